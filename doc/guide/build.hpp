@@ -90,10 +90,22 @@ The full list of options mlpack allows:
    OFF in releases)
  - ARMA_EXTRA_DEBUG=(ON/OFF): compile with extra Armadillo debugging symbols
        (default OFF)
+ - TRACK_ARMA_ALLOCATIONS=(ON/OFF): count the allocations of Armadillo objects,
+       which are then reported with the timers by \c --verbose and by the
+       benchmarks (default OFF; needs an Armadillo version supporting
+       \c ARMA_ALIEN_MEM_ALLOC_FUNCTION, and code linking against mlpack
+       must define \c MLPACK_TRACK_ARMA_ALLOCATIONS too)
  - BUILD_TESTS=(ON/OFF): compile the \c mlpack_test program (default ON)
+ - BUILD_BENCHMARKS=(ON/OFF): compile the \c mlpack_benchmarks program
+       (default OFF); \c make \c benchmark runs it and writes the results to
+       \c benchmarks.json (see \c mlpack_benchmarks \c --help for options)
  - BUILD_CLI_EXECUTABLES=(ON/OFF): compile the mlpack command-line executables
        (i.e. \c mlpack_knn, \c mlpack_kfn, \c mlpack_logistic_regression, etc.)
        (default ON)
+ - BUILD_ISA_VARIANTS=(ON/OFF): compile the distance kernels for SSE4.2, AVX2
+       and AVX-512 as well as for the default instruction set, and use the best
+       one the processor supports (default ON; needs a compiler with function
+       multiversioning)
  - TEST_VERBOSE=(ON/OFF): run test cases in \c mlpack_test with verbose output
        (default OFF)
 
@@ -62,4 +62,38 @@ int main(int argc, char** argv)
 If the --verbose flag was given to this executable, the resultant time that
 "some_timer" ran for would be shown.
 
+@section profiler Profiling inner loops
+
+Each \c Timer call looks up the named timer in a map shared by all threads, so
+timers are only suited to coarse phases of a method.  For finer measurements,
+like the time spent in a tree traversal or the number of base cases of a
+search, mlpack provides the \c Profiler.  The \c MLPACK_PROFILE_SCOPE() macro
+times the rest of the enclosing block, and \c MLPACK_PROFILE_COUNT() adds a
+value to a counter; each one looks up the id of its name only once, and the
+results are accumulated locally in each thread.  Nothing is recorded unless
+the profiler is enabled:
+
+@code
+Profiler::Enable();
+// (Optional.)  Record every scope in a trace too.
+Profiler::EnableTracing();
+
+{
+  MLPACK_PROFILE_SCOPE("my_method/step");
+  DoSomeStuff();
+  MLPACK_PROFILE_COUNT("my_method/items", numItems);
+}
+
+// One tab-separated line per scope or counter.
+Profiler::WriteSummary(std::cout);
+// A trace that can be opened in chrome://tracing or Perfetto.
+std::ofstream trace("trace.json");
+Profiler::WriteChromeTrace(trace);
+@endcode
+
+NeighborSearch and KMeans report scopes and counters such as
+"neighbor_search/traversal", "neighbor_search/base_cases" and
+"kmeans/iteration".  Defining \c MLPACK_NO_PROFILING before including mlpack
+removes the macros entirely.
+
 */
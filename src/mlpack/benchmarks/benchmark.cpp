@@ -0,0 +1,397 @@
+/**
+ * @file benchmark.cpp
+ *
+ * Implementation of the benchmark registry and runner.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/core/util/version.hpp>
+#include <mlpack/core/util/cpu_features.hpp>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <regex>
+#include <sstream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace std;
+
+#ifndef MLPACK_BENCHMARK_DATA_DIR
+  #define MLPACK_BENCHMARK_DATA_DIR "."
+#endif
+
+namespace {
+
+//! The results of a benchmark with one argument.
+struct BenchmarkResult
+{
+  BenchmarkResult() :
+      iterations(0),
+      meanTime(0.0),
+      medianTime(0.0),
+      stddevTime(0.0),
+      minTime(0.0),
+      cpuTime(0.0),
+      itemsPerSecond(0.0),
+      bytesPerSecond(0.0),
+      allocationsPerIteration(0.0),
+      bytesAllocatedPerIteration(0.0),
+      peakRSS(0),
+      error(false)
+  { }
+
+  //! Name of the benchmark, with its argument.
+  string name;
+  //! Iterations of each repetition.
+  size_t iterations;
+  //! Mean, median, standard deviation and minimum of the time of an
+  //! iteration over the repetitions, in nanoseconds.
+  double meanTime;
+  double medianTime;
+  double stddevTime;
+  double minTime;
+  //! Mean processor time of an iteration, in nanoseconds.
+  double cpuTime;
+  //! Items and bytes processed per second (0 if not given).
+  double itemsPerSecond;
+  double bytesPerSecond;
+  //! Armadillo allocations and allocated bytes per iteration (0 if they are
+  //! not tracked).
+  double allocationsPerIteration;
+  double bytesAllocatedPerIteration;
+  //! Peak resident set size of the process after the runs, in bytes (0 if
+  //! unknown).
+  size_t peakRSS;
+  //! Label of the last repetition.
+  string label;
+  //! Whether the benchmark threw an exception, and its message.
+  bool error;
+  string errorMessage;
+};
+
+string& DataDirectory()
+{
+  static string directory(MLPACK_BENCHMARK_DATA_DIR);
+  return directory;
+}
+
+//! Run one repetition with the given number of iterations.
+State RunOnce(const Benchmark& benchmark,
+              const size_t arg,
+              const size_t iterations,
+              const size_t seed)
+{
+  math::RandomSeed(seed);
+  State state(iterations, arg);
+  benchmark.Function()(state);
+  if (state.Iterations() != iterations)
+  {
+    throw runtime_error("the benchmark stopped after " +
+        to_string(state.Iterations()) + " of " + to_string(iterations) +
+        " iterations");
+  }
+
+  return state;
+}
+
+//! Run the benchmark with the given argument, repeating it as requested.
+BenchmarkResult Run(const Benchmark& benchmark,
+                    const size_t arg,
+                    const bool hasArg,
+                    const BenchmarkOptions& options)
+{
+  BenchmarkResult result;
+  result.name = benchmark.Name();
+  if (hasArg)
+    result.name += "/" + to_string(arg);
+
+  try
+  {
+    // Grow the number of iterations until a run takes long enough.
+    size_t iterations = 1;
+    const size_t maxIterations = 1000000000;
+    while (true)
+    {
+      const State state = RunOnce(benchmark, arg, iterations, options.seed);
+      const double time = state.ElapsedSeconds();
+      if (time >= options.minTime || iterations >= maxIterations)
+        break;
+
+      // Aim a little above the minimum time, but do not grow more than ten
+      // times at once, in case the first runs were unusually fast.
+      const double factor = (time > 0.0) ?
+          std::min(10.0, 1.4 * options.minTime / time) : 10.0;
+      iterations = std::min(maxIterations, std::max(iterations + 1,
+          (size_t) std::ceil(iterations * factor)));
+    }
+    result.iterations = iterations;
+
+    vector<double> times;
+    double items = 0.0, bytes = 0.0, seconds = 0.0, cpuSeconds = 0.0;
+    double allocations = 0.0, bytesAllocated = 0.0;
+    for (size_t r = 0; r < std::max(options.repetitions, (size_t) 1); ++r)
+    {
+      const State state = RunOnce(benchmark, arg, iterations, options.seed);
+      times.push_back(1e9 * state.ElapsedSeconds() / iterations);
+      items += state.ItemsProcessed();
+      bytes += state.BytesProcessed();
+      seconds += state.ElapsedSeconds();
+      cpuSeconds += state.CPUSeconds();
+      allocations += state.Allocations();
+      bytesAllocated += state.BytesAllocated();
+      result.label = state.Label();
+    }
+
+    const arma::vec t(times);
+    result.meanTime = arma::mean(t);
+    result.medianTime = arma::median(t);
+    result.stddevTime = (t.n_elem > 1) ? arma::stddev(t) : 0.0;
+    result.minTime = t.min();
+    result.cpuTime = 1e9 * cpuSeconds / (iterations * times.size());
+    result.allocationsPerIteration = allocations /
+        (iterations * times.size());
+    result.bytesAllocatedPerIteration = bytesAllocated /
+        (iterations * times.size());
+    result.peakRSS = MemoryTracker::PeakRSS();
+    if (seconds > 0.0)
+    {
+      result.itemsPerSecond = items / seconds;
+      result.bytesPerSecond = bytes / seconds;
+    }
+  }
+  catch (const exception& e)
+  {
+    result.error = true;
+    result.errorMessage = e.what();
+  }
+
+  return result;
+}
+
+//! Write the given string as a JSON string.
+void WriteJSONString(ostream& stream, const string& s)
+{
+  stream << '"';
+  for (const char c : s)
+  {
+    if (c == '"' || c == '\\')
+      stream << '\\' << c;
+    else if ((unsigned char) c < 0x20)
+    {
+      char escaped[7];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", (int) c);
+      stream << escaped;
+    }
+    else
+      stream << c;
+  }
+  stream << '"';
+}
+
+//! Get the current local time as a string.
+string Now()
+{
+  const time_t now = time(NULL);
+  char buffer[64];
+  strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+  return buffer;
+}
+
+size_t NumThreads()
+{
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+    threads = omp_get_max_threads();
+  #endif
+  return threads;
+}
+
+void WriteJSON(ostream& stream,
+               const vector<BenchmarkResult>& results,
+               const BenchmarkOptions& options)
+{
+  stream << "{\n  \"context\": {\n    \"date\": ";
+  WriteJSONString(stream, Now());
+  stream << ",\n    \"executable\": \"mlpack_benchmarks\",\n"
+      << "    \"mlpack_version\": ";
+  WriteJSONString(stream, util::GetVersion());
+  stream << ",\n    \"isa\": ";
+  WriteJSONString(stream, util::ISALevelName(util::ActiveISALevel()));
+  stream << ",\n    \"num_threads\": " << NumThreads() << ",\n"
+      << "    \"seed\": " << options.seed << ",\n"
+      << "    \"min_time\": " << options.minTime << ",\n"
+      << "    \"repetitions\": " << options.repetitions << "\n  },\n"
+      << "  \"benchmarks\": [";
+
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const BenchmarkResult& r = results[i];
+    stream << (i == 0 ? "\n" : ",\n") << "    {\n      \"name\": ";
+    WriteJSONString(stream, r.name);
+    stream << ",\n      \"run_name\": ";
+    WriteJSONString(stream, r.name);
+    if (r.error)
+    {
+      stream << ",\n      \"error_occurred\": true,\n"
+          << "      \"error_message\": ";
+      WriteJSONString(stream, r.errorMessage);
+      stream << "\n    }";
+      continue;
+    }
+
+    stream << ",\n      \"run_type\": \"iteration\",\n"
+        << "      \"iterations\": " << r.iterations << ",\n"
+        << "      \"real_time\": " << r.meanTime << ",\n"
+        << "      \"cpu_time\": " << r.cpuTime << ",\n"
+        << "      \"median_time\": " << r.medianTime << ",\n"
+        << "      \"stddev_time\": " << r.stddevTime << ",\n"
+        << "      \"min_time\": " << r.minTime << ",\n"
+        << "      \"time_unit\": \"ns\"";
+    if (r.itemsPerSecond > 0.0)
+      stream << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+    if (r.bytesPerSecond > 0.0)
+      stream << ",\n      \"bytes_per_second\": " << r.bytesPerSecond;
+    if (MemoryTracker::TracksAllocations())
+    {
+      stream << ",\n      \"allocs_per_iter\": " << r.allocationsPerIteration
+          << ",\n      \"bytes_allocated_per_iter\": "
+          << r.bytesAllocatedPerIteration;
+    }
+    if (r.peakRSS > 0)
+      stream << ",\n      \"peak_rss\": " << r.peakRSS;
+    if (!r.label.empty())
+    {
+      stream << ",\n      \"label\": ";
+      WriteJSONString(stream, r.label);
+    }
+    stream << "\n    }";
+  }
+  stream << "\n  ]\n}\n";
+}
+
+void WriteTableHeader(ostream& stream, const size_t nameWidth)
+{
+  const bool allocations = MemoryTracker::TracksAllocations();
+  stream << left << setw(nameWidth) << "Benchmark" << right << setw(15)
+      << "Time (ns)" << setw(12) << "Stddev" << setw(12) << "Iterations"
+      << setw(14) << "Items/s";
+  if (allocations)
+    stream << setw(13) << "Allocs/iter";
+  stream << setw(12) << "Peak RSS" << "  Label\n"
+      << string(nameWidth + 65 + (allocations ? 13 : 0), '-') << '\n';
+}
+
+void WriteTableRow(ostream& stream,
+                   const BenchmarkResult& r,
+                   const size_t nameWidth)
+{
+  stream << left << setw(nameWidth) << r.name << right;
+  if (r.error)
+  {
+    stream << "  ERROR: " << r.errorMessage << '\n';
+    return;
+  }
+
+  stream << setw(15) << r.meanTime << setw(12) << r.stddevTime << setw(12)
+      << r.iterations << setw(14);
+  if (r.itemsPerSecond > 0.0)
+    stream << r.itemsPerSecond;
+  else
+    stream << "";
+  if (MemoryTracker::TracksAllocations())
+    stream << setw(13) << r.allocationsPerIteration;
+
+  ostringstream rss;
+  if (r.peakRSS > 0)
+    MemoryTracker::PrintBytes(rss, r.peakRSS);
+  stream << setw(12) << rss.str() << "  " << r.label << '\n';
+  stream.flush();
+}
+
+} // namespace
+
+Benchmark* mlpack::benchmark::RegisterBenchmark(const string& name,
+                                                BenchmarkFunction function)
+{
+  Benchmarks().push_back(new Benchmark(name, function));
+  return Benchmarks().back();
+}
+
+vector<Benchmark*>& mlpack::benchmark::Benchmarks()
+{
+  static vector<Benchmark*> benchmarks;
+  return benchmarks;
+}
+
+string mlpack::benchmark::DataFile(const string& file)
+{
+  return DataDirectory() + "/" + file;
+}
+
+void mlpack::benchmark::SetDataDirectory(const string& directory)
+{
+  DataDirectory() = directory;
+}
+
+size_t mlpack::benchmark::RunBenchmarks(const BenchmarkOptions& options,
+                                        ostream& stream)
+{
+  const regex filter(options.filter);
+
+  // Collect the runs to do, so that the table can be aligned.
+  vector<pair<Benchmark*, size_t>> runs;
+  vector<bool> hasArg;
+  size_t nameWidth = 10;
+  for (Benchmark* b : Benchmarks())
+  {
+    vector<size_t> args = b->Args();
+    const bool withArgs = !args.empty();
+    if (!withArgs)
+      args.push_back(0);
+
+    for (const size_t arg : args)
+    {
+      const string name = withArgs ? b->Name() + "/" + to_string(arg) :
+          b->Name();
+      if (!regex_search(name, filter))
+        continue;
+
+      runs.push_back(make_pair(b, arg));
+      hasArg.push_back(withArgs);
+      nameWidth = std::max(nameWidth, name.size() + 2);
+    }
+  }
+
+  const ios::fmtflags flags = stream.flags();
+  const streamsize precision = stream.precision();
+  stream << fixed << setprecision(options.json ? 3 : 0);
+
+  if (!options.json)
+    WriteTableHeader(stream, nameWidth);
+
+  vector<BenchmarkResult> results;
+  size_t failed = 0;
+  for (size_t i = 0; i < runs.size(); ++i)
+  {
+    results.push_back(Run(*runs[i].first, runs[i].second, hasArg[i],
+        options));
+    if (results.back().error)
+      ++failed;
+
+    if (!options.json)
+      WriteTableRow(stream, results.back(), nameWidth);
+  }
+
+  if (options.json)
+    WriteJSON(stream, results, options);
+
+  stream.flags(flags);
+  stream.precision(precision);
+  return failed;
+}
@@ -0,0 +1,329 @@
+/**
+ * @file benchmark.hpp
+ *
+ * A small benchmark harness in the style of Google Benchmark: benchmarks are
+ * functions that time a loop over a State object, registered with
+ * MLPACK_BENCHMARK(), and run by the mlpack_benchmarks program, which reports
+ * the results on the console or as JSON.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/memory_usage.hpp>
+#include <chrono>
+#include <ctime>
+
+namespace mlpack {
+namespace benchmark {
+
+/**
+ * The state of one run of a benchmark.  The benchmark function times its loop
+ * with KeepRunning(), which returns true the number of times the runner
+ * chose:
+ *
+ * @code
+ * void BenchmarkSomething(benchmark::State& state)
+ * {
+ *   arma::mat data(10, state.Arg(), arma::fill::randu);
+ *   while (state.KeepRunning())
+ *     benchmark::DoNotOptimize(Something(data));
+ *   state.SetItemsProcessed(state.Iterations() * data.n_cols);
+ * }
+ * MLPACK_BENCHMARK(BenchmarkSomething)->Arg(1000)->Arg(10000);
+ * @endcode
+ *
+ * Everything before the first call to KeepRunning() and after the last one is
+ * setup, and is not timed.  The allocations of Armadillo objects during the
+ * timed part are counted too, if they are tracked (see MemoryTracker).
+ */
+class State
+{
+ public:
+  //! The clock used for the measurements.
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * Create the state of a run with the given number of iterations.
+   *
+   * @param maxIterations Number of times KeepRunning() returns true.
+   * @param arg The argument of the benchmark (0 if it has none).
+   */
+  State(const size_t maxIterations, const size_t arg) :
+      maxIterations(maxIterations),
+      iterations(0),
+      arg(arg),
+      running(false),
+      elapsed(0),
+      cpuStart(0),
+      cpuElapsed(0),
+      allocationsStart(0),
+      allocations(0),
+      bytesAllocatedStart(0),
+      bytesAllocated(0),
+      itemsProcessed(0),
+      bytesProcessed(0)
+  { }
+
+  /**
+   * Return true if the loop of the benchmark must run again.  The timer is
+   * started by the first call and stopped by the last one.
+   */
+  bool KeepRunning()
+  {
+    if (iterations == 0 && !running)
+      ResumeTiming();
+
+    if (iterations < maxIterations)
+    {
+      ++iterations;
+      return true;
+    }
+
+    PauseTiming();
+    return false;
+  }
+
+  //! Stop the timer, to exclude some work of an iteration.
+  void PauseTiming()
+  {
+    if (running)
+    {
+      elapsed += Clock::now() - start;
+      cpuElapsed += std::clock() - cpuStart;
+      allocations += MemoryTracker::Allocations() - allocationsStart;
+      bytesAllocated += MemoryTracker::BytesAllocated() - bytesAllocatedStart;
+      running = false;
+    }
+  }
+
+  //! Restart the timer after PauseTiming().
+  void ResumeTiming()
+  {
+    if (!running)
+    {
+      allocationsStart = MemoryTracker::Allocations();
+      bytesAllocatedStart = MemoryTracker::BytesAllocated();
+      start = Clock::now();
+      cpuStart = std::clock();
+      running = true;
+    }
+  }
+
+  //! Get the argument of the benchmark.
+  size_t Arg() const { return arg; }
+  //! Get the number of iterations run so far.
+  size_t Iterations() const { return iterations; }
+  //! Get the number of iterations of the run.
+  size_t MaxIterations() const { return maxIterations; }
+
+  //! Set the number of items processed by the run, for the items per second.
+  void SetItemsProcessed(const size_t items) { itemsProcessed = items; }
+  //! Get the number of items processed by the run.
+  size_t ItemsProcessed() const { return itemsProcessed; }
+  //! Set the number of bytes processed by the run, for the bytes per second.
+  void SetBytesProcessed(const size_t bytes) { bytesProcessed = bytes; }
+  //! Get the number of bytes processed by the run.
+  size_t BytesProcessed() const { return bytesProcessed; }
+  //! Set a label that is reported with the results.
+  void SetLabel(const std::string& newLabel) { label = newLabel; }
+  //! Get the label of the run.
+  const std::string& Label() const { return label; }
+
+  //! Get the timed duration of the run, in seconds.
+  double ElapsedSeconds() const
+  { return std::chrono::duration<double>(elapsed).count(); }
+  //! Get the processor time used by the program (all threads) during the
+  //! timed part of the run, in seconds.
+  double CPUSeconds() const { return double(cpuElapsed) / CLOCKS_PER_SEC; }
+  //! Get the number of Armadillo allocations during the timed part of the run
+  //! (0 if they are not tracked).
+  size_t Allocations() const { return allocations; }
+  //! Get the number of bytes allocated for Armadillo objects during the timed
+  //! part of the run (0 if they are not tracked).
+  size_t BytesAllocated() const { return bytesAllocated; }
+
+ private:
+  //! The number of iterations of the run.
+  size_t maxIterations;
+  //! The number of iterations run so far.
+  size_t iterations;
+  //! The argument of the benchmark.
+  size_t arg;
+  //! Whether the timer is running.
+  bool running;
+  //! When the timer was last started.
+  Clock::time_point start;
+  //! The timed duration so far.
+  Clock::duration elapsed;
+  //! The processor time when the timer was last started.
+  std::clock_t cpuStart;
+  //! The timed processor time so far.
+  std::clock_t cpuElapsed;
+  //! The allocation count when the timer was last started.
+  size_t allocationsStart;
+  //! The allocations during the timed part so far.
+  size_t allocations;
+  //! The allocated bytes when the timer was last started.
+  size_t bytesAllocatedStart;
+  //! The bytes allocated during the timed part so far.
+  size_t bytesAllocated;
+  //! The number of items processed.
+  size_t itemsProcessed;
+  //! The number of bytes processed.
+  size_t bytesProcessed;
+  //! The label of the run.
+  std::string label;
+};
+
+//! The type of a benchmark function.
+typedef void (*BenchmarkFunction)(State&);
+
+/**
+ * A registered benchmark: a function and the arguments to run it with.
+ */
+class Benchmark
+{
+ public:
+  //! Create the benchmark with the given name and function.
+  Benchmark(const std::string& name, BenchmarkFunction function) :
+      name(name),
+      function(function)
+  { }
+
+  //! Add an argument to run the benchmark with.
+  Benchmark* Arg(const size_t arg)
+  {
+    args.push_back(arg);
+    return this;
+  }
+
+  //! Get the name of the benchmark.
+  const std::string& Name() const { return name; }
+  //! Get the function of the benchmark.
+  BenchmarkFunction Function() const { return function; }
+  //! Get the arguments to run the benchmark with (empty if there are none).
+  const std::vector<size_t>& Args() const { return args; }
+
+ private:
+  //! The name of the benchmark.
+  std::string name;
+  //! The function of the benchmark.
+  BenchmarkFunction function;
+  //! The arguments to run the benchmark with.
+  std::vector<size_t> args;
+};
+
+/**
+ * Register a benchmark; use MLPACK_BENCHMARK() instead of calling this
+ * directly.  The returned object lives until the end of the program.
+ */
+Benchmark* RegisterBenchmark(const std::string& name,
+                             BenchmarkFunction function);
+
+//! Get all registered benchmarks, in the order they were registered.
+std::vector<Benchmark*>& Benchmarks();
+
+/**
+ * Get the path of a file of the benchmark dataset directory (the test data of
+ * mlpack, unless --data_dir is given).
+ *
+ * @param file Name of the file.
+ */
+std::string DataFile(const std::string& file);
+
+//! Set the benchmark dataset directory.
+void SetDataDirectory(const std::string& directory);
+
+/**
+ * Load a dataset of the benchmark dataset directory, with one point in each
+ * column.  A std::runtime_error is thrown if it cannot be loaded.
+ */
+template<typename eT>
+void LoadDataset(const std::string& file, arma::Mat<eT>& matrix)
+{
+  if (!data::Load(DataFile(file), matrix, false))
+    throw std::runtime_error("cannot load benchmark dataset '" + file + "'");
+}
+
+/**
+ * The options of a run of the benchmarks.
+ */
+struct BenchmarkOptions
+{
+  BenchmarkOptions() :
+      filter(".*"),
+      minTime(0.5),
+      repetitions(3),
+      seed(42),
+      json(false)
+  { }
+
+  //! Regular expression that the names of the benchmarks to run must match.
+  std::string filter;
+  //! Minimum timed duration of each repetition, in seconds.
+  double minTime;
+  //! Number of timed repetitions of each benchmark.
+  size_t repetitions;
+  //! Random seed, set before each repetition so that the runs are repeatable.
+  size_t seed;
+  //! Whether to write the results as JSON instead of a table.
+  bool json;
+};
+
+/**
+ * Run the registered benchmarks that match the filter, and write the results
+ * to the given stream.  The JSON output has the layout of the JSON output of
+ * Google Benchmark, so its comparison tools can be used on it; it also gives
+ * the peak resident set size of the process after each benchmark and, if they
+ * are tracked, the Armadillo allocations per iteration.  A benchmark
+ * that throws an exception is reported as an error.
+ *
+ * @param options The options of the run.
+ * @param stream Stream to write the results to.
+ * @return The number of benchmarks that failed.
+ */
+size_t RunBenchmarks(const BenchmarkOptions& options, std::ostream& stream);
+
+/**
+ * Prevent the compiler from optimizing away the computation of the given
+ * value.
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  const volatile char* p = reinterpret_cast<const volatile char*>(&value);
+  (void) *p;
+#endif
+}
+
+} // namespace benchmark
+} // namespace mlpack
+
+#define MLPACK_BENCHMARK_CONCAT_INNER(a, b) a ## b
+#define MLPACK_BENCHMARK_CONCAT(a, b) MLPACK_BENCHMARK_CONCAT_INNER(a, b)
+
+#if defined(__GNUC__) || defined(__clang__)
+  #define MLPACK_BENCHMARK_UNUSED __attribute__((unused))
+#else
+  #define MLPACK_BENCHMARK_UNUSED
+#endif
+
+/**
+ * Register the given function as a benchmark.  Arguments may be added to the
+ * result with Arg().
+ */
+#define MLPACK_BENCHMARK(function) \
+    static MLPACK_BENCHMARK_UNUSED ::mlpack::benchmark::Benchmark* \
+        MLPACK_BENCHMARK_CONCAT(mlpackBenchmark, __LINE__) = \
+        ::mlpack::benchmark::RegisterBenchmark(#function, function)
+
+#endif
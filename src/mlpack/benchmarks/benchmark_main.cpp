@@ -0,0 +1,135 @@
+/**
+ * @file benchmark_main.cpp
+ *
+ * The mlpack_benchmarks program: run the registered benchmarks and report the
+ * results.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <fstream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace std;
+
+namespace {
+
+void PrintUsage(ostream& stream)
+{
+  stream << "Usage: mlpack_benchmarks [options]\n\n"
+      << "  --filter=<regex>      Only run the benchmarks whose name matches.\n"
+      << "  --min_time=<seconds>  Minimum duration of each repetition "
+      << "(default 0.5).\n"
+      << "  --repetitions=<n>     Number of repetitions (default 3).\n"
+      << "  --seed=<n>            Random seed (default 42).\n"
+      << "  --format=<format>     'console' (default) or 'json'.\n"
+      << "  --out=<file>          Write the results to the given file.\n"
+      << "  --data_dir=<dir>      Directory of the benchmark datasets.\n"
+      << "  --list                List the benchmarks and exit.\n"
+      << "  --help                Print this message and exit.\n";
+}
+
+//! If the argument is "--<option>=<value>", store the value and return true.
+bool ParseOption(const string& argument,
+                 const string& option,
+                 string& value)
+{
+  const string prefix = "--" + option + "=";
+  if (argument.compare(0, prefix.size(), prefix) != 0)
+    return false;
+
+  value = argument.substr(prefix.size());
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  BenchmarkOptions options;
+  string out, value;
+  bool list = false;
+
+  try
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const string argument(argv[i]);
+      if (argument == "--help")
+      {
+        PrintUsage(cout);
+        return 0;
+      }
+      else if (argument == "--list")
+        list = true;
+      else if (ParseOption(argument, "filter", value))
+        options.filter = value;
+      else if (ParseOption(argument, "min_time", value))
+        options.minTime = stod(value);
+      else if (ParseOption(argument, "repetitions", value))
+        options.repetitions = stoul(value);
+      else if (ParseOption(argument, "seed", value))
+        options.seed = stoul(value);
+      else if (ParseOption(argument, "out", value))
+        out = value;
+      else if (ParseOption(argument, "data_dir", value))
+        SetDataDirectory(value);
+      else if (ParseOption(argument, "format", value) &&
+          (value == "console" || value == "json"))
+        options.json = (value == "json");
+      else
+        throw invalid_argument("unknown option '" + argument + "'");
+    }
+  }
+  catch (const exception& e)
+  {
+    cerr << "mlpack_benchmarks: " << e.what() << ".\n\n";
+    PrintUsage(cerr);
+    return 1;
+  }
+
+  if (list)
+  {
+    for (const Benchmark* b : Benchmarks())
+    {
+      if (b->Args().empty())
+        cout << b->Name() << '\n';
+      for (const size_t arg : b->Args())
+        cout << b->Name() << '/' << arg << '\n';
+    }
+    return 0;
+  }
+
+  ofstream file;
+  if (!out.empty())
+  {
+    file.open(out);
+    if (!file)
+    {
+      cerr << "mlpack_benchmarks: cannot open '" << out << "'." << endl;
+      return 1;
+    }
+  }
+
+  size_t failed;
+  try
+  {
+    failed = RunBenchmarks(options, out.empty() ? cout : file);
+  }
+  catch (const exception& e)
+  {
+    // The filter may not be a valid regular expression.
+    cerr << "mlpack_benchmarks: " << e.what() << "." << endl;
+    return 1;
+  }
+
+  if (failed > 0)
+    cerr << "mlpack_benchmarks: " << failed << " benchmarks failed." << endl;
+
+  return (failed > 0) ? 1 : 0;
+}
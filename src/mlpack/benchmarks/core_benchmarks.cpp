@@ -0,0 +1,304 @@
+/**
+ * @file core_benchmarks.cpp
+ *
+ * Micro-benchmarks of the kernels that the methods spend most of their time
+ * in: distances, tree bounds, convolutions, dataset loading, k-means steps and
+ * neural network gradients.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/hrectbound.hpp>
+#include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+using namespace mlpack::bound;
+using namespace mlpack::ann;
+using namespace mlpack::kmeans;
+using namespace mlpack::metric;
+
+/**
+ * The Euclidean distances between 1000 pairs of random points; the argument is
+ * the dimensionality.
+ */
+static void EuclideanDistances(State& state)
+{
+  const arma::mat points(state.Arg(), 1001, arma::fill::randu);
+
+  while (state.KeepRunning())
+  {
+    double sum = 0.0;
+    for (size_t i = 0; i + 1 < points.n_cols; ++i)
+      sum += EuclideanDistance::Evaluate(points.col(i), points.col(i + 1));
+    DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.Iterations() * (points.n_cols - 1));
+}
+MLPACK_BENCHMARK(EuclideanDistances)->Arg(3)->Arg(10)->Arg(100);
+
+/**
+ * The minimum distance between a point and a bound, for 1000 random points;
+ * the argument is the dimensionality.
+ */
+static void HRectBoundPointMinDistance(State& state)
+{
+  const arma::mat data(state.Arg(), 100, arma::fill::randu);
+  HRectBound<EuclideanDistance> bound(state.Arg());
+  bound |= data;
+  const arma::mat points = 2.0 * arma::randu<arma::mat>(state.Arg(), 1000);
+
+  while (state.KeepRunning())
+  {
+    double sum = 0.0;
+    for (size_t i = 0; i < points.n_cols; ++i)
+      sum += bound.MinDistance(points.col(i));
+    DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.Iterations() * points.n_cols);
+}
+MLPACK_BENCHMARK(HRectBoundPointMinDistance)->Arg(3)->Arg(10)->Arg(100);
+
+/**
+ * The minimum distance between two bounds, for 1000 pairs of random bounds;
+ * the argument is the dimensionality.
+ */
+static void HRectBoundMinDistance(State& state)
+{
+  std::vector<HRectBound<EuclideanDistance>> bounds;
+  for (size_t i = 0; i < 1001; ++i)
+  {
+    bounds.push_back(HRectBound<EuclideanDistance>(state.Arg()));
+    bounds.back() |= 3.0 * arma::randu<arma::mat>(state.Arg(), 5);
+  }
+
+  while (state.KeepRunning())
+  {
+    double sum = 0.0;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i)
+      sum += bounds[i].MinDistance(bounds[i + 1]);
+    DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.Iterations() * (bounds.size() - 1));
+}
+MLPACK_BENCHMARK(HRectBoundMinDistance)->Arg(3)->Arg(10)->Arg(100);
+
+/**
+ * A convolution of a square image with a 5x5 filter, with the given
+ * convolution rule and border mode; the argument is the side of the image.
+ */
+template<typename ConvolutionRuleType>
+static void Convolution2D(State& state)
+{
+  const arma::mat input(state.Arg(), state.Arg(), arma::fill::randu);
+  const arma::mat filter(5, 5, arma::fill::randu);
+  arma::mat output;
+
+  while (state.KeepRunning())
+  {
+    ConvolutionRuleType::Convolution(input, filter, output);
+    DoNotOptimize(output);
+  }
+  state.SetItemsProcessed(state.Iterations() * output.n_elem);
+}
+
+static void NaiveValidConvolution(State& state)
+{ Convolution2D<NaiveConvolution<ValidConvolution> >(state); }
+MLPACK_BENCHMARK(NaiveValidConvolution)->Arg(32)->Arg(128);
+
+static void FFTValidConvolution(State& state)
+{ Convolution2D<FFTConvolution<ValidConvolution> >(state); }
+MLPACK_BENCHMARK(FFTValidConvolution)->Arg(32)->Arg(128);
+
+static void SVDValidConvolution(State& state)
+{ Convolution2D<SVDConvolution<ValidConvolution> >(state); }
+MLPACK_BENCHMARK(SVDValidConvolution)->Arg(32)->Arg(128);
+
+static void ImToColValidConvolution(State& state)
+{ Convolution2D<ImToColConvolution<ValidConvolution> >(state); }
+MLPACK_BENCHMARK(ImToColValidConvolution)->Arg(32)->Arg(128);
+
+static void NaiveFullConvolution(State& state)
+{ Convolution2D<NaiveConvolution<FullConvolution> >(state); }
+MLPACK_BENCHMARK(NaiveFullConvolution)->Arg(32)->Arg(128);
+
+static void FFTFullConvolution(State& state)
+{ Convolution2D<FFTConvolution<FullConvolution> >(state); }
+MLPACK_BENCHMARK(FFTFullConvolution)->Arg(32)->Arg(128);
+
+static void SVDFullConvolution(State& state)
+{ Convolution2D<SVDConvolution<FullConvolution> >(state); }
+MLPACK_BENCHMARK(SVDFullConvolution)->Arg(32)->Arg(128);
+
+static void ImToColFullConvolution(State& state)
+{ Convolution2D<ImToColConvolution<FullConvolution> >(state); }
+MLPACK_BENCHMARK(ImToColFullConvolution)->Arg(32)->Arg(128);
+
+/**
+ * The forward pass, backward pass and gradient of a Convolution layer with 8
+ * input and 16 output maps of 28x28 points and 5x5 filters, with the given
+ * convolution rule; the argument is the batch size.
+ */
+template<typename ConvolutionRuleType, typename FullConvolutionRuleType>
+static void ConvolutionLayer(State& state)
+{
+  Convolution<ConvolutionRuleType, FullConvolutionRuleType,
+      ConvolutionRuleType> layer(8, 16, 5, 5, 1, 1, 0, 0, 28, 28);
+  layer.Parameters().randu();
+  layer.Reset();
+
+  arma::mat input(28 * 28 * 8, state.Arg(), arma::fill::randu);
+  arma::mat output, error, delta;
+  arma::mat gradient(layer.Parameters().n_elem, 1);
+
+  while (state.KeepRunning())
+  {
+    layer.Forward(std::move(input), std::move(output));
+    error = output;
+    layer.Backward(std::move(input), std::move(error), std::move(delta));
+    layer.Gradient(std::move(input), std::move(error), std::move(gradient));
+    DoNotOptimize(gradient);
+  }
+  state.SetItemsProcessed(state.Iterations() * input.n_cols);
+}
+
+static void NaiveConvolutionLayer(State& state)
+{
+  ConvolutionLayer<NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<FullConvolution> >(state);
+}
+MLPACK_BENCHMARK(NaiveConvolutionLayer)->Arg(1)->Arg(32);
+
+static void ImToColConvolutionLayer(State& state)
+{
+  ConvolutionLayer<ImToColConvolution<ValidConvolution>,
+      ImToColConvolution<FullConvolution> >(state);
+}
+MLPACK_BENCHMARK(ImToColConvolutionLayer)->Arg(1)->Arg(32);
+
+/**
+ * Loading a CSV file of 10-dimensional points; the argument is the number of
+ * points.
+ */
+static void LoadCSV(State& state)
+{
+  const std::string file = "mlpack_benchmark_load_csv.csv";
+  const arma::mat data(10, state.Arg(), arma::fill::randu);
+  if (!data::Save(file, data, false))
+    throw std::runtime_error("cannot write '" + file + "'");
+
+  size_t bytes = 0;
+  {
+    std::ifstream stream(file, std::ios::binary | std::ios::ate);
+    bytes = (size_t) stream.tellg();
+  }
+
+  arma::mat loaded;
+  while (state.KeepRunning())
+  {
+    data::Load(file, loaded, false);
+    DoNotOptimize(loaded);
+  }
+  std::remove(file.c_str());
+
+  if (loaded.n_cols != data.n_cols)
+    throw std::runtime_error("the CSV file was not loaded");
+
+  state.SetItemsProcessed(state.Iterations() * data.n_cols);
+  state.SetBytesProcessed(state.Iterations() * bytes);
+}
+MLPACK_BENCHMARK(LoadCSV)->Arg(10000)->Arg(100000);
+
+/**
+ * Five iterations of k-means with the given step type, from the same initial
+ * centroids, on clustered 5-dimensional data; the argument is the number of
+ * points.
+ */
+template<template<class, class> class LloydStepType>
+static void KMeansIterations(State& state)
+{
+  const size_t clusters = 20;
+  arma::mat centers(5, clusters, arma::fill::randu);
+  centers *= 10.0;
+  arma::mat data(5, state.Arg(), arma::fill::randn);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data.col(i) += centers.col(i % clusters);
+
+  const arma::mat initialCentroids = data.cols(0, clusters - 1);
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      LloydStepType> kmeans(5);
+  arma::mat centroids;
+
+  while (state.KeepRunning())
+  {
+    centroids = initialCentroids;
+    kmeans.Cluster(data, clusters, centroids, true);
+    DoNotOptimize(centroids);
+  }
+  state.SetItemsProcessed(state.Iterations() * data.n_cols);
+}
+
+static void KMeansNaive(State& state)
+{ KMeansIterations<NaiveKMeans>(state); }
+MLPACK_BENCHMARK(KMeansNaive)->Arg(10000);
+
+static void KMeansElkan(State& state)
+{ KMeansIterations<ElkanKMeans>(state); }
+MLPACK_BENCHMARK(KMeansElkan)->Arg(10000);
+
+static void KMeansHamerly(State& state)
+{ KMeansIterations<HamerlyKMeans>(state); }
+MLPACK_BENCHMARK(KMeansHamerly)->Arg(10000);
+
+static void KMeansPellegMoore(State& state)
+{ KMeansIterations<PellegMooreKMeans>(state); }
+MLPACK_BENCHMARK(KMeansPellegMoore)->Arg(10000);
+
+static void KMeansDualTree(State& state)
+{ KMeansIterations<DefaultDualTreeKMeans>(state); }
+MLPACK_BENCHMARK(KMeansDualTree)->Arg(10000);
+
+/**
+ * The gradient of a two-layer network on a batch of 64 points; the argument is
+ * the size of the hidden layer.
+ */
+static void FFNGradient(State& state)
+{
+  const arma::mat data(100, 256, arma::fill::randu);
+  arma::mat labels = arma::ones<arma::mat>(1, 256);
+  labels.cols(128, 255).fill(2);
+
+  FFN<NegativeLogLikelihood<>> model(data, labels);
+  model.Add<Linear<>>(data.n_rows, state.Arg());
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(state.Arg(), 2);
+  model.Add<LogSoftMax<>>();
+  model.ResetParameters();
+
+  arma::mat gradient;
+  while (state.KeepRunning())
+  {
+    model.Gradient(model.Parameters(), 0, gradient, 64);
+    DoNotOptimize(gradient);
+  }
+  state.SetItemsProcessed(state.Iterations() * 64);
+}
+MLPACK_BENCHMARK(FFNGradient)->Arg(32)->Arg(256);
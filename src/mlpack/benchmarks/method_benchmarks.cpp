@@ -0,0 +1,319 @@
+/**
+ * @file method_benchmarks.cpp
+ *
+ * Macro-benchmarks of the methods behind the command-line programs, on the
+ * datasets shipped with the tests.  Each benchmark times the work the program
+ * does after loading its input: training the model, or building the trees and
+ * searching them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+#include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+#include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/pca/pca.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
+#include <mlpack/methods/softmax_regression/softmax_regression.hpp>
+
+using namespace mlpack;
+using namespace mlpack::benchmark;
+
+namespace {
+
+//! Load a labeled dataset of the benchmark dataset directory.
+void LoadLabeledDataset(const std::string& file,
+                        const std::string& labelsFile,
+                        arma::mat& dataset,
+                        arma::Row<size_t>& labels)
+{
+  LoadDataset(file, dataset);
+  arma::Mat<size_t> labelsIn;
+  LoadDataset(labelsFile, labelsIn);
+  labels = labelsIn.row(0);
+  if (labels.n_elem != dataset.n_cols)
+    throw std::runtime_error("the labels of '" + file + "' do not match");
+}
+
+} // namespace
+
+//! The knn program: 5 nearest neighbors of each point.
+static void MethodKNN(State& state)
+{
+  arma::mat dataset;
+  LoadDataset("test_data_3_1000.csv", dataset);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  while (state.KeepRunning())
+  {
+    neighbor::KNN knn(dataset);
+    knn.Search(5, neighbors, distances);
+    DoNotOptimize(distances);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodKNN);
+
+/**
+ * The knn program with cover trees (--tree_type cover): 5 nearest neighbors of
+ * each point, which spends most of its time in the cover tree dual-tree
+ * traverser.
+ */
+static void MethodCoverTreeKNN(State& state)
+{
+  typedef neighbor::NeighborSearch<neighbor::NearestNeighborSort,
+      metric::EuclideanDistance, arma::mat, tree::StandardCoverTree>
+      CoverTreeKNN;
+
+  arma::mat dataset;
+  LoadDataset("test_data_3_1000.csv", dataset);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  while (state.KeepRunning())
+  {
+    CoverTreeKNN knn(dataset);
+    knn.Search(5, neighbors, distances);
+    DoNotOptimize(distances);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodCoverTreeKNN);
+
+//! The kfn program: 5 furthest neighbors of each point.
+static void MethodKFN(State& state)
+{
+  arma::mat dataset;
+  LoadDataset("test_data_3_1000.csv", dataset);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  while (state.KeepRunning())
+  {
+    neighbor::KFN kfn(dataset);
+    kfn.Search(5, neighbors, distances);
+    DoNotOptimize(distances);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodKFN);
+
+//! The range_search program: the points within 0.1 of each point.
+static void MethodRangeSearch(State& state)
+{
+  arma::mat dataset;
+  LoadDataset("test_data_3_1000.csv", dataset);
+
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+  while (state.KeepRunning())
+  {
+    range::RangeSearch<> rs(dataset);
+    rs.Search(math::Range(0.0, 0.1), neighbors, distances);
+    DoNotOptimize(distances);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodRangeSearch);
+
+//! The kmeans program: 10 clusters.
+static void MethodKMeans(State& state)
+{
+  arma::mat dataset;
+  LoadDataset("test_data_3_1000.csv", dataset);
+
+  arma::mat centroids;
+  while (state.KeepRunning())
+  {
+    kmeans::KMeans<> kmeans;
+    kmeans.Cluster(dataset, 10, centroids);
+    DoNotOptimize(centroids);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodKMeans);
+
+//! The emst program: the Euclidean minimum spanning tree.
+static void MethodEMST(State& state)
+{
+  arma::mat dataset;
+  LoadDataset("test_data_3_1000.csv", dataset);
+
+  arma::mat results;
+  while (state.KeepRunning())
+  {
+    emst::DualTreeBoruvka<> dtb(dataset);
+    dtb.ComputeMST(results);
+    DoNotOptimize(results);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodEMST);
+
+//! The fastmks program: the 5 maximum linear kernel values of each point.
+static void MethodFastMKS(State& state)
+{
+  arma::mat dataset;
+  LoadDataset("test_data_3_1000.csv", dataset);
+
+  arma::Mat<size_t> indices;
+  arma::mat kernels;
+  while (state.KeepRunning())
+  {
+    fastmks::FastMKS<kernel::LinearKernel> fastmks(dataset);
+    fastmks.Search(dataset, 5, indices, kernels);
+    DoNotOptimize(kernels);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodFastMKS);
+
+//! The kde program: the Gaussian kernel density at each point.
+static void MethodKDE(State& state)
+{
+  arma::mat dataset;
+  LoadDataset("test_data_3_1000.csv", dataset);
+
+  arma::vec estimations;
+  while (state.KeepRunning())
+  {
+    kde::KDE<> kde;
+    kde.Train(dataset);
+    kde.Evaluate(estimations);
+    DoNotOptimize(estimations);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodKDE);
+
+//! The gmm_train program: a mixture of 3 Gaussians.
+static void MethodGMM(State& state)
+{
+  arma::mat dataset;
+  LoadDataset("test_data_3_1000.csv", dataset);
+
+  while (state.KeepRunning())
+  {
+    gmm::GMM gmm(3, dataset.n_rows);
+    DoNotOptimize(gmm.Train(dataset));
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodGMM);
+
+//! The pca program.
+static void MethodPCA(State& state)
+{
+  arma::mat dataset;
+  LoadDataset("thyroid_train.csv", dataset);
+
+  arma::mat transformed, eigvec;
+  arma::vec eigval;
+  while (state.KeepRunning())
+  {
+    pca::PCA pca;
+    pca.Apply(dataset, transformed, eigval, eigvec);
+    DoNotOptimize(transformed);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodPCA);
+
+//! The logistic_regression program: training, then classification.
+static void MethodLogisticRegression(State& state)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels, predictions;
+  LoadLabeledDataset("train_nonlinsep.txt", "train_labels_nonlinsep.txt",
+      dataset, labels);
+
+  while (state.KeepRunning())
+  {
+    regression::LogisticRegression<> lr(dataset, labels);
+    lr.Classify(dataset, predictions);
+    DoNotOptimize(predictions);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodLogisticRegression);
+
+//! The softmax_regression program: training, then classification.
+static void MethodSoftmaxRegression(State& state)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels, predictions;
+  LoadLabeledDataset("vc2.csv", "vc2_labels.txt", dataset, labels);
+
+  while (state.KeepRunning())
+  {
+    regression::SoftmaxRegression sr(dataset, labels, 3);
+    sr.Classify(dataset, predictions);
+    DoNotOptimize(predictions);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodSoftmaxRegression);
+
+//! The nbc program: training, then classification.
+static void MethodNaiveBayes(State& state)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels, predictions;
+  LoadLabeledDataset("vc2.csv", "vc2_labels.txt", dataset, labels);
+
+  while (state.KeepRunning())
+  {
+    naive_bayes::NaiveBayesClassifier<> nbc(dataset, labels, 3);
+    nbc.Classify(dataset, predictions);
+    DoNotOptimize(predictions);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodNaiveBayes);
+
+//! The decision_tree program: training, then classification.
+static void MethodDecisionTree(State& state)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels, predictions;
+  LoadLabeledDataset("vc2.csv", "vc2_labels.txt", dataset, labels);
+
+  while (state.KeepRunning())
+  {
+    tree::DecisionTree<> dt(dataset, labels, 3);
+    dt.Classify(dataset, predictions);
+    DoNotOptimize(predictions);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodDecisionTree);
+
+//! The random_forest program: training 20 trees, then classification.
+static void MethodRandomForest(State& state)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels, predictions;
+  LoadLabeledDataset("vc2.csv", "vc2_labels.txt", dataset, labels);
+
+  while (state.KeepRunning())
+  {
+    tree::RandomForest<> rf(dataset, labels, 3, 20);
+    rf.Classify(dataset, predictions);
+    DoNotOptimize(predictions);
+  }
+  state.SetItemsProcessed(state.Iterations() * dataset.n_cols);
+}
+MLPACK_BENCHMARK(MethodRandomForest);
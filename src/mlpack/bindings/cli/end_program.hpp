@@ -9,21 +9,17 @@
 #define MLPACK_BINDINGS_CLI_END_PROGRAM_HPP
 
 #include <mlpack/core/util/cli.hpp>
+#include <unordered_set>
 
 namespace mlpack {
 namespace bindings {
 namespace cli {
 
 /**
- * Handle command-line program termination.  If --help or --info was passed, we
- * won't make it here, so we don't have to write any contingencies for that.
+ * Save or print all of the output parameters.
  */
-inline void EndProgram()
+inline void OutputParameters()
 {
-  // Stop the CLI timers.
-  CLI::GetSingleton().timer.StopAllTimers();
-
-  // Print any output.
   const std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
   std::map<std::string, util::ParamData>::const_iterator it =
       parameters.begin();
@@ -35,44 +31,71 @@ inline void EndProgram()
 
     ++it;
   }
+}
+
+/**
+ * If --verbose was passed, print the values of all the parameters, the timers
+ * and the memory used while each timer ran.
+ */
+inline void PrintExecutionInformation()
+{
+  if (!CLI::HasParam("verbose"))
+    return;
+
+  Log::Info << std::endl << "Execution parameters:" << std::endl;
+
+  // Print out all the values.
+  const std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
+  std::map<std::string, util::ParamData>::const_iterator it =
+      parameters.begin();
+  while (it != parameters.end())
+  {
+    // Now, figure out what type it is, and print it.
+    // We can handle strings, ints, bools, floats, doubles.
+    const util::ParamData& data = it->second;
+    std::string boostName;
+    CLI::GetSingleton().functionMap[data.tname]["MapParameterName"](data,
+        NULL, (void*) &boostName);
+    Log::Info << "  " << boostName << ": ";
+
+    std::string printableParam;
+    CLI::GetSingleton().functionMap[data.tname]["GetPrintableParam"](data,
+        NULL, (void*) &printableParam);
+    Log::Info << printableParam << std::endl;
+
+    ++it;
+  }
 
-  if (CLI::HasParam("verbose"))
+  Log::Info << "Program timers:" << std::endl;
+  for (auto it2 : CLI::GetSingleton().timer.GetAllTimers())
   {
-    Log::Info << std::endl << "Execution parameters:" << std::endl;
-
-    // Print out all the values.
-    it = parameters.begin();
-    while (it != parameters.end())
-    {
-      // Now, figure out what type it is, and print it.
-      // We can handle strings, ints, bools, floats, doubles.
-      const util::ParamData& data = it->second;
-      std::string boostName;
-      CLI::GetSingleton().functionMap[data.tname]["MapParameterName"](data,
-          NULL, (void*) &boostName);
-      Log::Info << "  " << boostName << ": ";
-
-      std::string printableParam;
-      CLI::GetSingleton().functionMap[data.tname]["GetPrintableParam"](data,
-          NULL, (void*) &printableParam);
-      Log::Info << printableParam << std::endl;
-
-      ++it;
-    }
-
-    Log::Info << "Program timers:" << std::endl;
-    for (auto it2 : CLI::GetSingleton().timer.GetAllTimers())
-    {
-      Log::Info << "  " << it2.first << ": ";
-      CLI::GetSingleton().timer.PrintTimer(it2.first);
-    }
+    Log::Info << "  " << it2.first << ": ";
+    CLI::GetSingleton().timer.PrintTimer(it2.first);
   }
 
-  // Lastly clean up any memory.  If we are holding any pointers, then we "own"
-  // them.  But we may hold the same pointer twice, so we have to be careful to
-  // not delete it multiple times.
+  Log::Info << "Program memory usage:" << std::endl;
+  for (auto it2 : CLI::GetSingleton().timer.GetAllTimers())
+  {
+    Log::Info << "  " << it2.first << ": ";
+    CLI::GetSingleton().timer.PrintMemoryUsage(it2.first);
+  }
+}
+
+/**
+ * Delete the memory held by the given parameters.  If we are holding any
+ * pointers, then we "own" them.  But we may hold the same pointer twice, so we
+ * have to be careful to not delete it multiple times.
+ *
+ * @param parameters Parameters whose memory should be deleted.
+ * @param keep Addresses that should not be deleted.
+ */
+inline void FreeParameterMemory(
+    const std::map<std::string, util::ParamData>& parameters,
+    const std::unordered_set<void*>& keep = std::unordered_set<void*>())
+{
   std::unordered_map<void*, const util::ParamData*> memoryAddresses;
-  it = parameters.begin();
+  std::map<std::string, util::ParamData>::const_iterator it =
+      parameters.begin();
   while (it != parameters.end())
   {
     const util::ParamData& data = it->second;
@@ -80,7 +103,8 @@ inline void EndProgram()
     void* result;
     CLI::GetSingleton().functionMap[data.tname]["GetAllocatedMemory"](data,
         NULL, (void*) &result);
-    if (result != NULL && memoryAddresses.count(result) == 0)
+    if (result != NULL && memoryAddresses.count(result) == 0 &&
+        keep.count(result) == 0)
       memoryAddresses[result] = &data;
 
     ++it;
@@ -100,6 +124,25 @@ inline void EndProgram()
   }
 }
 
+/**
+ * Handle command-line program termination.  If --help or --info was passed, we
+ * won't make it here, so we don't have to write any contingencies for that.
+ */
+inline void EndProgram()
+{
+  // Stop the CLI timers.
+  CLI::GetSingleton().timer.StopAllTimers();
+
+  // Print any output.
+  OutputParameters();
+
+  // Handle --verbose.
+  PrintExecutionInformation();
+
+  // Lastly clean up any memory.
+  FreeParameterMemory(CLI::Parameters());
+}
+
 } // namespace cli
 } // namespace bindings
 } // namespace mlpack
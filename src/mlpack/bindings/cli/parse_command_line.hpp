@@ -9,6 +9,9 @@
 #define MLPACK_BINDINGS_CLI_PARSE_COMMAND_LINE_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/compact_storage.hpp>
+#include <mlpack/core/data/standard_stream.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include <boost/program_options.hpp>
 #include "print_help.hpp"
 
@@ -19,9 +22,20 @@ namespace cli {
 // Add default parameters that are included in every program.
 PARAM_FLAG("help", "Default help info.", "h");
 PARAM_STRING_IN("info", "Get help on a specific module or option.", "", "");
-PARAM_FLAG("verbose", "Display informational messages and the full list of "
-    "parameters and timers at the end of execution.", "v");
+PARAM_FLAG("verbose", "Display informational messages, the statistics of the "
+    "tree traversals, and the full list of parameters and timers at the end of "
+    "execution.", "v");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_INT_IN("threads", "Number of threads used by mlpack and the BLAS library "
+    "(if 0, the OpenMP default is used: OMP_NUM_THREADS, or the number of "
+    "processors).", "j", 0);
+PARAM_FLAG("compact_models", "Save output models compactly: their largest "
+    "parameters in single precision, and their indices in 32 bits if they fit.",
+    "");
+PARAM_FLAG("serve", "Run as a server: read requests (the arguments of one run "
+    "of the program each) from standard input, one per line, and answer each "
+    "on standard output.  Input models are loaded once and kept between "
+    "requests.", "");
 
 /**
  * Parse the command line, setting all of the options inside of the CLI object
@@ -165,11 +179,57 @@ void ParseCommandLine(int argc, char** argv)
 
   if (CLI::HasParam("verbose"))
   {
-    // Give [INFO ] output.
+    // Give [INFO ] output, with the statistics of the tree traversals.
     Log::Info.ignoreInput = false;
+    tree::TraversalStatistics::Enable();
   }
 
-  // Now, issue an error if we forgot any required options.
+  // Set the number of threads of everything mlpack runs.
+  if (parameters.count("threads") > 0 && CLI::HasParam("threads"))
+  {
+    const int threads = CLI::GetParam<int>("threads");
+    if (threads < 0)
+    {
+      Log::Fatal << "Invalid value of --threads (" << threads << "); the "
+          << "number of threads must be nonnegative." << std::endl;
+    }
+
+#ifndef HAS_OPENMP
+    if (threads > 1)
+    {
+      Log::Warn << "--threads ignored because mlpack was compiled without "
+          << "OpenMP." << std::endl;
+    }
+#endif
+    Threads::Set((size_t) threads);
+  }
+
+  // Every run sets whether output models are saved compactly.
+  data::CompactStorage::Set(parameters.count("compact_models") > 0 &&
+      CLI::HasParam("compact_models"));
+
+  // A server only gets its required options with its requests.
+  if (parameters.count("serve") > 0 && CLI::HasParam("serve"))
+    return;
+
+  // An output saved to "-" goes to the standard output, so the messages go to
+  // the standard error instead, and don't get mixed with the data.
+  for (std::map<std::string, util::ParamData>::const_iterator iter =
+       parameters.begin(); iter != parameters.end(); ++iter)
+  {
+    const util::ParamData& d = iter->second;
+    if (d.input || !d.wasPassed)
+      continue;
+
+    std::string value;
+    CLI::GetSingleton().functionMap[d.tname]["GetPrintableParam"](d, NULL,
+        (void*) &value);
+    if (data::IsStandardStream(value))
+      data::SeparateStandardOutput();
+  }
+
+  // Now, issue an error if we forgot any required options.  They may have been
+  // given with the command line of a server rather than with the request.
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
   {
@@ -180,7 +240,7 @@ void ParseCommandLine(int argc, char** argv)
       CLI::GetSingleton().functionMap[d.tname]["MapParameterName"](d, NULL,
           (void*) &boostName);
 
-      if (!vmap.count(boostName))
+      if (!d.wasPassed)
       {
         Log::Fatal << "Required option --" << boostName << " is undefined."
             << std::endl;
@@ -0,0 +1,238 @@
+/**
+ * @file serve.hpp
+ *
+ * Run a command-line program as a resident server, which handles many runs of
+ * the program (requests) but loads each input model only once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+#include <boost/program_options/parsers.hpp>
+#include "parse_command_line.hpp"
+#include "end_program.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Give the input model parameters of a request the models that earlier
+ * requests loaded from the same files, so that they are not loaded again.
+ *
+ * @param cache The parameters holding the loaded models, by name.
+ */
+inline void ReuseModels(const std::map<std::string, util::ParamData>& cache)
+{
+  std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
+  for (auto it = cache.begin(); it != cache.end(); ++it)
+  {
+    util::ParamData& d = parameters[it->first];
+    if (!d.wasPassed)
+      continue;
+
+    // The printable value of a model parameter is its filename.
+    std::string file, cachedFile;
+    CLI::GetSingleton().functionMap[d.tname]["GetPrintableParam"](d, NULL,
+        (void*) &file);
+    CLI::GetSingleton().functionMap[d.tname]["GetPrintableParam"](it->second,
+        NULL, (void*) &cachedFile);
+    if (file == cachedFile)
+    {
+      d.value = it->second.value;
+      d.loaded = true;
+    }
+  }
+}
+
+/**
+ * After a request, move the input models it loaded to the cache, and free all
+ * the other memory the parameters hold.  A model that the program also
+ * returned as an output may have been modified, so it is not kept.
+ *
+ * @param cache The parameters holding the loaded models, by name.
+ */
+inline void KeepModels(std::map<std::string, util::ParamData>& cache)
+{
+  const std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
+
+  // Collect the memory held by the output parameters.
+  std::unordered_set<void*> outputs;
+  for (auto it = parameters.begin(); it != parameters.end(); ++it)
+  {
+    void* memory;
+    CLI::GetSingleton().functionMap[it->second.tname]["GetAllocatedMemory"](
+        it->second, NULL, (void*) &memory);
+    if (!it->second.input && memory != NULL)
+      outputs.insert(memory);
+  }
+
+  // Forget the cached models that were returned; they are freed below.
+  for (auto it = cache.begin(); it != cache.end(); )
+  {
+    void* memory;
+    CLI::GetSingleton().functionMap[it->second.tname]["GetAllocatedMemory"](
+        it->second, NULL, (void*) &memory);
+    if (outputs.count(memory) > 0)
+      it = cache.erase(it);
+    else
+      ++it;
+  }
+
+  std::unordered_set<void*> keep;
+  for (auto it = parameters.begin(); it != parameters.end(); ++it)
+  {
+    const util::ParamData& d = it->second;
+    void* memory;
+    CLI::GetSingleton().functionMap[d.tname]["GetAllocatedMemory"](d, NULL,
+        (void*) &memory);
+    if (!d.input || !d.loaded || memory == NULL || outputs.count(memory) > 0)
+      continue;
+
+    // If the request loaded another model for this parameter, the old one
+    // will not be used again.
+    if (cache.count(it->first) > 0)
+    {
+      void* cachedMemory;
+      CLI::GetSingleton().functionMap[d.tname]["GetAllocatedMemory"](
+          cache[it->first], NULL, (void*) &cachedMemory);
+      if (cachedMemory != memory)
+      {
+        CLI::GetSingleton().functionMap[d.tname]["DeleteAllocatedMemory"](
+            cache[it->first], NULL, NULL);
+      }
+    }
+
+    cache[it->first] = d;
+    keep.insert(memory);
+  }
+
+  FreeParameterMemory(parameters, keep);
+}
+
+/**
+ * Serve requests to the program until the end of the input.  Each line of the
+ * input is a request: the arguments of one run of the program (without the
+ * program name), quoted as on a Unix shell command line, and parsed on top of
+ * the arguments the server was started with.  A line "quit" stops the server.
+ *
+ * The response to each request is a line "OK <n>" or "ERROR <n>", followed by
+ * n bytes: what the run printed on standard output, or on standard error if it
+ * failed.  Output files are written as usual.
+ *
+ * The input models are loaded for the first request that needs them and kept,
+ * and later requests that give the same file reuse them; the programs must
+ * therefore not modify an input model they do not return as an output.
+ * Datasets are loaded for each request.
+ *
+ * @param mainFunction The mlpackMain() function of the program.
+ * @param input Stream to read the requests from.
+ * @param output Stream to write the responses to.
+ */
+inline void Serve(void (*mainFunction)(),
+                  std::istream& input,
+                  std::ostream& output)
+{
+  // Every request starts from the parameters the server was started with.
+  std::map<std::string, util::ParamData> base = CLI::Parameters();
+  if (base.count("serve") > 0)
+    base["serve"].wasPassed = false;
+  const bool infoIgnored = Log::Info.ignoreInput;
+  const bool statisticsEnabled = tree::TraversalStatistics::Enabled();
+  const size_t threads = Threads::Get();
+  const std::string programName = CLI::ProgramName();
+
+  // The parameters holding the models loaded so far, by name.
+  std::map<std::string, util::ParamData> cache;
+
+  std::string line;
+  while (std::getline(input, line))
+  {
+    const std::vector<std::string> args =
+        boost::program_options::split_unix(line);
+    if (args.empty())
+      continue;
+    if (args.size() == 1 && args[0] == "quit")
+      break;
+
+    std::vector<char*> argv(1, const_cast<char*>(programName.c_str()));
+    for (size_t i = 0; i < args.size(); ++i)
+      argv.push_back(const_cast<char*>(args[i].c_str()));
+
+    CLI::Parameters() = base;
+    Log::Info.ignoreInput = infoIgnored;
+    if (statisticsEnabled)
+      tree::TraversalStatistics::Enable();
+    else
+      tree::TraversalStatistics::Disable();
+    Threads::Set(threads);
+
+    // Capture what the run prints, for the response.
+    std::ostringstream out, err;
+    std::streambuf* coutBuffer = std::cout.rdbuf(out.rdbuf());
+    std::streambuf* cerrBuffer = std::cerr.rdbuf(err.rdbuf());
+    bool success = true;
+    try
+    {
+      // These options would end the server, or make a server of the request.
+      for (size_t i = 0; i < args.size(); ++i)
+      {
+        const std::string& a = args[i];
+        if (a == "-h" || a == "-V" || a.compare(0, 6, "--help") == 0 ||
+            a.compare(0, 6, "--info") == 0 ||
+            a.compare(0, 9, "--version") == 0 ||
+            a.compare(0, 7, "--serve") == 0)
+        {
+          throw std::invalid_argument("option '" + a + "' cannot be given "
+              "with a request");
+        }
+      }
+
+      ParseCommandLine((int) argv.size(), argv.data());
+      ReuseModels(cache);
+
+      CLI::GetSingleton().timer.Reset();
+      Timer::Start("total_time");
+      mainFunction();
+      CLI::GetSingleton().timer.StopAllTimers();
+
+      OutputParameters();
+      PrintExecutionInformation();
+    }
+    catch (const std::exception& e)
+    {
+      err << e.what() << std::endl;
+      success = false;
+    }
+
+    KeepModels(cache);
+
+    std::cout.rdbuf(coutBuffer);
+    std::cerr.rdbuf(cerrBuffer);
+
+    // Warnings of a successful run are still shown on the standard error of
+    // the server.
+    if (success)
+      std::cerr << err.str() << std::flush;
+
+    const std::string response = success ? out.str() : err.str();
+    output << (success ? "OK " : "ERROR ") << response.size() << '\n'
+        << response << std::flush;
+  }
+
+  // Free the models that were kept.
+  CLI::Parameters() = base;
+  FreeParameterMemory(cache);
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -12,6 +12,12 @@ object, then the numpy object will "own" the matrix.
 Thus, know that if you convert a matrix type, remember that the resulting type
 is what "owns" the allocated memory.
 
+A C-contiguous (row-major) numpy array with one point in each row has exactly
+the memory layout of a column-major Armadillo matrix with one point in each
+column, so such arrays (including views that do not own their memory) are
+converted without any copy or transposition.  Any other array is copied once
+into C order.
+
 mlpack is free software; you may redistribute it and/or modify it under the
 terms of the 3-clause BSD license.  You should have received a copy of the
 3-clause BSD license along with mlpack.  If not, see
@@ -45,8 +51,9 @@ cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous:
+    # Only a C-contiguous array has the layout of an Armadillo object, so
+    # anything else (Fortran order, strided views) must be copied first.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -65,8 +72,9 @@ cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous:
+    # Only a C-contiguous array has the layout of an Armadillo object, so
+    # anything else (Fortran order, strided views) must be copied first.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -124,8 +132,9 @@ cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous:
+    # Only a C-contiguous array has the layout of an Armadillo object, so
+    # anything else (Fortran order, strided views) must be copied first.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -145,8 +154,9 @@ cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous:
+    # Only a C-contiguous array has the layout of an Armadillo object, so
+    # anything else (Fortran order, strided views) must be copied first.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -200,8 +210,9 @@ cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous:
+    # Only a C-contiguous array has the layout of an Armadillo object, so
+    # anything else (Fortran order, strided views) must be copied first.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -221,9 +232,11 @@ cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous:
+    # Only a C-contiguous array has the layout of an Armadillo object, so
+    # anything else (Fortran order, strided views) must be copied first.
     X = X.copy(order="C")
+    takeOwnership = True
 
   cdef arma.Col[size_t]* m = new arma.Col[size_t](<size_t*> X.data, X.shape[0],
       False, False)
@@ -38,6 +38,9 @@ cdef extern from "<mlpack/core/util/cli.hpp>" namespace "mlpack" nogil:
     @staticmethod
     void ClearSettings() nogil except +
 
+    @staticmethod
+    void UseThreadLocalInstance() nogil except +
+
 cdef extern from "<mlpack/bindings/python/mlpack/cli_util.hpp>" \
     namespace "mlpack::util" nogil:
   void SetParam[T](string, T&) nogil except +
@@ -50,3 +53,4 @@ cdef extern from "<mlpack/bindings/python/mlpack/cli_util.hpp>" \
   void DisableBacktrace() nogil except +
   void ResetTimers() nogil except +
   void EnableTimers() nogil except +
+  void SetThreads() nogil except +
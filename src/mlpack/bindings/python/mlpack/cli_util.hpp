@@ -163,6 +163,22 @@ inline void EnableTimers()
   Timer::EnableTiming();
 }
 
+/**
+ * Set the number of threads of mlpack to the value of the 'threads' parameter
+ * (0, the default, restores the OpenMP default).
+ */
+inline void SetThreads()
+{
+  const int threads = CLI::GetParam<int>("threads");
+  if (threads < 0)
+  {
+    throw std::invalid_argument("the number of threads must be nonnegative, "
+        "not " + std::to_string(threads));
+  }
+
+  Threads::Set((size_t) threads);
+}
+
 } // namespace util
 } // namespace mlpack
 
@@ -70,11 +70,10 @@ def to_matrix_with_info(x, dtype, copy=False):
     # It is already an ndarray, so the vector of info is all 0s (all numeric).
     d = np.zeros([x.shape[1]], dtype=np.bool)
 
-    # Copy the matrix if needed.
-    if copy:
-      return (x.copy(order="C"), True, d)
-    else:
-      return (x, False, d)
+    # This only copies the matrix if it has the wrong type or layout, or if a
+    # copy was requested.
+    t = to_matrix(x, dtype, copy)
+    return (t[0], t[1], d)
 
   if isinstance(x, pd.DataFrame) or isinstance(x, pd.Series):
     # It's a pandas dataframe.  So we need to see if any of the dtypes are
@@ -0,0 +1,16 @@
+#!/usr/bin/env python
+"""
+model_buffer.pxd: a read-only buffer holding a serialized model.
+
+mlpack is free software; you may redistribute it and/or modify it under the
+terms of the 3-clause BSD license.  You should have received a copy of the
+3-clause BSD license along with mlpack.  If not, see
+http://www.opensource.org/licenses/BSD-3-Clause for more information.
+"""
+cimport cython
+
+from libcpp.string cimport string
+
+cdef class ModelBuffer:
+  # The serialized model; it must not be modified once the buffer is exported.
+  cdef string data
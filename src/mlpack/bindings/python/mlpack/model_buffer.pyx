@@ -0,0 +1,29 @@
+#!/usr/bin/env python
+"""
+model_buffer.pyx: a read-only buffer holding a serialized model.
+
+A model class fills a ModelBuffer with SerializeOutTo(), and the buffer protocol
+then exposes the serialized model directly, without converting it to a bytes
+object.  This lets pickle protocol 5 pass models out-of-band (with
+pickle.PickleBuffer) without copying them.
+
+mlpack is free software; you may redistribute it and/or modify it under the
+terms of the 3-clause BSD license.  You should have received a copy of the
+3-clause BSD license along with mlpack.  If not, see
+http://www.opensource.org/licenses/BSD-3-Clause for more information.
+"""
+cimport cython
+
+from cpython.buffer cimport PyBuffer_FillInfo
+
+cdef class ModelBuffer:
+  def __getbuffer__(self, Py_buffer* buffer, int flags):
+    # The buffer is read-only, so asking for a writable buffer is an error.
+    PyBuffer_FillInfo(buffer, self, <void*> self.data.data(), self.data.size(),
+        1, flags)
+
+  def __releasebuffer__(self, Py_buffer* buffer):
+    pass
+
+  def __len__(self):
+    return self.data.size()
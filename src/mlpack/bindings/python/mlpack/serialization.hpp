@@ -13,6 +13,48 @@ namespace mlpack {
 namespace bindings {
 namespace python {
 
+/**
+ * A stream buffer that appends everything written to it to a string, so that
+ * an archive can be written to a string without the copy that
+ * std::ostringstream::str() makes.
+ */
+class StringOutputBuffer : public std::streambuf
+{
+ public:
+  StringOutputBuffer(std::string& str) : str(str) { }
+
+ protected:
+  std::streamsize xsputn(const char* s, std::streamsize n)
+  {
+    str.append(s, (size_t) n);
+    return n;
+  }
+
+  int_type overflow(int_type c)
+  {
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+      str.push_back(traits_type::to_char_type(c));
+    return traits_type::not_eof(c);
+  }
+
+ private:
+  std::string& str;
+};
+
+/**
+ * A stream buffer that reads from memory it does not own, so that an archive
+ * can be read from a Python buffer without copying it.
+ */
+class MemoryInputBuffer : public std::streambuf
+{
+ public:
+  MemoryInputBuffer(const char* data, const size_t size)
+  {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
 template<typename T>
 std::string SerializeOut(T* t, const std::string& name)
 {
@@ -34,6 +76,39 @@ void SerializeIn(T* t, const std::string& str, const std::string& name)
   b >> boost::serialization::make_nvp(name.c_str(), *t);
 }
 
+/**
+ * Serialize the given object into the given string, which is cleared first.
+ * Unlike SerializeOut(), the archive is written directly into the string.
+ */
+template<typename T>
+void SerializeOutTo(T* t, const std::string& name, std::string& str)
+{
+  str.clear();
+  StringOutputBuffer buffer(str);
+  std::ostream stream(&buffer);
+  {
+    boost::archive::binary_oarchive b(stream);
+
+    b << boost::serialization::make_nvp(name.c_str(), *t);
+  }
+}
+
+/**
+ * Deserialize the given object from the given memory, which is not copied.
+ */
+template<typename T>
+void SerializeInFrom(T* t,
+                     const char* data,
+                     const size_t size,
+                     const std::string& name)
+{
+  MemoryInputBuffer buffer(data, size);
+  std::istream stream(&buffer);
+  boost::archive::binary_iarchive b(stream);
+
+  b >> boost::serialization::make_nvp(name.c_str(), *t);
+}
+
 } // namespace python
 } // namespace bindings
 } // namespace mlpack
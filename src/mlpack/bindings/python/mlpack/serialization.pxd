@@ -12,3 +12,6 @@ from libcpp.string cimport string
 cdef extern from "serialization.hpp" namespace "mlpack::bindings::python" nogil:
   string SerializeOut[T](T* t, string name) nogil
   void SerializeIn[T](T* t, string str, string name) nogil
+  void SerializeOutTo[T](T* t, string name, string& str) nogil except +
+  void SerializeInFrom[T](T* t, const char* data, size_t size, string name) \
+      nogil except +
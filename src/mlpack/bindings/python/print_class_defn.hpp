@@ -67,10 +67,23 @@ void PrintClassDefn(
    *     return SerializeOut(self.modelptr, "<ModelType>")
    *
    *   def __setstate__(self, state):
-   *     SerializeIn(self.modelptr, state, "<ModelType>")
+   *     cdef const unsigned char[::1] buf = state
+   *     SerializeInFrom(self.modelptr, <const char*> &buf[0], buf.shape[0],
+   *         "<ModelType>")
    *
-   *   def __reduce_ex__(self):
+   *   def __reduce_ex__(self, version):
+   *     cdef ModelBuffer buf
+   *     if version >= 5:
+   *       buf = ModelBuffer()
+   *       SerializeOutTo(self.modelptr, "<ModelType>", buf.data)
+   *       return (self.__class__, (), pickle.PickleBuffer(buf))
    *     return (self.__class__, (), self.__getstate__())
+   *
+   * The state may be any object with the buffer protocol (bytes, a memoryview,
+   * or the out-of-band buffer of pickle protocol 5), and it is deserialized in
+   * place.  With protocol 5 the model is serialized directly into a
+   * ModelBuffer that pickle can pass out-of-band, so it is never copied into a
+   * bytes object.
    */
   std::cout << "cdef class " << strippedType << "Type:" << std::endl;
   std::cout << "  cdef " << printedType << "* modelptr" << std::endl;
@@ -86,10 +99,19 @@ void PrintClassDefn(
       << "\")" << std::endl;
   std::cout << std::endl;
   std::cout << "  def __setstate__(self, state):" << std::endl;
-  std::cout << "    SerializeIn(self.modelptr, state, \"" << printedType
-      << "\")" << std::endl;
+  std::cout << "    cdef const unsigned char[::1] buf = state" << std::endl;
+  std::cout << "    SerializeInFrom(self.modelptr, <const char*> &buf[0], "
+      << "buf.shape[0]," << std::endl;
+  std::cout << "        \"" << printedType << "\")" << std::endl;
   std::cout << std::endl;
   std::cout << "  def __reduce_ex__(self, version):" << std::endl;
+  std::cout << "    cdef ModelBuffer buf" << std::endl;
+  std::cout << "    if version >= 5:" << std::endl;
+  std::cout << "      buf = ModelBuffer()" << std::endl;
+  std::cout << "      SerializeOutTo(self.modelptr, \"" << printedType
+      << "\", buf.data)" << std::endl;
+  std::cout << "      return (self.__class__, (), pickle.PickleBuffer(buf))"
+      << std::endl;
   std::cout << "    return (self.__class__, (), self.__getstate__())"
       << std::endl;
   std::cout << std::endl;
@@ -74,11 +74,14 @@ void PrintPYX(const ProgramDoc& programInfo,
   cout << "from cli cimport SetParam, SetParamPtr, SetParamWithInfo, "
       << "GetParamPtr" << endl;
   cout << "from cli cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
-      << "ResetTimers, EnableTimers" << endl;
+      << "ResetTimers, EnableTimers, SetThreads" << endl;
   cout << "from matrix_utils import to_matrix, to_matrix_with_info" << endl;
-  cout << "from serialization cimport SerializeIn, SerializeOut" << endl;
+  cout << "from serialization cimport SerializeIn, SerializeOut, "
+      << "SerializeInFrom, SerializeOutTo" << endl;
+  cout << "from model_buffer cimport ModelBuffer" << endl;
   cout << endl;
   cout << "import numpy as np" << endl;
+  cout << "import pickle" << endl;
   cout << "cimport numpy as np" << endl;
   cout << endl;
   cout << "from libcpp.string cimport string" << endl;
@@ -170,6 +173,10 @@ void PrintPYX(const ProgramDoc& programInfo,
       << "returned." << endl;
   cout << "  \"\"\"" << endl;
 
+  // Every Python thread has its own parameters and timers, so that several
+  // threads can call mlpack at once.
+  cout << "  CLI.UseThreadLocalInstance()" << endl;
+
   // Reset any timers and disable backtraces.
   cout << "  ResetTimers()" << endl;
   cout << "  EnableTimers()" << endl;
@@ -196,6 +203,10 @@ void PrintPYX(const ProgramDoc& programInfo,
         (void*) &indent, NULL);
   }
 
+  // Every call sets the number of threads, so that one call does not change
+  // the next ones.
+  cout << "  SetThreads()" << endl;
+
   // Set all output options as passed.
   cout << "  # Mark all output options as passed." << endl;
   for (size_t i = 0; i < outputOptions.size(); ++i)
@@ -204,9 +215,11 @@ void PrintPYX(const ProgramDoc& programInfo,
     cout << "  CLI.SetPassed(<const string> '" << d.name << "')" << endl;
   }
 
-  // Call the method.
+  // Call the method.  Other Python threads may run while it computes, since
+  // it does not touch any Python objects.
   cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpackMain()" << endl;
+  cout << "  with nogil:" << endl;
+  cout << "    mlpackMain()" << endl;
 
   // Do any output processing and return.
   cout << "  # Initialize result dictionary." << endl;
@@ -8,6 +8,8 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import pickle
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -112,6 +114,28 @@ class TestPythonBinding(unittest.TestCase):
     for j in range(100):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
+  def testNumpyFortranMatrix(self):
+    """
+    A matrix in Fortran order must be converted correctly (it is the only
+    layout that needs a copy).
+    """
+    x = np.random.rand(100, 5);
+    z = np.asfortranarray(x)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 matrix_in=z)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(x[j, i], output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
+
   def testNumpyMatrixForceCopy(self):
     """
     The matrix we pass in, we should get back with the third dimension doubled
@@ -603,5 +627,87 @@ class TestPythonBinding(unittest.TestCase):
     self.assertEqual(output2['model_bw_out'], 20.0)
     self.assertEqual(output3['model_bw_out'], 20.0)
 
+  def testThreads(self):
+    """
+    The number of threads can be given to any binding, but must not be
+    negative.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 threads=1)
+
+    self.assertEqual(output['string_out'], 'hello2')
+
+    self.assertRaises(ValueError,
+                      lambda: test_python_binding(string_in='hello',
+                                                  int_in=12,
+                                                  double_in=4.0,
+                                                  threads=-1))
+
+  def testModelPickle(self):
+    """
+    A model must survive pickling with every protocol.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 build_model=True)
+
+    for protocol in range(pickle.HIGHEST_PROTOCOL + 1):
+      model = pickle.loads(pickle.dumps(output['model_out'], protocol))
+      output2 = test_python_binding(string_in='hello',
+                                    int_in=12,
+                                    double_in=4.0,
+                                    model_in=model)
+
+      self.assertEqual(output2['model_bw_out'], 20.0)
+
+  @unittest.skipIf(pickle.HIGHEST_PROTOCOL < 5, "requires pickle protocol 5")
+  def testModelPickleOutOfBand(self):
+    """
+    With pickle protocol 5, a model can be passed as an out-of-band buffer.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 build_model=True)
+
+    buffers = []
+    data = pickle.dumps(output['model_out'], protocol=5,
+                        buffer_callback=buffers.append)
+    self.assertEqual(len(buffers), 1)
+
+    model = pickle.loads(data, buffers=buffers)
+    output2 = test_python_binding(string_in='hello',
+                                  int_in=12,
+                                  double_in=4.0,
+                                  model_in=model)
+
+    self.assertEqual(output2['model_bw_out'], 20.0)
+
+  def testConcurrentCalls(self):
+    """
+    Several threads should be able to call the binding at the same time without
+    seeing each other's parameters.  Every other thread passes a wrong int.
+    """
+    results = [None] * 8
+    def run(i):
+      results[i] = test_python_binding(string_in='hello',
+                                       int_in=(12 if i % 2 == 0 else 15),
+                                       double_in=4.0,
+                                       flag1=True)
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(8)]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    for i in range(8):
+      self.assertEqual(results[i]['string_out'], 'hello2')
+      self.assertEqual(results[i]['int_out'], 13 if i % 2 == 0 else 11)
+      self.assertEqual(results[i]['double_out'], 5.0)
+
 if __name__ == '__main__':
   unittest.main()
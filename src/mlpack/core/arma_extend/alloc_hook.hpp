@@ -0,0 +1,38 @@
+/**
+ * @file alloc_hook.hpp
+ *
+ * Route the memory allocations of Armadillo objects through mlpack, so that
+ * they can be counted by the MemoryTracker.  This is only used when mlpack is
+ * compiled with MLPACK_TRACK_ARMA_ALLOCATIONS, and it needs a version of
+ * Armadillo that supports ARMA_ALIEN_MEM_ALLOC_FUNCTION.
+ *
+ * Every translation unit that uses Armadillo objects shared with mlpack must
+ * be compiled with the same setting, since memory acquired with the hook must
+ * be released with it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_ARMA_EXTEND_ALLOC_HOOK_HPP
+#define MLPACK_CORE_ARMA_EXTEND_ALLOC_HOOK_HPP
+
+#include <cstddef>
+
+namespace mlpack {
+namespace util {
+
+//! Allocate memory for an Armadillo object, and count the allocation.
+void* ArmaAllocate(const std::size_t bytes);
+
+//! Release memory allocated with ArmaAllocate().
+void ArmaFree(void* memory);
+
+} // namespace util
+} // namespace mlpack
+
+#define ARMA_ALIEN_MEM_ALLOC_FUNCTION ::mlpack::util::ArmaAllocate
+#define ARMA_ALIEN_MEM_FREE_FUNCTION ::mlpack::util::ArmaFree
+
+#endif
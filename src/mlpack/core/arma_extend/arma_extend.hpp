@@ -39,6 +39,11 @@
     #endif
 #endif
 
+// Count the allocations of Armadillo objects, if requested.
+#ifdef MLPACK_TRACK_ARMA_ALLOCATIONS
+  #include "alloc_hook.hpp"
+#endif
+
 // Make sure that U64 and S64 support is enabled.
 #ifndef ARMA_USE_U64S64
   #define ARMA_USE_U64S64
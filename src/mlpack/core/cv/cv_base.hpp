@@ -13,6 +13,7 @@
 #define MLPACK_CORE_CV_CV_BASE_HPP
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
+#include <mlpack/core/cv/warm_start_traits.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -98,6 +99,50 @@ class CVBase
                     const WeightsType& weights,
                     const MLAlgorithmArgs&... args);
 
+  /**
+   * Train the given model again with given data points and predictions by
+   * calling its Train() method, so that training starts from the current model
+   * if MLAlgorithm supports that.  std::invalid_argument is thrown if
+   * MLAlgorithm has no such Train() method.
+   */
+  void Retrain(MLAlgorithm& model,
+               const MatType& xs,
+               const PredictionsType& ys);
+
+  /**
+   * Train the given model again with given data points, predictions, and
+   * weights by calling its Train() method, so that training starts from the
+   * current model if MLAlgorithm supports that.
+   */
+  void Retrain(MLAlgorithm& model,
+               const MatType& xs,
+               const PredictionsType& ys,
+               const WeightsType& weights);
+
+  /**
+   * Train MLAlgorithm with given data points, predictions, and hyperparameters,
+   * starting from the given previous model (trained with other
+   * hyperparameters) if WarmStartTraits<MLAlgorithm> supports it; otherwise
+   * this is the same as Train().
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm Continue(const MLAlgorithm& previous,
+                       const MatType& xs,
+                       const PredictionsType& ys,
+                       const MLAlgorithmArgs&... args);
+
+  /**
+   * Train MLAlgorithm with given data points, predictions, weights, and
+   * hyperparameters, starting from the given previous model if
+   * WarmStartTraits<MLAlgorithm> supports it.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm ContinueWeighted(const MLAlgorithm& previous,
+                               const MatType& xs,
+                               const PredictionsType& ys,
+                               const WeightsType& weights,
+                               const MLAlgorithmArgs&... args);
+
  private:
   static_assert(MIE::IsSupported,
       "The given MLAlgorithm is not supported by MetaInfoExtractor");
@@ -225,6 +270,135 @@ class CVBase
   MLAlgorithm TrainModel(const MatType& xs,
                          const PredictionsType& ys,
                          const MLAlgorithmArgs&... args);
+
+  /**
+   * Train the given model again if MLAlgorithm doesn't take the numClasses
+   * parameter.
+   */
+  template<bool Enabled = !MIE::TakesNumClasses,
+           typename = typename std::enable_if<Enabled>::type>
+  void RetrainModel(MLAlgorithm& model,
+                    const MatType& xs,
+                    const PredictionsType& ys);
+
+  /**
+   * Train the given model again if MLAlgorithm takes the numClasses parameter.
+   */
+  template<bool Enabled = MIE::TakesNumClasses & !MIE::TakesDatasetInfo,
+           typename = typename std::enable_if<Enabled>::type,
+           typename = void>
+  void RetrainModel(MLAlgorithm& model,
+                    const MatType& xs,
+                    const PredictionsType& ys);
+
+  /**
+   * Train the given model again if MLAlgorithm takes the numClasses parameter
+   * and a data::DatasetInfo parameter.
+   */
+  template<bool Enabled = MIE::TakesNumClasses & MIE::TakesDatasetInfo,
+           typename = typename std::enable_if<Enabled>::type,
+           typename = void,
+           typename = void>
+  void RetrainModel(MLAlgorithm& model,
+                    const MatType& xs,
+                    const PredictionsType& ys);
+
+  /**
+   * Train the given model again with weights if MLAlgorithm doesn't take the
+   * numClasses parameter.
+   */
+  template<bool Enabled = !MIE::TakesNumClasses,
+           typename = typename std::enable_if<Enabled>::type>
+  void RetrainModel(MLAlgorithm& model,
+                    const MatType& xs,
+                    const PredictionsType& ys,
+                    const WeightsType& weights);
+
+  /**
+   * Train the given model again with weights if MLAlgorithm takes the
+   * numClasses parameter.
+   */
+  template<bool Enabled = MIE::TakesNumClasses & !MIE::TakesDatasetInfo,
+           typename = typename std::enable_if<Enabled>::type,
+           typename = void>
+  void RetrainModel(MLAlgorithm& model,
+                    const MatType& xs,
+                    const PredictionsType& ys,
+                    const WeightsType& weights);
+
+  /**
+   * Train the given model again with weights if MLAlgorithm takes the
+   * numClasses parameter and a data::DatasetInfo parameter.
+   */
+  template<bool Enabled = MIE::TakesNumClasses & MIE::TakesDatasetInfo,
+           typename = typename std::enable_if<Enabled>::type,
+           typename = void,
+           typename = void>
+  void RetrainModel(MLAlgorithm& model,
+                    const MatType& xs,
+                    const PredictionsType& ys,
+                    const WeightsType& weights);
+
+  /**
+   * Call model.Train(args...) when MLAlgorithm has such a Train() method.
+   */
+  template<typename... TrainArgs>
+  static auto CallTrain(MLAlgorithm& model,
+                        int /* preferred */,
+                        const TrainArgs&... args)
+      -> decltype(model.Train(args...), void());
+
+  /**
+   * Throw an exception when MLAlgorithm can't be trained with the given
+   * arguments.
+   */
+  template<typename... TrainArgs>
+  static void CallTrain(MLAlgorithm& model,
+                        long /* fallback */,
+                        const TrainArgs&... args);
+
+  /**
+   * Continue training from a copy of the previous model.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm ContinueModel(std::true_type /* supportsWarmStart */,
+                            const MLAlgorithm& previous,
+                            const MatType& xs,
+                            const PredictionsType& ys,
+                            const MLAlgorithmArgs&... args);
+
+  /**
+   * Train from scratch, since MLAlgorithm doesn't support warm starts.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm ContinueModel(std::false_type /* supportsWarmStart */,
+                            const MLAlgorithm& previous,
+                            const MatType& xs,
+                            const PredictionsType& ys,
+                            const MLAlgorithmArgs&... args);
+
+  /**
+   * Continue weighted training from a copy of the previous model.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm ContinueWeightedModel(std::true_type /* supportsWarmStart */,
+                                    const MLAlgorithm& previous,
+                                    const MatType& xs,
+                                    const PredictionsType& ys,
+                                    const WeightsType& weights,
+                                    const MLAlgorithmArgs&... args);
+
+  /**
+   * Train with weights from scratch, since MLAlgorithm doesn't support warm
+   * starts.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm ContinueWeightedModel(std::false_type /* supportsWarmStart */,
+                                    const MLAlgorithm& previous,
+                                    const MatType& xs,
+                                    const PredictionsType& ys,
+                                    const WeightsType& weights,
+                                    const MLAlgorithmArgs&... args);
 };
 
 } // namespace cv
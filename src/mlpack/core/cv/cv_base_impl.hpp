@@ -94,6 +94,171 @@ MLAlgorithm CVBase<MLAlgorithm,
   return TrainModel(xs, ys, weights, args...);
 }
 
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::Retrain(MLAlgorithm& model,
+                                  const MatType& xs,
+                                  const PredictionsType& ys)
+{
+  RetrainModel(model, xs, ys);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::Retrain(MLAlgorithm& model,
+                                  const MatType& xs,
+                                  const PredictionsType& ys,
+                                  const WeightsType& weights)
+{
+  RetrainModel(model, xs, ys, weights);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... TrainArgs>
+auto CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::CallTrain(MLAlgorithm& model,
+                                    int /* preferred */,
+                                    const TrainArgs&... args)
+    -> decltype(model.Train(args...), void())
+{
+  model.Train(args...);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... TrainArgs>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::CallTrain(MLAlgorithm& /* model */,
+                                    long /* fallback */,
+                                    const TrainArgs&... /* args */)
+{
+  throw std::invalid_argument("The given MLAlgorithm has no Train() method "
+      "that takes only data, so its models can't be trained again");
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<bool Enabled, typename>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::RetrainModel(MLAlgorithm& model,
+                                       const MatType& xs,
+                                       const PredictionsType& ys)
+{
+  CallTrain(model, 0, xs, ys);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<bool Enabled, typename, typename>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::RetrainModel(MLAlgorithm& model,
+                                       const MatType& xs,
+                                       const PredictionsType& ys)
+{
+  CallTrain(model, 0, xs, ys, numClasses);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<bool Enabled, typename, typename, typename>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::RetrainModel(MLAlgorithm& model,
+                                       const MatType& xs,
+                                       const PredictionsType& ys)
+{
+  if (!isDatasetInfoPassed)
+    throw std::invalid_argument(
+        "Training the given MLAlgorithm again requires a data::DatasetInfo "
+        "parameter");
+
+  CallTrain(model, 0, xs, datasetInfo, ys, numClasses);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<bool Enabled, typename>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::RetrainModel(MLAlgorithm& model,
+                                       const MatType& xs,
+                                       const PredictionsType& ys,
+                                       const WeightsType& weights)
+{
+  CallTrain(model, 0, xs, ys, weights);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<bool Enabled, typename, typename>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::RetrainModel(MLAlgorithm& model,
+                                       const MatType& xs,
+                                       const PredictionsType& ys,
+                                       const WeightsType& weights)
+{
+  CallTrain(model, 0, xs, ys, numClasses, weights);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<bool Enabled, typename, typename, typename>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::RetrainModel(MLAlgorithm& model,
+                                       const MatType& xs,
+                                       const PredictionsType& ys,
+                                       const WeightsType& weights)
+{
+  if (!isDatasetInfoPassed)
+    throw std::invalid_argument(
+        "Training the given MLAlgorithm again requires a data::DatasetInfo "
+        "parameter");
+
+  CallTrain(model, 0, xs, datasetInfo, ys, numClasses,
+      weights);
+}
+
 template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
@@ -311,6 +476,126 @@ MLAlgorithm CVBase<MLAlgorithm,
   return MLAlgorithm(xs, datasetInfo, ys, numClasses, args...);
 }
 
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::Continue(const MLAlgorithm& previous,
+                                          const MatType& xs,
+                                          const PredictionsType& ys,
+                                          const MLAlgorithmArgs&... args)
+{
+  return ContinueModel(std::integral_constant<bool,
+      WarmStartTraits<MLAlgorithm>::SupportsWarmStart>(), previous, xs, ys,
+      args...);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::ContinueWeighted(
+    const MLAlgorithm& previous,
+    const MatType& xs,
+    const PredictionsType& ys,
+    const WeightsType& weights,
+    const MLAlgorithmArgs&... args)
+{
+  return ContinueWeightedModel(std::integral_constant<bool,
+      WarmStartTraits<MLAlgorithm>::SupportsWarmStart>(), previous, xs, ys,
+      weights, args...);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::ContinueModel(
+    std::true_type /* supportsWarmStart */,
+    const MLAlgorithm& previous,
+    const MatType& xs,
+    const PredictionsType& ys,
+    const MLAlgorithmArgs&... args)
+{
+  MLAlgorithm model(previous);
+  WarmStartTraits<MLAlgorithm>::SetHyperParameters(model, args...);
+  Retrain(model, xs, ys);
+
+  return model;
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::ContinueModel(
+    std::false_type /* supportsWarmStart */,
+    const MLAlgorithm& /* previous */,
+    const MatType& xs,
+    const PredictionsType& ys,
+    const MLAlgorithmArgs&... args)
+{
+  return Train(xs, ys, args...);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::ContinueWeightedModel(
+    std::true_type /* supportsWarmStart */,
+    const MLAlgorithm& previous,
+    const MatType& xs,
+    const PredictionsType& ys,
+    const WeightsType& weights,
+    const MLAlgorithmArgs&... args)
+{
+  MLAlgorithm model(previous);
+  WarmStartTraits<MLAlgorithm>::SetHyperParameters(model, args...);
+  Retrain(model, xs, ys, weights);
+
+  return model;
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm CVBase<MLAlgorithm,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::ContinueWeightedModel(
+    std::false_type /* supportsWarmStart */,
+    const MLAlgorithm& /* previous */,
+    const MatType& xs,
+    const PredictionsType& ys,
+    const WeightsType& weights,
+    const MLAlgorithmArgs&... args)
+{
+  return Train(xs, ys, weights, args...);
+}
+
 } // namespace cv
 } // namespace mlpack
 
@@ -14,6 +14,7 @@
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/cv/cv_base.hpp>
+#include <mlpack/core/cv/metrics/multi_metric.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -40,6 +41,15 @@ namespace cv {
  * double softmaxAccuracy = cv.Evaluate(lambda);
  * @endcode
  *
+ * The training subsets are views of the data rather than copies: the data is
+ * stored once, extended by its first k - 2 bins, so that every training subset
+ * is a contiguous block of it.  With Parallel() the folds are trained at once
+ * (each on its own model), and with WarmStart() each fold instead starts
+ * training from the model of the previous fold.  With Continuation() each
+ * fold starts from its own model of the previous call to Evaluate(), which
+ * speeds up a search over a path of hyper-parameters for models that
+ * specialize WarmStartTraits.
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -152,6 +162,18 @@ class KFoldCV
           const size_t numClasses,
           const WeightsType& weights);
 
+  /**
+   * Copy the given k-fold cross-validation object, including its data and the
+   * model from its last run (if there is one), so that several copies can run
+   * at once.
+   *
+   * @param other Object to copy.
+   */
+  KFoldCV(const KFoldCV& other);
+
+  //! Move the given k-fold cross-validation object.
+  KFoldCV(KFoldCV&& other) = default;
+
   /**
    * Run k-fold cross-validation.
    *
@@ -161,9 +183,83 @@ class KFoldCV
   template<typename... MLAlgorithmArgs>
   double Evaluate(const MLAlgorithmArgs& ...args);
 
+  /**
+   * Run k-fold cross-validation, and calculate several metrics of the trained
+   * models with MultiMetric, so that a classifier classifies each validation
+   * subset only once for Accuracy, Precision, Recall and F1.  For example:
+   *
+   * @code
+   * arma::vec values = cv.EvaluateMetrics<Precision<Binary>, Recall<Binary>,
+   *     F1<Binary>>(lambda);
+   * @endcode
+   *
+   * @param args Arguments for MLAlgorithm (in addition to the passed
+   *     ones in the constructor).
+   * @return The mean of each metric over the folds, in the order of Metrics.
+   */
+  template<typename... Metrics, typename... MLAlgorithmArgs>
+  arma::vec EvaluateMetrics(const MLAlgorithmArgs&... args);
+
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get whether the folds are trained and evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the folds are trained and evaluated in parallel.  The
+  //! training of MLAlgorithm must then be safe to run concurrently.
+  bool& Parallel() { return parallel; }
+
+  /**
+   * Get whether each fold starts training from the model of the previous fold
+   * (see WarmStart()).
+   */
+  bool WarmStart() const { return warmStart; }
+
+  /**
+   * Modify whether each fold starts training from the model of the previous
+   * fold.  The first model is constructed with the hyper-parameters, and each
+   * following fold calls Train() on the model from the previous fold, which
+   * helps when MLAlgorithm::Train() starts from the current model (as
+   * LogisticRegression's does) and keeps the hyper-parameters.  The folds are
+   * then trained in order, even with Parallel().  The previous model has seen
+   * the validation subset of the next fold, so the estimate can be a bit
+   * optimistic.
+   */
+  bool& WarmStart() { return warmStart; }
+
+  /**
+   * Get whether each fold starts training from its model of the previous call
+   * to Evaluate() (see Continuation()).
+   */
+  bool Continuation() const { return continuation; }
+
+  /**
+   * Modify whether each fold starts training from its model of the previous
+   * call to Evaluate().  The previous model takes the new hyper-parameters
+   * with WarmStartTraits<MLAlgorithm>::SetHyperParameters() and is then
+   * trained again on the same fold, so that neighbouring points of a
+   * hyper-parameter search converge in a few iterations.  This has no effect
+   * when WarmStartTraits is not specialized for MLAlgorithm.  With WarmStart()
+   * the first fold starts from the last model of the previous call.
+   */
+  bool& Continuation() { return continuation; }
+
+  //! Get the number of folds (k).
+  size_t K() const { return k; }
+
+  //! Get the number of folds that Evaluate() trains and assesses (see
+  //! Folds()).
+  size_t Folds() const { return folds; }
+
+  /**
+   * Modify the number of folds that Evaluate() trains and assesses; only the
+   * first Folds() of the k folds are run, and the result is their mean.  This
+   * lets a hyper-parameter search (such as SuccessiveHalving) assess a set of
+   * hyper-parameters cheaply before spending all k folds on it.  The default is
+   * k.
+   */
+  size_t& Folds() { return folds; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -190,6 +286,21 @@ class KFoldCV
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! Whether the folds are trained and evaluated in parallel.
+  bool parallel;
+
+  //! Whether each fold starts training from the model of the previous fold.
+  bool warmStart;
+
+  //! Whether each fold starts from its model of the previous run.
+  bool continuation;
+
+  //! The model of each fold from the last run (with continuation).
+  std::vector<std::unique_ptr<MLAlgorithm>> foldModels;
+
+  //! The number of folds to run.
+  size_t folds;
+
   /**
    * Assert the k parameter and data consistency and initialize fields required
    * for running k-fold cross-validation.
@@ -217,21 +328,49 @@ class KFoldCV
   void InitKFoldCVMat(const DataType& source, DataType& destination);
 
   /**
-   * Train and run evaluation in the case of non-weighted learning.
+   * Train and run evaluation with the given MultiMetric in the case of
+   * non-weighted learning.
    */
-  template<typename...MLAlgorithmArgs,
+  template<typename EvaluatorType,
+           typename... MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  arma::vec TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
-   * Train and run evaluation in the case of supporting weighted learning.
+   * Train and run evaluation with the given MultiMetric in the case of
+   * supporting weighted learning.
    */
-  template<typename...MLAlgorithmArgs,
+  template<typename EvaluatorType,
+           typename... MLAlgorithmArgs,
            bool Enabled = Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  arma::vec TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+
+  /**
+   * Get the number of folds to run, after checking that it is between 1 and
+   * k.
+   */
+  size_t FoldsToRun() const;
+
+  /**
+   * Train the model of the ith fold, from the given previous model if it is
+   * not null.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm TrainFold(const size_t i,
+                        const MLAlgorithm* previous,
+                        const MLAlgorithmArgs&... args);
+
+  /**
+   * Train the model of the ith fold with the weights (if they are given),
+   * from the given previous model if it is not null.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm TrainWeightedFold(const size_t i,
+                                const MLAlgorithm* previous,
+                                const MLAlgorithmArgs&... args);
 
   /**
    * Calculate the index of the first column of the ith validation subset.
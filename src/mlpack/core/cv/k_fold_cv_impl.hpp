@@ -127,7 +127,12 @@ KFoldCV<MLAlgorithm,
                               const size_t k,
                               const MatType& xs,
                               const PredictionsType& ys) :
-  base(std::move(base)), k(k)
+  base(std::move(base)),
+  k(k),
+  parallel(false),
+  warmStart(false),
+  continuation(false),
+  folds(k)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -159,6 +164,33 @@ KFoldCV<MLAlgorithm,
   InitKFoldCVMat(weights, this->weights);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+KFoldCV<MLAlgorithm,
+        Metric,
+        MatType,
+        PredictionsType,
+        WeightsType>::KFoldCV(const KFoldCV& other) :
+    base(other.base),
+    k(other.k),
+    xs(other.xs),
+    ys(other.ys),
+    weights(other.weights),
+    binSize(other.binSize),
+    trainingSubsetSize(other.trainingSubsetSize),
+    modelPtr(other.modelPtr ? new MLAlgorithm(*other.modelPtr) : nullptr),
+    parallel(other.parallel),
+    warmStart(other.warmStart),
+    continuation(other.continuation),
+    folds(other.folds)
+{
+  for (const std::unique_ptr<MLAlgorithm>& foldModel : other.foldModels)
+    foldModels.emplace_back(foldModel ? new MLAlgorithm(*foldModel) : nullptr);
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -171,7 +203,22 @@ double KFoldCV<MLAlgorithm,
                PredictionsType,
                WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
-  return TrainAndEvaluate(args...);
+  return TrainAndEvaluate<MultiMetric<Metric>>(args...)[0];
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... Metrics, typename... MLAlgorithmArgs>
+arma::vec KFoldCV<MLAlgorithm,
+                  Metric,
+                  MatType,
+                  PredictionsType,
+                  WeightsType>::EvaluateMetrics(const MLAlgorithmArgs&... args)
+{
+  return TrainAndEvaluate<MultiMetric<Metrics...>>(args...);
 }
 
 template<typename MLAlgorithm,
@@ -217,26 +264,56 @@ template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
          typename WeightsType>
-template<typename... MLAlgorithmArgs, bool Enabled, typename>
-double KFoldCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+template<typename EvaluatorType,
+         typename... MLAlgorithmArgs,
+         bool Enabled,
+         typename>
+arma::vec KFoldCV<MLAlgorithm,
+                  Metric,
+                  MatType,
+                  PredictionsType,
+                  WeightsType>::TrainAndEvaluate(
+    const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
+  const size_t numFolds = FoldsToRun();
+  arma::mat evaluations(EvaluatorType::NumMetrics, numFolds);
 
-  for (size_t i = 0; i < k; ++i)
+  if (warmStart)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
+    // Each fold starts from the model of the previous one.
+    MLAlgorithm model = TrainFold(0, continuation ? modelPtr.get() : nullptr,
+        args...);
+    evaluations.col(0) = EvaluatorType::Evaluate(model,
+        GetValidationSubset(xs, 0), GetValidationSubset(ys, 0));
+    for (size_t i = 1; i < numFolds; ++i)
+    {
+      base.Retrain(model, GetTrainingSubset(xs, i), GetTrainingSubset(ys, i));
+      evaluations.col(i) = EvaluatorType::Evaluate(model,
+          GetValidationSubset(xs, i), GetValidationSubset(ys, i));
+    }
+    modelPtr.reset(new MLAlgorithm(std::move(model)));
+
+    return arma::mean(evaluations, 1);
+  }
+
+  // Each fold trains its own model on read-only views of the data (starting
+  // from its model of the last run with continuation).
+  if (continuation)
+    foldModels.resize(k);
+  #pragma omp parallel for schedule(dynamic) if (parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) numFolds; ++i)
+  {
+    MLAlgorithm&& model = TrainFold(i,
+        continuation ? foldModels[i].get() : nullptr, args...);
+    evaluations.col(i) = EvaluatorType::Evaluate(model,
+        GetValidationSubset(xs, i), GetValidationSubset(ys, i));
+    if (continuation)
+      foldModels[i].reset(new MLAlgorithm(model));
+    if ((size_t) i == numFolds - 1)
       modelPtr.reset(new MLAlgorithm(std::move(model)));
   }
 
-  return arma::mean(evaluations);
+  return arma::mean(evaluations, 1);
 }
 
 template<typename MLAlgorithm,
@@ -244,29 +321,135 @@ template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
          typename WeightsType>
-template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
-double KFoldCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+template<typename EvaluatorType,
+         typename... MLAlgorithmArgs,
+         bool Enabled,
+         typename,
+         typename>
+arma::vec KFoldCV<MLAlgorithm,
+                  Metric,
+                  MatType,
+                  PredictionsType,
+                  WeightsType>::TrainAndEvaluate(
+    const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
+  const size_t numFolds = FoldsToRun();
+  arma::mat evaluations(EvaluatorType::NumMetrics, numFolds);
 
-  for (size_t i = 0; i < k; ++i)
+  if (warmStart)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            GetTrainingSubset(weights, i), args...) :
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
+    // Each fold starts from the model of the previous one.
+    MLAlgorithm model = TrainWeightedFold(0,
+        continuation ? modelPtr.get() : nullptr, args...);
+    evaluations.col(0) = EvaluatorType::Evaluate(model,
+        GetValidationSubset(xs, 0), GetValidationSubset(ys, 0));
+    for (size_t i = 1; i < numFolds; ++i)
+    {
+      if (weights.n_elem > 0)
+        base.Retrain(model, GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+            GetTrainingSubset(weights, i));
+      else
+        base.Retrain(model, GetTrainingSubset(xs, i), GetTrainingSubset(ys, i));
+      evaluations.col(i) = EvaluatorType::Evaluate(model,
+          GetValidationSubset(xs, i), GetValidationSubset(ys, i));
+    }
+    modelPtr.reset(new MLAlgorithm(std::move(model)));
+
+    return arma::mean(evaluations, 1);
+  }
+
+  // Each fold trains its own model on read-only views of the data (starting
+  // from its model of the last run with continuation).
+  if (continuation)
+    foldModels.resize(k);
+  #pragma omp parallel for schedule(dynamic) if (parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) numFolds; ++i)
+  {
+    MLAlgorithm&& model = TrainWeightedFold(i,
+        continuation ? foldModels[i].get() : nullptr, args...);
+    evaluations.col(i) = EvaluatorType::Evaluate(model,
+        GetValidationSubset(xs, i), GetValidationSubset(ys, i));
+    if (continuation)
+      foldModels[i].reset(new MLAlgorithm(model));
+    if ((size_t) i == numFolds - 1)
       modelPtr.reset(new MLAlgorithm(std::move(model)));
   }
 
-  return arma::mean(evaluations);
+  return arma::mean(evaluations, 1);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::FoldsToRun() const
+{
+  if (folds == 0 || folds > k)
+  {
+    std::ostringstream oss;
+    oss << "KFoldCV: the number of folds to run (" << folds << ") should be "
+        << "between 1 and k (" << k << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return folds;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm KFoldCV<MLAlgorithm,
+                    Metric,
+                    MatType,
+                    PredictionsType,
+                    WeightsType>::TrainFold(const size_t i,
+                                            const MLAlgorithm* previous,
+                                            const MLAlgorithmArgs&... args)
+{
+  if (previous)
+  {
+    return base.Continue(*previous, GetTrainingSubset(xs, i),
+        GetTrainingSubset(ys, i), args...);
+  }
+
+  return base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+      args...);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm KFoldCV<MLAlgorithm,
+                    Metric,
+                    MatType,
+                    PredictionsType,
+                    WeightsType>::TrainWeightedFold(
+    const size_t i,
+    const MLAlgorithm* previous,
+    const MLAlgorithmArgs&... args)
+{
+  if (weights.n_elem == 0)
+    return TrainFold(i, previous, args...);
+
+  if (previous)
+  {
+    return base.ContinueWeighted(*previous, GetTrainingSubset(xs, i),
+        GetTrainingSubset(ys, i), GetTrainingSubset(weights, i), args...);
+  }
+
+  return base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+      GetTrainingSubset(weights, i), args...);
 }
 
 template<typename MLAlgorithm,
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_CV_METRICS_ACCURACY_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/cv/metrics/confusion_matrix.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -37,6 +38,13 @@ class Accuracy
                          const DataType& data,
                          const arma::Row<size_t>& labels);
 
+  /**
+   * Calculate accuracy from the confusion matrix of a classification.
+   *
+   * @param confusion The confusion matrix.
+   */
+  static double Evaluate(const ConfusionMatrix& confusion);
+
   /**
    * Information for hyper-parameter tuning code. It indicates that we want
    * to maximize the metric.
@@ -31,6 +31,11 @@ double Accuracy::Evaluate(MLAlgorithm& model,
   return (double) amountOfCorrectPredictions / labels.n_elem;
 }
 
+inline double Accuracy::Evaluate(const ConfusionMatrix& confusion)
+{
+  return (double) confusion.Correct() / confusion.Points();
+}
+
 } // namespace cv
 } // namespace mlpack
 
@@ -0,0 +1,111 @@
+/**
+ * @file confusion_matrix.hpp
+ *
+ * The confusion matrix of a classification, from which all the classification
+ * metrics can be calculated.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CV_METRICS_CONFUSION_MATRIX_HPP
+#define MLPACK_CORE_CV_METRICS_CONFUSION_MATRIX_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace cv {
+
+/**
+ * The confusion matrix of the predicted labels of some test items against their
+ * ground truth labels: the number of items of every class that have been given
+ * every label.  Accuracy, Precision, Recall and F1 can all be calculated from
+ * it, so a model needs to classify the test items only once for all of them
+ * (see MultiMetric).  The items are counted in parallel.
+ *
+ * As for the metrics, in the case of multiclass classification it is assumed
+ * that there are instances of every label from 0 to max(labels) among the test
+ * items; Classes() is max(labels) + 1.
+ */
+class ConfusionMatrix
+{
+ public:
+  /**
+   * Count the given predicted labels against the given ground truth labels.
+   *
+   * @param labels Ground truth (correct) labels for the test items.
+   * @param predictedLabels Predicted labels for the test items.
+   */
+  ConfusionMatrix(const arma::Row<size_t>& labels,
+                  const arma::Row<size_t>& predictedLabels);
+
+  /**
+   * Run classification with the given model, and count the predicted labels
+   * against the given ground truth labels.
+   *
+   * @param model A classification model.
+   * @param data Column-major data containing test items.
+   * @param labels Ground truth (correct) labels for the test items.
+   */
+  template<typename MLAlgorithm, typename DataType>
+  ConfusionMatrix(MLAlgorithm& model,
+                  const DataType& data,
+                  const arma::Row<size_t>& labels);
+
+  //! Get the number of classes, max(labels) + 1.
+  size_t Classes() const { return classes; }
+
+  //! Get the number of test items.
+  size_t Points() const { return points; }
+
+  //! Get the counts: element (i, j) is the number of items of class i that
+  //! have been given label j.  The size is one more than the largest label
+  //! or prediction.
+  const arma::Mat<size_t>& Counts() const { return counts; }
+
+  //! Get the number of items of class c that have been given label c.
+  size_t TruePositives(const size_t c) const
+  {
+    return (c < counts.n_rows) ? counts(c, c) : 0;
+  }
+
+  //! Get the number of items that have been given label c.
+  size_t Predictions(const size_t c) const
+  {
+    return (c < predictions.n_elem) ? predictions[c] : 0;
+  }
+
+  //! Get the number of items of class c.
+  size_t Instances(const size_t c) const
+  {
+    return (c < instances.n_elem) ? instances[c] : 0;
+  }
+
+  //! Get the number of items that have been given their correct label.
+  size_t Correct() const { return arma::accu(counts.diag()); }
+
+ private:
+  //! Count the labels.
+  void Count(const arma::Row<size_t>& labels,
+             const arma::Row<size_t>& predictedLabels);
+
+  //! The number of classes.
+  size_t classes;
+  //! The number of test items.
+  size_t points;
+  //! The counts.
+  arma::Mat<size_t> counts;
+  //! The number of items given each label (the sums of the columns).
+  arma::Col<size_t> predictions;
+  //! The number of items of each class (the sums of the rows).
+  arma::Col<size_t> instances;
+};
+
+} // namespace cv
+} // namespace mlpack
+
+// Include implementation.
+#include "confusion_matrix_impl.hpp"
+
+#endif
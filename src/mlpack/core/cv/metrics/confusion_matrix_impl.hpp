@@ -0,0 +1,76 @@
+/**
+ * @file confusion_matrix_impl.hpp
+ *
+ * Implementation of the class ConfusionMatrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CV_METRICS_CONFUSION_MATRIX_IMPL_HPP
+#define MLPACK_CORE_CV_METRICS_CONFUSION_MATRIX_IMPL_HPP
+
+#include <mlpack/core/cv/metrics/facilities.hpp>
+
+namespace mlpack {
+namespace cv {
+
+inline ConfusionMatrix::ConfusionMatrix(
+    const arma::Row<size_t>& labels,
+    const arma::Row<size_t>& predictedLabels)
+{
+  Count(labels, predictedLabels);
+}
+
+template<typename MLAlgorithm, typename DataType>
+ConfusionMatrix::ConfusionMatrix(MLAlgorithm& model,
+                                 const DataType& data,
+                                 const arma::Row<size_t>& labels)
+{
+  AssertSizes(data, labels, "ConfusionMatrix::ConfusionMatrix()");
+
+  arma::Row<size_t> predictedLabels;
+  model.Classify(data, predictedLabels);
+  Count(labels, predictedLabels);
+}
+
+inline void ConfusionMatrix::Count(const arma::Row<size_t>& labels,
+                                   const arma::Row<size_t>& predictedLabels)
+{
+  if (labels.n_elem != predictedLabels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "ConfusionMatrix::ConfusionMatrix(): number of labels ("
+        << labels.n_elem << ") does not match number of predicted labels ("
+        << predictedLabels.n_elem << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  points = labels.n_elem;
+  classes = (points == 0) ? 0 : arma::max(labels) + 1;
+  const size_t size = (points == 0) ? 0 :
+      std::max(classes, (size_t) arma::max(predictedLabels) + 1);
+
+  // Each thread counts a part of the items.
+  counts.zeros(size, size);
+  #pragma omp parallel
+  {
+    arma::Mat<size_t> threadCounts(size, size, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) points; ++i)
+      ++threadCounts(labels[i], predictedLabels[i]);
+
+    #pragma omp critical
+    counts += threadCounts;
+  }
+
+  predictions = arma::sum(counts, 0).t();
+  instances = arma::sum(counts, 1);
+}
+
+} // namespace cv
+} // namespace mlpack
+
+#endif
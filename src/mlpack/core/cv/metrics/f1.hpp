@@ -16,6 +16,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/cv/metrics/average_strategy.hpp>
+#include <mlpack/core/cv/metrics/confusion_matrix.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -57,6 +58,13 @@ class F1
                          const DataType& data,
                          const arma::Row<size_t>& labels);
 
+  /**
+   * Calculate F1 from the confusion matrix of a classification.
+   *
+   * @param confusion The confusion matrix.
+   */
+  static double Evaluate(const ConfusionMatrix& confusion);
+
   /**
    * Information for hyper-parameter tuning code. It indicates that we want
    * to maximize the metric.
@@ -65,40 +73,28 @@ class F1
 
  private:
   /**
-   * Run classification and calculate F1 for binary classification.
+   * Calculate F1 for binary classification.
    */
   template<AverageStrategy _AS,
-           typename MLAlgorithm,
-           typename DataType,
            typename = std::enable_if_t<_AS == Binary>>
-  static double Evaluate(MLAlgorithm& model,
-                        const DataType& data,
-                        const arma::Row<size_t>& labels);
+  static double Evaluate(const ConfusionMatrix& confusion);
 
   /**
-   * Run classification and calculate microaveraged F1.
+   * Calculate microaveraged F1.
    */
   template<AverageStrategy _AS,
-           typename MLAlgorithm,
-           typename DataType,
            typename = std::enable_if_t<_AS == Micro>,
            typename = void>
-  static double Evaluate(MLAlgorithm& model,
-                        const DataType& data,
-                        const arma::Row<size_t>& labels);
+  static double Evaluate(const ConfusionMatrix& confusion);
 
   /**
-   * Run classification and calculate macroaveraged F1.
+   * Calculate macroaveraged F1.
    */
   template<AverageStrategy _AS,
-           typename MLAlgorithm,
-           typename DataType,
            typename = std::enable_if_t<_AS == Macro>,
            typename = void,
            typename = void>
-  static double Evaluate(MLAlgorithm& model,
-                        const DataType& data,
-                        const arma::Row<size_t>& labels);
+  static double Evaluate(const ConfusionMatrix& confusion);
 };
 
 } // namespace cv
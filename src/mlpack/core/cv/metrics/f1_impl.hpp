@@ -24,68 +24,48 @@ double F1<AS, PC>::Evaluate(MLAlgorithm& model,
                             const DataType& data,
                             const arma::Row<size_t>& labels)
 {
-  return Evaluate<AS>(model, data, labels);
+  AssertSizes(data, labels, "F1::Evaluate()");
+
+  return Evaluate<AS>(ConfusionMatrix(model, data, labels));
 }
 
 template<AverageStrategy AS, size_t PC /* PositiveClass */>
-template<AverageStrategy _AS, typename MLAlgorithm, typename DataType, typename>
-double F1<AS, PC>::Evaluate(MLAlgorithm& model,
-                            const DataType& data,
-                            const arma::Row<size_t>& labels)
+double F1<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
 {
-  AssertSizes(data, labels, "F1<Binary>::Evaluate()");
-
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
-
-  size_t tp = arma::sum((labels == PC) % (predictedLabels == PC));
-  size_t numberOfPositivePredictions = arma::sum(predictedLabels == PC);
-  size_t numberOfPositiveClassInstances = arma::sum(labels == PC);
+  return Evaluate<AS>(confusion);
+}
 
-  double precision = double(tp) / numberOfPositivePredictions;
-  double recall = double(tp) / numberOfPositiveClassInstances;
+template<AverageStrategy AS, size_t PC /* PositiveClass */>
+template<AverageStrategy _AS, typename>
+double F1<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
+{
+  const double tp = confusion.TruePositives(PC);
+  const double precision = tp / confusion.Predictions(PC);
+  const double recall = tp / confusion.Instances(PC);
 
   return (precision + recall == 0.0) ? 0.0 :
       2.0 * precision * recall / (precision + recall);
 }
 
 template<AverageStrategy AS, size_t PC /* PositiveClass */>
-template<AverageStrategy _AS, typename MLAlgorithm, typename DataType, typename,
-    typename>
-double F1<AS, PC>::Evaluate(MLAlgorithm& model,
-                            const DataType& data,
-                            const arma::Row<size_t>& labels)
+template<AverageStrategy _AS, typename, typename>
+double F1<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
 {
-  AssertSizes(data, labels, "F1<Micro>::Evaluate()");
-
   // Microaveraged F1 is really the same as microaveraged precision and
   // microaveraged recall, which are in turn the same as accuracy.
-  return Accuracy::Evaluate(model, data, labels);
+  return Accuracy::Evaluate(confusion);
 }
 
 template<AverageStrategy AS, size_t PC /* PositiveClass */>
-template<AverageStrategy _AS, typename MLAlgorithm, typename DataType, typename,
-    typename, typename>
-double F1<AS, PC>::Evaluate(MLAlgorithm& model,
-                            const DataType& data,
-                            const arma::Row<size_t>& labels)
+template<AverageStrategy _AS, typename, typename, typename>
+double F1<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
 {
-  AssertSizes(data, labels, "F1<Macro>::Evaluate()");
-
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
-
-  size_t numClasses = arma::max(labels) + 1;
-
-  arma::vec f1s = arma::vec(numClasses);
-  for (size_t c = 0; c < numClasses; ++c)
+  arma::vec f1s = arma::vec(confusion.Classes());
+  for (size_t c = 0; c < confusion.Classes(); ++c)
   {
-    size_t tp = arma::sum((labels == c) % (predictedLabels == c));
-    size_t numberOfPositivePredictions = arma::sum(predictedLabels == c);
-    size_t numberOfClassInstances = arma::sum(labels == c);
-
-    double precision = double(tp) / numberOfPositivePredictions;
-    double recall = double(tp) / numberOfClassInstances;
+    const double tp = confusion.TruePositives(c);
+    const double precision = tp / confusion.Predictions(c);
+    const double recall = tp / confusion.Instances(c);
     f1s(c) = (precision + recall == 0.0) ? 0.0 :
         2.0 * precision * recall / (precision + recall);
   }
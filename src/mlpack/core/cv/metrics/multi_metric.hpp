@@ -0,0 +1,110 @@
+/**
+ * @file multi_metric.hpp
+ *
+ * Evaluation of several metrics with a single run of the model.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CV_METRICS_MULTI_METRIC_HPP
+#define MLPACK_CORE_CV_METRICS_MULTI_METRIC_HPP
+
+#include <type_traits>
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/cv/metrics/confusion_matrix.hpp>
+
+namespace mlpack {
+namespace cv {
+
+/**
+ * A type trait that is true if the given metric can be calculated from a
+ * ConfusionMatrix (that is, it has a static Evaluate(const ConfusionMatrix&)
+ * method), as Accuracy, Precision, Recall and F1 can.
+ */
+template<typename Metric, typename = void>
+struct UsesConfusionMatrix : std::false_type { };
+
+template<typename Metric>
+struct UsesConfusionMatrix<Metric, decltype((void) Metric::Evaluate(
+    std::declval<const ConfusionMatrix&>()))> : std::true_type { };
+
+//! True if all the given metrics can be calculated from a ConfusionMatrix.
+template<typename... Metrics>
+struct AllUseConfusionMatrix : std::true_type { };
+
+template<typename Metric, typename... Metrics>
+struct AllUseConfusionMatrix<Metric, Metrics...> :
+    std::integral_constant<bool, UsesConfusionMatrix<Metric>::value &&
+        AllUseConfusionMatrix<Metrics...>::value> { };
+
+/**
+ * MultiMetric evaluates several metrics of a model at once.  When all of them
+ * can be calculated from a ConfusionMatrix, the model classifies the test items
+ * only once, and every metric is calculated from the counts; otherwise each
+ * metric is evaluated on its own.  For example, the precision, recall and F1
+ * of a classifier can be calculated with
+ *
+ * @code
+ * arma::vec values = MultiMetric<Precision<Binary>, Recall<Binary>,
+ *     F1<Binary>>::Evaluate(model, data, labels);
+ * @endcode
+ *
+ * KFoldCV::EvaluateMetrics() and SimpleCV::EvaluateMetrics() use it to
+ * evaluate several metrics of each trained model.
+ *
+ * @tparam Metrics The metrics to evaluate.
+ */
+template<typename... Metrics>
+class MultiMetric
+{
+ public:
+  //! The number of metrics.
+  static const size_t NumMetrics = sizeof...(Metrics);
+
+  /**
+   * Run the model once if possible, and calculate all the metrics.
+   *
+   * @param model A model.
+   * @param data Column-major data containing test items.
+   * @param ys Ground truth (correct) labels or responses for the test items.
+   * @return The values of the metrics, in the order of Metrics.
+   */
+  template<typename MLAlgorithm, typename DataType, typename PredictionsType>
+  static arma::vec Evaluate(MLAlgorithm& model,
+                            const DataType& data,
+                            const PredictionsType& ys);
+
+  /**
+   * Calculate all the metrics from the confusion matrix of a classification.
+   *
+   * @param confusion The confusion matrix.
+   * @return The values of the metrics, in the order of Metrics.
+   */
+  static arma::vec Evaluate(const ConfusionMatrix& confusion);
+
+ private:
+  //! Evaluate the metrics from a single confusion matrix.
+  template<typename MLAlgorithm, typename DataType, typename PredictionsType>
+  static arma::vec Evaluate(MLAlgorithm& model,
+                            const DataType& data,
+                            const PredictionsType& ys,
+                            std::true_type /* usesConfusionMatrix */);
+
+  //! Evaluate every metric on its own.
+  template<typename MLAlgorithm, typename DataType, typename PredictionsType>
+  static arma::vec Evaluate(MLAlgorithm& model,
+                            const DataType& data,
+                            const PredictionsType& ys,
+                            std::false_type /* usesConfusionMatrix */);
+};
+
+} // namespace cv
+} // namespace mlpack
+
+// Include implementation.
+#include "multi_metric_impl.hpp"
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file multi_metric_impl.hpp
+ *
+ * Implementation of the class MultiMetric.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CV_METRICS_MULTI_METRIC_IMPL_HPP
+#define MLPACK_CORE_CV_METRICS_MULTI_METRIC_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "multi_metric.hpp"
+
+namespace mlpack {
+namespace cv {
+
+template<typename... Metrics>
+template<typename MLAlgorithm, typename DataType, typename PredictionsType>
+arma::vec MultiMetric<Metrics...>::Evaluate(MLAlgorithm& model,
+                                            const DataType& data,
+                                            const PredictionsType& ys)
+{
+  return Evaluate(model, data, ys, std::integral_constant<bool,
+      AllUseConfusionMatrix<Metrics...>::value>());
+}
+
+template<typename... Metrics>
+arma::vec MultiMetric<Metrics...>::Evaluate(const ConfusionMatrix& confusion)
+{
+  return arma::vec({ double(Metrics::Evaluate(confusion))... });
+}
+
+template<typename... Metrics>
+template<typename MLAlgorithm, typename DataType, typename PredictionsType>
+arma::vec MultiMetric<Metrics...>::Evaluate(MLAlgorithm& model,
+                                            const DataType& data,
+                                            const PredictionsType& ys,
+                                            std::true_type)
+{
+  return Evaluate(ConfusionMatrix(model, data, ys));
+}
+
+template<typename... Metrics>
+template<typename MLAlgorithm, typename DataType, typename PredictionsType>
+arma::vec MultiMetric<Metrics...>::Evaluate(MLAlgorithm& model,
+                                            const DataType& data,
+                                            const PredictionsType& ys,
+                                            std::false_type)
+{
+  return arma::vec({ double(Metrics::Evaluate(model, data, ys))... });
+}
+
+} // namespace cv
+} // namespace mlpack
+
+#endif
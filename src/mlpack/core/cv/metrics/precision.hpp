@@ -14,6 +14,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/cv/metrics/average_strategy.hpp>
+#include <mlpack/core/cv/metrics/confusion_matrix.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -60,6 +61,13 @@ class Precision
                          const DataType& data,
                          const arma::Row<size_t>& labels);
 
+  /**
+   * Calculate precision from the confusion matrix of a classification.
+   *
+   * @param confusion The confusion matrix.
+   */
+  static double Evaluate(const ConfusionMatrix& confusion);
+
   /**
    * Information for hyper-parameter tuning code. It indicates that we want
    * to maximize the metric.
@@ -68,40 +76,28 @@ class Precision
 
  private:
   /**
-   * Run classification and calculate precision for binary classification.
+   * Calculate precision for binary classification.
    */
   template<AverageStrategy _AS,
-           typename MLAlgorithm,
-           typename DataType,
            typename = std::enable_if_t<_AS == Binary>>
-  static double Evaluate(MLAlgorithm& model,
-                        const DataType& data,
-                        const arma::Row<size_t>& labels);
+  static double Evaluate(const ConfusionMatrix& confusion);
 
   /**
-   * Run classification and calculate microaveraged precision.
+   * Calculate microaveraged precision.
    */
   template<AverageStrategy _AS,
-           typename MLAlgorithm,
-           typename DataType,
            typename = std::enable_if_t<_AS == Micro>,
            typename = void>
-  static double Evaluate(MLAlgorithm& model,
-                        const DataType& data,
-                        const arma::Row<size_t>& labels);
+  static double Evaluate(const ConfusionMatrix& confusion);
 
   /**
-   * Run classification and calculate macroaveraged precision.
+   * Calculate macroaveraged precision.
    */
   template<AverageStrategy _AS,
-           typename MLAlgorithm,
-           typename DataType,
            typename = std::enable_if_t<_AS == Macro>,
            typename = void,
            typename = void>
-  static double Evaluate(MLAlgorithm& model,
-                        const DataType& data,
-                        const arma::Row<size_t>& labels);
+  static double Evaluate(const ConfusionMatrix& confusion);
 };
 
 } // namespace cv
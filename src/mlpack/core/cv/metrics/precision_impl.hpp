@@ -24,59 +24,41 @@ double Precision<AS, PC>::Evaluate(MLAlgorithm& model,
                                    const DataType& data,
                                    const arma::Row<size_t>& labels)
 {
-  return Evaluate<AS>(model, data, labels);
+  AssertSizes(data, labels, "Precision::Evaluate()");
+
+  return Evaluate<AS>(ConfusionMatrix(model, data, labels));
 }
 
 template<AverageStrategy AS, size_t PC /* PositiveClass */>
-template<AverageStrategy _AS, typename MLAlgorithm, typename DataType, typename>
-double Precision<AS, PC>::Evaluate(MLAlgorithm& model,
-                                   const DataType& data,
-                                   const arma::Row<size_t>& labels)
+double Precision<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
 {
-  AssertSizes(data, labels, "Precision<Binary>::Evaluate()");
-
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
-
-  size_t tp = arma::sum((labels == PC) % (predictedLabels == PC));
-  size_t numberOfPositivePredictions = arma::sum(predictedLabels == PC);
-
-  return double(tp) / numberOfPositivePredictions;
+  return Evaluate<AS>(confusion);
 }
 
 template<AverageStrategy AS, size_t PC /* PositiveClass */>
-template<AverageStrategy _AS, typename MLAlgorithm, typename DataType, typename,
-    typename>
-double Precision<AS, PC>::Evaluate(MLAlgorithm& model,
-                                   const DataType& data,
-                                   const arma::Row<size_t>& labels)
+template<AverageStrategy _AS, typename>
+double Precision<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
 {
-  AssertSizes(data, labels, "Precision<Micro>::Evaluate()");
+  return double(confusion.TruePositives(PC)) / confusion.Predictions(PC);
+}
 
+template<AverageStrategy AS, size_t PC /* PositiveClass */>
+template<AverageStrategy _AS, typename, typename>
+double Precision<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
+{
   // Microaveraged precision turns out to be just accuracy.
-  return Accuracy::Evaluate(model, data, labels);
+  return Accuracy::Evaluate(confusion);
 }
 
 template<AverageStrategy AS, size_t PC /* PositiveClass */>
-template<AverageStrategy _AS, typename MLAlgorithm, typename DataType, typename,
-    typename, typename>
-double Precision<AS, PC>::Evaluate(MLAlgorithm& model,
-                                   const DataType& data,
-                                   const arma::Row<size_t>& labels)
+template<AverageStrategy _AS, typename, typename, typename>
+double Precision<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
 {
-  AssertSizes(data, labels, "Precision<Macro>::Evaluate()");
-
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
-
-  size_t numClasses = arma::max(labels) + 1;
-
-  arma::vec precisions = arma::vec(numClasses);
-  for (size_t c = 0; c < numClasses; ++c)
+  arma::vec precisions = arma::vec(confusion.Classes());
+  for (size_t c = 0; c < confusion.Classes(); ++c)
   {
-    size_t tp = arma::sum((labels == c) % (predictedLabels == c));
-    size_t numberOfPositivePredictions = arma::sum(predictedLabels == c);
-    precisions(c) = double(tp) / numberOfPositivePredictions;
+    precisions(c) = double(confusion.TruePositives(c)) /
+        confusion.Predictions(c);
   }
 
   return arma::mean(precisions);
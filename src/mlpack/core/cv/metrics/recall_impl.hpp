@@ -24,59 +24,41 @@ double Recall<AS, PC>::Evaluate(MLAlgorithm& model,
                                 const DataType& data,
                                 const arma::Row<size_t>& labels)
 {
-  return Evaluate<AS>(model, data, labels);
+  AssertSizes(data, labels, "Recall::Evaluate()");
+
+  return Evaluate<AS>(ConfusionMatrix(model, data, labels));
 }
 
 template<AverageStrategy AS, size_t PC /* PositiveClass */>
-template<AverageStrategy _AS, typename MLAlgorithm, typename DataType, typename>
-double Recall<AS, PC>::Evaluate(MLAlgorithm& model,
-                                const DataType& data,
-                                const arma::Row<size_t>& labels)
+double Recall<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
 {
-  AssertSizes(data, labels, "Recall<Binary>::Evaluate()");
-
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
-
-  size_t tp = arma::sum((labels == PC) % (predictedLabels == PC));
-  size_t numberOfPositiveClassInstances = arma::sum(labels == PC);
-
-  return double(tp) / numberOfPositiveClassInstances;
+  return Evaluate<AS>(confusion);
 }
 
 template<AverageStrategy AS, size_t PC /* PositiveClass */>
-template<AverageStrategy _AS, typename MLAlgorithm, typename DataType, typename,
-    typename>
-double Recall<AS, PC>::Evaluate(MLAlgorithm& model,
-                                const DataType& data,
-                                const arma::Row<size_t>& labels)
+template<AverageStrategy _AS, typename>
+double Recall<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
 {
-  AssertSizes(data, labels, "Recall<Micro>::Evaluate()");
+  return double(confusion.TruePositives(PC)) / confusion.Instances(PC);
+}
 
+template<AverageStrategy AS, size_t PC /* PositiveClass */>
+template<AverageStrategy _AS, typename, typename>
+double Recall<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
+{
   // Microaveraged recall is really the same as accuracy.
-  return Accuracy::Evaluate(model, data, labels);
+  return Accuracy::Evaluate(confusion);
 }
 
 template<AverageStrategy AS, size_t PC /* PositiveClass */>
-template<AverageStrategy _AS, typename MLAlgorithm, typename DataType, typename,
-    typename, typename>
-double Recall<AS, PC>::Evaluate(MLAlgorithm& model,
-                                const DataType& data,
-                                const arma::Row<size_t>& labels)
+template<AverageStrategy _AS, typename, typename, typename>
+double Recall<AS, PC>::Evaluate(const ConfusionMatrix& confusion)
 {
-  AssertSizes(data, labels, "Recall<Macro>::Evaluate()");
-
-  arma::Row<size_t> predictedLabels;
-  model.Classify(data, predictedLabels);
-
-  size_t numClasses = arma::max(labels) + 1;
-
-  arma::vec recalls = arma::vec(numClasses);
-  for (size_t c = 0; c < numClasses; ++c)
+  arma::vec recalls = arma::vec(confusion.Classes());
+  for (size_t c = 0; c < confusion.Classes(); ++c)
   {
-    size_t tp = arma::sum((labels == c) % (predictedLabels == c));
-    size_t numberOfClassInstances = arma::sum(labels == c);
-    recalls(c) = double(tp) / numberOfClassInstances;
+    recalls(c) = double(confusion.TruePositives(c)) /
+        confusion.Instances(c);
   }
 
   return arma::mean(recalls);
@@ -14,6 +14,7 @@
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/cv/cv_base.hpp>
+#include <mlpack/core/cv/metrics/multi_metric.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -198,6 +199,17 @@ class SimpleCV
            const size_t numClasses,
            WeightsInType&& weights);
 
+  /**
+   * Copy the given cross-validation object, including its data and the last
+   * trained model (if there is one), so that several copies can run at once.
+   *
+   * @param other Object to copy.
+   */
+  SimpleCV(const SimpleCV& other);
+
+  //! Move the given cross-validation object.
+  SimpleCV(SimpleCV&& other) = default;
+
   /**
    * Train on the training set and assess performance on the validation set by
    * using the class Metric.
@@ -208,9 +220,41 @@ class SimpleCV
   template<typename... MLAlgorithmArgs>
   double Evaluate(const MLAlgorithmArgs&... args);
 
+  /**
+   * Run cross-validation, and calculate several metrics of the trained model
+   * with MultiMetric, so that a classifier classifies the validation set only
+   * once for Accuracy, Precision, Recall and F1.  For example:
+   *
+   * @code
+   * arma::vec values = cv.EvaluateMetrics<Precision<Binary>, Recall<Binary>,
+   *     F1<Binary>>(lambda);
+   * @endcode
+   *
+   * @param args Arguments for MLAlgorithm (in addition to the passed
+   *     ones in the constructor).
+   * @return The value of each metric, in the order of Metrics.
+   */
+  template<typename... Metrics, typename... MLAlgorithmArgs>
+  arma::vec EvaluateMetrics(const MLAlgorithmArgs&... args);
+
   //! Access and modify the last trained model.
   MLAlgorithm& Model();
 
+  /**
+   * Get whether training starts from the model of the previous call to
+   * Evaluate() (see Continuation()).
+   */
+  bool Continuation() const { return continuation; }
+
+  /**
+   * Modify whether training starts from the model of the previous call to
+   * Evaluate().  The previous model takes the new hyper-parameters with
+   * WarmStartTraits<MLAlgorithm>::SetHyperParameters() and is then trained
+   * again, which speeds up a search over a path of hyper-parameters.  This has
+   * no effect when WarmStartTraits is not specialized for MLAlgorithm.
+   */
+  bool& Continuation() { return continuation; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -240,6 +284,9 @@ class SimpleCV
   //! The pointer to the last trained model.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! Whether training starts from the model of the previous run.
+  bool continuation;
+
   /**
    * Assert data consistency and initialize fields required for running
    * cross-validation.
@@ -286,21 +333,25 @@ class SimpleCV
                                    const size_t lastCol);
 
   /**
-   * Train and run evaluation in the case of non-weighted learning.
+   * Train and run evaluation with the given MultiMetric in the case of
+   * non-weighted learning.
    */
-  template<typename... MLAlgorithmArgs,
+  template<typename EvaluatorType,
+           typename... MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type>
-  double TrainAndEvaluate(const MLAlgorithmArgs&... args);
+  arma::vec TrainAndEvaluate(const MLAlgorithmArgs&... args);
 
   /**
-   * Train and run evaluation in the case of supporting weighted learning.
+   * Train and run evaluation with the given MultiMetric in the case of
+   * supporting weighted learning.
    */
-  template<typename... MLAlgorithmArgs,
+  template<typename EvaluatorType,
+           typename... MLAlgorithmArgs,
            bool Enabled = Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs&... args);
+  arma::vec TrainAndEvaluate(const MLAlgorithmArgs&... args);
 };
 
 } // namespace cv
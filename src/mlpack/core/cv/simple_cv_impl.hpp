@@ -143,7 +143,8 @@ SimpleCV<MLAlgorithm,
                                 PIT&& ys) :
     base(std::move(base)),
     xs(std::forward<MIT>(xs)),
-    ys(std::forward<PIT>(ys))
+    ys(std::forward<PIT>(ys)),
+    continuation(false)
 {
   Base::AssertDataConsistency(this->xs, this->ys);
 
@@ -182,6 +183,29 @@ SimpleCV<MLAlgorithm,
   trainingWeights = GetSubset(this->weights, 0, trainingXs.n_cols - 1);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+SimpleCV<MLAlgorithm,
+         Metric,
+         MatType,
+         PredictionsType,
+         WeightsType>::SimpleCV(const SimpleCV& other) :
+    base(other.base),
+    xs(other.xs),
+    ys(other.ys),
+    weights(other.weights),
+    trainingXs(other.trainingXs),
+    trainingYs(other.trainingYs),
+    trainingWeights(other.trainingWeights),
+    validationXs(other.validationXs),
+    validationYs(other.validationYs),
+    modelPtr(other.modelPtr ? new MLAlgorithm(*other.modelPtr) : nullptr),
+    continuation(other.continuation)
+{ /* Nothing left to do. */ }
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -194,7 +218,22 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
-  return TrainAndEvaluate(args...);
+  return TrainAndEvaluate<MultiMetric<Metric>>(args...)[0];
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... Metrics, typename... MLAlgorithmArgs>
+arma::vec SimpleCV<MLAlgorithm,
+                   Metric,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::EvaluateMetrics(const MLAlgorithmArgs&... args)
+{
+  return TrainAndEvaluate<MultiMetric<Metrics...>>(args...);
 }
 
 template<typename MLAlgorithm,
@@ -286,16 +325,25 @@ template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
          typename WeightsType>
-template<typename... MLAlgorithmArgs, bool Enabled, typename>
-double SimpleCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+template<typename EvaluatorType,
+         typename... MLAlgorithmArgs,
+         bool Enabled,
+         typename>
+arma::vec SimpleCV<MLAlgorithm,
+                   Metric,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::TrainAndEvaluate(
+    const MLAlgorithmArgs&... args)
 {
-  modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  if (continuation && modelPtr)
+    modelPtr.reset(new MLAlgorithm(
+        base.Continue(*modelPtr, trainingXs, trainingYs, args...)));
+  else
+    modelPtr.reset(new MLAlgorithm(
+        base.Train(trainingXs, trainingYs, args...)));
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return EvaluatorType::Evaluate(*modelPtr, validationXs, validationYs);
 }
 
 template<typename MLAlgorithm,
@@ -303,21 +351,32 @@ template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
          typename WeightsType>
-template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
-double SimpleCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+template<typename EvaluatorType,
+         typename... MLAlgorithmArgs,
+         bool Enabled,
+         typename,
+         typename>
+arma::vec SimpleCV<MLAlgorithm,
+                   Metric,
+                   MatType,
+                   PredictionsType,
+                   WeightsType>::TrainAndEvaluate(
+    const MLAlgorithmArgs&... args)
 {
-  if (trainingWeights.n_elem > 0)
+  if (continuation && modelPtr && trainingWeights.n_elem > 0)
+    modelPtr.reset(new MLAlgorithm(base.ContinueWeighted(*modelPtr,
+        trainingXs, trainingYs, trainingWeights, args...)));
+  else if (continuation && modelPtr)
+    modelPtr.reset(new MLAlgorithm(
+        base.Continue(*modelPtr, trainingXs, trainingYs, args...)));
+  else if (trainingWeights.n_elem > 0)
     modelPtr.reset(new MLAlgorithm(
         base.Train(trainingXs, trainingYs, trainingWeights, args...)));
   else
     modelPtr.reset(new MLAlgorithm(
         base.Train(trainingXs, trainingYs, args...)));
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return EvaluatorType::Evaluate(*modelPtr, validationXs, validationYs);
 }
 
 } // namespace cv
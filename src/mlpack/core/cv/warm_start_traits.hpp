@@ -0,0 +1,60 @@
+/**
+ * @file warm_start_traits.hpp
+ *
+ * The traits that let a machine learning algorithm continue training from a
+ * model trained with other hyper-parameters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CV_WARM_START_TRAITS_HPP
+#define MLPACK_CORE_CV_WARM_START_TRAITS_HPP
+
+namespace mlpack {
+namespace cv {
+
+/**
+ * WarmStartTraits tells cross-validation whether a machine learning algorithm
+ * can train a model for new hyper-parameters starting from the model trained
+ * for other ones, as iterative algorithms can: when neighboring
+ * hyper-parameters are evaluated one after the other (a regularization path,
+ * or a grid search with HyperParameterTuner), each model then starts close to
+ * its solution.  See KFoldCV::Continuation() and SimpleCV::Continuation().
+ *
+ * By default algorithms don't support it.  An algorithm opts in with a
+ * specialization like
+ *
+ * @code
+ * template<typename MatType>
+ * struct WarmStartTraits<LogisticRegression<MatType>>
+ * {
+ *   static const bool SupportsWarmStart = true;
+ *
+ *   static void SetHyperParameters(LogisticRegression<MatType>& model,
+ *                                  const double lambda = 0)
+ *   {
+ *     model.Lambda() = lambda;
+ *   }
+ * };
+ * @endcode
+ *
+ * SetHyperParameters() is called on a copy of the previous model with the
+ * hyper-parameters that would be passed to the constructor after the data (and
+ * numClasses and datasetInfo), and the copy is then trained with the Train()
+ * method that takes only the data (see CVBase::Retrain()), which must start
+ * from the current parameters of the model.
+ */
+template<typename MLAlgorithm>
+struct WarmStartTraits
+{
+  //! Whether models can start training from a model trained with other
+  //! hyper-parameters.
+  static const bool SupportsWarmStart = false;
+};
+
+} // namespace cv
+} // namespace mlpack
+
+#endif
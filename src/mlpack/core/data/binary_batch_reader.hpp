@@ -0,0 +1,110 @@
+/**
+ * @file binary_batch_reader.hpp
+ *
+ * Read an Armadillo binary file one batch of points at a time, so that
+ * datasets larger than memory can be streamed to a learner.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BINARY_BATCH_READER_HPP
+#define MLPACK_CORE_DATA_BINARY_BATCH_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A BinaryBatchReader reads an Armadillo binary (arma_binary) file a batch of
+ * points at a time, seeking directly to each batch, so only the current batch
+ * is ever in memory.  Like data::Load(), by default the file is taken to hold
+ * one point per row (as data::Save() writes it); if it holds one point per
+ * column (as SaveMappable() writes it), each batch is a single contiguous
+ * read.
+ *
+ * A reader is a loader for the Update() methods of the learners (such as
+ * LogisticRegression::Update() or GMM::Update()): it is called as
+ * reader(batch), or as reader(predictors, labels) to take the labels from the
+ * last dimension, and returns false when the file is exhausted.
+ *
+ * @tparam eT Element type of the file.
+ */
+template<typename eT = double>
+class BinaryBatchReader
+{
+ public:
+  /**
+   * Open the given file and read its header.  Throws std::runtime_error if it
+   * cannot be opened or is not an Armadillo binary file for the element type.
+   *
+   * @param filename Name of the file to read.
+   * @param batchSize Number of points in each batch.
+   * @param transpose If true, the file holds one point per row.
+   */
+  BinaryBatchReader(const std::string& filename,
+                    const size_t batchSize = 1000,
+                    const bool transpose = true);
+
+  /**
+   * Read the next batch of points.  Throws std::runtime_error if the file is
+   * truncated.
+   *
+   * @param batch Matrix to store the batch in.
+   * @return false if there are no more points.
+   */
+  bool operator()(arma::Mat<eT>& batch);
+
+  /**
+   * Read the next batch of points, taking the labels (or responses) from the
+   * last dimension.
+   *
+   * @tparam LabelsType Type of the labels (such as arma::Row<size_t>).
+   * @param predictors Matrix to store the predictors of the batch in.
+   * @param labels Object to store the labels of the batch in.
+   * @return false if there are no more points.
+   */
+  template<typename LabelsType>
+  bool operator()(arma::Mat<eT>& predictors, LabelsType& labels);
+
+  //! Go back to the first point.
+  void Reset() { stream.clear(); next = 0; }
+
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return transpose ? fileCols : fileRows; }
+  //! Get the number of points in the file.
+  size_t Points() const { return transpose ? fileRows : fileCols; }
+
+ private:
+  //! Name of the file.
+  std::string filename;
+  //! The open file.
+  std::ifstream stream;
+  //! Number of points in each batch.
+  size_t batchSize;
+  //! Whether the file holds one point per row.
+  bool transpose;
+  //! Number of rows of the stored matrix.
+  size_t fileRows;
+  //! Number of columns of the stored matrix.
+  size_t fileCols;
+  //! Offset of the data in the file.
+  std::streamoff offset;
+  //! Index of the next point to read.
+  size_t next;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "binary_batch_reader_impl.hpp"
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file binary_batch_reader_impl.hpp
+ *
+ * Implementation of BinaryBatchReader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BINARY_BATCH_READER_IMPL_HPP
+#define MLPACK_CORE_DATA_BINARY_BATCH_READER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "binary_batch_reader.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+BinaryBatchReader<eT>::BinaryBatchReader(const std::string& filename,
+                                         const size_t batchSize,
+                                         const bool transpose) :
+    filename(filename),
+    stream(filename.c_str(), std::fstream::binary),
+    batchSize(batchSize),
+    transpose(transpose),
+    fileRows(0),
+    fileCols(0),
+    offset(0),
+    next(0)
+{
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "BinaryBatchReader::BinaryBatchReader(): cannot open file '"
+        << filename << "'!";
+    throw std::runtime_error(oss.str());
+  }
+
+  // Read the header the same way arma::Mat::load() does.
+  const std::string expected = arma::diskio::gen_bin_header(arma::Mat<eT>());
+  std::string token;
+  stream >> token >> fileRows >> fileCols;
+  stream.get();
+  if (stream.fail() || token != expected)
+  {
+    std::ostringstream oss;
+    oss << "BinaryBatchReader::BinaryBatchReader(): '" << filename << "' is "
+        << "not an Armadillo binary file with header '" << expected << "'!";
+    throw std::runtime_error(oss.str());
+  }
+
+  offset = stream.tellg();
+}
+
+template<typename eT>
+bool BinaryBatchReader<eT>::operator()(arma::Mat<eT>& batch)
+{
+  const size_t points = Points();
+  if (next >= points)
+    return false;
+
+  const size_t dimensionality = Dimensionality();
+  const size_t count = std::min(std::max(batchSize, size_t(1)), points - next);
+  batch.set_size(dimensionality, count);
+
+  if (!transpose)
+  {
+    // The points of the batch are contiguous.
+    stream.seekg(offset + std::streamoff(next * fileRows * sizeof(eT)));
+    stream.read(reinterpret_cast<char*>(batch.memptr()),
+        std::streamsize(batch.n_elem * sizeof(eT)));
+  }
+  else
+  {
+    // Each dimension of the batch is a contiguous run of one column.
+    arma::Col<eT> values(count);
+    for (size_t d = 0; d < dimensionality && stream.good(); ++d)
+    {
+      stream.seekg(offset + std::streamoff((d * fileRows + next) *
+          sizeof(eT)));
+      stream.read(reinterpret_cast<char*>(values.memptr()),
+          std::streamsize(count * sizeof(eT)));
+      batch.row(d) = values.t();
+    }
+  }
+
+  if (!stream.good())
+  {
+    std::ostringstream oss;
+    oss << "BinaryBatchReader: '" << filename << "' is truncated!";
+    throw std::runtime_error(oss.str());
+  }
+
+  next += count;
+  return true;
+}
+
+template<typename eT>
+template<typename LabelsType>
+bool BinaryBatchReader<eT>::operator()(arma::Mat<eT>& predictors,
+                                       LabelsType& labels)
+{
+  if (!(*this)(predictors))
+    return false;
+
+  if (predictors.n_rows < 2)
+  {
+    std::ostringstream oss;
+    oss << "BinaryBatchReader: '" << filename << "' has dimensionality 1, so "
+        << "it has no labels!";
+    throw std::runtime_error(oss.str());
+  }
+
+  labels = arma::conv_to<LabelsType>::from(
+      predictors.row(predictors.n_rows - 1));
+  predictors.shed_row(predictors.n_rows - 1);
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
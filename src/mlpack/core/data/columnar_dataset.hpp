@@ -0,0 +1,124 @@
+/**
+ * @file columnar_dataset.hpp
+ *
+ * A binary format that stores a dataset one dimension after another, together
+ * with its DatasetInfo, so that it can be reloaded (or memory-mapped) without
+ * parsing text or rebuilding the mappings.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COLUMNAR_DATASET_HPP
+#define MLPACK_CORE_DATA_COLUMNAR_DATASET_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_mapper.hpp"
+#include "mapped_matrix.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Save a dataset and its DatasetInfo in the columnar dataset format.  The
+ * file is the transposed matrix (one row per point, so each dimension is
+ * contiguous) in the format of SaveMappable(), with the data aligned to 64
+ * bytes, followed by the DatasetInfo (the types of the dimensions and the
+ * mappings of the categorical dimensions) as a text archive.  Because the
+ * matrix comes first, data::Load() can also load the file as an Armadillo
+ * binary matrix (if it has the .bin extension), in which case the DatasetInfo
+ * is ignored.
+ *
+ * @param filename Name of the file to save to.
+ * @param matrix Dataset to save, with one point per column.
+ * @param info DatasetInfo of the dataset.
+ * @param fatal If true, an error will cause a Log::Fatal.
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT>
+bool SaveColumnar(const std::string& filename,
+                  const arma::Mat<eT>& matrix,
+                  const DatasetInfo& info,
+                  const bool fatal = false);
+
+/**
+ * Load a dataset and its DatasetInfo saved with SaveColumnar().  The matrix
+ * has one point per column, as with data::Load().
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load the dataset into.
+ * @param info DatasetInfo to load the types and mappings into.
+ * @param fatal If true, an error will cause a Log::Fatal.
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool LoadColumnar(const std::string& filename,
+                  arma::Mat<eT>& matrix,
+                  DatasetInfo& info,
+                  const bool fatal = false);
+
+/**
+ * Load only the given dimensions of a dataset saved with SaveColumnar(); only
+ * those dimensions are read from the file.  Dimension i of the loaded matrix
+ * and DatasetInfo is dimension dimensions[i] of the saved dataset.
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load the selected dimensions into.
+ * @param info DatasetInfo to load the types and mappings of the selected
+ *     dimensions into.
+ * @param dimensions Dimensions to load.
+ * @param fatal If true, an error will cause a Log::Fatal.
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool LoadColumnar(const std::string& filename,
+                  arma::Mat<eT>& matrix,
+                  DatasetInfo& info,
+                  const std::vector<size_t>& dimensions,
+                  const bool fatal = false);
+
+/**
+ * A MappedColumnarDataset memory-maps a file saved with SaveColumnar(), so
+ * that it can be opened many times (or by many processes) at almost no cost.
+ * The data is exposed as a read-only matrix with one row per point and one
+ * column per dimension, so each dimension is a contiguous column;
+ * Columns().t() gives a matrix with one point per column.
+ *
+ * @tparam eT Element type of the dataset.
+ */
+template<typename eT>
+class MappedColumnarDataset
+{
+ public:
+  /**
+   * Map the given file and load its DatasetInfo.  Throws std::runtime_error
+   * if the file is not a valid columnar dataset for the element type.
+   *
+   * @param filename Name of the file to map.
+   */
+  MappedColumnarDataset(const std::string& filename);
+
+  //! Get the matrix, with one row per point and one column per dimension.
+  const arma::Mat<eT>& Columns() const { return mapped.Matrix(); }
+  //! Get the DatasetInfo of the dataset.
+  const DatasetInfo& Info() const { return info; }
+
+  //! Return whether or not the data is an alias of the mapped file.
+  bool Mapped() const { return mapped.Mapped(); }
+
+ private:
+  //! The mapped matrix.
+  MappedMatrix<eT> mapped;
+  //! The DatasetInfo of the dataset.
+  DatasetInfo info;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "columnar_dataset_impl.hpp"
+
+#endif
@@ -0,0 +1,273 @@
+/**
+ * @file columnar_dataset_impl.hpp
+ *
+ * Implementation of the columnar dataset format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COLUMNAR_DATASET_IMPL_HPP
+#define MLPACK_CORE_DATA_COLUMNAR_DATASET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "columnar_dataset.hpp"
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+
+namespace mlpack {
+namespace data {
+namespace columnar {
+
+/**
+ * Open a columnar dataset and read the header of its matrix.  Throws
+ * std::runtime_error on errors.
+ */
+template<typename eT>
+void OpenColumnar(const std::string& filename,
+                  std::ifstream& stream,
+                  size_t& points,
+                  size_t& dimensionality,
+                  std::streamoff& offset)
+{
+  stream.open(filename.c_str(), std::fstream::binary);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'; load failed.";
+    throw std::runtime_error(oss.str());
+  }
+
+  const std::string expected = arma::diskio::gen_bin_header(arma::Mat<eT>());
+  std::string token;
+  stream >> token >> points >> dimensionality;
+  stream.get();
+  if (stream.fail() || token != expected)
+  {
+    std::ostringstream oss;
+    oss << "'" << filename << "' is not a columnar dataset with header '"
+        << expected << "'; load failed.";
+    throw std::runtime_error(oss.str());
+  }
+
+  offset = stream.tellg();
+}
+
+/**
+ * Read the DatasetInfo, which follows the matrix, of an open columnar
+ * dataset.  Throws std::runtime_error on errors.
+ */
+template<typename eT>
+void ReadColumnarInfo(const std::string& filename,
+                      std::ifstream& stream,
+                      const size_t points,
+                      const size_t dimensionality,
+                      const std::streamoff offset,
+                      DatasetInfo& info)
+{
+  stream.clear();
+  stream.seekg(offset + std::streamoff(points * dimensionality * sizeof(eT)));
+
+  try
+  {
+    boost::archive::text_iarchive ar(stream);
+    ar >> boost::serialization::make_nvp("info", info);
+  }
+  catch (boost::archive::archive_exception& e)
+  {
+    std::ostringstream oss;
+    oss << "Cannot read the DatasetInfo of '" << filename << "': " << e.what();
+    throw std::runtime_error(oss.str());
+  }
+
+  if (info.Dimensionality() != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "The DatasetInfo of '" << filename << "' has dimensionality "
+        << info.Dimensionality() << ", but the dataset has dimensionality "
+        << dimensionality << "; load failed.";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+} // namespace columnar
+
+template<typename eT>
+bool SaveColumnar(const std::string& filename,
+                  const arma::Mat<eT>& matrix,
+                  const DatasetInfo& info,
+                  const bool fatal)
+{
+  if (info.Dimensionality() != matrix.n_rows)
+  {
+    if (fatal)
+      Log::Fatal << "DatasetInfo has dimensionality " << info.Dimensionality()
+          << ", but the matrix has dimensionality " << matrix.n_rows << "."
+          << std::endl;
+    else
+      Log::Warn << "DatasetInfo has dimensionality " << info.Dimensionality()
+          << ", but the matrix has dimensionality " << matrix.n_rows << "; "
+          << "save failed." << std::endl;
+
+    return false;
+  }
+
+  // Store one point per row, so that each dimension is contiguous.
+  Timer::Start("saving_data");
+  if (!SaveMappable(filename, arma::Mat<eT>(trans(matrix)), fatal))
+  {
+    Timer::Stop("saving_data");
+    return false;
+  }
+
+  std::ofstream stream(filename.c_str(), std::fstream::binary |
+      std::fstream::app);
+  {
+    boost::archive::text_oarchive ar(stream);
+    ar << boost::serialization::make_nvp("info", info);
+  }
+  Timer::Stop("saving_data");
+
+  if (!stream.good())
+  {
+    if (fatal)
+      Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+template<typename eT>
+bool LoadColumnar(const std::string& filename,
+                  arma::Mat<eT>& matrix,
+                  DatasetInfo& info,
+                  const bool fatal)
+{
+  Timer::Start("loading_data");
+  try
+  {
+    std::ifstream stream;
+    size_t points, dimensionality;
+    std::streamoff offset;
+    columnar::OpenColumnar<eT>(filename, stream, points, dimensionality,
+        offset);
+
+    arma::Mat<eT> columns(points, dimensionality);
+    stream.read(reinterpret_cast<char*>(columns.memptr()),
+        std::streamsize(columns.n_elem * sizeof(eT)));
+    if (!stream.good())
+    {
+      std::ostringstream oss;
+      oss << "'" << filename << "' is truncated; load failed.";
+      throw std::runtime_error(oss.str());
+    }
+
+    columnar::ReadColumnarInfo<eT>(filename, stream, points, dimensionality,
+        offset, info);
+    matrix = trans(columns);
+  }
+  catch (std::exception& e)
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Timer::Stop("loading_data");
+  return true;
+}
+
+template<typename eT>
+bool LoadColumnar(const std::string& filename,
+                  arma::Mat<eT>& matrix,
+                  DatasetInfo& info,
+                  const std::vector<size_t>& dimensions,
+                  const bool fatal)
+{
+  Timer::Start("loading_data");
+  try
+  {
+    std::ifstream stream;
+    size_t points, dimensionality;
+    std::streamoff offset;
+    columnar::OpenColumnar<eT>(filename, stream, points, dimensionality,
+        offset);
+
+    DatasetInfo fullInfo;
+    columnar::ReadColumnarInfo<eT>(filename, stream, points, dimensionality,
+        offset, fullInfo);
+
+    // Read each selected dimension, which is contiguous in the file, and copy
+    // its type and mappings, in order.
+    matrix.set_size(dimensions.size(), points);
+    info = DatasetInfo(dimensions.size());
+    arma::Col<eT> column(points);
+    for (size_t i = 0; i < dimensions.size(); ++i)
+    {
+      const size_t d = dimensions[i];
+      if (d >= dimensionality)
+      {
+        std::ostringstream oss;
+        oss << "Cannot load dimension " << d << " of '" << filename << "', "
+            << "which has dimensionality " << dimensionality << ".";
+        throw std::runtime_error(oss.str());
+      }
+
+      stream.clear();
+      stream.seekg(offset + std::streamoff(d * points * sizeof(eT)));
+      stream.read(reinterpret_cast<char*>(column.memptr()),
+          std::streamsize(points * sizeof(eT)));
+      if (!stream.good())
+      {
+        std::ostringstream oss;
+        oss << "'" << filename << "' is truncated; load failed.";
+        throw std::runtime_error(oss.str());
+      }
+      matrix.row(i) = column.t();
+
+      info.Type(i) = fullInfo.Type(d);
+      for (size_t v = 0; v < fullInfo.NumMappings(d); ++v)
+        info.MapString<size_t>(fullInfo.UnmapString(v, d), i);
+    }
+  }
+  catch (std::exception& e)
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Timer::Stop("loading_data");
+  return true;
+}
+
+template<typename eT>
+MappedColumnarDataset<eT>::MappedColumnarDataset(const std::string& filename) :
+    mapped(filename)
+{
+  std::ifstream stream;
+  size_t points, dimensionality;
+  std::streamoff offset;
+  columnar::OpenColumnar<eT>(filename, stream, points, dimensionality, offset);
+  columnar::ReadColumnarInfo<eT>(filename, stream, points, dimensionality,
+      offset, info);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
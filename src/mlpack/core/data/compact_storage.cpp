@@ -0,0 +1,37 @@
+/**
+ * @file compact_storage.cpp
+ *
+ * Implementation of the compact storage setting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "compact_storage.hpp"
+
+#include <atomic>
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+namespace {
+
+//! Whether models are saved compactly.
+std::atomic<bool>& Compact()
+{
+  static std::atomic<bool> compact(false);
+  return compact;
+}
+
+} // namespace
+
+void CompactStorage::Set(const bool compact)
+{
+  Compact() = compact;
+}
+
+bool CompactStorage::Get()
+{
+  return Compact();
+}
@@ -0,0 +1,130 @@
+/**
+ * @file compact_storage.hpp
+ *
+ * Compact storage of the parameters of saved models: matrices of doubles are
+ * saved in single precision, and matrices of indices in 32 bits if they fit.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COMPACT_STORAGE_HPP
+#define MLPACK_CORE_DATA_COMPACT_STORAGE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The setting of whether models are saved compactly.  When it is enabled, the
+ * models that support it save their largest parameters (for instance, the leaf
+ * distributions of decision trees, the covariances of Gaussians, and the
+ * reference sets and tables of LSHSearch) in single precision, and their
+ * indices in 32 bits when every index fits; the model files are about half as
+ * large.  Loading a model widens the parameters again, so models are used in
+ * full precision whichever way they were saved, and models saved compactly
+ * are loaded like any other.
+ *
+ * Saving in single precision loses precision, so it is disabled by default.
+ * The command-line programs enable it with the --compact_models option.
+ */
+class CompactStorage
+{
+ public:
+  //! Set whether models are saved compactly.
+  static void Set(const bool compact);
+
+  //! Get whether models are saved compactly.
+  static bool Get();
+};
+
+//! The type a matrix element is stored as when it is saved compactly.
+template<typename eT>
+struct CompactElemType
+{
+  //! Whether elements of this type can be stored compactly.
+  static const bool available = false;
+  typedef eT type;
+};
+
+template<>
+struct CompactElemType<double>
+{
+  static const bool available = true;
+  typedef float type;
+};
+
+template<>
+struct CompactElemType<unsigned long>
+{
+  static const bool available = (sizeof(unsigned long) > sizeof(uint32_t));
+  typedef uint32_t type;
+};
+
+template<>
+struct CompactElemType<unsigned long long>
+{
+  static const bool available = true;
+  typedef uint32_t type;
+};
+
+/**
+ * Return whether the given matrix can be stored compactly: the elements of
+ * doubles must be in the range of floats, and the indices must fit in 32 bits.
+ */
+template<typename eT>
+bool CanStoreCompactly(const arma::Mat<eT>& m)
+{
+  if (!CompactElemType<eT>::available)
+    return false;
+  if (m.n_elem == 0)
+    return true;
+
+  const double limit = std::is_floating_point<eT>::value ?
+      (double) std::numeric_limits<float>::max() :
+      (double) std::numeric_limits<uint32_t>::max();
+  return (double) arma::abs(m).max() <= limit;
+}
+
+/**
+ * Serialize the given matrix, compactly if compact storage is enabled and the
+ * matrix can be stored compactly.  A flag saved before the matrix tells how it
+ * was stored, so a model must always serialize the matrix with this function
+ * (it is typically used from a new version of the serialize() function of the
+ * model, so that older model files can still be loaded).
+ *
+ * @param ar Archive to serialize to or from.
+ * @param m Matrix, column or row to serialize.
+ * @param name Name of the matrix in the archive.
+ */
+template<typename Archive, typename MatType>
+void SerializeCompact(Archive& ar, MatType& m, const std::string& name)
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef typename CompactElemType<ElemType>::type StoredType;
+
+  bool compact = false;
+  if (Archive::is_saving::value)
+    compact = CompactStorage::Get() && CanStoreCompactly(m);
+  ar & boost::serialization::make_nvp((name + "Compact").c_str(), compact);
+
+  if (!compact)
+  {
+    ar & boost::serialization::make_nvp(name.c_str(), m);
+    return;
+  }
+
+  arma::Mat<StoredType> stored;
+  if (Archive::is_saving::value)
+    stored = arma::conv_to<arma::Mat<StoredType>>::from(m);
+  ar & boost::serialization::make_nvp(name.c_str(), stored);
+  if (Archive::is_loading::value)
+    m = arma::conv_to<MatType>::from(stored);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file csv_batch_reader.hpp
+ *
+ * Read a numeric CSV file one batch of points at a time, so that datasets
+ * larger than memory can be streamed to a learner.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CSV_BATCH_READER_HPP
+#define MLPACK_CORE_DATA_CSV_BATCH_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "standard_stream.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A CSVBatchReader reads a numeric CSV file (or a whitespace or tab separated
+ * file) a batch of lines at a time; each line is one point, so each batch has
+ * one point per column, as data::Load() gives by default.  Only the current
+ * batch is ever in memory.
+ *
+ * A reader is a loader for the Update() methods of the learners (such as
+ * LogisticRegression::Update() or GMM::Update()): it is called as
+ * reader(batch), or as reader(predictors, labels) to take the labels from the
+ * last column of the file, and returns false when the file is exhausted.
+ *
+ * @code
+ * data::CSVBatchReader<> reader("training.csv", 10000);
+ * regression::LogisticRegression<> lr(dimensionality);
+ * optimization::SGD<> sgd(0.01, 32, 10000);
+ * lr.Update(reader, sgd);
+ * @endcode
+ *
+ * @tparam eT Element type of the batches.
+ */
+template<typename eT = double>
+class CSVBatchReader
+{
+ public:
+  /**
+   * Open the given file.  Throws std::runtime_error if it cannot be opened.
+   * If the filename is "-" (or "-.csv"), the points are read from the standard
+   * input as they arrive, so the batches can be processed while the previous
+   * program of a pipeline is still writing the next ones.
+   *
+   * @param filename Name of the file to read.
+   * @param batchSize Number of points in each batch.
+   */
+  CSVBatchReader(const std::string& filename, const size_t batchSize = 1000);
+
+  /**
+   * Read the next batch of points.  Throws std::runtime_error if a line is not
+   * numeric or has a different number of values than the first line.
+   *
+   * @param batch Matrix to store the batch in.
+   * @return false if there are no more points.
+   */
+  bool operator()(arma::Mat<eT>& batch);
+
+  /**
+   * Read the next batch of points, taking the labels (or responses) from the
+   * last column of the file.
+   *
+   * @tparam LabelsType Type of the labels (such as arma::Row<size_t>).
+   * @param predictors Matrix to store the predictors of the batch in.
+   * @param labels Object to store the labels of the batch in.
+   * @return false if there are no more points.
+   */
+  template<typename LabelsType>
+  bool operator()(arma::Mat<eT>& predictors, LabelsType& labels);
+
+  //! Go back to the start of the file.  Throws std::runtime_error for the
+  //! standard input.
+  void Reset();
+
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of values on each line (0 until the first batch is read).
+  size_t Dimensionality() const { return dimensionality; }
+
+ private:
+  //! Name of the file.
+  std::string filename;
+  //! The open file.
+  std::ifstream stream;
+  //! The stream the points are read from (the file or the standard input).
+  std::istream* input;
+  //! Number of points in each batch.
+  size_t batchSize;
+  //! Number of values on each line.
+  size_t dimensionality;
+  //! Number of lines read, for error messages.
+  size_t lineNumber;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "csv_batch_reader_impl.hpp"
+
+#endif
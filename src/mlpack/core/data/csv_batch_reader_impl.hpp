@@ -0,0 +1,146 @@
+/**
+ * @file csv_batch_reader_impl.hpp
+ *
+ * Implementation of CSVBatchReader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CSV_BATCH_READER_IMPL_HPP
+#define MLPACK_CORE_DATA_CSV_BATCH_READER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "csv_batch_reader.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+CSVBatchReader<eT>::CSVBatchReader(const std::string& filename,
+                                   const size_t batchSize) :
+    filename(filename),
+    batchSize(batchSize),
+    dimensionality(0),
+    lineNumber(0)
+{
+  // "-" is the standard input, which is read as it arrives.
+  if (IsStandardStream(filename))
+  {
+    input = &std::cin;
+    return;
+  }
+
+  stream.open(filename.c_str());
+  input = &stream;
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "CSVBatchReader::CSVBatchReader(): cannot open file '" << filename
+        << "'!";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+template<typename eT>
+bool CSVBatchReader<eT>::operator()(arma::Mat<eT>& batch)
+{
+  std::vector<eT> values;
+  size_t points = 0;
+  std::string line;
+  while (points < std::max(batchSize, size_t(1)) &&
+         std::getline(*input, line))
+  {
+    ++lineNumber;
+
+    // Parse each value; separators may be commas, spaces or tabs.
+    size_t count = 0;
+    const char* position = line.c_str();
+    while (true)
+    {
+      while (*position == ',' || std::isspace((unsigned char) *position))
+        ++position;
+      if (*position == '\0')
+        break;
+
+      char* end;
+      const double value = std::strtod(position, &end);
+      if (end == position)
+      {
+        std::ostringstream oss;
+        oss << "CSVBatchReader: line " << lineNumber << " of '" << filename
+            << "' is not numeric!";
+        throw std::runtime_error(oss.str());
+      }
+
+      values.push_back(eT(value));
+      ++count;
+      position = end;
+    }
+
+    // Skip empty lines.
+    if (count == 0)
+      continue;
+
+    if (dimensionality == 0)
+    {
+      dimensionality = count;
+    }
+    else if (count != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "CSVBatchReader: line " << lineNumber << " of '" << filename
+          << "' has " << count << " values, but the file has dimensionality "
+          << dimensionality << "!";
+      throw std::runtime_error(oss.str());
+    }
+
+    ++points;
+  }
+
+  if (points == 0)
+    return false;
+
+  batch = arma::Mat<eT>(values.data(), dimensionality, points);
+  return true;
+}
+
+template<typename eT>
+template<typename LabelsType>
+bool CSVBatchReader<eT>::operator()(arma::Mat<eT>& predictors,
+                                    LabelsType& labels)
+{
+  if (!(*this)(predictors))
+    return false;
+
+  if (predictors.n_rows < 2)
+  {
+    std::ostringstream oss;
+    oss << "CSVBatchReader: '" << filename << "' has only one column, so it "
+        << "has no labels!";
+    throw std::runtime_error(oss.str());
+  }
+
+  labels = arma::conv_to<LabelsType>::from(
+      predictors.row(predictors.n_rows - 1));
+  predictors.shed_row(predictors.n_rows - 1);
+  return true;
+}
+
+template<typename eT>
+void CSVBatchReader<eT>::Reset()
+{
+  if (input != &stream)
+    throw std::runtime_error("CSVBatchReader::Reset(): cannot go back to the "
+        "start of the standard input!");
+
+  stream.clear();
+  stream.seekg(0);
+  lineNumber = 0;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,189 @@
+/**
+ * @file decompress.cpp
+ *
+ * Implementation of Decompress() and DecompressedStream.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "decompress.hpp"
+
+#ifdef HAS_ZLIB
+  #include <zlib.h>
+#endif
+
+#ifdef HAS_ZSTD
+  #include <zstd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+//! Size of the blocks that compressed files are read in.
+static const size_t blockSize = 1024 * 1024;
+
+//! Throw a std::runtime_error about the given file.
+static void ThrowDecompressError(const std::string& filename,
+                                 const std::string& message)
+{
+  std::ostringstream oss;
+  oss << "Cannot decompress '" << filename << "': " << message << ".";
+  throw std::runtime_error(oss.str());
+}
+
+#ifdef HAS_ZLIB
+//! Decompress a gzip file, which may have several concatenated members.
+static void DecompressGzip(const std::string& filename,
+                           std::ifstream& stream,
+                           std::string& contents)
+{
+  z_stream z;
+  z.zalloc = Z_NULL;
+  z.zfree = Z_NULL;
+  z.opaque = Z_NULL;
+  z.avail_in = 0;
+  z.next_in = Z_NULL;
+  // Adding 16 to the window size makes zlib expect a gzip header.
+  if (inflateInit2(&z, 15 + 16) != Z_OK)
+    ThrowDecompressError(filename, "cannot initialize zlib");
+
+  std::vector<char> in(blockSize), out(blockSize);
+  int result = Z_OK;
+  bool done = false;
+  while (!done)
+  {
+    stream.read(&in[0], in.size());
+    const size_t read = stream.gcount();
+    if (read == 0)
+      break;
+
+    z.next_in = reinterpret_cast<Bytef*>(&in[0]);
+    z.avail_in = read;
+    while (z.avail_in > 0)
+    {
+      z.next_out = reinterpret_cast<Bytef*>(&out[0]);
+      z.avail_out = out.size();
+      result = inflate(&z, Z_NO_FLUSH);
+      if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+      {
+        inflateEnd(&z);
+        ThrowDecompressError(filename, "the file is corrupt");
+      }
+      contents.append(&out[0], out.size() - z.avail_out);
+
+      // Another gzip member may follow the end of this one.
+      if (result == Z_STREAM_END)
+      {
+        if (z.avail_in == 0 && stream.peek() == EOF)
+          done = true;
+        else
+          inflateReset(&z);
+      }
+    }
+  }
+
+  inflateEnd(&z);
+  if (result != Z_STREAM_END)
+    ThrowDecompressError(filename, "the file is truncated");
+}
+#endif
+
+#ifdef HAS_ZSTD
+//! Decompress a zstd file, which may have several concatenated frames.
+static void DecompressZstd(const std::string& filename,
+                           std::ifstream& stream,
+                           std::string& contents)
+{
+  ZSTD_DStream* z = ZSTD_createDStream();
+  if (z == NULL || ZSTD_isError(ZSTD_initDStream(z)))
+  {
+    ZSTD_freeDStream(z);
+    ThrowDecompressError(filename, "cannot initialize zstd");
+  }
+
+  std::vector<char> in(ZSTD_DStreamInSize()), out(ZSTD_DStreamOutSize());
+  size_t result = 0;
+  while (true)
+  {
+    stream.read(&in[0], in.size());
+    const size_t read = stream.gcount();
+    if (read == 0)
+      break;
+
+    ZSTD_inBuffer input = { &in[0], read, 0 };
+    while (input.pos < input.size)
+    {
+      ZSTD_outBuffer output = { &out[0], out.size(), 0 };
+      result = ZSTD_decompressStream(z, &output, &input);
+      if (ZSTD_isError(result))
+      {
+        ZSTD_freeDStream(z);
+        ThrowDecompressError(filename, ZSTD_getErrorName(result));
+      }
+      contents.append(&out[0], output.pos);
+    }
+  }
+
+  // Flush any output that did not fit in the last block.
+  while (result != 0)
+  {
+    ZSTD_inBuffer input = { NULL, 0, 0 };
+    ZSTD_outBuffer output = { &out[0], out.size(), 0 };
+    result = ZSTD_decompressStream(z, &output, &input);
+    if (ZSTD_isError(result) || output.pos == 0)
+    {
+      ZSTD_freeDStream(z);
+      ThrowDecompressError(filename, "the file is truncated");
+    }
+    contents.append(&out[0], output.pos);
+  }
+
+  ZSTD_freeDStream(z);
+}
+#endif
+
+void Decompress(const std::string& filename, std::string& contents)
+{
+  contents.clear();
+  std::ifstream stream(filename.c_str(), std::fstream::binary);
+  if (!stream.is_open())
+    ThrowDecompressError(filename, "cannot open file");
+
+  const std::string extension = Extension(filename);
+  if (extension == "gz")
+  {
+#ifdef HAS_ZLIB
+    DecompressGzip(filename, stream, contents);
+#else
+    ThrowDecompressError(filename, "mlpack was compiled without zlib support");
+#endif
+  }
+  else if (extension == "zst")
+  {
+#ifdef HAS_ZSTD
+    DecompressZstd(filename, stream, contents);
+#else
+    ThrowDecompressError(filename, "mlpack was compiled without zstd support");
+#endif
+  }
+  else
+  {
+    ThrowDecompressError(filename, "unknown compression format");
+  }
+
+  if (stream.bad())
+    ThrowDecompressError(filename, "read error");
+}
+
+DecompressedStream::DecompressedStream(const std::string& filename) :
+    std::istream(NULL)
+{
+  Decompress(filename, contents);
+  buffer.Reset(contents.data(), contents.size());
+  rdbuf(&buffer);
+}
+
+} // namespace data
+} // namespace mlpack
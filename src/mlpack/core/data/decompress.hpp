@@ -0,0 +1,87 @@
+/**
+ * @file decompress.hpp
+ *
+ * Read gzip- and zstd-compressed files into memory so that data::Load() can
+ * parse them without decompressing them to disk first.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_DECOMPRESS_HPP
+#define MLPACK_CORE_DATA_DECOMPRESS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "extension.hpp"
+#include "memory_buffer.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Return whether the given file is compressed, judging by its extension: .gz
+ * files are gzip-compressed and .zst files are zstd-compressed.
+ */
+inline bool IsCompressed(const std::string& filename)
+{
+  const std::string extension = Extension(filename);
+  return (extension == "gz" || extension == "zst");
+}
+
+/**
+ * Return the extension of the given file once it is decompressed: for
+ * instance, "csv" for "dataset.csv.gz".  For files that are not compressed,
+ * this is the same as Extension().
+ */
+inline std::string UncompressedExtension(const std::string& filename)
+{
+  if (!IsCompressed(filename))
+    return Extension(filename);
+
+  return Extension(filename.substr(0, filename.rfind('.')));
+}
+
+/**
+ * Decompress the given gzip- or zstd-compressed file into the given string.
+ * The file is read and decompressed in blocks, so only the decompressed
+ * contents are held in memory.  Throws std::runtime_error if the file cannot
+ * be read, is corrupt or truncated, or if mlpack was compiled without support
+ * for its compression format.
+ *
+ * @param filename Name of the compressed file.
+ * @param contents String to store the decompressed contents in.
+ */
+void Decompress(const std::string& filename, std::string& contents);
+
+/**
+ * A read-only stream over the decompressed contents of a compressed file.  It
+ * supports seeking, so it can be given to the Armadillo loaders (which need to
+ * seek to detect the file type) just like a std::ifstream.
+ */
+class DecompressedStream : public std::istream
+{
+ public:
+  /**
+   * Decompress the given file.  Throws std::runtime_error on errors (see
+   * Decompress()).
+   *
+   * @param filename Name of the compressed file.
+   */
+  DecompressedStream(const std::string& filename);
+
+  //! Get the decompressed contents of the file.
+  const std::string& Contents() const { return contents; }
+
+ private:
+  //! The decompressed contents of the file.
+  std::string contents;
+  //! The buffer over the contents.
+  MemoryBuffer buffer;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
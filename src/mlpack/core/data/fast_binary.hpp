@@ -0,0 +1,69 @@
+/**
+ * @file fast_binary.hpp
+ *
+ * The fast binary model format: a boost::serialization binary archive behind a
+ * small versioned header, loaded straight from a memory-mapped file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FAST_BINARY_HPP
+#define MLPACK_CORE_DATA_FAST_BINARY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+//! The first token of the header of fast binary model files.
+const char fastBinaryMagic[] = "MLPACK_FAST_BINARY";
+//! The version of the fast binary format written by this version of mlpack.
+const size_t fastBinaryVersion = 1;
+//! The size of the header of fast binary model files, in bytes.
+const size_t fastBinaryHeaderSize = 64;
+
+/**
+ * Return whether the given stream is at the start of a fast binary model file.
+ * The position of the stream is restored.
+ */
+inline bool IsFastBinary(std::istream& stream);
+
+/**
+ * Serialize the given object to the given stream in the fast binary format: a
+ * header of fastBinaryHeaderSize bytes, holding fastBinaryMagic, the version
+ * of the format and the size of the archive, followed by a boost
+ * binary_oarchive.  Matrices are written by binary archives as contiguous
+ * blocks.  The stream must be seekable (the header is written last).  Throws
+ * std::runtime_error or boost::archive::archive_exception on errors.
+ *
+ * @param stream Stream to write to, opened in binary mode.
+ * @param name Name of the object.
+ * @param t Object to serialize.
+ */
+template<typename T>
+void SaveFastBinary(std::ostream& stream, const std::string& name, T& t);
+
+/**
+ * Load an object from a file in the fast binary format.  The file is memory
+ * mapped and deserialized straight from the mapping, so there are no reads or
+ * intermediate copies; on platforms without mmap(), the file is read with a
+ * single read.  Throws std::runtime_error if the header is invalid, the file
+ * is truncated, or it was written by a newer version of the format, and
+ * boost::archive::archive_exception if the archive is invalid.
+ *
+ * @param filename Name of the file to load.
+ * @param name Name of the object.
+ * @param t Object to deserialize into.
+ */
+template<typename T>
+void LoadFastBinary(const std::string& filename, const std::string& name, T& t);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "fast_binary_impl.hpp"
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * @file fast_binary_impl.hpp
+ *
+ * Implementation of the fast binary model format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FAST_BINARY_IMPL_HPP
+#define MLPACK_CORE_DATA_FAST_BINARY_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "fast_binary.hpp"
+#include "memory_buffer.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#ifndef _WIN32
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+namespace fast_binary {
+
+//! Throw a std::runtime_error for a file too short to hold a header.
+inline void ThrowTooShort(const std::string& filename)
+{
+  std::ostringstream oss;
+  oss << "'" << filename << "' is not a fast binary model file.";
+  throw std::runtime_error(oss.str());
+}
+
+//! Parse the header of a fast binary file; throws std::runtime_error on errors.
+inline void ReadHeader(const std::string& filename,
+                       const char* header,
+                       const size_t fileSize,
+                       size_t& archiveSize)
+{
+  std::istringstream iss(std::string(header, fastBinaryHeaderSize));
+  std::string magic;
+  size_t version;
+  iss >> magic >> version >> archiveSize;
+  if (iss.fail() || magic != fastBinaryMagic)
+  {
+    std::ostringstream oss;
+    oss << "'" << filename << "' is not a fast binary model file.";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (version > fastBinaryVersion)
+  {
+    std::ostringstream oss;
+    oss << "'" << filename << "' has fast binary format version " << version
+        << ", but this version of mlpack can only load version "
+        << fastBinaryVersion << " or older.";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (fastBinaryHeaderSize + archiveSize > fileSize)
+  {
+    std::ostringstream oss;
+    oss << "'" << filename << "' is truncated.";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+//! Deserialize an object from the archive in a block of memory.
+template<typename T>
+void LoadArchive(const char* archive,
+                 const size_t archiveSize,
+                 const std::string& name,
+                 T& t)
+{
+  MemoryBuffer buffer(archive, archiveSize);
+  boost::archive::binary_iarchive ar(buffer);
+  ar >> boost::serialization::make_nvp(name.c_str(), t);
+}
+
+} // namespace fast_binary
+
+inline bool IsFastBinary(std::istream& stream)
+{
+  const std::string magic(fastBinaryMagic);
+  std::string header(magic.size(), '\0');
+  const std::streampos pos = stream.tellg();
+  stream.read(&header[0], std::streamsize(header.size()));
+  stream.clear();
+  stream.seekg(pos); // Reset stream position after peeking.
+
+  return (header == magic);
+}
+
+template<typename T>
+void SaveFastBinary(std::ostream& stream, const std::string& name, T& t)
+{
+  // Leave room for the header, which needs the size of the archive.
+  const std::streampos start = stream.tellp();
+  stream.write(std::string(fastBinaryHeaderSize, ' ').c_str(),
+      fastBinaryHeaderSize);
+  {
+    boost::archive::binary_oarchive ar(*stream.rdbuf());
+    ar << boost::serialization::make_nvp(name.c_str(), t);
+  }
+  const std::streampos end = stream.tellp();
+
+  std::ostringstream header;
+  header << fastBinaryMagic << " " << fastBinaryVersion << " "
+      << size_t(end - start - std::streamoff(fastBinaryHeaderSize));
+  std::string headerString = header.str();
+  headerString.resize(fastBinaryHeaderSize - 1, ' ');
+  headerString += '\n';
+
+  stream.seekp(start);
+  stream.write(headerString.c_str(), headerString.size());
+  stream.seekp(end);
+  if (!stream.good())
+    throw std::runtime_error("Cannot write fast binary model file.");
+}
+
+template<typename T>
+void LoadFastBinary(const std::string& filename, const std::string& name, T& t)
+{
+#ifdef _WIN32
+  std::ifstream stream(filename.c_str(), std::fstream::binary);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot read '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  stream.seekg(0, std::ios::end);
+  const size_t fileSize = stream.tellg();
+  stream.seekg(0, std::ios::beg);
+  if (fileSize < fastBinaryHeaderSize)
+    fast_binary::ThrowTooShort(filename);
+
+  std::vector<char> contents(fileSize);
+  if (!stream.read(&contents[0], std::streamsize(fileSize)))
+  {
+    std::ostringstream oss;
+    oss << "Cannot read '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  size_t archiveSize;
+  fast_binary::ReadHeader(filename, &contents[0], fileSize, archiveSize);
+  fast_binary::LoadArchive(&contents[fastBinaryHeaderSize], archiveSize, name,
+      t);
+#else
+  const int fd = open(filename.c_str(), O_RDONLY);
+  struct stat fileStat;
+  if (fd < 0 || fstat(fd, &fileStat) != 0)
+  {
+    if (fd >= 0)
+      close(fd);
+    std::ostringstream oss;
+    oss << "Cannot read '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  const size_t fileSize = fileStat.st_size;
+  if (fileSize < fastBinaryHeaderSize)
+  {
+    close(fd);
+    fast_binary::ThrowTooShort(filename);
+  }
+
+  // The mapping stays valid after the file is closed.
+  void* mapping = mmap(NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    std::ostringstream oss;
+    oss << "Cannot map '" << filename << "' into memory.";
+    throw std::runtime_error(oss.str());
+  }
+  madvise(mapping, fileSize, MADV_SEQUENTIAL);
+
+  try
+  {
+    const char* contents = static_cast<const char*>(mapping);
+    size_t archiveSize;
+    fast_binary::ReadHeader(filename, contents, fileSize, archiveSize);
+    fast_binary::LoadArchive(contents + fastBinaryHeaderSize, archiveSize,
+        name, t);
+  }
+  catch (...)
+  {
+    munmap(mapping, fileSize);
+    throw;
+  }
+  munmap(mapping, fileSize);
+#endif
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -46,27 +46,37 @@ class CustomImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    // replace the target value to custom value
-    if (columnMajor)
-    {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          input(dimension, i) = customValue;
-        }
-      }
-    }
-    else
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
+
+  /**
+   * Impute several dimensions at once in a single parallel pass over the
+   * points: replace mappedValues[i] (and NaN) in dimension dimensions[i] with
+   * the custom value, for each i.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value to replace in each dimension.
+   * @param dimensions Dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t points = columnMajor ? input.n_cols : input.n_rows;
+
+    // replace the target values with the custom value
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) points; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      for (size_t d = 0; d < dimensions.size(); ++d)
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          input(i, dimension) = customValue;
-        }
+        T& value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        if (value == mappedValues[d] || std::isnan(value))
+          value = customValue;
       }
     }
   }
@@ -39,32 +39,53 @@ class ListwiseDeletion
               const size_t dimension,
               const bool columnMajor = true)
   {
-    std::vector<arma::uword> colsToKeep;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
 
-    if (columnMajor)
-    {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-         if (!(input(dimension, i) == mappedValue ||
-             std::isnan(input(dimension, i))))
-         {
-           colsToKeep.push_back(i);
-         }
-      }
-      input = input.cols(arma::uvec(colsToKeep));
-    }
-    else
+  /**
+   * Impute several dimensions at once: remove every point (column, or row if
+   * the matrix is not column-major) that has mappedValues[i] (or NaN) in
+   * dimension dimensions[i] for any i.  The points are checked in one parallel
+   * pass, and the matrix is rebuilt only once.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value to look for in each dimension.
+   * @param dimensions Dimensions to check.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t points = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<char> keep(points, 1);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) points; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      for (size_t d = 0; d < dimensions.size(); ++d)
       {
-        if (!(input(i, dimension) == mappedValue ||
-             std::isnan(input(i, dimension))))
+        const T value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        if (value == mappedValues[d] || std::isnan(value))
         {
-           colsToKeep.push_back(i);
+          keep[i] = 0;
+          break;
         }
       }
-      input = input.rows(arma::uvec(colsToKeep));
     }
+
+    std::vector<arma::uword> colsToKeep;
+    for (size_t i = 0; i < points; ++i)
+      if (keep[i])
+        colsToKeep.push_back(i);
+
+    if (columnMajor)
+      input = input.cols(arma::uvec(colsToKeep));
+    else
+      input = input.rows(arma::uvec(colsToKeep));
   }
 }; // class ListwiseDeletion
 
@@ -39,61 +39,88 @@ class MeanImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    double sum = 0;
-    size_t elems = 0; // excluding nan or missing target
-
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
 
+  /**
+   * Impute several dimensions at once: replace mappedValues[i] (and NaN) in
+   * dimension dimensions[i] with the mean of that dimension, for each i.  The
+   * means of all the dimensions are computed in one parallel pass over the
+   * points, and the missing values are replaced in a second one, so the cost
+   * does not grow with the number of passes over the data.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value to replace in each dimension.
+   * @param dimensions Dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t points = columnMajor ? input.n_cols : input.n_rows;
+    const size_t numDimensions = dimensions.size();
+    auto element = [&](const size_t point, const size_t d) -> T&
+    {
+      return columnMajor ? input(dimensions[d], point) :
+          input(point, dimensions[d]);
+    };
 
-    // calculate number of elements and sum of them excluding mapped value or
-    // nan. while doing that, remember where mappedValue or NaN exists.
-    if (columnMajor)
+    // Sum the elements of each dimension, excluding mapped values and NaNs.
+    std::vector<double> sums(numDimensions, 0.0);
+    std::vector<size_t> elems(numDimensions, 0);
+    #pragma omp parallel
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      std::vector<double> threadSums(numDimensions, 0.0);
+      std::vector<size_t> threadElems(numDimensions, 0);
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) points; ++i)
       {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
+        for (size_t d = 0; d < numDimensions; ++d)
         {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elems++;
-          sum += input(dimension, i);
+          const T value = element(i, d);
+          if (!(value == mappedValues[d] || std::isnan(value)))
+          {
+            threadSums[d] += value;
+            ++threadElems[d];
+          }
         }
       }
-    }
-    else
-    {
-      for (size_t i = 0; i < input.n_rows; ++i)
+
+      #pragma omp critical
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
+        for (size_t d = 0; d < numDimensions; ++d)
         {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-          elems++;
-          sum += input(i, dimension);
+          sums[d] += threadSums[d];
+          elems[d] += threadElems[d];
         }
       }
     }
 
-    if (elems == 0)
-      Log::Fatal << "it is impossible to calculate mean; no valid elements in "
-          << "the dimension" << std::endl;
+    // calculate means.
+    std::vector<double> means(numDimensions);
+    for (size_t d = 0; d < numDimensions; ++d)
+    {
+      if (elems[d] == 0)
+        Log::Fatal << "it is impossible to calculate mean; no valid elements "
+            << "in dimension " << dimensions[d] << std::endl;
 
-    // calculate mean;
-    const double mean = sum / elems;
+      means[d] = sums[d] / elems[d];
+    }
 
-    // Now replace the calculated mean to the missing variables
-    // It only needs to loop through targets vector, not the whole matrix.
-    for (const PairType& target : targets)
+    // Now replace the missing variables with the calculated means.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) points; ++i)
     {
-      input(target.first, target.second) = mean;
+      for (size_t d = 0; d < numDimensions; ++d)
+      {
+        T& value = element(i, d);
+        if (value == mappedValues[d] || std::isnan(value))
+          value = means[d];
+      }
     }
   }
 }; // class MeanImputation
@@ -40,50 +40,79 @@ class MedianImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
-    // good elements are kept inside this vector.
-    std::vector<double> elemsToKeep;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
+
+  /**
+   * Impute several dimensions at once: replace mappedValues[i] (and NaN) in
+   * dimension dimensions[i] with the median of that dimension, for each i.  The
+   * dimensions are imputed in parallel, and each median is found with
+   * std::nth_element() instead of a full sort.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value to replace in each dimension.
+   * @param dimensions Dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t points = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<std::string> errors(dimensions.size());
 
-    if (columnMajor)
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      const size_t dimension = dimensions[d];
+      auto element = [&](const size_t point) -> T&
+      {
+        return columnMajor ? input(dimension, point) : input(point, dimension);
+      };
+
+      // Points with missing values, and the values of the other points.
+      std::vector<size_t> targets;
+      std::vector<double> elemsToKeep;
+      elemsToKeep.reserve(points);
+      for (size_t i = 0; i < points; ++i)
       {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
+        const T value = element(i);
+        if (value == mappedValues[d] || std::isnan(value))
+          targets.push_back(i);
         else
-        {
-          elemsToKeep.push_back(input(dimension, i));
-        }
+          elemsToKeep.push_back(value);
       }
-    }
-    else
-    {
-      for (size_t i = 0; i < input.n_rows; ++i)
+
+      if (elemsToKeep.empty())
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-           elemsToKeep.push_back(input(i, dimension));
-        }
+        std::ostringstream oss;
+        oss << "it is impossible to calculate median; no valid elements in "
+            << "dimension " << dimension;
+        errors[d] = oss.str();
+        continue;
       }
-    }
 
-    // calculate median
-    const double median = arma::median(arma::vec(elemsToKeep));
+      // calculate median; for an even number of elements, it is the average of
+      // the two middle elements, as with arma::median().
+      const size_t half = elemsToKeep.size() / 2;
+      std::nth_element(elemsToKeep.begin(), elemsToKeep.begin() + half,
+          elemsToKeep.end());
+      double median = elemsToKeep[half];
+      if (elemsToKeep.size() % 2 == 0)
+      {
+        median = (median + *std::max_element(elemsToKeep.begin(),
+            elemsToKeep.begin() + half)) / 2.0;
+      }
 
-    for (const PairType& target : targets)
-    {
-       input(target.first, target.second) = median;
+      for (const size_t target : targets)
+        element(target) = median;
     }
+
+    for (size_t d = 0; d < errors.size(); ++d)
+      if (!errors[d].empty())
+        Log::Fatal << errors[d] << std::endl;
   }
 }; // class MedianImputation
 
@@ -65,6 +65,31 @@ class Imputer
     strategy.Impute(input, mappedValue, dimension, columnMajor);
   }
 
+  /**
+   * Given an input dataset, replace missing values of several dimensions with
+   * the given imputation strategy.  This is equivalent to calling Impute() for
+   * each dimension, but the strategy can impute all of the dimensions in the
+   * same passes over the data (the strategy must have an Impute() overload
+   * that takes a vector of mapped values and a vector of dimensions, like the
+   * strategies in imputation_methods/).
+   *
+   * @param input Input dataset to apply imputation.
+   * @param missingValue User defined missing value; it can be anything.
+   * @param dimensions Dimensions to apply the imputation.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::string& missingValue,
+              const std::vector<size_t>& dimensions)
+  {
+    std::vector<T> mappedValues(dimensions.size());
+    for (size_t i = 0; i < dimensions.size(); ++i)
+    {
+      mappedValues[i] = static_cast<T>(mapper.UnmapValue(missingValue,
+          dimensions[i]));
+    }
+    strategy.Impute(input, mappedValues, dimensions, columnMajor);
+  }
+
   //! Get the strategy
   const StrategyType& Strategy() const { return strategy; }
 
@@ -49,6 +49,7 @@ template bool Load<int, IncrementPolicy>(const std::string&,
                                          arma::Mat<int>&,
                                          DatasetMapper<IncrementPolicy>&,
                                          const bool,
+                                         const bool,
                                          const bool);
 
 template bool Load<unsigned int, IncrementPolicy>(
@@ -56,6 +57,7 @@ template bool Load<unsigned int, IncrementPolicy>(
     arma::Mat<unsigned int>&,
     DatasetMapper<IncrementPolicy>&,
     const bool,
+    const bool,
     const bool);
 
 template bool Load<unsigned long, IncrementPolicy>(
@@ -63,6 +65,7 @@ template bool Load<unsigned long, IncrementPolicy>(
     arma::Mat<unsigned long>&,
     DatasetMapper<IncrementPolicy>&,
     const bool,
+    const bool,
     const bool);
 
 template bool Load<unsigned long long, IncrementPolicy>(
@@ -70,18 +73,21 @@ template bool Load<unsigned long long, IncrementPolicy>(
     arma::Mat<unsigned long long>&,
     DatasetMapper<IncrementPolicy>&,
     const bool,
+    const bool,
     const bool);
 
 template bool Load<float, IncrementPolicy>(const std::string&,
                                            arma::Mat<float>&,
                                            DatasetMapper<IncrementPolicy>&,
                                            const bool,
+                                           const bool,
                                            const bool);
 
 template bool Load<double, IncrementPolicy>(const std::string&,
                                             arma::Mat<double>&,
                                             DatasetMapper<IncrementPolicy>&,
                                             const bool,
+                                            const bool,
                                             const bool);
 
 } // namespace data
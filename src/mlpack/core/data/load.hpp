@@ -45,6 +45,11 @@ namespace data /** Functions to load and save matrices and models. */ {
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
  *
+ * Files of any of those types except HDF5 may also be gzip-compressed (with an
+ * additional .gz extension, like dataset.csv.gz) or zstd-compressed (with an
+ * additional .zst extension), if mlpack was compiled with zlib or libzstd.
+ * They are decompressed into memory while they are read, never to disk.
+ *
  * If the parameter 'fatal' is set to true, a std::runtime_error exception will
  * be thrown if the matrix does not load successfully.  The parameter
  * 'transpose' controls whether or not the matrix is transposed after loading.
@@ -170,6 +175,32 @@ bool Load(const std::string& filename,
           arma::Row<eT>& rowvec,
           const bool fatal = false);
 
+/**
+ * Load a sparse matrix from a file, guessing the filetype from the extension.
+ * The supported types of files are:
+ *
+ *  - Armadillo binary (arma_binary), denoted by .bin; this is a compact
+ *    compressed sparse column format that is read without parsing
+ *  - Coordinate list (coord_ascii), denoted by .txt or .tsv
+ *  - libsvm/svmlight, denoted by .svm, .libsvm or .svmlight; the labels are
+ *    discarded (use LoadSVMLight() to load them too)
+ *
+ * Sparse matrices are never transposed: coordinate lists and binary files
+ * hold the matrix as it is in memory, and each line of an svmlight file is one
+ * point (column).  If the parameter 'fatal' is set to true, a
+ * std::runtime_error exception will be thrown if the matrix does not load
+ * successfully.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Sparse matrix to load contents of file into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::SpMat<eT>& matrix,
+          const bool fatal = false);
+
 /**
  * Loads a matrix from a file, guessing the filetype from the extension and
  * mapping categorical features with a DatasetMapper object.  This will
@@ -183,7 +214,9 @@ bool Load(const std::string& filename,
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
- * filetype as raw_binary, which can have very confusing effects.
+ * filetype as raw_binary, which can have very confusing effects.  As with the
+ * overload without a DatasetMapper, the files may be compressed (with .gz or
+ * .zst).
  *
  * If the parameter 'fatal' is set to true, a std::runtime_error exception will
  * be thrown if the matrix does not load successfully.  The parameter
@@ -192,14 +225,21 @@ bool Load(const std::string& filename,
  * mlpack requires column-major matrices, this should be left at its default
  * value of 'true'.
  *
- * The DatasetMapper object passed to this function will be re-created, so any
- * mappings from previous loads will be lost.
+ * Unless useExistingMappings is true, the DatasetMapper object passed to this
+ * function will be re-created, so any mappings from previous loads will be
+ * lost.  If it is true, the types and mappings of the DatasetMapper (for
+ * instance from an earlier load, or loaded with data::Load() from a saved
+ * DatasetMapper) are reused for CSV files: the pass over the file that
+ * discovers the types of the dimensions is skipped, and strings that are
+ * already mapped keep their values.  This makes repeated loads of files with
+ * the same schema faster and consistent with each other.
  *
  * @param filename Name of file to load.
  * @param matrix Matrix to load contents of file into.
  * @param info DatasetMapper object to populate with mappings and data types.
  * @param fatal If an error should be reported as fatal (default false).
  * @param transpose If true, transpose the matrix after loading.
+ * @param useExistingMappings If true, reuse the mappings in info.
  * @return Boolean value indicating success or failure of load.
  */
 template<typename eT, typename PolicyType>
@@ -207,7 +247,8 @@ bool Load(const std::string& filename,
           arma::Mat<eT>& matrix,
           DatasetMapper<PolicyType>& info,
           const bool fatal = false,
-          const bool transpose = true);
+          const bool transpose = true,
+          const bool useExistingMappings = false);
 
 /**
  * Don't document these with doxygen; they aren't helpful for users to know
@@ -221,6 +262,7 @@ extern template bool Load<int, IncrementPolicy>(
     arma::Mat<int>&,
     DatasetMapper<IncrementPolicy>&,
     const bool,
+    const bool,
     const bool);
 
 extern template bool Load<arma::u32, IncrementPolicy>(
@@ -228,6 +270,7 @@ extern template bool Load<arma::u32, IncrementPolicy>(
     arma::Mat<arma::u32>&,
     DatasetMapper<IncrementPolicy>&,
     const bool,
+    const bool,
     const bool);
 
 extern template bool Load<arma::u64, IncrementPolicy>(
@@ -235,6 +278,7 @@ extern template bool Load<arma::u64, IncrementPolicy>(
     arma::Mat<arma::u64>&,
     DatasetMapper<IncrementPolicy>&,
     const bool,
+    const bool,
     const bool);
 
 extern template bool Load<float, IncrementPolicy>(
@@ -242,6 +286,7 @@ extern template bool Load<float, IncrementPolicy>(
     arma::Mat<float>&,
     DatasetMapper<IncrementPolicy>&,
     const bool,
+    const bool,
     const bool);
 
 extern template bool Load<double, IncrementPolicy>(
@@ -249,6 +294,7 @@ extern template bool Load<double, IncrementPolicy>(
     arma::Mat<double>&,
     DatasetMapper<IncrementPolicy>&,
     const bool,
+    const bool,
     const bool);
 
 /**
@@ -266,9 +312,14 @@ extern template bool Load<double, IncrementPolicy>(
  *  - text, denoted by .txt
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - fast binary, denoted by .fbin; this is a binary archive behind a
+ *    versioned header, which is loaded straight from a memory-mapped file and
+ *    is the fastest to reload (see LoadFastBinary()).  Files in this format
+ *    are also recognized when they have the .bin extension.
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary', and
+ * 'format::fast_binary'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -294,5 +345,7 @@ bool Load(const std::string& filename,
 #include "load_model_impl.hpp"
 // Include implementation of Load() for vectors.
 #include "load_vec_impl.hpp"
+// Include implementation of Load() for sparse matrices.
+#include "load_sparse_impl.hpp"
 
 #endif
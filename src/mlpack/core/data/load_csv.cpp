@@ -6,10 +6,21 @@ namespace mlpack {
 namespace data {
 
 LoadCSV::LoadCSV(const std::string& file) :
-  extension(Extension(file)),
+  extension(UncompressedExtension(file)),
   filename(file),
-  inFile(file)
+  decompressedStream(IsCompressed(file) ? new DecompressedStream(file) : NULL),
+  inFile(NULL)
 {
+  if (decompressedStream)
+  {
+    inFile.rdbuf(decompressedStream->rdbuf());
+  }
+  else
+  {
+    fileStream.open(file.c_str());
+    inFile.rdbuf(fileStream.rdbuf());
+  }
+
   // Attempt to open stream.
   CheckOpen();
 
@@ -48,7 +59,7 @@ LoadCSV::LoadCSV(const std::string& file) :
 
 void LoadCSV::CheckOpen()
 {
-  if (!inFile.is_open())
+  if (!decompressedStream && !fileStream.is_open())
   {
     std::ostringstream oss;
     oss << "Cannot open file '" << filename << "'. " << std::endl;
@@ -58,5 +69,51 @@ void LoadCSV::CheckOpen()
   inFile.unsetf(std::ios::skipws);
 }
 
+void LoadCSV::ReadLines(const size_t begin,
+                        const size_t end,
+                        std::vector<std::string>& lines) const
+{
+  // Each caller opens its own stream (or copies from the decompressed
+  // contents), so chunks can be read concurrently.
+  std::string buffer;
+  if (decompressedStream)
+  {
+    buffer = decompressedStream->Contents().substr(begin, end - begin);
+  }
+  else
+  {
+    std::ifstream stream(filename, std::ios::binary);
+    buffer.resize(end - begin);
+    stream.seekg(begin);
+    if (!stream.read(&buffer[0], buffer.size()))
+    {
+      std::ostringstream oss;
+      oss << "Cannot read bytes " << begin << " to " << end << " of file '"
+          << filename << "'.";
+      throw std::runtime_error(oss.str());
+    }
+  }
+
+  // Split the buffer like std::getline() would.
+  lines.clear();
+  size_t lineStart = 0;
+  while (lineStart < buffer.size())
+  {
+    size_t lineEnd = buffer.find('\n', lineStart);
+    if (lineEnd == std::string::npos)
+      lineEnd = buffer.size();
+
+    lines.push_back(buffer.substr(lineStart, lineEnd - lineStart));
+    lineStart = lineEnd + 1;
+  }
+}
+
+void LoadCSV::ThrowFirstError(const std::vector<std::string>& errors)
+{
+  for (size_t i = 0; i < errors.size(); ++i)
+    if (!errors[i].empty())
+      throw std::runtime_error(errors[i]);
+}
+
 } // namespace data
 } // namespace mlpack
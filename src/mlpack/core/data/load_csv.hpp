@@ -22,8 +22,10 @@
 #include <string>
 
 #include "extension.hpp"
+#include "decompress.hpp"
 #include "format.hpp"
 #include "dataset_mapper.hpp"
+#include "map_policies/missing_policy.hpp"
 
 namespace mlpack {
 namespace data {
@@ -38,7 +40,9 @@ class LoadCSV
  public:
   /**
    * Construct the LoadCSV object on the given file.  This will construct the
-   * rules necessary for loading and attempt to open the file.
+   * rules necessary for loading and attempt to open the file.  Compressed
+   * files (see IsCompressed()) are decompressed into memory and parsed from
+   * there.
    */
   LoadCSV(const std::string& file);
 
@@ -46,22 +50,267 @@ class LoadCSV
    * Load the file into the given matrix with the given DatasetMapper object.
    * Throws exceptions on errors.
    *
+   * If useExistingMappings is true, the types and mappings already in infoSet
+   * (for instance from an earlier load, or deserialized from a saved
+   * DatasetMapper) are reused: the pass over the file that discovers the
+   * types of the dimensions is skipped, strings that are already mapped keep
+   * their values, and new strings are added to the mappings.
+   *
    * @param inout Matrix to load into.
    * @param infoSet DatasetMapper to use while loading.
    * @param transpose If true, the matrix should be transposed on loading
    *     (default).
+   * @param useExistingMappings If true, reuse the mappings of infoSet.
    */
   template<typename T, typename PolicyType>
   void Load(arma::Mat<T> &inout,
             DatasetMapper<PolicyType> &infoSet,
-            const bool transpose = true)
+            const bool transpose = true,
+            const bool useExistingMappings = false)
   {
     CheckOpen();
 
     if (transpose)
-      TransposeParse(inout, infoSet);
+      ParallelLoad(inout, infoSet, 16 * 1024 * 1024, useExistingMappings);
+    else
+      NonTransposeParse(inout, infoSet, useExistingMappings);
+  }
+
+  /**
+   * Load the file into the given matrix with the given DatasetMapper object,
+   * transposing it (so each line is a point), by parsing chunks of the file in
+   * parallel.  The file is split into chunks of about chunkSize bytes that end
+   * on line boundaries; each chunk is parsed into its own range of columns of
+   * the matrix with its own DatasetMapper, and the categorical mappings of the
+   * chunks are merged into infoSet in file order at the end, so the result is
+   * the same as for a serial parse.  The mappings can only be merged for the
+   * IncrementPolicy (as in DatasetInfo) and the MissingPolicy; with other
+   * policies, the file is parsed serially.  Throws exceptions on errors.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper to use while loading.
+   * @param chunkSize Approximate number of bytes in each chunk.
+   * @param useExistingMappings If true, reuse the mappings of infoSet (see
+   *     Load()).
+   */
+  template<typename T, typename PolicyType>
+  void ParallelLoad(arma::Mat<T>& inout,
+                    DatasetMapper<PolicyType>& infoSet,
+                    const size_t chunkSize = 16 * 1024 * 1024,
+                    const bool useExistingMappings = false)
+  {
+    using namespace boost::spirit;
+
+    CheckOpen();
+
+    // Find the size of the file, and the dimensionality from its first line.
+    inFile.clear();
+    inFile.seekg(0, std::ios::end);
+    const size_t fileSize = inFile.tellg();
+    inFile.seekg(0, std::ios::beg);
+
+    std::string line;
+    if ((!std::is_same<PolicyType, IncrementPolicy>::value &&
+         !std::is_same<PolicyType, MissingPolicy>::value) || fileSize == 0 ||
+        !std::getline(inFile, line))
+    {
+      TransposeParse(inout, infoSet, useExistingMappings);
+      return;
+    }
+
+    boost::trim(line);
+    size_t rows = 0;
+    auto findRowSize = [&rows](iter_type) { ++rows; };
+    qi::parse(line.begin(), line.end(),
+        stringRule[findRowSize] % delimiterRule);
+
+    // Each chunk gets an empty DatasetMapper with a copy of the policy.
+    auto emptyMapper = [&infoSet, rows]()
+    {
+      PolicyType policy(infoSet.Policy());
+      return DatasetMapper<PolicyType>(policy, rows);
+    };
+
+    if (!useExistingMappings)
+      infoSet = emptyMapper();
     else
-      NonTransposeParse(inout, infoSet);
+      CheckDimensionality(infoSet, rows);
+
+    // Split the file into chunks that each end after a newline.
+    std::vector<size_t> bounds(1, 0);
+    for (size_t offset = std::max(chunkSize, size_t(1)); offset < fileSize;
+        offset += std::max(chunkSize, size_t(1)))
+    {
+      if (offset <= bounds.back())
+        continue;
+
+      inFile.clear();
+      inFile.seekg(offset - 1);
+      inFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      const size_t bound = inFile.good() ? size_t(inFile.tellg()) : fileSize;
+      if (bound > bounds.back() && bound < fileSize)
+        bounds.push_back(bound);
+    }
+    bounds.push_back(fileSize);
+    const size_t numChunks = bounds.size() - 1;
+
+    // The first pass over each chunk counts its lines and, if the policy needs
+    // it, finds which dimensions are categorical.
+    std::vector<DatasetMapper<PolicyType>> chunkInfo(numChunks, emptyMapper());
+    std::vector<size_t> chunkCols(numChunks, 0);
+    std::vector<std::string> errors(numChunks);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      try
+      {
+        std::vector<std::string> lines;
+        ReadLines(bounds[c], bounds[c + 1], lines);
+        chunkCols[c] = lines.size();
+
+        if (!PolicyType::NeedsFirstPass || useExistingMappings)
+          continue;
+
+        for (size_t i = 0; i < lines.size(); ++i)
+        {
+          boost::trim(lines[i]);
+
+          size_t dim = 0;
+          auto firstPassMap = [&](const iter_type& iter)
+          {
+            // Lines with too many dimensions are reported in the second pass.
+            if (dim < rows)
+            {
+              std::string str(iter.begin(), iter.end());
+              boost::trim(str);
+
+              chunkInfo[c].template MapFirstPass<T>(std::move(str), dim);
+            }
+            ++dim;
+          };
+
+          qi::parse(lines[i].begin(), lines[i].end(),
+              stringRule[firstPassMap] % delimiterRule);
+        }
+      }
+      catch (std::exception& e)
+      {
+        errors[c] = e.what();
+      }
+    }
+    ThrowFirstError(errors);
+
+    // A dimension is categorical if it is categorical in any chunk.
+    for (size_t c = 0; c < numChunks; ++c)
+      for (size_t d = 0; d < rows; ++d)
+        if (chunkInfo[c].Type(d) == Datatype::categorical)
+          infoSet.Type(d) = Datatype::categorical;
+
+    std::vector<size_t> firstCols(numChunks, 0);
+    for (size_t c = 1; c < numChunks; ++c)
+      firstCols[c] = firstCols[c - 1] + chunkCols[c - 1];
+    inout.set_size(rows, firstCols[numChunks - 1] + chunkCols[numChunks - 1]);
+
+    // The second pass parses each chunk into its columns, mapping the strings
+    // of categorical dimensions with the DatasetMapper of the chunk.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      try
+      {
+        chunkInfo[c] = emptyMapper();
+        for (size_t d = 0; d < rows; ++d)
+          chunkInfo[c].Type(d) = infoSet.Type(d);
+
+        std::vector<std::string> lines;
+        ReadLines(bounds[c], bounds[c + 1], lines);
+
+        size_t row = 0;
+        size_t col = firstCols[c];
+        auto parseString = [&](iter_type const &iter)
+        {
+          if (row < rows)
+          {
+            std::string str(iter.begin(), iter.end());
+            boost::trim(str);
+
+            inout(row, col) = chunkInfo[c].template MapString<T>(
+                std::move(str), row);
+          }
+          ++row;
+        };
+
+        for (size_t i = 0; i < lines.size(); ++i, ++col)
+        {
+          boost::trim(lines[i]);
+
+          row = 0;
+          const bool canParse = qi::parse(lines[i].begin(), lines[i].end(),
+              stringRule[parseString] % delimiterRule);
+
+          if (row != rows)
+          {
+            std::ostringstream oss;
+            oss << "LoadCSV::ParallelLoad(): wrong number of dimensions ("
+                << row << ") on line " << col << "; should be " << rows
+                << " dimensions.";
+            throw std::runtime_error(oss.str());
+          }
+
+          if (!canParse)
+          {
+            std::ostringstream oss;
+            oss << "LoadCSV::ParallelLoad(): parsing error on line " << col
+                << "!";
+            throw std::runtime_error(oss.str());
+          }
+        }
+      }
+      catch (std::exception& e)
+      {
+        errors[c] = e.what();
+      }
+    }
+    ThrowFirstError(errors);
+
+    // Merge the mappings of each chunk in order, so that each string gets the
+    // value it would get from a serial parse, and remap the columns of the
+    // chunk.
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      for (size_t d = 0; d < rows; ++d)
+      {
+        const size_t numMappings = chunkInfo[c].NumMappings(d);
+        if (numMappings == 0)
+          continue;
+
+        // The MissingPolicy maps every string to NaN, so the strings only
+        // have to be recorded.
+        if (!std::is_same<PolicyType, IncrementPolicy>::value)
+        {
+          const typename PolicyType::MappedType missing =
+              std::numeric_limits<typename PolicyType::MappedType>::quiet_NaN();
+          for (size_t v = 0; v < chunkInfo[c].NumUnmappings(missing, d); ++v)
+          {
+            infoSet.template MapString<T>(
+                chunkInfo[c].UnmapString(missing, d, v), d);
+          }
+          continue;
+        }
+
+        std::vector<T> remap(numMappings);
+        for (size_t v = 0; v < numMappings; ++v)
+        {
+          remap[v] = infoSet.template MapString<T>(
+              chunkInfo[c].UnmapString(v, d), d);
+        }
+
+        for (size_t col = firstCols[c]; col < firstCols[c] + chunkCols[c];
+            ++col)
+          inout(d, col) = remap[size_t(inout(d, col))];
+      }
+    }
   }
 
   /**
@@ -70,12 +319,19 @@ class LoadCSV
    * the data for DatasetMapper, if MapPolicy::NeedsFirstPass is true.  The info
    * object will be re-initialized with the correct dimensionality.
    *
+   * If useExistingMappings is true, the info object is kept, and the first
+   * pass is skipped.
+   *
    * @param rows Variable to be filled with the number of rows.
    * @param cols Variable to be filled with the number of columns.
    * @param info DatasetMapper object to use for first pass.
+   * @param useExistingMappings If true, reuse the mappings of info.
    */
   template<typename T, typename MapPolicy>
-  void GetMatrixSize(size_t& rows, size_t& cols, DatasetMapper<MapPolicy>& info)
+  void GetMatrixSize(size_t& rows,
+                     size_t& cols,
+                     DatasetMapper<MapPolicy>& info,
+                     const bool useExistingMappings = false)
   {
     using namespace boost::spirit;
 
@@ -96,7 +352,11 @@ class LoadCSV
     {
       ++rows;
     }
-    info = DatasetMapper<MapPolicy>(rows);
+
+    if (useExistingMappings)
+      CheckDimensionality(info, rows);
+    else
+      info = DatasetMapper<MapPolicy>(rows);
 
     // Now, jump back to the beginning of the file.
     inFile.clear();
@@ -119,7 +379,7 @@ class LoadCSV
 
       // I guess this is technically a second pass, but that's ok... still the
       // same idea...
-      if (MapPolicy::NeedsFirstPass)
+      if (MapPolicy::NeedsFirstPass && !useExistingMappings)
       {
         // In this case we must pass everything we parse to the MapPolicy.
         auto firstPassMap = [&](const iter_type& iter)
@@ -143,14 +403,19 @@ class LoadCSV
    * data for DatasetMapper, if MapPolicy::NeedsFirstPass is true.  The info
    * object will be re-initialized with the correct dimensionality.
    *
+   * If useExistingMappings is true, the info object is kept, and the first
+   * pass is skipped.
+   *
    * @param rows Variable to be filled with the number of rows.
    * @param cols Variable to be filled with the number of columns.
    * @param info DatasetMapper object to use for first pass.
+   * @param useExistingMappings If true, reuse the mappings of info.
    */
   template<typename T, typename MapPolicy>
   void GetTransposeMatrixSize(size_t& rows,
                               size_t& cols,
-                              DatasetMapper<MapPolicy>& info)
+                              DatasetMapper<MapPolicy>& info,
+                              const bool useExistingMappings = false)
   {
     using namespace boost::spirit;
 
@@ -180,11 +445,14 @@ class LoadCSV
             stringRule[findRowSize] % delimiterRule);
 
         // Now that we know the dimensionality, initialize the DatasetMapper.
-        info = DatasetMapper<MapPolicy>(rows);
+        if (useExistingMappings)
+          CheckDimensionality(info, rows);
+        else
+          info = DatasetMapper<MapPolicy>(rows);
       }
 
       // If we need to do a first pass for the DatasetMapper, do it.
-      if (MapPolicy::NeedsFirstPass)
+      if (MapPolicy::NeedsFirstPass && !useExistingMappings)
       {
         size_t dim = 0;
 
@@ -213,21 +481,53 @@ class LoadCSV
    */
   void CheckOpen();
 
+  /**
+   * Read the lines between the given byte offsets of the file, which must be
+   * at the start of a line and at the end of a line (or of the file).
+   */
+  void ReadLines(const size_t begin,
+                 const size_t end,
+                 std::vector<std::string>& lines) const;
+
+  //! Throw the first non-empty error message of the given chunks, if any.
+  static void ThrowFirstError(const std::vector<std::string>& errors);
+
+  /**
+   * Make sure that an existing DatasetMapper to reuse has the dimensionality
+   * of the file; throw an exception if not.
+   */
+  template<typename PolicyType>
+  void CheckDimensionality(const DatasetMapper<PolicyType>& info,
+                           const size_t dimensionality) const
+  {
+    if (info.Dimensionality() != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "LoadCSV: cannot reuse the mappings of a DatasetMapper with "
+          << "dimensionality " << info.Dimensionality() << " for '"
+          << filename << "', which has dimensionality " << dimensionality
+          << "!";
+      throw std::runtime_error(oss.str());
+    }
+  }
+
   /**
    * Parse a non-transposed matrix.
    *
    * @param inout Matrix to load into.
    * @param infoSet DatasetMapper object to load with.
+   * @param useExistingMappings If true, reuse the mappings of infoSet.
    */
   template<typename T, typename PolicyType>
   void NonTransposeParse(arma::Mat<T>& inout,
-                         DatasetMapper<PolicyType>& infoSet)
+                         DatasetMapper<PolicyType>& infoSet,
+                         const bool useExistingMappings = false)
   {
     using namespace boost::spirit;
 
     // Get the size of the matrix.
     size_t rows, cols;
-    GetMatrixSize<T>(rows, cols, infoSet);
+    GetMatrixSize<T>(rows, cols, infoSet, useExistingMappings);
 
     // Set up output matrix.
     inout.set_size(rows, cols);
@@ -288,15 +588,18 @@ class LoadCSV
    *
    * @param inout Matrix to load into.
    * @param infoSet DatasetMapper to load with.
+   * @param useExistingMappings If true, reuse the mappings of infoSet.
    */
   template<typename T, typename PolicyType>
-  void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet)
+  void TransposeParse(arma::Mat<T>& inout,
+                      DatasetMapper<PolicyType>& infoSet,
+                      const bool useExistingMappings = false)
   {
     using namespace boost::spirit;
 
     // Get matrix size.  This also initializes infoSet correctly.
     size_t rows, cols;
-    GetTransposeMatrixSize<T>(rows, cols, infoSet);
+    GetTransposeMatrixSize<T>(rows, cols, infoSet, useExistingMappings);
 
     // Set the matrix size.
     inout.set_size(rows, cols);
@@ -366,8 +669,12 @@ class LoadCSV
   std::string extension;
   //! Name of file.
   std::string filename;
-  //! Opened stream for reading.
-  std::ifstream inFile;
+  //! Stream of the file, if it is not compressed.
+  std::ifstream fileStream;
+  //! Decompressed contents of the file, if it is compressed.
+  std::unique_ptr<DecompressedStream> decompressedStream;
+  //! Opened stream for reading (one of the two above).
+  std::istream inFile;
 };
 
 } // namespace data
@@ -21,6 +21,8 @@
 #include "load_csv.hpp"
 #include "load.hpp"
 #include "extension.hpp"
+#include "decompress.hpp"
+#include "standard_stream.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/tokenizer.hpp>
@@ -85,27 +87,59 @@ bool Load(const std::string& filename,
 {
   Timer::Start("loading_data");
 
-  // Get the extension.
-  std::string extension = Extension(filename);
+  // Get the extension (of the decompressed file, if it is compressed).  "-"
+  // is the standard input.
+  const bool standard = IsStandardStream(filename);
+  std::string extension = standard ? StandardStreamExtension(filename) :
+      UncompressedExtension(filename);
+  const bool compressed = !standard && IsCompressed(filename);
+
+  // Catch nonexistent files by opening the stream ourselves.  Compressed files
+  // are decompressed into memory and loaded from there, and so is the standard
+  // input (since the type detection needs to seek).
+  std::fstream fileStream;
+  std::unique_ptr<std::istream> memoryStream;
+  if (standard || compressed)
+  {
+    try
+    {
+      if (standard)
+        memoryStream.reset(new StandardInputStream());
+      else
+        memoryStream.reset(new DecompressedStream(filename));
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
 
-  // Catch nonexistent files by opening the stream ourselves.
-  std::fstream stream;
+      return false;
+    }
+  }
+  else
+  {
 #ifdef  _WIN32 // Always open in binary mode on Windows.
-  stream.open(filename.c_str(), std::fstream::in | std::fstream::binary);
+    fileStream.open(filename.c_str(), std::fstream::in | std::fstream::binary);
 #else
-  stream.open(filename.c_str(), std::fstream::in);
+    fileStream.open(filename.c_str(), std::fstream::in);
 #endif
-  if (!stream.is_open())
-  {
-    Timer::Stop("loading_data");
-    if (fatal)
-      Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
-    else
-      Log::Warn << "Cannot open file '" << filename << "'; load failed."
-          << std::endl;
+    if (!fileStream.is_open())
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
+      else
+        Log::Warn << "Cannot open file '" << filename << "'; load failed."
+            << std::endl;
 
-    return false;
+      return false;
+    }
   }
+  std::istream& stream = (standard || compressed) ?
+      *memoryStream : static_cast<std::istream&>(fileStream);
 
   bool unknownType = false;
   arma::file_type loadType;
@@ -220,6 +254,21 @@ bool Load(const std::string& filename,
            extension == "he5")
   {
 #ifdef ARMA_USE_HDF5
+    if (standard || compressed)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "Cannot load '" << filename << "': compressed HDF5 "
+            << "files and HDF5 from the standard input are not supported."
+            << std::endl;
+      else
+        Log::Warn << "Cannot load '" << filename << "': compressed HDF5 "
+            << "files and HDF5 from the standard input are not supported.  "
+            << "Load failed." << std::endl;
+
+      return false;
+    }
+
     loadType = arma::hdf5_binary;
     stringType = "HDF5 data";
 #else
@@ -305,13 +354,15 @@ bool Load(const std::string& filename,
           arma::Mat<eT>& matrix,
           DatasetMapper<PolicyType>& info,
           const bool fatal,
-          const bool transpose)
+          const bool transpose,
+          const bool useExistingMappings)
 {
   // Get the extension and load as necessary.
   Timer::Start("loading_data");
 
-  // Get the extension.
-  std::string extension = Extension(filename);
+  // Get the extension (of the decompressed file, if it is compressed; LoadCSV
+  // decompresses it itself).
+  std::string extension = UncompressedExtension(filename);
 
   // Catch nonexistent files by opening the stream ourselves.
   std::fstream stream;
@@ -335,7 +386,7 @@ bool Load(const std::string& filename,
     try
     {
       LoadCSV loader(filename);
-      loader.Load(matrix, info, transpose);
+      loader.Load(matrix, info, transpose, useExistingMappings);
     }
     catch (std::exception& e)
     {
@@ -348,7 +399,7 @@ bool Load(const std::string& filename,
       return false;
     }
   }
-  else if (extension == "arff")
+  else if (extension == "arff" && !IsCompressed(filename))
   {
     Log::Info << "Loading '" << filename << "' as ARFF dataset.  "
         << std::flush;
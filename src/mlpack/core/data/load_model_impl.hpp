@@ -19,6 +19,7 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "extension.hpp"
+#include "fast_binary.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -47,6 +48,8 @@ bool Load(const std::string& filename,
       f = format::xml;
     else if (extension == "bin")
       f = format::binary;
+    else if (extension == "fbin")
+      f = format::fast_binary;
     else if (extension == "txt")
       f = format::text;
     else
@@ -65,7 +68,7 @@ bool Load(const std::string& filename,
   // Now load the given format.
   std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
-  if (f == format::binary)
+  if (f == format::binary || f == format::fast_binary)
     ifs.open(filename, std::ifstream::in | std::ifstream::binary);
   else
     ifs.open(filename, std::ifstream::in);
@@ -85,6 +88,10 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // Files in the fast binary format may also have the .bin extension.
+  if (f == format::binary && IsFastBinary(ifs))
+    f = format::fast_binary;
+
   try
   {
     if (f == format::xml)
@@ -102,6 +109,10 @@ bool Load(const std::string& filename,
       boost::archive::binary_iarchive ar(ifs);
       ar >> boost::serialization::make_nvp(name.c_str(), t);
     }
+    else if (f == format::fast_binary)
+    {
+      LoadFastBinary(filename, name, t);
+    }
 
     return true;
   }
@@ -114,6 +125,15 @@ bool Load(const std::string& filename,
 
     return false;
   }
+  catch (std::runtime_error& e)
+  {
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
 }
 
 } // namespace data
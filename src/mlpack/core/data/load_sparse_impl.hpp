@@ -0,0 +1,87 @@
+/**
+ * @file load_sparse_impl.hpp
+ *
+ * Implementation of the templatized Load() function defined in load.hpp for
+ * sparse matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_SPARSE_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_SPARSE_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "load.hpp"
+#include "extension.hpp"
+#include "load_svmlight.hpp"
+
+namespace mlpack {
+namespace data {
+
+// Load sparse matrix.
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::SpMat<eT>& matrix,
+          const bool fatal)
+{
+  const std::string extension = Extension(filename);
+  if (extension == "svm" || extension == "libsvm" || extension == "svmlight")
+  {
+    arma::rowvec labels;
+    return LoadSVMLight(filename, matrix, labels, fatal);
+  }
+
+  Timer::Start("loading_data");
+
+  arma::file_type loadType;
+  std::string stringType;
+  if (extension == "bin")
+  {
+    loadType = arma::arma_binary;
+    stringType = "Armadillo binary formatted sparse data";
+  }
+  else if (extension == "txt" || extension == "tsv")
+  {
+    loadType = arma::coord_ascii;
+    stringType = "coordinate list formatted sparse data";
+  }
+  else
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Unable to detect type of '" << filename << "'; "
+          << "incorrect extension?" << std::endl;
+    else
+      Log::Warn << "Unable to detect type of '" << filename << "'; load failed."
+          << " Incorrect extension?" << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Loading '" << filename << "' as " << stringType << ".  "
+      << std::flush;
+  const bool success = matrix.quiet_load(filename, loadType);
+  Timer::Stop("loading_data");
+
+  if (!success)
+  {
+    Log::Info << std::endl;
+    if (fatal)
+      Log::Fatal << "Loading from '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Loading from '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols << " with "
+      << matrix.n_nonzero << " nonzeros." << std::endl;
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
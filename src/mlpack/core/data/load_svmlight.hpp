@@ -0,0 +1,61 @@
+/**
+ * @file load_svmlight.hpp
+ *
+ * Load sparse datasets in the libsvm/svmlight format directly into a sparse
+ * matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_SVMLIGHT_HPP
+#define MLPACK_CORE_DATA_LOAD_SVMLIGHT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Load a dataset in the libsvm/svmlight format,
+ *
+ *   <label> <index>:<value> <index>:<value> ... # comment
+ *
+ * into a sparse matrix with one point per column, and the labels (or
+ * responses) into a row vector.  Indices are one-based, so feature i is row
+ * (i - 1) of the matrix; "qid:" tokens and comments are ignored, and zero
+ * values are not stored.  The file is split into chunks of about chunkSize
+ * bytes that end on line boundaries, and the chunks are parsed in parallel
+ * directly into the compressed sparse column arrays of the matrix, so no
+ * coordinate list of the whole file is ever built.
+ *
+ * Labels are loaded as they are; binary labels of -1 and +1 can be converted
+ * to the 0 and 1 that classifiers such as LogisticRegression expect with,
+ * e.g., arma::conv_to<arma::Row<size_t>>::from(labels > 0).
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Sparse matrix to load the points into.
+ * @param labels Row vector to load the labels into.
+ * @param fatal If true, an error will cause a Log::Fatal.
+ * @param dimensionality Number of features; if 0, the largest index in the
+ *     file is used.  Set it to load a test set with the features of a
+ *     training set.
+ * @param chunkSize Approximate number of bytes in each chunk.
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool LoadSVMLight(const std::string& filename,
+                  arma::SpMat<eT>& matrix,
+                  arma::rowvec& labels,
+                  const bool fatal = false,
+                  const size_t dimensionality = 0,
+                  const size_t chunkSize = 16 * 1024 * 1024);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_svmlight_impl.hpp"
+
+#endif
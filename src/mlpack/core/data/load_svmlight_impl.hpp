@@ -0,0 +1,321 @@
+/**
+ * @file load_svmlight_impl.hpp
+ *
+ * Implementation of LoadSVMLight().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_SVMLIGHT_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_SVMLIGHT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_svmlight.hpp"
+
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+namespace svmlight {
+
+//! The points of one chunk of a file, in compressed sparse column form.
+template<typename eT>
+struct Chunk
+{
+  //! Label of each point.
+  std::vector<double> labels;
+  //! Number of nonzeros of each point.
+  std::vector<arma::uword> counts;
+  //! Row of each nonzero.
+  std::vector<arma::uword> rows;
+  //! Value of each nonzero.
+  std::vector<eT> values;
+  //! Largest one-based index in the chunk.
+  size_t maxIndex;
+  //! Number of lines of the chunk, including empty lines and comments.
+  size_t lines;
+  //! Line of the chunk with the first error, and its message.
+  size_t errorLine;
+  std::string error;
+};
+
+//! Return whether the given character ends a token.
+inline bool IsSeparator(const char c)
+{
+  return (c == ' ' || c == '\t' || c == '\r');
+}
+
+/**
+ * Parse the lines of one chunk of a file.  Parsing stops at the first error,
+ * which is stored in the chunk.
+ */
+template<typename eT>
+void ParseChunk(const std::string& buffer, Chunk<eT>& chunk)
+{
+  chunk.maxIndex = 0;
+  chunk.lines = 0;
+
+  std::vector<std::pair<arma::uword, eT>> pairs;
+  const char* position = buffer.c_str();
+  const char* bufferEnd = position + buffer.size();
+  while (position < bufferEnd)
+  {
+    const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n',
+        bufferEnd - position));
+    if (lineEnd == NULL)
+      lineEnd = bufferEnd;
+    const char* comment = static_cast<const char*>(std::memchr(position, '#',
+        lineEnd - position));
+    const char* stop = (comment == NULL) ? lineEnd : comment;
+    ++chunk.lines;
+
+    while (position < stop && IsSeparator(*position))
+      ++position;
+
+    // Skip empty lines and comments.
+    if (position == stop)
+    {
+      position = lineEnd + 1;
+      continue;
+    }
+
+    char* end;
+    const double label = std::strtod(position, &end);
+    if (end == position || (end < stop && !IsSeparator(*end)))
+    {
+      chunk.errorLine = chunk.lines;
+      chunk.error = "invalid label";
+      return;
+    }
+    position = end;
+
+    pairs.clear();
+    bool sorted = true;
+    while (true)
+    {
+      while (position < stop && IsSeparator(*position))
+        ++position;
+      if (position >= stop)
+        break;
+
+      if (std::strncmp(position, "qid:", 4) == 0)
+      {
+        while (position < stop && !IsSeparator(*position))
+          ++position;
+        continue;
+      }
+
+      // strtoull() and strtod() skip leading whitespace and accept signs, so
+      // check the first character of each number first.
+      const unsigned long long index = std::isdigit((unsigned char) *position) ?
+          std::strtoull(position, &end, 10) : 0;
+      if (index == 0 || *end != ':' || end + 1 >= stop ||
+          IsSeparator(*(end + 1)))
+      {
+        chunk.errorLine = chunk.lines;
+        chunk.error = (index == 0 && std::isdigit((unsigned char) *position)) ?
+            "feature indices are one-based" : "invalid feature";
+        return;
+      }
+
+      position = end + 1;
+      const double value = std::strtod(position, &end);
+      if (end == position || (end < stop && !IsSeparator(*end)))
+      {
+        chunk.errorLine = chunk.lines;
+        chunk.error = "invalid feature value";
+        return;
+      }
+      position = end;
+
+      if (!pairs.empty() && index - 1 <= pairs.back().first)
+        sorted = false;
+      if (value != 0.0)
+        pairs.push_back(std::make_pair(arma::uword(index - 1), eT(value)));
+      chunk.maxIndex = std::max(chunk.maxIndex, size_t(index));
+    }
+
+    // Indices should be increasing, but sort them if they are not.
+    if (!sorted)
+    {
+      std::sort(pairs.begin(), pairs.end(),
+          [](const std::pair<arma::uword, eT>& a,
+             const std::pair<arma::uword, eT>& b)
+          {
+            return a.first < b.first;
+          });
+
+      for (size_t i = 1; i < pairs.size(); ++i)
+      {
+        if (pairs[i].first == pairs[i - 1].first)
+        {
+          chunk.errorLine = chunk.lines;
+          chunk.error = "duplicate feature index";
+          return;
+        }
+      }
+    }
+
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+      chunk.rows.push_back(pairs[i].first);
+      chunk.values.push_back(pairs[i].second);
+    }
+    chunk.labels.push_back(label);
+    chunk.counts.push_back(pairs.size());
+
+    position = lineEnd + 1;
+  }
+}
+
+} // namespace svmlight
+
+template<typename eT>
+bool LoadSVMLight(const std::string& filename,
+                  arma::SpMat<eT>& matrix,
+                  arma::rowvec& labels,
+                  const bool fatal,
+                  const size_t dimensionality,
+                  const size_t chunkSize)
+{
+  Timer::Start("loading_data");
+
+  std::ifstream stream(filename.c_str(), std::fstream::binary);
+  if (!stream.is_open())
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
+    else
+      Log::Warn << "Cannot open file '" << filename << "'; load failed."
+          << std::endl;
+
+    return false;
+  }
+
+  // Split the file into chunks that each end after a newline.
+  stream.seekg(0, std::ios::end);
+  const size_t fileSize = stream.tellg();
+  const size_t step = std::max(chunkSize, size_t(1));
+  std::vector<size_t> bounds(1, 0);
+  for (size_t offset = step; offset < fileSize; offset += step)
+  {
+    if (offset <= bounds.back())
+      continue;
+
+    stream.clear();
+    stream.seekg(offset - 1);
+    stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    const size_t bound = stream.good() ? size_t(stream.tellg()) : fileSize;
+    if (bound > bounds.back() && bound < fileSize)
+      bounds.push_back(bound);
+  }
+  bounds.push_back(fileSize);
+  const size_t numChunks = bounds.size() - 1;
+
+  // Parse the chunks in parallel, each with its own stream.
+  std::vector<svmlight::Chunk<eT>> chunks(numChunks);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    std::string buffer(bounds[c + 1] - bounds[c], '\0');
+    std::ifstream chunkStream(filename.c_str(), std::fstream::binary);
+    chunkStream.seekg(bounds[c]);
+    chunkStream.read(&buffer[0], buffer.size());
+    if (!chunkStream.good() && !buffer.empty())
+    {
+      chunks[c].lines = 0;
+      chunks[c].errorLine = 0;
+      chunks[c].error = "read error";
+      continue;
+    }
+
+    svmlight::ParseChunk(buffer, chunks[c]);
+  }
+
+  // Report the first error, and find where each chunk goes.
+  std::vector<size_t> firstPoints(numChunks + 1, 0);
+  std::vector<size_t> firstNonzeros(numChunks + 1, 0);
+  size_t lines = 0;
+  size_t maxIndex = 0;
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    if (!chunks[c].error.empty())
+    {
+      Timer::Stop("loading_data");
+      std::ostringstream oss;
+      oss << "Cannot load '" << filename << "': " << chunks[c].error
+          << " on line " << (lines + chunks[c].errorLine) << ".";
+      if (fatal)
+        Log::Fatal << oss.str() << std::endl;
+      else
+        Log::Warn << oss.str() << std::endl;
+
+      return false;
+    }
+
+    lines += chunks[c].lines;
+    maxIndex = std::max(maxIndex, chunks[c].maxIndex);
+    firstPoints[c + 1] = firstPoints[c] + chunks[c].labels.size();
+    firstNonzeros[c + 1] = firstNonzeros[c] + chunks[c].rows.size();
+  }
+
+  if (dimensionality != 0 && maxIndex > dimensionality)
+  {
+    Timer::Stop("loading_data");
+    std::ostringstream oss;
+    oss << "Cannot load '" << filename << "': it has feature index "
+        << maxIndex << ", but the dimensionality is " << dimensionality << ".";
+    if (fatal)
+      Log::Fatal << oss.str() << std::endl;
+    else
+      Log::Warn << oss.str() << std::endl;
+
+    return false;
+  }
+
+  // Copy each chunk into place, freeing it as we go.
+  const size_t points = firstPoints[numChunks];
+  const size_t nonzeros = firstNonzeros[numChunks];
+  arma::uvec rowIndices(nonzeros);
+  arma::uvec colPtrs(points + 1);
+  arma::Col<eT> values(nonzeros);
+  labels.set_size(points);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    svmlight::Chunk<eT>& chunk = chunks[c];
+    std::copy(chunk.rows.begin(), chunk.rows.end(),
+        rowIndices.begin() + firstNonzeros[c]);
+    std::copy(chunk.values.begin(), chunk.values.end(),
+        values.begin() + firstNonzeros[c]);
+    std::copy(chunk.labels.begin(), chunk.labels.end(),
+        labels.begin() + firstPoints[c]);
+
+    arma::uword colPtr = firstNonzeros[c];
+    for (size_t i = 0; i < chunk.counts.size(); ++i)
+    {
+      colPtrs[firstPoints[c] + i] = colPtr;
+      colPtr += chunk.counts[i];
+    }
+
+    chunk = svmlight::Chunk<eT>();
+  }
+  colPtrs[points] = nonzeros;
+
+  matrix = arma::SpMat<eT>(rowIndices, colPtrs, values,
+      (dimensionality == 0) ? maxIndex : dimensionality, points);
+  Timer::Stop("loading_data");
+
+  Log::Info << "Loaded '" << filename << "' as svmlight dataset.  Size is "
+      << matrix.n_rows << " x " << matrix.n_cols << " with "
+      << matrix.n_nonzero << " nonzeros." << std::endl;
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -87,49 +87,38 @@ class MissingPolicy
     static_assert(std::numeric_limits<T>::has_quiet_NaN == true,
         "Cannot use MissingPolicy with types where has_quiet_NaN() is false!");
 
-    // If we can load the string then there is no need for mapping.
-    std::stringstream token;
-    token.str(string);
-    T t;
-    token >> t; // Could be sped up by only doing this if we need to.
-
     MappedType value = std::numeric_limits<MappedType>::quiet_NaN();
     // But we can't use that for the map, so we need some other thing that will
     // represent quiet_NaN().
     const MappedType mapValue = std::nexttoward(
         std::numeric_limits<MappedType>::max(), MappedType(0));
 
-    // If extraction of the value fails, or if it is a value that is supposed to
-    // be mapped, then do mapping.
-    if (token.fail() || !token.eof() ||
-        missingSet.find(string) != std::end(missingSet))
+    // Strings in the missing set are always mapped, so only try to load the
+    // string as a value if it is not one of them.  If we can load the string
+    // then there is no need for mapping.
+    if (missingSet.find(string) == std::end(missingSet))
     {
-      // Everything is mapped to NaN.  However we must still keep track of
-      // everything that we have mapped, so we add it to the maps if needed.
-      if (maps.count(dimension) == 0 ||
-          maps[dimension].first.count(string) == 0)
-      {
-        // This string does not exist yet.
-        typedef std::pair<std::string, MappedType> PairType;
-        maps[dimension].first.insert(PairType(string, value));
-
-        // Insert right mapping too.
-        if (maps[dimension].second.count(mapValue) == 0)
-        {
-          // Create new element in reverse map.
-          maps[dimension].second.insert(std::make_pair(mapValue,
-              std::vector<std::string>()));
-        }
-        maps[dimension].second[mapValue].push_back(string);
-      }
-
-      return value;
+      std::stringstream token;
+      token.str(string);
+      T t;
+      token >> t;
+      if (!token.fail() && token.eof())
+        return t;
     }
-    else
+
+    // Everything is mapped to NaN.  However we must still keep track of
+    // everything that we have mapped, so we add it to the maps if needed; the
+    // maps of the dimension are looked up only once.
+    typename MapType::mapped_type& dimensionMaps = maps[dimension];
+    if (dimensionMaps.first.count(string) == 0)
     {
-      // We can just return the value that we read.
-      return t;
+      // This string does not exist yet.  Insert the right mapping too.
+      typedef std::pair<std::string, MappedType> PairType;
+      dimensionMaps.first.insert(PairType(string, value));
+      dimensionMaps.second[mapValue].push_back(string);
     }
+
+    return value;
   }
 
  private:
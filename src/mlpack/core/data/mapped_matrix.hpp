@@ -0,0 +1,128 @@
+/**
+ * @file mapped_matrix.hpp
+ *
+ * Read-only matrices that are memory-mapped from Armadillo binary files, so
+ * that many processes can share one copy of a large matrix in the page cache.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The alignment, in bytes, of the data of the files written by
+ * SaveMappable().
+ */
+static const size_t mappableAlignment = 64;
+
+/**
+ * Save the given matrix as an Armadillo binary (arma_binary) file that can be
+ * memory-mapped by MappedMatrix.  The header of the file is padded with spaces
+ * so that the data starts at a multiple of 64 bytes; the file can still be
+ * loaded with arma::Mat::load() or data::Load().  Unlike data::Save(), the
+ * matrix is never transposed: it is stored as it is in memory, with one point
+ * per column.
+ *
+ * @param filename Name of the file to save to.
+ * @param matrix Matrix to save.
+ * @param fatal If true, an error will cause a Log::Fatal.
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT>
+bool SaveMappable(const std::string& filename,
+                  const arma::Mat<eT>& matrix,
+                  const bool fatal = false);
+
+/**
+ * A MappedMatrix memory-maps an Armadillo binary (arma_binary) file and
+ * exposes its data as a read-only arma::Mat alias, without copying it.
+ * Opening the file is nearly free, the data is read from disk only as it is
+ * used, and every process that maps the same file shares its pages in the
+ * page cache.  The mapping is read-only, so the alias must not be modified.
+ *
+ * The data must start at an offset that is a multiple of the element size;
+ * files written by SaveMappable() start it at a multiple of 64 bytes.  If the
+ * data of a file is not aligned, or memory mapping is unavailable (on
+ * Windows), the matrix is instead loaded into memory, with a warning.
+ *
+ * @code
+ * data::MappedMatrix<double> features("features.bin");
+ * const arma::mat& dataset = features.Matrix();
+ * @endcode
+ *
+ * @tparam eT Element type of the matrix.
+ */
+template<typename eT>
+class MappedMatrix
+{
+ public:
+  /**
+   * Map the given Armadillo binary file.  Throws std::runtime_error if the
+   * file cannot be opened or is not a valid Armadillo binary file for the
+   * element type.
+   *
+   * @param filename Name of the file to map.
+   */
+  MappedMatrix(const std::string& filename);
+
+  //! Unmap the file.
+  ~MappedMatrix();
+
+  // A mapping cannot be copied.
+  MappedMatrix(const MappedMatrix&) = delete;
+  MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+  //! Get the matrix.
+  const arma::Mat<eT>& Matrix() const { return matrix; }
+
+  //! Return whether or not the matrix is an alias of the mapped file (false
+  //! if it had to be loaded into memory).
+  bool Mapped() const { return mapping != NULL; }
+
+ private:
+  //! A mapped region and the matrix data in it.
+  struct Region
+  {
+    void* mapping;
+    size_t size;
+    eT* data;
+    size_t rows;
+    size_t cols;
+  };
+
+  /**
+   * Map the given file and parse its header.  If the file cannot be mapped
+   * without copying, the returned region is empty.
+   */
+  static Region MapFile(const std::string& filename);
+
+  //! Make the matrix an alias of the data of the given region; if it is
+  //! empty, load the file instead.
+  MappedMatrix(const std::string& filename, const Region& region);
+
+  //! Release the mapping, if there is one.
+  void Unmap();
+
+  //! The start of the mapped region, or NULL if nothing is mapped.
+  void* mapping;
+  //! The size of the mapped region.
+  size_t mappingSize;
+  //! The matrix (an alias of the mapped data, if the file is mapped).
+  arma::Mat<eT> matrix;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
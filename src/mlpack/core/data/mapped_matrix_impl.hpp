@@ -0,0 +1,199 @@
+/**
+ * @file mapped_matrix_impl.hpp
+ *
+ * Implementation of memory-mapped matrices and SaveMappable().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_matrix.hpp"
+
+#ifndef _WIN32
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+bool SaveMappable(const std::string& filename,
+                  const arma::Mat<eT>& matrix,
+                  const bool fatal)
+{
+  std::ofstream stream(filename.c_str(), std::fstream::binary);
+  if (!stream.is_open())
+  {
+    if (fatal)
+      Log::Fatal << "Cannot open file '" << filename << "' for writing."
+          << std::endl;
+    else
+      Log::Warn << "Cannot open file '" << filename << "' for writing; save "
+          << "failed." << std::endl;
+
+    return false;
+  }
+
+  // Pad the header with spaces, which arma::Mat::load() skips, so that the
+  // data starts at a multiple of the alignment.
+  std::ostringstream size;
+  size << matrix.n_rows << " " << matrix.n_cols << "\n";
+  std::string header = arma::diskio::gen_bin_header(matrix) + "\n";
+  const size_t length = header.size() + size.str().size();
+  const size_t padding = (mappableAlignment - length % mappableAlignment) %
+      mappableAlignment;
+  header += std::string(padding, ' ') + size.str();
+
+  stream.write(header.c_str(), header.size());
+  stream.write(reinterpret_cast<const char*>(matrix.memptr()),
+      std::streamsize(matrix.n_elem * sizeof(eT)));
+
+  if (!stream.good())
+  {
+    if (fatal)
+      Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename) :
+    MappedMatrix(filename, MapFile(filename))
+{
+  // Nothing to do.
+}
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename,
+                               const Region& region) :
+    mapping(region.mapping),
+    mappingSize(region.size),
+    // A non-strict alias, so that the fallback below can still load into it.
+    matrix(region.data, region.rows, region.cols, false, false)
+{
+  if (mapping != NULL)
+    return;
+
+  if (!matrix.load(filename, arma::arma_binary))
+  {
+    std::ostringstream oss;
+    oss << "MappedMatrix::MappedMatrix(): cannot load '" << filename << "'!";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+template<typename eT>
+MappedMatrix<eT>::~MappedMatrix()
+{
+  Unmap();
+}
+
+template<typename eT>
+typename MappedMatrix<eT>::Region MappedMatrix<eT>::MapFile(
+    const std::string& filename)
+{
+  Region region = { NULL, 0, NULL, 0, 0 };
+
+#ifdef _WIN32
+  Log::Warn << "MappedMatrix: memory mapping is not supported on this "
+      << "platform; loading '" << filename << "' into memory." << std::endl;
+  return region;
+#else
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::ostringstream oss;
+    oss << "MappedMatrix::MappedMatrix(): cannot open file '" << filename
+        << "'!";
+    throw std::runtime_error(oss.str());
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+  {
+    close(fd);
+    std::ostringstream oss;
+    oss << "MappedMatrix::MappedMatrix(): '" << filename << "' is empty or "
+        << "cannot be read!";
+    throw std::runtime_error(oss.str());
+  }
+
+  // The mapping stays valid after the file is closed.
+  const size_t size = fileStat.st_size;
+  void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    std::ostringstream oss;
+    oss << "MappedMatrix::MappedMatrix(): cannot map '" << filename << "'!";
+    throw std::runtime_error(oss.str());
+  }
+
+  // Parse the header the same way arma::Mat::load() does.
+  const char* bytes = static_cast<const char*>(mapping);
+  std::istringstream header(std::string(bytes, std::min(size, size_t(4096))));
+  const std::string expected = arma::diskio::gen_bin_header(arma::Mat<eT>());
+  std::string token;
+  size_t rows = 0, cols = 0;
+  header >> token >> rows >> cols;
+  header.get();
+
+  const size_t offset = header.fail() ? size : size_t(header.tellg());
+  if (header.fail() || token != expected ||
+      rows * cols * sizeof(eT) > size - offset)
+  {
+    munmap(mapping, size);
+    std::ostringstream oss;
+    oss << "MappedMatrix::MappedMatrix(): '" << filename << "' is not a valid "
+        << "Armadillo binary file with header '" << expected << "'!";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (offset % sizeof(eT) != 0)
+  {
+    munmap(mapping, size);
+    Log::Warn << "MappedMatrix: the data of '" << filename << "' is not "
+        << "aligned; loading it into memory.  Save it with SaveMappable() to "
+        << "map it." << std::endl;
+    return region;
+  }
+
+  // Armadillo has no read-only alias; the pages are mapped read-only, so the
+  // const_cast is safe as long as the alias is only exposed as const.
+  region.mapping = mapping;
+  region.size = size;
+  region.data = const_cast<eT*>(reinterpret_cast<const eT*>(bytes + offset));
+  region.rows = rows;
+  region.cols = cols;
+  return region;
+#endif
+}
+
+template<typename eT>
+void MappedMatrix<eT>::Unmap()
+{
+#ifndef _WIN32
+  if (mapping != NULL)
+    munmap(mapping, mappingSize);
+#endif
+  mapping = NULL;
+  mappingSize = 0;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
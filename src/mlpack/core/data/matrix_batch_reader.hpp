@@ -0,0 +1,163 @@
+/**
+ * @file matrix_batch_reader.hpp
+ *
+ * Read a dataset in memory one batch of points at a time, in a new random
+ * order on every pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MATRIX_BATCH_READER_HPP
+#define MLPACK_CORE_DATA_MATRIX_BATCH_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A MatrixBatchReader reads the columns of a matrix (and of its labels or
+ * responses) a batch at a time.  Unlike math::ShuffleData(), which copies the
+ * whole dataset, it only shuffles the order of the points, once per pass, and
+ * gathers the columns of each batch when it is read; wrapped in a
+ * PrefetchLoader, the gathering happens in the background.
+ *
+ * Like the file readers, it is a loader for the Update() methods of the
+ * learners: it is called as reader(batch) or reader(predictors, labels), and
+ * returns false at the end of the pass; Reset() starts a new pass.
+ *
+ * @code
+ * data::MatrixBatchReader<> reader(predictors, responses, 64);
+ * data::PrefetchLoader<data::MatrixBatchReader<>> loader(reader);
+ * for (size_t epoch = 0; epoch < 10; ++epoch)
+ * {
+ *   model.Update(loader, sgd);
+ *   loader.Reset();
+ * }
+ * @endcode
+ *
+ * Neither the dataset nor the labels are copied, so they must outlive the
+ * reader.
+ *
+ * @tparam MatType Type of the dataset.
+ * @tparam LabelsType Type of the labels (such as arma::Row<size_t>).
+ */
+template<typename MatType = arma::mat, typename LabelsType = arma::mat>
+class MatrixBatchReader
+{
+ public:
+  /**
+   * Read the given dataset, without labels.
+   *
+   * @param dataset Dataset to read, one point per column.
+   * @param batchSize Number of points in each batch.
+   * @param shuffle Whether to read the points in a random order.
+   */
+  MatrixBatchReader(const MatType& dataset,
+                    const size_t batchSize = 1000,
+                    const bool shuffle = true) :
+      dataset(dataset),
+      labels(NULL),
+      batchSize(batchSize),
+      shuffle(shuffle)
+  {
+    Reset();
+  }
+
+  /**
+   * Read the given dataset and its labels.
+   *
+   * @param dataset Dataset to read, one point per column.
+   * @param labels Labels or responses of the points, one per column.
+   * @param batchSize Number of points in each batch.
+   * @param shuffle Whether to read the points in a random order.
+   */
+  MatrixBatchReader(const MatType& dataset,
+                    const LabelsType& labels,
+                    const size_t batchSize = 1000,
+                    const bool shuffle = true) :
+      dataset(dataset),
+      labels(&labels),
+      batchSize(batchSize),
+      shuffle(shuffle)
+  {
+    if (labels.n_cols != dataset.n_cols)
+    {
+      throw std::invalid_argument("MatrixBatchReader: the number of labels "
+          "differs from the number of points");
+    }
+
+    Reset();
+  }
+
+  //! Read the next batch of points; return false at the end of the pass.
+  bool operator()(MatType& batch)
+  {
+    if (position >= ordering.n_elem)
+      return false;
+
+    const size_t last = std::min(position + batchSize, (size_t)
+        ordering.n_elem) - 1;
+    batch = dataset.cols(ordering.subvec(position, last));
+    position = last + 1;
+    return true;
+  }
+
+  //! Read the next batch of points and their labels; return false at the end
+  //! of the pass.
+  bool operator()(MatType& predictors, LabelsType& batchLabels)
+  {
+    if (labels == NULL)
+    {
+      throw std::invalid_argument("MatrixBatchReader: the reader was "
+          "constructed without labels");
+    }
+
+    const size_t first = position;
+    if (!(*this)(predictors))
+      return false;
+
+    batchLabels = labels->cols(ordering.subvec(first, position - 1));
+    return true;
+  }
+
+  //! Start a new pass, in a new order if the points are shuffled.
+  void Reset()
+  {
+    position = 0;
+    if (dataset.n_cols == 0)
+      ordering.reset();
+    else if (shuffle)
+      ordering = math::RandPermutation(dataset.n_cols);
+    else
+      ordering = arma::linspace<arma::uvec>(0, dataset.n_cols - 1,
+          dataset.n_cols);
+  }
+
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each batch.
+  size_t& BatchSize() { return batchSize; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The labels, if any.
+  const LabelsType* labels;
+  //! Number of points in each batch.
+  size_t batchSize;
+  //! Whether to read the points in a random order.
+  bool shuffle;
+  //! The order of the points in this pass.
+  arma::uvec ordering;
+  //! The position of the next batch in the order.
+  size_t position;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
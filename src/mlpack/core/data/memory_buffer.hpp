@@ -0,0 +1,74 @@
+/**
+ * @file memory_buffer.hpp
+ *
+ * A read-only, seekable stream buffer over a block of memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MEMORY_BUFFER_HPP
+#define MLPACK_CORE_DATA_MEMORY_BUFFER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A std::streambuf that reads from a block of memory that it does not own,
+ * such as a string or a memory-mapped file.  It supports seeking, so streams
+ * and archives over it behave like those over a file, but reads are plain
+ * copies out of memory.
+ */
+class MemoryBuffer : public std::streambuf
+{
+ public:
+  //! Make the buffer empty.
+  MemoryBuffer() { }
+
+  //! Point the buffer at the given block of memory.
+  MemoryBuffer(const char* data, const size_t size) { Reset(data, size); }
+
+  //! Point the buffer at the given block of memory.
+  void Reset(const char* data, const size_t size)
+  {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+
+ protected:
+  virtual pos_type seekoff(off_type offset,
+                           std::ios_base::seekdir direction,
+                           std::ios_base::openmode mode)
+  {
+    if (!(mode & std::ios_base::in))
+      return pos_type(off_type(-1));
+
+    off_type base;
+    if (direction == std::ios_base::beg)
+      base = 0;
+    else if (direction == std::ios_base::cur)
+      base = gptr() - eback();
+    else
+      base = egptr() - eback();
+
+    const off_type target = base + offset;
+    if (target < 0 || target > egptr() - eback())
+      return pos_type(off_type(-1));
+
+    setg(eback(), eback() + target, egptr());
+    return pos_type(target);
+  }
+
+  virtual pos_type seekpos(pos_type position, std::ios_base::openmode mode)
+  {
+    return seekoff(off_type(position), std::ios_base::beg, mode);
+  }
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
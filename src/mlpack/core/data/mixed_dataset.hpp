@@ -0,0 +1,128 @@
+/**
+ * @file mixed_dataset.hpp
+ *
+ * A compact container for datasets with numeric and categorical dimensions,
+ * which stores the categorical dimensions as small integer codes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MIXED_DATASET_HPP
+#define MLPACK_CORE_DATA_MIXED_DATASET_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A MixedDataset holds a dataset with numeric and categorical dimensions (as
+ * described by a DatasetInfo) in two matrices: one of NumericType for the
+ * numeric dimensions, and one of CodeType for the categorical dimensions, each
+ * with one point per column.  A categorical value is stored as its mapped
+ * value (from 0 to the number of mappings of its dimension minus 1), so with
+ * 8-bit or 16-bit codes the categorical dimensions take four to eight times
+ * less memory than in an arma::mat, and more of them fit in the cache while
+ * splits are searched.
+ *
+ * DecisionTree and RandomForest can be trained on a MixedDataset given its
+ * DatasetInfo, in place of a matrix:
+ *
+ * @code
+ * arma::mat dataset;
+ * data::DatasetInfo info;
+ * data::Load("mixed.arff", dataset, info);
+ *
+ * // At most 256 categories per categorical dimension.
+ * data::MixedDataset<double, uint8_t> mixed(dataset, info);
+ * DecisionTree<> tree(mixed, info, labels, numClasses);
+ * @endcode
+ *
+ * The split policies then read the codes directly.  Like an Armadillo matrix,
+ * a MixedDataset has one row per dimension and one column per point; points
+ * are classified as columns of a matrix, which ToMatrix() rebuilds.
+ *
+ * @tparam NumericType Type of the numeric values (float or double).
+ * @tparam CodeType Unsigned integer type of the categorical codes.
+ */
+template<typename NumericType = double, typename CodeType = uint32_t>
+class MixedDataset
+{
+ public:
+  //! Create an empty dataset.
+  MixedDataset() : n_rows(0), n_cols(0) { }
+
+  /**
+   * Convert the given dataset, whose types are given by the DatasetInfo.
+   * Throws std::invalid_argument if the dimensionality of the dataset and the
+   * DatasetInfo differ, or if a categorical dimension has more mappings than
+   * CodeType can hold.
+   *
+   * @param dataset Dataset to convert, with one point per column.
+   * @param info DatasetInfo of the dataset.
+   */
+  template<typename eT>
+  MixedDataset(const arma::Mat<eT>& dataset, const DatasetInfo& info);
+
+  //! Get the value of the given dimension of the given point.
+  double operator()(const size_t dimension, const size_t point) const
+  {
+    return categorical[dimension] ? (double) codes(rows[dimension], point) :
+        (double) numeric(rows[dimension], point);
+  }
+
+  //! Swap the given points (as arma::Mat::swap_cols() does).
+  void swap_cols(const size_t first, const size_t second)
+  {
+    numeric.swap_cols(first, second);
+    codes.swap_cols(first, second);
+  }
+
+  //! Get a dataset of the points with the given indices, in that order.
+  MixedDataset cols(const arma::uvec& indices) const;
+
+  //! Rebuild the dataset as a matrix, with one point per column.
+  template<typename eT>
+  void ToMatrix(arma::Mat<eT>& matrix) const;
+
+  //! Get whether the given dimension is categorical.
+  bool Categorical(const size_t dimension) const
+  {
+    return categorical[dimension];
+  }
+
+  //! Get the row of the given dimension in Numeric() or Codes().
+  size_t Row(const size_t dimension) const { return rows[dimension]; }
+
+  //! Get the values of the numeric dimensions, one point per column.
+  const arma::Mat<NumericType>& Numeric() const { return numeric; }
+  //! Get the codes of the categorical dimensions, one point per column.
+  const arma::Mat<CodeType>& Codes() const { return codes; }
+
+  //! The number of dimensions (read-only, as for Armadillo matrices).
+  size_t n_rows;
+  //! The number of points (read-only, as for Armadillo matrices).
+  size_t n_cols;
+
+ private:
+  //! The values of the numeric dimensions.
+  arma::Mat<NumericType> numeric;
+  //! The codes of the categorical dimensions.
+  arma::Mat<CodeType> codes;
+  //! The row of each dimension in numeric or codes.
+  arma::Col<size_t> rows;
+  //! Whether each dimension is categorical.
+  std::vector<bool> categorical;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mixed_dataset_impl.hpp"
+
+#endif
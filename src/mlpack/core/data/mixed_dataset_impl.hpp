@@ -0,0 +1,127 @@
+/**
+ * @file mixed_dataset_impl.hpp
+ *
+ * Implementation of the MixedDataset container.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MIXED_DATASET_IMPL_HPP
+#define MLPACK_CORE_DATA_MIXED_DATASET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mixed_dataset.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename NumericType, typename CodeType>
+template<typename eT>
+MixedDataset<NumericType, CodeType>::MixedDataset(
+    const arma::Mat<eT>& dataset,
+    const DatasetInfo& info) :
+    n_rows(dataset.n_rows),
+    n_cols(dataset.n_cols),
+    rows(dataset.n_rows),
+    categorical(dataset.n_rows, false)
+{
+  if (info.Dimensionality() != dataset.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "MixedDataset::MixedDataset(): the dataset has " << dataset.n_rows
+        << " dimensions, but the DatasetInfo has " << info.Dimensionality();
+    throw std::invalid_argument(oss.str());
+  }
+
+  size_t numCategorical = 0;
+  for (size_t i = 0; i < dataset.n_rows; ++i)
+  {
+    if (info.Type(i) != Datatype::categorical)
+      continue;
+
+    if (info.NumMappings(i) > (size_t) std::numeric_limits<CodeType>::max() +
+        1)
+    {
+      std::ostringstream oss;
+      oss << "MixedDataset::MixedDataset(): dimension " << i << " has "
+          << info.NumMappings(i) << " categories, more than the code type can "
+          << "hold";
+      throw std::invalid_argument(oss.str());
+    }
+
+    categorical[i] = true;
+    ++numCategorical;
+  }
+
+  numeric.set_size(dataset.n_rows - numCategorical, dataset.n_cols);
+  codes.set_size(numCategorical, dataset.n_cols);
+  size_t numericRow = 0, codeRow = 0;
+  for (size_t i = 0; i < dataset.n_rows; ++i)
+    rows[i] = categorical[i] ? codeRow++ : numericRow++;
+
+  // Each point is converted by one thread.
+  bool valid = true;
+  #pragma omp parallel for schedule(static) reduction(&&:valid) \
+      if (dataset.n_elem >= 100000)
+  for (omp_size_t j = 0; j < (omp_size_t) dataset.n_cols; ++j)
+  {
+    for (size_t i = 0; i < dataset.n_rows; ++i)
+    {
+      const eT value = dataset(i, j);
+      if (!categorical[i])
+      {
+        numeric(rows[i], j) = (NumericType) value;
+      }
+      else if (value >= 0 && (size_t) value < info.NumMappings(i))
+      {
+        codes(rows[i], j) = (CodeType) value;
+      }
+      else
+      {
+        codes(rows[i], j) = 0;
+        valid = false;
+      }
+    }
+  }
+
+  if (!valid)
+  {
+    throw std::invalid_argument("MixedDataset::MixedDataset(): a categorical "
+        "value is not one of the mapped values of its dimension");
+  }
+}
+
+template<typename NumericType, typename CodeType>
+MixedDataset<NumericType, CodeType>
+MixedDataset<NumericType, CodeType>::cols(const arma::uvec& indices) const
+{
+  MixedDataset subset;
+  subset.n_rows = n_rows;
+  subset.n_cols = indices.n_elem;
+  subset.numeric = numeric.cols(indices);
+  subset.codes = codes.cols(indices);
+  subset.rows = rows;
+  subset.categorical = categorical;
+  return subset;
+}
+
+template<typename NumericType, typename CodeType>
+template<typename eT>
+void MixedDataset<NumericType, CodeType>::ToMatrix(arma::Mat<eT>& matrix) const
+{
+  matrix.set_size(n_rows, n_cols);
+  for (size_t i = 0; i < n_rows; ++i)
+  {
+    if (categorical[i])
+      matrix.row(i) = arma::conv_to<arma::Row<eT>>::from(codes.row(rows[i]));
+    else
+      matrix.row(i) = arma::conv_to<arma::Row<eT>>::from(numeric.row(rows[i]));
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
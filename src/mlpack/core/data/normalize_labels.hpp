@@ -25,6 +25,10 @@ namespace data {
  * a reverse mapping from the new label to the old value is stored in the
  * 'mapping' vector.
  *
+ * The new labels are given in the order in which the labels first appear.  The
+ * labels are looked up in a hash table, in parallel for large label vectors,
+ * so this takes O(n) time however many different labels there are.
+ *
  * @param labelsIn Input labels of arbitrary datatype.
  * @param labels Vector that unsigned labels will be stored in.
  * @param mapping Reverse mapping to convert new labels back to old labels.
@@ -34,10 +38,30 @@ void NormalizeLabels(const RowType& labelsIn,
                      arma::Row<size_t>& labels,
                      arma::Col<eT>& mapping);
 
+/**
+ * Given a set of labels of a particular datatype and an existing mapping (for
+ * instance from NormalizeLabels() on the training set), convert the labels to
+ * unsigned labels so that the value mapping[j] becomes j.  Labels that are not
+ * in the mapping yet are appended to it, in the order in which they first
+ * appear, so the same mapping can be reused for several sets of labels.
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param labels Vector that unsigned labels will be stored in.
+ * @param mapping Reverse mapping to convert new labels back to old labels; it
+ *     is extended with the labels it doesn't have.
+ */
+template<typename eT, typename RowType>
+void MapLabels(const RowType& labelsIn,
+               arma::Row<size_t>& labels,
+               arma::Col<eT>& mapping);
+
 /**
  * Given a set of labels that have been mapped to the range [0, n), map them
  * back to the original labels given by the 'mapping' vector.
  *
+ * This runs in parallel for large label vectors.  A std::invalid_argument is
+ * thrown if a label has no value in the mapping.
+ *
  * @param labels Set of normalized labels to convert.
  * @param mapping Mapping to use to convert labels.
  * @param labelsOut Vector to store new labels in.
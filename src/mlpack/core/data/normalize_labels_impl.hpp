@@ -16,9 +16,18 @@
 // In case it hasn't been included yet.
 #include "normalize_labels.hpp"
 
+#include <unordered_map>
+
 namespace mlpack {
 namespace data {
 
+namespace details {
+
+//! The label vectors with fewer elements than this are handled by one thread.
+const size_t parallelLabelsThreshold = 10000;
+
+} // namespace details
+
 /**
  * Given a set of labels of a particular datatype, convert them to unsigned
  * labels in the range [0, n) where n is the number of different labels.  Also,
@@ -34,37 +43,99 @@ void NormalizeLabels(const RowType& labelsIn,
                      arma::Row<size_t>& labels,
                      arma::Col<eT>& mapping)
 {
-  // Loop over the input labels, and develop the mapping.  We'll first naively
-  // resize the mapping to the maximum possible size, and then when we fill it,
-  // we'll resize it back down to its actual size.
-  mapping.set_size(labelsIn.n_elem);
-  labels.set_size(labelsIn.n_elem);
-  size_t curLabel = 0;
-  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  mapping.reset();
+  MapLabels(labelsIn, labels, mapping);
+}
+
+/**
+ * Given a set of labels of a particular datatype and an existing mapping,
+ * convert the labels to unsigned labels so that the value mapping[j] becomes
+ * j, and append the labels that aren't in the mapping to it.
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param labels Vector that unsigned labels will be stored in.
+ * @param mapping Reverse mapping to convert new labels back to old labels.
+ */
+template<typename eT, typename RowType>
+void MapLabels(const RowType& labelsIn,
+               arma::Row<size_t>& labels,
+               arma::Col<eT>& mapping)
+{
+  const size_t n = labelsIn.n_elem;
+  const size_t unknown = std::numeric_limits<size_t>::max();
+  labels.set_size(n);
+
+  // The first occurrence of a value in the mapping wins.
+  std::unordered_map<eT, size_t> index(2 * mapping.n_elem + 1);
+  for (size_t j = 0; j < mapping.n_elem; ++j)
+    index.emplace(mapping[j], j);
+
+  // Look up each label; each thread also keeps the first position of the
+  // values it didn't find in its part of the labels, and these are merged
+  // into the first position of each new value.
+  std::unordered_map<eT, size_t> firstPositions;
+  #pragma omp parallel if (n >= details::parallelLabelsThreshold)
   {
-    bool found = false;
-    for (size_t j = 0; j < curLabel; ++j)
+    std::unordered_map<eT, size_t> threadFirstPositions;
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
     {
-      // Is the label already in the list of labels we have seen?
-      if (labelsIn[i] == mapping[j])
+      const eT value = labelsIn[i];
+      typename std::unordered_map<eT, size_t>::const_iterator it =
+          index.find(value);
+      if (it != index.end())
       {
-        labels[i] = j;
-        found = true;
-        break;
+        labels[i] = it->second;
+      }
+      else
+      {
+        labels[i] = unknown;
+        threadFirstPositions.emplace(value, i);
       }
     }
 
-    // Do we need to add this new label?
-    if (!found)
+    #pragma omp critical(MapLabelsMerge)
     {
-      mapping[curLabel] = labelsIn[i];
-      labels[i] = curLabel;
-      ++curLabel;
+      for (const std::pair<const eT, size_t>& p : threadFirstPositions)
+      {
+        std::pair<typename std::unordered_map<eT, size_t>::iterator, bool>
+            inserted = firstPositions.insert(p);
+        if (!inserted.second && p.second < inserted.first->second)
+          inserted.first->second = p.second;
+      }
     }
   }
 
-  // Resize mapping back down to necessary size.
-  mapping.resize(curLabel);
+  if (firstPositions.empty())
+    return;
+
+  // Give the new values the next labels in the order of their first
+  // appearance, which is what a serial scan would do.
+  std::vector<std::pair<size_t, eT>> newValues;
+  newValues.reserve(firstPositions.size());
+  for (const std::pair<const eT, size_t>& p : firstPositions)
+    newValues.push_back(std::make_pair(p.second, p.first));
+  std::sort(newValues.begin(), newValues.end(),
+      [](const std::pair<size_t, eT>& a, const std::pair<size_t, eT>& b)
+      {
+        return a.first < b.first;
+      });
+
+  const size_t oldSize = mapping.n_elem;
+  mapping.resize(oldSize + newValues.size());
+  for (size_t j = 0; j < newValues.size(); ++j)
+  {
+    mapping[oldSize + j] = newValues[j].second;
+    index[newValues[j].second] = oldSize + j;
+  }
+
+  #pragma omp parallel for schedule(static) \
+      if (n >= details::parallelLabelsThreshold)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    if (labels[i] == unknown)
+      labels[i] = index.find((eT) labelsIn[i])->second;
+  }
 }
 
 /**
@@ -80,10 +151,20 @@ void RevertLabels(const arma::Row<size_t>& labels,
                   const arma::Col<eT>& mapping,
                   arma::Row<eT>& labelsOut)
 {
+  if (labels.n_elem > 0 && arma::max(labels) >= mapping.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "RevertLabels(): label " << arma::max(labels) << " has no value in "
+        << "the mapping of " << mapping.n_elem << " labels";
+    throw std::invalid_argument(oss.str());
+  }
+
   // We already have the mapping, so we just need to loop over each element.
   labelsOut.set_size(labels.n_elem);
 
-  for (size_t i = 0; i < labels.n_elem; ++i)
+  #pragma omp parallel for schedule(static) \
+      if (labels.n_elem >= details::parallelLabelsThreshold)
+  for (omp_size_t i = 0; i < (omp_size_t) labels.n_elem; ++i)
     labelsOut[i] = mapping[labels[i]];
 }
 
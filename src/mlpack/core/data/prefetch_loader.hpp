@@ -0,0 +1,292 @@
+/**
+ * @file prefetch_loader.hpp
+ *
+ * A loader that reads the next batches of another loader in a background
+ * thread, while the current batch is trained on.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PREFETCH_LOADER_HPP
+#define MLPACK_CORE_DATA_PREFETCH_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A PrefetchLoader wraps a loader (such as CSVBatchReader, BinaryBatchReader
+ * or MatrixBatchReader) and reads its batches in a background thread, up to
+ * the given number of batches ahead, so that reading, decoding, shuffling and
+ * augmenting the next batches overlaps the training on the current one.  It is
+ * itself a loader for the Update() methods of the learners (such as
+ * FFN::Update() or LogisticRegression::Update()): it is called as
+ * loader(batch) or loader(predictors, labels), and returns false when the
+ * wrapped loader has no more batches.
+ *
+ * The batches are handed over by swapping matrices, so they are never copied,
+ * and the matrices given back by the caller are reused for the next batches.
+ * An optional transform is applied to every batch in the background thread,
+ * for instance to augment or normalize it; it is called as
+ * transform(predictors, labels), with an empty labels object for batches
+ * without labels.  If the wrapped loader or the transform throws, the
+ * exception is rethrown by the call that would have returned the batch.
+ *
+ * @code
+ * data::CSVBatchReader<> reader("training.csv", 1024);
+ * data::PrefetchLoader<data::CSVBatchReader<>> loader(reader, 4);
+ * model.Update(loader, sgd);
+ * @endcode
+ *
+ * The wrapped loader is only used by the background thread until the end of
+ * the pass (or until Reset()), and it is not copied, so it must outlive the
+ * PrefetchLoader.  All the calls of a pass must use the same form (with or
+ * without labels).
+ *
+ * @tparam LoaderType Type of the wrapped loader.
+ * @tparam BatchType Type of the batches of predictors.
+ * @tparam LabelsType Type of the batches of labels (or responses).
+ */
+template<typename LoaderType,
+         typename BatchType = arma::mat,
+         typename LabelsType = arma::mat>
+class PrefetchLoader
+{
+ public:
+  //! The type of the transform applied to every batch.
+  typedef std::function<void(BatchType&, LabelsType&)> TransformType;
+
+  /**
+   * Wrap the given loader.  No batch is read until the first call.
+   *
+   * @param loader Loader to read the batches of.
+   * @param depth Number of batches to read ahead (at least one).
+   * @param transform Transform to apply to every batch, if any.
+   */
+  PrefetchLoader(LoaderType& loader,
+                 const size_t depth = 2,
+                 const TransformType& transform = TransformType()) :
+      loader(loader),
+      depth(std::max(depth, (size_t) 1)),
+      transform(transform),
+      started(false),
+      withLabels(false),
+      finished(false),
+      stopping(false)
+  {
+    // Nothing to do here.
+  }
+
+  //! Stop the background thread.
+  ~PrefetchLoader() { Stop(); }
+
+  //! Get the next batch; return false if there are no more batches.
+  bool operator()(BatchType& batch)
+  {
+    LabelsType labels;
+    Start(std::false_type());
+    return Next(batch, labels);
+  }
+
+  //! Get the next batch and its labels; return false if there are no more
+  //! batches.
+  bool operator()(BatchType& predictors, LabelsType& labels)
+  {
+    Start(std::true_type());
+    return Next(predictors, labels);
+  }
+
+  //! Stop reading ahead, drop the batches read so far, and reset the wrapped
+  //! loader (which must have a Reset() method) for a new pass.
+  void Reset()
+  {
+    Stop();
+    loader.Reset();
+  }
+
+  //! Get the number of batches read ahead.
+  size_t Depth() const { return depth; }
+
+ private:
+  //! A batch and its labels.
+  typedef std::pair<BatchType, LabelsType> Slot;
+
+  //! Start the background thread for the given form of the calls, if it is
+  //! not running yet.  Only the form that is used is compiled, so the wrapped
+  //! loader needs not have both.
+  template<typename LabelsTag>
+  void Start(LabelsTag labels)
+  {
+    if (started)
+    {
+      if (LabelsTag::value != withLabels)
+      {
+        throw std::invalid_argument("PrefetchLoader: all the calls of a pass "
+            "must be with labels, or all without");
+      }
+
+      return;
+    }
+
+    started = true;
+    withLabels = LabelsTag::value;
+    finished = false;
+    stopping = false;
+    producer = std::thread([this, labels]() { Produce(labels); });
+  }
+
+  //! Stop the background thread, and drop the batches that were read.
+  void Stop()
+  {
+    if (!started)
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    changed.notify_all();
+    producer.join();
+
+    ready.clear();
+    error = std::exception_ptr();
+    started = false;
+  }
+
+  //! Read batches until the loader is exhausted or the thread is stopped.
+  template<typename LabelsTag>
+  void Produce(LabelsTag labels)
+  {
+    while (true)
+    {
+      Slot slot;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]()
+        {
+          return stopping || ready.size() < depth;
+        });
+        if (stopping)
+          return;
+
+        if (!spare.empty())
+        {
+          slot = std::move(spare.back());
+          spare.pop_back();
+        }
+      }
+
+      bool more = false;
+      std::exception_ptr failure;
+      try
+      {
+        more = Read(slot, labels);
+        if (more && transform)
+          transform(slot.first, slot.second);
+      }
+      catch (...)
+      {
+        failure = std::current_exception();
+      }
+
+      const bool last = (failure || !more);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (last)
+        {
+          error = std::move(failure);
+          finished = true;
+        }
+        else
+        {
+          ready.push_back(std::move(slot));
+        }
+      }
+      changed.notify_all();
+
+      if (last)
+        return;
+    }
+  }
+
+  //! Read a batch without labels.
+  bool Read(Slot& slot, std::false_type) { return loader(slot.first); }
+
+  //! Read a batch with labels.
+  bool Read(Slot& slot, std::true_type)
+  {
+    return loader(slot.first, slot.second);
+  }
+
+  //! Wait for the next batch, and swap it with the given matrices.
+  bool Next(BatchType& predictors, LabelsType& labels)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return !ready.empty() || finished; });
+
+    if (ready.empty())
+    {
+      if (error)
+      {
+        std::exception_ptr failure = error;
+        error = std::exception_ptr();
+        std::rethrow_exception(failure);
+      }
+
+      return false;
+    }
+
+    std::swap(predictors, ready.front().first);
+    std::swap(labels, ready.front().second);
+    spare.push_back(std::move(ready.front()));
+    ready.pop_front();
+    lock.unlock();
+    changed.notify_all();
+    return true;
+  }
+
+  //! The wrapped loader.
+  LoaderType& loader;
+  //! The number of batches to read ahead.
+  size_t depth;
+  //! The transform applied to every batch.
+  TransformType transform;
+
+  //! Whether the background thread was started in this pass.
+  bool started;
+  //! Whether the batches are read with labels.
+  bool withLabels;
+  //! Whether the wrapped loader is exhausted (or failed).
+  bool finished;
+  //! Whether the background thread has to stop.
+  bool stopping;
+  //! The exception of the wrapped loader or the transform, if any.
+  std::exception_ptr error;
+
+  //! The batches read ahead.
+  std::deque<Slot> ready;
+  //! The matrices given back, to read the next batches into.
+  std::vector<Slot> spare;
+
+  //! The lock of the batches and the flags.
+  std::mutex mutex;
+  //! Signals a change of the batches or the flags.
+  std::condition_variable changed;
+  //! The background thread.
+  std::thread producer;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
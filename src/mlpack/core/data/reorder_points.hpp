@@ -0,0 +1,166 @@
+/**
+ * @file reorder_points.hpp
+ *
+ * Defines ReorderPoints(), which sorts the points of a dataset along a
+ * space-filling curve so that close points are stored close in memory, and
+ * RestoreOrder(), which maps results back to the original order.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_REORDER_POINTS_HPP
+#define MLPACK_CORE_DATA_REORDER_POINTS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/address.hpp>
+#include <mlpack/core/tree/rectangle_tree/discrete_hilbert_value.hpp>
+
+namespace mlpack {
+namespace data {
+
+//! The space-filling curves along which ReorderPoints() can sort a dataset.
+enum SpaceFillingCurve
+{
+  HILBERT_CURVE,
+  MORTON_CURVE
+};
+
+/**
+ * Sort the points (columns) of the given dataset along a space-filling curve,
+ * so that points which are close in space are mostly close in memory too.
+ * Methods which go through the points in their column order (such as
+ * LSHSearch, KMeans, naive kNN, DBSCAN and MeanShift) then read the dataset
+ * with far fewer cache misses when it has strong spatial structure (such as
+ * geographic data); none of them depends on the order of the points, so they
+ * can be given the reordered dataset directly, and their results are mapped
+ * back with RestoreOrder() (or neighbor::Unmap() for neighbor indices):
+ *
+ * @code
+ * std::vector<size_t> oldFromNew;
+ * data::ReorderPoints(dataset, oldFromNew);
+ *
+ * arma::Row<size_t> assignments;
+ * KMeans<> k;
+ * k.Cluster(dataset, clusters, assignments);
+ *
+ * // Now assignments[i] is the cluster of the i'th point of the original
+ * // dataset.
+ * data::RestoreOrder(assignments, oldFromNew);
+ * @endcode
+ *
+ * The keys of the points are those that the trees use: the Hilbert values of
+ * DiscreteHilbertValue (as in the Hilbert R tree) or the Morton addresses of
+ * bound::addr::PointToAddress() (as in the UB tree), which are computed from
+ * the bits of the floating-point values, so no scaling of the dataset is
+ * needed.  The sort is stable, so points with equal keys keep their order.
+ *
+ * @param dataset Dataset to reorder, with one point per column.
+ * @param oldFromNew Filled with the original index of each point, in the new
+ *     order (as the trees do).
+ * @param curve Space-filling curve to sort the points along.
+ */
+template<typename eT>
+void ReorderPoints(arma::Mat<eT>& dataset,
+                   std::vector<size_t>& oldFromNew,
+                   const SpaceFillingCurve curve = HILBERT_CURVE)
+{
+  // The keys take as many bits as the values, as for the trees.
+  typedef typename std::conditional<sizeof(eT) * CHAR_BIT <= 32,
+                                    uint32_t,
+                                    uint64_t>::type KeyElemType;
+
+  // Each point's key is computed by one thread.
+  arma::Mat<KeyElemType> keys(dataset.n_rows, dataset.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+  {
+    arma::Col<KeyElemType> key(dataset.n_rows);
+    if (curve == HILBERT_CURVE)
+      key = tree::DiscreteHilbertValue<eT>::CalculateValue(dataset.col(i));
+    else
+      bound::addr::PointToAddress(key, dataset.col(i));
+    keys.col(i) = key;
+  }
+
+  // The Hilbert values and the addresses are both compared
+  // lexicographically.
+  oldFromNew.resize(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    oldFromNew[i] = i;
+
+  std::stable_sort(oldFromNew.begin(), oldFromNew.end(),
+      [&keys](const size_t a, const size_t b)
+      {
+        return std::lexicographical_compare(keys.colptr(a),
+            keys.colptr(a) + keys.n_rows, keys.colptr(b),
+            keys.colptr(b) + keys.n_rows);
+      });
+
+  arma::Mat<eT> reordered(dataset.n_rows, dataset.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    reordered.col(i) = dataset.col(oldFromNew[i]);
+
+  dataset = std::move(reordered);
+}
+
+/**
+ * Sort the points (columns) of the given dataset along a space-filling curve,
+ * as the overload above does, and also return the new index of each original
+ * point.
+ *
+ * @param dataset Dataset to reorder, with one point per column.
+ * @param oldFromNew Filled with the original index of each point, in the new
+ *     order.
+ * @param newFromOld Filled with the new index of each point, in the original
+ *     order.
+ * @param curve Space-filling curve to sort the points along.
+ */
+template<typename eT>
+void ReorderPoints(arma::Mat<eT>& dataset,
+                   std::vector<size_t>& oldFromNew,
+                   std::vector<size_t>& newFromOld,
+                   const SpaceFillingCurve curve = HILBERT_CURVE)
+{
+  ReorderPoints(dataset, oldFromNew, curve);
+
+  newFromOld.resize(oldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    newFromOld[oldFromNew[i]] = i;
+}
+
+/**
+ * Given values with one column per point of a dataset that was reordered by
+ * ReorderPoints() (for instance, cluster assignments or labels), put them back
+ * in the original order of the points, so that column i holds the value of the
+ * i'th original point.  Throws std::invalid_argument if the number of columns
+ * is not the number of points.
+ *
+ * @param values Values to restore the order of, one column per point.
+ * @param oldFromNew Original index of each point in the new order, as given
+ *     by ReorderPoints().
+ */
+template<typename MatType>
+void RestoreOrder(MatType& values, const std::vector<size_t>& oldFromNew)
+{
+  if (values.n_cols != oldFromNew.size())
+  {
+    std::ostringstream oss;
+    oss << "RestoreOrder(): " << values.n_cols << " columns were given, but "
+        << "the mapping has " << oldFromNew.size() << " points";
+    throw std::invalid_argument(oss.str());
+  }
+
+  MatType restored(values.n_rows, values.n_cols);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    restored.col(oldFromNew[i]) = values.col(i);
+
+  values = std::move(restored);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -58,6 +58,27 @@ bool Save(const std::string& filename,
           const bool fatal = false,
           bool transpose = true);
 
+/**
+ * Saves a sparse matrix to file, guessing the filetype from the extension.
+ * The supported types of files are:
+ *
+ *  - Armadillo binary (arma_binary), denoted by .bin; this is a compact
+ *    compressed sparse column format, which is the fastest to reload
+ *  - Coordinate list (coord_ascii), denoted by .txt or .tsv
+ *
+ * The matrix is never transposed.  If the 'fatal' parameter is set to true, a
+ * std::runtime_error exception will be thrown upon failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Sparse matrix to save into file.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT>
+bool Save(const std::string& filename,
+          const arma::SpMat<eT>& matrix,
+          const bool fatal = false);
+
 /**
  * Saves a model to file, guessing the filetype from the extension, or,
  * optionally, saving the specified format.  If automatic extension detection is
@@ -69,9 +90,13 @@ bool Save(const std::string& filename,
  *  - text, denoted by .txt
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - fast binary, denoted by .fbin; this is a binary archive behind a
+ *    versioned header, which is loaded straight from a memory-mapped file and
+ *    is the fastest to reload (see LoadFastBinary()).
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary', and
+ * 'format::fast_binary'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -15,6 +15,8 @@
 // In case it hasn't already been included.
 #include "save.hpp"
 #include "extension.hpp"
+#include "fast_binary.hpp"
+#include "standard_stream.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -49,8 +51,11 @@ bool Save(const std::string& filename,
 {
   Timer::Start("saving_data");
 
-  // First we will try to discriminate by file extension.
-  std::string extension = Extension(filename);
+  // First we will try to discriminate by file extension.  "-" is the standard
+  // output.
+  const bool standard = IsStandardStream(filename);
+  std::string extension = standard ? StandardStreamExtension(filename) :
+      Extension(filename);
   if (extension == "")
   {
     Timer::Stop("saving_data");
@@ -65,13 +70,19 @@ bool Save(const std::string& filename,
   }
 
   // Catch errors opening the file.
-  std::fstream stream;
+  std::fstream fileStream;
+  if (!standard)
+  {
 #ifdef  _WIN32 // Always open in binary mode on Windows.
-  stream.open(filename.c_str(), std::fstream::out | std::fstream::binary);
+    fileStream.open(filename.c_str(), std::fstream::out | std::fstream::binary);
 #else
-  stream.open(filename.c_str(), std::fstream::out);
+    fileStream.open(filename.c_str(), std::fstream::out);
 #endif
-  if (!stream.is_open())
+  }
+  std::ostream standardStream(StandardOutputBuffer());
+  std::ostream& stream = standard ? standardStream :
+      static_cast<std::ostream&>(fileStream);
+  if (!standard && !fileStream.is_open())
   {
     Timer::Stop("saving_data");
     if (fatal)
@@ -112,6 +123,19 @@ bool Save(const std::string& filename,
            extension == "he5")
   {
 #ifdef ARMA_USE_HDF5
+    if (standard)
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << "Cannot save HDF5 data to the standard output."
+            << std::endl;
+      else
+        Log::Warn << "Cannot save HDF5 data to the standard output.  Save "
+            << "failed." << std::endl;
+
+      return false;
+    }
+
     saveType = arma::hdf5_binary;
     stringType = "HDF5 data";
 #else
@@ -191,12 +215,66 @@ bool Save(const std::string& filename,
     }
   }
 
+  // The next program of a pipeline may be waiting for the data.
+  stream.flush();
   Timer::Stop("saving_data");
 
   // Finally return success.
   return true;
 }
 
+//! Save a sparse matrix to file.
+template<typename eT>
+bool Save(const std::string& filename,
+          const arma::SpMat<eT>& matrix,
+          const bool fatal)
+{
+  Timer::Start("saving_data");
+
+  const std::string extension = Extension(filename);
+  arma::file_type saveType;
+  std::string stringType;
+  if (extension == "bin")
+  {
+    saveType = arma::arma_binary;
+    stringType = "Armadillo binary formatted sparse data";
+  }
+  else if (extension == "txt" || extension == "tsv")
+  {
+    saveType = arma::coord_ascii;
+    stringType = "coordinate list formatted sparse data";
+  }
+  else
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Unable to determine format to save sparse matrix to from "
+          << "filename '" << filename << "'.  Save failed." << std::endl;
+    else
+      Log::Warn << "Unable to determine format to save sparse matrix to from "
+          << "filename '" << filename << "'.  Save failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Saving " << stringType << " to '" << filename << "'."
+      << std::endl;
+
+  if (!matrix.quiet_save(filename, saveType))
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
+  Timer::Stop("saving_data");
+  return true;
+}
+
 //! Save a model to file.
 template<typename T>
 bool Save(const std::string& filename,
@@ -213,32 +291,45 @@ bool Save(const std::string& filename,
       f = format::xml;
     else if (extension == "bin")
       f = format::binary;
+    else if (extension == "fbin")
+      f = format::fast_binary;
     else if (extension == "txt")
       f = format::text;
     else
     {
       if (fatal)
         Log::Fatal << "Unable to detect type of '" << filename << "'; incorrect"
-            << " extension? (allowed: xml/bin/txt)" << std::endl;
+            << " extension? (allowed: xml/bin/fbin/txt)" << std::endl;
       else
         Log::Warn << "Unable to detect type of '" << filename << "'; save "
-            << "failed.  Incorrect extension? (allowed: xml/bin/txt)"
+            << "failed.  Incorrect extension? (allowed: xml/bin/fbin/txt)"
             << std::endl;
 
       return false;
     }
   }
 
-  // Open the file to save to.
+  // Open the file to save to.  The buffer must outlive the stream.
+  std::vector<char> buffer;
   std::ofstream ofs;
-#ifdef _WIN32
-  if (f == format::binary) // Open non-text types in binary mode on Windows.
+  if (f == format::fast_binary)
+  {
+    // A large buffer makes the many small writes of the archive cheaper.
+    buffer.resize(1024 * 1024);
+    ofs.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
     ofs.open(filename, std::ofstream::out | std::ofstream::binary);
+  }
   else
-    ofs.open(filename, std::ofstream::out);
+  {
+#ifdef _WIN32
+    if (f == format::binary) // Open non-text types in binary mode on Windows.
+      ofs.open(filename, std::ofstream::out | std::ofstream::binary);
+    else
+      ofs.open(filename, std::ofstream::out);
 #else
-  ofs.open(filename, std::ofstream::out);
+    ofs.open(filename, std::ofstream::out);
 #endif
+  }
 
   if (!ofs.is_open())
   {
@@ -269,6 +360,10 @@ bool Save(const std::string& filename,
       boost::archive::binary_oarchive ar(ofs);
       ar << boost::serialization::make_nvp(name.c_str(), t);
     }
+    else if (f == format::fast_binary)
+    {
+      SaveFastBinary(ofs, name, t);
+    }
 
     return true;
   }
@@ -281,6 +376,15 @@ bool Save(const std::string& filename,
 
     return false;
   }
+  catch (std::runtime_error& e)
+  {
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
 }
 
 } // namespace data
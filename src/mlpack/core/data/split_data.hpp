@@ -14,6 +14,7 @@
 #define MLPACK_CORE_DATA_SPLIT_DATA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
 
 namespace mlpack {
 namespace data {
@@ -65,13 +66,15 @@ void Split(const arma::Mat<T>& input,
       arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols - 1,
                                                       input.n_cols));
 
-  for (size_t i = 0; i != trainSize; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) trainSize; ++i)
   {
     trainData.col(i) = input.col(order[i]);
     trainLabel(i) = inputLabel(order[i]);
   }
 
-  for (size_t i = 0; i != testSize; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) testSize; ++i)
   {
     testData.col(i) = input.col(order[i + trainSize]);
     testLabel(i) = inputLabel(order[i + trainSize]);
@@ -114,11 +117,13 @@ void Split(const arma::Mat<T>& input,
       arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols -1,
                                                       input.n_cols));
 
-  for (size_t i = 0; i != trainSize; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) trainSize; ++i)
   {
     trainData.col(i) = input.col(order[i]);
   }
-  for (size_t i = 0; i != testSize; ++i)
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) testSize; ++i)
   {
     testData.col(i) = input.col(order[i + trainSize]);
   }
@@ -192,6 +197,83 @@ Split(const arma::Mat<T>& input,
                          std::move(testData));
 }
 
+/**
+ * Given an input dataset and labels, split them into a training set and test
+ * set in place, without copying the dataset.  The points of input and
+ * inputLabel are shuffled in place (with the same random ordering that Split()
+ * would use), and the training and test sets are returned as matrices and row
+ * vectors that are aliases of the first and last columns of input and
+ * inputLabel.  The aliases are only valid as long as input and inputLabel
+ * exist and are not resized.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * auto splitResult = SplitInPlace(input, label, 0.2);
+ * const arma::mat& trainData = std::get<0>(splitResult);
+ * @endcode
+ *
+ * Assigning the returned aliases to other matrices copies them, so keep the
+ * returned tuple (or move it) to avoid any copy.
+ *
+ * @param input Input dataset to shuffle and split.
+ * @param inputLabel Input labels to shuffle and split.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @return std::tuple containing aliases of trainData (arma::Mat<T>), testData
+ *      (arma::Mat<T>), trainLabel (arma::Row<U>), and testLabel (arma::Row<U>).
+ */
+template<typename T, typename U>
+std::tuple<arma::Mat<T>, arma::Mat<T>, arma::Row<U>, arma::Row<U>>
+SplitInPlace(arma::Mat<T>& input,
+             arma::Row<U>& inputLabel,
+             const double testRatio)
+{
+  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
+  const size_t trainSize = input.n_cols - testSize;
+
+  const arma::uvec order =
+      arma::shuffle(arma::linspace<arma::uvec>(0, input.n_cols - 1,
+                                               input.n_cols));
+  math::PermuteColumns(input, order);
+  math::PermuteColumns(inputLabel, order);
+
+  return std::make_tuple(
+      arma::Mat<T>(input.memptr(), input.n_rows, trainSize, false, true),
+      arma::Mat<T>(input.colptr(trainSize), input.n_rows, testSize, false,
+          true),
+      arma::Row<U>(inputLabel.memptr(), trainSize, false, true),
+      arma::Row<U>(inputLabel.memptr() + trainSize, testSize, false, true));
+}
+
+/**
+ * Given an input dataset, split it into a training set and test set in place,
+ * without copying the dataset.  The points of input are shuffled in place, and
+ * the training and test sets are returned as aliases of the first and last
+ * columns of input; see the overload with labels for details.
+ *
+ * @param input Input dataset to shuffle and split.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @return std::tuple containing aliases of trainData (arma::Mat<T>) and
+ *      testData (arma::Mat<T>).
+ */
+template<typename T>
+std::tuple<arma::Mat<T>, arma::Mat<T>>
+SplitInPlace(arma::Mat<T>& input, const double testRatio)
+{
+  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
+  const size_t trainSize = input.n_cols - testSize;
+
+  const arma::uvec order =
+      arma::shuffle(arma::linspace<arma::uvec>(0, input.n_cols - 1,
+                                               input.n_cols));
+  math::PermuteColumns(input, order);
+
+  return std::make_tuple(
+      arma::Mat<T>(input.memptr(), input.n_rows, trainSize, false, true),
+      arma::Mat<T>(input.colptr(trainSize), input.n_rows, testSize, false,
+          true));
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -0,0 +1,52 @@
+/**
+ * @file standard_stream.cpp
+ *
+ * Implementation of StandardInputStream and of the standard output used by
+ * data::Save().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "standard_stream.hpp"
+
+namespace mlpack {
+namespace data {
+
+//! The buffer of the standard output, once it is reserved for data.
+static std::streambuf* standardOutputBuffer = NULL;
+
+StandardInputStream::StandardInputStream() :
+    std::istream(NULL)
+{
+  std::ostringstream oss;
+  // operator<< sets failbit on an empty input, which isn't an error.
+  if (std::cin.rdbuf()->sgetc() != std::char_traits<char>::eof())
+    oss << std::cin.rdbuf();
+  if (std::cin.bad() || oss.bad())
+    throw std::runtime_error("Cannot read the standard input.");
+
+  contents = oss.str();
+  buffer.Reset(contents.data(), contents.size());
+  rdbuf(&buffer);
+}
+
+std::streambuf* StandardOutputBuffer()
+{
+  return (standardOutputBuffer == NULL) ? std::cout.rdbuf() :
+      standardOutputBuffer;
+}
+
+void SeparateStandardOutput()
+{
+  if (standardOutputBuffer != NULL)
+    return;
+
+  std::cout.flush();
+  standardOutputBuffer = std::cout.rdbuf();
+  std::cout.rdbuf(std::cerr.rdbuf());
+}
+
+} // namespace data
+} // namespace mlpack
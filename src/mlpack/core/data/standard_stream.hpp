@@ -0,0 +1,102 @@
+/**
+ * @file standard_stream.hpp
+ *
+ * Support for the "-" filename, which means the standard input (for loading)
+ * or the standard output (for saving), so that programs can be piped together.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STANDARD_STREAM_HPP
+#define MLPACK_CORE_DATA_STANDARD_STREAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "extension.hpp"
+#include "memory_buffer.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Return true if the given filename names the standard input or output: this
+ * is "-" for CSV data, or "-" followed by an extension (such as "-.bin" or
+ * "-.txt") for the format of that extension.
+ *
+ * @param filename Filename to check.
+ */
+inline bool IsStandardStream(const std::string& filename)
+{
+  return (filename == "-") || (filename.compare(0, 2, "-.") == 0);
+}
+
+/**
+ * Return the extension giving the format of the given standard stream
+ * filename: "csv" for "-", or the extension otherwise.
+ *
+ * @param filename Filename of the standard stream ("-" or "-.ext").
+ */
+inline std::string StandardStreamExtension(const std::string& filename)
+{
+  return (filename == "-") ? "csv" : Extension(filename);
+}
+
+/**
+ * Return true if the given filename names the standard input or output in a
+ * text format ("-", "-.csv" or "-.txt"), which can be read or written a batch
+ * of points at a time (see TransformCSVStream()).
+ *
+ * @param filename Filename to check.
+ */
+inline bool IsTextStandardStream(const std::string& filename)
+{
+  if (!IsStandardStream(filename))
+    return false;
+
+  const std::string extension = StandardStreamExtension(filename);
+  return (extension == "csv" || extension == "txt");
+}
+
+/**
+ * A read-only stream over the whole standard input.  The standard input is read
+ * to its end on construction, so the stream supports seeking, and can be given
+ * to the Armadillo loaders (which need to seek to detect the file type) just
+ * like a std::ifstream.  To read the standard input a batch of points at a
+ * time instead, give "-" to a CSVBatchReader.
+ */
+class StandardInputStream : public std::istream
+{
+ public:
+  //! Read the standard input.  Throws std::runtime_error on a read error.
+  StandardInputStream();
+
+  //! Get the contents of the standard input.
+  const std::string& Contents() const { return contents; }
+
+ private:
+  //! The contents of the standard input.
+  std::string contents;
+  //! The buffer over the contents.
+  MemoryBuffer buffer;
+};
+
+/**
+ * Get the stream buffer that data saved to "-" is written to.  This is the
+ * buffer of std::cout, unless SeparateStandardOutput() has been called.
+ */
+std::streambuf* StandardOutputBuffer();
+
+/**
+ * Reserve the standard output for data saved to "-": from now on, everything
+ * else written to std::cout (such as the messages of Log::Info and Log::Warn)
+ * goes to the standard error instead, so that it does not corrupt the data
+ * read by the next program of a pipeline.  The command-line programs call this
+ * when one of their outputs is "-".
+ */
+void SeparateStandardOutput();
+
+} // namespace data
+} // namespace mlpack
+
+#endif
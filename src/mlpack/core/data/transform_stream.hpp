@@ -0,0 +1,128 @@
+/**
+ * @file transform_stream.hpp
+ *
+ * Apply a function to the points of a text file (or of the standard input) a
+ * batch at a time, writing each result as soon as it is computed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_TRANSFORM_STREAM_HPP
+#define MLPACK_CORE_DATA_TRANSFORM_STREAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "csv_batch_reader.hpp"
+#include "standard_stream.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Return true if the points of the given input are worth transforming a batch
+ * at a time into the given output with TransformCSVStream(): the input is
+ * the standard input as text ("-", "-.csv" or "-.txt"), and the output is a
+ * text file (or the standard output as text).  Anything else is simpler to
+ * load and save whole.
+ *
+ * @param inputFile File the points are read from.
+ * @param outputFile File the results are written to.
+ */
+inline bool CanTransformStream(const std::string& inputFile,
+                               const std::string& outputFile)
+{
+  const std::string extension = IsStandardStream(outputFile) ?
+      StandardStreamExtension(outputFile) : Extension(outputFile);
+  return IsTextStandardStream(inputFile) &&
+      (extension == "csv" || extension == "txt");
+}
+
+/**
+ * Read the points of the given CSV (or whitespace separated) file a batch at a
+ * time with a CSVBatchReader, and write the result of the given function on
+ * each batch to the given file, one line per point as data::Save() writes it,
+ * as soon as it is computed.  With "-" as the input and the output, a program
+ * can process the points while the previous program of a pipeline is still
+ * writing them, with only one batch in memory:
+ *
+ * @code
+ * data::TransformCSVStream<arma::Row<size_t>>("-", "-",
+ *     [&](const arma::mat& batch, arma::Row<size_t>& predictions)
+ *     {
+ *       model.Classify(batch, predictions);
+ *     });
+ * @endcode
+ *
+ * The output is CSV, unless its extension is "txt" (for space separated
+ * values).  Throws std::runtime_error if the input cannot be read or the output
+ * cannot be written.
+ *
+ * @tparam ResultType Type of the result of the function (such as
+ *     arma::Row<size_t> or arma::mat), with one column per point.
+ * @tparam eT Element type of the points.
+ * @tparam FunctionType Type of the function, called as
+ *     function(const arma::Mat<eT>& batch, ResultType& result).
+ * @param inputFile File to read the points from ("-" for the standard input).
+ * @param outputFile File to write the results to ("-" for the standard
+ *     output).
+ * @param function Function to apply to each batch.
+ * @param batchSize Number of points in each batch.
+ * @return The number of points processed.
+ */
+template<typename ResultType, typename eT = double, typename FunctionType>
+size_t TransformCSVStream(const std::string& inputFile,
+                          const std::string& outputFile,
+                          FunctionType function,
+                          const size_t batchSize = 1000)
+{
+  CSVBatchReader<eT> reader(inputFile, batchSize);
+
+  const bool standard = IsStandardStream(outputFile);
+  const std::string extension = standard ?
+      StandardStreamExtension(outputFile) : Extension(outputFile);
+  const arma::file_type saveType = (extension == "txt") ? arma::raw_ascii :
+      arma::csv_ascii;
+
+  std::ofstream fileStream;
+  if (!standard)
+  {
+    fileStream.open(outputFile.c_str());
+    if (!fileStream.is_open())
+    {
+      std::ostringstream oss;
+      oss << "TransformCSVStream(): cannot open file '" << outputFile << "' "
+          << "for writing!";
+      throw std::runtime_error(oss.str());
+    }
+  }
+  std::ostream standardStream(StandardOutputBuffer());
+  std::ostream& output = standard ? standardStream :
+      static_cast<std::ostream&>(fileStream);
+
+  size_t points = 0;
+  arma::Mat<eT> batch;
+  ResultType result;
+  while (reader(batch))
+  {
+    function(batch, result);
+
+    // Write one line per point, and hand it to the next program right away.
+    const arma::Mat<typename ResultType::elem_type> lines = arma::trans(result);
+    if (!lines.save(output, saveType) || !output.flush())
+    {
+      std::ostringstream oss;
+      oss << "TransformCSVStream(): cannot write to '" << outputFile << "'!";
+      throw std::runtime_error(oss.str());
+    }
+
+    points += batch.n_cols;
+  }
+
+  return points;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -57,7 +57,7 @@ void GaussianDistribution::FactorCovariance()
   // 0 after the method. That last part is unnecessary, but baked into
   // Armadillo, so there's not really much that can be done about that without
   // discussion with the Armadillo maintainer.
-  const arma::mat invCovLower = arma::inv(arma::trimatl(covLower));
+  invCovLower = arma::inv(arma::trimatl(covLower));
 
   invCov = invCovLower.t() * invCovLower;
   double sign = 0.;
@@ -14,6 +14,7 @@
 #define MLPACK_CORE_DISTRIBUTIONS_GAUSSIAN_DISTRIBUTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/compact_storage.hpp>
 
 namespace mlpack {
 namespace distribution {
@@ -30,6 +31,8 @@ class GaussianDistribution
   arma::mat covariance;
   //! Lower triangular factor of cov (e.g. cov = LL^T).
   arma::mat covLower;
+  //! Cached inverse of the lower triangular factor (L^-1).
+  arma::mat invCovLower;
   //! Cached inverse of covariance.
   arma::mat invCov;
   //! Cached logdet(cov).
@@ -52,6 +55,7 @@ class GaussianDistribution
       mean(arma::zeros<arma::vec>(dimension)),
       covariance(arma::eye<arma::mat>(dimension, dimension)),
       covLower(arma::eye<arma::mat>(dimension, dimension)),
+      invCovLower(arma::eye<arma::mat>(dimension, dimension)),
       invCov(arma::eye<arma::mat>(dimension, dimension)),
       logDetCov(0)
   { /* Nothing to do. */ }
@@ -95,8 +99,44 @@ class GaussianDistribution
     probabilities = arma::exp(logProbabilities);
   }
 
+  /**
+   * Calculates the multivariate Gaussian log probability density function for
+   * each data point (column) in the given matrix.  The whole matrix is
+   * whitened with one product with the cached inverse Cholesky factor.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
   void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
 
+  /**
+   * Calculates the multivariate Gaussian probability density function for each
+   * data point (column) in the given single-precision matrix.
+   *
+   * @param x List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::fmat& x, arma::fvec& probabilities) const
+  {
+    arma::fvec logProbabilities;
+    LogProbability(x, logProbabilities);
+    probabilities = arma::exp(logProbabilities);
+  }
+
+  /**
+   * Calculates the multivariate Gaussian log probability density function for
+   * each data point (column) in the given single-precision matrix.  This is
+   * faster than the double-precision version, but the largest log
+   * probabilities may lose a few digits.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
+  void LogProbability(const arma::fmat& x,
+                      arma::fvec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -146,14 +186,42 @@ class GaussianDistribution
    * Serialize the distribution.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
+  void serialize(Archive& ar, const unsigned int version)
   {
-    // We just need to serialize each of the members.
-    ar & BOOST_SERIALIZATION_NVP(mean);
-    ar & BOOST_SERIALIZATION_NVP(covariance);
+    // Version 0 always saved the factors of the covariance.  When models are
+    // saved compactly, only the mean and the covariance are saved, and the
+    // factors are computed again when the distribution is loaded.
+    bool factors = true;
+    if (version > 0)
+    {
+      if (Archive::is_saving::value)
+        factors = !data::CompactStorage::Get();
+      ar & BOOST_SERIALIZATION_NVP(factors);
+
+      data::SerializeCompact(ar, mean, "mean");
+      data::SerializeCompact(ar, covariance, "covariance");
+    }
+    else
+    {
+      ar & BOOST_SERIALIZATION_NVP(mean);
+      ar & BOOST_SERIALIZATION_NVP(covariance);
+    }
+
+    if (!factors)
+    {
+      if (Archive::is_loading::value)
+        FactorCovariance();
+      return;
+    }
+
     ar & BOOST_SERIALIZATION_NVP(covLower);
     ar & BOOST_SERIALIZATION_NVP(invCov);
     ar & BOOST_SERIALIZATION_NVP(logDetCov);
+
+    // The inverse of the factor is not saved, so models saved by older
+    // versions can still be loaded.
+    if (Archive::is_loading::value)
+      invCovLower = arma::inv(arma::trimatl(covLower));
   }
 
  private:
@@ -165,36 +233,35 @@ class GaussianDistribution
   void FactorCovariance();
 };
 
-/**
-* Calculates the multivariate Gaussian log probability density function for each
-* data point (column) in the given matrix
-*
-* @param x List of observations.
-* @param probabilities Output log probabilities for each input observation.
-*/
 inline void GaussianDistribution::LogProbability(
     const arma::mat& x,
     arma::vec& logProbabilities) const
 {
-  // Column i of 'diffs' is the difference between x.col(i) and the mean.
-  arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
+  // With cov = LL^T, the Mahalanobis distance of each point is the squared norm
+  // of L^-1 (x - mean), so one matrix product handles every point.
+  const arma::mat whitened = invCovLower * (x.each_col() - mean);
 
-  // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1 *
-  // diffs).  We just don't need any of the other elements.  We can calculate
-  // the right hand part of the equation (instead of the left side) so that
-  // later we are referencing columns, not rows -- that is faster.
-  const arma::mat rhs = -0.5 * invCov * diffs;
-  arma::vec logExponents(diffs.n_cols); // We will now fill this.
-  for (size_t i = 0; i < diffs.n_cols; i++)
-    logExponents(i) = accu(diffs.unsafe_col(i) % rhs.unsafe_col(i));
+  logProbabilities = -0.5 * (x.n_rows * log2pi + logDetCov) -
+      0.5 * trans(arma::sum(arma::square(whitened), 0));
+}
 
-  const size_t k = x.n_rows;
+inline void GaussianDistribution::LogProbability(
+    const arma::fmat& x,
+    arma::fvec& logProbabilities) const
+{
+  const arma::fvec floatMean = arma::conv_to<arma::fvec>::from(mean);
+  const arma::fmat floatInvCovLower =
+      arma::conv_to<arma::fmat>::from(invCovLower);
+  const arma::fmat whitened = floatInvCovLower * (x.each_col() - floatMean);
 
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  logProbabilities = float(-0.5 * (x.n_rows * log2pi + logDetCov)) -
+      0.5f * trans(arma::sum(arma::square(whitened), 0));
 }
 
-
 } // namespace distribution
 } // namespace mlpack
 
+//! Set the serialization version of the GaussianDistribution class.
+BOOST_CLASS_VERSION(mlpack::distribution::GaussianDistribution, 1);
+
 #endif
@@ -14,6 +14,9 @@
 
 #include <mlpack/core.hpp>
 
+#include <map>
+#include <memory>
+
 namespace mlpack {
 namespace hpt {
 
@@ -24,6 +27,12 @@ namespace hpt {
  * This class is not supposed to be used directly by users. To tune
  * hyper-parameters see HyperParameterTuner.
  *
+ * Evaluate() may be called from several threads at once (as GridSearch does
+ * when it runs in parallel); each thread then runs cross-validation on its own
+ * copy of the CVType object, so CVType has to be copy-constructible.  The
+ * objectives can also be cached, keyed by the values of all of the arguments,
+ * so that repeated evaluations of the same hyper-parameters are skipped.
+ *
  * @tparam CVType A cross-validation strategy.
  * @tparam MLAlgorithm The machine learning algorithm used in cross-validation.
  * @tparam TotalArgs The total number of arguments that are supposed to be
@@ -69,6 +78,20 @@ class CVFunction
    */
   double Evaluate(const arma::mat& parameters);
 
+  /**
+   * Run cross-validation with the bound and passed parameters, spending only
+   * the given fraction of the full cost (as SuccessiveHalving and Hyperband
+   * do for early evaluations).  With KFoldCV only that fraction of the folds
+   * (at least one) is run; other cross-validation strategies run fully.
+   * Evaluations with a budget less than 1 are neither cached nor used for the
+   * best model.
+   *
+   * @param parameters Arguments (rather than the bound arguments) that should
+   *     be passed into the Evaluate method of the CVType object.
+   * @param budget Fraction (in (0, 1]) of the full cost to spend.
+   */
+  double Evaluate(const arma::mat& parameters, const double budget);
+
   /**
    * Evaluate numerically the gradient of the CVFunction with the given
    * parameters.
@@ -82,6 +105,18 @@ class CVFunction
   //! Access and modify the best model so far.
   MLAlgorithm& BestModel() { return bestModel; }
 
+  //! Get the best objective so far.
+  double BestObjective() const { return bestObjective; }
+
+  //! The type of caches of objectives, keyed by the values of the arguments.
+  using CacheType = std::map<std::vector<double>, double>;
+
+  //! Get the cache of objectives (nullptr if objectives are not cached).
+  CacheType* Cache() const { return cache; }
+  //! Modify the cache of objectives (set it to nullptr to disable caching).
+  //! Objectives are only cached if all of the bound arguments are arithmetic.
+  CacheType*& Cache() { return cache; }
+
  private:
   //! The type of tuples of BoundArgs.
   using BoundArgsTupleType = std::tuple<BoundArgs...>;
@@ -118,6 +153,73 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  //! The cache of objectives, if there is one.
+  CacheType* cache;
+
+  //! The positions and values of the bound arguments, to start cache keys.
+  std::vector<double> boundArgsKey;
+
+  //! Whether the objectives can be cached (all bound arguments are
+  //! arithmetic).
+  bool cacheable;
+
+  //! The copies of the cross-validation object for each thread.
+  std::vector<std::unique_ptr<CVType>> threadCVs;
+
+  /**
+   * Return the cross-validation object that the calling thread should use: a
+   * copy of cv inside a parallel region, and cv itself otherwise.
+   */
+  CVType& ThreadCV();
+
+  //! Run only the given fraction of the folds of a KFoldCV object.
+  template<typename CV>
+  static auto SetBudget(CV& cv, const double budget, int /* preferred */)
+      -> decltype(cv.Folds() = cv.K(), void());
+
+  //! Other cross-validation strategies can't run partially.
+  template<typename CV>
+  static void SetBudget(CV& cv, const double budget, long /* fallback */);
+
+  //! Check whether all of the folds of a KFoldCV object are run.
+  template<typename CV>
+  static auto FullBudget(CV& cv, int /* preferred */)
+      -> decltype(cv.Folds() == cv.K());
+
+  //! Other cross-validation strategies always run fully.
+  template<typename CV>
+  static bool FullBudget(CV& cv, long /* fallback */);
+
+  /**
+   * Add the position and value of the bound argument at BoundArgIndex (and
+   * the following ones) to boundArgsKey.
+   */
+  template<size_t BoundArgIndex,
+           typename = typename
+               std::enable_if<(BoundArgIndex < BoundArgsAmount)>::type>
+  inline void InitBoundArgsKey();
+
+  /**
+   * Stop when all of the bound arguments have been added to boundArgsKey.
+   */
+  template<size_t BoundArgIndex,
+           typename = typename
+               std::enable_if<BoundArgIndex == BoundArgsAmount>::type,
+           typename = void>
+  inline void InitBoundArgsKey();
+
+  //! Add an arithmetic value to a cache key.
+  template<typename T>
+  static bool AppendToKey(const T& value,
+                          std::vector<double>& key,
+                          std::true_type /* arithmetic */);
+
+  //! Values of other types can't be part of a cache key.
+  template<typename T>
+  static bool AppendToKey(const T& value,
+                          std::vector<double>& key,
+                          std::false_type /* arithmetic */);
+
   /**
    * Collect all arguments and run cross-validation.
    */
@@ -53,8 +53,12 @@ CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::CVFunction(
     boundArgs(args...),
     bestObjective(std::numeric_limits<double>::max()),
     relativeDelta(relativeDelta),
-    minDelta(minDelta)
-{ /* Nothing left to do. */ }
+    minDelta(minDelta),
+    cache(nullptr),
+    cacheable(true)
+{
+  InitBoundArgsKey<0>();
+}
 
 template<typename CVType,
          typename MLAlgorithm,
@@ -63,7 +67,53 @@ template<typename CVType,
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters)
 {
-  return Evaluate<0, 0>(parameters);
+  if (cache == nullptr || !cacheable)
+    return Evaluate<0, 0>(parameters);
+
+  std::vector<double> key(boundArgsKey);
+  key.insert(key.end(), parameters.begin(), parameters.end());
+
+  bool found = false;
+  double objective = 0.0;
+  #pragma omp critical(CVFunctionCache)
+  {
+    typename CacheType::const_iterator it = cache->find(key);
+    if (it != cache->end())
+    {
+      found = true;
+      objective = it->second;
+    }
+  }
+
+  if (found)
+    return objective;
+
+  objective = Evaluate<0, 0>(parameters);
+
+  #pragma omp critical(CVFunctionCache)
+  (*cache)[key] = objective;
+
+  return objective;
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
+    const arma::mat& parameters,
+    const double budget)
+{
+  if (budget >= 1.0)
+    return Evaluate(parameters);
+
+  // The copy of cv of this thread is the one that the evaluation uses.
+  CVType& threadCV = ThreadCV();
+  SetBudget(threadCV, budget, 0);
+  const double objective = Evaluate<0, 0>(parameters);
+  SetBudget(threadCV, 1.0, 0);
+
+  return objective;
 }
 
 template<typename CVType,
@@ -115,15 +165,23 @@ double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& /* parameters */,
     const Args&... args)
 {
-  double objective = cv.Evaluate(args...);
+  CVType& threadCV = ThreadCV();
+  double objective = threadCV.Evaluate(args...);
 
   // Change the best model if we have got a better score, or if we probably
-  // have not assigned any valid (trained) model yet.
-  if (bestObjective > objective ||
-      bestObjective == std::numeric_limits<double>::max())
+  // have not assigned any valid (trained) model yet.  Partial evaluations
+  // aren't comparable with full ones.
+  if (!FullBudget(threadCV, 0))
+    return objective;
+
+  #pragma omp critical(CVFunctionBestModel)
   {
-    bestObjective = objective;
-    bestModel = std::move(cv.Model());
+    if (bestObjective > objective ||
+        bestObjective == std::numeric_limits<double>::max())
+    {
+      bestObjective = objective;
+      bestModel = std::move(threadCV.Model());
+    }
   }
 
   return objective;
@@ -162,6 +220,140 @@ double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
       parameters, args..., parameters(ParamIndex, 0));
 }
 
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+CVType& CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::ThreadCV()
+{
+#ifdef HAS_OPENMP
+  if (omp_in_parallel())
+  {
+    // The copies live on the heap, so references to them stay valid when
+    // another thread grows the vector.
+    const size_t thread = omp_get_thread_num();
+    CVType* threadCV;
+    #pragma omp critical(CVFunctionThreadCV)
+    {
+      if (threadCVs.size() <= thread)
+        threadCVs.resize(thread + 1);
+      if (!threadCVs[thread])
+        threadCVs[thread].reset(new CVType(cv));
+      threadCV = threadCVs[thread].get();
+    }
+
+    return *threadCV;
+  }
+#endif
+
+  return cv;
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+template<typename CV>
+auto CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::SetBudget(
+    CV& cv,
+    const double budget,
+    int /* preferred */) -> decltype(cv.Folds() = cv.K(), void())
+{
+  cv.Folds() = std::min(cv.K(),
+      std::max((size_t) 1, (size_t) std::round(budget * cv.K())));
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+template<typename CV>
+void CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::SetBudget(
+    CV& /* cv */,
+    const double /* budget */,
+    long /* fallback */)
+{ /* Nothing to do. */ }
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+template<typename CV>
+auto CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::FullBudget(
+    CV& cv,
+    int /* preferred */) -> decltype(cv.Folds() == cv.K())
+{
+  return cv.Folds() == cv.K();
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+template<typename CV>
+bool CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::FullBudget(
+    CV& /* cv */,
+    long /* fallback */)
+{
+  return true;
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+template<size_t BoundArgIndex, typename>
+void CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+    InitBoundArgsKey()
+{
+  using BoundArgType = typename
+      std::tuple_element<BoundArgIndex, BoundArgsTupleType>::type;
+  using ValueType = typename std::decay<
+      decltype(std::get<BoundArgIndex>(boundArgs).value)>::type;
+
+  boundArgsKey.push_back(BoundArgType::index);
+  cacheable = AppendToKey(std::get<BoundArgIndex>(boundArgs).value,
+      boundArgsKey, std::is_arithmetic<ValueType>()) && cacheable;
+
+  InitBoundArgsKey<BoundArgIndex + 1>();
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+template<size_t BoundArgIndex, typename, typename>
+void CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+    InitBoundArgsKey()
+{ /* Nothing left to do. */ }
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+template<typename T>
+bool CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::AppendToKey(
+    const T& value,
+    std::vector<double>& key,
+    std::true_type /* arithmetic */)
+{
+  key.push_back(value);
+  return true;
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+template<typename T>
+bool CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::AppendToKey(
+    const T& /* value */,
+    std::vector<double>& /* key */,
+    std::false_type /* arithmetic */)
+{
+  return false;
+}
+
 } // namespace hpt
 } // namespace mlpack
 
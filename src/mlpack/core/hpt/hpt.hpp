@@ -15,6 +15,10 @@
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/hpt/deduce_hp_types.hpp>
 #include <mlpack/core/optimizers/grid_search/grid_search.hpp>
+#include <mlpack/core/optimizers/random_search/random_search.hpp>
+#include <mlpack/core/optimizers/hyperband/hyperband.hpp>
+
+#include <map>
 
 namespace mlpack {
 namespace hpt {
@@ -67,12 +71,49 @@ namespace hpt {
  *     Fixed(useCholesky), lambda1Set, lambda2Set);
  * @endcode
  *
+ * Assessing sets of hyper-parameters can be sped up in two ways.  The
+ * cross-validation folds can be trained in parallel with CV().Parallel() (for
+ * KFoldCV), and GridSearch can evaluate the points of the grid in parallel
+ * (see GridSearch::Parallel()); in both cases each thread trains its own copy
+ * of the model.  The objectives can also be cached with UseCache(), so that a
+ * set of hyper-parameters that has already been assessed (for instance by an
+ * earlier call to Optimize()) is not assessed again; this assumes that
+ * training is deterministic.  Finally, for models that specialize
+ * WarmStartTraits (like LogisticRegression and SoftmaxRegression),
+ * CV().Continuation() makes each set of hyper-parameters start training from
+ * the models of the previously assessed set, which takes fewer iterations
+ * when neighbouring sets are assessed one after the other (without
+ * Optimizer().Parallel()).
+ *
+ * @code
+ * HyperParameterTuner<LARS, MSE, KFoldCV> hpt3(5, data, responses);
+ * hpt3.CV().Parallel() = true;
+ * hpt3.Optimizer().Parallel() = true;
+ * hpt3.UseCache() = true;
+ * std::tie(bestLambda1, bestLambda2) = hpt3.Optimize(Fixed(transposeData),
+ *     Fixed(useCholesky), lambda1Set, lambda2Set);
+ * @endcode
+ *
+ * When there are too many combinations of values for GridSearch, RandomSearch
+ * assesses a given number of random ones, and SuccessiveHalving and Hyperband
+ * also stop assessing bad ones early: with KFoldCV they run only a few of the
+ * folds for most of the combinations, and all of them only for the best (see
+ * KFoldCV::Folds()).  They can all assess the combinations in parallel.
+ *
+ * @code
+ * HyperParameterTuner<LARS, MSE, KFoldCV, Hyperband> hpt4(5, data, responses);
+ * hpt4.Optimizer().Parallel() = true;
+ * arma::vec lambdaSet = arma::logspace(-6, 1, 100);
+ * std::tie(bestLambda1, bestLambda2) = hpt4.Optimize(Fixed(transposeData),
+ *     Fixed(useCholesky), lambdaSet, lambdaSet);
+ * @endcode
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam CV A cross-validation strategy used to assess a set of
  *     hyper-parameters.
- * @tparam OptimizerType An optimization strategy (GridSearch and
- *     GradientDescent are supported).
+ * @tparam OptimizerType An optimization strategy (GridSearch, RandomSearch,
+ *     SuccessiveHalving, Hyperband and GradientDescent are supported).
  * @tparam MatType The type of data.
  * @tparam PredictionsType The type of predictions (should be passed when the
  *     predictions type is a template parameter in Train methods of the given
@@ -109,6 +150,27 @@ class HyperParameterTuner
   //! Access and modify the optimizer.
   OptimizerType& Optimizer() { return optimizer; }
 
+  /**
+   * Get whether the objectives of the sets of hyper-parameters are cached, so
+   * that each set is assessed only once.  The cache is kept between calls to
+   * Optimize().
+   *
+   * The default value is false.
+   */
+  bool UseCache() const { return useCache; }
+
+  /**
+   * Modify whether the objectives of the sets of hyper-parameters are cached,
+   * so that each set is assessed only once.  The cache is kept between calls to
+   * Optimize().
+   *
+   * The default value is false.
+   */
+  bool& UseCache() { return useCache; }
+
+  //! Remove all of the cached objectives.
+  void ClearCache() { cache.clear(); }
+
   /**
    * Get relative increase of arguments for calculation of partial
    * derivatives (by the definition) in gradient-based optimization. The exact
@@ -154,10 +216,11 @@ class HyperParameterTuner
   /**
    * Find the best hyper-parameters by using the given Optimizer. For each
    * hyper-parameter one of the following should be passed as an argument.
-   * 1. A set of values to choose from (when using GridSearch as an optimizer).
+   * 1. A set of values to choose from (when using GridSearch, RandomSearch,
+   *   SuccessiveHalving or Hyperband as an optimizer).
    *   The set of values should be an STL-compatible container (it should
    *   provide begin() and end() methods returning iterators).
-   * 2. A starting value (when using any other optimizer than GridSearch).
+   * 2. A starting value (when using a gradient-based optimizer).
    * 3. A value fixed by using the function mlpack::hpt::Fixed. In this case the
    *   hyper-parameter will not be optimized.
    *
@@ -205,10 +268,20 @@ class HyperParameterTuner
       CV<MLAlgorithm, Negated<Metric>, MatType, PredictionsType,
           WeightsType>>::type;
 
+ public:
+  //! Access and modify the cross-validation object.
+  CVType& CV() { return cv; }
 
+ private:
   //! The cross-validation object for assessing sets of hyper-parameters.
   CVType cv;
 
+  //! Whether the objectives are cached.
+  bool useCache;
+
+  //! The cached objectives, keyed by the hyper-parameters.
+  std::map<std::vector<double>, double> cache;
+
   //! The optimizer.
   OptimizerType optimizer;
 
@@ -32,7 +32,7 @@ HyperParameterTuner<MLAlgorithm,
                     MatType,
                     PredictionsType,
                     WeightsType>::HyperParameterTuner(const CVArgs&... args) :
-    cv(args...), relativeDelta(0.01), minDelta(1e-10) {}
+    cv(args...), useCache(false), relativeDelta(0.01), minDelta(1e-10) {}
 
 template<typename MLAlgorithm,
          typename Metric,
@@ -89,9 +89,20 @@ void HyperParameterTuner<MLAlgorithm,
 
   CVFunction<CVType, MLAlgorithm, totalArgs, FixedArgs...>
       cvFunction(cv, relativeDelta, minDelta, fixedArgs...);
-  bestObjective = Metric::NeedsMinimization?
-      optimizer.Optimize(cvFunction, bestParams, datasetInfo) :
-      -optimizer.Optimize(cvFunction, bestParams, datasetInfo);
+  cvFunction.Cache() = useCache ? &cache : nullptr;
+  const double objective = optimizer.Optimize(cvFunction, bestParams,
+      datasetInfo);
+
+  // If the best objective came from the cache (or from a partial evaluation,
+  // when the optimizer was terminated early), the best model hasn't been
+  // trained with it in this run, so train it again.
+  if (cvFunction.BestObjective() > objective)
+  {
+    cvFunction.Cache() = nullptr;
+    cvFunction.Evaluate(bestParams);
+  }
+
+  bestObjective = Metric::NeedsMinimization ? objective : -objective;
   bestModel = std::move(cvFunction.BestModel());
 }
 
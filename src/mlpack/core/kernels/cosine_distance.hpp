@@ -41,6 +41,20 @@ class CosineDistance
   template<typename VecTypeA, typename VecTypeB>
   static double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Evaluate the cosine distance between every column of a and every column of
+   * b, and store the results in out: out(i, j) = d(a.col(i), b.col(j)).  The
+   * inner products are computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix (arma::mat or a subview of one).
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& out);
+
   //! Serialize the class (there's nothing to save).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -56,6 +70,9 @@ class KernelTraits<CosineDistance>
 
   //! The cosine kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+
+  //! The cosine kernel has a batch Evaluate() function.
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
@@ -32,6 +32,29 @@ double CosineDistance::Evaluate(const VecTypeA& a, const VecTypeB& b)
     return dot(a, b) / denominator;
 }
 
+template<typename MatTypeA, typename MatTypeB>
+void CosineDistance::Evaluate(const MatTypeA& a,
+                              const MatTypeB& b,
+                              arma::mat& out)
+{
+  const arma::vec aNorms = arma::sqrt(arma::sum(arma::square(a), 0)).t();
+  const arma::rowvec bNorms = arma::sqrt(arma::sum(arma::square(b), 0));
+
+  out = a.t() * b;
+
+  // As above, the cosine similarity is 0 if either norm is 0.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) out.n_cols; ++j)
+  {
+    double* column = out.colptr(j);
+    for (size_t i = 0; i < out.n_rows; ++i)
+    {
+      const double denominator = aNorms[i] * bNorms[j];
+      column[i] = (denominator == 0.0) ? 0.0 : column[i] / denominator;
+    }
+  }
+}
+
 } // namespace kernel
 } // namespace mlpack
 
@@ -51,6 +51,21 @@ class EpanechnikovKernel
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b) const;
 
+  /**
+   * Evaluate the Epanechnikov kernel between every column of a and every column
+   * of b, and store the results in out: out(i, j) = K(a.col(i), b.col(j)).  The
+   * squared distances are computed with one matrix multiplication, so the
+   * results may differ from those of the other overloads by roundoff.
+   *
+   * @tparam MatTypeA Type of first matrix (arma::mat or a subview of one).
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& out) const;
+
   /**
    * Evaluate the Epanechnikov kernel given that the distance between the two
    * input points is known.
@@ -111,6 +126,8 @@ class KernelTraits<EpanechnikovKernel>
   static const bool IsNormalized = true;
   //! The Epanechnikov kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Epanechnikov kernel has a batch Evaluate() function.
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
@@ -68,6 +68,25 @@ class GaussianKernel
     return exp(gamma * metric::SquaredEuclideanDistance::Evaluate(a, b));
   }
 
+  /**
+   * Evaluate the Gaussian kernel between every column of a and every column of
+   * b, and store the results in out: out(i, j) = K(a.col(i), b.col(j)).  The
+   * squared distances are computed with one matrix multiplication, so the
+   * results may differ from those of the other overloads by roundoff.
+   *
+   * @tparam MatTypeA Type of first matrix (arma::mat or a subview of one).
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& out) const
+  {
+    metric::SquaredEuclideanDistance::Evaluate(a, b, out);
+    out = arma::exp(gamma * out);
+  }
+
   /**
    * Evaluation of the Gaussian kernel given the distance between two points.
    *
@@ -171,6 +190,8 @@ class KernelTraits<GaussianKernel>
   static const bool IsNormalized = true;
   //! The Gaussian kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Gaussian kernel has a batch Evaluate() function.
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
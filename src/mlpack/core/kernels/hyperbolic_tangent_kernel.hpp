@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_HYPERBOLIC_TANGENT_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -62,6 +63,24 @@ class HyperbolicTangentKernel
     return tanh(scale * arma::dot(a, b) + offset);
   }
 
+  /**
+   * Evaluate the hyperbolic tangent kernel between every column of a and every
+   * column of b, and store the results in out: out(i, j) = K(a.col(i),
+   * b.col(j)).  The inner products are computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix (arma::mat or a subview of one).
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& out) const
+  {
+    out = a.t() * b;
+    out = arma::tanh(scale * out + offset);
+  }
+
   //! Get scale factor.
   double Scale() const { return scale; }
   //! Modify scale factor.
@@ -85,6 +104,19 @@ class HyperbolicTangentKernel
   double offset;
 };
 
+//! Kernel traits for the hyperbolic tangent kernel.
+template<>
+class KernelTraits<HyperbolicTangentKernel>
+{
+ public:
+  //! The hyperbolic tangent kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The hyperbolic tangent kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The hyperbolic tangent kernel has a batch Evaluate() function.
+  static const bool HasBatchEvaluate = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
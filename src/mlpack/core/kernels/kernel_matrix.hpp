@@ -0,0 +1,132 @@
+/**
+ * @file kernel_matrix.hpp
+ *
+ * Computation of kernel matrices: the kernel evaluations between all the
+ * columns of two data matrices, or of one data matrix with itself.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Evaluate a kernel between every column of a and every column of b, writing
+ * out(i, j) = K(a.col(i), b.col(j)).  Kernels that declare a batch Evaluate()
+ * function in their KernelTraits (HasBatchEvaluate) are evaluated with it; for
+ * the others, each column of the output is one task of an OpenMP parallel
+ * loop.  This class may be specialized for other kernels.
+ *
+ * @tparam KernelType Type of the kernel.
+ */
+template<typename KernelType>
+class KernelMatrixRule
+{
+ public:
+  /**
+   * Evaluate the kernel between the columns of a and b.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernel Kernel to evaluate.
+   * @param out Matrix to store the kernel evaluations in.
+   */
+  static void Evaluate(const arma::mat& a,
+                       const arma::mat& b,
+                       KernelType& kernel,
+                       arma::mat& out)
+  {
+    Evaluate(a, b, kernel, out, std::integral_constant<bool,
+        KernelTraits<KernelType>::HasBatchEvaluate>());
+  }
+
+ private:
+  //! Use the batch Evaluate() function of the kernel.
+  static void Evaluate(const arma::mat& a,
+                       const arma::mat& b,
+                       KernelType& kernel,
+                       arma::mat& out,
+                       std::true_type /* hasBatchEvaluate */)
+  {
+    kernel.Evaluate(a, b, out);
+  }
+
+  //! Evaluate the kernel on each pair of points.
+  static void Evaluate(const arma::mat& a,
+                       const arma::mat& b,
+                       KernelType& kernel,
+                       arma::mat& out,
+                       std::false_type /* hasBatchEvaluate */)
+  {
+    out.set_size(a.n_cols, b.n_cols);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+    {
+      for (size_t i = 0; i < a.n_cols; ++i)
+        out(i, j) = kernel.Evaluate(a.unsafe_col(i), b.unsafe_col(j));
+    }
+  }
+};
+
+/**
+ * Compute the kernel matrix between the columns of a and the columns of b,
+ * out(i, j) = K(a.col(i), b.col(j)).  The columns of b are processed in tiles,
+ * so the output may be stored in single precision (with ElemType = float)
+ * without an intermediate double precision matrix of the same size.
+ *
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param kernel Kernel to evaluate.
+ * @param out Matrix to store the kernel matrix in.
+ */
+template<typename KernelType, typename ElemType>
+void KernelMatrix(const arma::mat& a,
+                  const arma::mat& b,
+                  KernelType& kernel,
+                  arma::Mat<ElemType>& out);
+
+/**
+ * Compute the (symmetric) kernel matrix of the columns of the given data,
+ * out(i, j) = K(data.col(i), data.col(j)).  Only the upper triangle is
+ * evaluated, and then it is copied to the lower triangle.
+ *
+ * @param data Set of points.
+ * @param kernel Kernel to evaluate.
+ * @param out Matrix to store the kernel matrix in.
+ */
+template<typename KernelType, typename ElemType>
+void KernelMatrix(const arma::mat& data,
+                  KernelType& kernel,
+                  arma::Mat<ElemType>& out);
+
+/**
+ * Compute the upper triangle of the (symmetric) kernel matrix of the columns of
+ * the given data, packed by columns: K(data.col(i), data.col(j)) for i <= j is
+ * stored in out[j * (j + 1) / 2 + i].  This holds n * (n + 1) / 2 values
+ * instead of n * n.
+ *
+ * @param data Set of points.
+ * @param kernel Kernel to evaluate.
+ * @param out Vector to store the packed kernel matrix in.
+ */
+template<typename KernelType, typename ElemType>
+void PackedKernelMatrix(const arma::mat& data,
+                        KernelType& kernel,
+                        arma::Col<ElemType>& out);
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file kernel_matrix_impl.hpp
+ *
+ * Implementation of the computation of kernel matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_matrix.hpp"
+
+namespace mlpack {
+namespace kernel {
+namespace details {
+
+//! The number of columns of the kernel matrix computed at once.
+static const size_t kernelMatrixTileSize = 1024;
+
+//! Make a matrix that uses the given columns of the given matrix (no copy).
+inline arma::mat ColumnAlias(const arma::mat& data,
+                             const size_t begin,
+                             const size_t end)
+{
+  return arma::mat(const_cast<double*>(data.colptr(begin)), data.n_rows,
+      end - begin, false, true);
+}
+
+//! Store a tile (in double precision) into a matrix of any element type.
+template<typename ElemType>
+inline void StoreTile(const arma::mat& tile,
+                      const size_t row,
+                      const size_t col,
+                      arma::Mat<ElemType>& out)
+{
+  out.submat(row, col, row + tile.n_rows - 1, col + tile.n_cols - 1) =
+      arma::conv_to<arma::Mat<ElemType>>::from(tile);
+}
+
+} // namespace details
+
+template<typename KernelType, typename ElemType>
+void KernelMatrix(const arma::mat& a,
+                  const arma::mat& b,
+                  KernelType& kernel,
+                  arma::Mat<ElemType>& out)
+{
+  out.set_size(a.n_cols, b.n_cols);
+  if (a.n_cols == 0)
+    return;
+
+  arma::mat tile;
+  for (size_t begin = 0; begin < b.n_cols;
+      begin += details::kernelMatrixTileSize)
+  {
+    const size_t end = std::min(begin + details::kernelMatrixTileSize,
+        (size_t) b.n_cols);
+
+    KernelMatrixRule<KernelType>::Evaluate(a,
+        details::ColumnAlias(b, begin, end), kernel, tile);
+    details::StoreTile(tile, 0, begin, out);
+  }
+}
+
+template<typename KernelType, typename ElemType>
+void KernelMatrix(const arma::mat& data,
+                  KernelType& kernel,
+                  arma::Mat<ElemType>& out)
+{
+  out.set_size(data.n_cols, data.n_cols);
+
+  // Each tile of columns only needs the rows up to its last column.
+  arma::mat tile;
+  for (size_t begin = 0; begin < data.n_cols;
+      begin += details::kernelMatrixTileSize)
+  {
+    const size_t end = std::min(begin + details::kernelMatrixTileSize,
+        (size_t) data.n_cols);
+
+    KernelMatrixRule<KernelType>::Evaluate(
+        details::ColumnAlias(data, 0, end),
+        details::ColumnAlias(data, begin, end), kernel, tile);
+    details::StoreTile(tile, 0, begin, out);
+  }
+
+  // Copy the upper triangle to the lower triangle.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) out.n_cols; ++j)
+  {
+    for (size_t i = j + 1; i < out.n_rows; ++i)
+      out(i, j) = out(j, i);
+  }
+}
+
+template<typename KernelType, typename ElemType>
+void PackedKernelMatrix(const arma::mat& data,
+                        KernelType& kernel,
+                        arma::Col<ElemType>& out)
+{
+  out.set_size(data.n_cols * (data.n_cols + 1) / 2);
+
+  arma::mat tile;
+  for (size_t begin = 0; begin < data.n_cols;
+      begin += details::kernelMatrixTileSize)
+  {
+    const size_t end = std::min(begin + details::kernelMatrixTileSize,
+        (size_t) data.n_cols);
+
+    KernelMatrixRule<KernelType>::Evaluate(
+        details::ColumnAlias(data, 0, end),
+        details::ColumnAlias(data, begin, end), kernel, tile);
+
+    // Column j of the kernel matrix holds j + 1 values of the upper triangle.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = (omp_size_t) begin; j < (omp_size_t) end; ++j)
+    {
+      const double* column = tile.colptr(j - begin);
+      ElemType* packed = out.memptr() + j * (j + 1) / 2;
+      for (size_t i = 0; i <= (size_t) j; ++i)
+        packed[i] = ElemType(column[i]);
+    }
+  }
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
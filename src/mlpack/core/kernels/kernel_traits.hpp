@@ -36,6 +36,14 @@ class KernelTraits
    * If true, then the kernel include a squared distance, ||x - y||^2 .
    */
   static const bool UsesSquaredDistance = false;
+
+  /**
+   * If true, then the kernel has a batch Evaluate(a, b, out) function, which
+   * evaluates the kernel between every column of a and every column of b at
+   * once; KernelMatrixRule and the other batch computations then use it
+   * instead of a loop over all the pairs of points.
+   */
+  static const bool HasBatchEvaluate = false;
 };
 
 } // namespace kernel
@@ -64,6 +64,25 @@ class LaplacianKernel
     return exp(-metric::EuclideanDistance::Evaluate(a, b) / bandwidth);
   }
 
+  /**
+   * Evaluate the Laplacian kernel between every column of a and every column of
+   * b, and store the results in out: out(i, j) = K(a.col(i), b.col(j)).  The
+   * squared distances are computed with one matrix multiplication, so the
+   * results may differ from those of the other overloads by roundoff.
+   *
+   * @tparam MatTypeA Type of first matrix (arma::mat or a subview of one).
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& out) const
+  {
+    metric::EuclideanDistance::Evaluate(a, b, out);
+    out = arma::exp(-out / bandwidth);
+  }
+
   /**
    * Evaluation of the Laplacian kernel given the distance between two points.
    *
@@ -117,6 +136,8 @@ class KernelTraits<LaplacianKernel>
   static const bool IsNormalized = true;
   //! The Laplacian kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The Laplacian kernel has a batch Evaluate() function.
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
@@ -15,6 +15,7 @@
 #define MLPACK_CORE_KERNELS_LINEAR_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -55,11 +56,41 @@ class LinearKernel
     return arma::dot(a, b);
   }
 
+  /**
+   * Evaluate the linear kernel between every column of a and every column of b,
+   * and store the results in out: out(i, j) = K(a.col(i), b.col(j)).  The inner
+   * products are computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix (arma::mat or a subview of one).
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& out)
+  {
+    out = a.t() * b;
+  }
+
   //! Serialize the kernel (it has no members... do nothing).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 };
 
+//! Kernel traits for the linear kernel.
+template<>
+class KernelTraits<LinearKernel>
+{
+ public:
+  //! The linear kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The linear kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The linear kernel has a batch Evaluate() function.
+  static const bool HasBatchEvaluate = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_POLYNOMIAL_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -57,6 +58,24 @@ class PolynomialKernel
     return pow((arma::dot(a, b) + offset), degree);
   }
 
+  /**
+   * Evaluate the polynomial kernel between every column of a and every column
+   * of b, and store the results in out: out(i, j) = K(a.col(i), b.col(j)).  The
+   * inner products are computed with one matrix multiplication.
+   *
+   * @tparam MatTypeA Type of first matrix (arma::mat or a subview of one).
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& out) const
+  {
+    out = a.t() * b;
+    out = arma::pow(out + offset, degree);
+  }
+
   //! Get the degree of the polynomial.
   const double& Degree() const { return degree; }
   //! Modify the degree of the polynomial.
@@ -82,6 +101,19 @@ class PolynomialKernel
   double offset;
 };
 
+//! Kernel traits for the polynomial kernel.
+template<>
+class KernelTraits<PolynomialKernel>
+{
+ public:
+  //! The polynomial kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The polynomial kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The polynomial kernel has a batch Evaluate() function.
+  static const bool HasBatchEvaluate = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
@@ -47,6 +47,28 @@ class SphericalKernel
         (metric::SquaredEuclideanDistance::Evaluate(a, b) <= bandwidthSquared) ?
         1.0 : 0.0;
   }
+
+  /**
+   * Evaluate the spherical kernel between every column of a and every column of
+   * b, and store the results in out: out(i, j) = K(a.col(i), b.col(j)).  The
+   * squared distances are computed with one matrix multiplication, so the
+   * results may differ from those of the other overloads for points whose
+   * distance is within roundoff of the bandwidth.
+   *
+   * @tparam MatTypeA Type of first matrix (arma::mat or a subview of one).
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& out) const
+  {
+    metric::SquaredEuclideanDistance::Evaluate(a, b, out);
+    out.transform([this](const double d)
+        { return (d <= bandwidthSquared) ? 1.0 : 0.0; });
+  }
+
   /**
    * Obtains the convolution integral [integral K(||x-a||)K(||b-x||)dx]
    * for the two vectors.
@@ -127,6 +149,8 @@ class KernelTraits<SphericalKernel>
   static const bool IsNormalized = true;
   //! The spherical kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The spherical kernel has a batch Evaluate() function.
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
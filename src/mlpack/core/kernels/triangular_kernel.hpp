@@ -52,6 +52,25 @@ class TriangularKernel
         bandwidth));
   }
 
+  /**
+   * Evaluate the triangular kernel between every column of a and every column
+   * of b, and store the results in out: out(i, j) = K(a.col(i), b.col(j)).  The
+   * squared distances are computed with one matrix multiplication, so the
+   * results may differ from those of the other overloads by roundoff.
+   *
+   * @tparam MatTypeA Type of first matrix (arma::mat or a subview of one).
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the kernel evaluations in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a, const MatTypeB& b, arma::mat& out) const
+  {
+    metric::EuclideanDistance::Evaluate(a, b, out);
+    out = arma::clamp(1.0 - out / bandwidth, 0.0, 1.0);
+  }
+
   /**
    * Evaluate the triangular kernel given that the distance between the two
    * points is known.
@@ -60,7 +79,7 @@ class TriangularKernel
    */
   double Evaluate(const double distance) const
   {
-    return std::max(0.0, (1 - distance) / bandwidth);
+    return std::max(0.0, 1 - distance / bandwidth);
   }
 
   /**
@@ -72,11 +91,11 @@ class TriangularKernel
    */
   double Gradient(const double distance) const
   {
-    if (distance < 1)
+    if (distance < bandwidth)
     {
       return -1.0 / bandwidth;
     }
-    else if (distance > 1)
+    else if (distance > bandwidth)
     {
       return 0;
     }
@@ -112,6 +131,8 @@ class KernelTraits<TriangularKernel>
   static const bool IsNormalized = true;
   //! The triangular kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The triangular kernel has a batch Evaluate() function.
+  static const bool HasBatchEvaluate = true;
 };
 
 } // namespace kernel
@@ -60,27 +60,24 @@ void ColumnsToBlocks::Transform(const arma::mat& maximalInputs,
 
   const size_t rowOffset = blockHeight+bufSize;
   const size_t colOffset = blockWidth+bufSize;
-  output.ones(bufSize + rows * rowOffset,
-              bufSize + cols * colOffset);
-  output *= bufValue;
+  output.set_size(bufSize + rows * rowOffset, bufSize + cols * colOffset);
+  output.fill(bufValue);
 
-  size_t k = 0;
-  const size_t maxSize = std::min(rows * cols, (size_t) maximalInputs.n_cols);
-  for (size_t i = 0; i != rows; ++i)
+  // Each block is a disjoint part of the output, and each column of a block
+  // is a contiguous part of an input column, so the blocks are copied one
+  // column at a time and in parallel.
+  const size_t blocks = std::min(rows * cols, (size_t) maximalInputs.n_cols);
+  #pragma omp parallel for schedule(static) \
+      if (blocks * maximalInputs.n_rows >= 100000)
+  for (omp_size_t k = 0; k < (omp_size_t) blocks; ++k)
   {
-    for (size_t j = 0; j != cols; ++j)
+    const size_t minRow = bufSize + (k / cols) * rowOffset;
+    const size_t minCol = bufSize + (k % cols) * colOffset;
+    const double* block = maximalInputs.colptr(k);
+    for (size_t c = 0; c < blockWidth; ++c)
     {
-      // Now, copy the elements of the row to the output submatrix.
-      const size_t minRow = bufSize + i * rowOffset;
-      const size_t minCol = bufSize + j * colOffset;
-      const size_t maxRow = i * rowOffset + blockHeight;
-      const size_t maxCol = j * colOffset + blockWidth;
-
-      output.submat(minRow, minCol, maxRow, maxCol) =
-          arma::reshape(maximalInputs.col(k++), blockHeight, blockWidth);
-
-      if (k >= maxSize)
-        break;
+      std::copy(block + c * blockHeight, block + (c + 1) * blockHeight,
+          output.colptr(minCol + c) + minRow);
     }
   }
 
@@ -0,0 +1,161 @@
+/**
+ * @file image_patches.hpp
+ *
+ * Extraction of (possibly overlapping) patches of images, and reassembly of
+ * images from their patches.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_IMAGE_PATCHES_HPP
+#define MLPACK_CORE_MATH_IMAGE_PATCHES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Cut images into patches on a regular grid, one patch per column, and put
+ * images back together from their patches.  This is how images are prepared
+ * for SparseCoding or a SparseAutoencoder, and how their reconstructions are
+ * turned back into images; ColumnsToBlocks shows patches (or learned
+ * features) side by side instead.
+ *
+ * Each column of the images is one image, stored as arma::cube(image,
+ * imageHeight, imageWidth, channels) would store it: column-major, one
+ * channel after the other.  (This is also the layout of the inputs of
+ * ann::Convolution, which calls the number of rows the width.)  Each patch is
+ * stored in the same way with the patch size, and the patches of an image are
+ * consecutive columns, with the top of the patch moving fastest; the patch at
+ * (row, col) of the grid starts at the pixel (row * strideHeight,
+ * col * strideWidth), and the patches that would cross the border of the image
+ * are left out.  With strides equal to the patch size (the default), the
+ * patches tile the image.
+ *
+ * @code
+ * // 28x28 grayscale images, one per column, cut into all of the overlapping
+ * // 8x8 patches with a stride of 2, as floats for a smaller SparseCoding
+ * // input.
+ * ImagePatches patches(28, 28, 1, 8, 8, 2, 2);
+ * arma::fmat x;
+ * patches.Extract(images, x);
+ * @endcode
+ *
+ * The patches are copied in parallel, one column of a patch at a time.
+ */
+class ImagePatches
+{
+ public:
+  /**
+   * Create the object for the given geometry of images and patches.
+   *
+   * @param imageHeight Number of rows of each image.
+   * @param imageWidth Number of columns of each image.
+   * @param channels Number of channels of each image.
+   * @param patchHeight Number of rows of each patch.
+   * @param patchWidth Number of columns of each patch.
+   * @param strideHeight Number of rows between the tops of vertically
+   *     neighboring patches (0 means patchHeight).
+   * @param strideWidth Number of columns between the left sides of
+   *     horizontally neighboring patches (0 means patchWidth).
+   */
+  ImagePatches(const size_t imageHeight,
+               const size_t imageWidth,
+               const size_t channels,
+               const size_t patchHeight,
+               const size_t patchWidth,
+               const size_t strideHeight = 0,
+               const size_t strideWidth = 0);
+
+  /**
+   * Extract all of the patches of all of the given images.  The output type
+   * may differ from the input type (for instance to get float patches of
+   * double images).
+   *
+   * @param images Images, one per column.
+   * @param patches Matrix to store the patches in, one per column; image i's
+   *     patches are the columns i * PatchesPerImage() to
+   *     (i + 1) * PatchesPerImage() - 1.
+   */
+  template<typename eT, typename OutputElemType>
+  void Extract(const arma::Mat<eT>& images,
+               arma::Mat<OutputElemType>& patches) const;
+
+  /**
+   * Put images back together from their patches (as given by Extract()).  The
+   * pixels that are in several patches get the mean of their values in the
+   * patches, and the pixels that are in no patch (when the strides are larger
+   * than the patches, or at the borders) are set to fillValue.
+   *
+   * @param patches Patches, one per column.
+   * @param images Matrix to store the images in, one per column.
+   * @param fillValue Value of the pixels that are in no patch.
+   */
+  template<typename eT, typename OutputElemType>
+  void Reassemble(const arma::Mat<eT>& patches,
+                  arma::Mat<OutputElemType>& images,
+                  const double fillValue = 0.0) const;
+
+  //! Get the number of rows of the grid of patches of each image.
+  size_t GridHeight() const
+  {
+    return (imageHeight - patchHeight) / strideHeight + 1;
+  }
+
+  //! Get the number of columns of the grid of patches of each image.
+  size_t GridWidth() const
+  {
+    return (imageWidth - patchWidth) / strideWidth + 1;
+  }
+
+  //! Get the number of patches of each image.
+  size_t PatchesPerImage() const { return GridHeight() * GridWidth(); }
+
+  //! Get the number of elements of each image.
+  size_t ImageSize() const { return imageHeight * imageWidth * channels; }
+
+  //! Get the number of elements of each patch.
+  size_t PatchSize() const { return patchHeight * patchWidth * channels; }
+
+  //! Get the number of rows of each image.
+  size_t ImageHeight() const { return imageHeight; }
+  //! Get the number of columns of each image.
+  size_t ImageWidth() const { return imageWidth; }
+  //! Get the number of channels of each image.
+  size_t Channels() const { return channels; }
+  //! Get the number of rows of each patch.
+  size_t PatchHeight() const { return patchHeight; }
+  //! Get the number of columns of each patch.
+  size_t PatchWidth() const { return patchWidth; }
+  //! Get the number of rows between vertically neighboring patches.
+  size_t StrideHeight() const { return strideHeight; }
+  //! Get the number of columns between horizontally neighboring patches.
+  size_t StrideWidth() const { return strideWidth; }
+
+ private:
+  //! The number of rows of each image.
+  size_t imageHeight;
+  //! The number of columns of each image.
+  size_t imageWidth;
+  //! The number of channels of each image.
+  size_t channels;
+  //! The number of rows of each patch.
+  size_t patchHeight;
+  //! The number of columns of each patch.
+  size_t patchWidth;
+  //! The number of rows between vertically neighboring patches.
+  size_t strideHeight;
+  //! The number of columns between horizontally neighboring patches.
+  size_t strideWidth;
+};
+
+} // namespace math
+} // namespace mlpack
+
+// Include implementation.
+#include "image_patches_impl.hpp"
+
+#endif
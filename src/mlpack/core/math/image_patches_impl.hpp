@@ -0,0 +1,165 @@
+/**
+ * @file image_patches_impl.hpp
+ *
+ * Implementation of the extraction and reassembly of patches of images.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_IMAGE_PATCHES_IMPL_HPP
+#define MLPACK_CORE_MATH_IMAGE_PATCHES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "image_patches.hpp"
+
+namespace mlpack {
+namespace math {
+
+inline ImagePatches::ImagePatches(const size_t imageHeight,
+                                  const size_t imageWidth,
+                                  const size_t channels,
+                                  const size_t patchHeight,
+                                  const size_t patchWidth,
+                                  const size_t strideHeight,
+                                  const size_t strideWidth) :
+    imageHeight(imageHeight),
+    imageWidth(imageWidth),
+    channels(channels),
+    patchHeight(patchHeight),
+    patchWidth(patchWidth),
+    strideHeight(strideHeight == 0 ? patchHeight : strideHeight),
+    strideWidth(strideWidth == 0 ? patchWidth : strideWidth)
+{
+  if (channels == 0 || patchHeight == 0 || patchWidth == 0)
+  {
+    throw std::invalid_argument("ImagePatches: the number of channels and the "
+        "patch size should be positive");
+  }
+
+  if (patchHeight > imageHeight || patchWidth > imageWidth)
+  {
+    std::ostringstream oss;
+    oss << "ImagePatches: the patches (" << patchHeight << "x" << patchWidth
+        << ") should fit in the images (" << imageHeight << "x" << imageWidth
+        << ")";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename eT, typename OutputElemType>
+void ImagePatches::Extract(const arma::Mat<eT>& images,
+                           arma::Mat<OutputElemType>& patches) const
+{
+  if (images.n_rows != ImageSize())
+  {
+    std::ostringstream oss;
+    oss << "ImagePatches::Extract(): the images have " << images.n_rows
+        << " rows, but " << ImageSize() << " were expected";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t perImage = PatchesPerImage();
+  const size_t gridHeight = GridHeight();
+  const size_t channelSize = imageHeight * imageWidth;
+  const size_t numPatches = images.n_cols * perImage;
+  patches.set_size(PatchSize(), numPatches);
+
+  #pragma omp parallel for schedule(static) \
+      if (numPatches * PatchSize() >= 100000)
+  for (omp_size_t p = 0; p < (omp_size_t) numPatches; ++p)
+  {
+    const size_t position = p % perImage;
+    const size_t top = (position % gridHeight) * strideHeight;
+    const size_t left = (position / gridHeight) * strideWidth;
+    const eT* image = images.colptr(p / perImage);
+    OutputElemType* patch = patches.colptr(p);
+
+    // Each column of each channel of the patch is a contiguous part of the
+    // image.
+    for (size_t ch = 0; ch < channels; ++ch)
+    {
+      for (size_t c = 0; c < patchWidth; ++c)
+      {
+        const eT* column = image + ch * channelSize + (left + c) * imageHeight +
+            top;
+        std::copy(column, column + patchHeight, patch);
+        patch += patchHeight;
+      }
+    }
+  }
+}
+
+template<typename eT, typename OutputElemType>
+void ImagePatches::Reassemble(const arma::Mat<eT>& patches,
+                              arma::Mat<OutputElemType>& images,
+                              const double fillValue) const
+{
+  const size_t perImage = PatchesPerImage();
+  if (patches.n_rows != PatchSize() || patches.n_cols % perImage != 0)
+  {
+    std::ostringstream oss;
+    oss << "ImagePatches::Reassemble(): expected " << PatchSize() << " rows "
+        << "and a multiple of " << perImage << " columns, but the patches are "
+        << patches.n_rows << "x" << patches.n_cols;
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t gridHeight = GridHeight();
+  const size_t channelSize = imageHeight * imageWidth;
+
+  // The number of patches that each pixel of a channel is in is the same for
+  // every channel of every image.
+  arma::vec counts(channelSize, arma::fill::zeros);
+  for (size_t position = 0; position < perImage; ++position)
+  {
+    const size_t top = (position % gridHeight) * strideHeight;
+    const size_t left = (position / gridHeight) * strideWidth;
+    for (size_t c = 0; c < patchWidth; ++c)
+    {
+      counts.subvec((left + c) * imageHeight + top,
+          (left + c) * imageHeight + top + patchHeight - 1) += 1.0;
+    }
+  }
+
+  const size_t numImages = patches.n_cols / perImage;
+  images.set_size(ImageSize(), numImages);
+
+  #pragma omp parallel for schedule(static) \
+      if (patches.n_elem >= 100000)
+  for (omp_size_t i = 0; i < (omp_size_t) numImages; ++i)
+  {
+    arma::vec sums(ImageSize(), arma::fill::zeros);
+    for (size_t position = 0; position < perImage; ++position)
+    {
+      const size_t top = (position % gridHeight) * strideHeight;
+      const size_t left = (position / gridHeight) * strideWidth;
+      const eT* patch = patches.colptr(i * perImage + position);
+      for (size_t ch = 0; ch < channels; ++ch)
+      {
+        for (size_t c = 0; c < patchWidth; ++c)
+        {
+          double* column = sums.memptr() + ch * channelSize +
+              (left + c) * imageHeight + top;
+          for (size_t r = 0; r < patchHeight; ++r)
+            column[r] += patch[r];
+          patch += patchHeight;
+        }
+      }
+    }
+
+    OutputElemType* image = images.colptr(i);
+    for (size_t j = 0; j < ImageSize(); ++j)
+    {
+      const double count = counts[j % channelSize];
+      image[j] = (OutputElemType) ((count > 0.0) ? sums[j] / count :
+          fillValue);
+    }
+  }
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
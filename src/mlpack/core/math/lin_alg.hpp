@@ -30,28 +30,115 @@ void VectorPower(arma::vec& vec, const double power);
 /**
  * Creates a centered matrix, where centering is done by subtracting
  * the sum over the columns (a column vector) from each column of the matrix.
+ * The input and the output may be the same matrix, in which case it is
+ * centered in place.
  *
  * @param x Input matrix
  * @param xCentered Matrix to write centered output into
  */
-void Center(const arma::mat& x, arma::mat& xCentered);
+template<typename eT>
+void Center(const arma::Mat<eT>& x, arma::Mat<eT>& xCentered);
+
+/**
+ * Center the columns of a matrix in place, without a copy of the matrix: the
+ * mean is computed in one pass over blocks of columns, and subtracted in a
+ * second one, both in parallel.
+ *
+ * @param x Matrix to center.
+ * @param mean Vector to store the mean of the columns in.
+ * @param blockSize Number of columns of the blocks.
+ */
+template<typename eT>
+void CenterInPlace(arma::Mat<eT>& x,
+                   arma::Col<eT>& mean,
+                   const size_t blockSize = 1024);
+
+/**
+ * Center the columns of a matrix in place, like the overload above.
+ *
+ * @param x Matrix to center.
+ */
+template<typename eT>
+void CenterInPlace(arma::Mat<eT>& x);
+
+/**
+ * Merge the moments of a set of points into those of another one, with the
+ * update of Chan et al.: the number of points, the mean, and the scatter matrix
+ * (the sum of the outer products of the deviations from the mean).  This lets
+ * the mean and covariance of a dataset be computed over chunks of it, also
+ * when they are loaded one at a time.
+ *
+ * @param points Number of points of the first set; updated.
+ * @param mean Mean of the first set; updated.
+ * @param scatter Scatter matrix of the first set; updated.
+ * @param otherPoints Number of points of the second set.
+ * @param otherMean Mean of the second set.
+ * @param otherScatter Scatter matrix of the second set.
+ */
+template<typename eT>
+void MergeMoments(size_t& points,
+                  arma::Col<eT>& mean,
+                  arma::Mat<eT>& scatter,
+                  const size_t otherPoints,
+                  const arma::Col<eT>& otherMean,
+                  const arma::Mat<eT>& otherScatter);
+
+/**
+ * Compute the mean and the covariance (normalized by the number of points
+ * minus one, like ccov()) of the columns of a matrix in one pass: every block
+ * of columns is centered on its own mean, its scatter matrix is one matrix
+ * product, and the blocks are merged with MergeMoments().  The blocks are
+ * processed in parallel, and only one block per thread is copied.
+ *
+ * @param x Matrix whose columns are the points.
+ * @param mean Vector to store the mean in.
+ * @param covariance Matrix to store the covariance in.
+ * @param blockSize Number of columns of the blocks.
+ */
+template<typename eT>
+void MeanAndCovariance(const arma::Mat<eT>& x,
+                       arma::Col<eT>& mean,
+                       arma::Mat<eT>& covariance,
+                       const size_t blockSize = 1024);
 
 /**
  * Whitens a matrix using the singular value decomposition of the covariance
  * matrix. Whitening means the covariance matrix of the result is the identity
  * matrix.
  */
-void WhitenUsingSVD(const arma::mat& x,
-                    arma::mat& xWhitened,
-                    arma::mat& whiteningMatrix);
+template<typename eT>
+void WhitenUsingSVD(const arma::Mat<eT>& x,
+                    arma::Mat<eT>& xWhitened,
+                    arma::Mat<eT>& whiteningMatrix);
+
+/**
+ * Whitens a matrix in place using the singular value decomposition of the
+ * covariance matrix.  The covariance is computed with MeanAndCovariance(), and
+ * the whitening matrix is applied to blocks of columns in parallel, so no copy
+ * of the matrix is needed.
+ */
+template<typename eT>
+void WhitenUsingSVDInPlace(arma::Mat<eT>& x,
+                           arma::Mat<eT>& whiteningMatrix,
+                           const size_t blockSize = 1024);
 
 /**
  * Whitens a matrix using the eigendecomposition of the covariance matrix.
  * Whitening means the covariance matrix of the result is the identity matrix.
  */
-void WhitenUsingEig(const arma::mat& x,
-                    arma::mat& xWhitened,
-                    arma::mat& whiteningMatrix);
+template<typename eT>
+void WhitenUsingEig(const arma::Mat<eT>& x,
+                    arma::Mat<eT>& xWhitened,
+                    arma::Mat<eT>& whiteningMatrix);
+
+/**
+ * Whitens a matrix in place using the eigendecomposition of the covariance
+ * matrix, like WhitenUsingSVDInPlace().
+ */
+template<typename eT>
+void WhitenUsingEigInPlace(arma::Mat<eT>& x,
+                           arma::Mat<eT>& whiteningMatrix,
+                           const size_t blockSize = 1024);
 
 /**
  * Overwrites a dimension-N vector to a random vector on the unit sphere in R^N.
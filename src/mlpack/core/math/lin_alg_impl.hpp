@@ -22,6 +22,268 @@ inline size_t SvecIndex(size_t i, size_t j, size_t n)
   return (j-i) + (n*(n+1) - (n-i)*(n-i+1))/2;
 }
 
+namespace details {
+
+//! Compute the sum of the columns of x in double precision, over blocks of
+//! columns in parallel.
+template<typename eT>
+arma::vec ColumnSum(const arma::Mat<eT>& x, const size_t blockSize)
+{
+  const size_t blocks = (x.n_cols + blockSize - 1) / blockSize;
+  arma::vec sum(x.n_rows, arma::fill::zeros);
+
+  #pragma omp parallel
+  {
+    arma::vec threadSum(x.n_rows, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      const size_t end = std::min((size_t) (b + 1) * blockSize,
+          (size_t) x.n_cols);
+      for (size_t i = b * blockSize; i < end; ++i)
+      {
+        const eT* column = x.colptr(i);
+        for (size_t d = 0; d < x.n_rows; ++d)
+          threadSum[d] += column[d];
+      }
+    }
+
+    #pragma omp critical
+    sum += threadSum;
+  }
+
+  return sum;
+}
+
+//! Apply the whitening matrix to blocks of columns of x, in place.
+template<typename eT>
+void ApplyInPlace(const arma::Mat<eT>& whiteningMatrix,
+                  arma::Mat<eT>& x,
+                  const size_t blockSize)
+{
+  const size_t blocks = (x.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) x.n_cols) - 1;
+    arma::Mat<eT> block = whiteningMatrix * x.cols(begin, end);
+    x.cols(begin, end) = block;
+  }
+}
+
+//! Compute the whitening matrix from the SVD of the covariance matrix.
+template<typename eT>
+void SVDWhiteningMatrix(const arma::Mat<eT>& covariance,
+                        arma::Mat<eT>& whiteningMatrix)
+{
+  arma::Mat<eT> u, v;
+  arma::Col<eT> s;
+  arma::svd(u, s, v, covariance);
+
+  whiteningMatrix = v * arma::diagmat(1 / arma::sqrt(s)) * u.t();
+}
+
+//! Compute the whitening matrix from the eigendecomposition of the covariance
+//! matrix; eigenvalues that are (numerically) zero are ignored, as with
+//! VectorPower().
+template<typename eT>
+void EigWhiteningMatrix(const arma::Mat<eT>& covariance,
+                        arma::Mat<eT>& whiteningMatrix)
+{
+  arma::Mat<eT> eigenvectors;
+  arma::Col<eT> eigenvalues;
+  arma::eig_sym(eigenvalues, eigenvectors, covariance);
+
+  for (size_t i = 0; i < eigenvalues.n_elem; ++i)
+  {
+    const double value = eigenvalues[i];
+    if (std::abs(value) > 1e-12)
+      eigenvalues[i] = (value > 0) ? std::pow(value, -0.5) :
+          -std::pow(-value, -0.5);
+    else
+      eigenvalues[i] = 0;
+  }
+
+  // Our whitening matrix is diag(1 / sqrt(eigenvalues)) * eigenvectors^T.
+  whiteningMatrix = arma::diagmat(eigenvalues) * eigenvectors.t();
+}
+
+} // namespace details
+
+template<typename eT>
+void CenterInPlace(arma::Mat<eT>& x,
+                   arma::Col<eT>& mean,
+                   const size_t blockSize)
+{
+  if (x.n_cols == 0)
+  {
+    mean.zeros(x.n_rows);
+    return;
+  }
+
+  mean = arma::conv_to<arma::Col<eT>>::from(
+      details::ColumnSum(x, std::max(blockSize, (size_t) 1)) / x.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
+    x.col(i) -= mean;
+}
+
+template<typename eT>
+void CenterInPlace(arma::Mat<eT>& x)
+{
+  arma::Col<eT> mean;
+  CenterInPlace(x, mean);
+}
+
+template<typename eT>
+void Center(const arma::Mat<eT>& x, arma::Mat<eT>& xCentered)
+{
+  if (&x == &xCentered)
+  {
+    CenterInPlace(xCentered);
+    return;
+  }
+
+  xCentered.set_size(x.n_rows, x.n_cols);
+  if (x.n_cols == 0)
+    return;
+
+  // Get the mean of the elements in each row.
+  const arma::Col<eT> rowMean = arma::conv_to<arma::Col<eT>>::from(
+      details::ColumnSum(x, 1024) / x.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
+    xCentered.col(i) = x.col(i) - rowMean;
+}
+
+template<typename eT>
+void MergeMoments(size_t& points,
+                  arma::Col<eT>& mean,
+                  arma::Mat<eT>& scatter,
+                  const size_t otherPoints,
+                  const arma::Col<eT>& otherMean,
+                  const arma::Mat<eT>& otherScatter)
+{
+  if (otherPoints == 0)
+    return;
+
+  if (points == 0)
+  {
+    points = otherPoints;
+    mean = otherMean;
+    scatter = otherScatter;
+    return;
+  }
+
+  const double total = double(points) + double(otherPoints);
+  const arma::Col<eT> delta = otherMean - mean;
+  mean += delta * eT(otherPoints / total);
+  scatter += otherScatter;
+  scatter += (delta * delta.t()) * eT(double(points) * otherPoints / total);
+  points += otherPoints;
+}
+
+template<typename eT>
+void MeanAndCovariance(const arma::Mat<eT>& x,
+                       arma::Col<eT>& mean,
+                       arma::Mat<eT>& covariance,
+                       const size_t blockSize)
+{
+  const size_t size = std::max(blockSize, (size_t) 1);
+  const size_t blocks = (x.n_cols + size - 1) / size;
+
+  size_t points = 0;
+  mean.zeros(x.n_rows);
+  covariance.zeros(x.n_rows, x.n_rows);
+
+  #pragma omp parallel
+  {
+    size_t threadPoints = 0;
+    arma::Col<eT> threadMean(x.n_rows, arma::fill::zeros);
+    arma::Mat<eT> threadScatter(x.n_rows, x.n_rows, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      const size_t begin = b * size;
+      const size_t end = std::min(begin + size, (size_t) x.n_cols) - 1;
+
+      // Center the block on its own mean, so that its scatter matrix is one
+      // matrix product.
+      arma::Mat<eT> block = x.cols(begin, end);
+      const arma::Col<eT> blockMean = arma::sum(block, 1) / eT(block.n_cols);
+      block.each_col() -= blockMean;
+      const arma::Mat<eT> blockScatter = block * block.t();
+
+      MergeMoments(threadPoints, threadMean, threadScatter,
+          (size_t) block.n_cols, blockMean, blockScatter);
+    }
+
+    #pragma omp critical
+    MergeMoments(points, mean, covariance, threadPoints, threadMean,
+        threadScatter);
+  }
+
+  if (points > 1)
+    covariance /= eT(points - 1);
+}
+
+template<typename eT>
+void WhitenUsingSVD(const arma::Mat<eT>& x,
+                    arma::Mat<eT>& xWhitened,
+                    arma::Mat<eT>& whiteningMatrix)
+{
+  arma::Col<eT> mean;
+  arma::Mat<eT> covariance;
+  MeanAndCovariance(x, mean, covariance);
+  details::SVDWhiteningMatrix(covariance, whiteningMatrix);
+
+  xWhitened = whiteningMatrix * x;
+}
+
+template<typename eT>
+void WhitenUsingSVDInPlace(arma::Mat<eT>& x,
+                           arma::Mat<eT>& whiteningMatrix,
+                           const size_t blockSize)
+{
+  arma::Col<eT> mean;
+  arma::Mat<eT> covariance;
+  MeanAndCovariance(x, mean, covariance, blockSize);
+  details::SVDWhiteningMatrix(covariance, whiteningMatrix);
+  details::ApplyInPlace(whiteningMatrix, x, std::max(blockSize, (size_t) 1));
+}
+
+template<typename eT>
+void WhitenUsingEig(const arma::Mat<eT>& x,
+                    arma::Mat<eT>& xWhitened,
+                    arma::Mat<eT>& whiteningMatrix)
+{
+  arma::Col<eT> mean;
+  arma::Mat<eT> covariance;
+  MeanAndCovariance(x, mean, covariance);
+  details::EigWhiteningMatrix(covariance, whiteningMatrix);
+
+  // Now apply the whitening matrix.
+  xWhitened = whiteningMatrix * x;
+}
+
+template<typename eT>
+void WhitenUsingEigInPlace(arma::Mat<eT>& x,
+                           arma::Mat<eT>& whiteningMatrix,
+                           const size_t blockSize)
+{
+  arma::Col<eT> mean;
+  arma::Mat<eT> covariance;
+  MeanAndCovariance(x, mean, covariance, blockSize);
+  details::EigWhiteningMatrix(covariance, whiteningMatrix);
+  details::ApplyInPlace(whiteningMatrix, x, std::max(blockSize, (size_t) 1));
+}
+
 } // namespace math
 } // namespace mlpack
 
@@ -48,6 +48,26 @@ arma::Col<ElemType> MakeAlias(arma::Col<ElemType>& input,
   return arma::Col<ElemType>(input.memptr(), input.n_elem, false, strict);
 }
 
+/**
+ * Reinitialize the given dense matrix in-place as an alias of the given memory.
+ * This is necessary when the matrix is a member of another object, because the
+ * assignment operators of Armadillo copy memory instead of making an alias.  If
+ * strict is true, then the alias cannot be resized or pointed at new memory,
+ * so any assignment of the same size writes directly into newMem.
+ */
+template<typename ElemType>
+void MakeAlias(arma::Mat<ElemType>& m,
+               ElemType* newMem,
+               const size_t numRows,
+               const size_t numCols,
+               const bool strict = true)
+{
+  // Destroy the old object (this frees its memory if it owned any) and
+  // construct the alias in its place.
+  m.~Mat();
+  new (&m) arma::Mat<ElemType>(newMem, numRows, numCols, false, strict);
+}
+
 /**
  * Make a copy of a sparse matrix (an alias is not possible).  The strict
  * parameter is ignored.
@@ -95,6 +115,23 @@ void ClearAlias(arma::Mat<ElemType>& mat)
     mat.reset();
 }
 
+/**
+ * Turn the given dense matrix back into a matrix that owns its memory, keeping
+ * its size and contents.  This does nothing if the matrix is not an alias.
+ * Unlike ClearAlias(), this also works for strict aliases.
+ */
+template<typename ElemType>
+void ReleaseAlias(arma::Mat<ElemType>& mat)
+{
+  if (mat.mem_state == 0)
+    return;
+
+  // The copy constructor always allocates new memory.
+  arma::Mat<ElemType> copy(mat);
+  mat.~Mat();
+  new (&mat) arma::Mat<ElemType>(std::move(copy));
+}
+
 /**
  * Clear an alias for a sparse matrix.  This does nothing because no sparse
  * matrices can have aliases.
@@ -0,0 +1,51 @@
+/**
+ * @file parallel_blocks.hpp
+ *
+ * Process the columns of a dataset in blocks, in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_PARALLEL_BLOCKS_HPP
+#define MLPACK_CORE_MATH_PARALLEL_BLOCKS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Call function(begin, end) for consecutive blocks [begin, end) of the columns
+ * 0, ..., n - 1, with one OpenMP task per block.  This is meant for batch
+ * predictions: each block is scored with one small matrix product, and then
+ * post-processed (thresholding, argmax, normalization) while it is still in
+ * cache, and the model parameters stay in the cache of each thread.  The
+ * blocks do not depend on the number of threads, so neither do the results.
+ *
+ * The function must only write to the columns of its block.
+ *
+ * @param n Number of columns.
+ * @param function Function to call on each block.
+ * @param blockSize Number of columns in each block.
+ */
+template<typename FunctionType>
+void ParallelColumnBlocks(const size_t n,
+                          FunctionType function,
+                          const size_t blockSize = 1024)
+{
+  const size_t blocks = (n + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    function(begin, std::min(begin + blockSize, n));
+  }
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
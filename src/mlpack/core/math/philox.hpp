@@ -0,0 +1,226 @@
+/**
+ * @file philox.hpp
+ *
+ * The Philox-4x32-10 counter-based random number generator.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_PHILOX_HPP
+#define MLPACK_CORE_MATH_PHILOX_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * The Philox-4x32-10 generator of Salmon et al. ("Parallel random numbers: as
+ * easy as 1, 2, 3", SC 2011).  The n-th block of four 32-bit words of a
+ * stream is a bijection of the counter (n, stream) keyed by the seed, so
+ * there is no state to carry from one number to the next: the blocks can be
+ * computed in any order (the fill functions compute many at once, which the
+ * compiler can vectorize), and each stream is an independent sequence for the
+ * same seed.  This is what makes it suitable for one stream per thread.
+ *
+ * The class satisfies the UniformRandomBitGenerator requirements, so it can
+ * also be used with the distributions and algorithms of the standard library.
+ */
+class Philox
+{
+ public:
+  //! The type of the generated numbers.
+  typedef uint32_t result_type;
+
+  //! Get the smallest generated number.
+  static constexpr result_type min() { return 0; }
+  //! Get the largest generated number.
+  static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+  /**
+   * Create the generator for the given stream of the given seed.
+   *
+   * @param seed Seed (the key of the bijection).
+   * @param stream Index of the stream.
+   */
+  Philox(const uint64_t seed = 0, const uint64_t stream = 0)
+  {
+    Seed(seed, stream);
+  }
+
+  //! Restart the generator at the beginning of the given stream of the given
+  //! seed.
+  void Seed(const uint64_t seed, const uint64_t stream = 0)
+  {
+    key[0] = (uint32_t) seed;
+    key[1] = (uint32_t) (seed >> 32);
+    this->stream = stream;
+    block = 0;
+    position = 4;
+  }
+
+  //! Get the next 32 random bits.
+  result_type operator()()
+  {
+    if (position == 4)
+    {
+      Block(block++, buffer);
+      position = 0;
+    }
+
+    return buffer[position++];
+  }
+
+  //! Skip the given number of blocks of four words ahead in the stream.
+  void Discard(const uint64_t blocks)
+  {
+    block += blocks;
+    position = 4;
+  }
+
+  /**
+   * Fill the given array with numbers uniformly distributed in [0, 1).
+   * Doubles get 53 random bits and floats 24.
+   *
+   * @param out Array to fill.
+   * @param n Number of elements of the array.
+   */
+  template<typename eT>
+  void FillUniform(eT* out, const size_t n)
+  {
+    // Each block gives four floats or two doubles.
+    const size_t perBlock = (sizeof(eT) > 4) ? 2 : 4;
+    const size_t full = n / perBlock;
+    for (size_t b = 0; b < full; ++b)
+    {
+      uint32_t words[4];
+      Block(block + b, words);
+      for (size_t i = 0; i < perBlock; ++i)
+        out[b * perBlock + i] = Uniform<eT>(words, i);
+    }
+
+    block += full;
+    position = 4;
+    for (size_t i = full * perBlock; i < n; ++i)
+    {
+      uint32_t words[4] = { (*this)(), (*this)(), 0, 0 };
+      out[i] = Uniform<eT>(words, 0);
+    }
+  }
+
+  /**
+   * Fill the given array with normally distributed numbers (with the
+   * Box-Muller transform).
+   *
+   * @param out Array to fill.
+   * @param n Number of elements of the array.
+   * @param mean Mean of the distribution.
+   * @param stddev Standard deviation of the distribution.
+   */
+  template<typename eT>
+  void FillNormal(eT* out,
+                  const size_t n,
+                  const double mean = 0.0,
+                  const double stddev = 1.0)
+  {
+    const double twoPi = 6.283185307179586476925286766559;
+    for (size_t i = 0; i < n; i += 2)
+    {
+      uint32_t words[4];
+      Block(block++, words);
+      const double u1 = 1.0 - Uniform<double>(words, 0);
+      const double u2 = Uniform<double>(words, 1);
+      const double radius = std::sqrt(-2.0 * std::log(u1));
+      out[i] = (eT) (mean + stddev * radius * std::cos(twoPi * u2));
+      if (i + 1 < n)
+        out[i + 1] = (eT) (mean + stddev * radius * std::sin(twoPi * u2));
+    }
+
+    position = 4;
+  }
+
+  /**
+   * Get a random integer in [0, hiExclusive).  The bias is below 2^-32 for
+   * any range that fits in 32 bits.
+   */
+  uint64_t Integer(const uint64_t hiExclusive)
+  {
+    const uint64_t high = (*this)();
+    return (((uint64_t) (*this)()) | (high << 32)) % hiExclusive;
+  }
+
+  /**
+   * Compute the given block of the stream, without changing the position of
+   * the generator.
+   *
+   * @param index Index of the block.
+   * @param out The four words of the block.
+   */
+  void Block(const uint64_t index, uint32_t out[4]) const
+  {
+    uint32_t c[4] = { (uint32_t) index, (uint32_t) (index >> 32),
+        (uint32_t) stream, (uint32_t) (stream >> 32) };
+    uint32_t k[2] = { key[0], key[1] };
+    for (size_t round = 0; round < 10; ++round)
+    {
+      if (round > 0)
+      {
+        k[0] += 0x9E3779B9u;
+        k[1] += 0xBB67AE85u;
+      }
+
+      const uint64_t p0 = (uint64_t) 0xD2511F53u * c[0];
+      const uint64_t p1 = (uint64_t) 0xCD9E8D57u * c[2];
+      const uint32_t next[4] = { (uint32_t) (p1 >> 32) ^ c[1] ^ k[0],
+          (uint32_t) p1, (uint32_t) (p0 >> 32) ^ c[3] ^ k[1], (uint32_t) p0 };
+      c[0] = next[0];
+      c[1] = next[1];
+      c[2] = next[2];
+      c[3] = next[3];
+    }
+
+    out[0] = c[0];
+    out[1] = c[1];
+    out[2] = c[2];
+    out[3] = c[3];
+  }
+
+ private:
+  //! Convert the i-th number's share of the words of a block to [0, 1).
+  template<typename eT>
+  static eT Uniform(const uint32_t words[4], const size_t i)
+  {
+    if (sizeof(eT) > 4)
+    {
+      const uint64_t bits = (((uint64_t) words[2 * i]) << 32) |
+          words[2 * i + 1];
+      return (eT) ((bits >> 11) * (1.0 / 9007199254740992.0));
+    }
+
+    return (eT) ((words[i] >> 8) * (1.0f / 16777216.0f));
+  }
+
+  //! The key (the seed).
+  uint32_t key[2];
+
+  //! The index of the stream.
+  uint64_t stream;
+
+  //! The index of the next block.
+  uint64_t block;
+
+  //! The words of the current block.
+  uint32_t buffer[4];
+
+  //! The index of the next word of the current block.
+  size_t position;
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
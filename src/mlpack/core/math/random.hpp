@@ -13,8 +13,13 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/mlpack_export.hpp>
+#include <mlpack/core/math/philox.hpp>
 #include <random>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
 
@@ -29,6 +34,11 @@ extern MLPACK_EXPORT std::mt19937 randGen;
 extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
+// Seed of the per-thread generators of ThreadRandGen().
+extern MLPACK_EXPORT uint64_t randStreamSeed;
+// Incremented by every RandomSeed() call, so that the per-thread generators
+// know when to restart.
+extern MLPACK_EXPORT size_t randStreamVersion;
 
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
@@ -43,6 +53,8 @@ inline void RandomSeed(const size_t seed)
     randGen.seed((uint32_t) seed);
     srand((unsigned int) seed);
     arma::arma_rng::set_seed(seed);
+    randStreamSeed = seed;
+    ++randStreamVersion;
   #else
     (void) seed;
   #endif
@@ -62,6 +74,8 @@ inline void FixedRandomSeed()
   randGen.seed((uint32_t) seed);
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
+  randStreamSeed = seed;
+  ++randStreamVersion;
 }
 #endif
 
@@ -118,6 +132,85 @@ inline double RandNormal(const double mean, const double variance)
   return variance * randNormalDist(randGen) + mean;
 }
 
+/**
+ * Get the counter-based generator of the calling thread.  The generator of
+ * every thread is its own stream of the seed given to RandomSeed(), numbered
+ * by the OpenMP thread number of the thread when it first draws after the
+ * seed is set; so with the same seed and the same number of threads the
+ * numbers drawn by each thread are reproducible, and the threads never need
+ * to synchronize.  This is the generator the fill functions below use.
+ */
+inline Philox& ThreadRandGen()
+{
+  static thread_local Philox generator;
+  static thread_local size_t version = 0;
+  if (version != randStreamVersion)
+  {
+    #ifdef HAS_OPENMP
+      generator.Seed(randStreamSeed, (uint64_t) omp_get_thread_num());
+    #else
+      generator.Seed(randStreamSeed, 0);
+    #endif
+    version = randStreamVersion;
+  }
+
+  return generator;
+}
+
+/**
+ * Fill the given matrix with numbers uniformly distributed in [0, 1), drawn
+ * from the generator of the calling thread.
+ */
+template<typename eT>
+inline void RandUniform(arma::Mat<eT>& m)
+{
+  ThreadRandGen().FillUniform(m.memptr(), m.n_elem);
+}
+
+/**
+ * Fill the given matrix with normally distributed numbers, drawn from the
+ * generator of the calling thread.
+ *
+ * @param m Matrix to fill.
+ * @param mean Mean of the distribution.
+ * @param stddev Standard deviation of the distribution.
+ */
+template<typename eT>
+inline void RandNormal(arma::Mat<eT>& m,
+                       const double mean = 0.0,
+                       const double stddev = 1.0)
+{
+  ThreadRandGen().FillNormal(m.memptr(), m.n_elem, mean, stddev);
+}
+
+/**
+ * Get the given number of random integers in [0, hiExclusive), drawn from the
+ * generator of the calling thread.
+ */
+inline arma::uvec RandIntegers(const size_t n, const size_t hiExclusive)
+{
+  Philox& generator = ThreadRandGen();
+  arma::uvec integers(n);
+  for (size_t i = 0; i < n; ++i)
+    integers[i] = (arma::uword) generator.Integer(hiExclusive);
+
+  return integers;
+}
+
+/**
+ * Get a random permutation of 0, ..., n - 1, drawn from the generator of the
+ * calling thread.
+ */
+inline arma::uvec RandPermutation(const size_t n)
+{
+  Philox& generator = ThreadRandGen();
+  arma::uvec ordering = arma::linspace<arma::uvec>(0, n - 1, n);
+  for (size_t i = n; i > 1; --i)
+    std::swap(ordering[i - 1], ordering[generator.Integer(i)]);
+
+  return ordering;
+}
+
 /**
  * Obtains no more than maxNumSamples distinct samples. Each sample belongs to
  * [loInclusive, hiExclusive).
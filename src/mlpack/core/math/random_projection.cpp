@@ -0,0 +1,79 @@
+/**
+ * @file random_projection.cpp
+ *
+ * Implementation of the non-templated functions of RandomProjection.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "random_projection.hpp"
+
+namespace mlpack {
+namespace math {
+
+RandomProjection::RandomProjection(const size_t dimensionality,
+                                   const double density,
+                                   const uint64_t seed) :
+    dimensionality(dimensionality),
+    density(density),
+    seed(seed)
+{
+  // Nothing to do.
+}
+
+void RandomProjection::Projection(const size_t inputDimensionality,
+                                  arma::sp_mat& projection) const
+{
+  const double p = CheckedDensity(inputDimensionality);
+  const double logKeep = std::log1p(-p);
+  const double scale = 1.0 / std::sqrt(p * dimensionality);
+
+  std::vector<arma::uword> rows, columns;
+  std::vector<double> values;
+  for (size_t j = 0; j < inputDimensionality; ++j)
+  {
+    ForEachNonzero(j, logKeep, [&](const size_t row, const int sign)
+    {
+      rows.push_back(row);
+      columns.push_back(j);
+      values.push_back(sign * scale);
+    });
+  }
+
+  arma::umat locations(2, rows.size());
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    locations(0, i) = rows[i];
+    locations(1, i) = columns[i];
+  }
+
+  projection = arma::sp_mat(locations, arma::vec(values), dimensionality,
+      inputDimensionality);
+}
+
+double RandomProjection::CheckedDensity(const size_t inputDimensionality) const
+{
+  if (dimensionality == 0)
+  {
+    throw std::invalid_argument("RandomProjection: the number of dimensions "
+        "of the projected points must be positive!");
+  }
+  if (density < 0.0 || density > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "RandomProjection: the density (" << density << ") must be in "
+        << "[0, 1]!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (density > 0.0)
+    return density;
+
+  // The very sparse projection.
+  return 1.0 / std::sqrt((double) std::max(inputDimensionality, (size_t) 1));
+}
+
+} // namespace math
+} // namespace mlpack
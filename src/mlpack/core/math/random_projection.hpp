@@ -0,0 +1,175 @@
+/**
+ * @file random_projection.hpp
+ *
+ * Sparse random projections of dense and sparse data, whose projection matrix
+ * is generated on the fly from a seed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_RANDOM_PROJECTION_HPP
+#define MLPACK_CORE_MATH_RANDOM_PROJECTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "philox.hpp"
+#include "parallel_blocks.hpp"
+
+namespace mlpack {
+namespace math {
+
+/**
+ * The RandomProjection class maps d-dimensional points to k dimensions with a
+ * sparse random matrix R, y = R x, whose elements are independently 0 with
+ * probability 1 - p, and +1 / sqrt(p k) or -1 / sqrt(p k) with probability
+ * p / 2 each.  Distances are then preserved up to a small distortion with high
+ * probability (the Johnson-Lindenstrauss lemma), and the projection is much
+ * cheaper than with the dense orthogonal basis of RandomBasis().  The density
+ * p = 1 / 3 gives the projection of
+ *
+ * @code
+ * @article{achlioptas2003database,
+ *   title={Database-friendly random projections: Johnson-Lindenstrauss with
+ *       binary coins},
+ *   author={Achlioptas, D.},
+ *   journal={Journal of Computer and System Sciences},
+ *   volume={66},
+ *   number={4},
+ *   pages={671--687},
+ *   year={2003}
+ * }
+ * @endcode
+ *
+ * and the default density p = 1 / sqrt(d) the very sparse random projection
+ * of
+ *
+ * @code
+ * @inproceedings{li2006very,
+ *   title={Very sparse random projections},
+ *   author={Li, P. and Hastie, T.J. and Church, K.W.},
+ *   booktitle={Proceedings of the 12th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={287--296},
+ *   year={2006}
+ * }
+ * @endcode
+ *
+ * The matrix is never stored: column j of R is generated from stream j of a
+ * math::Philox generator keyed by the seed, with geometrically distributed
+ * gaps between its nonzero elements, so it costs about p k + 1 random numbers
+ * to generate.  Sparse points (arma::SpMat) are projected by generating the
+ * columns of their nonzero dimensions; dense points are projected by blocks of
+ * dimensions, whose columns are generated once for all the points.  The
+ * points are projected in parallel, and the result only depends on the seed.
+ *
+ * For instance, to project sparse points to 256 dimensions before a nearest
+ * neighbor search (the query points must be projected by the same object, or
+ * one with the same seed):
+ *
+ * @code
+ * math::RandomProjection projection(256, 0.0, 42);
+ * arma::mat projectedReferences, projectedQueries;
+ * projection.Transform(references, projectedReferences);
+ * projection.Transform(queries, projectedQueries);
+ * @endcode
+ */
+class RandomProjection
+{
+ public:
+  /**
+   * Create the projection to the given number of dimensions.
+   *
+   * @param dimensionality Number of dimensions of the projected points.
+   * @param density Probability that an element of the projection matrix is
+   *     nonzero, in (0, 1]; 0 means 1 / sqrt(d) for d-dimensional points.
+   * @param seed Seed that the projection matrix is generated from.
+   */
+  RandomProjection(const size_t dimensionality = 0,
+                   const double density = 0.0,
+                   const uint64_t seed = 0);
+
+  /**
+   * Project the given dense points.  Throws std::invalid_argument if the
+   * number of dimensions is 0 or the density is not in [0, 1].
+   *
+   * @param input Points to project, one per column.
+   * @param output Matrix to store the projected points in.
+   */
+  template<typename eT>
+  void Transform(const arma::Mat<eT>& input, arma::Mat<eT>& output) const;
+
+  /**
+   * Project the given sparse points.  Throws std::invalid_argument if the
+   * number of dimensions is 0 or the density is not in [0, 1].
+   *
+   * @param input Points to project, one per column.
+   * @param output Matrix to store the (dense) projected points in.
+   */
+  template<typename eT>
+  void Transform(const arma::SpMat<eT>& input, arma::Mat<eT>& output) const;
+
+  /**
+   * Compute the projection matrix for points of the given dimensionality,
+   * for inspection; Transform() doesn't need it.
+   *
+   * @param inputDimensionality Number of dimensions of the points.
+   * @param projection Sparse matrix to store the projection matrix in.
+   */
+  void Projection(const size_t inputDimensionality,
+                  arma::sp_mat& projection) const;
+
+  //! Get the number of dimensions of the projected points.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Modify the number of dimensions of the projected points.
+  size_t& Dimensionality() { return dimensionality; }
+
+  //! Get the density of the projection matrix (0 means 1 / sqrt(d)).
+  double Density() const { return density; }
+  //! Modify the density of the projection matrix (0 means 1 / sqrt(d)).
+  double& Density() { return density; }
+
+  //! Get the seed of the projection matrix.
+  uint64_t Seed() const { return seed; }
+  //! Modify the seed of the projection matrix.
+  uint64_t& Seed() { return seed; }
+
+  //! Serialize the projection.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Check the parameters, and return the density of the projection matrix for
+   * points of the given dimensionality.
+   */
+  double CheckedDensity(const size_t inputDimensionality) const;
+
+  /**
+   * Call function(row, sign) for each nonzero element of the given column of
+   * the projection matrix, in increasing order of rows, where sign is +1 or -1.
+   *
+   * @param column Index of the column (an input dimension).
+   * @param logKeep Logarithm of 1 - p.
+   * @param function Function to call.
+   */
+  template<typename FunctionType>
+  void ForEachNonzero(const size_t column,
+                      const double logKeep,
+                      FunctionType function) const;
+
+  //! The number of dimensions of the projected points.
+  size_t dimensionality;
+  //! The density of the projection matrix.
+  double density;
+  //! The seed of the projection matrix.
+  uint64_t seed;
+};
+
+} // namespace math
+} // namespace mlpack
+
+// Include implementation.
+#include "random_projection_impl.hpp"
+
+#endif
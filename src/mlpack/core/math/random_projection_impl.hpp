@@ -0,0 +1,153 @@
+/**
+ * @file random_projection_impl.hpp
+ *
+ * Implementation of the templated functions of RandomProjection.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_RANDOM_PROJECTION_IMPL_HPP
+#define MLPACK_CORE_MATH_RANDOM_PROJECTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_projection.hpp"
+
+namespace mlpack {
+namespace math {
+
+template<typename eT>
+void RandomProjection::Transform(const arma::Mat<eT>& input,
+                                 arma::Mat<eT>& output) const
+{
+  const double p = CheckedDensity(input.n_rows);
+  const double logKeep = std::log1p(-p);
+  output.zeros(dimensionality, input.n_cols);
+
+  // The columns of a block of dimensions are generated once, in the
+  // compressed sparse column format, and applied to all the points.
+  const size_t blockSize = 4096;
+  std::vector<size_t> offsets;
+  std::vector<size_t> rows;
+  std::vector<eT> signs;
+  for (size_t begin = 0; begin < input.n_rows; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) input.n_rows);
+
+    // Count the nonzero elements of each column first, and then generate them
+    // at their place.
+    offsets.assign(end - begin + 1, 0);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = (omp_size_t) begin; j < (omp_size_t) end; ++j)
+    {
+      ForEachNonzero(j, logKeep, [&](const size_t /* row */,
+          const int /* sign */) { ++offsets[j - begin + 1]; });
+    }
+    for (size_t j = 1; j < offsets.size(); ++j)
+      offsets[j] += offsets[j - 1];
+
+    rows.resize(offsets.back());
+    signs.resize(offsets.back());
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = (omp_size_t) begin; j < (omp_size_t) end; ++j)
+    {
+      size_t position = offsets[j - begin];
+      ForEachNonzero(j, logKeep, [&](const size_t row, const int sign)
+      {
+        rows[position] = row;
+        signs[position++] = (eT) sign;
+      });
+    }
+
+    ParallelColumnBlocks(input.n_cols, [&](const size_t first,
+                                           const size_t last)
+    {
+      for (size_t i = first; i < last; ++i)
+      {
+        const eT* point = input.colptr(i);
+        eT* projected = output.colptr(i);
+        for (size_t j = begin; j < end; ++j)
+        {
+          const eT value = point[j];
+          if (value == 0)
+            continue;
+
+          for (size_t k = offsets[j - begin]; k < offsets[j - begin + 1]; ++k)
+            projected[rows[k]] += signs[k] * value;
+        }
+      }
+    });
+  }
+
+  output *= (eT) (1.0 / std::sqrt(p * dimensionality));
+}
+
+template<typename eT>
+void RandomProjection::Transform(const arma::SpMat<eT>& input,
+                                 arma::Mat<eT>& output) const
+{
+  const double p = CheckedDensity(input.n_rows);
+  const double logKeep = std::log1p(-p);
+  output.zeros(dimensionality, input.n_cols);
+
+  // Bring the compressed arrays up to date before they are read in parallel.
+  input.sync();
+
+  // The columns of the nonzero dimensions of each point are generated again
+  // for each point, so the projection matrix is never stored.
+  ParallelColumnBlocks(input.n_cols, [&](const size_t first, const size_t last)
+  {
+    for (size_t i = first; i < last; ++i)
+    {
+      eT* projected = output.colptr(i);
+      for (size_t k = input.col_ptrs[i]; k < input.col_ptrs[i + 1]; ++k)
+      {
+        const eT value = input.values[k];
+        ForEachNonzero(input.row_indices[k], logKeep,
+            [&](const size_t row, const int sign)
+            { projected[row] += sign * value; });
+      }
+    }
+  });
+
+  output *= (eT) (1.0 / std::sqrt(p * dimensionality));
+}
+
+template<typename FunctionType>
+void RandomProjection::ForEachNonzero(const size_t column,
+                                      const double logKeep,
+                                      FunctionType function) const
+{
+  Philox generator(seed, column);
+  size_t row = 0;
+  while (row < dimensionality)
+  {
+    // Draw u in (0, 1] from 53 bits, and the sign from another one.  The gap
+    // before the next nonzero element, floor(log(u) / log(1 - p)), is
+    // geometrically distributed with parameter p.
+    const uint64_t high = generator();
+    const uint64_t bits = (high << 32) | generator();
+    const double u = ((bits >> 11) + 1) * (1.0 / 9007199254740992.0);
+    const double gap = std::floor(std::log(u) / logKeep);
+    if (gap >= (double) (dimensionality - row))
+      break;
+
+    row += (size_t) gap;
+    function(row, (bits & 1) ? -1 : 1);
+    ++row;
+  }
+}
+
+template<typename Archive>
+void RandomProjection::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(dimensionality);
+  ar & BOOST_SERIALIZATION_NVP(density);
+  ar & BOOST_SERIALIZATION_NVP(seed);
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -8,16 +8,68 @@
 #define MLPACK_CORE_MATH_SHUFFLE_DATA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 namespace mlpack {
 namespace math {
 
+/**
+ * Rearrange the columns of a dense matrix in place, so that column i becomes
+ * what was column ordering[i], as with data = data.cols(ordering).  Each cycle
+ * of the permutation is followed with a single temporary column, so no copy of
+ * the matrix is made.
+ *
+ * @param data Matrix to rearrange.
+ * @param ordering Permutation of the column indices of data.
+ */
+template<typename MatType>
+void PermuteColumns(MatType& data, const arma::uvec& ordering)
+{
+  std::vector<bool> done(ordering.n_elem, false);
+  arma::Col<typename MatType::elem_type> first;
+  for (size_t start = 0; start < ordering.n_elem; ++start)
+  {
+    if (done[start] || ordering[start] == start)
+      continue;
+
+    first = data.col(start);
+    size_t i = start;
+    while (ordering[i] != start)
+    {
+      data.col(i) = data.col(ordering[i]);
+      done[i] = true;
+      i = ordering[i];
+    }
+    data.col(i) = first;
+    done[i] = true;
+  }
+}
+
+/**
+ * Set output to the columns of input in the given order, copying the columns
+ * in parallel, as with output = input.cols(ordering).  input and output must be
+ * different objects.
+ */
+template<typename MatType>
+void GatherColumns(const MatType& input,
+                   const arma::uvec& ordering,
+                   MatType& output)
+{
+  output.set_size(input.n_rows, ordering.n_elem);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) ordering.n_elem; ++i)
+    output.col(i) = input.col(ordering[i]);
+}
+
 /**
  * Shuffle a dataset and associated labels (or responses).  It is expected that
  * inputPoints and inputLabels have the same number of columns (so, be sure that
  * inputLabels, if it is a vector, is a row vector).
  *
- * Shuffled data will be output into outputPoints and outputLabels.
+ * Shuffled data will be output into outputPoints and outputLabels.  If they are
+ * the same objects as inputPoints and inputLabels, the data is shuffled in
+ * place, without a copy of the dataset; otherwise the columns are copied in
+ * parallel.
  */
 template<typename MatType, typename LabelsType>
 void ShuffleData(const MatType& inputPoints,
@@ -28,11 +80,17 @@ void ShuffleData(const MatType& inputPoints,
                  const std::enable_if_t<!arma::is_Cube<MatType>::value>* = 0)
 {
   // Generate ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      inputPoints.n_cols - 1, inputPoints.n_cols));
+  arma::uvec ordering = RandPermutation(inputPoints.n_cols);
 
-  outputPoints = inputPoints.cols(ordering);
-  outputLabels = inputLabels.cols(ordering);
+  if (&inputPoints == &outputPoints)
+    PermuteColumns(outputPoints, ordering);
+  else
+    GatherColumns(inputPoints, ordering, outputPoints);
+
+  if (&inputLabels == &outputLabels)
+    PermuteColumns(outputLabels, ordering);
+  else
+    outputLabels = inputLabels.cols(ordering);
 }
 
 /**
@@ -51,8 +109,7 @@ void ShuffleData(const MatType& inputPoints,
                  const std::enable_if_t<!arma::is_Cube<MatType>::value>* = 0)
 {
   // Generate ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      inputPoints.n_cols - 1, inputPoints.n_cols));
+  arma::uvec ordering = RandPermutation(inputPoints.n_cols);
 
   // Extract coordinate list representation.
   arma::umat locations(2, inputPoints.n_nonzero);
@@ -105,8 +162,7 @@ void ShuffleData(const MatType& inputPoints,
                  const std::enable_if_t<arma::is_Cube<LabelsType>::value>* = 0)
 {
   // Generate ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      inputPoints.n_cols - 1, inputPoints.n_cols));
+  arma::uvec ordering = RandPermutation(inputPoints.n_cols);
 
   // Properly handle the case where the input and output data are the same
   // object.
@@ -0,0 +1,171 @@
+/**
+ * @file distance_kernels.cpp
+ *
+ * Implementation of the compiled distance kernels.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "distance_kernels.hpp"
+
+#include <mlpack/core/util/cpu_features.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace mlpack;
+using namespace mlpack::metric;
+
+namespace {
+
+#if defined(__GNUC__)
+
+// The kernels work on blocks of 64 bytes: one AVX-512 register, which the
+// compiler splits into two AVX2 or four SSE registers for the other versions.
+// Summing into a whole block of partial sums is what lets the reduction be
+// vectorized without reassociating floating-point additions behind the back of
+// the programmer.
+typedef double DoubleBlock __attribute__((vector_size(64)));
+typedef int64_t DoubleMask __attribute__((vector_size(64)));
+typedef float FloatBlock __attribute__((vector_size(64)));
+typedef int32_t FloatMask __attribute__((vector_size(64)));
+
+//! The block types for each element type.
+template<typename eT>
+struct Blocks;
+
+template<>
+struct Blocks<double>
+{
+  typedef DoubleBlock BlockType;
+  typedef DoubleMask MaskType;
+  //! Every bit but the sign bit.
+  static const int64_t absMask = INT64_MAX;
+};
+
+template<>
+struct Blocks<float>
+{
+  typedef FloatBlock BlockType;
+  typedef FloatMask MaskType;
+  //! Every bit but the sign bit.
+  static const int32_t absMask = INT32_MAX;
+};
+
+template<typename eT>
+inline __attribute__((always_inline)) eT SquaredEuclidean(const eT* a,
+                                                         const eT* b,
+                                                         const size_t n)
+{
+  typedef typename Blocks<eT>::BlockType BlockType;
+  const size_t lanes = sizeof(BlockType) / sizeof(eT);
+
+  BlockType sum = {};
+  size_t i = 0;
+  for (; i + lanes <= n; i += lanes)
+  {
+    BlockType x, y;
+    std::memcpy(&x, a + i, sizeof(BlockType));
+    std::memcpy(&y, b + i, sizeof(BlockType));
+    const BlockType d = x - y;
+    sum += d * d;
+  }
+
+  eT result = 0;
+  for (size_t j = 0; j < lanes; ++j)
+    result += sum[j];
+  for (; i < n; ++i)
+    result += (a[i] - b[i]) * (a[i] - b[i]);
+
+  return result;
+}
+
+template<typename eT>
+inline __attribute__((always_inline)) eT Manhattan(const eT* a,
+                                                  const eT* b,
+                                                  const size_t n)
+{
+  typedef typename Blocks<eT>::BlockType BlockType;
+  typedef typename Blocks<eT>::MaskType MaskType;
+  const size_t lanes = sizeof(BlockType) / sizeof(eT);
+
+  MaskType mask = {};
+  mask += Blocks<eT>::absMask;
+
+  BlockType sum = {};
+  size_t i = 0;
+  for (; i + lanes <= n; i += lanes)
+  {
+    BlockType x, y;
+    std::memcpy(&x, a + i, sizeof(BlockType));
+    std::memcpy(&y, b + i, sizeof(BlockType));
+    // Clearing the sign bits gives the absolute values.
+    sum += (BlockType) ((MaskType) (x - y) & mask);
+  }
+
+  eT result = 0;
+  for (size_t j = 0; j < lanes; ++j)
+    result += sum[j];
+  for (; i < n; ++i)
+    result += std::abs(a[i] - b[i]);
+
+  return result;
+}
+
+#else
+
+template<typename eT>
+inline eT SquaredEuclidean(const eT* a, const eT* b, const size_t n)
+{
+  eT result = 0;
+  for (size_t i = 0; i < n; ++i)
+    result += (a[i] - b[i]) * (a[i] - b[i]);
+  return result;
+}
+
+template<typename eT>
+inline eT Manhattan(const eT* a, const eT* b, const size_t n)
+{
+  eT result = 0;
+  for (size_t i = 0; i < n; ++i)
+    result += std::abs(a[i] - b[i]);
+  return result;
+}
+
+#endif
+
+} // namespace
+
+MLPACK_TARGET_CLONES
+double mlpack::metric::SquaredEuclideanKernel(const double* a,
+                                              const double* b,
+                                              const size_t n)
+{
+  return SquaredEuclidean(a, b, n);
+}
+
+MLPACK_TARGET_CLONES
+float mlpack::metric::SquaredEuclideanKernel(const float* a,
+                                             const float* b,
+                                             const size_t n)
+{
+  return SquaredEuclidean(a, b, n);
+}
+
+MLPACK_TARGET_CLONES
+double mlpack::metric::ManhattanKernel(const double* a,
+                                       const double* b,
+                                       const size_t n)
+{
+  return Manhattan(a, b, n);
+}
+
+MLPACK_TARGET_CLONES
+float mlpack::metric::ManhattanKernel(const float* a,
+                                      const float* b,
+                                      const size_t n)
+{
+  return Manhattan(a, b, n);
+}
@@ -0,0 +1,50 @@
+/**
+ * @file distance_kernels.hpp
+ *
+ * Compiled kernels for the distances between contiguous vectors.  When the
+ * library is built with BUILD_ISA_VARIANTS, they are compiled for several
+ * instruction sets and the best one for the processor is used.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_DISTANCE_KERNELS_HPP
+#define MLPACK_CORE_METRICS_DISTANCE_KERNELS_HPP
+
+#include <cstddef>
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * The minimum number of elements for which LMetric uses the compiled kernels;
+ * for shorter vectors the call costs more than it saves.
+ */
+const size_t DistanceKernelMinSize = 16;
+
+/**
+ * Compute the squared Euclidean distance between two vectors.
+ *
+ * @param a The first vector.
+ * @param b The second vector.
+ * @param n Number of elements of each vector.
+ */
+double SquaredEuclideanKernel(const double* a, const double* b, const size_t n);
+float SquaredEuclideanKernel(const float* a, const float* b, const size_t n);
+
+/**
+ * Compute the Manhattan (L1) distance between two vectors.
+ *
+ * @param a The first vector.
+ * @param b The second vector.
+ * @param n Number of elements of each vector.
+ */
+double ManhattanKernel(const double* a, const double* b, const size_t n);
+float ManhattanKernel(const float* a, const float* b, const size_t n);
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file fixed_lmetric.hpp
+ *
+ * The L-metric for points of a dimensionality known at compile time, for
+ * low-dimensional data such as 2-D locations and 3-D point clouds.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_FIXED_LMETRIC_HPP
+#define MLPACK_CORE_METRICS_FIXED_LMETRIC_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "lmetric.hpp"
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * The L_p metric of LMetric, for points of the dimensionality given as a
+ * template parameter.  Each distance is a loop over a constant number of
+ * dimensions, which the compiler unrolls completely, instead of a call to a
+ * general vector expression; for two or three dimensions, this is several
+ * times faster.  The metric is also a choice for the trees: the HRectBound of
+ * a BinarySpaceTree (such as a kd-tree) with this metric stores its ranges in
+ * the node, and its distance computations are unrolled likewise.  For
+ * instance, a kd-tree nearest neighbor search on 3-dimensional points is
+ *
+ * @code
+ * NeighborSearch<NearestNeighborSort, FixedEuclideanDistance<3>, arma::mat,
+ *     KDTree> knn(points);
+ * @endcode
+ *
+ * The points must have exactly Dim dimensions; the trees check it when they
+ * are built.  The distances between the columns of two matrices are those of
+ * LMetric.
+ *
+ * @tparam Dim Dimensionality of the points.
+ * @tparam TPower Power of metric (see LMetric).
+ * @tparam TTakeRoot If true, the Power'th root of the result is taken (see
+ *     LMetric).
+ */
+template<size_t Dim, int TPower, bool TTakeRoot = true>
+class FixedLMetric
+{
+  static_assert(Dim > 0, "FixedLMetric: the dimensionality must be positive.");
+
+ public:
+  //! Default constructor does nothing, but is required by the Metric policy.
+  FixedLMetric() { }
+
+  /**
+   * Computes the distance between two points of dimensionality Dim.
+   *
+   * @tparam VecTypeA Type of first vector.
+   * @tparam VecTypeB Type of second vector.
+   * @param a First vector.
+   * @param b Second vector.
+   * @return Distance between vectors a and b.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
+                                               const VecTypeB& b)
+  {
+    typedef typename VecTypeA::elem_type ElemType;
+
+    ElemType sum = 0;
+    for (size_t i = 0; i < Dim; ++i)
+    {
+      const ElemType v = std::abs(a[i] - b[i]);
+
+      // The compiler should optimize these conditions at compile-time.
+      if (Power == INT_MAX)
+        sum = std::max(sum, v);
+      else if (Power == 1)
+        sum += v;
+      else if (Power == 2)
+        sum += v * v;
+      else
+        sum += std::pow(v, (ElemType) Power);
+    }
+
+    if (!TakeRoot || Power == 1 || Power == INT_MAX)
+      return sum;
+    else if (Power == 2)
+      return std::sqrt(sum);
+    else
+      return std::pow(sum, (ElemType) (1.0 / Power));
+  }
+
+  /**
+   * Computes the distances between every column of a and every column of b,
+   * and stores them in out, like LMetric.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the distances in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::Mat<typename MatTypeA::elem_type>& out)
+  {
+    LMetric<TPower, TTakeRoot>::Evaluate(a, b, out);
+  }
+
+  //! Serialize the metric (nothing to do).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+  //! The power of the metric.
+  static const int Power = TPower;
+  //! Whether or not the root is taken.
+  static const bool TakeRoot = TTakeRoot;
+  //! The dimensionality of the points.
+  static const size_t Dimensionality = Dim;
+};
+
+// Convenience typedefs.
+
+/**
+ * The Euclidean (L2) distance between points of dimensionality Dim.
+ */
+template<size_t Dim>
+using FixedEuclideanDistance = FixedLMetric<Dim, 2, true>;
+
+/**
+ * The squared Euclidean (L2) distance between points of dimensionality Dim.
+ */
+template<size_t Dim>
+using FixedSquaredEuclideanDistance = FixedLMetric<Dim, 2, false>;
+
+/**
+ * The Manhattan (L1) distance between points of dimensionality Dim.
+ */
+template<size_t Dim>
+using FixedManhattanDistance = FixedLMetric<Dim, 1, false>;
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
@@ -83,6 +83,28 @@ class LMetric
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the distances between every column of a and every column of b,
+   * and stores them in out: out(i, j) = d(a.col(i), b.col(j)).  For the
+   * (squared) Euclidean distance, the squared distances are computed as
+   * ||a_i||^2 + ||b_j||^2 - 2 a_i^T b_j with one matrix multiplication, so they
+   * may differ from those of the other overload by roundoff (the distances
+   * that are small compared to the norms of the points are computed exactly,
+   * though, so they are never negative).  For other powers, each column of out
+   * is computed with one vectorized expression.  The matrices must be dense.
+   *
+   * @tparam MatTypeA Type of first matrix (arma::Mat or a subview of one).
+   * @tparam MatTypeB Type of second matrix.
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the distances in; it is set to the size
+   *      a.n_cols x b.n_cols.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::Mat<typename MatTypeA::elem_type>& out);
+
   //! Serialize the metric (nothing to do).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -14,10 +14,106 @@
 
 // In case it hasn't been included.
 #include "lmetric.hpp"
+#include "distance_kernels.hpp"
 
 namespace mlpack {
 namespace metric {
 
+namespace details {
+
+//! Whether the elements of a dense vector type are contiguous in memory.
+template<typename VecType>
+struct IsContiguousVector
+{
+  static const bool value = false;
+};
+
+template<typename eT>
+struct IsContiguousVector<arma::Col<eT> >
+{
+  static const bool value = true;
+};
+
+template<typename eT>
+struct IsContiguousVector<arma::Row<eT> >
+{
+  static const bool value = true;
+};
+
+template<typename eT>
+struct IsContiguousVector<arma::subview_col<eT> >
+{
+  static const bool value = true;
+};
+
+//! Whether the compiled distance kernels can be used for the given vectors.
+template<typename VecTypeA, typename VecTypeB>
+struct UseDistanceKernels
+{
+  typedef typename VecTypeA::elem_type ElemType;
+
+  static const bool value = IsContiguousVector<VecTypeA>::value &&
+      IsContiguousVector<VecTypeB>::value &&
+      std::is_same<ElemType, typename VecTypeB::elem_type>::value &&
+      (std::is_same<ElemType, double>::value ||
+       std::is_same<ElemType, float>::value);
+};
+
+//! Get the memory of a contiguous vector.
+template<typename eT>
+const eT* VectorMemory(const arma::Mat<eT>& v) { return v.memptr(); }
+
+template<typename eT>
+const eT* VectorMemory(const arma::subview_col<eT>& v) { return v.colmem; }
+
+/**
+ * Compute the squared Euclidean distance between two vectors, with the
+ * compiled kernel if the vectors are long enough.  Vectors of different sizes
+ * are left to Armadillo, which reports the error.
+ */
+template<typename VecTypeA, typename VecTypeB>
+typename std::enable_if<UseDistanceKernels<VecTypeA, VecTypeB>::value,
+    typename VecTypeA::elem_type>::type
+SquaredEuclidean(const VecTypeA& a, const VecTypeB& b)
+{
+  if (a.n_elem >= DistanceKernelMinSize && a.n_rows == b.n_rows &&
+      a.n_cols == b.n_cols)
+    return SquaredEuclideanKernel(VectorMemory(a), VectorMemory(b), a.n_elem);
+
+  return arma::accu(arma::square(a - b));
+}
+
+template<typename VecTypeA, typename VecTypeB>
+typename std::enable_if<!UseDistanceKernels<VecTypeA, VecTypeB>::value,
+    typename VecTypeA::elem_type>::type
+SquaredEuclidean(const VecTypeA& a, const VecTypeB& b)
+{
+  return arma::accu(arma::square(a - b));
+}
+
+//! Compute the Manhattan distance between two vectors, in the same way.
+template<typename VecTypeA, typename VecTypeB>
+typename std::enable_if<UseDistanceKernels<VecTypeA, VecTypeB>::value,
+    typename VecTypeA::elem_type>::type
+Manhattan(const VecTypeA& a, const VecTypeB& b)
+{
+  if (a.n_elem >= DistanceKernelMinSize && a.n_rows == b.n_rows &&
+      a.n_cols == b.n_cols)
+    return ManhattanKernel(VectorMemory(a), VectorMemory(b), a.n_elem);
+
+  return arma::accu(arma::abs(a - b));
+}
+
+template<typename VecTypeA, typename VecTypeB>
+typename std::enable_if<!UseDistanceKernels<VecTypeA, VecTypeB>::value,
+    typename VecTypeA::elem_type>::type
+Manhattan(const VecTypeA& a, const VecTypeB& b)
+{
+  return arma::accu(arma::abs(a - b));
+}
+
+} // namespace details
+
 // Unspecialized implementation.  This should almost never be used...
 template<int Power, bool TakeRoot>
 template<typename VecTypeA, typename VecTypeB>
@@ -42,7 +138,7 @@ typename VecTypeA::elem_type LMetric<1, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::accu(abs(a - b));
+  return details::Manhattan(a, b);
 }
 
 template<>
@@ -51,7 +147,7 @@ typename VecTypeA::elem_type LMetric<1, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return arma::accu(abs(a - b));
+  return details::Manhattan(a, b);
 }
 
 // L2-metric specializations.
@@ -61,7 +157,7 @@ typename VecTypeA::elem_type LMetric<2, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return sqrt(arma::accu(square(a - b)));
+  return std::sqrt(details::SquaredEuclidean(a, b));
 }
 
 template<>
@@ -70,7 +166,7 @@ typename VecTypeA::elem_type LMetric<2, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return accu(arma::square(a - b));
+  return details::SquaredEuclidean(a, b);
 }
 
 // L3-metric specialization (not very likely to be used, but just in case).
@@ -106,6 +202,99 @@ typename VecTypeA::elem_type LMetric<INT_MAX, false>::Evaluate(
   return arma::as_scalar(arma::max(arma::abs(a - b)));
 }
 
+namespace details {
+
+/**
+ * Compute the squared Euclidean distances between the columns of a and b with
+ * one matrix multiplication.  The roundoff error of each distance is relative
+ * to the norms of the points, so the distances that are too small compared to
+ * the norms (for instance, of a point and itself) are computed again exactly.
+ */
+template<typename MatTypeA, typename MatTypeB, typename ElemType>
+void SquaredEuclideanDistances(const MatTypeA& a,
+                               const MatTypeB& b,
+                               arma::Mat<ElemType>& out)
+{
+  const arma::Col<ElemType> aNorms = arma::sum(arma::square(a), 0).t();
+  const arma::Row<ElemType> bNorms = arma::sum(arma::square(b), 0);
+  const ElemType tolerance =
+      std::sqrt(std::numeric_limits<ElemType>::epsilon());
+
+  out = a.t() * b;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) out.n_cols; ++j)
+  {
+    ElemType* column = out.colptr(j);
+    for (size_t i = 0; i < out.n_rows; ++i)
+    {
+      const ElemType norms = aNorms[i] + bNorms[j];
+      column[i] = norms - ElemType(2) * column[i];
+      if (column[i] <= tolerance * norms)
+        column[i] = arma::accu(arma::square(a.col(i) - b.col(j)));
+    }
+  }
+}
+
+} // namespace details
+
+// Unspecialized batch implementation: one column of distances at a time.
+template<int Power, bool TakeRoot>
+template<typename MatTypeA, typename MatTypeB>
+void LMetric<Power, TakeRoot>::Evaluate(
+    const MatTypeA& a,
+    const MatTypeB& b,
+    arma::Mat<typename MatTypeA::elem_type>& out)
+{
+  typedef typename MatTypeA::elem_type ElemType;
+
+  // This does not copy anything if the inputs are already matrices.
+  const arma::Mat<ElemType>& aMat = a;
+  const arma::Mat<ElemType>& bMat = b;
+
+  out.set_size(aMat.n_cols, bMat.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) bMat.n_cols; ++j)
+  {
+    const arma::Mat<ElemType> differences =
+        arma::abs(aMat.each_col() - bMat.col(j));
+
+    // The compiler should optimize these conditions at compile-time.
+    if (Power == 1)
+      out.col(j) = arma::sum(differences, 0).t();
+    else if (Power == INT_MAX)
+      out.col(j) = arma::max(differences, 0).t();
+    else if (!TakeRoot)
+      out.col(j) = arma::sum(arma::pow(differences, (double) Power), 0).t();
+    else
+      out.col(j) = arma::pow(arma::sum(arma::pow(differences, (double) Power),
+          0), 1.0 / Power).t();
+  }
+}
+
+// L2-metric batch specializations.
+template<>
+template<typename MatTypeA, typename MatTypeB>
+void LMetric<2, true>::Evaluate(
+    const MatTypeA& a,
+    const MatTypeB& b,
+    arma::Mat<typename MatTypeA::elem_type>& out)
+{
+  details::SquaredEuclideanDistances(a, b, out);
+  out = arma::sqrt(out);
+}
+
+template<>
+template<typename MatTypeA, typename MatTypeB>
+void LMetric<2, false>::Evaluate(
+    const MatTypeA& a,
+    const MatTypeB& b,
+    arma::Mat<typename MatTypeA::elem_type>& out)
+{
+  details::SquaredEuclideanDistances(a, b, out);
+}
+
 } // namespace metric
 } // namespace mlpack
 
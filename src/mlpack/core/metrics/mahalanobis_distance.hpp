@@ -102,6 +102,23 @@ class MahalanobisDistance
    */
   arma::mat& Covariance() { return covariance; }
 
+  /**
+   * Compute a matrix L such that the covariance matrix is L^T L, so that the
+   * distance between two points is the Euclidean distance between the points
+   * multiplied by L.  Searches can then project their points once and use the
+   * Euclidean distance, which costs O(d) per evaluation instead of O(d^2) (and
+   * works with the kd-tree bounds).  This is the Cholesky factor of the
+   * covariance matrix if it is positive definite, and otherwise is computed
+   * from its eigendecomposition.  Only the symmetric part of the covariance
+   * matrix is used, as it is the only part the distance depends on.  If the
+   * covariance matrix has not been set, an empty matrix is returned, which
+   * stands for the identity.
+   *
+   * Throws std::invalid_argument if the covariance matrix is not square or not
+   * positive semidefinite.
+   */
+  arma::mat Transformation() const;
+
   //! Serialize the Mahalanobis distance.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
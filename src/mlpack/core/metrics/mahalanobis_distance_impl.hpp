@@ -47,6 +47,41 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   return sqrt(out[0]);
 }
 
+template<bool TakeRoot>
+arma::mat MahalanobisDistance<TakeRoot>::Transformation() const
+{
+  if (covariance.n_elem == 0)
+    return arma::mat();
+
+  if (covariance.n_rows != covariance.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "MahalanobisDistance::Transformation(): the covariance matrix is "
+        << covariance.n_rows << "x" << covariance.n_cols << ", not square";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const arma::mat symmetric = 0.5 * (covariance + covariance.t());
+
+  // The Cholesky factorization is the cheapest, when it exists.
+  arma::mat transformation;
+  if (arma::chol(transformation, symmetric))
+    return transformation;
+
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  if (!arma::eig_sym(eigenvalues, eigenvectors, symmetric) ||
+      eigenvalues.min() < -1e-10 * std::max(1.0, eigenvalues.max()))
+  {
+    throw std::invalid_argument("MahalanobisDistance::Transformation(): the "
+        "covariance matrix is not positive semidefinite");
+  }
+
+  // Rounding errors may give slightly negative eigenvalues.
+  return arma::diagmat(arma::sqrt(arma::clamp(eigenvalues, 0.0, DBL_MAX))) *
+      eigenvectors.t();
+}
+
 // Serialize the Mahalanobis distance.
 template<bool TakeRoot>
 template<typename Archive>
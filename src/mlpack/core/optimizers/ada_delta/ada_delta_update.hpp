@@ -108,6 +108,17 @@ class AdaDeltaUpdate
   //! Modify the value used to initialise the mean squared gradient parameter.
   double& Epsilon() { return epsilon; }
 
+  //! Serialize the update policy (with its state, so that an optimization
+  //! can be resumed).
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(rho);
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(meanSquaredGradient);
+    ar & BOOST_SERIALIZATION_NVP(meanSquaredGradientDx);
+  }
+
  private:
   // The smoothing parameter.
   double rho;
@@ -104,6 +104,25 @@ class AdaGrad
     return optimizer.Optimize(function, iterate);
   }
 
+  /**
+   * Optimize the given function using AdaGrad, and call the given callback at
+   * the end of each pass over the functions (see SGD::Optimize()).
+   *
+   * @tparam DecomposableFunctionType Type of the function to optimize.
+   * @tparam CallbackType Type of the callback.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callback Callback to call at each pass.
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType, typename CallbackType>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackType& callback)
+  {
+    return optimizer.Optimize(function, iterate, callback);
+  }
+
   //! Get the step size.
   double StepSize() const { return optimizer.StepSize(); }
   //! Modify the step size.
@@ -134,6 +153,20 @@ class AdaGrad
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return optimizer.Shuffle(); }
 
+  //! Get whether or not the update policy parameters are reset before
+  //! Optimize call.
+  bool ResetPolicy() const { return optimizer.ResetPolicy(); }
+  //! Modify whether or not the update policy parameters are reset before
+  //! Optimize call.
+  bool& ResetPolicy() { return optimizer.ResetPolicy(); }
+
+  //! Serialize the optimizer, with the state of its update policy.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(optimizer);
+  }
+
  private:
   //! The Stochastic Gradient Descent object with AdaGrad policy.
   SGD<AdaGradUpdate> optimizer;
@@ -84,11 +84,52 @@ class AdaGradUpdate
     iterate -= (stepSize * gradient) / (arma::sqrt(squaredGradient) + epsilon);
   }
 
+  /**
+   * Update step for SGD with a sparse gradient.  The sum of squared gradients
+   * doesn't change where the gradient is zero, so only the nonzero coordinates
+   * of the gradient are touched, and the result is the same as the dense
+   * update.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::sp_mat& gradient)
+  {
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+         it != gradient.end(); ++it)
+    {
+      const size_t i = it.row() + it.col() * iterate.n_rows;
+      squaredGradient[i] += (*it) * (*it);
+      iterate[i] -= stepSize * (*it) / (std::sqrt(squaredGradient[i]) +
+          epsilon);
+    }
+  }
+
+  /**
+   * Apply any deferred updates.  The sparse AdaGrad update never defers
+   * anything.
+   *
+   * @param iterate Parameters that minimize the function.
+   */
+  void CatchUp(arma::mat& /* iterate */) { /* Do nothing. */ }
+
   //! Get the value used to initialise the squared gradient parameter.
   double Epsilon() const { return epsilon; }
   //! Modify the value used to initialise the squared gradient parameter.
   double& Epsilon() { return epsilon; }
 
+  //! Serialize the update policy (with its state, so that an optimization
+  //! can be resumed).
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(squaredGradient);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
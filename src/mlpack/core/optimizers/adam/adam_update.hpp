@@ -72,6 +72,10 @@ class AdamUpdate
   {
     m = arma::zeros<arma::mat>(rows, cols);
     v = arma::zeros<arma::mat>(rows, cols);
+
+    // The step of the last sparse update of each coordinate is only needed
+    // for sparse gradients.
+    lastUpdate.reset();
   }
 
   /**
@@ -107,6 +111,96 @@ class AdamUpdate
         m / (arma::sqrt(v) + epsilon);
   }
 
+  /**
+   * Update step for Adam with iterates of another element type (e.g. float).
+   * The moment estimates are still kept in double precision; the squared
+   * gradients in particular would underflow in single precision.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  template<typename eT>
+  void Update(arma::Mat<eT>& iterate,
+              const double stepSize,
+              const arma::Mat<eT>& gradient)
+  {
+    const arma::mat g = arma::conv_to<arma::mat>::from(gradient);
+    ++iteration;
+
+    m *= beta1;
+    m += (1 - beta1) * g;
+
+    v *= beta2;
+    v += (1 - beta2) * (g % g);
+
+    const double biasCorrection1 = 1.0 - std::pow(beta1, iteration);
+    const double biasCorrection2 = 1.0 - std::pow(beta2, iteration);
+
+    iterate -= arma::conv_to<arma::Mat<eT>>::from(
+        (stepSize * std::sqrt(biasCorrection2) / biasCorrection1) *
+        m / (arma::sqrt(v) + epsilon));
+  }
+
+  /**
+   * Lazy update step for Adam with a sparse gradient.  Only the nonzero
+   * coordinates of the gradient are touched: the moment estimates of a
+   * coordinate that has not been seen for k steps are first decayed by
+   * \f$ beta1^k \f$ and \f$ beta2^k \f$, as the dense update would have
+   * done, and then the usual Adam step is taken.  Unlike the dense update, a
+   * coordinate does not keep moving with its (decaying) first moment on the
+   * steps where its gradient is zero.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::sp_mat& gradient)
+  {
+    if (lastUpdate.n_elem != iterate.n_elem)
+    {
+      lastUpdate.set_size(iterate.n_rows, iterate.n_cols);
+      lastUpdate.fill(iteration);
+    }
+
+    // Increment the iteration counter variable.
+    ++iteration;
+
+    const double biasCorrection1 = 1.0 - std::pow(beta1, iteration);
+    const double biasCorrection2 = 1.0 - std::pow(beta2, iteration);
+    const double scale = stepSize * std::sqrt(biasCorrection2) /
+        biasCorrection1;
+
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+         it != gradient.end(); ++it)
+    {
+      const size_t i = it.row() + it.col() * iterate.n_rows;
+      CatchUp(i, iteration - 1);
+
+      m[i] = beta1 * m[i] + (1 - beta1) * (*it);
+      v[i] = beta2 * v[i] + (1 - beta2) * (*it) * (*it);
+      iterate[i] -= scale * m[i] / (std::sqrt(v[i]) + epsilon);
+      lastUpdate[i] = iteration;
+    }
+  }
+
+  /**
+   * Apply the decay of the moment estimates that every coordinate has missed
+   * since its last sparse update.
+   *
+   * @param iterate Parameters that minimize the function.
+   */
+  void CatchUp(arma::mat& iterate)
+  {
+    if (lastUpdate.n_elem != iterate.n_elem)
+      return;
+
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+      CatchUp(i, iteration);
+  }
+
   //! Get the value used to initialise the squared gradient parameter.
   double Epsilon() const { return epsilon; }
   //! Modify the value used to initialise the squared gradient parameter.
@@ -122,7 +216,33 @@ class AdamUpdate
   //! Modify the second moment coefficient.
   double& Beta2() { return beta2; }
 
+  //! Serialize the update policy (with its state, so that an optimization
+  //! can be resumed).
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(v);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+    ar & BOOST_SERIALIZATION_NVP(lastUpdate);
+  }
+
  private:
+  //! Decay the moment estimates of coordinate i up to the given iteration.
+  void CatchUp(const size_t i, const double upTo)
+  {
+    const double steps = upTo - lastUpdate[i];
+    if (steps > 0)
+    {
+      m[i] *= std::pow(beta1, steps);
+      v[i] *= std::pow(beta2, steps);
+      lastUpdate[i] = upTo;
+    }
+  }
+
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
 
@@ -140,6 +260,9 @@ class AdamUpdate
 
   // The number of iterations.
   double iteration;
+
+  // The iteration at which each coordinate was last updated.
+  arma::mat lastUpdate;
 };
 
 } // namespace optimization
@@ -116,6 +116,20 @@ class AMSGradUpdate
   //! Modify the second moment coefficient.
   double& Beta2() { return beta2; }
 
+  //! Serialize the update policy (with its state, so that an optimization
+  //! can be resumed).
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(beta1);
+    ar & BOOST_SERIALIZATION_NVP(beta2);
+    ar & BOOST_SERIALIZATION_NVP(m);
+    ar & BOOST_SERIALIZATION_NVP(v);
+    ar & BOOST_SERIALIZATION_NVP(vImproved);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
@@ -0,0 +1,84 @@
+/**
+ * @file callback_list.hpp
+ *
+ * A callback that calls several callbacks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_CALLBACK_LIST_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_CALLBACK_LIST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "callback_monitor.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * CallbackList calls each of the given callbacks at every iteration, in order,
+ * and terminates the optimization when any of them asks to.  All of them are
+ * called even then, so that a trace also records the last iteration.  For
+ * example, to stop after a minute or when the objective stops improving,
+ *
+ * @code
+ * TimeBudget budget(60.0);
+ * ObjectivePatience patience(5);
+ * CallbackList<TimeBudget, ObjectivePatience> callbacks(budget, patience);
+ * optimizer.Optimize(f, coordinates, callbacks);
+ * @endcode
+ *
+ * The callbacks are not copied, so they must outlive the list.
+ *
+ * @tparam CallbackTypes Types of the callbacks.
+ */
+template<typename... CallbackTypes>
+class CallbackList;
+
+//! The empty list never terminates the optimization.
+template<>
+class CallbackList<>
+{
+ public:
+  bool Iteration(const arma::mat& /* coordinates */,
+                 const IterationInfo& /* info */)
+  {
+    return false;
+  }
+};
+
+template<typename CallbackType, typename... CallbackTypes>
+class CallbackList<CallbackType, CallbackTypes...>
+{
+ public:
+  /**
+   * Store the given callbacks.
+   *
+   * @param callback First callback.
+   * @param callbacks The rest of the callbacks.
+   */
+  CallbackList(CallbackType& callback, CallbackTypes&... callbacks) :
+      callback(callback),
+      rest(callbacks...)
+  { /* Nothing to do. */ }
+
+  //! Call all of the callbacks, and terminate if any of them asks to.
+  bool Iteration(const arma::mat& coordinates, const IterationInfo& info)
+  {
+    const bool terminate = callback.Iteration(coordinates, info);
+    return rest.Iteration(coordinates, info) || terminate;
+  }
+
+ private:
+  //! The first callback.
+  CallbackType& callback;
+  //! The rest of the callbacks.
+  CallbackList<CallbackTypes...> rest;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
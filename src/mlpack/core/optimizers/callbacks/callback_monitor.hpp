@@ -0,0 +1,178 @@
+/**
+ * @file callback_monitor.hpp
+ *
+ * The information passed to optimizer callbacks, the callback that does
+ * nothing, and the glue that optimizers use to call callbacks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_CALLBACK_MONITOR_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_CALLBACK_MONITOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <chrono>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * The progress of an optimizer at one of its iterations.  What an iteration
+ * is depends on the optimizer: SGD reports once per pass over the functions,
+ * SARAH once per outer iteration, L_BFGS once per line search, CMAES once per
+ * generation, SA once per sweep over the coordinates and GridSearch once per
+ * point of the grid.
+ */
+struct IterationInfo
+{
+  //! The iteration number, counted as the optimizer counts its iterations.
+  size_t iteration;
+  //! The objective at the iteration.
+  double objective;
+  //! The Frobenius norm of the (last) gradient of the iteration, or NaN for
+  //! optimizers that don't use gradients.
+  double gradientNorm;
+  //! The current step size, or NaN for optimizers that have none.
+  double stepSize;
+  //! The seconds since the optimization started.
+  double elapsed;
+};
+
+/**
+ * A callback that does nothing.  The optimizers that take callbacks use it
+ * when they are not given one, and CallbackMonitor is specialized for it so
+ * that no information is computed.
+ *
+ * Any other callback must implement
+ *
+ *   bool Iteration(const arma::mat& coordinates, const IterationInfo& info);
+ *
+ * which is called with the current coordinates at each iteration of the
+ * optimizer; returning true terminates the optimization.
+ */
+class NoCallback
+{
+ public:
+  //! Never terminate the optimization.
+  bool Iteration(const arma::mat& /* coordinates */,
+                 const IterationInfo& /* info */)
+  {
+    return false;
+  }
+};
+
+/**
+ * CallbackMonitor is what an optimizer uses to call its callback: it measures
+ * the time since it was constructed and fills in the IterationInfo.
+ *
+ * @tparam CallbackType Type of the callback.
+ */
+template<typename CallbackType>
+class CallbackMonitor
+{
+ public:
+  /**
+   * Start monitoring the optimization with the given callback.
+   *
+   * @param callback Callback to call; it must outlive the monitor.
+   */
+  CallbackMonitor(CallbackType& callback) :
+      callback(callback),
+      start(std::chrono::steady_clock::now())
+  { /* Nothing to do. */ }
+
+  /**
+   * Call the callback at an iteration, and return whether it asked to
+   * terminate the optimization.
+   *
+   * @param coordinates The current coordinates.
+   * @param iteration The iteration number.
+   * @param objective The objective at the iteration.
+   * @param gradient The gradient at the iteration (dense or sparse).
+   * @param stepSize The current step size.
+   */
+  template<typename GradType>
+  bool Iteration(const arma::mat& coordinates,
+                 const size_t iteration,
+                 const double objective,
+                 const GradType& gradient,
+                 const double stepSize)
+  {
+    IterationInfo info;
+    info.iteration = iteration;
+    info.objective = objective;
+    info.gradientNorm = arma::norm(gradient, "fro");
+    info.stepSize = stepSize;
+    info.elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    return callback.Iteration(coordinates, info);
+  }
+
+  /**
+   * Call the callback at an iteration of an optimizer that doesn't use
+   * gradients, and return whether it asked to terminate the optimization.
+   *
+   * @param coordinates The current coordinates.
+   * @param iteration The iteration number.
+   * @param objective The objective at the iteration.
+   * @param stepSize The current step size (or NaN).
+   */
+  bool Iteration(const arma::mat& coordinates,
+                 const size_t iteration,
+                 const double objective,
+                 const double stepSize)
+  {
+    IterationInfo info;
+    info.iteration = iteration;
+    info.objective = objective;
+    info.gradientNorm = std::numeric_limits<double>::quiet_NaN();
+    info.stepSize = stepSize;
+    info.elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    return callback.Iteration(coordinates, info);
+  }
+
+ private:
+  //! The callback.
+  CallbackType& callback;
+  //! When the optimization started.
+  std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * Without a callback there is nothing to measure, so this inlines to nothing.
+ */
+template<>
+class CallbackMonitor<NoCallback>
+{
+ public:
+  CallbackMonitor(NoCallback& /* callback */) { }
+
+  template<typename GradType>
+  bool Iteration(const arma::mat& /* coordinates */,
+                 const size_t /* iteration */,
+                 const double /* objective */,
+                 const GradType& /* gradient */,
+                 const double /* stepSize */)
+  {
+    return false;
+  }
+
+  bool Iteration(const arma::mat& /* coordinates */,
+                 const size_t /* iteration */,
+                 const double /* objective */,
+                 const double /* stepSize */)
+  {
+    return false;
+  }
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,22 @@
+/**
+ * @file callbacks.hpp
+ *
+ * Include all of the optimizer callbacks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_CALLBACKS_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_CALLBACKS_HPP
+
+#include "callback_monitor.hpp"
+#include "callback_list.hpp"
+#include "checkpoint.hpp"
+#include "csv_trace.hpp"
+#include "objective_patience.hpp"
+#include "time_budget.hpp"
+#include "validation_early_stop.hpp"
+
+#endif
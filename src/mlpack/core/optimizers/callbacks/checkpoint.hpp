@@ -0,0 +1,262 @@
+/**
+ * @file checkpoint.hpp
+ *
+ * A callback that periodically saves the coordinates and the state of an
+ * optimizer in the background, so that an interrupted optimization can be
+ * resumed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_CHECKPOINT_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_CHECKPOINT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/fast_binary.hpp>
+#include "callback_monitor.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Checkpoint saves the coordinates and the optimizer (with the state of its
+ * policies, such as the moment estimates of Adam and the current step size) to
+ * a file, at the first iteration that ends at least the given number of
+ * seconds after the last checkpoint.  The state is copied at the iteration,
+ * and written in the fast binary format by a background thread while the
+ * optimization goes on; it is written to a temporary file first and then
+ * renamed, so the file always holds a complete checkpoint, even if the
+ * process is killed while writing.  It never terminates the optimization.
+ *
+ * If the checkpoint file exists, Resume() restores the coordinates and the
+ * optimizer, so that the optimization continues where it stopped, with the
+ * iterations that remain.  The same code can then be run again until it
+ * finishes, for instance on a preemptible machine:
+ *
+ * @code
+ * Adam adam(0.001, 32, 0.9, 0.999, 1e-8, 1000000);
+ * Checkpoint<Adam> checkpoint("model.checkpoint", adam, 300);
+ *
+ * model.ResetParameters();
+ * checkpoint.Resume(model.Parameters());
+ * model.Train(predictors, responses, adam, checkpoint);
+ * @endcode
+ *
+ * The optimizer must be serializable and have the MaxIterations() and
+ * ResetPolicy() accessors, like SGD and the SGD variants (Adam, RMSProp,
+ * AdaGrad, AdaDelta, SMORMS3).  The callback is called at the end of each pass
+ * over the functions, so after a resume the functions are shuffled anew, and
+ * the convergence test (on the change of the objective over a pass) is first
+ * applied at the end of the second pass.
+ *
+ * Only optimizations that take callbacks can be checkpointed this way.  The
+ * factorizers of collaborative filtering (AMF with its update rules, and
+ * RegularizedSVD, whose SGD has its own Optimize() without callbacks) can't
+ * be checkpointed yet; AsyncLearning has its own checkpoints (see
+ * AsyncLearning::CheckpointFile()), since its workers update the network
+ * directly.
+ *
+ * @tparam OptimizerType Type of the optimizer.
+ */
+template<typename OptimizerType>
+class Checkpoint
+{
+ public:
+  /**
+   * Set up checkpoints of the given optimizer, which must outlive the
+   * callback.
+   *
+   * @param filename File to save the checkpoints to (it is overwritten).
+   * @param optimizer The optimizer whose state is saved.
+   * @param period Minimum number of seconds between two checkpoints (0 saves
+   *     a checkpoint at every iteration).
+   */
+  Checkpoint(const std::string& filename,
+             OptimizerType& optimizer,
+             const double period = 60.0) :
+      filename(filename),
+      optimizer(optimizer),
+      period(period),
+      lastCheckpoint(0.0),
+      offset(0),
+      checkpoints(0)
+  { /* Nothing to do. */ }
+
+  //! Wait for the last checkpoint to be written.
+  ~Checkpoint() { Wait(); }
+
+  /**
+   * Restore the coordinates and the optimizer from the checkpoint file, if it
+   * exists.  The maximum number of iterations of the optimizer is reduced by
+   * the iterations done before the checkpoint, and its policies are not reset
+   * by the next optimization.  Throws std::runtime_error if the file is
+   * invalid.
+   *
+   * @param coordinates Coordinates to restore; they must have the size of the
+   *     saved ones (such as the initialized parameters of a network), so that
+   *     any memory they share stays shared.
+   * @return false if there is no checkpoint file.
+   */
+  bool Resume(arma::mat& coordinates)
+  {
+    Wait();
+    if (!std::ifstream(filename.c_str()).good())
+      return false;
+
+    State state;
+    data::LoadFastBinary(filename, "checkpoint", state);
+    if (coordinates.n_elem != 0 && (state.coordinates.n_rows !=
+        coordinates.n_rows || state.coordinates.n_cols != coordinates.n_cols))
+    {
+      std::ostringstream oss;
+      oss << "Checkpoint::Resume(): the coordinates of '" << filename << "' "
+          << "are " << state.coordinates.n_rows << "x"
+          << state.coordinates.n_cols << ", but the given coordinates are "
+          << coordinates.n_rows << "x" << coordinates.n_cols << "!";
+      throw std::runtime_error(oss.str());
+    }
+
+    coordinates = state.coordinates;
+    optimizer = state.optimizer;
+    offset = state.iteration;
+    if (optimizer.MaxIterations() != 0)
+    {
+      optimizer.MaxIterations() = std::max(optimizer.MaxIterations(), offset +
+          1) - offset;
+    }
+    optimizer.ResetPolicy() = false;
+
+    Log::Info << "Checkpoint: resumed from '" << filename << "' after "
+        << offset << " iterations." << std::endl;
+    return true;
+  }
+
+  //! Save a checkpoint if the period has elapsed since the last one.
+  bool Iteration(const arma::mat& coordinates, const IterationInfo& info)
+  {
+    if (checkpoints > 0 && info.elapsed - lastCheckpoint < period)
+      return false;
+
+    // Copy the state now, and write it while the optimization goes on.  The
+    // copy of the optimizer counts all the iterations, including those before
+    // a resume.
+    Wait();
+    std::shared_ptr<State> state(new State(optimizer));
+    state->coordinates = coordinates;
+    state->iteration = offset + info.iteration;
+    if (state->optimizer.MaxIterations() != 0)
+      state->optimizer.MaxIterations() += offset;
+
+    writer = std::thread(&Checkpoint::Write, this, state);
+    lastCheckpoint = info.elapsed;
+    ++checkpoints;
+    return false;
+  }
+
+  //! Wait for the last checkpoint to be written, and warn if it failed.
+  void Wait()
+  {
+    if (!writer.joinable())
+      return;
+
+    writer.join();
+    if (!error.empty())
+    {
+      Log::Warn << "Checkpoint: " << error << std::endl;
+      error.clear();
+    }
+  }
+
+  //! Get the number of checkpoints saved.
+  size_t Checkpoints() const { return checkpoints; }
+
+  //! Get the number of iterations done before the checkpoint resumed from.
+  size_t ResumedIterations() const { return offset; }
+
+  //! Get the minimum number of seconds between two checkpoints.
+  double Period() const { return period; }
+  //! Modify the minimum number of seconds between two checkpoints.
+  double& Period() { return period; }
+
+ private:
+  //! The saved state of an optimization.
+  struct State
+  {
+    //! Copy the given optimizer.
+    State(const OptimizerType& optimizer = OptimizerType()) :
+        optimizer(optimizer), iteration(0) { }
+
+    //! The optimizer, with the state of its policies.
+    OptimizerType optimizer;
+    //! The coordinates.
+    arma::mat coordinates;
+    //! The number of iterations done.
+    size_t iteration;
+
+    //! Serialize the state.
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & BOOST_SERIALIZATION_NVP(optimizer);
+      ar & BOOST_SERIALIZATION_NVP(coordinates);
+      ar & BOOST_SERIALIZATION_NVP(iteration);
+    }
+  };
+
+  //! Write the given state to the file (in the background thread).
+  void Write(std::shared_ptr<State> state)
+  {
+    const std::string temporary = filename + ".tmp";
+    try
+    {
+      {
+        std::ofstream stream(temporary.c_str(), std::ios::binary);
+        if (!stream.is_open())
+          throw std::runtime_error("cannot open '" + temporary + "'");
+        data::SaveFastBinary(stream, "checkpoint", *state);
+        stream.close();
+        if (stream.fail())
+          throw std::runtime_error("cannot write '" + temporary + "'");
+      }
+
+      // Replace the last checkpoint (rename() can't replace files on Windows).
+#ifdef _WIN32
+      std::remove(filename.c_str());
+#endif
+      if (std::rename(temporary.c_str(), filename.c_str()) != 0)
+        throw std::runtime_error("cannot rename '" + temporary + "'");
+    }
+    catch (std::exception& e)
+    {
+      error = std::string("checkpoint not saved: ") + e.what() + ".";
+    }
+  }
+
+  //! The file to save the checkpoints to.
+  std::string filename;
+  //! The optimizer.
+  OptimizerType& optimizer;
+  //! The minimum number of seconds between two checkpoints.
+  double period;
+  //! When the last checkpoint was saved, in seconds.
+  double lastCheckpoint;
+  //! The number of iterations done before the checkpoint resumed from.
+  size_t offset;
+  //! The number of checkpoints saved.
+  size_t checkpoints;
+  //! The thread writing the last checkpoint.
+  std::thread writer;
+  //! The error of the last write, if it failed.
+  std::string error;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
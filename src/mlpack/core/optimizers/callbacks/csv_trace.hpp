@@ -0,0 +1,77 @@
+/**
+ * @file csv_trace.hpp
+ *
+ * A callback that writes the progress of an optimizer to a CSV file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_CSV_TRACE_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_CSV_TRACE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "callback_monitor.hpp"
+
+#include <fstream>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * CSVTrace writes one line per iteration to a CSV file, with the columns
+ * iteration, objective, gradient_norm, step_size and elapsed (in seconds), so
+ * that convergence can be plotted against time.  It never terminates the
+ * optimization.
+ *
+ * @code
+ * CSVTrace trace("sgd_trace.csv");
+ * sgd.Optimize(f, coordinates, trace);
+ * @endcode
+ */
+class CSVTrace
+{
+ public:
+  /**
+   * Open the given file and write the header.  If the file can't be opened, a
+   * warning is issued and nothing is written.
+   *
+   * @param filename File to write the trace to (it is overwritten).
+   */
+  CSVTrace(const std::string& filename) : stream(filename.c_str())
+  {
+    if (!stream.is_open())
+    {
+      Log::Warn << "CSVTrace: cannot open '" << filename << "'; no trace will "
+          << "be written." << std::endl;
+      return;
+    }
+
+    stream << "iteration,objective,gradient_norm,step_size,elapsed"
+        << std::endl;
+    stream.precision(17);
+  }
+
+  //! Write the information of an iteration.
+  bool Iteration(const arma::mat& /* coordinates */, const IterationInfo& info)
+  {
+    if (stream.is_open())
+    {
+      stream << info.iteration << "," << info.objective << ","
+          << info.gradientNorm << "," << info.stepSize << "," << info.elapsed
+          << "\n";
+    }
+
+    return false;
+  }
+
+ private:
+  //! The file the trace is written to.
+  std::ofstream stream;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
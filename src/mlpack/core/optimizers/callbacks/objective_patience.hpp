@@ -0,0 +1,91 @@
+/**
+ * @file objective_patience.hpp
+ *
+ * A callback that terminates an optimizer when its objective stops improving.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_OBJECTIVE_PATIENCE_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_OBJECTIVE_PATIENCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "callback_monitor.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * ObjectivePatience terminates the optimization when the objective reported by
+ * the optimizer hasn't improved on the best objective so far for the given
+ * number of iterations.  Unlike the tolerance of the optimizers, which compares
+ * consecutive iterations, this also stops optimizers whose objective
+ * oscillates, such as SGD with a large step size or CMAES.
+ */
+class ObjectivePatience
+{
+ public:
+  /**
+   * Set the patience.
+   *
+   * @param patience Number of iterations without improvement of the objective
+   *     after which the optimization is terminated.
+   * @param tolerance Minimum decrease of the objective that counts as an
+   *     improvement.
+   */
+  ObjectivePatience(const size_t patience = 10,
+                    const double tolerance = 0.0) :
+      patience(patience),
+      tolerance(tolerance),
+      bestObjective(std::numeric_limits<double>::max()),
+      steps(0)
+  { /* Nothing to do. */ }
+
+  //! Terminate if the objective stopped improving.
+  bool Iteration(const arma::mat& /* coordinates */, const IterationInfo& info)
+  {
+    if (info.objective < bestObjective - tolerance)
+    {
+      bestObjective = info.objective;
+      steps = 0;
+      return false;
+    }
+
+    if (++steps < patience)
+      return false;
+
+    Log::Info << "ObjectivePatience: objective has not improved for " << steps
+        << " iterations; terminating optimization." << std::endl;
+    return true;
+  }
+
+  //! Get the best objective.
+  double BestObjective() const { return bestObjective; }
+
+  //! Get the patience.
+  size_t Patience() const { return patience; }
+  //! Modify the patience.
+  size_t& Patience() { return patience; }
+
+  //! Get the tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance.
+  double& Tolerance() { return tolerance; }
+
+ private:
+  //! The number of iterations without improvement to stop after.
+  size_t patience;
+  //! The minimum decrease that counts as an improvement.
+  double tolerance;
+  //! The best objective.
+  double bestObjective;
+  //! The number of iterations since the best objective.
+  size_t steps;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file time_budget.hpp
+ *
+ * A callback that terminates an optimizer after a wall-clock budget.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_TIME_BUDGET_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_TIME_BUDGET_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "callback_monitor.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * TimeBudget terminates the optimization at the first iteration that ends
+ * after the given number of seconds since the optimization started.  The
+ * budget is only checked at the iterations of the optimizer, so the
+ * optimization may run over it by up to one iteration.
+ */
+class TimeBudget
+{
+ public:
+  /**
+   * Set the budget.
+   *
+   * @param budget Number of seconds the optimization may take.
+   */
+  TimeBudget(const double budget) : budget(budget), exceeded(false)
+  { /* Nothing to do. */ }
+
+  //! Terminate if the budget is exceeded.
+  bool Iteration(const arma::mat& /* coordinates */, const IterationInfo& info)
+  {
+    if (info.elapsed >= budget)
+    {
+      Log::Info << "TimeBudget: " << info.elapsed << " seconds elapsed; "
+          << "terminating optimization." << std::endl;
+      exceeded = true;
+    }
+
+    return exceeded;
+  }
+
+  //! Get the budget, in seconds.
+  double Budget() const { return budget; }
+  //! Modify the budget, in seconds.
+  double& Budget() { return budget; }
+
+  //! Get whether the last optimization was terminated because of the budget.
+  bool Exceeded() const { return exceeded; }
+
+ private:
+  //! The budget, in seconds.
+  double budget;
+  //! Whether the budget was exceeded.
+  bool exceeded;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file validation_early_stop.hpp
+ *
+ * A callback that terminates an optimizer when the objective on a validation
+ * function stops improving.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_CALLBACKS_VALIDATION_EARLY_STOP_HPP
+#define MLPACK_CORE_OPTIMIZERS_CALLBACKS_VALIDATION_EARLY_STOP_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "callback_monitor.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * ValidationEarlyStop evaluates a validation function at the coordinates of
+ * each iteration, and terminates the optimization when the validation
+ * objective hasn't improved for the given number of iterations.  The
+ * coordinates with the best validation objective are kept, since the
+ * optimizer returns the coordinates of its last iteration.  For example,
+ *
+ * @code
+ * LogisticRegressionFunction<> train(trainData, trainLabels, lambda);
+ * LogisticRegressionFunction<> validation(validData, validLabels, lambda);
+ * ValidationEarlyStop<LogisticRegressionFunction<>> earlyStop(validation, 3);
+ * sgd.Optimize(train, coordinates, earlyStop);
+ * coordinates = earlyStop.BestCoordinates();
+ * @endcode
+ *
+ * @tparam FunctionType Type of the validation function; it must implement
+ *     double Evaluate(const arma::mat& coordinates).
+ */
+template<typename FunctionType>
+class ValidationEarlyStop
+{
+ public:
+  /**
+   * Set the validation function.  The function is not copied, so it must
+   * outlive the callback.
+   *
+   * @param function Validation function.
+   * @param patience Number of iterations without improvement of the validation
+   *     objective after which the optimization is terminated.
+   * @param tolerance Minimum decrease of the validation objective that counts
+   *     as an improvement.
+   */
+  ValidationEarlyStop(FunctionType& function,
+                      const size_t patience = 5,
+                      const double tolerance = 0.0) :
+      function(function),
+      patience(patience),
+      tolerance(tolerance),
+      bestObjective(std::numeric_limits<double>::max()),
+      steps(0)
+  { /* Nothing to do. */ }
+
+  //! Evaluate the validation function, and terminate if it stopped improving.
+  bool Iteration(const arma::mat& coordinates, const IterationInfo& /* info */)
+  {
+    const double objective = function.Evaluate(coordinates);
+    if (objective < bestObjective - tolerance)
+    {
+      bestObjective = objective;
+      bestCoordinates = coordinates;
+      steps = 0;
+      return false;
+    }
+
+    if (++steps < patience)
+      return false;
+
+    Log::Info << "ValidationEarlyStop: validation objective has not improved "
+        << "for " << steps << " iterations; terminating optimization."
+        << std::endl;
+    return true;
+  }
+
+  //! Get the best validation objective.
+  double BestObjective() const { return bestObjective; }
+  //! Get the coordinates with the best validation objective.
+  const arma::mat& BestCoordinates() const { return bestCoordinates; }
+
+  //! Get the patience.
+  size_t Patience() const { return patience; }
+  //! Modify the patience.
+  size_t& Patience() { return patience; }
+
+  //! Get the tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance.
+  double& Tolerance() { return tolerance; }
+
+ private:
+  //! The validation function.
+  FunctionType& function;
+  //! The number of iterations without improvement to stop after.
+  size_t patience;
+  //! The minimum decrease that counts as an improvement.
+  double tolerance;
+  //! The best validation objective.
+  double bestObjective;
+  //! The coordinates with the best validation objective.
+  arma::mat bestCoordinates;
+  //! The number of iterations since the best validation objective.
+  size_t steps;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 #define MLPACK_CORE_OPTIMIZERS_CMAES_CMAES_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/callbacks/callback_monitor.hpp>
 
 #include "full_selection.hpp"
 #include "random_selection.hpp"
@@ -83,6 +84,11 @@ class CMAES
    * @param tolerance Maximum absolute tolerance to terminate algorithm.
    * @param selectionPolicy Instantiated selection policy used to calculate the
    *     objective.
+   * @param parallel If true, evaluate the candidates of each generation with
+   *     several threads.  Each candidate gets its own random number generator,
+   *     seeded from the global one, for the selection policy, so the results
+   *     don't depend on the number of threads.  The function's Evaluate() must
+   *     then be safe to call concurrently.
    */
   CMAES(const size_t lambda = 0,
         const double lowerBound = -10,
@@ -90,7 +96,8 @@ class CMAES
         const size_t batchSize = 32,
         const size_t maxIterations = 1000,
         const double tolerance = 1e-5,
-        const SelectionPolicyType& selectionPolicy = SelectionPolicyType());
+        const SelectionPolicyType& selectionPolicy = SelectionPolicyType(),
+        const bool parallel = false);
 
   /**
    * Optimize the given function using CMA-ES. The given starting point will be
@@ -105,6 +112,24 @@ class CMAES
   template<typename DecomposableFunctionType>
   double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
 
+  /**
+   * Optimize the given function using CMA-ES, and call the given callback at
+   * each generation with the best point so far, its objective and the step
+   * size sigma (see mlpack::optimization::NoCallback for the interface).  The
+   * optimization terminates when the callback returns true.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam CallbackType Type of the callback.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callback Callback to call at each generation.
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType, typename CallbackType>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackType& callback);
+
   //! Get the step size.
   size_t PopulationSize() const { return lambda; }
   //! Modify the step size.
@@ -140,6 +165,11 @@ class CMAES
   //! Modify the selection policy.
   SelectionPolicyType& SelectionPolicy() { return selectionPolicy; }
 
+  //! Get whether or not the candidates are evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not the candidates are evaluated in parallel.
+  bool& Parallel() { return parallel; }
+
  private:
   //! Population size.
   size_t lambda;
@@ -161,6 +191,9 @@ class CMAES
 
   //! The selection policy used to calculate the objective.
   SelectionPolicyType selectionPolicy;
+
+  //! Whether or not the candidates are evaluated in parallel.
+  bool parallel;
 };
 
 /**
@@ -19,6 +19,7 @@
 #include "cmaes.hpp"
 
 #include <mlpack/core/optimizers/function.hpp>
+#include <mlpack/core/math/random.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -30,14 +31,16 @@ CMAES<SelectionPolicyType>::CMAES(const size_t lambda,
                                   const size_t batchSize,
                                   const size_t maxIterations,
                                   const double tolerance,
-                                  const SelectionPolicyType& selectionPolicy) :
+                                  const SelectionPolicyType& selectionPolicy,
+                                  const bool parallel) :
     lambda(lambda),
     lowerBound(lowerBound),
     upperBound(upperBound),
     batchSize(batchSize),
     maxIterations(maxIterations),
     tolerance(tolerance),
-    selectionPolicy(selectionPolicy)
+    selectionPolicy(selectionPolicy),
+    parallel(parallel)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -45,6 +48,18 @@ template<typename SelectionPolicyType>
 template<typename DecomposableFunctionType>
 double CMAES<SelectionPolicyType>::Optimize(
     DecomposableFunctionType& function, arma::mat& iterate)
+{
+  NoCallback callback;
+  return Optimize(function, iterate, callback);
+}
+
+//! Optimize the function (minimize), calling the callback at each generation.
+template<typename SelectionPolicyType>
+template<typename DecomposableFunctionType, typename CallbackType>
+double CMAES<SelectionPolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate,
+    CallbackType& callback)
 {
   // Make sure that we have the methods that we need.  Long name...
   traits::CheckNonDifferentiableDecomposableFunctionTypeAPI<
@@ -104,6 +119,7 @@ double CMAES<SelectionPolicyType>::Optimize(
 
   double overallObjective = currentObjective;
   double lastObjective = DBL_MAX;
+  CallbackMonitor<CallbackType> monitor(callback);
 
   // Population parameters.
   arma::cube pStep(iterate.n_rows, iterate.n_cols, lambda);
@@ -148,8 +164,28 @@ double CMAES<SelectionPolicyType>::Optimize(
           pStep.slice(idx(j));
 
       // Calculate the objective function.
-      pObjective(idx(j)) = selectionPolicy.Select(function, batchSize,
-          pPosition.slice(idx(j)));
+      if (!parallel)
+      {
+        pObjective(idx(j)) = selectionPolicy.Select(function, batchSize,
+            pPosition.slice(idx(j)));
+      }
+    }
+
+    // The candidates are sampled above in the same order either way; then each
+    // one is evaluated with its own generator, seeded in candidate order.
+    if (parallel)
+    {
+      std::vector<std::mt19937::result_type> seeds(lambda);
+      for (size_t j = 0; j < lambda; ++j)
+        seeds[j] = math::randGen();
+
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t j = 0; j < (omp_size_t) lambda; ++j)
+      {
+        std::mt19937 generator(seeds[j]);
+        pObjective(j) = selectionPolicy.Select(function, batchSize,
+            pPosition.slice(j), generator);
+      }
     }
 
     // Sort population.
@@ -274,6 +310,12 @@ double CMAES<SelectionPolicyType>::Optimize(
       return overallObjective;
     }
 
+    if (monitor.Iteration(iterate, i, overallObjective, sigma(idx1)))
+    {
+      Log::Info << "CMA-ES: terminated by the callback." << std::endl;
+      return overallObjective;
+    }
+
     lastObjective = overallObjective;
   }
 
@@ -48,6 +48,25 @@ class FullSelection
 
     return objective;
   }
+
+  /**
+   * Select the full dataset to calculate the objective function.  The full
+   * selection doesn't need any randomness, so the generator is ignored.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be evaluated.
+   * @param function Function to optimize.
+   * @param batchSize Batch size to use for each step.
+   * @param iterate starting point.
+   * @param generator Random number generator of the candidate (unused).
+   */
+  template<typename DecomposableFunctionType>
+  double Select(DecomposableFunctionType& function,
+                const size_t batchSize,
+                const arma::mat& iterate,
+                std::mt19937& /* generator */)
+  {
+    return Select(function, batchSize, iterate);
+  }
 };
 
 } // namespace optimization
@@ -67,6 +67,40 @@ class RandomSelection
     return objective;
   }
 
+  /**
+   * Randomly select dataset points to calculate the objective function, with
+   * the given random number generator instead of the global one, so that
+   * candidates can be evaluated in parallel reproducibly.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be evaluated.
+   * @param function Function to optimize.
+   * @param batchSize Batch size to use for each step.
+   * @param iterate starting point.
+   * @param generator Random number generator of the candidate.
+   */
+  template<typename DecomposableFunctionType>
+  double Select(DecomposableFunctionType& function,
+                const size_t batchSize,
+                const arma::mat& iterate,
+                std::mt19937& generator)
+  {
+    // Find the number of functions to use.
+    const size_t numFunctions = function.NumFunctions();
+
+    std::uniform_int_distribution<size_t> distribution(0, numFunctions - 1);
+    double objective = 0;
+    for (size_t f = 0; f < std::floor(numFunctions * fraction); f += batchSize)
+    {
+      const size_t selection = distribution(generator);
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - selection);
+
+      objective += function.Evaluate(iterate, selection, effectiveBatchSize);
+    }
+
+    return objective;
+  }
+
  private:
   //! Dataset fraction parameter.
   double fraction;
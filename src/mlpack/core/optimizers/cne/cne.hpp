@@ -94,6 +94,11 @@ class CNE
    * @param objectiveChange Minimum change in best fitness values between two
    *     consecutive generations should be greater than threshold. If set to
    *     negative value, objectiveChange is not considered.
+   * @param parallel If true, evaluate the candidates of each generation with
+   *     several threads.  Each candidate is evaluated at its own parameters
+   *     instead of at the iterate, so the function's Evaluate() must be safe
+   *     to call concurrently and must only depend on the given parameters
+   *     (this is not the case for FFN, whose parameters are the iterate).
    */
   CNE(const size_t populationSize = 500,
       const size_t maxGenerations = 5000,
@@ -101,7 +106,8 @@ class CNE
       const double mutationSize = 0.02,
       const double selectPercent = 0.2,
       const double tolerance = 1e-5,
-      const double objectiveChange = 1e-5);
+      const double objectiveChange = 1e-5,
+      const bool parallel = false);
 
   /**
    * Optimize the given function using CNE. The given
@@ -151,6 +157,11 @@ class CNE
   //! Modify the termination criteria of change in fitness value.
   double& ObjectiveChange() { return objectiveChange; }
 
+  //! Get whether or not the candidates are evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not the candidates are evaluated in parallel.
+  bool& Parallel() { return parallel; }
+
  private:
   //! Reproduce candidates to create the next generation.
   void Reproduce();
@@ -205,6 +216,9 @@ class CNE
   //! Minimum change in best fitness values between two generations.
   double objectiveChange;
 
+  //! Whether or not the candidates are evaluated in parallel.
+  bool parallel;
+
   //! Number of candidates to become parent for the next generation.
   size_t numElite;
 
@@ -27,7 +27,8 @@ CNE::CNE(const size_t populationSize,
          const double mutationSize,
          const double selectPercent,
          const double tolerance,
-         const double objectiveChange) :
+         const double objectiveChange,
+         const bool parallel) :
     populationSize(populationSize),
     maxGenerations(maxGenerations),
     mutationProb(mutationProb),
@@ -35,6 +36,7 @@ CNE::CNE(const size_t populationSize,
     selectPercent(selectPercent),
     tolerance(tolerance),
     objectiveChange(objectiveChange),
+    parallel(parallel),
     numElite(0),
     elements(0)
 { /* Nothing to do here. */ }
@@ -90,13 +92,24 @@ double CNE::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
   for (size_t gen = 1; gen <= maxGenerations; gen++)
   {
     // Calculating fitness values of all candidates.
-    for (size_t i = 0; i < populationSize; i++)
+    if (parallel)
     {
-       // Select a candidate and insert the parameters in the function.
-       iterate = population.slice(i);
+      // Evaluating the fitness doesn't draw any random numbers, so the result
+      // doesn't depend on the number of threads.
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) populationSize; i++)
+        fitnessValues[i] = function.Evaluate(population.slice(i));
+    }
+    else
+    {
+      for (size_t i = 0; i < populationSize; i++)
+      {
+         // Select a candidate and insert the parameters in the function.
+         iterate = population.slice(i);
 
-       // Find fitness of candidate.
-       fitnessValues[i] = function.Evaluate(iterate);
+         // Find fitness of candidate.
+         fitnessValues[i] = function.Evaluate(iterate);
+      }
     }
 
     Log::Info << "Generation number: " << gen << " best fitness = "
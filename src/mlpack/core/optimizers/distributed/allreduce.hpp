@@ -0,0 +1,92 @@
+/**
+ * @file allreduce.hpp
+ *
+ * The ring allreduce of the distributed training of DistributedFunction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_ALLREDUCE_HPP
+#define MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_ALLREDUCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Sum the given array over all of the ranks of the communicator, in place,
+ * with the ring algorithm: the array is split into one chunk per rank, the
+ * chunks are summed while they travel once around the ring (reduce-scatter),
+ * and the sums travel around it once more (allgather).  Each rank sends and
+ * receives 2 (P - 1) / P times the size of the array, whatever the number P of
+ * ranks, so the time does not grow with the number of nodes.
+ *
+ * The array is reduced in buckets of the given number of elements, one ring
+ * after the other; this bounds the size of the messages and of the temporary
+ * buffer.  Every rank must call RingAllreduce() with the same size and bucket
+ * size.  The sums are added in a different order on each rank, so they may
+ * differ in the last bits between the ranks.
+ *
+ * @param communicator Communicator of this rank (see LocalCommunicator).
+ * @param data Array to sum.
+ * @param n Number of elements of the array.
+ * @param bucketSize Number of elements reduced at a time (0 for the whole
+ *     array at once).
+ */
+template<typename CommunicatorType>
+void RingAllreduce(CommunicatorType& communicator,
+                   double* data,
+                   const size_t n,
+                   const size_t bucketSize = 0)
+{
+  const size_t ranks = communicator.Size();
+  if (ranks < 2 || n == 0)
+    return;
+
+  const size_t rank = communicator.Rank();
+  const size_t next = (rank + 1) % ranks;
+  const size_t previous = (rank + ranks - 1) % ranks;
+  const size_t bucket = (bucketSize == 0) ? n : std::min(bucketSize, n);
+
+  std::vector<double> received(bucket / ranks + 1);
+  for (size_t start = 0; start < n; start += bucket)
+  {
+    double* values = data + start;
+    const size_t length = std::min(bucket, n - start);
+    auto begin = [&](const size_t chunk) { return chunk * length / ranks; };
+    auto size = [&](const size_t chunk)
+    {
+      return begin(chunk + 1) - begin(chunk);
+    };
+
+    // After step s of the reduce-scatter, the chunk (rank - s - 1) holds the
+    // sum over s + 2 ranks, so in the end chunk (rank + 1) holds the sum over
+    // all of them.
+    for (size_t step = 0; step + 1 < ranks; ++step)
+    {
+      const size_t sent = (rank + ranks - step) % ranks;
+      const size_t summed = (rank + 2 * ranks - step - 1) % ranks;
+      communicator.SendRecv(values + begin(sent), size(sent), next,
+          received.data(), size(summed), previous);
+      for (size_t i = 0; i < size(summed); ++i)
+        values[begin(summed) + i] += received[i];
+    }
+
+    // Pass the finished chunks around the ring.
+    for (size_t step = 0; step + 1 < ranks; ++step)
+    {
+      const size_t sent = (rank + 1 + ranks - step) % ranks;
+      const size_t copied = (rank + ranks - step) % ranks;
+      communicator.SendRecv(values + begin(sent), size(sent), next,
+          values + begin(copied), size(copied), previous);
+    }
+  }
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
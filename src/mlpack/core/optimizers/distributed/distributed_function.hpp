@@ -0,0 +1,211 @@
+/**
+ * @file distributed_function.hpp
+ *
+ * A wrapper that trains a decomposable function on data split between the
+ * nodes of a cluster, by summing the gradients of the nodes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_DISTRIBUTED_FUNCTION_HPP
+#define MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_DISTRIBUTED_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/function.hpp>
+
+#include "allreduce.hpp"
+#include "local_communicator.hpp"
+#include "mpi_communicator.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * DistributedFunction wraps a function of the DecomposableFunctionType API (see
+ * mlpack::optimization::SGD) whose data is one shard of a dataset split
+ * between several ranks (the processes of an MPI job with MPICommunicator, or
+ * threads with LocalCommunicator), for data-parallel training with SGD or any
+ * of its update policies, such as Adam.  Each rank runs the same optimizer on
+ * its own DistributedFunction; the gradient of every batch is averaged over
+ * the ranks with RingAllreduce(), so all the ranks take the same steps.  For
+ * example, on every process of an MPI job:
+ *
+ * @code
+ * MPICommunicator communicator;
+ * FFN<> model(...);
+ * // Load the local shard of the data.
+ * model.ResetParameters();
+ * ...
+ * DistributedFunction<FFN<>, MPICommunicator> f(model, communicator);
+ * f.Broadcast(model.Parameters());
+ * Adam adam(0.001, 32);
+ * adam.Optimize(f, model.Parameters());
+ * @endcode
+ *
+ * Each rank has to run the same number of batches of the same size, so the
+ * number of functions is the smallest number of functions of the ranks; the
+ * batches are taken from the start of each shard, and Shuffle() only shuffles
+ * the local shard (so with shuffling, all of the functions of larger shards
+ * are visited over the epochs).  The objective of a batch is averaged over the
+ * ranks too, so all the ranks see the same objective and stop at the same
+ * time.  The effective batch size is the number of ranks times the batch size
+ * of the optimizer.
+ *
+ * The gradient is reduced in buckets of a fixed number of elements, once it
+ * has been computed.
+ *
+ * @tparam FunctionType Type of the decomposable function to wrap.
+ * @tparam CommunicatorType Type of the communicator (see LocalCommunicator).
+ */
+template<typename FunctionType, typename CommunicatorType>
+class DistributedFunction
+{
+ public:
+  /**
+   * Wrap the given function.  This is a collective call: all the ranks of the
+   * communicator must construct their DistributedFunction.  Neither the
+   * function nor the communicator is copied, so they must outlive the
+   * DistributedFunction.
+   *
+   * @param function Decomposable function to wrap.
+   * @param communicator Communicator of this rank.
+   * @param bucketSize Number of elements of the gradient reduced at a time.
+   */
+  DistributedFunction(FunctionType& function,
+                      CommunicatorType& communicator,
+                      const size_t bucketSize = 262144) :
+      function(static_cast<Function<FunctionType>&>(function)),
+      communicator(communicator),
+      bucketSize(bucketSize)
+  {
+    traits::CheckDecomposableFunctionTypeAPI<Function<FunctionType>>();
+
+    // Gather the number of functions of each rank, and keep the smallest.
+    arma::vec counts(communicator.Size(), arma::fill::zeros);
+    counts[communicator.Rank()] = (double) this->function.NumFunctions();
+    RingAllreduce(communicator, counts.memptr(), counts.n_elem);
+    numFunctions = (size_t) counts.min();
+    if (numFunctions == 0)
+    {
+      throw std::invalid_argument("DistributedFunction: the shard of one of "
+          "the ranks is empty");
+    }
+  }
+
+  /**
+   * Give all the ranks the iterate of the root rank, so that they start from
+   * the same point.  This is a collective call.
+   *
+   * @param iterate Iterate to set (or to send, on the root rank).
+   * @param root Rank to take the iterate of.
+   */
+  void Broadcast(arma::mat& iterate, const size_t root = 0)
+  {
+    if (communicator.Rank() != root)
+      iterate.zeros();
+    RingAllreduce(communicator, iterate.memptr(), iterate.n_elem, bucketSize);
+  }
+
+  //! Shuffle the local shard.
+  void Shuffle() { function.Shuffle(); }
+
+  /**
+   * Evaluate the objective of a batch, averaged over the ranks.  This is a
+   * collective call.
+   *
+   * @param coordinates Point to evaluate the objective at.
+   * @param begin First function of the batch.
+   * @param batchSize Number of functions of the batch.
+   */
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t begin,
+                  const size_t batchSize)
+  {
+    return Average(function.Evaluate(coordinates, begin, batchSize));
+  }
+
+  /**
+   * Evaluate the gradient of a batch, averaged over the ranks.  This is a
+   * collective call.
+   *
+   * @param coordinates Point to evaluate the gradient at.
+   * @param begin First function of the batch.
+   * @param gradient Matrix to store the gradient in.
+   * @param batchSize Number of functions of the batch.
+   */
+  void Gradient(const arma::mat& coordinates,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize)
+  {
+    function.Gradient(coordinates, begin, gradient, batchSize);
+    Reduce(gradient);
+  }
+
+  /**
+   * Evaluate the objective and gradient of a batch, averaged over the ranks.
+   * This is a collective call.
+   *
+   * @param coordinates Point to evaluate at.
+   * @param begin First function of the batch.
+   * @param gradient Matrix to store the gradient in.
+   * @param batchSize Number of functions of the batch.
+   */
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize)
+  {
+    const double objective = function.EvaluateWithGradient(coordinates, begin,
+        gradient, batchSize);
+    Reduce(gradient);
+    return Average(objective);
+  }
+
+  //! Return the number of functions that every rank has.
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Get the communicator.
+  CommunicatorType& Communicator() const { return communicator; }
+
+  //! Get the number of elements of the gradient reduced at a time.
+  size_t BucketSize() const { return bucketSize; }
+  //! Modify the number of elements of the gradient reduced at a time.
+  size_t& BucketSize() { return bucketSize; }
+
+ private:
+  //! Average the gradient over the ranks.
+  void Reduce(arma::mat& gradient)
+  {
+    RingAllreduce(communicator, gradient.memptr(), gradient.n_elem,
+        bucketSize);
+    gradient /= (double) communicator.Size();
+  }
+
+  //! Average the objective over the ranks.
+  double Average(const double objective)
+  {
+    double sum = objective;
+    RingAllreduce(communicator, &sum, 1);
+    return sum / communicator.Size();
+  }
+
+  //! The wrapped function, with all the methods that can be derived.
+  Function<FunctionType>& function;
+
+  //! The communicator of this rank.
+  CommunicatorType& communicator;
+
+  //! The number of functions that every rank has.
+  size_t numFunctions;
+
+  //! The number of elements of the gradient reduced at a time.
+  size_t bucketSize;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
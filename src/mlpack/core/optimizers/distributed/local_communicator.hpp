@@ -0,0 +1,153 @@
+/**
+ * @file local_communicator.hpp
+ *
+ * A communicator between threads of one process, for the distributed
+ * training of DistributedFunction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_LOCAL_COMMUNICATOR_HPP
+#define MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_LOCAL_COMMUNICATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * A LocalGroup holds the mailboxes of a group of ranks that run as threads of
+ * the same process; each rank talks to the others through its own
+ * LocalCommunicator.  This behaves like an MPI communicator, so the
+ * distributed code can be run and tested without MPI, or used to split the
+ * training between the sockets of one machine.
+ */
+class LocalGroup
+{
+ public:
+  /**
+   * Create the mailboxes of a group of the given number of ranks.
+   *
+   * @param size Number of ranks.
+   */
+  LocalGroup(const size_t size) : size(size), mailboxes(size * size)
+  {
+    for (size_t i = 0; i < mailboxes.size(); ++i)
+      mailboxes[i].reset(new Mailbox());
+  }
+
+  //! Get the number of ranks.
+  size_t Size() const { return size; }
+
+ private:
+  //! The messages sent from one rank to another, in order.
+  struct Mailbox
+  {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::vector<double> > messages;
+  };
+
+  //! Get the mailbox of the messages from source to destination.
+  Mailbox& Between(const size_t source, const size_t destination)
+  {
+    return *mailboxes[source * size + destination];
+  }
+
+  //! The number of ranks.
+  size_t size;
+
+  //! The mailboxes.
+  std::vector<std::unique_ptr<Mailbox> > mailboxes;
+
+  friend class LocalCommunicator;
+};
+
+/**
+ * The communicator of one rank of a LocalGroup.  It has the interface that
+ * RingAllreduce() and DistributedFunction expect of a communicator:
+ *
+ * @code
+ * size_t Rank() const;
+ * size_t Size() const;
+ * void SendRecv(const double* send, size_t sendCount, size_t destination,
+ *               double* receive, size_t receiveCount, size_t source);
+ * @endcode
+ *
+ * SendRecv() sends a message to one rank and receives the next message of
+ * another.
+ */
+class LocalCommunicator
+{
+ public:
+  /**
+   * Create the communicator of the given rank of the group.  The group is
+   * not copied, so it must outlive the communicator.
+   */
+  LocalCommunicator(LocalGroup& group, const size_t rank) :
+      group(group), rank(rank)
+  {
+    if (rank >= group.Size())
+    {
+      throw std::invalid_argument("LocalCommunicator: rank is not smaller "
+          "than the size of the group");
+    }
+  }
+
+  //! Get the rank of this communicator.
+  size_t Rank() const { return rank; }
+
+  //! Get the number of ranks.
+  size_t Size() const { return group.Size(); }
+
+  //! Send a message to the destination and receive the next message from
+  //! the source.
+  void SendRecv(const double* send,
+                const size_t sendCount,
+                const size_t destination,
+                double* receive,
+                const size_t receiveCount,
+                const size_t source)
+  {
+    LocalGroup::Mailbox& out = group.Between(rank, destination);
+    {
+      std::lock_guard<std::mutex> lock(out.mutex);
+      out.messages.emplace_back(send, send + sendCount);
+    }
+    out.ready.notify_one();
+
+    LocalGroup::Mailbox& in = group.Between(source, rank);
+    std::unique_lock<std::mutex> lock(in.mutex);
+    in.ready.wait(lock, [&in]() { return !in.messages.empty(); });
+    const std::vector<double> message = std::move(in.messages.front());
+    in.messages.pop_front();
+    lock.unlock();
+
+    if (message.size() != receiveCount)
+    {
+      throw std::runtime_error("LocalCommunicator::SendRecv(): received a "
+          "message of another size than expected");
+    }
+
+    std::copy(message.begin(), message.end(), receive);
+  }
+
+ private:
+  //! The group of ranks.
+  LocalGroup& group;
+
+  //! The rank of this communicator.
+  size_t rank;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
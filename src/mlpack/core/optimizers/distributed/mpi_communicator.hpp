@@ -0,0 +1,90 @@
+/**
+ * @file mpi_communicator.hpp
+ *
+ * A communicator between the processes of an MPI job, for the distributed
+ * training of DistributedFunction.  It is only available if mlpack was
+ * configured with USE_MPI.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_MPI_COMMUNICATOR_HPP
+#define MLPACK_CORE_OPTIMIZERS_DISTRIBUTED_MPI_COMMUNICATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_MPI
+
+#include <mpi.h>
+#include <climits>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * The communicator of one process of an MPI communicator (by default
+ * MPI_COMM_WORLD), with the interface described in LocalCommunicator.  MPI
+ * has to be initialized before the communicator is created.
+ */
+class MPICommunicator
+{
+ public:
+  //! Create the communicator of this process in the given MPI communicator.
+  MPICommunicator(MPI_Comm communicator = MPI_COMM_WORLD) :
+      communicator(communicator)
+  {
+    int value;
+    MPI_Comm_rank(communicator, &value);
+    rank = (size_t) value;
+    MPI_Comm_size(communicator, &value);
+    size = (size_t) value;
+  }
+
+  //! Get the rank of this process.
+  size_t Rank() const { return rank; }
+
+  //! Get the number of processes.
+  size_t Size() const { return size; }
+
+  //! Send a message to the destination and receive the next message from
+  //! the source.
+  void SendRecv(const double* send,
+                const size_t sendCount,
+                const size_t destination,
+                double* receive,
+                const size_t receiveCount,
+                const size_t source)
+  {
+    if (sendCount > (size_t) INT_MAX || receiveCount > (size_t) INT_MAX)
+    {
+      throw std::invalid_argument("MPICommunicator::SendRecv(): message too "
+          "large; use a smaller bucket size");
+    }
+
+    const int result = MPI_Sendrecv(const_cast<double*>(send), (int) sendCount,
+        MPI_DOUBLE, (int) destination, 0, receive, (int) receiveCount,
+        MPI_DOUBLE, (int) source, 0, communicator, MPI_STATUS_IGNORE);
+    if (result != MPI_SUCCESS)
+      throw std::runtime_error("MPICommunicator::SendRecv(): MPI_Sendrecv() "
+          "failed");
+  }
+
+ private:
+  //! The MPI communicator.
+  MPI_Comm communicator;
+
+  //! The rank of this process.
+  size_t rank;
+
+  //! The number of processes.
+  size_t size;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif // HAS_MPI
+
+#endif
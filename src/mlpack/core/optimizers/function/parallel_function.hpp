@@ -0,0 +1,192 @@
+/**
+ * @file parallel_function.hpp
+ *
+ * A wrapper that evaluates the objective and gradient of a decomposable
+ * function over the whole dataset with several threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_FUNCTION_PARALLEL_FUNCTION_HPP
+#define MLPACK_CORE_OPTIMIZERS_FUNCTION_PARALLEL_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/function.hpp>
+
+#include <numeric>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * ParallelFunction wraps a function of the DecomposableFunctionType API (see
+ * mlpack::optimization::SGD) and provides the Evaluate(), Gradient() and
+ * EvaluateWithGradient() methods over all of the functions that batch
+ * optimizers such as L_BFGS, GradientDescent and FrankWolfe use.  The
+ * functions are split into one contiguous block per thread, the decomposable
+ * EvaluateWithGradient() (or Evaluate() and Gradient()) of each block is
+ * computed in parallel, and the objectives and gradients of the blocks are
+ * summed in order, so the result only depends on the number of threads.  For
+ * example,
+ *
+ * @code
+ * LogisticRegressionFunction<> f(data, responses, lambda);
+ * ParallelFunction<LogisticRegressionFunction<>> pf(f);
+ * L_BFGS lbfgs;
+ * lbfgs.Optimize(pf, parameters);
+ * @endcode
+ *
+ * The decomposable methods of the wrapped function are called concurrently on
+ * different blocks, so they must not modify any state of the function; this is
+ * the case for LogisticRegressionFunction, SoftmaxRegressionFunction and
+ * SoftmaxErrorFunction, for instance.  The sum of the decomposable objectives
+ * over all of the functions must also be the full objective, as it is for
+ * those functions.
+ *
+ * @tparam FunctionType Type of the decomposable function to wrap.
+ */
+template<typename FunctionType>
+class ParallelFunction
+{
+ public:
+  /**
+   * Wrap the given function.  The function is not copied, so it must outlive
+   * the ParallelFunction.
+   *
+   * @param function Decomposable function to wrap.
+   */
+  ParallelFunction(FunctionType& function) :
+      function(static_cast<Function<FunctionType>&>(function))
+  {
+    traits::CheckDecomposableFunctionTypeAPI<Function<FunctionType>>();
+  }
+
+  /**
+   * Evaluate the objective over all of the functions.
+   *
+   * @param coordinates Point to evaluate the objective at.
+   */
+  double Evaluate(const arma::mat& coordinates)
+  {
+    const size_t blocks = Blocks();
+    std::vector<double> objectives(blocks, 0.0);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      if (BlockSize(b, blocks) > 0)
+      {
+        objectives[b] = function.Evaluate(coordinates, BlockBegin(b, blocks),
+            BlockSize(b, blocks));
+      }
+    }
+
+    return std::accumulate(objectives.begin(), objectives.end(), 0.0);
+  }
+
+  /**
+   * Evaluate the gradient over all of the functions.
+   *
+   * @param coordinates Point to evaluate the gradient at.
+   * @param gradient Matrix to store the gradient in.
+   */
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient)
+  {
+    const size_t blocks = Blocks();
+    std::vector<arma::mat> gradients(blocks);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      if (BlockSize(b, blocks) > 0)
+      {
+        function.Gradient(coordinates, BlockBegin(b, blocks), gradients[b],
+            BlockSize(b, blocks));
+      }
+    }
+
+    Sum(coordinates, gradients, gradient);
+  }
+
+  /**
+   * Evaluate the objective and gradient over all of the functions.
+   *
+   * @param coordinates Point to evaluate at.
+   * @param gradient Matrix to store the gradient in.
+   */
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              arma::mat& gradient)
+  {
+    const size_t blocks = Blocks();
+    std::vector<double> objectives(blocks, 0.0);
+    std::vector<arma::mat> gradients(blocks);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      if (BlockSize(b, blocks) > 0)
+      {
+        objectives[b] = function.EvaluateWithGradient(coordinates,
+            BlockBegin(b, blocks), gradients[b], BlockSize(b, blocks));
+      }
+    }
+
+    Sum(coordinates, gradients, gradient);
+    return std::accumulate(objectives.begin(), objectives.end(), 0.0);
+  }
+
+  //! Return the number of functions.
+  size_t NumFunctions() const { return function.NumFunctions(); }
+
+  //! Get the point to start optimizing from, if the function has one.
+  arma::mat GetInitialPoint() const { return function.GetInitialPoint(); }
+
+ private:
+  //! Return the number of blocks: one per thread, but never more than there
+  //! are functions.
+  size_t Blocks() const
+  {
+    size_t threads = 1;
+    #ifdef HAS_OPENMP
+      threads = omp_get_max_threads();
+    #endif
+
+    return std::max(std::min(threads, size_t(function.NumFunctions())),
+        size_t(1));
+  }
+
+  //! Return the first function of the given block.
+  size_t BlockBegin(const size_t block, const size_t blocks) const
+  {
+    return block * function.NumFunctions() / blocks;
+  }
+
+  //! Return the number of functions in the given block.
+  size_t BlockSize(const size_t block, const size_t blocks) const
+  {
+    return BlockBegin(block + 1, blocks) - BlockBegin(block, blocks);
+  }
+
+  //! Sum the gradients of the blocks in order.
+  void Sum(const arma::mat& coordinates,
+           const std::vector<arma::mat>& gradients,
+           arma::mat& gradient) const
+  {
+    gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+    for (size_t b = 0; b < gradients.size(); ++b)
+    {
+      if (!gradients[b].is_empty())
+        gradient += gradients[b];
+    }
+  }
+
+  //! The wrapped function, with all the methods that can be derived.
+  Function<FunctionType>& function;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -163,6 +163,19 @@ struct CheckSparseGradient
       HasGradient<FunctionType, SparseGradientStaticForm>::value;
 };
 
+/**
+ * Check if the function has both dense and sparse gradients, and chooses
+ * which ones the optimizers should use at run time with SparseGradients().
+ */
+template<typename FunctionType>
+struct CheckSparseGradientsChoice
+{
+  const static bool value =
+      HasSparseGradients<FunctionType, SparseGradientsConstForm>::value &&
+      CheckSparseGradient<FunctionType>::value &&
+      CheckDecomposableGradient<FunctionType>::value;
+};
+
 /**
  * Check if a suitable overload of NumFeatures() is available.
  *
@@ -35,6 +35,8 @@ HAS_EXACT_METHOD_FORM(GradientConstraint, HasGradientConstraint);
 HAS_EXACT_METHOD_FORM(NumFeatures, HasNumFeatures);
 //! Detect a PartialGradient() method.
 HAS_EXACT_METHOD_FORM(PartialGradient, HasPartialGradient);
+//! Detect a SparseGradients() method.
+HAS_EXACT_METHOD_FORM(SparseGradients, HasSparseGradients);
 
 //! This is the form of a non-const Evaluate() method.
 template<typename FunctionType>
@@ -202,6 +204,11 @@ template<typename FunctionType>
 using SparseGradientStaticForm = void(*)(
     const arma::mat&, const size_t, arma::sp_mat&, const size_t);
 
+//! This is the form of a const SparseGradients() method, with which a function
+//! that has both dense and sparse gradients chooses one at run time.
+template<typename FunctionType>
+using SparseGradientsConstForm = bool(FunctionType::*)() const;
+
 //! This is the form of a non-const NumFeatures() method.
 template<typename FunctionType>
 using NumFeaturesForm = size_t(FunctionType::*)();
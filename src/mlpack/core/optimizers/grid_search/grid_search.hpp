@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_GRID_SEARCH_GRID_SEARCH_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/callbacks/callback_monitor.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -29,6 +30,18 @@ namespace optimization {
 class GridSearch
 {
  public:
+  /**
+   * Construct the GridSearch optimizer.
+   *
+   * @param parallel If true, evaluate the points of the grid with several
+   *     threads.  The points are evaluated in chunks of a few points per
+   *     thread, and each chunk is then gone through in the order of the serial
+   *     search, so the result (and what the callback sees) doesn't change; the
+   *     callback can only terminate the search at the end of a chunk, though.
+   *     The function's Evaluate() must be safe to call concurrently.
+   */
+  GridSearch(const bool parallel = false) : parallel(parallel) { }
+
   /**
    * Optimize (minimize) the given function by iterating through the all
    * possible combinations of values for the parameters specified in
@@ -46,22 +59,70 @@ class GridSearch
       arma::mat& bestParameters,
       data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo);
 
+  /**
+   * Optimize (minimize) the given function by iterating through the possible
+   * combinations of values for the parameters specified in datasetInfo, and
+   * call the given callback after each evaluation with the evaluated point and
+   * its objective (see mlpack::optimization::NoCallback for the interface).
+   * The search terminates, with the best point found so far, when the callback
+   * returns true.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Variable for storing results.
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @param callback Callback to call after each evaluation.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType, typename CallbackType>
+  double Optimize(
+      FunctionType& function,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+      CallbackType& callback);
+
+  //! Get whether the points of the grid are evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the points of the grid are evaluated in parallel.
+  bool& Parallel() { return parallel; }
+
  private:
+  //! Whether the points of the grid are evaluated in parallel.
+  bool parallel;
+
   /**
    * Iterate through the last (parameterValueCollections.size() - i) dimensions
    * of the grid and change the arguments bestObjective and bestParameters if
    * there is something better. The values for the first i dimensions
    * (parameters) are specified in the first i rows of the currentParameters
-   * argument.
+   * argument.  The number of evaluations so far is kept in evaluations, and
+   * true is returned if the callback asked to terminate.
    */
-  template<typename FunctionType>
-  void Optimize(
+  template<typename FunctionType, typename CallbackType>
+  bool Optimize(
       FunctionType& function,
       double& bestObjective,
       arma::mat& bestParameters,
       arma::vec& currentParameters,
       data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
-      size_t i);
+      size_t i,
+      CallbackMonitor<CallbackType>& monitor,
+      size_t& evaluations);
+
+  /**
+   * Evaluate all of the points of the grid with several threads, and change
+   * the arguments bestObjective and bestParameters if there is something
+   * better.  The number of evaluations so far is kept in evaluations, and true
+   * is returned if the callback asked to terminate.
+   */
+  template<typename FunctionType, typename CallbackType>
+  bool ParallelOptimize(
+      FunctionType& function,
+      double& bestObjective,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+      CallbackMonitor<CallbackType>& monitor,
+      size_t& evaluations);
 };
 
 } // namespace optimization
@@ -23,6 +23,17 @@ double GridSearch::Optimize(
     FunctionType& function,
     arma::mat& bestParameters,
     data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo)
+{
+  NoCallback callback;
+  return Optimize(function, bestParameters, datasetInfo, callback);
+}
+
+template<typename FunctionType, typename CallbackType>
+double GridSearch::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+    CallbackType& callback)
 {
   for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
   {
@@ -45,20 +56,32 @@ double GridSearch::Optimize(
   for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
     bestParameters(i, 0) = datasetInfo.UnmapString(0, i);
 
-  Optimize(function, bestObjective, bestParameters, currentParameters,
-      datasetInfo, 0);
+  CallbackMonitor<CallbackType> monitor(callback);
+  size_t evaluations = 0;
+  const bool terminated = parallel ?
+      ParallelOptimize(function, bestObjective, bestParameters, datasetInfo,
+          monitor, evaluations) :
+      Optimize(function, bestObjective, bestParameters, currentParameters,
+          datasetInfo, 0, monitor, evaluations);
+  if (terminated)
+  {
+    Log::Info << "GridSearch: terminated by the callback after "
+        << evaluations << " evaluations." << std::endl;
+  }
 
   return bestObjective;
 }
 
-template<typename FunctionType>
-void GridSearch::Optimize(
+template<typename FunctionType, typename CallbackType>
+bool GridSearch::Optimize(
     FunctionType& function,
     double& bestObjective,
     arma::mat& bestParameters,
     arma::vec& currentParameters,
     data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
-    size_t i)
+    size_t i,
+    CallbackMonitor<CallbackType>& monitor,
+    size_t& evaluations)
 {
   // Make sure we have the methods that we need.
   traits::CheckNonDifferentiableFunctionTypeAPI<FunctionType>();
@@ -68,8 +91,11 @@ void GridSearch::Optimize(
     for (size_t j = 0; j < datasetInfo.NumMappings(i); ++j)
     {
       currentParameters(i) = datasetInfo.UnmapString(j, i);
-      Optimize(function, bestObjective, bestParameters, currentParameters,
-          datasetInfo, i + 1);
+      if (Optimize(function, bestObjective, bestParameters, currentParameters,
+          datasetInfo, i + 1, monitor, evaluations))
+      {
+        return true;
+      }
     }
   }
   else
@@ -80,7 +106,80 @@ void GridSearch::Optimize(
       bestObjective = objective;
       bestParameters = currentParameters;
     }
+
+    return monitor.Iteration(currentParameters, evaluations++, objective,
+        std::numeric_limits<double>::quiet_NaN());
+  }
+
+  return false;
+}
+
+template<typename FunctionType, typename CallbackType>
+bool GridSearch::ParallelOptimize(
+    FunctionType& function,
+    double& bestObjective,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+    CallbackMonitor<CallbackType>& monitor,
+    size_t& evaluations)
+{
+  // Make sure we have the methods that we need.
+  traits::CheckNonDifferentiableFunctionTypeAPI<FunctionType>();
+
+  const size_t dimensionality = datasetInfo.Dimensionality();
+  size_t numPoints = 1;
+  for (size_t i = 0; i < dimensionality; ++i)
+    numPoints *= datasetInfo.NumMappings(i);
+
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+    threads = omp_get_max_threads();
+  #endif
+
+  const size_t chunkSize = 4 * threads;
+  arma::mat chunk(dimensionality, chunkSize);
+  arma::vec objectives(chunkSize);
+  for (size_t first = 0; first < numPoints; first += chunkSize)
+  {
+    // Find the points of the chunk; the last dimension changes fastest, as in
+    // the serial search.
+    const size_t chunkPoints = std::min(chunkSize, numPoints - first);
+    for (size_t p = 0; p < chunkPoints; ++p)
+    {
+      size_t index = first + p;
+      for (size_t i = dimensionality; i > 0; --i)
+      {
+        const size_t mappings = datasetInfo.NumMappings(i - 1);
+        chunk(i - 1, p) = datasetInfo.UnmapString(index % mappings, i - 1);
+        index /= mappings;
+      }
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t p = 0; p < (omp_size_t) chunkPoints; ++p)
+    {
+      const arma::vec point = chunk.col(p);
+      objectives(p) = function.Evaluate(point);
+    }
+
+    for (size_t p = 0; p < chunkPoints; ++p)
+    {
+      const arma::vec point = chunk.col(p);
+      if (objectives(p) < bestObjective)
+      {
+        bestObjective = objectives(p);
+        bestParameters = point;
+      }
+
+      if (monitor.Iteration(point, evaluations++, objectives(p),
+          std::numeric_limits<double>::quiet_NaN()))
+      {
+        return true;
+      }
+    }
   }
+
+  return false;
 }
 
 } // namespace optimization
@@ -0,0 +1,129 @@
+/**
+ * @file hyperband.hpp
+ *
+ * Hyperband optimization: successive halving with several trade-offs between
+ * the number of points and the budget of their first evaluation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_HYPERBAND_HYPERBAND_HPP
+#define MLPACK_CORE_OPTIMIZERS_HYPERBAND_HYPERBAND_HPP
+
+#include <mlpack/core.hpp>
+#include "successive_halving.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An optimizer that runs SuccessiveHalving in several brackets (Li et al.,
+ * "Hyperband: a novel bandit-based approach to hyperparameter optimization",
+ * JMLR 2018).  SuccessiveHalving has to choose between many points with a
+ * small first budget, which may drop good points whose early evaluations are
+ * noisy, and few points with a large one; Hyperband runs a bracket for each
+ * first budget eta^-s that is at least minBudget (from the smallest), and
+ * gives each bracket about the same total budget, so the last bracket is a
+ * random search of a few points with full evaluations.  The points are drawn
+ * at random from a multidimensional grid, as in RandomSearch.
+ *
+ * The function has the same requirements as for SuccessiveHalving: it needs
+ *
+ *   double Evaluate(const arma::mat& coordinates);
+ *
+ * and, to evaluate bad points cheaply,
+ *
+ *   double Evaluate(const arma::mat& coordinates, const double budget);
+ */
+class Hyperband
+{
+ public:
+  /**
+   * Construct the Hyperband optimizer.
+   *
+   * @param eta Factor by which the number of points shrinks, and the budget
+   *     grows, from one round of successive halving to the next (more than 1).
+   * @param minBudget Smallest budget of a first round, as a fraction (in
+   *     (0, 1]) of the full budget.
+   * @param parallel If true, evaluate the points of each round with several
+   *     threads.  The function's Evaluate() must be safe to call concurrently.
+   */
+  Hyperband(const double eta = 3.0,
+            const double minBudget = 1.0 / 9.0,
+            const bool parallel = false) :
+      eta(eta), minBudget(minBudget), parallel(parallel) { }
+
+  /**
+   * Optimize (minimize) the given function with each bracket of successive
+   * halving of random combinations of values for the parameters specified in
+   * datasetInfo.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Variable for storing results.
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType>
+  double Optimize(
+      FunctionType& function,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo);
+
+  /**
+   * Optimize (minimize) the given function with each bracket of successive
+   * halving of random combinations of values for the parameters specified in
+   * datasetInfo, and call the given callback after each evaluation with the
+   * evaluated point and its objective (see mlpack::optimization::NoCallback
+   * for the interface).  The search terminates, with the best point found so
+   * far, when the callback returns true.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Variable for storing results.
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @param callback Callback to call after each evaluation.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType, typename CallbackType>
+  double Optimize(
+      FunctionType& function,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+      CallbackType& callback);
+
+  //! Get the factor by which the number of points shrinks in each round.
+  double Eta() const { return eta; }
+  //! Modify the factor by which the number of points shrinks in each round.
+  double& Eta() { return eta; }
+
+  //! Get the smallest budget of a first round.
+  double MinBudget() const { return minBudget; }
+  //! Modify the smallest budget of a first round.
+  double& MinBudget() { return minBudget; }
+
+  //! Get whether the points of each round are evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the points of each round are evaluated in parallel.
+  bool& Parallel() { return parallel; }
+
+ private:
+  //! The factor by which the number of points shrinks in each round.
+  double eta;
+
+  //! The smallest budget of a first round.
+  double minBudget;
+
+  //! Whether the points of each round are evaluated in parallel.
+  bool parallel;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation
+#include "hyperband_impl.hpp"
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file hyperband_impl.hpp
+ *
+ * Implementation of Hyperband optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_HYPERBAND_HYPERBAND_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_HYPERBAND_HYPERBAND_IMPL_HPP
+
+#include <limits>
+
+// In case it hasn't been included yet.
+#include "hyperband.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename FunctionType>
+double Hyperband::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo)
+{
+  NoCallback callback;
+  return Optimize(function, bestParameters, datasetInfo, callback);
+}
+
+template<typename FunctionType, typename CallbackType>
+double Hyperband::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+    CallbackType& callback)
+{
+  if (eta <= 1.0)
+    throw std::invalid_argument("Hyperband::Optimize(): eta should be more "
+        "than 1");
+  if (minBudget <= 0.0 || minBudget > 1.0)
+    throw std::invalid_argument("Hyperband::Optimize(): minBudget should be "
+        "in (0, 1]");
+
+  // The number of rounds of the bracket with the smallest first budget is
+  // maxRounds + 1.
+  const size_t maxRounds = (size_t) std::floor(
+      std::log(1.0 / minBudget) / std::log(eta) + 1e-10);
+
+  double bestObjective = std::numeric_limits<double>::max();
+  bestParameters = RandomSearch::Sample(datasetInfo, 1, "Hyperband");
+
+  CallbackMonitor<CallbackType> monitor(callback);
+  size_t evaluations = 0;
+  for (size_t s = maxRounds + 1; s > 0; --s)
+  {
+    // Each bracket gets about (maxRounds + 1) full evaluations of budget.
+    const size_t rounds = s - 1;
+    const size_t points = (size_t) std::ceil((maxRounds + 1.0) / s *
+        std::pow(eta, (double) rounds));
+    SuccessiveHalving bracket(points, eta, std::pow(eta, -(double) rounds),
+        parallel);
+
+    // The points are drawn before they are evaluated, so that they don't
+    // depend on the order in which the threads evaluate them.
+    const arma::mat bracketPoints = RandomSearch::Sample(datasetInfo, points,
+        "Hyperband");
+    if (bracket.Optimize(function, bracketPoints, bestObjective,
+        bestParameters, monitor, evaluations))
+    {
+      Log::Info << "Hyperband: terminated by the callback after "
+          << evaluations << " evaluations." << std::endl;
+      break;
+    }
+  }
+
+  return bestObjective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
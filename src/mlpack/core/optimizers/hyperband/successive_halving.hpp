@@ -0,0 +1,175 @@
+/**
+ * @file successive_halving.hpp
+ *
+ * Successive-halving optimization, which stops the evaluation of bad points
+ * early.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_HYPERBAND_SUCCESSIVE_HALVING_HPP
+#define MLPACK_CORE_OPTIMIZERS_HYPERBAND_SUCCESSIVE_HALVING_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/callbacks/callback_monitor.hpp>
+#include <mlpack/core/optimizers/random_search/random_search.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An optimizer that draws random points from a multidimensional grid (as
+ * RandomSearch does), evaluates all of them with a small budget, and then
+ * repeatedly keeps the best 1 / eta of them and evaluates those again with
+ * eta times the budget, until the last few points are evaluated with the full
+ * budget (Jamieson and Talwalkar, "Non-stochastic best arm identification and
+ * hyperparameter optimization", AISTATS 2016).  Most of the evaluations then
+ * cost a fraction of a full one, and bad points are dropped early.
+ *
+ * For SuccessiveHalving to work, a FunctionType template parameter is
+ * required.  This class must implement the following function:
+ *
+ *   double Evaluate(const arma::mat& coordinates);
+ *
+ * and to run the early evaluations with a smaller budget it should also
+ * implement
+ *
+ *   double Evaluate(const arma::mat& coordinates, const double budget);
+ *
+ * where the budget is a fraction (in (0, 1]) of the cost of a full
+ * evaluation; with HyperParameterTuner and KFoldCV it is the fraction of the
+ * folds that are run (see KFoldCV::Folds()).  Only the objectives of full
+ * evaluations are compared to find the best point.
+ */
+class SuccessiveHalving
+{
+ public:
+  /**
+   * Construct the SuccessiveHalving optimizer.
+   *
+   * @param trials Number of points to draw (and evaluate with the smallest
+   *     budget).
+   * @param eta Factor by which the number of points shrinks, and the budget
+   *     grows, from one round to the next (more than 1).
+   * @param minBudget Budget of the first round, as a fraction (in (0, 1]) of
+   *     the full budget.
+   * @param parallel If true, evaluate the points of each round with several
+   *     threads.  The function's Evaluate() must be safe to call concurrently.
+   */
+  SuccessiveHalving(const size_t trials = 27,
+                    const double eta = 3.0,
+                    const double minBudget = 1.0 / 9.0,
+                    const bool parallel = false) :
+      trials(trials), eta(eta), minBudget(minBudget), parallel(parallel) { }
+
+  /**
+   * Optimize (minimize) the given function by successive halving of random
+   * combinations of values for the parameters specified in datasetInfo.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Variable for storing results.
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType>
+  double Optimize(
+      FunctionType& function,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo);
+
+  /**
+   * Optimize (minimize) the given function by successive halving of random
+   * combinations of values for the parameters specified in datasetInfo, and
+   * call the given callback after each evaluation with the evaluated point and
+   * its objective (see mlpack::optimization::NoCallback for the interface).
+   * The search terminates, with the best point found so far, when the callback
+   * returns true.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Variable for storing results.
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @param callback Callback to call after each evaluation.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType, typename CallbackType>
+  double Optimize(
+      FunctionType& function,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+      CallbackType& callback);
+
+  /**
+   * Run successive halving on the given points (one per column), and change
+   * bestObjective and bestParameters if a full evaluation finds something
+   * better.  The number of evaluations so far is kept in evaluations, and true
+   * is returned if the callback asked to terminate.  This is what Hyperband
+   * runs for each of its brackets.
+   */
+  template<typename FunctionType, typename CallbackType>
+  bool Optimize(FunctionType& function,
+                arma::mat points,
+                double& bestObjective,
+                arma::mat& bestParameters,
+                CallbackMonitor<CallbackType>& monitor,
+                size_t& evaluations);
+
+  //! Get the number of points to draw.
+  size_t Trials() const { return trials; }
+  //! Modify the number of points to draw.
+  size_t& Trials() { return trials; }
+
+  //! Get the factor by which the number of points shrinks in each round.
+  double Eta() const { return eta; }
+  //! Modify the factor by which the number of points shrinks in each round.
+  double& Eta() { return eta; }
+
+  //! Get the budget of the first round.
+  double MinBudget() const { return minBudget; }
+  //! Modify the budget of the first round.
+  double& MinBudget() { return minBudget; }
+
+  //! Get whether the points of each round are evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the points of each round are evaluated in parallel.
+  bool& Parallel() { return parallel; }
+
+ private:
+  //! The number of points to draw.
+  size_t trials;
+
+  //! The factor by which the number of points shrinks in each round.
+  double eta;
+
+  //! The budget of the first round.
+  double minBudget;
+
+  //! Whether the points of each round are evaluated in parallel.
+  bool parallel;
+
+  //! Evaluate the function with the given budget, if it takes one.
+  template<typename FunctionType>
+  static auto Evaluate(FunctionType& function,
+                       const arma::mat& coordinates,
+                       const double budget,
+                       int /* preferred */)
+      -> decltype(function.Evaluate(coordinates, budget));
+
+  //! Evaluate the function fully, since it doesn't take a budget.
+  template<typename FunctionType>
+  static double Evaluate(FunctionType& function,
+                         const arma::mat& coordinates,
+                         const double budget,
+                         long /* fallback */);
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation
+#include "successive_halving_impl.hpp"
+
+#endif
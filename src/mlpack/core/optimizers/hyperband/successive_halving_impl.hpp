@@ -0,0 +1,161 @@
+/**
+ * @file successive_halving_impl.hpp
+ *
+ * Implementation of successive-halving optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_HYPERBAND_SUCCESSIVE_HALVING_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_HYPERBAND_SUCCESSIVE_HALVING_IMPL_HPP
+
+#include <limits>
+#include <mlpack/core/optimizers/function.hpp>
+
+// In case it hasn't been included yet.
+#include "successive_halving.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename FunctionType>
+double SuccessiveHalving::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo)
+{
+  NoCallback callback;
+  return Optimize(function, bestParameters, datasetInfo, callback);
+}
+
+template<typename FunctionType, typename CallbackType>
+double SuccessiveHalving::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+    CallbackType& callback)
+{
+  const arma::mat points = RandomSearch::Sample(datasetInfo,
+      std::max(trials, (size_t) 1), "SuccessiveHalving");
+
+  double bestObjective = std::numeric_limits<double>::max();
+  bestParameters = points.col(0);
+
+  CallbackMonitor<CallbackType> monitor(callback);
+  size_t evaluations = 0;
+  if (Optimize(function, points, bestObjective, bestParameters, monitor,
+      evaluations))
+  {
+    Log::Info << "SuccessiveHalving: terminated by the callback after "
+        << evaluations << " evaluations." << std::endl;
+  }
+
+  return bestObjective;
+}
+
+template<typename FunctionType, typename CallbackType>
+bool SuccessiveHalving::Optimize(FunctionType& function,
+                                 arma::mat points,
+                                 double& bestObjective,
+                                 arma::mat& bestParameters,
+                                 CallbackMonitor<CallbackType>& monitor,
+                                 size_t& evaluations)
+{
+  // Make sure we have the methods that we need.
+  traits::CheckNonDifferentiableFunctionTypeAPI<FunctionType>();
+
+  if (eta <= 1.0)
+    throw std::invalid_argument("SuccessiveHalving::Optimize(): eta should "
+        "be more than 1");
+  if (minBudget <= 0.0 || minBudget > 1.0)
+    throw std::invalid_argument("SuccessiveHalving::Optimize(): minBudget "
+        "should be in (0, 1]");
+
+  // The best point of the rounds so far, in case the callback terminates the
+  // search before any full evaluation.
+  double partialObjective = std::numeric_limits<double>::max();
+  arma::vec partialParameters;
+
+  double budget = minBudget;
+  while (points.n_cols > 0)
+  {
+    // Allow for rounding in the products of eta.
+    const bool full = (budget * (1.0 + 1e-10) >= 1.0);
+    if (full)
+      budget = 1.0;
+
+    arma::vec objectives(points.n_cols);
+    #pragma omp parallel for schedule(dynamic) if (parallel)
+    for (omp_size_t p = 0; p < (omp_size_t) points.n_cols; ++p)
+    {
+      const arma::vec point = points.col(p);
+      objectives(p) = Evaluate(function, point, budget, 0);
+    }
+
+    for (size_t p = 0; p < points.n_cols; ++p)
+    {
+      const arma::vec point = points.col(p);
+      if (full && objectives(p) < bestObjective)
+      {
+        bestObjective = objectives(p);
+        bestParameters = point;
+      }
+      else if (!full && objectives(p) < partialObjective)
+      {
+        partialObjective = objectives(p);
+        partialParameters = point;
+      }
+
+      if (monitor.Iteration(point, evaluations++, objectives(p),
+          std::numeric_limits<double>::quiet_NaN()))
+      {
+        if (bestObjective == std::numeric_limits<double>::max() &&
+            partialObjective < bestObjective)
+        {
+          bestObjective = partialObjective;
+          bestParameters = partialParameters;
+        }
+
+        return true;
+      }
+    }
+
+    if (full)
+      break;
+
+    // Keep the best 1 / eta of the points for the next round.
+    const size_t keep = std::max((size_t) 1,
+        (size_t) std::floor(points.n_cols / eta));
+    const arma::uvec order = arma::stable_sort_index(objectives);
+    points = arma::mat(points.cols(order.head(keep)));
+    budget = std::min(1.0, budget * eta);
+  }
+
+  return false;
+}
+
+template<typename FunctionType>
+auto SuccessiveHalving::Evaluate(FunctionType& function,
+                                 const arma::mat& coordinates,
+                                 const double budget,
+                                 int /* preferred */)
+    -> decltype(function.Evaluate(coordinates, budget))
+{
+  return function.Evaluate(coordinates, budget);
+}
+
+template<typename FunctionType>
+double SuccessiveHalving::Evaluate(FunctionType& function,
+                                   const arma::mat& coordinates,
+                                   const double /* budget */,
+                                   long /* fallback */)
+{
+  return function.Evaluate(coordinates);
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
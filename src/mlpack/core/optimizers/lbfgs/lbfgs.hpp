@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/optimizers/function.hpp>
+#include <mlpack/core/optimizers/callbacks/callback_monitor.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -86,6 +87,25 @@ class L_BFGS
   template<typename FunctionType>
   double Optimize(FunctionType& function, arma::mat& iterate);
 
+  /**
+   * Use L-BFGS to optimize the given function, and call the given callback
+   * before each line search with the current objective, gradient and the step
+   * size of the previous line search (see mlpack::optimization::NoCallback for
+   * the interface).  The optimization terminates when the callback returns
+   * true.
+   *
+   * @tparam FunctionType Type of the function to be optimized.
+   * @tparam CallbackType Type of the callback.
+   * @param function Function to optimize; must have Evaluate() and Gradient().
+   * @param iterate Starting point (will be modified).
+   * @param callback Callback to call at each iteration.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType, typename CallbackType>
+  double Optimize(FunctionType& function,
+                  arma::mat& iterate,
+                  CallbackType& callback);
+
   //! Get the memory size.
   size_t NumBasis() const { return numBasis; }
   //! Modify the memory size.
@@ -182,7 +202,8 @@ class L_BFGS
                   arma::mat& iterate,
                   arma::mat& gradient,
                   arma::mat& newIterateTmp,
-                  const arma::mat& searchDirection);
+                  const arma::mat& searchDirection,
+                  double& stepSize);
 
   /**
    * Find the L-BFGS search direction.
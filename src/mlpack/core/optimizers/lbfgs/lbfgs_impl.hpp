@@ -39,10 +39,11 @@ bool L_BFGS::LineSearch(FunctionType& function,
                         arma::mat& iterate,
                         arma::mat& gradient,
                         arma::mat& newIterateTmp,
-                        const arma::mat& searchDirection)
+                        const arma::mat& searchDirection,
+                        double& stepSize)
 {
   // Default first step size of 1.0.
-  double stepSize = 1.0;
+  stepSize = 1.0;
 
   // The initial linear term approximation in the direction of the
   // search direction.
@@ -130,6 +131,7 @@ bool L_BFGS::LineSearch(FunctionType& function,
   }
 
   // Move to the new iterate.
+  stepSize = bestStepSize;
   iterate += bestStepSize * searchDirection;
   return true;
 }
@@ -145,6 +147,16 @@ bool L_BFGS::LineSearch(FunctionType& function,
  */
 template<typename FunctionType>
 double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
+{
+  NoCallback callback;
+  return Optimize(function, iterate, callback);
+}
+
+//! Optimize the function (minimize), calling the callback at each iteration.
+template<typename FunctionType, typename CallbackType>
+double L_BFGS::Optimize(FunctionType& function,
+                        arma::mat& iterate,
+                        CallbackType& callback)
 {
   // Use the Function<> wrapper to ensure the function has all of the functions
   // that we need.
@@ -181,6 +193,10 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
   double functionValue = f.EvaluateWithGradient(iterate, gradient);
   double prevFunctionValue = functionValue;
 
+  // The step size of the last line search.
+  double stepSize = 0.0;
+  CallbackMonitor<CallbackType> monitor(callback);
+
   // The main optimization loop.
   for (size_t itNum = 0; optimizeUntilConvergence || (itNum != maxIterations);
        ++itNum)
@@ -216,6 +232,12 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
       break;
     }
 
+    if (monitor.Iteration(iterate, itNum, functionValue, gradient, stepSize))
+    {
+      Log::Debug << "L-BFGS terminated by the callback." << std::endl;
+      break;
+    }
+
     // Choose the scaling factor.
     double scalingFactor = ChooseScalingFactor(itNum, gradient, s, y);
 
@@ -230,7 +252,7 @@ double L_BFGS::Optimize(FunctionType& function, arma::mat& iterate)
     // Do a line search and take a step.
     Timer::Start("line_search");
     if (!LineSearch(f, functionValue, iterate, gradient, newIterateTmp,
-        searchDirection))
+        searchDirection, stepSize))
     {
       Log::Debug << "Line search failed.  Stopping optimization." << std::endl;
       break; // The line search failed; nothing else to try.
@@ -53,6 +53,24 @@ namespace optimization {
  * out-param for the gradient, as ParallelSGD is only expected to be relevant in
  * situations where the computed gradient is sparse.
  *
+ * If the function has no sparse Gradient(), the DecomposableFunctionType API
+ * (see mlpack::optimization::SGD) is used instead: the functions are shuffled
+ * with Shuffle(), each thread takes a contiguous share of them, and steps with
+ * the dense gradient of each minibatch of batchSize functions of its share.
+ * These dense updates are applied without any synchronization, so threads may
+ * overwrite each other's updates; as in HOGWILD!, this is accepted in exchange
+ * for lock-free steps, and the minibatches keep the number of racing writes
+ * low.
+ *
+ * On machines with several sockets, threads on different sockets that update
+ * the same coordinates keep moving cache lines between the sockets.  To avoid
+ * this, the threads can be split into the given number of groups (e.g., one
+ * per socket), each of which updates its own replica of the parameters that is
+ * allocated by one of its threads (and so, with the usual first-touch policy,
+ * on its socket).  The replicas are averaged at the end of each iteration.
+ * OpenMP numbers threads so that consecutive threads are grouped together;
+ * bind them to the sockets in that order with, e.g., OMP_PROC_BIND=close.
+ *
  * @tparam DecayPolicyType Step size update policy used by parallel SGD
  *     to update the stepsize after each iteration.
  */
@@ -76,12 +94,18 @@ class ParallelSGD
    * @param shuffle If true, the function order is shuffled; otherwise, each
    *     function is visited in linear order.
    * @param decayPolicy The step size update policy to use.
+   * @param batchSize Number of functions in each step, for functions with
+   *     dense gradients.
+   * @param replicas Number of replicas of the parameters, to be averaged after
+   *     each iteration; e.g., the number of sockets.
   */
   ParallelSGD(const size_t maxIterations,
               const size_t threadShareSize,
               const double tolerance = 1e-5,
               const bool shuffle = true,
-              const DecayPolicyType& decayPolicy = DecayPolicyType());
+              const DecayPolicyType& decayPolicy = DecayPolicyType(),
+              const size_t batchSize = 1,
+              const size_t replicas = 1);
 
   /**
    * Optimize the given function using the parallel SGD algorithm. The given
@@ -124,7 +148,67 @@ class ParallelSGD
   //! Modify the step size decay policy.
   DecayPolicyType& DecayPolicy() { return decayPolicy; }
 
+  //! Get the number of functions in each step, for dense gradients.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of functions in each step, for dense gradients.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of replicas of the parameters.
+  size_t Replicas() const { return replicas; }
+  //! Modify the number of replicas of the parameters.
+  size_t& Replicas() { return replicas; }
+
  private:
+  /**
+   * Take the steps of one thread on the functions [begin, end) of the
+   * visitation order, with sparse gradients and atomic updates.
+   */
+  template <typename SparseFunctionType>
+  void Steps(SparseFunctionType& function,
+             arma::mat& iterate,
+             const arma::Col<size_t>& visitationOrder,
+             const size_t begin,
+             const size_t end,
+             const double stepSize,
+             std::true_type /* sparse */);
+
+  /**
+   * Take the steps of one thread on the functions [begin, end), in minibatches
+   * of dense gradients, without synchronization.
+   */
+  template <typename DecomposableFunctionType>
+  void Steps(DecomposableFunctionType& function,
+             arma::mat& iterate,
+             const arma::Col<size_t>& visitationOrder,
+             const size_t begin,
+             const size_t end,
+             const double stepSize,
+             std::false_type /* sparse */);
+
+  //! Shuffle the visitation order of the functions.
+  template <typename SparseFunctionType>
+  void ShuffleFunctions(SparseFunctionType& function,
+                        arma::Col<size_t>& visitationOrder,
+                        std::true_type /* sparse */);
+
+  //! Shuffle the functions themselves, so minibatches stay contiguous.
+  template <typename DecomposableFunctionType>
+  void ShuffleFunctions(DecomposableFunctionType& function,
+                        arma::Col<size_t>& visitationOrder,
+                        std::false_type /* sparse */);
+
+  //! Evaluate the objective of all the functions.
+  template <typename SparseFunctionType>
+  double Objective(SparseFunctionType& function,
+                   const arma::mat& iterate,
+                   std::true_type /* sparse */);
+
+  //! Evaluate the objective of all the functions.
+  template <typename DecomposableFunctionType>
+  double Objective(DecomposableFunctionType& function,
+                   const arma::mat& iterate,
+                   std::false_type /* sparse */);
+
   //! The maximum number of allowed iterations.
   size_t maxIterations;
 
@@ -140,6 +224,12 @@ class ParallelSGD
 
   //! The step size decay policy.
   DecayPolicyType decayPolicy;
+
+  //! The number of functions in each step, for dense gradients.
+  size_t batchSize;
+
+  //! The number of replicas of the parameters.
+  size_t replicas;
 };
 
 } // namespace optimization
@@ -26,12 +26,16 @@ ParallelSGD<DecayPolicyType>::ParallelSGD(
     const size_t threadShareSize,
     const double tolerance,
     const bool shuffle,
-    const DecayPolicyType& decayPolicy) :
+    const DecayPolicyType& decayPolicy,
+    const size_t batchSize,
+    const size_t replicas) :
     maxIterations(maxIterations),
     threadShareSize(threadShareSize),
     tolerance(tolerance),
     shuffle(shuffle),
-    decayPolicy(decayPolicy)
+    decayPolicy(decayPolicy),
+    batchSize(batchSize),
+    replicas(replicas)
 { /* Nothing to do. */ }
 
 template <typename DecayPolicyType>
@@ -40,8 +44,9 @@ double ParallelSGD<DecayPolicyType>::Optimize(
     SparseFunctionType& function,
     arma::mat& iterate)
 {
-  // Check that we have all the functions that we need.
-  traits::CheckSparseFunctionTypeAPI<SparseFunctionType>();
+  // Use sparse gradients whenever they are available.
+  typedef std::integral_constant<bool,
+      traits::CheckSparseGradient<SparseFunctionType>::value> IsSparse;
 
   double overallObjective = DBL_MAX;
   double lastObjective;
@@ -50,6 +55,30 @@ double ParallelSGD<DecayPolicyType>::Optimize(
   arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
       (function.NumFunctions() - 1), function.NumFunctions());
 
+  // Each group of consecutive threads updates its own replica of the
+  // parameters, which is allocated by the first thread of the group.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  const size_t numReplicas = std::max(std::min(replicas, numThreads),
+      size_t(1));
+  std::vector<arma::mat> iterateReplicas((numReplicas > 1) ? numReplicas : 0);
+  if (numReplicas > 1)
+  {
+    #pragma omp parallel num_threads(numThreads)
+    {
+      size_t threadId = 0;
+      #ifdef HAS_OPENMP
+        threadId = omp_get_thread_num();
+      #endif
+
+      const size_t replica = threadId * numReplicas / numThreads;
+      if (threadId == (replica * numThreads + numReplicas - 1) / numReplicas)
+        iterateReplicas[replica] = iterate;
+    }
+  }
+
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
   // till convergence.
@@ -58,7 +87,7 @@ double ParallelSGD<DecayPolicyType>::Optimize(
     // Calculate the overall objective.
     lastObjective = overallObjective;
 
-    overallObjective = function.Evaluate(iterate);
+    overallObjective = Objective(function, iterate, IsSparse());
 
     // Output current objective function.
     Log::Info << "Parallel SGD: iteration " << i << ", objective "
@@ -84,13 +113,9 @@ double ParallelSGD<DecayPolicyType>::Optimize(
 
     // Shuffle for uniform sampling of functions by each thread.
     if (shuffle)
-    {
-      // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
-    }
+      ShuffleFunctions(function, visitationOrder, IsSparse());
 
-    #pragma omp parallel
+    #pragma omp parallel num_threads(numThreads)
     {
       // Each processor gets a subset of the instances.
       // Each subset is of size threadShareSize
@@ -99,28 +124,29 @@ double ParallelSGD<DecayPolicyType>::Optimize(
         threadId = omp_get_thread_num();
       #endif
 
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        // Each instance affects only some components of the decision variable.
-        // So the gradient is sparse.
-        arma::sp_mat gradient;
+      arma::mat& threadIterate = (numReplicas > 1) ?
+          iterateReplicas[threadId * numReplicas / numThreads] : iterate;
+      const size_t begin = std::min(threadId * threadShareSize,
+          size_t(visitationOrder.n_elem));
+      const size_t end = std::min((threadId + 1) * threadShareSize,
+          size_t(visitationOrder.n_elem));
+      Steps(function, threadIterate, visitationOrder, begin, end, stepSize,
+          IsSparse());
 
-        // Evaluate the sparse gradient.
-        function.Gradient(iterate, visitationOrder[j], gradient, 1);
+      // Average the replicas, and start the next iteration from the average.
+      if (numReplicas > 1)
+      {
+        #pragma omp barrier
 
-        // Update the decision variable with non-zero components of the
-        // gradient.
-        for (size_t i = 0; i < gradient.n_cols; ++i)
+        #pragma omp for schedule(static)
+        for (omp_size_t k = 0; k < (omp_size_t) iterate.n_elem; ++k)
         {
-          // Iterate over the non-zero elements.
-          for (arma::sp_mat::iterator cur = gradient.begin_col(i);
-              cur != gradient.end_col(i); ++cur)
-          {
-            #pragma omp atomic
-            iterate(cur.row(), i) -= stepSize * (*cur);
-          }
+          double sum = 0.0;
+          for (size_t r = 0; r < numReplicas; ++r)
+            sum += iterateReplicas[r][k];
+          iterate[k] = sum / numReplicas;
+          for (size_t r = 0; r < numReplicas; ++r)
+            iterateReplicas[r][k] = iterate[k];
         }
       }
     }
@@ -131,6 +157,125 @@ double ParallelSGD<DecayPolicyType>::Optimize(
   return overallObjective;
 }
 
+template <typename DecayPolicyType>
+template <typename SparseFunctionType>
+void ParallelSGD<DecayPolicyType>::Steps(
+    SparseFunctionType& function,
+    arma::mat& iterate,
+    const arma::Col<size_t>& visitationOrder,
+    const size_t begin,
+    const size_t end,
+    const double stepSize,
+    std::true_type /* sparse */)
+{
+  for (size_t j = begin; j < end; ++j)
+  {
+    // Each instance affects only some components of the decision variable.
+    // So the gradient is sparse.
+    arma::sp_mat gradient;
+
+    // Evaluate the sparse gradient.
+    function.Gradient(iterate, visitationOrder[j], gradient, 1);
+
+    // Update the decision variable with non-zero components of the
+    // gradient.
+    for (size_t i = 0; i < gradient.n_cols; ++i)
+    {
+      // Iterate over the non-zero elements.
+      for (arma::sp_mat::iterator cur = gradient.begin_col(i);
+          cur != gradient.end_col(i); ++cur)
+      {
+        #pragma omp atomic
+        iterate(cur.row(), i) -= stepSize * (*cur);
+      }
+    }
+  }
+}
+
+template <typename DecayPolicyType>
+template <typename DecomposableFunctionType>
+void ParallelSGD<DecayPolicyType>::Steps(
+    DecomposableFunctionType& function,
+    arma::mat& iterate,
+    const arma::Col<size_t>& /* visitationOrder */,
+    const size_t begin,
+    const size_t end,
+    const double stepSize,
+    std::false_type /* sparse */)
+{
+  typedef Function<DecomposableFunctionType> FullFunctionType;
+  FullFunctionType& f(static_cast<FullFunctionType&>(function));
+
+  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  const size_t step = std::max(batchSize, size_t(1));
+  for (size_t j = begin; j < end; j += step)
+  {
+    // The gradient is computed from an iterate that other threads may be
+    // updating at the same time, and the update may race with theirs.
+    f.Gradient(iterate, j, gradient, std::min(step, end - j));
+    iterate -= stepSize * gradient;
+  }
+}
+
+template <typename DecayPolicyType>
+template <typename SparseFunctionType>
+void ParallelSGD<DecayPolicyType>::ShuffleFunctions(
+    SparseFunctionType& /* function */,
+    arma::Col<size_t>& visitationOrder,
+    std::true_type /* sparse */)
+{
+  // Determine order of visitation.
+  std::shuffle(visitationOrder.begin(), visitationOrder.end(),
+      mlpack::math::randGen);
+}
+
+template <typename DecayPolicyType>
+template <typename DecomposableFunctionType>
+void ParallelSGD<DecayPolicyType>::ShuffleFunctions(
+    DecomposableFunctionType& function,
+    arma::Col<size_t>& /* visitationOrder */,
+    std::false_type /* sparse */)
+{
+  // Dense minibatches need contiguous functions, so the function itself is
+  // shuffled.
+  function.Shuffle();
+}
+
+template <typename DecayPolicyType>
+template <typename SparseFunctionType>
+double ParallelSGD<DecayPolicyType>::Objective(
+    SparseFunctionType& function,
+    const arma::mat& iterate,
+    std::true_type /* sparse */)
+{
+  // Check that we have all the functions that we need.
+  traits::CheckSparseFunctionTypeAPI<SparseFunctionType>();
+
+  return function.Evaluate(iterate);
+}
+
+template <typename DecayPolicyType>
+template <typename DecomposableFunctionType>
+double ParallelSGD<DecayPolicyType>::Objective(
+    DecomposableFunctionType& function,
+    const arma::mat& iterate,
+    std::false_type /* sparse */)
+{
+  typedef Function<DecomposableFunctionType> FullFunctionType;
+  FullFunctionType& f(static_cast<FullFunctionType&>(function));
+
+  // Check that we have all the functions that we need.
+  traits::CheckDecomposableFunctionTypeAPI<FullFunctionType>();
+
+  const size_t numFunctions = f.NumFunctions();
+  const size_t step = std::max(batchSize, size_t(1));
+  double objective = 0.0;
+  for (size_t i = 0; i < numFunctions; i += step)
+    objective += f.Evaluate(iterate, i, std::min(step, numFunctions - i));
+
+  return objective;
+}
+
 } // namespace optimization
 } // namespace mlpack
 
@@ -39,6 +39,9 @@ class SparseTestFunction
   //! Return 4 (the number of features).
   size_t NumFeatures() const { return 4; }
 
+  //! Shuffle the functions; they are independent, so there is nothing to do.
+  void Shuffle() { }
+
   //! Get the starting point.
   arma::mat GetInitialPoint() const { return arma::mat("0 0 0 0;"); }
 
@@ -101,6 +104,44 @@ class SparseTestFunction
   arma::vec bi;
 };
 
+// The same function as SparseTestFunction, but with dense gradients, to test
+// the dense paths of optimizers against the sparse ones.
+class DenseGradientTestFunction
+{
+ public:
+  //! Return 4 (the number of functions).
+  size_t NumFunctions() const { return f.NumFunctions(); }
+
+  //! Shuffle the functions; they are independent, so there is nothing to do.
+  void Shuffle() { }
+
+  //! Get the starting point.
+  arma::mat GetInitialPoint() const { return f.GetInitialPoint(); }
+
+  //! Evaluate a function.
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t i,
+                  const size_t batchSize = 1) const
+  {
+    return f.Evaluate(coordinates, i, batchSize);
+  }
+
+  //! Evaluate the gradient of a function.
+  void Gradient(const arma::mat& coordinates,
+                const size_t i,
+                arma::mat& gradient,
+                const size_t batchSize = 1) const
+  {
+    arma::sp_mat sparseGradient;
+    f.Gradient(coordinates, i, sparseGradient, batchSize);
+    gradient = arma::mat(sparseGradient);
+  }
+
+ private:
+  //! The function with sparse gradients.
+  SparseTestFunction f;
+};
+
 } // namespace test
 } // namespace optimization
 } // namespace mlpack
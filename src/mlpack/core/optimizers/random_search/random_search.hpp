@@ -0,0 +1,129 @@
+/**
+ * @file random_search.hpp
+ *
+ * Random-search optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_RANDOM_SEARCH_RANDOM_SEARCH_HPP
+#define MLPACK_CORE_OPTIMIZERS_RANDOM_SEARCH_RANDOM_SEARCH_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/callbacks/callback_monitor.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An optimizer that finds the minimum of a given function by evaluating a given
+ * number of points drawn at random from a multidimensional grid, as
+ * GridSearch takes it.  When only a few of the dimensions matter, random
+ * points try many more different values of them than a grid with the same
+ * number of points (Bergstra and Bengio, "Random search for hyper-parameter
+ * optimization", JMLR 2012), so the grid can be much finer than GridSearch
+ * could afford: a hundred values for each of eight hyper-parameters is
+ * fine.  The points are drawn with mlpack::math::RandInt(), so the search is
+ * reproducible with mlpack::math::RandomSeed().
+ *
+ * For RandomSearch to work, a FunctionType template parameter is required.
+ * This class must implement the following function:
+ *
+ *   double Evaluate(const arma::mat& coordinates);
+ */
+class RandomSearch
+{
+ public:
+  /**
+   * Construct the RandomSearch optimizer.
+   *
+   * @param trials Number of points to evaluate.  The points are drawn with
+   *     replacement, so a point may be evaluated more than once (which is
+   *     cheap with HyperParameterTuner::UseCache()).
+   * @param parallel If true, evaluate the points with several threads, in
+   *     chunks of a few points per thread, as GridSearch does.  The function's
+   *     Evaluate() must be safe to call concurrently.
+   */
+  RandomSearch(const size_t trials = 100, const bool parallel = false) :
+      trials(trials), parallel(parallel) { }
+
+  /**
+   * Optimize (minimize) the given function by evaluating random combinations
+   * of values for the parameters specified in datasetInfo.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Variable for storing results.
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType>
+  double Optimize(
+      FunctionType& function,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo);
+
+  /**
+   * Optimize (minimize) the given function by evaluating random combinations
+   * of values for the parameters specified in datasetInfo, and call the given
+   * callback after each evaluation with the evaluated point and its objective
+   * (see mlpack::optimization::NoCallback for the interface).  The search
+   * terminates, with the best point found so far, when the callback returns
+   * true.
+   *
+   * @param function Function to optimize.
+   * @param bestParameters Variable for storing results.
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @param callback Callback to call after each evaluation.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType, typename CallbackType>
+  double Optimize(
+      FunctionType& function,
+      arma::mat& bestParameters,
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+      CallbackType& callback);
+
+  /**
+   * Draw the given number of random points from the grid specified by
+   * datasetInfo, one point per column.  All of the dimensions have to be
+   * categorical.
+   *
+   * @param datasetInfo Type information for each dimension of the dataset. It
+   *     should store possible values for each parameter.
+   * @param points Number of points to draw.
+   * @param optimizer Name of the optimizer, for the error message.
+   */
+  static arma::mat Sample(
+      data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+      const size_t points,
+      const std::string& optimizer = "RandomSearch");
+
+  //! Get the number of points to evaluate.
+  size_t Trials() const { return trials; }
+  //! Modify the number of points to evaluate.
+  size_t& Trials() { return trials; }
+
+  //! Get whether the points are evaluated in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the points are evaluated in parallel.
+  bool& Parallel() { return parallel; }
+
+ private:
+  //! The number of points to evaluate.
+  size_t trials;
+
+  //! Whether the points are evaluated in parallel.
+  bool parallel;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation
+#include "random_search_impl.hpp"
+
+#endif
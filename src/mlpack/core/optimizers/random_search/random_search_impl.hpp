@@ -0,0 +1,125 @@
+/**
+ * @file random_search_impl.hpp
+ *
+ * Implementation of random-search optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_RANDOM_SEARCH_RANDOM_SEARCH_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_RANDOM_SEARCH_RANDOM_SEARCH_IMPL_HPP
+
+#include <limits>
+#include <mlpack/core/optimizers/function.hpp>
+
+// In case it hasn't been included yet.
+#include "random_search.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+inline arma::mat RandomSearch::Sample(
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+    const size_t points,
+    const std::string& optimizer)
+{
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    if (datasetInfo.Type(i) != data::Datatype::categorical)
+    {
+      std::ostringstream oss;
+      oss << optimizer << "::Optimize(): the dimension " << i
+          << " is not categorical" << std::endl;
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  arma::mat samples(datasetInfo.Dimensionality(), points);
+  for (size_t p = 0; p < points; ++p)
+  {
+    for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+    {
+      samples(i, p) = datasetInfo.UnmapString(
+          math::RandInt(datasetInfo.NumMappings(i)), i);
+    }
+  }
+
+  return samples;
+}
+
+template<typename FunctionType>
+double RandomSearch::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo)
+{
+  NoCallback callback;
+  return Optimize(function, bestParameters, datasetInfo, callback);
+}
+
+template<typename FunctionType, typename CallbackType>
+double RandomSearch::Optimize(
+    FunctionType& function,
+    arma::mat& bestParameters,
+    data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
+    CallbackType& callback)
+{
+  // Make sure we have the methods that we need.
+  traits::CheckNonDifferentiableFunctionTypeAPI<FunctionType>();
+
+  // Draw all of the points first, so that they don't depend on the order in
+  // which the threads evaluate them.
+  const arma::mat points = Sample(datasetInfo, trials);
+
+  double bestObjective = std::numeric_limits<double>::max();
+  bestParameters = (trials > 0) ? arma::mat(points.col(0)) :
+      Sample(datasetInfo, 1);
+
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+    if (parallel)
+      threads = omp_get_max_threads();
+  #endif
+
+  CallbackMonitor<CallbackType> monitor(callback);
+  const size_t chunkSize = parallel ? 4 * threads : 1;
+  arma::vec objectives(chunkSize);
+  for (size_t first = 0; first < trials; first += chunkSize)
+  {
+    const size_t chunkPoints = std::min(chunkSize, trials - first);
+
+    #pragma omp parallel for schedule(dynamic) if (parallel)
+    for (omp_size_t p = 0; p < (omp_size_t) chunkPoints; ++p)
+    {
+      const arma::vec point = points.col(first + p);
+      objectives(p) = function.Evaluate(point);
+    }
+
+    for (size_t p = 0; p < chunkPoints; ++p)
+    {
+      const arma::vec point = points.col(first + p);
+      if (objectives(p) < bestObjective)
+      {
+        bestObjective = objectives(p);
+        bestParameters = point;
+      }
+
+      if (monitor.Iteration(point, first + p, objectives(p),
+          std::numeric_limits<double>::quiet_NaN()))
+      {
+        Log::Info << "RandomSearch: terminated by the callback after "
+            << first + p + 1 << " evaluations." << std::endl;
+        return bestObjective;
+      }
+    }
+  }
+
+  return bestObjective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -54,7 +54,8 @@ class RMSPropUpdate
   RMSPropUpdate(const double epsilon = 1e-8,
                 const double alpha = 0.99) :
     epsilon(epsilon),
-    alpha(alpha)
+    alpha(alpha),
+    iteration(0)
   {
     // Nothing to do.
   }
@@ -70,6 +71,11 @@ class RMSPropUpdate
   {
     // Leaky sum of squares of parameter gradient.
     meanSquaredGradient = arma::zeros<arma::mat>(rows, cols);
+
+    // The step of the last sparse update of each coordinate is only needed
+    // for sparse gradients.
+    iteration = 0;
+    lastUpdate.reset();
   }
 
   /**
@@ -89,6 +95,61 @@ class RMSPropUpdate
         epsilon);
   }
 
+  /**
+   * Update step for RMSProp with a sparse gradient.  Only the nonzero
+   * coordinates of the gradient are touched.  Where the gradient is zero, the
+   * dense update leaves the iterate alone and only decays the mean squared
+   * gradient, so a coordinate that has not been seen for k steps has its mean
+   * squared gradient decayed by \f$ alpha^k \f$ before it is updated, and the
+   * result is the same as the dense update.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::sp_mat& gradient)
+  {
+    if (lastUpdate.n_elem != iterate.n_elem)
+    {
+      lastUpdate.set_size(iterate.n_rows, iterate.n_cols);
+      lastUpdate.fill(iteration);
+    }
+
+    ++iteration;
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+         it != gradient.end(); ++it)
+    {
+      const size_t i = it.row() + it.col() * iterate.n_rows;
+      meanSquaredGradient[i] *= std::pow(alpha,
+          (double) (iteration - lastUpdate[i]));
+      meanSquaredGradient[i] += (1 - alpha) * (*it) * (*it);
+      iterate[i] -= stepSize * (*it) / (std::sqrt(meanSquaredGradient[i]) +
+          epsilon);
+      lastUpdate[i] = iteration;
+    }
+  }
+
+  /**
+   * Apply the decay of the mean squared gradient that every coordinate has
+   * missed since its last sparse update.
+   *
+   * @param iterate Parameters that minimize the function.
+   */
+  void CatchUp(arma::mat& iterate)
+  {
+    if (lastUpdate.n_elem != iterate.n_elem)
+      return;
+
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+    {
+      meanSquaredGradient[i] *= std::pow(alpha,
+          (double) (iteration - lastUpdate[i]));
+      lastUpdate[i] = iteration;
+    }
+  }
+
   //! Get the value used to initialise the squared gradient parameter.
   double Epsilon() const { return epsilon; }
   //! Modify the value used to initialise the squared gradient parameter.
@@ -99,6 +160,18 @@ class RMSPropUpdate
   //! Modify the smoothing parameter.
   double& Alpha() { return alpha; }
 
+  //! Serialize the update policy (with its state, so that an optimization
+  //! can be resumed).
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+    ar & BOOST_SERIALIZATION_NVP(meanSquaredGradient);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+    ar & BOOST_SERIALIZATION_NVP(lastUpdate);
+  }
+
  private:
   // The epsilon value used to initialise the squared gradient parameter.
   double epsilon;
@@ -108,6 +181,12 @@ class RMSPropUpdate
 
   // Leaky sum of squares of parameter gradient.
   arma::mat meanSquaredGradient;
+
+  // The number of sparse updates.
+  size_t iteration;
+
+  // The sparse update at which each coordinate was last updated.
+  arma::umat lastUpdate;
 };
 
 } // namespace optimization
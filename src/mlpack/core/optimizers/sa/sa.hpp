@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_SA_SA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/callbacks/callback_monitor.hpp>
 
 #include "exponential_schedule.hpp"
 
@@ -41,6 +42,17 @@ namespace optimization {
  * The system is considered "frozen" when its score fails to change more then
  * tolerance for maxToleranceSweep consecutive sweeps.
  *
+ * If more than one chain is requested, the chains are run in parallel (with
+ * OpenMP), each from the starting point, at the temperatures initT,
+ * initT * temperatureRatio, initT * temperatureRatio^2, and so on, all cooled
+ * by the cooling schedule.  Every swapSweeps sweeps, neighbouring chains
+ * exchange their states with the replica-exchange (parallel tempering)
+ * criterion, so that the good states found by the hot chains reach the cold
+ * ones; if swapSweeps is 0, the chains are independent.  The optimization ends
+ * when all chains are frozen or after maxIterations moves of each chain, and
+ * the best point found by any chain is returned.  In this mode the function
+ * must support concurrent calls of Evaluate().
+ *
  * For SA to work, the FunctionType template class, used by the Optimize()
  * method, must implement the following two methods:
  *
@@ -55,7 +67,8 @@ namespace optimization {
  * which returns the next temperature given current temperature and the value
  * of the function being optimized.
  *
- * @tparam CoolingScheduleType type for cooling schedule
+ * @tparam CoolingScheduleType type for cooling schedule (copied for each chain
+ *     when there are several)
  */
 template<typename CoolingScheduleType = ExponentialSchedule>
 class SA
@@ -76,6 +89,11 @@ class SA
    * @param maxMoveCoef Maximum move size.
    * @param initMoveCoef Initial move size.
    * @param gain Proportional control in feedback move control.
+   * @param chains Number of chains run in parallel (1 for the classical
+   *    algorithm).
+   * @param swapSweeps Sweeps between exchanges of the states of neighbouring
+   *    chains (0 for independent chains).
+   * @param temperatureRatio Ratio of the temperatures of neighbouring chains.
    */
   SA(CoolingScheduleType& coolingSchedule,
      const size_t maxIterations = 1000000,
@@ -86,7 +104,10 @@ class SA
      const size_t maxToleranceSweep = 3,
      const double maxMoveCoef = 20,
      const double initMoveCoef = 0.3,
-     const double gain = 0.3);
+     const double gain = 0.3,
+     const size_t chains = 1,
+     const size_t swapSweeps = 10,
+     const double temperatureRatio = 2.0);
 
   /**
    * Optimize the given function using simulated annealing. The given starting
@@ -101,6 +122,24 @@ class SA
   template<typename FunctionType>
   double Optimize(FunctionType& function, arma::mat& iterate);
 
+  /**
+   * Optimize the given function using simulated annealing, and call the given
+   * callback at the end of each sweep over the coordinates with the current
+   * energy (see mlpack::optimization::NoCallback for the interface).  The
+   * optimization terminates when the callback returns true.
+   *
+   * @tparam FunctionType Type of function to optimize.
+   * @tparam CallbackType Type of the callback.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callback Callback to call at each sweep.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType, typename CallbackType>
+  double Optimize(FunctionType& function,
+                  arma::mat& iterate,
+                  CallbackType& callback);
+
   //! Get the temperature.
   double Temperature() const { return temperature; }
   //! Modify the temperature.
@@ -136,6 +175,21 @@ class SA
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of chains.
+  size_t Chains() const { return chains; }
+  //! Modify the number of chains.
+  size_t& Chains() { return chains; }
+
+  //! Get the sweeps between exchanges of states.
+  size_t SwapSweeps() const { return swapSweeps; }
+  //! Modify the sweeps between exchanges of states.
+  size_t& SwapSweeps() { return swapSweeps; }
+
+  //! Get the ratio of the temperatures of neighbouring chains.
+  double TemperatureRatio() const { return temperatureRatio; }
+  //! Modify the ratio of the temperatures of neighbouring chains.
+  double& TemperatureRatio() { return temperatureRatio; }
+
  private:
   //! The cooling schedule being used.
   CoolingScheduleType& coolingSchedule;
@@ -157,6 +211,26 @@ class SA
   double initMoveCoef;
   //! Proportional control in feedback move control.
   double gain;
+  //! Number of chains.
+  size_t chains;
+  //! Sweeps between exchanges of the states of neighbouring chains.
+  size_t swapSweeps;
+  //! Ratio of the temperatures of neighbouring chains.
+  double temperatureRatio;
+
+  /**
+   * Run several chains in parallel, exchanging their states every swapSweeps
+   * sweeps, and return the best point found.
+   *
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callback Callback to call after each exchange.
+   * @return Objective value of the best point.
+   */
+  template<typename FunctionType, typename CallbackType>
+  double OptimizeChains(FunctionType& function,
+                        arma::mat& iterate,
+                        CallbackType& callback);
 
   /**
    * GenerateMove proposes a move on element iterate(idx), and determines if
@@ -173,6 +247,8 @@ class SA
    * @param idx Current parameter to modify.
    * @param sweepCounter Current counter representing how many sweeps have been
    *      completed.
+   * @param chainTemperature Current temperature of the chain.
+   * @param generator Random number generator of the chain.
    */
   template<typename FunctionType>
   void GenerateMove(FunctionType& function,
@@ -181,7 +257,9 @@ class SA
                     arma::mat& moveSize,
                     double& energy,
                     size_t& idx,
-                    size_t& sweepCounter);
+                    size_t& sweepCounter,
+                    const double chainTemperature,
+                    std::mt19937& generator);
 
   /**
    * MoveControl() uses a proportional feedback control to determine the size
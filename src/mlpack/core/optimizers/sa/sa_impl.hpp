@@ -29,7 +29,10 @@ SA<CoolingScheduleType>::SA(
     const size_t maxToleranceSweep,
     const double maxMoveCoef,
     const double initMoveCoef,
-    const double gain) :
+    const double gain,
+    const size_t chains,
+    const size_t swapSweeps,
+    const double temperatureRatio) :
     coolingSchedule(coolingSchedule),
     maxIterations(maxIterations),
     temperature(initT),
@@ -39,7 +42,10 @@ SA<CoolingScheduleType>::SA(
     maxToleranceSweep(maxToleranceSweep),
     maxMoveCoef(maxMoveCoef),
     initMoveCoef(initMoveCoef),
-    gain(gain)
+    gain(gain),
+    chains(chains),
+    swapSweeps(swapSweeps),
+    temperatureRatio(temperatureRatio)
 {
   // Nothing to do.
 }
@@ -49,16 +55,31 @@ template<typename CoolingScheduleType>
 template<typename FunctionType>
 double SA<CoolingScheduleType>::Optimize(FunctionType& function,
                                          arma::mat& iterate)
+{
+  NoCallback callback;
+  return Optimize(function, iterate, callback);
+}
+
+//! Optimize the function (minimize), calling the callback at each sweep.
+template<typename CoolingScheduleType>
+template<typename FunctionType, typename CallbackType>
+double SA<CoolingScheduleType>::Optimize(FunctionType& function,
+                                         arma::mat& iterate,
+                                         CallbackType& callback)
 {
   // Make sure we have the methods that we need.
   traits::CheckNonDifferentiableFunctionTypeAPI<FunctionType>();
 
+  if (chains > 1)
+    return OptimizeChains(function, iterate, callback);
+
   const size_t rows = iterate.n_rows;
   const size_t cols = iterate.n_cols;
 
   size_t frozenCount = 0;
   double energy = function.Evaluate(iterate);
   double oldEnergy = energy;
+  CallbackMonitor<CallbackType> monitor(callback);
 
   size_t idx = 0;
   size_t sweepCounter = 0;
@@ -70,14 +91,14 @@ double SA<CoolingScheduleType>::Optimize(FunctionType& function,
   // Initial moves to get rid of dependency of initial states.
   for (size_t i = 0; i < initMoves; ++i)
     GenerateMove(function, iterate, accept, moveSize, energy, idx,
-        sweepCounter);
+        sweepCounter, temperature, math::randGen);
 
   // Iterating and cooling.
   for (size_t i = 0; i != maxIterations; ++i)
   {
     oldEnergy = energy;
     GenerateMove(function, iterate, accept, moveSize, energy, idx,
-        sweepCounter);
+        sweepCounter, temperature, math::randGen);
     temperature = coolingSchedule.NextTemperature(temperature, energy);
 
     // Determine if the optimization has entered (or continues to be in) a
@@ -95,6 +116,15 @@ double SA<CoolingScheduleType>::Optimize(FunctionType& function,
           << "terminating optimization." << std::endl;
       return energy;
     }
+
+    // The index of the next move wraps around at the end of each sweep.
+    if (idx == 0 && monitor.Iteration(iterate, i, energy,
+        std::numeric_limits<double>::quiet_NaN()))
+    {
+      Log::Debug << "SA: terminated by the callback after " << i
+          << " iterations." << std::endl;
+      return energy;
+    }
   }
 
   Log::Debug << "SA: maximum iterations (" << maxIterations << ") reached; "
@@ -102,6 +132,160 @@ double SA<CoolingScheduleType>::Optimize(FunctionType& function,
   return energy;
 }
 
+//! Optimize the function (minimize) with several chains.
+template<typename CoolingScheduleType>
+template<typename FunctionType, typename CallbackType>
+double SA<CoolingScheduleType>::OptimizeChains(FunctionType& function,
+                                               arma::mat& iterate,
+                                               CallbackType& callback)
+{
+  const double initEnergy = function.Evaluate(iterate);
+  CallbackMonitor<CallbackType> monitor(callback);
+
+  // The state of each chain.  The random number generators are seeded from the
+  // mlpack generator, so the results do not depend on the number of threads.
+  std::vector<arma::mat> iterates(chains, iterate);
+  std::vector<arma::mat> accepts(chains, arma::mat(iterate.n_rows,
+      iterate.n_cols, arma::fill::zeros));
+  std::vector<arma::mat> moveSizes(chains, arma::mat(iterate.n_rows,
+      iterate.n_cols));
+  std::vector<CoolingScheduleType> schedules(chains, coolingSchedule);
+  std::vector<std::mt19937> generators(chains);
+  arma::vec energies(chains);
+  arma::vec temperatures(chains);
+  std::vector<size_t> idx(chains, 0), sweepCounters(chains, 0);
+  std::vector<size_t> frozenCounts(chains, 0);
+  std::vector<char> frozen(chains, false);
+  for (size_t c = 0; c < chains; ++c)
+  {
+    moveSizes[c].fill(initMoveCoef);
+    generators[c].seed((uint32_t) math::RandInt(
+        std::numeric_limits<int>::max()));
+    energies[c] = initEnergy;
+    temperatures[c] = temperature * std::pow(temperatureRatio, (double) c);
+  }
+
+  // The best point found by each chain.
+  std::vector<arma::mat> bestIterates(chains, iterate);
+  arma::vec bestEnergies(chains);
+  bestEnergies.fill(initEnergy);
+
+  arma::mat bestIterate(iterate);
+  double bestEnergy = initEnergy;
+
+  const size_t frozenMoves = maxToleranceSweep * moveCtrlSweep *
+      iterate.n_elem;
+  const size_t epochMoves = std::max(swapSweeps, (size_t) 1) * iterate.n_elem;
+  size_t swaps = 0, swapTrials = 0;
+  size_t epoch = 0;
+  for (size_t i = 0; maxIterations == 0 || i < maxIterations; ++epoch)
+  {
+    const size_t moves = (maxIterations == 0) ? epochMoves :
+        std::min(epochMoves, maxIterations - i);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) chains; ++c)
+    {
+      // Initial moves to get rid of dependency of initial states.
+      if (epoch == 0)
+      {
+        for (size_t m = 0; m < initMoves; ++m)
+        {
+          GenerateMove(function, iterates[c], accepts[c], moveSizes[c],
+              energies[c], idx[c], sweepCounters[c], temperatures[c],
+              generators[c]);
+        }
+      }
+
+      for (size_t m = 0; m < moves && !frozen[c]; ++m)
+      {
+        const double oldEnergy = energies[c];
+        GenerateMove(function, iterates[c], accepts[c], moveSizes[c],
+            energies[c], idx[c], sweepCounters[c], temperatures[c],
+            generators[c]);
+        temperatures[c] = schedules[c].NextTemperature(temperatures[c],
+            energies[c]);
+
+        if (energies[c] < bestEnergies[c])
+        {
+          bestEnergies[c] = energies[c];
+          bestIterates[c] = iterates[c];
+        }
+
+        if (std::abs(energies[c] - oldEnergy) < tolerance)
+          ++frozenCounts[c];
+        else
+          frozenCounts[c] = 0;
+
+        if (frozenCounts[c] >= frozenMoves)
+          frozen[c] = true;
+      }
+    }
+    i += moves;
+
+    for (size_t c = 0; c < chains; ++c)
+    {
+      if (bestEnergies[c] < bestEnergy)
+      {
+        bestEnergy = bestEnergies[c];
+        bestIterate = bestIterates[c];
+      }
+    }
+
+    // Exchange the states of neighbouring chains that are still running, with
+    // probability min{1, exp((E_c - E_{c + 1}) (1 / T_c - 1 / T_{c + 1}))},
+    // alternating between the even and the odd pairs.
+    if (swapSweeps > 0)
+    {
+      for (size_t c = epoch % 2; c + 1 < chains; c += 2)
+      {
+        if (frozen[c] || frozen[c + 1])
+          continue;
+
+        ++swapTrials;
+        const double exponent = (energies[c] - energies[c + 1]) *
+            (1.0 / temperatures[c] - 1.0 / temperatures[c + 1]);
+        if (exponent >= 0.0 || math::Random() < std::exp(exponent))
+        {
+          std::swap(iterates[c], iterates[c + 1]);
+          std::swap(energies[c], energies[c + 1]);
+          frozenCounts[c] = 0;
+          frozenCounts[c + 1] = 0;
+          ++swaps;
+        }
+      }
+    }
+
+    if (std::find(frozen.begin(), frozen.end(), false) == frozen.end())
+    {
+      Log::Debug << "SA: all " << chains << " chains minimized within "
+          << "tolerance " << tolerance << " for " << maxToleranceSweep
+          << " sweeps after " << i << " iterations; terminating "
+          << "optimization." << std::endl;
+      break;
+    }
+
+    if (monitor.Iteration(bestIterate, i, bestEnergy,
+        std::numeric_limits<double>::quiet_NaN()))
+    {
+      Log::Debug << "SA: terminated by the callback after " << i
+          << " iterations." << std::endl;
+      break;
+    }
+  }
+
+  if (swapTrials > 0)
+  {
+    Log::Info << "SA: " << swaps << " of " << swapTrials << " exchanges "
+        << "between chains accepted." << std::endl;
+  }
+
+  // The coldest chain continues the cooling of a later call.
+  temperature = temperatures[0];
+  iterate = bestIterate;
+  return bestEnergy;
+}
+
 /**
  * GenerateMove proposes a move on element iterate(idx), and determines
  * it that move is acceptable or not according to the Metropolis criterion.
@@ -119,7 +303,9 @@ void SA<CoolingScheduleType>::GenerateMove(
     arma::mat& moveSize,
     double& energy,
     size_t& idx,
-    size_t& sweepCounter)
+    size_t& sweepCounter,
+    const double chainTemperature,
+    std::mt19937& generator)
 {
   const double prevEnergy = energy;
   const double prevValue = iterate(idx);
@@ -129,7 +315,8 @@ void SA<CoolingScheduleType>::GenerateMove(
   // MoveControl() is derived for the Laplace distribution.
 
   // Sample from a Laplace distribution with scale parameter moveSize(idx).
-  const double unif = 2.0 * math::Random() - 1.0;
+  std::uniform_real_distribution<> random;
+  const double unif = 2.0 * random(generator) - 1.0;
   const double move = (unif < 0) ? (moveSize(idx) * std::log(1 + unif)) :
       (-moveSize(idx) * std::log(1 - unif));
 
@@ -137,9 +324,9 @@ void SA<CoolingScheduleType>::GenerateMove(
   energy = function.Evaluate(iterate);
   // According to the Metropolis criterion, accept the move with probability
   // min{1, exp(-(E_new - E_old) / T)}.
-  const double xi = math::Random();
+  const double xi = random(generator);
   const double delta = energy - prevEnergy;
-  const double criterion = std::exp(-delta / temperature);
+  const double criterion = std::exp(-delta / chainTemperature);
   if (delta <= 0. || criterion > xi)
   {
     accept(idx) += 1.;
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_OPTIMIZERS_SARAH_SARAH_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/callbacks/callback_monitor.hpp>
 
 #include "sarah_update.hpp"
 #include "sarah_plus_update.hpp"
@@ -86,6 +87,10 @@ class SARAHType
    *     function is visited in linear order.
    * @param updatePolicy Instantiated update policy used to adjust the given
    *     parameters.
+   * @param parallel If true, compute the objective and full gradient with
+   *     several threads, and split the inner iterations between threads that
+   *     step on the shared iterate without synchronization.  The function's
+   *     Evaluate() and Gradient() must then be safe to call concurrently.
    */
   SARAHType(const double stepSize = 0.01,
             const size_t batchSize = 32,
@@ -93,7 +98,8 @@ class SARAHType
             const size_t innerIterations = 0,
             const double tolerance = 1e-5,
             const bool shuffle = true,
-            const UpdatePolicyType& updatePolicy = UpdatePolicyType());
+            const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+            const bool parallel = false);
 
   /**
    * Optimize the given function using SARAH. The given starting point will be
@@ -108,6 +114,24 @@ class SARAHType
   template<typename DecomposableFunctionType>
   double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
 
+  /**
+   * Optimize the given function using SARAH, and call the given callback at
+   * each outer iteration with the objective and the full gradient, before the
+   * step is taken (see mlpack::optimization::NoCallback for the interface).
+   * The optimization terminates when the callback returns true.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam CallbackType Type of the callback.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callback Callback to call at each outer iteration.
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType, typename CallbackType>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackType& callback);
+
   //! Get the step size.
   double StepSize() const { return stepSize; }
   //! Modify the step size.
@@ -138,6 +162,11 @@ class SARAHType
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return shuffle; }
 
+  //! Get whether or not the gradients are computed with several threads.
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not the gradients are computed with several threads.
+  bool& Parallel() { return parallel; }
+
   //! Get the update policy.
   const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
   //! Modify the update policy.
@@ -165,6 +194,9 @@ class SARAHType
 
   //! The update policy used to update the parameters in each iteration.
   UpdatePolicyType updatePolicy;
+
+  //! Controls whether or not the gradients are computed with several threads.
+  bool parallel;
 };
 
 // Convenience typedefs.
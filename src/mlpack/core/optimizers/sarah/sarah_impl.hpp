@@ -16,6 +16,7 @@
 #include "sarah.hpp"
 
 #include <mlpack/core/optimizers/function.hpp>
+#include <mlpack/core/optimizers/function/parallel_function.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -28,14 +29,16 @@ SARAHType<UpdatePolicyType>::SARAHType(
     const size_t innerIterations,
     const double tolerance,
     const bool shuffle,
-    const UpdatePolicyType& updatePolicy) :
+    const UpdatePolicyType& updatePolicy,
+    const bool parallel) :
     stepSize(stepSize),
     batchSize(batchSize),
     maxIterations(maxIterations),
     innerIterations(innerIterations),
     tolerance(tolerance),
     shuffle(shuffle),
-    updatePolicy(updatePolicy)
+    updatePolicy(updatePolicy),
+    parallel(parallel)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -43,15 +46,31 @@ template<typename UpdatePolicyType>
 template<typename DecomposableFunctionType>
 double SARAHType<UpdatePolicyType>::Optimize(
     DecomposableFunctionType& function, arma::mat& iterate)
+{
+  NoCallback callback;
+  return Optimize(function, iterate, callback);
+}
+
+//! Optimize the function (minimize), calling the callback at each iteration.
+template<typename UpdatePolicyType>
+template<typename DecomposableFunctionType, typename CallbackType>
+double SARAHType<UpdatePolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate,
+    CallbackType& callback)
 {
   traits::CheckDecomposableFunctionTypeAPI<DecomposableFunctionType>();
 
   // Find the number of functions to use.
   const size_t numFunctions = function.NumFunctions();
 
+  // This computes the objective and the full gradient with several threads.
+  ParallelFunction<DecomposableFunctionType> parallelFunction(function);
+
   // To keep track of where we are and how things are going.
   double overallObjective = 0;
   double lastObjective = DBL_MAX;
+  CallbackMonitor<CallbackType> monitor(callback);
 
   // Set epoch length to n / b if the user asked for.
   if (innerIterations == 0)
@@ -74,10 +93,18 @@ double SARAHType<UpdatePolicyType>::Optimize(
   {
     // Calculate the objective function.
     overallObjective = 0;
-    for (size_t f = 0; f < numFunctions; f += batchSize)
+    if (parallel)
+    {
+      overallObjective = parallelFunction.Evaluate(iterate);
+    }
+    else
     {
-      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-      overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
+      for (size_t f = 0; f < numFunctions; f += batchSize)
+      {
+        const size_t effectiveBatchSize = std::min(batchSize,
+            numFunctions - f);
+        overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
+      }
     }
 
     if (std::isnan(overallObjective) || std::isinf(overallObjective))
@@ -99,78 +126,152 @@ double SARAHType<UpdatePolicyType>::Optimize(
 
     // Compute the full gradient.
     size_t effectiveBatchSize = std::min(batchSize, numFunctions);
-    function.Gradient(iterate, 0, v, effectiveBatchSize);
-    for (size_t f = effectiveBatchSize; f < numFunctions;
-        /* incrementing done manually */)
+    if (parallel)
+    {
+      parallelFunction.Gradient(iterate, v);
+    }
+    else
     {
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - f);
+      function.Gradient(iterate, 0, v, effectiveBatchSize);
+      for (size_t f = effectiveBatchSize; f < numFunctions;
+          /* incrementing done manually */)
+      {
+        // Find the effective batch size (the last batch may be smaller).
+        effectiveBatchSize = std::min(batchSize, numFunctions - f);
 
-      function.Gradient(iterate, f, gradient, effectiveBatchSize);
-      v += gradient;
+        function.Gradient(iterate, f, gradient, effectiveBatchSize);
+        v += gradient;
 
-      f += effectiveBatchSize;
+        f += effectiveBatchSize;
+      }
     }
     v /= (double) numFunctions;
 
+    if (monitor.Iteration(iterate, i, overallObjective, v, stepSize))
+    {
+      Log::Info << "SARAH: terminated by the callback." << std::endl;
+      return overallObjective;
+    }
+
     // Update iterate with full gradient (v).
     iterate -= stepSize * v;
 
     const double vNorm = arma::norm(v);
 
-    for (size_t f = 0, currentFunction = 0; f < innerIterations;
-        /* incrementing done manually */)
+    // Asynchronous inner iterations: each thread takes a contiguous share of
+    // the inner iterations, and steps on the shared iterate without
+    // synchronization.  The recursive gradient estimate is kept per thread,
+    // from the copies of the iterate that the thread read at its steps.
+    if (parallel)
     {
-      // Is this iteration the start of a sequence?
-      if ((currentFunction % numFunctions) == 0)
-      {
-        currentFunction = 0;
+      if (shuffle)
+        function.Shuffle();
 
-        // Determine order of visitation.
-        if (shuffle)
-          function.Shuffle();
+      #pragma omp parallel
+      {
+        size_t threads = 1;
+        size_t threadId = 0;
+        #ifdef HAS_OPENMP
+          threads = omp_get_num_threads();
+          threadId = omp_get_thread_num();
+        #endif
+
+        arma::mat threadV = v;
+        arma::mat threadGradient(iterate.n_rows, iterate.n_cols);
+        arma::mat threadGradient0(iterate.n_rows, iterate.n_cols);
+        arma::mat threadIterate, threadIterate0;
+        const size_t begin = threadId * innerIterations / threads;
+        const size_t end = (threadId + 1) * innerIterations / threads;
+        for (size_t f = begin; f < end; /* incrementing done manually */)
+        {
+          // Don't go past the last function or the share of the thread.
+          const size_t currentFunction = f % numFunctions;
+          const size_t threadBatchSize = std::min(std::min(batchSize,
+              numFunctions - currentFunction), end - f);
+
+          threadIterate = iterate;
+          function.Gradient(threadIterate, currentFunction, threadGradient,
+              threadBatchSize);
+
+          // On the first step of the thread, there is no older gradient.
+          if (f > begin)
+          {
+            function.Gradient(threadIterate0, currentFunction,
+                threadGradient0, threadBatchSize);
+          }
+          else
+          {
+            threadGradient0 = threadGradient;
+          }
+
+          threadIterate0 = std::move(threadIterate);
+          if (updatePolicy.Update(iterate, threadV, threadGradient,
+              threadGradient0, threadBatchSize, stepSize, vNorm))
+          {
+            break;
+          }
+
+          f += threadBatchSize;
+        }
       }
+    }
+    else
+    {
+      for (size_t f = 0, currentFunction = 0; f < innerIterations;
+          /* incrementing done manually */)
+      {
+        // Is this iteration the start of a sequence?
+        if ((currentFunction % numFunctions) == 0)
+        {
+          currentFunction = 0;
 
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - currentFunction);
+          // Determine order of visitation.
+          if (shuffle)
+            function.Shuffle();
+        }
 
-      // Calculate variance reduced gradient.
-      function.Gradient(iterate, currentFunction, gradient,
-          effectiveBatchSize);
+        // Find the effective batch size (the last batch may be smaller).
+        effectiveBatchSize = std::min(batchSize,
+            numFunctions - currentFunction);
 
-      // Avoid an unnecessary copy on the first iteration.
-      if (f > 0)
-      {
-        function.Gradient(iterate0, currentFunction, gradient0,
+        // Calculate variance reduced gradient.
+        function.Gradient(iterate, currentFunction, gradient,
             effectiveBatchSize);
 
-        // Store current parameter for the calculation of the variance reduced
-        // gradient.
-        iterate0 = iterate;
-
-        // Use the update policy to take a step.
-        if (updatePolicy.Update(iterate, v, gradient, gradient0,
-            effectiveBatchSize, stepSize, vNorm))
+        // Avoid an unnecessary copy on the first iteration.
+        if (f > 0)
         {
-          break;
+          function.Gradient(iterate0, currentFunction, gradient0,
+              effectiveBatchSize);
+
+          // Store current parameter for the calculation of the variance reduced
+          // gradient.
+          iterate0 = iterate;
+
+          // Use the update policy to take a step.
+          if (updatePolicy.Update(iterate, v, gradient, gradient0,
+              effectiveBatchSize, stepSize, vNorm))
+          {
+            break;
+          }
         }
-      }
-      else
-      {
-        // Store current parameter for the calculation of the variance reduced
-        // gradient.
-        iterate0 = iterate;
-
-        // Use the update policy to take a step.
-        if (updatePolicy.Update(iterate, v, gradient, gradient,
-            effectiveBatchSize, stepSize, vNorm))
+        else
         {
-          break;
+          // Store current parameter for the calculation of the variance reduced
+          // gradient.
+          iterate0 = iterate;
+
+          // Use the update policy to take a step.
+          if (updatePolicy.Update(iterate, v, gradient, gradient,
+              effectiveBatchSize, stepSize, vNorm))
+          {
+            break;
+          }
         }
-      }
 
-      currentFunction += effectiveBatchSize;
-      f += effectiveBatchSize;
+        currentFunction += effectiveBatchSize;
+        f += effectiveBatchSize;
+      }
     }
   }
 
@@ -178,6 +279,9 @@ double SARAHType<UpdatePolicyType>::Optimize(
       << "terminating optimization." << std::endl;
 
   // Calculate final objective.
+  if (parallel)
+    return parallelFunction.Evaluate(iterate);
+
   overallObjective = 0;
   for (size_t i = 0; i < numFunctions; i += batchSize)
   {
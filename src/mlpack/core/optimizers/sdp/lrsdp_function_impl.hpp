@@ -77,9 +77,19 @@ double LRSDPFunction<SDPType>::EvaluateConstraint(
   // function is only used by AugLagrangian, which do not update the coordinates
   // matrix.
 
-  // Using cached R*R^T gives better optimization for sparse matrices.
+  // For sparse matrices, Tr(A * (R R^T)) is the sum of A(i, j) * <R_i, R_j>
+  // over the nonzeros of A, where R_i is the ith row of R.
   if (index < SDP().NumSparseConstraints())
-    return accu(SDP().SparseA()[index] % rrt) - SDP().SparseB()[index];
+  {
+    const arma::sp_mat& a = SDP().SparseA()[index];
+    double trace = 0.0;
+    for (arma::sp_mat::const_iterator it = a.begin(); it != a.end(); ++it)
+    {
+      trace += (*it) * arma::dot(coordinates.row(it.row()),
+          coordinates.row(it.col()));
+    }
+    return trace - SDP().SparseB()[index];
+  }
   const size_t index1 = index - SDP().NumSparseConstraints();
 
   // For computation optimization we will be taking R^T * A first.
@@ -108,51 +118,185 @@ void UpdateRRT(LRSDPFunction<SDPType>& function,
   function.RRT() = newrrt;
 }
 
+//! Utility function for the number of blocks of constraints that are handled
+//! in parallel: one per thread, but never more than there are constraints.
+inline size_t ConstraintBlocks(const size_t numConstraints)
+{
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+    threads = omp_get_max_threads();
+  #endif
+
+  return std::max(std::min(threads, numConstraints), size_t(1));
+}
+
+//! Utility function for calculating Tr(A * (R R^T)) for a sparse constraint
+//! matrix without forming R R^T.  Each nonzero A(i, j) adds A(i, j) times the
+//! dot product of the ith and jth rows of R, so this takes O(nnz(A) * r) time;
+//! the rows of R are passed as the columns of rt = R^T, so they are contiguous.
+inline double SparseTrace(const arma::sp_mat& a, const arma::mat& rt)
+{
+  double trace = 0.0;
+  for (arma::sp_mat::const_iterator it = a.begin(); it != a.end(); ++it)
+    trace += (*it) * arma::dot(rt.col(it.row()), rt.col(it.col()));
+
+  return trace;
+}
+
+//! Utility function for calculating Tr(A_i * (R R^T)) - b_i for all of the
+//! sparse constraints in parallel.  If R R^T has been formed anyway (because
+//! there are dense constraints), looking its entries up is cheaper than the
+//! sparse kernel.
+inline void EvaluateConstraints(const std::vector<arma::sp_mat>& ais,
+                                const arma::vec& bis,
+                                const arma::mat& rrt,
+                                const arma::mat& rt,
+                                const bool useRRT,
+                                arma::vec& values)
+{
+  values.set_size(ais.size());
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) ais.size(); ++i)
+  {
+    values[i] = (useRRT ? accu(ais[i] % rrt) : SparseTrace(ais[i], rt)) -
+        bis[i];
+  }
+}
+
+//! Utility function for calculating Tr(A_i * (R R^T)) - b_i for all of the
+//! dense constraints in parallel.
+inline void EvaluateConstraints(const std::vector<arma::mat>& ais,
+                                const arma::vec& bis,
+                                const arma::mat& rrt,
+                                const arma::mat& /* rt */,
+                                const bool /* useRRT */,
+                                arma::vec& values)
+{
+  values.set_size(ais.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) ais.size(); ++i)
+  {
+    // Here taking R^T * A first is not recommended as we are already
+    // using pre-computed R * R^T. Taking R^T * A first will result in increase
+    // in number of computations.
+    values[i] = accu(ais[i] % rrt) - bis[i];
+  }
+}
+
 //! Utility function for calculating part of the objective when AugLagrangian is
 //! used with an LRSDPFunction.
 template <typename MatrixType>
 static inline void
 UpdateObjective(double& objective,
                 const arma::mat& rrt,
+                const arma::mat& rt,
+                const bool useRRT,
                 const std::vector<MatrixType>& ais,
                 const arma::vec& bis,
                 const arma::vec& lambda,
                 const size_t lambdaOffset,
                 const double sigma)
 {
+  arma::vec constraints;
+  EvaluateConstraints(ais, bis, rrt, rt, useRRT, constraints);
+
+  // Sum the terms in order, so that the objective doesn't depend on the number
+  // of threads.
   for (size_t i = 0; i < ais.size(); ++i)
   {
-    // Take the trace subtracted by the b_i.
-    // Here taking R^T * A first is not recommended as we are already
-    // using pre-computed R * R^T. Taking R^T * A first will result in increase
-    // in number of computations.
-    const double constraint = accu(ais[i] % rrt) - bis[i];
-    objective -= (lambda[lambdaOffset + i] * constraint);
-    objective += (sigma / 2.) * constraint * constraint;
+    objective -= (lambda[lambdaOffset + i] * constraints[i]);
+    objective += (sigma / 2.) * constraints[i] * constraints[i];
   }
 }
 
-//! Utility function for calculating part of the gradient when AugLagrangian is
-//! used with an LRSDPFunction.
-template <typename MatrixType>
+//! Utility function for calculating the part of the gradient from the sparse
+//! constraints when AugLagrangian is used with an LRSDPFunction.  The
+//! transposed gradient gt (r x n) is updated with -y_i * (A_i R)^T, nonzero by
+//! nonzero, so neither R R^T nor a dense n x n matrix is formed.  Each thread
+//! accumulates a block of constraints in its own matrix, and the blocks are
+//! summed in order.
+static inline void
+UpdateGradient(arma::mat& gt,
+               const arma::mat& rrt,
+               const arma::mat& rt,
+               const bool useRRT,
+               const std::vector<arma::sp_mat>& ais,
+               const arma::vec& bis,
+               const arma::vec& lambda,
+               const size_t lambdaOffset,
+               const double sigma)
+{
+  if (ais.empty())
+    return;
+
+  arma::vec constraints;
+  EvaluateConstraints(ais, bis, rrt, rt, useRRT, constraints);
+
+  const size_t blocks = ConstraintBlocks(ais.size());
+  std::vector<arma::mat> partials(blocks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    partials[b].zeros(gt.n_rows, gt.n_cols);
+    const size_t begin = b * ais.size() / blocks;
+    const size_t end = (b + 1) * ais.size() / blocks;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double y = lambda[lambdaOffset + i] - sigma * constraints[i];
+      for (arma::sp_mat::const_iterator it = ais[i].begin();
+           it != ais[i].end(); ++it)
+      {
+        partials[b].col(it.row()) -= (y * (*it)) * rt.col(it.col());
+      }
+    }
+  }
+
+  for (size_t b = 0; b < blocks; ++b)
+    gt += partials[b];
+}
+
+//! Utility function for calculating the part of S = C - sum_i y_i A_i from the
+//! dense constraints when AugLagrangian is used with an LRSDPFunction.  Each
+//! thread accumulates a block of constraints in its own matrix, and the blocks
+//! are summed in order.
 static inline void
 UpdateGradient(arma::mat& s,
                const arma::mat& rrt,
-               const std::vector<MatrixType>& ais,
+               const arma::mat& rt,
+               const bool useRRT,
+               const std::vector<arma::mat>& ais,
                const arma::vec& bis,
                const arma::vec& lambda,
                const size_t lambdaOffset,
                const double sigma)
 {
-  for (size_t i = 0; i < ais.size(); ++i)
+  if (ais.empty())
+    return;
+
+  arma::vec constraints;
+  EvaluateConstraints(ais, bis, rrt, rt, useRRT, constraints);
+
+  const size_t blocks = ConstraintBlocks(ais.size());
+  std::vector<arma::mat> partials(blocks);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
   {
-    // Here taking R^T * A first is not recommended as we are already
-    // using pre-computed R * R^T. Taking R^T * A first will result in increase
-    // in number of computations.
-    const double constraint = accu(ais[i] % rrt) - bis[i];
-    const double y = lambda[lambdaOffset + i] - sigma * constraint;
-    s -= y * ais[i];
+    partials[b].zeros(s.n_rows, s.n_cols);
+    const size_t begin = b * ais.size() / blocks;
+    const size_t end = (b + 1) * ais.size() / blocks;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double y = lambda[lambdaOffset + i] - sigma * constraints[i];
+      partials[b] -= y * ais[i];
+    }
   }
+
+  for (size_t b = 0; b < blocks; ++b)
+    s += partials[b];
 }
 
 template <typename SDPType>
@@ -180,28 +324,35 @@ EvaluateImpl(LRSDPFunction<SDPType>& function,
   // For computation optimization we will be taking R^T * C first.
   // Objective function = Tr((R^T * C) * R)
 
-  // Calculate R*R^T for updating cache.
-  const arma::mat rrt = coordinates * trans(coordinates);
+  // The rows of R, for the sparse constraint kernel.
+  const arma::mat rt = trans(coordinates);
 
-  // Update R*R^T matrix.
-  // Note that we can only use this optimization in case of L-BFGS optimizer
-  // or any other similar optimizer which calls Evaluate() before Gradient()
-  // with same coordinates matrix and uses only Evaluate() to update
-  // coordinates matrix.
-
-  // Note: In case optimizer also uses Gradient() for updating coordinates
-  // matrix than the same line of code can be used to update R*R^T through
-  // Gradient().
-  UpdateRRT(function, rrt);
+  // R*R^T is only needed for the dense constraints; the sparse ones are
+  // evaluated directly from the rows of R, which is much cheaper when there
+  // are many low-nnz constraints.
+  const bool useRRT = (function.SDP().NumDenseConstraints() > 0);
+  if (useRRT)
+  {
+    // Update R*R^T matrix.
+    // Note that we can only use this optimization in case of L-BFGS optimizer
+    // or any other similar optimizer which calls Evaluate() before Gradient()
+    // with same coordinates matrix and uses only Evaluate() to update
+    // coordinates matrix.
+
+    // Note: In case optimizer also uses Gradient() for updating coordinates
+    // matrix than the same line of code can be used to update R*R^T through
+    // Gradient().
+    UpdateRRT(function, coordinates * rt);
+  }
+  const arma::mat& rrt = function.RRT();
 
   // Optimized objective function.
-  double objective = trace((trans(coordinates) * function.SDP().C())
-                         * coordinates);
+  double objective = trace((rt * function.SDP().C()) * coordinates);
 
   // Now each constraint.
-  UpdateObjective(objective, rrt, function.SDP().SparseA(),
+  UpdateObjective(objective, rrt, rt, useRRT, function.SDP().SparseA(),
       function.SDP().SparseB(), lambda, 0, sigma);
-  UpdateObjective(objective, rrt, function.SDP().DenseA(),
+  UpdateObjective(objective, rrt, rt, useRRT, function.SDP().DenseA(),
       function.SDP().DenseB(), lambda, function.SDP().NumSparseConstraints(),
       sigma);
 
@@ -221,19 +372,33 @@ GradientImpl(const LRSDPFunction<SDPType>& function,
   //   with
   // S' = C - sum_{i = 1}^{m} y'_i A_i
   // y'_i = y_i - sigma * (Trace(A_i * (R R^T)) - b_i)
+  //
+  // S' is never formed for the sparse constraints: their part of S' * R is
+  // accumulated directly from the nonzeros of each A_i.
 
-  // Directly reterive R*R^T from cache.
-  const arma::mat rrt = function.RRT();
-  arma::mat s(function.SDP().C());
+  // Directly reterive R*R^T from cache (it is only kept if there are dense
+  // constraints).
+  const bool useRRT = (function.SDP().NumDenseConstraints() > 0);
+  const arma::mat& rrt = function.RRT();
+  const arma::mat rt = trans(coordinates);
+
+  // Start with (C * R)^T; the product is cheap if C is sparse.
+  arma::mat gt = trans(function.SDP().C() * coordinates);
 
   UpdateGradient(
-      s, rrt, function.SDP().SparseA(), function.SDP().SparseB(),
+      gt, rrt, rt, useRRT, function.SDP().SparseA(), function.SDP().SparseB(),
       lambda, 0, sigma);
-  UpdateGradient(
-      s, rrt, function.SDP().DenseA(), function.SDP().DenseB(),
-      lambda, function.SDP().NumSparseConstraints(), sigma);
 
-  gradient = 2 * s * coordinates;
+  if (useRRT)
+  {
+    arma::mat s(coordinates.n_rows, coordinates.n_rows, arma::fill::zeros);
+    UpdateGradient(
+        s, rrt, rt, useRRT, function.SDP().DenseA(), function.SDP().DenseB(),
+        lambda, function.SDP().NumSparseConstraints(), sigma);
+    gt += rt * trans(s);
+  }
+
+  gradient = 2 * trans(gt);
 }
 
 // Template specializations for function and gradient evaluation.
@@ -43,6 +43,37 @@ class NoDecay
     // Nothing to do here.
   }
 
+  /**
+   * This function is called in each iteration after the policy update, when
+   * the iterate has another element type than double.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  template<typename eT>
+  void Update(arma::Mat<eT>& /* iterate */,
+              double& /* stepSize */,
+              const arma::Mat<eT>& /* gradient */)
+  {
+    // Nothing to do here.
+  }
+
+  /**
+   * This function is called in each iteration after the policy update, when
+   * the gradient is sparse.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& /* iterate */,
+              double& /* stepSize */,
+              const arma::sp_mat& /* gradient */)
+  {
+    // Nothing to do here.
+  }
+
   /**
    * This function is called in each iteration after the SVRG update step.
    *
@@ -61,6 +92,10 @@ class NoDecay
   {
     // Nothing to do here.
   }
+
+  //! Serialize the decay policy (there is nothing to save).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 };
 
 } // namespace optimization
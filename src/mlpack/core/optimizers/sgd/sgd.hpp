@@ -16,9 +16,11 @@
 #define MLPACK_CORE_OPTIMIZERS_SGD_SGD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/callbacks/callback_monitor.hpp>
 #include "update_policies/vanilla_update.hpp"
 #include "update_policies/momentum_update.hpp"
 #include "update_policies/nesterov_momentum_update.hpp"
+#include "update_policies/skip_non_finite_update.hpp"
 #include "decay_policies/no_decay.hpp"
 
 namespace mlpack {
@@ -74,6 +76,25 @@ namespace optimization {
  * objective function on the first point in the dataset (presumably, the dataset
  * is held internally in the DecomposableFunctionType).
  *
+ * If the DecomposableFunctionType has no dense Gradient() but instead has
+ *
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::sp_mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * (as well as Shuffle()), then SGD computes sparse gradients and the update
+ * policy only touches the nonzero coordinates of each gradient, so a step
+ * costs time proportional to the number of nonzeros instead of the number of
+ * coordinates.  VanillaUpdate, MomentumUpdate, AdamUpdate, AdaGradUpdate and
+ * RMSPropUpdate support this; see their sparse Update() overloads for how
+ * deferred decay is caught up.  A function that has both kinds of gradients
+ * can choose at run time, with a
+ *
+ *   bool SparseGradients() const;
+ *
+ * method that returns whether the sparse gradients should be used.
+ *
  * @tparam UpdatePolicyType update policy used by SGD during the iterative update
  *     process. By default vanilla update policy (see
  *     mlpack::optimization::VanillaUpdate) is used.
@@ -130,6 +151,54 @@ class SGD
   double Optimize(DecomposableFunctionType& function,
                   arma::mat& iterate);
 
+  /**
+   * Optimize the given function using stochastic gradient descent, and call
+   * the given callback at the end of each pass over the functions with the
+   * objective of the pass and the gradient of its last batch (see
+   * mlpack::optimization::NoCallback for the interface).  The optimization
+   * terminates when the callback returns true.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam CallbackType Type of the callback.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callback Callback to call at each pass.
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType, typename CallbackType>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackType& callback);
+
+  /**
+   * Optimize the given function with iterates of another element type than
+   * double, such as the parameters of a single-precision network (see
+   * mlpack::ann::StaticFFN).  The function must provide
+   *
+   *   double Evaluate(const arma::Mat<eT>& coordinates,
+   *                   const size_t begin,
+   *                   const size_t batchSize);
+   *
+   *   void Gradient(const arma::Mat<eT>& coordinates,
+   *                 const size_t begin,
+   *                 arma::Mat<eT>& gradient,
+   *                 const size_t batchSize);
+   *
+   * as well as NumFunctions() and Shuffle(), and the update and decay policies
+   * must have an Update() overload for the element type (VanillaUpdate,
+   * MomentumUpdate, AdamUpdate and NoDecay do).  Gradients are dense, and no
+   * callbacks are called.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam eT Element type of the iterate.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType, typename eT>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::Mat<eT>& iterate);
+
   //! Get the step size.
   double StepSize() const { return stepSize; }
   //! Modify the step size.
@@ -172,7 +241,67 @@ class SGD
   //! Modify the step size decay policy.
   DecayPolicyType& DecayPolicy() { return decayPolicy; }
 
+  /**
+   * Serialize the optimizer, with the state of its policies (such as the
+   * moment estimates of Adam), so that an optimization can be resumed where it
+   * stopped (see Checkpoint).
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(stepSize);
+    ar & BOOST_SERIALIZATION_NVP(batchSize);
+    ar & BOOST_SERIALIZATION_NVP(maxIterations);
+    ar & BOOST_SERIALIZATION_NVP(tolerance);
+    ar & BOOST_SERIALIZATION_NVP(shuffle);
+    ar & BOOST_SERIALIZATION_NVP(updatePolicy);
+    ar & BOOST_SERIALIZATION_NVP(decayPolicy);
+    ar & BOOST_SERIALIZATION_NVP(resetPolicy);
+  }
+
  private:
+  /**
+   * Optimize a function that has both dense and sparse gradients, with the
+   * ones that its SparseGradients() method chooses.
+   */
+  template<typename DecomposableFunctionType, typename CallbackType>
+  double ChooseGradients(DecomposableFunctionType& function,
+                         arma::mat& iterate,
+                         CallbackType& callback,
+                         std::true_type /* choice */);
+
+  /**
+   * Optimize a function with the gradients it has: sparse gradients are only
+   * used if there are no dense ones.
+   */
+  template<typename DecomposableFunctionType, typename CallbackType>
+  double ChooseGradients(DecomposableFunctionType& function,
+                         arma::mat& iterate,
+                         CallbackType& callback,
+                         std::false_type /* choice */);
+
+  /**
+   * Optimize a function with dense gradients.
+   */
+  template<typename DecomposableFunctionType, typename CallbackType>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackType& callback,
+                  std::false_type /* sparse */);
+
+  /**
+   * Optimize a function whose Gradient() returns an arma::sp_mat.  Each step
+   * only touches the nonzero coordinates of the gradient; the update policy
+   * must provide a sparse Update() overload and a CatchUp() method, which is
+   * called at the end of each pass over the functions to apply any deferred
+   * updates to the rest of the coordinates.
+   */
+  template<typename DecomposableFunctionType, typename CallbackType>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackType& callback,
+                  std::true_type /* sparse */);
+
   //! The step size for each example.
   double stepSize;
 
@@ -21,6 +21,22 @@
 
 namespace mlpack {
 namespace optimization {
+namespace traits {
+
+//! Detect an Update() method of an update or decay policy.
+HAS_EXACT_METHOD_FORM(Update, HasUpdate);
+
+//! This is the form of the sparse Update() method of an update policy.
+template<typename PolicyType>
+using SparseUpdateForm = void(PolicyType::*)(
+    arma::mat&, const double, const arma::sp_mat&);
+
+//! This is the form of the sparse Update() method of a decay policy.
+template<typename PolicyType>
+using SparseDecayForm = void(PolicyType::*)(
+    arma::mat&, double&, const arma::sp_mat&);
+
+} // namespace traits
 
 template<typename UpdatePolicyType, typename DecayPolicyType>
 SGD<UpdatePolicyType, DecayPolicyType>::SGD(
@@ -48,6 +64,159 @@ template<typename DecomposableFunctionType>
 double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
     DecomposableFunctionType& function,
     arma::mat& iterate)
+{
+  NoCallback callback;
+  return Optimize(function, iterate, callback);
+}
+
+//! Optimize the function (minimize) with iterates of another element type.
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename DecomposableFunctionType, typename eT>
+double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::Mat<eT>& iterate)
+{
+  // Find the number of functions to use.
+  const size_t numFunctions = function.NumFunctions();
+
+  // To keep track of where we are and how things are going.
+  size_t currentFunction = 0;
+  double overallObjective = 0;
+  double lastObjective = DBL_MAX;
+
+  // Initialize the update policy.
+  if (resetPolicy)
+    updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
+
+  // Now iterate!
+  arma::Mat<eT> gradient(iterate.n_rows, iterate.n_cols);
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  for (size_t i = 0; i < actualMaxIterations; /* incrementing done manually */)
+  {
+    // Is this iteration the start of a sequence?
+    if ((currentFunction % numFunctions) == 0 && i > 0)
+    {
+      // Output current objective function.
+      Log::Info << "SGD: iteration " << i << ", objective " << overallObjective
+          << "." << std::endl;
+
+      if (std::isnan(overallObjective) || std::isinf(overallObjective))
+      {
+        Log::Warn << "SGD: converged to " << overallObjective << "; terminating"
+            << " with failure.  Try a smaller step size?" << std::endl;
+        return overallObjective;
+      }
+
+      if (std::abs(lastObjective - overallObjective) < tolerance)
+      {
+        Log::Info << "SGD: minimized within tolerance " << tolerance << "; "
+            << "terminating optimization." << std::endl;
+        return overallObjective;
+      }
+
+      // Reset the counter variables.
+      lastObjective = overallObjective;
+      overallObjective = 0;
+      currentFunction = 0;
+
+      if (shuffle) // Determine order of visitation.
+        function.Shuffle();
+    }
+
+    // Find the effective batch size, as in the double-precision case.
+    const size_t effectiveBatchSize = std::min(
+        std::min(batchSize, actualMaxIterations - i),
+        numFunctions - currentFunction);
+
+    overallObjective += function.Evaluate(iterate, currentFunction,
+        effectiveBatchSize);
+    function.Gradient(iterate, currentFunction, gradient, effectiveBatchSize);
+
+    // Use the update policy to take a step.
+    updatePolicy.Update(iterate, stepSize, gradient);
+
+    // Now update the learning rate if requested by the user.
+    decayPolicy.Update(iterate, stepSize, gradient);
+
+    i += effectiveBatchSize;
+    currentFunction += effectiveBatchSize;
+  }
+
+  Log::Info << "SGD: maximum iterations (" << maxIterations << ") reached; "
+      << "terminating optimization." << std::endl;
+
+  // Calculate final objective.
+  overallObjective = 0;
+  for (size_t i = 0; i < numFunctions; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
+    overallObjective += function.Evaluate(iterate, i, effectiveBatchSize);
+  }
+  return overallObjective;
+}
+
+//! Optimize the function (minimize), calling the callback at each pass.
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename DecomposableFunctionType, typename CallbackType>
+double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate,
+    CallbackType& callback)
+{
+  // The function can only choose sparse gradients if the policies support
+  // them.
+  typedef std::integral_constant<bool, traits::CheckSparseGradientsChoice<
+      DecomposableFunctionType>::value &&
+      traits::HasUpdate<UpdatePolicyType, traits::SparseUpdateForm>::value &&
+      traits::HasUpdate<DecayPolicyType, traits::SparseDecayForm>::value>
+      HasChoice;
+
+  return ChooseGradients(function, iterate, callback, HasChoice());
+}
+
+//! Use the gradients that the function chooses at run time.
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename DecomposableFunctionType, typename CallbackType>
+double SGD<UpdatePolicyType, DecayPolicyType>::ChooseGradients(
+    DecomposableFunctionType& function,
+    arma::mat& iterate,
+    CallbackType& callback,
+    std::true_type /* choice */)
+{
+  if (function.SparseGradients())
+    return Optimize(function, iterate, callback, std::true_type());
+
+  return Optimize(function, iterate, callback, std::false_type());
+}
+
+//! Choose the gradients from the methods that the function has.
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename DecomposableFunctionType, typename CallbackType>
+double SGD<UpdatePolicyType, DecayPolicyType>::ChooseGradients(
+    DecomposableFunctionType& function,
+    arma::mat& iterate,
+    CallbackType& callback,
+    std::false_type /* choice */)
+{
+  // Only use sparse gradients if there is no dense Gradient() to use.
+  typedef std::integral_constant<bool,
+      traits::CheckSparseGradient<DecomposableFunctionType>::value &&
+      !traits::CheckDecomposableGradient<DecomposableFunctionType>::value &&
+      !traits::CheckDecomposableEvaluateWithGradient<
+          DecomposableFunctionType>::value> IsSparse;
+
+  return Optimize(function, iterate, callback, IsSparse());
+}
+
+//! Optimize the function (minimize) with dense gradients.
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename DecomposableFunctionType, typename CallbackType>
+double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate,
+    CallbackType& callback,
+    std::false_type /* sparse */)
 {
   typedef Function<DecomposableFunctionType> FullFunctionType;
   FullFunctionType& f(static_cast<FullFunctionType&>(function));
@@ -62,6 +231,7 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
   size_t currentFunction = 0;
   double overallObjective = 0;
   double lastObjective = DBL_MAX;
+  CallbackMonitor<CallbackType> monitor(callback);
 
   // Initialize the update policy.
   if (resetPolicy)
@@ -94,6 +264,12 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
         return overallObjective;
       }
 
+      if (monitor.Iteration(iterate, i, overallObjective, gradient, stepSize))
+      {
+        Log::Info << "SGD: terminated by the callback." << std::endl;
+        return overallObjective;
+      }
+
       // Reset the counter variables.
       lastObjective = overallObjective;
       overallObjective = 0;
@@ -141,6 +317,115 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
   return overallObjective;
 }
 
+//! Optimize the function (minimize) with sparse gradients.
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename DecomposableFunctionType, typename CallbackType>
+double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate,
+    CallbackType& callback,
+    std::true_type /* sparse */)
+{
+  // Make sure we have all the methods that we need.
+  traits::CheckSparseFunctionTypeAPI<DecomposableFunctionType>();
+  static_assert(traits::CheckShuffle<DecomposableFunctionType>::value,
+      "The FunctionType does not have a correct definition of Shuffle(). "
+      "Please check that the FunctionType fully satisfies the requirements of "
+      "the SparseFunctionType API; see the optimizer tutorial for more "
+      "details.");
+
+  // Find the number of functions to use.
+  const size_t numFunctions = function.NumFunctions();
+
+  // To keep track of where we are and how things are going.
+  size_t currentFunction = 0;
+  double overallObjective = 0;
+  double lastObjective = DBL_MAX;
+  CallbackMonitor<CallbackType> monitor(callback);
+
+  // Initialize the update policy.
+  if (resetPolicy)
+    updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
+
+  // Now iterate!
+  arma::sp_mat gradient(iterate.n_rows, iterate.n_cols);
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  for (size_t i = 0; i < actualMaxIterations; /* incrementing done manually */)
+  {
+    // Is this iteration the start of a sequence?
+    if ((currentFunction % numFunctions) == 0 && i > 0)
+    {
+      // Bring every coordinate up to date once per pass.
+      updatePolicy.CatchUp(iterate);
+
+      // Output current objective function.
+      Log::Info << "SGD: iteration " << i << ", objective " << overallObjective
+          << "." << std::endl;
+
+      if (std::isnan(overallObjective) || std::isinf(overallObjective))
+      {
+        Log::Warn << "SGD: converged to " << overallObjective << "; terminating"
+            << " with failure.  Try a smaller step size?" << std::endl;
+        return overallObjective;
+      }
+
+      if (std::abs(lastObjective - overallObjective) < tolerance)
+      {
+        Log::Info << "SGD: minimized within tolerance " << tolerance << "; "
+            << "terminating optimization." << std::endl;
+        return overallObjective;
+      }
+
+      if (monitor.Iteration(iterate, i, overallObjective, gradient, stepSize))
+      {
+        Log::Info << "SGD: terminated by the callback." << std::endl;
+        return overallObjective;
+      }
+
+      // Reset the counter variables.
+      lastObjective = overallObjective;
+      overallObjective = 0;
+      currentFunction = 0;
+
+      if (shuffle) // Determine order of visitation.
+        function.Shuffle();
+    }
+
+    // Find the effective batch size, as in the dense case.
+    const size_t effectiveBatchSize = std::min(
+        std::min(batchSize, actualMaxIterations - i),
+        numFunctions - currentFunction);
+
+    overallObjective += function.Evaluate(iterate, currentFunction,
+        effectiveBatchSize);
+    function.Gradient(iterate, currentFunction, gradient, effectiveBatchSize);
+
+    // Use the update policy to take a step on the nonzero coordinates.
+    updatePolicy.Update(iterate, stepSize, gradient);
+
+    // Now update the learning rate if requested by the user.
+    decayPolicy.Update(iterate, stepSize, gradient);
+
+    i += effectiveBatchSize;
+    currentFunction += effectiveBatchSize;
+  }
+
+  updatePolicy.CatchUp(iterate);
+
+  Log::Info << "SGD: maximum iterations (" << maxIterations << ") reached; "
+      << "terminating optimization." << std::endl;
+
+  // Calculate final objective.
+  overallObjective = 0;
+  for (size_t i = 0; i < numFunctions; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
+    overallObjective += function.Evaluate(iterate, i, effectiveBatchSize);
+  }
+  return overallObjective;
+}
+
 } // namespace optimization
 } // namespace mlpack
 
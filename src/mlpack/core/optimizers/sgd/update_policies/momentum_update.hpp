@@ -69,7 +69,9 @@ class MomentumUpdate
    *
    * @param momentum The momentum decay hyperparameter
    */
-  MomentumUpdate(const double momentum = 0.5) : momentum(momentum)
+  MomentumUpdate(const double momentum = 0.5) :
+      momentum(momentum),
+      iteration(0)
   { /* Do nothing. */ };
 
   /**
@@ -85,6 +87,11 @@ class MomentumUpdate
   {
     // Initialize am empty velocity matrix.
     velocity = arma::zeros<arma::mat>(rows, cols);
+
+    // The step of the last sparse update of each coordinate is only needed
+    // for sparse gradients.
+    iteration = 0;
+    lastUpdate.reset();
   }
 
   /**
@@ -104,11 +111,120 @@ class MomentumUpdate
     iterate += velocity;
   }
 
+  /**
+   * Update step for SGD with iterates of another element type (e.g. float).
+   * The velocity is still accumulated in double precision, so that small
+   * steps are not lost to rounding.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  template<typename eT>
+  void Update(arma::Mat<eT>& iterate,
+              const double stepSize,
+              const arma::Mat<eT>& gradient)
+  {
+    velocity = momentum * velocity -
+        stepSize * arma::conv_to<arma::mat>::from(gradient);
+    iterate += arma::conv_to<arma::Mat<eT>>::from(velocity);
+  }
+
+  /**
+   * Update step for SGD with a sparse gradient.  Only the nonzero coordinates
+   * of the gradient are touched; a coordinate that has not been seen for k
+   * steps would have kept moving with a decaying velocity during those steps,
+   * so before it is updated, it is moved by
+   *
+   * \f[
+   * v (mu + mu^2 + ... + mu^k)
+   * \f]
+   *
+   * and its velocity is decayed by \f$ mu^k \f$, which is exactly what k
+   * dense updates with a zero gradient would have done.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::sp_mat& gradient)
+  {
+    if (lastUpdate.n_elem != iterate.n_elem)
+    {
+      lastUpdate.set_size(iterate.n_rows, iterate.n_cols);
+      lastUpdate.fill(iteration);
+    }
+
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+         it != gradient.end(); ++it)
+    {
+      const size_t i = it.row() + it.col() * iterate.n_rows;
+      CatchUp(iterate, i);
+      velocity[i] = momentum * velocity[i] - stepSize * (*it);
+      iterate[i] += velocity[i];
+    }
+
+    // The coordinates just updated are now a step behind.
+    ++iteration;
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+         it != gradient.end(); ++it)
+      lastUpdate[it.row() + it.col() * iterate.n_rows] = iteration;
+  }
+
+  /**
+   * Apply the velocity that every coordinate has accumulated since its last
+   * sparse update.
+   *
+   * @param iterate Parameters that minimize the function.
+   */
+  void CatchUp(arma::mat& iterate)
+  {
+    if (lastUpdate.n_elem != iterate.n_elem)
+      return;
+
+    for (size_t i = 0; i < iterate.n_elem; ++i)
+    {
+      CatchUp(iterate, i);
+      lastUpdate[i] = iteration;
+    }
+  }
+
+  //! Serialize the update policy (with its state, so that an optimization
+  //! can be resumed).
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(momentum);
+    ar & BOOST_SERIALIZATION_NVP(velocity);
+    ar & BOOST_SERIALIZATION_NVP(iteration);
+    ar & BOOST_SERIALIZATION_NVP(lastUpdate);
+  }
+
  private:
+  //! Apply the deferred steps of coordinate i.
+  void CatchUp(arma::mat& iterate, const size_t i)
+  {
+    const size_t steps = iteration - lastUpdate[i];
+    if (steps == 0 || velocity[i] == 0.0)
+      return;
+
+    const double decay = std::pow(momentum, (double) steps);
+    const double distance = (momentum == 1.0) ? (double) steps :
+        momentum * (1.0 - decay) / (1.0 - momentum);
+    iterate[i] += distance * velocity[i];
+    velocity[i] *= decay;
+  }
+
   // The momentum hyperparamter
   double momentum;
   // The velocity matrix.
   arma::mat velocity;
+  // The number of sparse updates.
+  size_t iteration;
+  // The sparse update after which each coordinate was last updated.
+  arma::umat lastUpdate;
 };
 
 } // namespace optimization
@@ -86,6 +86,15 @@ class NesterovMomentumUpdate
   //! Modify the value used to initialize the momentum coefficient.
   double& Momentum() { return momentum; }
 
+  //! Serialize the update policy (with its state, so that an optimization
+  //! can be resumed).
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(velocity);
+    ar & BOOST_SERIALIZATION_NVP(momentum);
+  }
+
  private:
   // The velocity matrix.
   arma::mat velocity;
@@ -0,0 +1,118 @@
+/**
+ * @file skip_non_finite_update.hpp
+ *
+ * Update wrapper that skips the steps whose gradient overflowed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_SGD_SKIP_NON_FINITE_UPDATE_HPP
+#define MLPACK_CORE_OPTIMIZERS_SGD_SKIP_NON_FINITE_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Wrapper around an update policy (e.g., VanillaUpdate or AdamUpdate) that
+ * skips the update when the gradient has an infinite or NaN element, so that
+ * neither the iterate nor the state of the update policy (such as the moments
+ * of Adam) is changed by it.  This is what mixed precision training with
+ * dynamic loss scaling needs: when the scaled gradient of a batch overflows,
+ * FFN (with FFN::EmulatedPrecision()) lowers the loss scale and returns the
+ * non-finite gradient, and the step is skipped.  For example,
+ *
+ * @code
+ * FFN<> model;
+ * model.EmulatedPrecision() = HALF_PRECISION;
+ * ...
+ * AdamType<SkipNonFiniteUpdate<AdamUpdate>> adam(0.001, 32);
+ * model.Train(data, responses, adam);
+ * @endcode
+ *
+ * @tparam UpdatePolicyType The update policy to wrap.
+ */
+template<typename UpdatePolicyType>
+class SkipNonFiniteUpdate
+{
+ public:
+  /**
+   * Construct the wrapped update policy with the given arguments, so that the
+   * wrapper can be used wherever the update policy is constructed (as in
+   * AdamType).
+   */
+  template<typename... Args, typename = typename std::enable_if<
+      std::is_constructible<UpdatePolicyType, Args&&...>::value>::type>
+  SkipNonFiniteUpdate(Args&&... args) :
+      updatePolicy(std::forward<Args>(args)...),
+      skipped(0)
+  {
+    // Nothing to do here.
+  }
+
+  /**
+   * The Initialize method is called by SGD Optimizer method before the start of
+   * the iteration update process.  The wrapped update policy is initialized.
+   *
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    updatePolicy.Initialize(rows, cols);
+    skipped = 0;
+  }
+
+  /**
+   * Update step.  The wrapped update policy updates the iterate, unless the
+   * gradient is not finite.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient)
+  {
+    if (!gradient.is_finite())
+    {
+      ++skipped;
+      return;
+    }
+
+    updatePolicy.Update(iterate, stepSize, gradient);
+  }
+
+  //! Get the update policy.
+  const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
+  //! Modify the update policy.
+  UpdatePolicyType& UpdatePolicy() { return updatePolicy; }
+
+  //! Get the number of updates skipped since the optimization started.
+  size_t Skipped() const { return skipped; }
+
+  //! Serialize the update policy (with its state, so that an optimization
+  //! can be resumed).
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(updatePolicy);
+    ar & BOOST_SERIALIZATION_NVP(skipped);
+  }
+
+ private:
+  //! The wrapped update policy.
+  UpdatePolicyType updatePolicy;
+
+  //! The number of skipped updates.
+  size_t skipped;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
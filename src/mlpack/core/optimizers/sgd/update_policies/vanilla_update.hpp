@@ -57,6 +57,49 @@ class VanillaUpdate
     // Perform the vanilla SGD update.
     iterate -= stepSize * gradient;
   }
+
+  /**
+   * Update step for SGD with iterates of another element type (e.g. float).
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  template<typename eT>
+  void Update(arma::Mat<eT>& iterate,
+              const double stepSize,
+              const arma::Mat<eT>& gradient)
+  {
+    iterate -= eT(stepSize) * gradient;
+  }
+
+  /**
+   * Update step for SGD with a sparse gradient; only the nonzero coordinates
+   * of the gradient are touched.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::sp_mat& gradient)
+  {
+    for (arma::sp_mat::const_iterator it = gradient.begin();
+         it != gradient.end(); ++it)
+      iterate(it.row(), it.col()) -= stepSize * (*it);
+  }
+
+  /**
+   * Apply any deferred updates.  The vanilla update never defers anything.
+   *
+   * @param iterate Parameters that minimize the function.
+   */
+  void CatchUp(arma::mat& /* iterate */) { /* Do nothing. */ }
+
+  //! Serialize the update policy (there is nothing to save).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 };
 
 } // namespace optimization
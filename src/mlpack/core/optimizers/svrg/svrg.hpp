@@ -124,6 +124,10 @@ class SVRGType
    * @param decayPolicy Instantiated decay policy used to adjust the step size.
    * @param resetPolicy Flag that determines whether update policy parameters
    *     are reset before every Optimize call.
+   * @param parallel If true, compute the objective and full gradient with
+   *     several threads, and split the inner iterations between threads that
+   *     step on the shared iterate without synchronization.  The function's
+   *     Evaluate() and Gradient() must then be safe to call concurrently.
    */
   SVRGType(const double stepSize = 0.01,
            const size_t batchSize = 32,
@@ -133,7 +137,8 @@ class SVRGType
            const bool shuffle = true,
            const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
            const DecayPolicyType& decayPolicy = DecayPolicyType(),
-           const bool resetPolicy = true);
+           const bool resetPolicy = true,
+           const bool parallel = false);
 
   /**
    * Optimize the given function using SVRG. The given starting point will be
@@ -185,6 +190,11 @@ class SVRGType
   //! are reset before Optimize call.
   bool& ResetPolicy() { return resetPolicy; }
 
+  //! Get whether or not the gradients are computed with several threads.
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not the gradients are computed with several threads.
+  bool& Parallel() { return parallel; }
+
   //! Get the update policy.
   const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
   //! Modify the update policy.
@@ -224,6 +234,9 @@ class SVRGType
   //! Flag indicating whether update policy
   //! should be reset before running optimization.
   bool resetPolicy;
+
+  //! Controls whether or not the gradients are computed with several threads.
+  bool parallel;
 };
 
 // Convenience typedefs.
@@ -15,6 +15,8 @@
 // In case it hasn't been included yet.
 #include "svrg.hpp"
 
+#include <mlpack/core/optimizers/function/parallel_function.hpp>
+
 namespace mlpack {
 namespace optimization {
 
@@ -28,7 +30,8 @@ SVRGType<UpdatePolicyType, DecayPolicyType>::SVRGType(
     const bool shuffle,
     const UpdatePolicyType& updatePolicy,
     const DecayPolicyType& decayPolicy,
-    const bool resetPolicy) :
+    const bool resetPolicy,
+    const bool parallel) :
     stepSize(stepSize),
     batchSize(batchSize),
     maxIterations(maxIterations),
@@ -37,7 +40,8 @@ SVRGType<UpdatePolicyType, DecayPolicyType>::SVRGType(
     shuffle(shuffle),
     updatePolicy(updatePolicy),
     decayPolicy(decayPolicy),
-    resetPolicy(resetPolicy)
+    resetPolicy(resetPolicy),
+    parallel(parallel)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -50,6 +54,9 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
   // Find the number of functions to use.
   const size_t numFunctions = function.NumFunctions();
 
+  // This computes the objective and the full gradient with several threads.
+  ParallelFunction<DecomposableFunctionType> parallelFunction(function);
+
   // To keep track of where we are and how things are going.
   double overallObjective = 0;
   double lastObjective = DBL_MAX;
@@ -78,10 +85,18 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
   {
     // Calculate the objective function.
     overallObjective = 0;
-    for (size_t f = 0; f < numFunctions; f += batchSize)
+    if (parallel)
+    {
+      overallObjective = parallelFunction.Evaluate(iterate);
+    }
+    else
     {
-      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-      overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
+      for (size_t f = 0; f < numFunctions; f += batchSize)
+      {
+        const size_t effectiveBatchSize = std::min(batchSize,
+            numFunctions - f);
+        overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
+      }
     }
 
     if (std::isnan(overallObjective) || std::isinf(overallObjective))
@@ -104,17 +119,24 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
     // Compute the full gradient.
     size_t effectiveBatchSize = std::min(batchSize, numFunctions);
     arma::mat fullGradient(iterate.n_rows, iterate.n_cols);
-    function.Gradient(iterate, 0, fullGradient, effectiveBatchSize);
-    for (size_t f = effectiveBatchSize; f < numFunctions;
-        /* incrementing done manually */)
+    if (parallel)
     {
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - f);
+      parallelFunction.Gradient(iterate, fullGradient);
+    }
+    else
+    {
+      function.Gradient(iterate, 0, fullGradient, effectiveBatchSize);
+      for (size_t f = effectiveBatchSize; f < numFunctions;
+          /* incrementing done manually */)
+      {
+        // Find the effective batch size (the last batch may be smaller).
+        effectiveBatchSize = std::min(batchSize, numFunctions - f);
 
-      function.Gradient(iterate, f, gradient, effectiveBatchSize);
-      fullGradient += gradient;
+        function.Gradient(iterate, f, gradient, effectiveBatchSize);
+        fullGradient += gradient;
 
-      f += effectiveBatchSize;
+        f += effectiveBatchSize;
+      }
     }
     fullGradient /= (double) numFunctions;
 
@@ -122,34 +144,77 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
     // gradient.
     iterate0 = iterate;
 
-    for (size_t f = 0, currentFunction = 0; f < innerIterations;
-        /* incrementing done manually */)
+    // Asynchronous inner iterations, in the spirit of ASVRG: each thread takes
+    // a contiguous share of the inner iterations, and steps on the shared
+    // iterate without synchronization.
+    if (parallel)
     {
-      // Is this iteration the start of a sequence?
-      if ((currentFunction % numFunctions) == 0)
-      {
-        currentFunction = 0;
+      if (shuffle)
+        function.Shuffle();
 
-        // Determine order of visitation.
-        if (shuffle)
-          function.Shuffle();
+      #pragma omp parallel
+      {
+        size_t threads = 1;
+        size_t threadId = 0;
+        #ifdef HAS_OPENMP
+          threads = omp_get_num_threads();
+          threadId = omp_get_thread_num();
+        #endif
+
+        arma::mat threadGradient(iterate.n_rows, iterate.n_cols);
+        arma::mat threadGradient0(iterate.n_rows, iterate.n_cols);
+        const size_t end = (threadId + 1) * innerIterations / threads;
+        for (size_t f = threadId * innerIterations / threads; f < end;
+            /* incrementing done manually */)
+        {
+          // Don't go past the last function or the share of the thread.
+          const size_t currentFunction = f % numFunctions;
+          const size_t threadBatchSize = std::min(std::min(batchSize,
+              numFunctions - currentFunction), end - f);
+
+          function.Gradient(iterate, currentFunction, threadGradient,
+              threadBatchSize);
+          function.Gradient(iterate0, currentFunction, threadGradient0,
+              threadBatchSize);
+          updatePolicy.Update(iterate, fullGradient, threadGradient,
+              threadGradient0, threadBatchSize, stepSize);
+
+          f += threadBatchSize;
+        }
+      }
+    }
+    else
+    {
+      for (size_t f = 0, currentFunction = 0; f < innerIterations;
+          /* incrementing done manually */)
+      {
+        // Is this iteration the start of a sequence?
+        if ((currentFunction % numFunctions) == 0)
+        {
+          currentFunction = 0;
+
+          // Determine order of visitation.
+          if (shuffle)
+            function.Shuffle();
+        }
+
+        // Find the effective batch size (the last batch may be smaller).
+        effectiveBatchSize = std::min(batchSize,
+            numFunctions - currentFunction);
+
+        // Calculate variance reduced gradient.
+        function.Gradient(iterate, currentFunction, gradient,
+            effectiveBatchSize);
+        function.Gradient(iterate0, currentFunction, gradient0,
+            effectiveBatchSize);
+
+        // Use the update policy to take a step.
+        updatePolicy.Update(iterate, fullGradient, gradient, gradient0,
+            effectiveBatchSize, stepSize);
+
+        currentFunction += effectiveBatchSize;
+        f += effectiveBatchSize;
       }
-
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - currentFunction);
-
-      // Calculate variance reduced gradient.
-      function.Gradient(iterate, currentFunction, gradient,
-          effectiveBatchSize);
-      function.Gradient(iterate0, currentFunction, gradient0,
-          effectiveBatchSize);
-
-      // Use the update policy to take a step.
-      updatePolicy.Update(iterate, fullGradient, gradient, gradient0,
-          effectiveBatchSize, stepSize);
-
-      currentFunction += effectiveBatchSize;
-      f += effectiveBatchSize;
     }
 
     // Update the learning rate if requested by the user.
@@ -161,6 +226,9 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
       << "terminating optimization." << std::endl;
 
   // Calculate final objective.
+  if (parallel)
+    return parallelFunction.Evaluate(iterate);
+
   overallObjective = 0;
   for (size_t i = 0; i < numFunctions; i += batchSize)
   {
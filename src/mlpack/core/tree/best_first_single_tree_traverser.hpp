@@ -0,0 +1,159 @@
+/**
+ * @file best_first_single_tree_traverser.hpp
+ *
+ * A single-tree traverser that visits the nodes in order of their scores,
+ * within a budget of leaves or time.  The RuleType class must implement the
+ * methods 'BaseCase()', 'Score()' and 'Rescore()' (and 'GetBestChild()' for
+ * spill trees).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <chrono>
+
+#include "spill_tree/is_spill_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The BestFirstSingleTreeTraverser keeps the nodes that are still to be
+ * visited in a priority queue, and always visits the one with the best (the
+ * lowest) score next, instead of finishing each subtree first as the
+ * depth-first traversers do.  For nearest neighbor search, the leaves are then
+ * visited in order of their distance to the query, so the candidates are as
+ * good as they can be for the number of leaves visited, and the traversal can
+ * be cut short at any time: it stops when the budget of leaves or the deadline
+ * is spent, and Exact() tells whether it finished (so that the result is the
+ * same as without a budget) or had to leave nodes that could have improved
+ * the result.  At least one leaf is visited by each traversal, whatever the
+ * budget.
+ *
+ * At the overlapping nodes of a spill tree, only the best child is visited, as
+ * in defeatist search (the points of the children are shared, so visiting
+ * both would return them twice); the result is then not exact.
+ */
+template<typename TreeType, typename RuleType>
+class BestFirstSingleTreeTraverser
+{
+ public:
+  //! The type of clock used for the deadline.
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * Instantiate the traverser with the given rule set and budget.
+   *
+   * @param rule Rules with which the tree will be traversed.
+   * @param maxLeaves Maximum number of leaves visited by each traversal (0 for
+   *     no limit).
+   * @param deadline Time when the traversals stop visiting leaves
+   *     (Clock::time_point::max() for no limit).
+   */
+  BestFirstSingleTreeTraverser(
+      RuleType& rule,
+      const size_t maxLeaves = 0,
+      const Clock::time_point deadline = Clock::time_point::max());
+
+  /**
+   * Traverse the tree with the given point.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the maximum number of leaves visited by each traversal.
+  size_t MaxLeaves() const { return maxLeaves; }
+  //! Modify the maximum number of leaves visited by each traversal.
+  size_t& MaxLeaves() { return maxLeaves; }
+
+  //! Get the time when the traversals stop visiting leaves.
+  Clock::time_point Deadline() const { return deadline; }
+  //! Modify the time when the traversals stop visiting leaves.
+  Clock::time_point& Deadline() { return deadline; }
+
+  //! Get the number of leaves visited by the last traversal.
+  size_t NumVisitedLeaves() const { return numVisitedLeaves; }
+
+  //! Get whether the last traversal visited every node that it could not
+  //! prune.
+  bool Exact() const { return exact; }
+
+ private:
+  //! A node to visit, with its score when it was queued.
+  typedef std::pair<double, TreeType*> QueueEntry;
+
+  //! Order the queue so that the entry with the lowest score is on top.
+  struct QueueCompare
+  {
+    bool operator()(const QueueEntry& a, const QueueEntry& b) const
+    {
+      return a.first > b.first;
+    }
+  };
+
+  //! Queue the children of the given node that can't be pruned.
+  void QueueChildren(const size_t queryIndex,
+                     TreeType& referenceNode,
+                     const std::false_type /* isSpillTree */);
+
+  //! Queue the children of the given node of a spill tree that can't be
+  //! pruned, or only the best child if the node is overlapping.
+  void QueueChildren(const size_t queryIndex,
+                     TreeType& referenceNode,
+                     const std::true_type /* isSpillTree */);
+
+  //! Queue the given node if it can't be pruned.
+  void QueueNode(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Whether the budget of the current traversal is spent.
+  bool BudgetSpent() const
+  {
+    if (numVisitedLeaves == 0)
+      return false;
+
+    return (maxLeaves > 0 && numVisitedLeaves >= maxLeaves) ||
+        (deadline != Clock::time_point::max() && Clock::now() >= deadline);
+  }
+
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+
+  //! The maximum number of leaves visited by each traversal (0 for no limit).
+  size_t maxLeaves;
+
+  //! The time when the traversals stop visiting leaves.
+  Clock::time_point deadline;
+
+  //! The number of leaves visited by the current traversal.
+  size_t numVisitedLeaves;
+
+  //! Whether the current traversal is exact so far.
+  bool exact;
+
+  //! The nodes to visit, as a heap (kept to reuse its memory).
+  std::vector<QueueEntry> queue;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "best_first_single_tree_traverser_impl.hpp"
+
+#endif
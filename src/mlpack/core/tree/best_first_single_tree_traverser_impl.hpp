@@ -0,0 +1,125 @@
+/**
+ * @file best_first_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the best-first single-tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "best_first_single_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType, typename RuleType>
+BestFirstSingleTreeTraverser<TreeType, RuleType>::BestFirstSingleTreeTraverser(
+    RuleType& rule,
+    const size_t maxLeaves,
+    const Clock::time_point deadline) :
+    rule(rule),
+    numPrunes(0),
+    maxLeaves(maxLeaves),
+    deadline(deadline),
+    numVisitedLeaves(0),
+    exact(true)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::Traverse(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  numVisitedLeaves = 0;
+  exact = true;
+  queue.clear();
+  QueueNode(queryIndex, referenceNode);
+
+  while (!queue.empty())
+  {
+    std::pop_heap(queue.begin(), queue.end(), QueueCompare());
+    const QueueEntry entry = queue.back();
+    queue.pop_back();
+    TreeType& node = *entry.second;
+
+    // The candidates may have improved since the node was queued.
+    if (rule.Rescore(queryIndex, node, entry.first) == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    // This node could still improve the result, so if the budget is spent,
+    // the result is not exact.
+    if (BudgetSpent())
+    {
+      exact = false;
+      numPrunes += queue.size() + 1;
+      break;
+    }
+
+    for (size_t i = 0; i < node.NumPoints(); ++i)
+      rule.BaseCase(queryIndex, node.Point(i));
+
+    if (node.IsLeaf())
+      ++numVisitedLeaves;
+    else
+      QueueChildren(queryIndex, node, std::integral_constant<bool,
+          IsSpillTree<TreeType>::value>());
+  }
+}
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::QueueChildren(
+    const size_t queryIndex,
+    TreeType& referenceNode,
+    const std::false_type /* isSpillTree */)
+{
+  for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
+    QueueNode(queryIndex, referenceNode.Child(i));
+}
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::QueueChildren(
+    const size_t queryIndex,
+    TreeType& referenceNode,
+    const std::true_type /* isSpillTree */)
+{
+  if (!referenceNode.Overlap())
+  {
+    QueueChildren(queryIndex, referenceNode, std::false_type());
+    return;
+  }
+
+  // Defeatist search: the other child is not visited.
+  const size_t bestChild = rule.GetBestChild(queryIndex, referenceNode);
+  QueueNode(queryIndex, referenceNode.Child(bestChild));
+  ++numPrunes;
+  exact = false;
+}
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::QueueNode(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  const double score = rule.Score(queryIndex, referenceNode);
+  if (score == DBL_MAX)
+  {
+    ++numPrunes;
+    return;
+  }
+
+  queue.push_back(QueueEntry(score, &referenceNode));
+  std::push_heap(queue.begin(), queue.end(), QueueCompare());
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -14,11 +14,30 @@
 #include <mlpack/prereqs.hpp>
 
 #include "../statistic.hpp"
+#include "../hrectbound.hpp"
+#include "../fixed_hrectbound.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+/**
+ * The order in which BinarySpaceTree::Compact() stores the nodes of a tree.
+ */
+enum NodeLayout
+{
+  //! Level by level, starting at the root.
+  BREADTH_FIRST_LAYOUT,
+  //! Recursively, the top half of the levels and then each subtree below
+  //! them; this is cache-oblivious.
+  VAN_EMDE_BOAS_LAYOUT
+};
+
 /**
  * A binary space partitioning tree, such as a KD-tree or a ball tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -88,6 +107,11 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If this is the root of a tree compacted with Compact(), the memory holding
+  //! all other nodes and the bounds; otherwise NULL.
+  char* arena;
+  //! The number of nodes held in the arena.
+  size_t arenaNodes;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -300,6 +324,21 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Move all nodes of the tree into one contiguous block of memory, in
+   * breadth-first or van Emde Boas order, so that traversals touch fewer cache
+   * lines and pages.  If the bound is an HRectBound, the ranges of all bounds
+   * are stored contiguously in the same order after the nodes.  The results of
+   * all algorithms are unchanged.
+   *
+   * This can only be called on the root.  The root itself does not move, but
+   * pointers and references to all other nodes are invalidated, and those
+   * nodes must not be deleted individually afterwards.
+   *
+   * @param layout The order of the nodes in memory.
+   */
+  void Compact(const NodeLayout layout = BREADTH_FIRST_LAYOUT);
+
   //! Return the bound object for this node.
   const BoundType<MetricType>& Bound() const { return bound; }
   //! Return the bound object for this node.
@@ -514,6 +553,110 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Construct this node as a child of the given parent, starting at column
+   * begin and using count points, without splitting it.  This is used by
+   * ParallelSplitNode(), which splits the node (and computes its statistic)
+   * later.
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of point to start tree construction with.
+   * @param count Number of points to use to construct tree.
+   */
+  BinarySpaceTree(BinarySpaceTree* parent,
+                  const size_t begin,
+                  const size_t count);
+
+  /**
+   * Split the current node and build the whole tree below it with all threads.
+   * The nodes holding many points are split first (their partitions are
+   * themselves parallel), and the subtrees below them are then built by
+   * different threads.  This is only used for splitters whose SplitTraits
+   * allow it.
+   *
+   * @param oldFromNew Vector holding permuted indices, or NULL if the indices
+   *     are not tracked.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void ParallelSplitNode(std::vector<size_t>* oldFromNew,
+                         const size_t maxLeafSize,
+                         SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Split the current node and its descendants holding more than taskSize
+   * points.  The other nodes are not split; they are added to the list of
+   * subtrees to build.
+   *
+   * @param oldFromNew Vector holding permuted indices, or NULL if the indices
+   *     are not tracked.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   * @param taskSize Maximum number of points in a subtree built by one thread.
+   * @param topNodes Filled with the split nodes, in depth-first order.
+   * @param tasks Filled with the nodes that still have to be split.
+   */
+  void SplitTopNode(std::vector<size_t>* oldFromNew,
+                    const size_t maxLeafSize,
+                    SplitType<BoundType<MetricType>, MatType>& splitter,
+                    const size_t taskSize,
+                    std::vector<BinarySpaceTree*>& topNodes,
+                    std::vector<BinarySpaceTree*>& tasks);
+
+  /**
+   * Append the nodes of the given subtree that are less than the given number
+   * of levels deep to the given list, in van Emde Boas order.
+   */
+  static void VanEmdeBoasOrder(BinarySpaceTree* node,
+                               const size_t levels,
+                               std::vector<BinarySpaceTree*>& order);
+
+  //! Return the number of levels of the given subtree.
+  static size_t Levels(const BinarySpaceTree* node);
+
+  //! Destroy the nodes held in the arena and free it, if there is one.
+  void FreeArena();
+
+  //! Return the number of bytes of arena memory needed for a bound; only
+  //! HRectBound is stored in the arena.
+  template<typename BoundType2>
+  static size_t ArenaBoundSize(const BoundType2& /* bound */) { return 0; }
+
+  //! Return the number of bytes of arena memory needed for an HRectBound.
+  template<typename BoundMetricType, typename BoundElemType>
+  static size_t ArenaBoundSize(
+      const bound::HRectBound<BoundMetricType, BoundElemType>& bound)
+  { return bound.Dim() * sizeof(math::RangeType<BoundElemType>); }
+
+  //! A fixed-dimensionality HRectBound holds its ranges itself, so it needs no
+  //! arena memory.
+  template<size_t BoundDim, int BoundPower, bool BoundTakeRoot,
+           typename BoundElemType>
+  static size_t ArenaBoundSize(
+      const bound::HRectBound<metric::FixedLMetric<BoundDim, BoundPower,
+          BoundTakeRoot>, BoundElemType>& /* bound */)
+  { return 0; }
+
+  //! Move a bound into the arena; other bounds keep their own memory.
+  template<typename BoundType2>
+  static void RelocateBound(BoundType2& /* bound */, char* /* memory */) { }
+
+  //! Move the ranges of an HRectBound into the arena.
+  template<typename BoundMetricType, typename BoundElemType>
+  static void RelocateBound(
+      bound::HRectBound<BoundMetricType, BoundElemType>& bound,
+      char* memory)
+  { bound.Relocate((math::RangeType<BoundElemType>*) memory); }
+
+  //! A fixed-dimensionality HRectBound moves along with its node.
+  template<size_t BoundDim, int BoundPower, bool BoundTakeRoot,
+           typename BoundElemType>
+  static void RelocateBound(
+      bound::HRectBound<metric::FixedLMetric<BoundDim, BoundPower,
+          BoundTakeRoot>, BoundElemType>& /* bound */,
+      char* /* memory */)
+  { }
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
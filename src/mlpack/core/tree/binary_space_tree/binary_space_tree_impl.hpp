@@ -17,6 +17,7 @@
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <queue>
+#include <unordered_map>
 
 namespace mlpack {
 namespace tree {
@@ -40,7 +41,9 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(NULL),
+    arenaNodes(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -68,7 +71,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(NULL),
+    arenaNodes(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -102,7 +107,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(NULL),
+    arenaNodes(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -137,7 +144,9 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(NULL),
+    arenaNodes(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -165,7 +174,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(NULL),
+    arenaNodes(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -199,7 +210,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(NULL),
+    arenaNodes(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -238,7 +251,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    arena(NULL),
+    arenaNodes(0)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -267,7 +282,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    arena(NULL),
+    arenaNodes(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -301,7 +318,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    arena(NULL),
+    arenaNodes(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -342,7 +361,9 @@ BinarySpaceTree(
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    arena(NULL),
+    arenaNodes(0)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -400,7 +421,9 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    arena(other.arena),
+    arenaNodes(other.arenaNodes)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -412,6 +435,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.arena = NULL;
+  other.arenaNodes = 0;
 
   // Set new parent.
   if (left)
@@ -455,6 +480,9 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
+  // If the tree was compacted, the other nodes are held in the arena.
+  FreeArena();
+
   delete left;
   delete right;
 
@@ -463,6 +491,180 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     delete dataset;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Compact(const NodeLayout layout)
+{
+  if (parent)
+  {
+    Log::Fatal << "BinarySpaceTree::Compact() can only be called on the root "
+        << "of the tree!" << std::endl;
+  }
+
+  // Find the new order of the nodes.  The root always comes first, and every
+  // parent comes before its children.
+  std::vector<BinarySpaceTree*> order;
+  if (layout == BREADTH_FIRST_LAYOUT)
+  {
+    order.push_back(this);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+      if (order[i]->left)
+        order.push_back(order[i]->left);
+      if (order[i]->right)
+        order.push_back(order[i]->right);
+    }
+  }
+  else
+  {
+    VanEmdeBoasOrder(this, Levels(this), order);
+  }
+
+  // The arena holds all nodes but the root, followed by the bounds of all
+  // nodes (if they are stored in the arena).
+  const size_t numNodes = order.size() - 1;
+  const size_t boundSize = ArenaBoundSize(bound);
+  const size_t nodeBytes = numNodes * sizeof(BinarySpaceTree);
+  char* newArena = (char*) ::operator new(nodeBytes +
+      order.size() * boundSize);
+  BinarySpaceTree* nodes = (BinarySpaceTree*) newArena;
+
+  // Move the nodes into the arena.  Since parents are moved before their
+  // children, the move constructor sets the new parent of every child.
+  std::unordered_map<const BinarySpaceTree*, BinarySpaceTree*> newFromOld;
+  for (size_t i = 1; i < order.size(); ++i)
+  {
+    new (nodes + i - 1) BinarySpaceTree(std::move(*order[i]));
+    newFromOld[order[i]] = nodes + i - 1;
+  }
+
+  // Now point every node to the new children, and move the bounds.
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    BinarySpaceTree* node = (i == 0) ? this : nodes + i - 1;
+    if (node->left)
+      node->left = newFromOld[node->left];
+    if (node->right)
+      node->right = newFromOld[node->right];
+
+    RelocateBound(node->bound, newArena + nodeBytes + i * boundSize);
+  }
+
+  // The old nodes are empty now; free them.
+  if (arena)
+  {
+    for (size_t i = 1; i < order.size(); ++i)
+      order[i]->~BinarySpaceTree();
+    ::operator delete(arena);
+  }
+  else
+  {
+    for (size_t i = 1; i < order.size(); ++i)
+      delete order[i];
+  }
+
+  arena = newArena;
+  arenaNodes = numNodes;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    VanEmdeBoasOrder(BinarySpaceTree* node,
+                     const size_t levels,
+                     std::vector<BinarySpaceTree*>& order)
+{
+  if (levels == 1)
+  {
+    order.push_back(node);
+    return;
+  }
+
+  // First the top half of the levels.
+  const size_t topLevels = levels / 2;
+  VanEmdeBoasOrder(node, topLevels, order);
+
+  // Then each subtree below them, from left to right.
+  std::vector<std::pair<BinarySpaceTree*, size_t>> stack;
+  stack.push_back(std::make_pair(node, 0));
+  std::vector<BinarySpaceTree*> roots;
+  while (!stack.empty())
+  {
+    BinarySpaceTree* current = stack.back().first;
+    const size_t depth = stack.back().second;
+    stack.pop_back();
+
+    if (depth == topLevels)
+    {
+      roots.push_back(current);
+      continue;
+    }
+
+    // Push the right child first, so that the left child is visited first.
+    if (current->right)
+      stack.push_back(std::make_pair(current->right, depth + 1));
+    if (current->left)
+      stack.push_back(std::make_pair(current->left, depth + 1));
+  }
+
+  for (size_t i = 0; i < roots.size(); ++i)
+    VanEmdeBoasOrder(roots[i], levels - topLevels, order);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+    SplitType>::Levels(const BinarySpaceTree* node)
+{
+  size_t levels = 1;
+  if (node->left)
+    levels = std::max(levels, 1 + Levels(node->left));
+  if (node->right)
+    levels = std::max(levels, 1 + Levels(node->right));
+  return levels;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    FreeArena()
+{
+  if (!arena)
+    return;
+
+  // Destroy the nodes without letting them delete their children.
+  BinarySpaceTree* nodes = (BinarySpaceTree*) arena;
+  for (size_t i = 0; i < arenaNodes; ++i)
+  {
+    nodes[i].left = NULL;
+    nodes[i].right = NULL;
+    nodes[i].~BinarySpaceTree();
+  }
+  ::operator delete(arena);
+
+  arena = NULL;
+  arenaNodes = 0;
+  left = NULL;
+  right = NULL;
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -747,6 +949,16 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     SplitNode(const size_t maxLeafSize,
               SplitType<BoundType<MetricType>, MatType>& splitter)
 {
+#ifdef HAS_OPENMP
+  // The root node builds the tree with all threads, if the splitter allows it.
+  if (!parent && SplitTraits<Split>::ParallelSplits &&
+      omp_get_max_threads() > 1 && !omp_in_parallel())
+  {
+    ParallelSplitNode(NULL, maxLeafSize, splitter);
+    return;
+  }
+#endif
+
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
 
@@ -813,6 +1025,16 @@ SplitNode(std::vector<size_t>& oldFromNew,
           const size_t maxLeafSize,
           SplitType<BoundType<MetricType>, MatType>& splitter)
 {
+#ifdef HAS_OPENMP
+  // The root node builds the tree with all threads, if the splitter allows it.
+  if (!parent && SplitTraits<Split>::ParallelSplits &&
+      omp_get_max_threads() > 1 && !omp_in_parallel())
+  {
+    ParallelSplitNode(&oldFromNew, maxLeafSize, splitter);
+    return;
+  }
+#endif
+
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
 
@@ -869,6 +1091,159 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    BinarySpaceTree* parent,
+    const size_t begin,
+    const size_t count) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    begin(begin),
+    count(count),
+    bound(parent->Dataset().n_rows),
+    parentDistance(0),
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    arena(NULL),
+    arenaNodes(0)
+{
+  // The node is split later by ParallelSplitNode().
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelSplitNode(std::vector<size_t>* oldFromNew,
+                  const size_t maxLeafSize,
+                  SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+#ifdef HAS_OPENMP
+  // Split the large nodes serially (their partitions use all threads) until
+  // there are enough subtrees to keep every thread busy.
+  const size_t tasksPerThread = 8;
+  const size_t taskSize = std::max(maxLeafSize,
+      count / (tasksPerThread * omp_get_max_threads()));
+
+  std::vector<BinarySpaceTree*> topNodes, tasks;
+  SplitTopNode(oldFromNew, maxLeafSize, splitter, taskSize, topNodes, tasks);
+
+  // Now build the remaining subtrees in parallel.  The subtrees hold disjoint
+  // ranges of points, so they can be built independently; each thread uses its
+  // own copy of the splitter.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) tasks.size(); ++i)
+  {
+    Split taskSplitter(splitter);
+    if (oldFromNew)
+      tasks[i]->SplitNode(*oldFromNew, maxLeafSize, taskSplitter);
+    else
+      tasks[i]->SplitNode(maxLeafSize, taskSplitter);
+
+    tasks[i]->stat = StatisticType(*tasks[i]);
+  }
+
+  // Finally, finish the split nodes bottom-up, since their parent distances and
+  // statistics depend on their children.  The statistic of this node is
+  // created by the constructor.
+  for (size_t i = topNodes.size(); i > 0; --i)
+  {
+    BinarySpaceTree* node = topNodes[i - 1];
+    if (node->left)
+    {
+      arma::vec center, leftCenter, rightCenter;
+      node->Center(center);
+      node->left->Center(leftCenter);
+      node->right->Center(rightCenter);
+
+      node->left->ParentDistance() = MetricType::Evaluate(center, leftCenter);
+      node->right->ParentDistance() = MetricType::Evaluate(center,
+          rightCenter);
+    }
+
+    if (node != this)
+      node->stat = StatisticType(*node);
+  }
+#else
+  // Without OpenMP this is never called; just split the node serially.
+  if (oldFromNew)
+    SplitNode(*oldFromNew, maxLeafSize, splitter);
+  else
+    SplitNode(maxLeafSize, splitter);
+#endif
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SplitTopNode(std::vector<size_t>* oldFromNew,
+             const size_t maxLeafSize,
+             SplitType<BoundType<MetricType>, MatType>& splitter,
+             const size_t taskSize,
+             std::vector<BinarySpaceTree*>& topNodes,
+             std::vector<BinarySpaceTree*>& tasks)
+{
+  // Small nodes are built later, by a single thread.
+  if (parent && count <= taskSize)
+  {
+    tasks.push_back(this);
+    return;
+  }
+
+  topNodes.push_back(this);
+
+  // We need to expand the bounds of this node properly.
+  UpdateBound(bound);
+
+  // Calculate the furthest descendant distance.
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // First, check if we need to split at all.
+  if (count <= maxLeafSize)
+    return; // We can't split this.
+
+  // Find the partition of the node. This method does not perform the split.
+  typename Split::SplitInfo splitInfo;
+
+  const bool split = splitter.SplitNode(bound, *dataset, begin, count,
+      splitInfo);
+
+  // The node may not be always split. For instance, if all the points are the
+  // same, we can't split them.
+  if (!split)
+    return;
+
+  // Perform the actual splitting.
+  const size_t splitCol = oldFromNew ?
+      splitter.PerformSplit(*dataset, begin, count, splitInfo, *oldFromNew) :
+      splitter.PerformSplit(*dataset, begin, count, splitInfo);
+
+  assert(splitCol > begin);
+  assert(splitCol < begin + count);
+
+  // Create the children without splitting them, and then recurse.
+  left = new BinarySpaceTree(this, begin, splitCol - begin);
+  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol);
+
+  left->SplitTopNode(oldFromNew, maxLeafSize, splitter, taskSize, topNodes,
+      tasks);
+  right->SplitTopNode(oldFromNew, maxLeafSize, splitter, taskSize, topNodes,
+      tasks);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -926,7 +1301,9 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    arena(NULL),
+    arenaNodes(0)
 {
   // Nothing to do.
 }
@@ -947,6 +1324,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
+    FreeArena();
     if (left)
       delete left;
     if (right)
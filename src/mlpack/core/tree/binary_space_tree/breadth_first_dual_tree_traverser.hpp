@@ -16,9 +16,10 @@
 #define MLPACK_CORE_TREE_BINARY_SPACE_TREE_BF_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
-#include <queue>
 
 #include "../binary_space_tree.hpp"
+#include "../leaf_base_case.hpp"
+#include "../traversal_scratch.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -61,8 +62,18 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
    */
   void Traverse(BinarySpaceTree& queryNode,
                 BinarySpaceTree& referenceNode);
+
+  /**
+   * Traverse the node combinations of the given queue, all with the given
+   * query node, and then recurse into the children of the query node.  The
+   * queue is a heap (see std::push_heap()) ordered by the query depth and the
+   * score of the combinations; it is empty when this returns.
+   *
+   * @param queryNode The query node of all combinations of the queue.
+   * @param referenceQueue The node combinations to traverse.
+   */
   void Traverse(BinarySpaceTree& queryNode,
-                std::priority_queue<QueueFrameType>& referenceQueue);
+                std::vector<QueueFrameType>& referenceQueue);
 
   //! Get the number of prunes.
   size_t NumPrunes() const { return numPrunes; }
@@ -103,6 +114,10 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! The queues of the children of each level of the recursion, reused for
+  //! every node.
+  TraversalScratch<QueueFrameType> queues;
 };
 
 } // namespace tree
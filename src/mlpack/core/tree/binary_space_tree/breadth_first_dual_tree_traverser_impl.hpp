@@ -73,7 +73,7 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   if (rootScore == DBL_MAX)
     return; // This probably means something is wrong.
 
-  std::priority_queue<QueueFrameType> queue;
+  ScratchVector<QueueFrameType> queue(queues);
 
   QueueFrameType rootFrame;
   rootFrame.queryNode = &queryRoot;
@@ -82,10 +82,10 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   rootFrame.score = 0.0;
   rootFrame.traversalInfo = rule.TraversalInfo();
 
-  queue.push(rootFrame);
+  queue.Vector().push_back(rootFrame);
 
   // Start the traversal.
-  Traverse(queryRoot, queue);
+  Traverse(queryRoot, queue.Vector());
 }
 
 template<typename MetricType,
@@ -99,17 +99,20 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 BreadthFirstDualTreeTraverser<RuleType>::Traverse(
     BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
         queryNode,
-    std::priority_queue<QueueFrameType>& referenceQueue)
+    std::vector<QueueFrameType>& referenceQueue)
 {
   // Store queues for the children.  We will recurse into the children once our
   // queue is empty.
-  std::priority_queue<QueueFrameType> leftChildQueue;
-  std::priority_queue<QueueFrameType> rightChildQueue;
+  ScratchVector<QueueFrameType> leftChildBuffer(queues);
+  ScratchVector<QueueFrameType> rightChildBuffer(queues);
+  std::vector<QueueFrameType>& leftChildQueue = leftChildBuffer.Vector();
+  std::vector<QueueFrameType>& rightChildQueue = rightChildBuffer.Vector();
 
   while (!referenceQueue.empty())
   {
-    QueueFrameType currentFrame = referenceQueue.top();
-    referenceQueue.pop();
+    std::pop_heap(referenceQueue.begin(), referenceQueue.end());
+    QueueFrameType currentFrame = referenceQueue.back();
+    referenceQueue.pop_back();
 
     BinarySpaceTree& queryNode = *currentFrame.queryNode;
     BinarySpaceTree& referenceNode = *currentFrame.referenceNode;
@@ -127,7 +130,13 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
     }
 
     // If both are leaves, we must evaluate the base case.
-    if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+    if (queryNode.IsLeaf() && referenceNode.IsLeaf() &&
+        LeafBaseCase(rule, queryNode, referenceNode))
+    {
+      // The rules evaluated all base cases between the two leaves at once.
+      numBaseCases += queryNode.Count() * referenceNode.Count();
+    }
+    else if (queryNode.IsLeaf() && referenceNode.IsLeaf())
     {
       // Loop through each of the points in each node.
       const size_t queryEnd = queryNode.Begin() + queryNode.Count();
@@ -153,11 +162,13 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
       // We have to recurse down the query node.
       QueueFrameType fl = { queryNode.Left(), &referenceNode, queryDepth + 1,
           score, rule.TraversalInfo() };
-      leftChildQueue.push(fl);
+      leftChildQueue.push_back(fl);
+      std::push_heap(leftChildQueue.begin(), leftChildQueue.end());
 
       QueueFrameType fr = { queryNode.Right(), &referenceNode, queryDepth + 1,
           score, ti };
-      rightChildQueue.push(fr);
+      rightChildQueue.push_back(fr);
+      std::push_heap(rightChildQueue.begin(), rightChildQueue.end());
     }
     else if (queryNode.IsLeaf() && (!referenceNode.IsLeaf()))
     {
@@ -166,11 +177,13 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
       // traversal information correctly.
       QueueFrameType fl = { &queryNode, referenceNode.Left(), queryDepth,
           score, rule.TraversalInfo() };
-      referenceQueue.push(fl);
+      referenceQueue.push_back(fl);
+      std::push_heap(referenceQueue.begin(), referenceQueue.end());
 
       QueueFrameType fr = { &queryNode, referenceNode.Right(), queryDepth,
           score, ti };
-      referenceQueue.push(fr);
+      referenceQueue.push_back(fr);
+      std::push_heap(referenceQueue.begin(), referenceQueue.end());
     }
     else
     {
@@ -180,19 +193,23 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
       // correctly.
       QueueFrameType fll = { queryNode.Left(), referenceNode.Left(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      leftChildQueue.push(fll);
+      leftChildQueue.push_back(fll);
+      std::push_heap(leftChildQueue.begin(), leftChildQueue.end());
 
       QueueFrameType flr = { queryNode.Left(), referenceNode.Right(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      leftChildQueue.push(flr);
+      leftChildQueue.push_back(flr);
+      std::push_heap(leftChildQueue.begin(), leftChildQueue.end());
 
       QueueFrameType frl = { queryNode.Right(), referenceNode.Left(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      rightChildQueue.push(frl);
+      rightChildQueue.push_back(frl);
+      std::push_heap(rightChildQueue.begin(), rightChildQueue.end());
 
       QueueFrameType frr = { queryNode.Right(), referenceNode.Right(),
           queryDepth + 1, score, rule.TraversalInfo() };
-      rightChildQueue.push(frr);
+      rightChildQueue.push_back(frr);
+      std::push_heap(rightChildQueue.begin(), rightChildQueue.end());
     }
   }
 
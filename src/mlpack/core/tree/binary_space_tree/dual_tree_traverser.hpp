@@ -18,6 +18,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "binary_space_tree.hpp"
+#include "../leaf_base_case.hpp"
 
 namespace mlpack {
 namespace tree {
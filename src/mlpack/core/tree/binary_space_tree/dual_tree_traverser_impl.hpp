@@ -56,8 +56,14 @@ DualTreeTraverser<RuleType>::Traverse(
   // Store the current traversal info.
   traversalInfo = rule.TraversalInfo();
 
-  // If both are leaves, we must evaluate the base case.
-  if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+  // If both are leaves, we must evaluate the base case.  The rules may
+  // evaluate all base cases between the two leaves at once.
+  if (queryNode.IsLeaf() && referenceNode.IsLeaf() &&
+      LeafBaseCase(rule, queryNode, referenceNode))
+  {
+    numBaseCases += queryNode.Count() * referenceNode.Count();
+  }
+  else if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
     // Loop through each of the points in each node.
     const size_t queryEnd = queryNode.Begin() + queryNode.Count();
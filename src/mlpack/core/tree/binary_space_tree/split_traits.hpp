@@ -0,0 +1,65 @@
+/**
+ * @file split_traits.hpp
+ *
+ * Definition of the SplitTraits class, which describes properties of the
+ * splitting strategies used by the BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "midpoint_split.hpp"
+#include "mean_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SplitTraits class provides compile-time information about a split type
+ * of the BinarySpaceTree.  By default nothing is assumed about the splitter;
+ * specialize this class for a split type to enable the optimizations that
+ * depend on it.
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * This is true if copies of the splitter may split disjoint nodes at the
+   * same time, and the result does not depend on the order in which the nodes
+   * are split.  The BinarySpaceTree then builds its subtrees in parallel.
+   * Splitters that draw random numbers or that modify state shared between
+   * nodes must leave this false.
+   */
+  static const bool ParallelSplits = false;
+};
+
+/**
+ * The midpoint split only depends on the bound of the node.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MidpointSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ParallelSplits = true;
+};
+
+/**
+ * The mean split only depends on the points of the node.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MeanSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ParallelSplits = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
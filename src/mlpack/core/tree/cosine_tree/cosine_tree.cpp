@@ -29,11 +29,11 @@ CosineTree::CosineTree(const arma::mat& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
-  for (size_t i = 0; i < numColumns; i++)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     indices[i] = i;
-    double l2Norm = arma::norm(dataset.col(i), 2);
-    l2NormsSquared(i) = l2Norm * l2Norm;
+    l2NormsSquared(i) = arma::dot(dataset.col(i), dataset.col(i));
   }
 
   // Frobenius norm of columns in the node.
@@ -91,6 +91,25 @@ CosineTree::CosineTree(const arma::mat& dataset,
   root.BasisVector(tempVector);
   treeQueue.push(&root);
 
+  // The basis vectors of the nodes in the queue are also held as the columns
+  // of a matrix (in no particular order), so that projections onto the basis
+  // are matrix products.
+  arma::mat basisMatrix = tempVector;
+  std::vector<CosineTree*> basisNodes(1, &root);
+
+  // The Monte Carlo error of the root is estimated on a fixed sample of its
+  // columns.  The coefficients of the projections of the sample onto every
+  // basis vector (one row per column of basisMatrix) are kept, so a split only
+  // needs the projections onto the two new basis vectors.
+  std::vector<size_t> rootSamples;
+  arma::vec rootProbabilities;
+  root.ColumnSamplesLS(rootSamples, rootProbabilities,
+      (size_t) log(root.NumColumns()) + 1);
+  const arma::mat rootSampleData = dataset.cols(
+      arma::conv_to<arma::uvec>::from(rootSamples));
+  arma::mat rootCoefficients = arma::zeros(1, rootSamples.size());
+  arma::vec rootMagnitudes = arma::zeros(rootSamples.size());
+
   // Initialize Monte Carlo error estimate for comparison.
   double monteCarloError = root.FrobNormSquared();
 
@@ -113,6 +132,19 @@ CosineTree::CosineTree(const arma::mat& dataset,
       break;
     }
 
+    // Remove the basis vector of the node (moving the last one in its place),
+    // and its share of the projections of the root sample.
+    const size_t index = std::find(basisNodes.begin(), basisNodes.end(),
+        currentNode) - basisNodes.begin();
+    const size_t last = basisNodes.size() - 1;
+    rootMagnitudes -= arma::square(rootCoefficients.row(index).t());
+    basisMatrix.col(index) = basisMatrix.col(last);
+    basisMatrix.shed_col(last);
+    rootCoefficients.row(index) = rootCoefficients.row(last);
+    rootCoefficients.shed_row(last);
+    basisNodes[index] = basisNodes[last];
+    basisNodes.pop_back();
+
     // Split the node into left and right children.  We assume that this cannot
     // fail; it might fail if L2Error() is 0, but we have already avoided that
     // case.
@@ -126,24 +158,35 @@ CosineTree::CosineTree(const arma::mat& dataset,
     // Calculate basis vectors of left and right children.
     arma::vec lBasisVector, rBasisVector;
 
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
-                        &lBasisVector);
+    GramSchmidt(basisMatrix, currentLeft->Centroid(), lBasisVector);
+    GramSchmidt(basisMatrix, currentRight->Centroid(), rBasisVector,
+                &lBasisVector);
 
     // Add basis vectors to their respective nodes.
     currentLeft->BasisVector(lBasisVector);
     currentRight->BasisVector(rBasisVector);
 
+    // Add them to the basis, with the projections of the root sample.
+    basisMatrix.insert_cols(basisMatrix.n_cols,
+        arma::join_rows(lBasisVector, rBasisVector));
+    basisNodes.push_back(currentLeft);
+    basisNodes.push_back(currentRight);
+    const arma::mat newCoefficients = arma::join_rows(lBasisVector,
+        rBasisVector).t() * rootSampleData;
+    rootCoefficients.insert_rows(rootCoefficients.n_rows, newCoefficients);
+    rootMagnitudes += arma::sum(arma::square(newCoefficients), 0).t();
+
     // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentLeft, basisMatrix);
+    MonteCarloError(currentRight, basisMatrix);
 
     // Push child nodes into the priority queue.
     treeQueue.push(currentLeft);
     treeQueue.push(currentRight);
 
     // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    monteCarloError = MonteCarloBound(&root, rootMagnitudes /
+        rootProbabilities);
   }
 
   // Construct the subspace basis from the current priority queue.
@@ -192,6 +235,25 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
     newBasisVector /= arma::norm(newBasisVector, 2);
 }
 
+void CosineTree::GramSchmidt(const arma::mat& basis,
+                             const arma::vec& centroid,
+                             arma::vec& newBasisVector,
+                             const arma::vec* addBasisVector)
+{
+  // Remove the projection of the centroid onto every basis vector; this is
+  // the same as ModifiedGramSchmidt(), with two matrix-vector products.
+  newBasisVector = centroid - basis * (basis.t() * centroid);
+
+  // If additional basis vector is passed, take it into account.
+  if (addBasisVector)
+    newBasisVector -= *addBasisVector * arma::dot(*addBasisVector, centroid);
+
+  // Normalize the modified centroid vector.
+  const double norm = arma::norm(newBasisVector, 2);
+  if (norm)
+    newBasisVector /= norm;
+}
+
 double CosineTree::MonteCarloError(CosineTree* node,
                                    CosineNodeQueue& treeQueue,
                                    arma::vec* addBasisVector1,
@@ -205,8 +267,8 @@ double CosineTree::MonteCarloError(CosineTree* node,
   size_t numSamples = log(node->NumColumns()) + 1;
   node->ColumnSamplesLS(sampledIndices, probabilities, numSamples);
 
-  // Get pointer to the original dataset.
-  arma::mat dataset = node->GetDataset();
+  // Get the original dataset.
+  const arma::mat& dataset = node->GetDataset();
 
   // Initialize weighted projection magnitudes as zeros.
   arma::vec weightedMagnitudes;
@@ -256,6 +318,30 @@ double CosineTree::MonteCarloError(CosineTree* node,
     weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
   }
 
+  return MonteCarloBound(node, weightedMagnitudes);
+}
+
+double CosineTree::MonteCarloError(CosineTree* node, const arma::mat& basis)
+{
+  std::vector<size_t> sampledIndices;
+  arma::vec probabilities;
+
+  // Sample O(log m) points from the input node's distribution.
+  // 'm' is the number of columns present in the node.
+  size_t numSamples = log(node->NumColumns()) + 1;
+  node->ColumnSamplesLS(sampledIndices, probabilities, numSamples);
+
+  // Project all the samples onto the basis at once.
+  const arma::mat coefficients = basis.t() * node->GetDataset().cols(
+      arma::conv_to<arma::uvec>::from(sampledIndices));
+
+  return MonteCarloBound(node, arma::sum(arma::square(coefficients), 0).t() /
+      probabilities);
+}
+
+double CosineTree::MonteCarloBound(CosineTree* node,
+                                   const arma::vec& weightedMagnitudes)
+{
   // Compute mean and standard deviation of the weighted samples.
   double mu = arma::mean(weightedMagnitudes);
   double sigma = arma::stddev(weightedMagnitudes);
@@ -424,19 +510,24 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; i++)
+  // The squared norms of the columns are known, so only the dot products are
+  // computed.
+  const double splitNormSquared = l2NormsSquared(splitPointIndex);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
-    if (l2NormsSquared(i) == 0)
+    if (l2NormsSquared(i) == 0 || splitNormSquared == 0)
     {
       cosines(i) = 0;
     }
     else
     {
-      cosines(i) =
-          std::abs(arma::norm_dot(dataset.col(indices[splitPointIndex]),
-                                  dataset.col(indices[i])));
+      cosines(i) = std::abs(arma::dot(dataset.col(indices[splitPointIndex]),
+          dataset.col(indices[i]))) / std::sqrt(splitNormSquared *
+          l2NormsSquared(i));
     }
   }
 }
@@ -446,10 +537,18 @@ void CosineTree::CalculateCentroid()
   // Initialize centroid as vector of zeros.
   centroid.zeros(dataset.n_rows);
 
-  // Calculate centroid of columns in the node.
-  for (size_t i = 0; i < numColumns; i++)
+  // Calculate centroid of columns in the node.  Every thread sums its share of
+  // the columns.
+  #pragma omp parallel
   {
-    centroid += dataset.col(indices[i]);
+    arma::vec localSum = arma::zeros(dataset.n_rows);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
+      localSum += dataset.col(indices[i]);
+
+    #pragma omp critical
+    centroid += localSum;
   }
   centroid /= numColumns;
 }
@@ -60,6 +60,11 @@ class CosineTree
    * input matrix's projection on the obtained subspace is less than a fraction
    * of the norm of the input matrix.
    *
+   * The basis is also held as a matrix, so that the orthonormalization of the
+   * centroids and the projections of the Monte Carlo samples are matrix
+   * products, and the root's error is estimated on one sample of its columns,
+   * whose projections onto the basis are kept from one split to the next.
+   *
    * @param dataset Matrix for which the CosineTree is constructed.
    * @param epsilon Error tolerance fraction for calculated subspace.
    * @param delta Cumulative probability for Monte Carlo error lower bound.
@@ -87,6 +92,20 @@ class CosineTree
                            arma::vec& newBasisVector,
                            arma::vec* addBasisVector = NULL);
 
+  /**
+   * Calculates the orthonormalization of the passed centroid, with respect to
+   * the vector subspace spanned by the columns of the given orthonormal basis.
+   *
+   * @param basis Orthonormal basis of the current vector subspace.
+   * @param centroid Centroid of the node being added to the basis.
+   * @param newBasisVector Orthonormalized centroid of the node.
+   * @param addBasisVector Address to additional basis vector.
+   */
+  void GramSchmidt(const arma::mat& basis,
+                   const arma::vec& centroid,
+                   arma::vec& newBasisVector,
+                   const arma::vec* addBasisVector = NULL);
+
   /**
    * Estimates the squared error of the projection of the input node's matrix
    * onto the current vector subspace. A normal distribution is fit using
@@ -104,6 +123,16 @@ class CosineTree
                          arma::vec* addBasisVector1 = NULL,
                          arma::vec* addBasisVector2 = NULL);
 
+  /**
+   * Estimates the squared error of the projection of the input node's matrix
+   * onto the vector subspace spanned by the columns of the given orthonormal
+   * basis, like the other overload.
+   *
+   * @param node Node for which Monte Carlo estimate is calculated.
+   * @param basis Orthonormal basis of the vector subspace.
+   */
+  double MonteCarloError(CosineTree* node, const arma::mat& basis);
+
   /**
    * Constructs the final basis matrix, after the cosine tree construction.
    *
@@ -213,6 +242,14 @@ class CosineTree
   size_t SplitPointIndex() const { return indices[splitPointIndex]; }
 
  private:
+  /**
+   * Set the Monte Carlo error of the node to the difference between its
+   * Frobenius norm and the lower bound of the given weighted squared norms of
+   * the projections of its samples, and return it.
+   */
+  double MonteCarloBound(CosineTree* node,
+                         const arma::vec& weightedMagnitudes);
+
   //! Matrix for which cosine tree is constructed.
   const arma::mat& dataset;
   //! Cumulative probability for Monte Carlo error lower bound.
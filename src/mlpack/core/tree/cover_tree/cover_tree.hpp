@@ -16,6 +16,7 @@
 #include <mlpack/core/math/range.hpp>
 
 #include "../statistic.hpp"
+#include "../leaf_base_case.hpp"
 #include "first_point_is_root.hpp"
 
 namespace mlpack {
@@ -348,11 +349,12 @@ class CoverTree
   ElemType MinDistance(const CoverTree& other, const ElemType distance) const;
 
   //! Return the minimum distance to another point.
-  ElemType MinDistance(const arma::vec& other) const;
+  ElemType MinDistance(const arma::Col<ElemType>& other) const;
 
   //! Return the minimum distance to another point given that the distance from
   //! the center to the point has already been calculated.
-  ElemType MinDistance(const arma::vec& other, const ElemType distance) const;
+  ElemType MinDistance(const arma::Col<ElemType>& other,
+                       const ElemType distance) const;
 
   //! Return the maximum distance to another node.
   ElemType MaxDistance(const CoverTree& other) const;
@@ -362,11 +364,12 @@ class CoverTree
   ElemType MaxDistance(const CoverTree& other, const ElemType distance) const;
 
   //! Return the maximum distance to another point.
-  ElemType MaxDistance(const arma::vec& other) const;
+  ElemType MaxDistance(const arma::Col<ElemType>& other) const;
 
   //! Return the maximum distance to another point given that the distance from
   //! the center to the point has already been calculated.
-  ElemType MaxDistance(const arma::vec& other, const ElemType distance) const;
+  ElemType MaxDistance(const arma::Col<ElemType>& other,
+                       const ElemType distance) const;
 
   //! Return the minimum and maximum distance to another node.
   math::RangeType<ElemType> RangeDistance(const CoverTree& other) const;
@@ -377,11 +380,12 @@ class CoverTree
                                           const ElemType distance) const;
 
   //! Return the minimum and maximum distance to another point.
-  math::RangeType<ElemType> RangeDistance(const arma::vec& other) const;
+  math::RangeType<ElemType> RangeDistance(
+      const arma::Col<ElemType>& other) const;
 
   //! Return the minimum and maximum distance to another point given that the
   //! point-to-point distance has already been calculated.
-  math::RangeType<ElemType> RangeDistance(const arma::vec& other,
+  math::RangeType<ElemType> RangeDistance(const arma::Col<ElemType>& other,
                                           const ElemType distance) const;
 
   //! Get the parent node.
@@ -409,9 +413,9 @@ class CoverTree
   ElemType MinimumBoundDistance() const { return furthestDescendantDistance; }
 
   //! Get the center of the node and store it in the given vector.
-  void Center(arma::vec& center) const
+  void Center(arma::Col<ElemType>& center) const
   {
-    center = arma::vec(dataset->col(point));
+    center = arma::Col<ElemType>(dataset->col(point));
   }
 
   //! Get the instantiated metric.
@@ -469,6 +473,29 @@ class CoverTree
                         const arma::Col<size_t>& indices,
                         arma::vec& distances,
                         const size_t pointSetSize);
+
+  /**
+   * Compute the distances one pair of points at a time, with the metric.  This
+   * is used for metrics and matrix types without a blocked evaluation.
+   */
+  void ComputeDistances(const size_t pointIndex,
+                        const arma::Col<size_t>& indices,
+                        arma::vec& distances,
+                        const size_t pointSetSize,
+                        const std::false_type /* blocked */);
+
+  /**
+   * Compute the Euclidean distances for blocks of points at a time: the points
+   * of each block are gathered into a matrix, so that one vectorized
+   * expression computes all their distances.  The blocks are split among the
+   * threads when there are many points.
+   */
+  void ComputeDistances(const size_t pointIndex,
+                        const arma::Col<size_t>& indices,
+                        arma::vec& distances,
+                        const size_t pointSetSize,
+                        const std::true_type /* blocked */);
+
   /**
    * Split the given indices and distances into a near and a far set, returning
    * the number of points in the near set.  The distances must already be
@@ -798,7 +798,7 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
 {
   // We already have the distance as evaluated by the metric.
   return std::max(distance - furthestDescendantDistance -
-      other.FurthestDescendantDistance(), 0.0);
+      other.FurthestDescendantDistance(), ElemType(0));
 }
 
 template<
@@ -810,7 +810,7 @@ template<
 typename CoverTree<MetricType, StatisticType, MatType,
     RootPointPolicy>::ElemType
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MinDistance(const arma::vec& other) const
+    MinDistance(const arma::Col<ElemType>& other) const
 {
   return std::max(metric->Evaluate(dataset->col(point), other) -
       furthestDescendantDistance, 0.0);
@@ -825,9 +825,10 @@ template<
 typename CoverTree<MetricType, StatisticType, MatType,
     RootPointPolicy>::ElemType
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MinDistance(const arma::vec& /* other */, const ElemType distance) const
+    MinDistance(const arma::Col<ElemType>& /* other */,
+                const ElemType distance) const
 {
-  return std::max(distance - furthestDescendantDistance, 0.0);
+  return std::max(distance - furthestDescendantDistance, ElemType(0));
 }
 
 template<
@@ -871,7 +872,7 @@ template<
 typename CoverTree<MetricType, StatisticType, MatType,
     RootPointPolicy>::ElemType
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MaxDistance(const arma::vec& other) const
+    MaxDistance(const arma::Col<ElemType>& other) const
 {
   return metric->Evaluate(dataset->col(point), other) +
       furthestDescendantDistance;
@@ -886,7 +887,8 @@ template<
 typename CoverTree<MetricType, StatisticType, MatType,
     RootPointPolicy>::ElemType
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MaxDistance(const arma::vec& /* other */, const ElemType distance) const
+    MaxDistance(const arma::Col<ElemType>& /* other */,
+                const ElemType distance) const
 {
   return distance + furthestDescendantDistance;
 }
@@ -948,7 +950,7 @@ template<
 math::RangeType<typename
     CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::ElemType>
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    RangeDistance(const arma::vec& other) const
+    RangeDistance(const arma::Col<ElemType>& other) const
 {
   const ElemType distance = metric->Evaluate(dataset->col(point), other);
 
@@ -967,7 +969,7 @@ template<
 math::RangeType<typename
     CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::ElemType>
 CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    RangeDistance(const arma::vec& /* other */,
+    RangeDistance(const arma::Col<ElemType>& /* other */,
                   const ElemType distance) const
 {
   return math::RangeType<ElemType>(distance - furthestDescendantDistance,
@@ -1241,15 +1243,71 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                      const size_t pointSetSize)
 {
   // For each point, rebuild the distances.  The indices do not need to be
-  // modified.
+  // modified.  The Euclidean distances of dense points are computed in blocks.
   distanceComps += pointSetSize;
-  for (size_t i = 0; i < pointSetSize; ++i)
+  ComputeDistances(pointIndex, indices, distances, pointSetSize,
+      std::integral_constant<bool,
+          LeafDistances<MetricType, MatType>::Supported>());
+}
+
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    ComputeDistances(const size_t pointIndex,
+                     const arma::Col<size_t>& indices,
+                     arma::vec& distances,
+                     const size_t pointSetSize,
+                     const std::false_type /* blocked */)
+{
+  // The point sets near the top of the tree are large, so their distances are
+  // computed by all threads.
+  #pragma omp parallel for if(pointSetSize >= 1000)
+  for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
         dataset->col(indices[i]));
   }
 }
 
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    ComputeDistances(const size_t pointIndex,
+                     const arma::Col<size_t>& indices,
+                     arma::vec& distances,
+                     const size_t pointSetSize,
+                     const std::true_type /* blocked */)
+{
+  const size_t blockSize = 512;
+  const size_t numBlocks = (pointSetSize + blockSize - 1) / blockSize;
+  const arma::Col<ElemType> queryPoint(dataset->col(pointIndex));
+
+  #pragma omp parallel for if(pointSetSize >= 1000)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, pointSetSize);
+
+    const arma::Mat<ElemType> block = dataset->cols(indices.subvec(begin,
+        end - 1));
+    arma::Row<ElemType> blockDistances = arma::sum(arma::square(
+        block.each_col() - queryPoint), 0);
+    if (MetricType::TakeRoot)
+      blockDistances = arma::sqrt(blockDistances);
+
+    distances.subvec(begin, end - 1) =
+        arma::conv_to<arma::vec>::from(blockDistances.t());
+  }
+}
+
 template<
     typename MetricType,
     typename StatisticType,
@@ -13,7 +13,8 @@
 #define MLPACK_CORE_TREE_COVER_TREE_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
-#include <queue>
+#include <deque>
+#include "scale_map.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -83,23 +84,40 @@ class CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
     }
   };
 
+  //! The reference set of a query node: the entries to consider for it, by
+  //! scale of their reference node.
+  typedef ScaleMap<DualCoverTreeMapEntry> ReferenceMap;
+
+  //! The reference sets of each depth of the recursion.  They are kept
+  //! between calls (a std::deque doesn't move them when it grows), so the
+  //! recursion reuses their memory instead of allocating new sets.
+  std::deque<ReferenceMap> referenceMaps;
+
+  //! The entries of the scale being expanded by ReferenceRecursion().
+  std::vector<DualCoverTreeMapEntry> expandedEntries;
+
+  //! Get the (empty) reference set of the given depth of the recursion.
+  ReferenceMap& EmptyReferenceMap(const size_t depth)
+  {
+    if (referenceMaps.size() <= depth)
+      referenceMaps.resize(depth + 1);
+    referenceMaps[depth].Clear();
+    return referenceMaps[depth];
+  }
+
   /**
    * Helper function for traversal of the two trees.
    */
   void Traverse(CoverTree& queryNode,
-                std::map<int, std::vector<DualCoverTreeMapEntry> >&
-                    referenceMap);
+                ReferenceMap& referenceMap,
+                const size_t depth);
 
   //! Prepare map for recursion.
   void PruneMap(CoverTree& queryNode,
-                std::map<int, std::vector<DualCoverTreeMapEntry> >&
-                    referenceMap,
-                std::map<int, std::vector<DualCoverTreeMapEntry> >&
-                    childMap);
-
-  void ReferenceRecursion(CoverTree& queryNode,
-                          std::map<int, std::vector<DualCoverTreeMapEntry> >&
-                              referenceMap);
+                ReferenceMap& referenceMap,
+                ReferenceMap& childMap);
+
+  void ReferenceRecursion(CoverTree& queryNode, ReferenceMap& referenceMap);
 };
 
 } // namespace tree
@@ -13,7 +13,6 @@
 #define MLPACK_CORE_TREE_COVER_TREE_DUAL_TREE_TRAVERSER_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include <queue>
 
 namespace mlpack {
 namespace tree {
@@ -42,8 +41,9 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
 DualTreeTraverser<RuleType>::Traverse(CoverTree& queryNode,
                                       CoverTree& referenceNode)
 {
-  // Start by creating a map and adding the reference root node to it.
-  std::map<int, std::vector<DualCoverTreeMapEntry> > refMap;
+  // Start by adding the reference root node to the reference set of the query
+  // root.
+  ReferenceMap& refMap = EmptyReferenceMap(0);
 
   DualCoverTreeMapEntry rootRefEntry;
 
@@ -57,7 +57,7 @@ DualTreeTraverser<RuleType>::Traverse(CoverTree& queryNode,
 
   refMap[referenceNode.Scale()].push_back(rootRefEntry);
 
-  Traverse(queryNode, refMap);
+  Traverse(queryNode, refMap, 0);
 }
 
 template<
@@ -68,40 +68,40 @@ template<
 >
 template<typename RuleType>
 void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-DualTreeTraverser<RuleType>::Traverse(
-    CoverTree& queryNode,
-    std::map<int, std::vector<DualCoverTreeMapEntry> >& referenceMap)
+DualTreeTraverser<RuleType>::Traverse(CoverTree& queryNode,
+                                      ReferenceMap& referenceMap,
+                                      const size_t depth)
 {
-  if (referenceMap.size() == 0)
+  if (referenceMap.Empty())
     return; // Nothing to do!
 
   // First recurse down the reference nodes as necessary.
   ReferenceRecursion(queryNode, referenceMap);
 
   // Did the map get emptied?
-  if (referenceMap.size() == 0)
+  if (referenceMap.Empty())
     return; // Nothing to do!
 
   // Now, reduce the scale of the query node by recursing.  But we can't recurse
   // if the query node is a leaf node.
   if ((queryNode.Scale() != INT_MIN) &&
-      (queryNode.Scale() >= (*referenceMap.rbegin()).first))
+      (queryNode.Scale() >= referenceMap.MaxScale()))
   {
     // Recurse into the non-self-children first.  The recursion order cannot
     // affect the runtime of the algorithm, because each query child recursion's
     // results are separate and independent.  I don't think this is true in
     // every case, and we may have to modify this section to consider scores in
-    // the future.
+    // the future.  The children are traversed one after the other, so they all
+    // fill the same reference set of the next depth.
     for (size_t i = 1; i < queryNode.NumChildren(); ++i)
     {
-      // We need a copy of the map for this child.
-      std::map<int, std::vector<DualCoverTreeMapEntry> > childMap;
+      ReferenceMap& childMap = EmptyReferenceMap(depth + 1);
       PruneMap(queryNode.Child(i), referenceMap, childMap);
-      Traverse(queryNode.Child(i), childMap);
+      Traverse(queryNode.Child(i), childMap, depth + 1);
     }
-    std::map<int, std::vector<DualCoverTreeMapEntry> > selfChildMap;
+    ReferenceMap& selfChildMap = EmptyReferenceMap(depth + 1);
     PruneMap(queryNode.Child(0), referenceMap, selfChildMap);
-    Traverse(queryNode.Child(0), selfChildMap);
+    Traverse(queryNode.Child(0), selfChildMap, depth + 1);
   }
 
   if (queryNode.Scale() != INT_MIN)
@@ -109,10 +109,9 @@ DualTreeTraverser<RuleType>::Traverse(
 
   // If we have made it this far, all we have is a bunch of base case
   // evaluations to do.
-  Log::Assert((*referenceMap.begin()).first == INT_MIN);
+  Log::Assert(referenceMap.MinScale() == INT_MIN);
   Log::Assert(queryNode.Scale() == INT_MIN);
-  std::vector<DualCoverTreeMapEntry>& pointVector =
-      (*referenceMap.begin()).second;
+  std::vector<DualCoverTreeMapEntry>& pointVector = referenceMap.Entries(0);
 
   for (size_t i = 0; i < pointVector.size(); ++i)
   {
@@ -154,80 +153,31 @@ template<
 >
 template<typename RuleType>
 void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-DualTreeTraverser<RuleType>::PruneMap(
-    CoverTree& queryNode,
-    std::map<int, std::vector<DualCoverTreeMapEntry> >& referenceMap,
-    std::map<int, std::vector<DualCoverTreeMapEntry> >& childMap)
+DualTreeTraverser<RuleType>::PruneMap(CoverTree& queryNode,
+                                      ReferenceMap& referenceMap,
+                                      ReferenceMap& childMap)
 {
-  if (referenceMap.empty())
+  if (referenceMap.Empty())
     return; // Nothing to do.
 
-  // Copy the zero set first.
-  if ((*referenceMap.begin()).first == INT_MIN)
-  {
-    // Get a reference to the vector representing the entries at this scale.
-    std::vector<DualCoverTreeMapEntry>& scaleVector =
-        (*referenceMap.begin()).second;
-
-    // Before traversing all the points in this scale, sort by score.
-    std::sort(scaleVector.begin(), scaleVector.end());
-
-    const int thisScale = (*referenceMap.begin()).first;
-    childMap[thisScale].reserve(scaleVector.size());
-    std::vector<DualCoverTreeMapEntry>& newScaleVector = childMap[thisScale];
-
-    // Loop over each entry in the vector.
-    for (size_t j = 0; j < scaleVector.size(); ++j)
-    {
-      const DualCoverTreeMapEntry& frame = scaleVector[j];
-
-      // First evaluate if we can prune without performing the base case.
-      CoverTree* refNode = frame.referenceNode;
-
-      // Perform the actual scoring, after restoring the traversal info.
-      rule.TraversalInfo() = frame.traversalInfo;
-      double score = rule.Score(queryNode, *refNode);
-
-      if (score == DBL_MAX)
-      {
-        // Pruned.  Move on.
-        ++numPrunes;
-        continue;
-      }
-
-      // If it isn't pruned, we must evaluate the base case.
-      const double baseCase = rule.BaseCase(queryNode.Point(),
-          refNode->Point());
-
-      // Add to child map.
-      newScaleVector.push_back(frame);
-      newScaleVector.back().score = score;
-      newScaleVector.back().baseCase = baseCase;
-      newScaleVector.back().traversalInfo = rule.TraversalInfo();
-    }
-
-    // If we didn't add anything, then strike this vector from the map.
-    if (newScaleVector.size() == 0)
-      childMap.erase((*referenceMap.begin()).first);
-  }
-
-  typename std::map<int, std::vector<DualCoverTreeMapEntry> >::reverse_iterator
-      it = referenceMap.rbegin();
-
-  while ((it != referenceMap.rend()))
+  // Prune the zero set first, and then the other scales from the largest down.
+  const size_t numScales = referenceMap.NumScales();
+  const bool hasZeroSet = (referenceMap.MinScale() == INT_MIN);
+  for (size_t k = 0; k < numScales; ++k)
   {
-    const int thisScale = (*it).first;
-    if (thisScale == INT_MIN) // We already did it.
-      break;
+    size_t i = numScales - 1 - k;
+    if (hasZeroSet)
+      i = (k == 0) ? 0 : numScales - k;
+    const int thisScale = referenceMap.Scale(i);
 
     // Get a reference to the vector representing the entries at this scale.
-    std::vector<DualCoverTreeMapEntry>& scaleVector = (*it).second;
+    std::vector<DualCoverTreeMapEntry>& scaleVector = referenceMap.Entries(i);
 
     // Before traversing all the points in this scale, sort by score.
     std::sort(scaleVector.begin(), scaleVector.end());
 
-    childMap[thisScale].reserve(scaleVector.size());
     std::vector<DualCoverTreeMapEntry>& newScaleVector = childMap[thisScale];
+    newScaleVector.reserve(scaleVector.size());
 
     // Loop over each entry in the vector.
     for (size_t j = 0; j < scaleVector.size(); ++j)
@@ -261,9 +211,7 @@ DualTreeTraverser<RuleType>::PruneMap(
 
     // If we didn't add anything, then strike this vector from the map.
     if (newScaleVector.size() == 0)
-      childMap.erase((*it).first);
-
-    ++it; // Advance to next scale.
+      childMap.Erase(thisScale);
   }
 }
 
@@ -275,30 +223,32 @@ template<
 >
 template<typename RuleType>
 void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-DualTreeTraverser<RuleType>::ReferenceRecursion(
-    CoverTree& queryNode,
-    std::map<int, std::vector<DualCoverTreeMapEntry> >& referenceMap)
+DualTreeTraverser<RuleType>::ReferenceRecursion(CoverTree& queryNode,
+                                                ReferenceMap& referenceMap)
 {
   // First, reduce the maximum scale in the reference map down to the scale of
   // the query node.
-  while (!referenceMap.empty())
+  while (!referenceMap.Empty())
   {
     // Hacky bullshit to imitate jl cover tree.
-    if (queryNode.Parent() == NULL && (*referenceMap.rbegin()).first <
+    if (queryNode.Parent() == NULL && referenceMap.MaxScale() <
         queryNode.Scale())
       break;
-    if (queryNode.Parent() != NULL && (*referenceMap.rbegin()).first <=
+    if (queryNode.Parent() != NULL && referenceMap.MaxScale() <=
         queryNode.Scale())
       break;
     // If the query node's scale is INT_MIN and the reference map's maximum
     // scale is INT_MIN, don't try to recurse...
     if ((queryNode.Scale() == INT_MIN) &&
-       ((*referenceMap.rbegin()).first == INT_MIN))
+       (referenceMap.MaxScale() == INT_MIN))
       break;
 
-    // Get a reference to the current largest scale.
-    std::vector<DualCoverTreeMapEntry>& scaleVector =
-        (*referenceMap.rbegin()).second;
+    // Take the entries of the current largest scale out of the map, since
+    // adding their children (which have smaller scales) to the map moves the
+    // vectors of the map.  This scale isn't needed anymore.
+    std::vector<DualCoverTreeMapEntry>& scaleVector = expandedEntries;
+    scaleVector.swap(referenceMap.MaxEntries());
+    referenceMap.PopMax();
 
     // Before traversing all the points in this scale, sort by score.
     std::sort(scaleVector.begin(), scaleVector.end());
@@ -307,7 +257,7 @@ DualTreeTraverser<RuleType>::ReferenceRecursion(
     for (size_t i = 0; i < scaleVector.size(); ++i)
     {
       // Get a reference to the current element.
-      const DualCoverTreeMapEntry& frame = scaleVector.at(i);
+      const DualCoverTreeMapEntry& frame = scaleVector[i];
 
       CoverTree* refNode = frame.referenceNode;
 
@@ -349,8 +299,8 @@ DualTreeTraverser<RuleType>::ReferenceRecursion(
       }
     }
 
-    // Now clear the memory for this scale; it isn't needed anymore.
-    referenceMap.erase((*referenceMap.rbegin()).first);
+    // Keep the memory of the entries for the next scale.
+    scaleVector.clear();
   }
 }
 
@@ -0,0 +1,136 @@
+/**
+ * @file scale_map.hpp
+ *
+ * A map from cover tree scales to vectors of entries, which keeps the memory
+ * of its vectors when they are removed, for the dual-tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_COVER_TREE_SCALE_MAP_HPP
+#define MLPACK_CORE_TREE_COVER_TREE_SCALE_MAP_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * ScaleMap holds a vector of entries for each of a set of scales, sorted by
+ * increasing scale, like a std::map<int, std::vector<EntryType>> with the
+ * operations that the cover tree dual-tree traverser needs.  The scales and
+ * the vectors are kept in flat arrays, and removing a scale (or clearing the
+ * map) only clears its vector and keeps it for the next scale added, so a map
+ * that is reused allocates nothing once its vectors are large enough.  There
+ * are few scales in a map (one per level of the reference tree at most), so
+ * adding a scale in the middle is a short shift of vectors swapped in place.
+ *
+ * @tparam EntryType Type of the entries.
+ */
+template<typename EntryType>
+class ScaleMap
+{
+ public:
+  //! Create an empty map.
+  ScaleMap() : numScales(0) { }
+
+  //! Return true if there are no scales in the map.
+  bool Empty() const { return numScales == 0; }
+
+  //! Get the number of scales in the map.
+  size_t NumScales() const { return numScales; }
+
+  //! Get the i'th smallest scale.
+  int Scale(const size_t i) const { return scales[i]; }
+  //! Get the entries of the i'th smallest scale.
+  std::vector<EntryType>& Entries(const size_t i) { return entries[i]; }
+
+  //! Get the smallest scale (the map must not be empty).
+  int MinScale() const { return scales[0]; }
+  //! Get the largest scale (the map must not be empty).
+  int MaxScale() const { return scales[numScales - 1]; }
+  //! Get the entries of the largest scale (the map must not be empty).
+  std::vector<EntryType>& MaxEntries() { return entries[numScales - 1]; }
+
+  /**
+   * Get the entries of the given scale, adding the scale (with no entries) if
+   * it isn't in the map.  Adding a scale moves the entries of the larger
+   * scales, so references to them are invalidated.
+   *
+   * @param scale Scale to get the entries of.
+   */
+  std::vector<EntryType>& operator[](const int scale)
+  {
+    const size_t i = std::lower_bound(scales.begin(), scales.begin() +
+        numScales, scale) - scales.begin();
+    if (i < numScales && scales[i] == scale)
+      return entries[i];
+
+    // Take the first unused vector, and move it in front of the larger scales.
+    if (numScales == entries.size())
+    {
+      entries.push_back(std::vector<EntryType>());
+      scales.push_back(0);
+    }
+    for (size_t j = numScales; j > i; --j)
+    {
+      entries[j].swap(entries[j - 1]);
+      scales[j] = scales[j - 1];
+    }
+
+    scales[i] = scale;
+    ++numScales;
+    return entries[i];
+  }
+
+  //! Remove the largest scale (the map must not be empty).
+  void PopMax()
+  {
+    entries[--numScales].clear();
+  }
+
+  /**
+   * Remove the given scale, if it is in the map.  This moves the entries of
+   * the larger scales, so references to them are invalidated.
+   *
+   * @param scale Scale to remove.
+   */
+  void Erase(const int scale)
+  {
+    size_t i = std::lower_bound(scales.begin(), scales.begin() + numScales,
+        scale) - scales.begin();
+    if (i == numScales || scales[i] != scale)
+      return;
+
+    entries[i].clear();
+    for (; i + 1 < numScales; ++i)
+    {
+      entries[i].swap(entries[i + 1]);
+      scales[i] = scales[i + 1];
+    }
+    --numScales;
+  }
+
+  //! Remove all the scales, keeping the memory of their vectors.
+  void Clear()
+  {
+    for (size_t i = 0; i < numScales; ++i)
+      entries[i].clear();
+    numScales = 0;
+  }
+
+ private:
+  //! The scales, in increasing order; only the first numScales are used.
+  std::vector<int> scales;
+  //! The entries of each scale, followed by the unused (empty) vectors.
+  std::vector<std::vector<EntryType>> entries;
+  //! The number of scales in the map.
+  size_t numScales;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
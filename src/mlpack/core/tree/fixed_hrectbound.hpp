@@ -0,0 +1,171 @@
+/**
+ * @file fixed_hrectbound.hpp
+ *
+ * A specialization of HRectBound for the FixedLMetric, whose dimensionality is
+ * known at compile time.  The ranges are stored in the bound itself, and all
+ * loops over the dimensions have a constant trip count.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_FIXED_HRECTBOUND_HPP
+#define MLPACK_CORE_TREE_FIXED_HRECTBOUND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/range.hpp>
+#include <mlpack/core/metrics/fixed_lmetric.hpp>
+#include "hrectbound.hpp"
+
+namespace mlpack {
+namespace bound {
+
+namespace meta {
+
+//! Specialization for IsLMetric when the argument is of type FixedLMetric.
+template<size_t Dim, int Power, bool TakeRoot>
+struct IsLMetric<metric::FixedLMetric<Dim, Power, TakeRoot>>
+{
+  static const bool Value = true;
+};
+
+} // namespace meta
+
+/**
+ * Hyper-rectangle bound of the fixed dimensionality TDim.  This has the same
+ * interface as HRectBound, but holds its TDim ranges in an array member instead
+ * of allocating them, so a tree node holds its bound directly and copying a
+ * bound allocates nothing.  All distance computations loop over exactly TDim
+ * dimensions and are unrolled by the compiler.
+ *
+ * This is used whenever the metric of a tree with an HRectBound (a kd-tree,
+ * for instance) is a FixedLMetric.
+ *
+ * @tparam TDim Dimensionality of the bound.
+ * @tparam TPower Power of the metric.
+ * @tparam TTakeRoot Whether the root of the distances is taken.
+ * @tparam ElemType Element type (double/float/int/etc.).
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+class HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>
+{
+ public:
+  //! The metric of the bound.
+  typedef metric::FixedLMetric<TDim, TPower, TTakeRoot> MetricType;
+
+  /**
+   * Empty constructor; creates a bound with each dimension the empty set.
+   */
+  HRectBound();
+
+  /**
+   * Initializes each dimension to the empty set.  The given dimensionality
+   * must be TDim.
+   */
+  HRectBound(const size_t dimension);
+
+  /**
+   * Resets all dimensions to the empty set (so that this bound contains
+   * nothing).
+   */
+  void Clear();
+
+  //! Gets the dimensionality.
+  size_t Dim() const { return TDim; }
+
+  //! Get the range for a particular dimension.  No bounds checking.  Be
+  //! careful: this may make MinWidth() invalid.
+  math::RangeType<ElemType>& operator[](const size_t i) { return bounds[i]; }
+  //! Modify the range for a particular dimension.  No bounds checking.
+  const math::RangeType<ElemType>& operator[](const size_t i) const
+  { return bounds[i]; }
+
+  //! Get the minimum width of the bound.
+  ElemType MinWidth() const { return minWidth; }
+  //! Modify the minimum width of the bound.
+  ElemType& MinWidth() { return minWidth; }
+
+  //! Calculates the center of the range, placing it into the given vector.
+  void Center(arma::Col<ElemType>& center) const;
+
+  //! Calculate the volume of the hyperrectangle.
+  ElemType Volume() const;
+
+  //! Calculates minimum bound-to-point distance.
+  template<typename VecType>
+  ElemType MinDistance(const VecType& point,
+                       typename std::enable_if_t<IsVector<VecType>::value>* = 0)
+      const;
+
+  //! Calculates minimum bound-to-bound distance.
+  ElemType MinDistance(const HRectBound& other) const;
+
+  //! Calculates maximum bound-to-point distance.
+  template<typename VecType>
+  ElemType MaxDistance(const VecType& point,
+                       typename std::enable_if_t<IsVector<VecType>::value>* = 0)
+      const;
+
+  //! Calculates maximum bound-to-bound distance.
+  ElemType MaxDistance(const HRectBound& other) const;
+
+  //! Calculates minimum and maximum bound-to-bound distance.
+  math::RangeType<ElemType> RangeDistance(const HRectBound& other) const;
+
+  //! Calculates minimum and maximum bound-to-point distance.
+  template<typename VecType>
+  math::RangeType<ElemType> RangeDistance(
+      const VecType& point,
+      typename std::enable_if_t<IsVector<VecType>::value>* = 0) const;
+
+  //! Expands this region to include new points.
+  template<typename MatType>
+  HRectBound& operator|=(const MatType& data);
+
+  //! Expands this region to encompass another bound.
+  HRectBound& operator|=(const HRectBound& other);
+
+  //! Determines if a point is within this bound.
+  template<typename VecType>
+  bool Contains(const VecType& point) const;
+
+  //! Determines if this bound partially contains a bound.
+  bool Contains(const HRectBound& bound) const;
+
+  //! Returns the intersection of this bound and another.
+  HRectBound operator&(const HRectBound& bound) const;
+
+  //! Intersects this bound with another.
+  HRectBound& operator&=(const HRectBound& bound);
+
+  //! Returns the volume of overlap of this bound and another.
+  ElemType Overlap(const HRectBound& bound) const;
+
+  //! Returns the diameter of the hyperrectangle (the longest diagonal).
+  ElemType Diameter() const;
+
+  //! Serialize the bound object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! Add the given non-negative per-dimension distance to the sum, raised to
+  //! the power of the metric (or take the maximum for the L-infinity metric).
+  static void Accumulate(ElemType& sum, const ElemType v);
+
+  //! Take the root of an accumulated sum, if the metric takes it.
+  static ElemType Root(const ElemType sum);
+
+  //! The bounds for each dimension.
+  math::RangeType<ElemType> bounds[TDim];
+  //! Cached minimum width of bound.
+  ElemType minWidth;
+};
+
+} // namespace bound
+} // namespace mlpack
+
+#include "fixed_hrectbound_impl.hpp"
+
+#endif // MLPACK_CORE_TREE_FIXED_HRECTBOUND_HPP
@@ -0,0 +1,415 @@
+/**
+ * @file fixed_hrectbound_impl.hpp
+ *
+ * Implementation of the fixed-dimensionality specialization of HRectBound.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_FIXED_HRECTBOUND_IMPL_HPP
+#define MLPACK_CORE_TREE_FIXED_HRECTBOUND_IMPL_HPP
+
+// In case it has not been included yet.
+#include "fixed_hrectbound.hpp"
+
+namespace mlpack {
+namespace bound {
+
+/**
+ * Empty constructor.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>::
+    HRectBound() :
+    minWidth(0)
+{ /* Nothing to do. */ }
+
+/**
+ * Initializes each dimension to the empty set, checking the dimensionality.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>::
+    HRectBound(const size_t dimension) :
+    minWidth(0)
+{
+  if (dimension != TDim)
+  {
+    Log::Fatal << "HRectBound::HRectBound(): the metric is for " << TDim
+        << "-dimensional points, but the data has " << dimension
+        << " dimensions!" << std::endl;
+  }
+}
+
+/**
+ * Resets all dimensions to the empty set.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline void HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::Clear()
+{
+  for (size_t i = 0; i < TDim; i++)
+    bounds[i] = math::RangeType<ElemType>();
+  minWidth = 0;
+}
+
+/**
+ * Calculates the center of the range, placing it into the given vector.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline void HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::Center(arma::Col<ElemType>& center) const
+{
+  if (center.n_elem != TDim)
+    center.set_size(TDim);
+
+  for (size_t i = 0; i < TDim; i++)
+    center(i) = bounds[i].Mid();
+}
+
+/**
+ * Calculate the volume of the hyperrectangle.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline ElemType HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::Volume() const
+{
+  ElemType volume = 1.0;
+  for (size_t i = 0; i < TDim; ++i)
+  {
+    if (bounds[i].Lo() >= bounds[i].Hi())
+      return 0;
+
+    volume *= (bounds[i].Hi() - bounds[i].Lo());
+  }
+
+  return volume;
+}
+
+/**
+ * Add a per-dimension distance to the sum.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline void HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::Accumulate(ElemType& sum, const ElemType v)
+{
+  // The compiler should optimize out this if statement entirely.
+  if (TPower == INT_MAX)
+    sum = std::max(sum, v);
+  else if (TPower == 1)
+    sum += v;
+  else if (TPower == 2)
+    sum += v * v;
+  else
+    sum += IntegerPower<TPower>(v);
+}
+
+/**
+ * Take the root of an accumulated sum.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline ElemType HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::Root(const ElemType sum)
+{
+  // The compiler should optimize out this if statement entirely.
+  if (!TTakeRoot || TPower == 1 || TPower == INT_MAX)
+    return sum;
+  else if (TPower == 2)
+    return (ElemType) std::sqrt(sum);
+  else
+    return (ElemType) pow((double) sum, 1.0 / (double) TPower);
+}
+
+/**
+ * Calculates minimum bound-to-point distance.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+template<typename VecType>
+inline ElemType HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::MinDistance(
+    const VecType& point,
+    typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+{
+  Log::Assert(point.n_elem == TDim);
+
+  ElemType sum = 0;
+  for (size_t d = 0; d < TDim; d++)
+  {
+    // At most one of these is positive.
+    const ElemType lower = bounds[d].Lo() - point[d];
+    const ElemType higher = point[d] - bounds[d].Hi();
+    Accumulate(sum, std::max(std::max(lower, higher), (ElemType) 0));
+  }
+
+  return Root(sum);
+}
+
+/**
+ * Calculates minimum bound-to-bound distance.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline ElemType HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::MinDistance(const HRectBound& other) const
+{
+  ElemType sum = 0;
+  for (size_t d = 0; d < TDim; d++)
+  {
+    const ElemType lower = other.bounds[d].Lo() - bounds[d].Hi();
+    const ElemType higher = bounds[d].Lo() - other.bounds[d].Hi();
+    Accumulate(sum, std::max(std::max(lower, higher), (ElemType) 0));
+  }
+
+  return Root(sum);
+}
+
+/**
+ * Calculates maximum bound-to-point distance.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+template<typename VecType>
+inline ElemType HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::MaxDistance(
+    const VecType& point,
+    typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+{
+  Log::Assert(point.n_elem == TDim);
+
+  ElemType sum = 0;
+  for (size_t d = 0; d < TDim; d++)
+  {
+    Accumulate(sum, std::max(std::fabs(point[d] - bounds[d].Lo()),
+        std::fabs(bounds[d].Hi() - point[d])));
+  }
+
+  return Root(sum);
+}
+
+/**
+ * Calculates maximum bound-to-bound distance.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline ElemType HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::MaxDistance(const HRectBound& other) const
+{
+  ElemType sum = 0;
+  for (size_t d = 0; d < TDim; d++)
+  {
+    Accumulate(sum, std::max(std::fabs(other.bounds[d].Hi() - bounds[d].Lo()),
+        std::fabs(bounds[d].Hi() - other.bounds[d].Lo())));
+  }
+
+  return Root(sum);
+}
+
+/**
+ * Calculates minimum and maximum bound-to-bound distance.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline math::RangeType<ElemType> HRectBound<
+    metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::RangeDistance(const HRectBound& other) const
+{
+  ElemType loSum = 0;
+  ElemType hiSum = 0;
+  for (size_t d = 0; d < TDim; d++)
+  {
+    const ElemType v1 = other.bounds[d].Lo() - bounds[d].Hi();
+    const ElemType v2 = bounds[d].Lo() - other.bounds[d].Hi();
+    // One of v1 or v2 is negative.
+    Accumulate(loSum, std::max(std::max(v1, v2), (ElemType) 0));
+    Accumulate(hiSum, -std::min(v1, v2));
+  }
+
+  return math::RangeType<ElemType>(Root(loSum), Root(hiSum));
+}
+
+/**
+ * Calculates minimum and maximum bound-to-point distance.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+template<typename VecType>
+inline math::RangeType<ElemType> HRectBound<
+    metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::RangeDistance(
+    const VecType& point,
+    typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+{
+  Log::Assert(point.n_elem == TDim);
+
+  ElemType loSum = 0;
+  ElemType hiSum = 0;
+  for (size_t d = 0; d < TDim; d++)
+  {
+    const ElemType v1 = bounds[d].Lo() - point[d]; // Negative if point > lo.
+    const ElemType v2 = point[d] - bounds[d].Hi(); // Negative if point < hi.
+    Accumulate(loSum, std::max(std::max(v1, v2), (ElemType) 0));
+    Accumulate(hiSum, -std::min(v1, v2));
+  }
+
+  return math::RangeType<ElemType>(Root(loSum), Root(hiSum));
+}
+
+/**
+ * Expands this region to include new points.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+template<typename MatType>
+inline HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>&
+HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>::
+    operator|=(const MatType& data)
+{
+  Log::Assert(data.n_rows == TDim);
+
+  arma::Col<ElemType> mins(min(data, 1));
+  arma::Col<ElemType> maxs(max(data, 1));
+
+  minWidth = std::numeric_limits<ElemType>::max();
+  for (size_t i = 0; i < TDim; i++)
+  {
+    bounds[i] |= math::RangeType<ElemType>(mins[i], maxs[i]);
+    const ElemType width = bounds[i].Width();
+    if (width < minWidth)
+      minWidth = width;
+  }
+
+  return *this;
+}
+
+/**
+ * Expands this region to encompass another bound.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>&
+HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>::
+    operator|=(const HRectBound& other)
+{
+  minWidth = std::numeric_limits<ElemType>::max();
+  for (size_t i = 0; i < TDim; i++)
+  {
+    bounds[i] |= other.bounds[i];
+    const ElemType width = bounds[i].Width();
+    if (width < minWidth)
+      minWidth = width;
+  }
+
+  return *this;
+}
+
+/**
+ * Determines if a point is within this bound.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+template<typename VecType>
+inline bool HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::Contains(const VecType& point) const
+{
+  for (size_t i = 0; i < TDim; i++)
+  {
+    if (!bounds[i].Contains(point(i)))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Determines if this bound partially contains a bound.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline bool HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::Contains(const HRectBound& bound) const
+{
+  for (size_t i = 0; i < TDim; i++)
+  {
+    const math::RangeType<ElemType>& r_a = bounds[i];
+    const math::RangeType<ElemType>& r_b = bound.bounds[i];
+
+    // If a does not overlap b at all.
+    if (r_a.Hi() <= r_b.Lo() || r_a.Lo() >= r_b.Hi())
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Returns the intersection of this bound and another.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>
+HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>::
+    operator&(const HRectBound& bound) const
+{
+  HRectBound result(*this);
+  result &= bound;
+  return result;
+}
+
+/**
+ * Intersects this bound with another.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>&
+HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>::
+    operator&=(const HRectBound& bound)
+{
+  for (size_t k = 0; k < TDim; k++)
+  {
+    bounds[k].Lo() = std::max(bounds[k].Lo(), bound.bounds[k].Lo());
+    bounds[k].Hi() = std::min(bounds[k].Hi(), bound.bounds[k].Hi());
+  }
+  return *this;
+}
+
+/**
+ * Returns the volume of overlap of this bound and another.
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline ElemType HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::Overlap(const HRectBound& bound) const
+{
+  ElemType volume = 1.0;
+  for (size_t k = 0; k < TDim; k++)
+  {
+    const ElemType lo = std::max(bounds[k].Lo(), bound.bounds[k].Lo());
+    const ElemType hi = std::min(bounds[k].Hi(), bound.bounds[k].Hi());
+
+    if (hi <= lo)
+      return 0;
+
+    volume *= hi - lo;
+  }
+  return volume;
+}
+
+/**
+ * Returns the diameter of the hyperrectangle (that is, the longest diagonal).
+ */
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+inline ElemType HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>,
+    ElemType>::Diameter() const
+{
+  ElemType sum = 0;
+  for (size_t i = 0; i < TDim; ++i)
+    Accumulate(sum, bounds[i].Hi() - bounds[i].Lo());
+
+  return Root(sum);
+}
+
+//! Serialize the bound object.
+template<size_t TDim, int TPower, bool TTakeRoot, typename ElemType>
+template<typename Archive>
+void HRectBound<metric::FixedLMetric<TDim, TPower, TTakeRoot>, ElemType>::
+    serialize(Archive& ar, const unsigned int /* version */)
+{
+  // We can't serialize a raw array directly, so wrap it.
+  auto boundsArray = boost::serialization::make_array(bounds, TDim);
+  ar & BOOST_SERIALIZATION_NVP(boundsArray);
+  ar & BOOST_SERIALIZATION_NVP(minWidth);
+}
+
+} // namespace bound
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_FIXED_HRECTBOUND_IMPL_HPP
@@ -0,0 +1,17 @@
+/**
+ * @file flat_tree.hpp
+ *
+ * Include all the necessary files to use the FlatTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_FLAT_TREE_HPP
+#define MLPACK_CORE_TREE_FLAT_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "flat_tree/flat_tree.hpp"
+
+#endif
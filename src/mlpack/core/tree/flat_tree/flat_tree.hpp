@@ -0,0 +1,236 @@
+/**
+ * @file flat_tree.hpp
+ *
+ * Definition of the FlatTree class, a read-only, pointer-free copy of a tree
+ * that is stored in a single file and queried directly from a memory mapping
+ * of that file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_FLAT_TREE_FLAT_TREE_HPP
+#define MLPACK_CORE_TREE_FLAT_TREE_FLAT_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <queue>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * A FlatTree is a read-only copy of any mlpack tree (BinarySpaceTree,
+ * CoverTree, Octree, RectangleTree, ...) in a flat layout without pointers.
+ * The file written by Save() holds a header followed by four blocks:
+ *
+ *  - the nodes, each holding the range of its points and of its children;
+ *  - the bounds, a hyperrectangle for each node;
+ *  - the dataset, ordered so that the points of each node are contiguous;
+ *  - the index of each point in the original dataset.
+ *
+ * Loading a FlatTree maps the file into memory instead of reading it, so the
+ * operating system shares the pages between all processes that load the same
+ * file, and a large index is available with almost no startup time.  The file
+ * is stored in the byte order of the machine that wrote it.
+ *
+ * The tree answers k-nearest-neighbor queries with a single-tree search, with
+ * one thread per query when OpenMP is available.  The bounds are
+ * hyperrectangles, so the metric must be an LMetric (or another metric with a
+ * static Evaluate() for which the distance to a box is the distance to the
+ * nearest point in it).
+ *
+ * @code
+ * KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(data, oldFromNew);
+ * FlatTree<>::Save(tree, "index.bin", oldFromNew);
+ *
+ * // Possibly in a different process.
+ * FlatTree<> flatTree("index.bin");
+ * flatTree.Search(queries, k, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MetricType The metric to search with.
+ * @tparam ElemType The type of the stored data.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename ElemType = double>
+class FlatTree
+{
+ public:
+  /**
+   * A node of the flat tree.  The points of the node are
+   * [begin, begin + count) in the stored dataset; the first numPoints of them
+   * belong to the node itself and the rest to its children, which are the
+   * nodes [firstChild, firstChild + numChildren).
+   */
+  struct Node
+  {
+    uint64_t begin;
+    uint64_t count;
+    uint64_t numPoints;
+    uint64_t firstChild;
+    uint64_t numChildren;
+  };
+
+  /**
+   * Write the given tree to the given file in the flat layout.  If the tree
+   * was built on a rearranged copy of the dataset, pass the mapping from the
+   * tree's point indices to the original indices, so that search results
+   * refer to the original dataset.
+   *
+   * @param tree The tree to save.
+   * @param filename The file to write.
+   * @param oldFromNew Original index of each point of the tree's dataset, or
+   *     an empty vector if the tree does not rearrange the dataset.
+   */
+  template<typename TreeType>
+  static void Save(const TreeType& tree,
+                   const std::string& filename,
+                   const std::vector<size_t>& oldFromNew =
+                       std::vector<size_t>());
+
+  /**
+   * Map the given file, written by Save(), into memory.  An exception is thrown
+   * if the file cannot be mapped or is not a flat tree of the right element
+   * type.
+   *
+   * @param filename The file to load.
+   */
+  FlatTree(const std::string& filename);
+
+  //! The memory mapping cannot be copied.
+  FlatTree(const FlatTree& other) = delete;
+  //! The memory mapping cannot be copied.
+  FlatTree& operator=(const FlatTree& other) = delete;
+
+  //! Unmap the file.
+  ~FlatTree();
+
+  /**
+   * Find the k nearest neighbors of each query point.  The results refer to
+   * the original indices of the reference points.  If there are fewer than k
+   * reference points, the missing neighbors are SIZE_MAX with distance
+   * DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to find.
+   * @param neighbors Matrix storing the neighbors of each query point.
+   * @param distances Matrix storing the distances of those neighbors.
+   */
+  void Search(const arma::Mat<ElemType>& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Find the k nearest neighbors of each reference point, excluding the point
+   * itself.  The columns of the results are in the order of the original
+   * dataset.
+   *
+   * @param k Number of neighbors to find.
+   * @param neighbors Matrix storing the neighbors of each point.
+   * @param distances Matrix storing the distances of those neighbors.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  //! Get the number of nodes.
+  size_t NumNodes() const { return numNodes; }
+  //! Get the given node.
+  const Node& GetNode(const size_t index) const { return nodes[index]; }
+
+  //! Get the lower corner of the bound of the given node.
+  const ElemType* Lo(const size_t index) const
+  { return bounds + 2 * index * dataset->n_rows; }
+  //! Get the upper corner of the bound of the given node.
+  const ElemType* Hi(const size_t index) const
+  { return bounds + (2 * index + 1) * dataset->n_rows; }
+
+  //! Get the stored (rearranged) dataset; it aliases the mapped file.
+  const arma::Mat<ElemType>& Dataset() const { return *dataset; }
+  //! Get the original index of the given stored point.
+  size_t OldFromNew(const size_t index) const
+  { return (size_t) oldFromNew[index]; }
+
+ private:
+  //! The list of candidates for one query point, with the worst on top.
+  typedef std::priority_queue<std::pair<double, size_t>> CandidateList;
+
+  /**
+   * Search the given node and its descendants for the nearest neighbors of the
+   * given point.
+   *
+   * @param nodeIndex Node to search.
+   * @param query The query point.
+   * @param skipIndex Stored index of a point to ignore (SIZE_MAX if none).
+   * @param k Number of neighbors to find.
+   * @param candidates The candidates found so far.
+   * @param buffer Storage for the point of the bound nearest to the query.
+   */
+  template<typename VecType>
+  void SearchNode(const size_t nodeIndex,
+                  const VecType& query,
+                  const size_t skipIndex,
+                  const size_t k,
+                  CandidateList& candidates,
+                  arma::Col<ElemType>& buffer) const;
+
+  //! Find the k nearest neighbors of one point and store them.
+  template<typename VecType>
+  void SearchPoint(const VecType& query,
+                   const size_t skipIndex,
+                   const size_t k,
+                   arma::Col<size_t>&& neighbors,
+                   arma::vec&& distances) const;
+
+  //! Return the distance between the given point and the bound of a node.
+  template<typename VecType>
+  double MinDistance(const size_t nodeIndex,
+                     const VecType& query,
+                     arma::Col<ElemType>& buffer) const;
+
+  /**
+   * Append the given tree node to the flat layout.
+   *
+   * @param node The node to add.
+   * @param index Index of the node in the flat layout (already reserved).
+   * @param nodes The flat nodes.
+   * @param order The tree's point indices, in the order they are stored.
+   * @param stored Whether each point of the tree is already stored.
+   */
+  template<typename TreeType>
+  static void FlattenNode(const TreeType& node,
+                          const size_t index,
+                          std::vector<Node>& nodes,
+                          std::vector<size_t>& order,
+                          std::vector<bool>& stored);
+
+  //! Release the given mapping of a file.
+  static void Unmap(char* data, const size_t size);
+
+  //! The mapped file.
+  char* data;
+  //! The size of the mapped file.
+  size_t size;
+
+  //! The number of nodes.
+  size_t numNodes;
+  //! The nodes (inside the mapped file).
+  const Node* nodes;
+  //! The bounds (inside the mapped file).
+  const ElemType* bounds;
+  //! The original index of each point (inside the mapped file).
+  const uint64_t* oldFromNew;
+  //! The dataset, aliasing the mapped file.
+  arma::Mat<ElemType>* dataset;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_tree_impl.hpp"
+
+#endif
@@ -0,0 +1,467 @@
+/**
+ * @file flat_tree_impl.hpp
+ *
+ * Implementation of the FlatTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_FLAT_TREE_FLAT_TREE_IMPL_HPP
+#define MLPACK_CORE_TREE_FLAT_TREE_FLAT_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_tree.hpp"
+
+#include <fstream>
+#include <cstring>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The header at the start of a flat tree file.  All offsets are in bytes from
+ * the start of the file.
+ */
+struct FlatTreeHeader
+{
+  char magic[8];
+  uint64_t version;
+  uint64_t elemSize;
+  uint64_t dimensionality;
+  uint64_t numPoints;
+  uint64_t numNodes;
+  uint64_t nodeOffset;
+  uint64_t boundOffset;
+  uint64_t datasetOffset;
+  uint64_t indexOffset;
+  uint64_t fileSize;
+};
+
+//! The magic bytes at the start of a flat tree file.
+static const char flatTreeMagic[8] = { 'M', 'L', 'P', 'K', 'F', 'L', 'A', 'T' };
+
+//! The version of the flat tree layout.
+static const uint64_t flatTreeVersion = 1;
+
+//! Round the given offset up to a multiple of the cache line size.
+inline uint64_t FlatTreeAlign(const uint64_t offset)
+{
+  return (offset + 63) / 64 * 64;
+}
+
+template<typename MetricType, typename ElemType>
+template<typename TreeType>
+void FlatTree<MetricType, ElemType>::Save(
+    const TreeType& tree,
+    const std::string& filename,
+    const std::vector<size_t>& oldFromNew)
+{
+  const auto& treeData = tree.Dataset();
+  const size_t dims = treeData.n_rows;
+
+  // Lay the nodes out depth-first, such that the children of each node are
+  // contiguous and the points of each node are contiguous.
+  std::vector<Node> nodes(1);
+  std::vector<size_t> order;
+  std::vector<bool> stored(treeData.n_cols, false);
+  FlattenNode(tree, 0, nodes, order, stored);
+
+  // Compute the bounds bottom-up; children always come after their parent.
+  std::vector<ElemType> bounds(2 * dims * nodes.size());
+  for (size_t i = nodes.size(); i > 0; --i)
+  {
+    const Node& node = nodes[i - 1];
+    ElemType* lo = &bounds[2 * (i - 1) * dims];
+    ElemType* hi = lo + dims;
+
+    if (node.count == 0)
+    {
+      std::fill(lo, lo + 2 * dims, ElemType(0));
+      continue;
+    }
+
+    std::fill(lo, lo + dims, std::numeric_limits<ElemType>::max());
+    std::fill(hi, hi + dims, std::numeric_limits<ElemType>::lowest());
+    for (size_t j = node.begin; j < node.begin + node.numPoints; ++j)
+    {
+      for (size_t d = 0; d < dims; ++d)
+      {
+        lo[d] = std::min(lo[d], (ElemType) treeData(d, order[j]));
+        hi[d] = std::max(hi[d], (ElemType) treeData(d, order[j]));
+      }
+    }
+
+    for (size_t c = node.firstChild; c < node.firstChild + node.numChildren;
+         ++c)
+    {
+      if (nodes[c].count == 0)
+        continue;
+
+      const ElemType* childLo = &bounds[2 * c * dims];
+      const ElemType* childHi = childLo + dims;
+      for (size_t d = 0; d < dims; ++d)
+      {
+        lo[d] = std::min(lo[d], childLo[d]);
+        hi[d] = std::max(hi[d], childHi[d]);
+      }
+    }
+  }
+
+  FlatTreeHeader header;
+  std::memcpy(header.magic, flatTreeMagic, sizeof(header.magic));
+  header.version = flatTreeVersion;
+  header.elemSize = sizeof(ElemType);
+  header.dimensionality = dims;
+  header.numPoints = order.size();
+  header.numNodes = nodes.size();
+  header.nodeOffset = FlatTreeAlign(sizeof(FlatTreeHeader));
+  header.boundOffset = FlatTreeAlign(header.nodeOffset +
+      nodes.size() * sizeof(Node));
+  header.datasetOffset = FlatTreeAlign(header.boundOffset +
+      bounds.size() * sizeof(ElemType));
+  header.indexOffset = FlatTreeAlign(header.datasetOffset +
+      order.size() * dims * sizeof(ElemType));
+  header.fileSize = header.indexOffset + order.size() * sizeof(uint64_t);
+
+  std::ofstream f(filename.c_str(), std::ios::binary);
+  if (!f.is_open())
+  {
+    Log::Fatal << "Cannot open file '" << filename << "' to save the flat tree!"
+        << std::endl;
+  }
+
+  // Write a block, padded to the given offset.
+  auto writeAt = [&f](const uint64_t offset, const void* block,
+      const size_t bytes)
+  {
+    const std::vector<char> padding(offset - (uint64_t) f.tellp(), 0);
+    f.write(padding.data(), padding.size());
+    f.write((const char*) block, bytes);
+  };
+
+  f.write((const char*) &header, sizeof(FlatTreeHeader));
+  writeAt(header.nodeOffset, nodes.data(), nodes.size() * sizeof(Node));
+  writeAt(header.boundOffset, bounds.data(), bounds.size() * sizeof(ElemType));
+
+  // The dataset and the indices are written one point at a time.
+  std::vector<ElemType> point(dims);
+  writeAt(header.datasetOffset, NULL, 0);
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    for (size_t d = 0; d < dims; ++d)
+      point[d] = (ElemType) treeData(d, order[i]);
+    f.write((const char*) point.data(), dims * sizeof(ElemType));
+  }
+
+  writeAt(header.indexOffset, NULL, 0);
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    const uint64_t index = oldFromNew.empty() ? order[i] :
+        oldFromNew[order[i]];
+    f.write((const char*) &index, sizeof(uint64_t));
+  }
+
+  if (!f.good())
+  {
+    Log::Fatal << "Error while writing the flat tree to '" << filename << "'!"
+        << std::endl;
+  }
+}
+
+template<typename MetricType, typename ElemType>
+template<typename TreeType>
+void FlatTree<MetricType, ElemType>::FlattenNode(const TreeType& node,
+                                                 const size_t index,
+                                                 std::vector<Node>& nodes,
+                                                 std::vector<size_t>& order,
+                                                 std::vector<bool>& stored)
+{
+  // Store the points of this node that no node stored before (e.g. in a cover
+  // tree the point of a node is also the point of its self-child).
+  nodes[index].begin = order.size();
+  for (size_t i = 0; i < node.NumPoints(); ++i)
+  {
+    const size_t point = node.Point(i);
+    if (!stored[point])
+    {
+      stored[point] = true;
+      order.push_back(point);
+    }
+  }
+  nodes[index].numPoints = order.size() - nodes[index].begin;
+
+  // Reserve the children, so that they are contiguous, and then recurse.
+  const size_t firstChild = nodes.size();
+  nodes[index].firstChild = firstChild;
+  nodes[index].numChildren = node.NumChildren();
+  nodes.resize(firstChild + node.NumChildren());
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    FlattenNode(node.Child(i), firstChild + i, nodes, order, stored);
+
+  nodes[index].count = order.size() - nodes[index].begin;
+}
+
+template<typename MetricType, typename ElemType>
+FlatTree<MetricType, ElemType>::FlatTree(const std::string& filename) :
+    data(NULL),
+    size(0),
+    numNodes(0),
+    nodes(NULL),
+    bounds(NULL),
+    oldFromNew(NULL),
+    dataset(NULL)
+{
+#ifndef _WIN32
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    Log::Fatal << "Cannot open flat tree file '" << filename << "'!"
+        << std::endl;
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+  {
+    close(fd);
+    Log::Fatal << "Cannot read flat tree file '" << filename << "'!"
+        << std::endl;
+  }
+  size = (size_t) fileStat.st_size;
+
+  // The mapping stays valid after the file is closed.
+  void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    Log::Fatal << "Cannot map flat tree file '" << filename << "' into "
+        << "memory!" << std::endl;
+  }
+  data = (char*) mapping;
+#else
+  // Without mmap(), just read the whole file.
+  std::ifstream f(filename.c_str(), std::ios::binary | std::ios::ate);
+  if (!f.is_open())
+  {
+    Log::Fatal << "Cannot open flat tree file '" << filename << "'!"
+        << std::endl;
+  }
+  size = (size_t) f.tellg();
+  f.seekg(0);
+  data = new char[size];
+  if (!f.read(data, size))
+  {
+    Unmap(data, size);
+    Log::Fatal << "Cannot read flat tree file '" << filename << "'!"
+        << std::endl;
+  }
+#endif
+
+  // Check that this is a flat tree we can use.
+  FlatTreeHeader header;
+  std::string error;
+  if (size < sizeof(FlatTreeHeader))
+  {
+    error = "the file is too small";
+  }
+  else
+  {
+    std::memcpy(&header, data, sizeof(FlatTreeHeader));
+    if (std::memcmp(header.magic, flatTreeMagic, sizeof(header.magic)) != 0)
+      error = "the file is not a flat tree";
+    else if (header.version != flatTreeVersion)
+      error = "the flat tree version is not supported";
+    else if (header.elemSize != sizeof(ElemType))
+      error = "the flat tree holds a different element type";
+    else if (header.fileSize != size || header.numNodes == 0)
+      error = "the file is truncated";
+  }
+
+  if (!error.empty())
+  {
+    Unmap(data, size);
+    Log::Fatal << "Cannot load flat tree file '" << filename << "': " << error
+        << "!" << std::endl;
+  }
+
+  numNodes = header.numNodes;
+  nodes = (const Node*) (data + header.nodeOffset);
+  bounds = (const ElemType*) (data + header.boundOffset);
+  oldFromNew = (const uint64_t*) (data + header.indexOffset);
+
+  // The dataset aliases the mapped memory; it is never modified.
+  dataset = new arma::Mat<ElemType>((ElemType*) (data + header.datasetOffset),
+      header.dimensionality, header.numPoints, false, true);
+}
+
+template<typename MetricType, typename ElemType>
+FlatTree<MetricType, ElemType>::~FlatTree()
+{
+  delete dataset;
+  Unmap(data, size);
+}
+
+template<typename MetricType, typename ElemType>
+void FlatTree<MetricType, ElemType>::Unmap(char* data, const size_t size)
+{
+#ifndef _WIN32
+  munmap(data, size);
+#else
+  (void) size;
+  delete[] data;
+#endif
+}
+
+template<typename MetricType, typename ElemType>
+void FlatTree<MetricType, ElemType>::Search(
+    const arma::Mat<ElemType>& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // The tree is read-only, so the queries are independent.
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    SearchPoint(querySet.col(i), SIZE_MAX, k, neighbors.unsafe_col(i),
+        distances.unsafe_col(i));
+  }
+}
+
+template<typename MetricType, typename ElemType>
+void FlatTree<MetricType, ElemType>::Search(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances) const
+{
+  neighbors.set_size(k, dataset->n_cols);
+  distances.set_size(k, dataset->n_cols);
+
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset->n_cols; ++i)
+  {
+    SearchPoint(dataset->col(i), i, k, neighbors.unsafe_col(oldFromNew[i]),
+        distances.unsafe_col(oldFromNew[i]));
+  }
+}
+
+template<typename MetricType, typename ElemType>
+template<typename VecType>
+void FlatTree<MetricType, ElemType>::SearchPoint(
+    const VecType& query,
+    const size_t skipIndex,
+    const size_t k,
+    arma::Col<size_t>&& neighbors,
+    arma::vec&& distances) const
+{
+  if (k == 0)
+    return;
+
+  CandidateList candidates;
+  arma::Col<ElemType> buffer(dataset->n_rows);
+  SearchNode(0, query, skipIndex, k, candidates, buffer);
+
+  // Neighbors that were not found are marked as invalid.
+  for (size_t i = candidates.size(); i < k; ++i)
+  {
+    neighbors[i] = SIZE_MAX;
+    distances[i] = DBL_MAX;
+  }
+
+  // The candidate list holds the worst candidate on top.
+  while (!candidates.empty())
+  {
+    const size_t i = candidates.size() - 1;
+    neighbors[i] = oldFromNew[candidates.top().second];
+    distances[i] = candidates.top().first;
+    candidates.pop();
+  }
+}
+
+template<typename MetricType, typename ElemType>
+template<typename VecType>
+void FlatTree<MetricType, ElemType>::SearchNode(
+    const size_t nodeIndex,
+    const VecType& query,
+    const size_t skipIndex,
+    const size_t k,
+    CandidateList& candidates,
+    arma::Col<ElemType>& buffer) const
+{
+  const Node& node = nodes[nodeIndex];
+
+  // First the points held by the node itself.
+  for (size_t i = node.begin; i < node.begin + node.numPoints; ++i)
+  {
+    if (i == skipIndex)
+      continue;
+
+    const double distance = MetricType::Evaluate(query, dataset->col(i));
+    if (candidates.size() < k)
+    {
+      candidates.push(std::make_pair(distance, i));
+    }
+    else if (distance < candidates.top().first)
+    {
+      candidates.pop();
+      candidates.push(std::make_pair(distance, i));
+    }
+  }
+
+  if (node.numChildren == 0)
+    return;
+
+  // Now visit the children, closest first, until they can be pruned.
+  std::vector<std::pair<double, size_t>> children(node.numChildren);
+  for (size_t c = 0; c < node.numChildren; ++c)
+  {
+    const size_t child = node.firstChild + c;
+    children[c] = std::make_pair(nodes[child].count == 0 ? DBL_MAX :
+        MinDistance(child, query, buffer), child);
+  }
+  std::sort(children.begin(), children.end());
+
+  for (size_t c = 0; c < children.size(); ++c)
+  {
+    const double bestDistance = (candidates.size() < k) ? DBL_MAX :
+        candidates.top().first;
+    if (children[c].first > bestDistance || nodes[children[c].second].count
+        == 0)
+      break;
+
+    SearchNode(children[c].second, query, skipIndex, k, candidates, buffer);
+  }
+}
+
+template<typename MetricType, typename ElemType>
+template<typename VecType>
+double FlatTree<MetricType, ElemType>::MinDistance(
+    const size_t nodeIndex,
+    const VecType& query,
+    arma::Col<ElemType>& buffer) const
+{
+  // The closest point of the bound is the query clamped to the bound.
+  const ElemType* lo = Lo(nodeIndex);
+  const ElemType* hi = Hi(nodeIndex);
+  for (size_t d = 0; d < buffer.n_elem; ++d)
+    buffer[d] = std::min(std::max((ElemType) query[d], lo[d]), hi[d]);
+
+  return MetricType::Evaluate(query, buffer);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
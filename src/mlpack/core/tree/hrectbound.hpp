@@ -18,6 +18,7 @@
 #include <mlpack/core/math/range.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include "bound_traits.hpp"
+#include "hrectbound_kernels.hpp"
 
 namespace mlpack {
 namespace bound {
@@ -214,6 +215,16 @@ class HRectBound
    */
   ElemType Diameter() const;
 
+  /**
+   * Move the ranges of the bound into the given memory, which must hold Dim()
+   * ranges and outlive the bound.  The bound does not free that memory.  This
+   * is used to store the bounds of many tree nodes contiguously; see
+   * BinarySpaceTree::Compact().
+   *
+   * @param memory Uninitialized memory for Dim() ranges.
+   */
+  void Relocate(math::RangeType<ElemType>* memory);
+
   /**
    * Serialize the bound object.
    */
@@ -225,6 +236,8 @@ class HRectBound
   size_t dim;
   //! The bounds for each dimension.
   math::RangeType<ElemType>* bounds;
+  //! Whether the bounds are owned by this object (see Relocate()).
+  bool ownsBounds;
   //! Cached minimum width of bound.
   ElemType minWidth;
 };
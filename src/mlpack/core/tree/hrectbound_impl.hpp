@@ -27,6 +27,7 @@ template<typename MetricType, typename ElemType>
 inline HRectBound<MetricType, ElemType>::HRectBound() :
     dim(0),
     bounds(NULL),
+    ownsBounds(true),
     minWidth(0)
 { /* Nothing to do. */ }
 
@@ -38,6 +39,7 @@ template<typename MetricType, typename ElemType>
 inline HRectBound<MetricType, ElemType>::HRectBound(const size_t dimension) :
     dim(dimension),
     bounds(new math::RangeType<ElemType>[dim]),
+    ownsBounds(true),
     minWidth(0)
 { /* Nothing to do. */ }
 
@@ -49,6 +51,7 @@ inline HRectBound<MetricType, ElemType>::HRectBound(
     const HRectBound<MetricType, ElemType>& other) :
     dim(other.Dim()),
     bounds(new math::RangeType<ElemType>[dim]),
+    ownsBounds(true),
     minWidth(other.MinWidth())
 {
   // Copy other bounds over.
@@ -68,11 +71,12 @@ inline HRectBound<
   if (dim != other.Dim())
   {
     // Reallocation is necessary.
-    if (bounds)
+    if (bounds && ownsBounds)
       delete[] bounds;
 
     dim = other.Dim();
     bounds = new math::RangeType<ElemType>[dim];
+    ownsBounds = true;
   }
 
   // Now copy each of the bound values.
@@ -92,11 +96,13 @@ inline HRectBound<MetricType, ElemType>::HRectBound(
     HRectBound<MetricType, ElemType>&& other) :
     dim(other.dim),
     bounds(other.bounds),
+    ownsBounds(other.ownsBounds),
     minWidth(other.minWidth)
 {
   // Fix the other bound.
   other.dim = 0;
   other.bounds = NULL;
+  other.ownsBounds = true;
   other.minWidth = 0.0;
 }
 
@@ -106,10 +112,27 @@ inline HRectBound<MetricType, ElemType>::HRectBound(
 template<typename MetricType, typename ElemType>
 inline HRectBound<MetricType, ElemType>::~HRectBound()
 {
-  if (bounds)
+  if (bounds && ownsBounds)
     delete[] bounds;
 }
 
+/**
+ * Move the ranges into the given memory, which the bound does not own.
+ */
+template<typename MetricType, typename ElemType>
+inline void HRectBound<MetricType, ElemType>::Relocate(
+    math::RangeType<ElemType>* memory)
+{
+  for (size_t i = 0; i < dim; i++)
+    new (memory + i) math::RangeType<ElemType>(bounds[i]);
+
+  if (bounds && ownsBounds)
+    delete[] bounds;
+
+  bounds = memory;
+  ownsBounds = false;
+}
+
 /**
  * Resets all dimensions to the empty set.
  */
@@ -189,8 +212,8 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
     }
     else
     {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
+      sum += IntegerPower<MetricType::Power>(
+          (lower + fabs(lower)) + (higher + fabs(higher)));
     }
   }
 
@@ -226,6 +249,16 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
 {
   Log::Assert(dim == other.dim);
 
+  // In higher dimensions, the L1 and L2 distances use vectorized kernels.
+  if (HRectBoundKernels<ElemType>::Available && MetricType::Power <= 2 &&
+      dim >= minimumKernelDimension)
+  {
+    const ElemType sum = HRectBoundKernels<ElemType>::MinDistance(bounds,
+        other.bounds, dim, MetricType::Power);
+    return (MetricType::Power == 2 && MetricType::TakeRoot) ?
+        (ElemType) std::sqrt(sum) : sum;
+  }
+
   ElemType sum = 0;
   const math::RangeType<ElemType>* mbound = bounds;
   const math::RangeType<ElemType>* obound = other.bounds;
@@ -249,8 +282,8 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
     }
     else
     {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
+      sum += IntegerPower<MetricType::Power>(
+          (lower + fabs(lower)) + (higher + fabs(higher)));
     }
 
     // Move bound pointers.
@@ -302,7 +335,7 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     else if (MetricType::Power == 2)
       sum += v * v;
     else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+      sum += IntegerPower<MetricType::Power>(v);
   }
 
   // The compiler should optimize out this if statement entirely.
@@ -327,10 +360,19 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const HRectBound& other)
     const
 {
-  ElemType sum = 0;
-
   Log::Assert(dim == other.dim);
 
+  // In higher dimensions, the L1 and L2 distances use vectorized kernels.
+  if (HRectBoundKernels<ElemType>::Available && MetricType::Power <= 2 &&
+      dim >= minimumKernelDimension)
+  {
+    const ElemType sum = HRectBoundKernels<ElemType>::MaxDistance(bounds,
+        other.bounds, dim, MetricType::Power);
+    return (MetricType::Power == 2 && MetricType::TakeRoot) ?
+        (ElemType) std::sqrt(sum) : sum;
+  }
+
+  ElemType sum = 0;
   ElemType v;
   for (size_t d = 0; d < dim; d++)
   {
@@ -343,7 +385,7 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     else if (MetricType::Power == 2)
       sum += v * v;
     else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+      sum += IntegerPower<MetricType::Power>(v);
   }
 
   // The compiler should optimize out this if statement entirely.
@@ -368,10 +410,24 @@ inline math::RangeType<ElemType>
 HRectBound<MetricType, ElemType>::RangeDistance(
     const HRectBound& other) const
 {
+  Log::Assert(dim == other.dim);
+
   ElemType loSum = 0;
   ElemType hiSum = 0;
 
-  Log::Assert(dim == other.dim);
+  // In higher dimensions, the L1 and L2 distances use vectorized kernels.
+  if (HRectBoundKernels<ElemType>::Available && MetricType::Power <= 2 &&
+      dim >= minimumKernelDimension)
+  {
+    HRectBoundKernels<ElemType>::RangeDistance(bounds, other.bounds, dim,
+        MetricType::Power, loSum, hiSum);
+    if (MetricType::Power == 2 && MetricType::TakeRoot)
+    {
+      return math::RangeType<ElemType>((ElemType) std::sqrt(loSum),
+                                       (ElemType) std::sqrt(hiSum));
+    }
+    return math::RangeType<ElemType>(loSum, hiSum);
+  }
 
   ElemType v1, v2, vLo, vHi;
   for (size_t d = 0; d < dim; d++)
@@ -403,8 +459,8 @@ HRectBound<MetricType, ElemType>::RangeDistance(
     }
     else
     {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
+      loSum += IntegerPower<MetricType::Power>(vLo);
+      hiSum += IntegerPower<MetricType::Power>(vHi);
     }
   }
 
@@ -479,8 +535,8 @@ HRectBound<MetricType, ElemType>::RangeDistance(
     }
     else
     {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
+      loSum += IntegerPower<MetricType::Power>(vLo);
+      hiSum += IntegerPower<MetricType::Power>(vHi);
     }
   }
 
@@ -668,9 +724,10 @@ void HRectBound<MetricType, ElemType>::serialize(
   // Allocate memory for the bounds, if necessary.
   if (Archive::is_loading::value)
   {
-    if (bounds)
+    if (bounds && ownsBounds)
       delete[] bounds;
     bounds = new math::RangeType<ElemType>[dim];
+    ownsBounds = true;
   }
 
   // We can't serialize a raw array directly, so wrap it.
@@ -0,0 +1,490 @@
+/**
+ * @file hrectbound_kernels.cpp
+ *
+ * Implementation of the vectorized HRectBound distance kernels and of the
+ * runtime selection of the instruction set.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "hrectbound_kernels.hpp"
+
+// The AVX2 kernels need the target attribute of GCC and clang on x86.
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+  #define MLPACK_HRECTBOUND_AVX2
+  #include <immintrin.h>
+#endif
+
+namespace mlpack {
+namespace bound {
+
+// The kernels treat an array of ranges as an array of interleaved lower and
+// upper bounds.
+static_assert(sizeof(math::RangeType<double>) == 2 * sizeof(double),
+    "math::RangeType<double> must hold exactly two doubles");
+static_assert(sizeof(math::RangeType<float>) == 2 * sizeof(float),
+    "math::RangeType<float> must hold exactly two floats");
+
+namespace {
+
+//! The minimum distance in one dimension.
+template<typename ElemType>
+inline ElemType MinDimension(const math::RangeType<ElemType>& a,
+                             const math::RangeType<ElemType>& b)
+{
+  // At most one of the two terms is positive.
+  return std::max(b.Lo() - a.Hi(), (ElemType) 0) +
+      std::max(a.Lo() - b.Hi(), (ElemType) 0);
+}
+
+//! The maximum distance in one dimension.
+template<typename ElemType>
+inline ElemType MaxDimension(const math::RangeType<ElemType>& a,
+                             const math::RangeType<ElemType>& b)
+{
+  return std::max(std::fabs(b.Hi() - a.Lo()), std::fabs(a.Hi() - b.Lo()));
+}
+
+//! The minimum and maximum distance in one dimension.
+template<typename ElemType>
+inline void RangeDimension(const math::RangeType<ElemType>& a,
+                           const math::RangeType<ElemType>& b,
+                           ElemType& lo,
+                           ElemType& hi)
+{
+  const ElemType v1 = b.Lo() - a.Hi();
+  const ElemType v2 = a.Lo() - b.Hi();
+  lo = std::max(std::max(v1, v2), (ElemType) 0);
+  hi = -std::min(v1, v2);
+}
+
+template<typename ElemType>
+ElemType ScalarMinDistance(const math::RangeType<ElemType>* a,
+                           const math::RangeType<ElemType>* b,
+                           const size_t begin,
+                           const size_t dim,
+                           const int power)
+{
+  ElemType sum = 0;
+  for (size_t d = begin; d < dim; ++d)
+  {
+    const ElemType v = MinDimension(a[d], b[d]);
+    sum += (power == 1) ? v : v * v;
+  }
+  return sum;
+}
+
+template<typename ElemType>
+ElemType ScalarMaxDistance(const math::RangeType<ElemType>* a,
+                           const math::RangeType<ElemType>* b,
+                           const size_t begin,
+                           const size_t dim,
+                           const int power)
+{
+  ElemType sum = 0;
+  for (size_t d = begin; d < dim; ++d)
+  {
+    const ElemType v = MaxDimension(a[d], b[d]);
+    sum += (power == 1) ? v : v * v;
+  }
+  return sum;
+}
+
+template<typename ElemType>
+void ScalarRangeDistance(const math::RangeType<ElemType>* a,
+                         const math::RangeType<ElemType>* b,
+                         const size_t begin,
+                         const size_t dim,
+                         const int power,
+                         ElemType& loSum,
+                         ElemType& hiSum)
+{
+  loSum = 0;
+  hiSum = 0;
+  for (size_t d = begin; d < dim; ++d)
+  {
+    ElemType lo, hi;
+    RangeDimension(a[d], b[d], lo, hi);
+    loSum += (power == 1) ? lo : lo * lo;
+    hiSum += (power == 1) ? hi : hi * hi;
+  }
+}
+
+// The scalar kernels, used when no vector instruction set is available.
+template<typename ElemType>
+ElemType ScalarMinKernel(const math::RangeType<ElemType>* a,
+                         const math::RangeType<ElemType>* b,
+                         const size_t dim,
+                         const int power)
+{
+  return ScalarMinDistance(a, b, 0, dim, power);
+}
+
+template<typename ElemType>
+ElemType ScalarMaxKernel(const math::RangeType<ElemType>* a,
+                         const math::RangeType<ElemType>* b,
+                         const size_t dim,
+                         const int power)
+{
+  return ScalarMaxDistance(a, b, 0, dim, power);
+}
+
+template<typename ElemType>
+void ScalarRangeKernel(const math::RangeType<ElemType>* a,
+                       const math::RangeType<ElemType>* b,
+                       const size_t dim,
+                       const int power,
+                       ElemType& loSum,
+                       ElemType& hiSum)
+{
+  ScalarRangeDistance(a, b, 0, dim, power, loSum, hiSum);
+}
+
+#ifdef MLPACK_HRECTBOUND_AVX2
+
+/**
+ * In the AVX2 kernels, a register holds the interleaved lower and upper
+ * bounds (lo, hi) of two (double) or four (float) dimensions.  Swapping the
+ * lanes of each pair of a gives (a.hi, a.lo), so b - swap(a) holds
+ * (b.lo - a.hi, b.hi - a.lo) for each dimension, and the distances follow
+ * from maxima and minima within each pair, without any branch.  Both lanes of
+ * a pair hold the result for the dimension, so the sums count every dimension
+ * twice and are halved at the end.  The upper halves of the registers are
+ * cleared before the scalar loop over the remaining dimensions, to avoid the
+ * penalty of mixing AVX and SSE instructions.
+ */
+__attribute__((target("avx2")))
+inline double HorizontalSum(const __m256d v)
+{
+  const __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v),
+      _mm256_extractf128_pd(v, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+__attribute__((target("avx2")))
+inline float HorizontalSum(const __m256 v)
+{
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v),
+      _mm256_extractf128_ps(v, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  return _mm_cvtss_f32(_mm_add_ss(sum, _mm_movehdup_ps(sum)));
+}
+
+__attribute__((target("avx2")))
+double AVX2MinKernel(const math::RangeType<double>* a,
+                     const math::RangeType<double>* b,
+                     const size_t dim,
+                     const int power)
+{
+  const double* aData = (const double*) a;
+  const double* bData = (const double*) b;
+  // The signs that turn (b.lo - a.hi, b.hi - a.lo) into
+  // (b.lo - a.hi, a.lo - b.hi).
+  const __m256d signs = _mm256_set_pd(-1.0, 1.0, -1.0, 1.0);
+  const __m256d zero = _mm256_setzero_pd();
+
+  __m256d sum = zero;
+  size_t d = 0;
+  for (; d + 2 <= dim; d += 2)
+  {
+    const __m256d va = _mm256_loadu_pd(aData + 2 * d);
+    const __m256d vb = _mm256_loadu_pd(bData + 2 * d);
+    const __m256d diff = _mm256_mul_pd(_mm256_sub_pd(vb,
+        _mm256_permute_pd(va, 0x5)), signs);
+    const __m256d pos = _mm256_max_pd(diff, zero);
+    const __m256d v = _mm256_add_pd(pos, _mm256_permute_pd(pos, 0x5));
+    sum = _mm256_add_pd(sum, (power == 1) ? v : _mm256_mul_pd(v, v));
+  }
+
+  const double result = 0.5 * HorizontalSum(sum);
+  _mm256_zeroupper();
+  return result + ScalarMinDistance(a, b, d, dim, power);
+}
+
+__attribute__((target("avx2")))
+double AVX2MaxKernel(const math::RangeType<double>* a,
+                     const math::RangeType<double>* b,
+                     const size_t dim,
+                     const int power)
+{
+  const double* aData = (const double*) a;
+  const double* bData = (const double*) b;
+  const __m256d absMask = _mm256_castsi256_pd(
+      _mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+
+  __m256d sum = _mm256_setzero_pd();
+  size_t d = 0;
+  for (; d + 2 <= dim; d += 2)
+  {
+    const __m256d va = _mm256_loadu_pd(aData + 2 * d);
+    const __m256d vb = _mm256_loadu_pd(bData + 2 * d);
+    const __m256d diff = _mm256_and_pd(_mm256_sub_pd(vb,
+        _mm256_permute_pd(va, 0x5)), absMask);
+    const __m256d v = _mm256_max_pd(diff, _mm256_permute_pd(diff, 0x5));
+    sum = _mm256_add_pd(sum, (power == 1) ? v : _mm256_mul_pd(v, v));
+  }
+
+  const double result = 0.5 * HorizontalSum(sum);
+  _mm256_zeroupper();
+  return result + ScalarMaxDistance(a, b, d, dim, power);
+}
+
+__attribute__((target("avx2")))
+void AVX2RangeKernel(const math::RangeType<double>* a,
+                     const math::RangeType<double>* b,
+                     const size_t dim,
+                     const int power,
+                     double& loSum,
+                     double& hiSum)
+{
+  const double* aData = (const double*) a;
+  const double* bData = (const double*) b;
+  const __m256d signs = _mm256_set_pd(-1.0, 1.0, -1.0, 1.0);
+  const __m256d zero = _mm256_setzero_pd();
+
+  __m256d lo = zero;
+  __m256d hi = zero;
+  size_t d = 0;
+  for (; d + 2 <= dim; d += 2)
+  {
+    const __m256d va = _mm256_loadu_pd(aData + 2 * d);
+    const __m256d vb = _mm256_loadu_pd(bData + 2 * d);
+    const __m256d diff = _mm256_mul_pd(_mm256_sub_pd(vb,
+        _mm256_permute_pd(va, 0x5)), signs);
+    const __m256d swapped = _mm256_permute_pd(diff, 0x5);
+    const __m256d vLo = _mm256_max_pd(_mm256_max_pd(diff, swapped), zero);
+    const __m256d vHi = _mm256_sub_pd(zero, _mm256_min_pd(diff, swapped));
+    lo = _mm256_add_pd(lo, (power == 1) ? vLo : _mm256_mul_pd(vLo, vLo));
+    hi = _mm256_add_pd(hi, (power == 1) ? vHi : _mm256_mul_pd(vHi, vHi));
+  }
+
+  const double vectorLo = 0.5 * HorizontalSum(lo);
+  const double vectorHi = 0.5 * HorizontalSum(hi);
+  _mm256_zeroupper();
+  ScalarRangeDistance(a, b, d, dim, power, loSum, hiSum);
+  loSum += vectorLo;
+  hiSum += vectorHi;
+}
+
+__attribute__((target("avx2")))
+float AVX2MinKernel(const math::RangeType<float>* a,
+                    const math::RangeType<float>* b,
+                    const size_t dim,
+                    const int power)
+{
+  const float* aData = (const float*) a;
+  const float* bData = (const float*) b;
+  const __m256 signs = _mm256_set_ps(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f,
+      -1.0f, 1.0f);
+  const __m256 zero = _mm256_setzero_ps();
+
+  __m256 sum = zero;
+  size_t d = 0;
+  for (; d + 4 <= dim; d += 4)
+  {
+    const __m256 va = _mm256_loadu_ps(aData + 2 * d);
+    const __m256 vb = _mm256_loadu_ps(bData + 2 * d);
+    const __m256 diff = _mm256_mul_ps(_mm256_sub_ps(vb,
+        _mm256_permute_ps(va, 0xB1)), signs);
+    const __m256 pos = _mm256_max_ps(diff, zero);
+    const __m256 v = _mm256_add_ps(pos, _mm256_permute_ps(pos, 0xB1));
+    sum = _mm256_add_ps(sum, (power == 1) ? v : _mm256_mul_ps(v, v));
+  }
+
+  const float result = 0.5f * HorizontalSum(sum);
+  _mm256_zeroupper();
+  return result + ScalarMinDistance(a, b, d, dim, power);
+}
+
+__attribute__((target("avx2")))
+float AVX2MaxKernel(const math::RangeType<float>* a,
+                    const math::RangeType<float>* b,
+                    const size_t dim,
+                    const int power)
+{
+  const float* aData = (const float*) a;
+  const float* bData = (const float*) b;
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+  __m256 sum = _mm256_setzero_ps();
+  size_t d = 0;
+  for (; d + 4 <= dim; d += 4)
+  {
+    const __m256 va = _mm256_loadu_ps(aData + 2 * d);
+    const __m256 vb = _mm256_loadu_ps(bData + 2 * d);
+    const __m256 diff = _mm256_and_ps(_mm256_sub_ps(vb,
+        _mm256_permute_ps(va, 0xB1)), absMask);
+    const __m256 v = _mm256_max_ps(diff, _mm256_permute_ps(diff, 0xB1));
+    sum = _mm256_add_ps(sum, (power == 1) ? v : _mm256_mul_ps(v, v));
+  }
+
+  const float result = 0.5f * HorizontalSum(sum);
+  _mm256_zeroupper();
+  return result + ScalarMaxDistance(a, b, d, dim, power);
+}
+
+__attribute__((target("avx2")))
+void AVX2RangeKernel(const math::RangeType<float>* a,
+                     const math::RangeType<float>* b,
+                     const size_t dim,
+                     const int power,
+                     float& loSum,
+                     float& hiSum)
+{
+  const float* aData = (const float*) a;
+  const float* bData = (const float*) b;
+  const __m256 signs = _mm256_set_ps(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f,
+      -1.0f, 1.0f);
+  const __m256 zero = _mm256_setzero_ps();
+
+  __m256 lo = zero;
+  __m256 hi = zero;
+  size_t d = 0;
+  for (; d + 4 <= dim; d += 4)
+  {
+    const __m256 va = _mm256_loadu_ps(aData + 2 * d);
+    const __m256 vb = _mm256_loadu_ps(bData + 2 * d);
+    const __m256 diff = _mm256_mul_ps(_mm256_sub_ps(vb,
+        _mm256_permute_ps(va, 0xB1)), signs);
+    const __m256 swapped = _mm256_permute_ps(diff, 0xB1);
+    const __m256 vLo = _mm256_max_ps(_mm256_max_ps(diff, swapped), zero);
+    const __m256 vHi = _mm256_sub_ps(zero, _mm256_min_ps(diff, swapped));
+    lo = _mm256_add_ps(lo, (power == 1) ? vLo : _mm256_mul_ps(vLo, vLo));
+    hi = _mm256_add_ps(hi, (power == 1) ? vHi : _mm256_mul_ps(vHi, vHi));
+  }
+
+  const float vectorLo = 0.5f * HorizontalSum(lo);
+  const float vectorHi = 0.5f * HorizontalSum(hi);
+  _mm256_zeroupper();
+  ScalarRangeDistance(a, b, d, dim, power, loSum, hiSum);
+  loSum += vectorLo;
+  hiSum += vectorHi;
+}
+
+#endif
+
+//! Whether the processor supports the AVX2 kernels.
+bool UseAVX2()
+{
+#ifdef MLPACK_HRECTBOUND_AVX2
+  static const bool useAVX2 = __builtin_cpu_supports("avx2");
+  return useAVX2;
+#else
+  return false;
+#endif
+}
+
+/**
+ * The kernels for one element type, selected once for the processor.
+ */
+template<typename ElemType>
+struct KernelTable
+{
+  typedef ElemType (*DistanceKernel)(const math::RangeType<ElemType>*,
+                                     const math::RangeType<ElemType>*,
+                                     const size_t,
+                                     const int);
+  typedef void (*RangeKernel)(const math::RangeType<ElemType>*,
+                              const math::RangeType<ElemType>*,
+                              const size_t,
+                              const int,
+                              ElemType&,
+                              ElemType&);
+
+  KernelTable() :
+      minDistance(&ScalarMinKernel<ElemType>),
+      maxDistance(&ScalarMaxKernel<ElemType>),
+      rangeDistance(&ScalarRangeKernel<ElemType>)
+  {
+#ifdef MLPACK_HRECTBOUND_AVX2
+    if (UseAVX2())
+    {
+      minDistance = &AVX2MinKernel;
+      maxDistance = &AVX2MaxKernel;
+      rangeDistance = &AVX2RangeKernel;
+    }
+#endif
+  }
+
+  DistanceKernel minDistance;
+  DistanceKernel maxDistance;
+  RangeKernel rangeDistance;
+};
+
+template<typename ElemType>
+const KernelTable<ElemType>& Kernels()
+{
+  static const KernelTable<ElemType> table;
+  return table;
+}
+
+} // namespace
+
+double HRectBoundKernels<double>::MinDistance(
+    const math::RangeType<double>* a,
+    const math::RangeType<double>* b,
+    const size_t dim,
+    const int power)
+{
+  return Kernels<double>().minDistance(a, b, dim, power);
+}
+
+double HRectBoundKernels<double>::MaxDistance(
+    const math::RangeType<double>* a,
+    const math::RangeType<double>* b,
+    const size_t dim,
+    const int power)
+{
+  return Kernels<double>().maxDistance(a, b, dim, power);
+}
+
+void HRectBoundKernels<double>::RangeDistance(
+    const math::RangeType<double>* a,
+    const math::RangeType<double>* b,
+    const size_t dim,
+    const int power,
+    double& loSum,
+    double& hiSum)
+{
+  Kernels<double>().rangeDistance(a, b, dim, power, loSum, hiSum);
+}
+
+float HRectBoundKernels<float>::MinDistance(
+    const math::RangeType<float>* a,
+    const math::RangeType<float>* b,
+    const size_t dim,
+    const int power)
+{
+  return Kernels<float>().minDistance(a, b, dim, power);
+}
+
+float HRectBoundKernels<float>::MaxDistance(
+    const math::RangeType<float>* a,
+    const math::RangeType<float>* b,
+    const size_t dim,
+    const int power)
+{
+  return Kernels<float>().maxDistance(a, b, dim, power);
+}
+
+void HRectBoundKernels<float>::RangeDistance(
+    const math::RangeType<float>* a,
+    const math::RangeType<float>* b,
+    const size_t dim,
+    const int power,
+    float& loSum,
+    float& hiSum)
+{
+  Kernels<float>().rangeDistance(a, b, dim, power, loSum, hiSum);
+}
+
+std::string HRectBoundKernelName()
+{
+  return UseAVX2() ? "avx2" : "scalar";
+}
+
+} // namespace bound
+} // namespace mlpack
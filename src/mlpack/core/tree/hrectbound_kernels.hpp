@@ -0,0 +1,146 @@
+/**
+ * @file hrectbound_kernels.hpp
+ *
+ * Vectorized kernels for the bound-to-bound distances of HRectBound.  The
+ * kernels are compiled for several instruction sets, and the fastest one that
+ * the processor supports is selected at runtime.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_HRECTBOUND_KERNELS_HPP
+#define MLPACK_CORE_TREE_HRECTBOUND_KERNELS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/range.hpp>
+
+namespace mlpack {
+namespace bound {
+
+/**
+ * The smallest dimensionality for which HRectBound uses the vectorized
+ * kernels.  Below it, the inlined scalar loop is faster than the call to the
+ * kernel.
+ */
+const size_t minimumKernelDimension = 8;
+
+/**
+ * The kernels for one element type.  Each kernel takes the bounds of two
+ * hyperrectangles of dimensionality dim and returns the sum over all
+ * dimensions of the per-dimension distance raised to the given power, which
+ * must be 1 or 2; the caller takes the root.  By default no kernels exist for
+ * an element type.
+ *
+ * @tparam ElemType Type of the bounds.
+ */
+template<typename ElemType>
+class HRectBoundKernels
+{
+ public:
+  //! Whether the kernels below exist for this element type.
+  static const bool Available = false;
+
+  //! The sum for the minimum distance between two bounds.
+  static ElemType MinDistance(const math::RangeType<ElemType>* /* a */,
+                              const math::RangeType<ElemType>* /* b */,
+                              const size_t /* dim */,
+                              const int /* power */)
+  { return 0; }
+
+  //! The sum for the maximum distance between two bounds.
+  static ElemType MaxDistance(const math::RangeType<ElemType>* /* a */,
+                              const math::RangeType<ElemType>* /* b */,
+                              const size_t /* dim */,
+                              const int /* power */)
+  { return 0; }
+
+  //! The sums for the minimum and maximum distance between two bounds.
+  static void RangeDistance(const math::RangeType<ElemType>* /* a */,
+                            const math::RangeType<ElemType>* /* b */,
+                            const size_t /* dim */,
+                            const int /* power */,
+                            ElemType& loSum,
+                            ElemType& hiSum)
+  { loSum = hiSum = 0; }
+};
+
+/**
+ * The kernels for double precision bounds.
+ */
+template<>
+class HRectBoundKernels<double>
+{
+ public:
+  static const bool Available = true;
+
+  static double MinDistance(const math::RangeType<double>* a,
+                            const math::RangeType<double>* b,
+                            const size_t dim,
+                            const int power);
+
+  static double MaxDistance(const math::RangeType<double>* a,
+                            const math::RangeType<double>* b,
+                            const size_t dim,
+                            const int power);
+
+  static void RangeDistance(const math::RangeType<double>* a,
+                            const math::RangeType<double>* b,
+                            const size_t dim,
+                            const int power,
+                            double& loSum,
+                            double& hiSum);
+};
+
+/**
+ * The kernels for single precision bounds.
+ */
+template<>
+class HRectBoundKernels<float>
+{
+ public:
+  static const bool Available = true;
+
+  static float MinDistance(const math::RangeType<float>* a,
+                           const math::RangeType<float>* b,
+                           const size_t dim,
+                           const int power);
+
+  static float MaxDistance(const math::RangeType<float>* a,
+                           const math::RangeType<float>* b,
+                           const size_t dim,
+                           const int power);
+
+  static void RangeDistance(const math::RangeType<float>* a,
+                            const math::RangeType<float>* b,
+                            const size_t dim,
+                            const int power,
+                            float& loSum,
+                            float& hiSum);
+};
+
+/**
+ * Return the name of the instruction set used by the kernels on this machine
+ * ("avx2" or "scalar").
+ */
+std::string HRectBoundKernelName();
+
+/**
+ * Raise the given value to the given (compile-time) power by repeated
+ * multiplication, which is much faster than std::pow() and can be vectorized
+ * by the compiler.
+ */
+template<int Power, typename ElemType>
+inline ElemType IntegerPower(const ElemType value)
+{
+  ElemType result = value;
+  for (int i = 1; i < Power; ++i)
+    result *= value;
+  return result;
+}
+
+} // namespace bound
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,43 @@
+/**
+ * @file is_dynamic_tree.hpp
+ *
+ * Definition of IsDynamicTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_IS_DYNAMIC_TREE_HPP
+#define MLPACK_CORE_TREE_IS_DYNAMIC_TREE_HPP
+
+#include "rectangle_tree.hpp"
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+// Useful struct to check whether points can be inserted into and deleted from
+// a tree after it is built, with InsertPoint(size_t) and DeletePoint(size_t).
+template<typename TreeType>
+struct IsDynamicTree
+{
+  static const bool value = false;
+};
+
+// Specialization for RectangleTree and its variants.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+struct IsDynamicTree<tree::RectangleTree<MetricType, StatisticType, MatType,
+    SplitType, DescentType, AuxiliaryInformationType>>
+{
+  static const bool value = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,196 @@
+/**
+ * @file leaf_base_case.hpp
+ *
+ * Support for rules that evaluate all base cases between two leaves at once:
+ * the LeafDistances class, which bounds the distances between all points of
+ * two leaves with one matrix multiplication, and the LeafBaseCase() function,
+ * which dual-tree traversers call when both nodes are leaves.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_LEAF_BASE_CASE_HPP
+#define MLPACK_CORE_TREE_LEAF_BASE_CASE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/range.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The smallest number of point pairs in two leaves for which the rules
+ * evaluate the base cases at once; for fewer pairs, the matrix multiplication
+ * does not pay off.
+ */
+const size_t minimumLeafBaseCases = 64;
+
+/**
+ * LeafDistances holds the distances between all points of a query leaf and a
+ * reference leaf, computed as ||q||^2 + ||r||^2 - 2 q^T r with one matrix
+ * multiplication.  These distances are not exact, so LeafDistances returns a
+ * range that is guaranteed to contain the exact distance; rules use it to
+ * skip the pairs that cannot change the result, and evaluate the remaining
+ * pairs exactly, so that the results are the same as with separate base
+ * cases.
+ *
+ * By default the class is not supported; it is specialized for the (squared)
+ * Euclidean distance on dense matrices.  The points of each leaf are
+ * [begin, begin + count) in their dataset.
+ *
+ * @tparam MetricType The metric of the rules.
+ * @tparam MatType The type of the datasets.
+ */
+template<typename MetricType, typename MatType>
+class LeafDistances
+{
+ public:
+  //! Whether distances can be computed for this metric and matrix type.
+  static const bool Supported = false;
+
+  LeafDistances(const MatType& /* querySet */,
+                const size_t /* queryBegin */,
+                const size_t /* queryCount */,
+                const MatType& /* referenceSet */,
+                const size_t /* referenceBegin */,
+                const size_t /* referenceCount */) { }
+
+  //! Return a range containing the distance between the given points.
+  math::Range Range(const size_t /* queryIndex */,
+                    const size_t /* referenceIndex */) const
+  {
+    return math::Range(0.0, DBL_MAX);
+  }
+};
+
+/**
+ * The leaf distances for the (squared) Euclidean distance on dense matrices.
+ */
+template<bool TakeRoot, typename ElemType>
+class LeafDistances<metric::LMetric<2, TakeRoot>, arma::Mat<ElemType>>
+{
+ public:
+  static const bool Supported = true;
+
+  /**
+   * Compute the distances between the points of the given leaves.
+   *
+   * @param querySet The dataset of the query leaf.
+   * @param queryBegin Index of the first point of the query leaf.
+   * @param queryCount Number of points of the query leaf.
+   * @param referenceSet The dataset of the reference leaf.
+   * @param referenceBegin Index of the first point of the reference leaf.
+   * @param referenceCount Number of points of the reference leaf.
+   */
+  LeafDistances(const arma::Mat<ElemType>& querySet,
+                const size_t queryBegin,
+                const size_t queryCount,
+                const arma::Mat<ElemType>& referenceSet,
+                const size_t referenceBegin,
+                const size_t referenceCount)
+  {
+    // Alias the points of the leaves to avoid copying them.
+    const arma::Mat<ElemType> queries(const_cast<ElemType*>(
+        querySet.colptr(queryBegin)), querySet.n_rows, queryCount, false,
+        true);
+    const arma::Mat<ElemType> references(const_cast<ElemType*>(
+        referenceSet.colptr(referenceBegin)), referenceSet.n_rows,
+        referenceCount, false, true);
+
+    queryNorms = arma::sum(arma::square(queries), 0).t();
+    referenceNorms = arma::sum(arma::square(references), 0);
+
+    squaredDistances = -2 * queries.t() * references;
+    squaredDistances.each_col() += queryNorms;
+    squaredDistances.each_row() += referenceNorms;
+
+    // With rounding, the error of each squared distance is at most about
+    // (2 * dim + 4) * epsilon * (||q||^2 + ||r||^2).  Twice that also covers
+    // the rounding of the exact evaluation that the range is compared with.
+    errorScale = (4 * querySet.n_rows + 16) *
+        std::numeric_limits<ElemType>::epsilon();
+  }
+
+  //! Return a range containing the distance between the given points.
+  math::Range Range(const size_t queryIndex,
+                    const size_t referenceIndex) const
+  {
+    const double squaredDistance = squaredDistances(queryIndex,
+        referenceIndex);
+    const double error = errorScale * (queryNorms[queryIndex] +
+        referenceNorms[referenceIndex]);
+
+    const double lo = std::max(squaredDistance - error, 0.0);
+    const double hi = squaredDistance + error;
+    if (TakeRoot)
+      return math::Range(std::sqrt(lo), std::sqrt(hi));
+    else
+      return math::Range(lo, hi);
+  }
+
+ private:
+  //! The approximate squared distances, with one row per query point.
+  arma::Mat<ElemType> squaredDistances;
+  //! The squared norm of each query point.
+  arma::Col<ElemType> queryNorms;
+  //! The squared norm of each reference point.
+  arma::Row<ElemType> referenceNorms;
+  //! The relative error of the squared distances.
+  double errorScale;
+};
+
+/**
+ * Checks whether RuleType has the method
+ *
+ *   bool LeafBaseCase(TreeType& queryNode, TreeType& referenceNode);
+ *
+ * which evaluates all base cases between two leaves at once, and returns false
+ * when the traverser should evaluate them one by one instead.
+ */
+template<typename RuleType, typename TreeType>
+class HasLeafBaseCase
+{
+ private:
+  template<typename R>
+  static auto Check(int) -> decltype(std::declval<R&>().LeafBaseCase(
+      std::declval<TreeType&>(), std::declval<TreeType&>()), std::true_type());
+
+  template<typename R>
+  static std::false_type Check(...);
+
+ public:
+  static const bool value = decltype(Check<RuleType>(0))::value;
+};
+
+/**
+ * Let the rules evaluate all base cases between two leaves at once, if they
+ * can.  Return false if the traverser must evaluate them one by one.
+ */
+template<typename RuleType, typename TreeType>
+inline typename std::enable_if<
+    HasLeafBaseCase<RuleType, TreeType>::value, bool>::type
+LeafBaseCase(RuleType& rule, TreeType& queryNode, TreeType& referenceNode)
+{
+  return rule.LeafBaseCase(queryNode, referenceNode);
+}
+
+/**
+ * Rules without a leaf base case evaluate the base cases one by one.
+ */
+template<typename RuleType, typename TreeType>
+inline typename std::enable_if<
+    !HasLeafBaseCase<RuleType, TreeType>::value, bool>::type
+LeafBaseCase(RuleType& /* rule */,
+             TreeType& /* queryNode */,
+             TreeType& /* referenceNode */)
+{
+  return false;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
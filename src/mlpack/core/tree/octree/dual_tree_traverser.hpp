@@ -14,6 +14,8 @@
 
 #include <mlpack/prereqs.hpp>
 #include "octree.hpp"
+#include "../leaf_base_case.hpp"
+#include "../traversal_scratch.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -57,6 +59,26 @@ class Octree<MetricType, StatisticType, MatType>::DualTreeTraverser
   size_t& NumBaseCases() { return numBaseCases; }
 
  private:
+  //! A child of a reference node, with its score.
+  struct ChildAndScore
+  {
+    size_t child;
+    double score;
+    typename RuleType::TraversalInfoType travInfo;
+  };
+
+  //! Order the children by score, and then by index.
+  static bool ChildComparator(const ChildAndScore& a, const ChildAndScore& b)
+  {
+    return (a.score < b.score) || (a.score == b.score && a.child < b.child);
+  }
+
+  //! Score the children of the reference node against the query node, and
+  //! sort them.
+  void ScoreChildren(Octree& queryNode,
+                     Octree& referenceNode,
+                     std::vector<ChildAndScore>& children);
+
   //! The rule type to use.
   RuleType& rule;
 
@@ -72,6 +94,10 @@ class Octree<MetricType, StatisticType, MatType>::DualTreeTraverser
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! The scored children of each level of the recursion, reused for every
+  //! node.
+  TraversalScratch<ChildAndScore> scratch;
 };
 
 } // namespace tree
@@ -42,7 +42,13 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
   // Store the current traversal info.
   traversalInfo = rule.TraversalInfo();
 
-  if (queryNode.IsLeaf() && referenceNode.IsLeaf())
+  if (queryNode.IsLeaf() && referenceNode.IsLeaf() &&
+      LeafBaseCase(rule, queryNode, referenceNode))
+  {
+    // The rules evaluated all base cases between the two leaves at once.
+    numBaseCases += queryNode.NumPoints() * referenceNode.NumPoints();
+  }
+  else if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
     const size_t begin = queryNode.Point(0);
     const size_t end = begin + queryNode.NumPoints();
@@ -85,29 +91,21 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
   {
     // We have to recurse down the reference node, so we need to do it in an
     // ordered manner.
-    arma::vec scores(referenceNode.NumChildren());
-    std::vector<typename RuleType::TraversalInfoType>
-        tis(referenceNode.NumChildren());
-    for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
-    {
-      rule.TraversalInfo() = traversalInfo;
-      scores[i] = rule.Score(queryNode, referenceNode.Child(i));
-      tis[i] = rule.TraversalInfo();
-    }
+    ScratchVector<ChildAndScore> buffer(scratch, referenceNode.NumChildren());
+    std::vector<ChildAndScore>& children = buffer.Vector();
+    ScoreChildren(queryNode, referenceNode, children);
 
-    // Sort the scores.
-    arma::uvec scoreOrder = arma::sort_index(scores);
-    for (size_t i = 0; i < scoreOrder.n_elem; ++i)
+    for (size_t i = 0; i < children.size(); ++i)
     {
-      if (scores[scoreOrder[i]] == DBL_MAX)
+      if (children[i].score == DBL_MAX)
       {
         // We don't need to check any more---all children past here are pruned.
-        numPrunes += scoreOrder.n_elem - i;
+        numPrunes += children.size() - i;
         break;
       }
 
-      rule.TraversalInfo() = tis[scoreOrder[i]];
-      Traverse(queryNode, referenceNode.Child(scoreOrder[i]));
+      rule.TraversalInfo() = children[i].travInfo;
+      Traverse(queryNode, referenceNode.Child(children[i].child));
     }
   }
   else
@@ -115,39 +113,49 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
     // We have to recurse down both the query and reference nodes.  Query order
     // does not matter, so we will do that in sequence.  However we will
     // allocate the arrays for recursion at this level.
-    arma::vec scores(referenceNode.NumChildren());
-    std::vector<typename RuleType::TraversalInfoType>
-        tis(referenceNode.NumChildren());
+    ScratchVector<ChildAndScore> buffer(scratch, referenceNode.NumChildren());
+    std::vector<ChildAndScore>& children = buffer.Vector();
     for (size_t j = 0; j < queryNode.NumChildren(); ++j)
     {
       // Now we have to recurse down the reference node, which we will do in a
       // prioritized manner.
-      for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
-      {
-        rule.TraversalInfo() = traversalInfo;
-        scores[i] = rule.Score(queryNode.Child(j), referenceNode.Child(i));
-        tis[i] = rule.TraversalInfo();
-      }
+      ScoreChildren(queryNode.Child(j), referenceNode, children);
 
-      // Sort the scores.
-      arma::uvec scoreOrder = arma::sort_index(scores);
-      for (size_t i = 0; i < scoreOrder.n_elem; ++i)
+      for (size_t i = 0; i < children.size(); ++i)
       {
-        if (scores[scoreOrder[i]] == DBL_MAX)
+        if (children[i].score == DBL_MAX)
         {
           // We don't need to check any more
           // All children past here are pruned.
-          numPrunes += scoreOrder.n_elem - i;
+          numPrunes += children.size() - i;
           break;
         }
 
-        rule.TraversalInfo() = tis[scoreOrder[i]];
-        Traverse(queryNode.Child(j), referenceNode.Child(scoreOrder[i]));
+        rule.TraversalInfo() = children[i].travInfo;
+        Traverse(queryNode.Child(j), referenceNode.Child(children[i].child));
       }
     }
   }
 }
 
+template<typename MetricType, typename StatisticType, typename MatType>
+template<typename RuleType>
+void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
+    ScoreChildren(Octree& queryNode,
+                  Octree& referenceNode,
+                  std::vector<ChildAndScore>& children)
+{
+  for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
+  {
+    rule.TraversalInfo() = traversalInfo;
+    children[i].child = i;
+    children[i].score = rule.Score(queryNode, referenceNode.Child(i));
+    children[i].travInfo = rule.TraversalInfo();
+  }
+
+  std::sort(children.begin(), children.end(), ChildComparator);
+}
+
 } // namespace tree
 } // namespace mlpack
 
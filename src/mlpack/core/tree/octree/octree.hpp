@@ -19,6 +19,22 @@
 namespace mlpack {
 namespace tree {
 
+/**
+ * The largest dimensionality for which the octree is built from Morton codes.
+ * Each point is given a key that interleaves the bits of its quantized
+ * coordinates, the points are sorted by key once, and each node takes the key
+ * range that shares its prefix; that avoids one pass over the points of every
+ * node for each dimension.  In higher dimensions, the node would have too many
+ * children for the keys to be useful.
+ */
+const size_t maxMortonDimension = 3;
+
+/**
+ * The number of bits each coordinate is quantized to in a Morton code.  Points
+ * in the same cell at this resolution end up in the same leaf.
+ */
+const size_t mortonBits = 21;
+
 template<typename MetricType = metric::EuclideanDistance,
          typename StatisticType = EmptyStatistic,
          typename MatType = arma::mat>
@@ -425,6 +441,66 @@ class Octree
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Construct this node as a child of the given parent from the Morton codes of
+   * the points, which must already be sorted (see MortonSplit()).
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of the first point of the node.
+   * @param count Number of points of the node.
+   * @param keys Morton codes of all the points of the dataset.
+   * @param level Depth of this node; its points share the first level groups
+   *      of bits of their keys.
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(Octree* parent,
+         const size_t begin,
+         const size_t count,
+         const std::vector<uint64_t>& keys,
+         const size_t level,
+         const size_t maxLeafSize);
+
+  /**
+   * Split the root.  In at most maxMortonDimension dimensions, the dense
+   * dataset is sorted by Morton code and the tree is built from the keys;
+   * otherwise SplitNode() is used.
+   *
+   * @param width Width of the root in its widest dimension.
+   * @param oldFromNew Mappings from old to new, or NULL.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void SplitRoot(const double width,
+                 std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize);
+
+  /**
+   * Split the node into the key ranges of its children.  The keys of the
+   * points of the node must be sorted.
+   *
+   * @param keys Morton codes of all the points of the dataset.
+   * @param level Depth of this node.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void MortonSplit(const std::vector<uint64_t>& keys,
+                   const size_t level,
+                   const size_t maxLeafSize);
+
+  /**
+   * Spread the low mortonBits bits of the given value so that there are dim - 1
+   * zero bits between each of them.
+   */
+  static uint64_t SpreadBits(uint64_t x, const size_t dim);
+
+  /**
+   * Compute the bound of the points of the node.  In two and three dimensions,
+   * the loop over the dimensions is unrolled.
+   */
+  void ComputeBound();
+
+  //! Compute the bound of the points of the node, in Dim dimensions.
+  template<size_t Dim>
+  void ComputeBound();
+
   /**
    * This is used for sorting points while splitting.
    */
@@ -32,17 +32,15 @@ Octree<MetricType, StatisticType, MatType>::Octree(const MatType& dataset,
 {
   if (count > 0)
   {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
+    // Calculate the bound of the data.
+    ComputeBound();
 
     double maxWidth = 0.0;
     for (size_t i = 0; i < bound.Dim(); ++i)
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, maxLeafSize);
+    SplitRoot(maxWidth, NULL, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -74,17 +72,15 @@ Octree<MetricType, StatisticType, MatType>::Octree(
 
   if (count > 0)
   {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
+    // Calculate the bound of the data.
+    ComputeBound();
 
     double maxWidth = 0.0;
     for (size_t i = 0; i < bound.Dim(); ++i)
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    SplitRoot(maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -117,17 +113,15 @@ Octree<MetricType, StatisticType, MatType>::Octree(
 
   if (count > 0)
   {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
+    // Calculate the bound of the data.
+    ComputeBound();
 
     double maxWidth = 0.0;
     for (size_t i = 0; i < bound.Dim(); ++i)
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    SplitRoot(maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -158,17 +152,15 @@ Octree<MetricType, StatisticType, MatType>::Octree(MatType&& dataset,
 {
   if (count > 0)
   {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
+    // Calculate the bound of the data.
+    ComputeBound();
 
     double maxWidth = 0.0;
     for (size_t i = 0; i < bound.Dim(); ++i)
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, maxLeafSize);
+    SplitRoot(maxWidth, NULL, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -200,17 +192,15 @@ Octree<MetricType, StatisticType, MatType>::Octree(
 
   if (count > 0)
   {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
+    // Calculate the bound of the data.
+    ComputeBound();
 
     double maxWidth = 0.0;
     for (size_t i = 0; i < bound.Dim(); ++i)
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    SplitRoot(maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -243,17 +233,15 @@ Octree<MetricType, StatisticType, MatType>::Octree(
 
   if (count > 0)
   {
-    // Calculate empirical center of data.
-    bound |= *this->dataset;
-    arma::vec center;
-    bound.Center(center);
+    // Calculate the bound of the data.
+    ComputeBound();
 
     double maxWidth = 0.0;
     for (size_t i = 0; i < bound.Dim(); ++i)
       if (bound[i].Hi() - bound[i].Lo() > maxWidth)
         maxWidth = bound[i].Hi() - bound[i].Lo();
 
-    SplitNode(center, maxWidth, oldFromNew, maxLeafSize);
+    SplitRoot(maxWidth, &oldFromNew, maxLeafSize);
 
     furthestDescendantDistance = 0.5 * bound.Diameter();
   }
@@ -286,8 +274,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     dataset(parent->dataset),
     parent(parent)
 {
-  // Calculate empirical center of data.
-  bound |= dataset->cols(begin, begin + count - 1);
+  // Calculate the bound of the points.
+  ComputeBound();
 
   // Now split the node.
   SplitNode(center, width, maxLeafSize);
@@ -321,8 +309,8 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     dataset(parent->dataset),
     parent(parent)
 {
-  // Calculate empirical center of data.
-  bound |= dataset->cols(begin, begin + count - 1);
+  // Calculate the bound of the points.
+  ComputeBound();
 
   // Now split the node.
   SplitNode(center, width, oldFromNew, maxLeafSize);
@@ -340,6 +328,40 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   stat = StatisticType(*this);
 }
 
+//! Construct a child node from the Morton codes of the points.
+template<typename MetricType, typename StatisticType, typename MatType>
+Octree<MetricType, StatisticType, MatType>::Octree(
+    Octree* parent,
+    const size_t begin,
+    const size_t count,
+    const std::vector<uint64_t>& keys,
+    const size_t level,
+    const size_t maxLeafSize) :
+    begin(begin),
+    count(count),
+    bound(parent->dataset->n_rows),
+    dataset(parent->dataset),
+    parent(parent)
+{
+  // Calculate the bound of the points.
+  ComputeBound();
+
+  // Now split the node.
+  MortonSplit(keys, level, maxLeafSize);
+
+  // Calculate the distance from the empirical center of this node to the
+  // empirical center of the parent.
+  arma::vec trueCenter, parentCenter;
+  bound.Center(trueCenter);
+  parent->Bound().Center(parentCenter);
+  parentDistance = metric.Evaluate(trueCenter, parentCenter);
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
 //! Copy the given tree.
 template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(const Octree& other) :
@@ -740,16 +762,24 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     }
   }
 
-  // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
+  // Now that the dataset is reordered, we can create the children.  If the
+  // child has no points, don't create it.
+  std::vector<size_t> childIndices;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+    if (childBegins[i + 1] - childBegins[i] > 0)
+      childIndices.push_back(i);
+
+  // The children hold disjoint ranges of points, so the children of the root
+  // are built in parallel.
+  children.resize(childIndices.size());
+  const double childWidth = width / 2.0;
+  #pragma omp parallel for schedule(dynamic) if(!parent)
+  for (omp_size_t c = 0; c < (omp_size_t) childIndices.size(); ++c)
   {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
+    const size_t i = childIndices[c];
 
     // Create the correct center.
+    arma::vec childCenter(center.n_elem);
     for (size_t d = 0; d < center.n_elem; ++d)
     {
       // Is the dimension "right" (1) or "left" (0)?
@@ -759,9 +789,9 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
         childCenter[d] = center[d] + childWidth;
     }
 
-    children.push_back(new Octree(this, childBegins[i],
+    children[c] = new Octree(this, childBegins[i],
         childBegins[i + 1] - childBegins[i], childCenter, childWidth,
-        maxLeafSize));
+        maxLeafSize);
   }
 }
 
@@ -842,16 +872,24 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
     }
   }
 
-  // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
+  // Now that the dataset is reordered, we can create the children.  If the
+  // child has no points, don't create it.
+  std::vector<size_t> childIndices;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
+    if (childBegins[i + 1] - childBegins[i] > 0)
+      childIndices.push_back(i);
+
+  // The children hold disjoint ranges of points, so the children of the root
+  // are built in parallel.
+  children.resize(childIndices.size());
+  const double childWidth = width / 2.0;
+  #pragma omp parallel for schedule(dynamic) if(!parent)
+  for (omp_size_t c = 0; c < (omp_size_t) childIndices.size(); ++c)
   {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
+    const size_t i = childIndices[c];
 
     // Create the correct center.
+    arma::vec childCenter(center.n_elem);
     for (size_t d = 0; d < center.n_elem; ++d)
     {
       // Is the dimension "right" (1) or "left" (0)?
@@ -861,9 +899,191 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
         childCenter[d] = center[d] + childWidth;
     }
 
-    children.push_back(new Octree(this, childBegins[i],
+    children[c] = new Octree(this, childBegins[i],
         childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
-        childWidth, maxLeafSize));
+        childWidth, maxLeafSize);
+  }
+}
+
+//! Split the root, with Morton codes if the data is low-dimensional.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::SplitRoot(
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  if (count <= maxLeafSize)
+    return;
+
+  const size_t dim = dataset->n_rows;
+  if (dim > maxMortonDimension || arma::is_SpMat<MatType>::value)
+  {
+    arma::vec center;
+    bound.Center(center);
+    if (oldFromNew)
+      SplitNode(center, width, *oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, width, maxLeafSize);
+    return;
+  }
+
+  // Quantize each coordinate to mortonBits bits within the cube that holds the
+  // root, and interleave the bits of the dimensions.  The highest group of dim
+  // bits of a key is then the index of the child of the root that holds the
+  // point, the next group the index of the grandchild, and so on.
+  const uint64_t maxCell = ((uint64_t) 1 << mortonBits) - 1;
+  const double scale = (width > 0.0) ? (maxCell + 1) / width : 0.0;
+  std::vector<std::pair<uint64_t, size_t>> order(count);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
+  {
+    uint64_t key = 0;
+    for (size_t d = 0; d < dim; ++d)
+    {
+      const double offset = ((*dataset)(d, i) - bound[d].Lo()) * scale;
+      const uint64_t cell = std::min((uint64_t) std::max(offset, 0.0),
+          maxCell);
+      key |= SpreadBits(cell, dim) << d;
+    }
+
+    order[i] = std::make_pair(key, (size_t) i);
+  }
+
+  // Sort the points by key once; each node then holds a range of keys.
+  std::sort(order.begin(), order.end());
+
+  MatType sortedDataset(dim, count);
+  std::vector<uint64_t> keys(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    sortedDataset.col(i) = dataset->col(order[i].second);
+    keys[i] = order[i].first;
+  }
+  *dataset = std::move(sortedDataset);
+
+  if (oldFromNew)
+  {
+    const std::vector<size_t> oldMappings(*oldFromNew);
+    for (size_t i = 0; i < count; ++i)
+      (*oldFromNew)[i] = oldMappings[order[i].second];
+  }
+
+  MortonSplit(keys, 0, maxLeafSize);
+}
+
+//! Split the node into the key ranges of its children.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::MortonSplit(
+    const std::vector<uint64_t>& keys,
+    const size_t level,
+    const size_t maxLeafSize)
+{
+  // No need to split if we have fewer than the maximum number of points in this
+  // node, or if all the points are in the same cell at the finest resolution.
+  if (count <= maxLeafSize || level == mortonBits ||
+      keys[begin] == keys[begin + count - 1])
+    return;
+
+  // The keys of the points of the node share all the bits above the group of
+  // this level, so the group is sorted too, and the first point of each child
+  // is found with a binary search.
+  const size_t dim = dataset->n_rows;
+  const size_t shift = (mortonBits - 1 - level) * dim;
+  const uint64_t prefix = (keys[begin] >> (shift + dim)) << (shift + dim);
+  const size_t numChildren = ((size_t) 1 << dim);
+
+  std::vector<size_t> childBegins(numChildren + 1);
+  childBegins[0] = begin;
+  childBegins[numChildren] = begin + count;
+  for (size_t i = 1; i < numChildren; ++i)
+  {
+    childBegins[i] = std::lower_bound(keys.begin() + childBegins[i - 1],
+        keys.begin() + begin + count, prefix | ((uint64_t) i << shift)) -
+        keys.begin();
+  }
+
+  // If the child has no points, don't create it.
+  std::vector<size_t> childIndices;
+  for (size_t i = 0; i < numChildren; ++i)
+    if (childBegins[i + 1] - childBegins[i] > 0)
+      childIndices.push_back(i);
+
+  // The children hold disjoint ranges of points, so the children of the root
+  // are built in parallel.
+  children.resize(childIndices.size());
+  #pragma omp parallel for schedule(dynamic) if(!parent)
+  for (omp_size_t c = 0; c < (omp_size_t) childIndices.size(); ++c)
+  {
+    const size_t i = childIndices[c];
+    children[c] = new Octree(this, childBegins[i],
+        childBegins[i + 1] - childBegins[i], keys, level + 1, maxLeafSize);
+  }
+}
+
+//! Spread the bits of a coordinate for a Morton code.
+template<typename MetricType, typename StatisticType, typename MatType>
+uint64_t Octree<MetricType, StatisticType, MatType>::SpreadBits(
+    uint64_t x,
+    const size_t dim)
+{
+  x &= ((uint64_t) 1 << mortonBits) - 1;
+  if (dim == 2)
+  {
+    x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ffULL;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+  }
+  else if (dim == 3)
+  {
+    x = (x | (x << 32)) & 0x001f00000000ffffULL;
+    x = (x | (x << 16)) & 0x001f0000ff0000ffULL;
+    x = (x | (x << 8)) & 0x100f00f00f00f00fULL;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3ULL;
+    x = (x | (x << 2)) & 0x1249249249249249ULL;
+  }
+
+  return x;
+}
+
+//! Compute the bound of the points of the node.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::ComputeBound()
+{
+  if (arma::is_SpMat<MatType>::value || dataset->n_rows < 2 ||
+      dataset->n_rows > 3)
+    bound |= dataset->cols(begin, begin + count - 1);
+  else if (dataset->n_rows == 2)
+    ComputeBound<2>();
+  else
+    ComputeBound<3>();
+}
+
+//! Compute the bound of the points of the node, in Dim dimensions.
+template<typename MetricType, typename StatisticType, typename MatType>
+template<size_t Dim>
+void Octree<MetricType, StatisticType, MatType>::ComputeBound()
+{
+  ElemType lo[Dim], hi[Dim];
+  for (size_t d = 0; d < Dim; ++d)
+    lo[d] = hi[d] = (*dataset)(d, begin);
+
+  for (size_t i = begin + 1; i < begin + count; ++i)
+  {
+    for (size_t d = 0; d < Dim; ++d)
+    {
+      const ElemType x = (*dataset)(d, i);
+      lo[d] = std::min(lo[d], x);
+      hi[d] = std::max(hi[d], x);
+    }
+  }
+
+  bound.MinWidth() = std::numeric_limits<double>::max();
+  for (size_t d = 0; d < Dim; ++d)
+  {
+    bound[d] |= math::Range(lo[d], hi[d]);
+    bound.MinWidth() = std::min(bound.MinWidth(), bound[d].Width());
   }
 }
 
@@ -0,0 +1,143 @@
+/**
+ * @file parallel_dual_tree_traverser.hpp
+ *
+ * A dual-tree traverser that splits the query tree into independent subtrees
+ * and traverses them in parallel with the default dual-tree traverser of the
+ * tree type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "shared_results.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The ParallelDualTreeTraverser cuts the query tree into disjoint subtrees
+ * (splitting the largest subtree until there are enough of them to keep every
+ * thread busy), and then traverses every query subtree against the whole
+ * reference tree with the dual-tree traverser of the tree type
+ * (TreeType::DualTreeTraverser).  The subtrees are handed out to the threads
+ * dynamically, largest first, so threads that finish early take over the
+ * remaining work.
+ *
+ * Every query subtree is traversed with its own copy of the rules, made with
+ * SharedCopy().  This requires that
+ *
+ *  - these copies of the RuleType object share the per-query-point results with
+ *    the object they are copied from, but not the traversal state (traversal
+ *    info, cached base cases and counters); rules that own their results do
+ *    this in a constructor taking a SharedResults tag; and
+ *  - the rules only modify the results of the query points and the statistics
+ *    of the query nodes that are visited (so no two threads write the same
+ *    data, as the query subtrees of the threads are disjoint).
+ *
+ * NeighborSearchRules satisfies both.  The query tree must not have
+ * overlapping nodes (e.g. a spill tree with tau > 0).
+ *
+ * The class can be used in the DualTreeTraversalType template slot of
+ * NeighborSearch.  Without OpenMP the subtrees are traversed one after
+ * another.
+ *
+ * @tparam RuleType Type of the rules of the traversal.
+ */
+template<typename RuleType>
+class ParallelDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the parallel dual-tree traverser with the given rule set.
+   *
+   * @param rule The rules of the traversal.
+   * @param tasksPerThread The number of query subtrees to create per thread;
+   *     more subtrees balance the load better, but each subtree restarts the
+   *     traversal at the reference root.
+   */
+  ParallelDualTreeTraverser(RuleType& rule, const size_t tasksPerThread = 8);
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  template<typename TreeType>
+  void Traverse(TreeType& queryNode, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+  //! Get the number of query subtrees per thread.
+  size_t TasksPerThread() const { return tasksPerThread; }
+  //! Modify the number of query subtrees per thread.
+  size_t& TasksPerThread() { return tasksPerThread; }
+
+  /**
+   * Split the given query tree into at least the given number of disjoint
+   * subtrees (if it has enough nodes), sorted by decreasing size.  This is
+   * also useful for algorithms that traverse the subtrees themselves.
+   *
+   * @param queryNode The root of the query tree.
+   * @param numTasks The number of subtrees to create.
+   * @param tasks The roots of the query subtrees.
+   */
+  template<typename TreeType>
+  static void QueryTasks(TreeType& queryNode,
+                         const size_t numTasks,
+                         std::vector<TreeType*>& tasks);
+
+ private:
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The number of query subtrees per thread.
+  size_t tasksPerThread;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traverser_impl.hpp"
+
+#endif
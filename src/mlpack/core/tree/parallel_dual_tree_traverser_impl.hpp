@@ -0,0 +1,121 @@
+/**
+ * @file parallel_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelDualTreeTraverser, which traverses disjoint
+ * query subtrees in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename RuleType>
+ParallelDualTreeTraverser<RuleType>::ParallelDualTreeTraverser(
+    RuleType& rule,
+    const size_t tasksPerThread) :
+    rule(rule),
+    tasksPerThread(tasksPerThread),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{ /* Nothing to do. */ }
+
+template<typename RuleType>
+template<typename TreeType>
+void ParallelDualTreeTraverser<RuleType>::Traverse(TreeType& queryNode,
+                                                    TreeType& referenceNode)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  std::vector<TreeType*> tasks;
+  QueryTasks(queryNode, std::max(tasksPerThread, (size_t) 1) * numThreads,
+      tasks);
+
+  // The counters of the rules before the traversal; every copy starts with
+  // them.
+  const size_t ruleBaseCases = rule.BaseCases();
+  const size_t ruleScores = rule.Scores();
+
+  size_t prunes = 0, visited = 0, scores = 0, baseCases = 0;
+  size_t taskRuleBaseCases = 0, taskRuleScores = 0;
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:prunes, visited, \
+      scores, baseCases, taskRuleBaseCases, taskRuleScores)
+  for (omp_size_t i = 0; i < (omp_size_t) tasks.size(); ++i)
+  {
+    std::unique_ptr<RuleType> taskRule = SharedCopy(rule);
+    typename TreeType::template DualTreeTraverser<RuleType> traverser(
+        *taskRule);
+    traverser.Traverse(*tasks[i], referenceNode);
+
+    prunes += traverser.NumPrunes();
+    visited += traverser.NumVisited();
+    scores += traverser.NumScores();
+    baseCases += traverser.NumBaseCases();
+    taskRuleBaseCases += taskRule->BaseCases() - ruleBaseCases;
+    taskRuleScores += taskRule->Scores() - ruleScores;
+  }
+
+  numPrunes += prunes;
+  numVisited += visited;
+  numScores += scores;
+  numBaseCases += baseCases;
+  rule.BaseCases() += taskRuleBaseCases;
+  rule.Scores() += taskRuleScores;
+}
+
+template<typename RuleType>
+template<typename TreeType>
+void ParallelDualTreeTraverser<RuleType>::QueryTasks(
+    TreeType& queryNode,
+    const size_t numTasks,
+    std::vector<TreeType*>& tasks)
+{
+  tasks.clear();
+  tasks.push_back(&queryNode);
+
+  while (tasks.size() < numTasks)
+  {
+    // Split the largest subtree.
+    size_t largest = 0;
+    for (size_t i = 1; i < tasks.size(); ++i)
+    {
+      if (tasks[i]->NumDescendants() > tasks[largest]->NumDescendants())
+        largest = i;
+    }
+
+    // Only leaves are left.
+    if (tasks[largest]->NumChildren() == 0)
+      break;
+
+    TreeType* node = tasks[largest];
+    tasks[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      tasks.push_back(&node->Child(i));
+  }
+
+  // Hand out the largest subtrees first.
+  std::stable_sort(tasks.begin(), tasks.end(),
+      [](const TreeType* a, const TreeType* b)
+      {
+        return a->NumDescendants() > b->NumDescendants();
+      });
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
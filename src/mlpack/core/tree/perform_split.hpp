@@ -16,10 +16,50 @@
 #ifndef MLPACK_CORE_TREE_PERFORM_SPLIT_HPP
 #define MLPACK_CORE_TREE_PERFORM_SPLIT_HPP
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 namespace split {
 
+#ifdef HAS_OPENMP
+
+/**
+ * The minimum number of points each thread partitions in ParallelPerformSplit.
+ * Smaller nodes are split serially.
+ */
+const size_t minimumParallelSplitSize = 4096;
+
+/**
+ * Rearrange points according to the split information using several threads.
+ * Each thread partitions a block of the node, and afterwards the points that
+ * lie on the wrong side of the split column are swapped in parallel.  This is
+ * only used for large nodes when no parallel region is active (i.e. for the
+ * top levels of the tree); the result is the same partition as the serial
+ * PerformSplit() produces, although the order of the points in each side may
+ * differ.
+ *
+ * @param data The dataset used by the tree.
+ * @param begin Index of the starting point in the dataset that belongs to
+ *    this node.
+ * @param count Number of points in this node.
+ * @param splitInfo The information about the split.
+ * @param oldFromNew Vector which will be filled with the old positions for
+ *    each new point, or NULL if the indices are not tracked.
+ * @param numBlocks Number of blocks to split in parallel.
+ */
+template<typename MatType, typename SplitType>
+size_t ParallelPerformSplit(MatType& data,
+                            const size_t begin,
+                            const size_t count,
+                            const typename SplitType::SplitInfo& splitInfo,
+                            std::vector<size_t>* oldFromNew,
+                            const size_t numBlocks);
+
+#endif
+
 /**
  * This function implements the default split behavior i.e. it rearranges
  * points according to the split information. The SplitType::AssignToLeftNode()
@@ -38,6 +78,18 @@ size_t PerformSplit(MatType& data,
                     const size_t count,
                     const typename SplitType::SplitInfo& splitInfo)
 {
+#ifdef HAS_OPENMP
+  // Large nodes are partitioned by all threads, unless we are already inside a
+  // parallel region.
+  const size_t numBlocks = std::min((size_t) omp_get_max_threads(),
+      count / minimumParallelSplitSize);
+  if (numBlocks > 1 && !omp_in_parallel())
+  {
+    return ParallelPerformSplit<MatType, SplitType>(data, begin, count,
+        splitInfo, NULL, numBlocks);
+  }
+#endif
+
   // This method modifies the input dataset.  We loop both from the left and
   // right sides of the points contained in this node.
   size_t left = begin;
@@ -104,6 +156,18 @@ size_t PerformSplit(MatType& data,
                     const typename SplitType::SplitInfo& splitInfo,
                     std::vector<size_t>& oldFromNew)
 {
+#ifdef HAS_OPENMP
+  // Large nodes are partitioned by all threads, unless we are already inside a
+  // parallel region.
+  const size_t numBlocks = std::min((size_t) omp_get_max_threads(),
+      count / minimumParallelSplitSize);
+  if (numBlocks > 1 && !omp_in_parallel())
+  {
+    return ParallelPerformSplit<MatType, SplitType>(data, begin, count,
+        splitInfo, &oldFromNew, numBlocks);
+  }
+#endif
+
   // This method modifies the input dataset.  We loop both from the left and
   // right sides of the points contained in this node.
   size_t left = begin;
@@ -152,6 +216,73 @@ size_t PerformSplit(MatType& data,
   return left;
 }
 
+#ifdef HAS_OPENMP
+
+template<typename MatType, typename SplitType>
+size_t ParallelPerformSplit(MatType& data,
+                            const size_t begin,
+                            const size_t count,
+                            const typename SplitType::SplitInfo& splitInfo,
+                            std::vector<size_t>* oldFromNew,
+                            const size_t numBlocks)
+{
+  // First, every thread partitions its own block of the node.  Since we are
+  // then inside a parallel region, the calls below are serial.
+  std::vector<size_t> blockBegins(numBlocks + 1);
+  for (size_t b = 0; b <= numBlocks; ++b)
+    blockBegins[b] = begin + (count * b) / numBlocks;
+
+  std::vector<size_t> blockSplits(numBlocks);
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t blockBegin = blockBegins[b];
+    const size_t blockCount = blockBegins[b + 1] - blockBegin;
+    if (oldFromNew)
+    {
+      blockSplits[b] = PerformSplit<MatType, SplitType>(data, blockBegin,
+          blockCount, splitInfo, *oldFromNew);
+    }
+    else
+    {
+      blockSplits[b] = PerformSplit<MatType, SplitType>(data, blockBegin,
+          blockCount, splitInfo);
+    }
+  }
+
+  // Now find the final split column.
+  size_t splitCol = begin;
+  for (size_t b = 0; b < numBlocks; ++b)
+    splitCol += blockSplits[b] - blockBegins[b];
+
+  // Collect the right points that lie left of the split column and the left
+  // points that lie right of it.  There is the same number of each.
+  std::vector<size_t> wrongRight, wrongLeft;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    for (size_t i = blockSplits[b]; i < std::min(blockBegins[b + 1], splitCol);
+         ++i)
+      wrongRight.push_back(i);
+    for (size_t i = std::max(blockBegins[b], splitCol); i < blockSplits[b];
+         ++i)
+      wrongLeft.push_back(i);
+  }
+
+  Log::Assert(wrongRight.size() == wrongLeft.size());
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) wrongRight.size(); ++i)
+  {
+    data.swap_cols(wrongRight[i], wrongLeft[i]);
+    if (oldFromNew)
+      std::swap((*oldFromNew)[wrongRight[i]], (*oldFromNew)[wrongLeft[i]]);
+  }
+
+  return splitCol;
+}
+
+#endif
+
 } // namespace split
 } // namespace tree
 } // namespace mlpack
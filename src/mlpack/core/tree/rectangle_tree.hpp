@@ -41,6 +41,8 @@
 #include "rectangle_tree/r_plus_plus_tree_auxiliary_information.hpp"
 #include "rectangle_tree/r_plus_plus_tree_descent_heuristic.hpp"
 #include "rectangle_tree/r_plus_plus_tree_split_policy.hpp"
+#include "rectangle_tree/str_packing.hpp"
+#include "rectangle_tree/hilbert_packing.hpp"
 #include "rectangle_tree/traits.hpp"
 #include "rectangle_tree/typedef.hpp"
 
@@ -0,0 +1,108 @@
+/**
+ * @file bulk_load_utils.hpp
+ *
+ * Utilities for bulk loading RectangleTrees: a trait that identifies the
+ * packing policies, and a parallel sort of the point order.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_UTILS_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_UTILS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * IsPackingPolicy<T>::value is true if T is a packing policy that can be given
+ * to the bulk loading constructor of RectangleTree.  A packing policy must
+ * provide:
+ *
+ * @code
+ * // Reorder the indices of all the points before the tree is built.
+ * template<typename MatType>
+ * static void Order(const MatType& data, std::vector<size_t>& points);
+ *
+ * // Reorder points[begin, begin + count) so that each of the numGroups
+ * // groups, group g starting at begin + count * g / numGroups, holds nearby
+ * // points.
+ * template<typename MatType>
+ * static void Tile(const MatType& data,
+ *                  std::vector<size_t>& points,
+ *                  const size_t begin,
+ *                  const size_t count,
+ *                  const size_t numGroups);
+ * @endcode
+ */
+template<typename T>
+struct IsPackingPolicy
+{
+  static const bool value = false;
+};
+
+/**
+ * Sort elements [begin, end) of the given vector.  Unless this is called in a
+ * parallel region, the range is split into one chunk per thread, the chunks are
+ * sorted in parallel, and then neighbouring chunks are merged in parallel until
+ * one is left.
+ *
+ * @param values Vector to sort.
+ * @param begin First element to sort.
+ * @param end One past the last element to sort.
+ * @param compare Strict weak ordering of the elements.
+ */
+template<typename T, typename CompareType>
+void ParallelSort(std::vector<T>& values,
+                  const size_t begin,
+                  const size_t end,
+                  CompareType compare)
+{
+  size_t numChunks = 1;
+  #ifdef HAS_OPENMP
+    if (!omp_in_parallel())
+      numChunks = omp_get_max_threads();
+  #endif
+
+  // Small ranges are not worth the threads.
+  const size_t count = end - begin;
+  if (numChunks == 1 || count < 1024 * numChunks)
+  {
+    std::sort(values.begin() + begin, values.begin() + end, compare);
+    return;
+  }
+
+  std::vector<size_t> bounds(numChunks + 1);
+  for (size_t c = 0; c <= numChunks; ++c)
+    bounds[c] = begin + count * c / numChunks;
+
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    std::sort(values.begin() + bounds[c], values.begin() + bounds[c + 1],
+        compare);
+  }
+
+  for (size_t width = 1; width < numChunks; width *= 2)
+  {
+    #pragma omp parallel for
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; c += 2 * width)
+    {
+      if ((size_t) c + width < numChunks)
+      {
+        const size_t last = std::min((size_t) c + 2 * width, numChunks);
+        std::inplace_merge(values.begin() + bounds[c],
+            values.begin() + bounds[c + width], values.begin() + bounds[last],
+            compare);
+      }
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
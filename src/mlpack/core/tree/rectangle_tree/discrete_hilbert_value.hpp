@@ -211,6 +211,17 @@ class DiscreteHilbertValue
                                  const size_t firstSibling,
                                  const size_t lastSibling);
 
+  /**
+   * Set up the Hilbert values of a node of a bulk-loaded tree.  The node shares
+   * the value to insert of the root.  The points of a leaf are sorted by their
+   * Hilbert values, which the leaf stores; a non-leaf node takes the values of
+   * its last child, so its children must already be set up and sorted.
+   *
+   * @param node The node in which the information should be set up.
+   */
+  template<typename TreeType>
+  void BulkLoadNode(TreeType* node);
+
   /**
    * Calculate the Hilbert value of the point pt.
    *
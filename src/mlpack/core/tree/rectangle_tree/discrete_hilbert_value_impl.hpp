@@ -464,6 +464,69 @@ void DiscreteHilbertValue<TreeElemType>::UpdateLargestValue(TreeType* node)
   }
 }
 
+template<typename TreeElemType>
+template<typename TreeType>
+void DiscreteHilbertValue<TreeElemType>::BulkLoadNode(TreeType* node)
+{
+  if (node->Parent())
+  {
+    // Only the root owns the value to insert.
+    const TreeType* root = node->Parent();
+    while (root->Parent())
+      root = root->Parent();
+
+    if (ownsValueToInsert)
+      delete valueToInsert;
+    valueToInsert = const_cast<arma::Col<HilbertElemType>*>
+        (root->AuxiliaryInfo().HilbertValue().ValueToInsert());
+    ownsValueToInsert = false;
+  }
+
+  if (!node->IsLeaf())
+  {
+    // Intermediate nodes store the pointer to the dataset of their last leaf.
+    if (ownsLocalHilbertValues)
+      delete localHilbertValues;
+    ownsLocalHilbertValues = false;
+    UpdateLargestValue(node);
+    return;
+  }
+
+  if (!ownsLocalHilbertValues)
+  {
+    localHilbertValues = new arma::Mat<HilbertElemType>(
+        node->Dataset().n_rows, node->MaxLeafSize() + 1);
+    ownsLocalHilbertValues = true;
+  }
+
+  // Sort the points by their Hilbert values.
+  const size_t numPoints = node->NumPoints();
+  arma::Mat<HilbertElemType> values(node->Dataset().n_rows, numPoints);
+  std::vector<size_t> order(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    values.col(i) = CalculateValue(node->Dataset().col(node->Point(i)));
+    order[i] = i;
+  }
+
+  std::stable_sort(order.begin(), order.end(),
+      [&values](const size_t a, const size_t b)
+      {
+        return CompareValues(values.unsafe_col(a), values.unsafe_col(b)) < 0;
+      });
+
+  std::vector<size_t> points(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    points[i] = node->Point(i);
+
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    node->Point(i) = points[order[i]];
+    localHilbertValues->col(i) = values.col(order[i]);
+  }
+  numValues = numPoints;
+}
+
 template<typename TreeElemType>
 template<typename TreeType>
 void DiscreteHilbertValue<TreeElemType>::RedistributeHilbertValues(
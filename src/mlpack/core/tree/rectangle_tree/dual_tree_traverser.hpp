@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "rectangle_tree.hpp"
+#include "../traversal_scratch.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -100,6 +101,10 @@ class RectangleTree<MetricType, StatisticType, MatType, SplitType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! The scored children of each level of the recursion, reused for every
+  //! node.
+  TraversalScratch<NodeAndScore> scratch;
 };
 
 } // namespace tree
@@ -104,7 +104,8 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
     // here.
 
     // We sort the children of the reference node by their scores.
-    std::vector<NodeAndScore> nodesAndScores(referenceNode.NumChildren());
+    ScratchVector<NodeAndScore> buffer(scratch, referenceNode.NumChildren());
+    std::vector<NodeAndScore>& nodesAndScores = buffer.Vector();
     for (size_t i = 0; i < referenceNode.NumChildren(); i++)
     {
       rule.TraversalInfo() = traversalInfo;
@@ -136,10 +137,11 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
     // We need to traverse down both the reference and the query trees.
     // We loop through all of the query nodes, and for each of them, we
     // loop through the reference nodes to see where we need to descend.
+    ScratchVector<NodeAndScore> buffer(scratch, referenceNode.NumChildren());
+    std::vector<NodeAndScore>& nodesAndScores = buffer.Vector();
     for (size_t j = 0; j < queryNode.NumChildren(); j++)
     {
       // We sort the children of the reference node by their scores.
-      std::vector<NodeAndScore> nodesAndScores(referenceNode.NumChildren());
       for (size_t i = 0; i < referenceNode.NumChildren(); i++)
       {
         rule.TraversalInfo() = traversalInfo;
@@ -0,0 +1,93 @@
+/**
+ * @file hilbert_packing.hpp
+ *
+ * Definition of HilbertPacking, a packing policy for the bulk loading of
+ * RectangleTrees along the Hilbert curve.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_PACKING_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_PACKING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "bulk_load_utils.hpp"
+#include "discrete_hilbert_value.hpp"
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * The Hilbert packing policy.  The points are sorted once by their discrete
+ * Hilbert values, and each node then takes a contiguous run of that order, so
+ * the points of each group are consecutive on the Hilbert curve.  This is the
+ * natural packing for the Hilbert R tree, whose insertions follow the same
+ * order.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{kamel1993hilbert,
+ *   title={On packing R-trees},
+ *   author={Kamel, I. and Faloutsos, C.},
+ *   booktitle={Proceedings of the Second International Conference on
+ *       Information and Knowledge Management},
+ *   pages={490--499},
+ *   year={1993}
+ * }
+ * @endcode
+ */
+class HilbertPacking
+{
+ public:
+  /**
+   * Sort the points by their Hilbert values.  The values are computed in
+   * parallel, and then sorted with ParallelSort().
+   *
+   * @param data Dataset of the tree.
+   * @param points Indices of the points of the tree.
+   */
+  template<typename MatType>
+  static void Order(const MatType& data, std::vector<size_t>& points)
+  {
+    typedef DiscreteHilbertValue<typename MatType::elem_type> HilbertValue;
+    typedef typename HilbertValue::HilbertElemType HilbertElemType;
+
+    arma::Mat<HilbertElemType> values(data.n_rows, data.n_cols);
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+      values.col(i) = HilbertValue::CalculateValue(data.col(i));
+
+    ParallelSort(points, 0, points.size(),
+        [&values](const size_t a, const size_t b)
+        {
+          return HilbertValue::CompareValues(values.unsafe_col(a),
+              values.unsafe_col(b)) < 0;
+        });
+  }
+
+  /**
+   * Nothing to do: the order of the points is already along the curve.
+   */
+  template<typename MatType>
+  static void Tile(const MatType& /* data */,
+                   std::vector<size_t>& /* points */,
+                   const size_t /* begin */,
+                   const size_t /* count */,
+                   const size_t /* numGroups */)
+  { }
+};
+
+//! HilbertPacking is a packing policy.
+template<>
+struct IsPackingPolicy<HilbertPacking>
+{
+  static const bool value = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -117,6 +117,16 @@ class HilbertRTreeAuxiliaryInformation
    */
   bool UpdateAuxiliaryInfo(TreeType* node);
 
+  /**
+   * Set up the Hilbert values of the node after the tree is bulk loaded: the
+   * points of a leaf, or the children of a non-leaf node, are sorted by their
+   * Hilbert values.  This is called on each leaf, and then on each non-leaf
+   * node once its children are set up.
+   *
+   * @param node The node in which the auxiliary information is being set up.
+   */
+  void HandleBulkLoad(TreeType* node);
+
   //! Clear memory.
   void NullifyData();
 
@@ -167,6 +167,27 @@ UpdateAuxiliaryInfo(TreeType* node)
   return false;
 }
 
+template<typename TreeType,
+         template<typename> class HilbertValueType>
+void HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>::
+HandleBulkLoad(TreeType* node)
+{
+  if (!node->IsLeaf())
+  {
+    // Sort the children by their largest Hilbert values.
+    std::stable_sort(node->children.begin(),
+        node->children.begin() + node->NumChildren(),
+        [](const TreeType* a, const TreeType* b)
+        {
+          return HilbertValueType<ElemType>::CompareValues(
+              a->AuxiliaryInfo().HilbertValue(),
+              b->AuxiliaryInfo().HilbertValue()) < 0;
+        });
+  }
+
+  hilbertValue.BulkLoadNode(node);
+}
+
 template<typename TreeType,
          template<typename> class HilbertValueType>
 void HilbertRTreeAuxiliaryInformation<TreeType, HilbertValueType>::
@@ -113,6 +113,15 @@ class NoAuxiliaryInformation
     return false;
   }
 
+  /**
+   * Some tree types need to set up their auxiliary information after the tree
+   * is bulk loaded.  This is called on each leaf once its points are set, and
+   * then on each non-leaf node once its children are finished.
+   *
+   * @param node The node in which the auxiliary information is being set up.
+   */
+  void HandleBulkLoad(TreeType* /* node */) { }
+
   /**
    * The R++ tree requires to split the maximum bounding rectangle of a node
    * that is being split. This method is intended for that. This method is only
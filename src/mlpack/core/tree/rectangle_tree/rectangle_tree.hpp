@@ -20,6 +20,7 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "bulk_load_utils.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -156,6 +157,63 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk loading
+   * the given dataset with the given packing policy (STRPacking or
+   * HilbertPacking), instead of inserting the points one by one.  The tree is
+   * built top down: the points of each node are split by the packing policy
+   * into as few groups as fit in the children, with balanced sizes, so all the
+   * leaves are on the same level and every node is at least half full.  The
+   * nodes of each level are built in parallel.  Points can be inserted into and
+   * deleted from the tree afterwards as usual.
+   *
+   * This works for the R tree, the R* tree, the X tree and the Hilbert R tree;
+   * the nodes of R+ and R++ trees may not overlap, which packing does not
+   * guarantee.  The dataset is not modified.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param packing Instantiated packing policy.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  template<typename PackingType>
+  RectangleTree(const MatType& data,
+                const PackingType& packing,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2,
+                const typename std::enable_if_t<
+                    IsPackingPolicy<PackingType>::value>* = 0);
+
+  /**
+   * Construct this as the root node of a rectangle type tree by bulk loading
+   * the given dataset with the given packing policy, and taking ownership of
+   * the dataset.  See the constructor above for details.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param packing Instantiated packing policy.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  template<typename PackingType>
+  RectangleTree(MatType&& data,
+                const PackingType& packing,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2,
+                const typename std::enable_if_t<
+                    IsPackingPolicy<PackingType>::value>* = 0);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -542,6 +600,31 @@ class RectangleTree
    */
   void SplitNode(std::vector<bool>& relevels);
 
+  /**
+   * Construct an empty node without a parent, with the parameters and the
+   * dataset of the given node.  Bulk loading links the node to its parent and
+   * fills it afterwards.
+   *
+   * @param other Node whose parameters are copied.
+   * @param data Dataset of the tree.
+   */
+  RectangleTree(const RectangleTree& other, const MatType& data);
+
+  /**
+   * Bulk load the points of the dataset into this empty root node, in the
+   * order given by the packing policy.
+   */
+  template<typename PackingType>
+  void BulkLoad();
+
+  /**
+   * Finish the nodes below this one after bulk loading, bottom up: the bound,
+   * the number of descendants, the auxiliary information and the statistic of
+   * each non-leaf node are computed from its children.  The leaves must
+   * already be finished.
+   */
+  void FinishBulkLoad();
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -575,7 +658,7 @@ class RectangleTree
    *      is possible when we now what point was deleted.  False otherwise (eg.
    *      if we deleted a node instead of a point).
    */
-  void CondenseTree(const arma::vec& point,
+  void CondenseTree(const arma::Col<ElemType>& point,
                     std::vector<bool>& relevels,
                     const bool usePoint);
 
@@ -586,7 +669,7 @@ class RectangleTree
    *      shrinking.
    * @return true if the bound needed to be changed, false if it did not.
    */
-  bool ShrinkBoundForPoint(const arma::vec& point);
+  bool ShrinkBoundForPoint(const arma::Col<ElemType>& point);
 
   /**
    * Shrink the bound object of this node for the removal of a child node.
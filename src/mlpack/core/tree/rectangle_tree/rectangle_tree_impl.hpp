@@ -134,6 +134,80 @@ RectangleTree(
   stat = StatisticType(*this);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename PackingType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const PackingType& /* packing */,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren,
+              const typename std::enable_if_t<
+                  IsPackingPolicy<PackingType>::value>*) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad<PackingType>();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename PackingType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const PackingType& /* packing */,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren,
+              const typename std::enable_if_t<
+                  IsPackingPolicy<PackingType>::value>*) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad<PackingType>();
+}
+
 /**
  * Create a rectangle tree by copying the other tree.  Be careful!  This can
  * take a long time and use a lot of memory.
@@ -554,7 +628,7 @@ bool RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
         tree->numDescendants -= node->numDescendants;
         tree = tree->Parent();
       }
-      CondenseTree(arma::vec(), relevels, false);
+      CondenseTree(arma::Col<ElemType>(), relevels, false);
       return true;
     }
 
@@ -858,6 +932,160 @@ inline size_t RectangleTree<MetricType, StatisticType, MatType, SplitType,
   }
 }
 
+/**
+ * Construct an empty node without a parent for bulk loading.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const RectangleTree& other, const MatType& data) :
+    maxNumChildren(other.MaxNumChildren()),
+    minNumChildren(other.MinNumChildren()),
+    numChildren(0),
+    children(maxNumChildren + 1),
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(other.MaxLeafSize()),
+    minLeafSize(other.MinLeafSize()),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(&data),
+    ownsDataset(false),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{ }
+
+/**
+ * Bulk load the dataset into this empty root node.  The tree is built top down,
+ * one level at a time; each node of a level holds a contiguous range of the
+ * point order, which the packing policy splits into the ranges of its children.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename PackingType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::BulkLoad()
+{
+  const size_t n = dataset->n_cols;
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+  PackingType::Order(*dataset, order);
+
+  // The capacity of a node is the largest number of points below it; the tree
+  // is as short as possible.
+  size_t capacity = maxLeafSize;
+  while (capacity < n)
+    capacity *= maxNumChildren;
+
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+    threads = omp_get_max_threads();
+  #endif
+
+  // Node i of the current level holds the points order[levelBegins[i]] to
+  // order[levelBegins[i + 1] - 1].
+  std::vector<RectangleTree*> level(1, this);
+  std::vector<size_t> levelBegins(1, 0);
+  levelBegins.push_back(n);
+  while (capacity > maxLeafSize)
+  {
+    capacity /= maxNumChildren;
+
+    // Each node gets as few children as can hold its points.
+    std::vector<size_t> firstChild(level.size() + 1, 0);
+    for (size_t i = 0; i < level.size(); ++i)
+    {
+      const size_t nodeCount = levelBegins[i + 1] - levelBegins[i];
+      firstChild[i + 1] = firstChild[i] + (nodeCount + capacity - 1) / capacity;
+    }
+
+    std::vector<RectangleTree*> nextLevel(firstChild.back());
+    std::vector<size_t> nextBegins(firstChild.back() + 1, n);
+
+    // With fewer nodes than threads, the packing policy sorts in parallel
+    // instead.
+    #pragma omp parallel for schedule(dynamic) if (level.size() >= threads)
+    for (omp_size_t i = 0; i < (omp_size_t) level.size(); ++i)
+    {
+      RectangleTree* node = level[i];
+      const size_t nodeBegin = levelBegins[i];
+      const size_t nodeCount = levelBegins[i + 1] - nodeBegin;
+      const size_t numGroups = firstChild[i + 1] - firstChild[i];
+      PackingType::Tile(*dataset, order, nodeBegin, nodeCount, numGroups);
+
+      for (size_t g = 0; g < numGroups; ++g)
+      {
+        RectangleTree* child = new RectangleTree(*this, *dataset);
+        child->parent = node;
+        node->children[g] = child;
+        nextLevel[firstChild[i] + g] = child;
+        nextBegins[firstChild[i] + g] = nodeBegin + nodeCount * g / numGroups;
+      }
+      node->numChildren = numGroups;
+    }
+
+    level.swap(nextLevel);
+    levelBegins.swap(nextBegins);
+  }
+
+  // Fill the leaves.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) level.size(); ++i)
+  {
+    RectangleTree* leaf = level[i];
+    leaf->count = levelBegins[i + 1] - levelBegins[i];
+    leaf->numDescendants = leaf->count;
+    for (size_t j = 0; j < leaf->count; ++j)
+    {
+      leaf->points[j] = order[levelBegins[i] + j];
+      leaf->bound |= dataset->col(leaf->points[j]);
+    }
+
+    leaf->auxiliaryInfo.HandleBulkLoad(leaf);
+    leaf->stat = StatisticType(*leaf);
+  }
+
+  FinishBulkLoad();
+}
+
+/**
+ * Finish the non-leaf nodes after bulk loading, bottom up.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::FinishBulkLoad()
+{
+  if (numChildren == 0)
+    return;
+
+  for (size_t i = 0; i < numChildren; ++i)
+  {
+    children[i]->FinishBulkLoad();
+    bound |= children[i]->Bound();
+    numDescendants += children[i]->NumDescendants();
+  }
+
+  auxiliaryInfo.HandleBulkLoad(this);
+  stat = StatisticType(*this);
+}
+
 /**
  * Split the tree.  This calls the SplitType code to split a node.  This method
  * should only be called on a leaf node.
@@ -931,7 +1159,7 @@ template<typename MetricType,
          template<typename> class AuxiliaryInformationType>
 void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
                    AuxiliaryInformationType>::
-    CondenseTree(const arma::vec& point,
+    CondenseTree(const arma::Col<ElemType>& point,
                  std::vector<bool>& relevels,
                  const bool usePoint)
 {
@@ -1115,7 +1343,7 @@ template<typename MetricType,
          template<typename> class AuxiliaryInformationType>
 bool RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
                    AuxiliaryInformationType>::
-    ShrinkBoundForPoint(const arma::vec& point)
+    ShrinkBoundForPoint(const arma::Col<ElemType>& point)
 {
   bool shrunk = false;
   if (IsLeaf())
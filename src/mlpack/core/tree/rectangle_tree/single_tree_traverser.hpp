@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "rectangle_tree.hpp"
+#include "../traversal_scratch.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -70,6 +71,10 @@ class RectangleTree<MetricType, StatisticType, MatType, SplitType,
 
   //! The number of nodes which have been prenud during traversal.
   size_t numPrunes;
+
+  //! The scored children of each level of the recursion, reused for every
+  //! node and every query.
+  TraversalScratch<NodeAndScore> scratch;
 };
 
 } // namespace tree
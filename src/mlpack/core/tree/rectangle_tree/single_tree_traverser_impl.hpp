@@ -60,7 +60,8 @@ SingleTreeTraverser<RuleType>::Traverse(
 
   // This is not a leaf node so we sort the children of this node by their
   // scores.
-  std::vector<NodeAndScore> nodesAndScores(referenceNode.NumChildren());
+  ScratchVector<NodeAndScore> buffer(scratch, referenceNode.NumChildren());
+  std::vector<NodeAndScore>& nodesAndScores = buffer.Vector();
   for (size_t i = 0; i < referenceNode.NumChildren(); i++)
   {
     nodesAndScores[i].node = &(referenceNode.Child(i));
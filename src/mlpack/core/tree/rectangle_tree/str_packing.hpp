@@ -0,0 +1,124 @@
+/**
+ * @file str_packing.hpp
+ *
+ * Definition of STRPacking, a packing policy for the bulk loading of
+ * RectangleTrees with Sort-Tile-Recursive.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_STR_PACKING_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_STR_PACKING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "bulk_load_utils.hpp"
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * The Sort-Tile-Recursive packing policy.  The points of a node are split into
+ * the groups of its children with slabs: to make G groups of points in d
+ * dimensions, the points are sorted by their first coordinate and cut into
+ * ceil(G^(1 / d)) slabs, and then each slab is split recursively along the
+ * remaining dimensions.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{leutenegger1997str,
+ *   title={STR: A simple and efficient algorithm for R-tree packing},
+ *   author={Leutenegger, S.T. and Lopez, M.A. and Edgington, J.},
+ *   booktitle={Proceedings of the 13th International Conference on Data
+ *       Engineering},
+ *   pages={497--506},
+ *   year={1997}
+ * }
+ * @endcode
+ */
+class STRPacking
+{
+ public:
+  /**
+   * Nothing to do: the points are only reordered when they are tiled.
+   */
+  template<typename MatType>
+  static void Order(const MatType& /* data */,
+                    std::vector<size_t>& /* points */)
+  { }
+
+  /**
+   * Reorder points[begin, begin + count) so that each of the numGroups groups
+   * is a tile of nearby points.
+   *
+   * @param data Dataset of the tree.
+   * @param points Indices of the points of the tree.
+   * @param begin First point of the node.
+   * @param count Number of points of the node.
+   * @param numGroups Number of groups to make.
+   */
+  template<typename MatType>
+  static void Tile(const MatType& data,
+                   std::vector<size_t>& points,
+                   const size_t begin,
+                   const size_t count,
+                   const size_t numGroups)
+  {
+    TileGroups(data, points, begin, count, numGroups, 0, numGroups, 0);
+  }
+
+ private:
+  /**
+   * Tile the groups [firstGroup, lastGroup) of the node, starting with the
+   * given dimension.
+   */
+  template<typename MatType>
+  static void TileGroups(const MatType& data,
+                         std::vector<size_t>& points,
+                         const size_t begin,
+                         const size_t count,
+                         const size_t numGroups,
+                         const size_t firstGroup,
+                         const size_t lastGroup,
+                         const size_t dim)
+  {
+    const size_t groups = lastGroup - firstGroup;
+    if (groups <= 1)
+      return;
+
+    const size_t rangeBegin = begin + count * firstGroup / numGroups;
+    const size_t rangeEnd = begin + count * lastGroup / numGroups;
+    ParallelSort(points, rangeBegin, rangeEnd,
+        [&data, dim](const size_t a, const size_t b)
+        {
+          return data(dim, a) < data(dim, b);
+        });
+
+    // Along the last dimension, the groups are consecutive runs of points.
+    if (dim + 1 == data.n_rows)
+      return;
+
+    const size_t numSlabs = (size_t) std::ceil(std::pow((double) groups,
+        1.0 / (data.n_rows - dim)));
+    for (size_t s = 0; s < numSlabs; ++s)
+    {
+      TileGroups(data, points, begin, count, numGroups,
+          firstGroup + groups * s / numSlabs,
+          firstGroup + groups * (s + 1) / numSlabs, dim + 1);
+    }
+  }
+};
+
+//! STRPacking is a packing policy.
+template<>
+struct IsPackingPolicy<STRPacking>
+{
+  static const bool value = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
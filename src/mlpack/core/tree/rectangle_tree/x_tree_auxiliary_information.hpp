@@ -156,6 +156,14 @@ class XTreeAuxiliaryInformation
     return false;
   }
 
+  /**
+   * The X tree does not need to set up its auxiliary information
+   * after the tree is bulk loaded: the split history of each node is empty.
+   *
+   * @param node The node in which the auxiliary information is being set up.
+   */
+  void HandleBulkLoad(TreeType* /* node */) { }
+
   /**
    * Nullify the auxiliary information in order to prevent an invalid free.
    */
@@ -0,0 +1,115 @@
+/**
+ * @file search_context.hpp
+ *
+ * Definition of SearchContext, the state of one search that is not part of the
+ * trained model.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_SEARCH_CONTEXT_HPP
+#define MLPACK_CORE_TREE_SEARCH_CONTEXT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <chrono>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * The SearchContext class holds the state of a single search that does not
+ * belong to the trained model: the number of base cases and scores that the
+ * search performed.  Searches that are given a SearchContext do not modify the
+ * model, so one model can serve searches from several threads at once, as long
+ * as each thread uses its own context.
+ *
+ * A context may also hold a budget for the searches that support one: the
+ * maximum number of leaves that each query visits, and a deadline for the
+ * whole search.  A search with a budget visits the nodes best first so that it
+ * can stop at any time with the best candidates found so far, and Exact()
+ * tells which queries it finished.
+ */
+class SearchContext
+{
+ public:
+  //! The type of clock used for the deadline.
+  typedef std::chrono::steady_clock Clock;
+
+  //! Create an empty context, without a budget.
+  SearchContext() :
+      baseCases(0),
+      scores(0),
+      maxLeaves(0),
+      deadline(Clock::time_point::max())
+  { }
+
+  //! Get the number of base cases performed by the last search.
+  size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases performed by the last search.
+  size_t& BaseCases() { return baseCases; }
+
+  //! Get the number of node combinations scored by the last search.
+  size_t Scores() const { return scores; }
+  //! Modify the number of node combinations scored by the last search.
+  size_t& Scores() { return scores; }
+
+  //! Get the maximum number of leaves that each query visits (0 for no
+  //! limit).
+  size_t MaxLeaves() const { return maxLeaves; }
+  //! Modify the maximum number of leaves that each query visits (0 for no
+  //! limit).
+  size_t& MaxLeaves() { return maxLeaves; }
+
+  //! Get the time when searches stop visiting leaves.
+  Clock::time_point Deadline() const { return deadline; }
+  //! Modify the time when searches stop visiting leaves
+  //! (Clock::time_point::max() for no limit).
+  Clock::time_point& Deadline() { return deadline; }
+
+  //! Set the deadline to the given time from now.
+  template<typename Rep, typename Period>
+  void Timeout(const std::chrono::duration<Rep, Period>& timeout)
+  {
+    deadline = Clock::now() +
+        std::chrono::duration_cast<Clock::duration>(timeout);
+  }
+
+  //! Return whether searches with this context have a budget.
+  bool Budgeted() const
+  {
+    return maxLeaves > 0 || deadline != Clock::time_point::max();
+  }
+
+  //! Get whether the result of each query of the last search with a budget
+  //! is the one that the search would have found without a budget (nonzero),
+  //! or whether the budget was spent first (zero).  This is empty after
+  //! searches without a budget.
+  const std::vector<char>& Exact() const { return exact; }
+  //! Modify whether the result of each query of the last search is exact.
+  std::vector<char>& Exact() { return exact; }
+
+  //! Return whether the result of every query of the last search is exact.
+  bool AllExact() const
+  {
+    return std::find(exact.begin(), exact.end(), 0) == exact.end();
+  }
+
+ private:
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+  //! The maximum number of leaves that each query visits.
+  size_t maxLeaves;
+  //! The time when searches stop visiting leaves.
+  Clock::time_point deadline;
+  //! Whether the result of each query of the last search is exact.
+  std::vector<char> exact;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file shared_results.hpp
+ *
+ * Definition of the SharedResults tag, which selects the constructor of rules
+ * that copies them for a parallel traversal, and of SharedCopy(), which copies
+ * any rules that way.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_SHARED_RESULTS_HPP
+#define MLPACK_CORE_TREE_SHARED_RESULTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Tag for the constructor of rules that creates a copy for a traversal running
+ * in parallel with the traversal of the original rules: the copy shares the
+ * per-query-point results with the object it is copied from (which must
+ * outlive the copy), but has its own traversal state and counters.
+ *
+ * A plain copy of rules that have such a constructor is independent of the
+ * original.
+ */
+struct SharedResults { };
+
+/**
+ * Create a copy of the given rules that shares their results, with the
+ * SharedResults constructor of the rules.  Rules without that constructor hold
+ * their results by reference, so they are plainly copied.
+ *
+ * @param rule The rules to copy.
+ */
+template<typename RuleType>
+std::unique_ptr<RuleType> SharedCopy(
+    const RuleType& rule,
+    const typename std::enable_if<std::is_constructible<RuleType,
+        const RuleType&, SharedResults>::value>::type* = 0)
+{
+  return std::unique_ptr<RuleType>(new RuleType(rule, SharedResults()));
+}
+
+//! Copy rules that have no SharedResults constructor.
+template<typename RuleType>
+std::unique_ptr<RuleType> SharedCopy(
+    const RuleType& rule,
+    const typename std::enable_if<!std::is_constructible<RuleType,
+        const RuleType&, SharedResults>::value>::type* = 0)
+{
+  return std::unique_ptr<RuleType>(new RuleType(rule));
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
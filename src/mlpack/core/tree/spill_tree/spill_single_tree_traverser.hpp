@@ -36,9 +36,17 @@ class SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 {
  public:
   /**
-   * Instantiate the single tree traverser with the given rule set.
+   * Instantiate the single tree traverser with the given rule set.  If
+   * maxLeaves is nonzero, each traversal visits at most that many leaves: the
+   * children are visited best first, as usual, and the search stops when the
+   * budget is spent.  This hybrid search is approximate even without defeatist
+   * nodes, but its cost per query is bounded.
+   *
+   * @param rule Rules with which the tree will be traversed.
+   * @param maxLeaves Maximum number of leaves visited by each traversal (0 for
+   *     no limit).
    */
-  SpillSingleTreeTraverser(RuleType& rule);
+  SpillSingleTreeTraverser(RuleType& rule, const size_t maxLeaves = 0);
 
   /**
    * Traverse the tree with the given point.
@@ -54,12 +62,40 @@ class SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   //! Modify the number of prunes.
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the maximum number of leaves visited by each traversal.
+  size_t MaxLeaves() const { return maxLeaves; }
+  //! Modify the maximum number of leaves visited by each traversal.
+  size_t& MaxLeaves() { return maxLeaves; }
+
+  //! Get the number of leaves visited by the last traversal.
+  size_t NumVisitedLeaves() const { return numVisitedLeaves; }
+
  private:
+  /**
+   * Traverse the given node and its descendants, within the leaf budget.
+   *
+   * @param queryIndex The index of the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void TraverseNode(const size_t queryIndex, SpillTree& referenceNode);
+
+  //! Whether the leaf budget of the current traversal is spent.
+  bool BudgetSpent() const
+  {
+    return maxLeaves > 0 && numVisitedLeaves >= maxLeaves;
+  }
+
   //! Reference to the rules with which the tree will be traversed.
   RuleType& rule;
 
   //! The number of nodes which have been pruned during traversal.
   size_t numPrunes;
+
+  //! The maximum number of leaves visited by each traversal (0 for no limit).
+  size_t maxLeaves;
+
+  //! The number of leaves visited by the current traversal.
+  size_t numVisitedLeaves;
 };
 
 } // namespace tree
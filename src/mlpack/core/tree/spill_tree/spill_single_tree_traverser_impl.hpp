@@ -30,9 +30,12 @@ template<typename MetricType,
 template<typename RuleType, bool Defeatist>
 SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 SpillSingleTreeTraverser<RuleType, Defeatist>::SpillSingleTreeTraverser(
-    RuleType& rule) :
+    RuleType& rule,
+    const size_t maxLeaves) :
     rule(rule),
-    numPrunes(0)
+    numPrunes(0),
+    maxLeaves(maxLeaves),
+    numVisitedLeaves(0)
 { /* Nothing to do. */ }
 
 template<typename MetricType,
@@ -48,9 +51,34 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
     SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>&
         referenceNode)
 {
-  // If we are a leaf, run the base case as necessary.
+  numVisitedLeaves = 0;
+  TraverseNode(queryIndex, referenceNode);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType, bool Defeatist>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+SpillSingleTreeTraverser<RuleType, Defeatist>::TraverseNode(
+    const size_t queryIndex,
+    SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>&
+        referenceNode)
+{
+  // If we are a leaf, run the base case as necessary, unless the leaf budget
+  // is spent.
   if (referenceNode.IsLeaf())
   {
+    if (BudgetSpent())
+    {
+      ++numPrunes;
+      return;
+    }
+
+    ++numVisitedLeaves;
     for (size_t i = 0; i < referenceNode.NumPoints(); ++i)
       rule.BaseCase(queryIndex, referenceNode.Point(i));
   }
@@ -60,7 +88,7 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
     {
       // If referenceNode is a overlapping node we do defeatist search.
       size_t bestChild = rule.GetBestChild(queryIndex, referenceNode);
-      Traverse(queryIndex, referenceNode.Child(bestChild));
+      TraverseNode(queryIndex, referenceNode.Child(bestChild));
       ++numPrunes;
     }
     else
@@ -72,27 +100,27 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
       if (leftScore < rightScore)
       {
         // Recurse to the left.
-        Traverse(queryIndex, *referenceNode.Left());
+        TraverseNode(queryIndex, *referenceNode.Left());
 
         // Is it still valid to recurse to the right?
         rightScore = rule.Rescore(queryIndex, *referenceNode.Right(),
             rightScore);
 
-        if (rightScore != DBL_MAX)
-          Traverse(queryIndex, *referenceNode.Right()); // Recurse to the right.
+        if (rightScore != DBL_MAX && !BudgetSpent())
+          TraverseNode(queryIndex, *referenceNode.Right()); // Recurse right.
         else
           ++numPrunes;
       }
       else if (rightScore < leftScore)
       {
         // Recurse to the right.
-        Traverse(queryIndex, *referenceNode.Right());
+        TraverseNode(queryIndex, *referenceNode.Right());
 
         // Is it still valid to recurse to the left?
         leftScore = rule.Rescore(queryIndex, *referenceNode.Left(), leftScore);
 
-        if (leftScore != DBL_MAX)
-          Traverse(queryIndex, *referenceNode.Left()); // Recurse to the left.
+        if (leftScore != DBL_MAX && !BudgetSpent())
+          TraverseNode(queryIndex, *referenceNode.Left()); // Recurse left.
         else
           ++numPrunes;
       }
@@ -105,14 +133,14 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
         else
         {
           // Choose the left first.
-          Traverse(queryIndex, *referenceNode.Left());
+          TraverseNode(queryIndex, *referenceNode.Left());
 
           // Is it still valid to recurse to the right?
           rightScore = rule.Rescore(queryIndex, *referenceNode.Right(),
               rightScore);
 
-          if (rightScore != DBL_MAX)
-            Traverse(queryIndex, *referenceNode.Right());
+          if (rightScore != DBL_MAX && !BudgetSpent())
+            TraverseNode(queryIndex, *referenceNode.Right());
           else
             ++numPrunes;
         }
@@ -452,6 +452,54 @@ class SpillTree
                    const arma::Col<size_t>& points,
                    arma::Col<size_t>& leftPoints,
                    arma::Col<size_t>& rightPoints);
+
+  /**
+   * Construct this node as a child of the given parent, without splitting it.
+   * This is used by ParallelSplitNode(), which splits the node (and computes
+   * its statistic) afterwards.
+   *
+   * @param parent Parent of this node.
+   */
+  SpillTree(SpillTree* parent);
+
+  /**
+   * Split the current node and build the whole tree below it with all threads.
+   * The nodes holding many points are split first (their projections are
+   * computed in parallel), and the subtrees below them are then built by
+   * different threads.
+   *
+   * @param points Vector of indexes of points to be included in this node.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   */
+  void ParallelSplitNode(arma::Col<size_t>& points,
+                         const size_t maxLeafSize,
+                         const double tau,
+                         const double rho);
+
+  /**
+   * Split the current node and its descendants holding more than taskSize
+   * points.  The other nodes are not split; they are added to the list of
+   * subtrees to build, with their points.
+   *
+   * @param points Vector of indexes of points to be included in this node.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   * @param taskSize Maximum number of points in a subtree built by one thread.
+   * @param topNodes Filled with the split nodes, in depth-first order.
+   * @param tasks Filled with the nodes that still have to be split.
+   * @param taskPoints Filled with the points of each node in tasks.
+   */
+  void SplitTopNode(arma::Col<size_t>& points,
+                    const size_t maxLeafSize,
+                    const double tau,
+                    const double rho,
+                    const size_t taskSize,
+                    std::vector<SpillTree*>& topNodes,
+                    std::vector<SpillTree*>& tasks,
+                    std::vector<arma::Col<size_t>>& taskPoints);
  protected:
   /**
    * A default constructor.  This is meant to only be used with
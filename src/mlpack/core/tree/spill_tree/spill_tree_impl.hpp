@@ -579,6 +579,15 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
               const double tau,
               const double rho)
 {
+#ifdef HAS_OPENMP
+  // The root node builds the tree with all threads.
+  if (!parent && omp_get_max_threads() > 1 && !omp_in_parallel())
+  {
+    ParallelSplitNode(points, maxLeafSize, tau, rho);
+    return;
+  }
+#endif
+
   // We need to expand the bounds of this node properly.
   for (size_t i = 0; i < points.n_elem; i++)
     bound |= dataset->col(points[i]);
@@ -653,7 +662,11 @@ bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   size_t left = 0, right = 0, leftFrontier = 0, rightFrontier = 0;
 
   // Count the number of points to the left/right of the splitting hyperplane.
-  for (size_t i = 0; i < points.n_elem; i++)
+  // The projections of the large nodes at the top of the tree are computed
+  // with all threads.
+  #pragma omp parallel for reduction(+:left, right, leftFrontier, \
+      rightFrontier) if (points.n_elem >= 10000)
+  for (omp_size_t i = 0; i < (omp_size_t) points.n_elem; i++)
   {
     // Store projection value for future use.
     projections[i] = hyperplane.Project(dataset->col(points[i]));
@@ -710,6 +723,154 @@ bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   return false;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+SpillTree(SpillTree* parent) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    count(0),
+    pointsIndex(NULL),
+    overlappingNode(false),
+    hyperplane(),
+    bound(parent->Dataset().n_rows),
+    parentDistance(0),
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    localDataset(false)
+{
+  // The node is split later by ParallelSplitNode().
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+ParallelSplitNode(arma::Col<size_t>& points,
+                  const size_t maxLeafSize,
+                  const double tau,
+                  const double rho)
+{
+#ifdef HAS_OPENMP
+  // Split the large nodes serially (their projections use all threads) until
+  // there are enough subtrees to keep every thread busy.
+  const size_t tasksPerThread = 8;
+  const size_t taskSize = std::max(maxLeafSize,
+      (size_t) points.n_elem / (tasksPerThread * omp_get_max_threads()));
+
+  std::vector<SpillTree*> topNodes, tasks;
+  std::vector<arma::Col<size_t>> taskPoints;
+  SplitTopNode(points, maxLeafSize, tau, rho, taskSize, topNodes, tasks,
+      taskPoints);
+
+  // Now build the remaining subtrees in parallel.  Each subtree owns the list
+  // of its points, so they can be built independently.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) tasks.size(); ++i)
+  {
+    tasks[i]->SplitNode(taskPoints[i], maxLeafSize, tau, rho);
+    tasks[i]->stat = StatisticType(*tasks[i]);
+  }
+
+  // Finally, finish the split nodes bottom-up, since their counts, parent
+  // distances and statistics depend on their children.  The statistic of this
+  // node is created by the constructor.
+  for (size_t i = topNodes.size(); i > 0; --i)
+  {
+    SpillTree* node = topNodes[i - 1];
+    if (node->left)
+    {
+      node->count = node->left->NumDescendants() +
+          node->right->NumDescendants();
+
+      arma::vec center, leftCenter, rightCenter;
+      node->Center(center);
+      node->left->Center(leftCenter);
+      node->right->Center(rightCenter);
+
+      node->left->ParentDistance() = MetricType::Evaluate(center, leftCenter);
+      node->right->ParentDistance() = MetricType::Evaluate(center,
+          rightCenter);
+    }
+
+    if (node != this)
+      node->stat = StatisticType(*node);
+  }
+#else
+  // Without OpenMP this is never called; just split the node serially.
+  SplitNode(points, maxLeafSize, tau, rho);
+#endif
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+SplitTopNode(arma::Col<size_t>& points,
+             const size_t maxLeafSize,
+             const double tau,
+             const double rho,
+             const size_t taskSize,
+             std::vector<SpillTree*>& topNodes,
+             std::vector<SpillTree*>& tasks,
+             std::vector<arma::Col<size_t>>& taskPoints)
+{
+  // Small nodes are built later, by a single thread.
+  if (parent && points.n_elem <= taskSize)
+  {
+    tasks.push_back(this);
+    taskPoints.push_back(arma::Col<size_t>());
+    taskPoints.back().swap(points);
+    return;
+  }
+
+  topNodes.push_back(this);
+
+  // We need to expand the bounds of this node properly.
+  for (size_t i = 0; i < points.n_elem; i++)
+    bound |= dataset->col(points[i]);
+
+  // Calculate the furthest descendant distance.
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // Now, check if we need to split at all.  The node may not be always split.
+  // For instance, if all the points are the same, we can't split them.
+  if (points.n_elem <= maxLeafSize || !SplitType<MetricType,
+      MatType>::SplitSpace(bound, *dataset, points, hyperplane))
+  {
+    pointsIndex = new arma::Col<size_t>();
+    pointsIndex->swap(points);
+    count = pointsIndex->n_elem;
+    return; // We can't split this.
+  }
+
+  arma::Col<size_t> leftPoints, rightPoints;
+  // Split the node.
+  overlappingNode = SplitPoints(tau, rho, points, leftPoints, rightPoints);
+
+  // We don't need the information in points, so lets clean it.
+  arma::Col<size_t>().swap(points);
+
+  // Create the children without splitting them, and then recurse.
+  left = new SpillTree(this);
+  right = new SpillTree(this);
+
+  left->SplitTopNode(leftPoints, maxLeafSize, tau, rho, taskSize, topNodes,
+      tasks, taskPoints);
+  right->SplitTopNode(rightPoints, maxLeafSize, tau, rho, taskSize, topNodes,
+      tasks, taskPoints);
+}
+
 // Default constructor (private), for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -0,0 +1,112 @@
+/**
+ * @file traversal_scratch.hpp
+ *
+ * Reusable scratch memory for the recursive tree traversers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_SCRATCH_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_SCRATCH_HPP
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A stack of vectors for a recursive traversal, so that each level of the
+ * recursion gets a vector without allocating it again for every node.  A
+ * traverser holds a TraversalScratch as a member, and each call takes a vector
+ * with a ScratchVector, which returns it when the call ends.  The vectors keep
+ * their capacity, so after the first few queries a traversal does not allocate
+ * any more memory.
+ *
+ * @code
+ * ScratchVector<NodeAndScore> buffer(scratch, node.NumChildren());
+ * std::vector<NodeAndScore>& nodesAndScores = buffer.Vector();
+ * @endcode
+ *
+ * @tparam T Type of the elements of the vectors.
+ */
+template<typename T>
+class TraversalScratch
+{
+ public:
+  //! Create the scratch memory; nothing is allocated until it is used.
+  TraversalScratch() : used(0) { }
+
+  //! Copying a traverser does not copy its scratch memory.
+  TraversalScratch(const TraversalScratch& /* other */) : used(0) { }
+
+  //! Copying a traverser does not copy its scratch memory.
+  TraversalScratch& operator=(const TraversalScratch& /* other */)
+  {
+    return *this;
+  }
+
+  /**
+   * Take the next vector, resized to the given number of elements.  Vectors
+   * must be returned in the reverse order they were taken.
+   */
+  std::vector<T>& Take(const size_t size)
+  {
+    // The vectors are held by a deque, so that references to them stay valid
+    // when deeper levels of the recursion add more.
+    if (used == vectors.size())
+      vectors.push_back(std::vector<T>());
+
+    std::vector<T>& v = vectors[used++];
+    v.clear();
+    v.resize(size);
+    return v;
+  }
+
+  //! Return the last vector that was taken.
+  void Return() { --used; }
+
+ private:
+  //! The vectors, one for each use at once.
+  std::deque<std::vector<T>> vectors;
+  //! The number of vectors currently taken.
+  size_t used;
+};
+
+/**
+ * A vector taken from a TraversalScratch for the lifetime of this object.
+ */
+template<typename T>
+class ScratchVector
+{
+ public:
+  //! Take a vector of the given size from the scratch memory.
+  ScratchVector(TraversalScratch<T>& scratch, const size_t size = 0) :
+      scratch(scratch),
+      vector(scratch.Take(size))
+  { }
+
+  //! Return the vector to the scratch memory.
+  ~ScratchVector() { scratch.Return(); }
+
+  //! Get the vector.
+  std::vector<T>& Vector() { return vector; }
+
+ private:
+  // A ScratchVector cannot be copied.
+  ScratchVector(const ScratchVector& other);
+  ScratchVector& operator=(const ScratchVector& other);
+
+  //! The scratch memory the vector was taken from.
+  TraversalScratch<T>& scratch;
+  //! The vector.
+  std::vector<T>& vector;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,418 @@
+/**
+ * @file traversal_statistics.hpp
+ *
+ * Optional statistics of dual-tree traversals: the node combinations scored
+ * and pruned at each depth of the reference tree, the base cases, and the time
+ * spent in Score() and BaseCase().  They are collected by wrapping the rules of
+ * any traversal in StatisticsRules.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/shared_results.hpp>
+#include <mutex>
+#include <numeric>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The statistics of one or more traversals.  The depth of a node combination
+ * is the depth of its reference node, so the prune ratio of each depth shows
+ * how well the bounds of the reference tree work at that depth; a low ratio at
+ * the deepest levels suggests larger leaves.
+ *
+ * Collecting statistics slows the traversal down (every call to the rules is
+ * timed), so the dual-tree algorithms only collect them if Enabled() is true;
+ * the command-line programs enable them with --verbose.
+ */
+class TraversalStatistics
+{
+ public:
+  //! Create empty statistics.
+  TraversalStatistics() :
+      baseCases(0),
+      rescorePrunes(0),
+      scoreTime(0),
+      baseCaseTime(0)
+  { }
+
+  //! Get whether the dual-tree algorithms collect statistics.
+  static bool Enabled() { return EnabledFlag(); }
+  //! Make the dual-tree algorithms collect (and report) statistics.
+  static void Enable() { EnabledFlag() = true; }
+  //! Stop collecting statistics.
+  static void Disable() { EnabledFlag() = false; }
+
+  //! Record a scored node combination, and whether it was pruned.
+  void AddScore(const size_t depth, const bool pruned)
+  {
+    if (depth >= scores.size())
+    {
+      scores.resize(depth + 1, 0);
+      prunes.resize(depth + 1, 0);
+    }
+
+    ++scores[depth];
+    if (pruned)
+      ++prunes[depth];
+  }
+
+  //! Record a node combination that was pruned when it was rescored.
+  void AddRescorePrune(const size_t depth)
+  {
+    if (depth >= scores.size())
+    {
+      scores.resize(depth + 1, 0);
+      prunes.resize(depth + 1, 0);
+    }
+
+    ++prunes[depth];
+    ++rescorePrunes;
+  }
+
+  //! Record base cases.
+  void AddBaseCases(const size_t count) { baseCases += count; }
+  //! Record time spent in Score() and Rescore(), in nanoseconds.
+  void AddScoreTime(const uint64_t time) { scoreTime += time; }
+  //! Record time spent in BaseCase() and LeafBaseCase(), in nanoseconds.
+  void AddBaseCaseTime(const uint64_t time) { baseCaseTime += time; }
+
+  /**
+   * Add the given statistics to these.  This may be called from several
+   * threads at once.
+   */
+  void Merge(const TraversalStatistics& other)
+  {
+    std::lock_guard<std::mutex> lock(mergeMutex);
+    if (other.scores.size() > scores.size())
+    {
+      scores.resize(other.scores.size(), 0);
+      prunes.resize(other.scores.size(), 0);
+    }
+
+    for (size_t d = 0; d < other.scores.size(); ++d)
+    {
+      scores[d] += other.scores[d];
+      prunes[d] += other.prunes[d];
+    }
+
+    baseCases += other.baseCases;
+    rescorePrunes += other.rescorePrunes;
+    scoreTime += other.scoreTime;
+    baseCaseTime += other.baseCaseTime;
+  }
+
+  //! Get the number of depths with scored node combinations.
+  size_t Depths() const { return scores.size(); }
+  //! Get the number of node combinations scored at the given depth.
+  size_t Scores(const size_t depth) const { return scores[depth]; }
+  //! Get the number of node combinations pruned at the given depth.
+  size_t Prunes(const size_t depth) const { return prunes[depth]; }
+
+  //! Get the total number of node combinations scored.
+  size_t Scores() const
+  { return std::accumulate(scores.begin(), scores.end(), (size_t) 0); }
+  //! Get the total number of node combinations pruned.
+  size_t Prunes() const
+  { return std::accumulate(prunes.begin(), prunes.end(), (size_t) 0); }
+  //! Get the number of node combinations that were visited (not pruned).
+  size_t Visited() const { return Scores() - (Prunes() - rescorePrunes); }
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the time spent in Score() and Rescore(), in seconds.
+  double ScoreTime() const { return scoreTime / 1e9; }
+  //! Get the time spent in BaseCase() and LeafBaseCase(), in seconds.
+  double BaseCaseTime() const { return baseCaseTime / 1e9; }
+
+  /**
+   * Print the statistics to Log::Info.
+   *
+   * @param name Name of the traversal, for the header.
+   */
+  void Report(const std::string& name) const
+  {
+    Log::Info << "Traversal statistics (" << name << "):" << std::endl;
+    Log::Info << "  " << Scores() << " node combinations scored, " << Prunes()
+        << " pruned, " << Visited() << " visited." << std::endl;
+    Log::Info << "  " << BaseCases() << " base cases." << std::endl;
+    Log::Info << "  " << ScoreTime() << "s in Score(), " << BaseCaseTime()
+        << "s in BaseCase()." << std::endl;
+    for (size_t d = 0; d < scores.size(); ++d)
+    {
+      if (scores[d] == 0)
+        continue;
+
+      Log::Info << "  depth " << d << ": " << scores[d] << " scored, "
+          << prunes[d] << " pruned (" << (100.0 * prunes[d] / scores[d])
+          << "%)." << std::endl;
+    }
+  }
+
+ private:
+  //! The flag of Enabled().
+  static std::atomic<bool>& EnabledFlag()
+  {
+    static std::atomic<bool> enabled(false);
+    return enabled;
+  }
+
+  //! The number of node combinations scored at each depth.
+  std::vector<size_t> scores;
+  //! The number of node combinations pruned at each depth.
+  std::vector<size_t> prunes;
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of prunes by Rescore() (those combinations were scored
+  //! before).
+  size_t rescorePrunes;
+  //! The time spent in Score() and Rescore(), in nanoseconds.
+  uint64_t scoreTime;
+  //! The time spent in BaseCase() and LeafBaseCase(), in nanoseconds.
+  uint64_t baseCaseTime;
+  //! Lock for Merge().
+  std::mutex mergeMutex;
+};
+
+/**
+ * StatisticsRules wraps the rules of a traversal and forwards every call to
+ * them, recording the statistics of the calls.  It can be used with any tree
+ * traverser, including ParallelDualTreeTraverser: a copy of the wrapper holds
+ * a copy of the rules (sharing their results, for a SharedResults copy), and
+ * adds its statistics to the shared TraversalStatistics object when it is
+ * destroyed.
+ *
+ * @tparam RuleType Type of the wrapped rules.
+ */
+template<typename RuleType>
+class StatisticsRules
+{
+ public:
+  //! The traversal info type of the wrapped rules.
+  typedef typename RuleType::TraversalInfoType TraversalInfoType;
+
+  /**
+   * Wrap the given rules.  The statistics are added to the given object when
+   * the wrapper is destroyed.
+   */
+  StatisticsRules(RuleType& rule, TraversalStatistics& statistics) :
+      rule(&rule),
+      target(&statistics)
+  { }
+
+  //! Copy the wrapper, with a copy of the wrapped rules.
+  StatisticsRules(const StatisticsRules& other) :
+      ownedRule(new RuleType(*other.rule)),
+      rule(ownedRule.get()),
+      target(other.target)
+  { }
+
+  //! Copy the wrapper for a parallel traversal, with a copy of the wrapped
+  //! rules that shares their results (see SharedCopy()).
+  StatisticsRules(const StatisticsRules& other, SharedResults) :
+      ownedRule(SharedCopy(*other.rule)),
+      rule(ownedRule.get()),
+      target(other.target)
+  { }
+
+  //! Add the statistics to the shared object.
+  ~StatisticsRules() { target->Merge(statistics); }
+
+  //! Compute the base case between the given points.
+  auto BaseCase(const size_t queryIndex, const size_t referenceIndex)
+      -> decltype(std::declval<RuleType&>().BaseCase(queryIndex,
+          referenceIndex))
+  {
+    CallTimer timer(statistics, false);
+    statistics.AddBaseCases(1);
+    return rule->BaseCase(queryIndex, referenceIndex);
+  }
+
+  //! Compute the base cases between two leaves, if the rules can.
+  template<typename TreeType>
+  auto LeafBaseCase(TreeType& queryNode, TreeType& referenceNode)
+      -> decltype(std::declval<RuleType&>().LeafBaseCase(queryNode,
+          referenceNode))
+  {
+    CallTimer timer(statistics, false);
+    const bool done = rule->LeafBaseCase(queryNode, referenceNode);
+    if (done)
+    {
+      statistics.AddBaseCases(queryNode.NumPoints() *
+          referenceNode.NumPoints());
+    }
+    return done;
+  }
+
+  //! Score a combination of a query point and a reference node.
+  template<typename TreeType>
+  double Score(const size_t queryIndex, TreeType& referenceNode)
+  {
+    CallTimer timer(statistics, true);
+    const double score = rule->Score(queryIndex, referenceNode);
+    statistics.AddScore(Depth(referenceNode), score == DBL_MAX);
+    return score;
+  }
+
+  //! Score a combination of a query node and a reference node.
+  template<typename TreeType>
+  double Score(TreeType& queryNode, TreeType& referenceNode)
+  {
+    CallTimer timer(statistics, true);
+    const double score = rule->Score(queryNode, referenceNode);
+    statistics.AddScore(Depth(referenceNode), score == DBL_MAX);
+    return score;
+  }
+
+  //! Rescore a combination of a query point and a reference node.
+  template<typename TreeType>
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore)
+  {
+    CallTimer timer(statistics, true);
+    const double score = rule->Rescore(queryIndex, referenceNode, oldScore);
+    if (score == DBL_MAX && oldScore != DBL_MAX)
+      statistics.AddRescorePrune(Depth(referenceNode));
+    return score;
+  }
+
+  //! Rescore a combination of a query node and a reference node.
+  template<typename TreeType>
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore)
+  {
+    CallTimer timer(statistics, true);
+    const double score = rule->Rescore(queryNode, referenceNode, oldScore);
+    if (score == DBL_MAX && oldScore != DBL_MAX)
+      statistics.AddRescorePrune(Depth(referenceNode));
+    return score;
+  }
+
+  //! Get the best child of a reference node (for spill tree traversals).
+  template<typename QueryType, typename TreeType>
+  auto GetBestChild(const QueryType& query, TreeType& referenceNode)
+      -> decltype(std::declval<RuleType&>().GetBestChild(query,
+          referenceNode))
+  {
+    return rule->GetBestChild(query, referenceNode);
+  }
+
+  //! Get the traversal info.
+  const TraversalInfoType& TraversalInfo() const
+  { return rule->TraversalInfo(); }
+  //! Modify the traversal info.
+  TraversalInfoType& TraversalInfo() { return rule->TraversalInfo(); }
+
+  //! Get the number of base cases of the wrapped rules.
+  size_t BaseCases() const { return rule->BaseCases(); }
+  //! Modify the number of base cases of the wrapped rules.
+  size_t& BaseCases() { return rule->BaseCases(); }
+
+  //! Get the number of scores of the wrapped rules.
+  size_t Scores() const { return rule->Scores(); }
+  //! Modify the number of scores of the wrapped rules.
+  size_t& Scores() { return rule->Scores(); }
+
+  //! Get the wrapped rules.
+  RuleType& Rules() { return *rule; }
+
+ private:
+  //! Add the time of its lifetime to the score or base case time.
+  class CallTimer
+  {
+   public:
+    CallTimer(TraversalStatistics& statistics, const bool score) :
+        statistics(statistics),
+        score(score),
+        start(std::chrono::steady_clock::now())
+    { }
+
+    ~CallTimer()
+    {
+      const uint64_t time = std::chrono::duration_cast<
+          std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+          start).count();
+      if (score)
+        statistics.AddScoreTime(time);
+      else
+        statistics.AddBaseCaseTime(time);
+    }
+
+   private:
+    TraversalStatistics& statistics;
+    bool score;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  //! Get the depth of the given node.
+  template<typename TreeType>
+  static size_t Depth(const TreeType& node)
+  {
+    size_t depth = 0;
+    for (const TreeType* n = node.Parent(); n != NULL; n = n->Parent())
+      ++depth;
+    return depth;
+  }
+
+  //! The copy of the rules held by a copied wrapper.
+  std::unique_ptr<RuleType> ownedRule;
+  //! The wrapped rules.
+  RuleType* rule;
+  //! The statistics of this wrapper.
+  TraversalStatistics statistics;
+  //! The statistics that this wrapper adds its statistics to.
+  TraversalStatistics* target;
+};
+
+/**
+ * Traverse the given trees with a TraverserType<RuleType>.  If
+ * TraversalStatistics::Enabled(), the rules are wrapped in StatisticsRules and
+ * the statistics are reported to Log::Info under the given name.
+ *
+ * @tparam TraverserType The dual-tree traverser to use.
+ * @param rule The rules of the traversal.
+ * @param queryNode The root of the query tree.
+ * @param referenceNode The root of the reference tree.
+ * @param name Name of the traversal, for the report.
+ * @return The number of prunes of the traverser.
+ */
+template<template<typename> class TraverserType,
+         typename RuleType,
+         typename TreeType>
+size_t TraverseWithStatistics(RuleType& rule,
+                              TreeType& queryNode,
+                              TreeType& referenceNode,
+                              const std::string& name)
+{
+  if (!TraversalStatistics::Enabled())
+  {
+    TraverserType<RuleType> traverser(rule);
+    traverser.Traverse(queryNode, referenceNode);
+    return traverser.NumPrunes();
+  }
+
+  TraversalStatistics statistics;
+  size_t numPrunes;
+  {
+    StatisticsRules<RuleType> statisticsRule(rule, statistics);
+    TraverserType<StatisticsRules<RuleType>> traverser(statisticsRule);
+    traverser.Traverse(queryNode, referenceNode);
+    numPrunes = traverser.NumPrunes();
+  }
+
+  statistics.Report(name);
+  return numPrunes;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file autotune.cpp
+ *
+ * Implementation of the cache of the autotuning decisions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "autotune.hpp"
+#include "threads.hpp"
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+using namespace mlpack;
+
+namespace {
+
+//! The cached decisions, by key.
+std::map<std::string, std::string>& Decisions()
+{
+  static std::map<std::string, std::string> decisions;
+  return decisions;
+}
+
+//! The lock of the cached decisions.
+std::mutex& DecisionsMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+//! The exponent of the smallest power of two that is at least the given size.
+size_t Log2Ceil(const size_t size)
+{
+  size_t exponent = 0;
+  while (exponent < 63 && (size_t(1) << exponent) < size)
+    ++exponent;
+  return exponent;
+}
+
+} // namespace
+
+std::string Autotune::Key(const std::string& method,
+                          const size_t points,
+                          const size_t dimensionality,
+                          const size_t k)
+{
+  std::ostringstream key;
+  key << method << ":n=2^" << Log2Ceil(points) << ":d=2^"
+      << Log2Ceil(dimensionality);
+  if (k > 0)
+    key << ":k=2^" << Log2Ceil(k);
+  key << ":threads=" << Threads::Get();
+  return key.str();
+}
+
+bool Autotune::Lookup(const std::string& key, std::string& choice)
+{
+  std::lock_guard<std::mutex> lock(DecisionsMutex());
+  std::map<std::string, std::string>::const_iterator it =
+      Decisions().find(key);
+  if (it == Decisions().end())
+    return false;
+
+  choice = it->second;
+  return true;
+}
+
+void Autotune::Store(const std::string& key, const std::string& choice)
+{
+  std::lock_guard<std::mutex> lock(DecisionsMutex());
+  Decisions()[key] = choice;
+}
+
+void Autotune::Clear()
+{
+  std::lock_guard<std::mutex> lock(DecisionsMutex());
+  Decisions().clear();
+}
+
+void Autotune::Load(const std::string& filename)
+{
+  std::ifstream stream(filename);
+  if (!stream)
+    return;
+
+  std::lock_guard<std::mutex> lock(DecisionsMutex());
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    std::istringstream fields(line);
+    std::string key, choice;
+    if (fields >> key >> choice)
+      Decisions()[key] = choice;
+  }
+}
+
+void Autotune::Save(const std::string& filename)
+{
+  std::ofstream stream(filename);
+  if (!stream)
+  {
+    throw std::runtime_error("Autotune::Save(): cannot open '" + filename +
+        "' for writing");
+  }
+
+  std::lock_guard<std::mutex> lock(DecisionsMutex());
+  std::map<std::string, std::string>::const_iterator it;
+  for (it = Decisions().begin(); it != Decisions().end(); ++it)
+    stream << it->first << ' ' << it->second << '\n';
+
+  if (!stream)
+  {
+    throw std::runtime_error("Autotune::Save(): cannot write '" + filename +
+        "'");
+  }
+}
@@ -0,0 +1,167 @@
+/**
+ * @file autotune.hpp
+ *
+ * Selection of the fastest of several variants of a method by timing them on
+ * a sample of the data, with a cache of the decisions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_AUTOTUNE_HPP
+#define MLPACK_CORE_UTIL_AUTOTUNE_HPP
+
+#include <mlpack/core/util/log.hpp>
+#include <mlpack/core/util/profiler.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mlpack {
+
+/**
+ * The Autotune class picks the fastest of several candidate variants of a
+ * method (for instance the Lloyd step types of k-means, or the trees of
+ * nearest neighbor search) by running each of them on a sample of the dataset
+ * and timing it.  The decisions are cached by a key that describes the
+ * problem, so that problems of about the same shape are only timed once:
+ *
+ * @code
+ * const std::string key = Autotune::Key("kmeans", data.n_cols, data.n_rows,
+ *     clusters);
+ * std::string choice;
+ * if (!Autotune::Lookup(key, choice))
+ * {
+ *   choice = Autotune::Fastest({ "naive", "hamerly" },
+ *       [&](const std::string& candidate) { ... });
+ *   Autotune::Store(key, choice);
+ * }
+ * @endcode
+ *
+ * The cache is kept in memory for the life of the process, and can be saved
+ * to and loaded from a text file, with one "key choice" line per decision.
+ * The command-line programs do that with their 'autotune_cache' option.  All
+ * the functions are thread-safe.
+ */
+class Autotune
+{
+ public:
+  /**
+   * Get the cache key of a problem.  The sizes are rounded up to powers of
+   * two, and the number of threads is part of the key, since it changes which
+   * variant is fastest.
+   *
+   * @param method Name of the method and of what is being chosen.
+   * @param points Number of points in the dataset.
+   * @param dimensionality Dimensionality of the dataset.
+   * @param k Another size of the problem (clusters, neighbors); 0 if none.
+   */
+  static std::string Key(const std::string& method,
+                         const size_t points,
+                         const size_t dimensionality,
+                         const size_t k = 0);
+
+  /**
+   * Look up a decision in the cache.
+   *
+   * @param key Key of the problem, from Key().
+   * @param choice Set to the cached choice, if there is one.
+   * @return Whether the cache holds a decision for the key.
+   */
+  static bool Lookup(const std::string& key, std::string& choice);
+
+  //! Store a decision in the cache, replacing any earlier one for the key.
+  static void Store(const std::string& key, const std::string& choice);
+
+  //! Remove all the decisions from the cache.
+  static void Clear();
+
+  /**
+   * Add the decisions saved in the given file to the cache.  A file that does
+   * not exist yet is not an error.
+   *
+   * @param filename File written by Save().
+   */
+  static void Load(const std::string& filename);
+
+  /**
+   * Save all the decisions of the cache to the given file.
+   *
+   * @param filename File to write.
+   * @throw std::runtime_error if the file cannot be written.
+   */
+  static void Save(const std::string& filename);
+
+  /**
+   * Get the shortest time of the given number of runs of a function, in
+   * seconds.
+   *
+   * @param function Function to time.
+   * @param repetitions Number of runs.
+   */
+  template<typename FunctionType>
+  static double Time(FunctionType&& function, const size_t repetitions = 1)
+  {
+    double best = std::numeric_limits<double>::max();
+    for (size_t r = 0; r < std::max(repetitions, (size_t) 1); ++r)
+    {
+      const Profiler::Clock::time_point start = Profiler::Clock::now();
+      function();
+      const double seconds = std::chrono::duration<double>(
+          Profiler::Clock::now() - start).count();
+      best = std::min(best, seconds);
+    }
+    return best;
+  }
+
+  /**
+   * Time each of the candidates and return the fastest.  A candidate that
+   * throws a std::exception is reported and skipped.
+   *
+   * @param candidates Names of the candidates.
+   * @param run Function that runs the candidate with the given name.
+   * @param repetitions Number of runs of each candidate.
+   * @throw std::runtime_error if every candidate failed.
+   */
+  template<typename FunctionType>
+  static std::string Fastest(const std::vector<std::string>& candidates,
+                             FunctionType&& run,
+                             const size_t repetitions = 1)
+  {
+    std::string fastest;
+    double bestTime = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      try
+      {
+        const std::string& candidate = candidates[i];
+        const double time = Time([&]() { run(candidate); }, repetitions);
+        Log::Info << "Autotuning: '" << candidate << "' took " << time
+            << "s." << std::endl;
+        if (time < bestTime)
+        {
+          bestTime = time;
+          fastest = candidate;
+        }
+      }
+      catch (const std::exception& e)
+      {
+        Log::Warn << "Autotuning: '" << candidates[i] << "' failed: "
+            << e.what() << std::endl;
+      }
+    }
+
+    if (fastest.empty())
+      throw std::runtime_error("Autotune::Fastest(): no candidate succeeded");
+
+    return fastest;
+  }
+};
+
+} // namespace mlpack
+
+#endif
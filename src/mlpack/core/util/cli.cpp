@@ -118,13 +118,50 @@ bool CLI::HasParam(const std::string& key)
   return (parameters.at(checkKey).wasPassed > 0);
 }
 
-// Returns the sole instance of this class.
+std::mutex CLI::storageMutex;
+
+// Returns the instance of the calling thread, or else the process-wide one.
 CLI& CLI::GetSingleton()
+{
+  std::unique_ptr<CLI>& threadInstance = GetThreadInstance();
+  return threadInstance ? *threadInstance : GetGlobalInstance();
+}
+
+// Returns the process-wide instance of this class.
+CLI& CLI::GetGlobalInstance()
 {
   static CLI singleton;
   return singleton;
 }
 
+// Returns the instance of the calling thread, which is empty by default.
+std::unique_ptr<CLI>& CLI::GetThreadInstance()
+{
+  thread_local std::unique_ptr<CLI> threadInstance;
+  return threadInstance;
+}
+
+// Give the calling thread its own instance.
+void CLI::UseThreadLocalInstance()
+{
+  std::unique_ptr<CLI>& threadInstance = GetThreadInstance();
+  if (threadInstance)
+    return;
+
+  CLI* instance = new CLI();
+  {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    CLI& global = GetGlobalInstance();
+    instance->parameters = global.parameters;
+    instance->aliases = global.aliases;
+    instance->functionMap = global.functionMap;
+    instance->doc = global.doc;
+  }
+  instance->timer.Enabled() = GetGlobalInstance().timer.Enabled().load();
+
+  threadInstance.reset(instance);
+}
+
 /**
  * Registers a ProgramDoc object, which contains documentation about the
  * program.
@@ -174,10 +211,14 @@ void CLI::SetPassed(const std::string& name)
 void CLI::StoreSettings(const std::string& name)
 {
   // Take all of the parameters and put them in the map.  Clear anything old
-  // first.
-  std::get<0>(GetSingleton().storageMap[name]) = GetSingleton().parameters;
-  std::get<1>(GetSingleton().storageMap[name]) = GetSingleton().aliases;
-  std::get<2>(GetSingleton().storageMap[name]) = GetSingleton().functionMap;
+  // first.  The stored settings are shared by all threads.
+  {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    auto& storage = GetGlobalInstance().storageMap[name];
+    std::get<0>(storage) = GetSingleton().parameters;
+    std::get<1>(storage) = GetSingleton().aliases;
+    std::get<2>(storage) = GetSingleton().functionMap;
+  }
 
   ClearSettings();
 }
@@ -185,21 +226,25 @@ void CLI::StoreSettings(const std::string& name)
 // Restore settings.
 void CLI::RestoreSettings(const std::string& name, const bool fatal)
 {
-  if (GetSingleton().storageMap.count(name) == 0 && fatal)
+  std::unique_lock<std::mutex> lock(storageMutex);
+  CLI& global = GetGlobalInstance();
+  if (global.storageMap.count(name) == 0 && fatal)
   {
     throw std::invalid_argument("no settings stored under the name '" + name
         + "'");
   }
-  else if (GetSingleton().storageMap.count(name) == 0 && !fatal)
+  else if (global.storageMap.count(name) == 0 && !fatal)
   {
     // Nothing to do, just clear what's there.
+    lock.unlock();
     ClearSettings();
   }
   else
   {
-    GetSingleton().parameters = std::get<0>(GetSingleton().storageMap[name]);
-    GetSingleton().aliases = std::get<1>(GetSingleton().storageMap[name]);
-    GetSingleton().functionMap = std::get<2>(GetSingleton().storageMap[name]);
+    const auto& storage = global.storageMap.at(name);
+    GetSingleton().parameters = std::get<0>(storage);
+    GetSingleton().aliases = std::get<1>(storage);
+    GetSingleton().functionMap = std::get<2>(storage);
   }
 }
 
@@ -17,6 +17,8 @@
 #include <list>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include <boost/any.hpp>
@@ -226,6 +228,20 @@ class CLI
    */
   static CLI& GetSingleton();
 
+  /**
+   * Give the calling thread its own instance of CLI from now on, so that the
+   * parameters, function mappings and timers of this thread are no longer
+   * shared with the other threads.  The instance starts with a copy of the
+   * current settings of the process-wide instance.  Settings stored with
+   * StoreSettings() and the ProgramDoc stay shared by all threads, so any
+   * thread can restore the settings of any program.  Calling this again on
+   * the same thread does nothing.
+   *
+   * This is used by the Python bindings, so that several Python threads can
+   * run mlpack methods at the same time.
+   */
+  static void UseThreadLocalInstance();
+
   /**
    * Registers a ProgramDoc object, which contains documentation about the
    * program.  If this method has been called before (that is, if two
@@ -294,6 +310,15 @@ class CLI
   std::map<std::string, std::tuple<std::map<std::string, util::ParamData>,
       std::map<char, std::string>, FunctionMapType>> storageMap;
 
+  //! The mutex that guards the storage map of the process-wide instance.
+  static std::mutex storageMutex;
+
+  //! Return the process-wide instance, which holds the storage map.
+  static CLI& GetGlobalInstance();
+
+  //! Return the instance of the calling thread, if it has one.
+  static std::unique_ptr<CLI>& GetThreadInstance();
+
  public:
   //! True, if CLI was used to parse command line options.
   bool didParse;
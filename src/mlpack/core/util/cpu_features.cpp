@@ -0,0 +1,53 @@
+/**
+ * @file cpu_features.cpp
+ *
+ * Implementation of the detection of the instruction sets of the processor.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "cpu_features.hpp"
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+ISALevel mlpack::util::DetectISALevel()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return ISALevel::AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return ISALevel::AVX2;
+  if (__builtin_cpu_supports("sse4.2"))
+    return ISALevel::SSE42;
+#endif
+
+  return ISALevel::GENERIC;
+}
+
+ISALevel mlpack::util::ActiveISALevel()
+{
+#ifdef MLPACK_HAS_ISA_VARIANTS
+  return DetectISALevel();
+#else
+  return ISALevel::GENERIC;
+#endif
+}
+
+std::string mlpack::util::ISALevelName(const ISALevel level)
+{
+  switch (level)
+  {
+    case ISALevel::SSE42:
+      return "SSE4.2";
+    case ISALevel::AVX2:
+      return "AVX2";
+    case ISALevel::AVX512:
+      return "AVX-512";
+    default:
+      return "generic";
+  }
+}
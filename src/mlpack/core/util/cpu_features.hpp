@@ -0,0 +1,62 @@
+/**
+ * @file cpu_features.hpp
+ *
+ * Detection of the instruction sets of the processor, and the macro that
+ * compiles a function for several of them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_CPU_FEATURES_HPP
+#define MLPACK_CORE_UTIL_CPU_FEATURES_HPP
+
+#include <string>
+
+/**
+ * MLPACK_TARGET_CLONES, before the definition of a (non-template) function in
+ * a source file of the library, compiles the function for AVX-512, AVX2 and
+ * SSE4.2 as well as for the default instruction set; the version to use is
+ * chosen when the library is loaded.  It is empty unless the library is built
+ * with BUILD_ISA_VARIANTS and the compiler supports it.
+ */
+#ifdef MLPACK_HAS_ISA_VARIANTS
+  #define MLPACK_TARGET_CLONES \
+      __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#else
+  #define MLPACK_TARGET_CLONES
+#endif
+
+namespace mlpack {
+namespace util {
+
+//! The instruction sets that the kernels of mlpack are compiled for.
+enum class ISALevel
+{
+  GENERIC = 0,
+  SSE42 = 1,
+  AVX2 = 2,
+  AVX512 = 3
+};
+
+/**
+ * Get the best instruction set that the processor supports, of those the
+ * kernels of mlpack are compiled for.
+ */
+ISALevel DetectISALevel();
+
+/**
+ * Get the instruction set that the kernels of mlpack use on this processor:
+ * the detected one if the library was compiled with several versions of the
+ * kernels, and ISALevel::GENERIC otherwise.
+ */
+ISALevel ActiveISALevel();
+
+//! Get the name of an instruction set ("generic", "SSE4.2", "AVX2", "AVX-512").
+std::string ISALevelName(const ISALevel level);
+
+} // namespace util
+} // namespace mlpack
+
+#endif
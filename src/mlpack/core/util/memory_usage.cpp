@@ -0,0 +1,178 @@
+/**
+ * @file memory_usage.cpp
+ *
+ * Implementation of the MemoryTracker and of the Armadillo allocation hook.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "memory_usage.hpp"
+#include <mlpack/core/arma_extend/alloc_hook.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <sys/resource.h>
+  #include <unistd.h>
+#endif
+
+using namespace mlpack;
+using namespace std;
+
+namespace {
+
+//! The counters of the Armadillo allocations.
+atomic<size_t> allocations(0);
+atomic<size_t> bytesAllocated(0);
+atomic<size_t> bytesInUse(0);
+atomic<size_t> peakBytesInUse(0);
+
+//! Alignment of the memory given to Armadillo (the largest it relies on).
+const size_t alignment = 32;
+//! Room before the aligned memory for the original pointer and the size.
+const size_t headerSize = sizeof(void*) + sizeof(size_t);
+
+} // namespace
+
+namespace mlpack {
+namespace util {
+
+void* ArmaAllocate(const size_t bytes)
+{
+  char* raw = (char*) malloc(bytes + headerSize + alignment);
+  if (raw == NULL)
+    return NULL;
+
+  // Align the memory after the header, and store the original pointer and the
+  // size just before it.
+  const uintptr_t start = (uintptr_t) (raw + headerSize);
+  char* memory = (char*) ((start + alignment - 1) & ~(uintptr_t)
+      (alignment - 1));
+  ((size_t*) memory)[-1] = bytes;
+  ((void**) (memory - sizeof(size_t)))[-1] = raw;
+
+  ++allocations;
+  bytesAllocated += bytes;
+  const size_t inUse = (bytesInUse += bytes);
+  size_t peak = peakBytesInUse.load(memory_order_relaxed);
+  while (inUse > peak && !peakBytesInUse.compare_exchange_weak(peak, inUse))
+    { }
+
+  return memory;
+}
+
+void ArmaFree(void* memory)
+{
+  if (memory == NULL)
+    return;
+
+  char* m = (char*) memory;
+  bytesInUse -= ((size_t*) m)[-1];
+  free(((void**) (m - sizeof(size_t)))[-1]);
+}
+
+} // namespace util
+} // namespace mlpack
+
+bool MemoryTracker::TracksAllocations()
+{
+#ifdef MLPACK_TRACK_ARMA_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+size_t MemoryTracker::Allocations()
+{
+  return allocations.load();
+}
+
+size_t MemoryTracker::BytesAllocated()
+{
+  return bytesAllocated.load();
+}
+
+size_t MemoryTracker::BytesInUse()
+{
+  return bytesInUse.load();
+}
+
+size_t MemoryTracker::PeakBytesInUse()
+{
+  return peakBytesInUse.load();
+}
+
+size_t MemoryTracker::CurrentRSS()
+{
+#if defined(__linux__)
+  // The second field of statm is the resident set size, in pages.
+  FILE* f = fopen("/proc/self/statm", "r");
+  if (f == NULL)
+    return 0;
+
+  unsigned long size = 0, resident = 0;
+  const int fields = fscanf(f, "%lu %lu", &size, &resident);
+  fclose(f);
+  return (fields == 2) ? (size_t) resident * (size_t) sysconf(_SC_PAGESIZE) :
+      0;
+#else
+  return 0;
+#endif
+}
+
+size_t MemoryTracker::PeakRSS()
+{
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+  #if defined(__APPLE__)
+    // macOS gives the size in bytes...
+    return (size_t) usage.ru_maxrss;
+  #else
+    // ...and the others in kilobytes.
+    return (size_t) usage.ru_maxrss * 1024;
+  #endif
+#else
+  return 0;
+#endif
+}
+
+MemoryUsage MemoryTracker::Current()
+{
+  MemoryUsage usage;
+  usage.allocations = Allocations();
+  usage.bytesAllocated = BytesAllocated();
+  usage.peakRSS = PeakRSS();
+  return usage;
+}
+
+void MemoryTracker::PrintBytes(ostream& stream, const size_t bytes)
+{
+  const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+  double value = (double) bytes;
+  size_t unit = 0;
+  while (value >= 1024.0 && unit < 4)
+  {
+    value /= 1024.0;
+    ++unit;
+  }
+
+  const ios::fmtflags flags = stream.flags();
+  const streamsize precision = stream.precision();
+  if (unit == 0)
+    stream << bytes << " B";
+  else
+    stream << fixed << setprecision(1) << value << " " << units[unit];
+  stream.flags(flags);
+  stream.precision(precision);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file memory_usage.hpp
+ *
+ * Accounting of the memory used by mlpack programs: the resident set size of
+ * the process and, if mlpack is compiled with MLPACK_TRACK_ARMA_ALLOCATIONS,
+ * the number and size of the allocations of Armadillo objects.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_MEMORY_USAGE_HPP
+#define MLPACK_CORE_UTIL_MEMORY_USAGE_HPP
+
+#include <cstddef>
+#include <ostream>
+
+namespace mlpack {
+
+/**
+ * The memory used during a named phase (a timer) of an mlpack program.  The
+ * allocations are those of Armadillo objects, made by any thread while the
+ * timer was running; they are only counted if
+ * MemoryTracker::TracksAllocations() is true.
+ */
+struct MemoryUsage
+{
+  //! Number of Armadillo allocations.
+  size_t allocations;
+  //! Number of bytes allocated for Armadillo objects.
+  size_t bytesAllocated;
+  //! Peak resident set size of the process when the timer was last stopped,
+  //! in bytes (0 if unknown on this platform).
+  size_t peakRSS;
+
+  MemoryUsage() : allocations(0), bytesAllocated(0), peakRSS(0) { }
+};
+
+/**
+ * The MemoryTracker gives the memory statistics of the process.  The resident
+ * set size is obtained from the operating system (on Linux and macOS).  The
+ * allocation counts are maintained by the allocation hook of arma_extend when
+ * mlpack is compiled with -DMLPACK_TRACK_ARMA_ALLOCATIONS (the CMake option
+ * TRACK_ARMA_ALLOCATIONS); otherwise they are always zero.  The counters are
+ * atomic and shared by all threads.
+ *
+ * The Timer records the memory used while each timer runs, and the memory
+ * usage is printed next to the timers with --verbose.
+ */
+class MemoryTracker
+{
+ public:
+  //! Return whether the allocations of Armadillo objects are counted.
+  static bool TracksAllocations();
+
+  //! Get the number of allocations of Armadillo objects so far.
+  static size_t Allocations();
+  //! Get the total number of bytes allocated for Armadillo objects so far.
+  static size_t BytesAllocated();
+  //! Get the number of bytes of Armadillo objects currently allocated.
+  static size_t BytesInUse();
+  //! Get the largest number of bytes of Armadillo objects allocated at once.
+  static size_t PeakBytesInUse();
+
+  //! Get the current resident set size of the process, in bytes (0 if
+  //! unknown).
+  static size_t CurrentRSS();
+  //! Get the peak resident set size of the process, in bytes (0 if unknown).
+  static size_t PeakRSS();
+
+  //! Get the current allocation counters and peak resident set size.
+  static MemoryUsage Current();
+
+  /**
+   * Print the given number of bytes in a human-readable unit (B, KiB, MiB,
+   * GiB).
+   *
+   * @param stream Stream to print to.
+   * @param bytes Number of bytes to print.
+   */
+  static void PrintBytes(std::ostream& stream, const size_t bytes);
+};
+
+} // namespace mlpack
+
+#endif
@@ -50,6 +50,7 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 static void mlpackMain(); // This is typically defined after this include.
 
@@ -60,6 +61,13 @@ int main(int argc, char** argv)
   // Enable timing.
   mlpack::Timer::EnableTiming();
 
+  // With --serve, run the program once for each request instead.
+  if (mlpack::CLI::HasParam("serve"))
+  {
+    mlpack::bindings::cli::Serve(mlpackMain, std::cin, std::cout);
+    return 0;
+  }
+
   // A "total_time" timer is run by default for each mlpack program.
   mlpack::Timer::Start("total_time");
 
@@ -143,6 +151,9 @@ PARAM_FLAG("copy_all_inputs", "If specified, all input parameters will be deep"
     " copied before the method is run.  This is useful for debugging problems "
     "where the input parameters are being modified by the algorithm, but can "
     "slow down the code.", "");
+PARAM_INT_IN("threads", "Number of threads used by mlpack and the BLAS library "
+    "(if 0, the OpenMP default is used: OMP_NUM_THREADS, or the number of "
+    "processors).", "", 0);
 
 // Nothing else needs to be defined---the binding will use mlpackMain() as-is.
 
@@ -0,0 +1,303 @@
+/**
+ * @file profiler.cpp
+ *
+ * Implementation of the Profiler.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "profiler.hpp"
+
+#include <cstdio>
+#include <iomanip>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace mlpack;
+using namespace std;
+using namespace chrono;
+
+namespace {
+
+//! A scope recorded while tracing.
+struct TraceEvent
+{
+  //! Id of the scope.
+  size_t id;
+  //! Start of the scope, in nanoseconds since the epoch of the profiler.
+  int64_t start;
+  //! Duration of the scope, in nanoseconds.
+  int64_t duration;
+};
+
+//! The results of one thread.  Only that thread writes to them.
+struct ThreadProfile
+{
+  //! The results, indexed by id.
+  vector<ProfileSummary> results;
+  //! The trace events, if tracing is enabled.
+  vector<TraceEvent> events;
+  //! The number of events that did not fit in the buffer.
+  size_t droppedEvents;
+  //! Index of the thread in the trace.
+  size_t threadIndex;
+};
+
+//! The state shared by all threads.
+struct ProfilerState
+{
+  ProfilerState() :
+      tracing(false),
+      maxEvents(0),
+      epoch(Profiler::Clock::now())
+  { }
+
+  //! Lock for everything but the results of the threads.
+  mutex lock;
+  //! The registered names, indexed by id.
+  vector<string> names;
+  //! The id of each registered name.
+  unordered_map<string, size_t> ids;
+  //! The results of every thread that recorded something.  A list keeps the
+  //! addresses stable as threads are added.
+  list<ThreadProfile> threads;
+  //! Whether scopes are recorded as trace events.
+  atomic<bool> tracing;
+  //! Maximum number of trace events per thread.
+  size_t maxEvents;
+  //! Origin of the trace timestamps.
+  Profiler::Clock::time_point epoch;
+};
+
+ProfilerState& State()
+{
+  static ProfilerState state;
+  return state;
+}
+
+//! The results of the calling thread, or NULL before it records anything.
+thread_local ThreadProfile* localProfile = NULL;
+
+//! Get the results of the calling thread, creating them if needed.
+ThreadProfile& LocalProfile()
+{
+  if (!localProfile)
+  {
+    ProfilerState& state = State();
+    lock_guard<mutex> guard(state.lock);
+    state.threads.push_back(ThreadProfile());
+    localProfile = &state.threads.back();
+    localProfile->droppedEvents = 0;
+    localProfile->threadIndex = state.threads.size() - 1;
+  }
+
+  return *localProfile;
+}
+
+//! Get the result with the given id of the calling thread.
+ProfileSummary& LocalResult(const size_t id)
+{
+  ThreadProfile& profile = LocalProfile();
+  if (id >= profile.results.size())
+    profile.results.resize(id + 1);
+
+  return profile.results[id];
+}
+
+//! Write the given string as a JSON string.
+void WriteJSONString(ostream& stream, const string& s)
+{
+  stream << '"';
+  for (const char c : s)
+  {
+    if (c == '"' || c == '\\')
+      stream << '\\' << c;
+    else if ((unsigned char) c < 0x20)
+    {
+      char escaped[7];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", (int) c);
+      stream << escaped;
+    }
+    else
+      stream << c;
+  }
+  stream << '"';
+}
+
+} // namespace
+
+atomic<bool> Profiler::enabled(false);
+thread_local ProfileScope* ProfileScope::current = NULL;
+
+size_t Profiler::Register(const string& name)
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> guard(state.lock);
+
+  unordered_map<string, size_t>::const_iterator it = state.ids.find(name);
+  if (it != state.ids.end())
+    return it->second;
+
+  const size_t id = state.names.size();
+  state.names.push_back(name);
+  state.ids[name] = id;
+  return id;
+}
+
+void Profiler::EnableTracing(const size_t maxEvents)
+{
+  ProfilerState& state = State();
+  {
+    lock_guard<mutex> guard(state.lock);
+    state.maxEvents = maxEvents;
+  }
+  state.tracing = true;
+  Enable();
+}
+
+void Profiler::DisableTracing()
+{
+  State().tracing = false;
+}
+
+void Profiler::Reset()
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> guard(state.lock);
+  for (ThreadProfile& profile : state.threads)
+  {
+    profile.results.clear();
+    profile.events.clear();
+    profile.droppedEvents = 0;
+  }
+  state.epoch = Clock::now();
+}
+
+map<string, ProfileSummary> Profiler::Summary()
+{
+  ProfilerState& state = State();
+  lock_guard<mutex> guard(state.lock);
+
+  map<string, ProfileSummary> summary;
+  for (const ThreadProfile& profile : state.threads)
+  {
+    for (size_t id = 0; id < profile.results.size(); ++id)
+    {
+      const ProfileSummary& r = profile.results[id];
+      if (r.calls == 0 && r.count == 0)
+        continue;
+
+      ProfileSummary& s = summary[state.names[id]];
+      s.calls += r.calls;
+      s.totalTime += r.totalTime;
+      s.selfTime += r.selfTime;
+      s.count += r.count;
+    }
+  }
+
+  return summary;
+}
+
+void Profiler::WriteSummary(ostream& stream)
+{
+  const map<string, ProfileSummary> summary = Summary();
+
+  stream << "name\tcalls\ttotal_us\tself_us\tcount\n";
+  for (const pair<const string, ProfileSummary>& s : summary)
+  {
+    stream << s.first << '\t' << s.second.calls << '\t'
+        << (s.second.totalTime / 1000) << '\t' << (s.second.selfTime / 1000)
+        << '\t' << s.second.count << '\n';
+  }
+}
+
+void Profiler::WriteChromeTrace(ostream& stream)
+{
+  const map<string, ProfileSummary> summary = Summary();
+
+  ProfilerState& state = State();
+  lock_guard<mutex> guard(state.lock);
+
+  // The timestamps of the format are in microseconds.
+  const ios::fmtflags flags = stream.flags();
+  const streamsize precision = stream.precision();
+  stream << fixed << setprecision(3);
+
+  stream << "{\"traceEvents\":[";
+  bool first = true;
+  int64_t lastTime = 0;
+  size_t droppedEvents = 0;
+  for (const ThreadProfile& profile : state.threads)
+  {
+    droppedEvents += profile.droppedEvents;
+    for (const TraceEvent& e : profile.events)
+    {
+      stream << (first ? "\n" : ",\n") << "{\"name\":";
+      WriteJSONString(stream, state.names[e.id]);
+      stream << ",\"cat\":\"mlpack\",\"ph\":\"X\",\"ts\":" << (e.start / 1e3)
+          << ",\"dur\":" << (e.duration / 1e3) << ",\"pid\":0,\"tid\":"
+          << profile.threadIndex << "}";
+      first = false;
+      lastTime = max(lastTime, e.start + e.duration);
+    }
+  }
+
+  // The counters are written as their final values.
+  for (const pair<const string, ProfileSummary>& s : summary)
+  {
+    if (s.second.count == 0)
+      continue;
+
+    stream << (first ? "\n" : ",\n") << "{\"name\":";
+    WriteJSONString(stream, s.first);
+    stream << ",\"cat\":\"mlpack\",\"ph\":\"C\",\"ts\":" << (lastTime / 1e3)
+        << ",\"pid\":0,\"tid\":0,\"args\":{\"value\":" << s.second.count
+        << "}}";
+    first = false;
+  }
+
+  stream << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":"
+      << droppedEvents << "}}\n";
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+void Profiler::Record(const size_t id,
+                      const Clock::time_point& start,
+                      const Clock::time_point& end,
+                      const uint64_t childTime)
+{
+  const uint64_t elapsed = duration_cast<nanoseconds>(end - start).count();
+
+  ThreadProfile& profile = LocalProfile();
+  ProfileSummary& r = LocalResult(id);
+  ++r.calls;
+  r.totalTime += elapsed;
+  r.selfTime += elapsed - childTime;
+
+  ProfilerState& state = State();
+  if (state.tracing)
+  {
+    if (profile.events.size() < state.maxEvents)
+    {
+      TraceEvent e;
+      e.id = id;
+      e.start = duration_cast<nanoseconds>(start - state.epoch).count();
+      e.duration = elapsed;
+      profile.events.push_back(e);
+    }
+    else
+    {
+      ++profile.droppedEvents;
+    }
+  }
+}
+
+void Profiler::AddCount(const size_t id, const uint64_t value)
+{
+  LocalResult(id).count += value;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file profiler.hpp
+ *
+ * A low-overhead profiler for the inner parts of mlpack methods: nested timed
+ * scopes and counters, accumulated per thread and identified by integer ids
+ * that are registered once per call site.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PROFILER_HPP
+#define MLPACK_CORE_UTIL_PROFILER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace mlpack {
+
+/**
+ * The accumulated results of one profiled scope or counter, summed over all
+ * threads.
+ */
+struct ProfileSummary
+{
+  //! Number of times the scope was entered.
+  size_t calls;
+  //! Total time spent in the scope, in nanoseconds.
+  uint64_t totalTime;
+  //! Time spent in the scope but not in the scopes nested in it, in
+  //! nanoseconds.
+  uint64_t selfTime;
+  //! Sum of the values passed to the counter.
+  uint64_t count;
+
+  ProfileSummary() : calls(0), totalTime(0), selfTime(0), count(0) { }
+};
+
+/**
+ * The Profiler collects the time spent in the scopes marked with
+ * MLPACK_PROFILE_SCOPE() and the values of the counters incremented with
+ * MLPACK_PROFILE_COUNT().  Unlike Timer, which looks up a named timer in a
+ * shared map under a lock on every call, each call site looks up the id of its
+ * name once, and the results are accumulated in arrays local to the calling
+ * thread; when profiling is disabled (the default), a scope or a counter costs
+ * one relaxed atomic load.  This makes it cheap enough to use inside tree
+ * traversals and optimizer steps.  For example:
+ *
+ * @code
+ * Profiler::Enable();
+ * {
+ *   MLPACK_PROFILE_SCOPE("knn/search");
+ *   // ...
+ *   MLPACK_PROFILE_COUNT("knn/base_cases", baseCases);
+ * }
+ * Profiler::WriteSummary(std::cout);
+ * @endcode
+ *
+ * Nested scopes are accounted both in the total time of each scope and in the
+ * self time, which excludes the nested scopes.  If tracing is enabled, every
+ * scope is also recorded as an event, and the events can be written in the
+ * Chrome trace format (chrome://tracing, Perfetto).
+ *
+ * The results must only be read or reset while no profiled code is running.
+ * Defining MLPACK_NO_PROFILING before including mlpack compiles the macros
+ * away.
+ */
+class Profiler
+{
+ public:
+  //! The clock used for all the measurements.
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * Get the id of the scope or counter with the given name, registering it if
+   * it has not been seen yet.  This takes a lock, so call sites should store
+   * the id (the macros keep it in a static variable).
+   *
+   * @param name Name of the scope or counter.
+   */
+  static size_t Register(const std::string& name);
+
+  //! Start collecting results.
+  static void Enable() { enabled.store(true, std::memory_order_relaxed); }
+  //! Stop collecting results; the results so far are kept.
+  static void Disable() { enabled.store(false, std::memory_order_relaxed); }
+  //! Get whether results are being collected.
+  static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+  /**
+   * Record every scope as a trace event too, keeping at most the given number
+   * of events per thread; later events are dropped.  This also enables
+   * profiling.
+   *
+   * @param maxEvents Maximum number of events recorded by each thread.
+   */
+  static void EnableTracing(const size_t maxEvents = 1000000);
+  //! Stop recording trace events; the events so far are kept.
+  static void DisableTracing();
+
+  /**
+   * Add the given value to a counter.  Use MLPACK_PROFILE_COUNT() instead of
+   * calling this directly.
+   *
+   * @param id Id of the counter, from Register().
+   * @param value Value to add.
+   */
+  static void Count(const size_t id, const uint64_t value)
+  {
+    if (Enabled())
+      AddCount(id, value);
+  }
+
+  //! Remove all results and trace events.  Registered ids stay valid.
+  static void Reset();
+
+  //! Get the results of every scope and counter that was used, by name.
+  static std::map<std::string, ProfileSummary> Summary();
+
+  /**
+   * Write the results as tab-separated lines, one per scope or counter: the
+   * name, the number of calls, the total and self times in microseconds, and
+   * the counter value.  The first line holds the column names.
+   */
+  static void WriteSummary(std::ostream& stream);
+
+  /**
+   * Write the trace events, and the final values of the counters, as a Chrome
+   * trace JSON document.
+   */
+  static void WriteChromeTrace(std::ostream& stream);
+
+ private:
+  friend class ProfileScope;
+
+  //! Record the end of a scope of the calling thread.
+  static void Record(const size_t id,
+                     const Clock::time_point& start,
+                     const Clock::time_point& end,
+                     const uint64_t childTime);
+
+  //! Add to a counter of the calling thread.
+  static void AddCount(const size_t id, const uint64_t value);
+
+  //! Whether results are being collected.
+  static std::atomic<bool> enabled;
+};
+
+/**
+ * A timed scope: the time between the construction and the destruction of the
+ * object is accounted to the scope id.  If profiling was disabled when the
+ * object was constructed, nothing is recorded.  Use MLPACK_PROFILE_SCOPE()
+ * instead of constructing this directly.
+ */
+class ProfileScope
+{
+ public:
+  //! Enter the scope with the given id.
+  explicit ProfileScope(const size_t id) :
+      id(id),
+      active(Profiler::Enabled()),
+      childTime(0),
+      parent(NULL)
+  {
+    if (active)
+    {
+      parent = current;
+      current = this;
+      start = Profiler::Clock::now();
+    }
+  }
+
+  //! Leave the scope.
+  ~ProfileScope()
+  {
+    if (active)
+    {
+      const Profiler::Clock::time_point end = Profiler::Clock::now();
+      const uint64_t elapsed = std::chrono::duration_cast<
+          std::chrono::nanoseconds>(end - start).count();
+      Profiler::Record(id, start, end, std::min(childTime, elapsed));
+
+      current = parent;
+      if (parent)
+        parent->childTime += elapsed;
+    }
+  }
+
+  // The scope must not be copied.
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+ private:
+  //! Id of the scope.
+  size_t id;
+  //! Whether profiling was enabled when the scope was entered.
+  bool active;
+  //! Time spent in the scopes nested in this one, in nanoseconds.
+  uint64_t childTime;
+  //! The enclosing scope of the same thread, or NULL.
+  ProfileScope* parent;
+  //! The time the scope was entered.
+  Profiler::Clock::time_point start;
+
+  //! The innermost active scope of each thread.
+  static thread_local ProfileScope* current;
+};
+
+} // namespace mlpack
+
+#define MLPACK_PROFILE_CONCAT_INNER(a, b) a ## b
+#define MLPACK_PROFILE_CONCAT(a, b) MLPACK_PROFILE_CONCAT_INNER(a, b)
+
+#ifndef MLPACK_NO_PROFILING
+
+/**
+ * Time the rest of the enclosing block as the scope with the given name.  The
+ * name is registered the first time the line is run.
+ */
+#define MLPACK_PROFILE_SCOPE(name) \
+    static const size_t MLPACK_PROFILE_CONCAT(mlpackProfileId, __LINE__) = \
+        ::mlpack::Profiler::Register(name); \
+    ::mlpack::ProfileScope MLPACK_PROFILE_CONCAT(mlpackProfileScope, \
+        __LINE__)(MLPACK_PROFILE_CONCAT(mlpackProfileId, __LINE__))
+
+/**
+ * Add the given value to the counter with the given name.  The name is
+ * registered the first time the line is run.
+ */
+#define MLPACK_PROFILE_COUNT(name, value) \
+    do \
+    { \
+      static const size_t mlpackProfileCounterId = \
+          ::mlpack::Profiler::Register(name); \
+      ::mlpack::Profiler::Count(mlpackProfileCounterId, (value)); \
+    } while (false)
+
+#else
+
+#define MLPACK_PROFILE_SCOPE(name)
+#define MLPACK_PROFILE_COUNT(name, value) do { } while (false)
+
+#endif
+
+#endif
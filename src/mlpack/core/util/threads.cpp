@@ -0,0 +1,113 @@
+/**
+ * @file threads.cpp
+ *
+ * Implementation of the library-wide thread settings.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "threads.hpp"
+
+#include <climits>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+
+  // omp_set_max_active_levels() needs OpenMP 3.0; Visual Studio only has 2.0.
+  #if _OPENMP >= 200805
+    #define MLPACK_OMP_SET_NESTED(nested) \
+        omp_set_max_active_levels((nested) ? INT_MAX : 1)
+  #else
+    #define MLPACK_OMP_SET_NESTED(nested) omp_set_nested((nested) ? 1 : 0)
+  #endif
+#endif
+
+// The BLAS libraries that have their own threads are detected at run time, so
+// that mlpack does not have to be linked against a particular one.
+#if defined(__GNUC__) && defined(__ELF__)
+  #define MLPACK_WEAK_BLAS_SYMBOLS
+extern "C" {
+void openblas_set_num_threads(int threads) __attribute__((weak));
+void MKL_Set_Num_Threads(int threads) __attribute__((weak));
+}
+#endif
+
+using namespace mlpack;
+
+namespace {
+
+//! The number of threads mlpack uses by default.
+size_t DefaultThreads()
+{
+  #ifdef HAS_OPENMP
+    // This is captured before mlpack changes the OpenMP settings.
+    static const size_t threads = (size_t) omp_get_max_threads();
+    return threads;
+  #else
+    return 1;
+  #endif
+}
+
+//! Set the number of threads of the BLAS library, if it has its own.
+void SetBLASThreads(const size_t threads)
+{
+  #ifdef MLPACK_WEAK_BLAS_SYMBOLS
+    if (openblas_set_num_threads)
+      openblas_set_num_threads((int) threads);
+    if (MKL_Set_Num_Threads)
+      MKL_Set_Num_Threads((int) threads);
+  #else
+    (void) threads;
+  #endif
+}
+
+//! The nesting policy, applied the first time the settings are used.
+bool& NestedFlag()
+{
+  static bool nested = false;
+  #ifdef HAS_OPENMP
+    static const bool applied = (MLPACK_OMP_SET_NESTED(false), true);
+    (void) applied;
+  #endif
+  return nested;
+}
+
+} // namespace
+
+void Threads::Set(const size_t threads)
+{
+  const size_t count = (threads == 0) ? DefaultThreads() : threads;
+  NestedFlag();
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads((int) count);
+  #endif
+  SetBLASThreads(count);
+}
+
+size_t Threads::Get()
+{
+  NestedFlag();
+
+  #ifdef HAS_OPENMP
+    return (size_t) omp_get_max_threads();
+  #else
+    return 1;
+  #endif
+}
+
+void Threads::SetNested(const bool nested)
+{
+  NestedFlag() = nested;
+
+  #ifdef HAS_OPENMP
+    MLPACK_OMP_SET_NESTED(nested);
+  #endif
+}
+
+bool Threads::Nested()
+{
+  return NestedFlag();
+}
@@ -0,0 +1,62 @@
+/**
+ * @file threads.hpp
+ *
+ * Library-wide control of the number of threads used by mlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_THREADS_HPP
+#define MLPACK_CORE_UTIL_THREADS_HPP
+
+#include <cstddef>
+
+namespace mlpack {
+
+/**
+ * The parallelism settings shared by all of mlpack.  The parallel parts of
+ * mlpack are OpenMP regions that use omp_get_max_threads() threads, so setting
+ * the number of threads here applies to all of them, and to the BLAS library
+ * too when it is OpenBLAS or MKL.  The command-line programs and the Python
+ * bindings set it with their 'threads' option.
+ *
+ * Nested parallel regions (for instance, a parallel tree build inside a
+ * parallel loop over trees) oversubscribe the processors, so they are run
+ * serially unless SetNested(true) is called.  The placement of the threads is
+ * left to the OpenMP runtime, and is controlled by the OMP_PROC_BIND and
+ * OMP_PLACES environment variables.
+ *
+ * Without OpenMP, mlpack always uses one thread, and these functions only
+ * change the BLAS settings.
+ */
+class Threads
+{
+ public:
+  /**
+   * Set the number of threads that mlpack and the BLAS library use.
+   *
+   * @param threads Number of threads; 0 restores the default (the value of
+   *     OMP_NUM_THREADS, or the number of processors).
+   */
+  static void Set(const size_t threads);
+
+  //! Get the number of threads that mlpack uses.
+  static size_t Get();
+
+  /**
+   * Allow or forbid nested parallel regions.  They are forbidden once any of
+   * the functions of this class has been called, unless this enables them.
+   *
+   * @param nested Whether nested parallel regions use more than one thread.
+   */
+  static void SetNested(const bool nested);
+
+  //! Get whether nested parallel regions use more than one thread.
+  static bool Nested();
+};
+
+} // namespace mlpack
+
+#endif
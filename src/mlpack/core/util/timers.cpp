@@ -17,11 +17,27 @@
 
 #include <map>
 #include <string>
+#include <algorithm>
 
 using namespace mlpack;
 using namespace std;
 using namespace chrono;
 
+namespace {
+
+//! Add the memory used between the start and the end of a run of a timer to
+//! its memory usage.
+void AddMemoryUsage(MemoryUsage& usage,
+                    const MemoryUsage& start,
+                    const MemoryUsage& end)
+{
+  usage.allocations += end.allocations - start.allocations;
+  usage.bytesAllocated += end.bytesAllocated - start.bytesAllocated;
+  usage.peakRSS = std::max(usage.peakRSS, end.peakRSS);
+}
+
+} // namespace
+
 /**
  * Start the given timer.
  */
@@ -46,6 +62,14 @@ microseconds Timer::Get(const string& name)
   return CLI::GetSingleton().timer.GetTimer(name);
 }
 
+/**
+ * Get the memory usage of the given timer, summing over all threads.
+ */
+MemoryUsage Timer::GetMemoryUsage(const string& name)
+{
+  return CLI::GetSingleton().timer.GetMemoryUsage(name);
+}
+
 // Enable timing.
 void Timer::EnableTiming()
 {
@@ -70,6 +94,8 @@ void Timers::Reset()
   lock_guard<mutex> lock(timersMutex);
   timers.clear();
   timerStartTime.clear();
+  memoryUsage.clear();
+  memoryStartUsage.clear();
 }
 
 map<string, microseconds> Timers::GetAllTimers()
@@ -88,6 +114,15 @@ microseconds Timers::GetTimer(const string& timerName)
   return timers[timerName];
 }
 
+MemoryUsage Timers::GetMemoryUsage(const string& timerName)
+{
+  if (!enabled)
+    return MemoryUsage();
+
+  lock_guard<mutex> lock(timersMutex);
+  return memoryUsage[timerName];
+}
+
 bool Timers::GetState(const string& timerName,
                       const thread::id& threadId)
 {
@@ -157,6 +192,27 @@ void Timers::PrintTimer(const string& timerName)
   Log::Info << endl;
 }
 
+void Timers::PrintMemoryUsage(const string& timerName)
+{
+  const MemoryUsage usage = GetMemoryUsage(timerName);
+
+  ostringstream oss;
+  oss << "peak RSS ";
+  if (usage.peakRSS > 0)
+    MemoryTracker::PrintBytes(oss, usage.peakRSS);
+  else
+    oss << "unknown";
+
+  if (MemoryTracker::TracksAllocations())
+  {
+    oss << ", " << usage.allocations << " Armadillo allocations (";
+    MemoryTracker::PrintBytes(oss, usage.bytesAllocated);
+    oss << ")";
+  }
+
+  Log::Info << oss.str() << endl;
+}
+
 void Timers::StopAllTimers()
 {
   // Terminate the program timers.  Don't use StopTimer() since that modifies
@@ -168,8 +224,14 @@ void Timers::StopAllTimers()
     for (auto it2 : it.second)
       timers[it2.first] += duration_cast<microseconds>(currTime - it2.second);
 
+  const MemoryUsage currUsage = MemoryTracker::Current();
+  for (auto it : memoryStartUsage)
+    for (auto it2 : it.second)
+      AddMemoryUsage(memoryUsage[it2.first], it2.second, currUsage);
+
   // If all timers are stopped, we can clear the maps.
   timerStartTime.clear();
+  memoryStartUsage.clear();
 }
 
 void Timers::StartTimer(const string& timerName,
@@ -199,6 +261,7 @@ void Timers::StartTimer(const string& timerName,
   }
 
   timerStartTime[threadId][timerName] = currTime;
+  memoryStartUsage[threadId][timerName] = MemoryTracker::Current();
 }
 
 void Timers::StopTimer(const string& timerName,
@@ -225,8 +288,15 @@ void Timers::StopTimer(const string& timerName,
   timers[timerName] += duration_cast<microseconds>(currTime -
       timerStartTime[threadId][timerName]);
 
+  // Add the memory used since the start.
+  AddMemoryUsage(memoryUsage[timerName], memoryStartUsage[threadId][timerName],
+      MemoryTracker::Current());
+
   // Remove the entries.
   timerStartTime[threadId].erase(timerName);
   if (timerStartTime[threadId].empty())
     timerStartTime.erase(threadId);
+  memoryStartUsage[threadId].erase(timerName);
+  if (memoryStartUsage[threadId].empty())
+    memoryStartUsage.erase(threadId);
 }
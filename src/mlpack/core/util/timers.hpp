@@ -22,6 +22,8 @@
 #include <list>
 #include <atomic>
 
+#include "memory_usage.hpp"
+
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
   #if !defined(HAVE_UINT64_T)
@@ -75,6 +77,15 @@ class Timer
    */
   static std::chrono::microseconds Get(const std::string& name);
 
+  /**
+   * Get the memory used while the given timer was running: the Armadillo
+   * allocations (if they are tracked; see MemoryTracker) and the peak resident
+   * set size of the process when it was last stopped.
+   *
+   * @param name Name of timer to return the memory usage of.
+   */
+  static MemoryUsage GetMemoryUsage(const std::string& name);
+
   /**
    * Enable timing of mlpack programs.  Do not run this while timers are
    * running!
@@ -119,6 +130,22 @@ class Timers
    */
   std::chrono::microseconds GetTimer(const std::string& timerName);
 
+  /**
+   * Returns a copy of the memory usage of the timer specified.  The
+   * allocations are summed over the runs of the timer.
+   *
+   * @param timerName The name of the timer in question.
+   */
+  MemoryUsage GetMemoryUsage(const std::string& timerName);
+
+  /**
+   * Prints the memory usage of the specified timer: the peak resident set size
+   * and, if they are tracked, the Armadillo allocations.
+   *
+   * @param timerName The name of the timer in question.
+   */
+  void PrintMemoryUsage(const std::string& timerName);
+
   /**
    * Prints the specified timer.  If it took longer than a minute to complete
    * the timer will be displayed in days, hours, and minutes as well.
@@ -175,6 +202,11 @@ class Timers
   //! A map for the starting values of the timers.
   std::map<std::thread::id, std::map<std::string,
       std::chrono::high_resolution_clock::time_point>> timerStartTime;
+  //! A map of the memory used while each timer was running.
+  std::map<std::string, MemoryUsage> memoryUsage;
+  //! A map for the allocation counters when the timers were started.
+  std::map<std::thread::id, std::map<std::string, MemoryUsage>>
+      memoryStartUsage;
 
   //! Whether or not timing is enabled.
   std::atomic<bool> enabled;
@@ -70,6 +70,15 @@ namespace adaboost {
  * void Classify(const MatType& data, arma::Row<size_t>& predictedLabels);
  * @endcode
  *
+ * With OpenMP, Classify() classifies one chunk of the points per thread, so
+ * the Classify() method of the weak learners may be called concurrently and
+ * must not modify the weak learner.  The weights of the points are also
+ * updated in parallel during training.
+ *
+ * The weak learner is copied before the boosting rounds; a copy of a decision
+ * stump sorts each dimension of the data once (see DecisionStump::Presort()),
+ * and every round reuses that order, since only the weights change.
+ *
  * For more information on and examples of weak learners, see
  * perceptron::Perceptron<> and decision_stump::DecisionStump<>.
  *
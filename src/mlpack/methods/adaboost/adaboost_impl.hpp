@@ -60,6 +60,27 @@ AdaBoost<WeakLearnerType, MatType>::AdaBoost(const double tolerance) :
   // Nothing to do.
 }
 
+namespace details {
+
+//! Most weak learners have nothing to prepare for training on the same data
+//! many times.
+template<typename WeakLearnerType, typename MatType>
+void PrepareWeakLearner(WeakLearnerType& /* weakLearner */,
+                        const MatType& /* data */)
+{
+  // Nothing to do.
+}
+
+//! Decision stumps sort each dimension once, for all the boosting rounds.
+template<typename MatType>
+void PrepareWeakLearner(decision_stump::DecisionStump<MatType>& weakLearner,
+                        const MatType& data)
+{
+  weakLearner.Presort(data);
+}
+
+} // namespace details
+
 // Train AdaBoost.
 template<typename WeakLearnerType, typename MatType>
 void AdaBoost<WeakLearnerType, MatType>::Train(
@@ -89,6 +110,11 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   // Use tempData to modify input data for incorporating weights.
   MatType tempData(data);
 
+  // Only the weights change from one round to the next, so let the weak
+  // learner prepare for the data once (decision stumps sort it).
+  WeakLearnerType prepared(other);
+  details::PrepareWeakLearner(prepared, tempData);
+
   // This matrix is a helper matrix used to calculate the final hypothesis.
   arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
       predictedLabels.n_cols);
@@ -112,26 +138,24 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
     // rt = (sum) D(i) y(i) ht(xi)
     rt = 0.0;
 
-    // zt is used for weight normalization.
-    zt = 0.0;
-
     // Build the weight vectors.
     weights = arma::sum(D);
 
     // Use the existing weak learner to train a new one with new weights.
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
+    WeakLearnerType w(prepared, tempData, labels, numClasses, weights);
     w.Classify(tempData, predictedLabels);
 
     // Now from predictedLabels, build ht, the weak hypothesis
     // buildClassificationMatrix(ht, predictedLabels);
 
-    // Now, calculate alpha(t) using ht.
+    // Now, calculate alpha(t) using ht.  The weight of each point is the sum
+    // of its column of D.
     for (size_t j = 0; j < D.n_cols; j++) // instead of D, ht
     {
       if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
+        rt += weights(j);
       else
-        rt -= arma::accu(D.col(j));
+        rt -= weights(j);
     }
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
@@ -155,17 +179,17 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; j++)
+    // Now start modifying the weights.  Each point is reweighted
+    // independently, so this is done in parallel.
+    const double expo = exp(alphat);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) D.n_cols; j++)
     {
-      const double expo = exp(alphat);
       if (predictedLabels(j) == labels(j))
       {
         for (size_t k = 0; k < D.n_rows; k++)
         {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
+          D(k, j) /= expo; // * exp(-1 * alphat * yt(j,k) * ht(j,k));
 
           // Add to the final hypothesis matrix.
           // sumFinalH(k, j) += (alphat * ht(k, j));
@@ -179,9 +203,7 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
       {
         for (size_t k = 0; k < D.n_rows; k++)
         {
-          // We calculate zt, the normalization constant.
           D(k, j) *= expo;
-          zt += D(k, j);
 
           // Add to the final hypothesis matrix.
           if (k == labels(j))
@@ -192,7 +214,8 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
       }
     }
 
-    // Normalize D.
+    // We calculate zt, the normalization constant, and normalize D.
+    zt = arma::accu(D);
     D /= zt;
 
     // Accumulate the value of zt for the Hamming loss bound.
@@ -208,18 +231,45 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
   arma::mat cMatrix(numClasses, test.n_cols);
 
   cMatrix.zeros();
   predictedLabels.set_size(test.n_cols);
 
-  for (size_t i = 0; i < wl.size(); i++)
+  // Split the points into one contiguous chunk per thread.  Each chunk is
+  // classified by all of the weak learners in turn, so the votes of each point
+  // are summed in the same order whatever the number of threads.
+  size_t chunks = 1;
+  #ifdef HAS_OPENMP
+    chunks = std::max(std::min(size_t(omp_get_max_threads()),
+        size_t(test.n_cols)), size_t(1));
+  #endif
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t c = 0; c < (omp_size_t) chunks; c++)
   {
-    wl[i].Classify(test, tempPredictedLabels);
+    const size_t begin = c * test.n_cols / chunks;
+    const size_t end = (c + 1) * test.n_cols / chunks;
+    if (begin == end)
+      continue;
+
+    // Only copy the chunk if the points are split.
+    MatType chunk;
+    const MatType* points = &test;
+    if (chunks > 1)
+    {
+      chunk = test.cols(begin, end - 1);
+      points = &chunk;
+    }
+
+    arma::Row<size_t> tempPredictedLabels(end - begin);
+    for (size_t i = 0; i < wl.size(); i++)
+    {
+      wl[i].Classify(*points, tempPredictedLabels);
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
-      cMatrix(tempPredictedLabels(j), j) += alpha[i];
+      for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
+        cMatrix(tempPredictedLabels(j), begin + j) += alpha[i];
+    }
   }
 
   arma::colvec cMRow;
@@ -22,9 +22,11 @@
 
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
+#include <mlpack/methods/amf/update_rules/implicit_als.hpp>
 #include <mlpack/methods/amf/update_rules/svd_batch_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
 
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/init_rules/random_acol_init.hpp>
@@ -142,6 +144,16 @@ typedef amf::AMF<amf::SimpleResidueTermination,
                  amf::RandomAcolInitialization<>,
                  amf::NMFALSUpdate> NMFALSFactorizer;
 
+/**
+ * ImplicitALSFactorizer factorizes a matrix of implicit feedback (counts of
+ * interactions) with confidence-weighted alternating least squares.
+ *
+ * @see ImplicitALSUpdate
+ */
+typedef amf::AMF<amf::SimpleResidueTermination,
+                 amf::RandomAcolInitialization<>,
+                 amf::ImplicitALSUpdate> ImplicitALSFactorizer;
+
 //! Convenience typedefs.
 
 /**
@@ -183,6 +195,18 @@ using SVDCompleteIncrementalFactorizer = amf::AMF<
     amf::SimpleResidueTermination,
     amf::RandomAcolInitialization<>,
     amf::SVDCompleteIncrementalLearning<MatType>>;
+
+/**
+ * SVDParallelIncrementalFactorizer factorizes given matrix V into two matrices
+ * W and H by complete incremental gradient descent, processing independent
+ * blocks of V in parallel (stratified SGD).
+ *
+ * @see SVDParallelIncrementalLearning
+ */
+typedef amf::AMF<amf::SimpleResidueTermination,
+                 amf::RandomAcolInitialization<>,
+                 amf::SVDParallelIncrementalLearning>
+    SVDParallelIncrementalFactorizer;
 } // namespace amf
 } // namespace mlpack
 
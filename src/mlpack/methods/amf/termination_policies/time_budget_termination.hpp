@@ -0,0 +1,124 @@
+/**
+ * @file time_budget_termination.hpp
+ *
+ * A termination policy for AMF that terminates after a wall-clock budget, or
+ * when the wrapped termination policy does.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_TERMINATION_POLICIES_TIME_BUDGET_TERMINATION_HPP
+#define MLPACK_METHODS_AMF_TERMINATION_POLICIES_TIME_BUDGET_TERMINATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "simple_residue_termination.hpp"
+
+#include <chrono>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class wraps another termination policy, and also terminates when the
+ * given number of seconds has passed since Initialize() was called.  The budget
+ * is only checked at the end of each iteration, so the factorization may run
+ * over it by up to one iteration.  For example, to factorize with the usual
+ * residue criterion but for at most a minute,
+ *
+ * @code
+ * AMF<TimeBudgetTermination<SimpleResidueTermination>> amf(
+ *     TimeBudgetTermination<SimpleResidueTermination>(60.0));
+ * @endcode
+ *
+ * @see AMF
+ */
+template<typename TerminationPolicy = SimpleResidueTermination>
+class TimeBudgetTermination
+{
+ public:
+  /**
+   * Construct the termination policy with the given budget.
+   *
+   * @param budget Number of seconds the factorization may take.
+   * @param tPolicy Wrapped termination policy.
+   */
+  TimeBudgetTermination(const double budget = 60.0,
+                        const TerminationPolicy tPolicy = TerminationPolicy()) :
+      budget(budget),
+      tPolicy(tPolicy),
+      exceeded(false)
+  { /* Nothing to do. */ }
+
+  /**
+   * Initialize the termination policy, and start the clock.
+   *
+   * @param V Input matrix to be factorized.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& V)
+  {
+    tPolicy.Initialize(V);
+    exceeded = false;
+    start = std::chrono::steady_clock::now();
+  }
+
+  /**
+   * Check if the wrapped termination criterion is met or the budget is
+   * exceeded.
+   *
+   * @param W Basis matrix of output.
+   * @param H Encoding matrix of output.
+   */
+  bool IsConverged(arma::mat& W, arma::mat& H)
+  {
+    // Let the wrapped policy update its residue and iteration first.
+    if (tPolicy.IsConverged(W, H))
+      return true;
+
+    exceeded = (std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count() >= budget);
+    if (exceeded)
+    {
+      Log::Info << "TimeBudgetTermination: budget of " << budget
+          << " seconds exceeded; terminating factorization." << std::endl;
+    }
+
+    return exceeded;
+  }
+
+  //! Get the current value of the residue of the wrapped policy.
+  double Index() { return tPolicy.Index(); }
+
+  //! Get the current iteration count of the wrapped policy.
+  size_t Iteration() const { return tPolicy.Iteration(); }
+
+  //! Get the budget, in seconds.
+  double Budget() const { return budget; }
+  //! Modify the budget, in seconds.
+  double& Budget() { return budget; }
+
+  //! Get whether the last factorization was terminated because of the budget.
+  bool Exceeded() const { return exceeded; }
+
+  //! Access the wrapped termination policy.
+  const TerminationPolicy& TPolicy() const { return tPolicy; }
+  //! Modify the wrapped termination policy.
+  TerminationPolicy& TPolicy() { return tPolicy; }
+
+ private:
+  //! The budget, in seconds.
+  double budget;
+  //! Wrapped termination policy.
+  TerminationPolicy tPolicy;
+  //! Whether the budget was exceeded.
+  bool exceeded;
+  //! When the factorization started.
+  std::chrono::steady_clock::time_point start;
+};
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * @file implicit_als.hpp
+ *
+ * Parallel alternating least squares update rules for implicit feedback.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_IMPLICIT_ALS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_IMPLICIT_ALS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class implements alternating least squares for implicit feedback, as
+ * described in the following paper:
+ *
+ * @code
+ * @inproceedings{hu2008collaborative,
+ *   title={Collaborative filtering for implicit feedback datasets},
+ *   author={Hu, Y. and Koren, Y. and Volinsky, C.},
+ *   booktitle={Proceedings of the Eighth IEEE International Conference on Data
+ *       Mining (ICDM '08)},
+ *   pages={263--272},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Each nonzero entry V(i, j) is an observed interaction, with a preference of 1
+ * and a confidence of 1 + alpha * V(i, j); every zero entry has a preference of
+ * 0 and a confidence of 1.  The update rules minimize the confidence-weighted
+ * squared error between the preferences and W * H, plus lambda times the
+ * squared norms of W and H.
+ *
+ * With H fixed, each row w_i of W is the solution of its own rank x rank
+ * system,
+ *
+ * \f[
+ * (H H^T + H (C_i - I) H^T + \lambda I) w_i = H C_i p_i,
+ * \f]
+ *
+ * and likewise for the columns of H.  The Gram matrix H H^T is computed once
+ * per update, so each system only needs the nonzero entries of its row (or
+ * column) of V.  The systems are solved in parallel with OpenMP, each thread
+ * with its own workspace.  The data is converted to a sparse matrix (and
+ * transposed, for the rows) when Initialize() is called, so Initialize() must
+ * be called with the matrix that is factorized, as AMF does.
+ */
+class ImplicitALSUpdate
+{
+ public:
+  /**
+   * Create the update rule with the given parameters.
+   *
+   * @param lambda Regularization parameter for W and H.
+   * @param alpha Scaling of the values of V to get the confidences.
+   */
+  ImplicitALSUpdate(const double lambda = 0.01, const double alpha = 1.0) :
+      lambda(lambda), alpha(alpha)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Store the nonzero entries of the given matrix by row and by column.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank Rank of the factorization.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& dataset, const size_t /* rank */)
+  {
+    data = arma::sp_mat(dataset);
+    dataT = data.t();
+  }
+
+  /**
+   * The update rule for the basis matrix W.  The function takes in all the
+   * matrices and only changes the value of the W matrix.
+   *
+   * @param V Input matrix to be factorized (ignored; the matrix given to
+   *     Initialize() is used).
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& /* V */,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    // Each row of W is a column of the transposed solution.
+    arma::mat wt;
+    Solve(dataT, H, wt);
+    W = wt.t();
+  }
+
+  /**
+   * The update rule for the encoding matrix H.  The function takes in all the
+   * matrices and only changes the value of the H matrix.
+   *
+   * @param V Input matrix to be factorized (ignored; the matrix given to
+   *     Initialize() is used).
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& /* V */,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    Solve(data, W.t(), H);
+  }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get the confidence scaling.
+  double Alpha() const { return alpha; }
+  //! Modify the confidence scaling.
+  double& Alpha() { return alpha; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+  }
+
+ private:
+  /**
+   * Solve the system of each column of the given sparse matrix.  Each nonzero
+   * X(i, j) is an interaction of column j with column i of the fixed factors.
+   *
+   * @param X Sparse matrix of interactions.
+   * @param fixed Fixed factors, with one column for each row of X.
+   * @param solution Solutions, with one column for each column of X.
+   */
+  void Solve(const arma::sp_mat& X,
+             const arma::mat& fixed,
+             arma::mat& solution) const
+  {
+    const size_t rank = fixed.n_rows;
+
+    // The Gram matrix (and the regularization) is shared by every system.
+    const arma::mat gram = fixed * fixed.t() +
+        lambda * arma::eye<arma::mat>(rank, rank);
+
+    solution.set_size(rank, X.n_cols);
+
+    #pragma omp parallel
+    {
+      // The workspaces of this thread.
+      arma::mat a(rank, rank);
+      arma::vec b(rank);
+
+      #pragma omp for schedule(dynamic, 64)
+      for (omp_size_t j = 0; j < (omp_size_t) X.n_cols; ++j)
+      {
+        a = gram;
+        b.zeros();
+
+        // Only the nonzero entries of the column change the system.
+        for (size_t k = X.col_ptrs[j]; k < X.col_ptrs[j + 1]; ++k)
+        {
+          const double confidence = 1.0 + alpha * X.values[k];
+          const double* y = fixed.colptr(X.row_indices[k]);
+          for (size_t c = 0; c < rank; ++c)
+          {
+            const double scaled = (confidence - 1.0) * y[c];
+            double* column = a.colptr(c);
+            for (size_t r = 0; r < rank; ++r)
+              column[r] += scaled * y[r];
+
+            b[c] += confidence * y[c];
+          }
+        }
+
+        // The system is positive definite if lambda > 0; otherwise it may be
+        // singular, and then the pseudoinverse is used.
+        arma::vec x(solution.colptr(j), rank, false, true);
+        if (!arma::solve(x, a, b))
+          x = arma::pinv(a) * b;
+      }
+    }
+  }
+
+  //! Regularization parameter for W and H.
+  double lambda;
+  //! Scaling of the values of V to get the confidences.
+  double alpha;
+
+  //! The matrix to factorize.
+  arma::sp_mat data;
+  //! The transpose of the matrix to factorize, to access its rows.
+  arma::sp_mat dataT;
+}; // class ImplicitALSUpdate
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
@@ -41,9 +41,9 @@ namespace amf {
  * is non-increasing between subsequent iterations. Both of the update rules
  * for W and H are defined in this file.
  *
- * This set of update rules is not meant to work with sparse matrices.  Using
- * sparse matrices often causes NaNs in the output, so other choices of update
- * rules are better in that situation.
+ * When V is sparse, the ratios V_{ij} / (W H)_{ij} are only computed at the
+ * nonzero entries of V (the other ratios are zero), so W H is never formed.
+ * Note that a zero in (W H) at a nonzero of V still causes NaNs in the output.
  */
 class NMFMultiplicativeDivergenceUpdate
 {
@@ -81,28 +81,25 @@ class NMFMultiplicativeDivergenceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::rowvec t2;
+    const arma::mat ratio = V / (W * H);
+    UpdateW(ratio, W, H);
+  }
 
-    t1 = W * H;
-    for (size_t i = 0; i < W.n_rows; ++i)
-    {
-      for (size_t j = 0; j < W.n_cols; ++j)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = H.row(j) % V.row(i) / t1.row(i);
-        t2.set_size(H.n_cols);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = H(j, k) * V(i, k) / t1(i, k);
-        }
-
-        W(i, j) = W(i, j) * sum(t2) / sum(H.row(j));
-      }
-    }
+  /**
+   * The update rule for the basis matrix W, when V is sparse.  Only the entries
+   * of W H at the nonzero entries of V are computed.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  inline static void WUpdate(const arma::sp_mat& V,
+                             arma::mat& W,
+                             const arma::mat& H)
+  {
+    arma::sp_mat ratio;
+    SparseRatio(V, W, H, ratio);
+    UpdateW(ratio, W, H);
   }
 
   /**
@@ -122,36 +119,89 @@ class NMFMultiplicativeDivergenceUpdate
    */
   template<typename MatType>
   inline static void HUpdate(const MatType& V,
-                            const arma::mat& W,
-                            arma::mat& H)
+                             const arma::mat& W,
+                             arma::mat& H)
   {
-    // Simple implementation left in the header file.
-    arma::mat t1;
-    arma::colvec t2;
+    const arma::mat ratio = V / (W * H);
+    UpdateH(ratio, W, H);
+  }
 
-    t1 = W * H;
-    for (size_t i = 0; i < H.n_rows; i++)
-    {
-      for (size_t j = 0; j < H.n_cols; j++)
-      {
-        // Writing this as a single expression does not work as of Armadillo
-        // 3.920.  This should be fixed in a future release, and then the code
-        // below can be fixed.
-        // t2 = W.col(i) % V.col(j) / t1.col(j);
-        t2.set_size(W.n_rows);
-        for (size_t k = 0; k < t2.n_elem; ++k)
-        {
-          t2(k) = W(k, i) * V(k, j) / t1(k, j);
-        }
-
-        H(i, j) = H(i, j) * sum(t2) / sum(W.col(i));
-      }
-    }
+  /**
+   * The update rule for the encoding matrix H, when V is sparse.  Only the
+   * entries of W H at the nonzero entries of V are computed.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to updated.
+   */
+  inline static void HUpdate(const arma::sp_mat& V,
+                             const arma::mat& W,
+                             arma::mat& H)
+  {
+    arma::sp_mat ratio;
+    SparseRatio(V, W, H, ratio);
+    UpdateH(ratio, W, H);
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  //! Update W, given the ratios V_{ij} / (W H)_{ij}.
+  template<typename RatioType>
+  inline static void UpdateW(const RatioType& ratio,
+                             arma::mat& W,
+                             const arma::mat& H)
+  {
+    W %= ratio * H.t();
+    W.each_row() /= arma::sum(H, 1).t();
+  }
+
+  //! Update H, given the ratios V_{ij} / (W H)_{ij}.
+  template<typename RatioType>
+  inline static void UpdateH(const RatioType& ratio,
+                             const arma::mat& W,
+                             arma::mat& H)
+  {
+    H %= W.t() * ratio;
+    H.each_col() /= arma::sum(W, 0).t();
+  }
+
+  /**
+   * Compute the ratios V_{ij} / (W H)_{ij} at the nonzero entries of V (a
+   * sampled dense-dense matrix product), in parallel over the columns of V.
+   */
+  inline static void SparseRatio(const arma::sp_mat& V,
+                                 const arma::mat& W,
+                                 const arma::mat& H,
+                                 arma::sp_mat& ratio)
+  {
+    V.sync();
+
+    // The rows of W are columns here so that they are contiguous.
+    const arma::mat wt = W.t();
+    const size_t rank = H.n_rows;
+    arma::vec values(V.n_nonzero);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
+    {
+      const double* h = H.colptr(j);
+      for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
+      {
+        const double* w = wt.colptr(V.row_indices[k]);
+        double product = 0.0;
+        for (size_t d = 0; d < rank; ++d)
+          product += w[d] * h[d];
+
+        values[k] = V.values[k] / product;
+      }
+    }
+
+    ratio = arma::sp_mat(arma::uvec(V.row_indices, V.n_nonzero),
+        arma::uvec(V.col_ptrs, V.n_cols + 1), values, V.n_rows, V.n_cols);
+  }
 };
 
 } // namespace amf
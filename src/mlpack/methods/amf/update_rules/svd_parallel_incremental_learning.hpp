@@ -0,0 +1,248 @@
+/**
+ * @file svd_parallel_incremental_learning.hpp
+ *
+ * Parallel SVD factorizer (stratified SGD) used in AMF (Alternating Matrix
+ * Factorization).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+#define MLPACK_METHODS_AMF_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class computes SVD with complete incremental learning (as in
+ * SVDCompleteIncrementalLearning) in parallel, using the stratified stochastic
+ * gradient descent described in the following paper:
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title={Large-scale matrix factorization with distributed stochastic
+ *       gradient descent},
+ *   author={Gemulla, R. and Nijkamp, E. and Haas, P.J. and Sismanis, Y.},
+ *   booktitle={Proceedings of the 17th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining (KDD '11)},
+ *   pages={69--77},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The rows and the columns of V are randomly split into the given number of
+ * strata, which divides V into strata x strata blocks.  Each iteration (one
+ * pass over every nonzero entry of V) is made of strata sub-epochs, and in each
+ * sub-epoch every row stratum is paired with a different column stratum, so
+ * that the blocks of a sub-epoch share no row of W and no column of H and can
+ * be processed in parallel with no locks.  The pairing and the order of the
+ * sub-epochs are shuffled in every iteration.  The blocks do not depend on the
+ * number of threads, so the result only depends on the random seed.
+ *
+ * Since each entry updates both a row of W and a column of H, the whole pass
+ * is done by WUpdate(), and HUpdate() stores the new H.
+ *
+ * @see SVDCompleteIncrementalLearning
+ */
+class SVDParallelIncrementalLearning
+{
+ public:
+  /**
+   * Initialize the parameters of SVDParallelIncrementalLearning.
+   *
+   * @param u Step value used in batch learning.
+   * @param kw Regularization constant for W matrix.
+   * @param kh Regularization constant for H matrix.
+   * @param strata Number of row (and column) strata of V.  More strata than
+   *     threads balance the load better.
+   */
+  SVDParallelIncrementalLearning(const double u = 0.0001,
+                                 const double kw = 0,
+                                 const double kh = 0,
+                                 const size_t strata = 16) :
+      u(u), kw(kw), kh(kh), strata(strata)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Split the nonzero entries of the input matrix into blocks.  This function
+   * must be called before a new factorization.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank Rank of factorization.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& dataset, const size_t /* rank */)
+  {
+    if (strata == 0)
+    {
+      throw std::invalid_argument("SVDParallelIncrementalLearning::"
+          "Initialize(): number of strata must be positive!");
+    }
+
+    const arma::sp_mat data(dataset);
+
+    // Assign the rows and the columns to the strata at random.
+    const arma::uvec rowOrder = arma::randperm(data.n_rows);
+    const arma::uvec colOrder = arma::randperm(data.n_cols);
+    arma::Col<size_t> rowStratum(data.n_rows), colStratum(data.n_cols);
+    for (size_t i = 0; i < data.n_rows; ++i)
+      rowStratum[rowOrder[i]] = i % strata;
+    for (size_t j = 0; j < data.n_cols; ++j)
+      colStratum[colOrder[j]] = j % strata;
+
+    // Count the entries of each block, then fill the blocks.
+    blockStarts.zeros(strata * strata + 1);
+    arma::sp_mat::const_iterator it = data.begin();
+    for (; it != data.end(); ++it)
+      ++blockStarts[Block(rowStratum[it.row()], colStratum[it.col()]) + 1];
+    for (size_t b = 1; b < blockStarts.n_elem; ++b)
+      blockStarts[b] += blockStarts[b - 1];
+
+    arma::Col<size_t> position = blockStarts.head(strata * strata);
+    locations.set_size(2, data.n_nonzero);
+    values.set_size(data.n_nonzero);
+    for (it = data.begin(); it != data.end(); ++it)
+    {
+      const size_t index =
+          position[Block(rowStratum[it.row()], colStratum[it.col()])]++;
+      locations(0, index) = it.row();
+      locations(1, index) = it.col();
+      values[index] = *it;
+    }
+  }
+
+  /**
+   * Perform one pass of stratified SGD over every nonzero entry of V.  This
+   * updates W, and the new H is stored until HUpdate() is called.
+   *
+   * @param V Input matrix to be factorized (ignored; the matrix given to
+   *     Initialize() is used).
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& /* V */,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    // The rows of W are columns here so that they are contiguous.
+    arma::mat wt = W.t();
+    h = H;
+
+    // Shuffle the pairing of the strata and the order of the sub-epochs.
+    const arma::uvec pairing = arma::randperm(strata);
+    const arma::uvec order = arma::randperm(strata);
+
+    const size_t rank = h.n_rows;
+    for (size_t s = 0; s < strata; ++s)
+    {
+      // The blocks of this sub-epoch share no row and no column.
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t r = 0; r < (omp_size_t) strata; ++r)
+      {
+        const size_t c = (pairing[r] + order[s]) % strata;
+        const size_t block = Block(r, c);
+        for (size_t k = blockStarts[block]; k < blockStarts[block + 1]; ++k)
+        {
+          double* w = wt.colptr(locations(0, k));
+          double* hc = h.colptr(locations(1, k));
+
+          double error = values[k];
+          for (size_t d = 0; d < rank; ++d)
+            error -= w[d] * hc[d];
+
+          for (size_t d = 0; d < rank; ++d)
+          {
+            const double wd = w[d];
+            w[d] += u * (error * hc[d] - kw * wd);
+            hc[d] += u * (error * wd - kh * hc[d]);
+          }
+        }
+      }
+    }
+
+    W = wt.t();
+  }
+
+  /**
+   * Store the encoding matrix computed by the last call to WUpdate().
+   *
+   * @param V Input matrix to be factorized (ignored).
+   * @param W Basis matrix (ignored).
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& /* V */,
+                      const arma::mat& /* W */,
+                      arma::mat& H)
+  {
+    H = h;
+  }
+
+  //! Get the step size.
+  double U() const { return u; }
+  //! Modify the step size.
+  double& U() { return u; }
+
+  //! Get the regularization parameter for W.
+  double KW() const { return kw; }
+  //! Modify the regularization parameter for W.
+  double& KW() { return kw; }
+
+  //! Get the regularization parameter for H.
+  double KH() const { return kh; }
+  //! Modify the regularization parameter for H.
+  double& KH() { return kh; }
+
+  //! Get the number of strata.
+  size_t Strata() const { return strata; }
+  //! Modify the number of strata.
+  size_t& Strata() { return strata; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(u);
+    ar & BOOST_SERIALIZATION_NVP(kw);
+    ar & BOOST_SERIALIZATION_NVP(kh);
+    ar & BOOST_SERIALIZATION_NVP(strata);
+  }
+
+ private:
+  //! Get the index of the block of the given row and column strata.
+  size_t Block(const size_t row, const size_t col) const
+  {
+    return row * strata + col;
+  }
+
+  //! Step size of the algorithm.
+  double u;
+  //! Regularization parameter for matrix W.
+  double kw;
+  //! Regularization parameter for matrix H.
+  double kh;
+  //! Number of row (and column) strata.
+  size_t strata;
+
+  //! The offset of each block in the entries (and the number of entries).
+  arma::Col<size_t> blockStarts;
+  //! The row and column of each entry, ordered by block.
+  arma::Mat<size_t> locations;
+  //! The value of each entry, ordered by block.
+  arma::vec values;
+
+  //! The encoding matrix computed by the last pass.
+  arma::mat h;
+}; // class SVDParallelIncrementalLearning
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
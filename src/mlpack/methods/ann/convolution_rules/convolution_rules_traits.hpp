@@ -0,0 +1,43 @@
+/**
+ * @file convolution_rules_traits.hpp
+ *
+ * This provides the ConvolutionTraits class, a template class to get
+ * information about various convolution rules.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_CONVOLUTION_RULES_TRAITS_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_CONVOLUTION_RULES_TRAITS_HPP
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * This is a template class that can provide information about various
+ * convolution rules.  By default, this class will provide the weakest possible
+ * assumptions on the convolution rule, and each convolution rule should
+ * override values as necessary.  If a convolution rule doesn't need to override
+ * a value, then there's no need to write a ConvolutionTraits specialization for
+ * that class.
+ */
+template<typename ConvolutionRuleType>
+class ConvolutionTraits
+{
+ public:
+  /**
+   * This is true if the convolution rule can process all input and output maps
+   * of a whole batch at once by unfolding the input into a patch matrix
+   * (im2col) and using a single matrix multiplication.  In this case the
+   * Convolution layer calls the batch functions of ImToColConvolution instead
+   * of convolving every input map with every filter separately.
+   */
+  static const bool UseImToCol = false;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,465 @@
+/**
+ * @file im2col_convolution.hpp
+ *
+ * Implementation of the convolution using the im2col transformation: the
+ * patches of the input are unfolded into the rows of a matrix, so that the
+ * convolution becomes a (BLAS level 3) matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+#include "convolution_rules_traits.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by unfolding the input patches into
+ * a matrix (im2col) and multiplying that matrix with the filter.  This class
+ * allows specification of the type of the border type. The convolution can be
+ * compute with the valid border type of the full border type (default).
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * Besides the interface shared with the other convolution rules, this class
+ * provides ForwardBatch(), BackwardBatch() and GradientBatch(), which handle
+ * all input and output maps of a whole batch with a single matrix
+ * multiplication.  The Convolution layer uses these functions if this rule is
+ * selected.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class ImToColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1)
+  {
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> patches;
+    ImToCol(inputCube, 1, filter.n_rows, filter.n_cols, dW, dH, patches);
+
+    output.set_size((input.n_rows - filter.n_rows) / dW + 1,
+        (input.n_cols - filter.n_cols) / dH + 1);
+
+    // The patches are stored in the rows, so the convolution of all positions
+    // is one matrix-vector product.
+    arma::Col<eT> outputCol(output.memptr(), output.n_elem, false, true);
+    outputCol = patches * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1)
+  {
+    const size_t outputRows = (input.n_rows + 2 * (filter.n_rows - 1)) * dW;
+    const size_t outputCols = (input.n_cols + 2 * (filter.n_cols - 1)) * dH;
+
+    // Pad filter and input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat(filter.n_rows - 1, filter.n_cols - 1,
+        filter.n_rows - 1 + input.n_rows - 1,
+        filter.n_cols - 1 + input.n_cols - 1) = input;
+
+    ImToColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    ImToColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      ImToColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    ImToColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; i++)
+    {
+      ImToColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    ImToColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      ImToColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH);
+    }
+  }
+
+  /**
+   * Compute the (valid) convolution of a whole batch, where every output map
+   * is the sum of the convolutions of all input maps with the corresponding
+   * filters.  The maps of point n are stored in the slices
+   * [n * inSize, (n + 1) * inSize) of the input and in the slices
+   * [n * outSize, (n + 1) * outSize) of the output; the filter that connects
+   * input map i with output map o is stored in slice o * inSize + i.
+   *
+   * @param input The (padded) input maps of the batch.
+   * @param filter The filters.
+   * @param inSize The number of input maps per point.
+   * @param outSize The number of output maps per point.
+   * @param patches The unfolded input patches, which can be reused by
+   *        GradientBatch().
+   * @param output Output maps of the batch.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void ForwardBatch(const arma::Cube<eT>& input,
+                           const arma::Cube<eT>& filter,
+                           const size_t inSize,
+                           const size_t outSize,
+                           arma::Mat<eT>& patches,
+                           arma::Cube<eT>& output,
+                           const size_t dW = 1,
+                           const size_t dH = 1)
+  {
+    const size_t batchSize = input.n_slices / inSize;
+    const size_t outputRows = (input.n_rows - filter.n_rows) / dW + 1;
+    const size_t outputCols = (input.n_cols - filter.n_cols) / dH + 1;
+    const size_t outputElem = outputRows * outputCols;
+
+    ImToCol(input, inSize, filter.n_rows, filter.n_cols, dW, dH, patches);
+
+    // Column o of this matrix holds all filters of output map o.
+    const arma::Mat<eT> filterMat(const_cast<eT*>(filter.memptr()),
+        filter.n_rows * filter.n_cols * inSize, outSize, false, true);
+
+    // One multiplication for all positions, output maps and points.
+    const arma::Mat<eT> result = patches * filterMat;
+
+    // Reorder the result into the map layout.
+    output.set_size(outputRows, outputCols, outSize * batchSize);
+    for (size_t n = 0; n < batchSize; ++n)
+    {
+      for (size_t outMap = 0; outMap < outSize; ++outMap)
+      {
+        const eT* resultPtr = result.colptr(outMap) + n * outputElem;
+        std::copy(resultPtr, resultPtr + outputElem,
+            output.slice_memptr(n * outSize + outMap));
+      }
+    }
+  }
+
+  /**
+   * Backpropagate the error of a whole batch through the (valid) convolution
+   * computed by ForwardBatch().  The output has to be set to the size of the
+   * (padded) input maps of the batch; its content is overwritten.
+   *
+   * @param error The error of the output maps of the batch.
+   * @param filter The filters.
+   * @param inSize The number of input maps per point.
+   * @param outSize The number of output maps per point.
+   * @param output The error of the (padded) input maps of the batch.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   */
+  template<typename eT>
+  static void BackwardBatch(const arma::Cube<eT>& error,
+                            const arma::Cube<eT>& filter,
+                            const size_t inSize,
+                            const size_t outSize,
+                            arma::Cube<eT>& output,
+                            const size_t dW = 1,
+                            const size_t dH = 1)
+  {
+    arma::Mat<eT> errorMat;
+    MapsToCol(error, outSize, errorMat);
+
+    const arma::Mat<eT> filterMat(const_cast<eT*>(filter.memptr()),
+        filter.n_rows * filter.n_cols * inSize, outSize, false, true);
+
+    // The error of every input patch, which is folded back onto the maps.
+    const arma::Mat<eT> patchError = errorMat * filterMat.t();
+
+    output.zeros();
+    ColToIm(patchError, inSize, filter.n_rows, filter.n_cols, dW, dH, output);
+  }
+
+  /**
+   * Compute the gradient of the filters of a whole batch, given the patches
+   * computed by ForwardBatch() (or ImToCol()).
+   *
+   * @param patches The unfolded input patches of the batch.
+   * @param error The error of the output maps of the batch.
+   * @param kW Width of the filters.
+   * @param kH Height of the filters.
+   * @param inSize The number of input maps per point.
+   * @param outSize The number of output maps per point.
+   * @param gradient The gradient of the filters (in the layout of the
+   *        filters).
+   */
+  template<typename eT>
+  static void GradientBatch(const arma::Mat<eT>& patches,
+                            const arma::Cube<eT>& error,
+                            const size_t kW,
+                            const size_t kH,
+                            const size_t inSize,
+                            const size_t outSize,
+                            arma::Cube<eT>& gradient)
+  {
+    arma::Mat<eT> errorMat;
+    MapsToCol(error, outSize, errorMat);
+
+    gradient.set_size(kW, kH, outSize * inSize);
+    arma::Mat<eT> gradientMat(gradient.memptr(), kW * kH * inSize, outSize,
+        false, true);
+    gradientMat = patches.t() * errorMat;
+  }
+
+  /**
+   * Unfold the input patches of a whole batch into a matrix.  Every row holds
+   * one patch (of all input maps of a point); the rows of point n are stored
+   * consecutively, with the patch positions in column-major order.
+   *
+   * @param input The input maps of the batch.
+   * @param inSize The number of input maps per point.
+   * @param kW Width of the filters.
+   * @param kH Height of the filters.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param patches The unfolded patches.
+   */
+  template<typename eT>
+  static void ImToCol(const arma::Cube<eT>& input,
+                      const size_t inSize,
+                      const size_t kW,
+                      const size_t kH,
+                      const size_t dW,
+                      const size_t dH,
+                      arma::Mat<eT>& patches)
+  {
+    const size_t batchSize = input.n_slices / inSize;
+    const size_t outputRows = (input.n_rows - kW) / dW + 1;
+    const size_t outputCols = (input.n_cols - kH) / dH + 1;
+
+    patches.set_size(outputRows * outputCols * batchSize, kW * kH * inSize);
+
+    // Fill the matrix column by column, so that all writes are contiguous.
+    for (size_t inMap = 0; inMap < inSize; ++inMap)
+    {
+      for (size_t kj = 0; kj < kH; ++kj)
+      {
+        for (size_t ki = 0; ki < kW; ++ki)
+        {
+          eT* patchesPtr = patches.colptr(ki + kj * kW + inMap * kW * kH);
+          for (size_t n = 0; n < batchSize; ++n)
+          {
+            const arma::Mat<eT>& map = input.slice(n * inSize + inMap);
+            for (size_t j = 0; j < outputCols; ++j)
+            {
+              const eT* inputPtr = map.colptr(j * dH + kj) + ki;
+              for (size_t i = 0; i < outputRows; ++i, inputPtr += dW)
+                *(patchesPtr++) = *inputPtr;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Fold a matrix of patches back onto the maps, summing overlapping
+   * entries; this is the adjoint of ImToCol().  The output has to be set to
+   * the size of the input maps of the batch; the patches are added to its
+   * content.
+   *
+   * @param patches The unfolded patches.
+   * @param inSize The number of input maps per point.
+   * @param kW Width of the filters.
+   * @param kH Height of the filters.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param output The maps of the batch.
+   */
+  template<typename eT>
+  static void ColToIm(const arma::Mat<eT>& patches,
+                      const size_t inSize,
+                      const size_t kW,
+                      const size_t kH,
+                      const size_t dW,
+                      const size_t dH,
+                      arma::Cube<eT>& output)
+  {
+    const size_t batchSize = output.n_slices / inSize;
+    const size_t outputRows = (output.n_rows - kW) / dW + 1;
+    const size_t outputCols = (output.n_cols - kH) / dH + 1;
+
+    for (size_t inMap = 0; inMap < inSize; ++inMap)
+    {
+      for (size_t kj = 0; kj < kH; ++kj)
+      {
+        for (size_t ki = 0; ki < kW; ++ki)
+        {
+          const eT* patchesPtr = patches.colptr(ki + kj * kW +
+              inMap * kW * kH);
+          for (size_t n = 0; n < batchSize; ++n)
+          {
+            arma::Mat<eT>& map = output.slice(n * inSize + inMap);
+            for (size_t j = 0; j < outputCols; ++j)
+            {
+              eT* outputPtr = map.colptr(j * dH + kj) + ki;
+              for (size_t i = 0; i < outputRows; ++i, outputPtr += dW)
+                *outputPtr += *(patchesPtr++);
+            }
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  /**
+   * Store the maps of a whole batch in a matrix with one column per map
+   * index, where the entries of point n are stored consecutively in the rows
+   * (the same row layout as the patches in ImToCol()).
+   */
+  template<typename eT>
+  static void MapsToCol(const arma::Cube<eT>& maps,
+                        const size_t mapSize,
+                        arma::Mat<eT>& output)
+  {
+    const size_t batchSize = maps.n_slices / mapSize;
+    const size_t mapElem = maps.n_rows * maps.n_cols;
+
+    output.set_size(mapElem * batchSize, mapSize);
+    for (size_t n = 0; n < batchSize; ++n)
+    {
+      for (size_t map = 0; map < mapSize; ++map)
+      {
+        const eT* mapPtr = maps.slice_memptr(n * mapSize + map);
+        std::copy(mapPtr, mapPtr + mapElem, output.colptr(map) + n * mapElem);
+      }
+    }
+  }
+};  // class ImToColConvolution
+
+//! The Convolution layer processes complete batches with ImToColConvolution.
+template<typename BorderMode>
+class ConvolutionTraits<ImToColConvolution<BorderMode> >
+{
+ public:
+  static const bool UseImToCol = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -53,8 +53,11 @@ class NaiveConvolution
               const size_t dW = 1,
               const size_t dH = 1)
   {
-    output = arma::zeros<arma::Mat<eT> >((input.n_rows - filter.n_rows + 1) /
-        dW, (input.n_cols - filter.n_cols + 1) / dH);
+    // The output size matches the one of the convolution layer (and the
+    // other convolution rules): the filter is applied at every dW-th row and
+    // every dH-th column at which it fits into the input.
+    output = arma::zeros<arma::Mat<eT> >((input.n_rows - filter.n_rows) / dW +
+        1, (input.n_cols - filter.n_cols) / dH + 1);
 
     // It seems to be about 3.5 times faster to use pointers instead of
     // filter(ki, kj) * input(leftInput + ki, topInput + kj) and output(i, j).
@@ -67,7 +70,7 @@ class NaiveConvolution
         const eT* kernelPtr = filter.memptr();
         for (size_t kj = 0; kj < filter.n_cols; ++kj)
         {
-          const eT* inputPtr = input.colptr(kj + j * dW) + i * dH;
+          const eT* inputPtr = input.colptr(kj + j * dH) + i * dW;
           for (size_t ki = 0; ki < filter.n_rows; ++ki, ++kernelPtr, ++inputPtr)
             *outputPtr += *kernelPtr * (*inputPtr);
         }
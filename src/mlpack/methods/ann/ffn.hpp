@@ -25,6 +25,7 @@
 #include "visitor/copy_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "layer/reduced_precision.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/init_rules/random_init.hpp>
@@ -121,6 +122,26 @@ class FFN
              arma::mat responses,
              OptimizerType& optimizer);
 
+  /**
+   * Train the feedforward network on the given input data using the given
+   * optimizer, and call the given callback at the end of each iteration of the
+   * optimizer (such as optimization::Checkpoint, to save the training state
+   * periodically, or optimization::ValidationEarlyStop).  The optimizer must
+   * support callbacks.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackType Type of the callback.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callback Callback to call at each iteration of the optimizer.
+   */
+  template<typename OptimizerType, typename CallbackType>
+  void Train(arma::mat predictors,
+             arma::mat responses,
+             OptimizerType& optimizer,
+             CallbackType& callback);
+
   /**
    * Train the feedforward network on the given input data. By default, the
    * RMSProp optimization algorithm is used, but others can be specified
@@ -140,18 +161,115 @@ class FFN
   template<typename OptimizerType = mlpack::optimization::RMSProp>
   void Train(arma::mat predictors, arma::mat responses);
 
+  /**
+   * Update the network with batches of predictors and responses read one at a
+   * time from the given loader (such as data::CSVBatchReader), so that the
+   * training set never has to be in memory at once.  The loader is called as
+   * loader(predictors, responses) and returns false when there are no more
+   * batches.  Each batch is optimized with the given optimizer, starting from
+   * the current parameters, so an optimizer that takes a bounded number of
+   * steps (such as SGD with one pass over each batch) should be used.  To
+   * read (and shuffle or augment) the next batches in the background while
+   * the current one is trained on, wrap the loader in a data::PrefetchLoader;
+   * data::MatrixBatchReader reads shuffled batches of a dataset in memory.
+   *
+   * @tparam LoaderType Type of the loader, a callable object.
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param loader Loader to read batches from.
+   * @param optimizer Instantiated optimizer used for each batch.
+   * @return The number of batches read.
+   */
+  template<typename LoaderType, typename OptimizerType>
+  size_t Update(LoaderType& loader, OptimizerType& optimizer);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
    * output layer function.
    *
+   * The predictors are passed through the network in blocks of batchSize
+   * columns, so that every layer works on a whole block at once (e.g. a
+   * matrix-matrix product instead of a matrix-vector product for the Linear
+   * layer).  All layers in the network have to support multi-column input if
+   * a batch size larger than one is used.
+   *
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to be passed through the network at a
+   *        time.
+   */
+  void Predict(arma::mat predictors,
+               arma::mat& results,
+               const size_t batchSize = 1);
+
+  /**
+   * Plan the memory used by the forward pass for inputs with the given number
+   * of rows and columns.  The network is run once to determine the size of the
+   * output of every layer; afterwards one buffer (arena) that holds the input
+   * block and the outputs of all layers is allocated, and the output of every
+   * layer is made an alias into that buffer.  Every following call to
+   * Predict() or Forward() with inputs of the planned shape writes directly
+   * into the preallocated memory, so large parts of the forward pass don't
+   * allocate memory anymore.
+   *
+   * Predict() uses the planned batch size while a plan exists.  The plan is
+   * dropped automatically if the network is run with inputs of a different
+   * shape (e.g. during training with another batch size), and it can be
+   * dropped manually with ReleasePlan().
+   *
+   * @param inputSize Number of rows of the input data.
+   * @param batchSize Number of points that are passed through the network at a
+   *        time.
+   * @return Size of the preallocated buffer in bytes.
+   */
+  size_t Plan(const size_t inputSize, const size_t batchSize = 1);
+
+  /**
+   * Drop the memory plan created by Plan(), if any.  All layers own their
+   * output again afterwards.
+   */
+  void ReleasePlan();
+
+  //! Return whether the forward pass runs with a memory plan.
+  bool Planned() const { return planned; }
+
+  //! Get the peak memory footprint (in bytes) of the buffers used by the
+  //! planned forward pass, or 0 if no plan exists.
+  size_t PlannedMemory() const { return arena.n_elem * sizeof(double); }
+
+  /**
+   * Create a slimmer network for inference from this (trained) network.  The
+   * new network computes the same function as this network in deterministic
+   * mode, but with fewer layers:
+   *
+   *  - BatchNorm, MultiplyConstant and rescaling Dropout layers after a Linear,
+   *    LinearNoBias or DropConnect layer are folded into the weights and the
+   *    bias of that layer,
+   *  - DropConnect and LinearNoBias layers become Linear layers,
+   *  - Dropout layers without rescaling are removed.
+   *
+   * All other layers are copied.
+   *
+   * @param network The network to store the folded network into.
+   */
+  void Fuse(FFN& network) const;
+
+  /**
+   * Create an 8-bit integer version of this (trained) network for inference.
+   * The Linear, LinearNoBias, DropConnect and Convolution layers are replaced
+   * by QuantizedLinear and QuantizedConvolution layers, whose weights are
+   * quantized with one scale per output channel; the scale of the input of
+   * every such layer is derived from the largest absolute input seen on the
+   * given calibration data.  All other layers are copied.  Call Fuse() first
+   * to fold BatchNorm layers into the weights before they are quantized.
+   *
+   * @param calibrationData Representative input data (one point per column).
+   * @param network The network to store the quantized network into.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Quantize(const arma::mat& calibrationData, FFN& network);
 
   /**
    * Evaluate the feedforward network with the given parameters. This function
@@ -217,6 +335,29 @@ class FFN
                 arma::mat& gradient,
                 const size_t batchSize);
 
+  /**
+   * Evaluate the gradient of the feedforward network with the given
+   * parameters, as a sparse matrix.  Layers that implement SparseGradient()
+   * (e.g. Lookup) only contribute the columns of their weights that were used
+   * by the batch, so for large embedding tables the cost is proportional to
+   * the batch instead of the table.  The gradients of all other layers are
+   * stored in full.  The batch is always computed by this thread.
+   *
+   * The optimizers that support sparse gradients use this instead of the
+   * dense Gradient() if SparseGradients() is true.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize);
+
   /**
    * Shuffle the order of function visitation. This may be called by the
    * optimizer.
@@ -241,11 +382,111 @@ class FFN
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
+  //! Get the number of threads used to compute the gradient of a batch.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used to compute the gradient of a batch.
+  //! If this is larger than one (and mlpack was compiled with OpenMP),
+  //! Gradient() splits each batch across worker-local copies of the network
+  //! that share the parameters of this network, and sums their gradients.
+  //! Layers that normalize over the batch (BatchNorm) normalize each part by
+  //! its own statistics in this mode; the running statistics of the copies
+  //! are merged into this network after every batch, so that they cover the
+  //! whole batch.
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the number of pipeline stages used to compute the gradient of a
+  //! batch.
+  size_t PipelineStages() const { return pipelineStages; }
+  //! Modify the number of pipeline stages used to compute the gradient of a
+  //! batch.  If this is larger than one, Gradient() splits the layers into
+  //! that many consecutive stages with about the same number of parameters,
+  //! each run by its own thread, and splits the batch into Microbatches()
+  //! parts that flow through the stages one after the other, so that while
+  //! one stage works on a microbatch the previous stage works on the next
+  //! one.  Each thread only touches the weights and activations of its own
+  //! layers, which keeps them in its cache (and, with OMP_PROC_BIND=spread,
+  //! on its socket).  Only the inputs of the stages are kept for the backward
+  //! pass; the forward pass of every stage but the last is recomputed,
+  //! replaying the saved state of the layers (e.g. the masks of Dropout), so
+  //! the running statistics of BatchNorm are only updated once for each
+  //! microbatch.  This takes precedence over NumThreads().
+  size_t& PipelineStages() { return pipelineStages; }
+
+  //! Get the number of microbatches a batch is split into for the pipeline.
+  size_t Microbatches() const { return microbatches; }
+  //! Modify the number of microbatches a batch is split into for the
+  //! pipeline.
+  size_t& Microbatches() { return microbatches; }
+
+  //! Get the number of segments of activation checkpointing.
+  size_t CheckpointSegments() const { return checkpointSegments; }
+  //! Modify the number of segments of activation checkpointing.  If this is
+  //! not one, Gradient() splits the layers into that many consecutive
+  //! segments (or into about the square root of the number of layers, if it
+  //! is zero) with about the same size of activations, as measured on the
+  //! previous batch.  Only the inputs of the segments are kept during the
+  //! forward pass; the outputs of the layers of each segment are freed, and
+  //! recomputed from the input of the segment when the backward pass gets to
+  //! it.  This costs about one more forward pass, but the activations that
+  //! are kept at once are those of one segment instead of all the layers, so
+  //! much larger batches fit in memory.  The recomputed passes replay the
+  //! saved state of the layers (e.g. the masks of Dropout), so the gradient
+  //! and the running statistics of BatchNorm are the same as without
+  //! checkpointing.  This takes precedence over PipelineStages() and
+  //! NumThreads().
+  size_t& CheckpointSegments() { return checkpointSegments; }
+
+  //! Get whether the optimizers should use the sparse gradients.
+  bool SparseGradients() const { return sparseGradients; }
+  //! Modify whether the optimizers should use the sparse gradients.  This is
+  //! off by default, since the optimizers may update the parameters lazily
+  //! with sparse gradients (e.g. Adam only decays the moments of the
+  //! coordinates in the gradient), which gives different results.
+  bool& SparseGradients() { return sparseGradients; }
+
+  //! Get the format whose precision the gradient emulates.
+  PrecisionType EmulatedPrecision() const { return emulatedPrecision; }
+  //! Modify the format whose precision the gradient emulates.  With
+  //! BFLOAT16_PRECISION or HALF_PRECISION, Gradient() emulates mixed precision
+  //! training: the forward and backward passes use the weights, the input, the
+  //! outputs of the layers with weights (such as Linear and Convolution) and
+  //! the errors rounded to that format, while the parameters that the optimizer
+  //! updates stay the full precision master weights.  The values are only
+  //! rounded; they are still stored and computed in double precision, so this
+  //! shows how the format and loss scaling affect training, but uses no less
+  //! memory or time than Gradient() in double precision (it takes a little
+  //! more, for the rounding).  The error is multiplied by LossScale() before
+  //! the backward pass and the gradient divided by it afterwards, so that small
+  //! errors do not underflow in half precision.  The loss scale is dynamic: it
+  //! is halved whenever the gradient overflows, in which case the non-finite
+  //! gradient is returned so that an optimizer with the SkipNonFiniteUpdate
+  //! update policy skips the step, and doubled after LossScaleWindow() steps
+  //! without overflow.  The batch is always computed by this thread.
+  PrecisionType& EmulatedPrecision() { return emulatedPrecision; }
+
+  //! Get the current loss scale of mixed precision training.
+  double LossScale() const { return lossScale; }
+  //! Modify the current loss scale of mixed precision training.
+  double& LossScale() { return lossScale; }
+
+  //! Get the number of steps without overflow after which the loss scale is
+  //! doubled.
+  size_t LossScaleWindow() const { return lossScaleWindow; }
+  //! Modify the number of steps without overflow after which the loss scale
+  //! is doubled.
+  size_t& LossScaleWindow() { return lossScaleWindow; }
+
   //! Return the initial point for the optimization.
   const arma::mat& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
   arma::mat& Parameters() { return parameter; }
 
+  //! Get the layers of the network.
+  const std::vector<LayerTypes<CustomLayers...> >& Model() const
+  {
+    return network;
+  }
+
   /**
    * Reset the module infomration (weights/parameters).
    */
@@ -311,6 +552,98 @@ class FFN
    */
   void Gradient(arma::mat&& input);
 
+  /**
+   * Compute the gradient of the given input and target batch, i.e. run the
+   * forward, backward and gradient pass.  The given gradient matrix has to be
+   * of the size of the network parameters.
+   *
+   * @param input The input batch.
+   * @param target The targets of the input batch.
+   * @param gradient Matrix to output the gradient into.
+   */
+  void BatchGradient(arma::mat&& input,
+                     arma::mat&& target,
+                     arma::mat& gradient);
+
+  /**
+   * Compute the gradient of the given batch by splitting it across the worker
+   * replicas of the network.
+   */
+  void ParallelGradient(const size_t begin,
+                        arma::mat& gradient,
+                        const size_t batchSize);
+
+  /**
+   * Compute the gradient of the given batch by running the stages of the
+   * pipeline in parallel on microbatches of the batch.
+   */
+  void PipelineGradient(const size_t begin,
+                        arma::mat& gradient,
+                        const size_t batchSize);
+
+  /**
+   * Compute the gradient of the given batch with activation checkpointing
+   * (see CheckpointSegments()).
+   */
+  void CheckpointGradient(const size_t begin,
+                          arma::mat& gradient,
+                          const size_t batchSize);
+
+  /**
+   * Compute the gradient of the given batch in emulated mixed precision, with
+   * dynamic loss scaling (see EmulatedPrecision()).
+   */
+  void EmulatedPrecisionGradient(const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize);
+
+  //! Run the forward pass of the layers first, ..., last on the given input.
+  void StageForward(const size_t first, const size_t last, arma::mat& input);
+
+  /**
+   * Save the state of the last forward pass of the layers first, ..., last,
+   * which is recomputed later (see RestoreStageState()).
+   */
+  void SaveStageState(const size_t first,
+                      const size_t last,
+                      std::vector<arma::mat>& states);
+
+  /**
+   * Restore the states saved by SaveStageState(), so that the next forward
+   * pass of the layers first, ..., last recomputes the saved pass without
+   * changing the state of the layers again.
+   */
+  void RestoreStageState(const size_t first,
+                         const size_t last,
+                         const std::vector<arma::mat>& states);
+
+  /**
+   * Run the backward and gradient pass of the layers first, ..., last, with
+   * the given input of the stage (for the gradient of the first layer) and
+   * the given error of the output of the last layer.  The delta of the first
+   * layer is only computed if first is not the first layer of the network.
+   */
+  void StageBackward(const size_t first,
+                     const size_t last,
+                     arma::mat& input,
+                     arma::mat& outputError);
+
+  /**
+   * Build the worker replicas used by ParallelGradient(), so that there are
+   * the given number of replicas which share the parameters of this network.
+   */
+  void ResetReplicas(const size_t numReplicas);
+
+  /**
+   * Merge the running statistics that the layers of the worker replicas
+   * collected (those of BatchNorm layers) into the layers of this network,
+   * in the order of the replicas, and reset them in the replicas.
+   */
+  void MergeReplicaStatistics();
+
+  //! Delete all worker replicas.
+  void DeleteReplicas();
+
   /**
    * Reset the module status by setting the current deterministic parameter
    * for all modules that implement the Deterministic function.
@@ -322,6 +655,32 @@ class FFN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Make the planned input block and the output of every layer an alias into
+   * the arena.  The sizes are taken from the current matrices.
+   */
+  void AliasPlan();
+
+  /**
+   * Make the planned input block and the output of every layer own their
+   * memory again, without releasing the arena.
+   */
+  void UnaliasPlan();
+
+  /**
+   * Set the parameters of the layers of the given (new) network and reset its
+   * layers; helper for Fuse() and Quantize().
+   *
+   * @param network The network to set up.
+   * @param layerParameters The parameters of every layer of the network.
+   * @param batchNorms The BatchNorm layers of the network (by index) and the
+   *        layers whose training statistics they take over.
+   */
+  void SetLayerParameters(
+      FFN& network,
+      const std::vector<arma::mat>& layerParameters,
+      const std::vector<std::pair<size_t, BatchNorm<>*> >& batchNorms) const;
+
   /**
    * Swap the content of this network with given network.
    *
@@ -404,6 +763,62 @@ class FFN
 
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
+
+  //! Indicator if the forward pass uses the memory plan.
+  bool planned;
+
+  //! The buffer that holds the planned input block and all layer outputs.
+  arma::mat arena;
+
+  //! The planned input block (an alias into the arena if planned).
+  arma::mat planInput;
+
+  //! The number of threads used to compute the gradient of a batch.
+  size_t numThreads;
+
+  //! The number of pipeline stages used to compute the gradient of a batch.
+  size_t pipelineStages;
+
+  //! The number of microbatches a batch is split into for the pipeline.
+  size_t microbatches;
+
+  //! Indicator if the optimizers should use the sparse gradients.
+  bool sparseGradients;
+
+  //! The dense buffer the sparse gradients are computed into.
+  arma::mat sparseGradientBuffer;
+
+  //! The number of segments of activation checkpointing.
+  size_t checkpointSegments;
+
+  //! The number of activations of each layer per point, on the last batch
+  //! computed with checkpointing.
+  std::vector<size_t> activationSizes;
+
+  //! The format whose precision the gradient emulates.
+  PrecisionType emulatedPrecision;
+
+  //! The current loss scale of mixed precision training.
+  double lossScale;
+
+  //! The number of steps without overflow after which the loss scale is
+  //! doubled.
+  size_t lossScaleWindow;
+
+  //! The number of steps without overflow since the loss scale changed.
+  size_t scaledSteps;
+
+  //! The full precision parameters, while the network uses rounded ones.
+  arma::mat masterParameter;
+
+  //! Worker-local copies of the network that share our parameters.
+  std::vector<FFN*> replicas;
+
+  //! Gradients of the worker replicas.
+  std::vector<arma::mat> replicaGradients;
+
+  //! The parameter memory the worker replicas were built for.
+  const double* replicaParameterMemory;
 }; // class FFN
 
 } // namespace ann
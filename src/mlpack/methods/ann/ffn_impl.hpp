@@ -20,11 +20,27 @@
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
+#include "visitor/restore_forward_state_visitor.hpp"
+#include "visitor/running_statistics_visitor.hpp"
+#include "visitor/save_forward_state_visitor.hpp"
 #include "visitor/set_input_height_visitor.hpp"
 #include "visitor/set_input_width_visitor.hpp"
+#include "visitor/sparse_gradient_visitor.hpp"
+
+#include "layer/convolution.hpp"
+#include "layer/dropconnect.hpp"
+#include "layer/linear.hpp"
+#include "layer/linear_no_bias.hpp"
+#include "layer/quantized_convolution.hpp"
+#include "layer/quantized_linear.hpp"
 
 #include <boost/serialization/variant.hpp>
 
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -39,7 +55,18 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    planned(false),
+    numThreads(1),
+    pipelineStages(1),
+    microbatches(4),
+    sparseGradients(false),
+    checkpointSegments(1),
+    emulatedPrecision(DOUBLE_PRECISION),
+    lossScale(65536.0),
+    lossScaleWindow(2000),
+    scaledSteps(0),
+    replicaParameterMemory(NULL)
 {
   /* Nothing to do here */
 }
@@ -58,7 +85,18 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     reset(false),
     predictors(std::move(predictors)),
     responses(std::move(responses)),
-    deterministic(true)
+    deterministic(true),
+    planned(false),
+    numThreads(1),
+    pipelineStages(1),
+    microbatches(4),
+    sparseGradients(false),
+    checkpointSegments(1),
+    emulatedPrecision(DOUBLE_PRECISION),
+    lossScale(65536.0),
+    lossScaleWindow(2000),
+    scaledSteps(0),
+    replicaParameterMemory(NULL)
 {
   numFunctions = this->responses.n_cols;
 }
@@ -67,6 +105,8 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::~FFN()
 {
+  DeleteReplicas();
+
   std::for_each(network.begin(), network.end(),
       boost::apply_visitor(deleteVisitor));
 }
@@ -105,6 +145,26 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
       << "." << std::endl;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename CallbackType>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+      arma::mat predictors,
+      arma::mat responses,
+      OptimizerType& optimizer,
+      CallbackType& callback)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callback);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename OptimizerType>
@@ -133,6 +193,28 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
       << "." << std::endl;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename LoaderType, typename OptimizerType>
+size_t FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Update(
+    LoaderType& loader, OptimizerType& optimizer)
+{
+  arma::mat batchPredictors, batchResponses;
+  size_t batches = 0;
+  while (loader(batchPredictors, batchResponses))
+  {
+    if (batchPredictors.n_cols == 0)
+      continue;
+
+    Train(std::move(batchPredictors), std::move(batchResponses), optimizer);
+    ++batches;
+  }
+
+  Log::Info << "FFN::Update(): updated the model with " << batches
+      << " batches." << std::endl;
+  return batches;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
@@ -175,8 +257,14 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::mat predictors, arma::mat& results)
+    arma::mat predictors, arma::mat& results, const size_t batchSize)
 {
+  if (batchSize == 0)
+  {
+    Log::Fatal << "FFN::Predict(): batch size must be greater than zero!"
+        << std::endl;
+  }
+
   if (parameter.is_empty())
     ResetParameters();
 
@@ -186,23 +274,430 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(std::move(arma::mat(predictors.colptr(0),
-      predictors.n_rows, 1, false, true)));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
+  // With a memory plan every block has to be of the planned size.
+  const size_t blockSize = planned ? planInput.n_cols : batchSize;
+  for (size_t i = 0; i < predictors.n_cols; i += blockSize)
+  {
+    const size_t effectiveBatchSize = std::min(blockSize,
+        size_t(predictors.n_cols - i));
 
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
+    if (planned)
+    {
+      // Stage the block in the preallocated input; pad the last block.
+      planInput.cols(0, effectiveBatchSize - 1) = predictors.cols(i,
+          i + effectiveBatchSize - 1);
+      if (effectiveBatchSize < blockSize)
+        planInput.cols(effectiveBatchSize, blockSize - 1).zeros();
 
-  for (size_t i = 1; i < predictors.n_cols; i++)
-  {
-    Forward(std::move(arma::mat(predictors.colptr(i),
-        predictors.n_rows, 1, false, true)));
+      Forward(std::move(planInput));
+    }
+    else
+    {
+      Forward(std::move(arma::mat(predictors.colptr(i), predictors.n_rows,
+          effectiveBatchSize, false, true)));
+    }
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
         network.back());
-    results.col(i) = resultsTemp.col(0);
+
+    // Now we know the size of the network output.
+    if (i == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    results.cols(i, i + effectiveBatchSize - 1) =
+        output.cols(0, effectiveBatchSize - 1);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Plan(
+    const size_t inputSize, const size_t batchSize)
+{
+  if (inputSize == 0 || batchSize == 0)
+  {
+    Log::Fatal << "FFN::Plan(): input size and batch size must be greater "
+        << "than zero!" << std::endl;
+  }
+
+  ReleasePlan();
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  // Run the network once, so that every layer knows the size of its output.
+  planInput.zeros(inputSize, batchSize);
+  Forward(std::move(planInput));
+
+  size_t elements = planInput.n_elem;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    elements += boost::apply_visitor(outputParameterVisitor,
+        network[i]).n_elem;
+  }
+
+  arena.zeros(elements, 1);
+  planned = true;
+  AliasPlan();
+
+  return PlannedMemory();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Fuse(FFN& network) const
+{
+  if (parameter.is_empty())
+  {
+    Log::Fatal << "FFN::Fuse(): the network has no parameters; train or "
+        << "initialize it first!" << std::endl;
+  }
+
+  network = FFN(outputLayer, initializeRule);
+  network.width = width;
+  network.height = height;
+
+  // The parameters of every layer of the new network, and the BatchNorm layers
+  // that are copied together with their (original) training statistics.
+  std::vector<arma::mat> layerParameters;
+  std::vector<std::pair<size_t, BatchNorm<>*> > batchNorms;
+
+  // The weight and the bias of the Linear layer that the following layers are
+  // folded into.
+  arma::mat weight;
+  arma::vec bias;
+  bool folding = false;
+
+  // Add the Linear layer that is currently folded, if any.
+  auto addFolded = [&]()
+  {
+    if (!folding)
+      return;
+
+    network.network.push_back(new Linear<>(weight.n_cols, weight.n_rows));
+    layerParameters.push_back(arma::join_cols(arma::vectorise(weight), bias));
+    folding = false;
+  };
+
+  WeightSizeVisitor weightSize;
+  CopyVisitor<CustomLayers...> copy;
+
+  size_t offset = 0;
+  for (size_t i = 0; i < this->network.size(); ++i)
+  {
+    const LayerTypes<CustomLayers...>& layer = this->network[i];
+
+    // The parameters of the layer.
+    const size_t size = boost::apply_visitor(weightSize, layer);
+    arma::mat layerParameter;
+    if (size > 0)
+      layerParameter = parameter.rows(offset, offset + size - 1);
+    offset += size;
+
+    Linear<>* const* linear = boost::get<Linear<>*>(&layer);
+    LinearNoBias<>* const* linearNoBias = boost::get<LinearNoBias<>*>(&layer);
+    DropConnect<>* const* dropConnect = boost::get<DropConnect<>*>(&layer);
+    BatchNorm<>* const* batchNorm = boost::get<BatchNorm<>*>(&layer);
+    MultiplyConstant<>* const* multiplyConstant =
+        boost::get<MultiplyConstant<>*>(&layer);
+    Dropout<>* const* dropout = boost::get<Dropout<>*>(&layer);
+
+    // In deterministic mode DropConnect is its Linear layer, whose weights
+    // follow the (own) parameters of the DropConnect layer.
+    if (dropConnect)
+    {
+      linear = boost::get<Linear<>*>(&(*dropConnect)->Model()[0]);
+      if (linear)
+      {
+        layerParameter = layerParameter.rows(
+            (*dropConnect)->Parameters().n_elem, size - 1);
+      }
+    }
+
+    if (linear || linearNoBias)
+    {
+      addFolded();
+
+      const size_t inSize = linear ? (*linear)->InputSize() :
+          (*linearNoBias)->InputSize();
+      const size_t outSize = linear ? (*linear)->OutputSize() :
+          (*linearNoBias)->OutputSize();
+
+      weight = arma::reshape(layerParameter.rows(0, outSize * inSize - 1),
+          outSize, inSize);
+      if (linear)
+      {
+        bias = layerParameter.rows(outSize * inSize,
+            outSize * inSize + outSize - 1);
+      }
+      else
+      {
+        bias = arma::zeros<arma::vec>(outSize);
+      }
+
+      folding = true;
+    }
+    else if (batchNorm && folding)
+    {
+      // y = (x - mean) / sqrt(variance + eps) * gamma + beta.
+      const size_t n = weight.n_rows;
+      const arma::vec scale = layerParameter.rows(0, n - 1) /
+          arma::sqrt((*batchNorm)->TrainingVariance() +
+          (*batchNorm)->Epsilon());
+
+      weight.each_col() %= scale;
+      bias = (bias - (*batchNorm)->TrainingMean()) % scale +
+          layerParameter.rows(n, 2 * n - 1);
+    }
+    else if (multiplyConstant && folding)
+    {
+      weight *= (*multiplyConstant)->Scalar();
+      bias *= (*multiplyConstant)->Scalar();
+    }
+    else if (dropout && !(*dropout)->Rescale())
+    {
+      // The layer is the identity in deterministic mode.
+    }
+    else if (dropout && folding)
+    {
+      weight *= 1.0 / (1.0 - (*dropout)->Ratio());
+      bias *= 1.0 / (1.0 - (*dropout)->Ratio());
+    }
+    else
+    {
+      addFolded();
+
+      if (batchNorm)
+      {
+        batchNorms.push_back(std::make_pair(network.network.size(),
+            *batchNorm));
+      }
+
+      network.network.push_back(boost::apply_visitor(copy, layer));
+      layerParameters.push_back(layerParameter);
+    }
+  }
+  addFolded();
+
+  SetLayerParameters(network, layerParameters, batchNorms);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::Quantize(const arma::mat& calibrationData,
+                                    FFN& network)
+{
+  if (parameter.is_empty())
+  {
+    Log::Fatal << "FFN::Quantize(): the network has no parameters; train or "
+        << "initialize it first!" << std::endl;
+  }
+
+  // Run the calibration data through the network, so that the input of every
+  // layer is known.
+  arma::mat results;
+  Forward(calibrationData, results);
+
+  network = FFN(outputLayer, initializeRule);
+  network.width = width;
+  network.height = height;
+
+  std::vector<arma::mat> layerParameters;
+  std::vector<std::pair<size_t, BatchNorm<>*> > batchNorms;
+
+  WeightSizeVisitor weightSize;
+  CopyVisitor<CustomLayers...> copy;
+
+  size_t offset = 0;
+  for (size_t i = 0; i < this->network.size(); ++i)
+  {
+    const LayerTypes<CustomLayers...>& layer = this->network[i];
+
+    // The parameters of the layer.
+    const size_t size = boost::apply_visitor(weightSize, layer);
+    arma::mat layerParameter;
+    if (size > 0)
+      layerParameter = parameter.rows(offset, offset + size - 1);
+    offset += size;
+
+    Linear<>* const* linear = boost::get<Linear<>*>(&layer);
+    LinearNoBias<>* const* linearNoBias = boost::get<LinearNoBias<>*>(&layer);
+    DropConnect<>* const* dropConnect = boost::get<DropConnect<>*>(&layer);
+    Convolution<>* const* convolution = boost::get<Convolution<>*>(&layer);
+    BatchNorm<>* const* batchNorm = boost::get<BatchNorm<>*>(&layer);
+
+    if (dropConnect)
+    {
+      linear = boost::get<Linear<>*>(&(*dropConnect)->Model()[0]);
+      if (linear)
+      {
+        layerParameter = layerParameter.rows(
+            (*dropConnect)->Parameters().n_elem, size - 1);
+      }
+    }
+
+    if (!linear && !linearNoBias && !convolution)
+    {
+      if (batchNorm)
+      {
+        batchNorms.push_back(std::make_pair(network.network.size(),
+            *batchNorm));
+      }
+
+      network.network.push_back(boost::apply_visitor(copy, layer));
+      layerParameters.push_back(layerParameter);
+      continue;
+    }
+
+    // The scale of the input of the layer.
+    const arma::mat& input = (i == 0) ? calibrationData :
+        boost::apply_visitor(outputParameterVisitor, this->network[i - 1]);
+    const double inputScale = Quantization::Scale(input.is_empty() ? 0.0 :
+        (double) arma::abs(input).max());
+
+    if (convolution)
+    {
+      const Convolution<>& conv = **convolution;
+      const size_t weightElem = conv.KernelWidth() * conv.KernelHeight() *
+          conv.InSize() * conv.OutSize();
+
+      const arma::cube weight(layerParameter.memptr(), conv.KernelWidth(),
+          conv.KernelHeight(), conv.OutSize() * conv.InSize());
+      const arma::vec bias = layerParameter.rows(weightElem,
+          weightElem + conv.OutSize() - 1);
+
+      network.network.push_back(new QuantizedConvolution<>(conv.InSize(),
+          conv.OutSize(), weight, bias, inputScale, conv.StrideWidth(),
+          conv.StrideHeight(), conv.PadWidth(), conv.PadHeight(),
+          conv.InputWidth(), conv.InputHeight()));
+    }
+    else
+    {
+      const size_t inSize = linear ? (*linear)->InputSize() :
+          (*linearNoBias)->InputSize();
+      const size_t outSize = linear ? (*linear)->OutputSize() :
+          (*linearNoBias)->OutputSize();
+
+      const arma::mat weight = arma::reshape(layerParameter.rows(0,
+          outSize * inSize - 1), outSize, inSize);
+      const arma::vec bias = linear ? arma::vec(layerParameter.rows(
+          outSize * inSize, outSize * inSize + outSize - 1)) :
+          arma::vec(arma::zeros<arma::vec>(outSize));
+
+      network.network.push_back(new QuantizedLinear<>(weight, bias,
+          inputScale));
+    }
+
+    // The quantized layers have no parameters.
+    layerParameters.push_back(arma::mat());
+  }
+
+  SetLayerParameters(network, layerParameters, batchNorms);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SetLayerParameters(
+    FFN& network,
+    const std::vector<arma::mat>& layerParameters,
+    const std::vector<std::pair<size_t, BatchNorm<>*> >& batchNorms) const
+{
+  // Collect the parameters of the new layers.
+  size_t numParameters = 0;
+  for (size_t i = 0; i < layerParameters.size(); ++i)
+    numParameters += layerParameters[i].n_elem;
+
+  network.parameter.set_size(numParameters, 1);
+  size_t offset = 0;
+  for (size_t i = 0; i < layerParameters.size(); ++i)
+  {
+    if (layerParameters[i].n_elem > 0)
+    {
+      network.parameter.rows(offset, offset + layerParameters[i].n_elem - 1) =
+          arma::vectorise(layerParameters[i]);
+    }
+    offset += layerParameters[i].n_elem;
+  }
+
+  // Let the layers use the new parameters.  Some layers (e.g. BatchNorm)
+  // initialize their weights in Reset(), so restore them afterwards.
+  const arma::mat parameterBackup = network.parameter;
+
+  offset = 0;
+  for (size_t i = 0; i < network.network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(std::move(
+        network.parameter), offset), network.network[i]);
+
+    boost::apply_visitor(network.resetVisitor, network.network[i]);
+  }
+
+  network.parameter = parameterBackup;
+
+  // Reset() cleared the training statistics of the copied BatchNorm layers.
+  for (size_t i = 0; i < batchNorms.size(); ++i)
+  {
+    boost::get<BatchNorm<>*>(network.network[batchNorms[i].first])->Stats() =
+        batchNorms[i].second->Stats();
+  }
+
+  network.reset = true;
+  network.deterministic = true;
+  network.ResetDeterministic();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ReleasePlan()
+{
+  if (!planned)
+    return;
+
+  UnaliasPlan();
+  arena.reset();
+  planned = false;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::UnaliasPlan()
+{
+  math::ReleaseAlias(planInput);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    math::ReleaseAlias(boost::apply_visitor(outputParameterVisitor,
+        network[i]));
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::AliasPlan()
+{
+  size_t offset = 0;
+  math::MakeAlias(planInput, arena.memptr(), planInput.n_rows,
+      planInput.n_cols);
+  offset += planInput.n_elem;
+
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    math::MakeAlias(output, arena.memptr() + offset, output.n_rows,
+        output.n_cols);
+    offset += output.n_elem;
   }
 }
 
@@ -263,6 +758,35 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
     gradient.zeros();
   }
 
+  if (emulatedPrecision != DOUBLE_PRECISION)
+  {
+    EmulatedPrecisionGradient(begin, gradient, batchSize);
+    return;
+  }
+
+  // Checkpointing, the pipeline and the worker replicas all need the input
+  // size of every layer, so the network has to be run once before.
+  if (checkpointSegments != 1 && network.size() > 1 && reset)
+  {
+    CheckpointGradient(begin, gradient, batchSize);
+    return;
+  }
+
+  if (pipelineStages > 1 && network.size() > 1 && batchSize > 1 && reset)
+  {
+    PipelineGradient(begin, gradient, batchSize);
+    return;
+  }
+
+#ifdef HAS_OPENMP
+  // Split the batch across the worker replicas.
+  if (numThreads > 1 && batchSize > 1 && reset)
+  {
+    ParallelGradient(begin, gradient, batchSize);
+    return;
+  }
+#endif
+
   Evaluate(parameters, begin, batchSize, false);
 
   outputLayer.Backward(
@@ -275,6 +799,684 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
   Gradient(std::move(predictors.cols(begin, begin + batchSize - 1)));
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  // The untouched columns of the sparse layers are never read from the
+  // buffer, so it is only cleared when it is allocated.
+  if (sparseGradientBuffer.n_elem != parameter.n_elem)
+    sparseGradientBuffer.zeros(parameter.n_rows, parameter.n_cols);
+
+  Evaluate(parameters, begin, batchSize, false);
+
+  outputLayer.Backward(
+      std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
+      std::move(responses.cols(begin, begin + batchSize - 1)),
+      std::move(error));
+
+  Backward();
+
+  std::vector<size_t> offsets(network.size() + 1, 0);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offsets[i + 1] = offsets[i] + boost::apply_visitor(GradientSetVisitor(
+        std::move(sparseGradientBuffer), offsets[i]), network[i]);
+  }
+
+  // Each layer gets the same input and delta as in Gradient(arma::mat&&).
+  arma::mat batchInput = predictors.cols(begin, begin + batchSize - 1);
+  std::vector<arma::uword> indices;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    arma::mat& input = (i == 0) ? batchInput :
+        boost::apply_visitor(outputParameterVisitor, network[i - 1]);
+    arma::mat& layerDelta = (i == network.size() - 1) ? error :
+        boost::apply_visitor(deltaVisitor, network[i + 1]);
+
+    if (boost::apply_visitor(SparseGradientVisitor(std::move(input),
+        std::move(layerDelta), offsets[i], indices), network[i]))
+    {
+      continue;
+    }
+
+    if (offsets[i + 1] == offsets[i])
+      continue;
+
+    sparseGradientBuffer.rows(offsets[i], offsets[i + 1] - 1).zeros();
+    boost::apply_visitor(GradientVisitor(std::move(input),
+        std::move(layerDelta)), network[i]);
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      indices.push_back(j);
+  }
+
+  // The indices are in increasing order, since the layers are.
+  arma::umat locations(2, indices.size(), arma::fill::zeros);
+  arma::vec values(indices.size());
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    locations(0, i) = indices[i];
+    values[i] = sparseGradientBuffer[indices[i]];
+  }
+
+  gradient = arma::sp_mat(locations, values, parameter.n_rows,
+      parameter.n_cols, false, false);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::BatchGradient(arma::mat&& input,
+                                         arma::mat&& target,
+                                         arma::mat& gradient)
+{
+  if (deterministic)
+  {
+    deterministic = false;
+    ResetDeterministic();
+  }
+
+  Forward(std::move(input));
+  outputLayer.Forward(std::move(boost::apply_visitor(outputParameterVisitor,
+      network.back())), std::move(target));
+
+  outputLayer.Backward(
+      std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
+      std::move(target), std::move(error));
+
+  Backward();
+  ResetGradients(gradient);
+  Gradient(std::move(input));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ParallelGradient(const size_t begin,
+                                            arma::mat& gradient,
+                                            const size_t batchSize)
+{
+  const size_t threads = std::min(numThreads, batchSize);
+
+  // This network handles the first part of the batch itself.
+  ResetReplicas(threads - 1);
+  replicaGradients.resize(threads - 1);
+  for (size_t i = 0; i < replicaGradients.size(); ++i)
+    replicaGradients[i].zeros(parameter.n_rows, parameter.n_cols);
+
+  #pragma omp parallel for num_threads(threads)
+  for (omp_size_t t = 0; t < (omp_size_t) threads; ++t)
+  {
+    const size_t first = begin + t * batchSize / threads;
+    const size_t last = begin + (t + 1) * batchSize / threads - 1;
+
+    FFN& worker = (t == 0) ? *this : *replicas[t - 1];
+    arma::mat& workerGradient = (t == 0) ? gradient : replicaGradients[t - 1];
+
+    worker.BatchGradient(predictors.cols(first, last),
+        responses.cols(first, last), workerGradient);
+  }
+
+  // The gradient of the batch is the sum of the gradients of its parts.
+  for (size_t i = 0; i < replicaGradients.size(); ++i)
+    gradient += replicaGradients[i];
+
+  MergeReplicaStatistics();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PipelineGradient(const size_t begin,
+                                            arma::mat& gradient,
+                                            const size_t batchSize)
+{
+  // The microbatches have other shapes than the planned batch.
+  ReleasePlan();
+
+  if (deterministic)
+  {
+    deterministic = false;
+    ResetDeterministic();
+  }
+
+  // Split the layers into stages with about the same number of parameters;
+  // stage s holds the layers firstLayer[s], ..., firstLayer[s + 1] - 1.
+  const size_t stages = std::min(pipelineStages, network.size());
+  std::vector<size_t> firstLayer(1, 0);
+  size_t weights = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    weights += boost::apply_visitor(weightSizeVisitor, network[i]);
+    const size_t layersLeft = network.size() - i - 1;
+    const size_t stagesLeft = stages - firstLayer.size();
+    if (stagesLeft > 0 && (layersLeft == stagesLeft ||
+        weights * stages >= firstLayer.size() * parameter.n_elem))
+    {
+      firstLayer.push_back(i + 1);
+    }
+  }
+  firstLayer.push_back(network.size());
+
+  // The layers write their gradients into the scratch gradient, and every
+  // stage adds its part to the gradient after each microbatch.
+  std::vector<size_t> firstWeight(network.size() + 1, 0);
+  arma::mat microbatchGradient(parameter.n_rows, parameter.n_cols,
+      arma::fill::zeros);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    firstWeight[i + 1] = firstWeight[i] + boost::apply_visitor(
+        GradientSetVisitor(std::move(microbatchGradient), firstWeight[i]),
+        network[i]);
+  }
+
+  const size_t parts = std::max((size_t) 1, std::min(microbatches,
+      batchSize));
+  std::vector<size_t> firstPoint(parts + 1);
+  for (size_t m = 0; m <= parts; ++m)
+    firstPoint[m] = begin + m * batchSize / parts;
+
+  // inputs[s][m] is the input of stage s for microbatch m, errors[s][m] the
+  // error of that input, and states[s][m] the state of the forward pass,
+  // which is replayed when it is recomputed; ready[s * parts + m] tells that
+  // inputs[s][m] is there, and done[s * parts + m] that errors[s][m] is.
+  std::vector<std::vector<arma::mat> > inputs(stages,
+      std::vector<arma::mat>(parts));
+  std::vector<std::vector<arma::mat> > errors(stages,
+      std::vector<arma::mat>(parts));
+  std::vector<std::vector<std::vector<arma::mat> > > states(stages,
+      std::vector<std::vector<arma::mat> >(parts));
+  std::unique_ptr<std::atomic<bool>[]> ready(
+      new std::atomic<bool>[stages * parts]);
+  std::unique_ptr<std::atomic<bool>[]> done(
+      new std::atomic<bool>[stages * parts]);
+  for (size_t i = 0; i < stages * parts; ++i)
+  {
+    ready[i] = (i < parts);
+    done[i] = false;
+  }
+
+  for (size_t m = 0; m < parts; ++m)
+    inputs[0][m] = predictors.cols(firstPoint[m], firstPoint[m + 1] - 1);
+
+  // Add the scratch gradient of the layers of a stage to the gradient.
+  auto accumulate = [&](const size_t s)
+  {
+    const size_t first = firstWeight[firstLayer[s]];
+    const size_t last = firstWeight[firstLayer[s + 1]];
+    if (last > first)
+    {
+      gradient.rows(first, last - 1) += microbatchGradient.rows(first,
+          last - 1);
+      microbatchGradient.rows(first, last - 1).zeros();
+    }
+  };
+
+  auto wait = [](const std::atomic<bool>& flag)
+  {
+    while (!flag.load(std::memory_order_acquire))
+      std::this_thread::yield();
+  };
+
+  // Thread t runs the stages t, t + threads, ...; the forward passes in
+  // increasing and the backward passes in decreasing order of the stages, so
+  // there is always a stage that can make progress, even if there are fewer
+  // threads than stages.
+  #pragma omp parallel num_threads(stages)
+  {
+    size_t thread = 0, threads = 1;
+    #ifdef HAS_OPENMP
+      thread = omp_get_thread_num();
+      threads = omp_get_num_threads();
+    #endif
+
+    for (size_t s = thread; s < stages; s += threads)
+    {
+      const size_t first = firstLayer[s], last = firstLayer[s + 1] - 1;
+      for (size_t m = 0; m < parts; ++m)
+      {
+        wait(ready[s * parts + m]);
+        StageForward(first, last, inputs[s][m]);
+
+        if (s + 1 < stages)
+        {
+          SaveStageState(first, last, states[s][m]);
+          inputs[s + 1][m] = boost::apply_visitor(outputParameterVisitor,
+              network[last]);
+          ready[(s + 1) * parts + m].store(true, std::memory_order_release);
+          continue;
+        }
+
+        // The last stage runs the output layer and the backward pass of the
+        // microbatch right away.
+        arma::mat target = responses.cols(firstPoint[m],
+            firstPoint[m + 1] - 1);
+        arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+            network[last]);
+        outputLayer.Forward(std::move(output), std::move(target));
+        outputLayer.Backward(std::move(output), std::move(target),
+            std::move(error));
+
+        StageBackward(first, last, inputs[s][m], error);
+        accumulate(s);
+        if (s > 0)
+        {
+          errors[s][m] = boost::apply_visitor(deltaVisitor, network[first]);
+          done[s * parts + m].store(true, std::memory_order_release);
+        }
+      }
+    }
+
+    std::vector<size_t> ownStages;
+    for (size_t s = thread; s + 1 < stages; s += threads)
+      ownStages.push_back(s);
+
+    for (size_t k = ownStages.size(); k-- > 0; )
+    {
+      const size_t s = ownStages[k];
+      const size_t first = firstLayer[s], last = firstLayer[s + 1] - 1;
+      for (size_t m = 0; m < parts; ++m)
+      {
+        wait(done[(s + 1) * parts + m]);
+
+        // Recompute the forward pass of the stage for this microbatch.
+        RestoreStageState(first, last, states[s][m]);
+        StageForward(first, last, inputs[s][m]);
+        states[s][m].clear();
+        StageBackward(first, last, inputs[s][m], errors[s + 1][m]);
+        accumulate(s);
+        if (s > 0)
+        {
+          errors[s][m] = boost::apply_visitor(deltaVisitor, network[first]);
+          done[s * parts + m].store(true, std::memory_order_release);
+        }
+      }
+    }
+  }
+
+  // Don't leave the layers with gradients in the scratch memory.
+  ResetGradients(gradient);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::CheckpointGradient(const size_t begin,
+                                              arma::mat& gradient,
+                                              const size_t batchSize)
+{
+  // The outputs are freed, so they can't be aliases into the arena.
+  ReleasePlan();
+
+  if (deterministic)
+  {
+    deterministic = false;
+    ResetDeterministic();
+  }
+
+  const size_t layers = network.size();
+  const size_t segments = std::min(layers, (checkpointSegments == 0) ?
+      (size_t) std::ceil(std::sqrt((double) layers)) : checkpointSegments);
+
+  // Segment k holds the layers firstLayer[k], ..., firstLayer[k + 1] - 1,
+  // with about the same number of activations as measured on the last batch
+  // (or the same number of layers, on the first one).
+  std::vector<size_t> firstLayer(1, 0);
+  if (activationSizes.size() == layers)
+  {
+    const size_t total = std::accumulate(activationSizes.begin(),
+        activationSizes.end(), (size_t) 0);
+    size_t sum = 0;
+    for (size_t i = 0; i + 1 < layers; ++i)
+    {
+      sum += activationSizes[i];
+      const size_t layersLeft = layers - i - 1;
+      const size_t segmentsLeft = segments - firstLayer.size();
+      if (segmentsLeft > 0 && (layersLeft == segmentsLeft ||
+          sum * segments >= firstLayer.size() * total))
+      {
+        firstLayer.push_back(i + 1);
+      }
+    }
+  }
+  else
+  {
+    for (size_t k = 1; k < segments; ++k)
+      firstLayer.push_back(k * layers / segments);
+  }
+  firstLayer.push_back(layers);
+  activationSizes.resize(layers);
+
+  // inputs[k] is the checkpoint: the input of segment k; states[k] holds the
+  // state of its forward pass, which is replayed when it is recomputed.
+  std::vector<arma::mat> inputs(segments);
+  std::vector<std::vector<arma::mat> > states(segments);
+  inputs[0] = predictors.cols(begin, begin + batchSize - 1);
+  for (size_t k = 0; k < segments; ++k)
+  {
+    const size_t first = firstLayer[k], last = firstLayer[k + 1] - 1;
+    StageForward(first, last, inputs[k]);
+    for (size_t i = first; i <= last; ++i)
+    {
+      activationSizes[i] = boost::apply_visitor(outputParameterVisitor,
+          network[i]).n_rows;
+    }
+
+    if (k + 1 < segments)
+    {
+      SaveStageState(first, last, states[k]);
+      inputs[k + 1] = boost::apply_visitor(outputParameterVisitor,
+          network[last]);
+      for (size_t i = first; i <= last; ++i)
+        boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+    }
+  }
+
+  arma::mat targets = responses.cols(begin, begin + batchSize - 1);
+  outputLayer.Forward(std::move(boost::apply_visitor(outputParameterVisitor,
+      network.back())), std::move(targets));
+  outputLayer.Backward(std::move(boost::apply_visitor(outputParameterVisitor,
+      network.back())), std::move(targets), std::move(error));
+
+  ResetGradients(gradient);
+  for (size_t k = segments; k-- > 0; )
+  {
+    const size_t first = firstLayer[k], last = firstLayer[k + 1] - 1;
+    if (k + 1 < segments)
+    {
+      RestoreStageState(first, last, states[k]);
+      StageForward(first, last, inputs[k]);
+      states[k].clear();
+    }
+
+    arma::mat& segmentError = (k + 1 == segments) ? error :
+        boost::apply_visitor(deltaVisitor, network[last + 1]);
+    StageBackward(first, last, inputs[k], segmentError);
+
+    // Only the error of the input of this segment is needed from now on.
+    if (k + 1 < segments)
+    {
+      segmentError.reset();
+      inputs[k + 1].reset();
+      for (size_t i = first; i <= last; ++i)
+        boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+    }
+
+    for (size_t i = first + 1; i <= last; ++i)
+      boost::apply_visitor(deltaVisitor, network[i]).reset();
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::EmulatedPrecisionGradient(const size_t begin,
+                                                  arma::mat& gradient,
+                                                  const size_t batchSize)
+{
+  if (deterministic)
+  {
+    deterministic = false;
+    ResetDeterministic();
+  }
+
+  arma::mat input = predictors.cols(begin, begin + batchSize - 1);
+  arma::mat targets = responses.cols(begin, begin + batchSize - 1);
+
+  // The layers need their input sizes, and the memory plan only holds for
+  // inputs of the planned shape.  The pass that sizes the layers is replayed
+  // by the rounded pass below, so the layers (e.g. Dropout, BatchNorm and
+  // MaxPooling) only change their state once.
+  if (!reset)
+  {
+    std::vector<arma::mat> states;
+    Forward(arma::mat(input));
+    SaveStageState(0, network.size() - 1, states);
+    RestoreStageState(0, network.size() - 1, states);
+  }
+  if (planned && (input.n_rows != planInput.n_rows ||
+      input.n_cols != planInput.n_cols))
+  {
+    ReleasePlan();
+  }
+
+  // The layers use the weights as they would be stored, while the parameters
+  // the optimizer updates keep full precision.
+  masterParameter = parameter;
+  ReducedPrecision::Round(parameter, emulatedPrecision);
+  ReducedPrecision::Round(input, emulatedPrecision);
+
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    StageForward(i, i, (i == 0) ? input :
+        boost::apply_visitor(outputParameterVisitor, network[i - 1]));
+    if (boost::apply_visitor(weightSizeVisitor, network[i]) > 0)
+    {
+      ReducedPrecision::Round(boost::apply_visitor(outputParameterVisitor,
+          network[i]), emulatedPrecision);
+    }
+  }
+
+  arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  outputLayer.Forward(std::move(output), std::move(targets));
+  outputLayer.Backward(std::move(output), std::move(targets),
+      std::move(error));
+
+  // Scale the error up, so that the errors of the layers do not underflow.
+  error *= lossScale;
+  ReducedPrecision::Round(error, emulatedPrecision);
+
+  ResetGradients(gradient);
+  for (size_t i = network.size(); i-- > 0; )
+  {
+    arma::mat& layerInput = (i == 0) ? input :
+        boost::apply_visitor(outputParameterVisitor, network[i - 1]);
+    arma::mat& layerError = (i == network.size() - 1) ? error :
+        boost::apply_visitor(deltaVisitor, network[i + 1]);
+    StageBackward(i, i, layerInput, layerError);
+    if (i > 0)
+    {
+      ReducedPrecision::Round(boost::apply_visitor(deltaVisitor, network[i]),
+          emulatedPrecision);
+    }
+  }
+
+  parameter = masterParameter;
+
+  // Halve the loss scale on overflow, and leave the gradient as it is so that
+  // the step is skipped; double it after enough steps without overflow.
+  if (!gradient.is_finite())
+  {
+    Log::Info << "FFN::Gradient(): the gradient overflowed; the loss scale is "
+        << "now " << std::max(lossScale / 2.0, 1.0) << "." << std::endl;
+    lossScale = std::max(lossScale / 2.0, 1.0);
+    scaledSteps = 0;
+    return;
+  }
+
+  gradient /= lossScale;
+  if (++scaledSteps >= lossScaleWindow)
+  {
+    lossScale *= 2.0;
+    scaledSteps = 0;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::StageForward(const size_t first,
+                                        const size_t last,
+                                        arma::mat& input)
+{
+  boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
+      boost::apply_visitor(outputParameterVisitor, network[first]))),
+      network[first]);
+
+  for (size_t i = first + 1; i <= last; ++i)
+  {
+    boost::apply_visitor(ForwardVisitor(std::move(boost::apply_visitor(
+        outputParameterVisitor, network[i - 1])), std::move(
+        boost::apply_visitor(outputParameterVisitor, network[i]))), network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SaveStageState(const size_t first,
+                                          const size_t last,
+                                          std::vector<arma::mat>& states)
+{
+  states.clear();
+  for (size_t i = first; i <= last; ++i)
+    boost::apply_visitor(SaveForwardStateVisitor(states), network[i]);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::RestoreStageState(
+    const size_t first,
+    const size_t last,
+    const std::vector<arma::mat>& states)
+{
+  size_t position = 0;
+  for (size_t i = first; i <= last; ++i)
+  {
+    boost::apply_visitor(RestoreForwardStateVisitor(states, position),
+        network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::StageBackward(const size_t first,
+                                         const size_t last,
+                                         arma::mat& input,
+                                         arma::mat& outputError)
+{
+  // As in Backward(), the first layer of the network needs no delta.
+  for (size_t i = last + 1; i-- > std::max(first, (size_t) 1); )
+  {
+    arma::mat& layerError = (i == last) ? outputError :
+        boost::apply_visitor(deltaVisitor, network[i + 1]);
+    boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
+        outputParameterVisitor, network[i])), std::move(layerError),
+        std::move(boost::apply_visitor(deltaVisitor, network[i]))),
+        network[i]);
+  }
+
+  for (size_t i = first; i <= last; ++i)
+  {
+    arma::mat& layerInput = (i == first) ? input :
+        boost::apply_visitor(outputParameterVisitor, network[i - 1]);
+    arma::mat& layerError = (i == last) ? outputError :
+        boost::apply_visitor(deltaVisitor, network[i + 1]);
+    boost::apply_visitor(GradientVisitor(std::move(layerInput),
+        std::move(layerError)), network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetReplicas(const size_t numReplicas)
+{
+  // The replicas are still valid if the parameters haven't been reallocated.
+  if (replicas.size() == numReplicas &&
+      replicaParameterMemory == parameter.memptr())
+  {
+    return;
+  }
+
+  DeleteReplicas();
+
+  // Some layers (e.g. BatchNorm) initialize their weights in Reset(), which
+  // would overwrite the shared parameters; so restore them afterwards.
+  const arma::mat parameterBackup = parameter;
+
+  for (size_t i = 0; i < numReplicas; ++i)
+  {
+    FFN* replica = new FFN(outputLayer, initializeRule);
+    for (size_t j = 0; j < network.size(); ++j)
+      replica->network.push_back(boost::apply_visitor(copyVisitor, network[j]));
+
+    replica->width = width;
+    replica->height = height;
+    replica->reset = reset;
+
+    // Let the layers of the replica use our parameters.
+    size_t offset = 0;
+    for (size_t j = 0; j < replica->network.size(); ++j)
+    {
+      offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+          offset), replica->network[j]);
+
+      boost::apply_visitor(resetVisitor, replica->network[j]);
+    }
+
+    replicas.push_back(replica);
+  }
+
+  parameter = parameterBackup;
+  replicaParameterMemory = parameter.memptr();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::MergeReplicaStatistics()
+{
+  std::vector<BatchNormStatistics<double>*> statistics;
+  for (size_t i = 0; i < network.size(); ++i)
+    boost::apply_visitor(RunningStatisticsVisitor(statistics), network[i]);
+
+  if (statistics.empty())
+    return;
+
+  // The layers of the replicas are copies of ours, so their statistics come
+  // in the same order.  Each replica starts with no points again.
+  std::vector<BatchNormStatistics<double>*> replicaStatistics;
+  for (size_t r = 0; r < replicas.size(); ++r)
+  {
+    replicaStatistics.clear();
+    for (size_t i = 0; i < replicas[r]->network.size(); ++i)
+    {
+      boost::apply_visitor(RunningStatisticsVisitor(replicaStatistics),
+          replicas[r]->network[i]);
+    }
+
+    for (size_t i = 0; i < statistics.size(); ++i)
+    {
+      statistics[i]->Merge(*replicaStatistics[i]);
+      replicaStatistics[i]->reset();
+    }
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::DeleteReplicas()
+{
+  for (size_t i = 0; i < replicas.size(); ++i)
+    delete replicas[i];
+
+  replicas.clear();
+  replicaGradients.clear();
+  replicaParameterMemory = NULL;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
@@ -323,6 +1525,13 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(arma::mat&& input)
 {
+  // The memory plan only holds for inputs of the planned shape.
+  if (planned && (input.n_rows != planInput.n_rows ||
+      input.n_cols != planInput.n_cols))
+  {
+    ReleasePlan();
+  }
+
   boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
       boost::apply_visitor(outputParameterVisitor, network.front()))),
       network.front());
@@ -427,6 +1636,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
   // Be sure to clear other layers before loading.
   if (Archive::is_loading::value)
   {
+    ReleasePlan();
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
@@ -458,6 +1668,13 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Swap(FFN& network)
 {
+  // Strict aliases can't be moved, so the layer outputs have to own their
+  // memory during the swap.
+  if (planned)
+    UnaliasPlan();
+  if (network.planned)
+    network.UnaliasPlan();
+
   std::swap(outputLayer, network.outputLayer);
   std::swap(initializeRule, network.initializeRule);
   std::swap(width, network.width);
@@ -475,6 +1692,31 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(planned, network.planned);
+  std::swap(arena, network.arena);
+  std::swap(planInput, network.planInput);
+  std::swap(numThreads, network.numThreads);
+  std::swap(pipelineStages, network.pipelineStages);
+  std::swap(microbatches, network.microbatches);
+  std::swap(sparseGradients, network.sparseGradients);
+  std::swap(sparseGradientBuffer, network.sparseGradientBuffer);
+  std::swap(checkpointSegments, network.checkpointSegments);
+  std::swap(activationSizes, network.activationSizes);
+  std::swap(emulatedPrecision, network.emulatedPrecision);
+  std::swap(lossScale, network.lossScale);
+  std::swap(lossScaleWindow, network.lossScaleWindow);
+  std::swap(scaledSteps, network.scaledSteps);
+
+  // The worker replicas share the parameters of their network, so they are
+  // rebuilt when needed.
+  DeleteReplicas();
+  network.DeleteReplicas();
+
+  // Point the layer outputs at the (swapped) arenas again.
+  if (planned)
+    AliasPlan();
+  if (network.planned)
+    network.AliasPlan();
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -496,7 +1738,21 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    planned(network.planned),
+    arena(network.arena),
+    planInput(network.planInput),
+    numThreads(network.numThreads),
+    pipelineStages(network.pipelineStages),
+    microbatches(network.microbatches),
+    sparseGradients(network.sparseGradients),
+    checkpointSegments(network.checkpointSegments),
+    activationSizes(network.activationSizes),
+    emulatedPrecision(network.emulatedPrecision),
+    lossScale(network.lossScale),
+    lossScaleWindow(network.lossScaleWindow),
+    scaledSteps(network.scaledSteps),
+    replicaParameterMemory(NULL)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -504,6 +1760,10 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     this->network.push_back(boost::apply_visitor(copyVisitor,
         network.network[i]));
   }
+
+  // The copied layers own their output, so point them at our own arena.
+  if (planned)
+    AliasPlan();
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -525,9 +1785,28 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    planned(network.planned),
+    arena(std::move(network.arena)),
+    planInput(std::move(network.planInput)),
+    numThreads(network.numThreads),
+    pipelineStages(network.pipelineStages),
+    microbatches(network.microbatches),
+    sparseGradients(network.sparseGradients),
+    checkpointSegments(network.checkpointSegments),
+    activationSizes(std::move(network.activationSizes)),
+    emulatedPrecision(network.emulatedPrecision),
+    lossScale(network.lossScale),
+    lossScaleWindow(network.lossScaleWindow),
+    scaledSteps(network.scaledSteps),
+    replicaParameterMemory(NULL)
 {
   this->network = std::move(network.network);
+  network.planned = false;
+
+  // A small arena may have been copied instead of moved.
+  if (planned)
+    AliasPlan();
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
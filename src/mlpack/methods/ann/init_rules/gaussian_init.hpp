@@ -55,7 +55,7 @@ class GaussianInitialization
     {
       W = arma::mat(rows, cols);
     }
-    W.imbue( [&]() { return arma::as_scalar(RandNormal(mean, variance)); } );
+    RandNormal(W, mean, variance);
   }
 
   /**
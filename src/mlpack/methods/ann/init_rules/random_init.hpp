@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_INIT_RULES_RANDOM_INIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -55,8 +56,9 @@ class RandomInitialization
   template<typename eT>
   void Initialize(arma::Mat<eT>& W, const size_t rows, const size_t cols)
   {
-    W = lowerBound + arma::randu<arma::Mat<eT>>(rows, cols) *
-        (upperBound - lowerBound);
+    W.set_size(rows, cols);
+    math::RandUniform(W);
+    W = lowerBound + W * (upperBound - lowerBound);
   }
 
   /**
@@ -19,6 +19,94 @@
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
+/**
+ * The running mean and variance of every unit over the training data of a
+ * BatchNorm layer.  The statistics of each batch are merged at once (with the
+ * update of Chan et al.), instead of one point at a time.  The accessors are
+ * those of arma::running_stat_vec.
+ *
+ * @tparam eT Element type of the statistics.
+ */
+template<typename eT>
+class BatchNormStatistics
+{
+ public:
+  //! Create empty statistics.
+  BatchNormStatistics() : points(0) { }
+
+  /**
+   * Add the statistics of a batch.
+   *
+   * @param batchPoints Number of points of the batch.
+   * @param batchMean Mean of every unit over the batch.
+   * @param batchDeviations Sum of the squared deviations from the mean of
+   *     every unit over the batch.
+   */
+  void Merge(const size_t batchPoints,
+             const arma::Mat<eT>& batchMean,
+             const arma::Mat<eT>& batchDeviations)
+  {
+    if (batchPoints == 0)
+      return;
+
+    if (points == 0)
+    {
+      runningMean = batchMean;
+      deviations = batchDeviations;
+      points = batchPoints;
+      return;
+    }
+
+    const double total = (double) points + batchPoints;
+    const arma::Col<eT> difference = batchMean - runningMean;
+    runningMean += difference * eT(batchPoints / total);
+    deviations += batchDeviations + arma::square(difference) *
+        eT(points * (batchPoints / total));
+    points += batchPoints;
+  }
+
+  //! Add the statistics of another object, e.g. of a copy of the layer that
+  //! saw other batches.
+  void Merge(const BatchNormStatistics& other)
+  {
+    Merge(other.points, other.runningMean, other.deviations);
+  }
+
+  //! Get the number of points.
+  eT count() const { return eT(points); }
+
+  //! Get the mean.
+  arma::Col<eT> mean() const { return runningMean; }
+
+  //! Get the variance, normalized by the number of points minus one (or by
+  //! the number of points if normType is 1).
+  arma::Col<eT> var(const arma::uword normType = 0) const
+  {
+    if (points == 0)
+      return arma::Col<eT>();
+    if (normType == 0 && points == 1)
+      return arma::zeros<arma::Col<eT> >(deviations.n_elem);
+
+    return deviations / eT((normType == 1) ? points : points - 1);
+  }
+
+  //! Forget all the points.
+  void reset()
+  {
+    points = 0;
+    runningMean.reset();
+    deviations.reset();
+  }
+
+ private:
+  //! The number of points.
+  size_t points;
+  //! The mean of every unit.
+  arma::Col<eT> runningMean;
+  //! The sum of the squared deviations from the mean of every unit.
+  arma::Col<eT> deviations;
+};
+
 /**
  * Declaration of the Batch Normalization layer class. The layer tranforms
  * the input data into zero mean and unit variance and then scales and shifts
@@ -29,6 +117,13 @@ namespace ann /** Artificial Neural Network. */ {
  * calculated and the data is normalized. If it is set to true (testing) then
  * the mean and variance accrued over the training set is used.
  *
+ * In training mode, the forward pass computes the mean and variance of the
+ * batch in one pass over the input (with Welford's algorithm) and normalizes,
+ * scales and shifts it in a second one; the backward pass computes the sums it
+ * needs in one pass over the error and the result in a second one.  All
+ * passes walk the batch column by column, so they are vectorized over the
+ * units, and the buffers are reused from one batch to the next.
+ *
  * For more information, refer to the following paper,
  *
  * @code
@@ -57,6 +152,9 @@ template <
 class BatchNorm
 {
  public:
+  // Convenience typedefs.
+  typedef typename OutputDataType::elem_type ElemType;
+
   //! Create the BatchNorm object.
   BatchNorm();
 
@@ -144,6 +242,32 @@ class BatchNorm
   //! Get the variance over the training data.
   OutputDataType TrainingVariance() { return stats.var(1); }
 
+  //! Get the running statistics over the training data.
+  BatchNormStatistics<ElemType> const& Stats() const { return stats; }
+  //! Modify the running statistics over the training data.
+  BatchNormStatistics<ElemType>& Stats() { return stats; }
+
+  /**
+   * Save the state of the last forward pass in training mode, whose forward
+   * pass is recomputed before its backward pass (see
+   * RestoreForwardState()).
+   *
+   * @param state Set to an empty matrix; the pass only depends on its input.
+   */
+  void SaveForwardState(arma::mat& state);
+
+  /**
+   * Let the next forward pass in training mode recompute the pass whose state
+   * was saved with the given state: it does not add the batch to the running
+   * statistics again.
+   *
+   * @param state The (empty) state saved by SaveForwardState().
+   */
+  void RestoreForwardState(const arma::mat& state);
+
+  //! Get the epsilon added to the variance.
+  double Epsilon() const { return eps; }
+
   /**
    * Serialize the layer
    */
@@ -178,8 +302,15 @@ class BatchNorm
   //! Locally-stored variance object.
   OutputDataType variance;
 
+  //! Locally-stored inverse standard deviation of every unit.
+  OutputDataType invStd;
+
   //! Locally-stored running statistics object.
-  arma::running_stat_vec<arma::colvec> stats;
+  BatchNormStatistics<ElemType> stats;
+
+  //! If true, the next forward pass in training mode does not update the
+  //! running statistics.
+  bool recompute;
 
   //! Locally-stored gradient object.
   OutputDataType gradient;
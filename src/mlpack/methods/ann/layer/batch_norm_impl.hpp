@@ -24,7 +24,8 @@ template<typename InputDataType, typename OutputDataType>
 BatchNorm<InputDataType, OutputDataType>::BatchNorm() :
     size(10),
     eps(1e-8),
-    deterministic(false)
+    deterministic(false),
+    recompute(false)
 {
   // Nothing to do here.
 }
@@ -34,7 +35,8 @@ BatchNorm<InputDataType, OutputDataType>::BatchNorm(
     const size_t size, const double eps) :
     size(size),
     eps(eps),
-    deterministic(false)
+    deterministic(false),
+    recompute(false)
 {
   weights.set_size(size + size, 1);
 }
@@ -42,8 +44,8 @@ BatchNorm<InputDataType, OutputDataType>::BatchNorm(
 template<typename InputDataType, typename OutputDataType>
 void BatchNorm<InputDataType, OutputDataType>::Reset()
 {
-  gamma = arma::mat(weights.memptr(), size, 1, false, false);
-  beta = arma::mat(weights.memptr() + gamma.n_elem, size, 1, false, false);
+  gamma = OutputDataType(weights.memptr(), size, 1, false, false);
+  beta = OutputDataType(weights.memptr() + gamma.n_elem, size, 1, false, false);
   deterministic = false;
   gamma.fill(1.0);
   beta.fill(0.0);
@@ -55,66 +57,124 @@ template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
+  const size_t n = input.n_rows;
+  const size_t m = input.n_cols;
+  output.set_size(n, m);
+
   // Mean and variance over the entire training set will be used to compute
   // the forward pass when deterministic is set to true.
   if (deterministic)
   {
-    // Mini--batch mean using the stats object.
+    // Mini--batch mean and variance using the stats object.
     mean = stats.mean();
-
-    // Mini--batch variance using the stats object.
     variance = stats.var(1);
 
-    // Normalize the input and scale and shift the output.
-    output = input.each_col() - mean;
-    output.each_col() %= gamma / arma::sqrt(variance + eps);
-    output.each_col() += beta;
+    // Fold the normalization, the scale and the shift into a single affine
+    // transformation of every unit.
+    const OutputDataType scale = gamma / arma::sqrt(variance + eps);
+    const OutputDataType shift = beta - scale % mean;
+    for (size_t j = 0; j < m; ++j)
+    {
+      const eT* x = input.colptr(j);
+      eT* y = output.colptr(j);
+      for (size_t i = 0; i < n; ++i)
+        y[i] = scale[i] * x[i] + shift[i];
+    }
   }
   else
   {
-    mean = arma::mean(input, 1);
-    variance = arma::var(input, 1, 1);
-
-    for (size_t i = 0; i < input.n_cols; i++)
-      stats(input.col(i));
-
-    // Normalize the input.
-    output = input.each_col() - mean;
-    output.each_col() /= arma::sqrt(variance + eps);
-
-    // Reused in the backward and gradient step.
-    normalized = output;
-
-    // Scale and shift the output.
-    output.each_col() %= gamma;
-    output.each_col() += beta;
+    // Compute the mean and the sum of the squared deviations of every unit in
+    // one pass, with Welford's algorithm; variance holds the sums until they
+    // are merged into the running statistics.
+    mean.zeros(n, 1);
+    variance.zeros(n, 1);
+    for (size_t j = 0; j < m; ++j)
+    {
+      const eT* x = input.colptr(j);
+      const ElemType weight = ElemType(1) / ElemType(j + 1);
+      for (size_t i = 0; i < n; ++i)
+      {
+        const ElemType delta = x[i] - mean[i];
+        mean[i] += delta * weight;
+        variance[i] += delta * (x[i] - mean[i]);
+      }
+    }
+
+    // A recomputed pass has already been added to the running statistics.
+    if (!recompute)
+      stats.Merge(m, mean, variance);
+    recompute = false;
+
+    variance /= ElemType(m);
+    invStd = 1.0 / arma::sqrt(variance + eps);
+
+    // Normalize the input, and scale and shift the output.  The normalized
+    // input is reused in the backward and gradient step.
+    normalized.set_size(n, m);
+    for (size_t j = 0; j < m; ++j)
+    {
+      const eT* x = input.colptr(j);
+      ElemType* xhat = normalized.colptr(j);
+      eT* y = output.colptr(j);
+      for (size_t i = 0; i < n; ++i)
+      {
+        xhat[i] = (x[i] - mean[i]) * invStd[i];
+        y[i] = gamma[i] * xhat[i] + beta[i];
+      }
+    }
   }
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Backward(
-    const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  const arma::mat inputMean = input.each_col() - mean;
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
+  const size_t n = gy.n_rows;
+  const size_t m = gy.n_cols;
+  g.set_size(n, m);
 
-  // Step 1: dl / dxhat *
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 1) %
-      arma::pow(stdInv, 3.0) * -0.5;
+  // With the statistics of the training set, the layer is an affine
+  // transformation of every unit.
+  if (deterministic)
+  {
+    const OutputDataType scale = gamma / arma::sqrt(variance + eps);
+    for (size_t j = 0; j < m; ++j)
+    {
+      const eT* dy = gy.colptr(j);
+      eT* dx = g.colptr(j);
+      for (size_t i = 0; i < n; ++i)
+        dx[i] = scale[i] * dy[i];
+    }
+
+    return;
+  }
 
-  // Step 4: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_col() % stdInv) + (inputMean.each_col() %
-      var * 2 / input.n_cols);
+  // The gradient with respect to the input is
+  // gamma * stdInv / m * (m * dy - sum(dy) - xhat * sum(dy * xhat)), so one
+  // pass collects the two sums, and a second one computes the result.
+  OutputDataType sumGy(n, 1, arma::fill::zeros);
+  OutputDataType sumGyXhat(n, 1, arma::fill::zeros);
+  for (size_t j = 0; j < m; ++j)
+  {
+    const eT* dy = gy.colptr(j);
+    const ElemType* xhat = normalized.colptr(j);
+    for (size_t i = 0; i < n; ++i)
+    {
+      sumGy[i] += dy[i];
+      sumGyXhat[i] += dy[i] * xhat[i];
+    }
+  }
 
-  // Step 3: sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_col() += arma::sum(norm.each_col() % -stdInv, 1) + var %
-      arma::mean(-2 * inputMean, 1) / input.n_cols;
+  const OutputDataType scale = gamma % invStd / ElemType(m);
+  for (size_t j = 0; j < m; ++j)
+  {
+    const eT* dy = gy.colptr(j);
+    const ElemType* xhat = normalized.colptr(j);
+    eT* dx = g.colptr(j);
+    for (size_t i = 0; i < n; ++i)
+      dx[i] = scale[i] * (m * dy[i] - sumGy[i] - xhat[i] * sumGyXhat[i]);
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -124,14 +184,35 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient.set_size(size + size, 1);
+  // The first half of the gradient is dl / dy * xhat (for gamma) and the
+  // second half dl / dy (for beta), both summed over the batch.
+  gradient.zeros(size + size, 1);
+  eT* dGamma = gradient.memptr();
+  eT* dBeta = gradient.memptr() + size;
+  for (size_t j = 0; j < error.n_cols; ++j)
+  {
+    const eT* dy = error.colptr(j);
+    const ElemType* xhat = normalized.colptr(j);
+    for (size_t i = 0; i < size; ++i)
+    {
+      dGamma[i] += dy[i] * xhat[i];
+      dBeta[i] += dy[i];
+    }
+  }
+}
 
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
+template<typename InputDataType, typename OutputDataType>
+void BatchNorm<InputDataType, OutputDataType>::SaveForwardState(
+    arma::mat& state)
+{
+  state.reset();
+}
 
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+template<typename InputDataType, typename OutputDataType>
+void BatchNorm<InputDataType, OutputDataType>::RestoreForwardState(
+    const arma::mat& /* state */)
+{
+  recompute = true;
 }
 
 template<typename InputDataType, typename OutputDataType>
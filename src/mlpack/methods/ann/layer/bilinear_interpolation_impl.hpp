@@ -64,9 +64,9 @@ void BilinearInterpolation<InputDataType, OutputDataType>::Forward(
   assert(inRowSize >= 2);
   assert(inColSize >= 2);
 
-  arma::cube inputAsCube(input.memptr(), inRowSize, inColSize, depth);
-  arma::cube outputAsCube(output.memptr(), outRowSize, outColSize, depth,
-                          false, true);
+  arma::Cube<eT> inputAsCube(input.memptr(), inRowSize, inColSize, depth);
+  arma::Cube<eT> outputAsCube(output.memptr(), outRowSize, outColSize, depth,
+                              false, true);
 
   double scaleRow = (double) inRowSize / (double) outRowSize;
   double scaleCol = (double) inColSize / (double) outColSize;
@@ -124,9 +124,10 @@ void BilinearInterpolation<InputDataType, OutputDataType>::Backward(
   assert(outRowSize >= 2);
   assert(outColSize >= 2);
 
-  arma::cube gradientAsCube(gradient.memptr(), outRowSize, outColSize, depth);
-  arma::cube outputAsCube(output.memptr(), inRowSize, inColSize, depth, false,
-                          true);
+  arma::Cube<eT> gradientAsCube(gradient.memptr(), outRowSize, outColSize,
+                                depth);
+  arma::Cube<eT> outputAsCube(output.memptr(), inRowSize, inColSize, depth,
+                              false, true);
 
   if (gradient.n_elem == output.n_elem)
   {
@@ -18,6 +18,8 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/convolution_rules_traits.hpp>
 
 #include "layer_types.hpp"
 
@@ -46,6 +48,9 @@ template <
 class Convolution
 {
  public:
+  // Convenience typedefs.
+  typedef typename OutputDataType::elem_type ElemType;
+
   //! Create the Convolution object.
   Convolution();
 
@@ -161,6 +166,30 @@ class Convolution
   //! Modify the output height.
   size_t& OutputHeight() { return outputHeight; }
 
+  //! Get the number of input maps.
+  size_t InSize() const { return inSize; }
+
+  //! Get the number of output maps.
+  size_t OutSize() const { return outSize; }
+
+  //! Get the filter width.
+  size_t KernelWidth() const { return kW; }
+
+  //! Get the filter height.
+  size_t KernelHeight() const { return kH; }
+
+  //! Get the stride in x-direction.
+  size_t StrideWidth() const { return dW; }
+
+  //! Get the stride in y-direction.
+  size_t StrideHeight() const { return dH; }
+
+  //! Get the padding width.
+  size_t PadWidth() const { return padW; }
+
+  //! Get the padding height.
+  size_t PadHeight() const { return padH; }
+
   /**
    * Serialize the layer
    */
@@ -231,7 +260,8 @@ class Convolution
     if (output.n_rows != input.n_rows + wPad * 2 ||
         output.n_cols != input.n_cols + hPad * 2)
     {
-      output = arma::zeros(input.n_rows + wPad * 2, input.n_cols + hPad * 2);
+      output = arma::zeros<arma::Mat<eT> >(input.n_rows + wPad * 2,
+          input.n_cols + hPad * 2);
     }
 
     output.submat(wPad, hPad, wPad + input.n_rows - 1,
@@ -252,12 +282,12 @@ class Convolution
            size_t hPad,
            arma::Cube<eT>& output)
   {
-    output = arma::zeros(input.n_rows + wPad * 2,
+    output = arma::zeros<arma::Cube<eT> >(input.n_rows + wPad * 2,
         input.n_cols + hPad * 2, input.n_slices);
 
     for (size_t i = 0; i < input.n_slices; ++i)
     {
-      Pad<double>(input.slice(i), wPad, hPad, output.slice(i));
+      Pad<eT>(input.slice(i), wPad, hPad, output.slice(i));
     }
   }
 
@@ -289,10 +319,10 @@ class Convolution
   OutputDataType weights;
 
   //! Locally-stored weight object.
-  arma::cube weight;
+  arma::Cube<ElemType> weight;
 
   //! Locally-stored bias term object.
-  arma::mat bias;
+  OutputDataType bias;
 
   //! Locally-stored input width.
   size_t inputWidth;
@@ -307,19 +337,23 @@ class Convolution
   size_t outputHeight;
 
   //! Locally-stored transformed output parameter.
-  arma::cube outputTemp;
+  arma::Cube<ElemType> outputTemp;
 
   //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
+  arma::Cube<ElemType> inputTemp;
 
   //! Locally-stored transformed padded input parameter.
-  arma::cube inputPaddedTemp;
+  arma::Cube<ElemType> inputPaddedTemp;
 
   //! Locally-stored transformed error parameter.
-  arma::cube gTemp;
+  arma::Cube<ElemType> gTemp;
 
   //! Locally-stored transformed gradient parameter.
-  arma::cube gradientTemp;
+  arma::Cube<ElemType> gradientTemp;
+
+  //! Locally-stored unfolded input patches (only used by im2col based
+  //! convolution rules).
+  OutputDataType patches;
 
   //! Locally-stored delta object.
   OutputDataType delta;
@@ -334,6 +368,21 @@ class Convolution
   OutputDataType outputParameter;
 }; // class Convolution
 
+/**
+ * Convolution layer that computes the forward pass, the backward pass and the
+ * gradient with the im2col rule (ImToColConvolution), i.e. as one matrix
+ * multiplication per pass.
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+using ImToColConvolutionLayer = Convolution<
+    ImToColConvolution<ValidConvolution>,
+    ImToColConvolution<FullConvolution>,
+    ImToColConvolution<ValidConvolution>,
+    InputDataType, OutputDataType>;
+
 } // namespace ann
 } // namespace mlpack
 
@@ -91,9 +91,9 @@ void Convolution<
     OutputDataType
 >::Reset()
 {
-    weight = arma::cube(weights.memptr(), kW, kH,
+    weight = arma::Cube<ElemType>(weights.memptr(), kW, kH,
         outSize * inSize, false, false);
-    bias = arma::mat(weights.memptr() + weight.n_elem,
+    bias = OutputDataType(weights.memptr() + weight.n_elem,
         outSize, 1, false, false);
 }
 
@@ -113,7 +113,11 @@ void Convolution<
     OutputDataType
 >::Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  inputTemp = arma::cube(input.memptr(), inputWidth, inputHeight, inSize);
+  // Every column of the input holds one point; the maps of all points are
+  // stored consecutively, so the maps of point n start at slice n * inSize.
+  const size_t batchSize = input.n_cols;
+  inputTemp = arma::Cube<eT>(input.memptr(), inputWidth, inputHeight,
+      inSize * batchSize);
 
   if (padW != 0 || padH != 0)
   {
@@ -123,32 +127,56 @@ void Convolution<
   size_t wConv = ConvOutSize(inputWidth, kW, dW, padW);
   size_t hConv = ConvOutSize(inputHeight, kH, dH, padH);
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(wConv, hConv, outSize);
-
-  for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
+  if (ConvolutionTraits<ForwardConvolutionRule>::UseImToCol)
   {
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    // Convolve all maps of all points with one matrix multiplication.
+    ImToColConvolution<ValidConvolution>::ForwardBatch(
+        (padW != 0 || padH != 0) ? inputPaddedTemp : inputTemp, weight,
+        inSize, outSize, patches, outputTemp, dW, dH);
+
+    for (size_t n = 0; n < batchSize; n++)
     {
-      arma::Mat<eT> convOutput;
+      for (size_t outMap = 0; outMap < outSize; outMap++)
+        outputTemp.slice(n * outSize + outMap) += bias(outMap);
+    }
+  }
+  else
+  {
+    outputTemp = arma::zeros<arma::Cube<eT> >(wConv, hConv,
+        outSize * batchSize);
 
-      if (padW != 0 || padH != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap),
-            weight.slice(outMapIdx), convOutput, dW, dH);
-      }
-      else
+    for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
+    {
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
       {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap),
-            weight.slice(outMapIdx), convOutput, dW, dH);
+        for (size_t n = 0; n < batchSize; n++)
+        {
+          arma::Mat<eT> convOutput;
+
+          if (padW != 0 || padH != 0)
+          {
+            ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(
+                n * inSize + inMap), weight.slice(outMapIdx), convOutput, dW,
+                dH);
+          }
+          else
+          {
+            ForwardConvolutionRule::Convolution(inputTemp.slice(
+                n * inSize + inMap), weight.slice(outMapIdx), convOutput, dW,
+                dH);
+          }
+
+          outputTemp.slice(n * outSize + outMap) += convOutput;
+        }
       }
 
-      outputTemp.slice(outMap) += convOutput;
+      for (size_t n = 0; n < batchSize; n++)
+        outputTemp.slice(n * outSize + outMap) += bias(outMap);
     }
-
-    outputTemp.slice(outMap) += bias(outMap);
   }
 
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem, 1);
+  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
+      batchSize);
 
   outputWidth = outputTemp.n_rows;
   outputHeight = outputTemp.n_cols;
@@ -171,37 +199,65 @@ void Convolution<
 >::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError(gy.memptr(), outputWidth, outputHeight, outSize,
-      false, false);
-  gTemp = arma::zeros<arma::Cube<eT> >(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  const size_t batchSize = gy.n_cols;
+  arma::Cube<eT> mappedError(gy.memptr(), outputWidth, outputHeight,
+      outSize * batchSize, false, false);
 
-  for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
+  if (ConvolutionTraits<BackwardConvolutionRule>::UseImToCol)
   {
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    if (padW != 0 || padH != 0)
     {
-      arma::Mat<eT> rotatedFilter;
-      Rotate180(weight.slice(outMapIdx), rotatedFilter);
-
-      arma::Mat<eT> output;
-      BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
-          rotatedFilter, output, dW, dH);
+      // Compute the error of the padded input and strip the padding.
+      arma::Cube<eT> gPadded(inputPaddedTemp.n_rows, inputPaddedTemp.n_cols,
+          inputPaddedTemp.n_slices);
+      ImToColConvolution<ValidConvolution>::BackwardBatch(mappedError,
+          weight, inSize, outSize, gPadded, dW, dH);
+      gTemp = gPadded.subcube(padW, padH, 0, padW + inputTemp.n_rows - 1,
+          padH + inputTemp.n_cols - 1, gPadded.n_slices - 1);
+    }
+    else
+    {
+      gTemp.set_size(inputTemp.n_rows, inputTemp.n_cols, inputTemp.n_slices);
+      ImToColConvolution<ValidConvolution>::BackwardBatch(mappedError,
+          weight, inSize, outSize, gTemp, dW, dH);
+    }
+  }
+  else
+  {
+    gTemp = arma::zeros<arma::Cube<eT> >(inputTemp.n_rows,
+        inputTemp.n_cols, inputTemp.n_slices);
 
-      if (padW != 0 || padH != 0)
-      {
-        gTemp.slice(inMap) += output.submat(rotatedFilter.n_rows / 2,
-            rotatedFilter.n_cols / 2,
-            rotatedFilter.n_rows / 2 + gTemp.n_rows - 1,
-            rotatedFilter.n_cols / 2 + gTemp.n_cols - 1);
-      }
-      else
+    for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
+    {
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
       {
-        gTemp.slice(inMap) += output;
+        arma::Mat<eT> rotatedFilter;
+        Rotate180(weight.slice(outMapIdx), rotatedFilter);
+
+        for (size_t n = 0; n < batchSize; n++)
+        {
+          arma::Mat<eT> output;
+          BackwardConvolutionRule::Convolution(mappedError.slice(
+              n * outSize + outMap), rotatedFilter, output, dW, dH);
+
+          if (padW != 0 || padH != 0)
+          {
+            gTemp.slice(n * inSize + inMap) += output.submat(
+                rotatedFilter.n_rows / 2,
+                rotatedFilter.n_cols / 2,
+                rotatedFilter.n_rows / 2 + gTemp.n_rows - 1,
+                rotatedFilter.n_cols / 2 + gTemp.n_cols - 1);
+          }
+          else
+          {
+            gTemp.slice(n * inSize + inMap) += output;
+          }
+        }
       }
     }
   }
 
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1);
+  g = arma::Mat<eT>(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
 
 template<
@@ -223,66 +279,99 @@ void Convolution<
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  arma::cube mappedError;
-  if (padW != 0 && padH != 0)
+  // The gradient of the whole batch is the sum of the per-point gradients.
+  const size_t batchSize = error.n_cols;
+  arma::Cube<eT> mappedError;
+  if (ConvolutionTraits<GradientConvolutionRule>::UseImToCol)
   {
-    mappedError = arma::cube(error.memptr(), outputWidth / padW,
-        outputHeight / padH, outSize);
-  }
-  else
-  {
-    mappedError = arma::cube(error.memptr(), outputWidth,
-        outputHeight, outSize);
-  }
+    mappedError = arma::Cube<eT>(error.memptr(), outputWidth,
+        outputHeight, outSize * batchSize, false, false);
 
-  gradientTemp = arma::zeros<arma::Cube<eT> >(weight.n_rows, weight.n_cols,
-      weight.n_slices);
+    // The patches are already known if the forward pass used im2col.
+    if (!ConvolutionTraits<ForwardConvolutionRule>::UseImToCol)
+    {
+      ImToColConvolution<ValidConvolution>::ImToCol(
+          (padW != 0 || padH != 0) ? inputPaddedTemp : inputTemp, inSize, kW,
+          kH, dW, dH, patches);
+    }
 
-  for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
+    ImToColConvolution<ValidConvolution>::GradientBatch(patches,
+        mappedError, kW, kH, inSize, outSize, gradientTemp);
+  }
+  else
   {
-    for (size_t inMap = 0, s = outMap; inMap < inSize; inMap++, outMapIdx++,
-        s += outSize)
+    if (padW != 0 && padH != 0)
     {
-      arma::Cube<eT> inputSlices;
-      if (padW != 0 || padH != 0)
-      {
-        inputSlices = inputPaddedTemp.slices(inMap, inMap);
-      }
-      else
-      {
-        inputSlices = inputTemp.slices(inMap, inMap);
-      }
-
-      arma::Cube<eT> deltaSlices = mappedError.slices(outMap, outMap);
+      mappedError = arma::Cube<eT>(error.memptr(), outputWidth / padW,
+          outputHeight / padH, outSize * batchSize);
+    }
+    else
+    {
+      mappedError = arma::Cube<eT>(error.memptr(), outputWidth,
+          outputHeight, outSize * batchSize);
+    }
 
-      arma::Cube<eT> output;
-      GradientConvolutionRule::Convolution(inputSlices, deltaSlices,
-          output, dW, dH);
+    gradientTemp = arma::zeros<arma::Cube<eT> >(weight.n_rows, weight.n_cols,
+        weight.n_slices);
 
-      if ((padW != 0 || padH != 0) &&
-          (gradientTemp.n_rows < output.n_rows &&
-          gradientTemp.n_cols < output.n_cols))
-      {
-        for (size_t i = 0; i < output.n_slices; i++)
-        {
-          gradientTemp.slice(s) += output.slice(i).submat(output.n_rows / 2,
-              output.n_cols / 2,
-              output.n_rows / 2 + gradientTemp.n_rows - 1,
-              output.n_cols / 2 + gradientTemp.n_cols - 1);
-        }
-      }
-      else
+    for (size_t outMap = 0, outMapIdx = 0; outMap < outSize; outMap++)
+    {
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
       {
-        for (size_t i = 0; i < output.n_slices; i++)
+        for (size_t n = 0; n < batchSize; n++)
         {
-          gradientTemp.slice(s) += output.slice(i);
+          arma::Cube<eT> inputSlices;
+          if (padW != 0 || padH != 0)
+          {
+            inputSlices = inputPaddedTemp.slices(n * inSize + inMap,
+                n * inSize + inMap);
+          }
+          else
+          {
+            inputSlices = inputTemp.slices(n * inSize + inMap,
+                n * inSize + inMap);
+          }
+
+          arma::Cube<eT> deltaSlices = mappedError.slices(n * outSize + outMap,
+              n * outSize + outMap);
+
+          arma::Cube<eT> output;
+          GradientConvolutionRule::Convolution(inputSlices, deltaSlices,
+              output, dW, dH);
+
+          if ((padW != 0 || padH != 0) &&
+              (gradientTemp.n_rows < output.n_rows &&
+              gradientTemp.n_cols < output.n_cols))
+          {
+            for (size_t i = 0; i < output.n_slices; i++)
+            {
+              gradientTemp.slice(outMapIdx) += output.slice(i).submat(
+                  output.n_rows / 2,
+                  output.n_cols / 2,
+                  output.n_rows / 2 + gradientTemp.n_rows - 1,
+                  output.n_cols / 2 + gradientTemp.n_cols - 1);
+            }
+          }
+          else
+          {
+            for (size_t i = 0; i < output.n_slices; i++)
+            {
+              gradientTemp.slice(outMapIdx) += output.slice(i);
+            }
+          }
         }
       }
     }
+  }
+
+  for (size_t outMap = 0; outMap < outSize; outMap++)
+  {
+    eT biasGradient = 0;
+    for (size_t n = 0; n < batchSize; n++)
+      biasGradient += arma::accu(mappedError.slice(n * outSize + outMap));
 
     gradient.submat(weight.n_elem + outMap, 0,
-        weight.n_elem + outMap, 0) = arma::accu(mappedError.slices(
-        outMap, outMap));
+        weight.n_elem + outMap, 0) = biasGradient;
   }
 
   gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::Mat<eT>(
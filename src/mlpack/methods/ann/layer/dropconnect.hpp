@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_ANN_LAYER_DROPCONNECT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 #include "layer_types.hpp"
 #include "add_merge.hpp"
@@ -156,6 +157,23 @@ class DropConnect
     scale = 1.0 / (1.0 - ratio);
   }
 
+  /**
+   * Save the state of the last forward pass in training mode, whose forward
+   * pass is recomputed before its backward pass (see
+   * RestoreForwardState()).
+   *
+   * @param state The mask of the pass.  The weights are unmasked again.
+   */
+  void SaveForwardState(arma::mat& state);
+
+  /**
+   * Let the next forward pass in training mode recompute the pass whose state
+   * was saved with the given state: it applies the same mask.
+   *
+   * @param state The mask saved by SaveForwardState().
+   */
+  void RestoreForwardState(const arma::mat& state);
+
   /**
    * Serialize the layer.
    */
@@ -193,6 +211,9 @@ class DropConnect
   //! Denoise mask for the weights.
   OutputDataType denoise;
 
+  //! If true, the next forward pass in training mode uses the restored mask.
+  bool recompute;
+
   //! Locally-stored layer module.
   LayerTypes<> baseLayer;
 
@@ -31,7 +31,8 @@ template<typename InputDataType, typename OutputDataType>
 DropConnect<InputDataType, OutputDataType>::DropConnect() :
     ratio(0.5),
     scale(2.0),
-    deterministic(true)
+    deterministic(true),
+    recompute(false)
 {
   // Nothing to do here.
 }
@@ -43,6 +44,7 @@ DropConnect<InputDataType, OutputDataType>::DropConnect(
     const double ratio) :
     ratio(ratio),
     scale(1.0 / (1 - ratio)),
+    recompute(false),
     baseLayer(new Linear<InputDataType, OutputDataType>(inSize, outSize))
 {
   network.push_back(baseLayer);
@@ -74,8 +76,13 @@ void DropConnect<InputDataType, OutputDataType>::Forward(
 
     // Scale with input / (1 - ratio) and set values to zero with
     // probability ratio.
-    mask = arma::randu<arma::Mat<eT> >(denoise.n_rows, denoise.n_cols);
-    mask.transform([&](double val) { return (val > ratio); });
+    if (!recompute)
+    {
+      mask.set_size(denoise.n_rows, denoise.n_cols);
+      math::RandUniform(mask);
+      mask.transform([&](double val) { return (val > ratio); });
+    }
+    recompute = false;
 
     boost::apply_visitor(ParametersSetVisitor(std::move(denoise % mask)),
         baseLayer);
@@ -112,6 +119,25 @@ void DropConnect<InputDataType, OutputDataType>::Gradient(
   boost::apply_visitor(ParametersSetVisitor(std::move(denoise)), baseLayer);
 }
 
+template<typename InputDataType, typename OutputDataType>
+void DropConnect<InputDataType, OutputDataType>::SaveForwardState(
+    arma::mat& state)
+{
+  state = mask;
+
+  // The recomputed pass saves the weights again, so they must not be masked.
+  if (!deterministic)
+    boost::apply_visitor(ParametersSetVisitor(std::move(denoise)), baseLayer);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void DropConnect<InputDataType, OutputDataType>::RestoreForwardState(
+    const arma::mat& state)
+{
+  mask = state;
+  recompute = true;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void DropConnect<InputDataType, OutputDataType>::serialize(
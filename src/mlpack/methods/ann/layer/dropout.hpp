@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_DROPOUT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -119,6 +120,23 @@ class Dropout
   //! Modify the value of the rescale parameter.
   bool& Rescale() {return rescale; }
 
+  /**
+   * Save the state of the last forward pass in training mode, whose forward
+   * pass is recomputed before its backward pass (see
+   * RestoreForwardState()).
+   *
+   * @param state The mask of the pass.
+   */
+  void SaveForwardState(arma::mat& state);
+
+  /**
+   * Let the next forward pass in training mode recompute the pass whose state
+   * was saved with the given state: it applies the same mask.
+   *
+   * @param state The mask saved by SaveForwardState().
+   */
+  void RestoreForwardState(const arma::mat& state);
+
   /**
    * Serialize the layer.
    */
@@ -149,6 +167,9 @@ class Dropout
 
   //! If true the input is rescaled when deterministic is False.
   bool rescale;
+
+  //! If true, the next forward pass in training mode uses the restored mask.
+  bool recompute;
 }; // class Dropout
 
 } // namespace ann
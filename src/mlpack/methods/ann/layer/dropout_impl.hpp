@@ -25,7 +25,8 @@ Dropout<InputDataType, OutputDataType>::Dropout(
     ratio(ratio),
     scale(1.0 / (1.0 - ratio)),
     deterministic(true),
-    rescale(rescale)
+    rescale(rescale),
+    recompute(false)
 {
   // Nothing to do here.
 }
@@ -53,8 +54,14 @@ void Dropout<InputDataType, OutputDataType>::Forward(
   {
     // Scale with input / (1 - ratio) and set values to zero with probability
     // ratio.
-    mask = arma::randu<arma::Mat<eT> >(input.n_rows, input.n_cols);
-    mask.transform( [&](double val) { return (val > ratio); } );
+    if (!recompute)
+    {
+      mask.set_size(input.n_rows, input.n_cols);
+      math::RandUniform(mask);
+      mask.transform( [&](double val) { return (val > ratio); } );
+    }
+    recompute = false;
+
     output = input % mask * scale;
   }
 }
@@ -69,6 +76,21 @@ void Dropout<InputDataType, OutputDataType>::Backward(
   g = gy % mask * scale;
 }
 
+template<typename InputDataType, typename OutputDataType>
+void Dropout<InputDataType, OutputDataType>::SaveForwardState(
+    arma::mat& state)
+{
+  state = mask;
+}
+
+template<typename InputDataType, typename OutputDataType>
+void Dropout<InputDataType, OutputDataType>::RestoreForwardState(
+    const arma::mat& state)
+{
+  mask = state;
+  recompute = true;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void Dropout<InputDataType, OutputDataType>::serialize(
@@ -116,6 +116,38 @@ class FastLSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Starts a new BPTT chain like ResetCell(), but keeps the output and the
+   * cell state of the last computed time step as the initial state of the new
+   * chain.  This is used for truncated BPTT over sequences that are longer
+   * than the BPTT window.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void CarryCell(const size_t size);
+
+  /*
+   * Store the output and the cell state of the last computed time step in the
+   * given matrix: the first outSize rows hold the output, the next outSize rows
+   * the cell state, and there is one column per sequence of the batch.  The
+   * matrix is empty if nothing was computed yet.
+   *
+   * @param state Matrix to store the state in.
+   */
+  void SaveState(OutputDataType& state) const;
+
+  /*
+   * Start a new chain from the given state, in the layout of SaveState(); the
+   * number of columns is the batch size of the next time step.  A state of
+   * zeros is the state of a new sequence.
+   *
+   * @param state The state to continue from.
+   */
+  void LoadState(const OutputDataType& state);
+
+  //! Get the number of rows of the state (see SaveState()).
+  size_t StateSize() const { return 2 * outSize; }
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -128,6 +160,48 @@ class FastLSTM
                 ErrorType&& error,
                 GradientType&& gradient);
 
+  /**
+   * Run the forward pass over a whole sequence at once.  The input projections
+   * of all time steps are computed with a single matrix multiplication; only
+   * the recurrent part is evaluated step by step, for all sequences of the
+   * batch at once.  The gate buffers of the layer are reused, so repeated
+   * calls with the same sequence length and batch size don't allocate memory.
+   *
+   * The columns of the input and output are ordered by time step: columns
+   * t * batchSize to (t + 1) * batchSize - 1 hold the points of time step t.
+   *
+   * @param input Input sequence (inSize x (steps * batchSize)).
+   * @param batchSize Number of sequences that are processed in parallel.
+   * @param output Resulting output sequence (outSize x (steps * batchSize)).
+   */
+  template<typename eT>
+  void ForwardSequence(const arma::Mat<eT>& input,
+                       const size_t batchSize,
+                       arma::Mat<eT>& output);
+
+  /**
+   * Run backpropagation through time over the whole sequence that was
+   * passed to ForwardSequence() before.  The error with respect to the input
+   * of all time steps is computed with a single matrix multiplication.
+   *
+   * @param gy The error with respect to the output of every time step
+   *     (outSize x (steps * batchSize)).
+   * @param g The calculated error with respect to the input of every time step
+   *     (inSize x (steps * batchSize)).
+   */
+  template<typename eT>
+  void BackwardSequence(const arma::Mat<eT>& gy, arma::Mat<eT>& g);
+
+  /**
+   * Calculate the gradient of the whole sequence passed to ForwardSequence()
+   * and BackwardSequence(), i.e. the sum of the gradients of all time steps.
+   *
+   * @param input Input sequence (inSize x (steps * batchSize)).
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void GradientSequence(const arma::Mat<eT>& input, arma::Mat<eT>& gradient);
+
   //! Get the maximum number of steps to backpropagate through time (BPTT).
   size_t Rho() const { return rho; }
   //! Modify the maximum number of steps to backpropagate through time (BPTT).
@@ -281,6 +355,9 @@ class FastLSTM
   //! Locally-stored cell parameter.
   OutputDataType cell;
 
+  //! Locally-stored cell state carried over from the previous window.
+  OutputDataType prevCell;
+
   //! Locally-stored cell activation error.
   OutputDataType cellActivation;
 
@@ -293,6 +370,9 @@ class FastLSTM
   //! Locally-stored output parameters.
   OutputDataType outParameter;
 
+  //! Locally-stored gate error of all time steps of a sequence.
+  OutputDataType sequenceError;
+
   //! Locally-stored current rho size.
   size_t rhoSize;
 
@@ -69,6 +69,7 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
     return;
 
   rhoSize = size;
+  prevCell.reset();
 
   if (batchSize == 0)
     return;
@@ -91,7 +92,7 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
     if (prevOutput.is_empty())
     {
       prevOutput = arma::zeros<OutputDataType>(outSize, batchSize);
-      cell = arma::zeros(outSize, size * batchSize);
+      cell = arma::zeros<OutputDataType>(outSize, size * batchSize);
       cellActivationError = arma::zeros<OutputDataType>(outSize, batchSize);
       outParameter = arma::zeros<OutputDataType>(
           outSize, (size + 1) * batchSize);
@@ -107,6 +108,75 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
       outParameter.resize(outSize, (size + 1) * batchSize);
     }
   }
+
+  // The first step of the new chain starts from the zero state.
+  outParameter.cols(0, batchStep).zeros();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::CarryCell(const size_t size)
+{
+  if (size == std::numeric_limits<size_t>::max())
+    return;
+
+  // Nothing was computed so far, so there is no state to carry over.
+  if (batchSize == 0 || cell.is_empty())
+  {
+    ResetCell(size);
+    return;
+  }
+
+  // The first column of the last computed time step.
+  const size_t lastStep = (forwardStep == 0 ? bpttSteps * batchSize :
+      forwardStep) - batchSize;
+
+  const OutputDataType lastOutput = outParameter.cols(lastStep + batchSize,
+      lastStep + batchSize + batchStep);
+  const OutputDataType lastCell = cell.cols(lastStep, lastStep + batchStep);
+
+  ResetCell(size);
+
+  outParameter.cols(0, batchStep) = lastOutput;
+  prevCell = lastCell;
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::SaveState(
+    OutputDataType& state) const
+{
+  if (batchSize == 0 || cell.is_empty())
+  {
+    state.reset();
+    return;
+  }
+
+  // The first column of the last computed time step.
+  const size_t lastStep = (forwardStep == 0 ? bpttSteps * batchSize :
+      forwardStep) - batchSize;
+
+  state.set_size(2 * outSize, batchSize);
+  state.rows(0, outSize - 1) = outParameter.cols(lastStep + batchSize,
+      lastStep + batchSize + batchStep);
+  state.rows(outSize, 2 * outSize - 1) = cell.cols(lastStep,
+      lastStep + batchStep);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::LoadState(
+    const OutputDataType& state)
+{
+  if (state.n_rows != 2 * outSize)
+  {
+    Log::Fatal << "FastLSTM::LoadState(): the state must have " << 2 * outSize
+        << " rows, but has " << state.n_rows << "!" << std::endl;
+  }
+
+  batchSize = state.n_cols;
+  batchStep = batchSize - 1;
+  ResetCell(rhoSize);
+
+  outParameter.cols(0, batchStep) = state.rows(0, outSize - 1);
+  prevCell = state.rows(outSize, 2 * outSize - 1);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -145,6 +215,14 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
         gateActivation.submat(0, forwardStep, outSize - 1,
         forwardStep + batchStep) %
         stateActivation.cols(forwardStep, forwardStep + batchStep);
+
+    // Continue from the cell state of the previous window, if any.
+    if (!prevCell.is_empty())
+    {
+      cell.cols(forwardStep, forwardStep + batchStep) +=
+          gateActivation.submat(2 * outSize, forwardStep, 3 * outSize - 1,
+          forwardStep + batchStep) % prevCell;
+    }
   }
   else
   {
@@ -206,6 +284,14 @@ void FastLSTM<InputDataType, OutputDataType>::Backward(
         3 * outSize - 1, backwardStep) % (1.0 - gateActivation.submat(
         2 * outSize, backwardStep - batchStep, 3 * outSize - 1, backwardStep));
   }
+  else if (!prevCell.is_empty())
+  {
+    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep) =
+        prevCell % cellActivationError % gateActivation.submat(2 * outSize,
+        backwardStep - batchStep, 3 * outSize - 1, backwardStep) %
+        (1.0 - gateActivation.submat(2 * outSize, backwardStep - batchStep,
+        3 * outSize - 1, backwardStep));
+  }
   else
   {
     prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep).zeros();
@@ -268,6 +354,149 @@ void FastLSTM<InputDataType, OutputDataType>::Gradient(
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void FastLSTM<InputDataType, OutputDataType>::ForwardSequence(
+    const arma::Mat<eT>& input, const size_t batchSize, arma::Mat<eT>& output)
+{
+  const size_t steps = input.n_cols / batchSize;
+  if (batchSize != this->batchSize)
+  {
+    this->batchSize = batchSize;
+    batchStep = batchSize - 1;
+  }
+
+  // Size the buffers for the whole sequence; this also starts a new BPTT
+  // chain for the step-wise functions.
+  ResetCell(steps);
+
+  // The input projections of all time steps at once.
+  gate = input2GateWeight * input;
+  gate.each_col() += input2GateBias;
+
+  for (size_t t = 0, step = 0; t < steps; ++t, step += batchSize)
+  {
+    const arma::span cols(step, step + batchStep);
+
+    // The recurrent part of the gate input; outParameter holds the output of
+    // the previous time step (or zeros for the first step).
+    gate.cols(cols) += output2GateWeight * outParameter.cols(cols);
+
+    FastSigmoid(std::move(gate.submat(arma::span(0, 3 * outSize - 1), cols)),
+        std::move(gateActivation.cols(cols)));
+
+    stateActivation.cols(cols) = arma::tanh(gate.submat(
+        arma::span(3 * outSize, 4 * outSize - 1), cols));
+
+    cell.cols(cols) = gateActivation.submat(arma::span(0, outSize - 1), cols) %
+        stateActivation.cols(cols);
+    if (t > 0)
+    {
+      cell.cols(cols) += gateActivation.submat(arma::span(2 * outSize,
+          3 * outSize - 1), cols) % cell.cols(step - batchSize,
+          step - batchSize + batchStep);
+    }
+
+    cellActivation.cols(cols) = arma::tanh(cell.cols(cols));
+
+    outParameter.cols(step + batchSize, step + batchSize + batchStep) =
+        cellActivation.cols(cols) % gateActivation.submat(arma::span(outSize,
+        2 * outSize - 1), cols);
+  }
+
+  output = outParameter.cols(batchSize, (steps + 1) * batchSize - 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void FastLSTM<InputDataType, OutputDataType>::BackwardSequence(
+    const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  const size_t steps = gy.n_cols / batchSize;
+  sequenceError.set_size(4 * outSize, gy.n_cols);
+
+  for (size_t t = steps; t > 0; --t)
+  {
+    const size_t step = (t - 1) * batchSize;
+    const arma::span cols(step, step + batchStep);
+
+    // The error of the output, including the error that flows back through
+    // the recurrent connection of the following time step.
+    arma::Mat<eT> outputError = gy.cols(cols);
+    if (t < steps)
+    {
+      outputError += output2GateWeight.t() * sequenceError.cols(
+          step + batchSize, step + batchSize + batchStep);
+    }
+
+    cellActivationError = outputError % gateActivation.submat(
+        arma::span(outSize, 2 * outSize - 1), cols) %
+        (1 - arma::pow(cellActivation.cols(cols), 2));
+
+    if (t < steps)
+      cellActivationError += forgetGateError;
+
+    forgetGateError = gateActivation.submat(arma::span(2 * outSize,
+        3 * outSize - 1), cols) % cellActivationError;
+
+    // Forget gate.
+    if (t > 1)
+    {
+      sequenceError.submat(arma::span(2 * outSize, 3 * outSize - 1), cols) =
+          cell.cols(step - batchSize, step - batchSize + batchStep) %
+          cellActivationError % gateActivation.submat(arma::span(2 * outSize,
+          3 * outSize - 1), cols) % (1.0 - gateActivation.submat(
+          arma::span(2 * outSize, 3 * outSize - 1), cols));
+    }
+    else
+    {
+      sequenceError.submat(arma::span(2 * outSize, 3 * outSize - 1),
+          cols).zeros();
+    }
+
+    // Input gate.
+    sequenceError.submat(arma::span(0, outSize - 1), cols) =
+        stateActivation.cols(cols) % cellActivationError %
+        gateActivation.submat(arma::span(0, outSize - 1), cols) %
+        (1.0 - gateActivation.submat(arma::span(0, outSize - 1), cols));
+
+    // State.
+    sequenceError.submat(arma::span(3 * outSize, 4 * outSize - 1), cols) =
+        gateActivation.submat(arma::span(0, outSize - 1), cols) %
+        cellActivationError % (1 - arma::pow(stateActivation.cols(cols), 2));
+
+    // Output gate.
+    sequenceError.submat(arma::span(outSize, 2 * outSize - 1), cols) =
+        cellActivation.cols(cols) % outputError % gateActivation.submat(
+        arma::span(outSize, 2 * outSize - 1), cols) % (1.0 -
+        gateActivation.submat(arma::span(outSize, 2 * outSize - 1), cols));
+  }
+
+  // The error of the inputs of all time steps at once.
+  g = input2GateWeight.t() * sequenceError;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void FastLSTM<InputDataType, OutputDataType>::GradientSequence(
+    const arma::Mat<eT>& input, arma::Mat<eT>& gradient)
+{
+  gradient.set_size(weights.n_elem, 1);
+
+  // Gradient of the input to gate layer.
+  gradient.submat(0, 0, input2GateWeight.n_elem - 1, 0) =
+      arma::vectorise(sequenceError * input.t());
+
+  gradient.submat(input2GateWeight.n_elem, 0, input2GateWeight.n_elem +
+      input2GateBias.n_elem - 1, 0) = arma::sum(sequenceError, 1);
+
+  // Gradient of the output to gate layer; the recurrent input of every time
+  // step is the output of the previous one.
+  gradient.submat(input2GateWeight.n_elem + input2GateBias.n_elem, 0,
+      gradient.n_elem - 1, 0) = arma::vectorise(sequenceError *
+      outParameter.cols(0, sequenceError.n_cols - 1).t());
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void FastLSTM<InputDataType, OutputDataType>::serialize(
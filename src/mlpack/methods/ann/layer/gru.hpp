@@ -120,6 +120,26 @@ class GRU
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Store the output of the last computed time step, which is the state of the
+   * cell, in the given matrix; there is one column per sequence of the batch.
+   *
+   * @param state Matrix to store the state in.
+   */
+  void SaveState(OutputDataType& state) const;
+
+  /*
+   * Start a new chain from the given state, in the layout of SaveState(); the
+   * number of columns is the batch size of the next time step.  A state of
+   * zeros is the state of a new sequence.
+   *
+   * @param state The state to continue from.
+   */
+  void LoadState(const OutputDataType& state);
+
+  //! Get the number of rows of the state (see SaveState()).
+  size_t StateSize() const { return outSize; }
+
   //! The value of the deterministic parameter.
   bool Deterministic() const { return deterministic; }
   //! Modify the value of the deterministic parameter.
@@ -381,6 +381,36 @@ void GRU<InputDataType, OutputDataType>::ResetCell(const size_t /* size */)
   backwardStep = 0;
 }
 
+template<typename InputDataType, typename OutputDataType>
+void GRU<InputDataType, OutputDataType>::SaveState(OutputDataType& state) const
+{
+  state = *prevOutput;
+}
+
+template<typename InputDataType, typename OutputDataType>
+void GRU<InputDataType, OutputDataType>::LoadState(const OutputDataType& state)
+{
+  if (state.n_rows != outSize)
+  {
+    Log::Fatal << "GRU::LoadState(): the state must have " << outSize
+        << " rows, but has " << state.n_rows << "!" << std::endl;
+  }
+
+  batchSize = state.n_cols;
+  prevError.resize(3 * outSize, batchSize);
+  allZeros.zeros(outSize, batchSize);
+
+  outParameter.clear();
+  outParameter.push_back(state);
+
+  prevOutput = outParameter.begin();
+  backIterator = outParameter.end();
+  gradIterator = outParameter.end();
+
+  forwardStep = 0;
+  backwardStep = 0;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void GRU<InputDataType, OutputDataType>::serialize(
@@ -18,12 +18,17 @@
 #include "convolution.hpp"
 #include "dropconnect.hpp"
 #include "glimpse.hpp"
+#include "layer_norm.hpp"
 #include "layer_types.hpp"
 #include "linear.hpp"
 #include "linear_no_bias.hpp"
 #include "lstm.hpp"
 #include "gru.hpp"
 #include "fast_lstm.hpp"
+#include "multihead_attention.hpp"
+#include "positional_encoding.hpp"
+#include "quantized_convolution.hpp"
+#include "quantized_linear.hpp"
 #include "recurrent.hpp"
 #include "recurrent_attention.hpp"
 #include "sequential.hpp"
@@ -0,0 +1,183 @@
+/**
+ * @file layer_norm.hpp
+ *
+ * Definition of the Layer Normalization layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_LAYER_NORM_HPP
+#define MLPACK_METHODS_ANN_LAYER_LAYER_NORM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Declaration of the Layer Normalization layer class.  Unlike BatchNorm, the
+ * mean and variance are those of the units of each point, so the layer
+ * behaves the same in training and at test time, for any batch size.  The
+ * input of a point is one vector of 'size' units, or a sequence of them
+ * stored one after the other (as the MultiheadAttention layer takes it); each
+ * vector is normalized on its own, and then scaled and shifted by the
+ * trainable gamma and beta.
+ *
+ * For more information, refer to the following paper,
+ *
+ * @code
+ * @article{Ba2016,
+ *   author  = {Jimmy Lei Ba and Jamie Ryan Kiros and Geoffrey E. Hinton},
+ *   title   = {Layer Normalization},
+ *   journal = {CoRR},
+ *   volume  = {abs/1607.06450},
+ *   year    = {2016}
+ * }
+ * @endcode
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class LayerNorm
+{
+ public:
+  //! Create the LayerNorm object.
+  LayerNorm();
+
+  /**
+   * Create the LayerNorm layer object for vectors of the given number of
+   * units.
+   *
+   * @param size The number of units of each normalized vector.
+   * @param eps The epsilon added to the variance to ensure numerical
+   *        stability.
+   */
+  LayerNorm(const size_t size, const double eps = 1e-5);
+
+  /**
+   * Reset the layer parameters: gamma is set to one and beta to zero.
+   */
+  void Reset();
+
+  /**
+   * Forward pass of the Layer Normalization layer.  Normalizes every vector of
+   * the input, and scales and shifts the result.
+   *
+   * @param input Input data for the layer (the number of rows must be a
+   *        multiple of the size).
+   * @param output Resulting output activations.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Backward pass through the layer.
+   *
+   * @param input The input activations.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  /**
+   * Calculate the gradient using the output delta and the input activations.
+   *
+   * @param input The input activations.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& error,
+                arma::Mat<eT>&& gradient);
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  //! Get the number of units of each normalized vector.
+  size_t Size() const { return size; }
+
+  //! Get the epsilon value.
+  double Epsilon() const { return eps; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored number of units of each normalized vector.
+  size_t size;
+
+  //! Locally-stored epsilon value.
+  double eps;
+
+  //! Locally-stored scale parameter.
+  OutputDataType gamma;
+
+  //! Locally-stored shift parameter.
+  OutputDataType beta;
+
+  //! Locally-stored parameters.
+  OutputDataType weights;
+
+  //! Locally-stored normalized input (one column per vector).
+  OutputDataType normalized;
+
+  //! Locally-stored inverse standard deviation of every vector.
+  OutputDataType invStd;
+
+  //! Locally-stored gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class LayerNorm
+
+} // namespace ann
+} // namespace mlpack
+
+// Include the implementation.
+#include "layer_norm_impl.hpp"
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file layer_norm_impl.hpp
+ *
+ * Implementation of the Layer Normalization layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_LAYER_NORM_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_LAYER_NORM_IMPL_HPP
+
+// In case it is not included.
+#include "layer_norm.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+LayerNorm<InputDataType, OutputDataType>::LayerNorm() :
+    size(0),
+    eps(1e-5)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+LayerNorm<InputDataType, OutputDataType>::LayerNorm(
+    const size_t size, const double eps) :
+    size(size),
+    eps(eps)
+{
+  weights.set_size(size + size, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LayerNorm<InputDataType, OutputDataType>::Reset()
+{
+  gamma = OutputDataType(weights.memptr(), size, 1, false, false);
+  beta = OutputDataType(weights.memptr() + size, size, 1, false, false);
+  gamma.fill(1.0);
+  beta.fill(0.0);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void LayerNorm<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  if (input.n_rows % size != 0)
+  {
+    Log::Fatal << "LayerNorm<>::Forward(): the number of input rows ("
+        << input.n_rows << ") is not a multiple of the size (" << size << ")!"
+        << std::endl;
+  }
+
+  // Every vector of the input is a column of this view.
+  const size_t vectors = input.n_elem / size;
+  const arma::Mat<eT> x(const_cast<eT*>(input.memptr()), size, vectors,
+      false, true);
+
+  normalized = x.each_row() - arma::mean(x, 0);
+  invStd = 1.0 / arma::sqrt(arma::mean(arma::square(normalized), 0) + eps);
+  normalized.each_row() %= invStd;
+
+  output.set_size(input.n_rows, input.n_cols);
+  arma::Mat<eT> y(output.memptr(), size, vectors, false, true);
+  y = normalized.each_col() % gamma;
+  y.each_col() += beta;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void LayerNorm<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  const arma::Mat<eT> error(gy.memptr(), size, normalized.n_cols, false,
+      true);
+
+  // dl / dx = stdInv / n * (n * dl / dxhat - sum(dl / dxhat) -
+  // xhat * sum(dl / dxhat * xhat)), with the sums over the units of a vector.
+  const arma::Mat<eT> norm = error.each_col() % gamma;
+
+  g.set_size(gy.n_rows, gy.n_cols);
+  arma::Mat<eT> result(g.memptr(), size, normalized.n_cols, false, true);
+  result = norm * size;
+  result.each_row() -= arma::sum(norm, 0);
+  result -= normalized.each_row() % arma::sum(norm % normalized, 0);
+  result.each_row() %= invStd / size;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void LayerNorm<InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>&& /* input */,
+    arma::Mat<eT>&& error,
+    arma::Mat<eT>&& gradient)
+{
+  const arma::Mat<eT> err(error.memptr(), size, normalized.n_cols, false,
+      true);
+
+  gradient.set_size(size + size, 1);
+
+  // dl / dgamma = sum(dl / dy * xhat).
+  gradient.submat(0, 0, size - 1, 0) = arma::sum(err % normalized, 1);
+
+  // dl / dbeta = sum(dl / dy).
+  gradient.submat(size, 0, gradient.n_elem - 1, 0) = arma::sum(err, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void LayerNorm<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(size);
+  ar & BOOST_SERIALIZATION_NVP(eps);
+
+  // Allocate the weights so that WeightSetVisitor gets the right size.
+  if (Archive::is_loading::value)
+    weights.set_size(size + size, 1);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
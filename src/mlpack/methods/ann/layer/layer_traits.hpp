@@ -88,6 +88,18 @@ HAS_MEM_FUNC(Reset, HasResetCheck);
 // we can use with SFINAE to catch when a type has a ResetCell() function.
 HAS_MEM_FUNC(ResetCell, HasResetCellCheck);
 
+// This gives us a HasCarryCellCheck<T, U> type (where U is a function pointer)
+// we can use with SFINAE to catch when a type has a CarryCell() function.
+HAS_MEM_FUNC(CarryCell, HasCarryCellCheck);
+
+// This gives us a HasSaveStateCheck<T, U> type (where U is a function pointer)
+// we can use with SFINAE to catch when a type has a SaveState() function.
+HAS_MEM_FUNC(SaveState, HasSaveStateCheck);
+
+// This gives us a HasLoadStateCheck<T, U> type (where U is a function pointer)
+// we can use with SFINAE to catch when a type has a LoadState() function.
+HAS_MEM_FUNC(LoadState, HasLoadStateCheck);
+
 // This gives us a HasRewardCheck<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Reward() function.
 HAS_MEM_FUNC(Reward, HasRewardCheck);
@@ -104,6 +116,32 @@ HAS_MEM_FUNC(InputHeight, HasInputHeight);
 // can use with SFINAE to catch when a type has a Rho() function.
 HAS_MEM_FUNC(Rho, HasRho);
 
+// This gives us a HasTouchedColumnsCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a TouchedColumns()
+// function, i.e. when it can compute sparse gradients.
+HAS_MEM_FUNC(TouchedColumns, HasTouchedColumnsCheck);
+
+// This gives us a HasForwardSequenceCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a ForwardSequence()
+// function, i.e. when it can process a whole sequence at once.
+HAS_MEM_FUNC(ForwardSequence, HasForwardSequenceCheck);
+
+// This gives us a HasStatsCheck<T, U> type (where U is a function pointer) we
+// can use with SFINAE to catch when a type has a Stats() function, i.e. when it
+// keeps running statistics of the training data.
+HAS_MEM_FUNC(Stats, HasStatsCheck);
+
+// This gives us a HasSaveForwardStateCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a
+// SaveForwardState() function, i.e. when its forward pass in training mode
+// changes or depends on state that must be kept to recompute the pass.
+HAS_MEM_FUNC(SaveForwardState, HasSaveForwardStateCheck);
+
+// This gives us a HasRestoreForwardStateCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a
+// RestoreForwardState() function.
+HAS_MEM_FUNC(RestoreForwardState, HasRestoreForwardStateCheck);
+
 } // namespace ann
 } // namespace mlpack
 
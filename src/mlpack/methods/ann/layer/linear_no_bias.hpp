@@ -112,6 +112,12 @@ class LinearNoBias
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the number of output units.
+  size_t OutputSize() const { return outSize; }
+
   /**
    * Serialize the layer
    */
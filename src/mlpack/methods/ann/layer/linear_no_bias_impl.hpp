@@ -37,7 +37,7 @@ LinearNoBias<InputDataType, OutputDataType>::LinearNoBias(
 template <typename InputDataType, typename OutputDataType>
 void LinearNoBias<InputDataType, OutputDataType>::Reset()
 {
-  weight = arma::mat(weights.memptr(), outSize, inSize, false, false);
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
 }
 
 template<typename InputDataType, typename OutputDataType>
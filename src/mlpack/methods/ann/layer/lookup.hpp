@@ -80,6 +80,26 @@ class Lookup
                 arma::Mat<eT>&& error,
                 arma::Mat<eT>&& gradient);
 
+  /**
+   * Calculate the gradient like Gradient(), but only write the columns of the
+   * words in the input; the other columns of the gradient are zero, and are
+   * left as they are.  This takes time proportional to the number of words in
+   * the input instead of the size of the vocabulary.  The written columns are
+   * given by TouchedColumns().
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void SparseGradient(const arma::Mat<eT>&& input,
+                      arma::Mat<eT>&& error,
+                      arma::Mat<eT>&& gradient);
+
+  //! Get the columns of the gradient written by the last SparseGradient()
+  //! call, in increasing order.
+  const arma::uvec& TouchedColumns() const { return touchedColumns; }
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -127,6 +147,9 @@ class Lookup
   //! Locally-stored gradient object.
   OutputDataType gradient;
 
+  //! Locally-stored columns written by SparseGradient().
+  arma::uvec touchedColumns;
+
   //! Locally-stored input parameter object.
   InputDataType inputParameter;
 
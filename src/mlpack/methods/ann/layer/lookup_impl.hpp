@@ -54,8 +54,29 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient = arma::zeros<arma::Mat<eT> >(weights.n_rows, weights.n_cols);
-  gradient.cols(arma::conv_to<arma::uvec>::from(input) - 1) = error;
+  // A word that appears several times gets the sum of its errors.
+  const arma::uvec words = arma::conv_to<arma::uvec>::from(input) - 1;
+  gradient.zeros(weights.n_rows, weights.n_cols);
+  for (size_t i = 0; i < words.n_elem; ++i)
+    gradient.col(words[i]) += error.col(i);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void Lookup<InputDataType, OutputDataType>::SparseGradient(
+    const arma::Mat<eT>&& input,
+    arma::Mat<eT>&& error,
+    arma::Mat<eT>&& gradient)
+{
+  const arma::uvec words = arma::conv_to<arma::uvec>::from(input) - 1;
+  touchedColumns = arma::unique(words);
+  if (gradient.n_rows != weights.n_rows || gradient.n_cols != weights.n_cols)
+    gradient.zeros(weights.n_rows, weights.n_cols);
+
+  for (size_t i = 0; i < touchedColumns.n_elem; ++i)
+    gradient.col(touchedColumns[i]).zeros();
+  for (size_t i = 0; i < words.n_elem; ++i)
+    gradient.col(words[i]) += error.col(i);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -50,6 +50,7 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
     return;
 
   rhoSize = size;
+  prevCell.reset();
 
   if (batchSize == 0)
     return;
@@ -91,6 +92,75 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
       outParameter.resize(outSize, (size + 1) * batchSize);
     }
   }
+
+  // The first step of the new chain starts from the zero state.
+  outParameter.cols(0, batchStep).zeros();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::CarryCell(const size_t size)
+{
+  if (size == std::numeric_limits<size_t>::max())
+    return;
+
+  // Nothing was computed so far, so there is no state to carry over.
+  if (batchSize == 0 || cell.is_empty())
+  {
+    ResetCell(size);
+    return;
+  }
+
+  // The first column of the last computed time step.
+  const size_t lastStep = (forwardStep == 0 ? bpttSteps * batchSize :
+      forwardStep) - batchSize;
+
+  const OutputDataType lastOutput = outParameter.cols(lastStep + batchSize,
+      lastStep + batchSize + batchStep);
+  const OutputDataType lastCell = cell.cols(lastStep, lastStep + batchStep);
+
+  ResetCell(size);
+
+  outParameter.cols(0, batchStep) = lastOutput;
+  prevCell = lastCell;
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::SaveState(
+    OutputDataType& state) const
+{
+  if (batchSize == 0 || cell.is_empty())
+  {
+    state.reset();
+    return;
+  }
+
+  // The first column of the last computed time step.
+  const size_t lastStep = (forwardStep == 0 ? bpttSteps * batchSize :
+      forwardStep) - batchSize;
+
+  state.set_size(2 * outSize, batchSize);
+  state.rows(0, outSize - 1) = outParameter.cols(lastStep + batchSize,
+      lastStep + batchSize + batchStep);
+  state.rows(outSize, 2 * outSize - 1) = cell.cols(lastStep,
+      lastStep + batchStep);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::LoadState(
+    const OutputDataType& state)
+{
+  if (state.n_rows != 2 * outSize)
+  {
+    Log::Fatal << "LSTM::LoadState(): the state must have " << 2 * outSize
+        << " rows, but has " << state.n_rows << "!" << std::endl;
+  }
+
+  batchSize = state.n_cols;
+  batchStep = batchSize - 1;
+  ResetCell(rhoSize);
+
+  outParameter.cols(0, batchStep) = state.rows(0, outSize - 1);
+  prevCell = state.rows(outSize, 2 * outSize - 1);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -195,6 +265,15 @@ void LSTM<InputDataType, OutputDataType>::Forward(
         arma::repmat(cell2GateForgetWeight, 1, batchSize) %
         cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
   }
+  else if (!prevCell.is_empty())
+  {
+    // Continue from the cell state of the previous window.
+    inputGate.cols(forwardStep, forwardStep + batchStep) +=
+        arma::repmat(cell2GateInputWeight, 1, batchSize) % prevCell;
+
+    forgetGate.cols(forwardStep, forwardStep + batchStep) +=
+        arma::repmat(cell2GateForgetWeight, 1, batchSize) % prevCell;
+  }
 
   inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
       (1 + arma::exp(-inputGate.cols(forwardStep, forwardStep + batchStep)));
@@ -217,6 +296,13 @@ void LSTM<InputDataType, OutputDataType>::Forward(
     cell.cols(forwardStep, forwardStep + batchStep) =
         inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
         hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
+
+    if (!prevCell.is_empty())
+    {
+      cell.cols(forwardStep, forwardStep + batchStep) +=
+          forgetGateActivation.cols(forwardStep, forwardStep + batchStep) %
+          prevCell;
+    }
   }
   else
   {
@@ -290,6 +376,12 @@ void LSTM<InputDataType, OutputDataType>::Backward(
       backwardStep - batchStep, backwardStep) % (1.0 -
       forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
   }
+  else if (!prevCell.is_empty())
+  {
+    forgetGateError = prevCell % cellError % (forgetGateActivation.cols(
+        backwardStep - batchStep, backwardStep) % (1.0 -
+        forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
+  }
   else
   {
     forgetGateError.zeros();
@@ -407,6 +499,14 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
                   cell.cols((gradientStep - batchSize) - batchStep,
                             (gradientStep - batchSize)), 1);
   }
+  else if (!prevCell.is_empty())
+  {
+    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
+        arma::sum(forgetGateError % prevCell, 1);
+    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
+        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
+        arma::sum(inputGateError % prevCell, 1);
+  }
   else
   {
     gradient.submat(offset, 0, offset +
@@ -426,6 +526,220 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
   }
 }
 
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void LSTM<InputDataType, OutputDataType>::ForwardSequence(
+    const arma::Mat<eT>& input, const size_t batchSize, arma::Mat<eT>& output)
+{
+  const size_t steps = input.n_cols / batchSize;
+  if (batchSize != this->batchSize)
+  {
+    this->batchSize = batchSize;
+    batchStep = batchSize - 1;
+  }
+
+  // Size the buffers for the whole sequence; this also starts a new BPTT
+  // chain from the zero state for the step-wise functions.
+  ResetCell(steps);
+
+  // The input projections of all time steps at once.
+  const size_t last = input.n_cols - 1;
+  inputGate.cols(0, last) = input2GateInputWeight * input;
+  inputGate.cols(0, last).each_col() += input2GateInputBias;
+  forgetGate.cols(0, last) = input2GateForgetWeight * input;
+  forgetGate.cols(0, last).each_col() += input2GateForgetBias;
+  hiddenLayer.cols(0, last) = input2HiddenWeight * input;
+  hiddenLayer.cols(0, last).each_col() += input2HiddenBias;
+  outputGate.cols(0, last) = input2GateOutputWeight * input;
+  outputGate.cols(0, last).each_col() += input2GateOutputBias;
+
+  for (size_t t = 0, step = 0; t < steps; ++t, step += batchSize)
+  {
+    const arma::span cols(step, step + batchStep);
+
+    // The recurrent part of the gate input; outParameter holds the output of
+    // the previous time step (or zeros for the first step).
+    inputGate.cols(cols) += output2GateInputWeight * outParameter.cols(cols);
+    forgetGate.cols(cols) += output2GateForgetWeight * outParameter.cols(cols);
+    hiddenLayer.cols(cols) += output2HiddenWeight * outParameter.cols(cols);
+    outputGate.cols(cols) += output2GateOutputWeight * outParameter.cols(cols);
+
+    if (t > 0)
+    {
+      const arma::span prevCols(step - batchSize, step - 1);
+      inputGate.cols(cols) += cell.cols(prevCols).each_col() %
+          cell2GateInputWeight;
+      forgetGate.cols(cols) += cell.cols(prevCols).each_col() %
+          cell2GateForgetWeight;
+    }
+
+    inputGateActivation.cols(cols) = 1.0 / (1 + arma::exp(
+        -inputGate.cols(cols)));
+    forgetGateActivation.cols(cols) = 1.0 / (1 + arma::exp(
+        -forgetGate.cols(cols)));
+    hiddenLayerActivation.cols(cols) = arma::tanh(hiddenLayer.cols(cols));
+
+    cell.cols(cols) = inputGateActivation.cols(cols) %
+        hiddenLayerActivation.cols(cols);
+    if (t > 0)
+    {
+      cell.cols(cols) += forgetGateActivation.cols(cols) %
+          cell.cols(step - batchSize, step - 1);
+    }
+
+    outputGate.cols(cols) += cell.cols(cols).each_col() %
+        cell2GateOutputWeight;
+    outputGateActivation.cols(cols) = 1.0 / (1 + arma::exp(
+        -outputGate.cols(cols)));
+    cellActivation.cols(cols) = arma::tanh(cell.cols(cols));
+
+    outParameter.cols(step + batchSize, step + batchSize + batchStep) =
+        cellActivation.cols(cols) % outputGateActivation.cols(cols);
+  }
+
+  output = outParameter.cols(batchSize, (steps + 1) * batchSize - 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void LSTM<InputDataType, OutputDataType>::BackwardSequence(
+    const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  const size_t steps = gy.n_cols / batchSize;
+  sequenceError.set_size(4 * outSize, gy.n_cols);
+
+  // The rows of the errors, in the order of the weights.
+  const arma::span outputRows(0, outSize - 1);
+  const arma::span forgetRows(outSize, 2 * outSize - 1);
+  const arma::span inputRows(2 * outSize, 3 * outSize - 1);
+  const arma::span hiddenRows(3 * outSize, 4 * outSize - 1);
+
+  for (size_t t = steps; t > 0; --t)
+  {
+    const size_t step = (t - 1) * batchSize;
+    const arma::span cols(step, step + batchStep);
+
+    // The error of the output, including the error that flows back through
+    // the recurrent connections of the following time step.
+    arma::Mat<eT> outputError = gy.cols(cols);
+    if (t < steps)
+    {
+      const arma::span nextCols(step + batchSize, step + batchSize + batchStep);
+      outputError += output2GateOutputWeight.t() *
+          sequenceError.submat(outputRows, nextCols) +
+          output2GateForgetWeight.t() *
+          sequenceError.submat(forgetRows, nextCols) +
+          output2GateInputWeight.t() *
+          sequenceError.submat(inputRows, nextCols) +
+          output2HiddenWeight.t() * sequenceError.submat(hiddenRows, nextCols);
+    }
+
+    outputGateError = outputError % cellActivation.cols(cols) %
+        (outputGateActivation.cols(cols) % (1.0 -
+        outputGateActivation.cols(cols)));
+
+    arma::Mat<eT> cellError = outputError % outputGateActivation.cols(cols) %
+        (1 - arma::pow(cellActivation.cols(cols), 2)) +
+        outputGateError.each_col() % cell2GateOutputWeight;
+
+    // The error of the cell state that flows back from the following step.
+    if (t < steps)
+      cellError += inputCellError;
+
+    if (t > 1)
+    {
+      forgetGateError = cell.cols(step - batchSize, step - 1) % cellError %
+          (forgetGateActivation.cols(cols) % (1.0 -
+          forgetGateActivation.cols(cols)));
+    }
+    else
+    {
+      forgetGateError.zeros(outSize, batchSize);
+    }
+
+    inputGateError = hiddenLayerActivation.cols(cols) % cellError %
+        (inputGateActivation.cols(cols) % (1.0 -
+        inputGateActivation.cols(cols)));
+
+    hiddenError = inputGateActivation.cols(cols) % cellError %
+        (1 - arma::pow(hiddenLayerActivation.cols(cols), 2));
+
+    inputCellError = forgetGateActivation.cols(cols) % cellError +
+        forgetGateError.each_col() % cell2GateForgetWeight +
+        inputGateError.each_col() % cell2GateInputWeight;
+
+    sequenceError.submat(outputRows, cols) = outputGateError;
+    sequenceError.submat(forgetRows, cols) = forgetGateError;
+    sequenceError.submat(inputRows, cols) = inputGateError;
+    sequenceError.submat(hiddenRows, cols) = hiddenError;
+  }
+
+  // The error of the inputs of all time steps at once.
+  g = input2GateOutputWeight.t() * sequenceError.rows(outputRows) +
+      input2GateForgetWeight.t() * sequenceError.rows(forgetRows) +
+      input2GateInputWeight.t() * sequenceError.rows(inputRows) +
+      input2HiddenWeight.t() * sequenceError.rows(hiddenRows);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void LSTM<InputDataType, OutputDataType>::GradientSequence(
+    const arma::Mat<eT>& input, arma::Mat<eT>& gradient)
+{
+  gradient.set_size(weights.n_elem, 1);
+
+  const size_t n = sequenceError.n_cols;
+  const arma::span rows[4] = { arma::span(0, outSize - 1),
+      arma::span(outSize, 2 * outSize - 1),
+      arma::span(2 * outSize, 3 * outSize - 1),
+      arma::span(3 * outSize, 4 * outSize - 1) };
+
+  // Input to gate weights and biases, in the order output, forget, input gate
+  // and hidden layer.
+  size_t offset = 0;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    gradient.submat(offset, 0, offset + outSize * inSize - 1, 0) =
+        arma::vectorise(sequenceError.rows(rows[i]) * input.t());
+    offset += outSize * inSize;
+
+    gradient.submat(offset, 0, offset + outSize - 1, 0) =
+        arma::sum(sequenceError.rows(rows[i]), 1);
+    offset += outSize;
+  }
+
+  // Output to gate weights; the recurrent input of every time step is the
+  // output of the previous one.
+  for (size_t i = 0; i < 4; ++i)
+  {
+    gradient.submat(offset, 0, offset + outSize * outSize - 1, 0) =
+        arma::vectorise(sequenceError.rows(rows[i]) *
+        outParameter.cols(0, n - 1).t());
+    offset += outSize * outSize;
+  }
+
+  // Cell to output gate weights.
+  gradient.submat(offset, 0, offset + outSize - 1, 0) = arma::sum(
+      sequenceError.rows(rows[0]) % cell.cols(0, n - 1), 1);
+  offset += outSize;
+
+  // Cell to forget and input gate weights; these use the cell state of the
+  // previous time step, which is zero for the first one.
+  if (n > batchSize)
+  {
+    gradient.submat(offset, 0, offset + outSize - 1, 0) = arma::sum(
+        sequenceError.submat(rows[1], arma::span(batchSize, n - 1)) %
+        cell.cols(0, n - batchSize - 1), 1);
+    gradient.submat(offset + outSize, 0, offset + 2 * outSize - 1, 0) =
+        arma::sum(sequenceError.submat(rows[2], arma::span(batchSize, n - 1)) %
+        cell.cols(0, n - batchSize - 1), 1);
+  }
+  else
+  {
+    gradient.submat(offset, 0, offset + 2 * outSize - 1, 0).zeros();
+  }
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void LSTM<InputDataType, OutputDataType>::serialize(
@@ -52,6 +52,9 @@ template <
 class MaxPooling
 {
  public:
+  // Convenience typedefs.
+  typedef typename OutputDataType::elem_type ElemType;
+
   //! Create the MaxPooling object.
   MaxPooling();
 
@@ -134,6 +137,27 @@ class MaxPooling
   //! Modify the value of the deterministic parameter.
   bool& Deterministic() { return deterministic; }
 
+  //! Get the number of forward passes that have not been passed backward yet.
+  size_t PendingPasses() const { return poolingIndices.size(); }
+
+  /**
+   * Save the state of the last forward pass in training mode, whose forward
+   * pass is recomputed before its backward pass: the maxima are found again,
+   * so the offsets of the pass are dropped.
+   *
+   * @param state Set to an empty matrix.
+   */
+  void SaveForwardState(arma::mat& state);
+
+  /**
+   * Let the next forward pass in training mode recompute the pass whose state
+   * was saved.  The pass only depends on its input, so there is nothing to
+   * restore.
+   *
+   * @param state The (empty) state saved by SaveForwardState().
+   */
+  void RestoreForwardState(const arma::mat& /* state */) { }
+
   /**
    * Serialize the layer
    */
@@ -141,57 +165,22 @@ class MaxPooling
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
- /**
-   * Apply pooling to the input and store the results.
-   *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
-   */
-  template<typename eT>
-  void PoolingOperation(const arma::Mat<eT>& input,
-                        arma::Mat<eT>& output,
-                        arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dW)
-    {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dH)
-      {
-        arma::mat subInput = input(arma::span(rowidx, rowidx + kW - 1 - offset),
-            arma::span(colidx, colidx + kH - 1 - offset));
-
-        const size_t idx = pooling.Pooling(subInput);
-        output(i, j) = subInput(idx);
-
-        if (!deterministic)
-        {
-          arma::Mat<size_t> subIndices = indices(arma::span(rowidx,
-              rowidx + kW - 1 - offset),
-              arma::span(colidx, colidx + kH - 1 - offset));
-
-          poolingIndices(i, j) = subIndices(idx);
-        }
-      }
-    }
-  }
-
   /**
-   * Apply unpooling to the input and store the results.
+   * Apply pooling to all the maps of the input and store the results.  The
+   * maps are stored one after the other (each map column-major), as in the
+   * input and output matrices, so the batch is handled in a single pass.
    *
-   * @param error The backward error.
+   * @param input The maps to apply the pooling rule to.
    * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
+   * @param maps Number of maps.
+   * @param indices If not NULL, the offset of the maximum of every window in
+   *     the input is stored here.
    */
   template<typename eT>
-  void Unpooling(const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output,
-                 arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
-    {
-      output(poolingIndices(i)) += error(i);
-    }
-  }
+  void PoolingOperation(const eT* input,
+                        eT* output,
+                        const size_t maps,
+                        size_t* indices) const;
 
   //! Locally-stored number of input units.
   size_t inSize;
@@ -235,18 +224,6 @@ class MaxPooling
   //! If true use maximum a posteriori during the forward pass.
   bool deterministic;
 
-  //! Locally-stored output parameter.
-  arma::cube outputTemp;
-
-  //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
-
-  //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
-
-  //! Locally-stored pooling strategy.
-  MaxPoolingRule pooling;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -259,14 +236,9 @@ class MaxPooling
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored indices matrix parameter.
-  arma::Mat<size_t> indices;
-
-  //! Locally-stored indices column parameter.
-  arma::Col<size_t> indicesCol;
-
-  //! Locally-stored pooling indicies.
-  std::vector<arma::cube> poolingIndices;
+  //! Locally-stored offsets of the maxima in the input, one column for each
+  //! forward pass that has not been passed backward yet.
+  std::vector<arma::Col<size_t> > poolingIndices;
 }; // class MaxPooling
 
 } // namespace ann
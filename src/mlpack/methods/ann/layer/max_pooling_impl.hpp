@@ -54,7 +54,6 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
   const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
   const size_t slices = input.n_elem / (inputWidth * inputHeight);
-  inputTemp = arma::cube(input.memptr(), inputWidth, inputHeight, slices);
 
   if (floor)
   {
@@ -69,43 +68,22 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      slices);
+  // Each column of the output holds the pooled maps of one input point.
+  output.set_size(outputWidth * outputHeight * slices / input.n_cols,
+      input.n_cols);
 
   if (!deterministic)
   {
-    poolingIndices.push_back(outputTemp);
+    poolingIndices.push_back(arma::Col<size_t>(output.n_elem));
+    PoolingOperation(input.memptr(), output.memptr(), slices,
+        poolingIndices.back().memptr());
   }
-
-  if (!reset)
+  else
   {
-    size_t elements = inputWidth * inputHeight;
-    indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
-        elements);
-
-    indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth, inputHeight);
-
-    reset = true;
+    PoolingOperation(input.memptr(), output.memptr(), slices, (size_t*) NULL);
   }
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-  {
-    if (!deterministic)
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-        poolingIndices.back().slice(s));
-    }
-    else
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-          inputTemp.slice(s));
-    }
-  }
-
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem, 1);
-
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
+  inSize = input.n_rows;
   outSize = slices;
 }
 
@@ -114,21 +92,97 @@ template<typename eT>
 void MaxPooling<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError = arma::cube(gy.memptr(), outputWidth,
-      outputHeight, outSize);
+  const arma::Col<size_t>& maxima = poolingIndices.back();
+
+  g.zeros(inSize, gy.n_cols);
+  for (size_t i = 0; i < maxima.n_elem; ++i)
+    g[maxima[i]] += gy[i];
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  poolingIndices.pop_back();
+}
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+template<typename InputDataType, typename OutputDataType>
+void MaxPooling<InputDataType, OutputDataType>::SaveForwardState(
+    arma::mat& state)
+{
+  if (!deterministic && !poolingIndices.empty())
+    poolingIndices.pop_back();
+
+  state.reset();
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void MaxPooling<InputDataType, OutputDataType>::PoolingOperation(
+    const eT* input,
+    eT* output,
+    const size_t maps,
+    size_t* indices) const
+{
+  const size_t mapSize = inputWidth * inputHeight;
+  const size_t windowRows = kW - offset;
+  const size_t windowCols = kH - offset;
+
+  // Ties go to the first maximum of the window in column-major order.
+  if (windowRows == 2 && windowCols == 2 && dW == 2 && dH == 2 &&
+      2 * outputWidth <= inputWidth && 2 * outputHeight <= inputHeight)
   {
-    Unpooling(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.back().slice(s));
-  }
+    for (size_t s = 0; s < maps; ++s)
+    {
+      const size_t mapOffset = s * mapSize;
+      const eT* map = input + mapOffset;
+      for (size_t j = 0; j < outputHeight; ++j)
+      {
+        for (size_t i = 0; i < outputWidth; ++i, ++output)
+        {
+          const size_t first = 2 * j * inputWidth + 2 * i;
+          size_t best = first;
+          if (map[first + 1] > map[best])
+            best = first + 1;
+          if (map[first + inputWidth] > map[best])
+            best = first + inputWidth;
+          if (map[first + inputWidth + 1] > map[best])
+            best = first + inputWidth + 1;
+
+          *output = map[best];
+          if (indices)
+            *indices++ = mapOffset + best;
+        }
+      }
+    }
 
-  poolingIndices.pop_back();
+    return;
+  }
 
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1);
+  for (size_t s = 0; s < maps; ++s)
+  {
+    const size_t mapOffset = s * mapSize;
+    const eT* map = input + mapOffset;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const size_t colBegin = std::min(j * dH, inputHeight - 1);
+      const size_t colEnd = std::min(colBegin + windowCols, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i, ++output)
+      {
+        const size_t rowBegin = std::min(i * dW, inputWidth - 1);
+        const size_t rowEnd = std::min(rowBegin + windowRows, inputWidth);
+
+        size_t best = colBegin * inputWidth + rowBegin;
+        for (size_t c = colBegin; c < colEnd; ++c)
+        {
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+          {
+            if (map[c * inputWidth + r] > map[best])
+              best = c * inputWidth + r;
+          }
+        }
+
+        *output = map[best];
+        if (indices)
+          *indices++ = mapOffset + best;
+      }
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
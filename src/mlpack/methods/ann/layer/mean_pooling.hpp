@@ -33,6 +33,9 @@ template <
 class MeanPooling
 {
  public:
+  // Convenience typedefs.
+  typedef typename OutputDataType::elem_type ElemType;
+
   //! Create the MeanPooling object.
   MeanPooling();
 
@@ -122,60 +125,26 @@ class MeanPooling
 
  private:
   /**
-   * Apply pooling to the input and store the results.
+   * Apply pooling to all the maps of the input and store the results.  The
+   * maps are stored one after the other (each map column-major), as in the
+   * input and output matrices, so the batch is handled in a single pass.
    *
-   * @param input The input to be apply the pooling rule.
+   * @param input The maps to apply the pooling rule to.
    * @param output The pooled result.
+   * @param maps Number of maps.
    */
   template<typename eT>
-  void Pooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
-  {
-    const size_t rStep = kW;
-    const size_t cStep = kH;
-
-    for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dH)
-    {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dW)
-      {
-        arma::mat subInput = input(
-            arma::span(rowidx, rowidx + rStep - 1 - offset),
-            arma::span(colidx, colidx + cStep - 1 - offset));
-
-        output(i, j) = arma::mean(arma::mean(subInput));
-      }
-    }
-  }
+  void Pooling(const eT* input, eT* output, const size_t maps) const;
 
   /**
-   * Apply unpooling to the input and store the results.
+   * Spread the error of every window evenly over the inputs of the window.
    *
-   * @param input The input to be apply the unpooling rule.
-   * @param output The pooled result.
+   * @param error The backward error of all the maps.
+   * @param output The unpooled result; has to be zero.
+   * @param maps Number of maps.
    */
   template<typename eT>
-  void Unpooling(const arma::Mat<eT>& input,
-                 const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output)
-  {
-    const size_t rStep = input.n_rows / error.n_rows - offset;
-    const size_t cStep = input.n_cols / error.n_cols - offset;
-
-    arma::Mat<eT> unpooledError;
-    for (size_t j = 0; j < input.n_cols - cStep; j += cStep)
-    {
-      for (size_t i = 0; i < input.n_rows - rStep; i += rStep)
-      {
-        const arma::Mat<eT>& inputArea = input(arma::span(i, i + rStep - 1),
-            arma::span(j, j + cStep - 1));
-
-        unpooledError = arma::Mat<eT>(inputArea.n_rows, inputArea.n_cols);
-        unpooledError.fill(error(i / rStep, j / cStep) / inputArea.n_elem);
-
-        output(arma::span(i, i + rStep - 1 - offset),
-            arma::span(j, j + cStep - 1 - offset)) += unpooledError;
-      }
-    }
-  }
+  void Unpooling(const eT* error, eT* output, const size_t maps) const;
 
   //! Locally-stored number of input units.
   size_t inSize;
@@ -219,15 +188,6 @@ class MeanPooling
   //! Locally-stored stored rounding offset.
   size_t offset;
 
-  //! Locally-stored output parameter.
-  arma::cube outputTemp;
-
-  //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
-
-  //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -54,7 +54,6 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
   size_t slices = input.n_elem / (inputWidth * inputHeight);
-  inputTemp = arma::cube(input.memptr(), inputWidth, inputHeight, slices);
 
   if (floor)
   {
@@ -71,16 +70,12 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      slices);
+  // Each column of the output holds the pooled maps of one input point.
+  output.set_size(outputWidth * outputHeight * slices / input.n_cols,
+      input.n_cols);
+  Pooling(input.memptr(), output.memptr(), slices);
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-    Pooling(inputTemp.slice(s), outputTemp.slice(s));
-
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem, 1);
-
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
+  inSize = input.n_rows;
   outSize = slices;
 }
 
@@ -91,18 +86,95 @@ void MeanPooling<InputDataType, OutputDataType>::Backward(
   arma::Mat<eT>&& gy,
   arma::Mat<eT>&& g)
 {
-  arma::cube mappedError = arma::cube(gy.memptr(), outputWidth,
-      outputHeight, outSize);
+  g.zeros(inSize, gy.n_cols);
+  Unpooling(gy.memptr(), g.memptr(), outSize);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void MeanPooling<InputDataType, OutputDataType>::Pooling(
+    const eT* input,
+    eT* output,
+    const size_t maps) const
+{
+  const size_t mapSize = inputWidth * inputHeight;
+  const size_t windowRows = kW - offset;
+  const size_t windowCols = kH - offset;
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  if (windowRows == 2 && windowCols == 2 && dW == 2 && dH == 2 &&
+      2 * outputWidth <= inputWidth && 2 * outputHeight <= inputHeight)
+  {
+    for (size_t s = 0; s < maps; ++s)
+    {
+      const eT* map = input + s * mapSize;
+      for (size_t j = 0; j < outputHeight; ++j)
+      {
+        const eT* left = map + 2 * j * inputWidth;
+        const eT* right = left + inputWidth;
+        for (size_t i = 0; i < outputWidth; ++i, ++output)
+        {
+          *output = (left[2 * i] + left[2 * i + 1] + right[2 * i] +
+              right[2 * i + 1]) / 4;
+        }
+      }
+    }
+
+    return;
+  }
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  for (size_t s = 0; s < maps; ++s)
   {
-    Unpooling(inputTemp.slice(s), mappedError.slice(s), gTemp.slice(s));
+    const eT* map = input + s * mapSize;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const size_t colBegin = std::min(j * dH, inputHeight - 1);
+      const size_t colEnd = std::min(colBegin + windowCols, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i, ++output)
+      {
+        const size_t rowBegin = std::min(i * dW, inputWidth - 1);
+        const size_t rowEnd = std::min(rowBegin + windowRows, inputWidth);
+
+        eT sum = 0;
+        for (size_t c = colBegin; c < colEnd; ++c)
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+            sum += map[c * inputWidth + r];
+
+        *output = sum / ((rowEnd - rowBegin) * (colEnd - colBegin));
+      }
+    }
   }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void MeanPooling<InputDataType, OutputDataType>::Unpooling(
+    const eT* error,
+    eT* output,
+    const size_t maps) const
+{
+  const size_t mapSize = inputWidth * inputHeight;
+  const size_t windowRows = kW - offset;
+  const size_t windowCols = kH - offset;
 
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1);
+  for (size_t s = 0; s < maps; ++s)
+  {
+    eT* map = output + s * mapSize;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const size_t colBegin = std::min(j * dH, inputHeight - 1);
+      const size_t colEnd = std::min(colBegin + windowCols, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i, ++error)
+      {
+        const size_t rowBegin = std::min(i * dW, inputWidth - 1);
+        const size_t rowEnd = std::min(rowBegin + windowRows, inputWidth);
+
+        const eT share = *error / ((rowEnd - rowBegin) * (colEnd - colBegin));
+        for (size_t c = colBegin; c < colEnd; ++c)
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+            map[c * inputWidth + r] += share;
+      }
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -0,0 +1,271 @@
+/**
+ * @file multihead_attention.hpp
+ *
+ * Definition of the MultiheadAttention layer class, the multi-head scaled
+ * dot-product self-attention of the Transformer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the MultiheadAttention layer class.  The input of a point
+ * is a sequence of embeddings stored one after the other (so a column has
+ * embedSize times the sequence length rows).  Every embedding is projected to a
+ * query, a key and a value; every one of the heads attends with its share of
+ * the units of the queries to the keys of the sequence,
+ *
+ *   head(Q, K, V) = V softmax(K^T Q / sqrt(d)),
+ *
+ * and the concatenated heads are projected back to embedSize units.  With
+ * causal masking every element only attends to itself and the elements before
+ * it.
+ *
+ * The projections of all the elements of the batch are computed with one
+ * matrix product each.  The softmax is computed blockwise, with a running
+ * maximum and sum over blocks of keys (as in FlashAttention), so the memory
+ * needed does not grow with the square of the sequence length: the scores of
+ * one block of queries and one block of keys are held at a time, and the
+ * backward pass recomputes them from the stored log-sum-exp of every query.
+ * With causal masking the blocks of keys past the queries are skipped.
+ *
+ * For more information, see the following papers.
+ *
+ * @code
+ * @inproceedings{Vaswani2017,
+ *   author    = {Ashish Vaswani and Noam Shazeer and Niki Parmar and
+ *                Jakob Uszkoreit and Llion Jones and Aidan N. Gomez and
+ *                Lukasz Kaiser and Illia Polosukhin},
+ *   title     = {Attention is All you Need},
+ *   booktitle = {Advances in Neural Information Processing Systems 30},
+ *   year      = {2017}
+ * }
+ *
+ * @inproceedings{Dao2022,
+ *   author    = {Tri Dao and Daniel Y. Fu and Stefano Ermon and Atri Rudra
+ *                and Christopher R{\'e}},
+ *   title     = {FlashAttention: Fast and Memory-Efficient Exact Attention
+ *                with IO-Awareness},
+ *   booktitle = {Advances in Neural Information Processing Systems 35},
+ *   year      = {2022}
+ * }
+ * @endcode
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class MultiheadAttention
+{
+ public:
+  // Convenience typedefs.
+  typedef typename OutputDataType::elem_type ElemType;
+
+  //! Create the MultiheadAttention object.
+  MultiheadAttention();
+
+  /**
+   * Create the MultiheadAttention layer object.
+   *
+   * @param embedSize The number of units of each embedding.
+   * @param numHeads The number of heads (embedSize must be a multiple of it).
+   * @param causal If true, every element only attends to itself and the
+   *        elements before it.
+   * @param blockSize The number of queries and keys of the blocks the softmax
+   *        is computed over.
+   */
+  MultiheadAttention(const size_t embedSize,
+                     const size_t numHeads,
+                     const bool causal = false,
+                     const size_t blockSize = 64);
+
+  /*
+   * Reset the layer parameter.
+   */
+  void Reset();
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>&& input,
+                arma::Mat<eT>&& error,
+                arma::Mat<eT>&& gradient);
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  //! Get the number of units of each embedding.
+  size_t EmbedSize() const { return embedSize; }
+
+  //! Get the number of heads.
+  size_t NumHeads() const { return numHeads; }
+
+  //! Get whether causal masking is used.
+  bool Causal() const { return causal; }
+  //! Modify whether causal masking is used.
+  bool& Causal() { return causal; }
+
+  //! Get the number of queries and keys of the softmax blocks.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of queries and keys of the softmax blocks.
+  size_t& BlockSize() { return blockSize; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Compute the output of the given head for the given sequence of the
+  //! batch.
+  void HeadForward(const size_t sequence, const size_t head);
+
+  //! Compute the error of the queries, keys and values of the given head for
+  //! the given sequence of the batch.
+  void HeadBackward(const size_t sequence, const size_t head);
+
+  //! Compute the error of the queries, keys and values of all the heads from
+  //! the error of the output.
+  template<typename eT>
+  void AttentionBackward(const arma::Mat<eT>& gy);
+
+  //! Set the scores of the keys after the queries of a block to -infinity.
+  void Mask(OutputDataType& scores,
+            const size_t firstKey,
+            const size_t firstQuery) const;
+
+  //! Locally-stored number of units of each embedding.
+  size_t embedSize;
+
+  //! Locally-stored number of heads.
+  size_t numHeads;
+
+  //! Locally-stored causal masking setting.
+  bool causal;
+
+  //! Locally-stored number of queries and keys of the softmax blocks.
+  size_t blockSize;
+
+  //! Locally-stored number of elements of the sequences of the batch.
+  size_t sequenceLength;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! Locally-stored query, key and value projection (stacked).
+  OutputDataType inWeight;
+
+  //! Locally-stored output projection.
+  OutputDataType outWeight;
+
+  //! Locally-stored query, key and value bias (stacked).
+  OutputDataType inBias;
+
+  //! Locally-stored output bias.
+  OutputDataType outBias;
+
+  //! Locally-stored queries, keys and values (one column per element).
+  OutputDataType qkv;
+
+  //! Locally-stored concatenated outputs of the heads.
+  OutputDataType attention;
+
+  //! Locally-stored log-sum-exp of the scores of every query (one column per
+  //! head of every sequence).
+  OutputDataType logSumExp;
+
+  //! Locally-stored error of the concatenated outputs of the heads.
+  OutputDataType attentionError;
+
+  //! Locally-stored error of the queries, keys and values.
+  OutputDataType qkvError;
+
+  //! Whether qkvError holds the error of the last forward pass.
+  bool backwardReady;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class MultiheadAttention
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "multihead_attention_impl.hpp"
+
+#endif
@@ -0,0 +1,327 @@
+/**
+ * @file multihead_attention_impl.hpp
+ *
+ * Implementation of the MultiheadAttention layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "multihead_attention.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+MultiheadAttention<InputDataType, OutputDataType>::MultiheadAttention() :
+    embedSize(0),
+    numHeads(1),
+    causal(false),
+    blockSize(64),
+    sequenceLength(0),
+    backwardReady(false)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+MultiheadAttention<InputDataType, OutputDataType>::MultiheadAttention(
+    const size_t embedSize,
+    const size_t numHeads,
+    const bool causal,
+    const size_t blockSize) :
+    embedSize(embedSize),
+    numHeads(numHeads),
+    causal(causal),
+    blockSize(blockSize),
+    sequenceLength(0),
+    backwardReady(false)
+{
+  if (numHeads == 0 || embedSize % numHeads != 0)
+  {
+    Log::Fatal << "MultiheadAttention<>: the embedding size (" << embedSize
+        << ") must be a multiple of the number of heads (" << numHeads << ")!"
+        << std::endl;
+  }
+
+  if (blockSize == 0)
+    Log::Fatal << "MultiheadAttention<>: the block size must be positive!"
+        << std::endl;
+
+  weights.set_size(4 * embedSize * (embedSize + 1), 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void MultiheadAttention<InputDataType, OutputDataType>::Reset()
+{
+  ElemType* parameters = weights.memptr();
+  inWeight = OutputDataType(parameters, 3 * embedSize, embedSize, false,
+      false);
+  parameters += inWeight.n_elem;
+  outWeight = OutputDataType(parameters, embedSize, embedSize, false, false);
+  parameters += outWeight.n_elem;
+  inBias = OutputDataType(parameters, 3 * embedSize, 1, false, false);
+  parameters += inBias.n_elem;
+  outBias = OutputDataType(parameters, embedSize, 1, false, false);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void MultiheadAttention<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  if (input.n_rows == 0 || input.n_rows % embedSize != 0)
+  {
+    Log::Fatal << "MultiheadAttention<>::Forward(): the input must be a "
+        << "sequence of embeddings of " << embedSize << " units!" << std::endl;
+  }
+
+  // The input is a sequence of embeddings per column, so seen as a matrix of
+  // one embedding per column it holds all the elements of the batch, and the
+  // projections are one matrix product each.
+  sequenceLength = input.n_rows / embedSize;
+  const size_t elements = input.n_elem / embedSize;
+  const arma::Mat<eT> x(const_cast<eT*>(input.memptr()), embedSize, elements,
+      false, true);
+
+  qkv = inWeight * x;
+  qkv.each_col() += inBias;
+
+  attention.set_size(embedSize, elements);
+  logSumExp.set_size(sequenceLength, numHeads * input.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) (numHeads * input.n_cols); ++i)
+    HeadForward(i / numHeads, i % numHeads);
+
+  output.set_size(input.n_rows, input.n_cols);
+  arma::Mat<eT> y(output.memptr(), embedSize, elements, false, true);
+  y = outWeight * attention;
+  y.each_col() += outBias;
+
+  backwardReady = false;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void MultiheadAttention<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  AttentionBackward(gy);
+
+  g.set_size(gy.n_rows, gy.n_cols);
+  arma::Mat<eT> result(g.memptr(), embedSize, qkvError.n_cols, false, true);
+  result = inWeight.t() * qkvError;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void MultiheadAttention<InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>&& input,
+    arma::Mat<eT>&& error,
+    arma::Mat<eT>&& gradient)
+{
+  // The FFN class does not call Backward() for its first layer.
+  if (!backwardReady)
+    AttentionBackward(error);
+
+  const size_t elements = input.n_elem / embedSize;
+  const arma::Mat<eT> x(const_cast<eT*>(input.memptr()), embedSize, elements,
+      false, true);
+  const arma::Mat<eT> err(error.memptr(), embedSize, elements, false, true);
+
+  gradient.set_size(weights.n_elem, 1);
+  size_t offset = 0;
+  gradient.rows(offset, offset + inWeight.n_elem - 1) =
+      arma::vectorise(qkvError * x.t());
+  offset += inWeight.n_elem;
+  gradient.rows(offset, offset + outWeight.n_elem - 1) =
+      arma::vectorise(err * attention.t());
+  offset += outWeight.n_elem;
+  gradient.rows(offset, offset + inBias.n_elem - 1) = arma::sum(qkvError, 1);
+  offset += inBias.n_elem;
+  gradient.rows(offset, gradient.n_elem - 1) = arma::sum(err, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void MultiheadAttention<InputDataType, OutputDataType>::AttentionBackward(
+    const arma::Mat<eT>& gy)
+{
+  const size_t elements = gy.n_elem / embedSize;
+  const arma::Mat<eT> error(const_cast<eT*>(gy.memptr()), embedSize, elements,
+      false, true);
+
+  attentionError = outWeight.t() * error;
+  qkvError.zeros(3 * embedSize, elements);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) (numHeads * gy.n_cols); ++i)
+    HeadBackward(i / numHeads, i % numHeads);
+
+  backwardReady = true;
+}
+
+template<typename InputDataType, typename OutputDataType>
+void MultiheadAttention<InputDataType, OutputDataType>::HeadForward(
+    const size_t sequence, const size_t head)
+{
+  const size_t headSize = embedSize / numHeads;
+  const size_t first = sequence * sequenceLength;
+  const size_t queryRow = head * headSize;
+  const size_t keyRow = embedSize + queryRow;
+  const size_t valueRow = 2 * embedSize + queryRow;
+  const ElemType scale = 1.0 / std::sqrt((double) headSize);
+  const ElemType infinity = std::numeric_limits<ElemType>::infinity();
+
+  for (size_t qs = 0; qs < sequenceLength; qs += blockSize)
+  {
+    const size_t qe = std::min(qs + blockSize, sequenceLength) - 1;
+    const OutputDataType q = qkv.submat(queryRow, first + qs,
+        queryRow + headSize - 1, first + qe) * scale;
+
+    // The running maximum and sum of the exponentials of the scores of every
+    // query, and the sum of the values weighted by them.
+    arma::Row<ElemType> maxScore(q.n_cols);
+    maxScore.fill(-infinity);
+    arma::Row<ElemType> sum(q.n_cols, arma::fill::zeros);
+    OutputDataType result(headSize, q.n_cols, arma::fill::zeros);
+
+    const size_t lastKey = causal ? qe : sequenceLength - 1;
+    for (size_t ks = 0; ks <= lastKey; ks += blockSize)
+    {
+      const size_t ke = std::min(ks + blockSize - 1, lastKey);
+      OutputDataType scores = qkv.submat(keyRow, first + ks,
+          keyRow + headSize - 1, first + ke).t() * q;
+      if (causal && ke > qs)
+        Mask(scores, ks, qs);
+
+      // The first block holds the first key, which every query attends to, so
+      // the maximum is finite from then on.
+      arma::Row<ElemType> newMax = arma::max(scores, 0);
+      for (size_t j = 0; j < newMax.n_elem; ++j)
+        newMax[j] = std::max(newMax[j], maxScore[j]);
+      scores.each_row() -= newMax;
+      scores = arma::exp(scores);
+
+      const arma::Row<ElemType> correction = arma::exp(maxScore - newMax);
+      sum = sum % correction + arma::sum(scores, 0);
+      result.each_row() %= correction;
+      result += qkv.submat(valueRow, first + ks, valueRow + headSize - 1,
+          first + ke) * scores;
+      maxScore = newMax;
+    }
+
+    result.each_row() /= sum;
+    attention.submat(queryRow, first + qs, queryRow + headSize - 1,
+        first + qe) = result;
+    logSumExp.submat(qs, sequence * numHeads + head, qe,
+        sequence * numHeads + head) = (maxScore + arma::log(sum)).t();
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void MultiheadAttention<InputDataType, OutputDataType>::HeadBackward(
+    const size_t sequence, const size_t head)
+{
+  const size_t headSize = embedSize / numHeads;
+  const size_t first = sequence * sequenceLength;
+  const size_t queryRow = head * headSize;
+  const size_t keyRow = embedSize + queryRow;
+  const size_t valueRow = 2 * embedSize + queryRow;
+  const ElemType scale = 1.0 / std::sqrt((double) headSize);
+
+  for (size_t qs = 0; qs < sequenceLength; qs += blockSize)
+  {
+    const size_t qe = std::min(qs + blockSize, sequenceLength) - 1;
+    const OutputDataType q = qkv.submat(queryRow, first + qs,
+        queryRow + headSize - 1, first + qe) * scale;
+    const OutputDataType outputError = attentionError.submat(queryRow,
+        first + qs, queryRow + headSize - 1, first + qe);
+    const arma::Row<ElemType> lse = logSumExp.submat(qs,
+        sequence * numHeads + head, qe, sequence * numHeads + head).t();
+
+    // The derivative of the softmax needs the sum over the keys of the
+    // probabilities times the error of the probabilities, which is the error
+    // of the output times the output.
+    const arma::Row<ElemType> outputDot = arma::sum(outputError %
+        attention.submat(queryRow, first + qs, queryRow + headSize - 1,
+        first + qe), 0);
+
+    OutputDataType queryError(headSize, q.n_cols, arma::fill::zeros);
+    const size_t lastKey = causal ? qe : sequenceLength - 1;
+    for (size_t ks = 0; ks <= lastKey; ks += blockSize)
+    {
+      const size_t ke = std::min(ks + blockSize - 1, lastKey);
+      const OutputDataType k = qkv.submat(keyRow, first + ks,
+          keyRow + headSize - 1, first + ke);
+      const OutputDataType v = qkv.submat(valueRow, first + ks,
+          valueRow + headSize - 1, first + ke);
+
+      // Recompute the probabilities from the log-sum-exp of the queries.
+      OutputDataType probabilities = k.t() * q;
+      if (causal && ke > qs)
+        Mask(probabilities, ks, qs);
+      probabilities.each_row() -= lse;
+      probabilities = arma::exp(probabilities);
+
+      qkvError.submat(valueRow, first + ks, valueRow + headSize - 1,
+          first + ke) += outputError * probabilities.t();
+
+      OutputDataType scoreError = v.t() * outputError;
+      scoreError.each_row() -= outputDot;
+      scoreError %= probabilities;
+
+      queryError += k * scoreError;
+      qkvError.submat(keyRow, first + ks, keyRow + headSize - 1,
+          first + ke) += q * scoreError.t();
+    }
+
+    qkvError.submat(queryRow, first + qs, queryRow + headSize - 1,
+        first + qe) = queryError * scale;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void MultiheadAttention<InputDataType, OutputDataType>::Mask(
+    OutputDataType& scores,
+    const size_t firstKey,
+    const size_t firstQuery) const
+{
+  const ElemType infinity = std::numeric_limits<ElemType>::infinity();
+  for (size_t j = 0; j < scores.n_cols; ++j)
+  {
+    // Keys after query firstQuery + j are hidden from it.
+    for (size_t i = 0; i < scores.n_rows; ++i)
+    {
+      if (firstKey + i > firstQuery + j)
+        scores(i, j) = -infinity;
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void MultiheadAttention<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(embedSize);
+  ar & BOOST_SERIALIZATION_NVP(numHeads);
+  ar & BOOST_SERIALIZATION_NVP(causal);
+  ar & BOOST_SERIALIZATION_NVP(blockSize);
+
+  // This is inefficient, but we have to allocate this memory so that
+  // WeightSetVisitor gets the right size.
+  if (Archive::is_loading::value)
+    weights.set_size(4 * embedSize * (embedSize + 1), 1);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
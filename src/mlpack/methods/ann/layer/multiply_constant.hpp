@@ -55,6 +55,9 @@ class MultiplyConstant
   template<typename DataType>
   void Backward(const DataType&& /* input */, DataType&& gy, DataType&& g);
 
+  //! Get the constant scalar value.
+  double Scalar() const { return scalar; }
+
   //! Get the input parameter.
   InputDataType& InputParameter() const { return inputParameter; }
   //! Modify the input parameter.
@@ -0,0 +1,152 @@
+/**
+ * @file positional_encoding.hpp
+ *
+ * Definition of the PositionalEncoding layer class, which adds the sinusoidal
+ * position signal to a sequence of embeddings.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_POSITIONAL_ENCODING_HPP
+#define MLPACK_METHODS_ANN_LAYER_POSITIONAL_ENCODING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the PositionalEncoding layer class.  The input of a point
+ * is a sequence of embeddings stored one after the other, and the layer adds
+ *
+ *   PE(t, 2i) = sin(t / 10000^(2i / d)),
+ *   PE(t, 2i + 1) = cos(t / 10000^(2i / d))
+ *
+ * to the i-th unit of the embedding of the t-th element, with d the
+ * dimensionality of the embeddings, so that the following attention layers
+ * can tell the positions apart.  Sequences of any length up to the maximum
+ * can be given.  The layer has no trainable parameters; learned position
+ * embeddings are an Add layer of embedding size times sequence length units.
+ *
+ * For more information, see the following paper.
+ *
+ * @code
+ * @inproceedings{Vaswani2017,
+ *   author    = {Ashish Vaswani and Noam Shazeer and Niki Parmar and
+ *                Jakob Uszkoreit and Llion Jones and Aidan N. Gomez and
+ *                Lukasz Kaiser and Illia Polosukhin},
+ *   title     = {Attention is All you Need},
+ *   booktitle = {Advances in Neural Information Processing Systems 30},
+ *   year      = {2017}
+ * }
+ * @endcode
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class PositionalEncoding
+{
+ public:
+  //! Create the PositionalEncoding object.
+  PositionalEncoding();
+
+  /**
+   * Create the PositionalEncoding layer object for the given embedding size
+   * and maximum sequence length.
+   *
+   * @param embedSize The number of units of each embedding.
+   * @param maxSequenceLength The largest number of elements of a sequence.
+   */
+  PositionalEncoding(const size_t embedSize, const size_t maxSequenceLength);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network; the error is passed on
+   * unchanged.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the number of units of each embedding.
+  size_t EmbedSize() const { return embedSize; }
+
+  //! Get the largest number of elements of a sequence.
+  size_t MaxSequenceLength() const { return maxSequenceLength; }
+
+  //! Get the position signal of the longest sequence.
+  OutputDataType const& Encoding() const { return encoding; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Compute the position signal.
+  void InitializeEncoding();
+
+  //! Locally-stored number of units of each embedding.
+  size_t embedSize;
+
+  //! Locally-stored largest number of elements of a sequence.
+  size_t maxSequenceLength;
+
+  //! Locally-stored position signal of the longest sequence.
+  OutputDataType encoding;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class PositionalEncoding
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "positional_encoding_impl.hpp"
+
+#endif
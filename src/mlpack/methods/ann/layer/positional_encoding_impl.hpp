@@ -0,0 +1,92 @@
+/**
+ * @file positional_encoding_impl.hpp
+ *
+ * Implementation of the PositionalEncoding layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_POSITIONAL_ENCODING_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_POSITIONAL_ENCODING_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "positional_encoding.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+PositionalEncoding<InputDataType, OutputDataType>::PositionalEncoding() :
+    embedSize(0),
+    maxSequenceLength(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+PositionalEncoding<InputDataType, OutputDataType>::PositionalEncoding(
+    const size_t embedSize,
+    const size_t maxSequenceLength) :
+    embedSize(embedSize),
+    maxSequenceLength(maxSequenceLength)
+{
+  InitializeEncoding();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void PositionalEncoding<InputDataType, OutputDataType>::InitializeEncoding()
+{
+  encoding.set_size(embedSize * maxSequenceLength, 1);
+  for (size_t i = 0; i < embedSize; i += 2)
+  {
+    const double frequency = std::pow(10000.0, -double(i) / embedSize);
+    for (size_t t = 0; t < maxSequenceLength; ++t)
+    {
+      encoding(t * embedSize + i) = std::sin(t * frequency);
+      if (i + 1 < embedSize)
+        encoding(t * embedSize + i + 1) = std::cos(t * frequency);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void PositionalEncoding<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  if (input.n_rows % embedSize != 0 || input.n_rows > encoding.n_elem)
+  {
+    Log::Fatal << "PositionalEncoding<>::Forward(): the input must be a "
+        << "sequence of at most " << maxSequenceLength << " embeddings of "
+        << embedSize << " units!" << std::endl;
+  }
+
+  output = input.each_col() + encoding.rows(0, input.n_rows - 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void PositionalEncoding<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  g = gy;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void PositionalEncoding<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(embedSize);
+  ar & BOOST_SERIALIZATION_NVP(maxSequenceLength);
+
+  if (Archive::is_loading::value)
+    InitializeEncoding();
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
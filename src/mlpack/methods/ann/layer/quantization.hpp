@@ -0,0 +1,154 @@
+/**
+ * @file quantization.hpp
+ *
+ * Definition of the Quantization class, which implements the 8-bit integer
+ * arithmetic used by the quantized layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZATION_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Symmetric linear 8-bit quantization.  A real value x is represented by the
+ * integer q = round(x / scale), clamped to [-127, 127], so that x ~ q * scale.
+ * Weights use one scale per output channel, inputs one scale per tensor.  The
+ * products of quantized values are accumulated in 32-bit integers and only the
+ * sums are converted back to floating point.
+ */
+class Quantization
+{
+ public:
+  /**
+   * Return the scale that maps the given maximum absolute value to the largest
+   * quantized value.
+   *
+   * @param maxValue The maximum absolute value to represent.
+   */
+  static double Scale(const double maxValue)
+  {
+    return (maxValue > 0) ? maxValue / 127.0 : 1.0;
+  }
+
+  /**
+   * Quantize the given data with the given scale.
+   *
+   * @param input The data to quantize.
+   * @param scale The scale of the quantized values.
+   * @param output The quantized data.
+   */
+  template<typename eT>
+  static void Quantize(const arma::Mat<eT>& input,
+                       const double scale,
+                       arma::Mat<arma::s8>& output)
+  {
+    output.set_size(input.n_rows, input.n_cols);
+    Quantize(input.memptr(), input.n_elem, scale, output.memptr());
+  }
+
+  /**
+   * Quantize the given data with the given scale.
+   *
+   * @param input The data to quantize.
+   * @param scale The scale of the quantized values.
+   * @param output The quantized data.
+   */
+  template<typename eT>
+  static void Quantize(const arma::Cube<eT>& input,
+                       const double scale,
+                       arma::Cube<arma::s8>& output)
+  {
+    output.set_size(input.n_rows, input.n_cols, input.n_slices);
+    Quantize(input.memptr(), input.n_elem, scale, output.memptr());
+  }
+
+  /**
+   * Quantize every column of the given matrix with its own scale (e.g. the
+   * weights of one output channel).
+   *
+   * @param input The data to quantize.
+   * @param output The quantized data.
+   * @param scales The scale of every column.
+   */
+  template<typename eT>
+  static void QuantizeColumns(const arma::Mat<eT>& input,
+                              arma::Mat<arma::s8>& output,
+                              arma::vec& scales)
+  {
+    output.set_size(input.n_rows, input.n_cols);
+    scales.set_size(input.n_cols);
+
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      scales(i) = Scale(input.n_rows > 0 ?
+          (double) arma::max(arma::abs(input.col(i))) : 0.0);
+      Quantize(input.colptr(i), input.n_rows, scales(i), output.colptr(i));
+    }
+  }
+
+  /**
+   * Multiply the quantized weights with the quantized input, i.e. compute
+   * output(i, j) = weightScales(i) * inputScale * (weights.col(i)' *
+   * input.col(j)) with 32-bit integer accumulation.
+   *
+   * @param weights The quantized weights with one column per output channel.
+   * @param weightScales The scale of every output channel.
+   * @param input The quantized input with one column per point.
+   * @param inputScale The scale of the input.
+   * @param output The (dequantized) result with one row per output channel.
+   */
+  template<typename eT>
+  static void Multiply(const arma::Mat<arma::s8>& weights,
+                       const arma::vec& weightScales,
+                       const arma::Mat<arma::s8>& input,
+                       const double inputScale,
+                       arma::Mat<eT>& output)
+  {
+    const size_t n = weights.n_rows;
+    output.set_size(weights.n_cols, input.n_cols);
+
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
+    {
+      const arma::s8* x = input.colptr(j);
+      for (size_t i = 0; i < weights.n_cols; ++i)
+      {
+        const arma::s8* w = weights.colptr(i);
+
+        int32_t sum = 0;
+        for (size_t k = 0; k < n; ++k)
+          sum += int32_t(w[k]) * int32_t(x[k]);
+
+        output(i, j) = eT(sum * weightScales(i) * inputScale);
+      }
+    }
+  }
+
+ private:
+  //! Quantize the given number of elements.
+  template<typename eT>
+  static void Quantize(const eT* input,
+                       const size_t n,
+                       const double scale,
+                       arma::s8* output)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double value = std::round(input[i] / scale);
+      output[i] = (arma::s8) std::max(-127.0, std::min(127.0, value));
+    }
+  }
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
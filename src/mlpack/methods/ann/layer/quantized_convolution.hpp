@@ -0,0 +1,220 @@
+/**
+ * @file quantized_convolution.hpp
+ *
+ * Definition of the QuantizedConvolution layer class, an inference only
+ * version of the Convolution layer with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+
+#include "quantization.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the QuantizedConvolution layer class.  The layer computes
+ * the same (valid) convolution as the Convolution layer, but holds the filters
+ * as 8-bit integers with one scale per output map; the input is quantized with
+ * a fixed (calibrated) scale, unfolded into patches (im2col), and the products
+ * are accumulated in 32-bit integers.  The layer has no trainable parameters;
+ * it is usually created from a trained network with FFN::Quantize().
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedConvolution
+{
+ public:
+  //! Create the QuantizedConvolution object.
+  QuantizedConvolution();
+
+  /**
+   * Create the QuantizedConvolution object from the given filters and bias.
+   *
+   * @param inSize The number of input maps.
+   * @param outSize The number of output maps.
+   * @param weight The filters, in the layout of the Convolution layer (the
+   *        filter of output map o and input map i is slice o * inSize + i).
+   * @param bias The bias of every output map.
+   * @param inputScale The scale used to quantize the input; the largest
+   *        absolute input value that can be represented is 127 * inputScale.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param padW Padding width of the input.
+   * @param padH Padding height of the input.
+   * @param inputWidth The width of the input data.
+   * @param inputHeight The height of the input data.
+   */
+  QuantizedConvolution(const size_t inSize,
+                       const size_t outSize,
+                       const arma::cube& weight,
+                       const arma::vec& bias,
+                       const double inputScale,
+                       const size_t dW = 1,
+                       const size_t dH = 1,
+                       const size_t padW = 0,
+                       const size_t padH = 0,
+                       const size_t inputWidth = 0,
+                       const size_t inputHeight = 0);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards through f, using the dequantized filters.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the input width.
+  size_t const& InputWidth() const { return inputWidth; }
+  //! Modify input the width.
+  size_t& InputWidth() { return inputWidth; }
+
+  //! Get the input height.
+  size_t const& InputHeight() const { return inputHeight; }
+  //! Modify the input height.
+  size_t& InputHeight() { return inputHeight; }
+
+  //! Get the output width.
+  size_t const& OutputWidth() const { return outputWidth; }
+  //! Modify the output width.
+  size_t& OutputWidth() { return outputWidth; }
+
+  //! Get the output height.
+  size_t const& OutputHeight() const { return outputHeight; }
+  //! Modify the output height.
+  size_t& OutputHeight() { return outputHeight; }
+
+  //! Get the quantized filters (one column per output map).
+  arma::Mat<arma::s8> const& Weights() const { return weights; }
+
+  //! Get the scale of the filters of every output map.
+  arma::vec const& WeightScales() const { return weightScales; }
+
+  //! Get the scale of the input.
+  double InputScale() const { return inputScale; }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored number of input maps.
+  size_t inSize;
+
+  //! Locally-stored number of output maps.
+  size_t outSize;
+
+  //! Locally-stored filter/kernel width.
+  size_t kW;
+
+  //! Locally-stored filter/kernel height.
+  size_t kH;
+
+  //! Locally-stored stride of the filter in x-direction.
+  size_t dW;
+
+  //! Locally-stored stride of the filter in y-direction.
+  size_t dH;
+
+  //! Locally-stored padding width.
+  size_t padW;
+
+  //! Locally-stored padding height.
+  size_t padH;
+
+  //! Locally-stored quantized filters (one column per output map).
+  arma::Mat<arma::s8> weights;
+
+  //! Locally-stored scale of the filters of every output map.
+  arma::vec weightScales;
+
+  //! Locally-stored bias term object.
+  arma::vec bias;
+
+  //! Locally-stored scale of the input.
+  double inputScale;
+
+  //! Locally-stored input width.
+  size_t inputWidth;
+
+  //! Locally-stored input height.
+  size_t inputHeight;
+
+  //! Locally-stored output width.
+  size_t outputWidth;
+
+  //! Locally-stored output height.
+  size_t outputHeight;
+
+  //! Locally-stored quantized (and padded) input maps.
+  arma::Cube<arma::s8> quantizedInput;
+
+  //! Locally-stored unfolded quantized input patches.
+  arma::Mat<arma::s8> patches;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedConvolution
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_convolution_impl.hpp"
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * @file quantized_convolution_impl.hpp
+ *
+ * Implementation of the QuantizedConvolution layer class, an inference only
+ * version of the Convolution layer with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedConvolution<InputDataType, OutputDataType>::QuantizedConvolution() :
+    inSize(0),
+    outSize(0),
+    kW(0),
+    kH(0),
+    dW(1),
+    dH(1),
+    padW(0),
+    padH(0),
+    inputScale(1.0),
+    inputWidth(0),
+    inputHeight(0),
+    outputWidth(0),
+    outputHeight(0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedConvolution<InputDataType, OutputDataType>::QuantizedConvolution(
+    const size_t inSize,
+    const size_t outSize,
+    const arma::cube& weight,
+    const arma::vec& bias,
+    const double inputScale,
+    const size_t dW,
+    const size_t dH,
+    const size_t padW,
+    const size_t padH,
+    const size_t inputWidth,
+    const size_t inputHeight) :
+    inSize(inSize),
+    outSize(outSize),
+    kW(weight.n_rows),
+    kH(weight.n_cols),
+    dW(dW),
+    dH(dH),
+    padW(padW),
+    padH(padH),
+    bias(bias),
+    inputScale(inputScale),
+    inputWidth(inputWidth),
+    inputHeight(inputHeight),
+    outputWidth(0),
+    outputHeight(0)
+{
+  // Column o holds all filters of output map o, in the order of the columns
+  // of the im2col patches.
+  const arma::mat filterMat(const_cast<double*>(weight.memptr()),
+      kW * kH * inSize, outSize, false, true);
+  Quantization::QuantizeColumns(filterMat, weights, weightScales);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedConvolution<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  const size_t batchSize = input.n_cols;
+  const arma::Cube<eT> inputTemp(const_cast<eT*>(input.memptr()), inputWidth,
+      inputHeight, inSize * batchSize, false, true);
+
+  if (padW != 0 || padH != 0)
+  {
+    arma::Cube<arma::s8> quantized;
+    Quantization::Quantize(inputTemp, inputScale, quantized);
+
+    quantizedInput.zeros(inputWidth + 2 * padW, inputHeight + 2 * padH,
+        inSize * batchSize);
+    quantizedInput.subcube(padW, padH, 0, padW + inputWidth - 1,
+        padH + inputHeight - 1, quantizedInput.n_slices - 1) = quantized;
+  }
+  else
+  {
+    Quantization::Quantize(inputTemp, inputScale, quantizedInput);
+  }
+
+  outputWidth = (quantizedInput.n_rows - kW) / dW + 1;
+  outputHeight = (quantizedInput.n_cols - kH) / dH + 1;
+  const size_t outputElem = outputWidth * outputHeight;
+
+  // Every column of the transposed patch matrix holds one patch.
+  ImToColConvolution<ValidConvolution>::ImToCol(quantizedInput, inSize, kW,
+      kH, dW, dH, patches);
+  const arma::Mat<arma::s8> patchesT = patches.t();
+
+  arma::Mat<eT> result;
+  Quantization::Multiply(weights, weightScales, patchesT, inputScale, result);
+
+  // Reorder the result into the map layout and add the bias.
+  output.set_size(outputElem * outSize, batchSize);
+  for (size_t n = 0; n < batchSize; ++n)
+  {
+    for (size_t outMap = 0; outMap < outSize; ++outMap)
+    {
+      eT* outputPtr = output.colptr(n) + outMap * outputElem;
+      for (size_t i = 0; i < outputElem; ++i)
+        outputPtr[i] = result(outMap, n * outputElem + i) + bias(outMap);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedConvolution<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  const size_t batchSize = gy.n_cols;
+  const arma::Cube<eT> mappedError(gy.memptr(), outputWidth, outputHeight,
+      outSize * batchSize, false, true);
+
+  // The dequantized filters.
+  arma::Mat<eT> filterMat = arma::conv_to<arma::Mat<eT> >::from(weights);
+  filterMat.each_row() %= arma::conv_to<arma::Row<eT> >::from(
+      weightScales.t());
+  const arma::Cube<eT> filter(filterMat.memptr(), kW, kH, outSize * inSize,
+      false, true);
+
+  arma::Cube<eT> gPadded(inputWidth + 2 * padW, inputHeight + 2 * padH,
+      inSize * batchSize);
+  ImToColConvolution<ValidConvolution>::BackwardBatch(mappedError, filter,
+      inSize, outSize, gPadded, dW, dH);
+
+  const arma::Cube<eT> gTemp = gPadded.subcube(padW, padH, 0,
+      padW + inputWidth - 1, padH + inputHeight - 1, gPadded.n_slices - 1);
+  g = arma::Mat<eT>(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedConvolution<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(kW);
+  ar & BOOST_SERIALIZATION_NVP(kH);
+  ar & BOOST_SERIALIZATION_NVP(dW);
+  ar & BOOST_SERIALIZATION_NVP(dH);
+  ar & BOOST_SERIALIZATION_NVP(padW);
+  ar & BOOST_SERIALIZATION_NVP(padH);
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(weightScales);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+  ar & BOOST_SERIALIZATION_NVP(inputScale);
+  ar & BOOST_SERIALIZATION_NVP(inputWidth);
+  ar & BOOST_SERIALIZATION_NVP(inputHeight);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ * @file quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer class, an inference only version of
+ * the Linear layer with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "quantization.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the QuantizedLinear layer class.  The layer computes the
+ * same affine transformation as the Linear layer, but holds the weights as
+ * 8-bit integers with one scale per output unit; the input is quantized with a
+ * fixed (calibrated) scale, and the products are accumulated in 32-bit
+ * integers.  The layer has no trainable parameters; it is usually created from
+ * a trained network with FFN::Quantize().
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedLinear
+{
+ public:
+  //! Create the QuantizedLinear object.
+  QuantizedLinear();
+
+  /**
+   * Create the QuantizedLinear layer object from the given weight and bias.
+   *
+   * @param weight The weight matrix (one row per output unit).
+   * @param bias The bias (one entry per output unit).
+   * @param inputScale The scale used to quantize the input; the largest
+   *        absolute input value that can be represented is 127 * inputScale.
+   */
+  QuantizedLinear(const arma::mat& weight,
+                  const arma::vec& bias,
+                  const double inputScale);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f, using the dequantized weights.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the quantized weights (one column per output unit).
+  arma::Mat<arma::s8> const& Weights() const { return weights; }
+
+  //! Get the scale of the weights of every output unit.
+  arma::vec const& WeightScales() const { return weightScales; }
+
+  //! Get the scale of the input.
+  double InputScale() const { return inputScale; }
+
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the number of output units.
+  size_t OutputSize() const { return outSize; }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored quantized weights (one column per output unit).
+  arma::Mat<arma::s8> weights;
+
+  //! Locally-stored scale of the weights of every output unit.
+  arma::vec weightScales;
+
+  //! Locally-stored bias term object.
+  arma::vec bias;
+
+  //! Locally-stored scale of the input.
+  double inputScale;
+
+  //! Locally-stored quantized input.
+  arma::Mat<arma::s8> quantizedInput;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedLinear
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
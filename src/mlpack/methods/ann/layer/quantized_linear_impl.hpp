@@ -0,0 +1,81 @@
+/**
+ * @file quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear layer class, an inference only version
+ * of the Linear layer with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear() :
+    inSize(0),
+    outSize(0),
+    inputScale(1.0)
+{
+  // Nothing to do here.
+}
+
+template <typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear(
+    const arma::mat& weight,
+    const arma::vec& bias,
+    const double inputScale) :
+    inSize(weight.n_cols),
+    outSize(weight.n_rows),
+    bias(bias),
+    inputScale(inputScale)
+{
+  // Store the weights of every output unit contiguously.
+  Quantization::QuantizeColumns(arma::mat(weight.t()), weights, weightScales);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  Quantization::Quantize(input, inputScale, quantizedInput);
+  Quantization::Multiply(weights, weightScales, quantizedInput, inputScale,
+      output);
+  output.each_col() += arma::conv_to<arma::Col<eT> >::from(bias);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  arma::Mat<eT> scaledError = gy;
+  scaledError.each_col() %= arma::conv_to<arma::Col<eT> >::from(weightScales);
+  g = arma::conv_to<arma::Mat<eT> >::from(weights) * scaledError;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedLinear<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(weightScales);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+  ar & BOOST_SERIALIZATION_NVP(inputScale);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
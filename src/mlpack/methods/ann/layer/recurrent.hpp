@@ -108,6 +108,40 @@ class Recurrent
                 arma::Mat<eT>&& error,
                 arma::Mat<eT>&& /* gradient */);
 
+  /*
+   * Resets the cell to accept a new input: the next time step is the first
+   * step of a sequence and is computed by the start module.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void ResetCell(const size_t size);
+
+  /*
+   * Store the output of the transfer module of the last computed time step,
+   * which is the state of the cell, in the given matrix; there is one column
+   * per sequence of the batch.
+   *
+   * @param state Matrix to store the state in.
+   */
+  void SaveState(OutputDataType& state) const;
+
+  /*
+   * Continue from the given state, in the layout of SaveState(): the next time
+   * step feeds the state back through the feedback module like any step after
+   * the first one.  The number of columns is the batch size of the next time
+   * step.  To start new sequences, reset the cell instead.
+   *
+   * @param state The state to continue from.
+   */
+  void LoadState(const OutputDataType& state);
+
+  /*
+   * Get the number of rows of the state (see SaveState()).  This is the output
+   * size of the transfer module, which is only known once a time step was
+   * computed.
+   */
+  size_t StateSize() const;
+
   //! Get the model modules.
   std::vector<LayerTypes<CustomLayers...> >& Model() { return network; }
 
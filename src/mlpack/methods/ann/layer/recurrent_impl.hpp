@@ -152,6 +152,63 @@ void Recurrent<InputDataType, OutputDataType, CustomLayers...>::Forward(
   }
 }
 
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+void Recurrent<InputDataType, OutputDataType, CustomLayers...>::ResetCell(
+    const size_t /* size */)
+{
+  forwardStep = 0;
+  backwardStep = 0;
+
+  if (!recurrentError.is_empty())
+  {
+    recurrentError.zeros();
+  }
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+void Recurrent<InputDataType, OutputDataType, CustomLayers...>::SaveState(
+    OutputDataType& state) const
+{
+  state = boost::apply_visitor(OutputParameterVisitor(), transferModule);
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+void Recurrent<InputDataType, OutputDataType, CustomLayers...>::LoadState(
+    const OutputDataType& state)
+{
+  if (state.n_rows != StateSize())
+  {
+    Log::Fatal << "Recurrent::LoadState(): the state must have "
+        << StateSize() << " rows, but has " << state.n_rows << "!"
+        << std::endl;
+  }
+
+  boost::apply_visitor(outputParameterVisitor, transferModule) = state;
+
+  // The next step is a feedback step, unless every step is the first one.
+  forwardStep = (rho > 1) ? 1 : 0;
+  backwardStep = 0;
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+size_t Recurrent<InputDataType, OutputDataType, CustomLayers...>::StateSize()
+    const
+{
+  const size_t size = boost::apply_visitor(OutputParameterVisitor(),
+      transferModule).n_rows;
+  if (size == 0)
+  {
+    Log::Fatal << "Recurrent::StateSize(): the size of the state is unknown "
+        << "before the first time step was computed!" << std::endl;
+  }
+
+  return size;
+}
+
 template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 template<typename eT>
@@ -0,0 +1,132 @@
+/**
+ * @file reduced_precision.hpp
+ *
+ * Definition of the ReducedPrecision class, which rounds values to the 16-bit
+ * floating point formats of mixed precision training.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_REDUCED_PRECISION_HPP
+#define MLPACK_METHODS_ANN_LAYER_REDUCED_PRECISION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <cstring>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+//! The formats whose precision the weights and activations of a network can
+//! emulate.
+enum PrecisionType
+{
+  DOUBLE_PRECISION,   //!< 64-bit IEEE floating point (no rounding).
+  BFLOAT16_PRECISION, //!< bfloat16: 8 exponent and 7 mantissa bits.
+  HALF_PRECISION      //!< 16-bit IEEE floating point: 5 and 10 bits.
+};
+
+/**
+ * Conversion to and from the 16-bit floating point formats, with rounding to
+ * the nearest value (ties to even).  bfloat16 has the range of float, so it
+ * only loses precision; half precision values larger than 65504 overflow to
+ * infinity, and those smaller than 2^-24 underflow to zero, which is why
+ * mixed precision training in half precision needs loss scaling.
+ */
+class ReducedPrecision
+{
+ public:
+  //! Convert the given float to bfloat16.
+  static uint16_t ToBFloat16(const float value)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u)
+      return (uint16_t) ((bits >> 16) | 0x40u); // Keep NaNs quiet.
+
+    bits += 0x7FFFu + ((bits >> 16) & 1u);
+    return (uint16_t) (bits >> 16);
+  }
+
+  //! Convert the given bfloat16 to float.
+  static float FromBFloat16(const uint16_t value)
+  {
+    const uint32_t bits = ((uint32_t) value) << 16;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+  }
+
+  //! Convert the given float to half precision.
+  static uint16_t ToHalf(const float value)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = (uint16_t) ((bits >> 16) & 0x8000u);
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+    if (magnitude > 0x7F800000u)
+      return sign | 0x7E00u;
+    // 65520 and above round to infinity.
+    if (magnitude >= 0x477FF000u)
+      return sign | 0x7C00u;
+    // Below 2^-14 the values are subnormal: multiples of 2^-24.
+    if (magnitude < 0x38800000u)
+    {
+      return sign | (uint16_t) std::nearbyint(std::fabs(value) *
+          16777216.0f);
+    }
+
+    // Rebias the exponent, and round away the 13 lowest mantissa bits.
+    uint32_t rebiased = magnitude - 0x38000000u;
+    rebiased += 0xFFFu + ((rebiased >> 13) & 1u);
+    return sign | (uint16_t) (rebiased >> 13);
+  }
+
+  //! Convert the given half precision value to float.
+  static float FromHalf(const uint16_t value)
+  {
+    const uint32_t exponent = (value >> 10) & 0x1Fu;
+    const uint32_t mantissa = value & 0x3FFu;
+    float result;
+    if (exponent == 0)
+      result = std::ldexp((float) mantissa, -24);
+    else if (exponent == 0x1F)
+      result = mantissa ? std::numeric_limits<float>::quiet_NaN() :
+          std::numeric_limits<float>::infinity();
+    else
+      result = std::ldexp((float) (mantissa | 0x400u), (int) exponent - 25);
+
+    return (value & 0x8000u) ? -result : result;
+  }
+
+  /**
+   * Round every element of the given matrix to the value it would have if it
+   * were stored in the given format.
+   *
+   * @param values The values to round.
+   * @param precision The format to round to.
+   */
+  template<typename eT>
+  static void Round(arma::Mat<eT>& values, const PrecisionType precision)
+  {
+    eT* memory = values.memptr();
+    if (precision == BFLOAT16_PRECISION)
+    {
+      for (size_t i = 0; i < values.n_elem; ++i)
+        memory[i] = (eT) FromBFloat16(ToBFloat16((float) memory[i]));
+    }
+    else if (precision == HALF_PRECISION)
+    {
+      for (size_t i = 0; i < values.n_elem; ++i)
+        memory[i] = (eT) FromHalf(ToHalf((float) memory[i]));
+    }
+  }
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
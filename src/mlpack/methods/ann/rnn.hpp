@@ -178,6 +178,31 @@ class RNN
                arma::cube& results,
                const size_t batchSize = 256);
 
+  /**
+   * Compute a single time step of a batch of sequences, continuing each
+   * sequence from the recurrent state left by the previous step.  This is
+   * used to serve sequence models online, where the events of a sequence
+   * arrive one at a time: instead of replaying the whole history through
+   * Predict(), the state of each sequence is kept between the calls.
+   *
+   * The state of a sequence is one column of the state matrix; it holds the
+   * outputs (and, for LSTM and FastLSTM, the cell states) of all recurrent
+   * layers of the network after the step.  The columns can be stored and
+   * regrouped freely between calls, so sequences that were stepped in
+   * different batches can be stepped together, and a column can be saved with
+   * data::Save() or serialized to resume the sequence later (with the same
+   * model).  If the given state is empty, every sequence of the batch starts
+   * anew.  A sequence is never cut into BPTT windows of rho steps here; the
+   * GRU and Recurrent layers need a rho of at least 2 to carry their state
+   * from one call to the next.
+   *
+   * @param input One time step of each sequence, one column per sequence.
+   * @param state The state of each sequence before the step (empty for new
+   *     sequences); it is replaced with the state after the step.
+   * @param output Matrix to put the output of the network for the step into.
+   */
+  void Step(const arma::mat& input, arma::mat& state, arma::mat& output);
+
   /**
    * Evaluate the recurrent neural network with the given parameters. This
    * function is usually called by the optimizer to train the model.
@@ -265,6 +290,35 @@ class RNN
   //! Modify the maximum length of backpropagation through time.
   size_t& Rho() { return rho; }
 
+  /**
+   * Get whether truncated BPTT is used.  If true, Evaluate(), Gradient() and
+   * Predict() walk over all time slices of the sequence in consecutive windows
+   * of rho steps instead of using only the first rho slices.  The state of the
+   * recurrent cells is carried over from one window to the next, but the
+   * gradient is only backpropagated within a window, so the memory needed for
+   * BPTT is bounded by rho no matter how long the sequence is.  Recurrent
+   * layers without support for carrying their state (CarryCell()) are reset at
+   * every window boundary.  The rho of the recurrent layers should be at least
+   * as large as the rho of the network.
+   */
+  bool TruncatedBPTT() const { return truncatedBPTT; }
+  //! Modify whether truncated BPTT is used.
+  bool& TruncatedBPTT() { return truncatedBPTT; }
+
+  /**
+   * Get whether Gradient() may process all time steps of the sequence at once.
+   * If true and every layer supports it (recurrent layers that implement
+   * ForwardSequence(), like FastLSTM and LSTM, and layers that keep no state
+   * from one time step to the next), the input projections, the error of the
+   * inputs and the weight gradients of all time steps are computed with a
+   * single matrix multiplication per layer, instead of one per time step.
+   * Otherwise, or with truncated BPTT, the network is run step by step.  The
+   * resulting gradient is the same either way.  This is enabled by default.
+   */
+  bool FusedSequences() const { return fusedSequences; }
+  //! Modify whether Gradient() may process all time steps at once.
+  bool& FusedSequences() { return fusedSequences; }
+
   /**
    * Reset the state of the network.  This ensures that all internally-held
    * gradients are set to 0, all memory cells are reset, and the parameters
@@ -296,6 +350,16 @@ class RNN
    */
   void ResetCells();
 
+  /**
+   * Prepare the RNN cells in the network for the window of time steps that
+   * starts at the given step (truncated BPTT).  The first window resets the
+   * cells, every following window carries the last cell state over.
+   *
+   * @param step The first time step of the window.
+   * @param steps The overall number of time steps of the sequence.
+   */
+  void ResetWindow(const size_t step, const size_t steps);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -309,6 +373,38 @@ class RNN
   template<typename InputType>
   void Gradient(InputType&& input);
 
+  /**
+   * Compute the gradient with truncated BPTT: the sequence is processed in
+   * consecutive windows of rho steps, each window is forwarded and then
+   * backpropagated before the next window starts.
+   *
+   * @param begin Index of the starting point to use for gradient evaluation.
+   * @param gradient Matrix to accumulate the gradient into.
+   * @param batchSize Number of points to be processed as a batch.
+   */
+  void TruncatedGradient(const size_t begin,
+                         arma::mat& gradient,
+                         const size_t batchSize);
+
+  /**
+   * Check whether every layer of the network can process all rho time steps
+   * of the sequence at once.
+   */
+  bool SequenceSupport() const;
+
+  /**
+   * Compute the gradient with all time steps of the sequence processed at
+   * once: every layer is run over the whole sequence before the next layer
+   * starts, with the columns of each time step side by side.
+   *
+   * @param begin Index of the starting point to use for gradient evaluation.
+   * @param gradient Matrix to accumulate the gradient into.
+   * @param batchSize Number of points to be processed as a batch.
+   */
+  void SequenceGradient(const size_t begin,
+                        arma::mat& gradient,
+                        const size_t batchSize);
+
   /**
    * Reset the module status by setting the current deterministic parameter
    * for all modules that implement the Deterministic function.
@@ -345,6 +441,12 @@ class RNN
     //! Only predict the last element of the input sequence.
   bool single;
 
+  //! Use truncated BPTT over the whole sequence.
+  bool truncatedBPTT;
+
+  //! Process all time steps at once in Gradient() if the layers support it.
+  bool fusedSequences;
+
   //! Locally-stored model modules.
   std::vector<LayerTypes<CustomLayers...> > network;
 
@@ -386,6 +488,9 @@ class RNN
 
   //! The current gradient for the gradient pass.
   arma::mat currentGradient;
+
+  //! The time steps of the current batch side by side (fused sequences).
+  arma::mat sequenceInput;
 }; // class RNN
 
 } // namespace ann
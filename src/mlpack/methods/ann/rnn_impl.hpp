@@ -20,9 +20,16 @@
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
+#include "visitor/carry_cell_visitor.hpp"
+#include "visitor/save_state_visitor.hpp"
+#include "visitor/load_state_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
+#include "visitor/forward_sequence_visitor.hpp"
+#include "visitor/backward_sequence_visitor.hpp"
+#include "visitor/gradient_sequence_visitor.hpp"
+#include "visitor/sequence_check_visitor.hpp"
 #include "visitor/weight_set_visitor.hpp"
 
 #include <boost/serialization/variant.hpp>
@@ -45,6 +52,8 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(0),
     reset(false),
     single(single),
+    truncatedBPTT(false),
+    fusedSequences(true),
     numFunctions(0),
     deterministic(true)
 {
@@ -68,6 +77,8 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(0),
     reset(false),
     single(single),
+    truncatedBPTT(false),
+    fusedSequences(true),
     predictors(std::move(predictors)),
     responses(std::move(responses)),
     numFunctions(0),
@@ -128,6 +139,21 @@ void RNN<OutputLayerType, InitializationRuleType,
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetWindow(const size_t step, const size_t steps)
+{
+  const size_t size = std::min(rho, steps - step);
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    if (step == 0)
+      boost::apply_visitor(ResetCellVisitor(size), network[i]);
+    else
+      boost::apply_visitor(CarryCellVisitor(size), network[i]);
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename OptimizerType>
@@ -177,14 +203,18 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  results = arma::zeros<arma::cube>(outputSize, predictors.n_cols, rho);
+  const size_t steps = truncatedBPTT ? predictors.n_slices : rho;
+  results = arma::zeros<arma::cube>(outputSize, predictors.n_cols, steps);
   // Process in accordance with the given batch size.
   for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
   {
     const size_t effectiveBatchSize = std::min(batchSize,
         size_t(predictors.n_cols - begin));
-    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    for (size_t seqNum = 0; seqNum < steps; ++seqNum)
     {
+      if (truncatedBPTT && (seqNum % rho) == 0)
+        ResetWindow(seqNum, steps);
+
       Forward(std::move(arma::mat(predictors.slice(seqNum).colptr(begin),
           predictors.n_rows, effectiveBatchSize, false, true)));
 
@@ -195,6 +225,56 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Step(
+    const arma::mat& input, arma::mat& state, arma::mat& output)
+{
+  if (parameter.is_empty())
+  {
+    ResetParameters();
+  }
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  if (state.is_empty())
+  {
+    ResetCells();
+  }
+  else
+  {
+    if (state.n_cols != input.n_cols)
+    {
+      Log::Fatal << "RNN::Step(): the state has " << state.n_cols
+          << " columns, but there are " << input.n_cols << " sequences!"
+          << std::endl;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < network.size(); ++i)
+      boost::apply_visitor(LoadStateVisitor(state, offset), network[i]);
+
+    if (offset != state.n_rows)
+    {
+      Log::Fatal << "RNN::Step(): the state has " << state.n_rows
+          << " rows, but the network has a state of " << offset << " rows!"
+          << std::endl;
+    }
+  }
+
+  Forward(std::move(arma::mat(const_cast<double*>(input.memptr()),
+      input.n_rows, input.n_cols, false, true)));
+  output = boost::apply_visitor(outputParameterVisitor, network.back());
+
+  state.reset();
+  for (size_t i = 0; i < network.size(); ++i)
+    boost::apply_visitor(SaveStateVisitor(state), network[i]);
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
@@ -228,8 +308,14 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
 
   double performance = 0;
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  // With truncated BPTT the whole sequence is evaluated window by window; the
+  // module outputs are not stored since Gradient() does its own forward pass.
+  const size_t steps = truncatedBPTT ? predictors.n_slices : rho;
+  for (size_t seqNum = 0; seqNum < steps; ++seqNum)
   {
+    if (truncatedBPTT && (seqNum % rho) == 0)
+      ResetWindow(seqNum, steps);
+
     // Wrap a matrix around our data to avoid a copy.
     arma::mat stepData(predictors.slice(seqNum).colptr(begin),
         predictors.n_rows, batchSize, false, true);
@@ -237,7 +323,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     arma::mat respData(responses.slice(seqNum).colptr(begin),
         responses.n_rows, batchSize, false, true);
 
-    if (!deterministic)
+    if (!deterministic && !truncatedBPTT)
     {
       for (size_t l = 0; l < network.size(); ++l)
       {
@@ -284,6 +370,18 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
     gradient.zeros();
   }
 
+  if (truncatedBPTT)
+  {
+    TruncatedGradient(begin, gradient, batchSize);
+    return;
+  }
+
+  if (fusedSequences && SequenceSupport())
+  {
+    SequenceGradient(begin, gradient, batchSize);
+    return;
+  }
+
   Evaluate(parameters, begin, batchSize, false);
 
   // Initialize current/working gradient.
@@ -326,6 +424,221 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::TruncatedGradient(
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  if (deterministic)
+  {
+    deterministic = false;
+    ResetDeterministic();
+  }
+
+  // Initialize current/working gradient.
+  if (currentGradient.is_empty())
+  {
+    currentGradient = arma::zeros<arma::mat>(parameter.n_rows,
+        parameter.n_cols);
+  }
+
+  ResetGradients(currentGradient);
+
+  const size_t steps = predictors.n_slices;
+  for (size_t start = 0; start < steps; start += rho)
+  {
+    const size_t end = std::min(start + rho, steps);
+    ResetWindow(start, steps);
+
+    // Forward the window and store the outputs of all modules; only the
+    // outputs of a single window are held at any time.
+    for (size_t seqNum = start; seqNum < end; ++seqNum)
+    {
+      Forward(std::move(arma::mat(predictors.slice(seqNum).colptr(begin),
+          predictors.n_rows, batchSize, false, true)));
+
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        boost::apply_visitor(SaveOutputParameterVisitor(
+            std::move(moduleOutputParameter)), network[l]);
+      }
+    }
+
+    // Backpropagate through the time steps of the window.
+    for (size_t seqNum = end; seqNum-- > start; )
+    {
+      currentGradient.zeros();
+
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        boost::apply_visitor(LoadOutputParameterVisitor(
+            std::move(moduleOutputParameter)), network[network.size() - 1 - l]);
+      }
+
+      if (single && seqNum < steps - 1)
+      {
+        error.zeros(boost::apply_visitor(outputParameterVisitor,
+            network.back()).n_rows, batchSize);
+      }
+      else
+      {
+        outputLayer.Backward(std::move(boost::apply_visitor(
+            outputParameterVisitor, network.back())),
+            std::move(arma::mat(responses.slice(seqNum).colptr(begin),
+                responses.n_rows, batchSize, false, true)),
+            std::move(error));
+      }
+
+      Backward();
+      Gradient(std::move(arma::mat(predictors.slice(seqNum).colptr(begin),
+          predictors.n_rows, batchSize, false, true)));
+      gradient += currentGradient;
+    }
+  }
+
+  if (outputSize == 0)
+  {
+    outputSize = boost::apply_visitor(outputParameterVisitor,
+        network.back()).n_elem / batchSize;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SequenceSupport() const
+{
+  // Gradient() never backpropagates through the first layer, and the output
+  // layer gets no gradient, so there is nothing to fuse for smaller networks.
+  if (network.size() < 2)
+    return false;
+
+  for (const LayerTypes<CustomLayers...>& layer : network)
+  {
+    if (!boost::apply_visitor(SequenceCheckVisitor(rho), layer))
+      return false;
+  }
+
+  return true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SequenceGradient(
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  if (parameter.is_empty())
+  {
+    ResetParameters();
+  }
+
+  if (deterministic)
+  {
+    deterministic = false;
+    ResetDeterministic();
+  }
+
+  if (!inputSize)
+  {
+    inputSize = predictors.n_rows;
+    targetSize = responses.n_rows;
+  }
+  else if (targetSize == 0)
+  {
+    targetSize = responses.n_rows;
+  }
+
+  // Put the time steps side by side; columns seqNum * batchSize to
+  // (seqNum + 1) * batchSize - 1 hold time step seqNum.
+  sequenceInput.set_size(predictors.n_rows, rho * batchSize);
+  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  {
+    sequenceInput.cols(seqNum * batchSize, (seqNum + 1) * batchSize - 1) =
+        predictors.slice(seqNum).cols(begin, begin + batchSize - 1);
+  }
+
+  // Forward the whole sequence layer by layer.
+  boost::apply_visitor(ForwardSequenceVisitor(std::move(sequenceInput),
+      std::move(boost::apply_visitor(outputParameterVisitor, network.front())),
+      batchSize), network.front());
+
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    boost::apply_visitor(ForwardSequenceVisitor(
+        std::move(boost::apply_visitor(outputParameterVisitor, network[i - 1])),
+        std::move(boost::apply_visitor(outputParameterVisitor, network[i])),
+        batchSize), network[i]);
+  }
+
+  arma::mat& sequenceOutput = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  if (outputSize == 0)
+  {
+    outputSize = sequenceOutput.n_rows;
+  }
+
+  // The output layer sees every time step on its own, as in the step-wise
+  // pass.
+  error.zeros(sequenceOutput.n_rows, sequenceOutput.n_cols);
+  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  {
+    if (single && seqNum < rho - 1)
+      continue;
+
+    outputLayer.Backward(std::move(arma::mat(sequenceOutput.colptr(seqNum *
+        batchSize), sequenceOutput.n_rows, batchSize, false, true)),
+        std::move(arma::mat(responses.slice(seqNum).colptr(begin),
+            responses.n_rows, batchSize, false, true)),
+        std::move(arma::mat(error.colptr(seqNum * batchSize), error.n_rows,
+            batchSize, false, true)));
+  }
+
+  // Backpropagate the whole sequence layer by layer.
+  boost::apply_visitor(BackwardSequenceVisitor(
+      std::move(sequenceOutput), std::move(error), std::move(
+      boost::apply_visitor(deltaVisitor, network.back()))), network.back());
+
+  for (size_t i = 2; i < network.size(); ++i)
+  {
+    boost::apply_visitor(BackwardSequenceVisitor(
+        std::move(boost::apply_visitor(outputParameterVisitor,
+        network[network.size() - i])), std::move(boost::apply_visitor(
+        deltaVisitor, network[network.size() - i + 1])), std::move(
+        boost::apply_visitor(deltaVisitor, network[network.size() - i]))),
+        network[network.size() - i]);
+  }
+
+  // Initialize current/working gradient.
+  if (currentGradient.is_empty())
+  {
+    currentGradient = arma::zeros<arma::mat>(parameter.n_rows,
+        parameter.n_cols);
+  }
+
+  ResetGradients(currentGradient);
+  currentGradient.zeros();
+
+  boost::apply_visitor(GradientSequenceVisitor(std::move(sequenceInput),
+      std::move(boost::apply_visitor(deltaVisitor, network[1]))),
+      network.front());
+
+  for (size_t i = 1; i < network.size() - 1; ++i)
+  {
+    boost::apply_visitor(GradientSequenceVisitor(
+        std::move(boost::apply_visitor(outputParameterVisitor, network[i - 1])),
+        std::move(boost::apply_visitor(deltaVisitor, network[i + 1]))),
+        network[i]);
+  }
+
+  gradient += currentGradient;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
@@ -0,0 +1,585 @@
+/**
+ * @file static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, a feed forward neural network whose
+ * layer types are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/gradient_set_visitor.hpp"
+#include "visitor/output_height_visitor.hpp"
+#include "visitor/output_width_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+#include "ffn.hpp"
+#include "layer/layer_traits.hpp"
+
+#include <mlpack/methods/ann/init_rules/random_init.hpp>
+#include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of a feed forward network with a fixed sequence of layers.
+ * In contrast to the FFN class, which holds its layers in a vector of
+ * boost::variant objects and dispatches every call at runtime, the layers of a
+ * StaticFFN are given as template parameters and stored by value in a tuple.
+ * Every forward, backward and gradient call is resolved at compile time, so
+ * the compiler can inline the layer functions and optimize across adjacent
+ * layers.  This avoids the per-layer dispatch overhead, which is noticeable
+ * for small networks serving many single-point requests.
+ *
+ * The network parameters are laid out exactly like the parameters of an FFN
+ * with the same layers, so a trained FFN (e.g. one loaded with data::Load())
+ * can be converted with Import(), and back with Export().  A double-precision
+ * StaticFFN is also serialized exactly like the FFN with the same layers, so
+ * a model saved by either class can be loaded by the other; its layers have
+ * to be types of the LayerTypes variant.
+ *
+ * The matrix type of the network (MatType) is the type of the output
+ * parameter of the output layer, so a network whose output layer and layers
+ * use arma::fmat stores its parameters, computes its passes and is trained
+ * and serialized in single precision (in its own layout, as there is no
+ * single-precision FFN):
+ *
+ * @code
+ * StaticFFN<MeanSquaredError<arma::fmat, arma::fmat>, RandomInitialization,
+ *     Linear<arma::fmat, arma::fmat>, SigmoidLayer<LogisticFunction,
+ *     arma::fmat, arma::fmat>, Linear<arma::fmat, arma::fmat> > model(
+ *     Linear<arma::fmat, arma::fmat>(10, 8), SigmoidLayer<LogisticFunction,
+ *     arma::fmat, arma::fmat>(), Linear<arma::fmat, arma::fmat>(8, 1));
+ * model.Train<optimization::StandardSGD>(predictors, responses);
+ * @endcode
+ *
+ * Single-precision networks can be trained with the optimizers that accept
+ * single-precision iterates (SGD with VanillaUpdate or MomentumUpdate, and
+ * Adam), and the initialization rule has to support the element type (like
+ * RandomInitialization does).  Layers that hold other layers (such as
+ * Sequential) and Import() are double precision only, like FFN.
+ *
+ * @code
+ * StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+ *     SigmoidLayer<>, Linear<>, LogSoftMax<> > model(Linear<>(10, 8),
+ *     SigmoidLayer<>(), Linear<>(8, 3), LogSoftMax<>());
+ * @endcode
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam Layers The types of the layers of the network, in order.
+ */
+template<
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename... Layers
+>
+class StaticFFN
+{
+  static_assert(sizeof...(Layers) >= 2,
+      "StaticFFN needs at least two layers.");
+
+ public:
+  //! The number of layers of the network.
+  static const size_t NumLayers = sizeof...(Layers);
+
+  //! Convenience typedef for the layer tuple.
+  using LayerTuple = std::tuple<Layers...>;
+
+  //! Convenience typedef for the type of the layer with the given index.
+  template<size_t I>
+  using LayerType = typename std::tuple_element<I, LayerTuple>::type;
+
+  //! The matrix type of the parameters and the data, given by the output
+  //! layer.
+  using MatType = typename std::remove_reference<decltype(
+      std::declval<OutputLayerType&>().OutputParameter())>::type;
+
+  /**
+   * Create the StaticFFN object with the given layers.  Optionally, specify
+   * which initialize rule and performance function should be used.
+   *
+   * @param layers The layers of the network.
+   */
+  StaticFFN(Layers... layers);
+
+  /**
+   * Create the StaticFFN object with the given output layer, initialization
+   * rule and layers.
+   *
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Instantiated InitializationRule object for
+   *        initializing the network parameter.
+   * @param layers The layers of the network.
+   */
+  StaticFFN(OutputLayerType outputLayer,
+            InitializationRuleType initializeRule,
+            Layers... layers);
+
+  //! Copy constructor.
+  StaticFFN(const StaticFFN& network);
+
+  //! Copy assignment operator.
+  StaticFFN& operator=(const StaticFFN& network);
+
+  /**
+   * Copy the layers and the parameters of the given FFN into this network.
+   * The FFN has to consist of exactly the layer types of this network, in the
+   * same order; otherwise a fatal error is raised.
+   *
+   * @param model The network to import.
+   */
+  template<typename... CustomLayers>
+  void Import(const FFN<OutputLayerType, InitializationRuleType,
+                        CustomLayers...>& model);
+
+  /**
+   * Copy the layers and the parameters of this network into the given FFN,
+   * replacing its layers.  This is the inverse of Import().
+   *
+   * @param model The network to export to.
+   */
+  template<typename... CustomLayers>
+  void Export(FFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>& model) const;
+
+  /**
+   * Train the network on the given input data using the given optimizer.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization. If this is not what you want, then you should access the
+   * parameters vector directly with Parameters() and modify it as desired.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   */
+  template<typename OptimizerType>
+  void Train(MatType predictors,
+             MatType responses,
+             OptimizerType& optimizer);
+
+  /**
+   * Train the network on the given input data. By default, the RMSProp
+   * optimization algorithm is used, but others can be specified (such as
+   * mlpack::optimization::SGD).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   */
+  template<typename OptimizerType = mlpack::optimization::RMSProp>
+  void Train(MatType predictors, MatType responses);
+
+  /**
+   * Predict the responses to a given set of predictors. The predictors are
+   * passed through the network in blocks of batchSize columns.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to be passed through the network at a
+   *        time.
+   */
+  void Predict(MatType predictors,
+               MatType& results,
+               const size_t batchSize = 1);
+
+  /**
+   * Evaluate the network with the given parameters. This function is usually
+   * called by the optimizer to train the model.
+   *
+   * @param parameters Matrix model parameters.
+   */
+  double Evaluate(const MatType& parameters);
+
+  /**
+   * Evaluate the network with the given parameters, but using only a batch of
+   * data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   * @param deterministic Whether or not to train or test the model. Note some
+   *        layer act differently in training or testing mode.
+   */
+  double Evaluate(const MatType& parameters,
+                  const size_t begin,
+                  const size_t batchSize,
+                  const bool deterministic);
+
+  /**
+   * Evaluate the network with the given parameters, but using only a batch of
+   * data points.  This just calls the overload of Evaluate() with
+   * deterministic = true.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  double Evaluate(const MatType& parameters,
+                  const size_t begin,
+                  const size_t batchSize)
+  {
+    return Evaluate(parameters, begin, batchSize, true);
+  }
+
+  /**
+   * Evaluate the gradient of the network with the given parameters, and with
+   * respect to only a batch of points in the dataset.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize);
+
+  /**
+   * Shuffle the order of function visitation. This may be called by the
+   * optimizer.
+   */
+  void Shuffle();
+
+  //! Return the number of separable functions (the number of predictor points).
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Return the initial point for the optimization.
+  const MatType& Parameters() const { return parameter; }
+  //! Modify the initial point for the optimization.
+  MatType& Parameters() { return parameter; }
+
+  //! Get the layer with the given index.
+  template<size_t I>
+  const LayerType<I>& Layer() const { return std::get<I>(network); }
+  //! Modify the layer with the given index.
+  template<size_t I>
+  LayerType<I>& Layer() { return std::get<I>(network); }
+
+  /**
+   * Reset the module infomration (weights/parameters).
+   */
+  void ResetParameters();
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+  /**
+   * Perform the forward pass of the data in real batch mode.
+   *
+   * @param inputs The input data.
+   * @param results The predicted results.
+   */
+  void Forward(MatType inputs, MatType& results);
+
+  /**
+   * Perform the backward pass of the data in real batch mode.
+   *
+   * @param targets The training target.
+   * @param gradients Computed gradients.
+   * @return Training error of the current pass.
+   */
+  double Backward(MatType targets, MatType& gradients);
+
+ private:
+  //! Tag type used to iterate over the layers at compile time.
+  template<size_t I>
+  using LayerIndex = std::integral_constant<size_t, I>;
+
+  /**
+   * Prepare the network for the given data.
+   *
+   * @param predictors Input data variables.
+   * @param responses Outputs results from input data variables.
+   */
+  void ResetData(MatType predictors, MatType responses);
+
+  /**
+   * Run the forward pass of the given input through all layers.
+   *
+   * @param input The input data.
+   */
+  void Forward(MatType&& input);
+
+  //! Run the forward pass of the layer with the given index and of all
+  //! following layers.
+  template<size_t I>
+  void ForwardLayer(LayerIndex<I>);
+
+  //! End of the forward pass.
+  void ForwardLayer(LayerIndex<NumLayers>) { }
+
+  //! Store the output size of the given layer as the input size of the next
+  //! layer, until the network is reset.
+  template<size_t I>
+  void UpdateSize(LayerIndex<I>);
+
+  /**
+   * Run the backward pass through all layers, using the error of the output
+   * layer.
+   */
+  void Backward();
+
+  //! Run the backward pass of the layer with the given index and of all
+  //! preceding layers but the first one.
+  template<size_t I>
+  void BackwardLayer(LayerIndex<I>);
+
+  //! The first layer doesn't need a backward pass.
+  void BackwardLayer(LayerIndex<0>) { }
+
+  /**
+   * Compute the gradient of all layers with the given input.
+   *
+   * @param input The input data.
+   */
+  void Gradient(MatType&& input);
+
+  //! Compute the gradient of the layer with the given index and of all
+  //! following layers but the last one.
+  template<size_t I>
+  void GradientLayer(LayerIndex<I>);
+
+  //! The gradient of the last layer depends on the error.
+  void GradientLayer(LayerIndex<NumLayers - 1>) { }
+
+  //! Return the number of weights of the layer with the given index and all
+  //! following layers.
+  template<size_t I>
+  size_t WeightSize(LayerIndex<I>);
+
+  //! End of the weight size computation.
+  size_t WeightSize(LayerIndex<NumLayers>) { return 0; }
+
+  //! Initialize the weights of the layer with the given index and of all
+  //! following layers one layer at a time.
+  template<size_t I>
+  void InitializeLayer(LayerIndex<I>, const size_t offset);
+
+  //! End of the layer-wise initialization.
+  void InitializeLayer(LayerIndex<NumLayers>, const size_t /* offset */) { }
+
+  //! Let all layers use the current network parameters.
+  void UseParameters();
+
+  //! Let the layer with the given index and all following layers use the
+  //! network parameters, starting at the given offset.
+  template<size_t I>
+  void SetWeights(LayerIndex<I>, const size_t offset);
+
+  //! End of the weight assignment.
+  void SetWeights(LayerIndex<NumLayers>, const size_t /* offset */) { }
+
+  //! Let the layer with the given index and all following layers write their
+  //! gradients into the given matrix, starting at the given offset.
+  template<size_t I>
+  void ResetGradients(LayerIndex<I>, MatType& gradient, const size_t offset);
+
+  //! End of the gradient assignment.
+  void ResetGradients(LayerIndex<NumLayers>,
+                      MatType& /* gradient */,
+                      const size_t /* offset */) { }
+
+  //! Let a layer with weights use the network parameters at the given offset,
+  //! and return the number of its weights.
+  template<typename T>
+  typename std::enable_if<
+      HasParametersCheck<T, MatType&(T::*)()>::value &&
+      !HasModelCheck<T>::value, size_t>::type
+  LayerWeights(T& layer, const size_t offset)
+  {
+    layer.Parameters() = MatType(parameter.memptr() + offset,
+        layer.Parameters().n_rows, layer.Parameters().n_cols, false, false);
+    return layer.Parameters().n_elem;
+  }
+
+  //! A layer without weights uses no parameters.
+  template<typename T>
+  typename std::enable_if<
+      !HasParametersCheck<T, MatType&(T::*)()>::value &&
+      !HasModelCheck<T>::value, size_t>::type
+  LayerWeights(T& /* layer */, const size_t /* offset */) { return 0; }
+
+  //! The weights of the layers held by a layer are set by the FFN visitor.
+  template<typename T>
+  typename std::enable_if<HasModelCheck<T>::value, size_t>::type
+  LayerWeights(T& layer, const size_t offset)
+  {
+    return WeightSetVisitor(std::move(parameter), offset)(&layer);
+  }
+
+  //! Let a layer with weights write its gradient into the given matrix at the
+  //! given offset, and return the number of its weights.
+  template<typename T>
+  typename std::enable_if<
+      HasGradientCheck<T, MatType&(T::*)()>::value &&
+      !HasModelCheck<T>::value, size_t>::type
+  LayerGradients(T& layer, MatType& gradient, const size_t offset)
+  {
+    layer.Gradient() = MatType(gradient.memptr() + offset,
+        layer.Parameters().n_rows, layer.Parameters().n_cols, false, false);
+    return layer.Parameters().n_elem;
+  }
+
+  //! A layer without weights has no gradient.
+  template<typename T>
+  typename std::enable_if<
+      !HasGradientCheck<T, MatType&(T::*)()>::value &&
+      !HasModelCheck<T>::value, size_t>::type
+  LayerGradients(T& /* layer */,
+                 MatType& /* gradient */,
+                 const size_t /* offset */) { return 0; }
+
+  //! The gradients of the layers held by a layer are set by the FFN visitor.
+  template<typename T>
+  typename std::enable_if<HasModelCheck<T>::value, size_t>::type
+  LayerGradients(T& layer, MatType& gradient, const size_t offset)
+  {
+    return GradientSetVisitor(std::move(gradient), offset)(&layer);
+  }
+
+  //! Compute the gradient of a layer with weights.
+  template<typename T>
+  typename std::enable_if<
+      HasGradientCheck<T, MatType&(T::*)()>::value, void>::type
+  LayerGradient(T& layer, MatType&& input, MatType&& delta)
+  {
+    layer.Gradient(std::move(input), std::move(delta),
+        std::move(layer.Gradient()));
+  }
+
+  //! A layer without weights has no gradient to compute.
+  template<typename T>
+  typename std::enable_if<
+      !HasGradientCheck<T, MatType&(T::*)()>::value, void>::type
+  LayerGradient(T& /* layer */,
+                MatType&& /* input */,
+                MatType&& /* delta */) { }
+
+  /**
+   * Reset the module status by setting the current deterministic parameter
+   * for all modules that implement the Deterministic function.
+   */
+  void ResetDeterministic() { SetDeterministic(LayerIndex<0>()); }
+
+  //! Set the current deterministic parameter for the layer with the given
+  //! index and all following layers.
+  template<size_t I>
+  void SetDeterministic(LayerIndex<I>);
+
+  //! End of the deterministic assignment.
+  void SetDeterministic(LayerIndex<NumLayers>) { }
+
+  //! Copy the layer with the given index and all following layers out of the
+  //! given FFN.
+  template<size_t I, typename NetworkType>
+  void ImportLayer(LayerIndex<I>, const NetworkType& model);
+
+  //! End of the import.
+  template<typename NetworkType>
+  void ImportLayer(LayerIndex<NumLayers>, const NetworkType& /* model */) { }
+
+  //! Add a copy of the layer with the given index and of all following
+  //! layers to the given FFN.
+  template<size_t I, typename NetworkType>
+  void ExportLayer(LayerIndex<I>, NetworkType& model) const;
+
+  //! End of the export.
+  template<typename NetworkType>
+  void ExportLayer(LayerIndex<NumLayers>, NetworkType& /* model */) const { }
+
+  //! Serialize a double-precision network as the FFN with the same layers.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int version, std::true_type);
+
+  //! Serialize a single-precision network with its parameters and layers.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int version, std::false_type);
+
+  //! Serialize the layer with the given index and all following layers.
+  template<size_t I, typename Archive>
+  void SerializeLayer(LayerIndex<I>, Archive& ar);
+
+  //! End of the layer serialization.
+  template<typename Archive>
+  void SerializeLayer(LayerIndex<NumLayers>, Archive& /* ar */) { }
+
+  //! Instantiated outputlayer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! The layers of the network.
+  LayerTuple network;
+
+  //! The input width.
+  size_t width;
+
+  //! The input height.
+  size_t height;
+
+  //! Indicator if we already trained the model.
+  bool reset;
+
+  //! The matrix of data points (predictors).
+  MatType predictors;
+
+  //! The matrix of responses to the input data points.
+  MatType responses;
+
+  //! Matrix of (trained) parameters.
+  MatType parameter;
+
+  //! The number of separable functions (the number of predictor points).
+  size_t numFunctions;
+
+  //! The current error for the backward pass.
+  MatType error;
+
+  //! THe current input of the forward/backward pass.
+  MatType currentInput;
+
+  //! Locally-stored weight size visitor.
+  WeightSizeVisitor weightSizeVisitor;
+
+  //! Locally-stored output width visitor.
+  OutputWidthVisitor outputWidthVisitor;
+
+  //! Locally-stored output height visitor.
+  OutputHeightVisitor outputHeightVisitor;
+
+  //! Locally-stored reset visitor.
+  ResetVisitor resetVisitor;
+
+  //! The current evaluation mode (training or testing).
+  bool deterministic;
+}; // class StaticFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
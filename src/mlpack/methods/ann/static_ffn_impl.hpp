@@ -0,0 +1,647 @@
+/**
+ * @file static_ffn_impl.hpp
+ *
+ * Definition of the StaticFFN class, a feed forward neural network whose
+ * layer types are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+
+#include "init_rules/init_rules_traits.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+// The layer functions are called directly on the concrete layer types, and
+// the visitors of the FFN class that do not depend on the matrix type are
+// applied directly too, instead of being dispatched through
+// boost::apply_visitor(), so every call is resolved at compile time.
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+const size_t StaticFFN<OutputLayerType, InitializationRuleType,
+                       Layers...>::NumLayers;
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    Layers... layers) :
+    network(std::move(layers)...),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    OutputLayerType outputLayer,
+    InitializationRuleType initializeRule,
+    Layers... layers) :
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    network(std::move(layers)...),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    const StaticFFN& network) :
+    outputLayer(network.outputLayer),
+    initializeRule(network.initializeRule),
+    network(network.network),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    predictors(network.predictors),
+    responses(network.responses),
+    parameter(network.parameter),
+    numFunctions(network.numFunctions),
+    deterministic(network.deterministic)
+{
+  // The copied layers have to use the parameters of this network.
+  if (!parameter.is_empty())
+    UseParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>&
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::operator=(
+    const StaticFFN& network)
+{
+  if (this != &network)
+  {
+    outputLayer = network.outputLayer;
+    initializeRule = network.initializeRule;
+    this->network = network.network;
+    width = network.width;
+    height = network.height;
+    reset = network.reset;
+    predictors = network.predictors;
+    responses = network.responses;
+    parameter = network.parameter;
+    numFunctions = network.numFunctions;
+    deterministic = network.deterministic;
+
+    // The copied layers have to use the parameters of this network.
+    if (!parameter.is_empty())
+      UseParameters();
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename... CustomLayers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Import(
+    const FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& model)
+{
+  if (model.Model().size() != NumLayers)
+  {
+    Log::Fatal << "StaticFFN::Import(): the given network has "
+        << model.Model().size() << " layers, but " << NumLayers
+        << " layers are expected!" << std::endl;
+  }
+
+  ImportLayer(LayerIndex<0>(), model);
+
+  // The copied layers still refer to the weights of the given network.
+  parameter = model.Parameters();
+  UseParameters();
+
+  reset = false;
+  deterministic = true;
+  ResetDeterministic();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename... CustomLayers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Export(
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& model) const
+{
+  model = FFN<OutputLayerType, InitializationRuleType, CustomLayers...>(
+      outputLayer, initializeRule);
+  ExportLayer(LayerIndex<0>(), model);
+
+  // Let the copied layers use the parameters of the given network, and then
+  // fill them in; the size is the same, so the memory is kept.
+  if (!parameter.is_empty())
+  {
+    model.ResetParameters();
+    model.Parameters() = parameter;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ResetData(
+    MatType predictors, MatType responses)
+{
+  numFunctions = responses.n_cols;
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (!reset)
+    ResetParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+      MatType predictors,
+      MatType responses,
+      OptimizerType& optimizer)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "StaticFFN::StaticFFN(): final objective of trained model is "
+      << out << "." << std::endl;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+    MatType predictors, MatType responses)
+{
+  OptimizerType optimizer;
+  Train(std::move(predictors), std::move(responses), optimizer);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Forward(
+    MatType inputs, MatType& results)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  currentInput = std::move(inputs);
+  Forward(std::move(currentInput));
+  results = std::get<NumLayers - 1>(network).OutputParameter();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Backward(
+    MatType targets, MatType& gradients)
+{
+  MatType& output = std::get<NumLayers - 1>(network).OutputParameter();
+  double res = outputLayer.Forward(std::move(output), std::move(targets));
+  outputLayer.Backward(std::move(output), std::move(targets),
+      std::move(error));
+
+  gradients = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
+
+  Backward();
+  ResetGradients(LayerIndex<0>(), gradients, 0);
+  Gradient(std::move(currentInput));
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Predict(
+    MatType predictors, MatType& results, const size_t batchSize)
+{
+  if (batchSize == 0)
+  {
+    Log::Fatal << "StaticFFN::Predict(): batch size must be greater than "
+        << "zero!" << std::endl;
+  }
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  for (size_t i = 0; i < predictors.n_cols; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - i));
+
+    Forward(std::move(MatType(predictors.colptr(i), predictors.n_rows,
+        effectiveBatchSize, false, true)));
+
+    const MatType& output =
+        std::get<NumLayers - 1>(network).OutputParameter();
+
+    // Now we know the size of the network output.
+    if (i == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    results.cols(i, i + effectiveBatchSize - 1) = output;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& parameters)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += Evaluate(parameters, i, 1, true);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& /* parameters */,
+    const size_t begin,
+    const size_t batchSize,
+    const bool deterministic)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (deterministic != this->deterministic)
+  {
+    this->deterministic = deterministic;
+    ResetDeterministic();
+  }
+
+  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  double res = outputLayer.Forward(std::move(std::get<NumLayers - 1>(
+      network).OutputParameter()), std::move(responses.cols(begin,
+      begin + batchSize - 1)));
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    const MatType& parameters,
+    const size_t begin,
+    MatType& gradient,
+    const size_t batchSize)
+{
+  if (gradient.is_empty())
+  {
+    if (parameter.is_empty())
+      ResetParameters();
+
+    gradient = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
+  }
+  else
+  {
+    gradient.zeros();
+  }
+
+  Evaluate(parameters, begin, batchSize, false);
+
+  outputLayer.Backward(std::move(std::get<NumLayers - 1>(
+      network).OutputParameter()), std::move(responses.cols(begin,
+      begin + batchSize - 1)), std::move(error));
+
+  Backward();
+  ResetGradients(LayerIndex<0>(), gradient, 0);
+  Gradient(std::move(predictors.cols(begin, begin + batchSize - 1)));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Shuffle()
+{
+  math::ShuffleData(predictors, responses, predictors, responses);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetParameters()
+{
+  ResetDeterministic();
+
+  // Reset the network parameter with the given initialization rule, either
+  // layer by layer or for the complete network (see NetworkInitialization).
+  parameter.set_size(WeightSize(LayerIndex<0>()), 1);
+  if (InitTraits<InitializationRuleType>::UseLayer)
+    InitializeLayer(LayerIndex<0>(), 0);
+  else
+    initializeRule.Initialize(parameter, parameter.n_elem, 1);
+
+  SetWeights(LayerIndex<0>(), 0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Forward(
+    MatType&& input)
+{
+  auto& layer = std::get<0>(network);
+  layer.Forward(std::move(input), std::move(layer.OutputParameter()));
+
+  UpdateSize(LayerIndex<0>());
+  ForwardLayer(LayerIndex<1>());
+
+  if (!reset)
+    reset = true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ForwardLayer(LayerIndex<I>)
+{
+  auto& layer = std::get<I>(network);
+  if (!reset)
+  {
+    // Set the input width and height.
+    SetInputWidthVisitor setInputWidthVisitor(width);
+    setInputWidthVisitor(&layer);
+
+    SetInputHeightVisitor setInputHeightVisitor(height);
+    setInputHeightVisitor(&layer);
+  }
+
+  layer.Forward(std::move(std::get<I - 1>(network).OutputParameter()),
+      std::move(layer.OutputParameter()));
+
+  UpdateSize(LayerIndex<I>());
+  ForwardLayer(LayerIndex<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::UpdateSize(LayerIndex<I>)
+{
+  if (reset)
+    return;
+
+  auto& layer = std::get<I>(network);
+  if (outputWidthVisitor(&layer) != 0)
+    width = outputWidthVisitor(&layer);
+
+  if (outputHeightVisitor(&layer) != 0)
+    height = outputHeightVisitor(&layer);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Backward()
+{
+  auto& layer = std::get<NumLayers - 1>(network);
+  layer.Backward(std::move(layer.OutputParameter()), std::move(error),
+      std::move(layer.Delta()));
+
+  BackwardLayer(LayerIndex<NumLayers - 2>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::BackwardLayer(LayerIndex<I>)
+{
+  auto& layer = std::get<I>(network);
+  layer.Backward(std::move(layer.OutputParameter()), std::move(
+      std::get<I + 1>(network).Delta()), std::move(layer.Delta()));
+
+  BackwardLayer(LayerIndex<I - 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    MatType&& input)
+{
+  LayerGradient(std::get<0>(network), std::move(input),
+      std::move(std::get<1>(network).Delta()));
+
+  GradientLayer(LayerIndex<1>());
+
+  LayerGradient(std::get<NumLayers - 1>(network), std::move(
+      std::get<NumLayers - 2>(network).OutputParameter()), std::move(error));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::GradientLayer(LayerIndex<I>)
+{
+  LayerGradient(std::get<I>(network), std::move(std::get<I - 1>(
+      network).OutputParameter()), std::move(std::get<I + 1>(
+      network).Delta()));
+
+  GradientLayer(LayerIndex<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+size_t StaticFFN<OutputLayerType, InitializationRuleType,
+                 Layers...>::WeightSize(LayerIndex<I>)
+{
+  return weightSizeVisitor(&std::get<I>(network)) +
+      WeightSize(LayerIndex<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::InitializeLayer(LayerIndex<I>, const size_t offset)
+{
+  const size_t weight = weightSizeVisitor(&std::get<I>(network));
+  MatType tmp = MatType(parameter.memptr() + offset, weight, 1, false,
+      false);
+  initializeRule.Initialize(tmp, tmp.n_elem, 1);
+
+  InitializeLayer(LayerIndex<I + 1>(), offset + weight);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::UseParameters()
+{
+  // Some layers (e.g. BatchNorm) initialize their weights in Reset(), which
+  // would overwrite the given parameters; so restore them afterwards.
+  const MatType parameterBackup = parameter;
+  SetWeights(LayerIndex<0>(), 0);
+  parameter = parameterBackup;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::SetWeights(LayerIndex<I>, const size_t offset)
+{
+  auto& layer = std::get<I>(network);
+  const size_t weight = LayerWeights(layer, offset);
+  resetVisitor(&layer);
+
+  SetWeights(LayerIndex<I + 1>(), offset + weight);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetGradients(LayerIndex<I>,
+                                          MatType& gradient,
+                                          const size_t offset)
+{
+  const size_t weight = LayerGradients(std::get<I>(network), gradient,
+      offset);
+
+  ResetGradients(LayerIndex<I + 1>(), gradient, offset + weight);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::SetDeterministic(LayerIndex<I>)
+{
+  DeterministicSetVisitor deterministicSetVisitor(deterministic);
+  deterministicSetVisitor(&std::get<I>(network));
+  SetDeterministic(LayerIndex<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I, typename NetworkType>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ImportLayer(LayerIndex<I>, const NetworkType& model)
+{
+  LayerType<I>* const* layer = boost::get<LayerType<I>*>(&model.Model()[I]);
+  if (layer == NULL)
+  {
+    Log::Fatal << "StaticFFN::Import(): layer " << I << " of the given "
+        << "network has the wrong type!" << std::endl;
+  }
+
+  std::get<I>(network) = **layer;
+  ImportLayer(LayerIndex<I + 1>(), model);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I, typename NetworkType>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ExportLayer(LayerIndex<I>, NetworkType& model) const
+{
+  model.Add(new LayerType<I>(std::get<I>(network)));
+  ExportLayer(LayerIndex<I + 1>(), model);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I, typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::SerializeLayer(LayerIndex<I>, Archive& ar)
+{
+  ar & boost::serialization::make_nvp("layer", std::get<I>(network));
+  SerializeLayer(LayerIndex<I + 1>(), ar);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::serialize(
+    Archive& ar, const unsigned int version)
+{
+  Serialize(ar, version, std::is_same<MatType, arma::mat>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Serialize(
+    Archive& ar, const unsigned int version, std::true_type)
+{
+  // Write and read exactly what the FFN with the same layers does.
+  FFN<OutputLayerType, InitializationRuleType> model(outputLayer,
+      initializeRule);
+  if (Archive::is_saving::value)
+    Export(model);
+
+  model.serialize(ar, version);
+
+  if (Archive::is_loading::value)
+    Import(model);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Serialize(
+    Archive& ar, const unsigned int /* version */, std::false_type)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameter);
+  ar & BOOST_SERIALIZATION_NVP(width);
+  ar & BOOST_SERIALIZATION_NVP(height);
+  ar & BOOST_SERIALIZATION_NVP(currentInput);
+
+  SerializeLayer(LayerIndex<0>(), ar);
+
+  // If we are loading, we need to initialize the weights.
+  if (Archive::is_loading::value)
+  {
+    reset = false;
+    UseParameters();
+
+    deterministic = true;
+    ResetDeterministic();
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file backward_sequence_visitor.hpp
+ *
+ * This file provides an abstraction for the BackwardSequence() function for
+ * different layers and automatically directs any parameter to the right layer
+ * type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_BACKWARD_SEQUENCE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_BACKWARD_SEQUENCE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * BackwardSequenceVisitor runs the backward pass over all time steps of the
+ * sequence that was passed to the ForwardSequenceVisitor before.  The
+ * BackwardSequence() function is used if the module implements it; otherwise
+ * the Backward() function is called with all time steps as one batch.
+ */
+class BackwardSequenceVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Execute the BackwardSequence() function given the input, error and delta
+  //! parameter.
+  BackwardSequenceVisitor(arma::mat&& input,
+                          arma::mat&& error,
+                          arma::mat&& delta);
+
+  //! Execute the BackwardSequence() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! The input parameter set.
+  arma::mat&& input;
+
+  //! The error parameter.
+  arma::mat&& error;
+
+  //! The delta parameter.
+  arma::mat&& delta;
+
+  //! Execute the BackwardSequence() function if the module implements the
+  //! ForwardSequence() function.
+  template<typename T>
+  typename std::enable_if<
+      HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+          arma::mat&)>::value, void>::type
+  LayerBackward(T* layer) const;
+
+  //! Execute the Backward() function if the module doesn't implement the
+  //! ForwardSequence() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+          arma::mat&)>::value, void>::type
+  LayerBackward(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "backward_sequence_visitor_impl.hpp"
+
+#endif
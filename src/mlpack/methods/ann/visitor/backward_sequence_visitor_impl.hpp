@@ -0,0 +1,58 @@
+/**
+ * @file backward_sequence_visitor_impl.hpp
+ *
+ * Implementation of the BackwardSequence() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_BACKWARD_SEQUENCE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_BACKWARD_SEQUENCE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "backward_sequence_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! BackwardSequenceVisitor visitor class.
+inline BackwardSequenceVisitor::BackwardSequenceVisitor(arma::mat&& input,
+                                                        arma::mat&& error,
+                                                        arma::mat&& delta) :
+  input(std::move(input)),
+  error(std::move(error)),
+  delta(std::move(delta))
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void BackwardSequenceVisitor::operator()(LayerType* layer) const
+{
+  LayerBackward(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+        arma::mat&)>::value, void>::type
+BackwardSequenceVisitor::LayerBackward(T* layer) const
+{
+  layer->BackwardSequence(error, delta);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+        arma::mat&)>::value, void>::type
+BackwardSequenceVisitor::LayerBackward(T* layer) const
+{
+  layer->Backward(std::move(input), std::move(error), std::move(delta));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file forward_sequence_visitor.hpp
+ *
+ * This file provides an abstraction for the ForwardSequence() function for
+ * different layers and automatically directs any parameter to the right layer
+ * type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_FORWARD_SEQUENCE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_FORWARD_SEQUENCE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * ForwardSequenceVisitor runs the forward pass over all time steps of a
+ * sequence at once.  The ForwardSequence() function is used if the module
+ * implements it; otherwise the Forward() function is called with all time
+ * steps as one batch.  The columns of the input and output are ordered by time
+ * step.
+ */
+class ForwardSequenceVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Execute the ForwardSequence() function given the input, output and
+  //! batch size.
+  ForwardSequenceVisitor(arma::mat&& input,
+                         arma::mat&& output,
+                         const size_t batchSize);
+
+  //! Execute the ForwardSequence() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! The input parameter set.
+  arma::mat&& input;
+
+  //! The output parameter set.
+  arma::mat&& output;
+
+  //! The number of sequences that are processed in parallel.
+  size_t batchSize;
+
+  //! Execute the ForwardSequence() function if the module implements it.
+  template<typename T>
+  typename std::enable_if<
+      HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+          arma::mat&)>::value, void>::type
+  LayerForward(T* layer) const;
+
+  //! Execute the Forward() function if the module doesn't implement the
+  //! ForwardSequence() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+          arma::mat&)>::value, void>::type
+  LayerForward(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "forward_sequence_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file forward_sequence_visitor_impl.hpp
+ *
+ * Implementation of the ForwardSequence() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_FORWARD_SEQUENCE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_FORWARD_SEQUENCE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "forward_sequence_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! ForwardSequenceVisitor visitor class.
+inline ForwardSequenceVisitor::ForwardSequenceVisitor(arma::mat&& input,
+                                                      arma::mat&& output,
+                                                      const size_t batchSize) :
+    input(std::move(input)),
+    output(std::move(output)),
+    batchSize(batchSize)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void ForwardSequenceVisitor::operator()(LayerType* layer) const
+{
+  LayerForward(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+        arma::mat&)>::value, void>::type
+ForwardSequenceVisitor::LayerForward(T* layer) const
+{
+  layer->ForwardSequence(input, batchSize, output);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+        arma::mat&)>::value, void>::type
+ForwardSequenceVisitor::LayerForward(T* layer) const
+{
+  layer->Forward(std::move(input), std::move(output));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
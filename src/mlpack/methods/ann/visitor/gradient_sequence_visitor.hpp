@@ -0,0 +1,74 @@
+/**
+ * @file gradient_sequence_visitor.hpp
+ *
+ * This file provides an abstraction for the GradientSequence() function for
+ * different layers and automatically directs any parameter to the right layer
+ * type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_GRADIENT_SEQUENCE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_GRADIENT_SEQUENCE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include "gradient_visitor.hpp"
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * GradientSequenceVisitor calculates the gradient of all time steps of the
+ * sequence that was passed to the ForwardSequenceVisitor and
+ * BackwardSequenceVisitor before.  The GradientSequence() function is used if
+ * the module implements it; otherwise the Gradient() function is called with
+ * all time steps as one batch, which sums up the gradient of every step.
+ */
+class GradientSequenceVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Executes the GradientSequence() method of the given module using the
+  //! input and delta parameter.
+  GradientSequenceVisitor(arma::mat&& input, arma::mat&& delta);
+
+  //! Executes the GradientSequence() method.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! The input set.
+  arma::mat&& input;
+
+  //! The delta parameter.
+  arma::mat&& delta;
+
+  //! Execute the GradientSequence() function if the module implements the
+  //! ForwardSequence() function.
+  template<typename T>
+  typename std::enable_if<
+      HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+          arma::mat&)>::value, void>::type
+  LayerGradients(T* layer) const;
+
+  //! Execute the Gradient() function (if any) if the module doesn't implement
+  //! the ForwardSequence() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+          arma::mat&)>::value, void>::type
+  LayerGradients(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "gradient_sequence_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,56 @@
+/**
+ * @file gradient_sequence_visitor_impl.hpp
+ *
+ * Implementation of the GradientSequence() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_GRADIENT_SEQUENCE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_GRADIENT_SEQUENCE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_sequence_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! GradientSequenceVisitor visitor class.
+inline GradientSequenceVisitor::GradientSequenceVisitor(arma::mat&& input,
+                                                        arma::mat&& delta) :
+    input(std::move(input)),
+    delta(std::move(delta))
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void GradientSequenceVisitor::operator()(LayerType* layer) const
+{
+  LayerGradients(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+        arma::mat&)>::value, void>::type
+GradientSequenceVisitor::LayerGradients(T* layer) const
+{
+  layer->GradientSequence(input, layer->Gradient());
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+        arma::mat&)>::value, void>::type
+GradientSequenceVisitor::LayerGradients(T* layer) const
+{
+  GradientVisitor(std::move(input), std::move(delta))(layer);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
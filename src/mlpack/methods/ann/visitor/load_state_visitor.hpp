@@ -0,0 +1,72 @@
+/**
+ * @file load_state_visitor.hpp
+ *
+ * Boost static visitor abstraction for calling the LoadState() function on RNN
+ * cells.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LOAD_STATE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LOAD_STATE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * LoadStateVisitor restores the recurrent state of a module from the rows of
+ * the given matrix that start at the given offset, in the layout written by
+ * SaveStateVisitor, and advances the offset past them.  The next time step of
+ * the module continues from that state.
+ */
+class LoadStateVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Load the states from the given matrix, starting at the given row.
+  LoadStateVisitor(const arma::mat& state, size_t& offset);
+
+  //! Execute the LoadState() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! The matrix holding the states.
+  const arma::mat& state;
+
+  //! The first row of the state of the next module.
+  size_t& offset;
+
+  //! Load the state of a module which implements the LoadState() function.
+  template<typename T>
+  typename std::enable_if<
+      HasLoadStateCheck<T, void(T::*)(const arma::mat&)>::value, void>::type
+  LoadState(T* layer) const;
+
+  //! Visit the modules of a container module without a state of its own.
+  template<typename T>
+  typename std::enable_if<
+      !HasLoadStateCheck<T, void(T::*)(const arma::mat&)>::value &&
+      HasModelCheck<T>::value, void>::type
+  LoadState(T* layer) const;
+
+  //! Do nothing for a module without a state.
+  template<typename T>
+  typename std::enable_if<
+      !HasLoadStateCheck<T, void(T::*)(const arma::mat&)>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LoadState(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "load_state_visitor_impl.hpp"
+
+#endif
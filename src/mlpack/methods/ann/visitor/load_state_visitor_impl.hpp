@@ -0,0 +1,74 @@
+/**
+ * @file load_state_visitor_impl.hpp
+ *
+ * Implementation of the LoadState() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LOAD_STATE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LOAD_STATE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_state_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! LoadStateVisitor visitor class.
+inline LoadStateVisitor::LoadStateVisitor(const arma::mat& state,
+                                          size_t& offset) :
+    state(state),
+    offset(offset)
+{
+  /* Nothing to do here. */
+}
+
+//! LoadStateVisitor visitor class.
+template<typename LayerType>
+inline void LoadStateVisitor::operator()(LayerType* layer) const
+{
+  LoadState(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasLoadStateCheck<T, void(T::*)(const arma::mat&)>::value, void>::type
+LoadStateVisitor::LoadState(T* layer) const
+{
+  const size_t rows = layer->StateSize();
+  if (offset + rows > state.n_rows)
+  {
+    Log::Fatal << "LoadStateVisitor: the state has " << state.n_rows
+        << " rows, but the network needs more!" << std::endl;
+  }
+
+  layer->LoadState(state.rows(offset, offset + rows - 1));
+  offset += rows;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasLoadStateCheck<T, void(T::*)(const arma::mat&)>::value &&
+    HasModelCheck<T>::value, void>::type
+LoadStateVisitor::LoadState(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+    boost::apply_visitor(LoadStateVisitor(state, offset), layer->Model()[i]);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasLoadStateCheck<T, void(T::*)(const arma::mat&)>::value &&
+    !HasModelCheck<T>::value, void>::type
+LoadStateVisitor::LoadState(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
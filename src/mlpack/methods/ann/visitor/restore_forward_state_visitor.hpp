@@ -0,0 +1,75 @@
+/**
+ * @file restore_forward_state_visitor.hpp
+ *
+ * Boost static visitor abstraction for restoring the state of the forward pass
+ * of a module.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_RESTORE_FORWARD_STATE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_RESTORE_FORWARD_STATE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * RestoreForwardStateVisitor restores the states saved by
+ * SaveForwardStateVisitor, so that the next forward pass of a module in
+ * training mode recomputes the saved pass without changing the state of the
+ * module again.  The modules must be visited in the order they were saved.
+ */
+class RestoreForwardStateVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Restore the states of the given vector, starting at the given position;
+  //! the position is advanced past every restored state.
+  RestoreForwardStateVisitor(const std::vector<arma::mat>& states,
+                             size_t& position);
+
+  //! Execute the RestoreForwardState() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! The saved states.
+  const std::vector<arma::mat>& states;
+
+  //! The position of the next state to restore.
+  size_t& position;
+
+  //! Restore the state of a module which implements RestoreForwardState().
+  template<typename T>
+  typename std::enable_if<
+      HasRestoreForwardStateCheck<T, void(T::*)(const arma::mat&)>::value,
+      void>::type
+  LayerRestoreForwardState(T* layer) const;
+
+  //! Visit the modules of a container module.
+  template<typename T>
+  typename std::enable_if<
+      !HasRestoreForwardStateCheck<T, void(T::*)(const arma::mat&)>::value &&
+      HasModelCheck<T>::value, void>::type
+  LayerRestoreForwardState(T* layer) const;
+
+  //! Do nothing for a module without forward state.
+  template<typename T>
+  typename std::enable_if<
+      !HasRestoreForwardStateCheck<T, void(T::*)(const arma::mat&)>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerRestoreForwardState(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "restore_forward_state_visitor_impl.hpp"
+
+#endif
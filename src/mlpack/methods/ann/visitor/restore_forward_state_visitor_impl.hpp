@@ -0,0 +1,71 @@
+/**
+ * @file restore_forward_state_visitor_impl.hpp
+ *
+ * Implementation of the RestoreForwardState() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_RESTORE_FORWARD_STATE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_RESTORE_FORWARD_STATE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "restore_forward_state_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! RestoreForwardStateVisitor visitor class.
+inline RestoreForwardStateVisitor::RestoreForwardStateVisitor(
+    const std::vector<arma::mat>& states,
+    size_t& position) :
+    states(states),
+    position(position)
+{
+  /* Nothing to do here. */
+}
+
+//! RestoreForwardStateVisitor visitor class.
+template<typename LayerType>
+inline void RestoreForwardStateVisitor::operator()(LayerType* layer) const
+{
+  LayerRestoreForwardState(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasRestoreForwardStateCheck<T, void(T::*)(const arma::mat&)>::value,
+    void>::type
+RestoreForwardStateVisitor::LayerRestoreForwardState(T* layer) const
+{
+  layer->RestoreForwardState(states[position++]);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasRestoreForwardStateCheck<T, void(T::*)(const arma::mat&)>::value &&
+    HasModelCheck<T>::value, void>::type
+RestoreForwardStateVisitor::LayerRestoreForwardState(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+  {
+    boost::apply_visitor(RestoreForwardStateVisitor(states, position),
+        layer->Model()[i]);
+  }
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasRestoreForwardStateCheck<T, void(T::*)(const arma::mat&)>::value &&
+    !HasModelCheck<T>::value, void>::type
+RestoreForwardStateVisitor::LayerRestoreForwardState(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
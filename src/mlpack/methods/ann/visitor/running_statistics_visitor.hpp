@@ -0,0 +1,74 @@
+/**
+ * @file running_statistics_visitor.hpp
+ *
+ * Boost static visitor abstraction for collecting the running statistics of
+ * BatchNorm layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_RUNNING_STATISTICS_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_RUNNING_STATISTICS_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+template<typename eT> class BatchNormStatistics;
+
+/**
+ * RunningStatisticsVisitor appends the running statistics of a module (those
+ * of a BatchNorm layer) to the given vector.  Modules without statistics add
+ * nothing; the modules held by a container module are visited in order, so
+ * two copies of a network give their statistics in the same order.
+ */
+class RunningStatisticsVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Append the statistics to the given vector.
+  RunningStatisticsVisitor(
+      std::vector<BatchNormStatistics<double>*>& statistics);
+
+  //! Execute the Stats() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! The vector the statistics are appended to.
+  std::vector<BatchNormStatistics<double>*>& statistics;
+
+  //! Append the statistics of a module which implements the Stats()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      HasStatsCheck<T, BatchNormStatistics<double>&(T::*)()>::value,
+      void>::type
+  LayerStatistics(T* layer) const;
+
+  //! Visit the modules of a container module.
+  template<typename T>
+  typename std::enable_if<
+      !HasStatsCheck<T, BatchNormStatistics<double>&(T::*)()>::value &&
+      HasModelCheck<T>::value, void>::type
+  LayerStatistics(T* layer) const;
+
+  //! Do nothing for a module without statistics.
+  template<typename T>
+  typename std::enable_if<
+      !HasStatsCheck<T, BatchNormStatistics<double>&(T::*)()>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerStatistics(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "running_statistics_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file running_statistics_visitor_impl.hpp
+ *
+ * Implementation of the Stats() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_RUNNING_STATISTICS_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_RUNNING_STATISTICS_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "running_statistics_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! RunningStatisticsVisitor visitor class.
+inline RunningStatisticsVisitor::RunningStatisticsVisitor(
+    std::vector<BatchNormStatistics<double>*>& statistics) :
+    statistics(statistics)
+{
+  /* Nothing to do here. */
+}
+
+//! RunningStatisticsVisitor visitor class.
+template<typename LayerType>
+inline void RunningStatisticsVisitor::operator()(LayerType* layer) const
+{
+  LayerStatistics(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasStatsCheck<T, BatchNormStatistics<double>&(T::*)()>::value,
+    void>::type
+RunningStatisticsVisitor::LayerStatistics(T* layer) const
+{
+  statistics.push_back(&layer->Stats());
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasStatsCheck<T, BatchNormStatistics<double>&(T::*)()>::value &&
+    HasModelCheck<T>::value, void>::type
+RunningStatisticsVisitor::LayerStatistics(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+  {
+    boost::apply_visitor(RunningStatisticsVisitor(statistics),
+        layer->Model()[i]);
+  }
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasStatsCheck<T, BatchNormStatistics<double>&(T::*)()>::value &&
+    !HasModelCheck<T>::value, void>::type
+RunningStatisticsVisitor::LayerStatistics(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file save_forward_state_visitor.hpp
+ *
+ * Boost static visitor abstraction for saving the state of the forward pass
+ * of a module.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SAVE_FORWARD_STATE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SAVE_FORWARD_STATE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * SaveForwardStateVisitor appends the state of the last forward pass of a
+ * module in training mode to the given vector, so that the pass can be
+ * recomputed later with RestoreForwardStateVisitor.  Modules whose forward pass
+ * has no state add nothing; the modules held by a container module are visited
+ * in order.
+ */
+class SaveForwardStateVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Append the states to the given vector.
+  SaveForwardStateVisitor(std::vector<arma::mat>& states);
+
+  //! Execute the SaveForwardState() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! The vector the states are appended to.
+  std::vector<arma::mat>& states;
+
+  //! Save the state of a module which implements SaveForwardState().
+  template<typename T>
+  typename std::enable_if<
+      HasSaveForwardStateCheck<T, void(T::*)(arma::mat&)>::value,
+      void>::type
+  LayerSaveForwardState(T* layer) const;
+
+  //! Visit the modules of a container module.
+  template<typename T>
+  typename std::enable_if<
+      !HasSaveForwardStateCheck<T, void(T::*)(arma::mat&)>::value &&
+      HasModelCheck<T>::value, void>::type
+  LayerSaveForwardState(T* layer) const;
+
+  //! Do nothing for a module without forward state.
+  template<typename T>
+  typename std::enable_if<
+      !HasSaveForwardStateCheck<T, void(T::*)(arma::mat&)>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerSaveForwardState(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "save_forward_state_visitor_impl.hpp"
+
+#endif
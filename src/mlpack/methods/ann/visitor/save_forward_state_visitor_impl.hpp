@@ -0,0 +1,70 @@
+/**
+ * @file save_forward_state_visitor_impl.hpp
+ *
+ * Implementation of the SaveForwardState() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SAVE_FORWARD_STATE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SAVE_FORWARD_STATE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "save_forward_state_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! SaveForwardStateVisitor visitor class.
+inline SaveForwardStateVisitor::SaveForwardStateVisitor(
+    std::vector<arma::mat>& states) :
+    states(states)
+{
+  /* Nothing to do here. */
+}
+
+//! SaveForwardStateVisitor visitor class.
+template<typename LayerType>
+inline void SaveForwardStateVisitor::operator()(LayerType* layer) const
+{
+  LayerSaveForwardState(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasSaveForwardStateCheck<T, void(T::*)(arma::mat&)>::value,
+    void>::type
+SaveForwardStateVisitor::LayerSaveForwardState(T* layer) const
+{
+  states.push_back(arma::mat());
+  layer->SaveForwardState(states.back());
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasSaveForwardStateCheck<T, void(T::*)(arma::mat&)>::value &&
+    HasModelCheck<T>::value, void>::type
+SaveForwardStateVisitor::LayerSaveForwardState(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+  {
+    boost::apply_visitor(SaveForwardStateVisitor(states),
+        layer->Model()[i]);
+  }
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasSaveForwardStateCheck<T, void(T::*)(arma::mat&)>::value &&
+    !HasModelCheck<T>::value, void>::type
+SaveForwardStateVisitor::LayerSaveForwardState(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
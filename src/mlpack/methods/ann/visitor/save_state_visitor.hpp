@@ -0,0 +1,69 @@
+/**
+ * @file save_state_visitor.hpp
+ *
+ * Boost static visitor abstraction for calling the SaveState() function on RNN
+ * cells.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SAVE_STATE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SAVE_STATE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * SaveStateVisitor appends the recurrent state of the last computed time step
+ * of a module to the given matrix, which has one column per sequence of the
+ * batch.  Modules without a state add nothing; the modules held by a container
+ * module are visited in order.
+ */
+class SaveStateVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Append the states to the given matrix.
+  SaveStateVisitor(arma::mat& state);
+
+  //! Execute the SaveState() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! The matrix the states are appended to.
+  arma::mat& state;
+
+  //! Save the state of a module which implements the SaveState() function.
+  template<typename T>
+  typename std::enable_if<
+      HasSaveStateCheck<T, void(T::*)(arma::mat&) const>::value, void>::type
+  SaveState(T* layer) const;
+
+  //! Visit the modules of a container module without a state of its own.
+  template<typename T>
+  typename std::enable_if<
+      !HasSaveStateCheck<T, void(T::*)(arma::mat&) const>::value &&
+      HasModelCheck<T>::value, void>::type
+  SaveState(T* layer) const;
+
+  //! Do nothing for a module without a state.
+  template<typename T>
+  typename std::enable_if<
+      !HasSaveStateCheck<T, void(T::*)(arma::mat&) const>::value &&
+      !HasModelCheck<T>::value, void>::type
+  SaveState(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "save_state_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file save_state_visitor_impl.hpp
+ *
+ * Implementation of the SaveState() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SAVE_STATE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SAVE_STATE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "save_state_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! SaveStateVisitor visitor class.
+inline SaveStateVisitor::SaveStateVisitor(arma::mat& state) : state(state)
+{
+  /* Nothing to do here. */
+}
+
+//! SaveStateVisitor visitor class.
+template<typename LayerType>
+inline void SaveStateVisitor::operator()(LayerType* layer) const
+{
+  SaveState(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasSaveStateCheck<T, void(T::*)(arma::mat&) const>::value, void>::type
+SaveStateVisitor::SaveState(T* layer) const
+{
+  arma::mat layerState;
+  layer->SaveState(layerState);
+  state = arma::join_cols(state, layerState);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasSaveStateCheck<T, void(T::*)(arma::mat&) const>::value &&
+    HasModelCheck<T>::value, void>::type
+SaveStateVisitor::SaveState(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+    boost::apply_visitor(SaveStateVisitor(state), layer->Model()[i]);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasSaveStateCheck<T, void(T::*)(arma::mat&) const>::value &&
+    !HasModelCheck<T>::value, void>::type
+SaveStateVisitor::SaveState(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file sequence_check_visitor.hpp
+ *
+ * This file provides an abstraction to check whether a layer can process a
+ * whole sequence at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SEQUENCE_CHECK_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SEQUENCE_CHECK_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * SequenceCheckVisitor checks whether a layer can process all time steps of a
+ * sequence in a single call.  This is the case for recurrent layers that
+ * implement the ForwardSequence() function (as long as the sequence is not
+ * longer than the rho of the layer), and for layers that keep no state from
+ * one time step to the next.  Layers that implement the ResetCell(), Model()
+ * or Deterministic() function are treated as stateful.
+ */
+class SequenceCheckVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Check the layer for a sequence of the given number of time steps.
+  SequenceCheckVisitor(const size_t steps);
+
+  //! Check whether the layer can process a whole sequence at once.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+ private:
+  //! The number of time steps of the sequence.
+  size_t steps;
+
+  //! Check the rho of a module which implements the ForwardSequence()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+          arma::mat&)>::value, bool>::type
+  LayerSequence(T* layer) const;
+
+  //! Check whether a module which doesn't implement the ForwardSequence()
+  //! function is stateless.
+  template<typename T>
+  typename std::enable_if<
+      !HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+          arma::mat&)>::value, bool>::type
+  LayerSequence(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sequence_check_visitor_impl.hpp"
+
+#endif
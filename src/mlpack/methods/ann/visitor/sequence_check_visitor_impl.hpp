@@ -0,0 +1,58 @@
+/**
+ * @file sequence_check_visitor_impl.hpp
+ *
+ * Implementation of the sequence check layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SEQUENCE_CHECK_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SEQUENCE_CHECK_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sequence_check_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! SequenceCheckVisitor visitor class.
+inline SequenceCheckVisitor::SequenceCheckVisitor(const size_t steps) :
+    steps(steps)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline bool SequenceCheckVisitor::operator()(LayerType* layer) const
+{
+  return LayerSequence(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+        arma::mat&)>::value, bool>::type
+SequenceCheckVisitor::LayerSequence(T* layer) const
+{
+  // The step-wise functions truncate BPTT to rho steps, the sequence functions
+  // don't.
+  return layer->Rho() >= steps;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasForwardSequenceCheck<T, void(T::*)(const arma::mat&, const size_t,
+        arma::mat&)>::value, bool>::type
+SequenceCheckVisitor::LayerSequence(T* /* layer */) const
+{
+  return !HasResetCellCheck<T, void(T::*)(const size_t)>::value &&
+      !HasModelCheck<T>::value &&
+      !HasDeterministicCheck<T, bool&(T::*)(void)>::value;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
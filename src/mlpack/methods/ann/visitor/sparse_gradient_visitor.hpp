@@ -0,0 +1,81 @@
+/**
+ * @file sparse_gradient_visitor.hpp
+ *
+ * This file provides an abstraction for the SparseGradient() function for
+ * different layers and automatically directs any parameter to the right layer
+ * type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SPARSE_GRADIENT_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SPARSE_GRADIENT_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * SparseGradientVisitor executes the SparseGradient() method of the given
+ * module using the input and delta parameter, and appends the indices of the
+ * written gradient entries, in the flat gradient of the network, to the given
+ * vector.  It returns false for modules that don't compute sparse gradients;
+ * their gradient has to be computed with the GradientVisitor.
+ */
+class SparseGradientVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Executes the SparseGradient() method of the given module using the input
+  //! and delta parameter; the gradient of the module starts at the given
+  //! offset of the flat gradient.
+  SparseGradientVisitor(arma::mat&& input,
+                        arma::mat&& delta,
+                        const size_t offset,
+                        std::vector<arma::uword>& indices);
+
+  //! Executes the SparseGradient() method.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+ private:
+  //! The input set.
+  arma::mat&& input;
+
+  //! The delta parameter.
+  arma::mat&& delta;
+
+  //! The offset of the gradient of the module.
+  size_t offset;
+
+  //! The indices of the written gradient entries.
+  std::vector<arma::uword>& indices;
+
+  //! Execute the SparseGradient() function if the module implements it.
+  template<typename T>
+  typename std::enable_if<
+      HasTouchedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+      bool>::type
+  LayerGradients(T* layer) const;
+
+  //! Do not execute the SparseGradient() function if the module doesn't
+  //! implement it.
+  template<typename T>
+  typename std::enable_if<
+      !HasTouchedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+      bool>::type
+  LayerGradients(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_gradient_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file sparse_gradient_visitor_impl.hpp
+ *
+ * Implementation of the SparseGradient() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_SPARSE_GRADIENT_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_SPARSE_GRADIENT_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_gradient_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! SparseGradientVisitor visitor class.
+inline SparseGradientVisitor::SparseGradientVisitor(
+    arma::mat&& input,
+    arma::mat&& delta,
+    const size_t offset,
+    std::vector<arma::uword>& indices) :
+    input(std::move(input)),
+    delta(std::move(delta)),
+    offset(offset),
+    indices(indices)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline bool SparseGradientVisitor::operator()(LayerType* layer) const
+{
+  return LayerGradients(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasTouchedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+    bool>::type
+SparseGradientVisitor::LayerGradients(T* layer) const
+{
+  layer->SparseGradient(std::move(input), std::move(delta),
+      std::move(layer->Gradient()));
+
+  // The gradient is stored column-major, so the indices come out sorted.
+  const size_t rows = layer->Gradient().n_rows;
+  const arma::uvec& columns = layer->TouchedColumns();
+  for (size_t i = 0; i < columns.n_elem; ++i)
+    for (size_t r = 0; r < rows; ++r)
+      indices.push_back(offset + columns[i] * rows + r);
+
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasTouchedColumnsCheck<T, const arma::uvec&(T::*)() const>::value,
+    bool>::type
+SparseGradientVisitor::LayerGradients(T* /* layer */) const
+{
+  return false;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -35,10 +35,21 @@
 namespace mlpack {
 namespace neighbor {
 
+/**
+ * The DrusillaSelect class selects a candidate set of points from the reference
+ * set at training time, and searches it for the approximate furthest neighbors
+ * of the query points.  The candidate set is stored with the element type of
+ * MatType, so arma::fmat stores it in single precision.
+ *
+ * @tparam MatType Type of the data (dense or sparse).
+ */
 template<typename MatType = arma::mat>
 class DrusillaSelect
 {
  public:
+  //! The element type of the data.
+  typedef typename MatType::elem_type ElemType;
+
   /**
    * Construct the DrusillaSelect object with the given reference set (this is
    * the set that will be searched).  The resulting set of candidate points that
@@ -81,7 +92,8 @@ class DrusillaSelect
    * NeighborSearch and LSHSearch classes.  That is, each column in the
    * neighbors and distances matrices will refer to a single query point, and
    * the k'th row in that column will refer to the k'th candidate neighbor or
-   * distance for that query point.
+   * distance for that query point.  Blocks of query points are searched in
+   * parallel.
    *
    * @param querySet Set of query points to search.
    * @param k Number of furthest neighbors to search for.
@@ -81,7 +81,7 @@ void DrusillaSelect<MatType>::Train(
   candidateSet.set_size(referenceSet.n_rows, l * m);
   candidateIndices.set_size(l * m);
 
-  arma::vec dataMean(arma::mean(referenceSet, 1));
+  arma::Col<ElemType> dataMean(arma::mean(referenceSet, 1));
   arma::vec norms(referenceSet.n_cols);
 
   MatType refCopy(referenceSet.n_rows, referenceSet.n_cols);
@@ -98,7 +98,8 @@ void DrusillaSelect<MatType>::Train(
     arma::uword maxIndex = 0;
     norms.max(maxIndex);
 
-    arma::vec line(refCopy.col(maxIndex) / arma::norm(refCopy.col(maxIndex)));
+    arma::Col<ElemType> line(refCopy.col(maxIndex) /
+        arma::norm(refCopy.col(maxIndex)));
 
     // Calculate distortion and offset and make scores.
     std::vector<bool> closeAngle(referenceSet.n_cols, false);
@@ -179,19 +180,40 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
     throw std::invalid_argument("DrusillaSelect::Search(): requested k is "
         "greater than number of points in candidate set!  Increase l or m.");
 
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
   // We'll use the NeighborSearchRules class to perform our brute-force search.
-  // Note that we aren't using trees for our search, so we can use 'int' as a
-  // TreeType.
-  metric::EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
+  // Note that we aren't using trees for our search, so the tree type is only
+  // used for its typedefs.  The rules hold the candidates of every query
+  // point, so the query points are searched in blocks, each with its own rules
+  // and in parallel.
+  typedef NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
       tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
+      RuleType;
 
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
 
-  rules.GetResults(neighbors, distances);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+    const MatType queryBlock = querySet.cols(begin, end - 1);
+
+    metric::EuclideanDistance metric;
+    RuleType rules(candidateSet, queryBlock, k, metric, 0, false);
+    for (size_t q = 0; q < queryBlock.n_cols; ++q)
+      for (size_t r = 0; r < candidateSet.n_cols; ++r)
+        rules.BaseCase(q, r);
+
+    arma::Mat<size_t> blockNeighbors;
+    arma::mat blockDistances;
+    rules.GetResults(blockNeighbors, blockDistances);
+    neighbors.cols(begin, end - 1) = blockNeighbors;
+    distances.cols(begin, end - 1) = blockDistances;
+  }
 
   // Map the neighbors back to their original indices in the reference set.
   for (size_t i = 0; i < neighbors.n_elem; ++i)
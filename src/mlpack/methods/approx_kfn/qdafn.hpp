@@ -30,10 +30,25 @@
 namespace mlpack {
 namespace neighbor {
 
+/**
+ * The QDAFN class stores a set of random projections of the reference set, and
+ * the m points that project furthest onto each of them; the candidates of the
+ * projections with the largest gaps from the query's projection are searched.
+ *
+ * The projections are stored with the element type of MatType; use arma::fmat
+ * to store the lines and the candidate sets in single precision.  Queries are
+ * processed in parallel, and each block of queries is projected onto all the
+ * lines with one matrix product.
+ *
+ * @tparam MatType Type of the data (dense or sparse).
+ */
 template<typename MatType = arma::mat>
 class QDAFN
 {
  public:
+  //! The element type of the data.
+  typedef typename MatType::elem_type ElemType;
+
   /**
    * Construct the QDAFN object but do not train it.  Be sure to call Train()
    * before calling Search().
@@ -72,7 +87,8 @@ class QDAFN
    * Search for the k furthest neighbors of the given query set.  (The query set
    * can contain just one point, that is okay.)  The results will be stored in
    * the given neighbors and distances matrices, in the same format as the
-   * mlpack NeighborSearch and LSHSearch classes.
+   * mlpack NeighborSearch and LSHSearch classes.  The query points are
+   * searched in parallel.
    */
   void Search(const MatType& querySet,
               const size_t k,
@@ -92,19 +108,38 @@ class QDAFN
   MatType& CandidateSet(const size_t t) { return candidateSet[t]; }
 
  private:
+  /**
+   * Search for the k furthest neighbors of one query point, and store them in
+   * the given column of the results.
+   *
+   * @param query The query point.
+   * @param queryProjections Projections of the query point onto the lines.
+   * @param k Number of furthest neighbors to search for.
+   * @param queryIndex Column of the results to store the neighbors in.
+   * @param neighbors Matrix of neighbors.
+   * @param distances Matrix of distances.
+   */
+  template<typename VecType>
+  void SearchPoint(const VecType& query,
+                   const arma::Col<ElemType>& queryProjections,
+                   const size_t k,
+                   const size_t queryIndex,
+                   arma::Mat<size_t>& neighbors,
+                   arma::mat& distances) const;
+
   //! The number of projections.
   size_t l;
   //! The number of elements to store for each projection.
   size_t m;
   //! The random lines we are projecting onto.  Has l columns.
-  arma::mat lines;
+  arma::Mat<ElemType> lines;
   //! Projections of each point onto each random line.
-  arma::mat projections;
+  arma::Mat<ElemType> projections;
 
   //! Indices of the points for each S.
   arma::Mat<size_t> sIndices;
   //! Values of a_i * x for each point in S.
-  arma::mat sValues;
+  arma::Mat<ElemType> sValues;
 
   // Candidate sets; one element in the vector for each table.
   std::vector<MatType> candidateSet;
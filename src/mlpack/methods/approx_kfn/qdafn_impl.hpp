@@ -64,7 +64,7 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   mlpack::distribution::GaussianDistribution gd(referenceSet.n_rows);
   lines.set_size(referenceSet.n_rows, l);
   for (size_t i = 0; i < l; ++i)
-    lines.col(i) = gd.Random();
+    lines.col(i) = arma::conv_to<arma::Col<ElemType>>::from(gd.Random());
 
   // Now, project each of the reference points onto each line, and collect the
   // top m elements.
@@ -104,69 +104,92 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
-  // Search for each point.
-  for (size_t q = 0; q < querySet.n_cols; ++q)
+  // The queries are projected onto the lines in blocks, with one matrix product
+  // for each block, and the blocks are searched in parallel.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // Initialize a priority queue.
-    // The size_t represents the index of the table, and the double represents
-    // the value of l_i * S_i - l_i * query (see line 6 of Algorithm 1).
-    std::priority_queue<std::pair<double, size_t>> queue;
-    for (size_t i = 0; i < l; ++i)
-    {
-      const double val = sValues(0, i) - arma::dot(querySet.col(q),
-          lines.col(i));
-      queue.push(std::make_pair(val, i));
-    }
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+    const arma::Mat<ElemType> queryProjections = arma::Mat<ElemType>(
+        lines.t() * MatType(querySet.cols(begin, end - 1)));
+
+    for (size_t q = begin; q < end; ++q)
+      SearchPoint(querySet.col(q), queryProjections.unsafe_col(q - begin), k,
+          q, neighbors, distances);
+  }
+}
+
+template<typename MatType>
+template<typename VecType>
+void QDAFN<MatType>::SearchPoint(const VecType& query,
+                                 const arma::Col<ElemType>& queryProjections,
+                                 const size_t k,
+                                 const size_t queryIndex,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& distances) const
+{
+  // Initialize a priority queue.
+  // The size_t represents the index of the table, and the double represents
+  // the value of l_i * S_i - l_i * query (see line 6 of Algorithm 1).
+  std::priority_queue<std::pair<double, size_t>> queue;
+  for (size_t i = 0; i < l; ++i)
+  {
+    const double val = sValues(0, i) - queryProjections[i];
+    queue.push(std::make_pair(val, i));
+  }
 
-    // To track where we are in each S table, we keep the next index to look at
-    // in each table (they start at 0).
-    arma::Col<size_t> tableLocations = arma::zeros<arma::Col<size_t>>(l);
+  // To track where we are in each S table, we keep the next index to look at
+  // in each table (they start at 0).
+  arma::Col<size_t> tableLocations = arma::zeros<arma::Col<size_t>>(l);
 
-    // Now that the queue is initialized, iterate over m elements.
-    std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
-        size_t(-1)));
-    std::priority_queue<std::pair<double, size_t>>
-        resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
-    for (size_t i = 0; i < m; ++i)
+  // Now that the queue is initialized, iterate over m elements.
+  std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
+      size_t(-1)));
+  std::priority_queue<std::pair<double, size_t>>
+      resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
+  for (size_t i = 0; i < m; ++i)
+  {
+    const std::pair<double, size_t> p = queue.top();
+    queue.pop();
+
+    // Get index of reference point to look at.
+    const size_t tableIndex = tableLocations[p.second];
+
+    // Calculate distance from query point.
+    const double dist = mlpack::metric::EuclideanDistance::Evaluate(query,
+        candidateSet[p.second].col(tableIndex));
+
+    // Is this neighbor good enough to insert into the results?
+    if (dist > resultsQueue.top().first)
     {
-      std::pair<size_t, double> p = queue.top();
-      queue.pop();
-
-      // Get index of reference point to look at.
-      const size_t tableIndex = tableLocations[p.second];
-
-      // Calculate distance from query point.
-      const double dist = mlpack::metric::EuclideanDistance::Evaluate(
-          querySet.col(q), candidateSet[p.second].col(tableIndex));
-
-      // Is this neighbor good enough to insert into the results?
-      if (dist > resultsQueue.top().first)
-      {
-        resultsQueue.pop();
-        resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
-      }
-
-      // Now (line 14) get the next element and insert into the queue.  Do this
-      // by adjusting the previous value.  Don't insert anything if we are at
-      // the end of the search, though.
-      if (i < m - 1)
-      {
-        tableLocations[p.second]++;
-        const double val = p.first - sValues(tableIndex, p.second) +
-            sValues(tableIndex + 1, p.second);
-
-        queue.push(std::make_pair(val, p.second));
-      }
+      resultsQueue.pop();
+      resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
     }
 
-    // Extract the results.
-    for (size_t j = 1; j <= k; ++j)
+    // Now (line 14) get the next element and insert into the queue.  Do this
+    // by adjusting the previous value.  Don't insert anything if we are at
+    // the end of the search, though.
+    if (i < m - 1)
     {
-      neighbors(k - j, q) = resultsQueue.top().second;
-      distances(k - j, q) = resultsQueue.top().first;
-      resultsQueue.pop();
+      tableLocations[p.second]++;
+      const double val = p.first - sValues(tableIndex, p.second) +
+          sValues(tableIndex + 1, p.second);
+
+      queue.push(std::make_pair(val, p.second));
     }
   }
+
+  // Extract the results.
+  for (size_t j = 1; j <= k; ++j)
+  {
+    neighbors(k - j, queryIndex) = resultsQueue.top().second;
+    distances(k - j, queryIndex) = resultsQueue.top().first;
+    resultsQueue.pop();
+  }
 }
 
 template<typename MatType>
@@ -15,6 +15,7 @@
  */
 #include "cf.hpp"
 
+#include <mlpack/methods/fastmks/fastmks.hpp>
 #include <queue>
 
 namespace mlpack {
@@ -37,7 +38,8 @@ CF::CF(const size_t numUsersForSimilarity,
 }
 
 void CF::GetRecommendations(const size_t numRecs,
-                            arma::Mat<size_t>& recommendations)
+                            arma::Mat<size_t>& recommendations,
+                            const bool useFastMKS)
 {
   // Generate list of users.  Maybe it would be more efficient to pass an empty
   // users list, and then have the other overload of GetRecommendations() assume
@@ -47,12 +49,13 @@ void CF::GetRecommendations(const size_t numRecs,
       cleanedData.n_cols - 1, cleanedData.n_cols);
 
   // Call the main overload for recommendations.
-  GetRecommendations(numRecs, recommendations, users);
+  GetRecommendations(numRecs, recommendations, users, useFastMKS);
 }
 
 void CF::GetRecommendations(const size_t numRecs,
                             arma::Mat<size_t>& recommendations,
-                            const arma::Col<size_t>& users)
+                            const arma::Col<size_t>& users,
+                            const bool useFastMKS)
 {
   // We want to avoid calculating the full rating matrix, so we will do nearest
   // neighbor search only on the H matrix, using the observation that if the
@@ -86,63 +89,197 @@ void CF::GetRecommendations(const size_t numRecs,
   arma::mat resultingDistances; // Temporary storage.
   a.Search(query, numUsersForSimilarity, neighborhood, resultingDistances);
 
-  // Generate recommendations for each query user by finding the maximum numRecs
-  // elements in the averages matrix.
+  // The estimated ratings of each user are the average of the estimated
+  // ratings of its neighborhood, that is, W times the average of the H columns
+  // of the neighborhood.
+  arma::mat averages(h.n_rows, users.n_elem, arma::fill::zeros);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      averages.col(i) += h.col(neighborhood(j, i));
+  }
+  averages /= neighborhood.n_rows;
+
+  // Items that could not be recommended are marked with the number of items.
+  // The ratings are only read from here, so they are safe to use in parallel.
+  const size_t invalid = cleanedData.n_rows;
+  const arma::sp_mat& ratings = cleanedData;
   recommendations.set_size(numRecs, users.n_elem);
-  arma::mat values(numRecs, users.n_elem);
-  recommendations.fill(SIZE_MAX);
-  values.fill(DBL_MAX);
 
-  for (size_t i = 0; i < users.n_elem; i++)
+  if (useFastMKS)
   {
-    // First, calculate average of neighborhood values.
-    arma::vec averages;
-    averages.zeros(cleanedData.n_rows);
-
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
-      averages += w * h.col(neighborhood(j, i));
-    averages /= neighborhood.n_rows;
-
-    // Let's build the list of candidate recomendations for the given user.
-    // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
-    std::vector<Candidate> vect(numRecs, def);
-    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        CandidateList;
-    CandidateList pqueue(CandidateCmp(), std::move(vect));
-
-    // Look through the averages column corresponding to the current user.
-    for (size_t j = 0; j < averages.n_rows; ++j)
+    // The rated items are filtered out of the results, so search for enough
+    // items to fill the recommendations of every user.
+    size_t maxRated = 0;
+    for (size_t i = 0; i < users.n_elem; ++i)
     {
-      // Ensure that the user hasn't already rated the item.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
+      maxRated = std::max(maxRated, (size_t) (ratings.col_ptrs[users(i) + 1] -
+          ratings.col_ptrs[users(i)]));
+    }
+    const size_t k = std::min(numRecs + maxRated, (size_t) w.n_rows);
 
-      // Is the estimated value better than the worst candidate?
-      if (averages[j] > pqueue.top().first)
+    // Search for the items with maximum inner product with the averages.
+    const arma::mat items = w.t();
+    fastmks::FastMKS<kernel::LinearKernel> mks(items);
+    arma::Mat<size_t> indices;
+    arma::mat kernels;
+    mks.Search(averages, k, indices, kernels);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
+    {
+      size_t found = 0;
+      for (size_t j = 0; j < k && found < numRecs; ++j)
       {
-        Candidate c = std::make_pair(averages[j], j);
-        pqueue.pop();
-        pqueue.push(c);
+        // Ensure that the user hasn't already rated the item.
+        if (ratings(indices(j, i), users(i)) == 0.0)
+          recommendations(found++, i) = indices(j, i);
       }
-    }
 
-    for (size_t p = 1; p <= numRecs; p++)
+      for (; found < numRecs; ++found)
+        recommendations(found, i) = invalid;
+    }
+  }
+  else
+  {
+    // Score the items for blocks of users at once, so that the work is done by
+    // a matrix product, without holding the estimated ratings of every user.
+    const size_t blockSize = 256;
+    for (size_t begin = 0; begin < users.n_elem; begin += blockSize)
     {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
+      const size_t end = std::min(begin + blockSize, (size_t) users.n_elem);
+      arma::mat scores = w * averages.cols(begin, end - 1);
+
+      #pragma omp parallel for
+      for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+      {
+        double* userScores = scores.colptr(i - begin);
+
+        // Ensure that the user hasn't already rated the item: an item with the
+        // smallest possible value will never become a candidate.
+        arma::sp_mat::const_iterator it = ratings.begin_col(users(i));
+        for (; it != ratings.end_col(users(i)); ++it)
+          userScores[it.row()] = -DBL_MAX;
+
+        // Let's build the list of candidate recomendations for the given user.
+        // Default candidate: the smallest possible value and invalid item
+        // number.
+        const Candidate def = std::make_pair(-DBL_MAX, invalid);
+        std::vector<Candidate> vect(numRecs, def);
+        typedef std::priority_queue<Candidate, std::vector<Candidate>,
+            CandidateCmp> CandidateList;
+        CandidateList pqueue(CandidateCmp(), std::move(vect));
+
+        // Look through the scores of the current user.
+        for (size_t j = 0; j < scores.n_rows; ++j)
+        {
+          // Is the estimated value better than the worst candidate?
+          if (userScores[j] > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(userScores[j], j);
+            pqueue.pop();
+            pqueue.push(c);
+          }
+        }
+
+        for (size_t p = 1; p <= numRecs; p++)
+        {
+          recommendations(numRecs - p, i) = pqueue.top().second;
+          pqueue.pop();
+        }
+      }
     }
+  }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (numRecs > 0 && recommendations(numRecs - 1, i) == invalid)
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
   }
 }
 
+void CF::AddUsers(const arma::sp_mat& ratings, const double lambda)
+{
+  if (ratings.n_rows != cleanedData.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "CF::AddUsers(): ratings must have one row for each of the "
+        << cleanedData.n_rows << " items (" << ratings.n_rows << " given)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat newH;
+  FoldIn(ratings, w.t(), lambda, newH);
+
+  h = arma::join_rows(h, newH);
+  cleanedData = arma::join_rows(cleanedData, ratings);
+}
+
+void CF::AddItems(const arma::sp_mat& ratings, const double lambda)
+{
+  if (ratings.n_cols != cleanedData.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "CF::AddItems(): ratings must have one column for each of the "
+        << cleanedData.n_cols << " users (" << ratings.n_cols << " given)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat newW;
+  FoldIn(ratings.t(), h, lambda, newW);
+
+  w = arma::join_cols(w, newW.t());
+  cleanedData = arma::join_cols(cleanedData, ratings);
+}
+
+void CF::FoldIn(const arma::sp_mat& ratings,
+                const arma::mat& fixed,
+                const double lambda,
+                arma::mat& factors)
+{
+  const size_t rank = fixed.n_rows;
+  factors.set_size(rank, ratings.n_cols);
+
+  #pragma omp parallel
+  {
+    // The workspaces of this thread.
+    arma::mat a(rank, rank);
+    arma::vec b(rank);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t j = 0; j < (omp_size_t) ratings.n_cols; ++j)
+    {
+      a.zeros();
+      a.diag().fill(lambda);
+      b.zeros();
+
+      // Only the rated entities take part in the fit.
+      for (size_t k = ratings.col_ptrs[j]; k < ratings.col_ptrs[j + 1]; ++k)
+      {
+        const double* y = fixed.colptr(ratings.row_indices[k]);
+        for (size_t c = 0; c < rank; ++c)
+        {
+          double* column = a.colptr(c);
+          for (size_t r = 0; r < rank; ++r)
+            column[r] += y[c] * y[r];
+
+          b[c] += ratings.values[k] * y[c];
+        }
+      }
+
+      // The system is singular if there are too few ratings and no
+      // regularization; then, take the minimum-norm fit.
+      arma::vec x(factors.colptr(j), rank, false, true);
+      if (lambda <= 0.0 || !arma::solve(x, a, b))
+        x = arma::pinv(a) * b;
+    }
+  }
+}
+
 // Predict the rating for a single user/item combination.
 double CF::Predict(const size_t user, const size_t item) const
 {
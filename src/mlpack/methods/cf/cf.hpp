@@ -161,6 +161,38 @@ class CF
              const typename std::enable_if_t<
                  !FactorizerTraits<FactorizerType>::UsesCoordinateList>* = 0);
 
+  /**
+   * Fold new users into the trained model, without refactorizing the data.
+   * With W fixed, the factors of each new user are the (regularized) least
+   * squares fit of its ratings,
+   *
+   * (W_r^T W_r + lambda I) h = W_r^T r,
+   *
+   * where W_r holds the rows of W of the items the user rated and r holds the
+   * ratings.  The new users are given the next user indices, and their ratings
+   * are added to the cleaned data, so they can be queried and can be part of
+   * the neighborhood of any user right away.  The systems of the new users are
+   * solved in parallel.
+   *
+   * @param ratings Ratings of the new users, with one row for each item and one
+   *     column for each new user.
+   * @param lambda Regularization parameter of the least squares fit.  If it is
+   *     0, users with fewer ratings than the rank get the minimum-norm fit.
+   */
+  void AddUsers(const arma::sp_mat& ratings, const double lambda = 0.0);
+
+  /**
+   * Fold new items into the trained model, without refactorizing the data.
+   * With H fixed, the factors of each new item are the (regularized) least
+   * squares fit of its ratings, as in AddUsers().  The new items are given the
+   * next item indices.
+   *
+   * @param ratings Ratings of the new items, with one row for each new item and
+   *     one column for each user.
+   * @param lambda Regularization parameter of the least squares fit.
+   */
+  void AddItems(const arma::sp_mat& ratings, const double lambda = 0.0);
+
   //! Sets number of users for calculating similarity.
   void NumUsersForSimilarity(const size_t num)
   {
@@ -203,20 +235,37 @@ class CF
    *
    * @param numRecs Number of Recommendations
    * @param recommendations Matrix to save recommendations into.
+   * @param useFastMKS If true, find the best items with FastMKS (exact maximum
+   *     inner product search on the item factors) instead of scoring every
+   *     item for every user.
    */
   void GetRecommendations(const size_t numRecs,
-                          arma::Mat<size_t>& recommendations);
+                          arma::Mat<size_t>& recommendations,
+                          const bool useFastMKS = false);
 
   /**
    * Generates the given number of recommendations for the specified users.
    *
+   * The estimated ratings of a user are W times the average of the columns of
+   * H of its neighborhood, so the best items are those whose rows of W have
+   * the largest inner product with that average.  By default, the items are
+   * scored for blocks of users at once with a matrix product, and the best
+   * items of each user are found in parallel.  If useFastMKS is true, FastMKS
+   * with the linear kernel is used instead, which avoids scoring every item
+   * when the number of items is large compared to the rank.  Items the user
+   * already rated are never recommended; if there are not enough un-rated
+   * items, the remaining recommendations are set to the number of items.
+   *
    * @param numRecs Number of Recommendations
    * @param recommendations Matrix to save recommendations
    * @param users Users for which recommendations are to be generated
+   * @param useFastMKS If true, find the best items with FastMKS instead of
+   *     scoring every item for every user.
    */
   void GetRecommendations(const size_t numRecs,
                           arma::Mat<size_t>& recommendations,
-                          const arma::Col<size_t>& users);
+                          const arma::Col<size_t>& users,
+                          const bool useFastMKS = false);
 
   //! Converts the User, Item, Value Matrix to User-Item Table
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
@@ -262,6 +311,21 @@ class CF
   //! Cleaned data matrix.
   arma::sp_mat cleanedData;
 
+  /**
+   * Fit the factors of each column of the given ratings, with the given fixed
+   * factors.  Each nonzero ratings(i, j) is a rating of column j for the
+   * entity of column i of the fixed factors.
+   *
+   * @param ratings Sparse matrix of ratings.
+   * @param fixed Fixed factors, with one column for each row of ratings.
+   * @param lambda Regularization parameter of the least squares fit.
+   * @param factors Fitted factors, with one column for each column of ratings.
+   */
+  static void FoldIn(const arma::sp_mat& ratings,
+                     const arma::mat& fixed,
+                     const double lambda,
+                     arma::mat& factors);
+
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
 
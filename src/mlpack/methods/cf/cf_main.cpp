@@ -59,9 +59,13 @@ PROGRAM_INFO("Collaborative Filtering", "This program performs collaborative "
     "'RegSVD' -- Regularized SVD using a SGD optimizer\n"
     "'NMF' -- Non-negative matrix factorization with alternating least squares "
     "update rules\n"
+    "'ImplicitALS' -- Alternating least squares for implicit feedback, where "
+    "the values are counts of interactions\n"
     "'BatchSVD' -- SVD batch learning\n"
     "'SVDIncompleteIncremental' -- SVD incomplete incremental learning\n"
     "'SVDCompleteIncremental' -- SVD complete incremental learning\n"
+    "'SVDParallelIncremental' -- SVD complete incremental learning on "
+    "independent blocks in parallel (stratified SGD)\n"
     "\n"
     "A trained model may be saved to with the " +
     PRINT_PARAM_STRING("output_model") + " output parameter."
@@ -112,6 +116,9 @@ PARAM_UMATRIX_OUT("output", "Matrix that will store output recommendations.",
     "o");
 PARAM_INT_IN("recommendations", "Number of recommendations to generate for each"
     " query user.", "c", 5);
+PARAM_FLAG("fast_mks", "Find the best items for each user with fast max-kernel "
+    "search (FastMKS) on the item factors instead of scoring every item.",
+    "F");
 
 PARAM_INT_IN("seed", "Set the random seed (0 uses std::time(NULL)).", "s", 0);
 
@@ -132,12 +139,14 @@ void ComputeRecommendations(CF* cf,
 
     Log::Info << "Generating recommendations for " << users.n_elem << " users."
         << endl;
-    cf->GetRecommendations(numRecs, recommendations, users.row(0).t());
+    cf->GetRecommendations(numRecs, recommendations, users.row(0).t(),
+        CLI::HasParam("fast_mks"));
   }
   else
   {
     Log::Info << "Generating recommendations for all users." << endl;
-    cf->GetRecommendations(numRecs, recommendations);
+    cf->GetRecommendations(numRecs, recommendations,
+        CLI::HasParam("fast_mks"));
   }
 }
 
@@ -217,6 +226,12 @@ void AssembleFactorizerType(const std::string& algorithm,
           FactorizerType;
       PerformAction(FactorizerType(mit), dataset, rank);
     }
+    else if (algorithm == "ImplicitALS")
+    {
+      typedef AMF<MaxIterationTermination, RandomInitialization,
+          ImplicitALSUpdate> FactorizerType;
+      PerformAction(FactorizerType(mit), dataset, rank);
+    }
     else if (algorithm == "BatchSVD")
     {
       typedef AMF<MaxIterationTermination, RandomInitialization,
@@ -235,6 +250,12 @@ void AssembleFactorizerType(const std::string& algorithm,
           SVDCompleteIncrementalLearning<arma::sp_mat>> FactorizerType;
       PerformAction(FactorizerType(mit), dataset, rank);
     }
+    else if (algorithm == "SVDParallelIncremental")
+    {
+      typedef AMF<MaxIterationTermination, RandomInitialization,
+          SVDParallelIncrementalLearning> FactorizerType;
+      PerformAction(FactorizerType(mit), dataset, rank);
+    }
     else if (algorithm == "RegSVD")
     {
       Log::Fatal << PRINT_PARAM_STRING("iteration_only_termination") << " not "
@@ -251,6 +272,10 @@ void AssembleFactorizerType(const std::string& algorithm,
     {
       PerformAction(NMFALSFactorizer(srt), dataset, rank);
     }
+    else if (algorithm == "ImplicitALS")
+    {
+      PerformAction(ImplicitALSFactorizer(srt), dataset, rank);
+    }
     else if (algorithm == "BatchSVD")
     {
       PerformAction(SVDBatchFactorizer<>(srt), dataset, rank);
@@ -265,6 +290,10 @@ void AssembleFactorizerType(const std::string& algorithm,
       PerformAction(SVDCompleteIncrementalFactorizer<arma::sp_mat>(srt),
           dataset, rank);
     }
+    else if (algorithm == "SVDParallelIncremental")
+    {
+      PerformAction(SVDParallelIncrementalFactorizer(srt), dataset, rank);
+    }
     else if (algorithm == "RegSVD")
     {
       PerformAction(RegularizedSVD<>(maxIterations), dataset, rank);
@@ -291,8 +320,9 @@ static void mlpackMain()
   if (CLI::HasParam("query") || CLI::HasParam("all_user_recommendations"))
     ReportIgnoredParam("output", "no recommendations requested");
 
-  RequireParamInSet<string>("algorithm", { "NMF", "BatchSVD",
-      "SVDIncompleteIncremental", "SVDCompleteIncremental", "RegSVD" }, true,
+  RequireParamInSet<string>("algorithm", { "NMF", "ImplicitALS",
+      "BatchSVD", "SVDIncompleteIncremental", "SVDCompleteIncremental",
+      "SVDParallelIncremental", "RegSVD" }, true,
       "unknown algorithm");
 
   ReportIgnoredParam({{ "iteration_only_termination", true }}, "min_residue");
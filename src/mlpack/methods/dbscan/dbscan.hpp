@@ -15,7 +15,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
-#include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
 
@@ -59,17 +59,25 @@ class DBSCAN
    * When batchMode is false, each point will be searched iteratively, which
    * could be slower but will use less memory.
    *
+   * In batch mode, the points can also be searched in blocks of blockSize
+   * query points, so that only the neighbors of one block per thread are held
+   * in memory at once.  The blocks are searched in parallel with OpenMP.  If
+   * blockSize is 0, all points are searched in one batch.
+   *
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
    * @param batchMode If true, all points are searched in batch.
    * @param rangeSearch Optional instantiated RangeSearch object.
    * @param pointSelector OptionL instantiated PointSelectionPolicy object.
+   * @param blockSize Number of query points in each batch search (0 means all
+   *      points).
    */
   DBSCAN(const double epsilon,
          const size_t minPoints,
          const bool batchMode = true,
          RangeSearchType rangeSearch = RangeSearchType(),
-         PointSelectionPolicy pointSelector = PointSelectionPolicy());
+         PointSelectionPolicy pointSelector = PointSelectionPolicy(),
+         const size_t blockSize = 0);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -111,6 +119,11 @@ class DBSCAN
                  arma::Row<size_t>& assignments,
                  arma::mat& centroids);
 
+  //! Get the number of query points in each batch search (0 means all).
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of query points in each batch search (0 means all).
+  size_t& BlockSize() { return blockSize; }
+
  private:
   //! Maximum distance between two points to be part of same cluster.
   double epsilon;
@@ -128,6 +141,9 @@ class DBSCAN
   //! Instantiated point selection policy.
   PointSelectionPolicy pointSelector;
 
+  //! Number of query points in each batch search (0 means all points).
+  size_t blockSize;
+
   /**
    * Performs DBSCAN clustering on the data, returning the number of clusters and
    * also the list of cluster assignments.  This searches each point iteratively,
@@ -140,7 +156,7 @@ class DBSCAN
    */
   template<typename MatType>
   void PointwiseCluster(const MatType& data,
-                        emst::UnionFind& uf);
+                        emst::ConcurrentUnionFind& uf);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -153,7 +169,7 @@ class DBSCAN
    */
   template<typename MatType>
   void BatchCluster(const MatType& data,
-                    emst::UnionFind& uf);
+                    emst::ConcurrentUnionFind& uf);
 };
 
 } // namespace dbscan
@@ -26,12 +26,14 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     const size_t minPoints,
     const bool batchMode,
     RangeSearchType rangeSearch,
-    PointSelectionPolicy pointSelector) :
+    PointSelectionPolicy pointSelector,
+    const size_t blockSize) :
     epsilon(epsilon),
     minPoints(minPoints),
     batchMode(batchMode),
     rangeSearch(rangeSearch),
-    pointSelector(pointSelector)
+    pointSelector(pointSelector),
+    blockSize(blockSize)
 {
   // Nothing to do.
 }
@@ -101,7 +103,7 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     arma::Row<size_t>& assignments)
 {
   // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
+  emst::ConcurrentUnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
   if (batchMode)
@@ -150,7 +152,7 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
@@ -173,29 +175,61 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
 /**
  * Performs DBSCAN clustering on the data, returning number of clusters
  * and also the list of cluster assignments.  This can perform search in batch,
- * naive search).
+ * so it is well suited for dual-tree or naive search.
  */
 template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
-  // For each point, find the points in epsilon-nighborhood and their distances.
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
-  Log::Info << "Performing range search." << std::endl;
-  rangeSearch.Train(data);
-  rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
-  Log::Info << "Range search complete." << std::endl;
+  const math::Range range(0.0, epsilon);
+  if (blockSize == 0 || blockSize >= data.n_cols)
+  {
+    // For each point, find the points in epsilon-neighborhood and their
+    // distances.
+    std::vector<std::vector<size_t>> neighbors;
+    std::vector<std::vector<double>> distances;
+    Log::Info << "Performing range search." << std::endl;
+    rangeSearch.Search(data, range, neighbors, distances);
+    Log::Info << "Range search complete." << std::endl;
+
+    // Now union each point to all its neighbors.
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+        uf.Union(i, neighbors[i][j]);
+    }
 
-  // Now loop over all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
+    return;
+  }
+
+  // Search the blocks in parallel; each thread only holds the neighbors of the
+  // block it is working on.  The model is not modified by these searches.
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  Log::Info << "Performing range search in " << numBlocks << " blocks."
+      << std::endl;
+
+  const RangeSearchType& search = rangeSearch;
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[i].size(); ++j)
-      uf.Union(i, neighbors[i][j]);
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+
+    std::vector<std::vector<size_t>> neighbors;
+    std::vector<std::vector<double>> distances;
+    tree::SearchContext context;
+    search.Search(MatType(data.cols(begin, end - 1)), range, neighbors,
+        distances, context);
+
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+        uf.Union(begin + i, neighbors[i][j]);
   }
+
+  Log::Info << "Range search complete." << std::endl;
 }
 
 } // namespace dbscan
@@ -55,6 +55,11 @@ PROGRAM_INFO("DBSCAN clustering",
     "search (as opposed to the default dual-tree search), and '" +
     PRINT_PARAM_STRING("naive") + " will force brute-force range search."
     "\n\n"
+    "For large datasets, the " + PRINT_PARAM_STRING("block_size") + " "
+    "parameter can be used to search the points in blocks of that many query "
+    "points, in parallel, instead of all at once; this bounds the memory used "
+    "to hold the neighbors of each point."
+    "\n\n"
     "An example usage to run DBSCAN on the dataset in " +
     PRINT_DATASET("input") + " with a radius of 0.5 and a minimum cluster size"
     " of 5 is given below:"
@@ -76,6 +81,8 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
+PARAM_INT_IN("block_size", "If nonzero, the number of query points in each "
+    "batch range search (not used with --single_mode).", "b", 0);
 
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType>
@@ -90,8 +97,10 @@ void RunDBSCAN(RangeSearchType rs = RangeSearchType())
   const double epsilon = CLI::GetParam<double>("epsilon");
   const size_t minSize = (size_t) CLI::GetParam<int>("min_size");
 
+  const size_t blockSize = (size_t) CLI::GetParam<int>("block_size");
+
   DBSCAN<RangeSearchType> d(epsilon, minSize, !CLI::HasParam("single_mode"),
-      rs);
+      rs, RandomPointSelection(), blockSize);
 
   // If possible, avoid the overhead of calculating centroids.
   arma::Row<size_t> assignments;
@@ -118,6 +127,10 @@ static void mlpackMain()
       "no output will be saved");
 
   ReportIgnoredParam({{ "naive", true }}, "single_mode");
+  ReportIgnoredParam({{ "single_mode", true }}, "block_size");
+
+  RequireParamValue<int>("block_size", [](int x) { return x >= 0; }, true,
+      "block size must be nonnegative");
 
   RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star", "x",
       "hilbert-r", "r-plus", "r-plus-plus", "ball" }, true,
@@ -28,6 +28,12 @@ namespace decision_stump {
  * last bin has range up to \infty (split[i + 1] does not exist in that case).
  * Points that are below the first bin will take the label of the first bin.
  *
+ * Training sorts each dimension of the data.  When many stumps are trained on
+ * the same data with different weights, as in boosting, Presort() can sort the
+ * dimensions once: the stumps trained with the boosting constructor from a
+ * presorted stump reuse its order, so that finding their split is linear in the
+ * number of points.
+ *
  * @tparam MatType Type of matrix that is being used (sparse or dense).
  */
 template<typename MatType = arma::mat>
@@ -58,8 +64,12 @@ class DecisionStump
    * @param data The data on which to train this object on.
    * @param labels The labels of data.
    * @param weights Weight vector to use while training. For boosting purposes.
+   *
+   * If other was presorted with Presort() on data (or a matrix of the same
+   * size and contents), its order is used instead of sorting data again.  The
+   * order is not copied into this stump.
    */
-  DecisionStump(const DecisionStump<>& other,
+  DecisionStump(const DecisionStump& other,
                 const MatType& data,
                 const arma::Row<size_t>& labels,
                 const size_t numClasses,
@@ -104,6 +114,29 @@ class DecisionStump
              const size_t numClasses,
              const size_t bucketSize);
 
+  /**
+   * Sort each dimension of the given data once; Train() and the stumps created
+   * from this one with the boosting constructor will then use this order
+   * instead of sorting the data again, as long as they are given a matrix of
+   * the same size (which is assumed to also have the same contents).  The
+   * dimensions are sorted in parallel.  The order takes as much memory as the
+   * data, and is not serialized.
+   *
+   * @param data Dataset that the stumps will be trained on.
+   */
+  void Presort(const MatType& data);
+
+  //! Forget the order computed by Presort().
+  void ClearPresort() { sortedIndices.reset(); }
+
+  //! Get whether the stump has an order computed by Presort() for data of the
+  //! given size.
+  bool Presorted(const MatType& data) const
+  {
+    return sortedIndices.n_rows == data.n_cols &&
+        sortedIndices.n_cols == data.n_rows && data.n_cols > 0;
+  }
+
   /**
    * Classification function. After training, classify test, and put the
    * predicted classes in predictedLabels.
@@ -145,17 +178,21 @@ class DecisionStump
   arma::vec split;
   //! Stores the labels for each splitting bin.
   arma::Col<size_t> binLabels;
+  //! The indices of the points in the sorted order of each dimension (one
+  //! column per dimension), if Presort() was called.
+  arma::Mat<arma::uword> sortedIndices;
 
   /**
    * Sets up dimension as if it were splitting on it and finds entropy when
    * splitting on dimension.
    *
-   * @param dimension A row from the training data, which might be a
-   *     candidate for the splitting dimension.
+   * @param sortedIndices The indices of the points in the sorted order of a
+   *     dimension of the training data, which might be a candidate for the
+   *     splitting dimension.
    * @tparam UseWeights Whether we need to run a weighted Decision Stump.
    */
-  template<bool UseWeights, typename VecType>
-  double SetupSplitDimension(const VecType& dimension,
+  template<bool UseWeights, typename IndexVecType>
+  double SetupSplitDimension(const IndexVecType& sortedIndices,
                              const arma::Row<size_t>& labels,
                              const arma::rowvec& weightD);
 
@@ -163,11 +200,14 @@ class DecisionStump
    * After having decided the dimension on which to split, train on that
    * dimension.
    *
-   * @tparam dimension dimension is the dimension decided by the constructor
+   * @param dimension dimension is the dimension decided by the constructor
    *      on which we now train the decision stump.
+   * @param sortedIndices The indices of the points in the sorted order of the
+   *      dimension.
    */
-  template<typename VecType>
+  template<typename VecType, typename IndexVecType>
   void TrainOnDim(const VecType& dimension,
+                  const IndexVecType& sortedIndices,
                   const arma::Row<size_t>& labels);
 
   /**
@@ -212,13 +252,16 @@ class DecisionStump
    * @param data Dataset to train on.
    * @param labels Labels for dataset.
    * @param weights Weights for this set of labels.
+   * @param order The order computed by Presort() for data, or an empty matrix
+   *      to sort the dimensions.
    * @tparam UseWeights If true, the weights in the weight vector will be used
    *      (otherwise they are ignored).
    */
   template<bool UseWeights>
   void Train(const MatType& data,
              const arma::Row<size_t>& labels,
-             const arma::rowvec& weights);
+             const arma::rowvec& weights,
+             const arma::Mat<arma::uword>& order);
 };
 
 } // namespace decision_stump
@@ -35,7 +35,7 @@ DecisionStump<MatType>::DecisionStump(const MatType& data,
     bucketSize(bucketSize)
 {
   arma::rowvec weights;
-  Train<false>(data, labels, weights);
+  Train<false>(data, labels, weights, arma::Mat<arma::uword>());
 }
 
 /**
@@ -67,7 +67,10 @@ void DecisionStump<MatType>::Train(const MatType& data,
 
   // Pass to unweighted training function.
   arma::rowvec weights;
-  Train<false>(data, labels, weights);
+  if (Presorted(data))
+    Train<false>(data, labels, weights, sortedIndices);
+  else
+    Train<false>(data, labels, weights, arma::Mat<arma::uword>());
 }
 
 /**
@@ -86,7 +89,10 @@ void DecisionStump<MatType>::Train(const MatType& data,
   this->bucketSize = bucketSize;
 
   // Pass to weighted training function.
-  Train<true>(data, labels, weights);
+  if (Presorted(data))
+    Train<true>(data, labels, weights, sortedIndices);
+  else
+    Train<true>(data, labels, weights, arma::Mat<arma::uword>());
 }
 
 /**
@@ -94,30 +100,60 @@ void DecisionStump<MatType>::Train(const MatType& data,
  *
  * @param data Dataset to train on.
  * @param labels Labels for dataset.
+ * @param order The order computed by Presort(), or an empty matrix.
  * @param UseWeights Whether we need to run a weighted Decision Stump.
  */
 template<typename MatType>
 template<bool UseWeights>
 void DecisionStump<MatType>::Train(const MatType& data,
                                    const arma::Row<size_t>& labels,
-                                   const arma::rowvec& weights)
+                                   const arma::rowvec& weights,
+                                   const arma::Mat<arma::uword>& order)
 {
+  const bool presorted = (order.n_rows == data.n_cols &&
+      order.n_cols == data.n_rows);
+
   // If classLabels are not all identical, proceed with training.
   size_t bestDim = 0;
-  double entropy;
   const double rootEntropy = CalculateEntropy<UseWeights>(labels, weights);
 
-  double gain, bestGain = 0.0;
-  for (size_t i = 0; i < data.n_rows; i++)
+  // Calculate the entropy of a split on each dimension in parallel.  Only the
+  // members of the stump are read, so the dimensions are independent.
+  std::vector<double> entropies(data.n_rows);
+  std::vector<char> distinct(data.n_rows);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; i++)
   {
     // Go through each dimension of the data.
-    if (IsDistinct(data.row(i)))
+    distinct[i] = IsDistinct(data.row(i));
+    if (distinct[i])
     {
       // For each dimension with non-identical values, treat it as a potential
-      // splitting dimension and calculate entropy if split on it.
-      entropy = SetupSplitDimension<UseWeights>(data.row(i), labels, weights);
+      // splitting dimension and calculate entropy if split on it.  This sort
+      // is stable.
+      if (presorted)
+      {
+        entropies[i] = SetupSplitDimension<UseWeights>(order.col(i), labels,
+            weights);
+      }
+      else
+      {
+        const arma::uvec sortedIndexDim =
+            arma::stable_sort_index(data.row(i).t());
+        entropies[i] = SetupSplitDimension<UseWeights>(sortedIndexDim, labels,
+            weights);
+      }
+    }
+  }
 
-      gain = rootEntropy - entropy;
+  // Take the best dimension in order, so that the split does not depend on the
+  // number of threads.
+  double gain, bestGain = 0.0;
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    if (distinct[i])
+    {
+      gain = rootEntropy - entropies[i];
       // Find the dimension with the best entropy so that the gain is
       // maximized.
 
@@ -133,7 +169,16 @@ void DecisionStump<MatType>::Train(const MatType& data,
   splitDimension = bestDim;
 
   // Once the splitting column/dimension has been decided, train on it.
-  TrainOnDim(data.row(splitDimension), labels);
+  if (presorted)
+  {
+    TrainOnDim(data.row(splitDimension), order.col(splitDimension), labels);
+  }
+  else
+  {
+    const arma::uvec sortedIndexDim =
+        arma::stable_sort_index(data.row(splitDimension).t());
+    TrainOnDim(data.row(splitDimension), sortedIndexDim, labels);
+  }
 }
 
 /**
@@ -182,7 +227,7 @@ void DecisionStump<MatType>::Classify(const MatType& test,
  * @param UseWeights Whether we need to run a weighted Decision Stump.
  */
 template<typename MatType>
-DecisionStump<MatType>::DecisionStump(const DecisionStump<>& other,
+DecisionStump<MatType>::DecisionStump(const DecisionStump& other,
                                       const MatType& data,
                                       const arma::Row<size_t>& labels,
                                       const size_t numClasses,
@@ -190,7 +235,24 @@ DecisionStump<MatType>::DecisionStump(const DecisionStump<>& other,
     numClasses(numClasses),
     bucketSize(other.bucketSize)
 {
-  Train<true>(data, labels, weights);
+  if (other.Presorted(data))
+    Train<true>(data, labels, weights, other.sortedIndices);
+  else
+    Train<true>(data, labels, weights, arma::Mat<arma::uword>());
+}
+
+/**
+ * Sort each dimension of the data once, for the following trainings.
+ */
+template<typename MatType>
+void DecisionStump<MatType>::Presort(const MatType& data)
+{
+  sortedIndices.set_size(data.n_cols, data.n_rows);
+
+  // The dimensions are independent.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; i++)
+    sortedIndices.col(i) = arma::stable_sort_index(data.row(i).t());
 }
 
 /**
@@ -214,28 +276,27 @@ void DecisionStump<MatType>::serialize(Archive& ar,
  * Sets up dimension as if it were splitting on it and finds entropy when
  * splitting on dimension.
  *
- * @param dimension A row from the training data, which might be a candidate for
- *      the splitting dimension.
+ * @param sortedIndexDim The indices of the points in the sorted order of a row
+ *      from the training data, which might be a candidate for the splitting
+ *      dimension.
  * @param UseWeights Whether we need to run a weighted Decision Stump.
  */
 template<typename MatType>
-template<bool UseWeights, typename VecType>
+template<bool UseWeights, typename IndexVecType>
 double DecisionStump<MatType>::SetupSplitDimension(
-    const VecType& dimension,
+    const IndexVecType& sortedIndexDim,
     const arma::Row<size_t>& labels,
     const arma::rowvec& weights)
 {
   size_t i, count, begin, end;
   double entropy = 0.0;
 
-  // Store the indices of the sorted dimension to build a vector of sorted
-  // labels.  This sort is stable.
-  arma::uvec sortedIndexDim = arma::stable_sort_index(dimension.t());
+  // Use the indices of the sorted dimension to build a vector of sorted
+  // labels.
+  arma::Row<size_t> sortedLabels(sortedIndexDim.n_elem);
+  arma::rowvec sortedWeights(sortedIndexDim.n_elem);
 
-  arma::Row<size_t> sortedLabels(dimension.n_elem);
-  arma::rowvec sortedWeights(dimension.n_elem);
-
-  for (i = 0; i < dimension.n_elem; i++)
+  for (i = 0; i < sortedIndexDim.n_elem; i++)
   {
     sortedLabels(i) = labels(sortedIndexDim(i));
 
@@ -307,16 +368,17 @@ double DecisionStump<MatType>::SetupSplitDimension(
  *
  * @param dimension Dimension is the dimension decided by the constructor on
  *      which we now train the decision stump.
+ * @param sortedSplitIndexDim The indices of the points in the sorted order of
+ *      the dimension.
  */
 template<typename MatType>
-template<typename VecType>
+template<typename VecType, typename IndexVecType>
 void DecisionStump<MatType>::TrainOnDim(const VecType& dimension,
+                                        const IndexVecType& sortedSplitIndexDim,
                                         const arma::Row<size_t>& labels)
 {
   size_t i, count, begin, end;
 
-  typename MatType::row_type sortedSplitDim = arma::sort(dimension);
-  arma::uvec sortedSplitIndexDim = arma::stable_sort_index(dimension.t());
   arma::Row<size_t> sortedLabels(dimension.n_elem);
   sortedLabels.fill(0);
 
@@ -338,7 +400,7 @@ void DecisionStump<MatType>::TrainOnDim(const VecType& dimension,
       mostFreq = CountMostFreq(sortedLabels.cols(begin, end));
 
       split.resize(split.n_elem + 1);
-      split(split.n_elem - 1) = sortedSplitDim(begin);
+      split(split.n_elem - 1) = dimension(sortedSplitIndexDim(begin));
       binLabels.resize(binLabels.n_elem + 1);
       binLabels(binLabels.n_elem - 1) = mostFreq;
 
@@ -366,7 +428,7 @@ void DecisionStump<MatType>::TrainOnDim(const VecType& dimension,
       mostFreq = CountMostFreq(sortedLabels.cols(begin, end));
 
       split.resize(split.n_elem + 1);
-      split(split.n_elem - 1) = sortedSplitDim(begin);
+      split(split.n_elem - 1) = dimension(sortedSplitIndexDim(begin));
       binLabels.resize(binLabels.n_elem + 1);
       binLabels(binLabels.n_elem - 1) = mostFreq;
 
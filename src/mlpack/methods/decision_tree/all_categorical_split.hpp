@@ -41,7 +41,8 @@ class AllCategoricalSplit
    *
    * @param bestGain Best gain seen so far (we'll only split if we find gain
    *      better than this).
-   * @param data The dimension of data points to check for a split in.
+   * @param data The dimension of data points to check for a split in (the
+   *      mapped categories, as floating-point values or as integer codes).
    * @param numCategories Number of categories in the categorical data.
    * @param labels Labels for each point.
    * @param numClasses Number of classes in the dataset.
@@ -52,7 +53,10 @@ class AllCategoricalSplit
    * @param aux Auxiliary split information, which may be modified on a
    *      successful split.
    */
-  template<bool UseWeights, typename VecType, typename WeightVecType>
+  template<bool UseWeights,
+           typename VecType,
+           typename WeightVecType,
+           typename ElemType>
   static double SplitIfBetter(
       const double bestGain,
       const VecType& data,
@@ -62,8 +66,8 @@ class AllCategoricalSplit
       const WeightVecType& weights,
       const size_t minimumLeafSize,
       const double minimumGainSplit,
-      arma::Col<typename VecType::elem_type>& classProbabilities,
-      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+      arma::Col<ElemType>& classProbabilities,
+      AuxiliarySplitInfo<ElemType>& aux);
 
   /**
    * Return the number of children in the split.
@@ -62,6 +62,46 @@ class BestBinaryNumericSplit
       arma::Col<typename VecType::elem_type>& classProbabilities,
       AuxiliarySplitInfo<typename VecType::elem_type>& aux);
 
+  /**
+   * Check if we can split a node, like SplitIfBetter(), but given the points
+   * of the node in ascending order of their values in the dimension, so that
+   * the data does not have to be sorted again.  The class counts are updated
+   * one point at a time, so each dimension is searched in linear time.
+   * DecisionTree uses this when it is trained with presorted indices.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of all of the data points.
+   * @param sortedIndices Indices of the points of the node in data, sorted in
+   *      ascending order of their values.
+   * @param labels Labels for all of the points.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights for all of the points (ignored if UseWeights is
+   *      false).
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights,
+           typename RowType,
+           typename IndicesType,
+           typename WeightVecType>
+  static double SplitIfBetterSorted(
+      const double bestGain,
+      const RowType& data,
+      const IndicesType& sortedIndices,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename RowType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename RowType::elem_type>& aux);
+
   /**
    * Returns 2, since the binary split always has two children.
    */
@@ -86,6 +126,23 @@ class BestBinaryNumericSplit
       const AuxiliarySplitInfo<ElemType>& /* aux */);
 };
 
+/**
+ * SupportsPresortedSplit holds whether the given numeric split type provides
+ * SplitIfBetterSorted(), so that DecisionTree can be trained with presorted
+ * indices.  Only BestBinaryNumericSplit does.
+ */
+template<typename NumericSplitType>
+struct SupportsPresortedSplit
+{
+  static const bool value = false;
+};
+
+template<typename FitnessFunction>
+struct SupportsPresortedSplit<BestBinaryNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
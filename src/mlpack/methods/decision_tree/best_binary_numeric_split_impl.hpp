@@ -118,6 +118,89 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   return bestFoundGain;
 }
 
+template<typename FitnessFunction>
+template<bool UseWeights,
+         typename RowType,
+         typename IndicesType,
+         typename WeightVecType>
+double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetterSorted(
+    const double bestGain,
+    const RowType& data,
+    const IndicesType& sortedIndices,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename RowType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename RowType::elem_type>& /* aux */)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  const size_t n = sortedIndices.n_elem;
+  if (n < (minimumLeafSize * 2) || n < 2)
+    return bestGain;
+
+  // Collect the class counts (or weights) of all of the points; the points
+  // will then be moved to the left child one at a time.
+  arma::vec totalCounts(numClasses, arma::fill::zeros);
+  for (size_t i = 0; i < n; ++i)
+  {
+    totalCounts[labels[sortedIndices[i]]] += UseWeights ?
+        double(weights[sortedIndices[i]]) : 1.0;
+  }
+  const double totalWeight = UseWeights ? arma::accu(totalCounts) : double(n);
+  if (totalWeight <= 0.0)
+    return bestGain;
+
+  // Loop through all possible split points, choosing the best one.  Also, force
+  // a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = bestGain;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  arma::vec rightCounts(numClasses);
+  double leftWeight = 0.0;
+  for (size_t index = 1; index < n - (minimum - 1); ++index)
+  {
+    // Move the previous point to the left child.
+    const size_t previous = sortedIndices[index - 1];
+    const double weight = UseWeights ? double(weights[previous]) : 1.0;
+    leftCounts[labels[previous]] += weight;
+    leftWeight += weight;
+
+    // Make sure that the left child is big enough and that the value has
+    // changed.
+    if (index < minimum || data[sortedIndices[index]] == data[previous])
+      continue;
+
+    // Calculate the gain of the left and right child from the counts.
+    rightCounts = totalCounts - leftCounts;
+    const double rightWeight = totalWeight - leftWeight;
+    const double leftGain = FitnessFunction::EvaluateCounts(leftCounts,
+        leftWeight);
+    const double rightGain = FitnessFunction::EvaluateCounts(rightCounts,
+        rightWeight);
+    const double gain = (leftWeight / totalWeight) * leftGain +
+        (rightWeight / totalWeight) * rightGain;
+
+    if (gain >= 0.0 || gain > bestFoundGain + minimumGainSplit)
+    {
+      // The actual split value will be halfway between the value at index - 1
+      // and index.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (data[previous] + data[sortedIndices[index]]) /
+          2.0;
+
+      // Corner case: no split will be better than this, so just take it.
+      if (gain >= 0.0)
+        return gain;
+
+      bestFoundGain = gain;
+    }
+  }
+
+  return bestFoundGain;
+}
+
 template<typename FitnessFunction>
 template<typename ElemType>
 size_t BestBinaryNumericSplit<FitnessFunction>::CalculateDirection(
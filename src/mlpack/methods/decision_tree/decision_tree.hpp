@@ -14,6 +14,8 @@
 #define MLPACK_METHODS_DECISION_TREE_DECISION_TREE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/compact_storage.hpp>
+#include <mlpack/core/data/mixed_dataset.hpp>
 #include "gini_gain.hpp"
 #include "best_binary_numeric_split.hpp"
 #include "all_categorical_split.hpp"
@@ -29,6 +31,15 @@ namespace tree {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * When OpenMP is available, the dimensions of each node are searched in
+ * parallel, and once the top of the tree is split, the smaller subtrees below
+ * it are trained in parallel (unless the dimensions are selected randomly).
+ * The tree does not depend on the number of threads.
+ *
+ * With a DatasetInfo, the tree can also be trained on a data::MixedDataset,
+ * whose categorical dimensions are stored as small integer codes that the
+ * categorical split reads directly.
  */
 template<typename FitnessFunction = GiniGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -219,13 +230,18 @@ class DecisionTree :
    * @param weights Weights of all the labels
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
+   * @param presort If true, sort each dimension once at the root and keep the
+   *      sorted order of the points as the nodes split, instead of sorting the
+   *      points of every node again.  The splits are the same, but the
+   *      NumericSplitType must support it (see SupportsPresortedSplit).
    */
   template<typename MatType, typename LabelsType>
   void Train(MatType&& data,
              LabelsType&& labels,
              const size_t numClasses,
              const size_t minimumLeafSize = 10,
-             const double minimumGainSplit = 1e-7);
+             const double minimumGainSplit = 1e-7,
+             const bool presort = false);
 
   /**
    * Train the decision tree on the given weighted data.  This will overwrite
@@ -265,6 +281,10 @@ class DecisionTree :
    * @param weights Weights of all the labels
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
+   * @param presort If true, sort each dimension once at the root and keep the
+   *      sorted order of the points as the nodes split, instead of sorting the
+   *      points of every node again.  The splits are the same, but the
+   *      NumericSplitType must support it (see SupportsPresortedSplit).
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
   void Train(MatType&& data,
@@ -273,6 +293,7 @@ class DecisionTree :
              WeightsType&& weights,
              const size_t minimumLeafSize = 10,
              const double minimumGainSplit = 1e-7,
+             const bool presort = false,
              const std::enable_if_t<arma::is_arma_type<typename
                  std::remove_reference<WeightsType>::type>::value>* = 0);
 
@@ -339,6 +360,19 @@ class DecisionTree :
   //! Modify the child of the given index (be careful!).
   DecisionTree& Child(const size_t i) { return *children[i]; }
 
+  //! Get the dimension this node splits on (only meaningful if it has
+  //! children).
+  size_t SplitDimension() const { return splitDimension; }
+  //! Get the data::Datatype of the split dimension if this node has children,
+  //! or the majority class if it is a leaf.
+  size_t DimensionTypeOrMajorityClass() const
+  {
+    return dimensionTypeOrMajorityClass;
+  }
+  //! Get the class probabilities if this node is a leaf, or the split
+  //! information of the split types otherwise.
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -379,6 +413,58 @@ class DecisionTree :
   typedef typename CategoricalSplit::template AuxiliarySplitInfo<ElemType>
       CategoricalAuxiliarySplitInfo;
 
+  //! A subtree whose training is deferred, so that it can be trained in
+  //! parallel with the other deferred subtrees.
+  struct SubtreeTask
+  {
+    //! The root of the subtree.
+    DecisionTree* node;
+    //! Index of the first point of the subtree.
+    size_t begin;
+    //! Number of points in the subtree.
+    size_t count;
+    //! Minimum number of points in each leaf of the subtree.
+    size_t minimumLeafSize;
+  };
+
+  //! The subtrees deferred while the top of a tree is built.
+  struct SubtreeTasks
+  {
+    //! The deferred subtrees.
+    std::vector<SubtreeTask> tasks;
+    //! Subtrees with at most this many points are deferred.
+    size_t taskSize;
+  };
+
+  /**
+   * Return whether a tree with the given number of points should be built with
+   * all threads, and if so, set the number of points under which subtrees are
+   * deferred to be trained in parallel.  The top of the tree is then split
+   * first, searching the dimensions of each node in parallel.
+   *
+   * @param count Number of points in the tree.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param taskSize Set to the maximum number of points of deferred subtrees.
+   */
+  static bool BuildInParallel(const size_t count,
+                              const size_t minimumLeafSize,
+                              size_t& taskSize);
+
+  /**
+   * Return the dimension to split on, given the gain of the best split found in
+   * each dimension when it is searched against the gain of the unsplit node.
+   * The dimensions are considered in order, as if they were searched one after
+   * another, so that the split does not depend on the number of threads.  If
+   * no dimension improves on the node, gains.n_elem is returned.
+   *
+   * @param gain Gain of the unsplit node.
+   * @param gains Gain of the split found in each dimension.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   */
+  static size_t BestDimension(const double gain,
+                              const arma::vec& gains,
+                              const double minimumGainSplit);
+
   /**
    * Calculate the class probabilities of the given labels.
    */
@@ -387,6 +473,69 @@ class DecisionTree :
                                    const size_t numClasses,
                                    const WeightsRowType& weights);
 
+  //! Get the values of the points begin to begin + count - 1 in the given
+  //! numeric dimension of a matrix.
+  template<typename MatType>
+  static auto NumericValues(const MatType& data,
+                              const size_t dimension,
+                              const size_t begin,
+                              const size_t count)
+      -> decltype(data.cols(begin, begin + count - 1).row(dimension))
+  {
+    return data.cols(begin, begin + count - 1).row(dimension);
+  }
+
+  //! Get the values of the points begin to begin + count - 1 in the given
+  //! numeric dimension of a MixedDataset of doubles.
+  template<typename CodeType>
+  static arma::subview_row<double> NumericValues(
+      const data::MixedDataset<double, CodeType>& data,
+      const size_t dimension,
+      const size_t begin,
+      const size_t count)
+  {
+    return data.Numeric().row(data.Row(dimension)).cols(begin,
+        begin + count - 1);
+  }
+
+  //! Get the values of the points begin to begin + count - 1 in the given
+  //! numeric dimension of a MixedDataset of another type, as doubles.
+  template<typename NumericType, typename CodeType>
+  static arma::rowvec NumericValues(
+      const data::MixedDataset<NumericType, CodeType>& data,
+      const size_t dimension,
+      const size_t begin,
+      const size_t count)
+  {
+    return arma::conv_to<arma::rowvec>::from(data.Numeric().row(
+        data.Row(dimension)).cols(begin, begin + count - 1));
+  }
+
+  //! Get the values of the points begin to begin + count - 1 in the given
+  //! categorical dimension of a matrix.
+  template<typename MatType>
+  static auto CategoricalValues(const MatType& data,
+                                const size_t dimension,
+                                const size_t begin,
+                                const size_t count)
+      -> decltype(data.cols(begin, begin + count - 1).row(dimension))
+  {
+    return data.cols(begin, begin + count - 1).row(dimension);
+  }
+
+  //! Get the codes of the points begin to begin + count - 1 in the given
+  //! categorical dimension of a MixedDataset.
+  template<typename NumericType, typename CodeType>
+  static arma::subview_row<CodeType> CategoricalValues(
+      const data::MixedDataset<NumericType, CodeType>& data,
+      const size_t dimension,
+      const size_t begin,
+      const size_t count)
+  {
+    return data.Codes().row(data.Row(dimension)).cols(begin,
+        begin + count - 1);
+  }
+
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This function is called to
@@ -401,6 +550,8 @@ class DecisionTree :
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
+   * @param subtrees If not NULL, subtrees small enough are deferred here
+   *      instead of being trained.
    */
   template<bool UseWeights, typename MatType>
   void Train(MatType& data,
@@ -411,7 +562,8 @@ class DecisionTree :
              const size_t numClasses,
              arma::rowvec& weights,
              const size_t minimumLeafSize = 10,
-             const double minimumGainSplit = 1e-7);
+             const double minimumGainSplit = 1e-7,
+             SubtreeTasks* subtrees = NULL);
 
   /**
    * Corresponding to the public Train() method, this method is designed for
@@ -426,6 +578,8 @@ class DecisionTree :
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
+   * @param subtrees If not NULL, subtrees small enough are deferred here
+   *      instead of being trained.
    */
   template<bool UseWeights, typename MatType>
   void Train(MatType& data,
@@ -435,7 +589,74 @@ class DecisionTree :
              const size_t numClasses,
              arma::rowvec& weights,
              const size_t minimumLeafSize = 10,
-             const double minimumGainSplit = 1e-7);
+             const double minimumGainSplit = 1e-7,
+             SubtreeTasks* subtrees = NULL);
+
+  /**
+   * Sort each dimension of the data, and train the tree with presorted
+   * indices.  This overload is used when the NumericSplitType supports it.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels (ignored if UseWeights is false).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   */
+  template<bool UseWeights, typename MatType>
+  void PresortAndTrain(MatType& data,
+                       arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       arma::rowvec& weights,
+                       const size_t minimumLeafSize,
+                       const double minimumGainSplit,
+                       const std::true_type& /* supported */);
+
+  /**
+   * Throw an exception, since the NumericSplitType cannot be used with
+   * presorted indices.
+   */
+  template<bool UseWeights, typename MatType>
+  void PresortAndTrain(MatType& data,
+                       arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       arma::rowvec& weights,
+                       const size_t minimumLeafSize,
+                       const double minimumGainSplit,
+                       const std::false_type& /* supported */);
+
+  /**
+   * Train the node with presorted indices, assuming all dimensions are
+   * numeric.  Row i of sortedIndices holds the indices of the points in
+   * ascending order of dimension i, and the points of each node are the
+   * contiguous columns begin to begin + count - 1 of data and sortedIndices.
+   * When the node splits, the points of each child are moved together while
+   * keeping their order, so that every child is still sorted.
+   *
+   * @param data Dataset to train on.
+   * @param begin Index of the starting point in the dataset that belongs to
+   *      this node.
+   * @param count Number of points in this node.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels (ignored if UseWeights is false).
+   * @param sortedIndices Sorted indices of the points in each dimension.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param subtrees If not NULL, subtrees small enough are deferred here
+   *      instead of being trained.
+   */
+  template<bool UseWeights, typename MatType>
+  void TrainPresorted(MatType& data,
+                      const size_t begin,
+                      const size_t count,
+                      arma::Row<size_t>& labels,
+                      const size_t numClasses,
+                      arma::rowvec& weights,
+                      arma::umat& sortedIndices,
+                      const size_t minimumLeafSize,
+                      const double minimumGainSplit,
+                      SubtreeTasks* subtrees = NULL);
 };
 
 /**
@@ -456,6 +677,17 @@ using DecisionStump = DecisionTree<FitnessFunction,
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the DecisionTree class.
+BOOST_TEMPLATE_CLASS_VERSION(SINGLE_ARG(template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename DimensionSelectionType,
+    typename ElemType,
+    bool NoRecursion>),
+    SINGLE_ARG(mlpack::tree::DecisionTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DimensionSelectionType, ElemType, NoRecursion>), 1);
+
 // Include implementation.
 #include "decision_tree_impl.hpp"
 
@@ -392,7 +392,8 @@ void DecisionTree<FitnessFunction,
                                       LabelsType&& labels,
                                       const size_t numClasses,
                                       const size_t minimumLeafSize,
-                                      const double minimumGainSplit)
+                                      const double minimumGainSplit,
+                                      const bool presort)
 {
   // Sanity check on data.
   if (data.n_cols != labels.n_elem)
@@ -413,8 +414,17 @@ void DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
-      minimumLeafSize, minimumGainSplit);
+  if (presort)
+  {
+    PresortAndTrain<false>(tmpData, tmpLabels, numClasses, weights,
+        minimumLeafSize, minimumGainSplit, std::integral_constant<bool,
+        SupportsPresortedSplit<NumericSplit>::value>());
+  }
+  else
+  {
+    Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
+        minimumLeafSize, minimumGainSplit);
+  }
 }
 
 //! Train on the given weighted data.
@@ -484,6 +494,7 @@ void DecisionTree<FitnessFunction,
                                       WeightsType&& weights,
                                       const size_t minimumLeafSize,
                                       const double minimumGainSplit,
+                                      const bool presort,
                                       const std::enable_if_t<arma::is_arma_type<
                                           typename std::remove_reference<
                                           WeightsType>::type>::value>*)
@@ -508,8 +519,17 @@ void DecisionTree<FitnessFunction,
   TrueWeightsType tmpWeights(std::forward<WeightsType>(weights));
 
   // Pass off work to the Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
-      minimumLeafSize, minimumGainSplit);
+  if (presort)
+  {
+    PresortAndTrain<true>(tmpData, tmpLabels, numClasses, tmpWeights,
+        minimumLeafSize, minimumGainSplit, std::integral_constant<bool,
+        SupportsPresortedSplit<NumericSplit>::value>());
+  }
+  else
+  {
+    Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
+        minimumLeafSize, minimumGainSplit);
+  }
 }
 
 //! Train on the given data.
@@ -533,64 +553,99 @@ void DecisionTree<FitnessFunction,
                                       const size_t numClasses,
                                       arma::rowvec& weights,
                                       const size_t minimumLeafSize,
-                                      const double minimumGainSplit)
+                                      const double minimumGainSplit,
+                                      SubtreeTasks* subtrees)
 {
+  // If the tree is large enough, build it with all threads: the top of the
+  // tree is split first, and the subtrees below it are then trained in
+  // parallel.  The subtrees hold disjoint ranges of points, so the tree does
+  // not depend on the number of threads.  Randomly selected dimensions would
+  // depend on the order the subtrees are trained in, so they are excluded.
+  size_t taskSize;
+  if (!subtrees &&
+      std::is_same<DimensionSelectionType, AllDimensionSelect>::value &&
+      BuildInParallel(count, minimumLeafSize, taskSize))
+  {
+    SubtreeTasks topSubtrees;
+    topSubtrees.taskSize = taskSize;
+    Train<UseWeights>(data, begin, count, datasetInfo, labels, numClasses,
+        weights, minimumLeafSize, minimumGainSplit, &topSubtrees);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) topSubtrees.tasks.size(); ++i)
+    {
+      const SubtreeTask& task = topSubtrees.tasks[i];
+      task.node->Train<UseWeights>(data, task.begin, task.count, datasetInfo,
+          labels, numClasses, weights, task.minimumLeafSize, minimumGainSplit);
+    }
+    return;
+  }
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
 
   // Look through the list of dimensions and obtain the gain of the best split.
-  // We'll cache the best numeric and categorical split auxiliary information in
-  // numericAux and categoricalAux (and clear them later if we make no split),
-  // and use classProbabilities as auxiliary information.  Later we'll overwrite
-  // classProbabilities to the empirical class probabilities if we do not split.
-  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
+  // Each dimension is searched in parallel against the gain of the unsplit
+  // node, with its own split information, and the best one is chosen
+  // afterwards.  Its split information is then kept in classProbabilities and
+  // the auxiliary split information.  Later we'll overwrite classProbabilities
+  // to the empirical class probabilities if we do not split.
+  const double gain = FitnessFunction::template Evaluate<UseWeights>(
       labels.subvec(begin, begin + count - 1),
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
-  DimensionSelectionType dimensions(datasetInfo.Dimensionality());
-  for (size_t i = dimensions.Begin(); i != dimensions.End();
-       i = dimensions.Next())
+  std::vector<size_t> dimensions;
+  DimensionSelectionType selection(datasetInfo.Dimensionality());
+  for (size_t i = selection.Begin(); i != selection.End();
+       i = selection.Next())
+    dimensions.push_back(i);
+
+  arma::vec gains(dimensions.size());
+  std::vector<arma::vec> dimensionProbabilities(dimensions.size());
+  std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+  std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(dimensions.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
   {
-    double dimGain = -DBL_MAX;
+    const size_t i = dimensions[d];
+    gains[d] = -DBL_MAX;
     if (datasetInfo.Type(i) == data::Datatype::categorical)
     {
-      dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-          data.cols(begin, begin + count - 1).row(i),
+      gains[d] = CategoricalSplit::template SplitIfBetter<UseWeights>(gain,
+          CategoricalValues(data, i, begin, count),
           datasetInfo.NumMappings(i),
           labels.subvec(begin, begin + count - 1),
           numClasses,
           UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
           minimumLeafSize,
           minimumGainSplit,
-          classProbabilities,
-          *this);
+          dimensionProbabilities[d],
+          categoricalAux[d]);
     }
     else if (datasetInfo.Type(i) == data::Datatype::numeric)
     {
-      dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-          data.cols(begin, begin + count - 1).row(i),
+      gains[d] = NumericSplit::template SplitIfBetter<UseWeights>(gain,
+          NumericValues(data, i, begin, count),
           labels.subvec(begin, begin + count - 1),
           numClasses,
           UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
           minimumLeafSize,
           minimumGainSplit,
-          classProbabilities,
-          *this);
-    }
-
-    // Was there an improvement?  If so mark that it's the new best dimension.
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
+          dimensionProbabilities[d],
+          numericAux[d]);
     }
+  }
 
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
+  size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
+  const size_t best = BestDimension(gain, gains, minimumGainSplit);
+  if (best != dimensions.size())
+  {
+    bestDim = dimensions[best];
+    classProbabilities = dimensionProbabilities[best];
+    NumericAuxiliarySplitInfo::operator=(numericAux[best]);
+    CategoricalAuxiliarySplitInfo::operator=(categoricalAux[best]);
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -646,19 +701,21 @@ void DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
+      // Now build the child recursively, or defer it if it is small enough.
       DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
+      const size_t childCount = currentCol - currentChildBegin;
+      const size_t childLeafSize = NoRecursion ? childCount : minimumLeafSize;
+      if (subtrees && childCount <= subtrees->taskSize)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit);
+        const SubtreeTask task = { child, currentChildBegin, childCount,
+            childLeafSize };
+        subtrees->tasks.push_back(task);
       }
       else
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit);
+        child->Train<UseWeights>(data, currentChildBegin, childCount,
+            datasetInfo, labels, numClasses, weights, childLeafSize,
+            minimumGainSplit, subtrees);
       }
       children.push_back(child);
     }
@@ -697,8 +754,31 @@ void DecisionTree<FitnessFunction,
                                       const size_t numClasses,
                                       arma::rowvec& weights,
                                       const size_t minimumLeafSize,
-                                      const double minimumGainSplit)
+                                      const double minimumGainSplit,
+                                      SubtreeTasks* subtrees)
 {
+  // If the tree is large enough, build it with all threads: the top of the
+  // tree is split first, and the subtrees below it are then trained in
+  // parallel.  The subtrees hold disjoint ranges of points, so the tree does
+  // not depend on the number of threads.
+  size_t taskSize;
+  if (!subtrees && BuildInParallel(count, minimumLeafSize, taskSize))
+  {
+    SubtreeTasks topSubtrees;
+    topSubtrees.taskSize = taskSize;
+    Train<UseWeights>(data, begin, count, labels, numClasses, weights,
+        minimumLeafSize, minimumGainSplit, &topSubtrees);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) topSubtrees.tasks.size(); ++i)
+    {
+      const SubtreeTask& task = topSubtrees.tasks[i];
+      task.node->Train<UseWeights>(data, task.begin, task.count, labels,
+          numClasses, weights, task.minimumLeafSize, minimumGainSplit);
+    }
+    return;
+  }
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -707,20 +787,24 @@ void DecisionTree<FitnessFunction,
   // We won't be using these members, so reset them.
   CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
 
-  // Look through the list of dimensions and obtain the best split.  We'll cache
-  // the best numeric split auxiliary information in numericAux (and clear it
-  // later if we don't make a split), and use classProbabilities as auxiliary
-  // information.  Later we'll overwrite classProbabilities to the empirical
-  // class probabilities if we do not split.
-  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
+  // Look through the list of dimensions and obtain the best split.  Each
+  // dimension is searched in parallel against the gain of the unsplit node,
+  // with its own split information, and the best one is chosen afterwards.
+  // Its split information is then kept in classProbabilities and the numeric
+  // auxiliary split information.  Later we'll overwrite classProbabilities to
+  // the empirical class probabilities if we do not split.
+  const double gain = FitnessFunction::template Evaluate<UseWeights>(
       labels.subvec(begin, begin + count - 1),
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = data.n_rows; // This means "no split".
-  for (size_t i = 0; i < data.n_rows; ++i)
+  arma::vec gains(data.n_rows);
+  std::vector<arma::vec> dimensionProbabilities(data.n_rows);
+  std::vector<NumericAuxiliarySplitInfo> numericAux(data.n_rows);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; ++i)
   {
-    const double dimGain = NumericSplitType<FitnessFunction>::template
-        SplitIfBetter<UseWeights>(bestGain,
+    gains[i] = NumericSplitType<FitnessFunction>::template
+        SplitIfBetter<UseWeights>(gain,
                                   data.cols(begin, begin + count - 1).row(i),
                                   labels.cols(begin, begin + count - 1),
                                   numClasses,
@@ -729,18 +813,16 @@ void DecisionTree<FitnessFunction,
                                       weights,
                                   minimumLeafSize,
                                   minimumGainSplit,
-                                  classProbabilities,
-                                  *this);
-
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
-    }
+                                  dimensionProbabilities[i],
+                                  numericAux[i]);
+  }
 
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
+  // data.n_rows means "no split".
+  const size_t bestDim = BestDimension(gain, gains, minimumGainSplit);
+  if (bestDim != data.n_rows)
+  {
+    classProbabilities = dimensionProbabilities[bestDim];
+    NumericAuxiliarySplitInfo::operator=(numericAux[bestDim]);
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -783,19 +865,20 @@ void DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
+      // Now build the child recursively, or defer it if it is small enough.
       DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
+      const size_t childCount = currentCol - currentChildBegin;
+      const size_t childLeafSize = NoRecursion ? childCount : minimumLeafSize;
+      if (subtrees && childCount <= subtrees->taskSize)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit);
+        const SubtreeTask task = { child, currentChildBegin, childCount,
+            childLeafSize };
+        subtrees->tasks.push_back(task);
       }
       else
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit);
+        child->Train<UseWeights>(data, currentChildBegin, childCount, labels,
+            numClasses, weights, childLeafSize, minimumGainSplit, subtrees);
       }
       children.push_back(child);
     }
@@ -813,6 +896,316 @@ void DecisionTree<FitnessFunction,
   }
 }
 
+//! Sort each dimension, and train with presorted indices.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::PresortAndTrain(
+    MatType& data,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const std::true_type& /* supported */)
+{
+  // Each dimension is only sorted once, here.  The sort is stable so that the
+  // order of equal values does not depend on the number of threads.
+  arma::umat sortedIndices(data.n_rows, data.n_cols);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; ++i)
+    sortedIndices.row(i) = arma::stable_sort_index(data.row(i)).t();
+
+  TrainPresorted<UseWeights>(data, 0, data.n_cols, labels, numClasses, weights,
+      sortedIndices, minimumLeafSize, minimumGainSplit);
+}
+
+//! Presorted training is not supported by the numeric split type.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::PresortAndTrain(
+    MatType& /* data */,
+    arma::Row<size_t>& /* labels */,
+    const size_t /* numClasses */,
+    arma::rowvec& /* weights */,
+    const size_t /* minimumLeafSize */,
+    const double /* minimumGainSplit */,
+    const std::false_type& /* supported */)
+{
+  throw std::invalid_argument("DecisionTree::Train(): the numeric split type "
+      "does not support presorted training; use BestBinaryNumericSplit!");
+}
+
+//! Train with presorted indices, assuming all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::TrainPresorted(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    arma::umat& sortedIndices,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    SubtreeTasks* subtrees)
+{
+  // If the tree is large enough, build it with all threads, as in Train().
+  size_t taskSize;
+  if (!subtrees && BuildInParallel(count, minimumLeafSize, taskSize))
+  {
+    SubtreeTasks topSubtrees;
+    topSubtrees.taskSize = taskSize;
+    TrainPresorted<UseWeights>(data, begin, count, labels, numClasses, weights,
+        sortedIndices, minimumLeafSize, minimumGainSplit, &topSubtrees);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) topSubtrees.tasks.size(); ++i)
+    {
+      const SubtreeTask& task = topSubtrees.tasks[i];
+      task.node->TrainPresorted<UseWeights>(data, task.begin, task.count,
+          labels, numClasses, weights, sortedIndices, task.minimumLeafSize,
+          minimumGainSplit);
+    }
+    return;
+  }
+
+  // Clear children if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // We won't be using these members, so reset them.
+  CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+
+  // Look through the list of dimensions and obtain the best split, exactly as
+  // in Train(), but searching each dimension in its presorted order.
+  const double gain = FitnessFunction::template Evaluate<UseWeights>(
+      labels.subvec(begin, begin + count - 1),
+      numClasses,
+      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  arma::vec gains(data.n_rows);
+  std::vector<arma::vec> dimensionProbabilities(data.n_rows);
+  std::vector<NumericAuxiliarySplitInfo> numericAux(data.n_rows);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; ++i)
+  {
+    gains[i] = NumericSplit::template
+        SplitIfBetterSorted<UseWeights>(gain,
+                                        data.row(i),
+                                        sortedIndices.row(i).cols(begin,
+                                            begin + count - 1),
+                                        labels,
+                                        numClasses,
+                                        weights,
+                                        minimumLeafSize,
+                                        minimumGainSplit,
+                                        dimensionProbabilities[i],
+                                        numericAux[i]);
+  }
+
+  // data.n_rows means "no split".
+  const size_t bestDim = BestDimension(gain, gains, minimumGainSplit);
+  if (bestDim != data.n_rows)
+  {
+    classProbabilities = dimensionProbabilities[bestDim];
+    NumericAuxiliarySplitInfo::operator=(numericAux[bestDim]);
+  }
+
+  // Did we split or not?  If so, then split the data and create the children.
+  if (bestDim != data.n_rows)
+  {
+    // We know that the split is numeric.
+    size_t numChildren = NumericSplit::NumChildren(classProbabilities, *this);
+    splitDimension = bestDim;
+    dimensionTypeOrMajorityClass = (size_t) data::Datatype::numeric;
+
+    // Calculate all child assignments, and where each child begins.
+    arma::Row<size_t> childAssignments(count);
+    arma::Col<size_t> childBegins(numChildren + 1, arma::fill::zeros);
+    for (size_t j = begin; j < begin + count; ++j)
+    {
+      childAssignments[j - begin] = NumericSplit::CalculateDirection(
+          data(bestDim, j), classProbabilities, *this);
+      childBegins[childAssignments[j - begin] + 1]++;
+    }
+    childBegins[0] = begin;
+    for (size_t i = 1; i <= numChildren; ++i)
+      childBegins[i] += childBegins[i - 1];
+
+    // Move the points of each child together, keeping their order.
+    arma::Col<size_t> childNext(childBegins.subvec(0, numChildren - 1));
+    arma::uvec newIndices(count);
+    arma::uvec oldIndices(count);
+    for (size_t j = 0; j < count; ++j)
+    {
+      newIndices[j] = childNext[childAssignments[j]]++;
+      oldIndices[newIndices[j] - begin] = begin + j;
+    }
+
+    data.cols(begin, begin + count - 1) = MatType(data.cols(oldIndices));
+    labels.cols(begin, begin + count - 1) =
+        arma::Row<size_t>(labels.cols(oldIndices));
+    if (UseWeights)
+    {
+      weights.cols(begin, begin + count - 1) =
+          arma::rowvec(weights.cols(oldIndices));
+    }
+
+    // Partition the sorted indices of each dimension in the same way; since
+    // the points are visited in sorted order, each child stays sorted.
+    arma::urowvec childIndices(count);
+    for (size_t i = 0; i < data.n_rows; ++i)
+    {
+      childNext = childBegins.subvec(0, numChildren - 1);
+      for (size_t j = begin; j < begin + count; ++j)
+      {
+        const size_t point = sortedIndices(i, j) - begin;
+        childIndices[childNext[childAssignments[point]]++ - begin] =
+            newIndices[point];
+      }
+      sortedIndices.row(i).cols(begin, begin + count - 1) = childIndices;
+    }
+
+    // Now build the children recursively, or defer them if they are small
+    // enough.
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      DecisionTree* child = new DecisionTree();
+      const size_t childCount = childBegins[i + 1] - childBegins[i];
+      const size_t childLeafSize = NoRecursion ? childCount : minimumLeafSize;
+      if (subtrees && childCount <= subtrees->taskSize)
+      {
+        const SubtreeTask task = { child, childBegins[i], childCount,
+            childLeafSize };
+        subtrees->tasks.push_back(task);
+      }
+      else
+      {
+        child->TrainPresorted<UseWeights>(data, childBegins[i], childCount,
+            labels, numClasses, weights, sortedIndices, childLeafSize,
+            minimumGainSplit, subtrees);
+      }
+      children.push_back(child);
+    }
+  }
+  else
+  {
+    // We won't be needing these members, so reset them.
+    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+
+    // Calculate class probabilities because we are a leaf.
+    CalculateClassProbabilities<UseWeights>(
+        labels.subvec(begin, begin + count - 1),
+        numClasses,
+        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  }
+}
+
+//! Decide whether to build the tree with all threads.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+bool DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::BuildInParallel(const size_t count,
+                                                const size_t minimumLeafSize,
+                                                size_t& taskSize)
+{
+  // A single level has nothing to build in parallel below it.
+  if (NoRecursion)
+    return false;
+
+#ifdef HAS_OPENMP
+  const size_t threads = omp_get_max_threads();
+  if (threads > 1 && !omp_in_parallel())
+  {
+    // Defer subtrees small enough that each thread gets several of them, to
+    // balance the load.
+    const size_t tasksPerThread = 8;
+    taskSize = std::max(2 * minimumLeafSize,
+        count / (tasksPerThread * threads));
+    return (count > taskSize);
+  }
+#endif
+
+  taskSize = count;
+  return false;
+}
+
+//! Choose the dimension to split on.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+size_t DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::BestDimension(const double gain,
+                                                const arma::vec& gains,
+                                                const double minimumGainSplit)
+{
+  double bestGain = gain;
+  size_t bestDimension = gains.n_elem;
+  for (size_t i = 0; i < gains.n_elem; ++i)
+  {
+    // Once a dimension is chosen, a later one has to improve on it by the
+    // minimum gain, as it would have if it were searched after it.
+    if (gains[i] > bestGain && (bestDimension == gains.n_elem ||
+        gains[i] >= 0.0 || gains[i] > bestGain + minimumGainSplit))
+    {
+      bestDimension = i;
+      bestGain = gains[i];
+    }
+
+    // If the gain is the best possible, no need to keep looking.
+    if (bestGain >= 0.0)
+      break;
+  }
+
+  return bestDimension;
+}
+
 //! Return the class.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -946,7 +1339,7 @@ void DecisionTree<FitnessFunction,
                   DimensionSelectionType,
                   ElemType,
                   NoRecursion>::serialize(Archive& ar,
-                                          const unsigned int /* version */)
+                                          const unsigned int version)
 {
   // Clean memory if needed.
   if (Archive::is_loading::value)
@@ -962,7 +1355,12 @@ void DecisionTree<FitnessFunction,
   // Now serialize the rest of the object.
   ar & BOOST_SERIALIZATION_NVP(splitDimension);
   ar & BOOST_SERIALIZATION_NVP(dimensionTypeOrMajorityClass);
-  ar & BOOST_SERIALIZATION_NVP(classProbabilities);
+
+  // Version 1 can save the class probabilities compactly.
+  if (version > 0)
+    data::SerializeCompact(ar, classProbabilities, "classProbabilities");
+  else
+    ar & BOOST_SERIALIZATION_NVP(classProbabilities);
 }
 
 template<typename FitnessFunction,
@@ -0,0 +1,193 @@
+/**
+ * @file flat_forest.hpp
+ *
+ * A compiled form of trained decision trees and random forests, stored in
+ * contiguous arrays for fast batch classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "best_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
+#include "all_categorical_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * IsThresholdSplit holds whether the given numeric split type sends a point to
+ * the first of two children if its value is at most classProbabilities[0], and
+ * to the second one otherwise, so that FlatForest can store the split as a
+ * threshold.
+ */
+template<typename NumericSplitType>
+struct IsThresholdSplit
+{
+  static const bool value = false;
+};
+
+template<typename FitnessFunction>
+struct IsThresholdSplit<BestBinaryNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+template<typename FitnessFunction>
+struct IsThresholdSplit<HistogramNumericSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+/**
+ * IsCategorySplit holds whether the given categorical split type sends a point
+ * to the child with the index of its category, as AllCategoricalSplit does.
+ */
+template<typename CategoricalSplitType>
+struct IsCategorySplit
+{
+  static const bool value = false;
+};
+
+template<typename FitnessFunction>
+struct IsCategorySplit<AllCategoricalSplit<FitnessFunction>>
+{
+  static const bool value = true;
+};
+
+/**
+ * FlatForest is a compiled, read-only form of trained DecisionTrees, or of a
+ * trained RandomForest, for fast classification.  The nodes of all of the trees
+ * are stored in one contiguous array, breadth-first, so that the children of
+ * each node are next to each other, and the class probabilities of the leaves
+ * are stored in another one.  The points are classified in blocks: every tree
+ * is walked for all the points of a block before moving on to the next tree,
+ * so that the nodes of the tree stay in cache, and the blocks are classified in
+ * parallel with OpenMP.  Classify() gives the same predictions and
+ * probabilities as RandomForest::Classify().  For example,
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 500);
+ * FlatForest flat(rf);
+ * flat.Classify(testData, predictions, probabilities);
+ * @endcode
+ *
+ * The trees must use threshold numeric splits (see IsThresholdSplit) and
+ * AllCategoricalSplit for categorical dimensions.  Changes to the trees after
+ * they are compiled are not seen by the FlatForest.
+ */
+class FlatForest
+{
+ public:
+  /**
+   * Create an empty FlatForest; trees can be added with Add().
+   */
+  FlatForest() : numClasses(0) { }
+
+  /**
+   * Compile all of the trees of the given trained random forest (or of any
+   * type with NumTrees() and Tree() methods).
+   *
+   * @param forest Forest to compile.
+   */
+  template<typename ForestType>
+  explicit FlatForest(const ForestType& forest);
+
+  /**
+   * Compile the given trained decision tree, and add it to the forest.  The
+   * probabilities of the trees are averaged when classifying, so a FlatForest
+   * with a single tree gives the same probabilities as the tree.
+   *
+   * @param tree Tree to add.
+   */
+  template<typename TreeType>
+  void Add(const TreeType& tree);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * class probabilities (averaged over the trees) for each point.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the number of nodes of all the trees.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! The number of points classified together by each thread.
+  static const size_t BlockSize = 64;
+
+ private:
+  //! A node of one of the trees.
+  struct Node
+  {
+    //! Threshold of a numeric split.
+    double threshold;
+    //! Dimension to split on, or the index of the leaf if this is a leaf.
+    size_t dimension;
+    //! Index of the first child; the other children follow it.
+    size_t firstChild;
+    //! Number of children (zero for a leaf).
+    size_t numChildren;
+    //! Whether the split is categorical.
+    bool categorical;
+  };
+
+  /**
+   * Find the leaf of the tree with the given root that the given point reaches.
+   *
+   * @param root Index of the root of the tree.
+   * @param data Dataset holding the point.
+   * @param col Column of the point in the dataset.
+   */
+  template<typename MatType>
+  size_t Leaf(const size_t root, const MatType& data, const size_t col) const;
+
+  //! The nodes of all the trees.
+  std::vector<Node> nodes;
+  //! The index of the root of each tree.
+  std::vector<size_t> roots;
+  //! The class probabilities of each leaf, one leaf after another.
+  std::vector<double> leafProbabilities;
+  //! The number of classes.
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file flat_forest_impl.hpp
+ *
+ * Implementation of FlatForest.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename ForestType>
+FlatForest::FlatForest(const ForestType& forest) : numClasses(0)
+{
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    Add(forest.Tree(i));
+}
+
+template<typename TreeType>
+void FlatForest::Add(const TreeType& tree)
+{
+  static_assert(IsThresholdSplit<typename TreeType::NumericSplit>::value,
+      "FlatForest requires a threshold numeric split type, such as "
+      "BestBinaryNumericSplit.");
+  static_assert(IsCategorySplit<typename TreeType::CategoricalSplit>::value,
+      "FlatForest requires AllCategoricalSplit as the categorical split type.");
+
+  if (tree.NumClasses() == 0)
+  {
+    throw std::invalid_argument("FlatForest::Add(): the tree has no "
+        "classes!");
+  }
+  else if (roots.empty())
+  {
+    numClasses = tree.NumClasses();
+  }
+  else if (tree.NumClasses() != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "FlatForest::Add(): the tree has " << tree.NumClasses()
+        << " classes, but the forest has " << numClasses << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Lay the nodes out breadth-first, so that the children of each node are
+  // contiguous.  Each pending node is paired with the index of its flat node.
+  std::vector<std::pair<const TreeType*, size_t>> pending;
+  roots.push_back(nodes.size());
+  pending.push_back(std::make_pair(&tree, nodes.size()));
+  nodes.push_back(Node());
+  for (size_t i = 0; i < pending.size(); ++i)
+  {
+    const TreeType& node = *pending[i].first;
+    Node& flatNode = nodes[pending[i].second];
+    flatNode.numChildren = node.NumChildren();
+    if (flatNode.numChildren == 0)
+    {
+      flatNode.threshold = 0.0;
+      flatNode.dimension = leafProbabilities.size() / numClasses;
+      flatNode.firstChild = 0;
+      flatNode.categorical = false;
+      leafProbabilities.insert(leafProbabilities.end(),
+          node.ClassProbabilities().begin(), node.ClassProbabilities().end());
+      continue;
+    }
+
+    flatNode.categorical = ((data::Datatype) node.DimensionTypeOrMajorityClass()
+        == data::Datatype::categorical);
+    flatNode.threshold = flatNode.categorical ? 0.0 :
+        node.ClassProbabilities()[0];
+    flatNode.dimension = node.SplitDimension();
+    flatNode.firstChild = nodes.size();
+
+    // Adding the children may move the nodes, so flatNode can't be used after
+    // this.
+    for (size_t c = 0; c < node.NumChildren(); ++c)
+    {
+      pending.push_back(std::make_pair(&node.Child(c), nodes.size()));
+      nodes.push_back(Node());
+    }
+  }
+}
+
+template<typename MatType>
+size_t FlatForest::Leaf(const size_t root,
+                        const MatType& data,
+                        const size_t col) const
+{
+  const Node* node = &nodes[root];
+  while (node->numChildren != 0)
+  {
+    const double value = data(node->dimension, col);
+    if (node->categorical)
+      node = &nodes[node->firstChild + (size_t) value];
+    else
+      node = &nodes[node->firstChild + ((value <= node->threshold) ? 0 : 1)];
+  }
+
+  return node->dimension;
+}
+
+template<typename VecType>
+size_t FlatForest::Classify(const VecType& point) const
+{
+  arma::Row<size_t> prediction;
+  Classify(arma::mat(point), prediction);
+  return prediction[0];
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions,
+                          arma::mat& probabilities) const
+{
+  if (roots.empty())
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatForest::Classify(): no trees added!");
+  }
+
+  probabilities.zeros(numClasses, data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  const size_t blocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + size_t(BlockSize),
+        size_t(data.n_cols));
+
+    // Walk each tree for all of the points of the block, summing the
+    // probabilities of the trees in order, as RandomForest does.
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const double* leaf = &leafProbabilities[Leaf(roots[t], data, i) *
+            numClasses];
+        double* pointProbabilities = probabilities.colptr(i);
+        for (size_t c = 0; c < numClasses; ++c)
+          pointProbabilities[c] += leaf[c];
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      arma::vec pointProbabilities = probabilities.unsafe_col(i); // Alias.
+      pointProbabilities /= roots.size();
+      arma::uword maxIndex = 0;
+      pointProbabilities.max(maxIndex);
+      predictions[i] = (size_t) maxIndex;
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * @file histogram_numeric_split_impl.hpp
+ *
+ * Implementation of the strategy that finds the best binary numeric split
+ * between the bins of a histogram.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2) || data.n_elem < 2)
+    return bestGain;
+
+  // Find the range of the points; if they are all the same, we can't split.
+  ElemType minValue = data[0];
+  ElemType maxValue = data[0];
+  for (size_t i = 1; i < data.n_elem; ++i)
+  {
+    minValue = std::min(minValue, data[i]);
+    maxValue = std::max(maxValue, data[i]);
+  }
+  if (minValue == maxValue)
+    return bestGain;
+
+  // Fill the histogram: the class counts (or weights) of each bin, its number
+  // of points, and the smallest and largest value in it.
+  const size_t bins = std::min(size_t(MaxBins), size_t(data.n_elem));
+  const double scale = double(bins) / (double(maxValue) - double(minValue));
+  arma::mat binCounts(numClasses, bins, arma::fill::zeros);
+  arma::Col<size_t> binPoints(bins, arma::fill::zeros);
+  arma::Col<ElemType> binMin(bins);
+  arma::Col<ElemType> binMax(bins);
+  binMin.fill(maxValue);
+  binMax.fill(minValue);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t bin = std::min(size_t((double(data[i]) -
+        double(minValue)) * scale), bins - 1);
+    binCounts(labels[i], bin) += UseWeights ? double(weights[i]) : 1.0;
+    ++binPoints[bin];
+    binMin[bin] = std::min(binMin[bin], data[i]);
+    binMax[bin] = std::max(binMax[bin], data[i]);
+  }
+
+  const arma::vec totalCounts = arma::sum(binCounts, 1);
+  const double totalWeight = UseWeights ? arma::accu(totalCounts) :
+      double(data.n_elem);
+  if (totalWeight <= 0.0)
+    return bestGain;
+
+  // Loop through the boundaries after each non-empty bin, choosing the best
+  // one.  Also, force a minimum leaf size of 1 (empty children don't make
+  // sense).
+  double bestFoundGain = bestGain;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  arma::vec rightCounts(numClasses);
+  size_t leftPoints = 0;
+  for (size_t bin = 0; bin < bins - 1; ++bin)
+  {
+    if (binPoints[bin] == 0)
+      continue;
+
+    leftCounts += binCounts.col(bin);
+    leftPoints += binPoints[bin];
+    if (data.n_elem - leftPoints < minimum)
+      break;
+    if (leftPoints < minimum)
+      continue;
+
+    // Calculate the gain of the left and right child from the counts.
+    rightCounts = totalCounts - leftCounts;
+    const double leftWeight = UseWeights ? arma::accu(leftCounts) :
+        double(leftPoints);
+    const double rightWeight = totalWeight - leftWeight;
+    const double leftGain = FitnessFunction::EvaluateCounts(leftCounts,
+        leftWeight);
+    const double rightGain = FitnessFunction::EvaluateCounts(rightCounts,
+        rightWeight);
+    const double gain = (leftWeight / totalWeight) * leftGain +
+        (rightWeight / totalWeight) * rightGain;
+
+    if (gain >= 0.0 || gain > bestFoundGain + minimumGainSplit)
+    {
+      // The split value will be halfway between the largest value on the left
+      // and the smallest value on the right.
+      size_t nextBin = bin + 1;
+      while (binPoints[nextBin] == 0)
+        ++nextBin;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[bin] + binMin[nextBin]) / 2.0;
+
+      // Corner case: no split will be better than this, so just take it.
+      if (gain >= 0.0)
+        return gain;
+
+      bestFoundGain = gain;
+    }
+  }
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -172,6 +172,31 @@ class InformationGain
     return gain;
   }
 
+  /**
+   * Evaluate the information gain of a set of points from its class counts (or
+   * the sums of the weights of each class).
+   *
+   * @param counts Count (or weight) of each class.
+   * @param total Sum of the counts.
+   */
+  template<typename CountsType>
+  static double EvaluateCounts(const CountsType& counts, const double total)
+  {
+    // Edge case: if there are no elements, the gain is zero.
+    if (total <= 0.0)
+      return 0.0;
+
+    double gain = 0.0;
+    for (size_t i = 0; i < counts.n_elem; ++i)
+    {
+      const double f = ((double) counts[i] / total);
+      if (f > 0.0)
+        gain += f * std::log2(f);
+    }
+
+    return gain;
+  }
+
   /**
    * Return the range of the information gain for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
@@ -91,6 +91,9 @@ PARAM_INT_IN("min_leaf_size", "The minimum size of a leaf in the unpruned, "
     "fully grown DET.", "l", 5);
 PARAM_INT_IN("max_leaf_size", "The maximum size of a leaf in the unpruned, "
     "fully grown DET.", "L", 10);
+PARAM_FLAG("presort", "If set, the points are sorted in each dimension once "
+    "before the trees are grown, instead of at every node; this is faster but "
+    "uses more memory.", "P");
 /*
 PARAM_FLAG("volume_regularization", "This flag gives the used the option to use"
     "a form of regularization similar to the usual alpha-pruning in decision "
@@ -140,6 +143,7 @@ static void mlpackMain()
     const int maxLeafSize = CLI::GetParam<int>("max_leaf_size");
     const int minLeafSize = CLI::GetParam<int>("min_leaf_size");
     const bool skipPruning = CLI::HasParam("skip_pruning");
+    const bool presort = CLI::HasParam("presort");
     size_t folds = CLI::GetParam<int>("folds");
 
     if (folds == 0)
@@ -149,21 +153,20 @@ static void mlpackMain()
     Timer::Start("det_training");
     tree = Trainer<arma::mat, int>(trainingData, folds, regularization,
                                    maxLeafSize, minLeafSize,
-                                   skipPruning);
+                                   skipPruning, presort);
     Timer::Stop("det_training");
 
     // Compute training set estimates, if desired.
     if (CLI::HasParam("training_set_estimates"))
     {
       // Compute density estimates for each point in the training set.
-      arma::rowvec trainingDensities(trainingData.n_cols);
+      arma::vec trainingDensities;
       Timer::Start("det_estimation_time");
-      for (size_t i = 0; i < trainingData.n_cols; i++)
-        trainingDensities[i] = tree->ComputeValue(trainingData.unsafe_col(i));
+      tree->ComputeValue(trainingData, trainingDensities);
       Timer::Stop("det_estimation_time");
 
       CLI::GetParam<arma::mat>("training_set_estimates") =
-          std::move(trainingDensities);
+          trainingDensities.t();
     }
   }
   else
@@ -180,14 +183,11 @@ static void mlpackMain()
     {
       // Compute test set densities.
       Timer::Start("det_test_set_estimation");
-      arma::rowvec testDensities(testData.n_cols);
-
-      for (size_t i = 0; i < testData.n_cols; i++)
-        testDensities[i] = tree->ComputeValue(testData.unsafe_col(i));
-
+      arma::vec testDensities;
+      tree->ComputeValue(testData, testDensities);
       Timer::Stop("det_test_set_estimation");
 
-      CLI::GetParam<arma::mat>("test_set_estimates") = std::move(testDensities);
+      CLI::GetParam<arma::mat>("test_set_estimates") = testDensities.t();
     }
 
     // Print variable importance.
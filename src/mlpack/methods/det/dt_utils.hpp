@@ -59,7 +59,9 @@ void PrintVariableImportance(const DTree<MatType, TagType>* dtree,
  * @param useVolumeReg If true, use volume regularization.
  * @param maxLeafSize Maximum number of points allowed in a leaf.
  * @param minLeafSize Minimum number of points allowed in a leaf.
- * @param unprunedTreeOutput Filename to print unpruned tree to (optional).
+ * @param skipPruning If true, return the unpruned tree.
+ * @param presort If true, presort the points to grow the trees (see
+ *      DTree::Grow()).
  */
 template <typename MatType, typename TagType>
 DTree<MatType, TagType>* Trainer(MatType& dataset,
@@ -67,8 +69,8 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
                                  const bool useVolumeReg = false,
                                  const size_t maxLeafSize = 10,
                                  const size_t minLeafSize = 5,
-                                 const std::string unprunedTreeOutput = "",
-                                 const bool skipPruning = false);
+                                 const bool skipPruning = false,
+                                 const bool presort = false);
 
 /**
  * This class is responsible for caching the path to each node of the tree. Its
@@ -112,7 +112,8 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
                                  const bool useVolumeReg,
                                  const size_t maxLeafSize,
                                  const size_t minLeafSize,
-                                 const bool skipPruning)
+                                 const bool skipPruning,
+                                 const bool presort)
 {
   // Initialize the tree.
   DTree<MatType, TagType>* dtree = new DTree<MatType, TagType>(dataset);
@@ -129,7 +130,7 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   // Growing the tree
   double oldAlpha = 0.0;
   double alpha = dtree->Grow(newDataset, oldFromNew, useVolumeReg, maxLeafSize,
-      minLeafSize);
+      minLeafSize, presort);
 
   Timer::Stop("tree_growing");
   Log::Info << dtree->SubtreeLeaves() << " leaf nodes in the tree using full "
@@ -220,23 +221,20 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
 
     // Grow the tree.
     cvDTree.Grow(train, cvOldFromNew, useVolumeReg, maxLeafSize,
-        minLeafSize);
+        minLeafSize, presort);
 
     // Sequentially prune with all the values of available alphas and adding
     // values for test values.  Don't enter this loop if there are less than two
     // trees in the pruned sequence.
     arma::vec cvRegularizationConstants(prunedSequence.size());
     cvRegularizationConstants.fill(0.0);
+    arma::vec testValues;
     for (size_t i = 0;
          i < ((prunedSequence.size() < 2) ? 0 : prunedSequence.size() - 2); ++i)
     {
       // Compute test values for this state of the tree.
-      double cvVal = 0.0;
-      for (size_t j = 0; j < test.n_cols; j++)
-      {
-        arma::vec testPoint = test.unsafe_col(j);
-        cvVal += cvDTree.ComputeValue(testPoint);
-      }
+      cvDTree.ComputeValue(test, testValues);
+      const double cvVal = arma::accu(testValues);
 
       // Update the cv regularization constant.
       cvRegularizationConstants[i] += 2.0 * cvVal / (double) cvData.n_cols;
@@ -248,12 +246,8 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     }
 
     // Compute test values for this state of the tree.
-    double cvVal = 0.0;
-    for (size_t i = 0; i < test.n_cols; ++i)
-    {
-      typename MatType::vec_type testPoint = test.unsafe_col(i);
-      cvVal += cvDTree.ComputeValue(testPoint);
-    }
+    cvDTree.ComputeValue(test, testValues);
+    const double cvVal = arma::accu(testValues);
 
     if (prunedSequence.size() > 2)
       cvRegularizationConstants[prunedSequence.size() - 2] += 2.0 * cvVal
@@ -300,7 +294,8 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
                          oldFromNew,
                          useVolumeReg,
                          maxLeafSize,
-                         minLeafSize);
+                         minLeafSize,
+                         presort);
 
   // Prune with optimal alpha.
   while ((oldAlpha < optimalAlpha) && (dtree->SubtreeLeaves() > 1))
@@ -148,19 +148,29 @@ class DTree
 
   /**
    * Greedily expand the tree.  The points in the dataset will be reordered
-   * during tree growth.
+   * during tree growth.  Large trees are grown in parallel with OpenMP: the
+   * top of the tree is split first, and then the subtrees below it are grown
+   * in parallel; the tree does not depend on the number of threads.
+   *
+   * If presort is true, the values of each dimension are sorted once before
+   * the tree is grown, and kept sorted within each node as it is split, instead
+   * of being sorted again at every node.  This gives the same tree, but uses
+   * memory for a sorted copy of the dataset.  If presort is true, oldFromNew
+   * must hold a permutation of the indices of the points.
    *
    * @param data Dataset to build tree on.
    * @param oldFromNew Mappings from old points to new points.
    * @param useVolReg If true, volume regularization is used.
    * @param maxLeafSize Maximum size of a leaf.
    * @param minLeafSize Minimum size of a leaf.
+   * @param presort If true, presort the points to find the splits.
    */
   double Grow(MatType& data,
               arma::Col<size_t>& oldFromNew,
               const bool useVolReg = false,
               const size_t maxLeafSize = 10,
-              const size_t minLeafSize = 5);
+              const size_t minLeafSize = 5,
+              const bool presort = false);
 
   /**
    * Perform alpha pruning on a tree.  Returns the new value of alpha.
@@ -181,6 +191,20 @@ class DTree
    */
   double ComputeValue(const VecType& query) const;
 
+  /**
+   * Compute the density estimates of all of the given query points.  The
+   * points are passed down the tree together, in blocks of BlockSize points
+   * that are evaluated in parallel with OpenMP.
+   *
+   * @param queries Points to estimate the density of.
+   * @param densities Output density estimates of each point.
+   */
+  void ComputeValue(const MatType& queries, arma::vec& densities) const;
+
+  //! The number of query points passed down the tree together by
+  //! ComputeValue().
+  static const size_t BlockSize = 256;
+
   /**
    * Index the buckets for possible usage later; this results in every leaf in
    * the tree having a specific tag (accessible with BucketTag()).  This
@@ -334,6 +358,73 @@ class DTree
  private:
   // Utility methods.
 
+  //! The values of each dimension of the points, sorted within each node.
+  struct PresortedPoints
+  {
+    //! The sorted values; each column holds one dimension, and the rows of
+    //! each node are the rows of its points in the dataset.
+    arma::Mat<ElemType> values;
+    //! The original index (in oldFromNew) of the point of each value.
+    arma::Mat<size_t> indices;
+    //! Whether each point goes to the left child of the node being split.
+    std::vector<char> goesLeft;
+  };
+
+  //! The subtrees deferred while the top of a tree is grown.
+  struct SubtreeTasks
+  {
+    //! The deferred subtrees.
+    std::vector<DTree*> tasks;
+    //! Subtrees with at most this many points are deferred.
+    size_t taskSize;
+  };
+
+  /**
+   * Return whether a tree with the given number of points should be grown with
+   * all threads, and if so, set the number of points under which subtrees are
+   * deferred to be grown in parallel.
+   *
+   * @param points Number of points in the tree.
+   * @param maxLeafSize Maximum size of a leaf.
+   * @param taskSize Set to the maximum number of points of deferred subtrees.
+   */
+  static bool GrowInParallel(const size_t points,
+                             const size_t maxLeafSize,
+                             size_t& taskSize);
+
+  /**
+   * Grow the subtree rooted at this node.  If subtrees is not NULL, subtrees
+   * small enough are deferred there instead of being grown, and the errors
+   * and alpha values of the nodes above them are left for FinishTop().
+   */
+  double GrowSubtree(MatType& data,
+                     arma::Col<size_t>& oldFromNew,
+                     const bool useVolReg,
+                     const size_t maxLeafSize,
+                     const size_t minLeafSize,
+                     PresortedPoints* presorted,
+                     SubtreeTasks* subtrees);
+
+  /**
+   * Finish the nodes above the deferred subtrees, once the subtrees are grown,
+   * given the value returned by the growth of each subtree.
+   */
+  double FinishTop(const size_t totalPoints,
+                   const bool useVolReg,
+                   const SubtreeTasks& subtrees,
+                   const std::vector<double>& alphas,
+                   size_t& nextTask);
+
+  /**
+   * Compute the error of the leaves of the subtree and the alpha values of
+   * this node, whose children (if any) are grown, given the values returned by
+   * the growth of the children.
+   */
+  double FinishNode(const size_t totalPoints,
+                    const bool useVolReg,
+                    const double leftG,
+                    const double rightG);
+
   /**
    * Find the dimension to split on.
    */
@@ -342,7 +433,25 @@ class DTree
                  ElemType& splitValue,
                  double& leftError,
                  double& rightError,
-                 const size_t minLeafSize = 5) const;
+                 const size_t minLeafSize = 5,
+                 const PresortedPoints* presorted = NULL) const;
+
+  /**
+   * Partition the presorted values of the points of this node between its
+   * children, after SplitData() has put splitIndex points on the left.
+   */
+  void PartitionPresorted(PresortedPoints& presorted,
+                          const arma::Col<size_t>& oldFromNew,
+                          const size_t splitIndex) const;
+
+  /**
+   * Compute the density estimates of the query points with the given indices,
+   * which are reordered.
+   */
+  void ComputeValues(const MatType& queries,
+                     size_t* begin,
+                     size_t* end,
+                     arma::vec& densities) const;
 
   /**
    * Split the data, returning the number of points left of the split.
@@ -21,6 +21,34 @@ using namespace det;
 namespace details
 {
 
+/**
+ * Put all of the splits between the given sorted values of the points of a
+ * node in a vector, ensuring the minimum leaf size on both sides.
+ */
+template<typename ElemType>
+void ExtractSortedSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                         const ElemType* dimVec,
+                         const size_t points,
+                         const size_t minLeafSize)
+{
+  typedef std::pair<ElemType, size_t> SplitItem;
+
+  // Ensure the minimum leaf size on both sides. We need to figure out why there
+  // are spikes if this minLeafSize is enforced here...
+  for (size_t i = minLeafSize - 1; i < points - minLeafSize; ++i)
+  {
+    // This makes sense for real continuous data. This kinda corrupts the data
+    // and estimation if the data is ordinal. Potentially we can fix that by
+    // taking into account ordinality later in the min/max update, but then we
+    // can end-up with a zero-volumed dimension. No good.
+    const ElemType split = (dimVec[i] + dimVec[i + 1]) / 2.0;
+
+    // Check if we can split here (two points are different)
+    if (split != dimVec[i])
+      splitVec.push_back(SplitItem(split, i + 1));
+  }
+}
+
 /**
  * This one sorts and scand the given per-dimension extract and puts all splits
  * in a vector, that can easily be iterated afterwards. General implementation.
@@ -37,24 +65,11 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
     std::is_same<typename MatType::elem_type, ElemType>::value == true,
     "The ElemType does not correspond to the matrix's element type.");
 
-  typedef std::pair<ElemType, size_t> SplitItem;
   const typename MatType::row_type dimVec =
       arma::sort(data(dim, arma::span(start, end - 1)));
 
-  // Ensure the minimum leaf size on both sides. We need to figure out why there
-  // are spikes if this minLeafSize is enforced here...
-  for (size_t i = minLeafSize - 1; i < dimVec.n_elem - minLeafSize; ++i)
-  {
-    // This makes sense for real continuous data. This kinda corrupts the data
-    // and estimation if the data is ordinal. Potentially we can fix that by
-    // taking into account ordinality later in the min/max update, but then we
-    // can end-up with a zero-volumed dimension. No good.
-    const ElemType split = (dimVec[i] + dimVec[i + 1]) / 2.0;
-
-    // Check if we can split here (two points are different)
-    if (split != dimVec[i])
-      splitVec.push_back(SplitItem(split, i + 1));
-  }
+  ExtractSortedSplits<ElemType>(splitVec, dimVec.memptr(), dimVec.n_elem,
+      minLeafSize);
 }
 
 // Now the custom arma::Mat implementation.
@@ -66,23 +81,13 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
                    const size_t end,
                    const size_t minLeafSize)
 {
-  typedef std::pair<ElemType, size_t> SplitItem;
-  arma::rowvec dimVec = data(dim, arma::span(start, end - 1));
+  arma::Row<ElemType> dimVec = data(dim, arma::span(start, end - 1));
 
   // We sort these, in-place (it's a copy of the data, anyways).
   std::sort(dimVec.begin(), dimVec.end());
 
-  for (size_t i = minLeafSize - 1; i < dimVec.n_elem - minLeafSize; ++i)
-  {
-    // This makes sense for real continuous data. This kinda corrupts the data
-    // and estimation if the data is ordinal. Potentially we can fix that by
-    // taking into account ordinality later in the min/max update, but then we
-    // can end-up with a zero-volumed dimension. No good.
-    const ElemType split = (dimVec[i] + dimVec[i + 1]) / 2.0;
-
-    if (split != dimVec[i])
-      splitVec.push_back(SplitItem(split, i + 1));
-  }
+  ExtractSortedSplits<ElemType>(splitVec, dimVec.memptr(), dimVec.n_elem,
+      minLeafSize);
 }
 
 // This the custom, sparse optimized implementation of the same routine.
@@ -439,7 +444,8 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
                                         ElemType& splitValue,
                                         double& leftError,
                                         double& rightError,
-                                        const size_t minLeafSize) const
+                                        const size_t minLeafSize,
+                                        const PresortedPoints* presorted) const
 {
   typedef std::pair<ElemType, size_t> SplitItem;
 
@@ -450,17 +456,18 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
 
   const size_t points = end - start;
 
-  double minError = logNegError;
-  bool splitFound = false;
+  // The best split of each dimension.  The dimensions are searched in parallel,
+  // and then the best one is taken in order, so that the split does not
+  // depend on the number of threads.
+  std::vector<char> dimSplitFounds(maxVals.n_elem, 0);
+  arma::vec dimErrors(maxVals.n_elem);
+  arma::vec dimLeftErrors(maxVals.n_elem);
+  arma::vec dimRightErrors(maxVals.n_elem);
+  std::vector<ElemType> dimSplitValues(maxVals.n_elem);
 
   // Loop through each dimension.
-#ifdef _WIN32
-  #pragma omp parallel for default(shared)
-  for (intmax_t dim = 0; dim < (intmax_t) maxVals.n_elem; ++dim)
-#else
   #pragma omp parallel for default(shared)
-  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
-#endif
+  for (omp_size_t dim = 0; dim < (omp_size_t) maxVals.n_elem; ++dim)
   {
     const ElemType min = minVals[dim];
     const ElemType max = maxVals[dim];
@@ -485,11 +492,20 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     //   dimVec = arma::sort(dimVec);
     // could be quite inefficient for sparse matrices, due to
     // copy operations (3). This one has custom implementation for dense and
-    // sparse matrices.
+    // sparse matrices.  If the points are presorted, the sorted values of
+    // this node are already available.
 
     std::vector<SplitItem> splitVec;
-    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
-        minLeafSize);
+    if (presorted)
+    {
+      details::ExtractSortedSplits<ElemType>(splitVec,
+          presorted->values.colptr(dim) + start, points, minLeafSize);
+    }
+    else
+    {
+      details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
+          minLeafSize);
+    }
 
     // Iterate on all the splits for this dimension
     for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
@@ -528,22 +544,32 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
       }
     }
 
-    const double actualMinDimError = std::log(minDimError)
+    // Calculate actual error (in logspace) by adding terms back to our
+    // estimate.
+    dimSplitFounds[dim] = dimSplitFound;
+    dimErrors[dim] = std::log(minDimError)
+      - 2 * std::log((double) data.n_cols)
+      - volumeWithoutDim;
+    dimLeftErrors[dim] = std::log(dimLeftError)
+      - 2 * std::log((double) data.n_cols)
+      - volumeWithoutDim;
+    dimRightErrors[dim] = std::log(dimRightError)
       - 2 * std::log((double) data.n_cols)
       - volumeWithoutDim;
+    dimSplitValues[dim] = dimSplitValue;
+  }
 
-#pragma omp critical(DTreeFindUpdate)
-    if ((actualMinDimError > minError) && dimSplitFound)
+  double minError = logNegError;
+  bool splitFound = false;
+  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
+  {
+    if (dimSplitFounds[dim] && (dimErrors[dim] > minError))
     {
-      // Calculate actual error (in logspace) by adding terms back to our
-      // estimate.
-      minError = actualMinDimError;
+      minError = dimErrors[dim];
       splitDim = dim;
-      splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
-        - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
-        - volumeWithoutDim;
+      splitValue = dimSplitValues[dim];
+      leftError = dimLeftErrors[dim];
+      rightError = dimRightErrors[dim];
       splitFound = true;
     } // end if better split found in this dimension.
   }
@@ -586,17 +612,147 @@ size_t DTree<MatType, TagType>::SplitData(MatType& data,
 }
 
 // Greedily expand the tree.
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::PartitionPresorted(
+    PresortedPoints& presorted,
+    const arma::Col<size_t>& oldFromNew,
+    const size_t splitIndex) const
+{
+  for (size_t i = start; i < end; ++i)
+    presorted.goesLeft[oldFromNew[i]] = (i < splitIndex) ? 1 : 0;
+
+  // Stably partition the sorted values of each dimension, so that the values
+  // of each child stay sorted.
+  #pragma omp parallel for
+  for (omp_size_t dim = 0; dim < (omp_size_t) presorted.values.n_cols; ++dim)
+  {
+    ElemType* values = presorted.values.colptr(dim);
+    size_t* indices = presorted.indices.colptr(dim);
+    std::vector<ElemType> rightValues;
+    std::vector<size_t> rightIndices;
+    rightValues.reserve(end - splitIndex);
+    rightIndices.reserve(end - splitIndex);
+
+    size_t left = start;
+    for (size_t i = start; i < end; ++i)
+    {
+      if (presorted.goesLeft[indices[i]])
+      {
+        values[left] = values[i];
+        indices[left] = indices[i];
+        ++left;
+      }
+      else
+      {
+        rightValues.push_back(values[i]);
+        rightIndices.push_back(indices[i]);
+      }
+    }
+
+    std::copy(rightValues.begin(), rightValues.end(), values + left);
+    std::copy(rightIndices.begin(), rightIndices.end(), indices + left);
+  }
+}
+
+template<typename MatType, typename TagType>
+bool DTree<MatType, TagType>::GrowInParallel(const size_t points,
+                                             const size_t maxLeafSize,
+                                             size_t& taskSize)
+{
+#ifdef HAS_OPENMP
+  const size_t threads = omp_get_max_threads();
+  if (threads > 1 && !omp_in_parallel())
+  {
+    // Defer subtrees small enough that each thread gets several of them, to
+    // balance the load.
+    const size_t tasksPerThread = 8;
+    taskSize = std::max(2 * maxLeafSize, points / (tasksPerThread * threads));
+    return (points > taskSize);
+  }
+#endif
+
+  taskSize = points;
+  return false;
+}
+
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::Grow(MatType& data,
                                      arma::Col<size_t>& oldFromNew,
                                      const bool useVolReg,
                                      const size_t maxLeafSize,
-                                     const size_t minLeafSize)
+                                     const size_t minLeafSize,
+                                     const bool presort)
 {
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
 
-  double leftG, rightG;
+  // Sort the values of each dimension once, if requested.
+  PresortedPoints presortedPoints;
+  PresortedPoints* presorted = NULL;
+  if (presort)
+  {
+    presorted = &presortedPoints;
+    presorted->values.set_size(data.n_cols, data.n_rows);
+    presorted->indices.set_size(data.n_cols, data.n_rows);
+    presorted->goesLeft.assign(oldFromNew.n_elem, 0);
+
+    #pragma omp parallel for
+    for (omp_size_t dim = 0; dim < (omp_size_t) data.n_rows; ++dim)
+    {
+      arma::Col<ElemType> dimValues(end - start);
+      for (size_t i = start; i < end; ++i)
+        dimValues[i - start] = data(dim, i);
+
+      const arma::uvec order = arma::sort_index(dimValues);
+      for (size_t i = 0; i < order.n_elem; ++i)
+      {
+        presorted->values(start + i, dim) = dimValues[order[i]];
+        presorted->indices(start + i, dim) = oldFromNew[start + order[i]];
+      }
+    }
+  }
+
+  // Large trees are grown with all threads: the top of the tree is split
+  // first, and then the subtrees below it, which hold disjoint ranges of
+  // points, are grown in parallel.
+  SubtreeTasks subtrees;
+  if (GrowInParallel(end - start, maxLeafSize, subtrees.taskSize))
+  {
+    GrowSubtree(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+        presorted, &subtrees);
+
+    std::vector<double> subtreeAlphas(subtrees.tasks.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) subtrees.tasks.size(); ++i)
+    {
+      subtreeAlphas[i] = subtrees.tasks[i]->GrowSubtree(data, oldFromNew,
+          useVolReg, maxLeafSize, minLeafSize, presorted, NULL);
+    }
+
+    size_t nextTask = 0;
+    return FinishTop(data.n_cols, useVolReg, subtrees, subtreeAlphas,
+        nextTask);
+  }
+
+  return GrowSubtree(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+      presorted, NULL);
+}
+
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::GrowSubtree(MatType& data,
+                                            arma::Col<size_t>& oldFromNew,
+                                            const bool useVolReg,
+                                            const size_t maxLeafSize,
+                                            const size_t minLeafSize,
+                                            PresortedPoints* presorted,
+                                            SubtreeTasks* subtrees)
+{
+  // Defer small subtrees, if we are growing the top of the tree.
+  if (subtrees && (size_t) (end - start) <= subtrees->taskSize)
+  {
+    subtrees->tasks.push_back(this);
+    return 0.0;
+  }
 
   // Compute points ratio.
   ratio = (double) (end - start) / (double) oldFromNew.n_elem;
@@ -614,11 +770,14 @@ double DTree<MatType, TagType>::Grow(MatType& data,
     size_t dim;
     double splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize,
+        presorted))
     {
       // Move the data around for the children to have points in a node lie
       // contiguously (to increase efficiency during the training).
       const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew);
+      if (presorted)
+        PartitionPresorted(*presorted, oldFromNew, splitIndex);
 
       // Make max and min vals for the children.
       StatType maxValsL(maxVals);
@@ -637,41 +796,79 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+      const double leftG = left->GrowSubtree(data, oldFromNew, useVolReg,
+          maxLeafSize, minLeafSize, presorted, subtrees);
+      const double rightG = right->GrowSubtree(data, oldFromNew, useVolReg,
+          maxLeafSize, minLeafSize, presorted, subtrees);
 
-      // Store values of R(T~) and |T~|.
-      subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
+      // The top of the tree is finished once the deferred subtrees are grown.
+      if (subtrees)
+        return 0.0;
 
-      // Find the log negative error of the subtree leaves.  This is kind of an
-      // odd one because we don't want to represent the error in non-log-space,
-      // but we have to calculate log(E_l + E_r).  So we multiply E_l and E_r by
-      // V_t (remember E_l has an inverse relationship to the volume of the
-      // nodes) and then subtract log(V_t) at the end of the whole expression.
-      // As a result we do leave log-space, but the largest quantity we
-      // represent is on the order of (V_t / V_i) where V_i is the smallest leaf
-      // node below this node, which depends heavily on the depth of the tree.
-      subtreeLeavesLogNegError = std::log(
-          std::exp(logVolume + left->SubtreeLeavesLogNegError()) +
-          std::exp(logVolume + right->SubtreeLeavesLogNegError()))
-          - logVolume;
-    }
-    else
-    {
-      // No split found so make a leaf out of it.
-      subtreeLeaves = 1;
-      subtreeLeavesLogNegError = logNegError;
+      return FinishNode(data.n_cols, useVolReg, leftG, rightG);
     }
   }
   else
   {
     // We can make this a leaf node.
     Log::Assert((size_t) (end - start) >= minLeafSize);
+  }
+
+  // No split found so make a leaf out of it.
+  return FinishNode(data.n_cols, useVolReg, 0.0, 0.0);
+}
+
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::FinishTop(const size_t totalPoints,
+                                          const bool useVolReg,
+                                          const SubtreeTasks& subtrees,
+                                          const std::vector<double>& alphas,
+                                          size_t& nextTask)
+{
+  // The deferred subtrees are visited in the order they were deferred in.
+  if ((size_t) (end - start) <= subtrees.taskSize)
+    return alphas[nextTask++];
+
+  if (!left)
+    return FinishNode(totalPoints, useVolReg, 0.0, 0.0);
+
+  const double leftG = left->FinishTop(totalPoints, useVolReg, subtrees,
+      alphas, nextTask);
+  const double rightG = right->FinishTop(totalPoints, useVolReg, subtrees,
+      alphas, nextTask);
+  return FinishNode(totalPoints, useVolReg, leftG, rightG);
+}
+
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::FinishNode(const size_t totalPoints,
+                                           const bool useVolReg,
+                                           const double leftG,
+                                           const double rightG)
+{
+  if (!left)
+  {
+    // This is a leaf.
     subtreeLeaves = 1;
     subtreeLeavesLogNegError = logNegError;
   }
+  else
+  {
+    // Store values of R(T~) and |T~|.
+    subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
+
+    // Find the log negative error of the subtree leaves.  This is kind of an
+    // odd one because we don't want to represent the error in non-log-space,
+    // but we have to calculate log(E_l + E_r).  So we multiply E_l and E_r by
+    // V_t (remember E_l has an inverse relationship to the volume of the
+    // nodes) and then subtract log(V_t) at the end of the whole expression.
+    // As a result we do leave log-space, but the largest quantity we
+    // represent is on the order of (V_t / V_i) where V_i is the smallest leaf
+    // node below this node, which depends heavily on the depth of the tree.
+    subtreeLeavesLogNegError = std::log(
+        std::exp(logVolume + left->SubtreeLeavesLogNegError()) +
+        std::exp(logVolume + right->SubtreeLeavesLogNegError()))
+        - logVolume;
+  }
 
   // If this is a leaf, do not compute g_k(t); otherwise compute, store, and
   // propagate min(g_k(t_L), g_k(t_R), g_k(t)), unless t_L and/or t_R are
@@ -695,7 +892,7 @@ double DTree<MatType, TagType>::Grow(MatType& data,
 
     if (left->SubtreeLeaves() > 1)
     {
-      const double exponent = 2 * std::log((double) data.n_cols) + logVolume +
+      const double exponent = 2 * std::log((double) totalPoints) + logVolume +
           left->AlphaUpper();
 
       // Whether or not this will overflow is highly dependent on the depth of
@@ -705,14 +902,14 @@ double DTree<MatType, TagType>::Grow(MatType& data,
 
     if (right->SubtreeLeaves() > 1)
     {
-      const double exponent = 2 * std::log((double) data.n_cols)
+      const double exponent = 2 * std::log((double) totalPoints)
         + logVolume
         + right->AlphaUpper();
 
       tmpAlphaSum += std::exp(exponent);
     }
 
-    alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) data.n_cols)
+    alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) totalPoints)
       - logVolume;
 
     double gT;
@@ -734,7 +931,6 @@ double DTree<MatType, TagType>::Grow(MatType& data,
   // -1.0 * subtreeLeavesError.
 }
 
-
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::PruneAndUpdate(const double oldAlpha,
                                                const size_t points,
@@ -889,6 +1085,80 @@ double DTree<MatType, TagType>::ComputeValue(const VecType& query) const
   return 0.0;
 }
 
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::ComputeValue(const MatType& queries,
+                                           arma::vec& densities) const
+{
+  Log::Assert(queries.n_rows == maxVals.n_elem);
+
+  densities.zeros(queries.n_cols);
+
+  // The points of each block are passed down the tree together.
+  const size_t blocks = (queries.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t blockEnd = std::min(begin + size_t(BlockSize),
+        size_t(queries.n_cols));
+
+    // Points outside of the range of the root have zero density.
+    std::vector<size_t> indices;
+    indices.reserve(blockEnd - begin);
+    for (size_t i = begin; i < blockEnd; ++i)
+    {
+      bool withinRange = true;
+      if (root)
+      {
+        for (size_t d = 0; d < queries.n_rows; ++d)
+        {
+          const ElemType value = queries(d, i);
+          if ((value < minVals[d]) || (value > maxVals[d]))
+          {
+            withinRange = false;
+            break;
+          }
+        }
+      }
+
+      if (withinRange)
+        indices.push_back(i);
+    }
+
+    if (!indices.empty())
+    {
+      ComputeValues(queries, indices.data(), indices.data() + indices.size(),
+          densities);
+    }
+  }
+}
+
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::ComputeValues(const MatType& queries,
+                                            size_t* begin,
+                                            size_t* end,
+                                            arma::vec& densities) const
+{
+  if (subtreeLeaves == 1)  // If we are a leaf...
+  {
+    const double density = std::exp(std::log(ratio) - logVolume);
+    for (size_t* i = begin; i != end; ++i)
+      densities[*i] = density;
+    return;
+  }
+
+  // Send the points to the left and right children.
+  size_t* middle = std::partition(begin, end, [&](const size_t i)
+      {
+        return queries(splitDim, i) <= splitValue;
+      });
+
+  if (middle != begin)
+    left->ComputeValues(queries, begin, middle, densities);
+  if (middle != end)
+    right->ComputeValues(queries, middle, end, densities);
+}
+
 // Index the buckets for possible usage later.
 template<typename MatType, typename TagType>
 TagType DTree<MatType, TagType>::TagTree(const TagType& tag, bool every)
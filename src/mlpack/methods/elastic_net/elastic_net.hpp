@@ -0,0 +1,281 @@
+/**
+ * @file elastic_net.hpp
+ *
+ * Definition of the ElasticNet class, which solves the lasso and the elastic
+ * net by coordinate descent, with the SCD optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ELASTIC_NET_ELASTIC_NET_HPP
+#define MLPACK_METHODS_ELASTIC_NET_ELASTIC_NET_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/optimizers/scd/scd.hpp>
+#include <mlpack/core/optimizers/scd/descent_policies/cyclic_descent.hpp>
+
+#include "elastic_net_function.hpp"
+
+namespace mlpack {
+namespace regression {
+
+/**
+ * An elastic net solver: it finds the coefficients beta (and optionally the
+ * intercept b) minimizing
+ *
+ * \f[ 0.5 || y - X^T \beta - b ||_2^2 + \lambda_1 || \beta ||_1 +
+ *     0.5 \lambda_2 || \beta ||_2^2, \f]
+ *
+ * which is the lasso when lambda2 is 0; this is the same objective as the LARS
+ * class.  Instead of the Gram matrix (or a Cholesky factorization over the
+ * active set), which grow quickly with the number of features, this runs
+ * coordinate descent with the SCD optimizer on ElasticNetFunction, which costs
+ * time proportional to the number of nonzero elements of each feature, so the
+ * data may be sparse.
+ *
+ * Before each solve, the sequential strong rule of
+ *
+ * @code
+ * @article{tibshirani2012strong,
+ *   title={Strong rules for discarding predictors in lasso-type problems},
+ *   author={Tibshirani, R. and Bien, J. and Friedman, J. and Hastie, T. and
+ *       Simon, N. and Taylor, J. and Tibshirani, R.J.},
+ *   journal={Journal of the Royal Statistical Society: Series B},
+ *   volume={74},
+ *   number={2},
+ *   pages={245--266},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * discards the features that are likely to have a zero coefficient; the KKT
+ * conditions are then checked for the discarded features, and the violators
+ * are added back, so the solution is the same as without screening.  Path()
+ * solves a decreasing sequence of values of lambda1, each one warm-started
+ * from the previous solution, which is usually much faster than each value
+ * alone.
+ *
+ * An example of use:
+ *
+ * @code
+ * arma::mat data; // One column per point; may be an arma::sp_mat.
+ * arma::rowvec responses;
+ *
+ * ElasticNet<> lasso(0.1);
+ * lasso.Train(data, responses);
+ * const arma::vec& beta = lasso.Beta();
+ * @endcode
+ *
+ * @tparam DescentPolicyType The descent policy of the SCD optimizer
+ *     (RandomDescent or CyclicDescent).
+ */
+template<typename DescentPolicyType = optimization::RandomDescent>
+class ElasticNet
+{
+ public:
+  /**
+   * Set the parameters of the elastic net.  No training is done.
+   *
+   * @param lambda1 Regularization parameter for l1-norm penalty.
+   * @param lambda2 Regularization parameter for l2-norm penalty.
+   * @param fitIntercept Whether to fit an intercept (by centering the data).
+   * @param tolerance Tolerance for the change of the objective in one pass
+   *     over the features, relative to the objective with zero coefficients.
+   * @param maxEpochs Maximum number of passes over the features per solve.
+   */
+  ElasticNet(const double lambda1 = 0.0,
+             const double lambda2 = 0.0,
+             const bool fitIntercept = false,
+             const double tolerance = 1e-10,
+             const size_t maxEpochs = 1000);
+
+  /**
+   * Set the parameters of the elastic net and train it on the given data.
+   *
+   * @param data Column-major input data (dense or sparse).
+   * @param responses A vector of targets.
+   * @param lambda1 Regularization parameter for l1-norm penalty.
+   * @param lambda2 Regularization parameter for l2-norm penalty.
+   * @param fitIntercept Whether to fit an intercept (by centering the data).
+   * @param tolerance Tolerance for the change of the objective in one pass
+   *     over the features, relative to the objective with zero coefficients.
+   * @param maxEpochs Maximum number of passes over the features per solve.
+   */
+  template<typename MatType>
+  ElasticNet(const MatType& data,
+             const arma::rowvec& responses,
+             const double lambda1 = 0.0,
+             const double lambda2 = 0.0,
+             const bool fitIntercept = false,
+             const double tolerance = 1e-10,
+             const size_t maxEpochs = 1000);
+
+  /**
+   * Train the elastic net on the given data.  The data is transposed once
+   * internally, so that each feature is contiguous.
+   *
+   * @param data Column-major input data (dense or sparse).
+   * @param responses A vector of targets.
+   * @param warmStart If true, start from the current coefficients (which must
+   *     have the dimensionality of the data) instead of zero.
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const arma::rowvec& responses,
+             const bool warmStart = false);
+
+  /**
+   * Compute the solutions for a decreasing sequence of values of lambda1 (with
+   * the current lambda2), each one warm-started from the previous one.  The
+   * model is left with the solution for the last value.  A good sequence
+   * starts just below MaxLambda1(), where all coefficients are zero.
+   *
+   * @param data Column-major input data (dense or sparse).
+   * @param responses A vector of targets.
+   * @param lambda1Path Decreasing values of lambda1.
+   * @param betaPath Matrix to store the coefficients in, one column per value
+   *     of lambda1.
+   * @param interceptPath Vector to store the intercepts in.
+   */
+  template<typename MatType>
+  void Path(const MatType& data,
+            const arma::rowvec& responses,
+            const arma::vec& lambda1Path,
+            arma::mat& betaPath,
+            arma::rowvec& interceptPath);
+
+  /**
+   * Predict the responses of the given points.
+   *
+   * @param points Column-major data points (dense or sparse).
+   * @param predictions Vector to store the predictions in.
+   */
+  template<typename MatType>
+  void Predict(const MatType& points, arma::rowvec& predictions) const;
+
+  /**
+   * Compute the smallest value of lambda1 for which all the coefficients are
+   * zero: the largest absolute correlation of a (centered) feature with the
+   * (centered) responses.
+   *
+   * @param data Column-major input data (dense or sparse).
+   * @param responses A vector of targets.
+   * @param fitIntercept Whether the data is centered.
+   */
+  template<typename MatType>
+  static double MaxLambda1(const MatType& data,
+                           const arma::rowvec& responses,
+                           const bool fitIntercept);
+
+  //! Get the regularization parameter for l1-norm penalty.
+  double Lambda1() const { return lambda1; }
+  //! Modify the regularization parameter for l1-norm penalty.
+  double& Lambda1() { return lambda1; }
+
+  //! Get the regularization parameter for l2-norm penalty.
+  double Lambda2() const { return lambda2; }
+  //! Modify the regularization parameter for l2-norm penalty.
+  double& Lambda2() { return lambda2; }
+
+  //! Get whether an intercept is fitted.
+  bool FitIntercept() const { return fitIntercept; }
+  //! Modify whether an intercept is fitted.
+  bool& FitIntercept() { return fitIntercept; }
+
+  //! Get the relative tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the relative tolerance.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the maximum number of passes over the features per solve.
+  size_t MaxEpochs() const { return maxEpochs; }
+  //! Modify the maximum number of passes over the features per solve.
+  size_t& MaxEpochs() { return maxEpochs; }
+
+  //! Get the coefficients.
+  const arma::vec& Beta() const { return beta; }
+  //! Modify the coefficients (used as the starting point of a warm start).
+  arma::vec& Beta() { return beta; }
+
+  //! Get the intercept.
+  double Intercept() const { return intercept; }
+
+  //! Get the number of features discarded by the screening rule in the last
+  //! solve.
+  size_t NumScreened() const { return numScreened; }
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Transpose and center the data and the responses.
+   *
+   * @param data Column-major input data.
+   * @param responses A vector of targets.
+   * @param fitIntercept Whether to center the data and the responses.
+   * @param featureData Matrix to store the transposed data in.
+   * @param means Vector to store the means of the features in (zero if the
+   *     data is not centered).
+   * @param centeredResponses Vector to store the centered responses in.
+   * @return The mean of the responses (zero if the data is not centered).
+   */
+  template<typename MatType>
+  static double Preprocess(const MatType& data,
+                           const arma::rowvec& responses,
+                           const bool fitIntercept,
+                           MatType& featureData,
+                           arma::vec& means,
+                           arma::vec& centeredResponses);
+
+  /**
+   * Compute the correlations of the centered features with the centered
+   * residual of the given coefficients.
+   */
+  template<typename MatType>
+  static void Correlations(const MatType& featureData,
+                           const arma::vec& centeredResponses,
+                           const arma::vec& means,
+                           const arma::vec& coefficients,
+                           arma::vec& correlations);
+
+  /**
+   * Solve for the current value of lambda1, starting from the current
+   * coefficients, with screening relative to the previous value of lambda1.
+   */
+  template<typename MatType>
+  void Solve(const MatType& featureData,
+             const arma::vec& centeredResponses,
+             const arma::vec& means,
+             const double previousLambda1);
+
+  //! Regularization parameter for l1-norm penalty.
+  double lambda1;
+  //! Regularization parameter for l2-norm penalty.
+  double lambda2;
+  //! Whether to fit an intercept.
+  bool fitIntercept;
+  //! Relative tolerance for the change of the objective in one pass.
+  double tolerance;
+  //! Maximum number of passes over the features per solve.
+  size_t maxEpochs;
+  //! The coefficients.
+  arma::vec beta;
+  //! The intercept.
+  double intercept;
+  //! The number of features discarded by screening in the last solve.
+  size_t numScreened;
+};
+
+} // namespace regression
+} // namespace mlpack
+
+// Include implementation.
+#include "elastic_net_impl.hpp"
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @file elastic_net_function.hpp
+ *
+ * The elastic net objective function, restricted to a subset of the features,
+ * for optimization with stochastic coordinate descent (SCD).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ELASTIC_NET_ELASTIC_NET_FUNCTION_HPP
+#define MLPACK_METHODS_ELASTIC_NET_ELASTIC_NET_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace regression {
+
+/**
+ * The elastic net objective
+ *
+ * \f[ f(w) = 0.5 || y - X_c w ||_2^2 + \lambda_1 || w ||_1 +
+ *     0.5 \lambda_2 || w ||_2^2 \f]
+ *
+ * over the coefficients w of a subset of the features (the others are 0),
+ * where X_c is the data with each feature centered by the given means (use
+ * zero means for a model without an intercept).  The data is given one column
+ * per feature (the transpose of the usual mlpack layout) and may be sparse;
+ * the centering is never applied to the data itself.
+ *
+ * The objective is not differentiable, so PartialGradient() returns the
+ * coordinate-wise proximal gradient mapping instead: w_j minus the exact
+ * minimizer of the objective along feature j.  Hence SCD with a step size of 1
+ * performs exact coordinate minimization (the usual coordinate descent for the
+ * elastic net).
+ *
+ * The residual is kept up to date between calls, so each partial gradient
+ * costs time proportional to the number of nonzero elements of the feature.
+ * This assumes (as SCD does) that between two calls to PartialGradient() only
+ * the coordinate of the previous call changed; Evaluate() is always exact.
+ *
+ * @tparam MatType Type of the data matrix (arma::mat or arma::sp_mat).
+ */
+template<typename MatType = arma::mat>
+class ElasticNetFunction
+{
+ public:
+  /**
+   * Create the objective function.  The data and the responses are not copied,
+   * so they must outlive the function.
+   *
+   * @param featureData Data matrix, with one column per feature (and one row
+   *     per point).
+   * @param responses Responses of the points, centered if the means are not
+   *     zero.
+   * @param means Mean of every feature, used to center the data (or zeros, to
+   *     not center it).
+   * @param features Indices of the features (columns) to optimize over.
+   * @param lambda1 Regularization parameter for l1-norm penalty.
+   * @param lambda2 Regularization parameter for l2-norm penalty.
+   * @param initialPoint Initial coefficients of the features (a row vector).
+   */
+  ElasticNetFunction(const MatType& featureData,
+                     const arma::vec& responses,
+                     const arma::vec& means,
+                     const arma::uvec& features,
+                     const double lambda1,
+                     const double lambda2,
+                     const arma::mat& initialPoint);
+
+  /**
+   * Evaluate the objective function with the given coefficients.
+   *
+   * @param coefficients Coefficients of the features (a row vector).
+   */
+  double Evaluate(const arma::mat& coefficients) const;
+
+  /**
+   * Compute the proximal gradient mapping of the objective function with
+   * respect to the coefficient of the given feature: the difference between
+   * the coefficient and the exact minimizer along that coordinate.
+   *
+   * @param coefficients Coefficients of the features (a row vector).
+   * @param j Index of the feature (in the features given to the constructor).
+   * @param gradient Sparse matrix to output the gradient mapping into.
+   */
+  void PartialGradient(const arma::mat& coefficients,
+                       const size_t j,
+                       arma::sp_mat& gradient) const;
+
+  //! Return the initial point for the optimization.
+  const arma::mat& GetInitialPoint() const { return initialPoint; }
+
+  //! Return the number of features optimized over.
+  size_t NumFeatures() const { return features.n_elem; }
+
+ private:
+  //! Update the residual with the change of the coefficient of the previous
+  //! partial gradient.
+  void UpdateResidual(const arma::mat& coefficients) const;
+
+  //! Compute the dot product of a column of a dense matrix with a vector.
+  static double Dot(const arma::mat& data, const size_t column,
+                    const arma::vec& x);
+  //! Compute the dot product of a column of a sparse matrix with a vector.
+  static double Dot(const arma::sp_mat& data, const size_t column,
+                    const arma::vec& x);
+  //! Add a times a column of a dense matrix to a vector.
+  static void Axpy(const double a, const arma::mat& data, const size_t column,
+                   arma::vec& x);
+  //! Add a times a column of a sparse matrix to a vector.
+  static void Axpy(const double a, const arma::sp_mat& data,
+                   const size_t column, arma::vec& x);
+
+  //! The data, one column per feature.
+  const MatType& featureData;
+  //! The (centered) responses.
+  const arma::vec& responses;
+  //! The features to optimize over.
+  arma::uvec features;
+  //! The means of the features to optimize over.
+  arma::vec featureMeans;
+  //! The sums of the (uncentered) features to optimize over.
+  arma::vec columnSums;
+  //! The squared norms of the centered features to optimize over.
+  arma::vec squaredNorms;
+  //! Regularization parameter for l1-norm penalty.
+  double lambda1;
+  //! Regularization parameter for l2-norm penalty.
+  double lambda2;
+  //! The initial point.
+  arma::mat initialPoint;
+
+  //! The residual y - X w of the uncentered data; the residual of the centered
+  //! data is this plus a constant.
+  mutable arma::vec residual;
+  //! The sum of the elements of the residual.
+  mutable double residualSum;
+  //! The feature of the previous partial gradient (or NumFeatures() if none).
+  mutable size_t lastFeature;
+  //! The coefficient of that feature at the previous partial gradient.
+  mutable double lastCoefficient;
+};
+
+} // namespace regression
+} // namespace mlpack
+
+// Include implementation.
+#include "elastic_net_function_impl.hpp"
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file elastic_net_function_impl.hpp
+ *
+ * Implementation of the elastic net objective function.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ELASTIC_NET_ELASTIC_NET_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_ELASTIC_NET_ELASTIC_NET_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "elastic_net_function.hpp"
+
+namespace mlpack {
+namespace regression {
+
+template<typename MatType>
+ElasticNetFunction<MatType>::ElasticNetFunction(
+    const MatType& featureData,
+    const arma::vec& responses,
+    const arma::vec& means,
+    const arma::uvec& features,
+    const double lambda1,
+    const double lambda2,
+    const arma::mat& initialPoint) :
+    featureData(featureData),
+    responses(responses),
+    features(features),
+    featureMeans(means.elem(features)),
+    columnSums(features.n_elem),
+    squaredNorms(features.n_elem),
+    lambda1(lambda1),
+    lambda2(lambda2),
+    initialPoint(initialPoint),
+    residual(responses),
+    lastFeature(features.n_elem),
+    lastCoefficient(0.0)
+{
+  const arma::vec ones(featureData.n_rows, arma::fill::ones);
+  for (size_t k = 0; k < features.n_elem; ++k)
+  {
+    const size_t f = features[k];
+    columnSums[k] = Dot(featureData, f, ones);
+
+    // The squared norm of the centered feature, from the uncentered one.
+    const double norm = arma::accu(arma::square(featureData.col(f)));
+    squaredNorms[k] = norm - 2.0 * featureMeans[k] * columnSums[k] +
+        featureData.n_rows * featureMeans[k] * featureMeans[k];
+
+    if (initialPoint(0, k) != 0.0)
+      Axpy(-initialPoint(0, k), featureData, f, residual);
+  }
+
+  residualSum = arma::accu(residual);
+}
+
+template<typename MatType>
+double ElasticNetFunction<MatType>::Evaluate(const arma::mat& coefficients)
+    const
+{
+  arma::vec r = responses;
+  for (size_t k = 0; k < features.n_elem; ++k)
+  {
+    if (coefficients(0, k) != 0.0)
+      Axpy(-coefficients(0, k), featureData, features[k], r);
+  }
+
+  // The residual of the centered data is r + (means^T w).
+  const double shift = arma::dot(featureMeans, coefficients.row(0).t());
+  const double squaredResidual = arma::dot(r, r) +
+      2.0 * shift * arma::accu(r) + featureData.n_rows * shift * shift;
+
+  return 0.5 * squaredResidual +
+      lambda1 * arma::accu(arma::abs(coefficients)) +
+      0.5 * lambda2 * arma::dot(coefficients, coefficients);
+}
+
+template<typename MatType>
+void ElasticNetFunction<MatType>::PartialGradient(
+    const arma::mat& coefficients,
+    const size_t j,
+    arma::sp_mat& gradient) const
+{
+  UpdateResidual(coefficients);
+
+  // The correlation of the centered feature with the centered residual; the
+  // shift of the residual cancels out, since the centered feature sums to 0
+  // (or the shift is 0 when the data is not centered).
+  const double correlation = Dot(featureData, features[j], residual) -
+      featureMeans[j] * residualSum;
+
+  // The exact minimizer along this coordinate.
+  const double z = correlation + squaredNorms[j] * coefficients(0, j);
+  const double denominator = squaredNorms[j] + lambda2;
+  double minimizer = 0.0;
+  if (denominator > 0.0)
+  {
+    minimizer = (z > 0.0 ? 1.0 : -1.0) *
+        std::max(std::abs(z) - lambda1, 0.0) / denominator;
+  }
+
+  gradient.zeros(coefficients.n_rows, coefficients.n_cols);
+  gradient(0, j) = coefficients(0, j) - minimizer;
+
+  lastFeature = j;
+  lastCoefficient = coefficients(0, j);
+}
+
+template<typename MatType>
+void ElasticNetFunction<MatType>::UpdateResidual(
+    const arma::mat& coefficients) const
+{
+  if (lastFeature >= features.n_elem)
+    return;
+
+  const double delta = coefficients(0, lastFeature) - lastCoefficient;
+  if (delta != 0.0)
+  {
+    Axpy(-delta, featureData, features[lastFeature], residual);
+    residualSum -= delta * columnSums[lastFeature];
+  }
+
+  lastFeature = features.n_elem;
+}
+
+template<typename MatType>
+double ElasticNetFunction<MatType>::Dot(const arma::mat& data,
+                                        const size_t column,
+                                        const arma::vec& x)
+{
+  return arma::dot(data.unsafe_col(column), x);
+}
+
+template<typename MatType>
+double ElasticNetFunction<MatType>::Dot(const arma::sp_mat& data,
+                                        const size_t column,
+                                        const arma::vec& x)
+{
+  data.sync();
+  double result = 0.0;
+  for (size_t i = data.col_ptrs[column]; i < data.col_ptrs[column + 1]; ++i)
+    result += data.values[i] * x[data.row_indices[i]];
+
+  return result;
+}
+
+template<typename MatType>
+void ElasticNetFunction<MatType>::Axpy(const double a,
+                                       const arma::mat& data,
+                                       const size_t column,
+                                       arma::vec& x)
+{
+  x += a * data.unsafe_col(column);
+}
+
+template<typename MatType>
+void ElasticNetFunction<MatType>::Axpy(const double a,
+                                       const arma::sp_mat& data,
+                                       const size_t column,
+                                       arma::vec& x)
+{
+  data.sync();
+  for (size_t i = data.col_ptrs[column]; i < data.col_ptrs[column + 1]; ++i)
+    x[data.row_indices[i]] += a * data.values[i];
+}
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,314 @@
+/**
+ * @file elastic_net_impl.hpp
+ *
+ * Implementation of the ElasticNet class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ELASTIC_NET_ELASTIC_NET_IMPL_HPP
+#define MLPACK_METHODS_ELASTIC_NET_ELASTIC_NET_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "elastic_net.hpp"
+
+namespace mlpack {
+namespace regression {
+
+template<typename DescentPolicyType>
+ElasticNet<DescentPolicyType>::ElasticNet(const double lambda1,
+                                          const double lambda2,
+                                          const bool fitIntercept,
+                                          const double tolerance,
+                                          const size_t maxEpochs) :
+    lambda1(lambda1),
+    lambda2(lambda2),
+    fitIntercept(fitIntercept),
+    tolerance(tolerance),
+    maxEpochs(maxEpochs),
+    intercept(0.0),
+    numScreened(0)
+{ /* Nothing to do. */ }
+
+template<typename DescentPolicyType>
+template<typename MatType>
+ElasticNet<DescentPolicyType>::ElasticNet(const MatType& data,
+                                          const arma::rowvec& responses,
+                                          const double lambda1,
+                                          const double lambda2,
+                                          const bool fitIntercept,
+                                          const double tolerance,
+                                          const size_t maxEpochs) :
+    lambda1(lambda1),
+    lambda2(lambda2),
+    fitIntercept(fitIntercept),
+    tolerance(tolerance),
+    maxEpochs(maxEpochs),
+    intercept(0.0),
+    numScreened(0)
+{
+  Train(data, responses);
+}
+
+template<typename DescentPolicyType>
+template<typename MatType>
+void ElasticNet<DescentPolicyType>::Train(const MatType& data,
+                                          const arma::rowvec& responses,
+                                          const bool warmStart)
+{
+  if (warmStart && beta.n_elem != data.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "ElasticNet::Train(): cannot warm start from " << beta.n_elem
+        << " coefficients with " << data.n_rows << "-dimensional data!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  MatType featureData;
+  arma::vec means, centeredResponses;
+  const double responseMean = Preprocess(data, responses, fitIntercept,
+      featureData, means, centeredResponses);
+
+  // Screen relative to the smallest lambda1 with a zero solution.
+  arma::vec correlations;
+  Correlations(featureData, centeredResponses, means,
+      arma::zeros<arma::vec>(data.n_rows), correlations);
+  const double maxLambda1 = correlations.is_empty() ? 0.0 :
+      arma::max(arma::abs(correlations));
+
+  if (!warmStart)
+    beta.zeros(data.n_rows);
+
+  Solve(featureData, centeredResponses, means, std::max(maxLambda1, lambda1));
+  intercept = fitIntercept ? responseMean - arma::dot(means, beta) : 0.0;
+}
+
+template<typename DescentPolicyType>
+template<typename MatType>
+void ElasticNet<DescentPolicyType>::Path(const MatType& data,
+                                         const arma::rowvec& responses,
+                                         const arma::vec& lambda1Path,
+                                         arma::mat& betaPath,
+                                         arma::rowvec& interceptPath)
+{
+  for (size_t i = 1; i < lambda1Path.n_elem; ++i)
+  {
+    if (lambda1Path[i] > lambda1Path[i - 1])
+    {
+      throw std::invalid_argument("ElasticNet::Path(): the values of lambda1 "
+          "must be decreasing!");
+    }
+  }
+
+  MatType featureData;
+  arma::vec means, centeredResponses;
+  const double responseMean = Preprocess(data, responses, fitIntercept,
+      featureData, means, centeredResponses);
+
+  beta.zeros(data.n_rows);
+  arma::vec correlations;
+  Correlations(featureData, centeredResponses, means, beta, correlations);
+  double previousLambda1 = correlations.is_empty() ? 0.0 :
+      arma::max(arma::abs(correlations));
+
+  betaPath.set_size(data.n_rows, lambda1Path.n_elem);
+  interceptPath.set_size(lambda1Path.n_elem);
+  for (size_t i = 0; i < lambda1Path.n_elem; ++i)
+  {
+    lambda1 = lambda1Path[i];
+    Solve(featureData, centeredResponses, means,
+        std::max(previousLambda1, lambda1));
+    intercept = fitIntercept ? responseMean - arma::dot(means, beta) : 0.0;
+
+    betaPath.col(i) = beta;
+    interceptPath[i] = intercept;
+    previousLambda1 = lambda1;
+
+    Log::Info << "ElasticNet::Path(): lambda1 " << lambda1 << ", "
+        << arma::accu(beta != 0.0) << " nonzero coefficients." << std::endl;
+  }
+}
+
+template<typename DescentPolicyType>
+template<typename MatType>
+void ElasticNet<DescentPolicyType>::Predict(const MatType& points,
+                                            arma::rowvec& predictions) const
+{
+  if (points.n_rows != beta.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "ElasticNet::Predict(): the points have " << points.n_rows
+        << " dimensions, but the model was trained on " << beta.n_elem
+        << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  predictions = beta.t() * points;
+  predictions += intercept;
+}
+
+template<typename DescentPolicyType>
+template<typename MatType>
+double ElasticNet<DescentPolicyType>::MaxLambda1(const MatType& data,
+                                                 const arma::rowvec& responses,
+                                                 const bool fitIntercept)
+{
+  MatType featureData;
+  arma::vec means, centeredResponses;
+  Preprocess(data, responses, fitIntercept, featureData, means,
+      centeredResponses);
+
+  arma::vec correlations;
+  Correlations(featureData, centeredResponses, means,
+      arma::zeros<arma::vec>(data.n_rows), correlations);
+  return correlations.is_empty() ? 0.0 : arma::max(arma::abs(correlations));
+}
+
+template<typename DescentPolicyType>
+template<typename Archive>
+void ElasticNet<DescentPolicyType>::serialize(Archive& ar,
+                                              const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(lambda1);
+  ar & BOOST_SERIALIZATION_NVP(lambda2);
+  ar & BOOST_SERIALIZATION_NVP(fitIntercept);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(maxEpochs);
+  ar & BOOST_SERIALIZATION_NVP(beta);
+  ar & BOOST_SERIALIZATION_NVP(intercept);
+}
+
+template<typename DescentPolicyType>
+template<typename MatType>
+double ElasticNet<DescentPolicyType>::Preprocess(
+    const MatType& data,
+    const arma::rowvec& responses,
+    const bool fitIntercept,
+    MatType& featureData,
+    arma::vec& means,
+    arma::vec& centeredResponses)
+{
+  if (responses.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ElasticNet: the number of responses (" << responses.n_elem
+        << ") does not match the number of points (" << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Each feature is a column of the transposed data.  The data itself is
+  // never centered, so that sparse data stays sparse.
+  featureData = data.t();
+
+  double responseMean = 0.0;
+  if (fitIntercept && data.n_cols > 0)
+  {
+    means = data * arma::ones<arma::vec>(data.n_cols) / data.n_cols;
+    responseMean = arma::mean(responses);
+  }
+  else
+  {
+    means.zeros(data.n_rows);
+  }
+
+  centeredResponses = responses.t() - responseMean;
+  return responseMean;
+}
+
+template<typename DescentPolicyType>
+template<typename MatType>
+void ElasticNet<DescentPolicyType>::Correlations(
+    const MatType& featureData,
+    const arma::vec& centeredResponses,
+    const arma::vec& means,
+    const arma::vec& coefficients,
+    arma::vec& correlations)
+{
+  // The residual of the centered data, y - (X - 1 means^T) beta.
+  arma::vec residual = centeredResponses;
+  if (arma::any(coefficients != 0.0))
+  {
+    residual -= featureData * coefficients;
+    residual += arma::dot(means, coefficients);
+  }
+
+  correlations = arma::trans(residual.t() * featureData);
+  correlations -= arma::accu(residual) * means;
+}
+
+template<typename DescentPolicyType>
+template<typename MatType>
+void ElasticNet<DescentPolicyType>::Solve(const MatType& featureData,
+                                          const arma::vec& centeredResponses,
+                                          const arma::vec& means,
+                                          const double previousLambda1)
+{
+  const size_t dimensionality = featureData.n_cols;
+  const double nullObjective = 0.5 * arma::dot(centeredResponses,
+      centeredResponses);
+  if (nullObjective == 0.0)
+  {
+    // There is nothing to fit.
+    beta.zeros(dimensionality);
+    numScreened = dimensionality;
+    return;
+  }
+
+  // The (sequential) strong rule: keep the nonzero coefficients, and the
+  // features whose correlation is at least 2 lambda1 - previousLambda1.
+  arma::vec correlations;
+  Correlations(featureData, centeredResponses, means, beta, correlations);
+  arma::uvec keep(dimensionality, arma::fill::zeros);
+  const double threshold = 2.0 * lambda1 - previousLambda1;
+  for (size_t j = 0; j < dimensionality; ++j)
+  {
+    if (beta[j] != 0.0 || std::abs(correlations[j]) >= threshold)
+      keep[j] = 1;
+  }
+
+  while (true)
+  {
+    const arma::uvec features = arma::find(keep);
+    numScreened = dimensionality - features.n_elem;
+
+    if (features.n_elem > 0)
+    {
+      // Coordinate descent over the kept features; SCD with a step size of 1
+      // takes the exact minimizer along each coordinate.
+      arma::mat coefficients = arma::trans(beta.elem(features));
+      ElasticNetFunction<MatType> function(featureData, centeredResponses,
+          means, features, lambda1, lambda2, coefficients);
+      optimization::SCD<DescentPolicyType> scd(1.0,
+          maxEpochs * features.n_elem + 1, tolerance * nullObjective,
+          features.n_elem);
+      scd.Optimize(function, coefficients);
+      beta.elem(features) = coefficients.t();
+    }
+
+    // The discarded features must satisfy the KKT conditions
+    // |correlation| <= lambda1; add back the ones that do not.
+    Correlations(featureData, centeredResponses, means, beta, correlations);
+    size_t violations = 0;
+    for (size_t j = 0; j < dimensionality; ++j)
+    {
+      if (keep[j] == 0 && std::abs(correlations[j]) > lambda1)
+      {
+        keep[j] = 1;
+        ++violations;
+      }
+    }
+
+    if (violations == 0)
+      break;
+
+    Log::Info << "ElasticNet: " << violations << " discarded features violate "
+        << "the KKT conditions; solving again." << std::endl;
+  }
+}
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file concurrent_union_find.hpp
+ *
+ * A union-find data structure that several threads can update at the same
+ * time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free union-find structure, with the same interface as UnionFind.
+ * Each point is initially in its own component.  Union(x, y) links the root
+ * with the larger index under the root with the smaller index with an atomic
+ * compare-and-swap, retrying if another thread linked either root first, and
+ * Find(x) compresses paths by halving.  So Union() and Find()
+ * may be called from any number of threads at once, and the index of each
+ * component is the smallest index of the points in it.
+ */
+class ConcurrentUnionFind
+{
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the component containing an element.
+   *
+   * @param x The element to find the component of.
+   * @return The index of the component containing x.
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load();
+      if (p == x)
+        return x;
+
+      // Point x to its grandparent.  If another thread changed the parent of
+      // x meanwhile, that is fine too: parents only move towards the root.
+      const size_t grandparent = parent[p].load();
+      if (grandparent != p)
+        parent[x].compare_exchange_weak(p, grandparent);
+
+      x = grandparent;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x One element.
+   * @param y The other element.
+   * @return Whether this call merged two components, that is, false if x and
+   *     y were already in the same component.
+   */
+  bool Union(size_t x, size_t y)
+  {
+    while (true)
+    {
+      x = Find(x);
+      y = Find(y);
+      if (x == y)
+        return false;
+
+      // Always link the larger root under the smaller one, so no cycles can
+      // form.  This only succeeds if x is still a root.
+      if (x < y)
+        std::swap(x, y);
+
+      size_t expected = x;
+      if (parent[x].compare_exchange_strong(expected, y))
+        return true;
+    }
+  }
+
+ private:
+  //! The parent of each element.
+  std::vector<std::atomic<size_t>> parent;
+};
+
+} // namespace emst
+} // namespace mlpack
+
+#endif
@@ -32,6 +32,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 
 namespace mlpack {
 namespace emst /** Euclidean Minimum Spanning Trees. */ {
@@ -68,6 +69,12 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * With OpenMP, the search for the nearest neighbor of each component in each
+ * Boruvka round is parallelized over disjoint subtrees of the query tree (or
+ * over the query points in naive mode), and the components are merged with a
+ * lock-free union-find.  Trees whose nodes share points with their children
+ * (such as the cover tree) are traversed serially.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -103,7 +110,7 @@ class DualTreeBoruvka
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
   //! Connections.
-  UnionFind connections;
+  ConcurrentUnionFind connections;
 
   //! List of edge nodes.
   arma::Col<size_t> neighborsInComponent;
@@ -178,9 +185,12 @@ class DualTreeBoruvka
 
  private:
   /**
-   * Adds a single edge to the edge list
+   * Adds a single edge to the given edge list.
    */
-  void AddEdge(const size_t e1, const size_t e2, const double distance);
+  static void AddEdge(std::vector<EdgePair>& edgeList,
+                      const size_t e1,
+                      const size_t e2,
+                      const double distance);
 
   /**
    * Adds all the edges found in one iteration to the list of neighbors.
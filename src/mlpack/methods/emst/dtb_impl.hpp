@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_EMST_DTB_IMPL_HPP
 
 #include "dtb_rules.hpp"
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 namespace mlpack {
 namespace emst {
@@ -123,6 +124,11 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
 
   totalDist = 0; // Reset distance.
 
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
   typedef DTBRules<MetricType, Tree> RuleType;
   RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
                  neighborsOutComponent, metric);
@@ -130,15 +136,35 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
   {
     if (naive)
     {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
+      // Full O(N^2) traversal.  Each thread uses its own copy of the rules,
+      // which share the candidate neighbors of the components.
+      size_t baseCases = 0;
+      #pragma omp parallel reduction(+:baseCases)
+      {
+        RuleType threadRules(rules);
+        threadRules.BaseCases() = 0;
+
+        #pragma omp for schedule(dynamic, 64)
+        for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            threadRules.BaseCase(i, j);
+
+        baseCases += threadRules.BaseCases();
+      }
+      rules.BaseCases() += baseCases;
+    }
+    else if (tree::TreeTraits<Tree>::HasSelfChildren || numThreads == 1)
+    {
+      tree::TraverseWithStatistics<Tree::template DualTreeTraverser>(rules,
+          *tree, *tree, "dual-tree Boruvka");
     }
     else
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      // The rules only write the statistics of the query nodes they visit, and
+      // the candidate neighbors of the components, which they update in a
+      // critical section.
+      tree::TraverseWithStatistics<tree::ParallelDualTreeTraverser>(rules,
+          *tree, *tree, "dual-tree Boruvka");
     }
 
     AddAllEdges();
@@ -162,7 +188,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
 }
 
 /**
- * Adds a single edge to the edge list
+ * Adds a single edge to the given edge list.
  */
 template<
     typename MetricType,
@@ -171,6 +197,7 @@ template<
              typename TreeStatType,
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddEdge(
+    std::vector<EdgePair>& edgeList,
     const size_t e1,
     const size_t e2,
     const double distance)
@@ -179,9 +206,9 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::AddEdge(
       "DualTreeBoruvka::AddEdge(): distance cannot be negative.");
 
   if (e1 < e2)
-    edges.push_back(EdgePair(e1, e2, distance));
+    edgeList.push_back(EdgePair(e1, e2, distance));
   else
-    edges.push_back(EdgePair(e2, e1, distance));
+    edgeList.push_back(EdgePair(e2, e1, distance));
 }
 
 /**
@@ -195,20 +222,41 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
 {
+  // Collect the components of this round before any of them are merged.
+  std::vector<size_t> components;
   for (size_t i = 0; i < data.n_cols; i++)
+    if (connections.Find(i) == i)
+      components.push_back(i);
+
+  // Merge each component with its nearest neighbor.  Union() only succeeds
+  // once for two components, even if both chose the same edge or several
+  // threads merge them at once, so an edge is added exactly when it joins two
+  // different components.
+  double roundDist = 0.0;
+  #pragma omp parallel reduction(+:roundDist)
   {
-    size_t component = connections.Find(i);
-    size_t inEdge = neighborsInComponent[component];
-    size_t outEdge = neighborsOutComponent[component];
-    if (connections.Find(inEdge) != connections.Find(outEdge))
+    std::vector<EdgePair> threadEdges;
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) components.size(); ++i)
     {
-      // totalDist = totalDist + dist;
-      // changed to make this agree with the cover tree code
-      totalDist += neighborsDistances[component];
-      AddEdge(inEdge, outEdge, neighborsDistances[component]);
-      connections.Union(inEdge, outEdge);
+      const size_t component = components[i];
+      const size_t inEdge = neighborsInComponent[component];
+      const size_t outEdge = neighborsOutComponent[component];
+      if (connections.Union(inEdge, outEdge))
+      {
+        // totalDist = totalDist + dist;
+        // changed to make this agree with the cover tree code
+        roundDist += neighborsDistances[component];
+        AddEdge(threadEdges, inEdge, outEdge, neighborsDistances[component]);
+      }
     }
+
+    #pragma omp critical
+    edges.insert(edges.end(), threadEdges.begin(), threadEdges.end());
   }
+
+  totalDist += roundDist;
 }
 
 /**
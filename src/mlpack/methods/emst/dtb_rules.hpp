@@ -24,7 +24,7 @@ class DTBRules
 {
  public:
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
+           ConcurrentUnionFind& connections,
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
@@ -102,7 +102,7 @@ class DTBRules
   const arma::mat& dataSet;
 
   //! Stores the tree structure so far
-  UnionFind& connections;
+  ConcurrentUnionFind& connections;
 
   //! The distance to the candidate nearest neighbor for each component.
   arma::vec& neighborsDistances;
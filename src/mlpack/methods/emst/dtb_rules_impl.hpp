@@ -18,7 +18,7 @@ namespace emst {
 template<typename MetricType, typename TreeType>
 DTBRules<MetricType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
+         ConcurrentUnionFind& connections,
          arma::vec& neighborsDistances,
          arma::Col<size_t>& neighborsInComponent,
          arma::Col<size_t>& neighborsOutComponent,
@@ -61,9 +61,17 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
     {
       Log::Assert(queryIndex != referenceIndex);
 
-      neighborsDistances[queryComponentIndex] = distance;
-      neighborsInComponent[queryComponentIndex] = queryIndex;
-      neighborsOutComponent[queryComponentIndex] = referenceIndex;
+      // In a parallel traversal, other threads may hold points of the same
+      // component, so check again while no other thread can update it.
+      #pragma omp critical(dtbUpdateNeighbor)
+      {
+        if (distance < neighborsDistances[queryComponentIndex])
+        {
+          neighborsDistances[queryComponentIndex] = distance;
+          neighborsInComponent[queryComponentIndex] = queryIndex;
+          neighborsOutComponent[queryComponentIndex] = referenceIndex;
+        }
+      }
     }
   }
 
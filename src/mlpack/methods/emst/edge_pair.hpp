@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "union_find.hpp"
+#include "concurrent_union_find.hpp"
 
 namespace mlpack {
 namespace emst {
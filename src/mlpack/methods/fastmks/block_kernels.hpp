@@ -0,0 +1,78 @@
+/**
+ * @file block_kernels.hpp
+ *
+ * Evaluation of a kernel between every query and reference point of two
+ * blocks of points, with the batch Evaluate() functions of the kernels that
+ * have one.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_BLOCK_KERNELS_HPP
+#define MLPACK_METHODS_FASTMKS_BLOCK_KERNELS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+
+namespace mlpack {
+namespace fastmks {
+
+/**
+ * Evaluate the kernel between each reference point and each query point, one
+ * pair at a time.
+ */
+template<typename KernelType, typename QueryMatType, typename ReferenceMatType>
+void BlockKernels(KernelType& kernel,
+                  const QueryMatType& queries,
+                  const ReferenceMatType& references,
+                  arma::mat& kernels,
+                  std::false_type /* hasBatchEvaluate */)
+{
+  kernels.set_size(references.n_cols, queries.n_cols);
+  for (size_t q = 0; q < queries.n_cols; ++q)
+    for (size_t r = 0; r < references.n_cols; ++r)
+      kernels(r, q) = kernel.Evaluate(queries.col(q), references.col(r));
+}
+
+/**
+ * Evaluate the kernel between each reference point and each query point with
+ * the batch Evaluate() function of the kernel (which uses matrix products).
+ */
+template<typename KernelType, typename QueryMatType, typename ReferenceMatType>
+void BlockKernels(KernelType& kernel,
+                  const QueryMatType& queries,
+                  const ReferenceMatType& references,
+                  arma::mat& kernels,
+                  std::true_type /* hasBatchEvaluate */)
+{
+  kernel.Evaluate(references, queries, kernels);
+}
+
+/**
+ * Evaluate the kernel between each reference point and each query point.
+ * Element (r, q) of the result is K(references.col(r), queries.col(q)), so
+ * that the kernel values of each query are contiguous.  Kernels that declare a
+ * batch Evaluate() function in their KernelTraits are evaluated with it.
+ *
+ * @param kernel The kernel to evaluate.
+ * @param queries Block of query points.
+ * @param references Block of reference points.
+ * @param kernels Matrix to store the kernel values in.
+ */
+template<typename KernelType, typename QueryMatType, typename ReferenceMatType>
+void BlockKernels(KernelType& kernel,
+                  const QueryMatType& queries,
+                  const ReferenceMatType& references,
+                  arma::mat& kernels)
+{
+  BlockKernels(kernel, queries, references, kernels,
+      std::integral_constant<bool,
+      mlpack::kernel::KernelTraits<KernelType>::HasBatchEvaluate>());
+}
+
+} // namespace fastmks
+} // namespace mlpack
+
+#endif
@@ -236,7 +236,12 @@ class FastMKS
   //! Get the inner-product metric induced by the given kernel.
   const metric::IPMetric<KernelType>& Metric() const { return metric; }
   //! Modify the inner-product metric induced by the given kernel.
-  metric::IPMetric<KernelType>& Metric() { return metric; }
+  metric::IPMetric<KernelType>& Metric()
+  {
+    // The cached self-kernels may not be valid anymore.
+    referenceKernels.reset();
+    return metric;
+  }
 
   //! Get whether or not single-tree search is used.
   bool SingleMode() const { return singleMode; }
@@ -271,6 +276,44 @@ class FastMKS
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
 
+  //! The square roots of the self-kernels of the reference points; they are
+  //! computed by the first search after the reference set or the kernel
+  //! changes, and reused by the following ones.
+  arma::vec referenceKernels;
+
+  //! Compute the square roots of the self-kernels of the reference points, if
+  //! they are not cached.
+  void ComputeReferenceKernels();
+
+  /**
+   * Run naive search in parallel over blocks of query points.  The kernel is
+   * evaluated between blocks of query and reference points at once, with a
+   * matrix product for the linear and polynomial kernels.
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   * @param sameSet Whether the query set is the reference set, in which case
+   *     points are not returned as their own candidates.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool sameSet);
+
+  /**
+   * Run single-tree search in parallel over blocks of query points; each block
+   * is traversed with its own rules object.  See NaiveSearch() for the
+   * parameters.
+   */
+  void SingleTreeSearch(const MatType& querySet,
+                        const size_t k,
+                        arma::Mat<size_t>& indices,
+                        arma::mat& kernels,
+                        const bool sameSet);
+
   //! Candidate represents a possible candidate point (value, index).
   typedef std::pair<double, size_t> Candidate;
 
@@ -16,6 +16,8 @@
 #include "fastmks.hpp"
 
 #include "fastmks_rules.hpp"
+#include <mlpack/core/tree/traversal_statistics.hpp>
+#include "block_kernels.hpp"
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
@@ -124,7 +126,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const FastMKS& other) :
     setOwner(other.referenceTree == NULL),
     singleMode(other.singleMode),
     naive(other.naive),
-    metric(other.metric)
+    metric(other.metric),
+    referenceKernels(other.referenceKernels)
 {
   // Set reference set correctly.
   if (referenceTree)
@@ -145,7 +148,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
     setOwner(other.setOwner),
     singleMode(other.singleMode),
     naive(other.naive),
-    metric(std::move(other.metric))
+    metric(std::move(other.metric)),
+    referenceKernels(std::move(other.referenceKernels))
 {
   // Clear information from the other.
   other.referenceSet = NULL;
@@ -189,6 +193,10 @@ FastMKS<KernelType, MatType, TreeType>::operator=(const FastMKS& other)
 
   singleMode = other.singleMode;
   naive = other.naive;
+  metric = other.metric;
+  referenceKernels = other.referenceKernels;
+
+  return *this;
 }
 
 template<typename KernelType,
@@ -217,6 +225,7 @@ void FastMKS<KernelType, MatType, TreeType>::Train(const MatType& referenceSet)
 
   this->referenceSet = &referenceSet;
   this->setOwner = false;
+  referenceKernels.reset();
 
   if (!naive)
   {
@@ -241,6 +250,7 @@ void FastMKS<KernelType, MatType, TreeType>::Train(const MatType& referenceSet,
   this->referenceSet = &referenceSet;
   this->metric = metric::IPMetric<KernelType>(kernel);
   this->setOwner = false;
+  referenceKernels.reset();
 
   if (!naive)
   {
@@ -268,6 +278,7 @@ void FastMKS<KernelType, MatType, TreeType>::Train(Tree* tree)
   this->referenceSet = &tree->Dataset();
   this->metric = metric::IPMetric<KernelType>(tree->Metric().Kernel());
   this->setOwner = false;
+  referenceKernels.reset();
 
   if (treeOwner && referenceTree)
     delete referenceTree;
@@ -304,56 +315,17 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, k, indices, kernels, false);
 
     Timer::Stop("computing_products");
-
     return;
   }
 
   // Single-tree implementation.
   if (singleMode)
   {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, querySet, k, metric.Kernel());
-
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
-
-    rules.GetResults(indices, kernels);
+    SingleTreeSearch(querySet, k, indices, kernels,
+        &querySet == referenceSet);
 
     Timer::Stop("computing_products");
     return;
@@ -403,9 +375,8 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   typedef FastMKSRules<KernelType, Tree> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
 
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
+  tree::TraverseWithStatistics<Tree::template DualTreeTraverser>(rules,
+      *queryTree, *referenceTree, "fastmks");
 
   Log::Info << rules.BaseCases() << " base cases." << std::endl;
   Log::Info << rules.Scores() << " scores." << std::endl;
@@ -433,73 +404,188 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
 
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
+    Timer::Stop("computing_products");
+    return;
+  }
 
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
+  // Single-tree implementation.
+  if (singleMode)
+  {
+    SingleTreeSearch(*referenceSet, k, indices, kernels, true);
+
+    Timer::Stop("computing_products");
+    return;
+  }
+
+  // Dual-tree implementation.
+  Timer::Stop("computing_products");
+
+  Search(referenceTree, k, indices, kernels);
+}
 
-        if (eval > pqueue.top().first)
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::ComputeReferenceKernels()
+{
+  // The cache is cleared whenever the reference set or the kernel changes.
+  if (referenceKernels.n_elem == referenceSet->n_cols)
+    return;
+
+  referenceKernels.set_size(referenceSet->n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+  {
+    referenceKernels[i] = std::sqrt(metric.Kernel().Evaluate(
+        referenceSet->col(i), referenceSet->col(i)));
+  }
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool sameSet)
+{
+  // Small blocks of queries keep the kernel values of a block of references in
+  // cache, and give enough blocks to balance the threads.
+  const size_t queryBlockSize = 64;
+  const size_t referenceBlockSize = 1024;
+  const size_t numQueryBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numQueryBlocks; ++b)
+  {
+    const size_t queryBegin = b * queryBlockSize;
+    const size_t queryEnd = std::min(queryBegin + queryBlockSize,
+        (size_t) querySet.n_cols);
+
+    const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+    std::vector<CandidateList> pqueues(queryEnd - queryBegin,
+        CandidateList(CandidateCmp(), std::vector<Candidate>(k, def)));
+
+    arma::mat blockKernels;
+    for (size_t referenceBegin = 0; referenceBegin < referenceSet->n_cols;
+         referenceBegin += referenceBlockSize)
+    {
+      const size_t referenceEnd = std::min(referenceBegin + referenceBlockSize,
+          (size_t) referenceSet->n_cols);
+
+      BlockKernels(metric.Kernel(), querySet.cols(queryBegin, queryEnd - 1),
+          referenceSet->cols(referenceBegin, referenceEnd - 1), blockKernels);
+
+      for (size_t q = 0; q < blockKernels.n_cols; ++q)
+      {
+        CandidateList& pqueue = pqueues[q];
+        for (size_t r = 0; r < blockKernels.n_rows; ++r)
         {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
+          // Don't return the point as its own candidate.
+          if (sameSet && (queryBegin + q == referenceBegin + r))
+            continue;
+
+          const double eval = blockKernels(r, q);
+          if (eval > pqueue.top().first)
+          {
+            pqueue.pop();
+            pqueue.push(std::make_pair(eval, referenceBegin + r));
+          }
         }
       }
+    }
 
+    for (size_t q = 0; q < pqueues.size(); ++q)
+    {
       for (size_t j = 1; j <= k; j++)
       {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
+        indices(k - j, queryBegin + q) = pqueues[q].top().second;
+        kernels(k - j, queryBegin + q) = pqueues[q].top().first;
+        pqueues[q].pop();
       }
     }
+  }
+}
 
-    Timer::Stop("computing_products");
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::SingleTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool sameSet)
+{
+  ComputeReferenceKernels();
 
-    return;
+  arma::vec queryKernels;
+  if (!sameSet)
+  {
+    queryKernels.set_size(querySet.n_cols);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      queryKernels[i] = std::sqrt(metric.Kernel().Evaluate(querySet.col(i),
+          querySet.col(i)));
+    }
   }
+  const arma::vec& allQueryKernels = sameSet ? referenceKernels : queryKernels;
 
-  // Single-tree implementation.
-  if (singleMode)
+  // Each block of queries is traversed with its own rules object; the reference
+  // tree is only read during single-tree search, so it can be shared.
+  typedef FastMKSRules<KernelType, Tree> RuleType;
+  const size_t blockSize = 256;
+  const size_t numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+  size_t baseCases = 0;
+  size_t scores = 0;
+  size_t numPrunes = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:baseCases, scores, numPrunes)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+
+    const MatType queryBlock = querySet.cols(begin, end - 1);
+    const arma::vec blockKernels(const_cast<double*>(
+        allQueryKernels.memptr()) + begin, end - begin, false, true);
 
+    RuleType rules(*referenceSet, queryBlock, k, metric.Kernel(),
+        referenceKernels, blockKernels, sameSet ? begin : size_t(-1));
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+    for (size_t i = 0; i < queryBlock.n_cols; ++i)
       traverser.Traverse(i, *referenceTree);
 
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
-
-    Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
+    arma::Mat<size_t> blockIndices;
+    arma::mat blockProducts;
+    rules.GetResults(blockIndices, blockProducts);
+    indices.cols(begin, end - 1) = blockIndices;
+    kernels.cols(begin, end - 1) = blockProducts;
 
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
-
-    rules.GetResults(indices, kernels);
-
-    Timer::Stop("computing_products");
-    return;
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+    numPrunes += traverser.NumPrunes();
   }
 
-  // Dual-tree implementation.
-  Timer::Stop("computing_products");
-
-  Search(referenceTree, k, indices, kernels);
+  Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
 }
 
 //! Serialize the model.
@@ -517,6 +603,10 @@ void FastMKS<KernelType, MatType, TreeType>::serialize(
   ar & BOOST_SERIALIZATION_NVP(naive);
   ar & BOOST_SERIALIZATION_NVP(singleMode);
 
+  // The self-kernels are not saved.
+  if (Archive::is_loading::value)
+    referenceKernels.reset();
+
   // If we are doing naive search, serialize the dataset.  Otherwise we
   // serialize the tree.
   if (naive)
@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
 #include <boost/heap/priority_queue.hpp>
+#include <unordered_map>
 
 namespace mlpack {
 namespace fastmks {
@@ -48,6 +49,31 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct the FastMKSRules object with precomputed self-kernels, so that
+   * many rules objects (one for each block of queries searched in parallel)
+   * can share them.  The vectors are used without being copied, so they must
+   * outlive the rules object.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param k Number of candidates to search for.
+   * @param kernel Kernel to run FastMKS with.
+   * @param referenceKernels Square roots of the self-kernels of the reference
+   *     points.
+   * @param queryKernels Square roots of the self-kernels of the query points.
+   * @param selfOffset If the query points are reference points, the index of
+   *     the first query point in the reference set (so that points are not
+   *     returned as their own candidates); otherwise, size_t(-1).
+   */
+  FastMKSRules(const typename TreeType::Mat& referenceSet,
+               const typename TreeType::Mat& querySet,
+               const size_t k,
+               KernelType& kernel,
+               const arma::vec& referenceKernels,
+               const arma::vec& queryKernels,
+               const size_t selfOffset);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -162,6 +188,16 @@ class FastMKSRules
   //! The instantiated kernel.
   KernelType& kernel;
 
+  //! The index in the reference set of the first query point, if the query
+  //! points are reference points, and size_t(-1) otherwise.
+  size_t selfOffset;
+
+  //! The kernel values between the current query point and the centroids of
+  //! the reference nodes it was scored with, for parent-child pruning in
+  //! single-tree search.  They are kept here and not in the statistics of the
+  //! reference tree so that many searches can share the tree.
+  std::unordered_map<const TreeType*, double> lastKernels;
+
   //! The last query index BaseCase() was called with.
   size_t lastQueryIndex;
   //! The last reference index BaseCase() was called with.
@@ -169,6 +205,9 @@ class FastMKSRules
   //! The last kernel evaluation resulting from BaseCase().
   double lastKernel;
 
+  //! Initialize the candidates and the traversal information.
+  void Initialize();
+
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
 
@@ -28,6 +28,7 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     querySet(querySet),
     k(k),
     kernel(kernel),
+    selfOffset((&querySet == &referenceSet) ? 0 : size_t(-1)),
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
     lastKernel(0.0),
@@ -45,6 +46,39 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
                                                referenceSet.col(i)));
 
+  Initialize();
+}
+
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const size_t k,
+    KernelType& kernel,
+    const arma::vec& referenceKernels,
+    const arma::vec& queryKernels,
+    const size_t selfOffset) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    k(k),
+    queryKernels(const_cast<double*>(queryKernels.memptr()),
+        queryKernels.n_elem, false, true),
+    referenceKernels(const_cast<double*>(referenceKernels.memptr()),
+        referenceKernels.n_elem, false, true),
+    kernel(kernel),
+    selfOffset(selfOffset),
+    lastQueryIndex(-1),
+    lastReferenceIndex(-1),
+    lastKernel(0.0),
+    baseCases(0),
+    scores(0)
+{
+  Initialize();
+}
+
+template<typename KernelType, typename TreeType>
+void FastMKSRules<KernelType, TreeType>::Initialize()
+{
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
   traversalInfo.LastQueryNode() = (TreeType*) this;
@@ -116,7 +150,8 @@ double FastMKSRules<KernelType, TreeType>::BaseCase(
   // If the reference and query sets are identical, we still need to compute the
   // base case (so that things can be bounded properly), but we won't add it to
   // the results.
-  if ((&querySet == &referenceSet) && (queryIndex == referenceIndex))
+  if ((selfOffset != size_t(-1)) &&
+      (queryIndex + selfOffset == referenceIndex))
     return kernelEval;
 
   InsertNeighbor(queryIndex, referenceIndex, kernelEval);
@@ -132,13 +167,20 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   const double bestKernel = candidates[queryIndex].top().first;
 
   // See if we can perform a parent-child prune.
+  // The parent is scored with the same query point before its children, so
+  // its kernel value is known.
   const double furthestDist = referenceNode.FurthestDescendantDistance();
+  typename std::unordered_map<const TreeType*, double>::const_iterator
+      parentKernel = lastKernels.end();
   if (referenceNode.Parent() != NULL)
+    parentKernel = lastKernels.find(referenceNode.Parent());
+
+  if (parentKernel != lastKernels.end())
   {
     double maxKernelBound;
     const double parentDist = referenceNode.ParentDistance();
     const double combinedDistBound = parentDist + furthestDist;
-    const double lastKernel = referenceNode.Parent()->Stat().LastKernel();
+    const double lastKernel = parentKernel->second;
     if (kernel::KernelTraits<KernelType>::IsNormalized)
     {
       const double squaredDist = std::pow(combinedDistBound, 2.0);
@@ -172,10 +214,10 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   {
     // Could it be that this kernel evaluation has already been calculated?
     if (tree::TreeTraits<TreeType>::HasSelfChildren &&
-        referenceNode.Parent() != NULL &&
+        parentKernel != lastKernels.end() &&
         referenceNode.Point(0) == referenceNode.Parent()->Point(0))
     {
-      kernelEval = referenceNode.Parent()->Stat().LastKernel();
+      kernelEval = parentKernel->second;
     }
     else
     {
@@ -190,7 +232,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
   }
 
-  referenceNode.Stat().LastKernel() = kernelEval;
+  lastKernels[&referenceNode] = kernelEval;
 
   double maxKernel;
   if (kernel::KernelTraits<KernelType>::IsNormalized)
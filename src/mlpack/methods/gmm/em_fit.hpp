@@ -148,19 +148,83 @@ class EMFit
                          arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Run the E-step: compute the responsibility of each component for each
+   * observation into condProb (one row per observation), and return the
+   * log-likelihood of the model.  The observations are processed in parallel
+   * blocks.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param covariances Vector of covariance matrices.
-   * @param weights Vector of a priori weights.
+   * @param observations List of observations.
+   * @param dists Current components of the model.
+   * @param weights Current a priori weights.
+   * @param condProb Matrix to store the responsibilities in.
    */
-  double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
-                           dists,
-                       const arma::vec& weights) const;
+  double Expectation(const arma::mat& observations,
+                     const std::vector<distribution::GaussianDistribution>&
+                         dists,
+                     const arma::vec& weights,
+                     arma::mat& condProb) const;
+
+  /**
+   * Run the M-step: update the means and covariances of the components from
+   * the given (possibly weighted) responsibilities, and store the total
+   * responsibility of each component in probRowSums.  Each thread accumulates
+   * the sufficient statistics of its own blocks of observations.
+   *
+   * @param observations List of observations.
+   * @param condProb Responsibility of each component for each observation.
+   * @param dists Components to update.
+   * @param probRowSums Vector to store the total responsibilities in.
+   */
+  void Maximization(const arma::mat& observations,
+                    const arma::mat& condProb,
+                    std::vector<distribution::GaussianDistribution>& dists,
+                    arma::vec& probRowSums);
+
+  /**
+   * Run EM iterations for a model with diagonal covariances, starting from the
+   * given model.  The means and variances are kept in matrices during the
+   * iterations, so that no covariance matrix is factored until the
+   * distributions are updated at the end.  This is used with the
+   * DiagonalConstraint.
+   *
+   * @param observations List of observations.
+   * @param probabilities Probability of each point being from this model, or
+   *     NULL if every point is certainly from this model.
+   * @param dists Components of the model.
+   * @param weights A priori weights of the model.
+   */
+  void DiagonalEstimate(const arma::mat& observations,
+                        const arma::vec* probabilities,
+                        std::vector<distribution::GaussianDistribution>& dists,
+                        arma::vec& weights);
+
+  //! Run the E-step for diagonal covariances, given as columns of variances.
+  double DiagonalExpectation(const arma::mat& observations,
+                             const arma::mat& means,
+                             const arma::mat& variances,
+                             const arma::vec& weights,
+                             arma::mat& condProb) const;
+
+  //! Run the M-step for diagonal covariances, given as columns of variances.
+  void DiagonalMaximization(const arma::mat& observations,
+                            const arma::mat& condProb,
+                            arma::mat& means,
+                            arma::mat& variances,
+                            arma::vec& probRowSums) const;
+
+  /**
+   * Turn the log-probabilities of the components in rows begin to end of
+   * condProb into responsibilities, and return the log-likelihood of those
+   * observations.  The number of observations that every component gives zero
+   * probability is added to outliers.
+   */
+  static double NormalizeBlock(arma::mat& condProb,
+                               const size_t begin,
+                               const size_t end,
+                               size_t& outliers);
+
+  //! The number of observations in each block processed by one thread.
+  static const size_t blockSize = 1024;
 
   // Armadillo uses uword internally as an OpenMP index type, which crashes
   // Visual Studio.
@@ -42,7 +42,8 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
 {
   // Shortcut: if the user is using the DiagonalConstraint, then we will call
   // out to Armadillo.  But Armadillo uses uword internally as an OpenMP index
-  // type, which crashes Visual Studio, so don't do this on Windows.
+  // type, which crashes Visual Studio, so don't do this on Windows; there, the
+  // diagonal EM iterations below are used instead.
   #ifndef _WIN32
   if (std::is_same<CovarianceConstraintPolicy, DiagonalConstraint>::value)
   {
@@ -55,13 +56,20 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  if (std::is_same<CovarianceConstraintPolicy, DiagonalConstraint>::value)
+  {
+    DiagonalEstimate(observations, NULL, dists, weights);
+    return;
+  }
+
+  // The E-step also gives the log-likelihood of the model.
+  arma::mat condProb(observations.n_cols, dists.size());
+  double l = Expectation(observations, dists, weights, condProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -70,62 +78,19 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0)
-        dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i)));
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0.0)
-      {
-        arma::mat covariance = (tmp * trans(tmpB)) / probRowSums[i];
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
+    // Calculate the new means and covariances using the conditional
+    // probabilities of choosing a particular Gaussian given the observations.
+    arma::vec probRowSums;
+    Maximization(observations, condProb, dists, probRowSums);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
     weights = probRowSums / observations.n_cols;
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate the new log-likelihood and the conditional
+    // probabilities for the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = Expectation(observations, dists, weights, condProb);
 
     iteration++;
   }
@@ -142,70 +107,30 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  if (std::is_same<CovarianceConstraintPolicy, DiagonalConstraint>::value)
+  {
+    DiagonalEstimate(observations, &probabilities, dists, weights);
+    return;
+  }
+
+  arma::mat condProb(observations.n_cols, dists.size());
+  double l = Expectation(observations, dists, weights, condProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      probRowSums[i] = accu(condProb.col(i) % probabilities);
-
-      dists[i].Mean() = (observations * (condProb.col(i) % probabilities)) /
-        probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i) % probabilities));
-
-      arma::mat cov = (tmp * trans(tmpB)) / probRowSums[i];
-
-      // Apply covariance constraint.
-      constraint.ApplyConstraint(cov);
+    // Multiply the conditional probability of each point being from each
+    // Gaussian by the probability of the point being from this mixture model.
+    condProb.each_col() %= probabilities;
 
-      dists[i].Covariance(std::move(cov));
-    }
+    arma::vec probRowSums;
+    Maximization(observations, condProb, dists, probRowSums);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -213,7 +138,7 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
 
     // Update values of l; calculate new log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = Expectation(observations, dists, weights, condProb);
 
     iteration++;
   }
@@ -287,28 +212,342 @@ InitialClustering(const arma::mat& observations,
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Expectation(
     const arma::mat& observations,
     const std::vector<distribution::GaussianDistribution>& dists,
-    const arma::vec& weights) const
+    const arma::vec& weights,
+    arma::mat& condProb) const
+{
+  condProb.set_size(observations.n_cols, dists.size());
+
+  const omp_size_t blocks = (observations.n_cols + blockSize - 1) / blockSize;
+  double logLikelihood = 0.0;
+  size_t outliers = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:logLikelihood, outliers)
+  for (omp_size_t b = 0; b < blocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, size_t(observations.n_cols))
+        - 1;
+    const arma::mat block = observations.cols(begin, end);
+
+    // Store the log-probability of each point under each weighted Gaussian.
+    arma::vec logProbabilities;
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      dists[i].LogProbability(block, logProbabilities);
+      condProb.submat(begin, i, end, i) = logProbabilities +
+          std::log(weights[i]);
+    }
+
+    logLikelihood += NormalizeBlock(condProb, begin, end, outliers);
+  }
+
+  if (outliers > 0)
+    Log::Info << "Likelihood of " << outliers << " points is 0!  They are "
+        << "probably outliers." << std::endl;
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Maximization(
+    const arma::mat& observations,
+    const arma::mat& condProb,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& probRowSums)
 {
-  double logLikelihood = 0;
+  // Store the sum of the probability of each state over all the observations.
+  probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
+
+  const size_t dimensionality = observations.n_rows;
+  const omp_size_t blocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  // Calculate the new value of the means using the conditional probabilities.
+  arma::mat means(dimensionality, dists.size(), arma::fill::zeros);
+  #pragma omp parallel
+  {
+    arma::mat localMeans(dimensionality, dists.size(), arma::fill::zeros);
 
-  arma::vec phis;
-  arma::mat likelihoods(dists.size(), observations.n_cols);
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < blocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          size_t(observations.n_cols)) - 1;
+      localMeans += observations.cols(begin, end) * condProb.rows(begin, end);
+    }
+
+    #pragma omp critical
+    means += localMeans;
+  }
 
   for (size_t i = 0; i < dists.size(); ++i)
   {
-    dists[i].Probability(observations, phis);
-    likelihoods.row(i) = weights(i) * trans(phis);
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probRowSums[i] != 0.0)
+      means.col(i) /= probRowSums[i];
+  }
+
+  // Calculate the new value of the covariances using the conditional
+  // probabilities and the updated means.
+  std::vector<arma::mat> covariances(dists.size(),
+      arma::mat(dimensionality, dimensionality, arma::fill::zeros));
+  #pragma omp parallel
+  {
+    std::vector<arma::mat> localCovariances(dists.size(),
+        arma::mat(dimensionality, dimensionality, arma::fill::zeros));
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < blocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          size_t(observations.n_cols)) - 1;
+      const arma::mat block = observations.cols(begin, end);
+
+      for (size_t i = 0; i < dists.size(); ++i)
+      {
+        if (probRowSums[i] == 0.0)
+          continue;
+
+        const arma::mat diffs = block.each_col() - means.col(i);
+        const arma::mat weightedDiffs = diffs.each_row() %
+            trans(condProb.submat(begin, i, end, i));
+        localCovariances[i] += weightedDiffs * trans(diffs);
+      }
+    }
+
+    #pragma omp critical
+    {
+      for (size_t i = 0; i < dists.size(); ++i)
+        covariances[i] += localCovariances[i];
+    }
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  for (size_t i = 0; i < dists.size(); ++i)
   {
-    if (accu(likelihoods.col(j)) == 0)
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    logLikelihood += log(accu(likelihoods.col(j)));
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probRowSums[i] == 0.0)
+      continue;
+
+    dists[i].Mean() = means.col(i);
+
+    covariances[i] /= probRowSums[i];
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariances[i]);
+    dists[i].Covariance(std::move(covariances[i]));
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+DiagonalEstimate(const arma::mat& observations,
+                 const arma::vec* probabilities,
+                 std::vector<distribution::GaussianDistribution>& dists,
+                 arma::vec& weights)
+{
+  arma::mat means(observations.n_rows, dists.size());
+  arma::mat variances(observations.n_rows, dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    means.col(i) = dists[i].Mean();
+    variances.col(i) = dists[i].Covariance().diag();
+  }
+
+  arma::mat condProb(observations.n_cols, dists.size());
+  double l = DiagonalExpectation(observations, means, variances, weights,
+      condProb);
+
+  Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
+      << l << std::endl;
+
+  const double totalProbability = (probabilities == NULL) ?
+      double(observations.n_cols) : accu(*probabilities);
+  double lOld = -DBL_MAX;
+
+  // Iterate to update the model until no more improvement is found.
+  size_t iteration = 1;
+  while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
+  {
+    Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
+        << "log-likelihood " << l << "." << std::endl;
+
+    if (probabilities != NULL)
+      condProb.each_col() %= *probabilities;
+
+    arma::vec probRowSums;
+    DiagonalMaximization(observations, condProb, means, variances,
+        probRowSums);
+    weights = probRowSums / totalProbability;
+
+    lOld = l;
+    l = DiagonalExpectation(observations, means, variances, weights, condProb);
+
+    iteration++;
+  }
+
+  // Only now are the covariances factored, once for each component.
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    dists[i].Mean() = means.col(i);
+    dists[i].Covariance(arma::diagmat(variances.col(i)));
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+DiagonalExpectation(const arma::mat& observations,
+                    const arma::mat& means,
+                    const arma::mat& variances,
+                    const arma::vec& weights,
+                    arma::mat& condProb) const
+{
+  condProb.set_size(observations.n_cols, means.n_cols);
+
+  // With a diagonal covariance, the log-probability of a point only needs the
+  // inverse variances, and the log-determinant is the sum of the log variances.
+  const arma::mat invVariances = 1.0 / variances;
+  const arma::rowvec logNormalizers = arma::log(trans(weights)) - 0.5 *
+      (observations.n_rows * std::log(2.0 * M_PI) +
+      arma::sum(arma::log(variances), 0));
+
+  const omp_size_t blocks = (observations.n_cols + blockSize - 1) / blockSize;
+  double logLikelihood = 0.0;
+  size_t outliers = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:logLikelihood, outliers)
+  for (omp_size_t b = 0; b < blocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, size_t(observations.n_cols))
+        - 1;
+    const arma::mat block = observations.cols(begin, end);
+
+    for (size_t i = 0; i < means.n_cols; ++i)
+    {
+      const arma::mat diffs = block.each_col() - means.col(i);
+      condProb.submat(begin, i, end, i) = logNormalizers[i] - 0.5 *
+          (trans(arma::square(diffs)) * invVariances.col(i));
+    }
+
+    logLikelihood += NormalizeBlock(condProb, begin, end, outliers);
+  }
+
+  if (outliers > 0)
+    Log::Info << "Likelihood of " << outliers << " points is 0!  They are "
+        << "probably outliers." << std::endl;
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+DiagonalMaximization(const arma::mat& observations,
+                     const arma::mat& condProb,
+                     arma::mat& means,
+                     arma::mat& variances,
+                     arma::vec& probRowSums) const
+{
+  probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
+
+  const omp_size_t blocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  arma::mat newMeans(means.n_rows, means.n_cols, arma::fill::zeros);
+  #pragma omp parallel
+  {
+    arma::mat localMeans(means.n_rows, means.n_cols, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < blocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          size_t(observations.n_cols)) - 1;
+      localMeans += observations.cols(begin, end) * condProb.rows(begin, end);
+    }
+
+    #pragma omp critical
+    newMeans += localMeans;
+  }
+
+  // Don't update if there's no probability of the Gaussian having points.
+  for (size_t i = 0; i < means.n_cols; ++i)
+    if (probRowSums[i] != 0.0)
+      means.col(i) = newMeans.col(i) / probRowSums[i];
+
+  // Only the diagonal of each covariance is needed.
+  arma::mat newVariances(means.n_rows, means.n_cols, arma::fill::zeros);
+  #pragma omp parallel
+  {
+    arma::mat localVariances(means.n_rows, means.n_cols, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < blocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          size_t(observations.n_cols)) - 1;
+      const arma::mat block = observations.cols(begin, end);
+
+      for (size_t i = 0; i < means.n_cols; ++i)
+      {
+        const arma::mat diffs = block.each_col() - means.col(i);
+        localVariances.col(i) += arma::square(diffs) *
+            condProb.submat(begin, i, end, i);
+      }
+    }
+
+    #pragma omp critical
+    newVariances += localVariances;
+  }
+
+  for (size_t i = 0; i < means.n_cols; ++i)
+  {
+    if (probRowSums[i] == 0.0)
+      continue;
+
+    arma::vec variance = newVariances.col(i) / probRowSums[i];
+    DiagonalConstraint::ApplyConstraint(variance);
+    variances.col(i) = variance;
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+NormalizeBlock(arma::mat& condProb,
+               const size_t begin,
+               const size_t end,
+               size_t& outliers)
+{
+  double logLikelihood = 0.0;
+  for (size_t j = begin; j <= end; ++j)
+  {
+    // Subtract the largest log-probability before exponentiating, so that the
+    // probabilities of far away points do not all underflow to 0.
+    const double maxLogProbability = condProb.row(j).max();
+    if (maxLogProbability == -std::numeric_limits<double>::infinity())
+    {
+      // Avoid dividing by zero; if the probability for everything is 0, we
+      // don't want to make it NaN.
+      condProb.row(j).zeros();
+      logLikelihood += maxLogProbability;
+      ++outliers;
+      continue;
+    }
+
+    double probSum = 0.0;
+    for (size_t i = 0; i < condProb.n_cols; ++i)
+    {
+      condProb(j, i) = std::exp(condProb(j, i) - maxLogProbability);
+      probSum += condProb(j, i);
+    }
+
+    condProb.row(j) /= probSum;
+    logLikelihood += maxLogProbability + std::log(probSum);
   }
 
   return logLikelihood;
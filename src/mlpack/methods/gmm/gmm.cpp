@@ -76,6 +76,38 @@ double GMM::Probability(const arma::vec& observation,
   return weights[component] * dists[component].Probability(observation);
 }
 
+/**
+ * Return the log-probability of each of the given observations being from this
+ * GMM.
+ */
+void GMM::LogProbability(const arma::mat& observations,
+                         arma::vec& logProbabilities) const
+{
+  // Score every observation under each component at once, including the prior
+  // of each component.
+  arma::mat componentLogProbabilities(gaussians, observations.n_cols);
+  arma::vec logProbs;
+  for (size_t i = 0; i < gaussians; i++)
+  {
+    dists[i].LogProbability(observations, logProbs);
+    componentLogProbabilities.row(i) = std::log(weights[i]) + trans(logProbs);
+  }
+
+  // Sum the probabilities of the components, shifted by the largest one.
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t j = 0; j < observations.n_cols; j++)
+  {
+    const double maxLogProb = (gaussians == 0) ?
+        -std::numeric_limits<double>::infinity() :
+        componentLogProbabilities.col(j).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+      logProbabilities[j] = maxLogProb;
+    else
+      logProbabilities[j] = maxLogProb + std::log(arma::accu(arma::exp(
+          componentLogProbabilities.col(j) - maxLogProb)));
+  }
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -108,7 +140,16 @@ arma::vec GMM::Random() const
 void GMM::Classify(const arma::mat& observations,
                    arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // Score every observation under each component at once, in log space so that
+  // far away observations are still classified.
+  arma::mat logProbabilities(gaussians, observations.n_cols);
+  arma::vec componentLogProbabilities;
+  for (size_t j = 0; j < gaussians; ++j)
+  {
+    dists[j].LogProbability(observations, componentLogProbabilities);
+    logProbabilities.row(j) = std::log(weights[j]) +
+        trans(componentLogProbabilities);
+  }
 
   // We should not have to fill this with values, because each one should be
   // overwritten.
@@ -116,13 +157,12 @@ void GMM::Classify(const arma::mat& observations,
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
     // Find maximum probability component.
-    double probability = 0;
+    double logProbability = -std::numeric_limits<double>::infinity();
     for (size_t j = 0; j < gaussians; ++j)
     {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (logProbabilities(j, i) >= logProbability)
       {
-        probability = newProb;
+        logProbability = logProbabilities(j, i);
         labels[i] = j;
       }
     }
@@ -18,6 +18,8 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+// This fitting method class can also update a model one chunk at a time.
+#include "online_em_fit.hpp"
 
 namespace mlpack {
 namespace gmm /** Gaussian Mixture Models. */ {
@@ -175,6 +177,32 @@ class GMM
   double Probability(const arma::vec& observation,
                      const size_t component) const;
 
+  /**
+   * Compute the log-probability of each of the given observations (one per
+   * column) under this distribution.  The components are evaluated on all the
+   * observations at once, and combined in log space, so observations far from
+   * every component do not underflow.
+   *
+   * @param observations Observations to evaluate the log-probability of.
+   * @param logProbabilities Vector to store the log-probabilities in.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
+  /**
+   * Compute the probability of each of the given observations (one per column)
+   * under this distribution.
+   *
+   * @param observations Observations to evaluate the probability of.
+   * @param probabilities Vector to store the probabilities in.
+   */
+  void Probability(const arma::mat& observations,
+                   arma::vec& probabilities) const
+  {
+    LogProbability(observations, probabilities);
+    probabilities = arma::exp(probabilities);
+  }
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -242,6 +270,30 @@ class GMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Update the model with chunks of observations read one at a time from the
+   * given loader, using an online fitting method such as OnlineEMFit<>, so
+   * that the observations never have to be in memory at once.  The loader is
+   * called as loader(chunk) with an arma::mat to fill, and returns false when
+   * there are no more chunks.  Unless useExistingModel is true, the first
+   * chunk initializes the model.
+   *
+   * The fitter keeps its state between calls: to checkpoint the fit, serialize
+   * both the GMM and the fitter, and to resume it, load them and call Update()
+   * again with useExistingModel set to true.
+   *
+   * @tparam LoaderType Type of the loader, a callable object.
+   * @tparam FittingType The type of online fitting method.
+   * @param loader Loader to read chunks of observations from.
+   * @param fitter Online fitting method.
+   * @param useExistingModel If true, the existing model is updated.
+   * @return The number of chunks read.
+   */
+  template<typename LoaderType, typename FittingType>
+  size_t Update(LoaderType& loader,
+                FittingType& fitter,
+                const bool useExistingModel = false);
+
   /**
    * Classify the given observations as being from an individual component in
    * this GMM.  The resultant classifications are stored in the 'labels' object,
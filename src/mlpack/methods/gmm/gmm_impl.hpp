@@ -187,6 +187,48 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Update the model with chunks of observations from a loader.
+ */
+template<typename LoaderType, typename FittingType>
+size_t GMM::Update(LoaderType& loader,
+                   FittingType& fitter,
+                   const bool useExistingModel)
+{
+  arma::mat chunk;
+  size_t chunks = 0;
+  bool initialized = useExistingModel;
+  while (loader(chunk))
+  {
+    if (chunk.n_cols == 0)
+      continue;
+
+    if (chunk.n_rows != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "GMM::Update(): chunk has dimensionality " << chunk.n_rows
+          << ", but the model has dimensionality " << dimensionality << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (initialized)
+    {
+      fitter.Step(chunk, dists, weights);
+    }
+    else
+    {
+      fitter.Initialize(chunk, dists, weights);
+      initialized = true;
+    }
+
+    ++chunks;
+  }
+
+  Log::Info << "GMM::Update(): updated the model with " << chunks
+      << " chunks." << std::endl;
+  return chunks;
+}
+
 /**
  * Serialize the object.
  */
@@ -0,0 +1,238 @@
+/**
+ * @file online_em_fit.hpp
+ *
+ * Utility class to fit a GMM with stepwise (online) EM, one chunk of
+ * observations at a time.  Used by GMM::Train<>() and GMM::Update<>().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM with stepwise EM, which does not need all of the
+ * observations at once.  Each step computes the responsibilities of the
+ * components for one chunk of observations, and moves the running sufficient
+ * statistics of the model (the weight, weighted mean, and weighted scatter of
+ * each component) towards the statistics of the chunk with the step size
+ *
+ *   eta_t = (t + 2)^(-stepDecay),
+ *
+ * where t is the number of steps taken so far, and stepDecay is in (0.5, 1].
+ * The sufficient statistics are kept in the form of the model itself, so the
+ * only state of the fitter is the number of steps; to checkpoint a fit,
+ * serialize both the GMM and the fitter, and resume it by loading them and
+ * passing more chunks.  The model is initialized with batch EM (EMFit<>) on
+ * the first chunk.
+ *
+ * This class can be used as the FittingType of GMM::Train(), in which case
+ * the observations are processed in chunks of the given size, for the given
+ * number of passes; with GMM::Update(), chunks can instead be read one at a
+ * time from a loader.  For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{liang2009online,
+ *   title={Online EM for Unsupervised Models},
+ *   author={Liang, P. and Klein, D.},
+ *   booktitle={Proceedings of Human Language Technologies: The 2009 Annual
+ *       Conference of the North American Chapter of the Association for
+ *       Computational Linguistics (NAACL '09)},
+ *   pages={611--619},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * @tparam InitialClusteringType Clustering used by the batch EM that
+ *     initializes the model.
+ * @tparam CovarianceConstraintPolicy Constraint applied to each covariance.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+class OnlineEMFit
+{
+ public:
+  /**
+   * Construct the OnlineEMFit object.
+   *
+   * @param stepDecay Exponent of the decay of the step size, in (0.5, 1].
+   * @param chunkSize Number of observations in each step, when the
+   *     observations are given as one matrix.
+   * @param passes Number of passes over the observations, when they are given
+   *     as one matrix.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint applied to each covariance.
+   */
+  OnlineEMFit(const double stepDecay = 0.6,
+              const size_t chunkSize = 1000,
+              const size_t passes = 1,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a GMM with stepwise EM, processing them in chunks
+   * of ChunkSize() observations, Passes() times.  Unless useInitialModel is
+   * true, the model is first initialized with batch EM on the first chunk and
+   * the number of steps is reset.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions of the model.
+   * @param weights A priori weights of the model.
+   * @param useInitialModel If true, the given model is used as the initial
+   *     model, and the steps continue from the last fit.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a GMM with stepwise EM like above, taking into
+   * account the probability of each observation being from this mixture.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each observation being from this
+   *     model.
+   * @param dists Distributions of the model.
+   * @param weights A priori weights of the model.
+   * @param useInitialModel If true, the given model is used as the initial
+   *     model, and the steps continue from the last fit.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Initialize the model with batch EM on the given chunk of observations,
+   * and reset the number of steps.
+   *
+   * @param chunk Observations to initialize the model with.
+   * @param dists Distributions of the model.
+   * @param weights A priori weights of the model.
+   */
+  void Initialize(const arma::mat& chunk,
+                  std::vector<distribution::GaussianDistribution>& dists,
+                  arma::vec& weights);
+
+  /**
+   * Update the model with one stepwise EM step on the given chunk.
+   *
+   * @param chunk Observations of this step.
+   * @param dists Distributions of the model.
+   * @param weights A priori weights of the model.
+   */
+  void Step(const arma::mat& chunk,
+            std::vector<distribution::GaussianDistribution>& dists,
+            arma::vec& weights);
+
+  /**
+   * Update the model with one stepwise EM step on the given chunk, taking
+   * into account the probability of each observation being from this mixture.
+   *
+   * @param chunk Observations of this step.
+   * @param probabilities Probability of each observation being from this
+   *     model.
+   * @param dists Distributions of the model.
+   * @param weights A priori weights of the model.
+   */
+  void Step(const arma::mat& chunk,
+            const arma::vec& probabilities,
+            std::vector<distribution::GaussianDistribution>& dists,
+            arma::vec& weights);
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the exponent of the decay of the step size.
+  double StepDecay() const { return stepDecay; }
+  //! Modify the exponent of the decay of the step size.
+  double& StepDecay() { return stepDecay; }
+
+  //! Get the number of observations in each step of Estimate().
+  size_t ChunkSize() const { return chunkSize; }
+  //! Modify the number of observations in each step of Estimate().
+  size_t& ChunkSize() { return chunkSize; }
+
+  //! Get the number of passes of Estimate() over the observations.
+  size_t Passes() const { return passes; }
+  //! Modify the number of passes of Estimate() over the observations.
+  size_t& Passes() { return passes; }
+
+  //! Get the number of steps taken since the model was initialized.
+  size_t Steps() const { return steps; }
+  //! Modify the number of steps taken since the model was initialized.
+  size_t& Steps() { return steps; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(stepDecay);
+    ar & BOOST_SERIALIZATION_NVP(chunkSize);
+    ar & BOOST_SERIALIZATION_NVP(passes);
+    ar & BOOST_SERIALIZATION_NVP(steps);
+    ar & BOOST_SERIALIZATION_NVP(clusterer);
+    ar & BOOST_SERIALIZATION_NVP(constraint);
+  }
+
+ private:
+  /**
+   * Run the chunks of the given observations through the stepwise updates;
+   * probabilities may be NULL.
+   */
+  void EstimateChunks(const arma::mat& observations,
+                      const arma::vec* probabilities,
+                      std::vector<distribution::GaussianDistribution>& dists,
+                      arma::vec& weights,
+                      const bool useInitialModel);
+
+  //! Take one step; probabilities may be NULL.
+  void TakeStep(const arma::mat& chunk,
+                const arma::vec* probabilities,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights);
+
+  //! The number of observations in each block processed by one thread.
+  static const size_t blockSize = 1024;
+
+  //! Exponent of the decay of the step size.
+  double stepDecay;
+  //! Number of observations in each step of Estimate().
+  size_t chunkSize;
+  //! Number of passes of Estimate() over the observations.
+  size_t passes;
+  //! Number of steps taken since the model was initialized.
+  size_t steps;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,296 @@
+/**
+ * @file online_em_fit_impl.hpp
+ *
+ * Implementation of stepwise EM for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::OnlineEMFit(
+    const double stepDecay,
+    const size_t chunkSize,
+    const size_t passes,
+    InitialClusteringType clusterer,
+    CovarianceConstraintPolicy constraint) :
+    stepDecay(stepDecay),
+    chunkSize(chunkSize),
+    passes(passes),
+    steps(0),
+    clusterer(clusterer),
+    constraint(constraint)
+{ /* Nothing to do. */ }
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  EstimateChunks(observations, NULL, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    const arma::vec& probabilities,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  EstimateChunks(observations, &probabilities, dists, weights,
+      useInitialModel);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+Initialize(const arma::mat& chunk,
+           std::vector<distribution::GaussianDistribution>& dists,
+           arma::vec& weights)
+{
+  EMFit<InitialClusteringType, CovarianceConstraintPolicy> fitter(300, 1e-10,
+      clusterer, constraint);
+  fitter.Estimate(chunk, dists, weights, false);
+  steps = 0;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Step(
+    const arma::mat& chunk,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights)
+{
+  TakeStep(chunk, NULL, dists, weights);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Step(
+    const arma::mat& chunk,
+    const arma::vec& probabilities,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights)
+{
+  TakeStep(chunk, &probabilities, dists, weights);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+EstimateChunks(const arma::mat& observations,
+               const arma::vec* probabilities,
+               std::vector<distribution::GaussianDistribution>& dists,
+               arma::vec& weights,
+               const bool useInitialModel)
+{
+  if (observations.n_cols == 0)
+    return;
+
+  const size_t step = std::max(chunkSize, size_t(1));
+  size_t begin = 0;
+
+  // Initialize the model with the first chunk, which the first pass then
+  // skips.
+  if (!useInitialModel)
+  {
+    const size_t end = std::min(step, size_t(observations.n_cols)) - 1;
+    if (probabilities == NULL)
+    {
+      Initialize(observations.cols(0, end), dists, weights);
+    }
+    else
+    {
+      EMFit<InitialClusteringType, CovarianceConstraintPolicy> fitter(300,
+          1e-10, clusterer, constraint);
+      fitter.Estimate(observations.cols(0, end), probabilities->subvec(0, end),
+          dists, weights, false);
+      steps = 0;
+    }
+
+    begin = end + 1;
+  }
+
+  for (size_t pass = 0; pass < passes; ++pass, begin = 0)
+  {
+    for (; begin < observations.n_cols; begin += step)
+    {
+      const size_t end = std::min(begin + step, size_t(observations.n_cols))
+          - 1;
+      if (probabilities == NULL)
+      {
+        TakeStep(observations.cols(begin, end), NULL, dists, weights);
+      }
+      else
+      {
+        const arma::vec chunkProbabilities = probabilities->subvec(begin, end);
+        TakeStep(observations.cols(begin, end), &chunkProbabilities, dists,
+            weights);
+      }
+    }
+  }
+
+  Log::Info << "OnlineEMFit::Estimate(): took " << steps << " steps."
+      << std::endl;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy>::TakeStep(
+    const arma::mat& chunk,
+    const arma::vec* probabilities,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights)
+{
+  const double total = (probabilities == NULL) ? double(chunk.n_cols) :
+      accu(*probabilities);
+  if (total == 0.0)
+    return;
+
+  const size_t dimensionality = chunk.n_rows;
+  const size_t k = dists.size();
+  const omp_size_t blocks = (chunk.n_cols + blockSize - 1) / blockSize;
+
+  // Find the responsibility of each component for each point of the chunk,
+  // and the total responsibility and weighted sum of the points of each
+  // component.
+  arma::mat condProb(chunk.n_cols, k);
+  arma::vec chunkWeights(k, arma::fill::zeros);
+  arma::mat chunkSums(dimensionality, k, arma::fill::zeros);
+  #pragma omp parallel
+  {
+    arma::vec localWeights(k, arma::fill::zeros);
+    arma::mat localSums(dimensionality, k, arma::fill::zeros);
+    arma::vec logProbabilities;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < blocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, size_t(chunk.n_cols)) - 1;
+      const arma::mat block = chunk.cols(begin, end);
+
+      for (size_t i = 0; i < k; ++i)
+      {
+        dists[i].LogProbability(block, logProbabilities);
+        condProb.submat(begin, i, end, i) = logProbabilities +
+            std::log(weights[i]);
+      }
+
+      // Normalize each row, subtracting the largest log-probability first so
+      // that the probabilities of far away points do not underflow.  If the
+      // probability for everything is 0, the point is ignored.
+      for (size_t j = begin; j <= end; ++j)
+      {
+        const double maxLogProbability = condProb.row(j).max();
+        if (maxLogProbability == -std::numeric_limits<double>::infinity())
+        {
+          condProb.row(j).zeros();
+          continue;
+        }
+
+        condProb.row(j) = arma::exp(condProb.row(j) - maxLogProbability);
+        condProb.row(j) *= ((probabilities == NULL) ? 1.0 :
+            (*probabilities)[j]) / accu(condProb.row(j));
+      }
+
+      localWeights += trans(arma::sum(condProb.rows(begin, end), 0));
+      localSums += block * condProb.rows(begin, end);
+    }
+
+    #pragma omp critical
+    {
+      chunkWeights += localWeights;
+      chunkSums += localSums;
+    }
+  }
+
+  // Move the weights and means towards those of the chunk.
+  const double eta = std::pow(double(steps + 2), -stepDecay);
+  const arma::vec newWeights = (1.0 - eta) * weights +
+      (eta / total) * chunkWeights;
+  arma::mat newMeans(dimensionality, k);
+  for (size_t i = 0; i < k; ++i)
+  {
+    if (newWeights[i] > 0.0)
+    {
+      newMeans.col(i) = ((1.0 - eta) * weights[i] * dists[i].Mean() +
+          (eta / total) * chunkSums.col(i)) / newWeights[i];
+    }
+    else
+    {
+      newMeans.col(i) = dists[i].Mean();
+    }
+  }
+
+  // Find the weighted scatter of the chunk around the new means.
+  std::vector<arma::mat> scatters(k,
+      arma::mat(dimensionality, dimensionality, arma::fill::zeros));
+  #pragma omp parallel
+  {
+    std::vector<arma::mat> localScatters(k,
+        arma::mat(dimensionality, dimensionality, arma::fill::zeros));
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < blocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, size_t(chunk.n_cols)) - 1;
+      const arma::mat block = chunk.cols(begin, end);
+
+      for (size_t i = 0; i < k; ++i)
+      {
+        if (chunkWeights[i] == 0.0)
+          continue;
+
+        const arma::mat diffs = block.each_col() - newMeans.col(i);
+        const arma::mat weightedDiffs = diffs.each_row() %
+            trans(condProb.submat(begin, i, end, i));
+        localScatters[i] += weightedDiffs * trans(diffs);
+      }
+    }
+
+    #pragma omp critical
+    {
+      for (size_t i = 0; i < k; ++i)
+        scatters[i] += localScatters[i];
+    }
+  }
+
+  // The scatter of the old model around the new mean is its covariance plus
+  // the outer product of the shift of the mean.
+  for (size_t i = 0; i < k; ++i)
+  {
+    if (newWeights[i] == 0.0)
+      continue;
+
+    const arma::vec shift = dists[i].Mean() - newMeans.col(i);
+    arma::mat covariance = ((1.0 - eta) * weights[i] *
+        (dists[i].Covariance() + shift * trans(shift)) +
+        (eta / total) * scatters[i]) / newWeights[i];
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+
+    dists[i].Mean() = newMeans.col(i);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  // Points that no component explains carry no weight, so renormalize.
+  weights = newWeights / accu(newWeights);
+  ++steps;
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,283 @@
+/**
+ * @file tree_em_fit.hpp
+ *
+ * Utility class to fit a GMM with the EM algorithm accelerated by a kd-tree
+ * (multiresolution kd-tree EM).  Used by GMM::Train<>().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_TREE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_TREE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+
+// Default clustering mechanism.
+#include <mlpack/methods/kmeans/kmeans.hpp>
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+#include "tree_em_fit_statistic.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with the EM algorithm, like EMFit, but
+ * the E-step and the M-step are computed on a kd-tree of the observations, as
+ * in the multiresolution kd-tree EM of
+ *
+ * @code
+ * @inproceedings{moore1999very,
+ *   title={Very fast EM-based mixture model clustering using multiresolution
+ *       kd-trees},
+ *   author={Moore, A.W.},
+ *   booktitle={Advances in Neural Information Processing Systems 11},
+ *   pages={543--549},
+ *   year={1999}
+ * }
+ * @endcode
+ *
+ * Each node of the tree caches the number of its points, their centroid, and
+ * their scatter matrix (see TreeEMFitStatistic).  For each node, the
+ * log-probability of each component is bounded over the bounding box of the
+ * node, which bounds the responsibility of each component for every point of
+ * the node.  When the bounds of every component are tighter than the given
+ * responsibility tolerance, all the points of the node are given the
+ * responsibilities of its centroid, and are added to the sufficient
+ * statistics of the components at once.  Components whose responsibility is
+ * certainly below the tolerance divided by the number of components are
+ * ignored in the descendants of the node, like the blacklists of
+ * PellegMooreKMeans.  The remaining points are handled one by one.  The
+ * subtrees are processed in parallel.
+ *
+ * The result is an approximation of EM, whose error is controlled by the
+ * responsibility tolerance (0 gives exact EM, with no pruning); it is fastest
+ * on large datasets of low dimensionality, with well separated components.
+ * The log-likelihood used for the convergence test is exact for the points
+ * that are handled one by one, and a lower bound otherwise.
+ *
+ * The bounds use the extreme eigenvalues of each covariance, so they are
+ * tightest for components that are not too elongated.
+ *
+ * @tparam InitialClusteringType Clustering mechanism for the initial model,
+ *     like for EMFit.
+ * @tparam CovarianceConstraintPolicy Constraint applied to the covariances.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+class TreeEMFit
+{
+ public:
+  //! The type of tree used to accelerate EM.
+  typedef tree::KDTree<metric::EuclideanDistance, TreeEMFitStatistic,
+      arma::mat> TreeType;
+
+  /**
+   * Construct the TreeEMFit object.  Setting the maximum number of iterations
+   * to 0 means that the EM algorithm will iterate until convergence (with the
+   * given tolerance).
+   *
+   * @param maxIterations Maximum number of iterations for EM.
+   * @param tolerance Log-likelihood tolerance required for convergence.
+   * @param responsibilityTolerance Largest difference between the bounds of
+   *     the responsibilities for the points of a node to be handled at once.
+   * @param leafSize Maximum number of points in a leaf of the kd-tree.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Object which applies constraints to the covariances.
+   */
+  TreeEMFit(const size_t maxIterations = 300,
+            const double tolerance = 1e-10,
+            const double responsibilityTolerance = 0.01,
+            const size_t leafSize = 20,
+            InitialClusteringType clusterer = InitialClusteringType(),
+            CovarianceConstraintPolicy constraint =
+                CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM).  The size of the
+   * vectors (indicating the number of components) must already be set.  If
+   * useInitialModel is set to true, then the given model is used as the
+   * initial model, instead of using the InitialClusteringType::Cluster()
+   * option.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Vector to store the trained components in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM), taking into
+   * account the probability of each point being from this mixture.  The size
+   * of the vectors (indicating the number of components) must already be set.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Vector to store the trained components in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the maximum number of iterations of the EM algorithm.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of the EM algorithm.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of the EM algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of the EM algorithm.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the tolerance on the responsibilities for pruning a node.
+  double ResponsibilityTolerance() const { return responsibilityTolerance; }
+  //! Modify the tolerance on the responsibilities for pruning a node.
+  double& ResponsibilityTolerance() { return responsibilityTolerance; }
+
+  //! Get the maximum number of points in a leaf of the kd-tree.
+  size_t LeafSize() const { return leafSize; }
+  //! Modify the maximum number of points in a leaf of the kd-tree.
+  size_t& LeafSize() { return leafSize; }
+
+  //! Get the number of points handled one by one during the last Estimate().
+  size_t BaseCases() const { return baseCases; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! The cached parameters of a component during an iteration.
+  struct Component
+  {
+    //! The mean of the component.
+    arma::vec mean;
+    //! The inverse of the covariance.
+    arma::mat invCov;
+    //! log(weight) - (d log(2 pi) + log(det(covariance))) / 2.
+    double logNormalizer;
+    //! The smallest eigenvalue of the inverse covariance.
+    double minInvEigenvalue;
+    //! The largest eigenvalue of the inverse covariance.
+    double maxInvEigenvalue;
+  };
+
+  //! The sufficient statistics accumulated during an E-step.
+  struct Accumulator
+  {
+    //! The total responsibility of each component.
+    arma::vec weights;
+    //! The sum of the responsibilities times the offsets to the old means.
+    arma::mat sums;
+    //! The same sum for the outer products of the offsets.
+    std::vector<arma::mat> scatters;
+    //! The log-likelihood of the observations.
+    double logLikelihood;
+    //! The number of points handled one by one.
+    size_t baseCases;
+
+    //! Set the statistics to 0.
+    void Reset(const size_t dimensionality, const size_t numComponents);
+    //! Add another accumulator.
+    void Add(const Accumulator& other);
+  };
+
+  /**
+   * Run EM iterations on the given tree, starting from the given model.
+   *
+   * @param tree Tree of the observations, with up to date statistics.
+   * @param pointWeights Weight of each point in the order of the tree's
+   *     dataset, or NULL if every point has weight 1.
+   * @param dists Components of the model.
+   * @param weights A priori weights of the model.
+   */
+  void Iterate(TreeType& tree,
+               const arma::vec* pointWeights,
+               std::vector<distribution::GaussianDistribution>& dists,
+               arma::vec& weights);
+
+  /**
+   * Run the E-step on the whole tree, accumulating the sufficient statistics
+   * of the components.
+   */
+  void Expectation(TreeType& tree,
+                   const arma::vec* pointWeights,
+                   const std::vector<Component>& components,
+                   Accumulator& accumulator) const;
+
+  /**
+   * Run the E-step on the given node.  If frontier is not NULL, the nodes with
+   * at most frontierSize descendants that can't be pruned are added to it
+   * instead of being processed.
+   *
+   * @param node Node to process.
+   * @param live Components which may have some responsibility for the node.
+   * @param pointWeights Weight of each point, or NULL.
+   * @param components Components of the model.
+   * @param accumulator Statistics to update.
+   * @param frontier Nodes to process later, with their live components.
+   * @param frontierSize Largest number of points in a node of the frontier.
+   */
+  void Traverse(TreeType& node,
+                const std::vector<size_t>& live,
+                const arma::vec* pointWeights,
+                const std::vector<Component>& components,
+                Accumulator& accumulator,
+                std::vector<std::pair<TreeType*, std::vector<size_t>>>*
+                    frontier,
+                const size_t frontierSize) const;
+
+  /**
+   * Run the clusterer, and then turn the cluster assignments into Gaussians.
+   */
+  void InitialClustering(const arma::mat& observations,
+                         std::vector<distribution::GaussianDistribution>& dists,
+                         arma::vec& weights);
+
+  //! Maximum iterations of EM algorithm.
+  size_t maxIterations;
+  //! Tolerance for convergence of EM.
+  double tolerance;
+  //! Tolerance on the responsibilities for pruning a node.
+  double responsibilityTolerance;
+  //! Maximum number of points in a leaf.
+  size_t leafSize;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+  //! The number of points handled one by one during the last Estimate().
+  size_t baseCases;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "tree_em_fit_impl.hpp"
+
+#endif
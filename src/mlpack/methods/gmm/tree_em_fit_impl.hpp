@@ -0,0 +1,446 @@
+/**
+ * @file tree_em_fit_impl.hpp
+ *
+ * Implementation of the tree-accelerated EM algorithm for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_TREE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_TREE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "tree_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::TreeEMFit(
+    const size_t maxIterations,
+    const double tolerance,
+    const double responsibilityTolerance,
+    const size_t leafSize,
+    InitialClusteringType clusterer,
+    CovarianceConstraintPolicy constraint) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    responsibilityTolerance(responsibilityTolerance),
+    leafSize(leafSize),
+    clusterer(clusterer),
+    constraint(constraint),
+    baseCases(0)
+{ /* Nothing to do. */ }
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  if (!useInitialModel)
+    InitialClustering(observations, dists, weights);
+
+  TreeType tree(observations, leafSize);
+  Iterate(tree, NULL, dists, weights);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    const arma::vec& probabilities,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  if (!useInitialModel)
+    InitialClustering(observations, dists, weights);
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(observations, oldFromNew, leafSize);
+
+  // The statistics were built with weight 1 for every point; compute them
+  // again with the probabilities, in the order of the tree's dataset.
+  arma::vec pointWeights(probabilities.n_elem);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    pointWeights[i] = probabilities[oldFromNew[i]];
+
+  std::vector<TreeType*> nodes(1, &tree);
+  for (size_t i = 0; i < nodes.size(); ++i)
+    for (size_t j = 0; j < nodes[i]->NumChildren(); ++j)
+      nodes.push_back(&nodes[i]->Child(j));
+  // Children come after their parents, so update in reverse order.
+  for (size_t i = nodes.size(); i > 0; --i)
+    nodes[i - 1]->Stat().Update(*nodes[i - 1], &pointWeights);
+
+  Iterate(tree, &pointWeights, dists, weights);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Iterate(
+    TreeType& tree,
+    const arma::vec* pointWeights,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights)
+{
+  const size_t dimensionality = tree.Dataset().n_rows;
+  const double totalWeight = tree.Stat().Weight();
+  std::vector<Component> components(dists.size());
+  Accumulator accumulator;
+  baseCases = 0;
+
+  double l = -DBL_MAX;
+  double lOld;
+  size_t iteration = 0;
+  while (true)
+  {
+    // Cache the inverse of each covariance, its extreme eigenvalues, and the
+    // normalizing constant of each component.
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      arma::vec eigenvalues;
+      arma::mat eigenvectors;
+      arma::eig_sym(eigenvalues, eigenvectors, dists[i].Covariance());
+
+      components[i].mean = dists[i].Mean();
+      components[i].invCov = eigenvectors *
+          arma::diagmat(1.0 / eigenvalues) * eigenvectors.t();
+      components[i].logNormalizer = std::log(weights[i]) - 0.5 *
+          (dimensionality * std::log(2.0 * M_PI) +
+          arma::accu(arma::log(eigenvalues)));
+      components[i].minInvEigenvalue = 1.0 / eigenvalues.max();
+      components[i].maxInvEigenvalue = 1.0 / eigenvalues.min();
+    }
+
+    Expectation(tree, pointWeights, components, accumulator);
+    baseCases += accumulator.baseCases;
+    lOld = l;
+    l = accumulator.logLikelihood;
+
+    if (iteration > 0)
+    {
+      Log::Info << "TreeEMFit::Estimate(): iteration " << iteration << ", "
+          << "log-likelihood " << l << "." << std::endl;
+    }
+    else
+    {
+      Log::Debug << "TreeEMFit::Estimate(): initial clustering log-likelihood: "
+          << l << std::endl;
+    }
+
+    if ((iteration > 0 && std::abs(l - lOld) <= tolerance) ||
+        ++iteration == maxIterations)
+      break;
+
+    // The M-step: the sums are offsets from the old means, which keeps the
+    // covariances accurate.
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      // Don't update if there's no probability of the Gaussian having points.
+      const double w = accumulator.weights[i];
+      if (w == 0.0)
+        continue;
+
+      const arma::vec shift = accumulator.sums.col(i) / w;
+      arma::mat covariance = accumulator.scatters[i] / w - shift * shift.t();
+      constraint.ApplyConstraint(covariance);
+
+      dists[i].Mean() = components[i].mean + shift;
+      dists[i].Covariance(std::move(covariance));
+    }
+
+    weights = accumulator.weights / totalWeight;
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Expectation(
+    TreeType& tree,
+    const arma::vec* pointWeights,
+    const std::vector<Component>& components,
+    Accumulator& accumulator) const
+{
+  const size_t dimensionality = tree.Dataset().n_rows;
+  accumulator.Reset(dimensionality, components.size());
+
+  std::vector<size_t> live(components.size());
+  for (size_t i = 0; i < live.size(); ++i)
+    live[i] = i;
+
+  // Traverse the top of the tree, collecting the subtrees that can't be
+  // pruned there; those are then processed in parallel.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  const size_t frontierSize = std::max(leafSize,
+      (size_t) tree.NumDescendants() / (16 * numThreads));
+  std::vector<std::pair<TreeType*, std::vector<size_t>>> frontier;
+  Traverse(tree, live, pointWeights, components, accumulator, &frontier,
+      frontierSize);
+
+  #pragma omp parallel
+  {
+    Accumulator localAccumulator;
+    localAccumulator.Reset(dimensionality, components.size());
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+    {
+      Traverse(*frontier[i].first, frontier[i].second, pointWeights,
+          components, localAccumulator, NULL, 0);
+    }
+
+    #pragma omp critical
+    accumulator.Add(localAccumulator);
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Traverse(
+    TreeType& node,
+    const std::vector<size_t>& live,
+    const arma::vec* pointWeights,
+    const std::vector<Component>& components,
+    Accumulator& accumulator,
+    std::vector<std::pair<TreeType*, std::vector<size_t>>>* frontier,
+    const size_t frontierSize) const
+{
+  const TreeEMFitStatistic& stat = node.Stat();
+  if (stat.Weight() == 0.0)
+    return;
+
+  // Bound the log-probability of each live component over the bounding box.
+  const size_t n = live.size();
+  arma::vec lo(n), hi(n);
+  for (size_t k = 0; k < n; ++k)
+  {
+    const Component& c = components[live[k]];
+    const double minDistance = node.MinDistance(c.mean);
+    const double maxDistance = node.MaxDistance(c.mean);
+    hi[k] = c.logNormalizer - 0.5 * c.minInvEigenvalue * minDistance *
+        minDistance;
+    lo[k] = c.logNormalizer - 0.5 * c.maxInvEigenvalue * maxDistance *
+        maxDistance;
+  }
+
+  // The responsibility of component k is at least
+  //   exp(lo_k) / (exp(lo_k) + sum_{i != k} exp(hi_i))
+  // and at most
+  //   exp(hi_k) / (exp(hi_k) + sum_{i != k} exp(lo_i)).
+  // The sums over the other components are taken from prefix and suffix sums,
+  // so that nothing cancels.
+  const double maxHi = hi.max();
+  const double maxLo = lo.max();
+  arma::vec prefixHi(n + 1), suffixHi(n + 1), prefixLo(n + 1), suffixLo(n + 1);
+  prefixHi[0] = prefixLo[0] = suffixHi[n] = suffixLo[n] = 0.0;
+  for (size_t k = 0; k < n; ++k)
+  {
+    prefixHi[k + 1] = prefixHi[k] + std::exp(hi[k] - maxHi);
+    prefixLo[k + 1] = prefixLo[k] + std::exp(lo[k] - maxLo);
+    suffixHi[n - k - 1] = suffixHi[n - k] + std::exp(hi[n - k - 1] - maxHi);
+    suffixLo[n - k - 1] = suffixLo[n - k] + std::exp(lo[n - k - 1] - maxLo);
+  }
+
+  std::vector<size_t> childLive;
+  bool prunable = true;
+  for (size_t k = 0; k < n; ++k)
+  {
+    const double otherHi = prefixHi[k] + suffixHi[k + 1];
+    const double otherLo = prefixLo[k] + suffixLo[k + 1];
+    const double minResponsibility = 1.0 / (1.0 + otherHi *
+        std::exp(maxHi - lo[k]));
+    const double maxResponsibility = 1.0 / (1.0 + otherLo *
+        std::exp(maxLo - hi[k]));
+
+    // Components with a negligible responsibility for every point of the node
+    // are ignored below it.
+    if (maxResponsibility < responsibilityTolerance / components.size())
+      continue;
+
+    childLive.push_back(live[k]);
+    if (maxResponsibility - minResponsibility >= responsibilityTolerance)
+      prunable = false;
+  }
+
+  // With a tolerance of 1 or more, every component could be ignored.
+  if (childLive.empty())
+    childLive = live;
+
+  if (prunable || childLive.size() == 1)
+  {
+    // Give every point the responsibilities of the centroid.
+    arma::vec logProbabilities(childLive.size());
+    for (size_t k = 0; k < childLive.size(); ++k)
+    {
+      const Component& c = components[childLive[k]];
+      const arma::vec offset = stat.Centroid() - c.mean;
+      logProbabilities[k] = c.logNormalizer - 0.5 *
+          arma::dot(offset, c.invCov * offset);
+    }
+    arma::vec responsibilities = arma::exp(logProbabilities -
+        logProbabilities.max());
+    responsibilities /= arma::accu(responsibilities);
+
+    const double w = stat.Weight();
+    for (size_t k = 0; k < childLive.size(); ++k)
+    {
+      const double r = responsibilities[k];
+      if (r == 0.0)
+        continue;
+
+      // The log-likelihood of the node is the expectation of
+      // log(p_k(x) / r_k) under the responsibilities; the sum of the
+      // quadratic terms over the points comes from the scatter matrix.
+      const size_t i = childLive[k];
+      const Component& c = components[i];
+      const arma::vec offset = stat.Centroid() - c.mean;
+      const double quadratic = arma::accu(c.invCov % stat.Scatter()) +
+          w * arma::dot(offset, c.invCov * offset);
+      accumulator.logLikelihood += r * (w * (c.logNormalizer - std::log(r)) -
+          0.5 * quadratic);
+
+      accumulator.weights[i] += r * w;
+      accumulator.sums.col(i) += (r * w) * offset;
+      accumulator.scatters[i] += r * (stat.Scatter() +
+          w * (offset * offset.t()));
+    }
+
+    return;
+  }
+
+  if (frontier != NULL && node.NumDescendants() <= frontierSize)
+  {
+    frontier->push_back(std::make_pair(&node, childLive));
+    return;
+  }
+
+  if (!node.IsLeaf())
+  {
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      Traverse(node.Child(i), childLive, pointWeights, components, accumulator,
+          frontier, frontierSize);
+    }
+    return;
+  }
+
+  // Handle the points of the leaf one by one.
+  arma::vec logProbabilities(childLive.size());
+  for (size_t j = 0; j < node.NumPoints(); ++j)
+  {
+    const size_t index = node.Point(j);
+    const double w = (pointWeights == NULL) ? 1.0 : (*pointWeights)[index];
+    if (w == 0.0)
+      continue;
+
+    const arma::vec point = node.Dataset().col(index);
+    for (size_t k = 0; k < childLive.size(); ++k)
+    {
+      const Component& c = components[childLive[k]];
+      const arma::vec offset = point - c.mean;
+      logProbabilities[k] = c.logNormalizer - 0.5 *
+          arma::dot(offset, c.invCov * offset);
+    }
+
+    const double maxLogProbability = logProbabilities.max();
+    const arma::vec probabilities = arma::exp(logProbabilities -
+        maxLogProbability);
+    const double probabilitySum = arma::accu(probabilities);
+    accumulator.logLikelihood += w * (maxLogProbability +
+        std::log(probabilitySum));
+    ++accumulator.baseCases;
+
+    for (size_t k = 0; k < childLive.size(); ++k)
+    {
+      const double r = w * probabilities[k] / probabilitySum;
+      const size_t i = childLive[k];
+      const arma::vec offset = point - components[i].mean;
+      accumulator.weights[i] += r;
+      accumulator.sums.col(i) += r * offset;
+      accumulator.scatters[i] += r * (offset * offset.t());
+    }
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+InitialClustering(const arma::mat& observations,
+                  std::vector<distribution::GaussianDistribution>& dists,
+                  arma::vec& weights)
+{
+  arma::Row<size_t> assignments;
+  clusterer.Cluster(observations, dists.size(), assignments);
+
+  weights.zeros(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const arma::uvec members = arma::find(assignments == i);
+    arma::vec mean(observations.n_rows, arma::fill::zeros);
+    arma::mat covariance(observations.n_rows, observations.n_rows,
+        arma::fill::zeros);
+    if (members.n_elem > 0)
+    {
+      const arma::mat points = observations.cols(members);
+      mean = arma::mean(points, 1);
+      const arma::mat offsets = points.each_col() - mean;
+      covariance = offsets * offsets.t() / members.n_elem;
+    }
+
+    // Apply constraints to covariance matrix.
+    constraint.ApplyConstraint(covariance);
+
+    dists[i].Mean() = std::move(mean);
+    dists[i].Covariance(std::move(covariance));
+    weights[i] = members.n_elem;
+  }
+
+  weights /= arma::accu(weights);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+Accumulator::Reset(const size_t dimensionality, const size_t numComponents)
+{
+  weights.zeros(numComponents);
+  sums.zeros(dimensionality, numComponents);
+  scatters.assign(numComponents,
+      arma::mat(dimensionality, dimensionality, arma::fill::zeros));
+  logLikelihood = 0.0;
+  baseCases = 0;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+Accumulator::Add(const Accumulator& other)
+{
+  weights += other.weights;
+  sums += other.sums;
+  for (size_t i = 0; i < scatters.size(); ++i)
+    scatters[i] += other.scatters[i];
+  logLikelihood += other.logLikelihood;
+  baseCases += other.baseCases;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename Archive>
+void TreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(responsibilityTolerance);
+  ar & BOOST_SERIALIZATION_NVP(leafSize);
+  ar & BOOST_SERIALIZATION_NVP(clusterer);
+  ar & BOOST_SERIALIZATION_NVP(constraint);
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file tree_em_fit_statistic.hpp
+ *
+ * A StatisticType for trees which caches the sufficient statistics of the
+ * points in each node, for the tree-accelerated EM algorithm of TreeEMFit.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_TREE_EM_FIT_STATISTIC_HPP
+#define MLPACK_METHODS_GMM_TREE_EM_FIT_STATISTIC_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * A statistic for trees which holds the (weighted) number of points in the
+ * node, their centroid, and their scatter matrix around the centroid.  These
+ * are enough to add the contribution of all the points of a node to the
+ * sufficient statistics of a Gaussian, if they share the same
+ * responsibilities.  The statistics of a node are computed from those of its
+ * children, so the tree must be built depth-first.
+ */
+class TreeEMFitStatistic
+{
+ public:
+  //! Initialize the statistic without a node (this does nothing).
+  TreeEMFitStatistic() : weight(0.0) { }
+
+  //! Initialize the statistic for a node, where every point has weight 1.
+  template<typename TreeType>
+  TreeEMFitStatistic(TreeType& node) : weight(0.0)
+  {
+    Update(node, NULL);
+  }
+
+  /**
+   * Compute the statistics of the node from those of its children (which must
+   * be up to date) and its points.
+   *
+   * @param node The node this statistic belongs to.
+   * @param weights Weight of each point (in the order of the tree's dataset),
+   *     or NULL if every point has weight 1.
+   */
+  template<typename TreeType>
+  void Update(TreeType& node, const arma::vec* weights)
+  {
+    const size_t dimensionality = node.Dataset().n_rows;
+    weight = 0.0;
+    centroid.zeros(dimensionality);
+    scatter.zeros(dimensionality, dimensionality);
+
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      const TreeEMFitStatistic& child = node.Child(i).Stat();
+      weight += child.Weight();
+      centroid += child.Weight() * child.Centroid();
+    }
+    for (size_t i = 0; i < node.NumPoints(); ++i)
+    {
+      const double w = (weights == NULL) ? 1.0 : (*weights)[node.Point(i)];
+      weight += w;
+      centroid += w * node.Dataset().col(node.Point(i));
+    }
+
+    if (weight == 0.0)
+      return;
+    centroid /= weight;
+
+    // Combine the scatters of the children around the new centroid.
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      const TreeEMFitStatistic& child = node.Child(i).Stat();
+      const arma::vec offset = child.Centroid() - centroid;
+      scatter += child.Scatter() + child.Weight() * (offset * offset.t());
+    }
+    for (size_t i = 0; i < node.NumPoints(); ++i)
+    {
+      const double w = (weights == NULL) ? 1.0 : (*weights)[node.Point(i)];
+      const arma::vec offset = node.Dataset().col(node.Point(i)) - centroid;
+      scatter += w * (offset * offset.t());
+    }
+  }
+
+  //! Get the total weight of the points in the node.
+  double Weight() const { return weight; }
+  //! Get the weighted centroid of the points in the node.
+  const arma::vec& Centroid() const { return centroid; }
+  //! Get the weighted scatter matrix of the points around the centroid.
+  const arma::mat& Scatter() const { return scatter; }
+
+ private:
+  //! The total weight of the points in the node.
+  double weight;
+  //! The weighted centroid of the points.
+  arma::vec centroid;
+  //! The weighted sum of the outer products of the offsets to the centroid.
+  arma::mat scatter;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
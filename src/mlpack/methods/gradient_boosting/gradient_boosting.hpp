@@ -0,0 +1,361 @@
+/**
+ * @file gradient_boosting.hpp
+ *
+ * Definition of the GradientBoosting class, a gradient boosted decision tree
+ * classifier.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/all_dimension_select.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * GradientBoosting is a gradient boosted decision tree classifier.  At each
+ * boosting round one regression tree per output (one output for two classes,
+ * with the logistic loss, and one per class otherwise, with the softmax loss)
+ * is fit to the gradients and hessians of the loss, and its leaves hold the
+ * Newton step -G / (H + lambda) scaled by the learning rate.  The split search
+ * is histogram-based: each dimension is cut into at most maxBins bins at the
+ * quantiles of the training data before training, and the gradients of the
+ * points of a node are accumulated into the bins of each dimension, as
+ * HistogramNumericSplit does for DecisionTree.
+ *
+ * Each round can be trained on a random subsample of the points
+ * (subsampleRatio) and each tree on a random subset of the dimensions
+ * (featureRatio); the DimensionSelectionType then picks the dimensions to
+ * search at each node, as for DecisionTree.  If a validation set is given to
+ * Train(), training stops once the validation log-loss has not improved for
+ * earlyStoppingRounds rounds, and the trees after the best round are dropped.
+ *
+ * With OpenMP, the gradients and scores are computed in parallel over the
+ * points, and the splits of each node are searched in parallel over the
+ * dimensions; the trained model does not depend on the number of threads.  The
+ * trees are stored in one contiguous node array, and Classify() walks every
+ * tree for a block of points at a time, with the blocks in parallel.  For
+ * example,
+ *
+ * @code
+ * GradientBoosting<> gb(200, 0.1);
+ * gb.Train(data, labels, numClasses, validationData, validationLabels, 10);
+ * gb.Classify(testData, predictions, probabilities);
+ * @endcode
+ *
+ * Only numeric dimensions are supported.
+ *
+ * @tparam DimensionSelectionType Strategy to select the dimensions to search
+ *     at each node, among the dimensions sampled for the tree.
+ */
+template<typename DimensionSelectionType = AllDimensionSelect>
+class GradientBoosting
+{
+ public:
+  /**
+   * Create the GradientBoosting object with the given parameters.  Classify()
+   * will throw an exception until Train() is called.
+   *
+   * @param numRounds Maximum number of boosting rounds.
+   * @param learningRate Shrinkage applied to the leaves of each tree.
+   * @param maximumDepth Maximum depth of each tree (0 for no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param lambda L2 regularization of the leaf values.
+   * @param minimumGain Minimum gain of a split.
+   * @param subsampleRatio Fraction of the points each round is trained on.
+   * @param featureRatio Fraction of the dimensions each tree is trained on.
+   * @param maxBins Maximum number of histogram bins per dimension (at most
+   *     256).
+   */
+  GradientBoosting(const size_t numRounds = 100,
+                   const double learningRate = 0.1,
+                   const size_t maximumDepth = 6,
+                   const size_t minimumLeafSize = 20,
+                   const double lambda = 1.0,
+                   const double minimumGain = 0.0,
+                   const double subsampleRatio = 1.0,
+                   const double featureRatio = 1.0,
+                   const size_t maxBins = 256);
+
+  /**
+   * Train the model on the given labeled data, for NumRounds() rounds.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of each point, in [0, numClasses).
+   * @param numClasses Number of classes (at least 2).
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses);
+
+  /**
+   * Train the model on the given labeled data, stopping once the log-loss on
+   * the validation data has not improved for earlyStoppingRounds rounds.  The
+   * model then holds the trees up to the round with the best validation
+   * log-loss.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of each point, in [0, numClasses).
+   * @param numClasses Number of classes (at least 2).
+   * @param validationData Dataset to evaluate the log-loss on.
+   * @param validationLabels Labels of the validation data.
+   * @param earlyStoppingRounds Number of rounds without improvement to stop
+   *     after.
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const MatType& validationData,
+             const arma::Row<size_t>& validationLabels,
+             const size_t earlyStoppingRounds);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.
+   *
+   * @param data Dataset to classify.
+   * @param predictions Output predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * class probabilities of each point.
+   *
+   * @param data Dataset to classify.
+   * @param predictions Output predictions for each point.
+   * @param probabilities Output class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trained trees.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the number of nodes of all the trees.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the maximum number of boosting rounds.
+  size_t NumRounds() const { return numRounds; }
+  //! Modify the maximum number of boosting rounds.
+  size_t& NumRounds() { return numRounds; }
+  //! Get the learning rate.
+  double LearningRate() const { return learningRate; }
+  //! Modify the learning rate.
+  double& LearningRate() { return learningRate; }
+  //! Get the maximum depth of each tree.
+  size_t MaximumDepth() const { return maximumDepth; }
+  //! Modify the maximum depth of each tree.
+  size_t& MaximumDepth() { return maximumDepth; }
+  //! Get the minimum number of points in each leaf.
+  size_t MinimumLeafSize() const { return minimumLeafSize; }
+  //! Modify the minimum number of points in each leaf.
+  size_t& MinimumLeafSize() { return minimumLeafSize; }
+  //! Get the L2 regularization of the leaf values.
+  double Lambda() const { return lambda; }
+  //! Modify the L2 regularization of the leaf values.
+  double& Lambda() { return lambda; }
+  //! Get the minimum gain of a split.
+  double MinimumGain() const { return minimumGain; }
+  //! Modify the minimum gain of a split.
+  double& MinimumGain() { return minimumGain; }
+  //! Get the fraction of the points each round is trained on.
+  double SubsampleRatio() const { return subsampleRatio; }
+  //! Modify the fraction of the points each round is trained on.
+  double& SubsampleRatio() { return subsampleRatio; }
+  //! Get the fraction of the dimensions each tree is trained on.
+  double FeatureRatio() const { return featureRatio; }
+  //! Modify the fraction of the dimensions each tree is trained on.
+  double& FeatureRatio() { return featureRatio; }
+  //! Get the maximum number of histogram bins per dimension.
+  size_t MaxBins() const { return maxBins; }
+  //! Modify the maximum number of histogram bins per dimension.
+  size_t& MaxBins() { return maxBins; }
+
+  //! The number of points classified together by each thread.
+  static const size_t BlockSize = 64;
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A node of one of the trees.
+  struct Node
+  {
+    //! Dimension to split on.
+    size_t dimension;
+    //! Index of the left child (the right child follows it), or 0 for a leaf.
+    size_t left;
+    //! Threshold of the split (points at most this go left), or the value of
+    //! the leaf.
+    double value;
+
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & BOOST_SERIALIZATION_NVP(dimension);
+      ar & BOOST_SERIALIZATION_NVP(left);
+      ar & BOOST_SERIALIZATION_NVP(value);
+    }
+  };
+
+  //! The best split of a node along one dimension.
+  struct Split
+  {
+    //! Gain of the split.
+    double gain;
+    //! The last bin of the left child.
+    size_t bin;
+    //! Sum of the gradients of the left child.
+    double gradientSum;
+    //! Sum of the hessians of the left child.
+    double hessianSum;
+    //! Number of points of the left child.
+    size_t count;
+  };
+
+  /**
+   * Train the model, with or without the validation data.
+   */
+  template<bool UseValidation, typename MatType>
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const MatType& validationData,
+             const arma::Row<size_t>& validationLabels,
+             const size_t earlyStoppingRounds);
+
+  /**
+   * Compute the boundaries of the bins of each dimension at the quantiles of
+   * the data, and the bin of each point in each dimension.  A point falls in
+   * bin b of a dimension if b boundaries are less than its value, so it is at
+   * most boundaries[b].
+   *
+   * @param data Dataset to bin.
+   * @param boundaries Output boundaries of the bins of each dimension.
+   * @param bins Output bins, with one row per point and one column per
+   *     dimension.
+   */
+  template<typename MatType>
+  void ComputeBins(const MatType& data,
+                   std::vector<arma::vec>& boundaries,
+                   arma::Mat<unsigned char>& bins) const;
+
+  /**
+   * Fit a tree to the given gradients and hessians, and append it to the
+   * model.
+   *
+   * @param bins Bins of the training points.
+   * @param boundaries Boundaries of the bins of each dimension.
+   * @param indices Points to fit the tree to (reordered during training).
+   * @param dimensions Dimensions the tree may split on.
+   * @param gradients Gradient of the loss of each point.
+   * @param hessians Hessian of the loss of each point.
+   */
+  void FitTree(const arma::Mat<unsigned char>& bins,
+               const std::vector<arma::vec>& boundaries,
+               std::vector<size_t>& indices,
+               const std::vector<size_t>& dimensions,
+               const arma::rowvec& gradients,
+               const arma::rowvec& hessians);
+
+  /**
+   * Grow the given node of the current tree, on points [begin, end) of
+   * indices, splitting it recursively.
+   */
+  void Grow(const size_t node,
+            const arma::Mat<unsigned char>& bins,
+            const std::vector<arma::vec>& boundaries,
+            std::vector<size_t>& indices,
+            const size_t begin,
+            const size_t end,
+            const size_t depth,
+            const std::vector<size_t>& dimensions,
+            const arma::rowvec& gradients,
+            const arma::rowvec& hessians,
+            const double gradientSum,
+            const double hessianSum);
+
+  //! Return the gain of a node with the given sums, up to a constant.
+  double Score(const double gradientSum, const double hessianSum) const
+  {
+    return gradientSum * gradientSum / (hessianSum + lambda);
+  }
+
+  /**
+   * Add the outputs of trees [firstTree, lastTree) for each point of the data
+   * to scores.
+   */
+  template<typename MatType>
+  void AddScores(const MatType& data,
+                 const size_t firstTree,
+                 const size_t lastTree,
+                 arma::mat& scores) const;
+
+  /**
+   * Turn the scores of each point into class probabilities, in place.
+   */
+  void Probabilities(arma::mat& scores) const;
+
+  //! Return the number of outputs of each round (1 for two classes).
+  size_t NumOutputs() const { return (numClasses == 2) ? 1 : numClasses; }
+
+  //! The maximum number of boosting rounds.
+  size_t numRounds;
+  //! The learning rate.
+  double learningRate;
+  //! The maximum depth of each tree.
+  size_t maximumDepth;
+  //! The minimum number of points in each leaf.
+  size_t minimumLeafSize;
+  //! The L2 regularization of the leaf values.
+  double lambda;
+  //! The minimum gain of a split.
+  double minimumGain;
+  //! The fraction of the points each round is trained on.
+  double subsampleRatio;
+  //! The fraction of the dimensions each tree is trained on.
+  double featureRatio;
+  //! The maximum number of histogram bins per dimension.
+  size_t maxBins;
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The initial score of each output.
+  arma::vec initialScores;
+  //! The nodes of all the trees.
+  std::vector<Node> nodes;
+  //! The index of the root of each tree; tree t adds to output
+  //! t % NumOutputs().
+  std::vector<size_t> roots;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "gradient_boosting_impl.hpp"
+
+#endif
@@ -0,0 +1,557 @@
+/**
+ * @file gradient_boosting_impl.hpp
+ *
+ * Implementation of the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_boosting.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename DimensionSelectionType>
+GradientBoosting<DimensionSelectionType>::GradientBoosting(
+    const size_t numRounds,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double lambda,
+    const double minimumGain,
+    const double subsampleRatio,
+    const double featureRatio,
+    const size_t maxBins) :
+    numRounds(numRounds),
+    learningRate(learningRate),
+    maximumDepth(maximumDepth),
+    minimumLeafSize(minimumLeafSize),
+    lambda(lambda),
+    minimumGain(minimumGain),
+    subsampleRatio(subsampleRatio),
+    featureRatio(featureRatio),
+    maxBins(maxBins),
+    numClasses(0)
+{
+  // Nothing to do.
+}
+
+template<typename DimensionSelectionType>
+template<typename MatType>
+void GradientBoosting<DimensionSelectionType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses)
+{
+  Train<false>(data, labels, numClasses, data, labels, 0);
+}
+
+template<typename DimensionSelectionType>
+template<typename MatType>
+void GradientBoosting<DimensionSelectionType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const MatType& validationData,
+    const arma::Row<size_t>& validationLabels,
+    const size_t earlyStoppingRounds)
+{
+  Train<true>(data, labels, numClasses, validationData, validationLabels,
+      earlyStoppingRounds);
+}
+
+template<typename DimensionSelectionType>
+template<bool UseValidation, typename MatType>
+void GradientBoosting<DimensionSelectionType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const MatType& validationData,
+    const arma::Row<size_t>& validationLabels,
+    const size_t earlyStoppingRounds)
+{
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): there must be at "
+        "least two classes!");
+  }
+
+  if (data.n_cols == 0 || labels.n_elem != data.n_cols)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the number of "
+        "labels must be the number of points, and nonzero!");
+  }
+
+  if (UseValidation && (validationData.n_rows != data.n_rows ||
+      validationLabels.n_elem != validationData.n_cols))
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the validation "
+        "data must have the dimensionality of the data, and one label per "
+        "point!");
+  }
+
+  if (maxBins < 2 || maxBins > 256)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): maxBins must be "
+        "between 2 and 256!");
+  }
+
+  if (subsampleRatio <= 0.0 || subsampleRatio > 1.0 || featureRatio <= 0.0 ||
+      featureRatio > 1.0)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): subsampleRatio "
+        "and featureRatio must be in (0, 1]!");
+  }
+
+  // Start the initial scores from the class frequencies.
+  arma::vec frequencies(numClasses, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    if (labels[i] >= numClasses)
+    {
+      throw std::invalid_argument("GradientBoosting::Train(): labels must be "
+          "in [0, numClasses)!");
+    }
+
+    ++frequencies[labels[i]];
+  }
+  frequencies = arma::clamp(frequencies / labels.n_elem, 1e-15, 1.0 - 1e-15);
+
+  this->numClasses = numClasses;
+  nodes.clear();
+  roots.clear();
+
+  const size_t numOutputs = NumOutputs();
+  if (numOutputs == 1)
+  {
+    initialScores.set_size(1);
+    initialScores[0] = std::log(frequencies[1] / frequencies[0]);
+  }
+  else
+    initialScores = arma::log(frequencies);
+
+  std::vector<arma::vec> boundaries;
+  arma::Mat<unsigned char> bins;
+  ComputeBins(data, boundaries, bins);
+
+  const size_t sampleSize = std::max(size_t(subsampleRatio * data.n_cols),
+      size_t(1));
+  const size_t numFeatures = std::min(std::max(size_t(std::ceil(featureRatio *
+      data.n_rows)), size_t(1)), size_t(data.n_rows));
+
+  arma::mat scores = arma::repmat(initialScores, 1, data.n_cols);
+  arma::mat validationScores;
+  if (UseValidation)
+    validationScores = arma::repmat(initialScores, 1, validationData.n_cols);
+  double bestLoss = DBL_MAX;
+  size_t bestRound = 0;
+
+  arma::mat probabilities;
+  arma::rowvec gradients(data.n_cols), hessians(data.n_cols);
+  std::vector<size_t> indices;
+  for (size_t round = 0; round < numRounds; ++round)
+  {
+    // All of the trees of the round fit the gradients at the start of it.
+    probabilities = scores;
+    Probabilities(probabilities);
+
+    arma::uvec sample = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+        data.n_cols);
+    if (sampleSize < data.n_cols)
+    {
+      const arma::uvec shuffled = arma::shuffle(sample);
+      sample = arma::sort(shuffled.subvec(0, sampleSize - 1));
+    }
+
+    for (size_t output = 0; output < numOutputs; ++output)
+    {
+      const size_t label = (numOutputs == 1) ? 1 : output;
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+      {
+        const double p = probabilities(label, i);
+        gradients[i] = p - ((labels[i] == label) ? 1.0 : 0.0);
+        hessians[i] = std::max(p * (1.0 - p), 1e-16);
+      }
+
+      arma::uvec features = arma::linspace<arma::uvec>(0, data.n_rows - 1,
+          data.n_rows);
+      if (numFeatures < data.n_rows)
+      {
+        const arma::uvec shuffled = arma::shuffle(features);
+        features = arma::sort(shuffled.subvec(0, numFeatures - 1));
+      }
+
+      indices.assign(sample.begin(), sample.end());
+      FitTree(bins, boundaries, indices, std::vector<size_t>(features.begin(),
+          features.end()), gradients, hessians);
+      AddScores(data, roots.size() - 1, roots.size(), scores);
+    }
+
+    if (UseValidation)
+    {
+      AddScores(validationData, roots.size() - numOutputs, roots.size(),
+          validationScores);
+      probabilities = validationScores;
+      Probabilities(probabilities);
+
+      double loss = 0.0;
+      for (size_t i = 0; i < validationLabels.n_elem; ++i)
+      {
+        loss -= std::log(std::max(probabilities(validationLabels[i], i),
+            1e-15));
+      }
+
+      if (loss < bestLoss)
+      {
+        bestLoss = loss;
+        bestRound = round;
+      }
+      else if (round - bestRound >= earlyStoppingRounds)
+      {
+        break;
+      }
+    }
+  }
+
+  // Drop the trees after the best round.
+  if (UseValidation && (bestRound + 1) * numOutputs < roots.size())
+  {
+    nodes.resize(roots[(bestRound + 1) * numOutputs]);
+    roots.resize((bestRound + 1) * numOutputs);
+  }
+}
+
+template<typename DimensionSelectionType>
+template<typename MatType>
+void GradientBoosting<DimensionSelectionType>::ComputeBins(
+    const MatType& data,
+    std::vector<arma::vec>& boundaries,
+    arma::Mat<unsigned char>& bins) const
+{
+  boundaries.resize(data.n_rows);
+  bins.set_size(data.n_cols, data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+  {
+    const arma::rowvec values = arma::sort(
+        arma::conv_to<arma::rowvec>::from(data.row(d)));
+    const size_t n = values.n_elem;
+
+    size_t distinct = 1;
+    for (size_t i = 1; i < n; ++i)
+      distinct += (values[i] != values[i - 1]) ? 1 : 0;
+
+    // Put a boundary between two distinct values once the points before it
+    // fill the next quantile, or between all of them if there are few enough.
+    std::vector<double> dimensionBoundaries;
+    size_t i = 0;
+    while (i < n)
+    {
+      size_t next = i + 1;
+      while (next < n && values[next] == values[i])
+        ++next;
+      if (next == n)
+        break;
+
+      if (distinct <= maxBins ||
+          next >= (dimensionBoundaries.size() + 1) * n / maxBins)
+        dimensionBoundaries.push_back((values[i] + values[next]) / 2.0);
+
+      i = next;
+    }
+
+    boundaries[d] = arma::vec(dimensionBoundaries);
+    const arma::vec& b = boundaries[d];
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      bins(j, d) = (unsigned char) (std::lower_bound(b.begin(), b.end(),
+          (double) data(d, j)) - b.begin());
+    }
+  }
+}
+
+template<typename DimensionSelectionType>
+void GradientBoosting<DimensionSelectionType>::FitTree(
+    const arma::Mat<unsigned char>& bins,
+    const std::vector<arma::vec>& boundaries,
+    std::vector<size_t>& indices,
+    const std::vector<size_t>& dimensions,
+    const arma::rowvec& gradients,
+    const arma::rowvec& hessians)
+{
+  double gradientSum = 0.0, hessianSum = 0.0;
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    gradientSum += gradients[indices[i]];
+    hessianSum += hessians[indices[i]];
+  }
+
+  roots.push_back(nodes.size());
+  nodes.push_back(Node());
+  Grow(roots.back(), bins, boundaries, indices, 0, indices.size(), 0,
+      dimensions, gradients, hessians, gradientSum, hessianSum);
+}
+
+template<typename DimensionSelectionType>
+void GradientBoosting<DimensionSelectionType>::Grow(
+    const size_t node,
+    const arma::Mat<unsigned char>& bins,
+    const std::vector<arma::vec>& boundaries,
+    std::vector<size_t>& indices,
+    const size_t begin,
+    const size_t end,
+    const size_t depth,
+    const std::vector<size_t>& dimensions,
+    const arma::rowvec& gradients,
+    const arma::rowvec& hessians,
+    const double gradientSum,
+    const double hessianSum)
+{
+  const size_t count = end - begin;
+  const size_t leafSize = std::max(minimumLeafSize, size_t(1));
+
+  std::vector<size_t> searched;
+  if ((maximumDepth == 0 || depth < maximumDepth) && count >= 2 * leafSize)
+  {
+    DimensionSelectionType selector(dimensions.size());
+    for (size_t i = selector.Begin(); i != selector.End(); i = selector.Next())
+      searched.push_back(dimensions[i]);
+  }
+
+  // Find the best split of each dimension, in parallel, from the histogram of
+  // the gradients and hessians of the points of the node.
+  std::vector<Split> splits(searched.size());
+  const double nodeScore = Score(gradientSum, hessianSum);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t s = 0; s < (omp_size_t) searched.size(); ++s)
+  {
+    const size_t dimension = searched[s];
+    const size_t numBins = boundaries[dimension].n_elem + 1;
+    std::vector<double> gradientBins(numBins, 0.0), hessianBins(numBins, 0.0);
+    std::vector<size_t> countBins(numBins, 0);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const size_t index = indices[i];
+      const size_t bin = bins(index, dimension);
+      gradientBins[bin] += gradients[index];
+      hessianBins[bin] += hessians[index];
+      ++countBins[bin];
+    }
+
+    Split& split = splits[s];
+    split.gain = -DBL_MAX;
+    double leftGradient = 0.0, leftHessian = 0.0;
+    size_t leftCount = 0;
+    for (size_t b = 0; b + 1 < numBins; ++b)
+    {
+      leftGradient += gradientBins[b];
+      leftHessian += hessianBins[b];
+      leftCount += countBins[b];
+      if (leftCount < leafSize)
+        continue;
+      if (count - leftCount < leafSize)
+        break;
+
+      const double gain = 0.5 * (Score(leftGradient, leftHessian) +
+          Score(gradientSum - leftGradient, hessianSum - leftHessian) -
+          nodeScore);
+      if (gain > split.gain)
+      {
+        split.gain = gain;
+        split.bin = b;
+        split.gradientSum = leftGradient;
+        split.hessianSum = leftHessian;
+        split.count = leftCount;
+      }
+    }
+  }
+
+  // Take the best dimension, in order, so that the tree does not depend on
+  // the number of threads.
+  size_t best = splits.size();
+  double bestGain = minimumGain;
+  for (size_t s = 0; s < splits.size(); ++s)
+  {
+    if (splits[s].gain > bestGain)
+    {
+      bestGain = splits[s].gain;
+      best = s;
+    }
+  }
+
+  if (best == splits.size())
+  {
+    nodes[node].dimension = 0;
+    nodes[node].left = 0;
+    nodes[node].value = -learningRate * gradientSum / (hessianSum + lambda);
+    return;
+  }
+
+  const size_t dimension = searched[best];
+  const Split split = splits[best];
+  std::stable_partition(indices.begin() + begin, indices.begin() + end,
+      [&](const size_t index) { return bins(index, dimension) <= split.bin; });
+
+  const size_t left = nodes.size();
+  nodes.resize(left + 2);
+  nodes[node].dimension = dimension;
+  nodes[node].left = left;
+  nodes[node].value = boundaries[dimension][split.bin];
+
+  Grow(left, bins, boundaries, indices, begin, begin + split.count, depth + 1,
+      dimensions, gradients, hessians, split.gradientSum, split.hessianSum);
+  Grow(left + 1, bins, boundaries, indices, begin + split.count, end,
+      depth + 1, dimensions, gradients, hessians,
+      gradientSum - split.gradientSum, hessianSum - split.hessianSum);
+}
+
+template<typename DimensionSelectionType>
+template<typename MatType>
+void GradientBoosting<DimensionSelectionType>::AddScores(
+    const MatType& data,
+    const size_t firstTree,
+    const size_t lastTree,
+    arma::mat& scores) const
+{
+  const size_t numOutputs = NumOutputs();
+  const size_t blocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + size_t(BlockSize),
+        size_t(data.n_cols));
+
+    // Walk each tree for all of the points of the block, so that the nodes of
+    // the tree stay in cache.
+    for (size_t t = firstTree; t < lastTree; ++t)
+    {
+      const size_t output = t % numOutputs;
+      for (size_t i = begin; i < end; ++i)
+      {
+        const Node* n = &nodes[roots[t]];
+        while (n->left != 0)
+          n = &nodes[n->left + ((data(n->dimension, i) <= n->value) ? 0 : 1)];
+
+        scores(output, i) += n->value;
+      }
+    }
+  }
+}
+
+template<typename DimensionSelectionType>
+void GradientBoosting<DimensionSelectionType>::Probabilities(
+    arma::mat& scores) const
+{
+  if (NumOutputs() == 1)
+  {
+    // The score is the log-odds of the second class.
+    arma::mat probabilities(2, scores.n_cols);
+    probabilities.row(1) = 1.0 / (1.0 + arma::exp(-scores.row(0)));
+    probabilities.row(0) = 1.0 - probabilities.row(1);
+    scores = std::move(probabilities);
+    return;
+  }
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) scores.n_cols; ++i)
+  {
+    double* s = scores.colptr(i);
+    const double maxScore = *std::max_element(s, s + scores.n_rows);
+    double sum = 0.0;
+    for (size_t c = 0; c < scores.n_rows; ++c)
+    {
+      s[c] = std::exp(s[c] - maxScore);
+      sum += s[c];
+    }
+    for (size_t c = 0; c < scores.n_rows; ++c)
+      s[c] /= sum;
+  }
+}
+
+template<typename DimensionSelectionType>
+template<typename VecType>
+size_t GradientBoosting<DimensionSelectionType>::Classify(
+    const VecType& point) const
+{
+  arma::Row<size_t> prediction;
+  Classify(arma::mat(point), prediction);
+  return prediction[0];
+}
+
+template<typename DimensionSelectionType>
+template<typename MatType>
+void GradientBoosting<DimensionSelectionType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename DimensionSelectionType>
+template<typename MatType>
+void GradientBoosting<DimensionSelectionType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::mat& probabilities) const
+{
+  if (numClasses == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("GradientBoosting::Classify(): model not "
+        "trained!");
+  }
+
+  probabilities = arma::repmat(initialScores, 1, data.n_cols);
+  AddScores(data, 0, roots.size(), probabilities);
+  Probabilities(probabilities);
+
+  predictions.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    size_t best = 0;
+    for (size_t c = 1; c < numClasses; ++c)
+    {
+      if (probabilities(c, i) > probabilities(best, i))
+        best = c;
+    }
+    predictions[i] = best;
+  }
+}
+
+template<typename DimensionSelectionType>
+template<typename Archive>
+void GradientBoosting<DimensionSelectionType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numRounds);
+  ar & BOOST_SERIALIZATION_NVP(learningRate);
+  ar & BOOST_SERIALIZATION_NVP(maximumDepth);
+  ar & BOOST_SERIALIZATION_NVP(minimumLeafSize);
+  ar & BOOST_SERIALIZATION_NVP(lambda);
+  ar & BOOST_SERIALIZATION_NVP(minimumGain);
+  ar & BOOST_SERIALIZATION_NVP(subsampleRatio);
+  ar & BOOST_SERIALIZATION_NVP(featureRatio);
+  ar & BOOST_SERIALIZATION_NVP(maxBins);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(initialScores);
+  ar & BOOST_SERIALIZATION_NVP(nodes);
+  ar & BOOST_SERIALIZATION_NVP(roots);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -16,10 +16,25 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/dists/discrete_distribution.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 namespace mlpack {
 namespace hmm /** Hidden Markov Models. */ {
 
+HAS_MEM_FUNC(LogProbability, HasBatchLogProbabilityCheck);
+
+/**
+ * Whether the emission distribution can compute the log-probabilities of a
+ * whole matrix of observations at once, with
+ * void LogProbability(const arma::mat&, arma::vec&) const.
+ */
+template<typename Distribution>
+struct HasBatchLogProbability
+{
+  static const bool value = HasBatchLogProbabilityCheck<Distribution,
+      void(Distribution::*)(const arma::mat&, arma::vec&) const>::value;
+};
+
 /**
  * A class that represents a Hidden Markov Model with an arbitrary type of
  * emission distribution.  This HMM class supports training (supervised and
@@ -164,6 +179,9 @@ class HMM
    * for training.
    * @endnote
    *
+   * The E-step (the Forward-Backward algorithm on each sequence) is run on the
+   * sequences in parallel.
+   *
    * @param dataSeq Vector of observation sequences.
    */
   void Train(const std::vector<arma::mat>& dataSeq);
@@ -267,6 +285,32 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence of each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are processed in
+   * parallel.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    observation sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of the most
+   *    probable state sequence of each observation sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t> >& stateSeq,
+               arma::vec& logLikelihoods) const;
+
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences are processed in parallel.
+   *
+   * @param dataSeq Vector of data sequences to evaluate the likelihood of.
+   * @param logLikelihoods Vector in which the log-likelihood of each sequence
+   *    will be stored.
+   */
+  void LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                     arma::vec& logLikelihoods) const;
+
   /**
    * HMM filtering. Computes the k-step-ahead expected emission at each time
    * conditioned only on prior observations. That is
@@ -359,6 +403,51 @@ class HMM
                 const arma::vec& scales,
                 arma::mat& backwardProb) const;
 
+  /**
+   * Compute the emission probabilities of every state for every observation of
+   * the given data sequence, scaled so that the largest one of each
+   * observation is 1: emissionProb(i, t) = P(o_t | state i) /
+   * exp(logShifts[t]).  If the emission distribution has a batch
+   * LogProbability() function, the log-probabilities are computed with one
+   * call per state, so that tiny probabilities (for instance in high
+   * dimensions) do not underflow to 0.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionProb Matrix in which the scaled emission probabilities will
+   *     be saved (one row per state).
+   * @param logShifts Vector in which the log-scale of each observation will be
+   *     saved.
+   */
+  void EmissionProbability(const arma::mat& dataSeq,
+                           arma::mat& emissionProb,
+                           arma::vec& logShifts) const;
+
+  /**
+   * The Forward algorithm on precomputed (scaled) emission probabilities, as
+   * given by EmissionProbability().  The scaling factors are relative to the
+   * scaled probabilities; the log-likelihood of the sequence is
+   * accu(log(scales)) + accu(logShifts).
+   *
+   * @param emissionProb Scaled emission probabilities (one row per state).
+   * @param scales Vector in which scaling factors will be saved.
+   * @param forwardProb Matrix in which forward probabilities will be saved.
+   */
+  void ScaledForward(const arma::mat& emissionProb,
+                     arma::vec& scales,
+                     arma::mat& forwardProb) const;
+
+  /**
+   * The Backward algorithm on precomputed (scaled) emission probabilities and
+   * the scaling factors found by ScaledForward() on them.
+   *
+   * @param emissionProb Scaled emission probabilities (one row per state).
+   * @param scales Vector of scaling factors.
+   * @param backwardProb Matrix in which backward probabilities will be saved.
+   */
+  void ScaledBackward(const arma::mat& emissionProb,
+                      const arma::vec& scales,
+                      arma::mat& backwardProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
@@ -374,6 +463,24 @@ class HMM
 
   //! Tolerance of Baum-Welch algorithm.
   double tolerance;
+
+  //! Compute the log-probabilities of the observations under each emission
+  //! distribution, with its batch LogProbability() function.
+  template<typename DistType = Distribution>
+  void EmissionLogProbability(
+      const arma::mat& dataSeq,
+      arma::mat& logProb,
+      const typename std::enable_if<
+          HasBatchLogProbability<DistType>::value>::type* = 0) const;
+
+  //! Compute the log-probabilities of the observations under each emission
+  //! distribution, one observation at a time.
+  template<typename DistType = Distribution>
+  void EmissionLogProbability(
+      const arma::mat& dataSeq,
+      arma::mat& logProb,
+      const typename std::enable_if<
+          !HasBatchLogProbability<DistType>::value>::type* = 0) const;
 };
 
 } // namespace hmm
@@ -104,10 +104,24 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // do not change between iterations, so they are only gathered once; the
+  // observations of each sequence start at its offset.
   std::vector<arma::vec> emissionProb(transition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+    {
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    }
+    sumTime += dataSeq[seq].n_cols;
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -123,49 +137,74 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // Loop over each sequence.  The sequences are independent given the
+    // current parameters, so the E-step runs in parallel, with thread-local
+    // accumulators that are merged at the end.
+    #pragma omp parallel
     {
-      arma::mat stateProb;
+      arma::vec threadInitial(transition.n_rows, arma::fill::zeros);
+      arma::mat threadTransition(transition.n_rows, transition.n_cols,
+          arma::fill::zeros);
+      double threadLoglik = 0;
+
+      // These buffers are reused for all the sequences of the thread.
+      arma::mat seqEmission;
+      arma::vec logShifts;
       arma::mat forward;
       arma::mat backward;
       arma::vec scales;
 
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += Estimate(dataSeq[seq], stateProb, forward, backward, scales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < transition.n_cols; ++j)
-        newInitial[j] += stateProb(j, 0);
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
+        const size_t length = dataSeq[seq].n_cols;
+        if (length == 0)
+          continue;
+
+        // Run the forward-backward algorithm on the emission probabilities,
+        // which are computed only once.  This is the E-step.
+        EmissionProbability(dataSeq[seq], seqEmission, logShifts);
+        ScaledForward(seqEmission, scales, forward);
+        ScaledBackward(seqEmission, scales, backward);
+
+        // Add the log-likelihood of this sequence.
+        threadLoglik += accu(log(scales)) + accu(logShifts);
+
+        // The state probabilities are forward % backward.  Add to estimate of
+        // initial probability for state j.
+        threadInitial += forward.col(0) % backward.col(0);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.  The estimate of
+        // T_ij (probability of transition from state j to state i) for all t
+        // is one matrix product; we postpone multiplication of the old T_ij
+        // until later.
+        if (length > 1)
+        {
+          arma::mat next = backward.cols(1, length - 1) %
+              seqEmission.cols(1, length - 1);
+          next.each_row() /= trans(scales.subvec(1, length - 1));
+          threadTransition += next * trans(forward.cols(0, length - 2));
+        }
+
+        // Add to list of emission probabilities, for Distribution::Train().
         for (size_t j = 0; j < transition.n_cols; ++j)
         {
-          if (t < dataSeq[seq].n_cols - 1)
-          {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
-              newTransition(i, j) += forward(j, t) * backward(i, t + 1) *
-                  emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
-                  scales[t + 1];
-          }
-
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = stateProb(j, t);
+          emissionProb[j].subvec(offsets[seq], offsets[seq] + length - 1) =
+              trans(forward.row(j) % backward.row(j));
         }
-        sumTime++;
+      }
+
+      #pragma omp critical
+      {
+        newInitial += threadInitial;
+        newTransition += threadTransition;
+        loglik += threadLoglik;
       }
     }
 
@@ -314,16 +353,23 @@ double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
                                    arma::mat& backwardProb,
                                    arma::vec& scales) const
 {
-  // First run the forward-backward algorithm.
-  Forward(dataSeq, scales, forwardProb);
-  Backward(dataSeq, scales, backwardProb);
+  // First run the forward-backward algorithm, on emission probabilities that
+  // are computed only once.
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  EmissionProbability(dataSeq, emissionProb, logShifts);
+  ScaledForward(emissionProb, scales, forwardProb);
+  ScaledBackward(emissionProb, scales, backwardProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
   stateProb = forwardProb % backwardProb;
 
-  // Finally assemble the log-likelihood and return it.
-  return accu(log(scales));
+  // Finally assemble the log-likelihood and return it.  The scaling factors of
+  // the unscaled emission probabilities are returned.
+  const double loglik = accu(log(scales)) + accu(logShifts);
+  scales %= exp(logShifts);
+  return loglik;
 }
 
 /**
@@ -411,14 +457,20 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   // will be using the rows of the transition matrix.
   arma::mat logTrans(log(trans(transition)));
 
+  // Compute the log emission probabilities of all the observations at once.
+  arma::mat logEmission;
+  arma::vec logShifts;
+  EmissionProbability(dataSeq, logEmission, logShifts);
+  logEmission = log(logEmission);
+  logEmission.each_row() += trans(logShifts);
+
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
   logStateProb.col(0).zeros();
   for (size_t state = 0; state < transition.n_rows; state++)
   {
-    logStateProb(state, 0) = log(initial[state] *
-        emission[state].Probability(dataSeq.unsafe_col(0)));
+    logStateProb(state, 0) = log(initial[state]) + logEmission(state, 0);
     stateSeqBack(state, 0) = state;
   }
 
@@ -432,8 +484,7 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
     for (size_t j = 0; j < transition.n_rows; j++)
     {
       arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          log(emission[j].Probability(dataSeq.unsafe_col(t)));
+      logStateProb(j, t) = prob.max(index) + logEmission(j, t);
         stateSeqBack(j, t) = index;
     }
   }
@@ -454,13 +505,48 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 template<typename Distribution>
 double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
 {
+  arma::mat emissionProb;
+  arma::vec logShifts;
   arma::mat forward;
   arma::vec scales;
 
-  Forward(dataSeq, scales, forward);
+  EmissionProbability(dataSeq, emissionProb, logShifts);
+  ScaledForward(emissionProb, scales, forward);
+
+  // The log-likelihood is the log of the scales for each time step, plus the
+  // scales of the emission probabilities.
+  return accu(log(scales)) + accu(logShifts);
+}
+
+/**
+ * Compute the most probable hidden state sequence of each of the given data
+ * sequences, in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                std::vector<arma::Row<size_t> >& stateSeq,
+                                arma::vec& logLikelihoods) const
+{
+  stateSeq.resize(dataSeq.size());
+  logLikelihoods.set_size(dataSeq.size());
 
-  // The log-likelihood is the log of the scales for each time step.
-  return accu(log(scales));
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
+    logLikelihoods[seq] = Predict(dataSeq[seq], stateSeq[seq]);
+}
+
+/**
+ * Compute the log-likelihood of each of the given data sequences, in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                                      arma::vec& logLikelihoods) const
+{
+  logLikelihoods.set_size(dataSeq.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
+    logLikelihoods[seq] = LogLikelihood(dataSeq[seq]);
 }
 
 /**
@@ -512,38 +598,118 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& scales,
                                 arma::mat& forwardProb) const
+{
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  EmissionProbability(dataSeq, emissionProb, logShifts);
+  ScaledForward(emissionProb, scales, forwardProb);
+
+  // Return the scaling factors of the unscaled emission probabilities.
+  scales %= exp(logShifts);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& scales,
+                                 arma::mat& backwardProb) const
+{
+  // The scaling factors are those of the unscaled emission probabilities.
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  EmissionProbability(dataSeq, emissionProb, logShifts);
+  emissionProb.each_row() %= trans(exp(logShifts));
+  ScaledBackward(emissionProb, scales, backwardProb);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::EmissionProbability(const arma::mat& dataSeq,
+                                            arma::mat& emissionProb,
+                                            arma::vec& logShifts) const
+{
+  EmissionLogProbability(dataSeq, emissionProb);
+
+  // Shift the log-probabilities of each observation by the largest one before
+  // exponentiating them; an observation that is impossible in every state is
+  // not shifted.
+  logShifts.zeros(dataSeq.n_cols);
+  if (emissionProb.n_rows > 0)
+  {
+    for (size_t t = 0; t < dataSeq.n_cols; t++)
+    {
+      const double maxLogProb = emissionProb.col(t).max();
+      if (std::isfinite(maxLogProb))
+        logShifts[t] = maxLogProb;
+    }
+  }
+
+  emissionProb.each_row() -= trans(logShifts);
+  emissionProb = exp(emissionProb);
+}
+
+template<typename Distribution>
+template<typename DistType>
+void HMM<Distribution>::EmissionLogProbability(
+    const arma::mat& dataSeq,
+    arma::mat& logProb,
+    const typename std::enable_if<
+        HasBatchLogProbability<DistType>::value>::type*) const
+{
+  logProb.set_size(transition.n_rows, dataSeq.n_cols);
+  arma::vec stateLogProb;
+  for (size_t state = 0; state < transition.n_rows; state++)
+  {
+    emission[state].LogProbability(dataSeq, stateLogProb);
+    logProb.row(state) = trans(stateLogProb);
+  }
+}
+
+template<typename Distribution>
+template<typename DistType>
+void HMM<Distribution>::EmissionLogProbability(
+    const arma::mat& dataSeq,
+    arma::mat& logProb,
+    const typename std::enable_if<
+        !HasBatchLogProbability<DistType>::value>::type*) const
+{
+  logProb.set_size(transition.n_rows, dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+    for (size_t state = 0; state < transition.n_rows; state++)
+      logProb(state, t) = log(emission[state].Probability(
+          dataSeq.unsafe_col(t)));
+}
+
+template<typename Distribution>
+void HMM<Distribution>::ScaledForward(const arma::mat& emissionProb,
+                                      arma::vec& scales,
+                                      arma::mat& forwardProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardProb.zeros(transition.n_rows, dataSeq.n_cols);
-  scales.zeros(dataSeq.n_cols);
+  forwardProb.set_size(transition.n_rows, emissionProb.n_cols);
+  scales.zeros(emissionProb.n_cols);
+  if (emissionProb.n_cols == 0)
+    return;
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < transition.n_rows; state++)
-    forwardProb(state, 0) = initial(state) *
-        emission[state].Probability(dataSeq.unsafe_col(0));
+  forwardProb.col(0) = initial % emissionProb.col(0);
 
   // Then normalize the column.
   scales[0] = accu(forwardProb.col(0));
   if (scales[0] > 0.0)
     forwardProb.col(0) /= scales[0];
 
-  // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  // Now compute the probabilities for each successive observation.  The
+  // forward probability of state j at time t is the sum over all states of the
+  // probability of the previous state transitioning to the current state and
+  // emitting the given observation.
+  for (size_t t = 1; t < emissionProb.n_cols; t++)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      forwardProb(j, t) = accu(forwardProb.col(t - 1) %
-          trans(transition.row(j))) *
-          emission[j].Probability(dataSeq.unsafe_col(t));
-    }
+    forwardProb.col(t) = (transition * forwardProb.col(t - 1)) %
+        emissionProb.col(t);
 
     // Normalize probability.
     scales[t] = accu(forwardProb.col(t));
@@ -553,34 +719,33 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
 }
 
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& scales,
-                                 arma::mat& backwardProb) const
+void HMM<Distribution>::ScaledBackward(const arma::mat& emissionProb,
+                                       const arma::vec& scales,
+                                       arma::mat& backwardProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardProb.zeros(transition.n_rows, dataSeq.n_cols);
+  backwardProb.set_size(transition.n_rows, emissionProb.n_cols);
+  if (emissionProb.n_cols == 0)
+    return;
 
   // The last element probability is 1.
-  backwardProb.col(dataSeq.n_cols - 1).fill(1);
-
-  // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  backwardProb.col(emissionProb.n_cols - 1).fill(1);
+
+  // Now step backwards through all other observations.  The backward
+  // probability of state j at time t is the sum over all state of the
+  // probability of the next state having been a transition from the current
+  // state multiplied by the probability of each of those states emitting the
+  // given observation.
+  const arma::mat transposedTransition = trans(transition);
+  for (size_t t = emissionProb.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-        backwardProb(j, t) += transition(state, j) * backwardProb(state, t + 1)
-            * emission[state].Probability(dataSeq.unsafe_col(t + 1));
-
-      // Normalize by the weights from the forward algorithm.
-      if (scales[t + 1] > 0.0)
-        backwardProb(j, t) /= scales[t + 1];
-    }
+    backwardProb.col(t) = transposedTransition * (backwardProb.col(t + 1) %
+        emissionProb.col(t + 1));
+
+    // Normalize by the weights from the forward algorithm.
+    if (scales[t + 1] > 0.0)
+      backwardProb.col(t) /= scales[t + 1];
   }
 }
 
@@ -37,12 +37,48 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Sequence Log-Likelihood", "This "
     PRINT_DATASET("seq") + " with the pre-trained HMM " + PRINT_MODEL("hmm") +
     ", the following command may be used: "
     "\n\n" +
-    PRINT_CALL("hmm_loglik", "input", "seq", "input_model", "hmm"));
+    PRINT_CALL("hmm_loglik", "input", "seq", "input_model", "hmm") +
+    "\n\n"
+    "Many sequences can be evaluated at once (in parallel) by concatenating "
+    "their observations in " + PRINT_PARAM_STRING("input") + " and giving the "
+    "length of each sequence with the " + PRINT_PARAM_STRING("lengths") +
+    " parameter; the log-likelihood of each sequence is then given by the " +
+    PRINT_PARAM_STRING("log_likelihoods") + " output parameter, and " +
+    PRINT_PARAM_STRING("log_likelihood") + " is their sum.");
 
 PARAM_MATRIX_IN_REQ("input", "File containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "File containing HMM.", "m");
+PARAM_UROW_IN("lengths", "Lengths of the sequences whose observations are "
+    "concatenated in the input.", "l");
 
 PARAM_DOUBLE_OUT("log_likelihood", "Log-likelihood of the sequence.");
+PARAM_COL_OUT("log_likelihoods", "Log-likelihood of each sequence, if "
+    "lengths is given.", "L");
+
+// Split the columns of the given data into consecutive sequences of the given
+// lengths.
+static vector<mat> SplitSequences(const mat& data,
+                                  const arma::Row<size_t>& lengths)
+{
+  if (accu(lengths) != data.n_cols)
+  {
+    Log::Fatal << "The sequence lengths sum to " << accu(lengths) << ", but "
+        << "the input has " << data.n_cols << " observations!" << endl;
+  }
+
+  vector<mat> sequences(lengths.n_elem);
+  size_t start = 0;
+  for (size_t i = 0; i < lengths.n_elem; ++i)
+  {
+    if (lengths[i] == 0)
+      Log::Fatal << "Sequence " << i << " has length 0!" << endl;
+
+    sequences[i] = data.cols(start, start + lengths[i] - 1);
+    start += lengths[i];
+  }
+
+  return sequences;
+}
 
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
@@ -70,14 +106,30 @@ struct Loglik
           << hmm.Emission()[0].Dimensionality() << ")!" << endl;
     }
 
-    const double loglik = hmm.LogLikelihood(dataSeq);
+    if (CLI::HasParam("lengths"))
+    {
+      const vector<mat> sequences = SplitSequences(dataSeq,
+          CLI::GetParam<arma::Row<size_t>>("lengths"));
 
-    CLI::GetParam<double>("log_likelihood") = loglik;
+      arma::vec logliks;
+      hmm.LogLikelihood(sequences, logliks);
+
+      CLI::GetParam<double>("log_likelihood") = accu(logliks);
+      CLI::GetParam<arma::vec>("log_likelihoods") = std::move(logliks);
+    }
+    else
+    {
+      const double loglik = hmm.LogLikelihood(dataSeq);
+
+      CLI::GetParam<double>("log_likelihood") = loglik;
+    }
   }
 };
 
 static void mlpackMain()
 {
+  ReportIgnoredParam({{ "lengths", false }}, "log_likelihoods");
+
   // Load model, and calculate the log-likelihood of the sequence.
   CLI::GetParam<HMMModel*>("input_model")->PerformAction<Loglik>((void*) NULL);
 }
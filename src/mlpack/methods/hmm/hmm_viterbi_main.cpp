@@ -41,12 +41,45 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Viterbi State Prediction", "This "
     ", the following command could be used:"
     "\n\n" +
     PRINT_CALL("hmm_viterbi", "input", "obs", "input_model", "hmm", "output",
-        "states"));
+        "states") +
+    "\n\n"
+    "Many sequences can be processed at once (in parallel) by concatenating "
+    "their observations in " + PRINT_PARAM_STRING("input") + " and giving the "
+    "length of each sequence with the " + PRINT_PARAM_STRING("lengths") +
+    " parameter; the predicted state sequences are then concatenated in the "
+    "same way.");
 
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
+PARAM_UROW_IN("lengths", "Lengths of the sequences whose observations are "
+    "concatenated in the input.", "l");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
 
+// Split the columns of the given data into consecutive sequences of the given
+// lengths.
+static vector<mat> SplitSequences(const mat& data,
+                                  const arma::Row<size_t>& lengths)
+{
+  if (accu(lengths) != data.n_cols)
+  {
+    Log::Fatal << "The sequence lengths sum to " << accu(lengths) << ", but "
+        << "the input has " << data.n_cols << " observations!" << endl;
+  }
+
+  vector<mat> sequences(lengths.n_elem);
+  size_t start = 0;
+  for (size_t i = 0; i < lengths.n_elem; ++i)
+  {
+    if (lengths[i] == 0)
+      Log::Fatal << "Sequence " << i << " has length 0!" << endl;
+
+    sequences[i] = data.cols(start, start + lengths[i] - 1);
+    start += lengths[i];
+  }
+
+  return sequences;
+}
+
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
 struct Viterbi
@@ -74,7 +107,28 @@ struct Viterbi
     }
 
     arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    if (CLI::HasParam("lengths"))
+    {
+      const vector<mat> sequences = SplitSequences(dataSeq,
+          CLI::GetParam<arma::Row<size_t>>("lengths"));
+
+      vector<arma::Row<size_t>> stateSeqs;
+      arma::vec logliks;
+      hmm.Predict(sequences, stateSeqs, logliks);
+
+      // Concatenate the state sequences like the observations.
+      sequence.set_size(dataSeq.n_cols);
+      size_t start = 0;
+      for (size_t i = 0; i < stateSeqs.size(); ++i)
+      {
+        sequence.cols(start, start + stateSeqs[i].n_elem - 1) = stateSeqs[i];
+        start += stateSeqs[i].n_elem;
+      }
+    }
+    else
+    {
+      hmm.Predict(dataSeq, sequence);
+    }
 
     // Save output.
     CLI::GetParam<arma::Mat<size_t>>("output") = std::move(sequence);
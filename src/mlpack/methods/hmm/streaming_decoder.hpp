@@ -0,0 +1,165 @@
+/**
+ * @file streaming_decoder.hpp
+ *
+ * Definition of the StreamingDecoder class, which filters and decodes the
+ * hidden states of an HMM one observation at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_STREAMING_DECODER_HPP
+#define MLPACK_METHODS_HMM_STREAMING_DECODER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "hmm.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * A stateful decoder for a stream of observations of a trained HMM.  Each
+ * call to Push() processes one observation in O(N^2) time for N hidden
+ * states, without storing the observations, and updates:
+ *
+ *  - the filtered state posterior P(X_t | o_{1:t}) (StatePosterior()) and the
+ *    log-likelihood of the observations so far (LogLikelihood()), as computed
+ *    by the Forward algorithm;
+ *  - the scores of the Viterbi algorithm, from which the state at time
+ *    t - lag is decoded (fixed-lag Viterbi decoding).
+ *
+ * Fixed-lag decoding follows the most probable state sequence of the
+ * observations so far back for lag steps, so it only keeps the last lag
+ * columns of Viterbi back-pointers: the memory is O(N lag), instead of the
+ * O(N T) of HMM::Predict() on a sequence of length T.  The decoded states
+ * tend to the full Viterbi path as the lag grows; when the stream ends, Flush()
+ * returns the states that have not been decoded yet, so with a lag at least
+ * the length of the sequence the result is exactly HMM::Predict().
+ *
+ * @code
+ * extern HMM<GaussianDistribution> hmm;
+ * StreamingDecoder<GaussianDistribution> decoder(hmm, 10);
+ * while (...)
+ * {
+ *   arma::vec observation = ...;
+ *   if (decoder.Push(observation))
+ *   {
+ *     // The state 10 steps ago is decoder.DecodedState().
+ *   }
+ *   // The current state posterior is decoder.StatePosterior().
+ * }
+ *
+ * arma::Row<size_t> lastStates;
+ * decoder.Flush(lastStates);
+ * @endcode
+ *
+ * The HMM must outlive the decoder.  If its parameters are modified, Reset()
+ * must be called before pushing the next observation.
+ *
+ * @tparam Distribution Type of the emission distributions of the HMM.
+ */
+template<typename Distribution = distribution::DiscreteDistribution>
+class StreamingDecoder
+{
+ public:
+  /**
+   * Create a decoder for the given HMM.
+   *
+   * @param hmm Trained HMM to decode observations of.
+   * @param lag Number of observations after which a state is decoded.
+   */
+  StreamingDecoder(const HMM<Distribution>& hmm, const size_t lag = 0);
+
+  /**
+   * Start a new stream of observations.  This also takes the current
+   * parameters of the HMM.
+   */
+  void Reset();
+
+  /**
+   * Process the next observation of the stream.  If at least lag + 1
+   * observations have been pushed, the state of the observation lag steps
+   * before this one is decoded, and true is returned; the state is then given
+   * by DecodedState().
+   *
+   * @param observation Next observation.
+   * @return Whether a state was decoded.
+   */
+  bool Push(const arma::vec& observation);
+
+  /**
+   * End the stream: decode the states of the last observations that have not
+   * been decoded yet (at most lag of them), in chronological order, and reset
+   * the decoder.
+   *
+   * @param states Row vector to store the remaining states in.
+   */
+  void Flush(arma::Row<size_t>& states);
+
+  //! Get the filtered state posterior P(X_t | o_{1:t}) of the last step.
+  const arma::vec& StatePosterior() const { return posterior; }
+  //! Get the log-likelihood of the observations of the stream so far.
+  double LogLikelihood() const { return logLikelihood; }
+  //! Get the state decoded by the last call to Push() that returned true.
+  size_t DecodedState() const { return decodedState; }
+  //! Get the number of observations pushed since the stream started.
+  size_t Steps() const { return steps; }
+  //! Get the lag of the decoding.
+  size_t Lag() const { return lag; }
+
+ private:
+  //! The HMM whose observations are decoded.
+  const HMM<Distribution>& hmm;
+  //! The lag of the decoding.
+  size_t lag;
+
+  //! The logarithm of the transposed transition matrix.
+  arma::mat logTransition;
+  //! The logarithm of the initial state probabilities.
+  arma::vec logInitial;
+
+  //! The filtered state posterior of the last step.
+  arma::vec posterior;
+  //! The log-likelihood of the observations so far.
+  double logLikelihood;
+  //! The Viterbi scores of the last step, shifted so their maximum is 0.
+  arma::vec viterbiScores;
+  //! The Viterbi back-pointers of the last lag steps (a circular buffer, with
+  //! one column per step).
+  arma::Mat<size_t> backPointers;
+  //! The number of observations pushed since the stream started.
+  size_t steps;
+  //! The state decoded by the last call to Push().
+  size_t decodedState;
+
+  //! Follow the back-pointers from the best state of the last step, and
+  //! return the state `back` steps before it.
+  size_t Backtrack(const size_t back) const;
+
+  //! Compute the log-probabilities of an observation under each emission
+  //! distribution, with its batch LogProbability() function.
+  template<typename DistType = Distribution>
+  void EmissionLogProbability(
+      const arma::vec& observation,
+      arma::vec& logProb,
+      const typename std::enable_if<
+          HasBatchLogProbability<DistType>::value>::type* = 0) const;
+
+  //! Compute the log-probabilities of an observation under each emission
+  //! distribution, with its Probability() function.
+  template<typename DistType = Distribution>
+  void EmissionLogProbability(
+      const arma::vec& observation,
+      arma::vec& logProb,
+      const typename std::enable_if<
+          !HasBatchLogProbability<DistType>::value>::type* = 0) const;
+};
+
+} // namespace hmm
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_decoder_impl.hpp"
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ * @file streaming_decoder_impl.hpp
+ *
+ * Implementation of the StreamingDecoder class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_STREAMING_DECODER_IMPL_HPP
+#define MLPACK_METHODS_HMM_STREAMING_DECODER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_decoder.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+template<typename Distribution>
+StreamingDecoder<Distribution>::StreamingDecoder(
+    const HMM<Distribution>& hmm,
+    const size_t lag) :
+    hmm(hmm),
+    lag(lag)
+{
+  Reset();
+}
+
+template<typename Distribution>
+void StreamingDecoder<Distribution>::Reset()
+{
+  const size_t states = hmm.Transition().n_rows;
+
+  // We will be using the rows of the transition matrix, like HMM::Predict().
+  logTransition = arma::log(arma::trans(hmm.Transition()));
+  logInitial = arma::log(hmm.Initial());
+
+  posterior.zeros(states);
+  logLikelihood = 0.0;
+  viterbiScores.zeros(states);
+  backPointers.zeros(states, lag);
+  steps = 0;
+  decodedState = 0;
+}
+
+template<typename Distribution>
+bool StreamingDecoder<Distribution>::Push(const arma::vec& observation)
+{
+  if (observation.n_elem != hmm.Dimensionality())
+  {
+    Log::Fatal << "StreamingDecoder::Push(): observation has dimensionality "
+        << observation.n_elem << " (expected " << hmm.Dimensionality()
+        << " dimensions)." << std::endl;
+  }
+
+  // Scale the emission probabilities so that the largest one is 1, as
+  // HMM::Forward() does.
+  arma::vec logEmission;
+  EmissionLogProbability(observation, logEmission);
+  double shift = (logEmission.n_elem > 0) ? logEmission.max() : 0.0;
+  if (!std::isfinite(shift))
+    shift = 0.0;
+  const arma::vec emissionProb = arma::exp(logEmission - shift);
+
+  if (steps == 0)
+  {
+    posterior = hmm.Initial() % emissionProb;
+    viterbiScores = logInitial + logEmission;
+  }
+  else
+  {
+    // One step of the Forward algorithm.
+    posterior = (hmm.Transition() * posterior) % emissionProb;
+
+    // One step of the Viterbi algorithm; the back-pointers of step t are
+    // stored in column t % lag.
+    arma::vec scores(viterbiScores.n_elem);
+    arma::uword index;
+    for (size_t j = 0; j < viterbiScores.n_elem; ++j)
+    {
+      scores[j] = (viterbiScores + logTransition.col(j)).max(index) +
+          logEmission[j];
+      if (lag > 0)
+        backPointers(j, steps % lag) = index;
+    }
+    viterbiScores = std::move(scores);
+  }
+
+  // Normalize the posterior, and accumulate the log-likelihood.
+  const double scale = arma::accu(posterior);
+  if (scale > 0.0)
+    posterior /= scale;
+  logLikelihood += std::log(scale) + shift;
+
+  // Only the differences of the Viterbi scores matter; keep them near 0.
+  const double maxScore = viterbiScores.max();
+  if (std::isfinite(maxScore))
+    viterbiScores -= maxScore;
+
+  ++steps;
+  if (steps <= lag)
+    return false;
+
+  decodedState = Backtrack(lag);
+  return true;
+}
+
+template<typename Distribution>
+void StreamingDecoder<Distribution>::Flush(arma::Row<size_t>& states)
+{
+  // The states of the last min(lag, steps) observations have not been decoded.
+  const size_t remaining = std::min(lag, steps);
+  states.set_size(remaining);
+  if (remaining > 0)
+  {
+    arma::uword state;
+    viterbiScores.max(state);
+    states[remaining - 1] = state;
+    for (size_t k = 1; k < remaining; ++k)
+    {
+      states[remaining - 1 - k] = backPointers(states[remaining - k],
+          (steps - k) % lag);
+    }
+  }
+
+  Reset();
+}
+
+template<typename Distribution>
+size_t StreamingDecoder<Distribution>::Backtrack(const size_t back) const
+{
+  arma::uword state;
+  viterbiScores.max(state);
+
+  // The back-pointers of step t give the best state of step t - 1.
+  for (size_t k = 0; k < back; ++k)
+    state = backPointers(state, (steps - 1 - k) % lag);
+
+  return state;
+}
+
+template<typename Distribution>
+template<typename DistType>
+void StreamingDecoder<Distribution>::EmissionLogProbability(
+    const arma::vec& observation,
+    arma::vec& logProb,
+    const typename std::enable_if<
+        HasBatchLogProbability<DistType>::value>::type*) const
+{
+  logProb.set_size(hmm.Emission().size());
+  arma::vec stateLogProb;
+  for (size_t state = 0; state < hmm.Emission().size(); ++state)
+  {
+    hmm.Emission()[state].LogProbability(observation, stateLogProb);
+    logProb[state] = stateLogProb[0];
+  }
+}
+
+template<typename Distribution>
+template<typename DistType>
+void StreamingDecoder<Distribution>::EmissionLogProbability(
+    const arma::vec& observation,
+    arma::vec& logProb,
+    const typename std::enable_if<
+        !HasBatchLogProbability<DistType>::value>::type*) const
+{
+  logProb.set_size(hmm.Emission().size());
+  for (size_t state = 0; state < hmm.Emission().size(); ++state)
+    logProb[state] = std::log(hmm.Emission()[state].Probability(observation));
+}
+
+} // namespace hmm
+} // namespace mlpack
+
+#endif
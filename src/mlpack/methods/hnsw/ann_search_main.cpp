@@ -0,0 +1,200 @@
+/**
+ * @file ann_search_main.cpp
+ *
+ * This file computes the approximate nearest-neighbors using a hierarchical
+ * navigable small world graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "hnsw_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with HNSW",
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points using a hierarchical navigable small world (HNSW) graph built "
+    "on the reference set.  You may specify a separate set of reference points "
+    "and query points, or just a reference set which will be used as both the "
+    "reference and query set.  The output has the same format as the output of"
+    " the knn program."
+    "\n\n"
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + " and store the distances in " +
+    PRINT_DATASET("distances") + " and the neighbors in " +
+    PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("ann_search", "k", 5, "reference", "input", "distances",
+        "distances", "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row j and column i in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points."
+    "\n\n"
+    "Each point is linked to " + PRINT_PARAM_STRING("connectivity") + " of "
+    "its neighbors when the graph is built, which searches " +
+    PRINT_PARAM_STRING("ef_construction") + " candidates for each point; the "
+    "search for each query keeps the best " + PRINT_PARAM_STRING("ef") +
+    " points.  Larger values of these parameters give more accurate results "
+    "for slower searches.  The graph is random, so the " +
+    PRINT_PARAM_STRING("seed") + " parameter can be specified to set the "
+    "random seed.");
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(HNSWSearch<>, "input_model", "Input HNSW model.", "m");
+PARAM_MODEL_OUT(HNSWSearch<>, "output_model", "Output for trained HNSW model.",
+    "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("connectivity", "The number of links added for each point on "
+    "each level of the graph.", "c", 16);
+PARAM_INT_IN("ef_construction", "The number of candidates searched for the "
+    "links of each point while building the graph.", "e", 200);
+PARAM_INT_IN("ef", "The number of candidates kept by the search for each "
+    "query.", "E", 50);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (CLI::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("connectivity", [](int x) { return x >= 2; }, true,
+      "connectivity must be at least 2");
+  RequireParamValue<int>("ef_construction", [](int x) { return x > 0; }, true,
+      "ef_construction must be greater than 0");
+  RequireParamValue<int>("ef", [](int x) { return x > 0; }, true,
+      "ef must be greater than 0");
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "true_neighbors");
+  ReportIgnoredParam({{ "k", false }}, "query");
+
+  ReportIgnoredParam({{ "reference", false }}, "connectivity");
+  ReportIgnoredParam({{ "reference", false }}, "ef_construction");
+
+  if (CLI::HasParam("input_model") && !CLI::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  HNSWSearch<>* ann;
+  if (CLI::HasParam("reference"))
+  {
+    ann = new HNSWSearch<>((size_t) CLI::GetParam<int>("connectivity"),
+        (size_t) CLI::GetParam<int>("ef_construction"));
+    arma::mat referenceData = std::move(CLI::GetParam<arma::mat>("reference"));
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceData.n_rows << " x " << referenceData.n_cols << ")."
+        << endl;
+
+    Timer::Start("graph_building");
+    ann->Train(std::move(referenceData));
+    Timer::Stop("graph_building");
+  }
+  else // We must have an input model.
+  {
+    ann = CLI::GetParam<HNSWSearch<>*>("input_model");
+  }
+  ann->Ef() = (size_t) CLI::GetParam<int>("ef");
+
+  if (CLI::HasParam("k"))
+  {
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+    const size_t numPoints = ann->ReferenceSet().n_cols;
+    if (k > numPoints || (!CLI::HasParam("query") && k == numPoints))
+    {
+      Log::Fatal << "Invalid k: " << k << "; must be less than or equal to the "
+          << "number of reference points (" << numPoints << "), and less than "
+          << "it if query data has not been provided." << endl;
+    }
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+
+    Log::Info << "Computing " << k << " distance approximate nearest neighbors."
+        << endl;
+    Timer::Start("computing_neighbors");
+    if (CLI::HasParam("query"))
+    {
+      arma::mat queryData = std::move(CLI::GetParam<arma::mat>("query"));
+      Log::Info << "Loaded query data from '"
+          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+          << queryData.n_rows << " x " << queryData.n_cols << ")." << endl;
+
+      if (queryData.n_rows != ann->ReferenceSet().n_rows)
+      {
+        Log::Fatal << "Query has invalid dimensions (" << queryData.n_rows
+            << "); should be " << ann->ReferenceSet().n_rows << "!" << endl;
+      }
+
+      ann->Search(queryData, k, neighbors, distances);
+    }
+    else
+    {
+      ann->Search(k, neighbors, distances);
+    }
+    Timer::Stop("computing_neighbors");
+    Log::Info << "Neighbors computed." << endl;
+
+    // Compute recall, if desired.
+    if (CLI::HasParam("true_neighbors"))
+    {
+      arma::Mat<size_t>& trueNeighbors =
+          CLI::GetParam<arma::Mat<size_t>>("true_neighbors");
+      if (trueNeighbors.n_rows != neighbors.n_rows ||
+          trueNeighbors.n_cols != neighbors.n_cols)
+      {
+        Log::Fatal << "The true neighbors file must have the same number of "
+            << "values as the set of neighbors being queried!" << endl;
+      }
+
+      Log::Info << "Recall: " << KNN::Recall(neighbors, trueNeighbors) << endl;
+    }
+
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+
+  CLI::GetParam<HNSWSearch<>*>("output_model") = ann;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world graph built on the
+ * reference set.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @article{malkov2018efficient,
+ *  title={Efficient and robust approximate nearest neighbor search using
+ *      hierarchical navigable small world graphs},
+ *  author={Malkov, Y.A. and Yashunin, D.A.},
+ *  journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *  volume={42},
+ *  number={4},
+ *  pages={824--836},
+ *  year={2018}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world (HNSW)
+ * graph on the reference set, and uses it to compute the approximate nearest
+ * neighbors of the given queries.  Every point is linked to a few of its
+ * nearest neighbors on level 0 of the graph, and each point also appears on
+ * levels 1 to l with probability exponentially decreasing in l; a query
+ * descends greedily through the sparse upper levels, and then runs a best-first
+ * search of width ef on level 0.  Larger values of ef give better recall for a
+ * slower search.
+ *
+ * The graph is built in batches of points: the neighbors of all the points of
+ * a batch are searched in parallel in the graph of the points inserted before
+ * it (and among the earlier points of the batch), and then the reverse links
+ * of the batch are added in parallel, one list at a time.  The graph thus only
+ * depends on the random seed, and not on the number of threads.
+ *
+ * The results have the same format as those of NeighborSearch: the neighbors
+ * of query i, sorted by distance, are in column i of the neighbors matrix,
+ * with their distances in column i of the distances matrix.
+ *
+ * @tparam MetricType The metric to search with; any metric works, although the
+ *     search is fastest with metrics whose Evaluate() is a single Armadillo
+ *     expression, like the LMetric classes.
+ * @tparam MatType Type of the matrix to store the reference set in.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  //! The type of the elements of the data.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Build the graph on the given reference set.  In order to avoid copying the
+   * reference set, it is suggested to pass that parameter with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param m The number of links added for each point on each level (points
+   *     may have up to 2m links on level 0).
+   * @param efConstruction The width of the search for the neighbors of each
+   *     point while building the graph.
+   * @param ef The default width of the search for queries.
+   * @param metric An optional instance of the metric type.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t m = 16,
+             const size_t efConstruction = 200,
+             const size_t ef = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Create an empty object; Train() must be called before Search().
+   *
+   * @param m The number of links added for each point on each level.
+   * @param efConstruction The width of the search for the neighbors of each
+   *     point while building the graph.
+   * @param ef The default width of the search for queries.
+   * @param metric An optional instance of the metric type.
+   */
+  HNSWSearch(const size_t m = 16,
+             const size_t efConstruction = 200,
+             const size_t ef = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Build the graph on the given reference set, with the current parameters,
+   * replacing any previous graph.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the query set,
+   * and store the output in the given matrices.  The matrices will be set to
+   * the size of k by querySet.n_cols.  If fewer than k neighbors are found for
+   * a query, the remaining neighbors are set to the number of reference points
+   * and their distances to DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param ef The width of the search; if 0 (the default), Ef() is used.  It is
+   *     increased to k if it is smaller.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t ef = 0) const;
+
+  /**
+   * Compute the approximate nearest neighbors of every point in the reference
+   * set, and store the output in the given matrices.  Each point is not its own
+   * neighbor.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   * @param ef The width of the search; if 0 (the default), Ef() is used.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t ef = 0) const;
+
+  //! Get the reference set.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of links added for each point on each level.
+  size_t M() const { return m; }
+  //! Get the width of the search while building the graph.
+  size_t EfConstruction() const { return efConstruction; }
+  //! Get the default width of the search for queries.
+  size_t Ef() const { return ef; }
+  //! Modify the default width of the search for queries.
+  size_t& Ef() { return ef; }
+
+  //! Get the highest level of the given point.
+  size_t Level(const size_t point) const { return levels[point]; }
+  //! Get the highest level of the graph.
+  size_t MaxLevel() const { return maxLevel; }
+  //! Get the point the searches start from.
+  size_t EntryPoint() const { return entryPoint; }
+
+  /**
+   * Get the links of the given point on the given level, which must be at most
+   * Level(point).
+   *
+   * @param point Index of the point.
+   * @param level Level of the graph.
+   */
+  arma::Col<size_t> Neighbors(const size_t point, const size_t level) const;
+
+  //! Get the instance of the metric.
+  const MetricType& Metric() const { return metric; }
+
+  /**
+   * Serialize the object.
+   *
+   * @param ar Archive to serialize to.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A point of a search, with its distance to the query.
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Get the links of the given point on the given level; the first element
+  //! is the number of links.
+  size_t* Links(const size_t point, const size_t level)
+  {
+    return (level == 0) ? baseLinks.colptr(point) :
+        upperLinks.colptr(upperOffsets[point] + level - 1);
+  }
+
+  //! Get the links of the given point on the given level.
+  const size_t* Links(const size_t point, const size_t level) const
+  {
+    return (level == 0) ? baseLinks.colptr(point) :
+        upperLinks.colptr(upperOffsets[point] + level - 1);
+  }
+
+  //! Evaluate the distance between two reference points.
+  double Distance(const size_t a, const size_t b) const
+  {
+    return metric.Evaluate(referenceSet.unsafe_col(a),
+        referenceSet.unsafe_col(b));
+  }
+
+  /**
+   * Descend greedily to the point closest to the query on the given level.
+   *
+   * @param query The query point.
+   * @param current The point to start from; it is updated.
+   * @param level Level of the graph.
+   */
+  template<typename VecType>
+  void GreedySearch(const VecType& query,
+                    Candidate& current,
+                    const size_t level) const;
+
+  /**
+   * Run a best-first search of the given width on the given level.
+   *
+   * @param query The query point.
+   * @param results The points to start from, on input; the (at most ef)
+   *     closest points found, sorted by distance, on output.
+   * @param ef The width of the search.
+   * @param level Level of the graph.
+   * @param visited Marks of the visited points; all false on entry and exit.
+   */
+  template<typename VecType>
+  void SearchLevel(const VecType& query,
+                   std::vector<Candidate>& results,
+                   const size_t ef,
+                   const size_t level,
+                   std::vector<bool>& visited) const;
+
+  /**
+   * Search for the k nearest neighbors of one query point.
+   *
+   * @param query The query point.
+   * @param k Number of neighbors to search for.
+   * @param ef The width of the search.
+   * @param skip A reference point that is not a neighbor (or the number of
+   *     reference points).
+   * @param neighbors The neighbors of the query.
+   * @param distances The distances of the neighbors.
+   * @param visited Marks of the visited points.
+   */
+  template<typename VecType>
+  void SearchPoint(const VecType& query,
+                   const size_t k,
+                   const size_t ef,
+                   const size_t skip,
+                   size_t* neighbors,
+                   double* distances,
+                   std::vector<bool>& visited) const;
+
+  /**
+   * Select the links of a point from the given candidates, sorted by distance:
+   * a candidate is kept if it is closer to the point than to any kept
+   * candidate, which keeps links in every direction.
+   *
+   * @param candidates Candidate neighbors, sorted by distance.
+   * @param maxDegree The largest number of links.
+   * @param links Links of the point; the first element is the number of links.
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t maxDegree,
+                       size_t* links) const;
+
+  /**
+   * Find and link the neighbors of the points in [begin, end), which must be
+   * inserted after all the points before begin.
+   *
+   * @param begin The first point of the batch.
+   * @param end One past the last point of the batch.
+   */
+  void InsertBatch(const size_t begin, const size_t end);
+
+  //! Reference dataset.
+  MatType referenceSet;
+
+  //! The number of links added for each point on each level.
+  size_t m;
+  //! The width of the search while building the graph.
+  size_t efConstruction;
+  //! The default width of the search for queries.
+  size_t ef;
+
+  //! The highest level of each point.
+  arma::Col<size_t> levels;
+  //! The column of upperLinks holding the level 1 links of each point (the
+  //! links of its other levels follow it).
+  arma::Col<size_t> upperOffsets;
+  //! The links of every point on level 0, one column per point; the first row
+  //! holds the number of links.
+  arma::Mat<size_t> baseLinks;
+  //! The links of the points on the upper levels, one column per point and
+  //! level; the first row holds the number of links.
+  arma::Mat<size_t> upperLinks;
+
+  //! The point the searches start from, on the highest level.
+  size_t entryPoint;
+  //! The highest level of the graph.
+  size_t maxLevel;
+
+  //! Instantiated metric.
+  MetricType metric;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
@@ -0,0 +1,480 @@
+/**
+ * @file hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSet,
+                                            const size_t m,
+                                            const size_t efConstruction,
+                                            const size_t ef,
+                                            const MetricType metric) :
+    m(m),
+    efConstruction(efConstruction),
+    ef(ef),
+    entryPoint(0),
+    maxLevel(0),
+    metric(metric)
+{
+  Train(std::move(referenceSet));
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const size_t m,
+                                            const size_t efConstruction,
+                                            const size_t ef,
+                                            const MetricType metric) :
+    m(m),
+    efConstruction(efConstruction),
+    ef(ef),
+    entryPoint(0),
+    maxLevel(0),
+    metric(metric)
+{
+  // Nothing to do; the graph is empty.
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSetIn)
+{
+  if (m < 2)
+  {
+    throw std::invalid_argument("HNSWSearch::Train(): m must be at least 2 "
+        "(given " + std::to_string(m) + ")");
+  }
+
+  referenceSet = std::move(referenceSetIn);
+  const size_t numPoints = referenceSet.n_cols;
+
+  // Draw the level of every point from a geometric distribution, so that the
+  // expected number of points shrinks by a factor of m on each level.
+  const double levelMultiplier = 1.0 / std::log((double) m);
+  levels.set_size(numPoints);
+  upperOffsets.set_size(numPoints);
+  size_t upperColumns = 0;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    levels[i] = (size_t) std::floor(-std::log(1.0 - math::Random()) *
+        levelMultiplier);
+    upperOffsets[i] = upperColumns;
+    upperColumns += levels[i];
+  }
+
+  baseLinks.zeros(2 * m + 1, numPoints);
+  upperLinks.zeros(m + 1, upperColumns);
+
+  entryPoint = 0;
+  maxLevel = (numPoints > 0) ? levels[0] : 0;
+
+  // Each batch is a fraction of the graph it is inserted in, so that its
+  // points find nearly the same neighbors as if they were inserted one by one.
+  const size_t maxBatchSize = 1024;
+  size_t inserted = std::min(numPoints, (size_t) 1);
+  while (inserted < numPoints)
+  {
+    const size_t batchSize = std::min(numPoints - inserted,
+        std::max((size_t) 1, std::min(inserted / 8, maxBatchSize)));
+    InsertBatch(inserted, inserted + batchSize);
+    inserted += batchSize;
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::InsertBatch(const size_t begin,
+                                                  const size_t end)
+{
+  // Select the links of each point of the batch.  Only the links of the batch
+  // are written, and only the links of the earlier points are read.
+  #pragma omp parallel
+  {
+    std::vector<bool> visited(referenceSet.n_cols, false);
+    std::vector<Candidate> results;
+    std::vector<std::vector<Candidate>> candidates;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+    {
+      const size_t point = (size_t) i;
+      const size_t level = levels[point];
+      candidates.clear();
+      candidates.resize(level + 1);
+
+      // Search the graph of the points before the batch.
+      Candidate current(Distance(point, entryPoint), entryPoint);
+      for (size_t l = maxLevel; l > level; --l)
+        GreedySearch(referenceSet.unsafe_col(point), current, l);
+
+      results.assign(1, current);
+      for (size_t l = std::min(level, maxLevel) + 1; l-- > 0; )
+      {
+        SearchLevel(referenceSet.unsafe_col(point), results, efConstruction, l,
+            visited);
+        candidates[l] = results;
+      }
+
+      // The earlier points of the batch are not in the graph yet, so they are
+      // compared directly.
+      for (size_t other = begin; other < point; ++other)
+      {
+        const Candidate candidate(Distance(point, other), other);
+        for (size_t l = 0; l <= std::min(level, levels[other]); ++l)
+          candidates[l].push_back(candidate);
+      }
+
+      for (size_t l = 0; l <= level; ++l)
+      {
+        std::sort(candidates[l].begin(), candidates[l].end());
+        SelectNeighbors(candidates[l], m, Links(point, l));
+      }
+    }
+  }
+
+  // Collect the reverse links, grouped by the list they are added to.
+  std::vector<std::tuple<size_t, size_t, size_t>> reverseLinks;
+  for (size_t point = begin; point < end; ++point)
+  {
+    for (size_t l = 0; l <= levels[point]; ++l)
+    {
+      const size_t* links = Links(point, l);
+      for (size_t j = 1; j <= links[0]; ++j)
+        reverseLinks.push_back(std::make_tuple(links[j], l, point));
+    }
+  }
+  std::sort(reverseLinks.begin(), reverseLinks.end());
+
+  std::vector<size_t> groupStarts;
+  for (size_t j = 0; j < reverseLinks.size(); ++j)
+  {
+    if (j == 0 || std::get<0>(reverseLinks[j]) !=
+        std::get<0>(reverseLinks[j - 1]) || std::get<1>(reverseLinks[j]) !=
+        std::get<1>(reverseLinks[j - 1]))
+      groupStarts.push_back(j);
+  }
+  groupStarts.push_back(reverseLinks.size());
+
+  // Each group modifies a different list, so the groups are independent.
+  #pragma omp parallel
+  {
+    std::vector<Candidate> candidates;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t g = 0; g < (omp_size_t) groupStarts.size() - 1; ++g)
+    {
+      const size_t point = std::get<0>(reverseLinks[groupStarts[g]]);
+      const size_t level = std::get<1>(reverseLinks[groupStarts[g]]);
+      const size_t maxDegree = (level == 0) ? 2 * m : m;
+      size_t* links = Links(point, level);
+
+      for (size_t j = groupStarts[g]; j < groupStarts[g + 1]; ++j)
+      {
+        const size_t newLink = std::get<2>(reverseLinks[j]);
+        if (links[0] < maxDegree)
+        {
+          links[++links[0]] = newLink;
+          continue;
+        }
+
+        // The list is full; select its links again, with the new one.
+        candidates.clear();
+        for (size_t k = 1; k <= links[0]; ++k)
+          candidates.push_back(Candidate(Distance(point, links[k]), links[k]));
+        candidates.push_back(Candidate(Distance(point, newLink), newLink));
+        std::sort(candidates.begin(), candidates.end());
+        SelectNeighbors(candidates, maxDegree, links);
+      }
+    }
+  }
+
+  // The searches start from the first point of the highest level.
+  for (size_t point = begin; point < end; ++point)
+  {
+    if (levels[point] > maxLevel)
+    {
+      maxLevel = levels[point];
+      entryPoint = point;
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxDegree,
+    size_t* links) const
+{
+  links[0] = 0;
+  for (size_t i = 0; i < candidates.size() && links[0] < maxDegree; ++i)
+  {
+    bool keep = true;
+    for (size_t j = 1; j <= links[0] && keep; ++j)
+      keep = (Distance(candidates[i].second, links[j]) >= candidates[i].first);
+
+    if (keep)
+      links[++links[0]] = candidates[i].second;
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::GreedySearch(const VecType& query,
+                                                   Candidate& current,
+                                                   const size_t level) const
+{
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+    const size_t* links = Links(current.second, level);
+    for (size_t i = 1; i <= links[0]; ++i)
+    {
+      const double distance = metric.Evaluate(query,
+          referenceSet.unsafe_col(links[i]));
+      if (distance < current.first)
+      {
+        current = Candidate(distance, links[i]);
+        changed = true;
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchLevel(
+    const VecType& query,
+    std::vector<Candidate>& results,
+    const size_t ef,
+    const size_t level,
+    std::vector<bool>& visited) const
+{
+  // The frontier is a min-heap of the points to expand, and the best points
+  // are a max-heap of the ef closest points found so far.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> frontier;
+  std::priority_queue<Candidate> best;
+  std::vector<size_t> touched;
+
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    visited[results[i].second] = true;
+    touched.push_back(results[i].second);
+    frontier.push(results[i]);
+    best.push(results[i]);
+  }
+  while (best.size() > ef)
+    best.pop();
+
+  while (!frontier.empty())
+  {
+    const Candidate current = frontier.top();
+    if (best.size() >= ef && current.first > best.top().first)
+      break;
+    frontier.pop();
+
+    const size_t* links = Links(current.second, level);
+    for (size_t i = 1; i <= links[0]; ++i)
+    {
+      const size_t neighbor = links[i];
+      if (visited[neighbor])
+        continue;
+      visited[neighbor] = true;
+      touched.push_back(neighbor);
+
+      const double distance = metric.Evaluate(query,
+          referenceSet.unsafe_col(neighbor));
+      if (best.size() < ef || distance < best.top().first)
+      {
+        frontier.push(Candidate(distance, neighbor));
+        best.push(Candidate(distance, neighbor));
+        if (best.size() > ef)
+          best.pop();
+      }
+    }
+  }
+
+  // Clear only the marks that were set.
+  for (size_t i = 0; i < touched.size(); ++i)
+    visited[touched[i]] = false;
+
+  results.resize(best.size());
+  for (size_t i = results.size(); i > 0; --i)
+  {
+    results[i - 1] = best.top();
+    best.pop();
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchPoint(
+    const VecType& query,
+    const size_t k,
+    const size_t ef,
+    const size_t skip,
+    size_t* neighbors,
+    double* distances,
+    std::vector<bool>& visited) const
+{
+  Candidate current(metric.Evaluate(query, referenceSet.unsafe_col(
+      entryPoint)), entryPoint);
+  for (size_t l = maxLevel; l > 0; --l)
+    GreedySearch(query, current, l);
+
+  std::vector<Candidate> results(1, current);
+  SearchLevel(query, results, ef, 0, visited);
+
+  size_t found = 0;
+  for (size_t i = 0; i < results.size() && found < k; ++i)
+  {
+    if (results[i].second == skip)
+      continue;
+
+    neighbors[found] = results[i].second;
+    distances[found] = results[i].first;
+    ++found;
+  }
+
+  for (; found < k; ++found)
+  {
+    neighbors[found] = referenceSet.n_cols;
+    distances[found] = DBL_MAX;
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const MatType& querySet,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances,
+                                             const size_t ef) const
+{
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  const size_t width = std::max(k, (ef == 0) ? this->ef : ef);
+
+  #pragma omp parallel
+  {
+    std::vector<bool> visited(referenceSet.n_cols, false);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      SearchPoint(querySet.unsafe_col(i), k, width, referenceSet.n_cols,
+          neighbors.colptr(i), distances.colptr(i), visited);
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances,
+                                             const size_t ef) const
+{
+  if (k >= referenceSet.n_cols && referenceSet.n_cols > 0)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+  if (k == 0)
+    return;
+
+  // The point itself is found too, and skipped.
+  const size_t width = std::max(k + 1, (ef == 0) ? this->ef : ef);
+
+  #pragma omp parallel
+  {
+    std::vector<bool> visited(referenceSet.n_cols, false);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+    {
+      SearchPoint(referenceSet.unsafe_col(i), k, width, (size_t) i,
+          neighbors.colptr(i), distances.colptr(i), visited);
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+arma::Col<size_t> HNSWSearch<MetricType, MatType>::Neighbors(
+    const size_t point,
+    const size_t level) const
+{
+  if (point >= referenceSet.n_cols || level > levels[point])
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Neighbors(): point " << point << " has no links on "
+        << "level " << level << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t* links = Links(point, level);
+  return arma::Col<size_t>(links + 1, links[0]);
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  ar & BOOST_SERIALIZATION_NVP(m);
+  ar & BOOST_SERIALIZATION_NVP(efConstruction);
+  ar & BOOST_SERIALIZATION_NVP(ef);
+  ar & BOOST_SERIALIZATION_NVP(levels);
+  ar & BOOST_SERIALIZATION_NVP(upperOffsets);
+  ar & BOOST_SERIALIZATION_NVP(baseLinks);
+  ar & BOOST_SERIALIZATION_NVP(upperLinks);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(maxLevel);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * @file drift_detection_method.hpp
+ *
+ * The drift detection method (DDM), which detects changes of the error rate of
+ * a streaming classifier.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_DRIFT_DETECTION_METHOD_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_DRIFT_DETECTION_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The drift detection method of Gama et al. ("Learning with drift detection",
+ * SBIA 2004).  The errors of a classifier on the points it is about to be
+ * trained on are modeled as Bernoulli trials: with p the error rate so far and
+ * s = sqrt(p (1 - p) / n) its standard deviation, the smallest p + s is
+ * recorded, and a warning is given when p + s exceeds it by warningLevel
+ * standard deviations, or a drift when it exceeds it by driftLevel standard
+ * deviations.
+ */
+class DriftDetectionMethod
+{
+ public:
+  //! The state of the classifier after an update.
+  enum State
+  {
+    STABLE,
+    WARNING,
+    DRIFT
+  };
+
+  /**
+   * Create the detector.
+   *
+   * @param warningLevel Number of standard deviations for a warning.
+   * @param driftLevel Number of standard deviations for a drift.
+   * @param minSamples Number of predictions before any detection.
+   */
+  DriftDetectionMethod(const double warningLevel = 2.0,
+                       const double driftLevel = 3.0,
+                       const size_t minSamples = 30) :
+      warningLevel(warningLevel),
+      driftLevel(driftLevel),
+      minSamples(minSamples)
+  {
+    Reset();
+  }
+
+  /**
+   * Add the result of one prediction, and return the state of the classifier.
+   * The detector must be reset after a drift.
+   *
+   * @param error Whether the prediction was wrong.
+   */
+  State Update(const bool error)
+  {
+    ++samples;
+    if (error)
+      ++errors;
+    if (samples < minSamples)
+      return STABLE;
+
+    const double p = double(errors) / samples;
+    const double s = std::sqrt(p * (1.0 - p) / samples);
+    if (p + s < minP + minS)
+    {
+      minP = p;
+      minS = s;
+    }
+
+    if (p + s > minP + driftLevel * minS)
+      return DRIFT;
+    else if (p + s > minP + warningLevel * minS)
+      return WARNING;
+    return STABLE;
+  }
+
+  //! Forget all the predictions.
+  void Reset()
+  {
+    samples = 0;
+    errors = 0;
+    minP = DBL_MAX;
+    minS = DBL_MAX;
+  }
+
+  //! Get the number of predictions since the last reset.
+  size_t Samples() const { return samples; }
+  //! Get the error rate since the last reset.
+  double ErrorRate() const
+  {
+    return (samples == 0) ? 0.0 : double(errors) / samples;
+  }
+
+  //! Serialize the detector.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(warningLevel);
+    ar & BOOST_SERIALIZATION_NVP(driftLevel);
+    ar & BOOST_SERIALIZATION_NVP(minSamples);
+    ar & BOOST_SERIALIZATION_NVP(samples);
+    ar & BOOST_SERIALIZATION_NVP(errors);
+    ar & BOOST_SERIALIZATION_NVP(minP);
+    ar & BOOST_SERIALIZATION_NVP(minS);
+  }
+
+ private:
+  //! Number of standard deviations for a warning.
+  double warningLevel;
+  //! Number of standard deviations for a drift.
+  double driftLevel;
+  //! Number of predictions before any detection.
+  size_t minSamples;
+  //! Number of predictions since the last reset.
+  size_t samples;
+  //! Number of wrong predictions since the last reset.
+  size_t errors;
+  //! The error rate at the smallest p + s.
+  double minP;
+  //! The standard deviation at the smallest p + s.
+  double minS;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,219 @@
+/**
+ * @file hoeffding_forest.hpp
+ *
+ * An online bagging ensemble of Hoeffding trees, trained in parallel, which
+ * replaces the trees whose accuracy drifts.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/philox.hpp>
+#include "hoeffding_tree.hpp"
+#include "drift_detection_method.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HoeffdingForest is a streaming classifier made of several Hoeffding
+ * trees, trained with the online bagging of
+ *
+ * @code
+ * @inproceedings{oza2001online,
+ *   title={Online bagging and boosting},
+ *   author={Oza, N.C. and Russell, S.},
+ *   booktitle={Proceedings of the Eighth International Workshop on Artificial
+ *       Intelligence and Statistics (AISTATS 2001)},
+ *   pages={105--112},
+ *   year={2001}
+ * }
+ * @endcode
+ *
+ * Each tree is trained on each point k times, where k is drawn from a Poisson
+ * distribution (of mean 1 by default), which mimics the bootstrap samples of
+ * bagging on a stream.  The trees are trained in parallel, one per thread, on
+ * each batch of points given to Train(), and predict by majority vote.
+ *
+ * Optionally, as in the adaptive random forest of Gomes et al. ("Adaptive
+ * random forests for evolving data stream classification", Machine Learning,
+ * 2017), each tree is tested on each point before it is trained on it, and a
+ * DriftDetectionMethod follows its errors.  When it warns, a background tree
+ * is trained alongside the tree, and when it detects a drift, the background
+ * tree replaces the tree, so that the ensemble recovers quickly from a change
+ * of the concept.
+ *
+ * The random weights only depend on the seed and on the number of points seen
+ * so far, so training is deterministic whatever the number of threads.
+ *
+ * @tparam FitnessFunction Fitness function of the trees.
+ * @tparam NumericSplitType Technique for splitting numeric features.
+ * @tparam CategoricalSplitType Technique for splitting categorical features.
+ */
+template<typename FitnessFunction = GiniImpurity,
+         template<typename> class NumericSplitType =
+             HoeffdingDoubleNumericSplit,
+         template<typename> class CategoricalSplitType =
+             HoeffdingCategoricalSplit
+>
+class HoeffdingForest
+{
+ public:
+  //! The type of the trees of the ensemble.
+  typedef HoeffdingTree<FitnessFunction, NumericSplitType,
+      CategoricalSplitType> TreeType;
+
+  /**
+   * Create the ensemble, without training it.
+   *
+   * @param datasetInfo Information on the dataset (types of each feature).
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of trees in the ensemble.
+   * @param lambda Mean of the Poisson distribution of the weights.
+   * @param detectDrift Whether to replace the trees whose accuracy drifts.
+   * @param successProbability Probability of success required in Hoeffding
+   *      bounds before a split can happen.
+   * @param maxSamples Maximum number of samples before a split is forced (0
+   *      never forces a split).
+   * @param checkInterval Number of samples required before each split check.
+   * @param minSamples If a node has seen this many points or fewer, no split
+   *      will be allowed.
+   */
+  HoeffdingForest(const data::DatasetInfo& datasetInfo,
+                  const size_t numClasses,
+                  const size_t numTrees = 10,
+                  const double lambda = 1.0,
+                  const bool detectDrift = true,
+                  const double successProbability = 0.95,
+                  const size_t maxSamples = 0,
+                  const size_t checkInterval = 100,
+                  const size_t minSamples = 100);
+
+  /**
+   * Create an empty ensemble.  Be sure to load one before using it.
+   */
+  HoeffdingForest();
+
+  //! Copy another ensemble (this copies every tree).
+  HoeffdingForest(const HoeffdingForest& other);
+
+  //! Copy another ensemble (this copies every tree).
+  HoeffdingForest& operator=(const HoeffdingForest& other);
+
+  //! Clean up memory.
+  ~HoeffdingForest();
+
+  /**
+   * Train the ensemble in streaming mode on the given batch of points, in
+   * order.  The trees are trained in parallel.
+   *
+   * @param data Points to train on.
+   * @param labels Labels of the points.
+   */
+  template<typename MatType>
+  void Train(const MatType& data, const arma::Row<size_t>& labels);
+
+  /**
+   * Classify the given points by majority vote of the trees.  The points are
+   * classified in parallel.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted labels for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points by majority vote of the trees, and also return
+   * the fraction of the votes for each class.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted labels for each point.
+   * @param probabilities Fraction of the votes for each class (one row per
+   *      class), for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees in the ensemble.
+  size_t NumTrees() const { return trees.size(); }
+  //! Get the given tree.
+  const TreeType& Tree(const size_t i) const { return *trees[i]; }
+  //! Modify the given tree.
+  TreeType& Tree(const size_t i) { return *trees[i]; }
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the number of trees that have been replaced after a drift.
+  size_t Replacements() const { return replacements; }
+
+  //! Get the number of points the ensemble has been trained on.
+  size_t SeenSamples() const { return seenSamples; }
+
+  //! Serialize the ensemble.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Create an untrained tree with the parameters of the ensemble.
+  TreeType* NewTree() const;
+
+  /**
+   * Train the given tree on the given points, each one as many times as its
+   * Poisson weight from the given stream.
+   */
+  template<typename MatType>
+  void TrainTree(TreeType& tree,
+                 const MatType& data,
+                 const arma::Row<size_t>& labels,
+                 const uint64_t stream) const;
+
+  //! Delete all the trees.
+  void Clear();
+
+  //! Information on the dataset.
+  data::DatasetInfo datasetInfo;
+  //! The number of classes.
+  size_t numClasses;
+  //! The mean of the Poisson distribution of the weights.
+  double lambda;
+  //! Whether to replace the trees whose accuracy drifts.
+  bool detectDrift;
+  //! Probability of success of the Hoeffding bounds of the trees.
+  double successProbability;
+  //! Maximum number of samples before a split is forced.
+  size_t maxSamples;
+  //! Number of samples between split checks.
+  size_t checkInterval;
+  //! Minimum number of samples for a split.
+  size_t minSamples;
+  //! The seed of the random weights.
+  uint64_t seed;
+  //! The number of points seen so far.
+  size_t seenSamples;
+  //! The number of trees replaced after a drift.
+  size_t replacements;
+
+  //! The trees of the ensemble.
+  std::vector<TreeType*> trees;
+  //! The background tree of each tree after a warning (or NULL).
+  std::vector<TreeType*> backgroundTrees;
+  //! The drift detector of each tree.
+  std::vector<DriftDetectionMethod> detectors;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "hoeffding_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,339 @@
+/**
+ * @file hoeffding_forest_impl.hpp
+ *
+ * Implementation of the online bagging ensemble of Hoeffding trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hoeffding_forest.hpp"
+
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/math/parallel_blocks.hpp>
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+HoeffdingForest(const data::DatasetInfo& datasetInfo,
+                const size_t numClasses,
+                const size_t numTrees,
+                const double lambda,
+                const bool detectDrift,
+                const double successProbability,
+                const size_t maxSamples,
+                const size_t checkInterval,
+                const size_t minSamples) :
+    datasetInfo(datasetInfo),
+    numClasses(numClasses),
+    lambda(lambda),
+    detectDrift(detectDrift),
+    successProbability(successProbability),
+    maxSamples(maxSamples),
+    checkInterval(checkInterval),
+    minSamples(minSamples),
+    seed((uint64_t) math::RandInt(std::numeric_limits<int>::max())),
+    seenSamples(0),
+    replacements(0),
+    backgroundTrees(numTrees, NULL),
+    detectors(numTrees)
+{
+  if (numTrees == 0)
+    throw std::invalid_argument("HoeffdingForest: the number of trees must be "
+        "positive");
+  if (lambda <= 0.0)
+    throw std::invalid_argument("HoeffdingForest: lambda must be positive");
+
+  for (size_t i = 0; i < numTrees; ++i)
+    trees.push_back(NewTree());
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+HoeffdingForest() :
+    numClasses(0),
+    lambda(1.0),
+    detectDrift(true),
+    successProbability(0.95),
+    maxSamples(0),
+    checkInterval(100),
+    minSamples(100),
+    seed(0),
+    seenSamples(0),
+    replacements(0)
+{
+  // Nothing to do.
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+HoeffdingForest(const HoeffdingForest& other) :
+    datasetInfo(other.datasetInfo),
+    numClasses(other.numClasses),
+    lambda(other.lambda),
+    detectDrift(other.detectDrift),
+    successProbability(other.successProbability),
+    maxSamples(other.maxSamples),
+    checkInterval(other.checkInterval),
+    minSamples(other.minSamples),
+    seed(other.seed),
+    seenSamples(other.seenSamples),
+    replacements(other.replacements),
+    detectors(other.detectors)
+{
+  for (size_t i = 0; i < other.trees.size(); ++i)
+  {
+    trees.push_back(new TreeType(*other.trees[i]));
+    backgroundTrees.push_back((other.backgroundTrees[i] == NULL) ? NULL :
+        new TreeType(*other.backgroundTrees[i]));
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>&
+HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+operator=(const HoeffdingForest& other)
+{
+  if (this == &other)
+    return *this;
+
+  Clear();
+  datasetInfo = other.datasetInfo;
+  numClasses = other.numClasses;
+  lambda = other.lambda;
+  detectDrift = other.detectDrift;
+  successProbability = other.successProbability;
+  maxSamples = other.maxSamples;
+  checkInterval = other.checkInterval;
+  minSamples = other.minSamples;
+  seed = other.seed;
+  seenSamples = other.seenSamples;
+  replacements = other.replacements;
+  detectors = other.detectors;
+  for (size_t i = 0; i < other.trees.size(); ++i)
+  {
+    trees.push_back(new TreeType(*other.trees[i]));
+    backgroundTrees.push_back((other.backgroundTrees[i] == NULL) ? NULL :
+        new TreeType(*other.backgroundTrees[i]));
+  }
+
+  return *this;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+~HoeffdingForest()
+{
+  Clear();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+Train(const MatType& data, const arma::Row<size_t>& labels)
+{
+  if (labels.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HoeffdingForest::Train(): the number of labels (" << labels.n_elem
+        << ") must be the number of points (" << data.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  size_t newReplacements = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:newReplacements)
+  for (omp_size_t t = 0; t < (omp_size_t) trees.size(); ++t)
+  {
+    // Test the tree on the points before training it on them.
+    DriftDetectionMethod::State state = DriftDetectionMethod::STABLE;
+    if (detectDrift)
+    {
+      arma::Row<size_t> predictions;
+      trees[t]->Classify(data, predictions);
+      for (size_t i = 0; i < data.n_cols && state !=
+          DriftDetectionMethod::DRIFT; ++i)
+      {
+        state = std::max(state, detectors[t].Update(predictions[i] !=
+            labels[i]));
+      }
+    }
+
+    // A warning starts a background tree, which learns the new concept until
+    // a drift is detected.
+    if (state != DriftDetectionMethod::STABLE && backgroundTrees[t] == NULL)
+      backgroundTrees[t] = NewTree();
+
+    TrainTree(*trees[t], data, labels, 2 * t);
+    if (backgroundTrees[t] != NULL)
+      TrainTree(*backgroundTrees[t], data, labels, 2 * t + 1);
+
+    if (state == DriftDetectionMethod::DRIFT)
+    {
+      delete trees[t];
+      trees[t] = backgroundTrees[t];
+      backgroundTrees[t] = NULL;
+      detectors[t].Reset();
+      ++newReplacements;
+    }
+  }
+
+  seenSamples += data.n_cols;
+  replacements += newReplacements;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+Classify(const MatType& data, arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+Classify(const MatType& data,
+         arma::Row<size_t>& predictions,
+         arma::mat& probabilities) const
+{
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(numClasses, data.n_cols);
+
+  math::ParallelColumnBlocks(data.n_cols, [&](const size_t begin,
+                                              const size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      for (size_t t = 0; t < trees.size(); ++t)
+        probabilities(trees[t]->Classify(data.col(i)), i) += 1.0;
+
+      predictions[i] = probabilities.col(i).index_max();
+    }
+  });
+
+  probabilities /= trees.size();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+typename HoeffdingForest<FitnessFunction, NumericSplitType,
+    CategoricalSplitType>::TreeType*
+HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+NewTree() const
+{
+  return new TreeType(datasetInfo, numClasses, successProbability, maxSamples,
+      checkInterval, minSamples);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+TrainTree(TreeType& tree,
+          const MatType& data,
+          const arma::Row<size_t>& labels,
+          const uint64_t stream) const
+{
+  // The weight of the point with global index j comes from block j of the
+  // stream, by inversion of the cumulative distribution.
+  const math::Philox generator(seed, stream);
+  const double p0 = std::exp(-lambda);
+  std::vector<arma::uword> indices;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    uint32_t words[4];
+    generator.Block(seenSamples + i, words);
+    const uint64_t bits = (((uint64_t) words[0]) << 32) | words[1];
+    const double u = (bits >> 11) * (1.0 / 9007199254740992.0);
+
+    size_t k = 0;
+    double p = p0;
+    double cdf = p0;
+    while (u > cdf && p > 0.0)
+    {
+      ++k;
+      p *= lambda / k;
+      cdf += p;
+    }
+
+    indices.insert(indices.end(), k, (arma::uword) i);
+  }
+
+  if (indices.empty())
+    return;
+
+  const arma::uvec sample(indices);
+  tree.Train(MatType(data.cols(sample)), labels.cols(sample), false);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+Clear()
+{
+  for (size_t i = 0; i < trees.size(); ++i)
+  {
+    delete trees[i];
+    delete backgroundTrees[i];
+  }
+  trees.clear();
+  backgroundTrees.clear();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename Archive>
+void HoeffdingForest<FitnessFunction, NumericSplitType, CategoricalSplitType>::
+serialize(Archive& ar, const unsigned int /* version */)
+{
+  if (Archive::is_loading::value)
+    Clear();
+
+  ar & BOOST_SERIALIZATION_NVP(datasetInfo);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(lambda);
+  ar & BOOST_SERIALIZATION_NVP(detectDrift);
+  ar & BOOST_SERIALIZATION_NVP(successProbability);
+  ar & BOOST_SERIALIZATION_NVP(maxSamples);
+  ar & BOOST_SERIALIZATION_NVP(checkInterval);
+  ar & BOOST_SERIALIZATION_NVP(minSamples);
+  ar & BOOST_SERIALIZATION_NVP(seed);
+  ar & BOOST_SERIALIZATION_NVP(seenSamples);
+  ar & BOOST_SERIALIZATION_NVP(replacements);
+  ar & BOOST_SERIALIZATION_NVP(trees);
+  ar & BOOST_SERIALIZATION_NVP(backgroundTrees);
+  ar & BOOST_SERIALIZATION_NVP(detectors);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
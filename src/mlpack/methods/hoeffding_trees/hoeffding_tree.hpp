@@ -48,6 +48,14 @@ namespace tree {
  * are handled.  As far as the actual splitting goes, the meat of the splitting
  * procedure will be contained in those two classes.
  *
+ * In streaming mode, the memory used by the split statistics of the leaves can
+ * be bounded with MaxActiveLeaves(), as in the memory management of VFDT.
+ * Every CheckInterval() points, only the leaves with the highest promise (the
+ * number of points they have seen times their estimated error) keep their
+ * split statistics; the others are deactivated, which frees the statistics, and
+ * only track their error until they are promising enough to be reactivated
+ * with fresh statistics.  Inactive leaves cannot split.
+ *
  * @tparam FitnessFunction Fitness function to use.
  * @tparam NumericSplitType Technique for splitting numeric features.
  * @tparam CategoricalSplitType Technique for splitting categorical features.
@@ -156,7 +164,10 @@ class HoeffdingTree
 
   /**
    * Train on a set of points, either in streaming mode or in batch mode, with
-   * the given labels.
+   * the given labels.  In streaming mode the points are taken in mini-batches
+   * of CheckInterval() points that are routed to the leaves together, and the
+   * statistics of each leaf are updated in parallel across dimensions; this
+   * gives the same tree as training on each point in turn.
    *
    * @param data Data points to train on.
    * @param label Labels of data points.
@@ -186,6 +197,19 @@ class HoeffdingTree
   template<typename VecType>
   void Train(const VecType& point, const size_t label);
 
+  /**
+   * Train in streaming mode on batches of points and labels read one at a
+   * time from the given loader (such as data::CSVBatchReader), so that the
+   * training set never has to be in memory at once.  The loader is called as
+   * loader(data, labels) and returns false when there are no more batches.
+   *
+   * @tparam LoaderType Type of the loader, a callable object.
+   * @param loader Loader to read batches from.
+   * @return The number of batches read.
+   */
+  template<typename LoaderType>
+  size_t Update(LoaderType& loader);
+
   /**
    * Check if a split would satisfy the conditions of the Hoeffding bound with
    * the node's specified success probability.  If so, the number of children
@@ -234,6 +258,25 @@ class HoeffdingTree
   //! Modify the number of samples before a split check is performed.
   void CheckInterval(const size_t checkInterval);
 
+  //! Get the maximum number of leaves that keep split statistics during
+  //! streaming training (0 means no limit).
+  size_t MaxActiveLeaves() const { return maxActiveLeaves; }
+  //! Modify the maximum number of leaves that keep split statistics during
+  //! streaming training (0 means no limit).
+  void MaxActiveLeaves(const size_t maxActiveLeaves);
+
+  //! Get whether this leaf keeps split statistics (and so may split).
+  bool Active() const { return active; }
+
+  /**
+   * Deactivate the least promising leaves of this (sub)tree, so that at most
+   * MaxActiveLeaves() leaves keep split statistics, and reactivate the most
+   * promising inactive leaves if there is room.  This is done every
+   * CheckInterval() points during streaming training, and does nothing if
+   * MaxActiveLeaves() is 0.
+   */
+  void EnforceActiveLeafLimit();
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -305,9 +348,35 @@ class HoeffdingTree
 
   //! Serialize the split.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
+  //! Return the promise of this leaf: the number of points it has seen that
+  //! it would misclassify.
+  double Promise() const { return seenSamples * (1.0 - majorityProbability); }
+
+  //! Free the split statistics of this leaf, keeping only one split of each
+  //! type to hold the parameters of the splits.
+  void Deactivate();
+
+  //! Create fresh split statistics for this leaf.
+  void Activate();
+
+  /**
+   * Train in streaming mode on the points of the given dataset with the given
+   * indices, in order.  Each leaf updates its statistics with all of its points
+   * up to its next split check at once, in parallel across dimensions, and
+   * the points that come after a split are routed to the new children.
+   *
+   * @param data Dataset holding the points.
+   * @param labels Labels of all the points of the dataset.
+   * @param indices Indices of the points to train on.
+   */
+  template<typename MatType>
+  void TrainPoints(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const arma::uvec& indices);
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
@@ -336,6 +405,13 @@ class HoeffdingTree
   bool ownsInfo;
   //! The required probability of success for a split to be performed.
   double successProbability;
+  //! The maximum number of leaves with split statistics (0 for no limit).
+  size_t maxActiveLeaves;
+  //! Whether this leaf keeps split statistics.
+  bool active;
+  //! The number of samples seen by this leaf, including while it was inactive
+  //! or before its statistics were last reset.
+  size_t seenSamples;
 
   // And we need to keep some information for after we have split.
 
@@ -357,6 +433,14 @@ class HoeffdingTree
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the HoeffdingTree class.
+BOOST_TEMPLATE_CLASS_VERSION(SINGLE_ARG(template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType>),
+    SINGLE_ARG(mlpack::tree::HoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType>), 1);
+
 #include "hoeffding_tree_impl.hpp"
 
 #endif
@@ -50,7 +50,12 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo(datasetInfo)),
     ownsInfo(true),
     successProbability(successProbability),
+    maxActiveLeaves(0),
+    active(true),
+    seenSamples(0),
     splitDimension(size_t(-1)),
+    majorityClass(0),
+    majorityProbability(0.0),
     categoricalSplit(0),
     numericSplit()
 {
@@ -106,7 +111,12 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo(datasetInfo)),
     ownsInfo(true),
     successProbability(successProbability),
+    maxActiveLeaves(0),
+    active(true),
+    seenSamples(0),
     splitDimension(size_t(-1)),
+    majorityClass(0),
+    majorityProbability(0.0),
     categoricalSplit(0),
     numericSplit()
 {
@@ -168,7 +178,12 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo()),
     ownsInfo(true),
     successProbability(0.95),
+    maxActiveLeaves(0),
+    active(true),
+    seenSamples(0),
     splitDimension(size_t(-1)),
+    majorityClass(0),
+    majorityProbability(0.0),
     categoricalSplit(0),
     numericSplit()
 {
@@ -194,6 +209,9 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     datasetInfo(new data::DatasetInfo(*other.datasetInfo)),
     ownsInfo(true),
     successProbability(other.successProbability),
+    maxActiveLeaves(other.maxActiveLeaves),
+    active(other.active),
+    seenSamples(other.seenSamples),
     splitDimension(other.splitDimension),
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
@@ -239,8 +257,11 @@ void HoeffdingTree<
     // Don't split if there are fewer than five points.
     size_t oldMaxSamples = maxSamples;
     maxSamples = std::max(size_t(data.n_cols - 1), size_t(5));
-    for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    if (data.n_cols > 0)
+    {
+      TrainPoints(data, labels, arma::regspace<arma::uvec>(0,
+          data.n_cols - 1));
+    }
     maxSamples = oldMaxSamples;
 
     // Now, if we did split, find out which points go to which child, and
@@ -291,9 +312,17 @@ void HoeffdingTree<
   }
   else
   {
-    // We aren't training in batch mode; loop through the points.
-    for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    // We aren't training in batch mode; take the points in mini-batches that
+    // end where the limit on the number of active leaves is enforced.
+    for (size_t begin = 0; begin < data.n_cols; begin += checkInterval)
+    {
+      const size_t end = std::min(begin + checkInterval, size_t(data.n_cols));
+      TrainPoints(data, labels, arma::regspace<arma::uvec>(begin, end - 1));
+
+      // Keep the number of leaves with split statistics within the limit.
+      if (maxActiveLeaves > 0 && end % checkInterval == 0)
+        EnforceActiveLeafLimit();
+    }
   }
 }
 
@@ -366,6 +395,17 @@ void HoeffdingTree<
 {
   if (splitDimension == size_t(-1))
   {
+    ++seenSamples;
+    if (!active)
+    {
+      // An inactive leaf has no split statistics, so it only keeps its
+      // estimate of the probability of its majority class up to date.
+      const double correct = majorityProbability * (seenSamples - 1) +
+          ((label == majorityClass) ? 1.0 : 0.0);
+      majorityProbability = correct / seenSamples;
+      return;
+    }
+
     ++numSamples;
     size_t numericIndex = 0;
     size_t categoricalIndex = 0;
@@ -410,6 +450,150 @@ void HoeffdingTree<
   }
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainPoints(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const arma::uvec& indices)
+{
+  size_t begin = 0;
+  while (splitDimension == size_t(-1) && begin < indices.n_elem)
+  {
+    if (!active)
+    {
+      // An inactive leaf only keeps its estimate of the probability of its
+      // majority class up to date, as in Train().
+      for (size_t i = begin; i < indices.n_elem; ++i)
+      {
+        ++seenSamples;
+        const double correct = majorityProbability * (seenSamples - 1) +
+            ((labels[indices[i]] == majorityClass) ? 1.0 : 0.0);
+        majorityProbability = correct / seenSamples;
+      }
+      return;
+    }
+
+    // Take all of the points up to the next split check.
+    const size_t end = std::min(size_t(indices.n_elem),
+        begin + checkInterval - numSamples % checkInterval);
+
+    // The statistics of each dimension are independent, so they can be
+    // updated in parallel; each one still sees the points in order.
+    #pragma omp parallel for if ((end - begin) * data.n_rows >= 1000)
+    for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+    {
+      const std::pair<size_t, size_t>& mapping = dimensionMappings->at(d);
+      if (mapping.first == data::Datatype::categorical)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          categoricalSplits[mapping.second].Train(data(d, indices[i]),
+              labels[indices[i]]);
+        }
+      }
+      else if (mapping.first == data::Datatype::numeric)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          numericSplits[mapping.second].Train(data(d, indices[i]),
+              labels[indices[i]]);
+        }
+      }
+    }
+
+    numSamples += end - begin;
+    seenSamples += end - begin;
+    begin = end;
+
+    // Grab majority class from splits.
+    if (categoricalSplits.size() > 0)
+    {
+      majorityClass = categoricalSplits[0].MajorityClass();
+      majorityProbability = categoricalSplits[0].MajorityProbability();
+    }
+    else
+    {
+      majorityClass = numericSplits[0].MajorityClass();
+      majorityProbability = numericSplits[0].MajorityProbability();
+    }
+
+    // Check for a split, if we should.
+    if (numSamples % checkInterval == 0)
+    {
+      const size_t numChildren = SplitCheck();
+      if (numChildren > 0)
+      {
+        // We need to add a bunch of children.
+        // Delete children, if we have them.
+        children.clear();
+        CreateChildren();
+      }
+    }
+  }
+
+  if (begin == indices.n_elem)
+    return;
+
+  // Route the remaining points to the children, keeping them in order.
+  std::vector<arma::uvec> childIndices(children.size(),
+      arma::uvec(indices.n_elem - begin));
+  arma::Col<size_t> counts = arma::zeros<arma::Col<size_t>>(children.size());
+  for (size_t i = begin; i < indices.n_elem; ++i)
+  {
+    const size_t direction = CalculateDirection(data.col(indices[i]));
+    childIndices[direction][counts[direction]++] = indices[i];
+  }
+
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    if (counts[i] > 0)
+    {
+      children[i]->TrainPoints(data, labels,
+          childIndices[i].subvec(0, counts[i] - 1));
+    }
+  }
+}
+
+//! Train on batches of points from a loader.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename LoaderType>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Update(LoaderType& loader)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  size_t batches = 0;
+  while (loader(data, labels))
+  {
+    if (data.n_rows != datasetInfo->Dimensionality())
+    {
+      std::ostringstream oss;
+      oss << "HoeffdingTree::Update(): batch has dimensionality "
+          << data.n_rows << ", but the tree has dimensionality "
+          << datasetInfo->Dimensionality() << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    Train(data, labels, false);
+    ++batches;
+  }
+
+  return batches;
+}
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType>
@@ -419,8 +603,8 @@ size_t HoeffdingTree<
     CategoricalSplitType
 >::SplitCheck()
 {
-  // Do nothing if we've already split.
-  if (splitDimension != size_t(-1))
+  // Do nothing if we've already split, or if we have no split statistics.
+  if (splitDimension != size_t(-1) || !active)
     return 0;
 
   // If not enough points have been seen, we cannot split.
@@ -563,6 +747,133 @@ void HoeffdingTree<
     children[i]->CheckInterval(checkInterval);
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MaxActiveLeaves(const size_t maxActiveLeaves)
+{
+  this->maxActiveLeaves = maxActiveLeaves;
+  for (size_t i = 0; i < children.size(); ++i)
+    children[i]->MaxActiveLeaves(maxActiveLeaves);
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::EnforceActiveLeafLimit()
+{
+  if (maxActiveLeaves == 0)
+    return;
+
+  // Collect all of the leaves.
+  std::vector<HoeffdingTree*> leaves;
+  std::stack<HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    HoeffdingTree* node = stack.top();
+    stack.pop();
+    if (node->children.size() == 0)
+      leaves.push_back(node);
+    for (size_t i = 0; i < node->children.size(); ++i)
+      stack.push(node->children[i]);
+  }
+
+  // Only the most promising leaves keep their split statistics.
+  std::stable_sort(leaves.begin(), leaves.end(),
+      [](const HoeffdingTree* a, const HoeffdingTree* b)
+      {
+        return a->Promise() > b->Promise();
+      });
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    if (i < maxActiveLeaves && !leaves[i]->active)
+      leaves[i]->Activate();
+    else if (i >= maxActiveLeaves && leaves[i]->active)
+      leaves[i]->Deactivate();
+  }
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Deactivate()
+{
+  // Replace the splits by a single split of each type without statistics.
+  std::vector<NumericSplitType<FitnessFunction>> newNumericSplits;
+  if (numericSplits.size() > 0)
+  {
+    newNumericSplits.push_back(NumericSplitType<FitnessFunction>(numClasses,
+        numericSplits[0]));
+  }
+
+  std::vector<CategoricalSplitType<FitnessFunction>> newCategoricalSplits;
+  if (categoricalSplits.size() > 0)
+  {
+    newCategoricalSplits.push_back(CategoricalSplitType<FitnessFunction>(0,
+        numClasses, categoricalSplits[0]));
+  }
+
+  // Swapping frees the memory of the old splits.
+  numericSplits.swap(newNumericSplits);
+  categoricalSplits.swap(newCategoricalSplits);
+  active = false;
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Activate()
+{
+  // Create fresh splits with the parameters of the splits we kept.
+  std::vector<NumericSplitType<FitnessFunction>> newNumericSplits;
+  std::vector<CategoricalSplitType<FitnessFunction>> newCategoricalSplits;
+  for (size_t i = 0; i < datasetInfo->Dimensionality(); ++i)
+  {
+    if (datasetInfo->Type(i) == data::Datatype::categorical)
+    {
+      newCategoricalSplits.push_back(CategoricalSplitType<FitnessFunction>(
+          datasetInfo->NumMappings(i), numClasses, categoricalSplits[0]));
+    }
+    else
+    {
+      newNumericSplits.push_back(NumericSplitType<FitnessFunction>(numClasses,
+          numericSplits[0]));
+    }
+  }
+
+  numericSplits.swap(newNumericSplits);
+  categoricalSplits.swap(newCategoricalSplits);
+
+  // The Hoeffding bound only counts the samples the new statistics have seen.
+  numSamples = 0;
+  active = true;
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -757,6 +1068,7 @@ void HoeffdingTree<
     }
 
     children[i]->MajorityClass() = childMajorities[i];
+    children[i]->maxActiveLeaves = maxActiveLeaves;
   }
 
   // Eliminate now-unnecessary split information.
@@ -774,10 +1086,16 @@ void HoeffdingTree<
     FitnessFunction,
     NumericSplitType,
     CategoricalSplitType
->::serialize(Archive& ar, const unsigned int /* version */)
+>::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(splitDimension);
 
+  // The limit on the number of active leaves was added in version 1.
+  if (version >= 1)
+    ar & BOOST_SERIALIZATION_NVP(maxActiveLeaves);
+  else if (Archive::is_loading::value)
+    maxActiveLeaves = 0;
+
   // Clear memory for the mappings if necessary.
   if (Archive::is_loading::value && ownsMappings && dimensionMappings)
     delete dimensionMappings;
@@ -817,6 +1135,19 @@ void HoeffdingTree<
     ar & BOOST_SERIALIZATION_NVP(maxSamples);
     ar & BOOST_SERIALIZATION_NVP(successProbability);
 
+    // Leaf deactivation was added in version 1.  An inactive leaf only holds
+    // one split of each type, which is serialized below.
+    if (version >= 1)
+    {
+      ar & BOOST_SERIALIZATION_NVP(active);
+      ar & BOOST_SERIALIZATION_NVP(seenSamples);
+    }
+    else if (Archive::is_loading::value)
+    {
+      active = true;
+      seenSamples = numSamples;
+    }
+
     // Serialize the splits, but not if we haven't seen any samples yet (in
     // which case we can just reinitialize).
     if (Archive::is_loading::value)
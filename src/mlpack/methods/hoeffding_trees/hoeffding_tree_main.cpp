@@ -109,6 +109,9 @@ PARAM_INT_IN("bins", "If the 'domingos' split strategy is used, this specifies "
 PARAM_INT_IN("observations_before_binning", "If the 'domingos' split strategy "
     "is used, this specifies the number of samples observed before binning is "
     "performed.", "o", 100);
+PARAM_INT_IN("max_active_leaves", "If training in streaming mode, the maximum "
+    "number of leaves that keep split statistics; the least promising leaves "
+    "are deactivated to bound memory usage (0 means no limit).", "a", 0);
 
 // Convenience typedef.
 typedef tuple<DatasetInfo, arma::mat> TupleType;
@@ -129,6 +132,7 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "training", false }}, "batch_mode");
   ReportIgnoredParam({{ "training", false }}, "passes");
+  ReportIgnoredParam({{ "training", false }}, "max_active_leaves");
 
   if (CLI::HasParam("test"))
   {
@@ -139,6 +143,9 @@ static void mlpackMain()
   RequireParamInSet<string>("numeric_split_strategy", { "domingos", "binary" },
       true, "unrecognized numeric split strategy");
 
+  RequireParamValue<int>("max_active_leaves", [](int x) { return x >= 0; },
+      true, "max_active_leaves must be non-negative");
+
   // Do we need to load a model or do we already have one?
   HoeffdingTreeModel* model;
   DatasetInfo datasetInfo;
@@ -172,6 +179,8 @@ static void mlpackMain()
     const size_t bins = (size_t) CLI::GetParam<int>("bins");
     const size_t observationsBeforeBinning = (size_t)
         CLI::GetParam<int>("observations_before_binning");
+    const size_t maxActiveLeaves = (size_t)
+        CLI::GetParam<int>("max_active_leaves");
     size_t passes = (size_t) CLI::GetParam<int>("passes");
     if (passes > 1)
       batchTraining = false; // We already warned about this earlier.
@@ -209,9 +218,13 @@ static void mlpackMain()
       // Build the model.
       model->BuildModel(trainingSet, datasetInfo, labels,
           arma::max(labels) + 1, batchTraining, confidence, maxSamples,
-          100, minSamples, bins, observationsBeforeBinning);
+          100, minSamples, bins, observationsBeforeBinning, maxActiveLeaves);
       --passes; // This model-building takes one pass.
     }
+    else if (CLI::HasParam("max_active_leaves"))
+    {
+      model->MaxActiveLeaves(maxActiveLeaves);
+    }
 
     // Now pass over the trees as many times as we need to.
     if (batchTraining)
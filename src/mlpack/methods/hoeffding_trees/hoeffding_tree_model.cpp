@@ -128,9 +128,11 @@ void HoeffdingTreeModel::BuildModel(
     const size_t checkInterval,
     const size_t minSamples,
     const size_t bins,
-    const size_t observationsBeforeBinning)
+    const size_t observationsBeforeBinning,
+    const size_t maxActiveLeaves)
 {
-  // Depending on the type, create the tree.
+  // Depending on the type, create the tree.  The limit on the number of active
+  // leaves has to be set before training, so the tree is trained afterwards.
   switch (type)
   {
     case GINI_HOEFFDING:
@@ -139,17 +141,15 @@ void HoeffdingTreeModel::BuildModel(
         HoeffdingDoubleNumericSplit<GiniImpurity> ns(0, bins,
             observationsBeforeBinning);
 
-        giniHoeffdingTree = new GiniHoeffdingTreeType(dataset, datasetInfo,
-            labels, numClasses, batchTraining, successProbability, maxSamples,
-            checkInterval, minSamples,
+        giniHoeffdingTree = new GiniHoeffdingTreeType(datasetInfo, numClasses,
+            successProbability, maxSamples, checkInterval, minSamples,
             HoeffdingCategoricalSplit<GiniImpurity>(0, 0), ns);
       }
       break;
 
     case GINI_BINARY:
-      giniBinaryTree = new GiniBinaryTreeType(dataset, datasetInfo, labels,
-          numClasses, batchTraining, successProbability, maxSamples,
-          checkInterval, minSamples);
+      giniBinaryTree = new GiniBinaryTreeType(datasetInfo, numClasses,
+          successProbability, maxSamples, checkInterval, minSamples);
       break;
 
     case INFO_HOEFFDING:
@@ -158,17 +158,41 @@ void HoeffdingTreeModel::BuildModel(
         HoeffdingDoubleNumericSplit<InformationGain> ns(0, bins,
             observationsBeforeBinning);
 
-        infoHoeffdingTree = new InfoHoeffdingTreeType(dataset, datasetInfo,
-            labels, numClasses, batchTraining, successProbability, maxSamples,
-            checkInterval, minSamples,
+        infoHoeffdingTree = new InfoHoeffdingTreeType(datasetInfo, numClasses,
+            successProbability, maxSamples, checkInterval, minSamples,
             HoeffdingCategoricalSplit<InformationGain>(0, 0), ns);
       }
       break;
 
     case INFO_BINARY:
-      infoBinaryTree = new InfoBinaryTreeType(dataset, datasetInfo, labels,
-          numClasses, batchTraining, successProbability, maxSamples,
-          checkInterval, minSamples);
+      infoBinaryTree = new InfoBinaryTreeType(datasetInfo, numClasses,
+          successProbability, maxSamples, checkInterval, minSamples);
+      break;
+  }
+
+  MaxActiveLeaves(maxActiveLeaves);
+  Train(dataset, labels, batchTraining);
+}
+
+// Set the limit on the number of active leaves.
+void HoeffdingTreeModel::MaxActiveLeaves(const size_t maxActiveLeaves)
+{
+  switch (type)
+  {
+    case GINI_HOEFFDING:
+      giniHoeffdingTree->MaxActiveLeaves(maxActiveLeaves);
+      break;
+
+    case GINI_BINARY:
+      giniBinaryTree->MaxActiveLeaves(maxActiveLeaves);
+      break;
+
+    case INFO_HOEFFDING:
+      infoHoeffdingTree->MaxActiveLeaves(maxActiveLeaves);
+      break;
+
+    case INFO_BINARY:
+      infoBinaryTree->MaxActiveLeaves(maxActiveLeaves);
       break;
   }
 }
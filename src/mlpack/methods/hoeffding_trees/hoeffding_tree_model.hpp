@@ -105,6 +105,8 @@ class HoeffdingTreeModel
    * @param bins Number of bins, for Hoeffding numeric split.
    * @param observationsBeforeBinning Number of observations before binning, for
    *      Hoeffding numeric split.
+   * @param maxActiveLeaves Maximum number of leaves that keep split statistics
+   *      in streaming mode (0 means no limit).
    */
   void BuildModel(const arma::mat& dataset,
                   const data::DatasetInfo& datasetInfo,
@@ -116,7 +118,17 @@ class HoeffdingTreeModel
                   const size_t checkInterval,
                   const size_t minSamples,
                   const size_t bins,
-                  const size_t observationsBeforeBinning);
+                  const size_t observationsBeforeBinning,
+                  const size_t maxActiveLeaves = 0);
+
+  /**
+   * Set the maximum number of leaves that keep split statistics when training
+   * in streaming mode (0 means no limit).  Be sure that BuildModel() has been
+   * called first!
+   *
+   * @param maxActiveLeaves Maximum number of active leaves.
+   */
+  void MaxActiveLeaves(const size_t maxActiveLeaves);
 
   /**
    * Train in streaming mode on the given dataset.  This takes one pass.  Be
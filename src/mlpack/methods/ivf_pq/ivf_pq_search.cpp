@@ -0,0 +1,394 @@
+/**
+ * @file ivf_pq_search.cpp
+ *
+ * Implementation of the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "ivf_pq_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+#include <queue>
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+IVFPQSearch::IVFPQSearch(const arma::mat& referenceSet,
+                         const size_t numLists,
+                         const size_t numSubspaces,
+                         const size_t numCentroids,
+                         const bool storeReferenceSet,
+                         const size_t trainingSamples,
+                         const size_t maxIterations) :
+    numLists(numLists),
+    numSubspaces(numSubspaces),
+    numCentroids(numCentroids),
+    storeReferenceSet(storeReferenceSet),
+    trainingSamples(trainingSamples),
+    maxIterations(maxIterations)
+{
+  Train(referenceSet);
+}
+
+IVFPQSearch::IVFPQSearch(const size_t numLists,
+                         const size_t numSubspaces,
+                         const size_t numCentroids,
+                         const bool storeReferenceSet,
+                         const size_t trainingSamples,
+                         const size_t maxIterations) :
+    numLists(numLists),
+    numSubspaces(numSubspaces),
+    numCentroids(numCentroids),
+    storeReferenceSet(storeReferenceSet),
+    trainingSamples(trainingSamples),
+    maxIterations(maxIterations),
+    listOffsets(arma::zeros<arma::Col<size_t>>(numLists + 1))
+{
+  // Nothing to do; the index is empty.
+}
+
+void IVFPQSearch::Train(const arma::mat& data)
+{
+  if (numLists == 0 || numSubspaces == 0)
+  {
+    throw std::invalid_argument("IVFPQSearch::Train(): the number of lists "
+        "and the number of subspaces must be positive");
+  }
+  if (numCentroids == 0 || numCentroids > 256)
+  {
+    throw std::invalid_argument("IVFPQSearch::Train(): the number of "
+        "centroids of each subspace must be between 1 and 256");
+  }
+  if (data.n_rows % numSubspaces != 0)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): the dimensionality of the data ("
+        << data.n_rows << ") is not a multiple of the number of subspaces ("
+        << numSubspaces << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Train the quantizers on a uniform sample, if requested.
+  arma::mat sampled;
+  if (trainingSamples > 0 && trainingSamples < data.n_cols)
+  {
+    arma::uvec indices(trainingSamples);
+    for (size_t i = 0; i < trainingSamples; ++i)
+    {
+      indices[i] = std::min((size_t) (math::Random() * data.n_cols),
+          (size_t) data.n_cols - 1);
+    }
+    sampled = data.cols(arma::sort(indices));
+  }
+  const arma::mat& sample = (sampled.n_cols > 0) ? sampled : data;
+
+  if (sample.n_cols < numLists || sample.n_cols < numCentroids)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): " << sample.n_cols << " training points "
+        << "are not enough for " << numLists << " lists and " << numCentroids
+        << " centroids per subspace!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  kmeans::KMeans<> kmeans(maxIterations);
+  kmeans.Cluster(sample, numLists, coarseCentroids);
+
+  // The product quantizer is trained on the residuals from the lists.
+  arma::mat residuals(sample.n_rows, sample.n_cols);
+  #pragma omp parallel
+  {
+    arma::rowvec listDistances;
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) sample.n_cols; ++i)
+    {
+      const arma::vec point = sample.col(i);
+      residuals.col(i) = point - coarseCentroids.col(NearestList(point,
+          listDistances));
+    }
+  }
+
+  const size_t subDimension = data.n_rows / numSubspaces;
+  codebooks.set_size(subDimension, numCentroids, numSubspaces);
+  for (size_t j = 0; j < numSubspaces; ++j)
+  {
+    arma::mat centroids;
+    kmeans.Cluster(arma::mat(residuals.rows(j * subDimension,
+        (j + 1) * subDimension - 1)), numCentroids, centroids);
+    codebooks.slice(j) = centroids;
+  }
+  ComputeCodebookNorms();
+
+  // Encode the reference set into an empty index.
+  listOffsets.zeros(numLists + 1);
+  listIndices.reset();
+  codes.set_size(numSubspaces, 0);
+  referenceSet.set_size(data.n_rows, 0);
+  Add(data);
+}
+
+void IVFPQSearch::Add(const arma::mat& points)
+{
+  if (codebooks.n_elem == 0)
+  {
+    throw std::invalid_argument("IVFPQSearch::Add(): the quantizers have not "
+        "been trained!");
+  }
+  if (points.n_rows != Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Add(): dimensionality of the points ("
+        << points.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << Dimensionality() << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Encode the new points.
+  arma::Col<size_t> lists(points.n_cols);
+  arma::Mat<unsigned char> newCodes(numSubspaces, points.n_cols);
+  #pragma omp parallel
+  {
+    arma::rowvec listDistances;
+    arma::mat table;
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) points.n_cols; ++i)
+    {
+      const arma::vec point = points.col(i);
+      lists[i] = NearestList(point, listDistances);
+      ComputeTable(point - coarseCentroids.col(lists[i]), table);
+      for (size_t j = 0; j < numSubspaces; ++j)
+      {
+        arma::uword centroid;
+        table.col(j).min(centroid);
+        newCodes(j, i) = (unsigned char) centroid;
+      }
+    }
+  }
+
+  // Merge them into the lists, after the points already there.
+  const size_t oldPoints = NumPoints();
+  arma::Col<size_t> newOffsets(numLists + 1);
+  arma::Col<size_t> counts = listOffsets.subvec(1, numLists) -
+      listOffsets.subvec(0, numLists - 1);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    ++counts[lists[i]];
+  newOffsets[0] = 0;
+  for (size_t l = 0; l < numLists; ++l)
+    newOffsets[l + 1] = newOffsets[l] + counts[l];
+
+  arma::Col<size_t> mergedIndices(oldPoints + points.n_cols);
+  arma::Mat<unsigned char> mergedCodes(numSubspaces, oldPoints + points.n_cols);
+  arma::Col<size_t> positions(numLists);
+  for (size_t l = 0; l < numLists; ++l)
+  {
+    const size_t oldSize = listOffsets[l + 1] - listOffsets[l];
+    if (oldSize > 0)
+    {
+      mergedIndices.subvec(newOffsets[l], newOffsets[l] + oldSize - 1) =
+          listIndices.subvec(listOffsets[l], listOffsets[l + 1] - 1);
+      mergedCodes.cols(newOffsets[l], newOffsets[l] + oldSize - 1) =
+          codes.cols(listOffsets[l], listOffsets[l + 1] - 1);
+    }
+    positions[l] = newOffsets[l] + oldSize;
+  }
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const size_t position = positions[lists[i]]++;
+    mergedIndices[position] = oldPoints + i;
+    mergedCodes.col(position) = newCodes.col(i);
+  }
+
+  listOffsets = std::move(newOffsets);
+  listIndices = std::move(mergedIndices);
+  codes = std::move(mergedCodes);
+
+  if (storeReferenceSet)
+    referenceSet = arma::join_rows(referenceSet, points);
+}
+
+void IVFPQSearch::Search(const arma::mat& querySet,
+                         const size_t k,
+                         arma::Mat<size_t>& neighbors,
+                         arma::mat& distances,
+                         const size_t nProbe,
+                         const size_t rerank) const
+{
+  if (k > NumPoints())
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but the index has " << NumPoints() << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (querySet.n_rows != Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << Dimensionality() << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (nProbe == 0)
+  {
+    throw std::invalid_argument("IVFPQSearch::Search(): at least one list "
+        "must be probed");
+  }
+  if (rerank > 0 && !storeReferenceSet)
+  {
+    throw std::invalid_argument("IVFPQSearch::Search(): re-ranking needs the "
+        "reference set, which is not stored");
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  typedef std::pair<double, size_t> Candidate;
+  const size_t probes = std::min(nProbe, numLists);
+  const size_t numCandidates = std::max(k, rerank);
+
+  #pragma omp parallel
+  {
+    arma::rowvec listDistances;
+    arma::mat table;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      const arma::vec query = querySet.col(i);
+      listDistances = arma::sum(arma::square(coarseCentroids.each_col() -
+          query), 0);
+      const arma::uvec order = arma::sort_index(listDistances);
+
+      // Keep the best candidates in a max-heap.
+      std::priority_queue<Candidate> best;
+      for (size_t p = 0; p < probes; ++p)
+      {
+        const size_t list = order[p];
+        if (listOffsets[list] == listOffsets[list + 1])
+          continue;
+
+        // The approximate distance of each point is a sum of one table entry
+        // per subspace.
+        ComputeTable(query - coarseCentroids.col(list), table);
+        const double* tableMem = table.memptr();
+        for (size_t q = listOffsets[list]; q < listOffsets[list + 1]; ++q)
+        {
+          const unsigned char* code = codes.colptr(q);
+          double distance = 0.0;
+          for (size_t j = 0; j < numSubspaces; ++j)
+            distance += tableMem[j * numCentroids + code[j]];
+
+          if (best.size() < numCandidates)
+          {
+            best.push(Candidate(distance, listIndices[q]));
+          }
+          else if (distance < best.top().first)
+          {
+            best.pop();
+            best.push(Candidate(distance, listIndices[q]));
+          }
+        }
+      }
+
+      std::vector<Candidate> results(best.size());
+      for (size_t r = results.size(); r > 0; --r)
+      {
+        results[r - 1] = best.top();
+        best.pop();
+      }
+
+      if (rerank > 0)
+      {
+        for (size_t r = 0; r < results.size(); ++r)
+        {
+          results[r].first = metric::EuclideanDistance::Evaluate(query,
+              referenceSet.col(results[r].second));
+        }
+        std::sort(results.begin(), results.end());
+      }
+      else
+      {
+        // The table entries may be slightly negative through rounding.
+        for (size_t r = 0; r < results.size(); ++r)
+          results[r].first = std::sqrt(std::max(results[r].first, 0.0));
+      }
+
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, i) = (j < results.size()) ? results[j].second :
+            NumPoints();
+        distances(j, i) = (j < results.size()) ? results[j].first : DBL_MAX;
+      }
+    }
+  }
+}
+
+void IVFPQSearch::Reconstruct(const size_t point,
+                              arma::vec& reconstruction) const
+{
+  if (point >= NumPoints())
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Reconstruct(): point " << point << " is not in the "
+        << "index (" << NumPoints() << " points)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t position = arma::as_scalar(arma::find(listIndices == point, 1));
+  const size_t list = (std::upper_bound(listOffsets.begin(), listOffsets.end(),
+      position) - listOffsets.begin()) - 1;
+
+  const size_t subDimension = codebooks.n_rows;
+  reconstruction = coarseCentroids.col(list);
+  for (size_t j = 0; j < numSubspaces; ++j)
+  {
+    reconstruction.subvec(j * subDimension, (j + 1) * subDimension - 1) +=
+        codebooks.slice(j).col(codes(j, position));
+  }
+}
+
+void IVFPQSearch::ComputeTable(const arma::vec& residual,
+                               arma::mat& table) const
+{
+  // ||r - c||^2 = ||c||^2 - 2 c^T r + ||r||^2, with one matrix-vector product
+  // per subspace.
+  const size_t subDimension = codebooks.n_rows;
+  table.set_size(numCentroids, numSubspaces);
+  for (size_t j = 0; j < numSubspaces; ++j)
+  {
+    const arma::vec subvector = residual.subvec(j * subDimension,
+        (j + 1) * subDimension - 1);
+    table.col(j) = codebookNorms.col(j) - 2.0 * codebooks.slice(j).t() *
+        subvector + arma::dot(subvector, subvector);
+  }
+}
+
+size_t IVFPQSearch::NearestList(const arma::vec& point,
+                                arma::rowvec& distances) const
+{
+  distances = arma::sum(arma::square(coarseCentroids.each_col() - point), 0);
+  arma::uword list;
+  distances.min(list);
+  return list;
+}
+
+void IVFPQSearch::ComputeCodebookNorms()
+{
+  codebookNorms.set_size(codebooks.n_cols, codebooks.n_slices);
+  for (size_t j = 0; j < codebooks.n_slices; ++j)
+  {
+    codebookNorms.col(j) = arma::trans(arma::sum(arma::square(
+        codebooks.slice(j)), 0));
+  }
+}
@@ -0,0 +1,250 @@
+/**
+ * @file ivf_pq_search.hpp
+ *
+ * Defines the IVFPQSearch class, which performs approximate nearest neighbor
+ * search on a compressed representation of the reference set: an inverted file
+ * over a coarse quantizer, with product-quantized residuals.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @article{jegou2011product,
+ *  title={Product quantization for nearest neighbor search},
+ *  author={J{\'e}gou, H. and Douze, M. and Schmid, C.},
+ *  journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *  volume={33},
+ *  number={1},
+ *  pages={117--128},
+ *  year={2011}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The IVFPQSearch class stores the reference set as an inverted file with
+ * product-quantized residuals (IVF-PQ), and computes approximate Euclidean
+ * nearest neighbors of queries from it.
+ *
+ * A coarse quantizer, trained with KMeans, splits the reference points into
+ * lists.  The residual of each point from its list centroid is split into
+ * subspaces of equal dimension, and each subspace is quantized with its own
+ * codebook of at most 256 centroids (also trained with KMeans), so each point
+ * takes one byte per subspace.  A query scans the lists of its nProbe closest
+ * list centroids: for each list, a table of the squared distances between the
+ * query residual and every codebook centroid is computed with one matrix-vector
+ * product per subspace, and the approximate distance of each point of the list
+ * is then the sum of one table entry per subspace.
+ *
+ * The quantizers may be trained on a sample of the reference set, and more
+ * points can be encoded later with Add(), so that the reference set never needs
+ * to fit in memory at once.  Optionally, the reference set is also stored, and
+ * the best candidates of each query are then re-ranked with their exact
+ * distances.
+ *
+ * The results have the same format as those of NeighborSearch: the neighbors
+ * of query i, sorted by distance, are in column i of the neighbors matrix,
+ * with their distances in column i of the distances matrix.
+ */
+class IVFPQSearch
+{
+ public:
+  /**
+   * Train the quantizers on the given reference set and encode it.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists The number of lists of the coarse quantizer.
+   * @param numSubspaces The number of subspaces of the product quantizer; it
+   *     must divide the dimensionality of the data.
+   * @param numCentroids The number of centroids of each subspace (at most 256).
+   * @param storeReferenceSet Whether to store the reference set too, for exact
+   *     re-ranking.
+   * @param trainingSamples The number of points the quantizers are trained on
+   *     (sampled uniformly); if 0, all the points are used.
+   * @param maxIterations Maximum number of iterations of KMeans.
+   */
+  IVFPQSearch(const arma::mat& referenceSet,
+              const size_t numLists = 256,
+              const size_t numSubspaces = 8,
+              const size_t numCentroids = 256,
+              const bool storeReferenceSet = false,
+              const size_t trainingSamples = 0,
+              const size_t maxIterations = 100);
+
+  /**
+   * Create an empty object; Train() must be called before Search().  See the
+   * other constructor for the parameters.
+   */
+  IVFPQSearch(const size_t numLists = 256,
+              const size_t numSubspaces = 8,
+              const size_t numCentroids = 256,
+              const bool storeReferenceSet = false,
+              const size_t trainingSamples = 0,
+              const size_t maxIterations = 100);
+
+  /**
+   * Train the quantizers on (a sample of) the given reference set, and encode
+   * it, replacing any previous index.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const arma::mat& referenceSet);
+
+  /**
+   * Encode the given points and add them to the index, with the trained
+   * quantizers.  They get the indices following those of the points already in
+   * the index.
+   *
+   * @param points The points to add.
+   */
+  void Add(const arma::mat& points);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the query set,
+   * and store the output in the given matrices.  The matrices will be set to
+   * the size of k by querySet.n_cols.  If fewer than k points are in the lists
+   * scanned for a query, the remaining neighbors are set to NumPoints() and
+   * their distances to DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param nProbe The number of lists to scan for each query.
+   * @param rerank If nonzero, the number of best candidates (at least k) whose
+   *     exact distances are computed to find the neighbors; this needs the
+   *     stored reference set.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t nProbe = 8,
+              const size_t rerank = 0) const;
+
+  /**
+   * Reconstruct the given point from its code.
+   *
+   * @param point Index of the point.
+   * @param reconstruction The approximation of the point.
+   */
+  void Reconstruct(const size_t point, arma::vec& reconstruction) const;
+
+  //! Get the number of lists of the coarse quantizer.
+  size_t NumLists() const { return numLists; }
+  //! Get the number of subspaces of the product quantizer.
+  size_t NumSubspaces() const { return numSubspaces; }
+  //! Get the number of centroids of each subspace.
+  size_t NumCentroids() const { return numCentroids; }
+  //! Get whether the reference set is stored.
+  bool StoreReferenceSet() const { return storeReferenceSet; }
+
+  //! Get the number of points in the index.
+  size_t NumPoints() const { return listIndices.n_elem; }
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return coarseCentroids.n_rows; }
+
+  //! Get the centroids of the coarse quantizer (one column per list).
+  const arma::mat& CoarseCentroids() const { return coarseCentroids; }
+  //! Get the codebooks; slice j holds the centroids of subspace j.
+  const arma::cube& Codebooks() const { return codebooks; }
+  //! Get the position in ListIndices() of the first point of each list (and
+  //! the number of points, last).
+  const arma::Col<size_t>& ListOffsets() const { return listOffsets; }
+  //! Get the indices of the points, grouped by list.
+  const arma::Col<size_t>& ListIndices() const { return listIndices; }
+  //! Get the codes of the points, one column per point of ListIndices().
+  const arma::Mat<unsigned char>& Codes() const { return codes; }
+  //! Get the stored reference set (empty unless StoreReferenceSet()).
+  const arma::mat& ReferenceSet() const { return referenceSet; }
+
+  /**
+   * Serialize the object.
+   *
+   * @param ar Archive to serialize to.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numLists);
+    ar & BOOST_SERIALIZATION_NVP(numSubspaces);
+    ar & BOOST_SERIALIZATION_NVP(numCentroids);
+    ar & BOOST_SERIALIZATION_NVP(storeReferenceSet);
+    ar & BOOST_SERIALIZATION_NVP(trainingSamples);
+    ar & BOOST_SERIALIZATION_NVP(maxIterations);
+    ar & BOOST_SERIALIZATION_NVP(coarseCentroids);
+    ar & BOOST_SERIALIZATION_NVP(codebooks);
+    ar & BOOST_SERIALIZATION_NVP(listOffsets);
+    ar & BOOST_SERIALIZATION_NVP(listIndices);
+    ar & BOOST_SERIALIZATION_NVP(codes);
+    ar & BOOST_SERIALIZATION_NVP(referenceSet);
+
+    // The squared norms of the codebook centroids are not saved.
+    if (Archive::is_loading::value)
+      ComputeCodebookNorms();
+  }
+
+ private:
+  /**
+   * Compute the table of the squared distances between each subvector of the
+   * given residual and the centroids of its subspace.
+   *
+   * @param residual The residual of a point from a list centroid.
+   * @param table The squared distances; column j is for subspace j.
+   */
+  void ComputeTable(const arma::vec& residual, arma::mat& table) const;
+
+  /**
+   * Find the list of the given point.
+   *
+   * @param point The point.
+   * @param distances Buffer for the distances to the list centroids.
+   */
+  size_t NearestList(const arma::vec& point, arma::rowvec& distances) const;
+
+  //! Compute the squared norms of the codebook centroids.
+  void ComputeCodebookNorms();
+
+  //! The number of lists of the coarse quantizer.
+  size_t numLists;
+  //! The number of subspaces of the product quantizer.
+  size_t numSubspaces;
+  //! The number of centroids of each subspace.
+  size_t numCentroids;
+  //! Whether the reference set is stored.
+  bool storeReferenceSet;
+  //! The number of points the quantizers are trained on (0 for all).
+  size_t trainingSamples;
+  //! The maximum number of iterations of KMeans.
+  size_t maxIterations;
+
+  //! The centroids of the coarse quantizer.
+  arma::mat coarseCentroids;
+  //! The centroids of each subspace.
+  arma::cube codebooks;
+  //! The squared norms of the centroids of each subspace.
+  arma::mat codebookNorms;
+  //! The position of the first point of each list.
+  arma::Col<size_t> listOffsets;
+  //! The indices of the points, grouped by list.
+  arma::Col<size_t> listIndices;
+  //! The codes of the points, in the order of listIndices.
+  arma::Mat<unsigned char> codes;
+  //! The stored reference set, if storeReferenceSet is true.
+  arma::mat referenceSet;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,334 @@
+/**
+ * @file kde.hpp
+ *
+ * Defines the KDE class, which performs kernel density estimation with trees.
+ *
+ * The details of the dual-tree algorithm and of its Monte Carlo acceleration
+ * can be found in the following papers:
+ *
+ * @inproceedings{gray2003nonparametric,
+ *  title={Nonparametric density estimation: Toward computational
+ *      tractability},
+ *  author={Gray, A.G. and Moore, A.W.},
+ *  booktitle={Proceedings of the 2003 SIAM International Conference on Data
+ *      Mining},
+ *  pages={203--211},
+ *  year={2003}
+ * }
+ *
+ * @inproceedings{holmes2008ultrafast,
+ *  title={Ultrafast {M}onte {C}arlo for statistical summations},
+ *  author={Holmes, M.P. and Gray, A.G. and Isbell, C.L.},
+ *  booktitle={Advances in Neural Information Processing Systems 20},
+ *  pages={673--680},
+ *  year={2008}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_HPP
+#define MLPACK_METHODS_KDE_KDE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include "kde_stat.hpp"
+
+namespace mlpack {
+namespace kde /** Kernel density estimation. */ {
+
+//! The ways the densities can be computed.
+enum KDEMode
+{
+  //! Exactly, evaluating the kernel between every pair of points.
+  NAIVE_MODE,
+  //! With a traversal of the reference tree for each query point.
+  SINGLE_TREE_MODE,
+  //! With a traversal of the reference tree and a query tree.
+  DUAL_TREE_MODE
+};
+
+/**
+ * The KDE class estimates the density of the reference set at query points:
+ * the estimate at a query point q is the mean of K(q, r) over the reference
+ * points r, multiplied by the normalizing constant of the kernel if it has
+ * one (so that the estimate integrates to one).
+ *
+ * With a tree, the kernel values between a query (node) and a reference node
+ * are approximated by the middle of their bounds when that is within the error
+ * tolerance: every estimate is within relError times the exact density (before
+ * normalization) plus absError.  The tolerance that the exact computations
+ * between leaves do not use is kept in the query nodes, to be spent on later
+ * approximations.  For large reference nodes, Monte Carlo estimation may
+ * also be enabled: the kernel values are estimated from a sample of the
+ * reference points, which is grown until it guarantees the relative error with
+ * probability mcProb.  The Monte Carlo estimates are not bounded by the
+ * absolute error.
+ *
+ * The query points (or query subtrees, in dual-tree mode) are processed in
+ * parallel with OpenMP.
+ *
+ * @tparam KernelType Kernel to estimate the density with; it must have an
+ *     Evaluate(distance) function that is nonincreasing in the distance.
+ * @tparam MetricType Metric to compute the distances with.
+ * @tparam MatType Type of data to use.
+ * @tparam TreeType Type of tree to use; must satisfy the TreeType policy API.
+ *     Trees with self-children (such as the cover tree) hold points in several
+ *     nodes, and are not supported.
+ */
+template<typename KernelType = kernel::GaussianKernel,
+         typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class KDE
+{
+ public:
+  //! Convenience typedef.
+  typedef TreeType<MetricType, KDEStat, MatType> Tree;
+
+  /**
+   * Initialize the KDE object.  Train() must be called before the densities can
+   * be estimated.  An std::invalid_argument is thrown if a parameter is out of
+   * range.
+   *
+   * @param relError Relative error tolerance, in [0, 1].
+   * @param absError Absolute error tolerance, at least 0.
+   * @param kernel Instantiated kernel.
+   * @param mode How to compute the densities.
+   * @param monteCarlo Whether to use Monte Carlo estimation for large
+   *     reference nodes; this needs a positive relative error tolerance.
+   * @param mcProb Probability that each Monte Carlo estimate is within the
+   *     relative error tolerance, in [0, 1).
+   * @param initialSampleSize Size of the first sample of a Monte Carlo
+   *     estimate, at least 2.
+   * @param mcEntryCoef Only reference nodes with at least mcEntryCoef *
+   *     initialSampleSize descendants are estimated with Monte Carlo; at least
+   *     1.
+   * @param mcBreakCoef A Monte Carlo estimate is abandoned when it would need
+   *     more than mcBreakCoef times the descendants of the reference node; in
+   *     (0, 1].
+   */
+  KDE(const double relError = 0.05,
+      const double absError = 0.0,
+      KernelType kernel = KernelType(),
+      const KDEMode mode = DUAL_TREE_MODE,
+      const bool monteCarlo = false,
+      const double mcProb = 0.95,
+      const size_t initialSampleSize = 100,
+      const double mcEntryCoef = 3.0,
+      const double mcBreakCoef = 0.4);
+
+  /**
+   * Copy the given KDE object.  The reference tree is copied if it is owned by
+   * the other object.
+   *
+   * @param other KDE object to copy.
+   */
+  KDE(const KDE& other);
+
+  /**
+   * Take the contents of the given KDE object.
+   *
+   * @param other KDE object to take the contents of.
+   */
+  KDE(KDE&& other);
+
+  /**
+   * Copy the given KDE object.
+   *
+   * @param other KDE object to copy.
+   */
+  KDE& operator=(const KDE& other);
+
+  /**
+   * Take the contents of the given KDE object.
+   *
+   * @param other KDE object to take the contents of.
+   */
+  KDE& operator=(KDE&& other);
+
+  /**
+   * Destroy the KDE object, and the reference tree if it is owned.
+   */
+  ~KDE();
+
+  /**
+   * Build the reference tree on the given reference set.  The dataset is
+   * copied (or moved, if possible) into the tree.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Use the given reference tree.  The tree is not owned by this object, and
+   * must stay alive while it is used.  With a tree that rearranges its dataset,
+   * the monochromatic densities are given in the order of the points in the
+   * tree.
+   *
+   * @param referenceTree Built reference tree.
+   */
+  void Train(Tree* referenceTree);
+
+  /**
+   * Estimate the density at each point of the query set.
+   *
+   * @param querySet Set of query points.
+   * @param estimations The density at each query point.
+   */
+  void Evaluate(MatType querySet, arma::vec& estimations);
+
+  /**
+   * Estimate the density at each point of the given query tree, with a
+   * dual-tree traversal (the mode must be DUAL_TREE_MODE).
+   *
+   * @param queryTree Built query tree.
+   * @param oldFromNewQueries The mapping of the query points, as given by the
+   *     constructor of a query tree that rearranges its dataset; if empty, the
+   *     estimations are in the order of the points in the tree.
+   * @param estimations The density at each query point.
+   */
+  void Evaluate(Tree* queryTree,
+                const std::vector<size_t>& oldFromNewQueries,
+                arma::vec& estimations);
+
+  /**
+   * Estimate the density at each reference point (monochromatic estimation).
+   * The contribution of each point to its own density is included.
+   *
+   * @param estimations The density at each reference point.
+   */
+  void Evaluate(arma::vec& estimations);
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the kernel.
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the reference tree.
+  Tree* ReferenceTree() { return referenceTree; }
+
+  //! Get the relative error tolerance.
+  double RelativeError() const { return relError; }
+  //! Modify the relative error tolerance.
+  double& RelativeError() { return relError; }
+
+  //! Get the absolute error tolerance.
+  double AbsoluteError() const { return absError; }
+  //! Modify the absolute error tolerance.
+  double& AbsoluteError() { return absError; }
+
+  //! Get whether the reference tree is owned by this object.
+  bool OwnsReferenceTree() const { return ownsReferenceTree; }
+
+  //! Get whether the object has been trained.
+  bool IsTrained() const { return trained; }
+
+  //! Get how the densities are computed.
+  KDEMode Mode() const { return mode; }
+  //! Modify how the densities are computed.
+  KDEMode& Mode() { return mode; }
+
+  //! Get whether Monte Carlo estimation is used.
+  bool MonteCarlo() const { return monteCarlo; }
+  //! Modify whether Monte Carlo estimation is used.
+  bool& MonteCarlo() { return monteCarlo; }
+
+  //! Get the probability of the Monte Carlo estimates.
+  double MCProb() const { return mcProb; }
+  //! Modify the probability of the Monte Carlo estimates.
+  double& MCProb() { return mcProb; }
+
+  //! Get the size of the first Monte Carlo sample.
+  size_t MCInitialSampleSize() const { return initialSampleSize; }
+  //! Modify the size of the first Monte Carlo sample.
+  size_t& MCInitialSampleSize() { return initialSampleSize; }
+
+  //! Get the minimum size of the nodes estimated with Monte Carlo, relative to
+  //! the initial sample size.
+  double MCEntryCoefficient() const { return mcEntryCoef; }
+  //! Modify the minimum size of the nodes estimated with Monte Carlo, relative
+  //! to the initial sample size.
+  double& MCEntryCoefficient() { return mcEntryCoef; }
+
+  //! Get the maximum size of a Monte Carlo sample, relative to the node.
+  double MCBreakCoefficient() const { return mcBreakCoef; }
+  //! Modify the maximum size of a Monte Carlo sample, relative to the node.
+  double& MCBreakCoefficient() { return mcBreakCoef; }
+
+  //! Get the number of base cases of the last estimation.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores of the last estimation.
+  size_t Scores() const { return scores; }
+
+  //! Serialize the KDE object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! Throw an std::invalid_argument if a parameter is out of range.
+  void CheckParameters() const;
+
+  //! Compute the densities at the points of the query set, in naive or
+  //! single-tree mode.
+  void EvaluatePoints(const MatType& querySet, arma::vec& densities);
+
+  //! Compute the densities at the points of the query tree, in dual-tree mode.
+  void EvaluateTree(Tree& queryTree, arma::vec& densities);
+
+  //! Divide the sums of the kernel values by the number of reference points
+  //! and the normalizer of the kernel.
+  void Normalize(arma::vec& estimations);
+
+  //! The instantiated kernel.
+  KernelType kernel;
+  //! The instantiated metric.
+  MetricType metric;
+  //! The reference tree.
+  Tree* referenceTree;
+  //! The mapping of the reference points, if the tree was built here.
+  std::vector<size_t> oldFromNewReferences;
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+  //! Whether the reference tree is owned by this object.
+  bool ownsReferenceTree;
+  //! Whether the object has been trained.
+  bool trained;
+  //! How the densities are computed.
+  KDEMode mode;
+  //! Whether Monte Carlo estimation is used.
+  bool monteCarlo;
+  //! The probability of the Monte Carlo estimates.
+  double mcProb;
+  //! The size of the first Monte Carlo sample.
+  size_t initialSampleSize;
+  //! The minimum size of the nodes estimated with Monte Carlo.
+  double mcEntryCoef;
+  //! The maximum size of a Monte Carlo sample.
+  double mcBreakCoef;
+  //! The number of base cases of the last estimation.
+  size_t baseCases;
+  //! The number of scores of the last estimation.
+  size_t scores;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_impl.hpp"
+
+#endif
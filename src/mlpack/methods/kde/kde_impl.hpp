@@ -0,0 +1,639 @@
+/**
+ * @file kde_impl.hpp
+ *
+ * Implementation of the KDE class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_IMPL_HPP
+
+// Just in case it hasn't been included.
+#include "kde.hpp"
+
+// The rules for traversal.
+#include "kde_rules.hpp"
+
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+#include <mlpack/core/kernels/spherical_kernel.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
+
+namespace mlpack {
+namespace kde {
+
+//! Call the tree constructor that does mapping.
+template<typename TreeType, typename MatType>
+TreeType* BuildTree(
+    MatType&& dataset,
+    std::vector<size_t>& oldFromNew,
+    const typename std::enable_if<
+        tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
+{
+  return new TreeType(std::forward<MatType>(dataset), oldFromNew);
+}
+
+//! Call the tree constructor that does not do mapping.
+template<typename TreeType, typename MatType>
+TreeType* BuildTree(
+    MatType&& dataset,
+    const std::vector<size_t>& /* oldFromNew */,
+    const typename std::enable_if<
+        !tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
+{
+  return new TreeType(std::forward<MatType>(dataset));
+}
+
+//! Most kernels have no normalizer.
+template<typename KernelType>
+void ApplyNormalizer(KernelType& /* kernel */,
+                     const size_t /* dimension */,
+                     arma::vec& /* estimations */)
+{ }
+
+//! Divide by the normalizer of the Gaussian kernel.
+inline void ApplyNormalizer(kernel::GaussianKernel& kernel,
+                            const size_t dimension,
+                            arma::vec& estimations)
+{
+  estimations /= kernel.Normalizer(dimension);
+}
+
+//! Divide by the normalizer of the Epanechnikov kernel.
+inline void ApplyNormalizer(kernel::EpanechnikovKernel& kernel,
+                            const size_t dimension,
+                            arma::vec& estimations)
+{
+  estimations /= kernel.Normalizer(dimension);
+}
+
+//! Divide by the normalizer of the spherical kernel.
+inline void ApplyNormalizer(kernel::SphericalKernel& kernel,
+                            const size_t dimension,
+                            arma::vec& estimations)
+{
+  estimations /= kernel.Normalizer(dimension);
+}
+
+//! Forget the unused error tolerance of every node of the tree.
+template<typename TreeType>
+void ResetAccumErrors(TreeType& node)
+{
+  node.Stat().AccumError() = 0.0;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    ResetAccumErrors(node.Child(i));
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(
+    const double relError,
+    const double absError,
+    KernelType kernel,
+    const KDEMode mode,
+    const bool monteCarlo,
+    const double mcProb,
+    const size_t initialSampleSize,
+    const double mcEntryCoef,
+    const double mcBreakCoef) :
+    kernel(kernel),
+    referenceTree(NULL),
+    relError(relError),
+    absError(absError),
+    ownsReferenceTree(false),
+    trained(false),
+    mode(mode),
+    monteCarlo(monteCarlo),
+    mcProb(mcProb),
+    initialSampleSize(initialSampleSize),
+    mcEntryCoef(mcEntryCoef),
+    mcBreakCoef(mcBreakCoef),
+    baseCases(0),
+    scores(0)
+{
+  // A point in several nodes would be counted several times.
+  static_assert(!tree::TreeTraits<Tree>::HasSelfChildren &&
+      !tree::TreeTraits<Tree>::HasDuplicatedPoints,
+      "KDE cannot be used with trees whose points may be in several nodes.");
+
+  CheckParameters();
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(const KDE& other) :
+    kernel(other.kernel),
+    metric(other.metric),
+    referenceTree((other.ownsReferenceTree && other.referenceTree) ?
+        new Tree(*other.referenceTree) : other.referenceTree),
+    oldFromNewReferences(other.oldFromNewReferences),
+    relError(other.relError),
+    absError(other.absError),
+    ownsReferenceTree(other.ownsReferenceTree),
+    trained(other.trained),
+    mode(other.mode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    baseCases(other.baseCases),
+    scores(other.scores)
+{
+  // Nothing to do.
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(KDE&& other) :
+    kernel(std::move(other.kernel)),
+    metric(std::move(other.metric)),
+    referenceTree(other.referenceTree),
+    oldFromNewReferences(std::move(other.oldFromNewReferences)),
+    relError(other.relError),
+    absError(other.absError),
+    ownsReferenceTree(other.ownsReferenceTree),
+    trained(other.trained),
+    mode(other.mode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    baseCases(other.baseCases),
+    scores(other.scores)
+{
+  other.referenceTree = NULL;
+  other.ownsReferenceTree = false;
+  other.trained = false;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>&
+KDE<KernelType, MetricType, MatType, TreeType>::operator=(const KDE& other)
+{
+  if (this != &other)
+  {
+    KDE copy(other);
+    *this = std::move(copy);
+  }
+
+  return *this;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>&
+KDE<KernelType, MetricType, MatType, TreeType>::operator=(KDE&& other)
+{
+  if (this != &other)
+  {
+    if (ownsReferenceTree)
+      delete referenceTree;
+
+    kernel = std::move(other.kernel);
+    metric = std::move(other.metric);
+    referenceTree = other.referenceTree;
+    oldFromNewReferences = std::move(other.oldFromNewReferences);
+    relError = other.relError;
+    absError = other.absError;
+    ownsReferenceTree = other.ownsReferenceTree;
+    trained = other.trained;
+    mode = other.mode;
+    monteCarlo = other.monteCarlo;
+    mcProb = other.mcProb;
+    initialSampleSize = other.initialSampleSize;
+    mcEntryCoef = other.mcEntryCoef;
+    mcBreakCoef = other.mcBreakCoef;
+    baseCases = other.baseCases;
+    scores = other.scores;
+
+    other.referenceTree = NULL;
+    other.ownsReferenceTree = false;
+    other.trained = false;
+  }
+
+  return *this;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::~KDE()
+{
+  if (ownsReferenceTree)
+    delete referenceTree;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Train(
+    MatType referenceSet)
+{
+  if (referenceSet.n_cols == 0)
+    throw std::invalid_argument("KDE::Train(): the reference set is empty");
+
+  if (ownsReferenceTree)
+    delete referenceTree;
+
+  Timer::Start("kde/tree_building");
+  oldFromNewReferences.clear();
+  referenceTree = BuildTree<Tree>(std::move(referenceSet),
+      oldFromNewReferences);
+  Timer::Stop("kde/tree_building");
+
+  ownsReferenceTree = true;
+  trained = true;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Train(
+    Tree* referenceTree)
+{
+  if (referenceTree == NULL || referenceTree->NumDescendants() == 0)
+    throw std::invalid_argument("KDE::Train(): the reference tree is empty");
+
+  if (ownsReferenceTree)
+    delete this->referenceTree;
+
+  this->referenceTree = referenceTree;
+  oldFromNewReferences.clear();
+  ownsReferenceTree = false;
+  trained = true;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    MatType querySet,
+    arma::vec& estimations)
+{
+  if (!trained)
+    throw std::invalid_argument("KDE::Evaluate(): the model is not trained");
+  if (querySet.n_rows != referenceTree->Dataset().n_rows)
+  {
+    throw std::invalid_argument("KDE::Evaluate(): the dimensionality of the "
+        "query set does not match the reference set");
+  }
+
+  CheckParameters();
+
+  if (mode != DUAL_TREE_MODE)
+  {
+    Timer::Start("kde/computing_kde");
+    EvaluatePoints(querySet, estimations);
+    Normalize(estimations);
+    Timer::Stop("kde/computing_kde");
+    return;
+  }
+
+  Timer::Start("kde/tree_building");
+  std::vector<size_t> oldFromNewQueries;
+  Tree* queryTree = BuildTree<Tree>(std::move(querySet), oldFromNewQueries);
+  Timer::Stop("kde/tree_building");
+
+  Evaluate(queryTree, oldFromNewQueries, estimations);
+  delete queryTree;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    Tree* queryTree,
+    const std::vector<size_t>& oldFromNewQueries,
+    arma::vec& estimations)
+{
+  if (!trained)
+    throw std::invalid_argument("KDE::Evaluate(): the model is not trained");
+  if (mode != DUAL_TREE_MODE)
+  {
+    throw std::invalid_argument("KDE::Evaluate(): a query tree can only be "
+        "used in dual-tree mode");
+  }
+  if (queryTree->Dataset().n_rows != referenceTree->Dataset().n_rows)
+  {
+    throw std::invalid_argument("KDE::Evaluate(): the dimensionality of the "
+        "query set does not match the reference set");
+  }
+
+  CheckParameters();
+
+  Timer::Start("kde/computing_kde");
+  arma::vec densities;
+  EvaluateTree(*queryTree, densities);
+
+  if (oldFromNewQueries.empty())
+  {
+    estimations = std::move(densities);
+  }
+  else
+  {
+    estimations.set_size(densities.n_elem);
+    for (size_t i = 0; i < densities.n_elem; ++i)
+      estimations[oldFromNewQueries[i]] = densities[i];
+  }
+
+  Normalize(estimations);
+  Timer::Stop("kde/computing_kde");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    arma::vec& estimations)
+{
+  if (!trained)
+    throw std::invalid_argument("KDE::Evaluate(): the model is not trained");
+
+  CheckParameters();
+
+  // The reference tree is the query tree too.
+  Timer::Start("kde/computing_kde");
+  arma::vec densities;
+  if (mode == DUAL_TREE_MODE)
+    EvaluateTree(*referenceTree, densities);
+  else
+    EvaluatePoints(referenceTree->Dataset(), densities);
+
+  if (oldFromNewReferences.empty())
+  {
+    estimations = std::move(densities);
+  }
+  else
+  {
+    estimations.set_size(densities.n_elem);
+    for (size_t i = 0; i < densities.n_elem; ++i)
+      estimations[oldFromNewReferences[i]] = densities[i];
+  }
+
+  Normalize(estimations);
+  Timer::Stop("kde/computing_kde");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::EvaluatePoints(
+    const MatType& querySet,
+    arma::vec& densities)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  const MatType& referenceSet = referenceTree->Dataset();
+  densities.zeros(querySet.n_cols);
+  arma::vec accumErrors(querySet.n_cols, arma::fill::zeros);
+  RuleType rules(referenceSet, querySet, densities, accumErrors, relError,
+      absError, metric, kernel, monteCarlo, mcProb, initialSampleSize,
+      mcEntryCoef, mcBreakCoef);
+
+  baseCases = 0;
+  scores = 0;
+
+  if (mode == NAIVE_MODE)
+  {
+    // Blocks of query points are given to the threads, and the reference set
+    // is processed in blocks, so that the kernel values of a block fit in the
+    // cache.
+    const size_t queryBlock = 64;
+    const size_t referenceBlock = 2048;
+    const size_t numBlocks = (querySet.n_cols + queryBlock - 1) / queryBlock;
+
+    size_t threadBaseCases = 0;
+    #pragma omp parallel reduction(+:threadBaseCases)
+    {
+      RuleType threadRules(rules);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      {
+        const size_t queryBegin = b * queryBlock;
+        const size_t queryCount = std::min(queryBlock,
+            (size_t) querySet.n_cols - queryBegin);
+        for (size_t r = 0; r < referenceSet.n_cols; r += referenceBlock)
+        {
+          threadRules.BlockBaseCases(queryBegin, queryCount, r,
+              std::min(referenceBlock, (size_t) referenceSet.n_cols - r));
+        }
+      }
+
+      threadBaseCases += threadRules.BaseCases();
+    }
+
+    baseCases = threadBaseCases;
+  }
+  else
+  {
+    // Each query point has its own traversal; the rules only write the
+    // density and the unused error tolerance of the query point.
+    size_t threadBaseCases = 0, threadScores = 0;
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+    {
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(
+          threadRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadBaseCases += threadRules.BaseCases();
+      threadScores += threadRules.Scores();
+    }
+
+    baseCases = threadBaseCases;
+    scores = threadScores;
+  }
+
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::EvaluateTree(
+    Tree& queryTree,
+    arma::vec& densities)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  const MatType& querySet = queryTree.Dataset();
+  densities.zeros(querySet.n_cols);
+  arma::vec accumErrors(querySet.n_cols, arma::fill::zeros);
+
+  // The unused tolerance of an earlier estimation must not be spent again.
+  ResetAccumErrors(queryTree);
+
+  RuleType rules(referenceTree->Dataset(), querySet, densities, accumErrors,
+      relError, absError, metric, kernel, monteCarlo, mcProb,
+      initialSampleSize, mcEntryCoef, mcBreakCoef);
+
+  // The rules only write the densities of the query points and the statistics
+  // of the query nodes they visit, so disjoint query subtrees are traversed in
+  // parallel.
+  tree::ParallelDualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+
+  baseCases = rules.BaseCases();
+  scores = rules.Scores();
+
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+  Log::Info << scores << " node combinations were scored." << std::endl;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Normalize(
+    arma::vec& estimations)
+{
+  estimations /= referenceTree->Dataset().n_cols;
+  ApplyNormalizer(kernel, referenceTree->Dataset().n_rows, estimations);
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::CheckParameters() const
+{
+  if (relError < 0.0 || relError > 1.0)
+  {
+    throw std::invalid_argument("KDE: the relative error tolerance must be in "
+        "[0, 1]");
+  }
+  if (absError < 0.0)
+  {
+    throw std::invalid_argument("KDE: the absolute error tolerance must be at "
+        "least 0");
+  }
+
+  if (!monteCarlo)
+    return;
+
+  if (relError == 0.0)
+  {
+    throw std::invalid_argument("KDE: Monte Carlo estimation needs a positive "
+        "relative error tolerance");
+  }
+  if (mcProb < 0.0 || mcProb >= 1.0)
+  {
+    throw std::invalid_argument("KDE: the Monte Carlo probability must be in "
+        "[0, 1)");
+  }
+  if (initialSampleSize < 2)
+  {
+    throw std::invalid_argument("KDE: the initial Monte Carlo sample size must "
+        "be at least 2");
+  }
+  if (mcEntryCoef < 1.0)
+  {
+    throw std::invalid_argument("KDE: the Monte Carlo entry coefficient must "
+        "be at least 1");
+  }
+  if (mcBreakCoef <= 0.0 || mcBreakCoef > 1.0)
+  {
+    throw std::invalid_argument("KDE: the Monte Carlo break coefficient must "
+        "be in (0, 1]");
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename Archive>
+void KDE<KernelType, MetricType, MatType, TreeType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(kernel);
+  ar & BOOST_SERIALIZATION_NVP(relError);
+  ar & BOOST_SERIALIZATION_NVP(absError);
+  ar & BOOST_SERIALIZATION_NVP(mode);
+  ar & BOOST_SERIALIZATION_NVP(monteCarlo);
+  ar & BOOST_SERIALIZATION_NVP(mcProb);
+  ar & BOOST_SERIALIZATION_NVP(initialSampleSize);
+  ar & BOOST_SERIALIZATION_NVP(mcEntryCoef);
+  ar & BOOST_SERIALIZATION_NVP(mcBreakCoef);
+  ar & BOOST_SERIALIZATION_NVP(trained);
+
+  // A loaded reference tree is always owned.
+  if (Archive::is_loading::value)
+  {
+    if (ownsReferenceTree)
+      delete referenceTree;
+
+    referenceTree = NULL;
+    ownsReferenceTree = true;
+    baseCases = 0;
+    scores = 0;
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(referenceTree);
+  ar & BOOST_SERIALIZATION_NVP(oldFromNewReferences);
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
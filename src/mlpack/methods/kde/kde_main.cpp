@@ -0,0 +1,220 @@
+/**
+ * @file kde_main.cpp
+ *
+ * Executable for kernel density estimation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "kde_model.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("Kernel Density Estimation",
+    "This program estimates the density of a reference set at a set of query "
+    "points, with a kernel: the estimate at a query point is the mean of the "
+    "kernel values between the query point and the reference points "
+    "(normalized, for the kernels with a normalizing constant).  If no query "
+    "set is given, the densities are estimated at the reference points."
+    "\n\n"
+    "The densities are approximated with a dual-tree algorithm: each estimate "
+    "is within " + PRINT_PARAM_STRING("rel_error") + " times the exact "
+    "(unnormalized) density plus " + PRINT_PARAM_STRING("abs_error") + ".  "
+    "With " + PRINT_PARAM_STRING("monte_carlo") + ", the kernel values of "
+    "large tree nodes are also estimated from samples, which are grown until "
+    "they are within the relative error with probability " +
+    PRINT_PARAM_STRING("mc_probability") + "."
+    "\n\n"
+    "The kernel may be 'gaussian', 'epanechnikov', 'laplacian', 'spherical' or "
+    "'triangular', the tree may be 'kd-tree', 'ball-tree', 'octree' or "
+    "'r-tree', and the algorithm may be 'dual-tree', 'single-tree' or 'naive'."
+    "\n\n"
+    "For example, the following will estimate the density of " +
+    PRINT_DATASET("reference") + " at the points of " + PRINT_DATASET("query") +
+    " with a Gaussian kernel of bandwidth 0.2, store the densities in " +
+    PRINT_DATASET("out_data") + ", and save the model to " +
+    PRINT_MODEL("kde_model") + ":"
+    "\n\n" +
+    PRINT_CALL("kde", "reference", "reference", "query", "query", "bandwidth",
+        0.2, "predictions", "out_data", "output_model", "kde_model"));
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Input reference dataset.", "r");
+PARAM_MATRIX_IN("query", "Query dataset to estimate the density at.", "q");
+PARAM_COL_OUT("predictions", "Vector to store the density estimates in.", "p");
+
+// We can load or save models.
+PARAM_MODEL_IN(KDEModel, "input_model", "Contains the pre-trained KDE model.",
+    "m");
+PARAM_MODEL_OUT(KDEModel, "output_model", "If specified, the KDE model will "
+    "be saved here.", "M");
+
+PARAM_DOUBLE_IN("bandwidth", "Bandwidth of the kernel.", "b", 1.0);
+PARAM_STRING_IN("kernel", "Kernel to use for the estimation ('gaussian', "
+    "'epanechnikov', 'laplacian', 'spherical', 'triangular').", "k",
+    "gaussian");
+PARAM_STRING_IN("tree", "Tree to use for the estimation ('kd-tree', "
+    "'ball-tree', 'octree', 'r-tree').", "t", "kd-tree");
+PARAM_STRING_IN("algorithm", "Algorithm to use for the estimation "
+    "('dual-tree', 'single-tree', 'naive').", "a", "dual-tree");
+PARAM_DOUBLE_IN("rel_error", "Relative error tolerance of the estimates.", "e",
+    0.05);
+PARAM_DOUBLE_IN("abs_error", "Absolute error tolerance of the estimates.", "E",
+    0.0);
+
+PARAM_FLAG("monte_carlo", "Estimate the kernel values of large nodes with "
+    "Monte Carlo.", "S");
+PARAM_DOUBLE_IN("mc_probability", "Probability that each Monte Carlo estimate "
+    "is within the relative error tolerance.", "P", 0.95);
+PARAM_INT_IN("initial_sample_size", "Size of the first sample of a Monte Carlo"
+    " estimate.", "n", 100);
+PARAM_DOUBLE_IN("mc_entry_coef", "Only nodes with at least this many times "
+    "the initial sample size are estimated with Monte Carlo.", "C", 3.0);
+PARAM_DOUBLE_IN("mc_break_coef", "A Monte Carlo estimate is abandoned when its "
+    "sample would be larger than this fraction of the node.", "c", 0.4);
+
+static void mlpackMain()
+{
+  RequireOnlyOnePassed({ "reference", "input_model" }, true);
+  RequireAtLeastOnePassed({ "predictions", "output_model" }, false,
+      "no results will be saved");
+
+  RequireParamInSet<string>("kernel", { "gaussian", "epanechnikov",
+      "laplacian", "spherical", "triangular" }, true, "unknown kernel");
+  RequireParamInSet<string>("tree", { "kd-tree", "ball-tree", "octree",
+      "r-tree" }, true, "unknown tree type");
+  RequireParamInSet<string>("algorithm", { "dual-tree", "single-tree",
+      "naive" }, true, "unknown algorithm");
+  RequireParamValue<double>("bandwidth", [](double x) { return x > 0.0; },
+      true, "bandwidth must be positive");
+  RequireParamValue<double>("rel_error",
+      [](double x) { return x >= 0.0 && x <= 1.0; }, true,
+      "relative error must be in [0, 1]");
+  RequireParamValue<double>("abs_error", [](double x) { return x >= 0.0; },
+      true, "absolute error must be at least 0");
+  RequireParamValue<double>("mc_probability",
+      [](double x) { return x >= 0.0 && x < 1.0; }, true,
+      "Monte Carlo probability must be in [0, 1)");
+  RequireParamValue<int>("initial_sample_size", [](int x) { return x >= 2; },
+      true, "initial sample size must be at least 2");
+  RequireParamValue<double>("mc_entry_coef", [](double x) { return x >= 1.0; },
+      true, "Monte Carlo entry coefficient must be at least 1");
+  RequireParamValue<double>("mc_break_coef",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "Monte Carlo break coefficient must be in (0, 1]");
+
+  // The kernel and the tree of a model cannot be changed.
+  ReportIgnoredParam({{ "input_model", true }}, "kernel");
+  ReportIgnoredParam({{ "input_model", true }}, "tree");
+
+  const string algorithm = CLI::GetParam<string>("algorithm");
+  const KDEMode mode = (algorithm == "naive") ? NAIVE_MODE :
+      (algorithm == "single-tree") ? SINGLE_TREE_MODE : DUAL_TREE_MODE;
+
+  KDEModel* kde;
+  if (CLI::HasParam("reference"))
+  {
+    const string kernel = CLI::GetParam<string>("kernel");
+    const string tree = CLI::GetParam<string>("tree");
+
+    kde = new KDEModel();
+    if (kernel == "gaussian")
+      kde->KernelType() = KDEModel::GAUSSIAN_KERNEL;
+    else if (kernel == "epanechnikov")
+      kde->KernelType() = KDEModel::EPANECHNIKOV_KERNEL;
+    else if (kernel == "laplacian")
+      kde->KernelType() = KDEModel::LAPLACIAN_KERNEL;
+    else if (kernel == "spherical")
+      kde->KernelType() = KDEModel::SPHERICAL_KERNEL;
+    else
+      kde->KernelType() = KDEModel::TRIANGULAR_KERNEL;
+
+    if (tree == "kd-tree")
+      kde->TreeType() = KDEModel::KD_TREE;
+    else if (tree == "ball-tree")
+      kde->TreeType() = KDEModel::BALL_TREE;
+    else if (tree == "octree")
+      kde->TreeType() = KDEModel::OCTREE;
+    else
+      kde->TreeType() = KDEModel::R_TREE;
+  }
+  else
+  {
+    kde = CLI::GetParam<KDEModel*>("input_model");
+  }
+
+  // The parameters of a loaded model are kept unless they are given.
+  const bool newModel = CLI::HasParam("reference");
+  if (newModel || CLI::HasParam("bandwidth"))
+    kde->Bandwidth() = CLI::GetParam<double>("bandwidth");
+  if (newModel || CLI::HasParam("algorithm"))
+    kde->Mode() = mode;
+  if (newModel || CLI::HasParam("rel_error"))
+    kde->RelativeError() = CLI::GetParam<double>("rel_error");
+  if (newModel || CLI::HasParam("abs_error"))
+    kde->AbsoluteError() = CLI::GetParam<double>("abs_error");
+  if (newModel || CLI::HasParam("monte_carlo"))
+    kde->MonteCarlo() = CLI::HasParam("monte_carlo");
+  if (newModel || CLI::HasParam("mc_probability"))
+    kde->MCProb() = CLI::GetParam<double>("mc_probability");
+  if (newModel || CLI::HasParam("initial_sample_size"))
+  {
+    kde->MCInitialSampleSize() =
+        (size_t) CLI::GetParam<int>("initial_sample_size");
+  }
+  if (newModel || CLI::HasParam("mc_entry_coef"))
+    kde->MCEntryCoefficient() = CLI::GetParam<double>("mc_entry_coef");
+  if (newModel || CLI::HasParam("mc_break_coef"))
+    kde->MCBreakCoefficient() = CLI::GetParam<double>("mc_break_coef");
+
+  if (kde->MonteCarlo() && kde->RelativeError() == 0.0)
+  {
+    if (newModel)
+      delete kde;
+    Log::Fatal << "Monte Carlo estimation needs a positive "
+        << PRINT_PARAM_STRING("rel_error") << "." << endl;
+  }
+
+  if (newModel)
+  {
+    arma::mat referenceSet = std::move(CLI::GetParam<arma::mat>("reference"));
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceSet.n_rows << " x " << referenceSet.n_cols << ")."
+        << endl;
+
+    kde->BuildModel(std::move(referenceSet));
+  }
+
+  if (CLI::HasParam("predictions"))
+  {
+    arma::vec estimations;
+    if (CLI::HasParam("query"))
+    {
+      arma::mat querySet = std::move(CLI::GetParam<arma::mat>("query"));
+      Log::Info << "Loaded query data from '"
+          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+          << querySet.n_rows << " x " << querySet.n_cols << ")." << endl;
+
+      kde->Evaluate(std::move(querySet), estimations);
+    }
+    else
+    {
+      kde->Evaluate(estimations);
+    }
+
+    CLI::GetParam<arma::vec>("predictions") = std::move(estimations);
+  }
+
+  CLI::GetParam<KDEModel*>("output_model") = kde;
+}
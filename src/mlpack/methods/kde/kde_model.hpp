@@ -0,0 +1,396 @@
+/**
+ * @file kde_model.hpp
+ *
+ * A serializable KDE model, which may use any of the supported kernels and
+ * tree types, selected at run time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_MODEL_HPP
+#define MLPACK_METHODS_KDE_KDE_MODEL_HPP
+
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+#include <mlpack/core/kernels/spherical_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
+#include <boost/variant.hpp>
+#include "kde.hpp"
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * Alias template for KDE.
+ */
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+using KDEType = KDE<KernelType, metric::EuclideanDistance, arma::mat, TreeType>;
+
+/**
+ * TrainVisitor builds the reference tree of the given KDEType.
+ */
+class TrainVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Train the given KDE object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! Construct the TrainVisitor with the given reference set.
+  TrainVisitor(arma::mat&& referenceSet) :
+      referenceSet(std::move(referenceSet))
+  { }
+
+ private:
+  //! The reference set.
+  arma::mat&& referenceSet;
+};
+
+/**
+ * EvaluateVisitor estimates the densities at the points of a query set with
+ * the given KDEType.
+ */
+class EvaluateVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Estimate the densities with the given KDE object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! Construct the EvaluateVisitor with the given query set and output.
+  EvaluateVisitor(arma::mat&& querySet, arma::vec& estimations) :
+      querySet(std::move(querySet)),
+      estimations(estimations)
+  { }
+
+ private:
+  //! The query set.
+  arma::mat&& querySet;
+  //! The estimated densities.
+  arma::vec& estimations;
+};
+
+/**
+ * MonoEvaluateVisitor estimates the densities at the reference points with the
+ * given KDEType.
+ */
+class MonoEvaluateVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Estimate the densities with the given KDE object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! Construct the MonoEvaluateVisitor with the given output.
+  MonoEvaluateVisitor(arma::vec& estimations) : estimations(estimations) { }
+
+ private:
+  //! The estimated densities.
+  arma::vec& estimations;
+};
+
+//! Forward declaration.
+class KDEModel;
+
+/**
+ * ParametersVisitor sets the parameters of the model on the given KDEType, so
+ * that they can be changed after the model is built.
+ */
+class ParametersVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Set the parameters of the given KDE object.
+  template<typename KernelType,
+           template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(KDEType<KernelType, TreeType>* kde) const;
+
+  //! Construct the ParametersVisitor with the given model.
+  ParametersVisitor(const KDEModel& model) : model(model) { }
+
+ private:
+  //! The model that holds the parameters.
+  const KDEModel& model;
+};
+
+/**
+ * CopyVisitor returns a copy of the given KDEType.
+ */
+template<typename VariantType>
+class CopyVisitor : public boost::static_visitor<VariantType>
+{
+ public:
+  //! Copy the given KDE object.
+  template<typename KDEType>
+  VariantType operator()(const KDEType* kde) const;
+};
+
+/**
+ * DeleteVisitor deletes the given KDEType instance.
+ */
+class DeleteVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Delete the KDE object.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+};
+
+/**
+ * The KDEModel holds a KDE object for one of the supported kernels and tree
+ * types, so that they can be chosen at run time (for instance, by the kde
+ * binding).  The parameters may be changed after the model is built, except
+ * for the kernel type and the tree type.
+ */
+class KDEModel
+{
+ public:
+  //! The supported kernels.
+  enum KernelTypes
+  {
+    GAUSSIAN_KERNEL,
+    EPANECHNIKOV_KERNEL,
+    LAPLACIAN_KERNEL,
+    SPHERICAL_KERNEL,
+    TRIANGULAR_KERNEL
+  };
+
+  //! The supported tree types.
+  enum TreeTypes
+  {
+    KD_TREE,
+    BALL_TREE,
+    OCTREE,
+    R_TREE
+  };
+
+ private:
+  //! The KDE types for each kernel and tree type.
+  typedef boost::variant<KDEType<kernel::GaussianKernel, tree::KDTree>*,
+                         KDEType<kernel::GaussianKernel, tree::BallTree>*,
+                         KDEType<kernel::GaussianKernel, tree::Octree>*,
+                         KDEType<kernel::GaussianKernel, tree::RTree>*,
+                         KDEType<kernel::EpanechnikovKernel, tree::KDTree>*,
+                         KDEType<kernel::EpanechnikovKernel, tree::BallTree>*,
+                         KDEType<kernel::EpanechnikovKernel, tree::Octree>*,
+                         KDEType<kernel::EpanechnikovKernel, tree::RTree>*,
+                         KDEType<kernel::LaplacianKernel, tree::KDTree>*,
+                         KDEType<kernel::LaplacianKernel, tree::BallTree>*,
+                         KDEType<kernel::LaplacianKernel, tree::Octree>*,
+                         KDEType<kernel::LaplacianKernel, tree::RTree>*,
+                         KDEType<kernel::SphericalKernel, tree::KDTree>*,
+                         KDEType<kernel::SphericalKernel, tree::BallTree>*,
+                         KDEType<kernel::SphericalKernel, tree::Octree>*,
+                         KDEType<kernel::SphericalKernel, tree::RTree>*,
+                         KDEType<kernel::TriangularKernel, tree::KDTree>*,
+                         KDEType<kernel::TriangularKernel, tree::BallTree>*,
+                         KDEType<kernel::TriangularKernel, tree::Octree>*,
+                         KDEType<kernel::TriangularKernel, tree::RTree>*>
+      KDEVariant;
+
+ public:
+  /**
+   * Initialize the KDEModel with the given parameters; BuildModel() must be
+   * called before the densities can be estimated.  See the KDE class for the
+   * meaning of the parameters.
+   *
+   * @param bandwidth Bandwidth of the kernel.
+   * @param relError Relative error tolerance.
+   * @param absError Absolute error tolerance.
+   * @param kernelType Type of kernel.
+   * @param treeType Type of tree.
+   * @param mode How to compute the densities.
+   * @param monteCarlo Whether to use Monte Carlo estimation.
+   * @param mcProb Probability of the Monte Carlo estimates.
+   * @param initialSampleSize Size of the first Monte Carlo sample.
+   * @param mcEntryCoef Minimum size of the nodes estimated with Monte Carlo,
+   *     relative to the initial sample size.
+   * @param mcBreakCoef Maximum size of a Monte Carlo sample, relative to the
+   *     node.
+   */
+  KDEModel(const double bandwidth = 1.0,
+           const double relError = 0.05,
+           const double absError = 0.0,
+           const KernelTypes kernelType = GAUSSIAN_KERNEL,
+           const TreeTypes treeType = KD_TREE,
+           const KDEMode mode = DUAL_TREE_MODE,
+           const bool monteCarlo = false,
+           const double mcProb = 0.95,
+           const size_t initialSampleSize = 100,
+           const double mcEntryCoef = 3.0,
+           const double mcBreakCoef = 0.4);
+
+  /**
+   * Copy the given KDEModel.
+   *
+   * @param other KDEModel to copy.
+   */
+  KDEModel(const KDEModel& other);
+
+  /**
+   * Take ownership of the given KDEModel.
+   *
+   * @param other KDEModel to take ownership of.
+   */
+  KDEModel(KDEModel&& other);
+
+  /**
+   * Copy the given KDEModel.
+   *
+   * @param other KDEModel to copy.
+   */
+  KDEModel& operator=(const KDEModel& other);
+
+  /**
+   * Take ownership of the given KDEModel.
+   *
+   * @param other KDEModel to take ownership of.
+   */
+  KDEModel& operator=(KDEModel&& other);
+
+  /**
+   * Clean memory, if necessary.
+   */
+  ~KDEModel();
+
+  //! Serialize the KDE model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  /**
+   * Build the reference tree of the chosen type on the given dataset.  This
+   * takes possession of the reference set to avoid a copy.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void BuildModel(arma::mat&& referenceSet);
+
+  /**
+   * Estimate the density at each point of the query set.  This takes
+   * possession of the query set, so the query set will not be usable after the
+   * estimation.
+   *
+   * @param querySet Set of query points.
+   * @param estimations The density at each query point.
+   */
+  void Evaluate(arma::mat&& querySet, arma::vec& estimations);
+
+  /**
+   * Estimate the density at each reference point.
+   *
+   * @param estimations The density at each reference point.
+   */
+  void Evaluate(arma::vec& estimations);
+
+  //! Get the bandwidth of the kernel.
+  double Bandwidth() const { return bandwidth; }
+  //! Modify the bandwidth of the kernel.
+  double& Bandwidth() { return bandwidth; }
+
+  //! Get the relative error tolerance.
+  double RelativeError() const { return relError; }
+  //! Modify the relative error tolerance.
+  double& RelativeError() { return relError; }
+
+  //! Get the absolute error tolerance.
+  double AbsoluteError() const { return absError; }
+  //! Modify the absolute error tolerance.
+  double& AbsoluteError() { return absError; }
+
+  //! Get the type of kernel.
+  KernelTypes KernelType() const { return kernelType; }
+  //! Modify the type of kernel (don't do this after the model has been built).
+  KernelTypes& KernelType() { return kernelType; }
+
+  //! Get the type of tree.
+  TreeTypes TreeType() const { return treeType; }
+  //! Modify the type of tree (don't do this after the model has been built).
+  TreeTypes& TreeType() { return treeType; }
+
+  //! Get how the densities are computed.
+  KDEMode Mode() const { return mode; }
+  //! Modify how the densities are computed.
+  KDEMode& Mode() { return mode; }
+
+  //! Get whether Monte Carlo estimation is used.
+  bool MonteCarlo() const { return monteCarlo; }
+  //! Modify whether Monte Carlo estimation is used.
+  bool& MonteCarlo() { return monteCarlo; }
+
+  //! Get the probability of the Monte Carlo estimates.
+  double MCProb() const { return mcProb; }
+  //! Modify the probability of the Monte Carlo estimates.
+  double& MCProb() { return mcProb; }
+
+  //! Get the size of the first Monte Carlo sample.
+  size_t MCInitialSampleSize() const { return initialSampleSize; }
+  //! Modify the size of the first Monte Carlo sample.
+  size_t& MCInitialSampleSize() { return initialSampleSize; }
+
+  //! Get the minimum size of the nodes estimated with Monte Carlo, relative to
+  //! the initial sample size.
+  double MCEntryCoefficient() const { return mcEntryCoef; }
+  //! Modify the minimum size of the nodes estimated with Monte Carlo, relative
+  //! to the initial sample size.
+  double& MCEntryCoefficient() { return mcEntryCoef; }
+
+  //! Get the maximum size of a Monte Carlo sample, relative to the node.
+  double MCBreakCoefficient() const { return mcBreakCoef; }
+  //! Modify the maximum size of a Monte Carlo sample, relative to the node.
+  double& MCBreakCoefficient() { return mcBreakCoef; }
+
+ private:
+  //! Create the KDE object for the given kernel and the chosen tree type.
+  template<typename KDEKernelType>
+  void InitializeModel();
+
+  //! Delete the KDE object.
+  void CleanMemory();
+
+  //! The bandwidth of the kernel.
+  double bandwidth;
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+  //! The type of kernel.
+  KernelTypes kernelType;
+  //! The type of tree.
+  TreeTypes treeType;
+  //! How the densities are computed.
+  KDEMode mode;
+  //! Whether Monte Carlo estimation is used.
+  bool monteCarlo;
+  //! The probability of the Monte Carlo estimates.
+  double mcProb;
+  //! The size of the first Monte Carlo sample.
+  size_t initialSampleSize;
+  //! The minimum size of the nodes estimated with Monte Carlo.
+  double mcEntryCoef;
+  //! The maximum size of a Monte Carlo sample.
+  double mcBreakCoef;
+
+  /**
+   * kdeModel holds an instance of the KDE class for the current kernel type
+   * and tree type.  It is initialized every time BuildModel() is executed.
+   */
+  KDEVariant kdeModel;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_model_impl.hpp"
+
+#endif
@@ -0,0 +1,300 @@
+/**
+ * @file kde_model_impl.hpp
+ *
+ * Implementation of the visitors and inline functions of KDEModel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_MODEL_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_MODEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_model.hpp"
+
+#include <boost/serialization/variant.hpp>
+
+namespace mlpack {
+namespace kde {
+
+//! Train the KDE object.
+template<typename KDEType>
+void TrainVisitor::operator()(KDEType* kde) const
+{
+  if (!kde)
+    throw std::runtime_error("no KDE model initialized");
+
+  kde->Train(std::move(referenceSet));
+}
+
+//! Estimate the densities at the query points.
+template<typename KDEType>
+void EvaluateVisitor::operator()(KDEType* kde) const
+{
+  if (!kde)
+    throw std::runtime_error("no KDE model initialized");
+
+  kde->Evaluate(std::move(querySet), estimations);
+}
+
+//! Estimate the densities at the reference points.
+template<typename KDEType>
+void MonoEvaluateVisitor::operator()(KDEType* kde) const
+{
+  if (!kde)
+    throw std::runtime_error("no KDE model initialized");
+
+  kde->Evaluate(estimations);
+}
+
+//! Set the parameters of the model on the KDE object.
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ParametersVisitor::operator()(KDEType<KernelType, TreeType>* kde) const
+{
+  if (!kde)
+    throw std::runtime_error("no KDE model initialized");
+
+  kde->Kernel() = KernelType(model.Bandwidth());
+  kde->RelativeError() = model.RelativeError();
+  kde->AbsoluteError() = model.AbsoluteError();
+  kde->Mode() = model.Mode();
+  kde->MonteCarlo() = model.MonteCarlo();
+  kde->MCProb() = model.MCProb();
+  kde->MCInitialSampleSize() = model.MCInitialSampleSize();
+  kde->MCEntryCoefficient() = model.MCEntryCoefficient();
+  kde->MCBreakCoefficient() = model.MCBreakCoefficient();
+}
+
+//! Copy the KDE object.
+template<typename VariantType>
+template<typename KDEType>
+VariantType CopyVisitor<VariantType>::operator()(const KDEType* kde) const
+{
+  return kde ? new KDEType(*kde) : NULL;
+}
+
+//! Delete the KDE object.
+template<typename KDEType>
+void DeleteVisitor::operator()(KDEType* kde) const
+{
+  if (kde)
+    delete kde;
+}
+
+inline KDEModel::KDEModel(const double bandwidth,
+                          const double relError,
+                          const double absError,
+                          const KernelTypes kernelType,
+                          const TreeTypes treeType,
+                          const KDEMode mode,
+                          const bool monteCarlo,
+                          const double mcProb,
+                          const size_t initialSampleSize,
+                          const double mcEntryCoef,
+                          const double mcBreakCoef) :
+    bandwidth(bandwidth),
+    relError(relError),
+    absError(absError),
+    kernelType(kernelType),
+    treeType(treeType),
+    mode(mode),
+    monteCarlo(monteCarlo),
+    mcProb(mcProb),
+    initialSampleSize(initialSampleSize),
+    mcEntryCoef(mcEntryCoef),
+    mcBreakCoef(mcBreakCoef)
+{
+  // Nothing to do.
+}
+
+// Copy constructor.
+inline KDEModel::KDEModel(const KDEModel& other) :
+    bandwidth(other.bandwidth),
+    relError(other.relError),
+    absError(other.absError),
+    kernelType(other.kernelType),
+    treeType(other.treeType),
+    mode(other.mode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    kdeModel(boost::apply_visitor(CopyVisitor<KDEVariant>(), other.kdeModel))
+{
+  // Nothing to do.
+}
+
+// Move constructor.
+inline KDEModel::KDEModel(KDEModel&& other) :
+    bandwidth(other.bandwidth),
+    relError(other.relError),
+    absError(other.absError),
+    kernelType(other.kernelType),
+    treeType(other.treeType),
+    mode(other.mode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    kdeModel(std::move(other.kdeModel))
+{
+  // Reset other model.
+  other.kdeModel = decltype(other.kdeModel)();
+}
+
+// Copy operator.
+inline KDEModel& KDEModel::operator=(const KDEModel& other)
+{
+  if (this != &other)
+  {
+    KDEModel copy(other);
+    *this = std::move(copy);
+  }
+
+  return *this;
+}
+
+// Move operator.
+inline KDEModel& KDEModel::operator=(KDEModel&& other)
+{
+  if (this != &other)
+  {
+    CleanMemory();
+
+    bandwidth = other.bandwidth;
+    relError = other.relError;
+    absError = other.absError;
+    kernelType = other.kernelType;
+    treeType = other.treeType;
+    mode = other.mode;
+    monteCarlo = other.monteCarlo;
+    mcProb = other.mcProb;
+    initialSampleSize = other.initialSampleSize;
+    mcEntryCoef = other.mcEntryCoef;
+    mcBreakCoef = other.mcBreakCoef;
+    kdeModel = std::move(other.kdeModel);
+
+    // Reset other model.
+    other.kdeModel = decltype(other.kdeModel)();
+  }
+
+  return *this;
+}
+
+// Clean memory, if necessary.
+inline KDEModel::~KDEModel()
+{
+  CleanMemory();
+}
+
+inline void KDEModel::BuildModel(arma::mat&& referenceSet)
+{
+  // Clean memory, if necessary.
+  CleanMemory();
+
+  switch (kernelType)
+  {
+    case GAUSSIAN_KERNEL:
+      InitializeModel<kernel::GaussianKernel>();
+      break;
+    case EPANECHNIKOV_KERNEL:
+      InitializeModel<kernel::EpanechnikovKernel>();
+      break;
+    case LAPLACIAN_KERNEL:
+      InitializeModel<kernel::LaplacianKernel>();
+      break;
+    case SPHERICAL_KERNEL:
+      InitializeModel<kernel::SphericalKernel>();
+      break;
+    case TRIANGULAR_KERNEL:
+      InitializeModel<kernel::TriangularKernel>();
+      break;
+  }
+
+  Log::Info << "Building reference tree..." << std::endl;
+  boost::apply_visitor(TrainVisitor(std::move(referenceSet)), kdeModel);
+  Log::Info << "Tree built." << std::endl;
+}
+
+template<typename KDEKernelType>
+void KDEModel::InitializeModel()
+{
+  const KDEKernelType kernel(bandwidth);
+  switch (treeType)
+  {
+    case KD_TREE:
+      kdeModel = new KDEType<KDEKernelType, tree::KDTree>(relError, absError,
+          kernel, mode, monteCarlo, mcProb, initialSampleSize, mcEntryCoef,
+          mcBreakCoef);
+      break;
+    case BALL_TREE:
+      kdeModel = new KDEType<KDEKernelType, tree::BallTree>(relError, absError,
+          kernel, mode, monteCarlo, mcProb, initialSampleSize, mcEntryCoef,
+          mcBreakCoef);
+      break;
+    case OCTREE:
+      kdeModel = new KDEType<KDEKernelType, tree::Octree>(relError, absError,
+          kernel, mode, monteCarlo, mcProb, initialSampleSize, mcEntryCoef,
+          mcBreakCoef);
+      break;
+    case R_TREE:
+      kdeModel = new KDEType<KDEKernelType, tree::RTree>(relError, absError,
+          kernel, mode, monteCarlo, mcProb, initialSampleSize, mcEntryCoef,
+          mcBreakCoef);
+      break;
+  }
+}
+
+inline void KDEModel::Evaluate(arma::mat&& querySet, arma::vec& estimations)
+{
+  // The parameters may have changed since the model was built.
+  boost::apply_visitor(ParametersVisitor(*this), kdeModel);
+  boost::apply_visitor(EvaluateVisitor(std::move(querySet), estimations),
+      kdeModel);
+}
+
+inline void KDEModel::Evaluate(arma::vec& estimations)
+{
+  boost::apply_visitor(ParametersVisitor(*this), kdeModel);
+  boost::apply_visitor(MonoEvaluateVisitor(estimations), kdeModel);
+}
+
+inline void KDEModel::CleanMemory()
+{
+  boost::apply_visitor(DeleteVisitor(), kdeModel);
+  kdeModel = decltype(kdeModel)();
+}
+
+template<typename Archive>
+void KDEModel::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(bandwidth);
+  ar & BOOST_SERIALIZATION_NVP(relError);
+  ar & BOOST_SERIALIZATION_NVP(absError);
+  ar & BOOST_SERIALIZATION_NVP(kernelType);
+  ar & BOOST_SERIALIZATION_NVP(treeType);
+  ar & BOOST_SERIALIZATION_NVP(mode);
+  ar & BOOST_SERIALIZATION_NVP(monteCarlo);
+  ar & BOOST_SERIALIZATION_NVP(mcProb);
+  ar & BOOST_SERIALIZATION_NVP(initialSampleSize);
+  ar & BOOST_SERIALIZATION_NVP(mcEntryCoef);
+  ar & BOOST_SERIALIZATION_NVP(mcBreakCoef);
+
+  // This should never happen, but just in case...
+  if (Archive::is_loading::value)
+    CleanMemory();
+
+  ar & BOOST_SERIALIZATION_NVP(kdeModel);
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,281 @@
+/**
+ * @file kde_rules.hpp
+ *
+ * Rules for kernel density estimation, so that it can be done with arbitrary
+ * tree types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_RULES_HPP
+#define MLPACK_METHODS_KDE_KDE_RULES_HPP
+
+#include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/leaf_base_case.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <random>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * The KDERules class is a template helper class used by the KDE class to
+ * estimate the densities of the query points with a tree traversal.  The
+ * kernel values between a query (node) and a reference node are approximated
+ * by the middle of their bounds when the error of that is within the
+ * tolerance, or, if Monte Carlo estimation is enabled, by the mean of a sample
+ * of the reference points when the sample is large enough for the relative
+ * error to hold with the requested probability.
+ *
+ * Copies of a KDERules object add the densities to the same vector, so that
+ * several threads can estimate the densities of disjoint sets of query points.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam KernelType The kernel to estimate the densities with.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename MetricType, typename KernelType, typename TreeType>
+class KDERules
+{
+ public:
+  /**
+   * Construct the KDERules object.  This is usually done from within the KDE
+   * class at evaluation time.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param densities Vector to add the (unnormalized) densities to; it must
+   *     have one element per query point.
+   * @param accumErrors Unused error tolerance of each query point; it must have
+   *     one element per query point, and is only used when single query points
+   *     are scored.
+   * @param relError Relative error tolerance.
+   * @param absError Absolute error tolerance (per reference point).
+   * @param metric Instantiated metric.
+   * @param kernel Instantiated kernel.
+   * @param monteCarlo Whether to use Monte Carlo estimation.
+   * @param mcProb Probability that each Monte Carlo estimate is within the
+   *     relative error tolerance.
+   * @param initialSampleSize Size of the first sample of a Monte Carlo
+   *     estimate.
+   * @param mcEntryCoef Only reference nodes with at least mcEntryCoef *
+   *     initialSampleSize descendants are estimated with Monte Carlo.
+   * @param mcBreakCoef A Monte Carlo estimate is abandoned when it would need
+   *     more than mcBreakCoef times the descendants of the reference node.
+   */
+  KDERules(const typename TreeType::Mat& referenceSet,
+           const typename TreeType::Mat& querySet,
+           arma::vec& densities,
+           arma::vec& accumErrors,
+           const double relError,
+           const double absError,
+           MetricType& metric,
+           KernelType& kernel,
+           const bool monteCarlo = false,
+           const double mcProb = 0.95,
+           const size_t initialSampleSize = 100,
+           const double mcEntryCoef = 3.0,
+           const double mcBreakCoef = 0.4);
+
+  /**
+   * Compute the base case between the given query point and reference point,
+   * and add the kernel value to the density of the query point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Compute the base cases between all points of two leaves at once, with the
+   * batch Evaluate() function of the kernel.  This is only done for kernels
+   * that have one, the Euclidean distance, dense matrices and large enough
+   * leaves; otherwise false is returned, and the base cases must be computed
+   * one by one.
+   *
+   * @param queryNode Query leaf.
+   * @param referenceNode Reference leaf.
+   */
+  bool LeafBaseCase(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Compute the base cases between a block of consecutive query points and a
+   * block of consecutive reference points.  The batch Evaluate() function of
+   * the kernel is used if it can be.
+   *
+   * @param queryBegin Index of the first query point.
+   * @param queryCount Number of query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BlockBaseCases(const size_t queryBegin,
+                      const size_t queryCount,
+                      const size_t referenceBegin,
+                      const size_t referenceCount);
+
+  /**
+   * Get the score for recursion order.  If the kernel values between the query
+   * point and the reference node can be approximated, they are added to the
+   * density of the query point, and DBL_MAX is returned (the node is pruned).
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  The approximations do not
+   * depend on the other recursions, so this returns the old score.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  /**
+   * Get the score for recursion order.  If the kernel values between the query
+   * node and the reference node can be approximated, they are added to the
+   * densities of the query points, and DBL_MAX is returned (the combination is
+   * pruned).
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  The approximations do not
+   * depend on the other recursions, so this returns the old score.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
+
+  //! Get the number of scores.
+  size_t Scores() const { return scores; }
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
+
+ private:
+  //! Whether blocks of base cases are evaluated with the batch Evaluate()
+  //! function of the kernel.  The batch functions take Euclidean distances.
+  static const bool BatchKernels =
+      mlpack::kernel::KernelTraits<KernelType>::HasBatchEvaluate &&
+      std::is_same<MetricType, mlpack::metric::EuclideanDistance>::value &&
+      std::is_same<typename TreeType::Mat, arma::mat>::value;
+
+  //! Evaluate a block of base cases with the batch Evaluate() function.
+  void BlockBaseCases(const size_t queryBegin,
+                      const size_t queryCount,
+                      const size_t referenceBegin,
+                      const size_t referenceCount,
+                      std::true_type /* batchKernels */);
+
+  //! Evaluate a block of base cases one by one.
+  void BlockBaseCases(const size_t queryBegin,
+                      const size_t queryCount,
+                      const size_t referenceBegin,
+                      const size_t referenceCount,
+                      std::false_type /* batchKernels */);
+
+  /**
+   * Estimate the sum of the kernel values between the query point and the
+   * descendants of the reference node from a sample of the descendants.  The
+   * sample grows until its size guarantees the relative error with probability
+   * mcProb; the estimation fails if it would need more than mcBreakCoef times
+   * the descendants.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Reference node.
+   * @param estimate The estimated sum of the kernel values.
+   * @return Whether the estimation succeeded.
+   */
+  bool MonteCarloEstimate(const size_t queryIndex,
+                          TreeType& referenceNode,
+                          double& estimate);
+
+  //! Whether Monte Carlo estimation may be used for the reference node.
+  bool UseMonteCarlo(const TreeType& referenceNode) const;
+
+  //! The reference set.
+  const typename TreeType::Mat& referenceSet;
+
+  //! The query set.
+  const typename TreeType::Mat& querySet;
+
+  //! The densities of the query points.
+  arma::vec& densities;
+
+  //! The unused error tolerance of each query point.
+  arma::vec& accumErrors;
+
+  //! The relative error tolerance.
+  double relError;
+
+  //! The absolute error tolerance.
+  double absError;
+
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The instantiated kernel.
+  KernelType& kernel;
+
+  //! Whether Monte Carlo estimation is used.
+  bool monteCarlo;
+
+  //! The quantile of the normal distribution for the Monte Carlo probability.
+  double mcQuantile;
+
+  //! The size of the first sample of a Monte Carlo estimate.
+  size_t initialSampleSize;
+
+  //! The minimum size of the nodes estimated with Monte Carlo, relative to
+  //! initialSampleSize.
+  double mcEntryCoef;
+
+  //! The maximum size of a Monte Carlo sample, relative to the size of the
+  //! node.
+  double mcBreakCoef;
+
+  //! The random number generator of the Monte Carlo samples.
+  std::mt19937 generator;
+
+  //! The estimates of each query descendant, for dual-tree Monte Carlo.
+  std::vector<double> estimates;
+
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_rules_impl.hpp"
+
+#endif
@@ -0,0 +1,320 @@
+/**
+ * @file kde_rules_impl.hpp
+ *
+ * Implementation of rules for kernel density estimation with generic trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_RULES_IMPL_HPP
+#define MLPACK_METHODS_KDE_KDE_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_rules.hpp"
+
+#include <boost/math/distributions/normal.hpp>
+
+namespace mlpack {
+namespace kde {
+
+template<typename MetricType, typename KernelType, typename TreeType>
+KDERules<MetricType, KernelType, TreeType>::KDERules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    arma::vec& densities,
+    arma::vec& accumErrors,
+    const double relError,
+    const double absError,
+    MetricType& metric,
+    KernelType& kernel,
+    const bool monteCarlo,
+    const double mcProb,
+    const size_t initialSampleSize,
+    const double mcEntryCoef,
+    const double mcBreakCoef) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    densities(densities),
+    accumErrors(accumErrors),
+    relError(relError),
+    absError(absError),
+    metric(metric),
+    kernel(kernel),
+    monteCarlo(monteCarlo),
+    mcQuantile(0.0),
+    initialSampleSize(initialSampleSize),
+    mcEntryCoef(mcEntryCoef),
+    mcBreakCoef(mcBreakCoef),
+    generator(math::RandInt(std::numeric_limits<int>::max())),
+    baseCases(0),
+    scores(0)
+{
+  // Each estimate must be within the relative error with probability mcProb,
+  // so the quantile is of the two-sided interval.
+  if (monteCarlo)
+  {
+    const boost::math::normal normal;
+    mcQuantile = boost::math::quantile(normal, 1.0 - (1.0 - mcProb) / 2.0);
+  }
+}
+
+//! The base case.  Evaluate the kernel between the two points and add it to
+//! the density of the query point.
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline
+double KDERules<MetricType, KernelType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
+      referenceSet.unsafe_col(referenceIndex));
+  densities[queryIndex] += kernel.Evaluate(distance);
+  ++baseCases;
+
+  return distance;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::LeafBaseCase(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  const size_t queryCount = queryNode.NumPoints();
+  const size_t referenceCount = referenceNode.NumPoints();
+  if (!BatchKernels ||
+      queryCount * referenceCount < tree::minimumLeafBaseCases)
+    return false;
+
+  BlockBaseCases(queryNode.Point(0), queryCount, referenceNode.Point(0),
+      referenceCount);
+
+  // The kernel values were computed exactly, so each query point keeps its
+  // error tolerance for later approximations.
+  const double errorTolerance = relError * kernel.Evaluate(
+      queryNode.MaxDistance(referenceNode)) + absError;
+  queryNode.Stat().AccumError() += 2 * referenceCount * errorTolerance;
+
+  return true;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::BlockBaseCases(
+    const size_t queryBegin,
+    const size_t queryCount,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  BlockBaseCases(queryBegin, queryCount, referenceBegin, referenceCount,
+      std::integral_constant<bool, BatchKernels>());
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::BlockBaseCases(
+    const size_t queryBegin,
+    const size_t queryCount,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    std::true_type /* batchKernels */)
+{
+  arma::mat kernels;
+  kernel.Evaluate(querySet.cols(queryBegin, queryBegin + queryCount - 1),
+      referenceSet.cols(referenceBegin, referenceBegin + referenceCount - 1),
+      kernels);
+  densities.subvec(queryBegin, queryBegin + queryCount - 1) +=
+      arma::sum(kernels, 1);
+
+  baseCases += queryCount * referenceCount;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::BlockBaseCases(
+    const size_t queryBegin,
+    const size_t queryCount,
+    const size_t referenceBegin,
+    const size_t referenceCount,
+    std::false_type /* batchKernels */)
+{
+  for (size_t i = queryBegin; i < queryBegin + queryCount; ++i)
+    for (size_t j = referenceBegin; j < referenceBegin + referenceCount; ++j)
+      BaseCase(i, j);
+}
+
+//! Single-tree scoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  const math::Range distances = referenceNode.RangeDistance(
+      querySet.unsafe_col(queryIndex));
+  ++scores;
+
+  const double maxKernel = kernel.Evaluate(distances.Lo());
+  const double minKernel = kernel.Evaluate(distances.Hi());
+  const double bound = maxKernel - minKernel;
+  const double errorTolerance = relError * minKernel + absError;
+  const size_t refNumDesc = referenceNode.NumDescendants();
+
+  // Approximating every kernel value by the middle of the bounds makes an error
+  // of at most bound / 2 per reference point; the unused tolerance of the
+  // query point (kept doubled, like the bound) may be spent on it.
+  if (refNumDesc * bound <= accumErrors[queryIndex] +
+      2 * refNumDesc * errorTolerance)
+  {
+    densities[queryIndex] += refNumDesc * (maxKernel + minKernel) / 2.0;
+    accumErrors[queryIndex] -= refNumDesc * (bound - 2 * errorTolerance);
+    return DBL_MAX;
+  }
+
+  double estimate;
+  if (UseMonteCarlo(referenceNode) &&
+      MonteCarloEstimate(queryIndex, referenceNode, estimate))
+  {
+    densities[queryIndex] += estimate;
+    return DBL_MAX;
+  }
+
+  // The base cases with a leaf are exact, so their tolerance is kept.
+  if (referenceNode.IsLeaf())
+    accumErrors[queryIndex] += 2 * refNumDesc * errorTolerance;
+
+  return distances.Lo();
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Rescore(
+    const size_t /* queryIndex */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  return oldScore;
+}
+
+//! Dual-tree scoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  const math::Range distances = queryNode.RangeDistance(referenceNode);
+  ++scores;
+
+  const double maxKernel = kernel.Evaluate(distances.Lo());
+  const double minKernel = kernel.Evaluate(distances.Hi());
+  const double bound = maxKernel - minKernel;
+  const double errorTolerance = relError * minKernel + absError;
+  const size_t refNumDesc = referenceNode.NumDescendants();
+  double& accumError = queryNode.Stat().AccumError();
+
+  // The bounds hold for every query descendant, and so does the unused
+  // tolerance of the query node.
+  if (refNumDesc * bound <= accumError + 2 * refNumDesc * errorTolerance)
+  {
+    const double sum = refNumDesc * (maxKernel + minKernel) / 2.0;
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+      densities[queryNode.Descendant(i)] += sum;
+    accumError -= refNumDesc * (bound - 2 * errorTolerance);
+    return DBL_MAX;
+  }
+
+  // The combination is only pruned if every query descendant can be
+  // estimated.
+  if (UseMonteCarlo(referenceNode))
+  {
+    const size_t queryNumDesc = queryNode.NumDescendants();
+    estimates.resize(queryNumDesc);
+
+    bool success = true;
+    for (size_t i = 0; i < queryNumDesc && success; ++i)
+    {
+      success = MonteCarloEstimate(queryNode.Descendant(i), referenceNode,
+          estimates[i]);
+    }
+
+    if (success)
+    {
+      for (size_t i = 0; i < queryNumDesc; ++i)
+        densities[queryNode.Descendant(i)] += estimates[i];
+      return DBL_MAX;
+    }
+  }
+
+  return distances.Lo();
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Rescore(
+    TreeType& /* queryNode */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  return oldScore;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::MonteCarloEstimate(
+    const size_t queryIndex,
+    TreeType& referenceNode,
+    double& estimate)
+{
+  const size_t refNumDesc = referenceNode.NumDescendants();
+  const double maxSamples = mcBreakCoef * refNumDesc;
+  std::uniform_int_distribution<size_t> sampler(0, refNumDesc - 1);
+
+  double sum = 0.0, squaredSum = 0.0;
+  size_t samples = 0;
+  size_t requiredSamples = initialSampleSize;
+  while (true)
+  {
+    for (; samples < requiredSamples; ++samples)
+    {
+      const size_t referenceIndex = referenceNode.Descendant(
+          sampler(generator));
+      const double value = kernel.Evaluate(metric.Evaluate(
+          querySet.unsafe_col(queryIndex),
+          referenceSet.unsafe_col(referenceIndex)));
+      sum += value;
+      squaredSum += value * value;
+      ++baseCases;
+    }
+
+    // The relative error cannot be bounded if every sampled value is zero.
+    const double mean = sum / samples;
+    if (mean <= 0.0)
+      return false;
+
+    // The number of samples for the mean to be within the relative error with
+    // the requested probability, by the central limit theorem.
+    const double variance = std::max(squaredSum - samples * mean * mean, 0.0) /
+        (samples - 1);
+    const double needed = std::pow(mcQuantile * std::sqrt(variance) *
+        (1.0 + relError) / (relError * mean), 2.0);
+
+    if (needed <= samples)
+    {
+      estimate = refNumDesc * mean;
+      return true;
+    }
+    else if (needed > maxSamples)
+    {
+      return false;
+    }
+
+    requiredSamples = (size_t) std::ceil(needed);
+  }
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::UseMonteCarlo(
+    const TreeType& referenceNode) const
+{
+  return monteCarlo && (referenceNode.NumDescendants() >=
+      mcEntryCoef * initialSampleSize);
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file kde_stat.hpp
+ *
+ * Defines the KDEStat class, the tree statistic of kernel density estimation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_KDE_STAT_HPP
+#define MLPACK_METHODS_KDE_KDE_STAT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * Statistic class for KDE, to be set to the StatisticType of the tree type
+ * that kernel density estimation is performed with.  It holds the error
+ * tolerance that a query node has not used yet: when the kernel values between
+ * two leaves are computed exactly, the error they were allowed is kept here,
+ * and later approximations of the same query node may spend it.
+ */
+class KDEStat
+{
+ public:
+  /**
+   * Initialize the statistic.
+   */
+  KDEStat() : accumError(0.0) { }
+
+  /**
+   * Initialize the statistic given a tree node that this statistic belongs to.
+   * In this case, we ignore the node.
+   */
+  template<typename TreeType>
+  KDEStat(TreeType& /* node */) :
+      accumError(0.0) { }
+
+  //! Get the unused error tolerance.
+  double AccumError() const { return accumError; }
+  //! Modify the unused error tolerance.
+  double& AccumError() { return accumError; }
+
+  //! Serialize the statistic.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(accumError);
+  }
+
+ private:
+  //! The unused error tolerance, summed over the reference points.
+  double accumError;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -30,6 +30,7 @@
 #include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
 #include <mlpack/methods/nystroem_method/nystroem_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_features_method.hpp>
 
 #include "kernel_pca.hpp"
 
@@ -93,7 +94,14 @@ PROGRAM_INFO("Kernel Principal Components Analysis",
     "the kernel matrix; to specify the sampling scheme, the " +
     PRINT_PARAM_STRING("sampling") + " parameter is used.  The "
     "sampling scheme for the Nystr\u00F6m method can be chosen from the "
-    "following list: 'kmeans', 'random', 'ordered'.");
+    "following list: 'kmeans', 'random', 'ordered'."
+    "\n\n"
+    "For the 'gaussian' and 'laplacian' kernels, random Fourier features "
+    "(\"Random features for large-scale kernel machines\", 2008) can instead "
+    "be used by specifying the " + PRINT_PARAM_STRING("random_features") +
+    " parameter.  This maps the data to 1024 explicit features and performs "
+    "PCA on them, which is much faster than the other methods on large "
+    "datasets.");
 
 PARAM_MATRIX_IN_REQ("input", "Input dataset to perform KPCA on.", "i");
 PARAM_MATRIX_OUT("output", "Matrix to save modified dataset to.", "o");
@@ -109,6 +117,9 @@ PARAM_FLAG("center", "If set, the transformed data will be centered about the "
 
 PARAM_FLAG("nystroem_method", "If set, the nystroem method will be used.", "n");
 
+PARAM_FLAG("random_features", "If set, random Fourier features will be used "
+    "(only for the 'gaussian' and 'laplacian' kernels).", "r");
+
 PARAM_STRING_IN("sampling", "Sampling scheme to use for the nystroem method: "
     "'kmeans', 'random', 'ordered'", "s", "kmeans");
 
@@ -164,6 +175,18 @@ void RunKPCA(arma::mat& dataset,
   }
 }
 
+//! Run KPCA with random Fourier features for the given kernel type.
+template<typename KernelType>
+void RunRandomFeaturesKPCA(arma::mat& dataset,
+                           const bool centerTransformedData,
+                           const size_t newDim,
+                           KernelType& kernel)
+{
+  KernelPCA<KernelType, RandomFeaturesKernelRule<KernelType> > kpca(kernel,
+      centerTransformedData);
+  kpca.Apply(dataset, newDim);
+}
+
 static void mlpackMain()
 {
   RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
@@ -194,6 +217,20 @@ static void mlpackMain()
   const bool centerTransformedData = CLI::HasParam("center");
   const bool nystroem = CLI::HasParam("nystroem_method");
   const string sampling = CLI::GetParam<string>("sampling");
+  const bool randomFeatures = CLI::HasParam("random_features");
+
+  ReportIgnoredParam({{ "random_features", true }}, "sampling");
+  if (randomFeatures && nystroem)
+  {
+    Log::Fatal << "Cannot specify both "
+        << PRINT_PARAM_STRING("nystroem_method") << " and "
+        << PRINT_PARAM_STRING("random_features") << "!" << endl;
+  }
+  if (randomFeatures && kernelType != "gaussian" && kernelType != "laplacian")
+  {
+    Log::Fatal << "Random Fourier features are only available for the "
+        << "'gaussian' and 'laplacian' kernels!" << endl;
+  }
 
   if (kernelType == "linear")
   {
@@ -206,8 +243,16 @@ static void mlpackMain()
     const double bandwidth = CLI::GetParam<double>("bandwidth");
 
     GaussianKernel kernel(bandwidth);
-    RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    if (randomFeatures)
+    {
+      RunRandomFeaturesKPCA<GaussianKernel>(dataset, centerTransformedData,
+          newDim, kernel);
+    }
+    else
+    {
+      RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem,
+          newDim, sampling, kernel);
+    }
   }
   else if (kernelType == "polynomial")
   {
@@ -232,8 +277,16 @@ static void mlpackMain()
     const double bandwidth = CLI::GetParam<double>("bandwidth");
 
     LaplacianKernel kernel(bandwidth);
-    RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    if (randomFeatures)
+    {
+      RunRandomFeaturesKPCA<LaplacianKernel>(dataset, centerTransformedData,
+          newDim, kernel);
+    }
+    else
+    {
+      RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem,
+          newDim, sampling, kernel);
+    }
   }
   else if (kernelType == "epanechnikov")
   {
@@ -0,0 +1,282 @@
+/**
+ * @file random_features_method.hpp
+ *
+ * Use random Fourier features for approximating a shift-invariant kernel
+ * matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOM_FEATURES_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOM_FEATURES_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * The distribution of the frequencies of the random Fourier features of a
+ * kernel: the Fourier transform of K(x - y).  It is only defined for
+ * shift-invariant kernels; specialize this class to support another kernel.
+ */
+template<typename KernelType>
+class RandomFeaturesFrequencies
+{
+  static_assert(sizeof(KernelType) == 0, "random Fourier features are only "
+      "available for shift-invariant kernels (GaussianKernel and "
+      "LaplacianKernel)");
+};
+
+//! The frequencies of the Gaussian kernel are normally distributed.
+template<>
+class RandomFeaturesFrequencies<kernel::GaussianKernel>
+{
+ public:
+  static void Sample(const kernel::GaussianKernel& kernel,
+                     const size_t dimensionality,
+                     const size_t numFeatures,
+                     arma::mat& frequencies)
+  {
+    frequencies.randn(dimensionality, numFeatures);
+    frequencies /= kernel.Bandwidth();
+  }
+};
+
+//! The frequencies of the Laplacian kernel (of the Euclidean distance) follow a
+//! multivariate Cauchy distribution: normal vectors divided by the absolute
+//! value of a normal variable.
+template<>
+class RandomFeaturesFrequencies<kernel::LaplacianKernel>
+{
+ public:
+  static void Sample(const kernel::LaplacianKernel& kernel,
+                     const size_t dimensionality,
+                     const size_t numFeatures,
+                     arma::mat& frequencies)
+  {
+    frequencies.randn(dimensionality, numFeatures);
+    const arma::rowvec scales = kernel.Bandwidth() *
+        arma::abs(arma::randn<arma::rowvec>(numFeatures));
+    frequencies.each_row() /= scales;
+  }
+};
+
+/**
+ * An explicit, random feature map z(x) for a shift-invariant kernel, such that
+ * z(x)^T z(y) approximates K(x, y), as described in
+ *
+ * @code
+ * @inproceedings{rahimi2008random,
+ *   title={Random features for large-scale kernel machines},
+ *   author={Rahimi, A. and Recht, B.},
+ *   booktitle={Advances in Neural Information Processing Systems},
+ *   pages={1177--1184},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Each feature is sqrt(2 / D) cos(w^T x + b), where the frequency w is drawn
+ * from the Fourier transform of the kernel and b is uniform in [0, 2 pi].
+ *
+ * @tparam KernelType Type of the (shift-invariant) kernel.
+ */
+template<typename KernelType>
+class RandomFourierFeatures
+{
+ public:
+  //! Create an empty feature map.
+  RandomFourierFeatures() { }
+
+  /**
+   * Draw a feature map for the given kernel.
+   *
+   * @param kernel Kernel to approximate.
+   * @param dimensionality Dimensionality of the points.
+   * @param numFeatures Number of features (D).
+   */
+  RandomFourierFeatures(const KernelType& kernel,
+                        const size_t dimensionality,
+                        const size_t numFeatures)
+  {
+    RandomFeaturesFrequencies<KernelType>::Sample(kernel, dimensionality,
+        numFeatures, frequencies);
+    offsets = 2.0 * M_PI * arma::randu<arma::vec>(numFeatures);
+  }
+
+  /**
+   * Map the given points to their features (one column per point).
+   *
+   * @param data Points to map.
+   * @param features Matrix to store the features in.
+   */
+  void Map(const arma::mat& data, arma::mat& features) const
+  {
+    if (data.n_rows != frequencies.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "RandomFourierFeatures::Map(): the points have " << data.n_rows
+          << " dimensions, but the features were drawn for "
+          << frequencies.n_rows << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    features = frequencies.t() * data;
+
+    const double scale = std::sqrt(2.0 / frequencies.n_cols);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) features.n_cols; ++j)
+    {
+      double* column = features.colptr(j);
+      for (size_t i = 0; i < features.n_rows; ++i)
+        column[i] = scale * std::cos(column[i] + offsets[i]);
+    }
+  }
+
+  //! Get the number of features.
+  size_t NumFeatures() const { return frequencies.n_cols; }
+  //! Get the frequencies (one column per feature).
+  const arma::mat& Frequencies() const { return frequencies; }
+  //! Get the offsets (one per feature).
+  const arma::vec& Offsets() const { return offsets; }
+
+  //! Serialize the feature map.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(frequencies);
+    ar & BOOST_SERIALIZATION_NVP(offsets);
+  }
+
+ private:
+  //! The frequencies, one column per feature.
+  arma::mat frequencies;
+  //! The offsets, one per feature.
+  arma::vec offsets;
+};
+
+/**
+ * Approximate kernel PCA with random Fourier features: the points are mapped to
+ * NumFeatures explicit features, and the PCA of the features is computed
+ * instead of the eigendecomposition of the kernel matrix.  This takes
+ * O(n D^2) time and O(D^2) memory (plus the transformed data) instead of
+ * O(n^3) and O(n^2), since the nonzero eigenvalues of the centered
+ * (approximate) kernel matrix Z^T Z are the eigenvalues of Z Z^T.  The features
+ * are computed in blocks of points.
+ *
+ * The eigenvectors are the D x D eigenvectors of the feature covariance, so a
+ * new point x is projected with eigvec.t() * (z(x) - mean); use the overload of
+ * ApplyKernelMatrix() that returns the feature map and the mean to do that.
+ * Only the first rank dimensions of the transformed data are computed.
+ *
+ * This is only available for shift-invariant kernels (GaussianKernel and
+ * LaplacianKernel).
+ *
+ * @tparam KernelType Type of the kernel.
+ * @tparam NumFeatures Number of random features (D).
+ */
+template<typename KernelType, size_t NumFeatures = 1024>
+class RandomFeaturesKernelRule
+{
+ public:
+  /**
+   * Construct the kernel matrix approximation using random Fourier features.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param rank Number of dimensions of the transformed data.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                KernelType kernel = KernelType())
+  {
+    RandomFourierFeatures<KernelType> features;
+    arma::vec featureMean;
+    ApplyKernelMatrix(data, transformedData, eigval, eigvec, rank, kernel,
+        features, featureMean);
+  }
+
+  /**
+   * Construct the kernel matrix approximation using random Fourier features,
+   * and return the feature map and the mean of the features of the data, which
+   * are needed to project new points.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param rank Number of dimensions of the transformed data.
+   * @param kernel Kernel to be used for computation.
+   * @param features The feature map will be written to this object.
+   * @param featureMean The mean of the features will be written to this vector.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                const KernelType& kernel,
+                                RandomFourierFeatures<KernelType>& features,
+                                arma::vec& featureMean)
+  {
+    features = RandomFourierFeatures<KernelType>(kernel, data.n_rows,
+        NumFeatures);
+
+    // Accumulate the second moment and the mean of the features.
+    const size_t blockSize = 4096;
+    arma::mat moment(NumFeatures, NumFeatures, arma::fill::zeros);
+    featureMean.zeros(NumFeatures);
+    arma::mat block;
+    for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
+    {
+      const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+      features.Map(data.cols(begin, end - 1), block);
+      moment += block * block.t();
+      featureMean += arma::sum(block, 1);
+    }
+    featureMean /= std::max((size_t) data.n_cols, (size_t) 1);
+
+    // Eigendecompose the centered second moment, which has the same nonzero
+    // eigenvalues as the centered kernel matrix.
+    moment -= data.n_cols * featureMean * featureMean.t();
+    moment = 0.5 * (moment + moment.t());
+    arma::eig_sym(eigval, eigvec, moment);
+
+    // Swap the eigenvalues since they are ordered backwards (we need largest
+    // to smallest).
+    eigval = arma::flipud(eigval);
+    eigvec = arma::fliplr(eigvec);
+
+    // Project the centered features onto the principal components.
+    const size_t dimensions = (rank == 0) ? NumFeatures :
+        std::min(rank, NumFeatures);
+    const arma::mat components = eigvec.head_cols(dimensions);
+    const arma::vec meanProjection = components.t() * featureMean;
+    // The transformed data may be the input data, so it is written last.
+    arma::mat transformed(dimensions, data.n_cols);
+    for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
+    {
+      const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+      features.Map(data.cols(begin, end - 1), block);
+      transformed.cols(begin, end - 1) = components.t() * block;
+      transformed.cols(begin, end - 1).each_col() -= meanProjection;
+    }
+    transformedData = std::move(transformed);
+  }
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file kernel_cache.hpp
+ *
+ * Defines the KernelCache class, an LRU cache of the columns of the kernel
+ * matrix of a dataset, for the SMO solver of the kernel SVM.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_KERNEL_CACHE_HPP
+#define MLPACK_METHODS_KERNEL_SVM_KERNEL_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include <list>
+
+namespace mlpack {
+namespace svm {
+
+/**
+ * The KernelCache class holds the most recently used columns of the kernel
+ * matrix K(x_i, x_j) of a dataset, within a memory budget.  A column is
+ * computed at once with kernel::KernelMatrixRule, so with the batch Evaluate()
+ * function of the kernel when it has one, and in parallel otherwise.  When the
+ * budget is exceeded, the least recently used columns are evicted.  The
+ * diagonal of the kernel matrix is always kept.
+ *
+ * A column may be computed only for its first elements: the SMO solver only
+ * needs the elements of the points that are not shrunk, which it keeps at the
+ * front of the dataset with Swap(), and the rest of the column is computed
+ * when it is needed.
+ *
+ * @tparam KernelType Type of the kernel.
+ */
+template<typename KernelType>
+class KernelCache
+{
+ public:
+  /**
+   * Create the cache of the kernel matrix of the given dataset, which is
+   * copied.  The cache holds at least two full columns, even if that exceeds
+   * the given size.
+   *
+   * @param data Dataset, one point per column.
+   * @param kernel The kernel to evaluate.
+   * @param cacheSize Size of the cache, in megabytes.
+   */
+  KernelCache(const arma::mat& data,
+              KernelType& kernel,
+              const double cacheSize);
+
+  /**
+   * Return column i of the kernel matrix, with at least its first length
+   * elements computed.  The returned memory stays valid while at most one
+   * other column is requested, and until the next call to Swap().
+   *
+   * @param i Index of the column.
+   * @param length Number of elements of the column that are needed.
+   */
+  const double* Column(const size_t i, const size_t length);
+
+  //! Get K(x_i, x_i).
+  double Diagonal(const size_t i) const { return diagonal[i]; }
+
+  /**
+   * Swap points i and j of the dataset, in the dataset and in the cached
+   * columns.  The columns that don't hold both elements are evicted.
+   *
+   * @param i Index of the first point.
+   * @param j Index of the second point.
+   */
+  void Swap(size_t i, size_t j);
+
+  //! Get the number of calls to Column() that didn't compute any element.
+  size_t Hits() const { return hits; }
+  //! Get the number of calls to Column() that computed elements.
+  size_t Misses() const { return misses; }
+
+ private:
+  //! A column of the kernel matrix.
+  struct Entry
+  {
+    //! The computed elements of the column.
+    arma::vec values;
+    //! The number of computed elements (0 if the column is not cached).
+    size_t length;
+    //! The position of the column in the list of cached columns.
+    std::list<size_t>::iterator position;
+  };
+
+  //! Remove the given column from the cache.
+  void Evict(const size_t i);
+
+  //! The dataset.
+  arma::mat data;
+  //! The kernel.
+  KernelType& kernel;
+  //! The diagonal of the kernel matrix.
+  arma::vec diagonal;
+  //! The columns of the kernel matrix.
+  std::vector<Entry> entries;
+  //! The cached columns, from the most recently used to the least.
+  std::list<size_t> lru;
+  //! The maximum number of cached elements.
+  size_t capacity;
+  //! The number of cached elements.
+  size_t used;
+  //! The number of calls to Column() that didn't compute any element.
+  size_t hits;
+  //! The number of calls to Column() that computed elements.
+  size_t misses;
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_cache_impl.hpp"
+
+#endif
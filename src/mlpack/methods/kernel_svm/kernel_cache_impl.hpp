@@ -0,0 +1,133 @@
+/**
+ * @file kernel_cache_impl.hpp
+ *
+ * Implementation of the LRU cache of kernel columns.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_KERNEL_CACHE_IMPL_HPP
+#define MLPACK_METHODS_KERNEL_SVM_KERNEL_CACHE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_cache.hpp"
+
+namespace mlpack {
+namespace svm {
+
+template<typename KernelType>
+KernelCache<KernelType>::KernelCache(const arma::mat& data,
+                                     KernelType& kernel,
+                                     const double cacheSize) :
+    data(data),
+    kernel(kernel),
+    diagonal(data.n_cols),
+    entries(data.n_cols),
+    capacity(std::max((size_t) (cacheSize * 1024.0 * 1024.0 / sizeof(double)),
+        (size_t) 2 * data.n_cols)),
+    used(0),
+    hits(0),
+    misses(0)
+{
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    diagonal[i] = kernel.Evaluate(this->data.unsafe_col(i),
+        this->data.unsafe_col(i));
+  }
+
+  for (size_t i = 0; i < entries.size(); ++i)
+    entries[i].length = 0;
+}
+
+template<typename KernelType>
+const double* KernelCache<KernelType>::Column(const size_t i,
+                                              const size_t length)
+{
+  Entry& entry = entries[i];
+  if (entry.length > 0)
+  {
+    // Move the column to the front of the list.
+    lru.splice(lru.begin(), lru, entry.position);
+    if (entry.length >= length)
+    {
+      ++hits;
+      return entry.values.memptr();
+    }
+  }
+  else
+  {
+    lru.push_front(i);
+    entry.position = lru.begin();
+  }
+
+  ++misses;
+
+  // Make room for the new elements, without evicting the column itself.
+  const size_t start = entry.length;
+  while (used + (length - start) > capacity && lru.back() != i)
+    Evict(lru.back());
+
+  // Compute the missing elements as one kernel row.
+  const arma::mat point(data.colptr(i), data.n_rows, 1, false, true);
+  const arma::mat points(data.colptr(start), data.n_rows, length - start,
+      false, true);
+  arma::mat row;
+  kernel::KernelMatrixRule<KernelType>::Evaluate(point, points, kernel, row);
+
+  entry.values.resize(length);
+  entry.values.subvec(start, length - 1) = row.t();
+  used += length - start;
+  entry.length = length;
+
+  return entry.values.memptr();
+}
+
+template<typename KernelType>
+void KernelCache<KernelType>::Swap(size_t i, size_t j)
+{
+  if (i == j)
+    return;
+  if (i > j)
+    std::swap(i, j);
+
+  data.swap_cols(i, j);
+  std::swap(diagonal[i], diagonal[j]);
+
+  // Swap the columns themselves.
+  entries[i].values.swap(entries[j].values);
+  std::swap(entries[i].length, entries[j].length);
+  std::swap(entries[i].position, entries[j].position);
+  if (entries[i].length > 0)
+    *entries[i].position = i;
+  if (entries[j].length > 0)
+    *entries[j].position = j;
+
+  // Then swap the elements of every column.
+  std::list<size_t>::iterator it = lru.begin();
+  while (it != lru.end())
+  {
+    Entry& entry = entries[*it++];
+    if (entry.length > j)
+      std::swap(entry.values[i], entry.values[j]);
+    else if (entry.length > i)
+      Evict(*entry.position);
+  }
+}
+
+template<typename KernelType>
+void KernelCache<KernelType>::Evict(const size_t i)
+{
+  Entry& entry = entries[i];
+  lru.erase(entry.position);
+  used -= entry.length;
+  entry.values.reset();
+  entry.length = 0;
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif
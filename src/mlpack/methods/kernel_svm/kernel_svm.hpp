@@ -0,0 +1,227 @@
+/**
+ * @file kernel_svm.hpp
+ *
+ * A kernel support vector machine trained with sequential minimal optimization,
+ * for binary and one-vs-one multiclass classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_HPP
+#define MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include "smo.hpp"
+
+namespace mlpack {
+namespace svm {
+
+/**
+ * A kernel support vector machine (C-SVC), whose decision function between two
+ * classes is
+ * \f[ f(x) = \sum_i \alpha_i y_i K(x_i, x) + b, \f]
+ * where the dual variables alpha minimize the dual problem of the hinge loss
+ * weighted by C; it is solved by the SMO class, with the second order working
+ * set selection, shrinking and the LRU kernel cache of libsvm:
+ *
+ * @code
+ * @article{chang2011libsvm,
+ *   title={LIBSVM: A library for support vector machines},
+ *   author={Chang, C.-C. and Lin, C.-J.},
+ *   journal={ACM Transactions on Intelligent Systems and Technology},
+ *   volume={2},
+ *   number={3},
+ *   pages={27:1--27:27},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * With two classes, one classifier separates class 1 from class 0; with more
+ * classes, one classifier is trained for each pair of classes (one-vs-one) on
+ * the points of these two classes only, the classifiers are trained in
+ * parallel, and a point is assigned to the class that wins the most pairs
+ * (the smallest such class in case of a tie).  The kernel cache size is shared
+ * by the classifiers that are trained at the same time.
+ *
+ * The support vectors of all the classifiers are stored once, so predicting a
+ * point evaluates the kernel once per support vector; the kernel evaluations
+ * between the support vectors and a block of points are computed with
+ * kernel::KernelMatrixRule, so with the batch Evaluate() function of the
+ * kernel when its KernelTraits declare one.
+ *
+ * @tparam KernelType Type of the kernel.
+ */
+template<typename KernelType = kernel::GaussianKernel>
+class KernelSVM
+{
+ public:
+  /**
+   * Create the model without training it.
+   *
+   * @param c Cost of the misclassifications (the regularization is 1 / C).
+   * @param tolerance Tolerance on the violation of the optimality conditions
+   *     of the dual problem.
+   * @param shrinking Whether to shrink the active set of the solver.
+   * @param cacheSize Size of the kernel cache, in megabytes.
+   * @param maxIterations Maximum number of iterations of the solver for each
+   *     classifier (0 means no limit).
+   * @param kernel The kernel to use.
+   */
+  KernelSVM(const double c = 1.0,
+            const double tolerance = 1e-3,
+            const bool shrinking = true,
+            const double cacheSize = 100.0,
+            const size_t maxIterations = 0,
+            const KernelType kernel = KernelType());
+
+  /**
+   * Create the model and train it on the given data.
+   *
+   * @param data Training points, one per column.
+   * @param labels Labels of the points, between 0 and numClasses - 1.
+   * @param numClasses Number of classes (at least 2).
+   * @param c Cost of the misclassifications (the regularization is 1 / C).
+   * @param tolerance Tolerance on the violation of the optimality conditions
+   *     of the dual problem.
+   * @param shrinking Whether to shrink the active set of the solver.
+   * @param cacheSize Size of the kernel cache, in megabytes.
+   * @param maxIterations Maximum number of iterations of the solver for each
+   *     classifier (0 means no limit).
+   * @param kernel The kernel to use.
+   */
+  KernelSVM(const arma::mat& data,
+            const arma::Row<size_t>& labels,
+            const size_t numClasses,
+            const double c = 1.0,
+            const double tolerance = 1e-3,
+            const bool shrinking = true,
+            const double cacheSize = 100.0,
+            const size_t maxIterations = 0,
+            const KernelType kernel = KernelType());
+
+  /**
+   * Train the model on the given data.  Any previous model is replaced.
+   *
+   * @param data Training points, one per column.
+   * @param labels Labels of the points, between 0 and numClasses - 1.
+   * @param numClasses Number of classes (at least 2).
+   */
+  void Train(const arma::mat& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses);
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Points to classify, one per column.
+   * @param labels Row vector to store the predicted classes in.
+   */
+  void Classify(const arma::mat& data, arma::Row<size_t>& labels) const;
+
+  /**
+   * Classify the given points, and also return their decision values: one row
+   * per pair of classes (a, b) with a < b, in lexicographic order, where a
+   * positive value is a vote for b (so a single row for two classes, where a
+   * positive value means class 1).
+   *
+   * @param data Points to classify, one per column.
+   * @param labels Row vector to store the predicted classes in.
+   * @param scores Matrix to store the decision values in.
+   */
+  void Classify(const arma::mat& data,
+                arma::Row<size_t>& labels,
+                arma::mat& scores) const;
+
+  /**
+   * Compute the accuracy of the model on the given points, as the percentage
+   * of points that are classified correctly.
+   *
+   * @param data Points to classify, one per column.
+   * @param labels True labels of the points.
+   */
+  double ComputeAccuracy(const arma::mat& data,
+                         const arma::Row<size_t>& labels) const;
+
+  //! Get the cost of the misclassifications.
+  double C() const { return c; }
+  //! Modify the cost of the misclassifications.
+  double& C() { return c; }
+
+  //! Get the tolerance of the solver.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the solver.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether the solver shrinks the active set.
+  bool Shrinking() const { return shrinking; }
+  //! Modify whether the solver shrinks the active set.
+  bool& Shrinking() { return shrinking; }
+
+  //! Get the size of the kernel cache, in megabytes.
+  double CacheSize() const { return cacheSize; }
+  //! Modify the size of the kernel cache, in megabytes.
+  double& CacheSize() { return cacheSize; }
+
+  //! Get the maximum number of iterations for each classifier.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations for each classifier.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the kernel.
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the support vectors of all the classifiers, one per column.
+  const arma::mat& SupportVectors() const { return supportVectors; }
+  //! Get the coefficients alpha_i y_i of the support vectors, one column per
+  //! classifier.
+  const arma::mat& Coefficients() const { return coefficients; }
+  //! Get the biases, one per classifier.
+  const arma::vec& Biases() const { return biases; }
+  //! Get the number of iterations of each classifier during the last training.
+  const arma::Col<size_t>& Iterations() const { return iterations; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The cost of the misclassifications.
+  double c;
+  //! The tolerance of the solver.
+  double tolerance;
+  //! Whether the solver shrinks the active set.
+  bool shrinking;
+  //! The size of the kernel cache, in megabytes.
+  double cacheSize;
+  //! The maximum number of iterations for each classifier.
+  size_t maxIterations;
+  //! The kernel.
+  KernelType kernel;
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The support vectors, one per column.
+  arma::mat supportVectors;
+  //! The coefficients of the support vectors, one column per classifier.
+  arma::mat coefficients;
+  //! The biases, one per classifier.
+  arma::vec biases;
+  //! The number of iterations of each classifier during the last training.
+  arma::Col<size_t> iterations;
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_svm_impl.hpp"
+
+#endif
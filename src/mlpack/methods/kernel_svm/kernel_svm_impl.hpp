@@ -0,0 +1,296 @@
+/**
+ * @file kernel_svm_impl.hpp
+ *
+ * Implementation of the kernel support vector machine.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_IMPL_HPP
+#define MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_svm.hpp"
+
+namespace mlpack {
+namespace svm {
+
+template<typename KernelType>
+KernelSVM<KernelType>::KernelSVM(const double c,
+                                 const double tolerance,
+                                 const bool shrinking,
+                                 const double cacheSize,
+                                 const size_t maxIterations,
+                                 const KernelType kernel) :
+    c(c),
+    tolerance(tolerance),
+    shrinking(shrinking),
+    cacheSize(cacheSize),
+    maxIterations(maxIterations),
+    kernel(kernel),
+    numClasses(0)
+{ /* Nothing to do. */ }
+
+template<typename KernelType>
+KernelSVM<KernelType>::KernelSVM(const arma::mat& data,
+                                 const arma::Row<size_t>& labels,
+                                 const size_t numClasses,
+                                 const double c,
+                                 const double tolerance,
+                                 const bool shrinking,
+                                 const double cacheSize,
+                                 const size_t maxIterations,
+                                 const KernelType kernel) :
+    c(c),
+    tolerance(tolerance),
+    shrinking(shrinking),
+    cacheSize(cacheSize),
+    maxIterations(maxIterations),
+    kernel(kernel),
+    numClasses(0)
+{
+  Train(data, labels, numClasses);
+}
+
+template<typename KernelType>
+void KernelSVM<KernelType>::Train(const arma::mat& data,
+                                  const arma::Row<size_t>& labels,
+                                  const size_t numClasses)
+{
+  if (labels.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "KernelSVM::Train(): the number of labels (" << labels.n_elem
+        << ") does not match the number of points (" << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("KernelSVM::Train(): there must be at least "
+        "two classes!");
+  }
+  if (labels.n_elem > 0 && arma::max(labels) >= numClasses)
+  {
+    std::ostringstream oss;
+    oss << "KernelSVM::Train(): label " << arma::max(labels) << " is not "
+        << "less than the number of classes (" << numClasses << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (c <= 0.0)
+    throw std::invalid_argument("KernelSVM::Train(): C must be positive!");
+  if (cacheSize <= 0.0)
+  {
+    throw std::invalid_argument("KernelSVM::Train(): the cache size must be "
+        "positive!");
+  }
+
+  this->numClasses = numClasses;
+
+  std::vector<std::vector<size_t>> classPoints(numClasses);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    classPoints[labels[i]].push_back(i);
+
+  // One classifier per pair of classes (a, b), with a < b.
+  std::vector<std::pair<size_t, size_t>> pairs;
+  for (size_t a = 0; a < numClasses; ++a)
+    for (size_t b = a + 1; b < numClasses; ++b)
+      pairs.push_back(std::make_pair(a, b));
+  const size_t numModels = pairs.size();
+
+  // The classifiers that are trained at the same time share the cache size.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  const double modelCacheSize = cacheSize /
+      std::min(std::max(numThreads, (size_t) 1), numModels);
+
+  // The coefficients alpha_i y_i of each classifier, in the order of the
+  // points of class a and then of class b.
+  std::vector<arma::vec> modelCoefficients(numModels);
+  biases.zeros(numModels);
+  iterations.zeros(numModels);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t m = 0; m < (omp_size_t) numModels; ++m)
+  {
+    const std::vector<size_t>& pointsA = classPoints[pairs[m].first];
+    const std::vector<size_t>& pointsB = classPoints[pairs[m].second];
+    const size_t n = pointsA.size() + pointsB.size();
+
+    // Without the points of one of the classes, the classifier always votes
+    // for the other.
+    if (pointsA.empty() || pointsB.empty())
+    {
+      modelCoefficients[m].zeros(n);
+      biases[m] = pointsB.empty() ? -1.0 : 1.0;
+      continue;
+    }
+
+    // Class b has the positive label.
+    arma::mat modelData(data.n_rows, n);
+    arma::vec y(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      const bool inB = (i >= pointsA.size());
+      const size_t point = inB ? pointsB[i - pointsA.size()] : pointsA[i];
+      modelData.col(i) = data.col(point);
+      y[i] = inB ? 1.0 : -1.0;
+    }
+
+    KernelType modelKernel(kernel);
+    SMO<KernelType> smo(c, tolerance, shrinking, modelCacheSize,
+        maxIterations);
+    arma::vec alpha;
+    iterations[m] = smo.Optimize(modelData, y, modelKernel, alpha, biases[m]);
+    modelCoefficients[m] = alpha % y;
+  }
+
+  for (size_t m = 0; m < numModels; ++m)
+  {
+    if (maxIterations != 0 && iterations[m] >= maxIterations)
+    {
+      Log::Warn << "KernelSVM::Train(): the classifier of classes "
+          << pairs[m].first << " and " << pairs[m].second << " reached the "
+          << "maximum number of iterations (" << maxIterations << ") before "
+          << "converging." << std::endl;
+    }
+  }
+
+  // Store each point that is a support vector of any classifier once, in the
+  // order of the dataset.
+  std::vector<size_t> supportIndex(data.n_cols, 0);
+  std::vector<char> isSupport(data.n_cols, 0);
+  for (size_t m = 0; m < numModels; ++m)
+  {
+    const std::vector<size_t>& pointsA = classPoints[pairs[m].first];
+    const std::vector<size_t>& pointsB = classPoints[pairs[m].second];
+    for (size_t i = 0; i < modelCoefficients[m].n_elem; ++i)
+    {
+      if (modelCoefficients[m][i] != 0.0)
+      {
+        isSupport[(i < pointsA.size()) ? pointsA[i] :
+            pointsB[i - pointsA.size()]] = 1;
+      }
+    }
+  }
+
+  size_t numSupport = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+    if (isSupport[i])
+      supportIndex[i] = numSupport++;
+
+  supportVectors.set_size(data.n_rows, numSupport);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    if (isSupport[i])
+      supportVectors.col(supportIndex[i]) = data.col(i);
+
+  coefficients.zeros(numSupport, numModels);
+  for (size_t m = 0; m < numModels; ++m)
+  {
+    const std::vector<size_t>& pointsA = classPoints[pairs[m].first];
+    const std::vector<size_t>& pointsB = classPoints[pairs[m].second];
+    for (size_t i = 0; i < modelCoefficients[m].n_elem; ++i)
+    {
+      if (modelCoefficients[m][i] != 0.0)
+      {
+        const size_t point = (i < pointsA.size()) ? pointsA[i] :
+            pointsB[i - pointsA.size()];
+        coefficients(supportIndex[point], m) = modelCoefficients[m][i];
+      }
+    }
+  }
+}
+
+template<typename KernelType>
+void KernelSVM<KernelType>::Classify(const arma::mat& data,
+                                     arma::Row<size_t>& labels) const
+{
+  arma::mat scores;
+  Classify(data, labels, scores);
+}
+
+template<typename KernelType>
+void KernelSVM<KernelType>::Classify(const arma::mat& data,
+                                     arma::Row<size_t>& labels,
+                                     arma::mat& scores) const
+{
+  if (data.n_rows != supportVectors.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KernelSVM::Classify(): the points have " << data.n_rows
+        << " dimensions, but the model was trained on " << supportVectors.n_rows
+        << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Evaluate the kernel between the support vectors and blocks of points, to
+  // bound the memory of the kernel matrix.
+  const size_t blockSize = 1024;
+  KernelType blockKernel(kernel);
+  scores.zeros(biases.n_elem, data.n_cols);
+  if (supportVectors.n_cols > 0)
+  {
+    for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
+    {
+      const size_t count = std::min(blockSize, (size_t) data.n_cols - begin);
+      const arma::mat block(const_cast<double*>(data.colptr(begin)),
+          data.n_rows, count, false, true);
+      arma::mat kernels;
+      kernel::KernelMatrixRule<KernelType>::Evaluate(supportVectors, block,
+          blockKernel, kernels);
+      scores.cols(begin, begin + count - 1) = coefficients.t() * kernels;
+    }
+  }
+  scores.each_col() += biases;
+
+  // Each classifier votes for one class of its pair.
+  labels.set_size(data.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    std::vector<size_t> votes(numClasses, 0);
+    size_t m = 0;
+    for (size_t a = 0; a < numClasses; ++a)
+      for (size_t b = a + 1; b < numClasses; ++b, ++m)
+        ++votes[(scores(m, i) > 0.0) ? b : a];
+
+    labels[i] = std::max_element(votes.begin(), votes.end()) - votes.begin();
+  }
+}
+
+template<typename KernelType>
+double KernelSVM<KernelType>::ComputeAccuracy(
+    const arma::mat& data,
+    const arma::Row<size_t>& labels) const
+{
+  arma::Row<size_t> predictions;
+  Classify(data, predictions);
+
+  const size_t correct = arma::accu(predictions == labels);
+  return (100.0 * correct) / std::max((size_t) labels.n_elem, (size_t) 1);
+}
+
+template<typename KernelType>
+template<typename Archive>
+void KernelSVM<KernelType>::serialize(Archive& ar,
+                                      const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(c);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(shrinking);
+  ar & BOOST_SERIALIZATION_NVP(cacheSize);
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(kernel);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(supportVectors);
+  ar & BOOST_SERIALIZATION_NVP(coefficients);
+  ar & BOOST_SERIALIZATION_NVP(biases);
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * @file kernel_svm_main.cpp
+ *
+ * Main executable for the kernel support vector machine.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "kernel_svm_model.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::svm;
+using namespace mlpack::kernel;
+using namespace mlpack::util;
+
+PROGRAM_INFO("Kernel Support Vector Machine",
+    "An implementation of the kernel support vector machine (SVM, or C-SVC), "
+    "trained with sequential minimal optimization as in libsvm: the working "
+    "set is selected with second order information, the solver shrinks the "
+    "points that are unlikely to move, and the most recently used kernel "
+    "columns are kept in a cache."
+    "\n\n"
+    "This program allows training a kernel SVM model on a training set "
+    "(specified with the " + PRINT_PARAM_STRING("training") + " parameter) or "
+    "loading an existing model (with the " +
+    PRINT_PARAM_STRING("input_model") + " parameter), and classifying a test "
+    "set (specified with the " + PRINT_PARAM_STRING("test") + " parameter); "
+    "the predictions may be saved with the " + PRINT_PARAM_STRING("output") +
+    " output parameter, the decision values with the " +
+    PRINT_PARAM_STRING("output_scores") + " output parameter, and the trained "
+    "model with the " + PRINT_PARAM_STRING("output_model") + " output "
+    "parameter."
+    "\n\n"
+    "The training data may have the labels as its last dimension, or the "
+    "labels can be given separately with the " + PRINT_PARAM_STRING("labels") +
+    " parameter.  The labels must be between 0 and the number of classes minus "
+    "one.  With two classes, a single classifier separates class 1 from class "
+    "0; with more classes, one classifier per pair of classes is trained in "
+    "parallel (one-vs-one), and each point is assigned to the class with the "
+    "most votes."
+    "\n\n"
+    "The kernels that are supported are listed below:"
+    "\n\n"
+    " * 'linear': the standard linear dot product:\n"
+    "    K(x, y) = x^T y\n"
+    "\n"
+    " * 'gaussian': a Gaussian kernel; requires bandwidth:\n"
+    "    K(x, y) = exp(-(|| x - y || ^ 2) / (2 * (bandwidth ^ 2)))\n"
+    "\n"
+    " * 'polynomial': polynomial kernel; requires offset and degree:\n"
+    "    K(x, y) = (x^T y + offset) ^ degree\n"
+    "\n"
+    " * 'hyptan': hyperbolic tangent kernel; requires scale and offset:\n"
+    "    K(x, y) = tanh(scale * (x^T y) + offset)\n"
+    "\n"
+    " * 'laplacian': Laplacian kernel; requires bandwidth:\n"
+    "    K(x, y) = exp(-(|| x - y ||) / bandwidth)\n"
+    "\n"
+    "The parameters for each of the kernels should be specified with the "
+    "options " + PRINT_PARAM_STRING("bandwidth") + ", " +
+    PRINT_PARAM_STRING("kernel_scale") + ", " +
+    PRINT_PARAM_STRING("offset") + ", or " + PRINT_PARAM_STRING("degree") +
+    " (or a combination of those parameters)."
+    "\n\n"
+    "The cost of the misclassifications is set with " +
+    PRINT_PARAM_STRING("c") + ".  The optimization stops when the violation "
+    "of the optimality conditions of the dual problem is below " +
+    PRINT_PARAM_STRING("tolerance") + ", or after " +
+    PRINT_PARAM_STRING("max_iterations") + " iterations.  The size of the "
+    "kernel cache, shared by the classifiers that are trained at the same "
+    "time, is set in megabytes with " + PRINT_PARAM_STRING("cache_size") +
+    ", and shrinking is disabled with " + PRINT_PARAM_STRING("no_shrinking") +
+    "."
+    "\n\n"
+    "As an example, to train a kernel SVM with a Gaussian kernel of bandwidth "
+    "0.5 on the data '" + PRINT_DATASET("data") + "' with labels '" +
+    PRINT_DATASET("labels") + "' and C = 10, saving the model to '" +
+    PRINT_MODEL("svm_model") + "', the following command may be used:"
+    "\n\n" +
+    PRINT_CALL("kernel_svm", "training", "data", "labels", "labels", "kernel",
+        "gaussian", "bandwidth", 0.5, "c", 10.0, "output_model", "svm_model") +
+    "\n\n"
+    "Then, to use that model to predict the classes of the dataset '" +
+    PRINT_DATASET("test") + "', storing the predictions in '" +
+    PRINT_DATASET("predictions") + "', the following command may be used:"
+    "\n\n" +
+    PRINT_CALL("kernel_svm", "input_model", "svm_model", "test", "test",
+        "output", "predictions"));
+
+// Training parameters.
+PARAM_MATRIX_IN("training", "A matrix containing the training set.", "t");
+PARAM_UROW_IN("labels", "A matrix containing the labels of the points in the "
+    "training set.", "l");
+
+// Kernel parameters.
+PARAM_STRING_IN("kernel", "The kernel to use; see the above documentation for "
+    "the list of usable kernels.", "k", "gaussian");
+PARAM_DOUBLE_IN("kernel_scale", "Scale, for 'hyptan' kernel.", "S", 1.0);
+PARAM_DOUBLE_IN("offset", "Offset, for 'hyptan' and 'polynomial' kernels.", "O",
+    0.0);
+PARAM_DOUBLE_IN("bandwidth", "Bandwidth, for 'gaussian' and 'laplacian' "
+    "kernels.", "b", 1.0);
+PARAM_DOUBLE_IN("degree", "Degree of polynomial, for 'polynomial' kernel.", "D",
+    2.0);
+
+// Solver parameters.
+PARAM_DOUBLE_IN("c", "Cost of the misclassifications (the regularization is "
+    "1 / C).", "c", 1.0);
+PARAM_DOUBLE_IN("tolerance", "Tolerance on the violation of the optimality "
+    "conditions of the dual problem.", "e", 1e-3);
+PARAM_INT_IN("max_iterations", "Maximum number of iterations for each "
+    "classifier (0 indicates no limit).", "n", 0);
+PARAM_DOUBLE_IN("cache_size", "Size of the kernel cache, in megabytes.", "C",
+    100.0);
+PARAM_FLAG("no_shrinking", "Do not shrink the active set of the solver.", "H");
+
+// Model loading/saving.
+PARAM_MODEL_IN(KernelSVMModel, "input_model", "Existing model.", "m");
+PARAM_MODEL_OUT(KernelSVMModel, "output_model", "Output for the trained kernel "
+    "SVM model.", "M");
+
+// Testing.
+PARAM_MATRIX_IN("test", "Matrix containing the test dataset.", "T");
+PARAM_UROW_OUT("output", "If test data is specified, this matrix is where "
+    "the predictions for the test set will be saved.", "o");
+PARAM_MATRIX_OUT("output_scores", "If test data is specified, this matrix is "
+    "where the decision values of the test set will be saved (one row per "
+    "pair of classes).", "p");
+
+// Train the model with the given kernel and the parameters given on the
+// command line.
+template<typename KernelType>
+static void TrainModel(KernelSVMModel& model,
+                       const arma::mat& data,
+                       const arma::Row<size_t>& labels,
+                       const size_t numClasses,
+                       const KernelType& kernel)
+{
+  Timer::Start("kernel_svm_training");
+  model.Train(data, labels, numClasses, kernel, CLI::GetParam<double>("c"),
+      CLI::GetParam<double>("tolerance"), !CLI::HasParam("no_shrinking"),
+      CLI::GetParam<double>("cache_size"),
+      (size_t) CLI::GetParam<int>("max_iterations"));
+  Timer::Stop("kernel_svm_training");
+}
+
+static void mlpackMain()
+{
+  // Exactly one of the training set and the input model must be given.
+  RequireOnlyOnePassed({ "training", "input_model" }, true);
+  ReportIgnoredParam({{ "training", false }}, "labels");
+  ReportIgnoredParam({{ "training", false }}, "kernel");
+
+  if (CLI::HasParam("training"))
+  {
+    RequireAtLeastOnePassed({ "output_model" }, false, "trained model will not "
+        "be saved");
+  }
+  RequireAtLeastOnePassed({ "output_model", "output", "output_scores" }, false,
+      "no output will be saved");
+
+  ReportIgnoredParam({{ "test", false }}, "output");
+  ReportIgnoredParam({{ "test", false }}, "output_scores");
+
+  RequireParamInSet<string>("kernel", { "linear", "gaussian", "polynomial",
+      "hyptan", "laplacian" }, true, "unknown kernel type");
+  RequireParamValue<double>("c", [](double x) { return x > 0.0; }, true,
+      "C must be positive");
+  RequireParamValue<double>("tolerance", [](double x) { return x > 0.0; },
+      true, "tolerance must be positive");
+  RequireParamValue<double>("cache_size", [](double x) { return x > 0.0; },
+      true, "cache size must be positive");
+  RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
+      "max_iterations must be positive or zero");
+
+  KernelSVMModel* model;
+  if (CLI::HasParam("input_model"))
+  {
+    model = CLI::GetParam<KernelSVMModel*>("input_model");
+  }
+  else
+  {
+    model = new KernelSVMModel();
+
+    arma::mat data = std::move(CLI::GetParam<arma::mat>("training"));
+    arma::Row<size_t> labels;
+    if (CLI::HasParam("labels"))
+    {
+      labels = std::move(CLI::GetParam<arma::Row<size_t>>("labels"));
+    }
+    else
+    {
+      if (data.n_rows < 2)
+      {
+        delete model;
+        Log::Fatal << "Can't get labels from training data since it has "
+            << "less than 2 rows." << endl;
+      }
+
+      labels = arma::conv_to<arma::Row<size_t>>::from(
+          data.row(data.n_rows - 1));
+      data.shed_row(data.n_rows - 1);
+    }
+
+    if (labels.n_elem != data.n_cols)
+    {
+      delete model;
+      Log::Fatal << "The labels must have the same number of points as the "
+          << "training dataset." << endl;
+    }
+
+    const size_t numClasses = std::max((size_t) arma::max(labels) + 1,
+        (size_t) 2);
+    const string kernelType = CLI::GetParam<string>("kernel");
+    if (kernelType == "linear")
+    {
+      TrainModel(*model, data, labels, numClasses, LinearKernel());
+    }
+    else if (kernelType == "gaussian")
+    {
+      TrainModel(*model, data, labels, numClasses,
+          GaussianKernel(CLI::GetParam<double>("bandwidth")));
+    }
+    else if (kernelType == "polynomial")
+    {
+      TrainModel(*model, data, labels, numClasses,
+          PolynomialKernel(CLI::GetParam<double>("degree"),
+          CLI::GetParam<double>("offset")));
+    }
+    else if (kernelType == "hyptan")
+    {
+      TrainModel(*model, data, labels, numClasses,
+          HyperbolicTangentKernel(CLI::GetParam<double>("kernel_scale"),
+          CLI::GetParam<double>("offset")));
+    }
+    else
+    {
+      TrainModel(*model, data, labels, numClasses,
+          LaplacianKernel(CLI::GetParam<double>("bandwidth")));
+    }
+  }
+
+  if (CLI::HasParam("test"))
+  {
+    const arma::mat testSet = std::move(CLI::GetParam<arma::mat>("test"));
+    const size_t trainingDimensionality = model->Dimensionality();
+    if (testSet.n_rows != trainingDimensionality)
+    {
+      if (!CLI::HasParam("input_model"))
+        delete model;
+
+      Log::Fatal << "Test data dimensionality (" << testSet.n_rows << ") "
+          << "must be the same as the dimensionality of the training data ("
+          << trainingDimensionality << ")!" << endl;
+    }
+
+    Log::Info << "Classifying points in '"
+        << CLI::GetPrintableParam<arma::mat>("test") << "'." << endl;
+
+    arma::Row<size_t> predictions;
+    arma::mat scores;
+    Timer::Start("kernel_svm_classification");
+    model->Classify(testSet, predictions, scores);
+    Timer::Stop("kernel_svm_classification");
+
+    if (CLI::HasParam("output"))
+      CLI::GetParam<arma::Row<size_t>>("output") = std::move(predictions);
+    if (CLI::HasParam("output_scores"))
+      CLI::GetParam<arma::mat>("output_scores") = std::move(scores);
+  }
+
+  CLI::GetParam<KernelSVMModel*>("output_model") = model;
+}
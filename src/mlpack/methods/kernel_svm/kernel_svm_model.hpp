@@ -0,0 +1,212 @@
+/**
+ * @file kernel_svm_model.hpp
+ *
+ * A model that holds a KernelSVM with one of the supported kernels, for the
+ * kernel_svm binding.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_MODEL_HPP
+#define MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_MODEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/kernels/polynomial_kernel.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+#include <mlpack/core/kernels/hyperbolic_tangent_kernel.hpp>
+#include <boost/variant.hpp>
+#include "kernel_svm.hpp"
+
+namespace mlpack {
+namespace svm {
+
+/**
+ * ClassifyVisitor classifies points with the given KernelSVM.
+ */
+class ClassifyVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Classify the points with the given KernelSVM object.
+  template<typename SVMType>
+  void operator()(const SVMType* svm) const;
+
+  //! Construct the ClassifyVisitor with the given points and outputs.
+  ClassifyVisitor(const arma::mat& data,
+                  arma::Row<size_t>& labels,
+                  arma::mat& scores) :
+      data(data),
+      labels(labels),
+      scores(scores)
+  { }
+
+ private:
+  //! The points to classify.
+  const arma::mat& data;
+  //! The predicted classes.
+  arma::Row<size_t>& labels;
+  //! The decision values.
+  arma::mat& scores;
+};
+
+/**
+ * DimensionalityVisitor returns the dimensionality of the points that the
+ * given KernelSVM was trained on.
+ */
+class DimensionalityVisitor : public boost::static_visitor<size_t>
+{
+ public:
+  //! Return the dimensionality of the given KernelSVM object.
+  template<typename SVMType>
+  size_t operator()(const SVMType* svm) const;
+};
+
+/**
+ * CopyVisitor returns a copy of the given KernelSVM.
+ */
+template<typename VariantType>
+class CopyVisitor : public boost::static_visitor<VariantType>
+{
+ public:
+  //! Copy the given KernelSVM object.
+  template<typename SVMType>
+  VariantType operator()(const SVMType* svm) const;
+};
+
+/**
+ * DeleteVisitor deletes the given KernelSVM.
+ */
+class DeleteVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Delete the KernelSVM object.
+  template<typename SVMType>
+  void operator()(SVMType* svm) const;
+};
+
+/**
+ * The KernelSVMModel holds a KernelSVM for one of the supported kernels, so
+ * that the kernel can be chosen at run time (for instance, by the kernel_svm
+ * binding).
+ */
+class KernelSVMModel
+{
+ public:
+  //! The supported kernels.
+  enum KernelTypes
+  {
+    LINEAR_KERNEL,
+    POLYNOMIAL_KERNEL,
+    GAUSSIAN_KERNEL,
+    LAPLACIAN_KERNEL,
+    HYPTAN_KERNEL
+  };
+
+ private:
+  //! The KernelSVM types for each kernel.
+  typedef boost::variant<KernelSVM<kernel::LinearKernel>*,
+                         KernelSVM<kernel::PolynomialKernel>*,
+                         KernelSVM<kernel::GaussianKernel>*,
+                         KernelSVM<kernel::LaplacianKernel>*,
+                         KernelSVM<kernel::HyperbolicTangentKernel>*>
+      SVMVariant;
+
+ public:
+  //! Create an empty model; Train() must be called before Classify().
+  KernelSVMModel();
+
+  //! Copy the given KernelSVMModel.
+  KernelSVMModel(const KernelSVMModel& other);
+
+  //! Take ownership of the given KernelSVMModel.
+  KernelSVMModel(KernelSVMModel&& other);
+
+  //! Copy the given KernelSVMModel.
+  KernelSVMModel& operator=(const KernelSVMModel& other);
+
+  //! Take ownership of the given KernelSVMModel.
+  KernelSVMModel& operator=(KernelSVMModel&& other);
+
+  //! Clean memory.
+  ~KernelSVMModel();
+
+  /**
+   * Train a KernelSVM with the given kernel and parameters, which replaces
+   * the current one.  See the KernelSVM class for the meaning of the
+   * parameters.
+   *
+   * @param data Training points, one per column.
+   * @param labels Labels of the points, between 0 and numClasses - 1.
+   * @param numClasses Number of classes (at least 2).
+   * @param kernel The kernel to use.
+   * @param c Cost of the misclassifications.
+   * @param tolerance Tolerance of the solver.
+   * @param shrinking Whether the solver shrinks the active set.
+   * @param cacheSize Size of the kernel cache, in megabytes.
+   * @param maxIterations Maximum number of iterations for each classifier.
+   */
+  template<typename KernelType>
+  void Train(const arma::mat& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const KernelType& kernel,
+             const double c,
+             const double tolerance,
+             const bool shrinking,
+             const double cacheSize,
+             const size_t maxIterations);
+
+  /**
+   * Classify the given points, and return their decision values; see
+   * KernelSVM::Classify().
+   *
+   * @param data Points to classify, one per column.
+   * @param labels Row vector to store the predicted classes in.
+   * @param scores Matrix to store the decision values in.
+   */
+  void Classify(const arma::mat& data,
+                arma::Row<size_t>& labels,
+                arma::mat& scores) const;
+
+  //! Get the dimensionality of the training points.
+  size_t Dimensionality() const;
+
+  //! Get the type of kernel.
+  KernelTypes KernelType() const { return kernelType; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Get the entry of KernelTypes of each kernel.
+  static KernelTypes TypeOf(const kernel::LinearKernel&)
+  { return LINEAR_KERNEL; }
+  static KernelTypes TypeOf(const kernel::PolynomialKernel&)
+  { return POLYNOMIAL_KERNEL; }
+  static KernelTypes TypeOf(const kernel::GaussianKernel&)
+  { return GAUSSIAN_KERNEL; }
+  static KernelTypes TypeOf(const kernel::LaplacianKernel&)
+  { return LAPLACIAN_KERNEL; }
+  static KernelTypes TypeOf(const kernel::HyperbolicTangentKernel&)
+  { return HYPTAN_KERNEL; }
+
+  //! Delete the KernelSVM.
+  void CleanMemory();
+
+  //! The type of kernel.
+  KernelTypes kernelType;
+  //! The KernelSVM for the current kernel type.
+  SVMVariant svm;
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_svm_model_impl.hpp"
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file kernel_svm_model_impl.hpp
+ *
+ * Implementation of the visitors and inline functions of KernelSVMModel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_MODEL_IMPL_HPP
+#define MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_MODEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_svm_model.hpp"
+
+#include <boost/serialization/variant.hpp>
+
+namespace mlpack {
+namespace svm {
+
+//! Classify the points.
+template<typename SVMType>
+void ClassifyVisitor::operator()(const SVMType* svm) const
+{
+  if (!svm)
+    throw std::runtime_error("no kernel SVM model initialized");
+
+  svm->Classify(data, labels, scores);
+}
+
+//! Return the dimensionality of the training points.
+template<typename SVMType>
+size_t DimensionalityVisitor::operator()(const SVMType* svm) const
+{
+  if (!svm)
+    throw std::runtime_error("no kernel SVM model initialized");
+
+  return svm->SupportVectors().n_rows;
+}
+
+//! Copy the KernelSVM object.
+template<typename VariantType>
+template<typename SVMType>
+VariantType CopyVisitor<VariantType>::operator()(const SVMType* svm) const
+{
+  return svm ? new SVMType(*svm) : NULL;
+}
+
+//! Delete the KernelSVM object.
+template<typename SVMType>
+void DeleteVisitor::operator()(SVMType* svm) const
+{
+  if (svm)
+    delete svm;
+}
+
+inline KernelSVMModel::KernelSVMModel() :
+    kernelType(LINEAR_KERNEL),
+    svm(static_cast<KernelSVM<kernel::LinearKernel>*>(NULL))
+{
+  // Nothing to do.
+}
+
+// Copy constructor.
+inline KernelSVMModel::KernelSVMModel(const KernelSVMModel& other) :
+    kernelType(other.kernelType),
+    svm(boost::apply_visitor(CopyVisitor<SVMVariant>(), other.svm))
+{
+  // Nothing to do.
+}
+
+// Move constructor.
+inline KernelSVMModel::KernelSVMModel(KernelSVMModel&& other) :
+    kernelType(other.kernelType),
+    svm(other.svm)
+{
+  // Leave the other model empty.
+  other.kernelType = LINEAR_KERNEL;
+  other.svm = static_cast<KernelSVM<kernel::LinearKernel>*>(NULL);
+}
+
+// Copy assignment operator.
+inline KernelSVMModel& KernelSVMModel::operator=(const KernelSVMModel& other)
+{
+  if (this != &other)
+  {
+    CleanMemory();
+    kernelType = other.kernelType;
+    svm = boost::apply_visitor(CopyVisitor<SVMVariant>(), other.svm);
+  }
+
+  return *this;
+}
+
+// Move assignment operator.
+inline KernelSVMModel& KernelSVMModel::operator=(KernelSVMModel&& other)
+{
+  if (this != &other)
+  {
+    CleanMemory();
+    kernelType = other.kernelType;
+    svm = other.svm;
+
+    other.kernelType = LINEAR_KERNEL;
+    other.svm = static_cast<KernelSVM<kernel::LinearKernel>*>(NULL);
+  }
+
+  return *this;
+}
+
+inline KernelSVMModel::~KernelSVMModel()
+{
+  CleanMemory();
+}
+
+template<typename KernelType>
+void KernelSVMModel::Train(const arma::mat& data,
+                           const arma::Row<size_t>& labels,
+                           const size_t numClasses,
+                           const KernelType& kernel,
+                           const double c,
+                           const double tolerance,
+                           const bool shrinking,
+                           const double cacheSize,
+                           const size_t maxIterations)
+{
+  KernelSVM<KernelType>* newSVM = new KernelSVM<KernelType>(c, tolerance,
+      shrinking, cacheSize, maxIterations, kernel);
+  try
+  {
+    newSVM->Train(data, labels, numClasses);
+  }
+  catch (...)
+  {
+    delete newSVM;
+    throw;
+  }
+
+  CleanMemory();
+  kernelType = TypeOf(kernel);
+  svm = newSVM;
+}
+
+inline void KernelSVMModel::Classify(const arma::mat& data,
+                                     arma::Row<size_t>& labels,
+                                     arma::mat& scores) const
+{
+  ClassifyVisitor classify(data, labels, scores);
+  boost::apply_visitor(classify, svm);
+}
+
+inline size_t KernelSVMModel::Dimensionality() const
+{
+  return boost::apply_visitor(DimensionalityVisitor(), svm);
+}
+
+template<typename Archive>
+void KernelSVMModel::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(kernelType);
+
+  // This should never happen, but just in case...
+  if (Archive::is_loading::value)
+    CleanMemory();
+
+  ar & BOOST_SERIALIZATION_NVP(svm);
+}
+
+inline void KernelSVMModel::CleanMemory()
+{
+  boost::apply_visitor(DeleteVisitor(), svm);
+  svm = static_cast<KernelSVM<kernel::LinearKernel>*>(NULL);
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif
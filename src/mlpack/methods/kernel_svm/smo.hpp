@@ -0,0 +1,207 @@
+/**
+ * @file smo.hpp
+ *
+ * Defines the SMO class, which solves the dual problem of a binary kernel SVM
+ * with sequential minimal optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_SMO_HPP
+#define MLPACK_METHODS_KERNEL_SVM_SMO_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kernel_cache.hpp"
+
+namespace mlpack {
+namespace svm {
+
+/**
+ * The SMO class solves the dual problem of the binary kernel SVM,
+ * \f[ \min_\alpha 0.5 \sum_{i,j} \alpha_i \alpha_j y_i y_j K(x_i, x_j) -
+ *     \sum_i \alpha_i \f]
+ * subject to \f$ 0 \le \alpha_i \le C \f$ and \f$ \sum_i y_i \alpha_i = 0 \f$,
+ * with the sequential minimal optimization of libsvm: each iteration updates
+ * the pair of dual variables chosen by the second order working set selection
+ * of
+ *
+ * @code
+ * @article{fan2005working,
+ *   title={Working set selection using second order information for training
+ *       support vector machines},
+ *   author={Fan, R.-E. and Chen, P.-H. and Lin, C.-J.},
+ *   journal={Journal of Machine Learning Research},
+ *   volume={6},
+ *   pages={1889--1918},
+ *   year={2005}
+ * }
+ * @endcode
+ *
+ * and the optimization stops when the maximal violation of the optimality
+ * conditions is below the tolerance.  The two kernel columns of each iteration
+ * come from a KernelCache of the given size.
+ *
+ * With shrinking, the points whose dual variable is at a bound and unlikely to
+ * move are periodically removed from the active set, so that the iterations
+ * only compute and update the kernel columns of the other points; before the
+ * optimization stops, the gradient of the shrunk points is reconstructed and
+ * the optimality of all the points is checked again.
+ *
+ * @tparam KernelType Type of the kernel.
+ */
+template<typename KernelType>
+class SMO
+{
+ public:
+  /**
+   * Create the solver with the given parameters.
+   *
+   * @param c Upper bound of the dual variables.
+   * @param tolerance Tolerance on the maximal violation of the optimality
+   *     conditions.
+   * @param shrinking Whether to shrink the active set.
+   * @param cacheSize Size of the kernel cache, in megabytes.
+   * @param maxIterations Maximum number of iterations (0 means no limit).
+   */
+  SMO(const double c = 1.0,
+      const double tolerance = 1e-3,
+      const bool shrinking = true,
+      const double cacheSize = 100.0,
+      const size_t maxIterations = 0);
+
+  /**
+   * Solve the dual problem on the given points.  Both labels must be present.
+   *
+   * @param data Training points, one per column.
+   * @param labels Labels of the points, -1 or +1.
+   * @param kernel The kernel to use.
+   * @param alpha Vector to store the dual variables in.
+   * @param bias Double to store the bias of the decision function
+   *     \f$ f(x) = \sum_i \alpha_i y_i K(x_i, x) + b \f$ in.
+   * @return Number of iterations.
+   */
+  size_t Optimize(const arma::mat& data,
+                  const arma::vec& labels,
+                  KernelType& kernel,
+                  arma::vec& alpha,
+                  double& bias);
+
+  //! Get the upper bound of the dual variables.
+  double C() const { return c; }
+  //! Modify the upper bound of the dual variables.
+  double& C() { return c; }
+
+  //! Get the tolerance on the violation of the optimality conditions.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance on the violation of the optimality conditions.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether the active set is shrunk.
+  bool Shrinking() const { return shrinking; }
+  //! Modify whether the active set is shrunk.
+  bool& Shrinking() { return shrinking; }
+
+  //! Get the size of the kernel cache, in megabytes.
+  double CacheSize() const { return cacheSize; }
+  //! Modify the size of the kernel cache, in megabytes.
+  double& CacheSize() { return cacheSize; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of kernel columns found in the cache during the last
+  //! optimization.
+  size_t CacheHits() const { return cacheHits; }
+  //! Get the number of kernel columns computed during the last optimization.
+  size_t CacheMisses() const { return cacheMisses; }
+
+ private:
+  //! Whether dual variable i is at its upper bound.
+  bool IsUpper(const size_t i) const { return alpha[i] >= c; }
+  //! Whether dual variable i is at its lower bound.
+  bool IsLower(const size_t i) const { return alpha[i] <= 0.0; }
+
+  /**
+   * Select the pair of dual variables to update with the second order working
+   * set selection, among the active points.
+   *
+   * @param cache The kernel cache.
+   * @param i Index of the first variable.
+   * @param j Index of the second variable.
+   * @return Whether a pair violates the optimality conditions by more than the
+   *     tolerance (otherwise the active points are optimal).
+   */
+  bool SelectWorkingSet(KernelCache<KernelType>& cache, size_t& i, size_t& j);
+
+  /**
+   * Minimize the dual along the given pair of variables, and update the
+   * gradient.
+   *
+   * @param cache The kernel cache.
+   * @param i Index of the first variable.
+   * @param j Index of the second variable.
+   */
+  void Update(KernelCache<KernelType>& cache, const size_t i, const size_t j);
+
+  //! Whether the given point is at a bound and unlikely to move, given the
+  //! maximal violations of the optimality conditions.
+  bool BeShrunk(const size_t i, const double gMax1, const double gMax2) const;
+
+  //! Remove the points that are unlikely to move from the active set.
+  void Shrink(KernelCache<KernelType>& cache);
+
+  //! Compute the gradient of the shrunk points.
+  void ReconstructGradient(KernelCache<KernelType>& cache);
+
+  //! Swap points i and j.
+  void Swap(KernelCache<KernelType>& cache, const size_t i, const size_t j);
+
+  //! Compute the bias of the decision function.
+  double Bias() const;
+
+  //! The upper bound of the dual variables.
+  double c;
+  //! The tolerance on the violation of the optimality conditions.
+  double tolerance;
+  //! Whether the active set is shrunk.
+  bool shrinking;
+  //! The size of the kernel cache, in megabytes.
+  double cacheSize;
+  //! The maximum number of iterations.
+  size_t maxIterations;
+
+  //! The number of kernel columns found in the cache.
+  size_t cacheHits;
+  //! The number of kernel columns computed.
+  size_t cacheMisses;
+
+  // The state of the optimization, in the order of the points in the cache.
+
+  //! The labels of the points.
+  arma::vec y;
+  //! The dual variables.
+  arma::vec alpha;
+  //! The gradient of the dual objective.
+  arma::vec gradient;
+  //! C times the sum of the columns of the points at the upper bound, which
+  //! gives the gradient of the shrunk points back.
+  arma::vec gradientBar;
+  //! The original index of each point.
+  std::vector<size_t> activeSet;
+  //! The number of active points, at the front.
+  size_t activeSize;
+  //! Whether the gradient was reconstructed to check the optimality.
+  bool unshrink;
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "smo_impl.hpp"
+
+#endif
@@ -0,0 +1,419 @@
+/**
+ * @file smo_impl.hpp
+ *
+ * Implementation of the SMO solver of the kernel SVM.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_SMO_IMPL_HPP
+#define MLPACK_METHODS_KERNEL_SVM_SMO_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "smo.hpp"
+
+namespace mlpack {
+namespace svm {
+
+template<typename KernelType>
+SMO<KernelType>::SMO(const double c,
+                     const double tolerance,
+                     const bool shrinking,
+                     const double cacheSize,
+                     const size_t maxIterations) :
+    c(c),
+    tolerance(tolerance),
+    shrinking(shrinking),
+    cacheSize(cacheSize),
+    maxIterations(maxIterations),
+    cacheHits(0),
+    cacheMisses(0),
+    activeSize(0),
+    unshrink(false)
+{ /* Nothing to do. */ }
+
+template<typename KernelType>
+size_t SMO<KernelType>::Optimize(const arma::mat& data,
+                                 const arma::vec& labels,
+                                 KernelType& kernel,
+                                 arma::vec& alphaOut,
+                                 double& bias)
+{
+  const size_t n = data.n_cols;
+  KernelCache<KernelType> cache(data, kernel, cacheSize);
+
+  // With all the dual variables at 0, the gradient is -1.
+  y = labels;
+  alpha.zeros(n);
+  gradient.set_size(n);
+  gradient.fill(-1.0);
+  gradientBar.zeros(n);
+  activeSet.resize(n);
+  for (size_t i = 0; i < n; ++i)
+    activeSet[i] = i;
+  activeSize = n;
+  unshrink = false;
+
+  size_t iteration = 0;
+  size_t counter = std::min(n, (size_t) 1000) + 1;
+  while (maxIterations == 0 || iteration < maxIterations)
+  {
+    if (--counter == 0)
+    {
+      counter = std::min(n, (size_t) 1000);
+      if (shrinking)
+        Shrink(cache);
+    }
+
+    size_t i, j;
+    if (!SelectWorkingSet(cache, i, j))
+    {
+      // The active points are optimal; check all the points.
+      ReconstructGradient(cache);
+      activeSize = n;
+      if (!SelectWorkingSet(cache, i, j))
+        break;
+
+      // Shrink again at the next iteration.
+      counter = 1;
+    }
+
+    ++iteration;
+    Update(cache, i, j);
+  }
+
+  if (activeSize < n)
+  {
+    ReconstructGradient(cache);
+    activeSize = n;
+  }
+
+  bias = Bias();
+  alphaOut.set_size(n);
+  for (size_t i = 0; i < n; ++i)
+    alphaOut[activeSet[i]] = alpha[i];
+
+  cacheHits = cache.Hits();
+  cacheMisses = cache.Misses();
+
+  return iteration;
+}
+
+template<typename KernelType>
+bool SMO<KernelType>::SelectWorkingSet(KernelCache<KernelType>& cache,
+                                       size_t& i,
+                                       size_t& j)
+{
+  // Smallest value of the quadratic coefficient of a pair.
+  const double tau = 1e-12;
+
+  // The first variable maximizes -y_t G_t among the variables that may move
+  // in the direction of y_t.
+  double gMax = -std::numeric_limits<double>::infinity();
+  bool found = false;
+  for (size_t t = 0; t < activeSize; ++t)
+  {
+    if (y[t] > 0.0 ? !IsUpper(t) : !IsLower(t))
+    {
+      const double value = -y[t] * gradient[t];
+      if (value >= gMax)
+      {
+        gMax = value;
+        i = t;
+        found = true;
+      }
+    }
+  }
+
+  if (!found)
+    return false;
+
+  // The second variable gives the largest decrease of the objective with the
+  // first, according to the second order approximation.
+  const double* kI = cache.Column(i, activeSize);
+  double gMax2 = -std::numeric_limits<double>::infinity();
+  double minDecrease = std::numeric_limits<double>::infinity();
+  found = false;
+  for (size_t t = 0; t < activeSize; ++t)
+  {
+    if (y[t] > 0.0 ? IsLower(t) : IsUpper(t))
+      continue;
+
+    const double value = y[t] * gradient[t];
+    gMax2 = std::max(gMax2, value);
+
+    const double gradientDiff = gMax + value;
+    if (gradientDiff > 0.0)
+    {
+      const double quad = cache.Diagonal(i) + cache.Diagonal(t) - 2.0 * kI[t];
+      const double decrease = -(gradientDiff * gradientDiff) /
+          std::max(quad, tau);
+      if (decrease <= minDecrease)
+      {
+        minDecrease = decrease;
+        j = t;
+        found = true;
+      }
+    }
+  }
+
+  return (gMax + gMax2 >= tolerance) && found;
+}
+
+template<typename KernelType>
+void SMO<KernelType>::Update(KernelCache<KernelType>& cache,
+                             const size_t i,
+                             const size_t j)
+{
+  const double tau = 1e-12;
+
+  const double* kI = cache.Column(i, activeSize);
+  const double* kJ = cache.Column(j, activeSize);
+  const double quad = std::max(cache.Diagonal(i) + cache.Diagonal(j) -
+      2.0 * kI[j], tau);
+
+  const double oldI = alpha[i];
+  const double oldJ = alpha[j];
+  const bool upperI = IsUpper(i);
+  const bool upperJ = IsUpper(j);
+
+  // Minimize along the pair, and clip the variables to the feasible segment.
+  if (y[i] != y[j])
+  {
+    const double delta = (-gradient[i] - gradient[j]) / quad;
+    const double diff = alpha[i] - alpha[j];
+    alpha[i] += delta;
+    alpha[j] += delta;
+
+    if (diff > 0.0)
+    {
+      if (alpha[j] < 0.0)
+      {
+        alpha[j] = 0.0;
+        alpha[i] = diff;
+      }
+    }
+    else if (alpha[i] < 0.0)
+    {
+      alpha[i] = 0.0;
+      alpha[j] = -diff;
+    }
+
+    if (diff > 0.0)
+    {
+      if (alpha[i] > c)
+      {
+        alpha[i] = c;
+        alpha[j] = c - diff;
+      }
+    }
+    else if (alpha[j] > c)
+    {
+      alpha[j] = c;
+      alpha[i] = c + diff;
+    }
+  }
+  else
+  {
+    const double delta = (gradient[i] - gradient[j]) / quad;
+    const double sum = alpha[i] + alpha[j];
+    alpha[i] -= delta;
+    alpha[j] += delta;
+
+    if (sum > c)
+    {
+      if (alpha[i] > c)
+      {
+        alpha[i] = c;
+        alpha[j] = sum - c;
+      }
+      if (alpha[j] > c)
+      {
+        alpha[j] = c;
+        alpha[i] = sum - c;
+      }
+    }
+    else
+    {
+      if (alpha[j] < 0.0)
+      {
+        alpha[j] = 0.0;
+        alpha[i] = sum;
+      }
+      if (alpha[i] < 0.0)
+      {
+        alpha[i] = 0.0;
+        alpha[j] = sum;
+      }
+    }
+  }
+
+  // Update the gradient of the active points: G_t += Q_ti dA_i + Q_tj dA_j,
+  // with Q_ts = y_t y_s K(x_t, x_s).
+  const double deltaI = (alpha[i] - oldI) * y[i];
+  const double deltaJ = (alpha[j] - oldJ) * y[j];
+  for (size_t t = 0; t < activeSize; ++t)
+    gradient[t] += y[t] * (deltaI * kI[t] + deltaJ * kJ[t]);
+
+  // Keep the contribution of the points at the upper bound, for the
+  // reconstruction of the gradient.
+  if (upperI != IsUpper(i))
+  {
+    const double* column = cache.Column(i, y.n_elem);
+    const double scale = (upperI ? -c : c) * y[i];
+    for (size_t t = 0; t < y.n_elem; ++t)
+      gradientBar[t] += scale * y[t] * column[t];
+  }
+  if (upperJ != IsUpper(j))
+  {
+    const double* column = cache.Column(j, y.n_elem);
+    const double scale = (upperJ ? -c : c) * y[j];
+    for (size_t t = 0; t < y.n_elem; ++t)
+      gradientBar[t] += scale * y[t] * column[t];
+  }
+}
+
+template<typename KernelType>
+bool SMO<KernelType>::BeShrunk(const size_t i,
+                               const double gMax1,
+                               const double gMax2) const
+{
+  // gMax1 is the maximal -y_t G_t of the variables that may move in the
+  // direction of y_t, and gMax2 the maximal y_t G_t of the others.
+  if (IsUpper(i))
+    return (y[i] > 0.0) ? (-gradient[i] > gMax1) : (-gradient[i] > gMax2);
+  else if (IsLower(i))
+    return (y[i] > 0.0) ? (gradient[i] > gMax2) : (gradient[i] > gMax1);
+
+  return false;
+}
+
+template<typename KernelType>
+void SMO<KernelType>::Shrink(KernelCache<KernelType>& cache)
+{
+  double gMax1 = -std::numeric_limits<double>::infinity();
+  double gMax2 = -std::numeric_limits<double>::infinity();
+  for (size_t t = 0; t < activeSize; ++t)
+  {
+    if (y[t] > 0.0)
+    {
+      if (!IsUpper(t))
+        gMax1 = std::max(gMax1, -gradient[t]);
+      if (!IsLower(t))
+        gMax2 = std::max(gMax2, gradient[t]);
+    }
+    else
+    {
+      if (!IsUpper(t))
+        gMax2 = std::max(gMax2, -gradient[t]);
+      if (!IsLower(t))
+        gMax1 = std::max(gMax1, gradient[t]);
+    }
+  }
+
+  // Close to the optimum, check all the points once with their exact gradient,
+  // so that the wrongly shrunk points are not kept out too long.
+  if (!unshrink && gMax1 + gMax2 <= 10.0 * tolerance)
+  {
+    unshrink = true;
+    ReconstructGradient(cache);
+    activeSize = y.n_elem;
+  }
+
+  // Move the points to shrink after the active points.
+  for (size_t t = 0; t < activeSize; ++t)
+  {
+    if (!BeShrunk(t, gMax1, gMax2))
+      continue;
+
+    --activeSize;
+    while (activeSize > t)
+    {
+      if (!BeShrunk(activeSize, gMax1, gMax2))
+      {
+        Swap(cache, t, activeSize);
+        break;
+      }
+      --activeSize;
+    }
+  }
+}
+
+template<typename KernelType>
+void SMO<KernelType>::ReconstructGradient(KernelCache<KernelType>& cache)
+{
+  const size_t n = y.n_elem;
+  if (activeSize == n)
+    return;
+
+  // The points at the upper bound are in gradientBar; add the free points.
+  for (size_t t = activeSize; t < n; ++t)
+    gradient[t] = gradientBar[t] - 1.0;
+
+  for (size_t i = 0; i < activeSize; ++i)
+  {
+    if (IsUpper(i) || IsLower(i))
+      continue;
+
+    const double* column = cache.Column(i, n);
+    const double scale = alpha[i] * y[i];
+    for (size_t t = activeSize; t < n; ++t)
+      gradient[t] += scale * y[t] * column[t];
+  }
+}
+
+template<typename KernelType>
+void SMO<KernelType>::Swap(KernelCache<KernelType>& cache,
+                           const size_t i,
+                           const size_t j)
+{
+  cache.Swap(i, j);
+  std::swap(y[i], y[j]);
+  std::swap(alpha[i], alpha[j]);
+  std::swap(gradient[i], gradient[j]);
+  std::swap(gradientBar[i], gradientBar[j]);
+  std::swap(activeSet[i], activeSet[j]);
+}
+
+template<typename KernelType>
+double SMO<KernelType>::Bias() const
+{
+  // The bias is minus the average of y_t G_t over the free variables, or minus
+  // the middle of its feasible interval if no variable is free.
+  double upperBound = std::numeric_limits<double>::infinity();
+  double lowerBound = -std::numeric_limits<double>::infinity();
+  double sum = 0.0;
+  size_t numFree = 0;
+  for (size_t t = 0; t < activeSize; ++t)
+  {
+    const double value = y[t] * gradient[t];
+    if (IsUpper(t))
+    {
+      if (y[t] < 0.0)
+        upperBound = std::min(upperBound, value);
+      else
+        lowerBound = std::max(lowerBound, value);
+    }
+    else if (IsLower(t))
+    {
+      if (y[t] > 0.0)
+        upperBound = std::min(upperBound, value);
+      else
+        lowerBound = std::max(lowerBound, value);
+    }
+    else
+    {
+      ++numFree;
+      sum += value;
+    }
+  }
+
+  return (numFree > 0) ? -sum / numFree : -(upperBound + lowerBound) / 2.0;
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif
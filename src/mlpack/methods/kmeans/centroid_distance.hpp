@@ -0,0 +1,160 @@
+/**
+ * @file centroid_distance.hpp
+ *
+ * Computation of the distances between the points of a dataset and the
+ * centroids of a k-means iteration, and of the sums of the points assigned to
+ * each centroid.  For sparse data and the (squared) Euclidean distance, the
+ * distances are computed from precomputed norms and sparse-dense dot products,
+ * so that the points are never densified.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_CENTROID_DISTANCE_HPP
+#define MLPACK_METHODS_KMEANS_CENTROID_DISTANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The distances between the points of a dataset and the current centroids,
+ * used by the Lloyd step types (NaiveKMeans, ElkanKMeans, HamerlyKMeans).  In
+ * general this just evaluates the metric; specializations may compute the
+ * distances faster for some metrics and matrix types.  Before computing any
+ * distance, the centroids must be given with Centroids().
+ *
+ * @tparam MetricType Type of metric used.
+ * @tparam MatType Type of the dataset.
+ */
+template<typename MetricType, typename MatType>
+class CentroidDistance
+{
+ public:
+  /**
+   * Prepare to compute distances between the points of the given dataset and
+   * centroids, with the given metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   */
+  CentroidDistance(const MatType& dataset, MetricType& metric) :
+      dataset(dataset),
+      metric(metric),
+      centroids(NULL)
+  { }
+
+  //! Set the centroids the distances are computed to.  The matrix must stay
+  //! alive and unmodified while distances are computed.
+  void Centroids(const arma::mat& newCentroids) { centroids = &newCentroids; }
+
+  //! Compute the distance between the given point and centroid.
+  double Evaluate(const size_t point, const size_t cluster) const
+  {
+    return metric.Evaluate(dataset.col(point), centroids->unsafe_col(cluster));
+  }
+
+  //! Add the given point to the given column of the sums of the clusters.
+  void AddPoint(arma::mat& sums, const size_t point, const size_t cluster)
+      const
+  {
+    sums.unsafe_col(cluster) += dataset.col(point);
+  }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The current centroids.
+  const arma::mat* centroids;
+};
+
+/**
+ * The distances between the points of a sparse dataset and dense centroids,
+ * for the Euclidean and squared Euclidean distances.  The squared distance is
+ * computed as ||x||^2 + ||c||^2 - 2 x^T c, where the norms of the points are
+ * computed once and those of the centroids once per iteration, so that each
+ * distance costs one sparse-dense dot product, linear in the number of nonzero
+ * values of the point.  Likewise, a point is added to the sums of its cluster
+ * by its nonzero values only.
+ *
+ * Since the distance is obtained by a difference, it is slightly less accurate
+ * than a direct computation when the point is very close to the centroid.
+ *
+ * @tparam TakeRoot Whether the metric takes the root of the squared distance.
+ * @tparam eT Element type of the dataset.
+ */
+template<bool TakeRoot, typename eT>
+class CentroidDistance<metric::LMetric<2, TakeRoot>, arma::SpMat<eT>>
+{
+ public:
+  //! Prepare to compute distances, computing the norms of all points.
+  CentroidDistance(const arma::SpMat<eT>& dataset,
+                   metric::LMetric<2, TakeRoot>& /* metric */) :
+      dataset(dataset),
+      centroids(NULL)
+  {
+    // Iterating over the matrix also brings its storage up to date, so it can
+    // be read concurrently afterwards.
+    pointNorms.zeros(dataset.n_cols);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      for (typename arma::SpMat<eT>::const_iterator it = dataset.begin_col(i);
+           it != dataset.end_col(i); ++it)
+        pointNorms[i] += double(*it) * double(*it);
+    }
+  }
+
+  //! Set the centroids the distances are computed to, computing their norms.
+  //! The matrix must stay alive and unmodified while distances are computed.
+  void Centroids(const arma::mat& newCentroids)
+  {
+    centroids = &newCentroids;
+    centroidNorms = arma::sum(arma::square(newCentroids), 0).t();
+  }
+
+  //! Compute the distance between the given point and centroid.
+  double Evaluate(const size_t point, const size_t cluster) const
+  {
+    const double* c = centroids->colptr(cluster);
+    double dot = 0.0;
+    for (typename arma::SpMat<eT>::const_iterator it =
+         dataset.begin_col(point); it != dataset.end_col(point); ++it)
+      dot += double(*it) * c[it.row()];
+
+    // Rounding may make the difference slightly negative.
+    const double squared = std::max(pointNorms[point] + centroidNorms[cluster]
+        - 2.0 * dot, 0.0);
+    return TakeRoot ? std::sqrt(squared) : squared;
+  }
+
+  //! Add the given point to the given column of the sums of the clusters.
+  void AddPoint(arma::mat& sums, const size_t point, const size_t cluster)
+      const
+  {
+    double* s = sums.colptr(cluster);
+    for (typename arma::SpMat<eT>::const_iterator it =
+         dataset.begin_col(point); it != dataset.end_col(point); ++it)
+      s[it.row()] += *it;
+  }
+
+ private:
+  //! The dataset.
+  const arma::SpMat<eT>& dataset;
+  //! The current centroids.
+  const arma::mat* centroids;
+  //! The squared norms of the points.
+  arma::vec pointNorms;
+  //! The squared norms of the current centroids.
+  arma::vec centroidNorms;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
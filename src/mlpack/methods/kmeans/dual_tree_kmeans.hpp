@@ -18,6 +18,7 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 
 #include "dual_tree_kmeans_statistic.hpp"
 
@@ -102,7 +103,9 @@ class DualTreeKMeans
 
   arma::Row<size_t> assignments;
 
-  std::vector<bool> visited; // Was the point visited this iteration?
+  // Was the point visited this iteration?  This is not a std::vector<bool>,
+  // because threads set the flags of neighbouring points at the same time.
+  std::vector<char> visited;
 
   arma::mat lastIterationCentroids; // For sanity checks.
 
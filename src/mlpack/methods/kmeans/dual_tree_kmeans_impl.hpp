@@ -19,6 +19,7 @@
 #include "dual_tree_kmeans.hpp"
 
 #include "dual_tree_kmeans_rules.hpp"
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 namespace mlpack {
 namespace kmeans {
@@ -155,17 +156,65 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
       upperBounds, lowerBounds, metric, prunedPoints, oldFromNewCentroids,
       visited);
 
-  typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
-      traverser(rules);
-
   Timer::Start("tree_mod");
   CoalesceTree(*tree);
   Timer::Stop("tree_mod");
 
   // Set the number of pruned centroids in the root to 0.
   tree->Stat().Pruned() = 0;
-  traverser.Traverse(*tree, nns.ReferenceTree());
-  distanceCalculations += rules.BaseCases() + rules.Scores();
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // The cover tree holds the points of a node in its first child too, so its
+  // subtrees are not disjoint; it is always traversed serially.  The tree is
+  // also traversed serially while traversal statistics are collected.
+  if (tree::TreeTraits<Tree>::HasSelfChildren || numThreads == 1 ||
+      tree::TraversalStatistics::Enabled())
+  {
+    tree::TraverseWithStatistics<Tree::template BreadthFirstDualTreeTraverser>(
+        rules, *tree, nns.ReferenceTree(), "dual-tree k-means");
+    distanceCalculations += rules.BaseCases() + rules.Scores();
+  }
+  else
+  {
+    // Split the tree into disjoint subtrees, and traverse each of them with
+    // its own copy of the rules.  The rules only write the statistics of the
+    // query nodes they visit and the bounds of their points, so the threads
+    // never write the same data.
+    std::vector<Tree*> tasks;
+    tree::ParallelDualTreeTraverser<RuleType>::QueryTasks(*tree,
+        8 * numThreads, tasks);
+
+    // The nodes above the subtrees are never scored, so, as for the root, no
+    // centroids are pruned for them; the subtrees inherit that.
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+      for (Tree* node = tasks[i]->Parent(); node != NULL;
+           node = node->Parent())
+      {
+        if (!node->Stat().StaticPruned() &&
+            node->Stat().Pruned() == size_t(-1))
+          node->Stat().Pruned() = 0;
+      }
+    }
+
+    size_t baseCases = 0, scores = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:baseCases, scores)
+    for (omp_size_t i = 0; i < (omp_size_t) tasks.size(); ++i)
+    {
+      RuleType taskRules(rules);
+      typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
+          taskTraverser(taskRules);
+      taskTraverser.Traverse(*tasks[i], nns.ReferenceTree());
+
+      baseCases += taskRules.BaseCases();
+      scores += taskRules.Scores();
+    }
+    distanceCalculations += baseCases + scores;
+  }
 
   Timer::Start("tree_mod");
   DecoalesceTree(*tree);
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_KMEANS_DUAL_TREE_KMEANS_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/leaf_base_case.hpp>
 
 namespace mlpack {
 namespace kmeans {
@@ -31,10 +32,13 @@ class DualTreeKMeansRules
                       MetricType& metric,
                       const std::vector<bool>& prunedPoints,
                       const std::vector<size_t>& oldFromNewCentroids,
-                      std::vector<bool>& visited);
+                      std::vector<char>& visited);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  //! Compute the base cases between two leaves at once, if possible.
+  bool LeafBaseCase(TreeType& queryNode, TreeType& referenceNode);
+
   double Score(const size_t queryIndex, TreeType& referenceNode);
   double Score(TreeType& queryNode, TreeType& referenceNode);
   double Rescore(const size_t queryIndex,
@@ -67,7 +71,7 @@ class DualTreeKMeansRules
 
   const std::vector<size_t>& oldFromNewCentroids;
 
-  std::vector<bool>& visited;
+  std::vector<char>& visited;
 
   size_t baseCases;
   size_t scores;
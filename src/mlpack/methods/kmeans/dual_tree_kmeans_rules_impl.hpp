@@ -27,7 +27,7 @@ DualTreeKMeansRules<MetricType, TreeType>::DualTreeKMeansRules(
     MetricType& metric,
     const std::vector<bool>& prunedPoints,
     const std::vector<size_t>& oldFromNewCentroids,
-    std::vector<bool>& visited) :
+    std::vector<char>& visited) :
     centroids(centroids),
     dataset(dataset),
     assignments(assignments),
@@ -89,6 +89,47 @@ inline force_inline double DualTreeKMeansRules<MetricType, TreeType>::BaseCase(
   return distance;
 }
 
+template<typename MetricType, typename TreeType>
+inline bool DualTreeKMeansRules<MetricType, TreeType>::LeafBaseCase(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  typedef tree::LeafDistances<MetricType, arma::mat> LeafDistancesType;
+
+  const size_t queryBegin = queryNode.Point(0);
+  const size_t queryCount = queryNode.NumPoints();
+  const size_t referenceBegin = referenceNode.Point(0);
+  const size_t referenceCount = referenceNode.NumPoints();
+  if (!LeafDistancesType::Supported ||
+      queryCount * referenceCount < tree::minimumLeafBaseCases)
+    return false;
+
+  const LeafDistancesType leafDistances(dataset, queryBegin, queryCount,
+      centroids, referenceBegin, referenceCount);
+
+  for (size_t i = 0; i < queryCount; ++i)
+  {
+    const size_t queryIndex = queryBegin + i;
+    if (prunedPoints[queryIndex])
+      continue;
+
+    // Any base cases imply that we will get a result.
+    visited[queryIndex] = true;
+
+    for (size_t j = 0; j < referenceCount; ++j)
+    {
+      // A centroid can only change the bounds if it is closer than the second
+      // closest centroid so far; only then is the distance computed exactly.
+      if (leafDistances.Range(i, j).Lo() < lowerBounds[queryIndex])
+        BaseCase(queryIndex, referenceBegin + j);
+      else
+        ++baseCases;
+    }
+  }
+
+  return true;
+}
+
 template<typename MetricType, typename TreeType>
 inline double DualTreeKMeansRules<MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -23,6 +23,7 @@ ElkanKMeans<MetricType, MatType>::ElkanKMeans(const MatType& dataset,
                                               MetricType& metric) :
     dataset(dataset),
     metric(metric),
+    distances(dataset, metric),
     distanceCalculations(0)
 {
   // Nothing to do here.
@@ -37,6 +38,7 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // Clear new centroids.
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
+  distances.Centroids(centroids);
 
   // At the beginning of the iteration, we must compute the distances between
   // all centers.  This is O(k^2).
@@ -46,9 +48,6 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
-
   // If this is the first iteration, we must reset all the bounds.
   if (lowerBounds.n_rows != centroids.n_cols)
   {
@@ -79,79 +78,100 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * arma::min(clusterDistances).t();
 
-  // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points, and see which ones need to be updated.  The
+  // bounds of each point are only touched by the thread that handles it, so
+  // the points are split across threads, each with its own centroid sums.
+  size_t pointDistances = 0;
+  #pragma omp parallel reduction(+:pointDistances)
   {
-    // Step 2: identify all points such that u(x) <= s(c(x)).
-    if (upperBounds(i) <= minClusterDistances(assignments[i]))
-    {
-      // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-      continue;
-    }
-    else
-    {
-      for (size_t c = 0; c < centroids.n_cols; ++c)
-      {
-        // Step 3: for all remaining points x and centers c such that c != c(x),
-        // u(x) > l(x, c) and u(x) > 0.5 d(c(x), c)...
-        if (assignments[i] == c)
-          continue; // Pruned because this cluster is already the assignment.
-
-        if (upperBounds(i) <= lowerBounds(c, i))
-          continue; // Pruned by triangle inequality on lower bound.
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
 
-        if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
-          continue; // Pruned by triangle inequality on cluster distances.
+    #pragma omp for schedule(dynamic, 256)
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    {
+      // Initially set r(x) to true.
+      bool mustRecalculate = true;
 
-        // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
-        // Otherwise, d(x, c(x)) = u(x).
-        double dist;
-        if (mustRecalculate[i])
+      // Step 2: identify all points such that u(x) <= s(c(x)).
+      if (upperBounds(i) <= minClusterDistances(assignments[i]))
+      {
+        // No change needed.  This point must still belong to that cluster.
+        localCounts(assignments[i])++;
+        distances.AddPoint(localCentroids, i, assignments[i]);
+        continue;
+      }
+      else
+      {
+        for (size_t c = 0; c < centroids.n_cols; ++c)
         {
-          mustRecalculate[i] = false;
-          dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
-          lowerBounds(assignments[i], i) = dist;
-          upperBounds(i) = dist;
-          distanceCalculations++;
+          // Step 3: for all remaining points x and centers c such that
+          // c != c(x), u(x) > l(x, c) and u(x) > 0.5 d(c(x), c)...
+          if (assignments[i] == c)
+            continue; // Pruned because this cluster is already the assignment.
 
-          // Check if we can prune again.
           if (upperBounds(i) <= lowerBounds(c, i))
             continue; // Pruned by triangle inequality on lower bound.
 
           if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
             continue; // Pruned by triangle inequality on cluster distances.
-        }
-        else
-        {
-          dist = upperBounds(i); // This is equivalent to d(x, c(x)).
-        }
 
-        // Step 3b: if d(x, c(x)) > l(x, c) or d(x, c(x)) > 0.5 d(c(x), c)...
-        if (dist > lowerBounds(c, i) ||
-            dist > 0.5 * clusterDistances(assignments[i], c))
-        {
-          // Compute d(x, c).  If d(x, c) < d(x, c(x)) then assign c(x) = c.
-          const double pointDist = metric.Evaluate(dataset.col(i),
-                                                   centroids.col(c));
-          lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
-          if (pointDist < dist)
+          // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
+          // Otherwise, d(x, c(x)) = u(x).
+          double dist;
+          if (mustRecalculate)
           {
-            upperBounds(i) = pointDist;
-            assignments[i] = c;
+            mustRecalculate = false;
+            dist = distances.Evaluate(i, assignments[i]);
+            lowerBounds(assignments[i], i) = dist;
+            upperBounds(i) = dist;
+            pointDistances++;
+
+            // Check if we can prune again.
+            if (upperBounds(i) <= lowerBounds(c, i))
+              continue; // Pruned by triangle inequality on lower bound.
+
+            if (upperBounds(i) <= 0.5 * clusterDistances(assignments[i], c))
+              continue; // Pruned by triangle inequality on cluster distances.
+          }
+          else
+          {
+            dist = upperBounds(i); // This is equivalent to d(x, c(x)).
+          }
+
+          // Step 3b: if d(x, c(x)) > l(x, c) or d(x, c(x)) > 0.5 d(c(x), c)...
+          if (dist > lowerBounds(c, i) ||
+              dist > 0.5 * clusterDistances(assignments[i], c))
+          {
+            // Compute d(x, c).  If d(x, c) < d(x, c(x)) then assign c(x) = c.
+            const double pointDist = distances.Evaluate(i, c);
+            lowerBounds(c, i) = pointDist;
+            pointDistances++;
+            if (pointDist < dist)
+            {
+              upperBounds(i) = pointDist;
+              assignments[i] = c;
+            }
           }
         }
       }
+
+      // At this point, we know the new cluster assignment.
+      // Step 4: for each center c, let m(c) be the mean of the points
+      // assigned to c.
+      distances.AddPoint(localCentroids, i, assignments[i]);
+      localCounts[assignments[i]]++;
     }
 
-    // At this point, we know the new cluster assignment.
-    // Step 4: for each center c, let m(c) be the mean of the points assigned to
-    // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+    // Combine the sums of each thread.
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
   }
+  distanceCalculations += pointDistances;
 
   // Now, normalize and calculate the distance each cluster has moved.
   arma::vec moveDistances(centroids.n_cols);
@@ -166,7 +186,8 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     distanceCalculations++;
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     // Step 5: for each point x and center c, assign
     //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 
+#include "centroid_distance.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -44,6 +46,8 @@ class HamerlyKMeans
   const MatType& dataset;
   //! The instantiated metric.
   MetricType& metric;
+  //! The point-to-centroid distances.
+  CentroidDistance<MetricType, MatType> distances;
 
   //! Minimum cluster distances from each cluster.
   arma::vec minClusterDistances;
@@ -18,6 +18,7 @@
 #include "sample_initialization.hpp"
 #include "max_variance_new_cluster.hpp"
 #include "naive_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
@@ -155,6 +156,38 @@ class KMeans
                const bool initialAssignmentGuess = false,
                const bool initialCentroidGuess = false);
 
+  /**
+   * Perform mini-batch k-means clustering on a stream of data that need not
+   * fit in memory, returning the centroids of each cluster.  The reader is
+   * called repeatedly with a matrix to fill with the next chunk of points, and
+   * must return false once there are no more chunks, as in
+   *
+   * @code
+   * bool operator()(MatType& chunk);
+   * @endcode
+   *
+   * Each chunk updates the centroids with MiniBatchKMeans, in batches of
+   * batchSize points; the stream is read once, so the maximum number of
+   * iterations and the LloydStepType are not used.  Unless initialGuess is
+   * true, the initial centroids are found with the initial partitioning policy
+   * on the first chunk, so that chunk should be a representative sample of the
+   * data.
+   *
+   * @tparam ReaderType Type of the reader callback.
+   * @param reader Callback that returns the chunks of the data.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that centroids contains the
+   *      initial cluster centroids.
+   * @param batchSize Number of points in each mini-batch.
+   */
+  template<typename ReaderType>
+  void ClusterStream(ReaderType&& reader,
+                     const size_t clusters,
+                     arma::mat& centroids,
+                     const bool initialGuess = false,
+                     const size_t batchSize = 1000);
+
   //! Get the maximum number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Set the maximum number of iterations.
@@ -0,0 +1,63 @@
+/**
+ * @file kmeans_autotune.hpp
+ *
+ * Selection of the fastest Lloyd step type of k-means for a dataset, by timing
+ * a few iterations of each on a sample of the dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_AUTOTUNE_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_AUTOTUNE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/autotune.hpp>
+
+#include "kmeans.hpp"
+#include "allow_empty_clusters.hpp"
+#include "elkan_kmeans.hpp"
+#include "hamerly_kmeans.hpp"
+#include "yinyang_kmeans.hpp"
+#include "pelleg_moore_kmeans.hpp"
+#include "dual_tree_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Choose the fastest Lloyd step type for clustering the given dataset, by
+ * running a few iterations of each candidate on a sample of the dataset, from
+ * the same initial centroids, and timing them.  The candidates are the exact
+ * step types: naive, Elkan, Hamerly, Pelleg-Moore, dual-tree and Yinyang
+ * k-means (mini-batch k-means gives different clusters, so it is never
+ * chosen; Elkan's algorithm is left out when its bounds would not fit in 1GB
+ * for the whole dataset).
+ *
+ * The decision is cached with Autotune, so datasets of about the same shape
+ * are not timed again.  The sample is taken at regular intervals of the
+ * dataset, so the random number generator is not used.
+ *
+ * @param dataset Dataset to be clustered.
+ * @param clusters Number of clusters.
+ * @param sampleSize Number of points of the sample (at least ten times the
+ *     number of clusters are used).
+ * @param iterations Number of Lloyd iterations to time.
+ * @return The name of the fastest step type, as the kmeans program's
+ *     'algorithm' option takes it: 'naive', 'elkan', 'hamerly',
+ *     'pelleg-moore', 'dualtree' or 'yinyang'.
+ */
+template<typename MatType>
+std::string SelectLloydStepType(const MatType& dataset,
+                                const size_t clusters,
+                                const size_t sampleSize = 10000,
+                                const size_t iterations = 3);
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_autotune_impl.hpp"
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file kmeans_autotune_impl.hpp
+ *
+ * Implementation of the selection of the fastest Lloyd step type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_AUTOTUNE_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_AUTOTUNE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_autotune.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+namespace details {
+
+//! Run the given number of Lloyd iterations from the given centroids.
+template<template<class, class> class LloydStepType, typename MatType>
+void RunLloydIterations(const MatType& sample,
+                        const arma::mat& initialCentroids,
+                        const size_t iterations)
+{
+  KMeans<metric::EuclideanDistance, SampleInitialization, AllowEmptyClusters,
+      LloydStepType, MatType> kmeans(iterations);
+  arma::mat centroids = initialCentroids;
+  kmeans.Cluster(sample, initialCentroids.n_cols, centroids, true);
+}
+
+} // namespace details
+
+template<typename MatType>
+std::string SelectLloydStepType(const MatType& dataset,
+                                const size_t clusters,
+                                const size_t sampleSize,
+                                const size_t iterations)
+{
+  // With too few points there is nothing to gain.
+  if (clusters == 0 || dataset.n_cols <= clusters)
+    return "naive";
+
+  const std::string key = Autotune::Key("kmeans/lloyd_step", dataset.n_cols,
+      dataset.n_rows, clusters);
+  std::string choice;
+  if (Autotune::Lookup(key, choice))
+  {
+    Log::Info << "Using the cached choice '" << choice << "' for k-means."
+        << std::endl;
+    return choice;
+  }
+
+  // Take the sample at regular intervals, and the initial centroids at regular
+  // intervals of the sample.
+  const size_t points = std::min((size_t) dataset.n_cols,
+      std::max(sampleSize, 10 * clusters));
+  MatType sample(dataset.n_rows, points);
+  for (size_t i = 0; i < points; ++i)
+    sample.col(i) = dataset.col((i * dataset.n_cols) / points);
+
+  arma::mat initialCentroids(dataset.n_rows, clusters);
+  for (size_t i = 0; i < clusters; ++i)
+  {
+    initialCentroids.col(i) = arma::conv_to<arma::vec>::from(
+        sample.col((i * points) / clusters));
+  }
+
+  std::vector<std::string> candidates = { "naive", "hamerly", "pelleg-moore",
+      "dualtree", "yinyang" };
+  if (double(dataset.n_cols) * clusters * sizeof(double) <= double(1 << 30))
+    candidates.push_back("elkan");
+
+  choice = Autotune::Fastest(candidates, [&](const std::string& candidate)
+  {
+    if (candidate == "naive")
+    {
+      details::RunLloydIterations<NaiveKMeans>(sample, initialCentroids,
+          iterations);
+    }
+    else if (candidate == "elkan")
+    {
+      details::RunLloydIterations<ElkanKMeans>(sample, initialCentroids,
+          iterations);
+    }
+    else if (candidate == "hamerly")
+    {
+      details::RunLloydIterations<HamerlyKMeans>(sample, initialCentroids,
+          iterations);
+    }
+    else if (candidate == "pelleg-moore")
+    {
+      details::RunLloydIterations<PellegMooreKMeans>(sample, initialCentroids,
+          iterations);
+    }
+    else if (candidate == "dualtree")
+    {
+      details::RunLloydIterations<DefaultDualTreeKMeans>(sample,
+          initialCentroids, iterations);
+    }
+    else if (candidate == "yinyang")
+    {
+      details::RunLloydIterations<YinyangKMeans>(sample, initialCentroids,
+          iterations);
+    }
+  });
+
+  Log::Info << "Autotuning chose '" << choice << "' for k-means." << std::endl;
+  Autotune::Store(key, choice);
+  return choice;
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
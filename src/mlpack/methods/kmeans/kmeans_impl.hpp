@@ -150,6 +150,8 @@ Cluster(const MatType& data,
         arma::mat& centroids,
         const bool initialGuess)
 {
+  MLPACK_PROFILE_SCOPE("kmeans/cluster");
+
   // Make sure we have more points than clusters.
   if (clusters > data.n_cols)
     Log::Warn << "KMeans::Cluster(): more clusters requested than points given."
@@ -213,6 +215,8 @@ Cluster(const MatType& data,
 
   do
   {
+    MLPACK_PROFILE_SCOPE("kmeans/iteration");
+
     // We have two centroid matrices.  We don't want to copy anything, so,
     // depending on the iteration number, we use a different centroid matrix...
     if (iteration % 2 == 0)
@@ -261,6 +265,8 @@ Cluster(const MatType& data,
   }
   Log::Info << lloydStep.DistanceCalculations() << " distance calculations."
       << std::endl;
+  MLPACK_PROFILE_COUNT("kmeans/distance_calculations",
+      lloydStep.DistanceCalculations());
 }
 
 /**
@@ -337,6 +343,92 @@ Cluster(const MatType& data,
   }
 }
 
+/**
+ * Perform mini-batch k-means clustering on a stream of chunks of data.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+template<typename ReaderType>
+void KMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+ClusterStream(ReaderType&& reader,
+              const size_t clusters,
+              arma::mat& centroids,
+              const bool initialGuess,
+              const size_t batchSize)
+{
+  // The chunk is reused for every call to the reader.
+  MatType chunk;
+  if (!reader(chunk))
+    Log::Fatal << "KMeans::ClusterStream(): the stream is empty!" << std::endl;
+
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters)
+      Log::Fatal << "KMeans::ClusterStream(): wrong number of initial cluster "
+        << "centroids (" << centroids.n_cols << ", should be " << clusters
+        << ")!" << std::endl;
+
+    if (centroids.n_rows != chunk.n_rows)
+      Log::Fatal << "KMeans::ClusterStream(): initial cluster centroids have "
+        << "wrong dimensionality (" << centroids.n_rows << ", should be "
+        << chunk.n_rows << ")!" << std::endl;
+  }
+  else
+  {
+    // Find the initial centroids from the first chunk, as in Cluster().
+    arma::Row<size_t> assignments;
+    bool gotAssignments = GetInitialAssignmentsOrCentroids(partitioner, chunk,
+        clusters, assignments, centroids);
+    if (gotAssignments)
+    {
+      arma::Row<size_t> counts;
+      counts.zeros(clusters);
+      centroids.zeros(chunk.n_rows, clusters);
+      for (size_t i = 0; i < chunk.n_cols; ++i)
+      {
+        centroids.col(assignments[i]) += arma::vec(chunk.col(i));
+        counts[assignments[i]]++;
+      }
+
+      for (size_t i = 0; i < clusters; ++i)
+        if (counts[i] != 0)
+          centroids.col(i) /= counts[i];
+    }
+  }
+
+  MiniBatchKMeans<MetricType, MatType> miniBatch(chunk, metric, batchSize);
+
+  size_t chunks = 0;
+  size_t points = 0;
+  do
+  {
+    if (chunk.n_rows != centroids.n_rows)
+      Log::Fatal << "KMeans::ClusterStream(): chunk " << chunks << " has "
+          << "dimensionality " << chunk.n_rows << ", should be "
+          << centroids.n_rows << "!" << std::endl;
+
+    const double cNorm = miniBatch.Update(chunk, centroids);
+
+    chunks++;
+    points += chunk.n_cols;
+    Log::Info << "KMeans::ClusterStream(): chunk " << chunks << ", residual "
+        << cNorm << ".\n";
+  } while (reader(chunk));
+
+  Log::Info << "KMeans::ClusterStream(): clustered " << points << " points "
+      << "in " << chunks << " chunks." << std::endl;
+  Log::Info << miniBatch.DistanceCalculations() << " distance calculations."
+      << std::endl;
+}
+
 template<typename MetricType,
          typename InitialPartitionPolicy,
          typename EmptyClusterPolicy,
@@ -17,10 +17,14 @@
 #include "allow_empty_clusters.hpp"
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
+#include "yinyang_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
+#include "kmeans_autotune.hpp"
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -43,14 +47,30 @@ PROGRAM_INFO("K-Means Clustering", "This program performs K-Means clustering "
     "used in each sample, the " + PRINT_PARAM_STRING("percentage") +
     " parameter is used (it should be a value between 0.0 and 1.0)."
     "\n\n"
+    "Alternately, the k-means|| initialization of Bahmani et al. (\"Scalable "
+    "k-means++\", 2012) can be used by specifying the " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " parameter.  It samples about " +
+    PRINT_PARAM_STRING("oversampling") + " times the number of clusters "
+    "candidate centroids in each of " + PRINT_PARAM_STRING("rounds") + " "
+    "passes over the data, and then clusters the candidates."
+    "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the " + PRINT_PARAM_STRING("algorithm") + " "
     " option.  The standard O(kN) approach can be used ('naive').  Other "
     "options include the Pelleg-Moore tree-based algorithm ('pelleg-moore'), "
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
     "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
-    "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "algorithm ('dualtree'), the dual-tree k-means algorithm using the "
+    "cover tree ('dualtree-covertree'), Yinyang k-means ('yinyang'), which "
+    "prunes like Elkan's algorithm but keeps one bound per group of ten "
+    "centroids instead of one per centroid and so needs much less memory for "
+    "large numbers of clusters, and mini-batch k-means ('minibatch'), which "
+    "updates the centroids from random batches of 1000 points and is much "
+    "faster on very large datasets.  If 'auto' is given, a few iterations of "
+    "each of the exact algorithms are timed on a sample of the dataset, and "
+    "the fastest is used; the choice is remembered for datasets of about the "
+    "same size, and if " + PRINT_PARAM_STRING("autotune_cache") + " is "
+    "given, it is also saved to that file for later runs."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -120,9 +140,20 @@ PARAM_INT_IN("samplings", "Number of samplings to perform for refined start "
 PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
+// Parameters for k-means|| initialization.
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| initialization by Bahmani et "
+    "al. to choose initial points.", "");
+PARAM_INT_IN("rounds", "Number of sampling rounds for k-means|| (use when "
+    "--kmeans_parallel is specified).", "", 5);
+PARAM_DOUBLE_IN("oversampling", "Number of candidates sampled in each "
+    "k-means|| round, as a multiple of the number of clusters (use when "
+    "--kmeans_parallel is specified).", "", 2.0);
+
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', "
+    "'dualtree-covertree', 'yinyang', 'minibatch', or 'auto').", "a", "naive");
+PARAM_STRING_IN("autotune_cache", "File of the choices made by '--algorithm "
+    "auto', read and updated so that later runs reuse them.", "", "");
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -151,6 +182,9 @@ static void mlpackMain()
   // Now, start building the KMeans type that we'll be using.  Start with the
   // initial partition policy.  The call to FindEmptyClusterPolicy<> results in
   // a call to RunKMeans<> and the algorithm is completed.
+  if (CLI::HasParam("refined_start") || CLI::HasParam("kmeans_parallel"))
+    RequireOnlyOnePassed({ "refined_start", "kmeans_parallel" }, true);
+
   if (CLI::HasParam("refined_start"))
   {
     RequireParamValue<int>("samplings", [](int x) { return x > 0; }, true,
@@ -163,6 +197,17 @@ static void mlpackMain()
 
     FindEmptyClusterPolicy<RefinedStart>(RefinedStart(samplings, percentage));
   }
+  else if (CLI::HasParam("kmeans_parallel"))
+  {
+    RequireParamValue<int>("rounds", [](int x) { return x > 0; }, true,
+        "number of rounds must be positive");
+    RequireParamValue<double>("oversampling", [](double x) { return x > 0.0; },
+        true, "oversampling factor must be positive");
+
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(
+        KMeansParallelInitialization(size_t(CLI::GetParam<int>("rounds")),
+        CLI::GetParam<double>("oversampling")));
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(SampleInitialization());
@@ -193,10 +238,32 @@ template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
 void FindLloydStepType(const InitialPartitionPolicy& ipp)
 {
   RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
-      "dualtree", "dualtree-covertree", "naive" }, true, "unknown k-means "
-      "algorithm");
+      "dualtree", "dualtree-covertree", "naive", "minibatch", "yinyang",
+      "auto" }, true, "unknown k-means algorithm");
+
+  string algorithm = CLI::GetParam<string>("algorithm");
+  if (algorithm != "auto")
+    ReportIgnoredParam("autotune_cache", "the algorithm is not 'auto'");
+  else
+  {
+    // The number of clusters may come from the initial centroids.
+    size_t clusters = (size_t) std::max(CLI::GetParam<int>("clusters"), 0);
+    if (clusters == 0 && CLI::HasParam("initial_centroids"))
+      clusters = CLI::GetParam<arma::mat>("initial_centroids").n_cols;
+
+    const string cacheFile = CLI::GetParam<string>("autotune_cache");
+    if (!cacheFile.empty())
+      Autotune::Load(cacheFile);
+
+    Timer::Start("autotuning");
+    algorithm = SelectLloydStepType(CLI::GetParam<arma::mat>("input"),
+        clusters);
+    Timer::Stop("autotuning");
+
+    if (!cacheFile.empty())
+      Autotune::Save(cacheFile);
+  }
 
-  const string algorithm = CLI::GetParam<string>("algorithm");
   if (algorithm == "elkan")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, ElkanKMeans>(ipp);
   else if (algorithm == "hamerly")
@@ -212,6 +279,11 @@ void FindLloydStepType(const InitialPartitionPolicy& ipp)
         CoverTreeDualTreeKMeans>(ipp);
   else if (algorithm == "naive")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(ipp);
+  else if (algorithm == "minibatch")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        MiniBatchKMeans>(ipp);
+  else if (algorithm == "yinyang")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, YinyangKMeans>(ipp);
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -258,8 +330,9 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
       clusters = centroids.n_cols;
 
     ReportIgnoredParam({{ "refined_start", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_parallel", true }}, "initial_centroids");
 
-    if (!CLI::HasParam("refined_start"))
+    if (!CLI::HasParam("refined_start") && !CLI::HasParam("kmeans_parallel"))
       Log::Info << "Using initial centroid guesses." << endl;
   }
 
@@ -0,0 +1,133 @@
+/**
+ * @file kmeans_parallel_initialization.hpp
+ *
+ * An implementation of the k-means|| initialization of Bahmani et al., a
+ * scalable variant of k-means++ that oversamples candidate centroids in a few
+ * passes over the data and then reclusters the weighted candidates.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means|| initialization chooses initial centroids that are spread over
+ * the data, like k-means++, but needs only a few passes over the data instead
+ * of one pass per cluster.  It starts from one random point; then, in each of
+ * a few rounds, every point is sampled as a candidate centroid independently,
+ * with probability proportional to its squared distance to the closest
+ * candidate so far, so that about oversampling * k candidates are added per
+ * round.  Each candidate is weighted with the number of points closest to it,
+ * and the weighted candidates are clustered into k centroids with k-means++
+ * and weighted Lloyd iterations.
+ *
+ * The distances to the candidates are computed with single-tree nearest
+ * neighbor searches on a kd-tree built on the candidates, which are
+ * parallelized with OpenMP.  For more information, see the following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, B. and Moseley, B. and Vattani, A. and Kumar, R. and
+ *       Vassilvitskii, S.},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the KMeansParallelInitialization object, optionally specifying the
+   * number of sampling rounds and the oversampling factor.
+   *
+   * @param rounds Number of sampling rounds (passes over the data).
+   * @param oversampling Expected number of candidates sampled per round, as a
+   *     multiple of the number of clusters.
+   */
+  KMeansParallelInitialization(const size_t rounds = 5,
+                               const double oversampling = 2.0) :
+      rounds(rounds), oversampling(oversampling) { }
+
+  /**
+   * Find initial centroids for the given dataset with the k-means||
+   * algorithm.
+   *
+   * @tparam MatType Type of data (a dense matrix).
+   * @param data Dataset to find initial centroids for.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to store centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids);
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(rounds);
+    ar & BOOST_SERIALIZATION_NVP(oversampling);
+  }
+
+ private:
+  /**
+   * Lower the squared distance of each point to its closest candidate with
+   * the given new candidates, and optionally return the index of the closest
+   * new candidate of each point.
+   */
+  template<typename MatType>
+  static void UpdateDistances(const MatType& data,
+                              const std::vector<size_t>& newCandidates,
+                              arma::vec& minDistances,
+                              arma::Col<size_t>* closest = NULL);
+
+  /**
+   * Cluster the weighted candidates into the given number of centroids with
+   * k-means++ and weighted Lloyd iterations.
+   */
+  static void Recluster(const arma::mat& candidates,
+                        const arma::vec& weights,
+                        const size_t clusters,
+                        arma::mat& centroids);
+
+  //! Sample an index with probability proportional to the given weights.
+  static size_t Sample(const arma::vec& weights);
+
+  //! The number of sampling rounds.
+  size_t rounds;
+  //! The expected number of candidates per round, per cluster.
+  double oversampling;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_parallel_initialization_impl.hpp"
+
+#endif
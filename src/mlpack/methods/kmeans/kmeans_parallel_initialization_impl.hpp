@@ -0,0 +1,225 @@
+/**
+ * @file kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| initialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+//! Find the initial centroids with k-means||.
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids)
+{
+  // Start with one random point.  Points that are already candidates have
+  // distance 0, so they are never sampled again.
+  std::vector<size_t> candidates(1, math::RandInt(0, data.n_cols));
+  arma::vec minDistances(data.n_cols);
+  minDistances.fill(DBL_MAX);
+  UpdateDistances(data, candidates, minDistances);
+
+  const double expectedSamples = oversampling * clusters;
+  for (size_t r = 0; r < rounds; ++r)
+  {
+    const double cost = arma::accu(minDistances);
+    if (cost == 0.0)
+      break; // Every point is a candidate already.
+
+    // Sample each point independently.  The random number generator is not
+    // thread-safe, so this is done serially; it is cheap next to the
+    // distance computations.
+    std::vector<size_t> newCandidates;
+    for (size_t i = 0; i < data.n_cols; ++i)
+      if (math::Random() * cost < expectedSamples * minDistances[i])
+        newCandidates.push_back(i);
+
+    if (newCandidates.empty())
+      continue;
+
+    UpdateDistances(data, newCandidates, minDistances);
+    candidates.insert(candidates.end(), newCandidates.begin(),
+        newCandidates.end());
+  }
+
+  Log::Info << "KMeansParallelInitialization::Cluster(): sampled "
+      << candidates.size() << " candidates in " << rounds << " rounds."
+      << std::endl;
+
+  // Weight each candidate with the number of points closest to it.
+  arma::Col<size_t> closest;
+  minDistances.fill(DBL_MAX);
+  UpdateDistances(data, candidates, minDistances, &closest);
+
+  arma::vec weights(candidates.size(), arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    weights[closest[i]] += 1.0;
+
+  arma::mat candidateSet(data.n_rows, candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i)
+    candidateSet.col(i) = arma::vec(data.col(candidates[i]));
+
+  Recluster(candidateSet, weights, clusters, centroids);
+}
+
+//! Lower the distances of the points with the new candidates.
+template<typename MatType>
+void KMeansParallelInitialization::UpdateDistances(
+    const MatType& data,
+    const std::vector<size_t>& newCandidates,
+    arma::vec& minDistances,
+    arma::Col<size_t>* closest)
+{
+  typedef neighbor::NeighborSearch<neighbor::NearestNeighborSort,
+      metric::EuclideanDistance, MatType> KNNType;
+
+  MatType candidateSet(data.n_rows, newCandidates.size());
+  for (size_t i = 0; i < newCandidates.size(); ++i)
+    candidateSet.col(i) = data.col(newCandidates[i]);
+
+  // A single-tree search against a tree on the candidates avoids building a
+  // tree on the whole dataset in each round.
+  KNNType knn(std::move(candidateSet), neighbor::SINGLE_TREE_MODE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(data, 1, neighbors, distances);
+
+  if (closest)
+    closest->set_size(data.n_cols);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const double distance = distances[i] * distances[i];
+    if (distance < minDistances[i])
+    {
+      minDistances[i] = distance;
+      if (closest)
+        (*closest)[i] = neighbors[i];
+    }
+  }
+}
+
+//! Cluster the weighted candidates.
+inline void KMeansParallelInitialization::Recluster(
+    const arma::mat& candidates,
+    const arma::vec& weights,
+    const size_t clusters,
+    arma::mat& centroids)
+{
+  centroids.set_size(candidates.n_rows, clusters);
+
+  // If there are too few candidates, the other centroids are copies of random
+  // candidates; the empty cluster policy of KMeans takes care of those.
+  if (candidates.n_cols <= clusters)
+  {
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      const size_t index = (c < candidates.n_cols) ? c :
+          math::RandInt(0, candidates.n_cols);
+      centroids.col(c) = candidates.col(index);
+    }
+    return;
+  }
+
+  // k-means++ on the weighted candidates: sample each centroid with
+  // probability proportional to its weight times its squared distance to the
+  // closest centroid so far.
+  arma::vec minDistances(candidates.n_cols);
+  minDistances.fill(DBL_MAX);
+  for (size_t c = 0; c < clusters; ++c)
+  {
+    const size_t index = (c == 0) ? Sample(weights) :
+        Sample(weights % minDistances);
+    centroids.col(c) = candidates.col(index);
+
+    for (size_t i = 0; i < candidates.n_cols; ++i)
+    {
+      const double distance = metric::SquaredEuclideanDistance::Evaluate(
+          candidates.col(i), centroids.col(c));
+      minDistances[i] = std::min(minDistances[i], distance);
+    }
+  }
+
+  // Refine the centroids with weighted Lloyd iterations on the candidates.
+  arma::Col<size_t> assignments(candidates.n_cols);
+  assignments.fill(clusters);
+  for (size_t iteration = 0; iteration < 100; ++iteration)
+  {
+    bool changed = false;
+    for (size_t i = 0; i < candidates.n_cols; ++i)
+    {
+      double minDistance = DBL_MAX;
+      size_t closestCluster = 0;
+      for (size_t c = 0; c < clusters; ++c)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            candidates.col(i), centroids.col(c));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = c;
+        }
+      }
+
+      if (assignments[i] != closestCluster)
+      {
+        assignments[i] = closestCluster;
+        changed = true;
+      }
+    }
+
+    if (!changed)
+      break;
+
+    // Empty clusters keep their centroid.
+    arma::mat sums(candidates.n_rows, clusters, arma::fill::zeros);
+    arma::vec totalWeights(clusters, arma::fill::zeros);
+    for (size_t i = 0; i < candidates.n_cols; ++i)
+    {
+      sums.col(assignments[i]) += weights[i] * candidates.col(i);
+      totalWeights[assignments[i]] += weights[i];
+    }
+
+    for (size_t c = 0; c < clusters; ++c)
+      if (totalWeights[c] > 0.0)
+        centroids.col(c) = sums.col(c) / totalWeights[c];
+  }
+}
+
+//! Sample an index with probability proportional to the weights.
+inline size_t KMeansParallelInitialization::Sample(const arma::vec& weights)
+{
+  const double total = arma::accu(weights);
+  if (total <= 0.0)
+    return math::RandInt(0, weights.n_elem);
+
+  const double target = math::Random() * total;
+  double sum = 0.0;
+  for (size_t i = 0; i < weights.n_elem; ++i)
+  {
+    sum += weights[i];
+    if (sum > target)
+      return i;
+  }
+
+  return weights.n_elem - 1;
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file mini_batch_kmeans.hpp
+ *
+ * An implementation of mini-batch k-means (Sculley, 2010), which updates the
+ * centroids from small random batches of the dataset instead of full passes.
+ * This is much faster on very large datasets, at the cost of a slightly
+ * worse clustering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This is an implementation of a single step of mini-batch k-means.  Each
+ * call to Iterate() samples a batch of points of the dataset, assigns them to
+ * their closest centroids, and moves each centroid towards the points assigned
+ * to it with a per-center learning rate of one over the number of points the
+ * centroid has been assigned so far.  The centroids therefore converge to the
+ * means of all the points seen, without ever making a full pass over the
+ * dataset.
+ *
+ * The class can be used as the LloydStepType of KMeans.  It can also update
+ * the centroids from data that does not fit in memory, one chunk at a time,
+ * with Update(); KMeans::ClusterStream() does this for a stream of chunks.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-Scale K-Means Clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points to sample in each iteration.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1000);
+
+  /**
+   * Run a single mini-batch step, updating the given centroids into the
+   * newCentroids matrix.  The counts are the number of points assigned to each
+   * cluster over all the steps so far, so a cluster is only empty if no point
+   * has ever been assigned to it.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points assigned to each cluster so far.
+   * @return The distance the centroids moved.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Update the given centroids in place with all the points of the given
+   * data, in batches of BatchSize() points.  The data need not be the dataset
+   * given to the constructor, so this can be called with successive chunks of
+   * a dataset that does not fit in memory.
+   *
+   * @param data Points to update the centroids with.
+   * @param centroids Cluster centroids to update.
+   * @return The distance the centroids moved.
+   */
+  double Update(const MatType& data, arma::mat& centroids);
+
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of points assigned to each cluster so far.
+  const arma::Col<size_t>& ClusterCounts() const { return clusterCounts; }
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  /**
+   * Update the centroids in place with the points of the given data with the
+   * given indices, and return the distance the centroids moved.
+   */
+  double UpdateBatch(const MatType& data,
+                     const arma::Col<size_t>& indices,
+                     arma::mat& centroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! Number of points in each batch.
+  size_t batchSize;
+  //! Number of points assigned to each cluster so far.
+  arma::Col<size_t> clusterCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of mini-batch k-means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(
+    const MatType& dataset,
+    MetricType& metric,
+    const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single mini-batch step.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // Sample the batch; if the dataset is smaller than a batch, use all of it.
+  arma::Col<size_t> indices;
+  if (batchSize >= dataset.n_cols)
+  {
+    indices = arma::linspace<arma::Col<size_t>>(0, dataset.n_cols - 1,
+        dataset.n_cols);
+  }
+  else
+  {
+    indices.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+      indices[i] = math::RandInt(dataset.n_cols);
+  }
+
+  newCentroids = centroids;
+  const double cNorm = UpdateBatch(dataset, indices, newCentroids);
+  counts = clusterCounts;
+
+  return cNorm;
+}
+
+// Update the centroids with all points of the given data.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Update(const MatType& data,
+                                                    arma::mat& centroids)
+{
+  double squaredNorm = 0.0;
+  const size_t step = std::max(batchSize, size_t(1));
+  for (size_t begin = 0; begin < data.n_cols; begin += step)
+  {
+    const size_t count = std::min(step, size_t(data.n_cols - begin));
+    const arma::Col<size_t> indices = arma::linspace<arma::Col<size_t>>(begin,
+        begin + count - 1, count);
+
+    const double batchNorm = UpdateBatch(data, indices, centroids);
+    squaredNorm += batchNorm * batchNorm;
+  }
+
+  return std::sqrt(squaredNorm);
+}
+
+// Update the centroids with one batch.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::UpdateBatch(
+    const MatType& data,
+    const arma::Col<size_t>& indices,
+    arma::mat& centroids)
+{
+  if (clusterCounts.n_elem != centroids.n_cols)
+    clusterCounts.zeros(centroids.n_cols);
+
+  // Sum the points of the batch assigned to each centroid.  The assignments
+  // are made with the centroids from before the batch, so the batch can be
+  // processed in parallel.
+  arma::mat sums(centroids.n_rows, centroids.n_cols, arma::fill::zeros);
+  arma::Col<size_t> batchCounts(centroids.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel
+  {
+    arma::mat localSums(centroids.n_rows, centroids.n_cols, arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) indices.n_elem; ++i)
+    {
+      const size_t point = indices[i];
+
+      // Find the closest centroid to this point.
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+      {
+        const double distance = metric.Evaluate(data.col(point),
+            centroids.unsafe_col(j));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+
+      localSums.unsafe_col(closestCluster) += data.col(point);
+      localCounts(closestCluster)++;
+    }
+
+    #pragma omp critical
+    {
+      sums += localSums;
+      batchCounts += localCounts;
+    }
+  }
+
+  distanceCalculations += centroids.n_cols * indices.n_elem;
+
+  // Move each centroid towards the points assigned to it.  With a learning
+  // rate of 1 / (number of points so far) for each point, the centroid stays
+  // the mean of all the points assigned to it.
+  double cNorm = 0.0;
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    if (batchCounts[j] == 0)
+      continue;
+
+    clusterCounts[j] += batchCounts[j];
+    const arma::vec oldCentroid = centroids.col(j);
+    centroids.col(j) += (sums.col(j) - double(batchCounts[j]) * oldCentroid) /
+        double(clusterCounts[j]);
+
+    cNorm += std::pow(metric.Evaluate(oldCentroid, centroids.col(j)), 2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,8 @@
 #define MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #include <mlpack/prereqs.hpp>
 
+#include "centroid_distance.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -25,6 +27,10 @@ namespace kmeans {
  * looking for the mlpack::kmeans::KMeans class instead of this one.  This class
  * is used by KMeans as the actual implementation of the Lloyd iteration.
  *
+ * For sparse data and the (squared) Euclidean distance, the distances are
+ * computed from sparse-dense dot products (see CentroidDistance), so the points
+ * are never densified.
+ *
  * @param MetricType Type of metric used with this implementation.
  * @param MatType Matrix type (arma::mat or arma::sp_mat).
  */
@@ -61,6 +67,8 @@ class NaiveKMeans
   const MatType& dataset;
   //! The instantiated metric.
   MetricType& metric;
+  //! The point-to-centroid distances.
+  CentroidDistance<MetricType, MatType> distances;
 
   //! Number of distance calculations.
   size_t distanceCalculations;
@@ -0,0 +1,125 @@
+/**
+ * @file yinyang_kmeans.hpp
+ *
+ * An implementation of Yinyang k-means, a variant of Elkan's algorithm for
+ * exact Lloyd iterations that keeps one lower bound per group of centroids
+ * instead of one per centroid.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Yinyang k-means gives the same result as the naive Lloyd iteration, while
+ * pruning most distance calculations with the triangle inequality like
+ * Elkan's algorithm.  Elkan's algorithm stores a lower bound for each point
+ * and each centroid, which takes k times as much memory as the dataset when
+ * the dimensionality is small; this implementation instead splits the
+ * centroids into t groups in the first iteration, and stores for each point
+ * one lower bound per group, so that the bounds take t / k of the memory.  By
+ * default, t = k / 10.
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{ding2015yinyang,
+ *   title={Yinyang K-Means: A Drop-In Replacement of the Classic K-Means with
+ *       Consistent Speedup},
+ *   author={Ding, Y. and Zhao, Y. and Shen, X. and Musuvathi, M. and
+ *       Mytkowicz, T.},
+ *   booktitle={Proceedings of the 32nd International Conference on Machine
+ *       Learning (ICML '15)},
+ *   pages={579--587},
+ *   year={2015}
+ * }
+ * @endcode
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class YinyangKMeans
+{
+ public:
+  /**
+   * Construct the YinyangKMeans object, which must store several sets of
+   * bounds.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param groups Number of groups of centroids, or 0 to use one group for
+   *     every ten centroids.
+   */
+  YinyangKMeans(const MatType& dataset,
+                MetricType& metric,
+                const size_t groups = 0);
+
+  /**
+   * Run a single iteration of Yinyang k-means, updating the given centroids
+   * into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Current counts, to be overwritten with new counts.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  //! Get the number of groups of centroids (0 means automatic).
+  size_t Groups() const { return groups; }
+  //! Modify the number of groups of centroids (0 means automatic).  This only
+  //! takes effect before the first iteration.
+  size_t& Groups() { return groups; }
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  /**
+   * Split the given centroids into groups with a few Lloyd iterations on the
+   * centroids, filling centroidGroups and groupMembers.
+   */
+  void FormGroups(const arma::mat& centroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The requested number of groups.
+  size_t groups;
+
+  //! The group of each centroid.
+  arma::Col<size_t> centroidGroups;
+  //! The centroids in each group.
+  std::vector<std::vector<size_t>> groupMembers;
+
+  //! The centroids given to the last iteration, to find how far they moved.
+  arma::mat lastCentroids;
+
+  //! Holds the index of the cluster that owns each point.
+  arma::Col<size_t> assignments;
+
+  //! Upper bounds on the distance between each point and its closest cluster.
+  arma::vec upperBounds;
+  //! Lower bounds on the distance between each point and the clusters of each
+  //! group, other than the cluster that owns the point.
+  arma::mat lowerBounds;
+
+  //! Track distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "yinyang_kmeans_impl.hpp"
+
+#endif
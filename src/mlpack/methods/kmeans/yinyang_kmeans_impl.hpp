@@ -0,0 +1,330 @@
+/**
+ * @file yinyang_kmeans_impl.hpp
+ *
+ * An implementation of Yinyang k-means for exact Lloyd iterations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "yinyang_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+YinyangKMeans<MetricType, MatType>::YinyangKMeans(const MatType& dataset,
+                                                  MetricType& metric,
+                                                  const size_t groups) :
+    dataset(dataset),
+    metric(metric),
+    groups(groups),
+    distanceCalculations(0)
+{
+  // Nothing to do here.
+}
+
+// Run a single iteration of Yinyang k-means.
+template<typename MetricType, typename MatType>
+double YinyangKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
+                                                   arma::mat& newCentroids,
+                                                   arma::Col<size_t>& counts)
+{
+  // Clear new centroids.
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  size_t pointDistances = 0;
+  if (lastCentroids.n_cols != centroids.n_cols)
+  {
+    // This is the first iteration: form the groups, then find the exact
+    // assignment and group bounds of each point.
+    FormGroups(centroids);
+
+    const size_t numGroups = groupMembers.size();
+    lowerBounds.set_size(numGroups, dataset.n_cols);
+    upperBounds.set_size(dataset.n_cols);
+    assignments.set_size(dataset.n_cols);
+
+    #pragma omp parallel
+    {
+      arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+          arma::fill::zeros);
+      arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+      arma::vec distances(centroids.n_cols);
+
+      #pragma omp for schedule(dynamic, 256)
+      for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+      {
+        for (size_t c = 0; c < centroids.n_cols; ++c)
+          distances[c] = metric.Evaluate(dataset.col(i), centroids.col(c));
+
+        arma::uword best;
+        distances.min(best);
+        assignments[i] = best;
+        upperBounds(i) = distances[best];
+
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+          double bound = DBL_MAX;
+          for (size_t j = 0; j < groupMembers[g].size(); ++j)
+          {
+            const size_t c = groupMembers[g][j];
+            if (c != best)
+              bound = std::min(bound, distances[c]);
+          }
+          lowerBounds(g, i) = bound;
+        }
+
+        localCentroids.col(best) += arma::vec(dataset.col(i));
+        localCounts[best]++;
+      }
+
+      // Combine the sums of each thread.
+      #pragma omp critical
+      {
+        newCentroids += localCentroids;
+        counts += localCounts;
+      }
+    }
+
+    pointDistances = dataset.n_cols * centroids.n_cols;
+  }
+  else
+  {
+    // Find how far each centroid moved since the last iteration, and the most
+    // any centroid of each group moved.  This is done here rather than at the
+    // end of the last iteration, because the empty cluster policy may have
+    // changed the centroids since.
+    const size_t numGroups = groupMembers.size();
+    arma::vec drifts(centroids.n_cols);
+    arma::vec groupDrifts(numGroups, arma::fill::zeros);
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+    {
+      drifts[c] = metric.Evaluate(centroids.col(c), lastCentroids.col(c));
+      groupDrifts[centroidGroups[c]] = std::max(groupDrifts[centroidGroups[c]],
+          drifts[c]);
+    }
+    distanceCalculations += centroids.n_cols;
+
+    #pragma omp parallel reduction(+:pointDistances)
+    {
+      arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+          arma::fill::zeros);
+      arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+      // The smallest and second smallest bound of each group examined for a
+      // point, and the cluster with the smallest bound.
+      arma::vec groupMin(numGroups), groupSecond(numGroups);
+      arma::Col<size_t> groupArgMin(numGroups);
+      std::vector<bool> examined(numGroups);
+
+      #pragma omp for schedule(dynamic, 256)
+      for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+      {
+        const size_t oldAssignment = assignments[i];
+
+        // Update the bounds with the movement of the centroids, and apply the
+        // global filter: if the upper bound is below every group bound, the
+        // assignment cannot change.
+        upperBounds(i) += drifts[oldAssignment];
+        double globalBound = DBL_MAX;
+        for (size_t g = 0; g < numGroups; ++g)
+          globalBound = std::min(globalBound, lowerBounds(g, i) -
+              groupDrifts[g]);
+
+        if (upperBounds(i) > globalBound)
+        {
+          // Tighten the upper bound and try again.
+          upperBounds(i) = metric.Evaluate(dataset.col(i),
+              centroids.col(oldAssignment));
+          pointDistances++;
+        }
+
+        if (upperBounds(i) <= globalBound)
+        {
+          for (size_t g = 0; g < numGroups; ++g)
+            lowerBounds(g, i) -= groupDrifts[g];
+
+          localCentroids.col(oldAssignment) += arma::vec(dataset.col(i));
+          localCounts[oldAssignment]++;
+          continue;
+        }
+
+        // Now examine each group that the group filter does not prune.
+        const double oldDistance = upperBounds(i);
+        size_t best = oldAssignment;
+        double bestDistance = oldDistance;
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+          const double oldBound = lowerBounds(g, i);
+          lowerBounds(g, i) -= groupDrifts[g];
+          examined[g] = (lowerBounds(g, i) < bestDistance);
+          if (!examined[g])
+            continue;
+
+          groupMin[g] = DBL_MAX;
+          groupSecond[g] = DBL_MAX;
+          groupArgMin[g] = centroids.n_cols;
+          for (size_t j = 0; j < groupMembers[g].size(); ++j)
+          {
+            const size_t c = groupMembers[g][j];
+
+            // The local filter: the last bound of the group, lowered by the
+            // movement of this centroid, bounds the distance to it.  If that
+            // cannot beat the best cluster so far, use it as the bound.
+            double value;
+            if (c == oldAssignment)
+            {
+              value = oldDistance;
+            }
+            else if (oldBound - drifts[c] >= bestDistance)
+            {
+              value = oldBound - drifts[c];
+            }
+            else
+            {
+              value = metric.Evaluate(dataset.col(i), centroids.col(c));
+              pointDistances++;
+              if (value < bestDistance)
+              {
+                bestDistance = value;
+                best = c;
+              }
+            }
+
+            if (value < groupMin[g])
+            {
+              groupSecond[g] = groupMin[g];
+              groupMin[g] = value;
+              groupArgMin[g] = c;
+            }
+            else if (value < groupSecond[g])
+            {
+              groupSecond[g] = value;
+            }
+          }
+        }
+
+        // Set the new bounds.  The bound of each examined group excludes the
+        // new owner of the point; if the point changed clusters, the group of
+        // its old cluster must also account for the old distance.
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+          if (examined[g])
+            lowerBounds(g, i) = (groupArgMin[g] == best) ? groupSecond[g] :
+                groupMin[g];
+        }
+
+        if (best != oldAssignment && !examined[centroidGroups[oldAssignment]])
+        {
+          const size_t g = centroidGroups[oldAssignment];
+          lowerBounds(g, i) = std::min(lowerBounds(g, i), oldDistance);
+        }
+
+        assignments[i] = best;
+        upperBounds(i) = bestDistance;
+
+        localCentroids.col(best) += arma::vec(dataset.col(i));
+        localCounts[best]++;
+      }
+
+      // Combine the sums of each thread.
+      #pragma omp critical
+      {
+        newCentroids += localCentroids;
+        counts += localCounts;
+      }
+    }
+  }
+  distanceCalculations += pointDistances;
+  lastCentroids = centroids;
+
+  // Now, normalize and calculate the distance each cluster has moved.
+  double cNorm = 0.0; // Cluster movement for residual.
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    if (counts[c] > 0)
+      newCentroids.col(c) /= counts[c];
+
+    cNorm += std::pow(metric.Evaluate(newCentroids.col(c), centroids.col(c)),
+        2.0);
+    distanceCalculations++;
+  }
+
+  return std::sqrt(cNorm);
+}
+
+// Split the centroids into groups.
+template<typename MetricType, typename MatType>
+void YinyangKMeans<MetricType, MatType>::FormGroups(const arma::mat& centroids)
+{
+  const size_t k = centroids.n_cols;
+  size_t numGroups = (groups == 0) ? std::max(k / 10, size_t(1)) :
+      std::min(groups, k);
+
+  // Run a few Lloyd iterations on the centroids, starting from the first
+  // centroids (the initial centroids are in no particular order).
+  arma::mat groupCenters = centroids.cols(0, numGroups - 1);
+  centroidGroups.set_size(k);
+  for (size_t iteration = 0; iteration < 5; ++iteration)
+  {
+    for (size_t c = 0; c < k; ++c)
+    {
+      double minDistance = DBL_MAX;
+      for (size_t g = 0; g < numGroups; ++g)
+      {
+        const double distance = metric.Evaluate(centroids.col(c),
+            groupCenters.col(g));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          centroidGroups[c] = g;
+        }
+      }
+    }
+    distanceCalculations += k * numGroups;
+
+    // Empty groups keep their center.
+    arma::mat sums(centroids.n_rows, numGroups, arma::fill::zeros);
+    arma::Col<size_t> groupCounts(numGroups, arma::fill::zeros);
+    for (size_t c = 0; c < k; ++c)
+    {
+      sums.col(centroidGroups[c]) += centroids.col(c);
+      groupCounts[centroidGroups[c]]++;
+    }
+
+    for (size_t g = 0; g < numGroups; ++g)
+      if (groupCounts[g] > 0)
+        groupCenters.col(g) = sums.col(g) / groupCounts[g];
+  }
+
+  // Collect the members of each group, dropping empty groups.
+  std::vector<size_t> newIndices(numGroups, numGroups);
+  groupMembers.clear();
+  for (size_t c = 0; c < k; ++c)
+  {
+    size_t& index = newIndices[centroidGroups[c]];
+    if (index == numGroups)
+    {
+      index = groupMembers.size();
+      groupMembers.push_back(std::vector<size_t>());
+    }
+
+    centroidGroups[c] = index;
+    groupMembers[index].push_back(c);
+  }
+
+  Log::Info << "YinyangKMeans: split " << k << " centroids into "
+      << groupMembers.size() << " groups." << std::endl;
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
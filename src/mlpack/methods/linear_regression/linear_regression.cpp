@@ -12,6 +12,7 @@
  */
 #include "linear_regression.hpp"
 #include <mlpack/core/util/log.hpp>
+#include <mlpack/core/math/parallel_blocks.hpp>
 
 using namespace mlpack;
 using namespace mlpack::regression;
@@ -42,6 +43,14 @@ LinearRegression::LinearRegression(const arma::mat& predictors,
   Train(predictors, responses, weights, intercept);
 }
 
+LinearRegression::LinearRegression(const NormalEquations& equations,
+                                   const double lambda) :
+    lambda(lambda),
+    intercept(equations.Intercept())
+{
+  Train(equations);
+}
+
 void LinearRegression::Train(const arma::mat& predictors,
                              const arma::vec& responses,
                              const bool intercept,
@@ -122,6 +131,12 @@ void LinearRegression::Train(const arma::mat& predictors,
   }
 }
 
+void LinearRegression::Train(const NormalEquations& equations)
+{
+  intercept = equations.Intercept();
+  equations.Solve(parameters, lambda);
+}
+
 void LinearRegression::Predict(const arma::mat& points, arma::vec& predictions)
     const
 {
@@ -133,25 +148,38 @@ void LinearRegression::Predict(const arma::mat& points, arma::vec& predictions)
 void LinearRegression::Predict(const arma::mat& points,
     arma::rowvec& predictions) const
 {
-  if (intercept)
-  {
-    // We want to be sure we have the correct number of dimensions in the
-    // dataset.
-    Log::Assert(points.n_rows == parameters.n_rows - 1);
-    // Get the predictions, but this ignores the intercept value
-    // (parameters[0]).
-    predictions = arma::trans(parameters.subvec(1, parameters.n_elem - 1))
-        * points;
-    // Now add the intercept.
-    predictions += parameters(0);
-  }
-  else
+  PredictBlocks(points, predictions);
+}
+
+void LinearRegression::Predict(const arma::fmat& points,
+    arma::frowvec& predictions) const
+{
+  PredictBlocks(points, predictions);
+}
+
+template<typename ElemType>
+void LinearRegression::PredictBlocks(const arma::Mat<ElemType>& points,
+                                     arma::Row<ElemType>& predictions) const
+{
+  // We want to be sure we have the correct number of dimensions in the
+  // dataset.
+  Log::Assert(points.n_rows == (intercept ? parameters.n_rows - 1 :
+      parameters.n_rows));
+
+  // Get the predictions one block of points at a time; this ignores the
+  // intercept value (parameters[0]), which is added afterwards.
+  const arma::Row<ElemType> weights = intercept ?
+      arma::conv_to<arma::Row<ElemType>>::from(
+          arma::trans(parameters.subvec(1, parameters.n_elem - 1))) :
+      arma::conv_to<arma::Row<ElemType>>::from(arma::trans(parameters));
+  const ElemType offset = intercept ? ElemType(parameters(0)) : ElemType(0);
+  predictions.set_size(points.n_cols);
+  math::ParallelColumnBlocks(points.n_cols,
+      [&](const size_t begin, const size_t end)
   {
-    // We want to be sure we have the correct number of dimensions in
-    // the dataset.
-    Log::Assert(points.n_rows == parameters.n_rows);
-    predictions = arma::trans(parameters) * points;
-  }
+    predictions.subvec(begin, end - 1) = weights * points.cols(begin, end - 1) +
+        offset;
+  });
 }
 
 //! Compute the L2 squared error on the given predictors and responses.
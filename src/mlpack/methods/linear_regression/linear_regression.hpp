@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "normal_equations.hpp"
 
 namespace mlpack {
 namespace regression /** Regression methods. */ {
@@ -21,7 +22,9 @@ namespace regression /** Regression methods. */ {
 /**
  * A simple linear regression algorithm using ordinary least squares.
  * Optionally, this class can perform ridge regression, if the lambda parameter
- * is set to a number greater than zero.
+ * is set to a number greater than zero.  Datasets too large for memory can be
+ * accumulated chunk by chunk in NormalEquations, which the model is then
+ * trained from; this also allows incremental updates.
  */
 class LinearRegression
 {
@@ -69,6 +72,15 @@ class LinearRegression
                    const double lambda = 0,
                    const bool intercept = true);
 
+  /**
+   * Creates the model from the given normal equations, accumulated over the
+   * training data; see NormalEquations.
+   *
+   * @param equations Normal equations of the training data.
+   * @param lambda Regularization constant for ridge regression.
+   */
+  LinearRegression(const NormalEquations& equations, const double lambda = 0);
+
   /**
    * Empty constructor.  This gives a non-working model, so make sure Train() is
    * called (or make sure the model parameters are set) before calling
@@ -125,6 +137,19 @@ class LinearRegression
              const arma::rowvec& weights,
              const bool intercept = true);
 
+  /**
+   * Train the LinearRegression model from the given normal equations,
+   * accumulated over the training data; see NormalEquations.  The intercept
+   * setting is that of the normal equations.  Careful!  This will completely
+   * ignore and overwrite the existing model.  To update the model with new
+   * data, add the data to the same normal equations and call Train() again.
+   * To set the regularization parameter lambda, call Lambda() or set a
+   * different value in the constructor.
+   *
+   * @param equations Normal equations of the training data.
+   */
+  void Train(const NormalEquations& equations);
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -142,6 +167,18 @@ class LinearRegression
    */
   void Predict(const arma::mat& points, arma::rowvec& predictions) const;
 
+  /**
+   * Calculate y_i for each single-precision data point in points.  The points
+   * are scored in single precision against a copy of the parameters converted
+   * once per call, which halves the memory traffic and doubles the SIMD width
+   * of batch scoring.  The model itself is still trained and stored in double
+   * precision.
+   *
+   * @param points the single-precision data points to calculate with.
+   * @param predictions y, will contain calculated values on completion.
+   */
+  void Predict(const arma::fmat& points, arma::frowvec& predictions) const;
+
   /**
    * Calculate the L2 squared error on the given predictors and responses using
    * this linear regression model.  This calculation returns
@@ -221,6 +258,12 @@ class LinearRegression
 
   //! Indicates whether first parameter is intercept.
   bool intercept;
+
+  //! Calculate the predictions one block of points at a time, in the
+  //! precision of the points.
+  template<typename ElemType>
+  void PredictBlocks(const arma::Mat<ElemType>& points,
+                     arma::Row<ElemType>& predictions) const;
 };
 
 } // namespace regression
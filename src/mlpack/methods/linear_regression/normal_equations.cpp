@@ -0,0 +1,177 @@
+/**
+ * @file normal_equations.cpp
+ *
+ * Implementation of the accumulation and solution of the normal equations of
+ * linear regression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "normal_equations.hpp"
+
+using namespace mlpack;
+using namespace mlpack::regression;
+
+NormalEquations::NormalEquations(const size_t dimensionality,
+                                 const bool intercept) :
+    intercept(intercept),
+    gram(dimensionality, dimensionality, arma::fill::zeros),
+    cross(dimensionality, arma::fill::zeros),
+    pointSum(dimensionality, arma::fill::zeros),
+    responseSum(0.0),
+    totalWeight(0.0),
+    numPoints(0)
+{
+  // Nothing to do.
+}
+
+void NormalEquations::Add(const arma::mat& predictors,
+                          const arma::rowvec& responses)
+{
+  Accumulate(predictors, responses, NULL);
+}
+
+void NormalEquations::Add(const arma::mat& predictors,
+                          const arma::rowvec& responses,
+                          const arma::rowvec& weights)
+{
+  if (weights.n_elem != predictors.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NormalEquations::Add(): " << weights.n_elem << " weights given "
+        << "for " << predictors.n_cols << " points";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Accumulate(predictors, responses, &weights);
+}
+
+void NormalEquations::Accumulate(const arma::mat& predictors,
+                                 const arma::rowvec& responses,
+                                 const arma::rowvec* weights)
+{
+  if (predictors.n_rows != gram.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "NormalEquations::Add(): the points have " << predictors.n_rows
+        << " dimensions, but the normal equations have " << gram.n_rows;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (responses.n_elem != predictors.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NormalEquations::Add(): " << responses.n_elem << " responses "
+        << "given for " << predictors.n_cols << " points";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Each thread sums the products of its blocks of points in one matrix
+  // product per block, and the sums of the threads are added at the end.
+  const size_t blockSize = 4096;
+  const size_t blocks = (predictors.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel
+  {
+    arma::mat threadGram(gram.n_rows, gram.n_cols, arma::fill::zeros);
+    arma::vec threadCross(cross.n_elem, arma::fill::zeros);
+    arma::vec threadPointSum(pointSum.n_elem, arma::fill::zeros);
+    double threadResponseSum = 0.0;
+    double threadWeight = 0.0;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) predictors.n_cols) - 1;
+      const arma::mat block = predictors.cols(begin, end);
+      if (weights == NULL)
+      {
+        threadGram += block * block.t();
+        threadCross += block * responses.subvec(begin, end).t();
+        threadPointSum += arma::sum(block, 1);
+        threadResponseSum += arma::accu(responses.subvec(begin, end));
+        threadWeight += (end - begin + 1);
+      }
+      else
+      {
+        const arma::rowvec blockWeights = weights->subvec(begin, end);
+        const arma::mat weighted = block.each_row() % blockWeights;
+        threadGram += weighted * block.t();
+        threadCross += weighted * responses.subvec(begin, end).t();
+        threadPointSum += arma::sum(weighted, 1);
+        threadResponseSum += arma::dot(blockWeights,
+            responses.subvec(begin, end));
+        threadWeight += arma::accu(blockWeights);
+      }
+    }
+
+    #pragma omp critical
+    {
+      gram += threadGram;
+      cross += threadCross;
+      pointSum += threadPointSum;
+      responseSum += threadResponseSum;
+      totalWeight += threadWeight;
+    }
+  }
+
+  numPoints += predictors.n_cols;
+}
+
+void NormalEquations::Merge(const NormalEquations& other)
+{
+  if (other.gram.n_rows != gram.n_rows || other.intercept != intercept)
+  {
+    throw std::invalid_argument("NormalEquations::Merge(): the normal "
+        "equations have a different dimensionality or intercept setting");
+  }
+
+  gram += other.gram;
+  cross += other.cross;
+  pointSum += other.pointSum;
+  responseSum += other.responseSum;
+  totalWeight += other.totalWeight;
+  numPoints += other.numPoints;
+}
+
+void NormalEquations::Solve(arma::vec& parameters, const double lambda) const
+{
+  // With an intercept, the points are augmented with a first dimension equal
+  // to 1, whose sums are the total weight and the sums of the points.
+  const size_t offset = intercept ? 1 : 0;
+  const size_t n = gram.n_rows + offset;
+  arma::mat a(n, n);
+  arma::vec b(n);
+  if (intercept)
+  {
+    a(0, 0) = totalWeight;
+    a.submat(1, 0, n - 1, 0) = pointSum;
+    a.submat(0, 1, 0, n - 1) = pointSum.t();
+    b[0] = responseSum;
+  }
+  a.submat(offset, offset, n - 1, n - 1) = gram;
+  b.subvec(offset, n - 1) = cross;
+
+  // The intercept is not penalized, like in LinearRegression::Train().
+  for (size_t i = offset; i < n; ++i)
+    a(i, i) += lambda;
+
+  if (!arma::solve(parameters, arma::symmatu(a), b))
+  {
+    throw std::runtime_error("NormalEquations::Solve(): the normal equations "
+        "are singular; add more points or use a positive lambda");
+  }
+}
+
+void NormalEquations::Reset()
+{
+  gram.zeros();
+  cross.zeros();
+  pointSum.zeros();
+  responseSum = 0.0;
+  totalWeight = 0.0;
+  numPoints = 0;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file normal_equations.hpp
+ *
+ * Accumulation of the normal equations of least-squares linear regression over
+ * chunks of data, so that models can be trained on datasets that do not fit in
+ * memory, and updated when new data arrives.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_REGRESSION_NORMAL_EQUATIONS_HPP
+#define MLPACK_METHODS_LINEAR_REGRESSION_NORMAL_EQUATIONS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace regression {
+
+/**
+ * The normal equations X^T X b = X^T y of a least-squares problem, accumulated
+ * one chunk of points at a time.  Only sums over the points are kept: X^T X,
+ * X^T y, the sum of the points, the sum of the responses, and the total weight
+ * of the points, so the memory used is quadratic in the dimensionality but does
+ * not depend on the number of points.  This suits datasets with many points
+ * and few dimensions, which can be streamed from disk in chunks:
+ *
+ * @code
+ * NormalEquations equations(dimensionality);
+ * while (LoadNextChunk(predictors, responses))
+ *   equations.Add(predictors, responses);
+ *
+ * LinearRegression lr;
+ * lr.Lambda() = 0.1;
+ * lr.Train(equations);
+ * @endcode
+ *
+ * Each chunk is accumulated with OpenMP threads.  Chunks may also be
+ * accumulated in different NormalEquations objects (for instance, by different
+ * threads or processes) and combined with Merge().  To update a model when new
+ * data arrives, add the new data to the same (possibly serialized) object and
+ * train again; the data seen before is not needed.
+ *
+ * Solving the normal equations squares the condition number of the problem,
+ * so LinearRegression::Train() on the full data (which uses a QR
+ * decomposition) is more accurate for badly conditioned predictors; a
+ * positive lambda also helps.
+ */
+class NormalEquations
+{
+ public:
+  /**
+   * Create empty normal equations for points of the given dimensionality.
+   *
+   * @param dimensionality Number of dimensions of the predictors.
+   * @param intercept Whether or not the model has an intercept term.
+   */
+  NormalEquations(const size_t dimensionality = 0,
+                  const bool intercept = true);
+
+  /**
+   * Add the given points to the normal equations.
+   *
+   * @param predictors X, matrix of data points.
+   * @param responses y, the measured data for each point in X.
+   */
+  void Add(const arma::mat& predictors, const arma::rowvec& responses);
+
+  /**
+   * Add the given weighted points to the normal equations.
+   *
+   * @param predictors X, matrix of data points.
+   * @param responses y, the measured data for each point in X.
+   * @param weights Observation weights (for boosting).
+   */
+  void Add(const arma::mat& predictors,
+           const arma::rowvec& responses,
+           const arma::rowvec& weights);
+
+  /**
+   * Add the points accumulated in the given normal equations, which must have
+   * the same dimensionality and intercept setting.
+   *
+   * @param other Normal equations to merge into these.
+   */
+  void Merge(const NormalEquations& other);
+
+  /**
+   * Solve the normal equations, with Tikhonov regularization lambda for ridge
+   * regression.  As with LinearRegression, the intercept is not penalized, and
+   * it is the first parameter.  A std::runtime_error is thrown if the
+   * equations are singular (for instance, if fewer points than dimensions
+   * were added and lambda is 0).
+   *
+   * @param parameters Output: the parameters (the b vector).
+   * @param lambda Regularization constant for ridge regression.
+   */
+  void Solve(arma::vec& parameters, const double lambda = 0.0) const;
+
+  //! Reset the normal equations, forgetting all added points.
+  void Reset();
+
+  //! Get the dimensionality of the predictors.
+  size_t Dimensionality() const { return gram.n_rows; }
+  //! Get whether or not the model has an intercept term.
+  bool Intercept() const { return intercept; }
+  //! Get the number of points added.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the total weight of the points added (their number if unweighted).
+  double TotalWeight() const { return totalWeight; }
+
+  //! Get X^T X (without the intercept row and column).
+  const arma::mat& Gram() const { return gram; }
+  //! Get X^T y (without the intercept element).
+  const arma::vec& Cross() const { return cross; }
+
+  /**
+   * Serialize the normal equations.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(intercept);
+    ar & BOOST_SERIALIZATION_NVP(gram);
+    ar & BOOST_SERIALIZATION_NVP(cross);
+    ar & BOOST_SERIALIZATION_NVP(pointSum);
+    ar & BOOST_SERIALIZATION_NVP(responseSum);
+    ar & BOOST_SERIALIZATION_NVP(totalWeight);
+    ar & BOOST_SERIALIZATION_NVP(numPoints);
+  }
+
+ private:
+  //! Add the given points, weighted if weights is not NULL.
+  void Accumulate(const arma::mat& predictors,
+                  const arma::rowvec& responses,
+                  const arma::rowvec* weights);
+
+  //! Indicates whether the model has an intercept term.
+  bool intercept;
+  //! The weighted sum of x x^T over the points.
+  arma::mat gram;
+  //! The weighted sum of x y over the points.
+  arma::vec cross;
+  //! The weighted sum of the points.
+  arma::vec pointSum;
+  //! The weighted sum of the responses.
+  double responseSum;
+  //! The sum of the weights.
+  double totalWeight;
+  //! The number of points added.
+  size_t numPoints;
+};
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
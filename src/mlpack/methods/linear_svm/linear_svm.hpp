@@ -0,0 +1,258 @@
+/**
+ * @file linear_svm.hpp
+ *
+ * A linear support vector machine trained with dual coordinate descent, for
+ * binary and one-vs-rest multiclass classification of dense or sparse data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_SVM_LINEAR_SVM_HPP
+#define MLPACK_METHODS_LINEAR_SVM_LINEAR_SVM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <random>
+
+namespace mlpack {
+namespace svm /** Support vector machines. */ {
+
+/**
+ * A linear support vector machine, which minimizes the primal objective
+ *
+ * \f[ 0.5 || w ||^2 + C \sum_i \xi(w, x_i, y_i) \f]
+ *
+ * where the loss xi is the hinge loss max(0, 1 - y_i w^T x_i) or its square,
+ * with the dual coordinate descent method of
+ *
+ * @code
+ * @inproceedings{hsieh2008dual,
+ *   title={A dual coordinate descent method for large-scale linear SVM},
+ *   author={Hsieh, C.-J. and Chang, K.-W. and Lin, C.-J. and Keerthi, S.S. and
+ *       Sundararajan, S.},
+ *   booktitle={Proceedings of the 25th International Conference on Machine
+ *       Learning (ICML '08)},
+ *   pages={408--415},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * which is also the default solver of liblinear.  Each dual coordinate update
+ * costs time proportional to the number of nonzero elements of the point, so
+ * sparse data (arma::sp_mat) is trained on directly.  Points whose dual
+ * variable is stuck at a bound are shrunk from the active set, and the
+ * optimization stops when the projected gradients of the dual variables are
+ * within the tolerance of each other.
+ *
+ * The intercept, if fitted, is the weight of an extra feature with value 1,
+ * so it is regularized like the other weights (as in liblinear).
+ *
+ * With two classes, one classifier separates class 1 from class 0; with more
+ * classes, one classifier per class separates it from the others
+ * (one-vs-rest), the classifiers are trained in parallel, and a point is
+ * assigned to the class with the largest decision value.
+ */
+class LinearSVM
+{
+ public:
+  /**
+   * Create the model without training it.
+   *
+   * @param c Cost of the misclassifications (the regularization is 1 / C).
+   * @param fitIntercept Whether to fit an intercept.
+   * @param squaredHinge Whether to use the squared hinge loss instead of the
+   *     hinge loss.
+   * @param tolerance Tolerance on the largest difference of the projected
+   *     gradients of the dual variables.
+   * @param maxIterations Maximum number of passes over the active points for
+   *     each classifier (0 means no limit).
+   */
+  LinearSVM(const double c = 1.0,
+            const bool fitIntercept = true,
+            const bool squaredHinge = false,
+            const double tolerance = 0.1,
+            const size_t maxIterations = 1000);
+
+  /**
+   * Create the model and train it on the given data.
+   *
+   * @param data Training points, one per column (dense or sparse).
+   * @param labels Labels of the points, between 0 and numClasses - 1.
+   * @param numClasses Number of classes (at least 2).
+   * @param c Cost of the misclassifications (the regularization is 1 / C).
+   * @param fitIntercept Whether to fit an intercept.
+   * @param squaredHinge Whether to use the squared hinge loss instead of the
+   *     hinge loss.
+   * @param tolerance Tolerance on the largest difference of the projected
+   *     gradients of the dual variables.
+   * @param maxIterations Maximum number of passes over the active points for
+   *     each classifier (0 means no limit).
+   */
+  template<typename MatType>
+  LinearSVM(const MatType& data,
+            const arma::Row<size_t>& labels,
+            const size_t numClasses,
+            const double c = 1.0,
+            const bool fitIntercept = true,
+            const bool squaredHinge = false,
+            const double tolerance = 0.1,
+            const size_t maxIterations = 1000);
+
+  /**
+   * Train the model on the given data.  Any previous model is replaced.
+   *
+   * @param data Training points, one per column (dense or sparse).
+   * @param labels Labels of the points, between 0 and numClasses - 1.
+   * @param numClasses Number of classes (at least 2).
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses);
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Points to classify, one per column (dense or sparse).
+   * @param labels Row vector to store the predicted classes in.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& labels) const;
+
+  /**
+   * Classify the given points, and also return their decision values: one row
+   * per classifier (a single row for two classes, where a positive value means
+   * class 1).
+   *
+   * @param data Points to classify, one per column (dense or sparse).
+   * @param labels Row vector to store the predicted classes in.
+   * @param scores Matrix to store the decision values in.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& labels,
+                arma::mat& scores) const;
+
+  /**
+   * Compute the accuracy of the model on the given points, as the percentage
+   * of points that are classified correctly.
+   *
+   * @param data Points to classify, one per column (dense or sparse).
+   * @param labels True labels of the points.
+   */
+  template<typename MatType>
+  double ComputeAccuracy(const MatType& data,
+                         const arma::Row<size_t>& labels) const;
+
+  //! Get the cost of the misclassifications.
+  double C() const { return c; }
+  //! Modify the cost of the misclassifications.
+  double& C() { return c; }
+
+  //! Get whether an intercept is fitted.
+  bool FitIntercept() const { return fitIntercept; }
+  //! Modify whether an intercept is fitted.
+  bool& FitIntercept() { return fitIntercept; }
+
+  //! Get whether the squared hinge loss is used.
+  bool SquaredHinge() const { return squaredHinge; }
+  //! Modify whether the squared hinge loss is used.
+  bool& SquaredHinge() { return squaredHinge; }
+
+  //! Get the tolerance of the dual coordinate descent.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the dual coordinate descent.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the maximum number of passes for each classifier.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of passes for each classifier.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the weights, one column per classifier.
+  const arma::mat& Weights() const { return weights; }
+  //! Modify the weights, one column per classifier.
+  arma::mat& Weights() { return weights; }
+  //! Get the intercepts, one per classifier.
+  const arma::vec& Intercepts() const { return intercepts; }
+  //! Modify the intercepts, one per classifier.
+  arma::vec& Intercepts() { return intercepts; }
+  //! Get the number of passes of each classifier during the last training.
+  const arma::Col<size_t>& Iterations() const { return iterations; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Train the classifier that separates the given class from the others with
+   * dual coordinate descent.
+   *
+   * @param data Training points, one per column.
+   * @param labels Labels of the points.
+   * @param positiveClass Class of the points with a positive label.
+   * @param diagonal Diagonal of the dual Hessian, one element per point.
+   * @param generator Random number generator for the order of the updates.
+   * @param w Vector to store the weights in.
+   * @param intercept Double to store the intercept in.
+   * @return Number of passes over the active points.
+   */
+  template<typename MatType>
+  size_t TrainBinary(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const size_t positiveClass,
+                     const arma::vec& diagonal,
+                     std::mt19937& generator,
+                     arma::vec& w,
+                     double& intercept) const;
+
+  //! Compute the squared norm of every column of a dense matrix.
+  static arma::vec SquaredNorms(const arma::mat& data);
+  //! Compute the squared norm of every column of a sparse matrix.
+  static arma::vec SquaredNorms(const arma::sp_mat& data);
+
+  //! Compute the dot product of a column of a dense matrix with a vector.
+  static double Dot(const arma::mat& data, const size_t column,
+                    const arma::vec& x);
+  //! Compute the dot product of a column of a sparse matrix with a vector.
+  static double Dot(const arma::sp_mat& data, const size_t column,
+                    const arma::vec& x);
+  //! Add a times a column of a dense matrix to a vector.
+  static void Axpy(const double a, const arma::mat& data, const size_t column,
+                   arma::vec& x);
+  //! Add a times a column of a sparse matrix to a vector.
+  static void Axpy(const double a, const arma::sp_mat& data,
+                   const size_t column, arma::vec& x);
+
+  //! The cost of the misclassifications.
+  double c;
+  //! Whether an intercept is fitted.
+  bool fitIntercept;
+  //! Whether the squared hinge loss is used.
+  bool squaredHinge;
+  //! The tolerance of the dual coordinate descent.
+  double tolerance;
+  //! The maximum number of passes for each classifier.
+  size_t maxIterations;
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The weights, one column per classifier.
+  arma::mat weights;
+  //! The intercepts, one per classifier.
+  arma::vec intercepts;
+  //! The number of passes of each classifier during the last training.
+  arma::Col<size_t> iterations;
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "linear_svm_impl.hpp"
+
+#endif
@@ -0,0 +1,362 @@
+/**
+ * @file linear_svm_impl.hpp
+ *
+ * Implementation of the linear support vector machine.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_SVM_LINEAR_SVM_IMPL_HPP
+#define MLPACK_METHODS_LINEAR_SVM_LINEAR_SVM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "linear_svm.hpp"
+
+namespace mlpack {
+namespace svm {
+
+inline LinearSVM::LinearSVM(const double c,
+                            const bool fitIntercept,
+                            const bool squaredHinge,
+                            const double tolerance,
+                            const size_t maxIterations) :
+    c(c),
+    fitIntercept(fitIntercept),
+    squaredHinge(squaredHinge),
+    tolerance(tolerance),
+    maxIterations(maxIterations),
+    numClasses(0)
+{ /* Nothing to do. */ }
+
+template<typename MatType>
+LinearSVM::LinearSVM(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     const double c,
+                     const bool fitIntercept,
+                     const bool squaredHinge,
+                     const double tolerance,
+                     const size_t maxIterations) :
+    c(c),
+    fitIntercept(fitIntercept),
+    squaredHinge(squaredHinge),
+    tolerance(tolerance),
+    maxIterations(maxIterations),
+    numClasses(0)
+{
+  Train(data, labels, numClasses);
+}
+
+template<typename MatType>
+void LinearSVM::Train(const MatType& data,
+                      const arma::Row<size_t>& labels,
+                      const size_t numClasses)
+{
+  if (labels.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "LinearSVM::Train(): the number of labels (" << labels.n_elem
+        << ") does not match the number of points (" << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("LinearSVM::Train(): there must be at least "
+        "two classes!");
+  }
+  if (labels.n_elem > 0 && arma::max(labels) >= numClasses)
+  {
+    std::ostringstream oss;
+    oss << "LinearSVM::Train(): label " << arma::max(labels) << " is not "
+        << "less than the number of classes (" << numClasses << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (c <= 0.0)
+    throw std::invalid_argument("LinearSVM::Train(): C must be positive!");
+
+  this->numClasses = numClasses;
+
+  // The diagonal of the dual Hessian, shared by all the classifiers.  The
+  // squared hinge loss adds 1 / (2 C) to it.
+  arma::vec diagonal = SquaredNorms(data);
+  if (fitIntercept)
+    diagonal += 1.0;
+  if (squaredHinge)
+    diagonal += 0.5 / c;
+
+  // Two classes only need one classifier.
+  const size_t numModels = (numClasses == 2) ? 1 : numClasses;
+  weights.zeros(data.n_rows, numModels);
+  intercepts.zeros(numModels);
+  iterations.zeros(numModels);
+
+  // Draw the seeds first, so that the result does not depend on the order in
+  // which the classifiers are trained.
+  std::vector<size_t> seeds(numModels);
+  for (size_t m = 0; m < numModels; ++m)
+    seeds[m] = (size_t) math::RandInt(std::numeric_limits<int>::max());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t m = 0; m < (omp_size_t) numModels; ++m)
+  {
+    std::mt19937 generator(seeds[m]);
+    arma::vec w;
+    double intercept;
+    iterations[m] = TrainBinary(data, labels, (numModels == 1) ? 1 : m,
+        diagonal, generator, w, intercept);
+
+    weights.col(m) = w;
+    intercepts[m] = intercept;
+  }
+
+  for (size_t m = 0; m < numModels; ++m)
+  {
+    if (maxIterations != 0 && iterations[m] >= maxIterations)
+    {
+      Log::Warn << "LinearSVM::Train(): the classifier of class "
+          << ((numModels == 1) ? 1 : m) << " reached the maximum number of "
+          << "iterations (" << maxIterations << ") before converging."
+          << std::endl;
+    }
+  }
+}
+
+template<typename MatType>
+size_t LinearSVM::TrainBinary(const MatType& data,
+                              const arma::Row<size_t>& labels,
+                              const size_t positiveClass,
+                              const arma::vec& diagonal,
+                              std::mt19937& generator,
+                              arma::vec& w,
+                              double& intercept) const
+{
+  const size_t n = data.n_cols;
+
+  // The dual variables are bounded by C for the hinge loss, and the squared
+  // hinge loss adds alpha_i / (2 C) to the gradient.
+  const double upper = squaredHinge ? std::numeric_limits<double>::infinity() :
+      c;
+  const double shift = squaredHinge ? 0.5 / c : 0.0;
+
+  arma::vec alpha(n, arma::fill::zeros);
+  w.zeros(data.n_rows);
+  intercept = 0.0;
+
+  // The active points are the first activeSize elements of the index.
+  std::vector<size_t> index(n);
+  for (size_t i = 0; i < n; ++i)
+    index[i] = i;
+  size_t activeSize = n;
+
+  // The extreme projected gradients of the previous pass, which decide which
+  // points are shrunk.
+  double maxOld = std::numeric_limits<double>::infinity();
+  double minOld = -std::numeric_limits<double>::infinity();
+
+  size_t iteration = 0;
+  while (maxIterations == 0 || iteration < maxIterations)
+  {
+    ++iteration;
+    double maxNew = -std::numeric_limits<double>::infinity();
+    double minNew = std::numeric_limits<double>::infinity();
+
+    std::shuffle(index.begin(), index.begin() + activeSize, generator);
+
+    size_t s = 0;
+    while (s < activeSize)
+    {
+      const size_t i = index[s];
+      const double y = (labels[i] == positiveClass) ? 1.0 : -1.0;
+      const double g = y * (Dot(data, i, w) + intercept) - 1.0 +
+          shift * alpha[i];
+
+      // Compute the projected gradient, and shrink the points at a bound that
+      // are unlikely to move.
+      double projected = g;
+      if (alpha[i] == 0.0)
+      {
+        if (g > maxOld)
+        {
+          std::swap(index[s], index[--activeSize]);
+          continue;
+        }
+        projected = std::min(g, 0.0);
+      }
+      else if (alpha[i] == upper)
+      {
+        if (g < minOld)
+        {
+          std::swap(index[s], index[--activeSize]);
+          continue;
+        }
+        projected = std::max(g, 0.0);
+      }
+
+      maxNew = std::max(maxNew, projected);
+      minNew = std::min(minNew, projected);
+
+      if (std::abs(projected) > 1e-12)
+      {
+        // Minimize the dual exactly along alpha_i.  A zero point (without
+        // intercept) makes the dual linear along alpha_i.
+        const double old = alpha[i];
+        if (diagonal[i] > 0.0)
+          alpha[i] = std::min(std::max(old - g / diagonal[i], 0.0), upper);
+        else
+          alpha[i] = (g < 0.0) ? upper : 0.0;
+
+        const double delta = (alpha[i] - old) * y;
+        Axpy(delta, data, i, w);
+        if (fitIntercept)
+          intercept += delta;
+      }
+
+      ++s;
+    }
+
+    if (maxNew - minNew <= tolerance)
+    {
+      // Converged on the active points; stop if none were shrunk, and check
+      // all the points again otherwise.
+      if (activeSize == n)
+        break;
+
+      activeSize = n;
+      maxOld = std::numeric_limits<double>::infinity();
+      minOld = -std::numeric_limits<double>::infinity();
+      continue;
+    }
+
+    maxOld = (maxNew <= 0.0) ? std::numeric_limits<double>::infinity() :
+        maxNew;
+    minOld = (minNew >= 0.0) ? -std::numeric_limits<double>::infinity() :
+        minNew;
+  }
+
+  return iteration;
+}
+
+template<typename MatType>
+void LinearSVM::Classify(const MatType& data, arma::Row<size_t>& labels) const
+{
+  arma::mat scores;
+  Classify(data, labels, scores);
+}
+
+template<typename MatType>
+void LinearSVM::Classify(const MatType& data,
+                         arma::Row<size_t>& labels,
+                         arma::mat& scores) const
+{
+  if (data.n_rows != weights.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "LinearSVM::Classify(): the points have " << data.n_rows
+        << " dimensions, but the model was trained on " << weights.n_rows
+        << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  scores = weights.t() * data;
+  scores.each_col() += intercepts;
+
+  labels.set_size(data.n_cols);
+  if (scores.n_rows == 1)
+  {
+    for (size_t i = 0; i < scores.n_cols; ++i)
+      labels[i] = (scores(0, i) > 0.0) ? 1 : 0;
+  }
+  else
+  {
+    for (size_t i = 0; i < scores.n_cols; ++i)
+    {
+      arma::uword best;
+      scores.col(i).max(best);
+      labels[i] = best;
+    }
+  }
+}
+
+template<typename MatType>
+double LinearSVM::ComputeAccuracy(const MatType& data,
+                                  const arma::Row<size_t>& labels) const
+{
+  arma::Row<size_t> predictions;
+  Classify(data, predictions);
+
+  const size_t correct = arma::accu(predictions == labels);
+  return (100.0 * correct) / std::max((size_t) labels.n_elem, (size_t) 1);
+}
+
+template<typename Archive>
+void LinearSVM::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(c);
+  ar & BOOST_SERIALIZATION_NVP(fitIntercept);
+  ar & BOOST_SERIALIZATION_NVP(squaredHinge);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(intercepts);
+}
+
+inline arma::vec LinearSVM::SquaredNorms(const arma::mat& data)
+{
+  return arma::sum(arma::square(data), 0).t();
+}
+
+inline arma::vec LinearSVM::SquaredNorms(const arma::sp_mat& data)
+{
+  // This also brings the compressed arrays up to date before they are read
+  // in parallel.
+  data.sync();
+  arma::vec norms(data.n_cols, arma::fill::zeros);
+  for (size_t j = 0; j < data.n_cols; ++j)
+    for (size_t i = data.col_ptrs[j]; i < data.col_ptrs[j + 1]; ++i)
+      norms[j] += data.values[i] * data.values[i];
+
+  return norms;
+}
+
+inline double LinearSVM::Dot(const arma::mat& data,
+                             const size_t column,
+                             const arma::vec& x)
+{
+  return arma::dot(data.unsafe_col(column), x);
+}
+
+inline double LinearSVM::Dot(const arma::sp_mat& data,
+                             const size_t column,
+                             const arma::vec& x)
+{
+  double result = 0.0;
+  for (size_t i = data.col_ptrs[column]; i < data.col_ptrs[column + 1]; ++i)
+    result += data.values[i] * x[data.row_indices[i]];
+
+  return result;
+}
+
+inline void LinearSVM::Axpy(const double a,
+                            const arma::mat& data,
+                            const size_t column,
+                            arma::vec& x)
+{
+  x += a * data.unsafe_col(column);
+}
+
+inline void LinearSVM::Axpy(const double a,
+                            const arma::sp_mat& data,
+                            const size_t column,
+                            arma::vec& x)
+{
+  for (size_t i = data.col_ptrs[column]; i < data.col_ptrs[column + 1]; ++i)
+    x[data.row_indices[i]] += a * data.values[i];
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif
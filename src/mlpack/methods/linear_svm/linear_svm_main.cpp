@@ -0,0 +1,282 @@
+/**
+ * @file linear_svm_main.cpp
+ *
+ * Main executable for the linear support vector machine.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/data/load_svmlight.hpp>
+
+#include "linear_svm.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::svm;
+using namespace mlpack::util;
+
+PROGRAM_INFO("Linear Support Vector Machine",
+    "An implementation of the linear support vector machine (SVM), trained "
+    "with dual coordinate descent (the default solver of liblinear).  It "
+    "minimizes the sum of the L2-regularization 0.5 ||w||^2 and of the "
+    "hinge loss (or, with " + PRINT_PARAM_STRING("squared_hinge") + ", the "
+    "squared hinge loss) of the points weighted by C."
+    "\n\n"
+    "This program allows training a linear SVM model on a training set "
+    "(specified with the " + PRINT_PARAM_STRING("training") + " parameter) or "
+    "loading an existing model (with the " +
+    PRINT_PARAM_STRING("input_model") + " parameter), and classifying a test "
+    "set (specified with the " + PRINT_PARAM_STRING("test") + " parameter); "
+    "the predictions may be saved with the " + PRINT_PARAM_STRING("output") +
+    " output parameter, the decision values with the " +
+    PRINT_PARAM_STRING("output_scores") + " output parameter, and the trained "
+    "model with the " + PRINT_PARAM_STRING("output_model") + " output "
+    "parameter."
+    "\n\n"
+    "The training data may have the labels as its last dimension, or the "
+    "labels can be given separately with the " + PRINT_PARAM_STRING("labels") +
+    " parameter.  The labels must be between 0 and the number of classes minus "
+    "one.  With two classes, a single classifier separates class 1 from class "
+    "0; with more classes, one classifier per class is trained in parallel "
+    "(one-vs-rest)."
+    "\n\n"
+    "Sparse data can be given instead as a file in the SVMLight format with "
+    "the " + PRINT_PARAM_STRING("training_svmlight") + " and " +
+    PRINT_PARAM_STRING("test_svmlight") + " parameters, and is trained on "
+    "directly.  The labels are read from the file: if there are two labels and"
+    " the smallest is not positive (such as -1 and +1), the positive label is "
+    "class 1 and the other is class 0; otherwise the labels must be "
+    "nonnegative integers, which are the classes."
+    "\n\n"
+    "The cost of the misclassifications is set with " +
+    PRINT_PARAM_STRING("c") + ", and an intercept is fitted unless " +
+    PRINT_PARAM_STRING("no_intercept") + " is given.  The optimization stops "
+    "when the projected gradients of the dual problem are within " +
+    PRINT_PARAM_STRING("tolerance") + " of each other, or after " +
+    PRINT_PARAM_STRING("max_iterations") + " passes over the data."
+    "\n\n"
+    "As an example, to train a linear SVM on the data '" +
+    PRINT_DATASET("data") + "' with labels '" + PRINT_DATASET("labels") + "' "
+    "and C = 10, saving the model to '" + PRINT_MODEL("svm_model") + "', the "
+    "following command may be used:"
+    "\n\n" +
+    PRINT_CALL("linear_svm", "training", "data", "labels", "labels", "c", 10.0,
+        "output_model", "svm_model") +
+    "\n\n"
+    "Then, to use that model to predict the classes of the dataset '" +
+    PRINT_DATASET("test") + "', storing the predictions in '" +
+    PRINT_DATASET("predictions") + "', the following command may be used:"
+    "\n\n" +
+    PRINT_CALL("linear_svm", "input_model", "svm_model", "test", "test",
+        "output", "predictions"));
+
+// Training parameters.
+PARAM_MATRIX_IN("training", "A matrix containing the training set.", "t");
+PARAM_UROW_IN("labels", "A matrix containing the labels of the points in the "
+    "training set.", "l");
+PARAM_STRING_IN("training_svmlight", "File containing a sparse training set "
+    "and its labels in the SVMLight format (instead of the training set).",
+    "S", "");
+
+// Solver parameters.
+PARAM_DOUBLE_IN("c", "Cost of the misclassifications (the regularization is "
+    "1 / C).", "c", 1.0);
+PARAM_FLAG("squared_hinge", "Use the squared hinge loss instead of the hinge "
+    "loss.", "q");
+PARAM_FLAG("no_intercept", "Do not fit an intercept.", "N");
+PARAM_DOUBLE_IN("tolerance", "Tolerance on the projected gradients of the dual "
+    "problem.", "e", 0.1);
+PARAM_INT_IN("max_iterations", "Maximum number of passes over the data for "
+    "each classifier (0 indicates no limit).", "n", 1000);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+// Model loading/saving.
+PARAM_MODEL_IN(LinearSVM, "input_model", "Existing model.", "m");
+PARAM_MODEL_OUT(LinearSVM, "output_model", "Output for the trained linear SVM "
+    "model.", "M");
+
+// Testing.
+PARAM_MATRIX_IN("test", "Matrix containing the test dataset.", "T");
+PARAM_STRING_IN("test_svmlight", "File containing a sparse test dataset in "
+    "the SVMLight format (instead of the test dataset); its labels are "
+    "ignored.", "E", "");
+PARAM_UROW_OUT("output", "If test data is specified, this matrix is where "
+    "the predictions for the test set will be saved.", "o");
+PARAM_MATRIX_OUT("output_scores", "If test data is specified, this matrix is "
+    "where the decision values of the test set will be saved (one row per "
+    "classifier).", "p");
+
+// Convert the labels of an SVMLight file to classes.
+static arma::Row<size_t> SVMLightClasses(const arma::rowvec& labels)
+{
+  if (labels.n_elem == 0)
+    return arma::Row<size_t>();
+
+  const arma::rowvec values = arma::unique(labels);
+  if (values.n_elem <= 2 && values[0] <= 0.0)
+    return arma::conv_to<arma::Row<size_t>>::from(labels > 0.0);
+
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    if (labels[i] < 0.0 || labels[i] != std::floor(labels[i]))
+    {
+      Log::Fatal << "The labels must be two values (such as -1 and +1) or "
+          << "nonnegative integers, not " << labels[i] << "!" << endl;
+    }
+  }
+
+  return arma::conv_to<arma::Row<size_t>>::from(labels);
+}
+
+// Predict the classes (and decision values) of the test set, as requested on
+// the command line.
+template<typename MatType>
+static void PredictTestSet(const LinearSVM& model,
+                           const MatType& testSet,
+                           const string& testName)
+{
+  Log::Info << "Classifying points in '" << testName << "'." << endl;
+
+  arma::Row<size_t> predictions;
+  arma::mat scores;
+  Timer::Start("linear_svm_classification");
+  model.Classify(testSet, predictions, scores);
+  Timer::Stop("linear_svm_classification");
+
+  if (CLI::HasParam("output"))
+    CLI::GetParam<arma::Row<size_t>>("output") = std::move(predictions);
+  if (CLI::HasParam("output_scores"))
+    CLI::GetParam<arma::mat>("output_scores") = std::move(scores);
+}
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  // Exactly one of the training sets and the input model must be given.
+  RequireOnlyOnePassed({ "training", "training_svmlight", "input_model" },
+      true);
+  if (CLI::HasParam("test_svmlight"))
+    RequireOnlyOnePassed({ "test", "test_svmlight" }, true);
+  ReportIgnoredParam({{ "training", false }}, "labels");
+
+  if (CLI::HasParam("training") || CLI::HasParam("training_svmlight"))
+  {
+    RequireAtLeastOnePassed({ "output_model" }, false, "trained model will not "
+        "be saved");
+  }
+  RequireAtLeastOnePassed({ "output_model", "output", "output_scores" }, false,
+      "no output will be saved");
+
+  ReportIgnoredParam({{ "test", false }, { "test_svmlight", false }},
+      "output");
+  ReportIgnoredParam({{ "test", false }, { "test_svmlight", false }},
+      "output_scores");
+
+  RequireParamValue<double>("c", [](double x) { return x > 0.0; }, true,
+      "C must be positive");
+  RequireParamValue<double>("tolerance", [](double x) { return x > 0.0; },
+      true, "tolerance must be positive");
+  RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
+      "max_iterations must be positive or zero");
+
+  LinearSVM* model;
+  if (CLI::HasParam("input_model"))
+  {
+    model = CLI::GetParam<LinearSVM*>("input_model");
+  }
+  else
+  {
+    model = new LinearSVM(CLI::GetParam<double>("c"),
+        !CLI::HasParam("no_intercept"), CLI::HasParam("squared_hinge"),
+        CLI::GetParam<double>("tolerance"),
+        (size_t) CLI::GetParam<int>("max_iterations"));
+
+    if (CLI::HasParam("training"))
+    {
+      arma::mat data = std::move(CLI::GetParam<arma::mat>("training"));
+      arma::Row<size_t> labels;
+      if (CLI::HasParam("labels"))
+      {
+        labels = std::move(CLI::GetParam<arma::Row<size_t>>("labels"));
+      }
+      else
+      {
+        if (data.n_rows < 2)
+        {
+          delete model;
+          Log::Fatal << "Can't get labels from training data since it has "
+              << "less than 2 rows." << endl;
+        }
+
+        labels = arma::conv_to<arma::Row<size_t>>::from(
+            data.row(data.n_rows - 1));
+        data.shed_row(data.n_rows - 1);
+      }
+
+      if (labels.n_elem != data.n_cols)
+      {
+        delete model;
+        Log::Fatal << "The labels must have the same number of points as the "
+            << "training dataset." << endl;
+      }
+
+      const size_t numClasses = std::max((size_t) arma::max(labels) + 1,
+          (size_t) 2);
+      Timer::Start("linear_svm_training");
+      model->Train(data, labels, numClasses);
+      Timer::Stop("linear_svm_training");
+    }
+    else
+    {
+      arma::sp_mat data;
+      arma::rowvec rawLabels;
+      data::LoadSVMLight(CLI::GetParam<string>("training_svmlight"), data,
+          rawLabels, true);
+      const arma::Row<size_t> labels = SVMLightClasses(rawLabels);
+
+      const size_t numClasses = std::max((size_t) arma::max(labels) + 1,
+          (size_t) 2);
+      Timer::Start("linear_svm_training");
+      model->Train(data, labels, numClasses);
+      Timer::Stop("linear_svm_training");
+    }
+  }
+
+  if (CLI::HasParam("test_svmlight"))
+  {
+    // The test set must have the features of the training set.
+    arma::sp_mat testSet;
+    arma::rowvec testLabels;
+    data::LoadSVMLight(CLI::GetParam<string>("test_svmlight"), testSet,
+        testLabels, true, model->Weights().n_rows);
+    PredictTestSet(*model, testSet, CLI::GetParam<string>("test_svmlight"));
+  }
+  else if (CLI::HasParam("test"))
+  {
+    const arma::mat testSet = std::move(CLI::GetParam<arma::mat>("test"));
+    const size_t trainingDimensionality = model->Weights().n_rows;
+    if (testSet.n_rows != trainingDimensionality)
+    {
+      if (!CLI::HasParam("input_model"))
+        delete model;
+
+      Log::Fatal << "Test data dimensionality (" << testSet.n_rows << ") "
+          << "must be the same as the dimensionality of the training data ("
+          << trainingDimensionality << ")!" << endl;
+    }
+
+    PredictTestSet(*model, testSet, CLI::GetPrintableParam<arma::mat>("test"));
+  }
+
+  CLI::GetParam<LinearSVM*>("output_model") = model;
+}
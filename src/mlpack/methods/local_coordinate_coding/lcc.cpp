@@ -35,31 +35,38 @@ void LocalCoordinateCoding::Encode(const arma::mat& data, arma::mat& codes)
       * data);
 
   arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
 
+  Log::Debug << "Optimizing the codes of " << data.n_cols << " points."
+      << std::endl;
+
+  // The code of each point is an independent LARS problem.  Each thread has
+  // its own LARS object and buffers; the weighted Gram matrix of each point is
+  // computed from the shared Gram matrix of the dictionary.
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; i++)
+  #pragma omp parallel
   {
-    // Report progress.
-    if ((i % 100) == 0)
-    {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-    }
-
-    arma::vec invW = invSqDists.unsafe_col(i);
-    arma::mat dictPrime = dictionary * diagmat(invW);
-
-    arma::mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
-
+    arma::mat dictPrime;
+    arma::mat dictGramTD;
     bool useCholesky = false;
     regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
 
-    // Run LARS for this point, by making an alias of the point and passing
-    // that.
-    arma::vec beta = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictPrime, responses, beta, false);
-    beta %= invW; // Remember, beta is an alias of codes.col(i).
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      const arma::vec invW = invSqDists.unsafe_col(i);
+      dictPrime = dictionary;
+      dictPrime.each_row() %= invW.t();
+
+      // This is diagmat(invW) * dictGram * diagmat(invW).
+      dictGramTD = dictGram % (invW * invW.t());
+
+      // Run LARS for this point, by making an alias of the point and passing
+      // that.
+      arma::vec beta = codes.unsafe_col(i);
+      arma::rowvec responses = data.unsafe_col(i).t();
+      lars.Train(dictPrime, responses, beta, false);
+      beta %= invW; // Remember, beta is an alias of codes.col(i).
+    }
   }
 }
 
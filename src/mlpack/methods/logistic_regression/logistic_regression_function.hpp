@@ -119,6 +119,28 @@ class LogisticRegressionFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with the given parameters, for the given batch size from a given point in
+   * the dataset, as a sparse vector.  Only the intercept, the features that are
+   * nonzero in the batch and (if lambda is not 0) the nonzero parameters have a
+   * nonzero gradient, so with sparse predictors the cost is proportional to the
+   * number of nonzero elements of the batch instead of the dimensionality.
+   * This is useful for optimizers such as parallel SGD, which only update the
+   * nonzero elements of the gradient.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the starting point to use for objective function
+   *     gradient evaluation.
+   * @param gradient Sparse vector to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *     function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
    * with the given parameters, and with respect to only one feature in the
@@ -166,8 +166,12 @@ void LogisticRegressionFunction<MatType>::Gradient(
 
   gradient.set_size(arma::size(parameters));
   gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  // Multiplying the predictors by the errors avoids transposing them, which
+  // is expensive when they are sparse.
+  const arma::vec errors = arma::trans(sigmoids -
+      arma::conv_to<arma::rowvec>::from(responses));
+  gradient.tail_cols(parameters.n_elem - 1) = arma::trans(predictors * errors) +
+      regularization;
 }
 
 //! Evaluate the gradient of the logistic regression objective function for a
@@ -194,9 +198,59 @@ void LogisticRegressionFunction<MatType>::Gradient(
   gradient.set_size(parameters.n_rows, parameters.n_cols);
   gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
       sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  const arma::vec errors = arma::trans(sigmoids - arma::conv_to<arma::rowvec>::
+      from(responses.subvec(begin, begin + batchSize - 1)));
+  gradient.tail_cols(parameters.n_elem - 1) = arma::trans(
+      predictors.cols(begin, begin + batchSize - 1) * errors) + regularization;
+}
+
+//! Evaluate the gradient of the logistic regression objective function for a
+//! given batch size, as a sparse vector.
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize) const
+{
+  const arma::sp_mat batch(predictors.cols(begin, begin + batchSize - 1));
+  batch.sync();
+
+  const arma::rowvec exponents = parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) * batch;
+  const arma::rowvec errors = 1.0 / (1.0 + arma::exp(-exponents)) -
+      arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
+      begin + batchSize - 1));
+
+  // The regularization only touches the nonzero parameters (but not the
+  // intercept).
+  const double scale = lambda / predictors.n_cols * batchSize;
+  const arma::uvec regularized = (lambda == 0.0) ? arma::uvec() :
+      arma::uvec(arma::find(parameters.tail_cols(parameters.n_elem - 1)));
+
+  // Collect the contributions of every nonzero element of the batch; the
+  // duplicate locations are summed by the batch constructor.
+  arma::umat locations(2, 1 + batch.n_nonzero + regularized.n_elem,
+      arma::fill::zeros);
+  arma::vec values(locations.n_cols);
+  values[0] = arma::accu(errors);
+  size_t index = 1;
+  for (size_t j = 0; j < batch.n_cols; ++j)
+  {
+    for (size_t k = batch.col_ptrs[j]; k < batch.col_ptrs[j + 1]; ++k)
+    {
+      locations(1, index) = batch.row_indices[k] + 1;
+      values[index++] = errors[j] * batch.values[k];
+    }
+  }
+  for (size_t i = 0; i < regularized.n_elem; ++i)
+  {
+    locations(1, index) = regularized[i] + 1;
+    values[index++] = scale * parameters[regularized[i] + 1];
+  }
+
+  gradient = arma::sp_mat(true, locations, values, parameters.n_rows,
+      parameters.n_cols);
 }
 
 /**
@@ -245,8 +299,12 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
 
   gradient.set_size(arma::size(parameters));
   gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  // Multiplying the predictors by the errors avoids transposing them, which
+  // is expensive when they are sparse.
+  const arma::vec errors = arma::trans(sigmoids -
+      arma::conv_to<arma::rowvec>::from(responses));
+  gradient.tail_cols(parameters.n_elem - 1) = arma::trans(predictors * errors) +
+      regularization;
 
   // Now compute the objective function using the sigmoids.
   double result = arma::accu(arma::log(1.0 -
@@ -283,9 +341,10 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
   gradient.set_size(parameters.n_rows, parameters.n_cols);
   gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
       sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  const arma::vec errors = arma::trans(sigmoids - arma::conv_to<arma::rowvec>::
+      from(responses.subvec(begin, begin + batchSize - 1)));
+  gradient.tail_cols(parameters.n_elem - 1) = arma::trans(
+      predictors.cols(begin, begin + batchSize - 1) * errors) + regularization;
 
   // Now compute the objective function using the sigmoids.
   arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
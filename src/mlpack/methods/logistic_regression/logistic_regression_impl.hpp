@@ -95,6 +95,36 @@ void LogisticRegression<MatType>::Train(
       << "trained model is " << out << "." << std::endl;
 }
 
+template<typename MatType>
+template<typename LoaderType, typename OptimizerType>
+size_t LogisticRegression<MatType>::Update(LoaderType& loader,
+                                           OptimizerType& optimizer)
+{
+  MatType predictors;
+  arma::Row<size_t> responses;
+  size_t batches = 0;
+  while (loader(predictors, responses))
+  {
+    if (predictors.n_cols == 0)
+      continue;
+
+    if (predictors.n_rows + 1 != parameters.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "LogisticRegression::Update(): batch has dimensionality "
+          << predictors.n_rows << ", but the model has dimensionality "
+          << parameters.n_elem - 1 << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    Train(predictors, responses, optimizer);
+    ++batches;
+  }
+
+  Log::Info << "LogisticRegression::Update(): updated the model with "
+      << batches << " batches." << std::endl;
+  return batches;
+}
 
 template<typename MatType>
 void LogisticRegression<MatType>::Predict(const MatType& predictors,
@@ -120,24 +150,88 @@ void LogisticRegression<MatType>::Classify(const MatType& dataset,
                                            arma::Row<size_t>& labels,
                                            const double decisionBoundary) const
 {
-  // Calculate sigmoid function for each point.  The (1.0 - decisionBoundary)
-  // term correctly sets an offset so that floor() returns 0 or 1 correctly.
-  labels = arma::conv_to<arma::Row<size_t>>::from((1.0 /
-      (1.0 + arma::exp(-parameters(0) -
-      parameters.tail_cols(parameters.n_elem - 1) * dataset))) +
-      (1.0 - decisionBoundary));
+  ClassLabels(dataset, labels, decisionBoundary);
 }
 
 template<typename MatType>
 void LogisticRegression<MatType>::Classify(const MatType& dataset,
                                            arma::mat& probabilities) const
 {
+  ClassProbabilities(dataset, probabilities);
+}
+
+template<typename MatType>
+template<typename ElemType>
+void LogisticRegression<MatType>::Classify(const arma::Mat<ElemType>& dataset,
+                                           arma::Row<size_t>& labels,
+                                           const double decisionBoundary) const
+{
+  ClassLabels(dataset, labels, decisionBoundary);
+}
+
+template<typename MatType>
+template<typename ElemType>
+void LogisticRegression<MatType>::Classify(
+    const arma::Mat<ElemType>& dataset,
+    arma::Mat<ElemType>& probabilities) const
+{
+  ClassProbabilities(dataset, probabilities);
+}
+
+template<typename MatType>
+template<typename DataType>
+void LogisticRegression<MatType>::ClassLabels(
+    const DataType& dataset,
+    arma::Row<size_t>& labels,
+    const double decisionBoundary) const
+{
+  typedef typename DataType::elem_type ElemType;
+
+  // Calculate sigmoid function for each point, one block at a time, so that
+  // each block of scores is thresholded while it is in cache.  The
+  // (1.0 - decisionBoundary) term correctly sets an offset so that the
+  // truncation returns 0 or 1 correctly.
+  const arma::Row<ElemType> weights = arma::conv_to<arma::Row<ElemType>>::from(
+      parameters.tail_cols(parameters.n_elem - 1));
+  const double intercept = parameters(0);
+  labels.set_size(dataset.n_cols);
+  math::ParallelColumnBlocks(dataset.n_cols,
+      [&](const size_t begin, const size_t end)
+  {
+    const arma::Row<ElemType> scores = weights * dataset.cols(begin, end - 1);
+    for (size_t i = 0; i < scores.n_elem; ++i)
+    {
+      labels[begin + i] = size_t(1.0 / (1.0 + std::exp(-intercept -
+          scores[i])) + (1.0 - decisionBoundary));
+    }
+  });
+}
+
+template<typename MatType>
+template<typename DataType, typename ProbabilitiesType>
+void LogisticRegression<MatType>::ClassProbabilities(
+    const DataType& dataset,
+    ProbabilitiesType& probabilities) const
+{
+  typedef typename DataType::elem_type ElemType;
+
   // Set correct size of output matrix.
   probabilities.set_size(2, dataset.n_cols);
 
-  probabilities.row(1) = 1.0 / (1.0 + arma::exp(-parameters(0) -
-      parameters.tail_cols(parameters.n_elem - 1) * dataset));
-  probabilities.row(0) = 1.0 - probabilities.row(1);
+  const arma::Row<ElemType> weights = arma::conv_to<arma::Row<ElemType>>::from(
+      parameters.tail_cols(parameters.n_elem - 1));
+  const double intercept = parameters(0);
+  math::ParallelColumnBlocks(dataset.n_cols,
+      [&](const size_t begin, const size_t end)
+  {
+    const arma::Row<ElemType> scores = weights * dataset.cols(begin, end - 1);
+    for (size_t i = 0; i < scores.n_elem; ++i)
+    {
+      const double p = 1.0 / (1.0 + std::exp(-intercept - scores[i]));
+      probabilities(1, begin + i) = p;
+      probabilities(0, begin + i) = 1.0 - p;
+    }
+  });
 }
 
 template<typename MatType>
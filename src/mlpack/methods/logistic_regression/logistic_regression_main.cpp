@@ -15,6 +15,8 @@
 
 #include "logistic_regression.hpp"
 
+#include <mlpack/core/data/load_svmlight.hpp>
+#include <mlpack/core/data/transform_stream.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
 
 using namespace std;
@@ -47,6 +49,14 @@ PROGRAM_INFO("L2-regularized Logistic Regression and Prediction",
     "dimension.  Alternately, the " + PRINT_PARAM_STRING("labels") + " "
     "parameter may be used to specify a separate matrix of labels."
     "\n\n"
+    "Sparse data can be given instead as a file in the SVMLight format with "
+    "the " + PRINT_PARAM_STRING("training_svmlight") + " parameter (then the "
+    "labels are read from the file, and positive labels are class 1) and the " +
+    PRINT_PARAM_STRING("test_svmlight") + " parameter.  The model is trained "
+    "on the sparse matrix directly, which is much faster than on the "
+    "equivalent dense matrix when most of the features are zero, and the saved "
+    "model is the same as for dense data."
+    "\n\n"
     "When a model is being trained, there are many options.  L2 regularization "
     "(to prevent overfitting) can be specified with the " +
     PRINT_PARAM_STRING("lambda") + " option, and the "
@@ -78,6 +88,13 @@ PROGRAM_INFO("L2-regularized Logistic Regression and Prediction",
     "from the logistic regression model may be saved with the " +
     PRINT_PARAM_STRING("output") + " parameter."
     "\n\n"
+    "A test set given as '-' is read from the standard input, and an output "
+    "given as '-' is written to the standard output, as CSV ('-.bin' or "
+    "'-.txt' select another format).  When the test set is read from the "
+    "standard input as text and only one text output is requested, the points "
+    "are predicted a batch at a time as they arrive, so the program can be "
+    "piped between other programs."
+    "\n\n"
     "This implementation of logistic regression does not support the general "
     "multi-class case but instead only the two-class case.  Any labels must "
     "be either 0 or 1.  For more classes, see the softmax_regression program."
@@ -102,6 +119,9 @@ PARAM_MATRIX_IN("training", "A matrix containing the training set (the matrix "
     "of predictors, X).", "t");
 PARAM_UROW_IN("labels", "A matrix containing labels (0 or 1) for the points "
     "in the training set (y).", "l");
+PARAM_STRING_IN("training_svmlight", "File containing a sparse training set "
+    "and its labels in the SVMLight format (instead of the training set).",
+    "S", "");
 
 // Optimizer parameters.
 PARAM_DOUBLE_IN("lambda", "L2-regularization parameter for training.", "L",
@@ -124,6 +144,9 @@ PARAM_MODEL_OUT(LogisticRegression<>, "output_model", "Output for trained "
 
 // Testing.
 PARAM_MATRIX_IN("test", "Matrix containing test dataset.", "T");
+PARAM_STRING_IN("test_svmlight", "File containing a sparse test dataset in "
+    "the SVMLight format (instead of the test dataset); its labels are "
+    "ignored.", "E", "");
 PARAM_UROW_OUT("output", "If test data is specified, this matrix is where "
     "the predictions for the test set will be saved.", "o");
 PARAM_MATRIX_OUT("output_probabilities", "If test data is specified, this "
@@ -133,23 +156,53 @@ PARAM_DOUBLE_IN("decision_boundary", "Decision boundary for prediction; if the "
     "logistic function for a point is less than the boundary, the class is "
     "taken to be 0; otherwise, the class is 1.", "d", 0.5);
 
+// Train the model with the optimizer given on the command line.
+template<typename MatType>
+void TrainModel(LogisticRegression<MatType>& model,
+                const MatType& regressors,
+                const arma::Row<size_t>& responses);
+
+// Predict the classes (and probabilities) of the test set, as requested on the
+// command line.
+template<typename MatType>
+void PredictTestSet(const arma::rowvec& parameters,
+                    const MatType& testSet,
+                    const string& testName);
+
+// Predict the classes (or probabilities) of the test set a batch at a time, as
+// it is read from the standard input.
+void PredictTestStream(const arma::rowvec& parameters,
+                       const size_t dimensionality);
+
+// Return the output requested on the command line, if there is only one.
+static string SingleOutput()
+{
+  if (CLI::HasParam("output") == CLI::HasParam("output_probabilities"))
+    return "";
+
+  return CLI::HasParam("output") ?
+      CLI::GetPrintableParam<arma::Row<size_t>>("output") :
+      CLI::GetPrintableParam<arma::mat>("output_probabilities");
+}
+
 static void mlpackMain()
 {
   // Collect command-line options.
   const double lambda = CLI::GetParam<double>("lambda");
   const string optimizerType = CLI::GetParam<string>("optimizer");
-  const double tolerance = CLI::GetParam<double>("tolerance");
-  const double stepSize = CLI::GetParam<double>("step_size");
-  const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
-  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
-  const double decisionBoundary = CLI::GetParam<double>("decision_boundary");
 
   // One of training and input_model must be specified.
-  RequireAtLeastOnePassed({ "training", "input_model" }, true);
+  RequireAtLeastOnePassed({ "training", "training_svmlight", "input_model" },
+      true);
+  if (CLI::HasParam("training_svmlight"))
+    RequireOnlyOnePassed({ "training", "training_svmlight" }, true);
+  if (CLI::HasParam("test_svmlight"))
+    RequireOnlyOnePassed({ "test", "test_svmlight" }, true);
+  ReportIgnoredParam({{ "training_svmlight", true }}, "labels");
 
   // If no output file is given, the user should know that the model will not be
   // saved, but only if a model is being trained.
-  if (CLI::HasParam("training"))
+  if (CLI::HasParam("training") || CLI::HasParam("training_svmlight"))
   {
     RequireAtLeastOnePassed({ "output_model" }, false, "trained model will not "
         "be saved");
@@ -158,8 +211,10 @@ static void mlpackMain()
   RequireAtLeastOnePassed({ "output_model", "output", "output_probabilities" },
       false, "no output will be saved");
 
-  ReportIgnoredParam({{ "test", false }}, "output");
-  ReportIgnoredParam({{ "test", false }}, "output_probabilities");
+  ReportIgnoredParam({{ "test", false }, { "test_svmlight", false }},
+      "output");
+  ReportIgnoredParam({{ "test", false }, { "test_svmlight", false }},
+      "output_probabilities");
 
   // Max Iterations needs to be positive.
   RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; },
@@ -205,24 +260,40 @@ static void mlpackMain()
 
   // These are the matrices we might use.
   arma::mat regressors;
+  arma::sp_mat sparseRegressors;
   arma::Row<size_t> responses;
-  arma::mat testSet;
-  arma::Row<size_t> predictions;
+
+  // Load the model, if necessary.
+  LogisticRegression<>* model = NULL;
+  if (CLI::HasParam("input_model"))
+    model = CLI::GetParam<LogisticRegression<>*>("input_model");
 
   // Load data matrix.
   if (CLI::HasParam("training"))
+  {
     regressors = std::move(CLI::GetParam<arma::mat>("training"));
+  }
+  else if (CLI::HasParam("training_svmlight"))
+  {
+    // A loaded model fixes the dimensionality of the data.
+    arma::rowvec labels;
+    data::LoadSVMLight(CLI::GetParam<string>("training_svmlight"),
+        sparseRegressors, labels, true,
+        (model == NULL) ? 0 : model->Parameters().n_cols - 1);
+    responses = arma::conv_to<arma::Row<size_t>>::from(labels > 0);
+  }
 
-  // Load the model, if necessary.
-  LogisticRegression<>* model;
-  if (CLI::HasParam("input_model"))
-    model = CLI::GetParam<LogisticRegression<>*>("input_model");
-  else
+  if (model == NULL)
   {
     model = new LogisticRegression<>(0, 0);
 
     // Set the size of the parameters vector, if necessary.
-    if (!CLI::HasParam("labels"))
+    if (CLI::HasParam("training_svmlight"))
+    {
+      model->Parameters() = arma::zeros<arma::rowvec>(
+          sparseRegressors.n_rows + 1);
+    }
+    else if (!CLI::HasParam("labels"))
       model->Parameters() = arma::zeros<arma::rowvec>(regressors.n_rows);
     else
       model->Parameters() = arma::zeros<arma::rowvec>(regressors.n_rows + 1);
@@ -276,70 +347,166 @@ static void mlpackMain()
   if (CLI::HasParam("training"))
   {
     model->Lambda() = lambda;
+    TrainModel(*model, regressors, responses);
+  }
+  else if (CLI::HasParam("training_svmlight"))
+  {
+    // Train a model on the sparse matrix, starting from the current
+    // parameters, and keep its parameters: the model type does not depend on
+    // the data type.
+    LogisticRegression<arma::sp_mat> sparseModel(0, lambda);
+    sparseModel.Parameters() = model->Parameters();
+    TrainModel(sparseModel, sparseRegressors, responses);
+
+    model->Lambda() = lambda;
+    model->Parameters() = std::move(sparseModel.Parameters());
+  }
 
-    if (optimizerType == "sgd")
+  if (CLI::HasParam("test") || CLI::HasParam("test_svmlight"))
+  {
+    // The test data must have the dimensionality of the training data.
+    const size_t trainingDimensionality = model->Parameters().n_cols - 1;
+    if (CLI::HasParam("test_svmlight"))
     {
-      SGD<> sgdOpt;
-      sgdOpt.MaxIterations() = maxIterations;
-      sgdOpt.Tolerance() = tolerance;
-      sgdOpt.StepSize() = stepSize;
-      sgdOpt.BatchSize() = batchSize;
-      Log::Info << "Training model with SGD optimizer." << endl;
-
-      // This will train the model.
-      model->Train(regressors, responses, sgdOpt);
+      arma::sp_mat testSet;
+      arma::rowvec testLabels;
+      data::LoadSVMLight(CLI::GetParam<string>("test_svmlight"), testSet,
+          testLabels, true, trainingDimensionality);
+      PredictTestSet(model->Parameters(), testSet,
+          CLI::GetParam<string>("test_svmlight"));
     }
-    else if (optimizerType == "lbfgs")
+    else if (data::CanTransformStream(
+        CLI::GetPrintableParam<arma::mat>("test"), SingleOutput()))
     {
-      L_BFGS lbfgsOpt;
-      lbfgsOpt.MaxIterations() = maxIterations;
-      lbfgsOpt.MinGradientNorm() = tolerance;
-      Log::Info << "Training model with L-BFGS optimizer." << endl;
-
-      // This will train the model.
-      model->Train(regressors, responses, lbfgsOpt);
+      PredictTestStream(model->Parameters(), trainingDimensionality);
+    }
+    else
+    {
+      const arma::mat testSet = std::move(CLI::GetParam<arma::mat>("test"));
+      if (testSet.n_rows != trainingDimensionality)
+      {
+        // Clean memory if needed.
+        if (!CLI::HasParam("input_model"))
+          delete model;
+
+        Log::Fatal << "Test data dimensionality (" << testSet.n_rows << ") "
+            << "must be the same as the dimensionality of the training data ("
+            << trainingDimensionality << ")!" << endl;
+      }
+
+      PredictTestSet(model->Parameters(), testSet,
+          CLI::GetPrintableParam<arma::mat>("test"));
     }
   }
 
-  if (CLI::HasParam("test"))
+  CLI::GetParam<LogisticRegression<>*>("output_model") = model;
+}
+
+template<typename MatType>
+void TrainModel(LogisticRegression<MatType>& model,
+                const MatType& regressors,
+                const arma::Row<size_t>& responses)
+{
+  const string optimizerType = CLI::GetParam<string>("optimizer");
+  const double tolerance = CLI::GetParam<double>("tolerance");
+  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
+
+  if (optimizerType == "sgd")
+  {
+    SGD<> sgdOpt;
+    sgdOpt.MaxIterations() = maxIterations;
+    sgdOpt.Tolerance() = tolerance;
+    sgdOpt.StepSize() = CLI::GetParam<double>("step_size");
+    sgdOpt.BatchSize() = (size_t) CLI::GetParam<int>("batch_size");
+    Log::Info << "Training model with SGD optimizer." << endl;
+
+    // This will train the model.
+    model.Train(regressors, responses, sgdOpt);
+  }
+  else if (optimizerType == "lbfgs")
   {
-    testSet = std::move(CLI::GetParam<arma::mat>("test"));
+    L_BFGS lbfgsOpt;
+    lbfgsOpt.MaxIterations() = maxIterations;
+    lbfgsOpt.MinGradientNorm() = tolerance;
+    Log::Info << "Training model with L-BFGS optimizer." << endl;
 
-    // Checking the dimensionality of the test data.
-    if (testSet.n_rows != model->Parameters().n_cols - 1)
-    {
-      // Clean memory if needed.
-      const size_t trainingDimensionality = model->Parameters().n_cols - 1;
-      if (!CLI::HasParam("input_model"))
-        delete model;
+    // This will train the model.
+    model.Train(regressors, responses, lbfgsOpt);
+  }
+}
 
-      Log::Fatal << "Test data dimensionality (" << testSet.n_rows << ") must "
-          << "be the same as the dimensionality of the training data ("
-          << trainingDimensionality << ")!" << endl;
-    }
+template<typename MatType>
+void PredictTestSet(const arma::rowvec& parameters,
+                    const MatType& testSet,
+                    const string& testName)
+{
+  // We must perform predictions on the test set.  Training (and the
+  // optimizer) are irrelevant here; we'll only use the parameters.
+  LogisticRegression<MatType> model(0, 0);
+  model.Parameters() = parameters;
 
-    // We must perform predictions on the test set.  Training (and the
-    // optimizer) are irrelevant here; we'll pass in the model we have.
-    if (CLI::HasParam("output"))
-    {
-      Log::Info << "Predicting classes of points in '"
-          << CLI::GetPrintableParam<arma::mat>("test") << "'." << endl;
-      model->Classify(testSet, predictions, decisionBoundary);
+  if (CLI::HasParam("output"))
+  {
+    Log::Info << "Predicting classes of points in '" << testName << "'."
+        << endl;
+    arma::Row<size_t> predictions;
+    model.Classify(testSet, predictions,
+        CLI::GetParam<double>("decision_boundary"));
 
-      CLI::GetParam<arma::Row<size_t>>("output") = std::move(predictions);
-    }
+    CLI::GetParam<arma::Row<size_t>>("output") = std::move(predictions);
+  }
 
-    if (CLI::HasParam("output_probabilities"))
-    {
-      Log::Info << "Calculating class probabilities of points in '"
-          << CLI::GetPrintableParam<arma::mat>("test") << "'." << endl;
-      arma::mat probabilities;
-      model->Classify(testSet, probabilities);
+  if (CLI::HasParam("output_probabilities"))
+  {
+    Log::Info << "Calculating class probabilities of points in '" << testName
+        << "'." << endl;
+    arma::mat probabilities;
+    model.Classify(testSet, probabilities);
 
-      CLI::GetParam<arma::mat>("output_probabilities") =
-          std::move(probabilities);
-    }
+    CLI::GetParam<arma::mat>("output_probabilities") =
+        std::move(probabilities);
   }
+}
 
-  CLI::GetParam<LogisticRegression<>*>("output_model") = model;
+void PredictTestStream(const arma::rowvec& parameters,
+                       const size_t dimensionality)
+{
+  LogisticRegression<> model(0, 0);
+  model.Parameters() = parameters;
+  const string testName = CLI::GetPrintableParam<arma::mat>("test");
+  const double decisionBoundary = CLI::GetParam<double>("decision_boundary");
+
+  // Check each batch, since the test set is never loaded whole.
+  auto checkDimensionality = [&](const arma::mat& batch)
+  {
+    if (batch.n_rows != dimensionality)
+    {
+      Log::Fatal << "Test data dimensionality (" << batch.n_rows << ") must "
+          << "be the same as the dimensionality of the training data ("
+          << dimensionality << ")!" << endl;
+    }
+  };
+
+  if (CLI::HasParam("output"))
+  {
+    Log::Info << "Predicting classes of points in '" << testName << "' a "
+        << "batch at a time." << endl;
+    data::TransformCSVStream<arma::Row<size_t>>(testName, SingleOutput(),
+        [&](const arma::mat& batch, arma::Row<size_t>& predictions)
+        {
+          checkDimensionality(batch);
+          model.Classify(batch, predictions, decisionBoundary);
+        });
+  }
+  else
+  {
+    Log::Info << "Calculating class probabilities of points in '" << testName
+        << "' a batch at a time." << endl;
+    data::TransformCSVStream<arma::mat>(testName, SingleOutput(),
+        [&](const arma::mat& batch, arma::mat& probabilities)
+        {
+          checkDimensionality(batch);
+          model.Classify(batch, probabilities);
+        });
+  }
 }
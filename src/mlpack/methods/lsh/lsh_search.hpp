@@ -46,6 +46,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/data/compact_storage.hpp>
 #include <mlpack/methods/neighbor_search/sort_policies/nearest_neighbor_sort.hpp>
 
 #include <queue>
@@ -280,9 +281,22 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  /**
+   * Get the offsets of the buckets of the second hash table in
+   * BucketContents(): the points of the bucket in row i of the table are
+   * BucketContents()[BucketOffsets()[i]] to
+   * BucketContents()[BucketOffsets()[i + 1] - 1].
+   */
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
+
+  //! Get the indices of the points in the buckets of the second hash table,
+  //! bucket after bucket.
+  const arma::Col<uint32_t>& BucketContents() const { return bucketContents; }
+
+  //! Get the second hash table, as one vector of point indices per bucket.
+  //! This copies the indices; BucketOffsets() and BucketContents() give the
+  //! table without a copy.
+  std::vector<arma::Col<size_t>> SecondHashTable() const;
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -310,12 +324,16 @@ class LSHSearch
    *    0, all tables are searched.
    * @param T The number of additional probing bins for multiprobe LSH. If 0,
    *    single-probe is used.
+   * @param visited Flags of the reference points already taken as candidates,
+   *    used to keep one copy of each candidate; it must have one (false) flag
+   *    per reference point, and is left that way.
    */
   template<typename VecType>
   void ReturnIndicesFromTable(const VecType& queryPoint,
                               arma::uvec& referenceIndices,
                               size_t numTablesToSearch,
-                              const size_t T) const;
+                              const size_t T,
+                              std::vector<bool>& visited) const;
 
   /**
    * This is a helper function that computes the distance of the query to the
@@ -414,6 +432,17 @@ class LSHSearch
    */
   bool PerturbationValid(const std::vector<bool>& A) const;
 
+  /**
+   * Load the second hash table in the format of versions 0 and 1 of the
+   * serialization: one vector per row of the table, and the number of points
+   * in each row.  This also loads bucketRowInHashTable.
+   */
+  template<typename Archive>
+  void LoadSecondHashTable(Archive& ar,
+                           const unsigned int version,
+                           std::vector<arma::Col<size_t>>& secondHashTable,
+                           arma::Col<size_t>& bucketContentSize);
+
   //! Reference dataset.
   arma::mat referenceSet;
 
@@ -440,15 +469,16 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The offsets of the nonempty buckets of the final hash table (there are
+  //! less than secondHashSize of them) in bucketContents, plus the total
+  //! number of elements.
+  arma::Col<size_t> bucketOffsets;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The indices of the points in each bucket of the final hash table (with
+  //! at most bucketSize points each), stored contiguously.
+  arma::Col<uint32_t> bucketContents;
 
-  //! For a particular hash value, points to the row in secondHashTable
+  //! For a particular hash value, points to the row in the final hash table
   //! corresponding to this value. Length secondHashSize.
   arma::Col<size_t> bucketRowInHashTable;
 
@@ -476,7 +506,7 @@ class LSHSearch
 
 //! Set the serialization version of the LSHSearch class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::LSHSearch<SortPolicy>, 1);
+    mlpack::neighbor::LSHSearch<SortPolicy>, 3);
 
 // Include implementation.
 #include "lsh_search_impl.hpp"
@@ -83,8 +83,8 @@ LSHSearch<SortPolicy>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketOffsets(other.bucketOffsets),
+    bucketContents(other.bucketContents),
     bucketRowInHashTable(other.bucketRowInHashTable),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -103,8 +103,8 @@ LSHSearch<SortPolicy>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    bucketContents(std::move(other.bucketContents)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -130,8 +130,8 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(const LSHSearch& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketOffsets = other.bucketOffsets;
+  bucketContents = other.bucketContents;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
@@ -151,8 +151,8 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(LSHSearch&& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketOffsets = std::move(other.bucketOffsets);
+  bucketContents = std::move(other.bucketContents);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
@@ -177,6 +177,13 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
                                   const size_t bucketSize,
                                   const arma::cube &projection)
 {
+  // The second hash table stores the point indices as 32-bit integers.
+  if (referenceSet.n_cols > std::numeric_limits<uint32_t>::max())
+  {
+    throw std::invalid_argument("LSHSearch::Train(): reference sets of more "
+        "than 2^32 - 1 points are not supported");
+  }
+
   // Set new reference set.
   this->referenceSet = std::move(referenceSet);
 
@@ -217,10 +224,8 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
   secondHashWeights = arma::floor(arma::randu(numProj) *
                                   (double) secondHashSize);
 
-  // Instead of putting the points in the row corresponding to the bucket, we
-  // chose the next empty row and keep track of the row in which the bucket
-  // lies. This allows us to stack together and slice out the empty buckets at
-  // the end of the hashing.
+  // The row of the final hash table of each bucket; secondHashSize marks the
+  // empty buckets.
   bucketRowInHashTable.set_size(secondHashSize);
   bucketRowInHashTable.fill(secondHashSize);
 
@@ -251,95 +256,157 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
         "tables provided must be equal to numProj");
   }
 
-  // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
-
-  for (size_t i = 0; i < numTables; i++)
+  // Step IV: create the 'numProj'-dimensional key for each point in each
+  // table.
+  //
+  // For a single table, let the 'numProj' projections be denoted by 'proj_i'
+  // and the corresponding offset be 'offset_i'.  Then the key of a single
+  // point is obtained as:
+  // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
+  //
+  // The slices of the projection cube are contiguous, so they form one
+  // dims x (numProj * numTables) matrix, and the keys of all the tables are
+  // computed with one matrix product per block of reference points.  The
+  // blocks are processed in parallel.
+  const size_t numPoints = this->referenceSet.n_cols;
+  const arma::mat allProjections(projections.memptr(), projections.n_rows,
+      numProj * numTables, false, true);
+  const arma::vec allOffsets = arma::vectorise(offsets);
+
+  // Step V: hash every key to its bucket of the second hash table.  We must
+  // also normalize the hashes to the range [0, secondHashSize).  The bucket of
+  // point j in table i is held in secondHashVectors(j, i), so that the pairs
+  // are stored table after table.
+  arma::Mat<size_t> secondHashVectors(numPoints, numTables);
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // Step IV: create the 'numProj'-dimensional key for each point in each
-    // table.
-
-    // The following code performs the task of hashing each point to a
-    // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
-    //
-    // For a single table, let the 'numProj' projections be denoted by 'proj_i'
-    // and the corresponding offset be 'offset_i'.  Then the key of a single
-    // point is obtained as:
-    // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
-    arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
-    hashMat += offsetMat;
-    hashMat /= hashWidth;
-
-    // Step V: Putting the points in the 'secondHashTable' by hashing the key.
-    // Now we hash every key, point ID to its corresponding bucket.  We must
-    // also normalize the hashes to the range [0, secondHashSize).
-    arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
-    for (size_t j = 0; j < unmodVector.n_elem; ++j)
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, numPoints);
+
+    arma::mat hashMat = allProjections.t() *
+        this->referenceSet.cols(begin, end - 1);
+    hashMat.each_col() += allOffsets;
+    hashMat = arma::floor(hashMat / hashWidth);
+
+    for (size_t i = 0; i < numTables; ++i)
     {
-      double shs = (double) secondHashSize; // Convenience cast.
-      if (unmodVector[j] >= 0.0)
+      const arma::rowvec unmodVector = secondHashWeights.t() *
+          hashMat.rows(i * numProj, (i + 1) * numProj - 1);
+      for (size_t j = 0; j < unmodVector.n_elem; ++j)
       {
-        const size_t key = size_t(fmod(unmodVector[j], shs));
-        secondHashVectors(i, j) = key;
-      }
-      else
-      {
-        const double mod = fmod(-unmodVector[j], shs);
-        const size_t key = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
-        secondHashVectors(i, j) = key;
+        double shs = (double) secondHashSize; // Convenience cast.
+        if (unmodVector[j] >= 0.0)
+        {
+          const size_t key = size_t(fmod(unmodVector[j], shs));
+          secondHashVectors(begin + j, i) = key;
+        }
+        else
+        {
+          const double mod = fmod(-unmodVector[j], shs);
+          const size_t key = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
+          secondHashVectors(begin + j, i) = key;
+        }
       }
     }
   }
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
+  // Step VI: sort the (table, point) pairs by bucket with a parallel counting
+  // sort.  The pairs are split, table after table, into one contiguous chunk
+  // per thread, and each chunk counts its pairs in each bucket and lists the
+  // buckets in the order it first sees them.
+  const size_t numPairs = secondHashVectors.n_elem;
+  size_t numChunks = 1;
+  #ifdef HAS_OPENMP
+    numChunks = omp_get_max_threads();
+  #endif
+  numChunks = std::max((size_t) 1, std::min(numChunks, numPairs));
+  const size_t chunkSize = (numPairs + numChunks - 1) / numChunks;
+
+  arma::Mat<size_t> chunkCounts(secondHashSize, numChunks, arma::fill::zeros);
+  std::vector<std::vector<size_t>> chunkBuckets(numChunks);
+
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = std::min(c * chunkSize, numPairs);
+    const size_t end = std::min(begin + chunkSize, numPairs);
+    size_t* counts = chunkCounts.colptr(c);
+    for (size_t k = begin; k < end; ++k)
+    {
+      const size_t hashInd = secondHashVectors[k];
+      if (counts[hashInd]++ == 0)
+        chunkBuckets[c].push_back(hashInd);
+    }
+  }
 
-  // Enforce the maximum bucket size.
+  // Now count the number of points in each row of the second hash table, and
+  // enforce the maximum bucket size.  Each chunk will place its points of a
+  // bucket after those of the previous chunks; chunkCounts is turned into the
+  // position of the first one.
   const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    for (size_t h = 0; h < secondHashSize; ++h)
+    {
+      const size_t count = chunkCounts(h, c);
+      chunkCounts(h, c) = secondHashBinCounts[h];
+      secondHashBinCounts[h] += count;
+    }
+  }
   secondHashBinCounts.transform([effectiveBucketSize](size_t val)
       { return std::min(val, effectiveBucketSize); });
 
+  // Instead of putting the points in the row corresponding to the bucket, we
+  // give each nonempty bucket the next row, in the order in which the buckets
+  // are first seen, and store the rows contiguously: the points of row i are
+  // bucketContents[bucketOffsets[i]] to bucketContents[bucketOffsets[i + 1] -
+  // 1].
   const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
-
-  // Next we must assign each point in each table to the right second hash
-  // table.
+  bucketOffsets.set_size(numRowsInTable + 1);
+  bucketOffsets[0] = 0;
   size_t currentRow = 0;
-  for (size_t i = 0; i < numTables; ++i)
+  for (size_t c = 0; c < numChunks; ++c)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
+    for (size_t i = 0; i < chunkBuckets[c].size(); ++i)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
+      const size_t hashInd = chunkBuckets[c][i];
       if (bucketRowInHashTable[hashInd] == secondHashSize)
       {
         bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
+        bucketOffsets[currentRow + 1] = bucketOffsets[currentRow] +
+            secondHashBinCounts[hashInd];
         currentRow++;
       }
+    }
+  }
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
+  // Next we must assign each point in each table to the right row, keeping
+  // the first points of each bucket in table order when it is full.
+  bucketContents.set_size(bucketOffsets[numRowsInTable]);
+
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t begin = std::min(c * chunkSize, numPairs);
+    const size_t end = std::min(begin + chunkSize, numPairs);
+    size_t* positions = chunkCounts.colptr(c);
+    for (size_t k = begin; k < end; ++k)
+    {
+      // The point ID is 'k % numPoints'.
+      const size_t hashInd = secondHashVectors[k];
+      const size_t position = positions[hashInd]++;
+      if (position < secondHashBinCounts[hashInd])
+      {
+        bucketContents[bucketOffsets[bucketRowInHashTable[hashInd]] +
+            position] = (uint32_t) (k % numPoints);
+      }
+    }
+  }
 
   Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
             << "maximum length of " << arma::max(secondHashBinCounts) << ", "
@@ -702,7 +769,8 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
     const VecType& queryPoint,
     arma::uvec& referenceIndices,
     size_t numTablesToSearch,
-    const size_t T) const
+    const size_t T,
+    std::vector<bool>& visited) const
 {
   // Decide on the number of tables to look into.
   if (numTablesToSearch == 0) // If no user input is given, search all.
@@ -770,82 +838,46 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
     {
       const size_t hashInd = hashMat(p, i); // find query's bucket
       const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+      if (tableRow < secondHashSize) // count bucket contents
+        maxNumPoints += bucketOffsets[tableRow + 1] - bucketOffsets[tableRow];
     }
   }
 
-  // There are two ways to proceed here:
-  // Either allocate a maxNumPoints-size vector, place all candidates, and run
-  // unique on the vector to discard duplicates.
-  // Or allocate a referenceSet.n_cols size vector (i.e. number of reference
-  // points) of zeros, and mark found indices as 1.
-  // Option 1 runs faster for small maxNumPoints but worse for larger values, so
-  // we choose based on a heuristic.
-  const float cutoff = 0.1;
-  const float selectivity = static_cast<float>(maxNumPoints) /
-      static_cast<float>(referenceSet.n_cols);
-
-  if (selectivity > cutoff)
+  // Collect the points of all the buckets, keeping only the first copy of
+  // each one; the visited flags are cleared again below, which takes time
+  // proportional to the number of candidates instead of the number of
+  // reference points.
+  referenceIndices.set_size(maxNumPoints);
+  size_t numCandidates = 0;
+  for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables.
   {
-    // Heuristic: larger maxNumPoints means we should use find() because it
-    // should be faster.
-    // Reference points hashed in the same bucket as the query are set to >0.
-    arma::Col<size_t> refPointsConsidered;
-    refPointsConsidered.zeros(referenceSet.n_cols);
-
-    for (size_t i = 0; i < numTablesToSearch; ++i) // for all tables
+    for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
     {
-      for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
-      {
-        // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
+      const size_t hashInd = hashMat(p, i); // Find the query's bucket.
+      const size_t tableRow = bucketRowInHashTable[hashInd];
+      if (tableRow >= secondHashSize)
+        continue;
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+      for (size_t j = bucketOffsets[tableRow]; j < bucketOffsets[tableRow + 1];
+          ++j)
+      {
+        const size_t index = bucketContents[j];
+        if (!visited[index])
         {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          visited[index] = true;
+          referenceIndices[numCandidates++] = index;
         }
       }
     }
-
-    // Only keep reference points found in at least one bucket.
-    referenceIndices = arma::find(refPointsConsidered > 0);
-    return;
   }
-  else
-  {
-    // Heuristic: smaller maxNumPoints means we should use unique() because it
-    // should be faster.
-    // Allocate space for the query's potential neighbors.
-    arma::uvec refPointsConsideredSmall;
-    refPointsConsideredSmall.zeros(maxNumPoints);
 
-    // Retrieve candidates.
-    size_t start = 0;
+  referenceIndices.resize(numCandidates);
+  for (size_t i = 0; i < numCandidates; ++i)
+    visited[referenceIndices[i]] = false;
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
-    {
-      for (size_t p = 0; p < T + 1; ++p)
-      {
-        const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
-
-        if (tableRow < secondHashSize)
-        {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
-      }
-    }
-
-    // Keep only one copy of each candidate.
-    referenceIndices = arma::unique(refPointsConsideredSmall);
-    return;
-  }
+  // Consider the candidates in order of index, so that ties are broken the
+  // same way for every probing sequence.
+  referenceIndices = arma::sort(referenceIndices);
 }
 
 // Search for nearest neighbors in a given query set.
@@ -904,29 +936,32 @@ void LSHSearch<SortPolicy>::Search(const arma::mat& querySet,
 
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  // Parallelization to process more than one query at a time.  Each thread
+  // has its own flags of the reference points already found for a query.
+  #pragma omp parallel shared(resultingNeighbors, distances)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
+    std::vector<bool> visited(referenceSet.n_cols, false);
+
+    #pragma omp for schedule(dynamic) reduction(+:avgIndicesReturned)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      // Go through every query point.
+      // Hash every query into every hash table and eventually into the
+      // 'secondHashTable' to obtain the neighbor candidates.
+      arma::uvec refIndices;
+      ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
+          Teffective, visited);
+
+      // An informative book-keeping for the number of neighbor candidates
+      // returned on average.
+      // Make atomic to avoid race conditions when multiple threads are running
+      // #pragma omp atomic
+      avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
+
+      // Sequentially go through all the candidates and save the best 'k'
+      // candidates.
+      BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -970,29 +1005,32 @@ Search(const size_t k,
 
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+  // Parallelization to process more than one query at a time.  Each thread
+  // has its own flags of the reference points already found for a query.
+  #pragma omp parallel shared(resultingNeighbors, distances)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
+    std::vector<bool> visited(referenceSet.n_cols, false);
+
+    #pragma omp for schedule(dynamic) reduction(+:avgIndicesReturned)
+    for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+    {
+      // Go through every query point.
+      // Hash every query into every hash table and eventually into the
+      // 'secondHashTable' to obtain the neighbor candidates.
+      arma::uvec refIndices;
+      ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
+          Teffective, visited);
+
+      // An informative book-keeping for the number of neighbor candidates
+      // returned on average.
+      // Make atomic to avoid race conditions when multiple threads are running.
+      // #pragma omp atomic
+      avgIndicesReturned += refIndices.n_elem;
+
+      // Sequentially go through all the candidates and save the best 'k'
+      // candidates.
+      BaseCase(i, refIndices, k, resultingNeighbors, distances);
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -1003,6 +1041,20 @@ Search(const size_t k,
       std::endl;
 }
 
+template<typename SortPolicy>
+std::vector<arma::Col<size_t>> LSHSearch<SortPolicy>::SecondHashTable() const
+{
+  std::vector<arma::Col<size_t>> secondHashTable(bucketOffsets.empty() ? 0 :
+      bucketOffsets.n_elem - 1);
+  for (size_t i = 0; i < secondHashTable.size(); ++i)
+  {
+    secondHashTable[i] = arma::conv_to<arma::Col<size_t>>::from(
+        bucketContents.subvec(bucketOffsets[i], bucketOffsets[i + 1] - 1));
+  }
+
+  return secondHashTable;
+}
+
 template<typename SortPolicy>
 double LSHSearch<SortPolicy>::ComputeRecall(
     const arma::Mat<size_t>& foundNeighbors,
@@ -1032,40 +1084,12 @@ double LSHSearch<SortPolicy>::ComputeRecall(
 
 template<typename SortPolicy>
 template<typename Archive>
-void LSHSearch<SortPolicy>::serialize(Archive& ar,
-                                      const unsigned int version)
+void LSHSearch<SortPolicy>::LoadSecondHashTable(
+    Archive& ar,
+    const unsigned int version,
+    std::vector<arma::Col<size_t>>& secondHashTable,
+    arma::Col<size_t>& bucketContentSize)
 {
-  ar & BOOST_SERIALIZATION_NVP(referenceSet);
-  ar & BOOST_SERIALIZATION_NVP(numProj);
-  ar & BOOST_SERIALIZATION_NVP(numTables);
-
-  // Delete existing projections, if necessary.
-  if (Archive::is_loading::value)
-    projections.reset();
-
-  // Backward compatibility: older versions of LSHSearch stored the projection
-  // tables in a std::vector<arma::mat>.
-  if (version == 0)
-  {
-    std::vector<arma::mat> tmpProj;
-    ar & BOOST_SERIALIZATION_NVP(tmpProj);
-
-    projections.set_size(tmpProj[0].n_rows, tmpProj[0].n_cols, tmpProj.size());
-    for (size_t i = 0; i < tmpProj.size(); ++i)
-      projections.slice(i) = tmpProj[i];
-  }
-  else
-  {
-    ar & BOOST_SERIALIZATION_NVP(projections);
-  }
-
-  ar & BOOST_SERIALIZATION_NVP(offsets);
-  ar & BOOST_SERIALIZATION_NVP(hashWidth);
-  ar & BOOST_SERIALIZATION_NVP(secondHashSize);
-  ar & BOOST_SERIALIZATION_NVP(secondHashWeights);
-  ar & BOOST_SERIALIZATION_NVP(bucketSize);
-  // needs specific handling for new version
-
   // Backward compatibility: in older versions of LSHSearch, the secondHashTable
   // was stored as an arma::Mat<size_t>.  So we need to properly load that, then
   // prune it down to size.
@@ -1098,17 +1122,10 @@ void LSHSearch<SortPolicy>::serialize(Archive& ar,
   else
   {
     size_t tables;
-    if (Archive::is_saving::value)
-      tables = secondHashTable.size();
     ar & BOOST_SERIALIZATION_NVP(tables);
 
-    // Set size of second hash table if needed.
-    if (Archive::is_loading::value)
-    {
-      secondHashTable.clear();
-      secondHashTable.resize(tables);
-    }
-
+    secondHashTable.clear();
+    secondHashTable.resize(tables);
     ar & BOOST_SERIALIZATION_NVP(secondHashTable);
   }
 
@@ -1125,7 +1142,7 @@ void LSHSearch<SortPolicy>::serialize(Archive& ar,
     ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
 
     // Compress into a smaller vector by just dropping all of the zeros.
-    bucketContentSize.set_size(secondHashTable.size());
+    bucketContentSize.zeros(secondHashTable.size());
     for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
       if (tmpBucketContentSize[i] > 0)
         bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
@@ -1135,6 +1152,81 @@ void LSHSearch<SortPolicy>::serialize(Archive& ar,
     ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
     ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
   }
+}
+
+template<typename SortPolicy>
+template<typename Archive>
+void LSHSearch<SortPolicy>::serialize(Archive& ar,
+                                      const unsigned int version)
+{
+  // Version 3 can save the reference set and the indices compactly.
+  if (version >= 3)
+    data::SerializeCompact(ar, referenceSet, "referenceSet");
+  else
+    ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  ar & BOOST_SERIALIZATION_NVP(numProj);
+  ar & BOOST_SERIALIZATION_NVP(numTables);
+
+  // Delete existing projections, if necessary.
+  if (Archive::is_loading::value)
+    projections.reset();
+
+  // Backward compatibility: older versions of LSHSearch stored the projection
+  // tables in a std::vector<arma::mat>.
+  if (version == 0)
+  {
+    std::vector<arma::mat> tmpProj;
+    ar & BOOST_SERIALIZATION_NVP(tmpProj);
+
+    projections.set_size(tmpProj[0].n_rows, tmpProj[0].n_cols, tmpProj.size());
+    for (size_t i = 0; i < tmpProj.size(); ++i)
+      projections.slice(i) = tmpProj[i];
+  }
+  else
+  {
+    ar & BOOST_SERIALIZATION_NVP(projections);
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(offsets);
+  ar & BOOST_SERIALIZATION_NVP(hashWidth);
+  ar & BOOST_SERIALIZATION_NVP(secondHashSize);
+  ar & BOOST_SERIALIZATION_NVP(secondHashWeights);
+  ar & BOOST_SERIALIZATION_NVP(bucketSize);
+  // Backward compatibility: versions 0 and 1 of LSHSearch stored the second
+  // hash table as one vector per bucket, and the number of points of each
+  // bucket.  Convert them to the contiguous storage.
+  if (version < 2)
+  {
+    std::vector<arma::Col<size_t>> secondHashTable;
+    arma::Col<size_t> bucketContentSize;
+    LoadSecondHashTable(ar, version, secondHashTable, bucketContentSize);
+
+    bucketOffsets.set_size(secondHashTable.size() + 1);
+    bucketOffsets[0] = 0;
+    for (size_t i = 0; i < secondHashTable.size(); ++i)
+    {
+      bucketContentSize[i] = std::min(bucketContentSize[i],
+          (size_t) secondHashTable[i].n_elem);
+      bucketOffsets[i + 1] = bucketOffsets[i] + bucketContentSize[i];
+    }
+
+    bucketContents.set_size(bucketOffsets[secondHashTable.size()]);
+    for (size_t i = 0; i < secondHashTable.size(); ++i)
+      for (size_t j = 0; j < bucketContentSize[i]; ++j)
+        bucketContents[bucketOffsets[i] + j] = secondHashTable[i][j];
+  }
+  else if (version == 2)
+  {
+    ar & BOOST_SERIALIZATION_NVP(bucketOffsets);
+    ar & BOOST_SERIALIZATION_NVP(bucketContents);
+    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+  }
+  else
+  {
+    data::SerializeCompact(ar, bucketOffsets, "bucketOffsets");
+    ar & BOOST_SERIALIZATION_NVP(bucketContents);
+    data::SerializeCompact(ar, bucketRowInHashTable, "bucketRowInHashTable");
+  }
 
   ar & BOOST_SERIALIZATION_NVP(distanceEvaluations);
 }
@@ -0,0 +1,193 @@
+/**
+ * @file soft_impute.cpp
+ *
+ * Implementation of the SoftImpute class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include "soft_impute.hpp"
+
+namespace mlpack {
+namespace matrix_completion {
+
+SoftImpute::SoftImpute(const size_t m,
+                       const size_t n,
+                       const arma::umat& indices,
+                       const arma::vec& values,
+                       const size_t maxRank,
+                       const double lambda,
+                       const size_t maxIterations,
+                       const double tolerance) :
+    m(m), n(n), indices(indices), values(values), maxRank(maxRank),
+    lambda(lambda), maxIterations(maxIterations), tolerance(tolerance),
+    oversampling(10), powerIterations(2), iterations(0)
+{
+  CheckValues();
+}
+
+void SoftImpute::CheckValues()
+{
+  if (indices.n_rows != 2)
+  {
+    Log::Fatal << "SoftImpute::CheckValues(): matrix of constraint indices "
+        << "does not have 2 rows!" << std::endl;
+  }
+
+  if (indices.n_cols != values.n_elem)
+  {
+    Log::Fatal << "SoftImpute::CheckValues(): the number of constraint "
+        << "indices (columns of constraint indices matrix) does not match the "
+        << "number of constraint values (length of constraint value vector)!"
+        << std::endl;
+  }
+
+  for (size_t i = 0; i < values.n_elem; i++)
+  {
+    if (indices(0, i) >= m || indices(1, i) >= n)
+      Log::Fatal << "SoftImpute::CheckValues(): indices (" << indices(0, i)
+          << ", " << indices(1, i) << ") are out of bounds for matrix of size "
+          << m << " x " << n << "!" << std::endl;
+  }
+
+  if (maxRank == 0)
+    Log::Fatal << "SoftImpute::CheckValues(): the maximum rank must be "
+        << "positive!" << std::endl;
+
+  // Sort the entries in column-major order, so that the sparse matrix of the
+  // residuals can be built without sorting them at every iteration.
+  const arma::uvec keys = indices.row(1).t() * m + indices.row(0).t();
+  const arma::uvec order = arma::stable_sort_index(keys);
+  indices = indices.cols(order);
+  values = values.elem(order);
+
+  for (size_t i = 1; i < values.n_elem; i++)
+  {
+    if (keys[order[i]] == keys[order[i - 1]])
+      Log::Fatal << "SoftImpute::CheckValues(): entry (" << indices(0, i)
+          << ", " << indices(1, i) << ") is given more than once!"
+          << std::endl;
+  }
+}
+
+arma::sp_mat SoftImpute::Residuals(const arma::mat& u,
+                                   const arma::vec& s,
+                                   const arma::mat& v) const
+{
+  // Store the factors of the estimate with one column per row (and column) of
+  // the matrix, so that every known entry is a dot product of two columns.
+  const arma::mat us = (u.each_row() % s.t()).t();
+  const arma::mat vt = v.t();
+
+  arma::vec residuals(values.n_elem);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) values.n_elem; i++)
+  {
+    residuals[i] = values[i] - arma::dot(us.unsafe_col(indices(0, i)),
+        vt.unsafe_col(indices(1, i)));
+  }
+
+  return arma::sp_mat(indices, residuals, m, n, false, false);
+}
+
+void SoftImpute::FilledSVD(const arma::sp_mat& residuals,
+                           const arma::mat& u,
+                           const arma::vec& s,
+                           const arma::mat& v,
+                           arma::mat& newU,
+                           arma::vec& newS,
+                           arma::mat& newV) const
+{
+  // The filled-in matrix is X = residuals + u diag(s) v^T; X * b and X^T * b
+  // are computed without forming it.
+  const size_t l = std::min(maxRank + oversampling, std::min(m, n));
+
+  // Start from the previous right singular vectors; the subspace changes
+  // little between iterations, so few power iterations are needed.
+  arma::mat omega(n, l);
+  if (v.n_cols > 0)
+    omega.cols(0, v.n_cols - 1) = v;
+  if (v.n_cols < l)
+    omega.cols(v.n_cols, l - 1) = arma::randn<arma::mat>(n, l - v.n_cols);
+
+  arma::mat q, r;
+  arma::mat y = residuals * omega + u * (arma::diagmat(s) * (v.t() * omega));
+  arma::qr_econ(q, r, y);
+
+  for (size_t i = 0; i < powerIterations; i++)
+  {
+    arma::mat z = residuals.t() * q + v * (arma::diagmat(s) * (u.t() * q));
+    arma::qr_econ(q, r, z);
+    y = residuals * q + u * (arma::diagmat(s) * (v.t() * q));
+    arma::qr_econ(q, r, y);
+  }
+
+  // X ~= q q^T X = q b, and the SVD of b^T = X^T q (n x l) gives the SVD of X.
+  const arma::mat bt = residuals.t() * q + v * (arma::diagmat(s) *
+      (u.t() * q));
+  arma::mat ub, vb;
+  arma::svd_econ(ub, newS, vb, bt);
+  newU = q * vb;
+  newV = std::move(ub);
+}
+
+void SoftImpute::Recover(arma::mat& u, arma::vec& s, arma::mat& v)
+{
+  u.zeros(m, 0);
+  s.zeros(0);
+  v.zeros(n, 0);
+
+  iterations = 0;
+  while (maxIterations == 0 || iterations < maxIterations)
+  {
+    ++iterations;
+
+    arma::mat newU, newV;
+    arma::vec newS;
+    FilledSVD(Residuals(u, s, v), u, s, v, newU, newS, newV);
+
+    // Soft-threshold the singular values (which are sorted in descending
+    // order), and keep at most maxRank of them.
+    newS -= lambda;
+    size_t rank = 0;
+    while (rank < std::min(maxRank, (size_t) newS.n_elem) && newS[rank] > 0.0)
+      ++rank;
+
+    newU = newU.head_cols(rank);
+    newS = newS.head(rank);
+    newV = newV.head_cols(rank);
+
+    // The relative change of the estimate in the Frobenius norm, computed from
+    // the factors.
+    const double oldNorm = arma::dot(s, s);
+    const double newNorm = arma::dot(newS, newS);
+    const double inner = arma::accu((u.t() * newU) % (s * newS.t()) %
+        (v.t() * newV));
+    const double change = std::max(oldNorm + newNorm - 2.0 * inner, 0.0);
+
+    u = std::move(newU);
+    s = std::move(newS);
+    v = std::move(newV);
+
+    Log::Info << "SoftImpute::Recover(): iteration " << iterations << ", rank "
+        << rank << ", relative change " << std::sqrt(change /
+        std::max(oldNorm, 1e-300)) << "." << std::endl;
+
+    if (change <= tolerance * tolerance * oldNorm)
+      break;
+  }
+}
+
+void SoftImpute::Recover(arma::mat& recovered)
+{
+  arma::mat u, v;
+  arma::vec s;
+  Recover(u, s, v);
+  recovered = u * arma::diagmat(s) * v.t();
+}
+
+} // namespace matrix_completion
+} // namespace mlpack
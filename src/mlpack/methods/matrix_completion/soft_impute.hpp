@@ -0,0 +1,202 @@
+/**
+ * @file soft_impute.hpp
+ *
+ * Matrix completion by iterative singular value thresholding (Soft-Impute),
+ * with the sparse-plus-low-rank structure of the iterates.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MATRIX_COMPLETION_SOFT_IMPUTE_HPP
+#define MLPACK_METHODS_MATRIX_COMPLETION_SOFT_IMPUTE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace matrix_completion {
+
+/**
+ * This class completes a matrix from some of its entries with the Soft-Impute
+ * algorithm of
+ *
+ * @code
+ * @article{mazumder2010spectral,
+ *   title={Spectral regularization algorithms for learning large incomplete
+ *       matrices},
+ *   author={Mazumder, R. and Hastie, T. and Tibshirani, R.},
+ *   journal={Journal of Machine Learning Research},
+ *   volume={11},
+ *   pages={2287--2322},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * which solves the nuclear norm regularized problem
+ *
+ *   min 0.5 sum_{(i, j) known} (X_ij - M_ij)^2 + lambda ||X||_*
+ *
+ * by repeatedly filling in the unknown entries with the current estimate Z and
+ * soft-thresholding the singular values of the result by lambda.  The rank of
+ * the estimate is at most MaxRank(); with lambda = 0, this is the rank
+ * constrained "Hard-Impute" variant, which recovers the known entries exactly
+ * like MatrixCompletion does when the matrix has that rank.
+ *
+ * The filled-in matrix is the sparse matrix of the residuals on the known
+ * entries plus the low-rank estimate, so it is never formed: its truncated SVD
+ * is computed with a randomized range finder (warm-started with the previous
+ * singular vectors) that only multiplies it with thin matrices.  Each
+ * iteration takes O(p r + (m + n) r^2) time for p known entries and rank r,
+ * and the memory is O(p + (m + n) r), so the dense m x n matrix is never
+ * formed unless it is requested.
+ *
+ * An example of how to use this class is shown below:
+ *
+ * @code
+ * size_t m, n;         // size of unknown matrix
+ * arma::umat indices;  // contains the known indices [2 x n_entries]
+ * arma::vec values;    // contains the known values [n_entries]
+ *
+ * SoftImpute si(m, n, indices, values, 10);
+ * arma::mat u, v;
+ * arma::vec s;
+ * si.Recover(u, s, v); // The completed matrix is u * diagmat(s) * v.t().
+ * @endcode
+ *
+ * @see MatrixCompletion
+ */
+class SoftImpute
+{
+ public:
+  /**
+   * Construct a matrix completion problem.
+   *
+   * @param m Number of rows of original matrix.
+   * @param n Number of columns of original matrix.
+   * @param indices Matrix containing the indices of the known entries (must be
+   *    [2 x p]).
+   * @param values Vector containing the values of the known entries (must be
+   *    length p).
+   * @param maxRank Maximum rank of the solution.
+   * @param lambda Threshold of the singular values (the nuclear norm
+   *    regularization).
+   * @param maxIterations Maximum number of iterations (0 means no limit).
+   * @param tolerance Relative change of the estimate below which the
+   *    iterations stop.
+   */
+  SoftImpute(const size_t m,
+             const size_t n,
+             const arma::umat& indices,
+             const arma::vec& values,
+             const size_t maxRank,
+             const double lambda = 0.0,
+             const size_t maxIterations = 100,
+             const double tolerance = 1e-5);
+
+  /**
+   * Complete the matrix, returning it as its (thin) singular value
+   * decomposition u * diagmat(s) * v.t(), with at most MaxRank() singular
+   * values.
+   *
+   * @param u Matrix to store the left singular vectors in (m x r).
+   * @param s Vector to store the singular values in (r).
+   * @param v Matrix to store the right singular vectors in (n x r).
+   */
+  void Recover(arma::mat& u, arma::vec& s, arma::mat& v);
+
+  /**
+   * Complete the matrix, returning all its entries.  This forms a dense m x n
+   * matrix; use the other overload for large matrices.
+   *
+   * @param recovered Will contain the completed matrix.
+   */
+  void Recover(arma::mat& recovered);
+
+  //! Get the maximum rank of the solution.
+  size_t MaxRank() const { return maxRank; }
+  //! Modify the maximum rank of the solution.
+  size_t& MaxRank() { return maxRank; }
+
+  //! Get the threshold of the singular values.
+  double Lambda() const { return lambda; }
+  //! Modify the threshold of the singular values.
+  double& Lambda() { return lambda; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance on the relative change of the estimate.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance on the relative change of the estimate.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the number of extra columns of the randomized range finder.
+  size_t Oversampling() const { return oversampling; }
+  //! Modify the number of extra columns of the randomized range finder.
+  size_t& Oversampling() { return oversampling; }
+
+  //! Get the number of power iterations of the randomized range finder.
+  size_t PowerIterations() const { return powerIterations; }
+  //! Modify the number of power iterations of the randomized range finder.
+  size_t& PowerIterations() { return powerIterations; }
+
+  //! Get the number of iterations of the last call to Recover().
+  size_t Iterations() const { return iterations; }
+
+ private:
+  //! Number of rows in original matrix.
+  size_t m;
+  //! Number of columns in original matrix.
+  size_t n;
+  //! The indices of the known entries, sorted by column (has two rows).
+  arma::umat indices;
+  //! The values of the known entries, in the order of the indices.
+  arma::vec values;
+
+  //! The maximum rank of the solution.
+  size_t maxRank;
+  //! The threshold of the singular values.
+  double lambda;
+  //! The maximum number of iterations.
+  size_t maxIterations;
+  //! The tolerance on the relative change of the estimate.
+  double tolerance;
+  //! The number of extra columns of the randomized range finder.
+  size_t oversampling;
+  //! The number of power iterations of the randomized range finder.
+  size_t powerIterations;
+  //! The number of iterations of the last call to Recover().
+  size_t iterations;
+
+  //! Validate the input matrices, and sort the entries by column.
+  void CheckValues();
+
+  /**
+   * Compute the sparse matrix of the residuals M - Z on the known entries, for
+   * the estimate Z = u * diagmat(s) * v.t().
+   */
+  arma::sp_mat Residuals(const arma::mat& u,
+                         const arma::vec& s,
+                         const arma::mat& v) const;
+
+  /**
+   * Compute the thin SVD of the filled-in matrix X = residuals + u diag(s) v^T
+   * with a randomized range finder of the columns of X, starting from the
+   * given right singular vectors.
+   */
+  void FilledSVD(const arma::sp_mat& residuals,
+                 const arma::mat& u,
+                 const arma::vec& s,
+                 const arma::mat& v,
+                 arma::mat& newU,
+                 arma::vec& newS,
+                 arma::mat& newV) const;
+};
+
+} // namespace matrix_completion
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,12 @@ namespace meanshift /** Mean shift clustering. */ {
  * apply mean shift algorithm until maximum iterations or convergence.  Then
  * remove duplicate centroids.
  *
+ * The seeds are shifted in parallel with OpenMP, with single-tree range
+ * searches on one reference tree built on the dataset.  The converged modes
+ * are then merged in the order of the seeds, using a grid of cells of side
+ * radius to find the earlier modes that may be duplicates, so the result does
+ * not depend on the number of threads.
+ *
  * A simple example of how to run mean shift clustering is shown below.
  *
  * @code
@@ -61,10 +67,16 @@ class MeanShift
    * @param maxIterations Maximum number of iterations allowed before giving up
    *      iterations will terminate.
    * @param kernel Optional KernelType object.
+   * @param binSize Width of the hypercube bins used to generate seeds.  If
+   *      this value isn't positive, the radius is used.
+   * @param minBinFrequency Minimum number of points in a bin for it to give a
+   *      seed.
    */
   MeanShift(const double radius = 0,
             const size_t maxIterations = 1000,
-            const KernelType kernel = KernelType());
+            const KernelType kernel = KernelType(),
+            const double binSize = 0,
+            const size_t minBinFrequency = 1);
 
   /**
    * Give an estimation of radius based on given dataset.
@@ -106,6 +118,16 @@ class MeanShift
   //! Modify the kernel.
   KernelType& Kernel() { return kernel; }
 
+  //! Get the width of the seed bins (0 means the radius).
+  double BinSize() const { return binSize; }
+  //! Modify the width of the seed bins (0 means the radius).
+  double& BinSize() { return binSize; }
+
+  //! Get the minimum number of points in a bin for it to give a seed.
+  size_t MinBinFrequency() const { return minBinFrequency; }
+  //! Modify the minimum number of points in a bin for it to give a seed.
+  size_t& MinBinFrequency() { return minBinFrequency; }
+
  private:
   /**
    * To speed up, we can generate some seeds from data set and use
@@ -155,6 +177,18 @@ class MeanShift
                     const std::vector<double>&, /*unused*/
                     arma::colvec& centroid);
 
+  /**
+   * Merge the converged modes in the order of the seeds: a mode is kept unless
+   * it is within the radius of a mode kept before it.
+   *
+   * @param modes The mode each seed converged to.
+   * @param converged Whether each seed converged.
+   * @param centroids Matrix to store the kept modes in.
+   */
+  void MergeModes(const arma::mat& modes,
+                  const std::vector<char>& converged,
+                  arma::mat& centroids) const;
+
   /**
    * If distance of two centroids is less than radius, one will be removed.
    * Points with distance to current centroid less than radius will be used
@@ -167,6 +201,12 @@ class MeanShift
 
   //! Instantiated kernel.
   KernelType kernel;
+
+  //! Width of the seed bins; if not positive, the radius is used.
+  double binSize;
+
+  //! Minimum number of points in a bin for it to give a seed.
+  size_t minBinFrequency;
 };
 
 } // namespace meanshift
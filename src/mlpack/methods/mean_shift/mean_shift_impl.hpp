@@ -33,10 +33,14 @@ template<bool UseKernel, typename KernelType, typename MatType>
 MeanShift<UseKernel, KernelType, MatType>::
 MeanShift(const double radius,
           const size_t maxIterations,
-          const KernelType kernel) :
+          const KernelType kernel,
+          const double binSize,
+          const size_t minBinFrequency) :
     radius(radius),
     maxIterations(maxIterations),
-    kernel(kernel)
+    kernel(kernel),
+    binSize(binSize),
+    minBinFrequency(minBinFrequency)
 {
   // Nothing to do.
 }
@@ -198,69 +202,65 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
   const MatType* pSeeds = &data;
   if (useSeeds)
   {
-    GenSeeds(data, radius, 1, seeds);
+    GenSeeds(data, (binSize > 0) ? binSize : radius, (int) minBinFrequency,
+        seeds);
     pSeeds = &seeds;
   }
 
   // Holds all centroids before removing duplicate ones.
   arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  std::vector<char> converged(pSeeds->n_cols, 0);
 
   assignments.set_size(data.n_cols);
 
-  range::RangeSearch<> rangeSearcher(data);
-  math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
+  // Single-tree searches need no query tree, so each step of each seed only
+  // traverses the reference tree, which all threads share.
+  const range::RangeSearch<> rangeSearcher(data, false, true);
+  const math::Range validRadius(0, radius);
 
   // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) pSeeds->n_cols; ++i)
   {
+    std::vector<std::vector<size_t> > neighbors;
+    std::vector<std::vector<double> > distances;
+    tree::SearchContext context;
+
     // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
+    arma::mat centroid = pSeeds->col(i);
     for (size_t completedIterations = 0; completedIterations < maxIterations
       || forceConvergence; completedIterations++)
     {
       // Store new centroid in this.
       arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
 
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
+      rangeSearcher.Search(centroid, validRadius, neighbors, distances,
+          context);
       if (neighbors[0].size() <= 1)
         break;
 
       // Calculate new centroid.
       if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
+        newCentroid = centroid;
 
       // If the mean shift vector is small enough, it has converged.
-      if (metric::EuclideanDistance::Evaluate(newCentroid,
-          allCentroids.unsafe_col(i)) < 1e-3 * radius)
+      if (metric::EuclideanDistance::Evaluate(newCentroid, centroid) <
+          1e-3 * radius)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
-        {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
-        }
-
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
+        converged[i] = 1;
         break;
       }
 
       // Update the centroid.
-      allCentroids.col(i) = newCentroid;
+      centroid = newCentroid;
     }
+
+    allCentroids.col(i) = centroid;
   }
 
+  // Remove the duplicate modes.
+  MergeModes(allCentroids, converged, centroids);
+
   // If no centroid has converged due to too little iterations and without
   // forcing convergence, take 1 random centroid calculated.
   if (centroids.empty())
@@ -293,6 +293,87 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
   }
 }
 
+// Merge the converged modes, in the order of the seeds.
+template<bool UseKernel, typename KernelType, typename MatType>
+void MeanShift<UseKernel, KernelType, MatType>::MergeModes(
+    const arma::mat& modes,
+    const std::vector<char>& converged,
+    arma::mat& centroids) const
+{
+  // The kept modes, by the cell of side radius that holds them.  A mode within
+  // the radius of another lies in the same cell or a neighboring one.
+  typedef arma::colvec VecType;
+  std::map<VecType, std::vector<size_t>, less<VecType> > cells;
+  std::vector<size_t> kept;
+
+  // In high dimension there are too many neighboring cells to look at, so then
+  // the kept modes are checked directly.
+  const double neighborCells = std::pow(3.0, (double) modes.n_rows);
+
+  for (size_t i = 0; i < modes.n_cols; ++i)
+  {
+    if (!converged[i])
+      continue;
+
+    const VecType cell = arma::floor(modes.unsafe_col(i) / radius);
+    bool isDuplicated = false;
+    if (neighborCells < (double) kept.size())
+    {
+      // Walk through all offsets in {-1, 0, 1}^d.
+      arma::ivec offset(modes.n_rows);
+      offset.fill(-1);
+      while (!isDuplicated)
+      {
+        typename std::map<VecType, std::vector<size_t>,
+            less<VecType> >::const_iterator it =
+            cells.find(cell + arma::conv_to<VecType>::from(offset));
+        if (it != cells.end())
+        {
+          for (size_t j = 0; j < it->second.size(); ++j)
+          {
+            if (metric::EuclideanDistance::Evaluate(modes.unsafe_col(i),
+                modes.unsafe_col(it->second[j])) < radius)
+            {
+              isDuplicated = true;
+              break;
+            }
+          }
+        }
+
+        // Go to the next offset.
+        size_t d = 0;
+        while (d < offset.n_elem && offset[d] == 1)
+          offset[d++] = -1;
+        if (d == offset.n_elem)
+          break;
+        ++offset[d];
+      }
+    }
+    else
+    {
+      for (size_t j = 0; j < kept.size(); ++j)
+      {
+        if (metric::EuclideanDistance::Evaluate(modes.unsafe_col(i),
+            modes.unsafe_col(kept[j])) < radius)
+        {
+          isDuplicated = true;
+          break;
+        }
+      }
+    }
+
+    if (!isDuplicated)
+    {
+      kept.push_back(i);
+      cells[cell].push_back(i);
+    }
+  }
+
+  centroids.set_size(modes.n_rows, kept.size());
+  for (size_t i = 0; i < kept.size(); ++i)
+    centroids.col(i) = modes.col(kept[i]);
+}
+
 } // namespace meanshift
 } // namespace mlpack
 
@@ -34,6 +34,13 @@ PROGRAM_INFO("Mean Shift Clustering", "This program performs mean shift "
     "is controlled with the " + PRINT_PARAM_STRING("max_iterations") + " "
     "parameter."
     "\n\n"
+    "Instead of every point, the mean shift starts from one seed per hypercube "
+    "bin of the data.  The width of the bins can be set with the " +
+    PRINT_PARAM_STRING("bin_size") + " parameter (by default, the radius), and "
+    "bins with fewer points than " + PRINT_PARAM_STRING("min_bin_frequency") +
+    " give no seed; on large datasets, larger bins give fewer seeds and a much "
+    "faster clustering."
+    "\n\n"
     "The output labels may be saved with the " + PRINT_PARAM_STRING("output") +
     " output parameter and the centroids of each cluster may be saved with the"
     " " + PRINT_PARAM_STRING("centroid") + " output parameter."
@@ -69,6 +76,11 @@ PARAM_DOUBLE_IN("radius", "If the distance between two centroids is less than "
     "the given radius, one will be removed.  A radius of 0 or less means an "
     "estimate will be calculated and used for the radius.", "r", 0);
 
+PARAM_DOUBLE_IN("bin_size", "Width of the hypercube bins used to generate "
+    "seeds.  A bin size of 0 or less means the radius is used.", "b", 0);
+PARAM_INT_IN("min_bin_frequency", "Minimum number of points in a bin for it "
+    "to give a seed.", "F", 1);
+
 static void mlpackMain()
 {
   const double radius = CLI::GetParam<double>("radius");
@@ -76,6 +88,8 @@ static void mlpackMain()
 
   RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
       "maximum iterations must be greater than or equal to 0");
+  RequireParamValue<int>("min_bin_frequency", [](int x) { return x > 0; },
+      true, "minimum bin frequency must be positive");
 
   // Make sure we have an output file if we're not doing the work in-place.
   RequireAtLeastOnePassed({ "in_place", "output", "centroid" }, false,
@@ -88,7 +102,9 @@ static void mlpackMain()
   arma::mat centroids;
   arma::Row<size_t> assignments;
 
-  MeanShift<> meanShift(radius, maxIterations);
+  MeanShift<> meanShift(radius, maxIterations, GaussianKernel(),
+      CLI::GetParam<double>("bin_size"),
+      (size_t) CLI::GetParam<int>("min_bin_frequency"));
 
   Timer::Start("clustering");
   Log::Info << "Performing mean shift clustering..." << endl;
@@ -19,6 +19,7 @@
 
 using namespace mlpack;
 using namespace mlpack::mvu;
+using namespace mlpack::neighbor;
 using namespace mlpack::optimization;
 
 MVU::MVU(const arma::mat& data) : data(data)
@@ -30,82 +31,136 @@ void MVU::Unfold(const size_t newDim,
                  const size_t numNeighbors,
                  arma::mat& outputData)
 {
-  // First we have to choose the output point.  We'll take a linear projection
-  // of the data for now (this is probably not a good final solution).
-//  outputData = trans(data.rows(0, newDim - 1));
-  // Following Nick's idea.
-  outputData.randu(data.n_cols, newDim);
+  SolveSDP(data, newDim, numNeighbors, outputData);
 
-  // The number of constraints is the number of nearest neighbors plus one.
-  LRSDP<arma::sp_mat> mvuSolver(numNeighbors * data.n_cols + 1, outputData);
+  // Revert to original data format.
+  outputData = trans(outputData);
+}
 
-  // Set up the objective.  Because we are maximizing the trace of (R R^T),
-  // we'll instead state it as min(-I_n * (R R^T)), meaning C() is -I_n.
-  mvuSolver.C().eye(data.n_cols, data.n_cols);
-  mvuSolver.C() *= -1;
+void MVU::UnfoldLandmarks(const size_t newDim,
+                          const size_t numNeighbors,
+                          const size_t numLandmarks,
+                          arma::mat& outputData)
+{
+  if (numLandmarks <= numNeighbors || numLandmarks > data.n_cols)
+  {
+    throw std::invalid_argument("MVU::UnfoldLandmarks(): the number of "
+        "landmarks must be greater than the number of neighbors, and at most "
+        "the number of points");
+  }
+
+  // Take the landmarks at regular intervals of the dataset, and unfold them.
+  arma::uvec landmarks(numLandmarks);
+  for (size_t i = 0; i < numLandmarks; ++i)
+    landmarks[i] = (i * data.n_cols) / numLandmarks;
+  const arma::mat landmarkData = data.cols(landmarks);
 
-  // Now set up each of the constraints.
-  // The first constraint is trace(ones * R * R^T) = 0.
-  mvuSolver.B()[0] = 0;
-  mvuSolver.A()[0].ones(data.n_cols, data.n_cols);
+  arma::mat landmarkCoordinates;
+  SolveSDP(landmarkData, newDim, numNeighbors, landmarkCoordinates);
+  landmarkCoordinates = trans(landmarkCoordinates);
+
+  // Find the nearest landmarks of every point.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  KNN knn(landmarkData, SINGLE_TREE_MODE);
+  knn.Search(data, numNeighbors, neighbors, distances);
+
+  // Place every point at the combination of its nearest landmarks (with
+  // weights summing to one) that reconstructs it best in the original space.
+  outputData.set_size(newDim, data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    const arma::uvec nearest = arma::conv_to<arma::uvec>::from(
+        neighbors.col(i));
+    arma::mat offsets = landmarkData.cols(nearest);
+    offsets.each_col() -= data.col(i);
+
+    // The Gram matrix is singular when there are more neighbors than
+    // dimensions, so it is regularized.
+    arma::mat gram = trans(offsets) * offsets;
+    gram.diag() += 1e-3 * arma::trace(gram) + 1e-12;
+
+    arma::vec weights = arma::solve(gram, arma::ones<arma::vec>(
+        numNeighbors));
+    weights /= arma::accu(weights);
+    outputData.col(i) = landmarkCoordinates.cols(nearest) * weights;
+  }
 
-  // All of our other constraints will be sparse except the first.  So set that
-  // vector of modes accordingly.
-  mvuSolver.AModes().ones();
-  mvuSolver.AModes()[0] = 0;
+  // The landmarks keep the coordinates of the SDP.
+  outputData.cols(landmarks) = landmarkCoordinates;
+}
 
-  // Now all of the other constraints.  We first have to run KNN to get the
-  // list of nearest neighbors.
+void MVU::SolveSDP(const arma::mat& points,
+                   const size_t newDim,
+                   const size_t numNeighbors,
+                   arma::mat& coordinates)
+{
+  // We first have to run KNN to get the list of nearest neighbors.  The
+  // single-tree search runs in parallel over the points.
   arma::Mat<size_t> neighbors;
   arma::mat distances;
 
-  KNN knn(data);
+  KNN knn(points, SINGLE_TREE_MODE);
   knn.Search(numNeighbors, neighbors, distances);
 
-  // Add each of the other constraints.  They are sparse constraints:
-  //   Tr(A_ij K) = d_ij;
-  //   A_ij = zeros except for 1 at (i, i), (j, j); -1 at (i, j), (j, i).
+  // Every edge of the neighbor graph gives one constraint, also when the two
+  // points are among the neighbors of each other.
+  std::vector<std::pair<std::pair<size_t, size_t>, double> > edges;
   for (size_t i = 0; i < neighbors.n_cols; ++i)
   {
     for (size_t j = 0; j < numNeighbors; ++j)
     {
-      // This is the index of the constraint.
-      const size_t index = (i * numNeighbors) + j + 1;
+      const size_t neighbor = neighbors(j, i);
+      edges.push_back(std::make_pair(std::make_pair(std::min(i, neighbor),
+          std::max(i, neighbor)), distances(j, i)));
+    }
+  }
+
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end(),
+      [](const std::pair<std::pair<size_t, size_t>, double>& a,
+         const std::pair<std::pair<size_t, size_t>, double>& b)
+      {
+        return a.first == b.first;
+      }), edges.end());
 
-      arma::mat& aRef = mvuSolver.A()[index];
+  // First we have to choose the output point.  Following Nick's idea, we
+  // start from a random point.
+  coordinates.randu(points.n_cols, newDim);
 
-      aRef.set_size(3, 4);
+  // One sparse constraint per edge, and the dense centering constraint.
+  LRSDP<SDP<arma::sp_mat> > mvuSolver(edges.size(), 1, coordinates);
 
-      // A_ij(i, i) = 1.
-      aRef(0, 0) = i;
-      aRef(1, 0) = i;
-      aRef(2, 0) = 1;
+  // Set up the objective.  Because we are maximizing the trace of (R R^T),
+  // we'll instead state it as min(-I_n * (R R^T)), meaning C() is -I_n.
+  mvuSolver.SDP().C().eye(points.n_cols, points.n_cols);
+  mvuSolver.SDP().C() *= -1;
 
-      // A_ij(i, j) = -1.
-      aRef(0, 1) = i;
-      aRef(1, 1) = neighbors(j, i);
-      aRef(2, 1) = -1;
+  // The dense constraint is trace(ones * R * R^T) = 0.
+  mvuSolver.SDP().DenseA()[0].ones(points.n_cols, points.n_cols);
+  mvuSolver.SDP().DenseB()[0] = 0;
 
-      // A_ij(j, i) = -1.
-      aRef(0, 2) = neighbors(j, i);
-      aRef(1, 2) = i;
-      aRef(2, 2) = -1;
+  // The sparse constraints are
+  //   Tr(A_ij K) = d_ij^2;
+  //   A_ij = zeros except for 1 at (i, i), (j, j); -1 at (i, j), (j, i).
+  for (size_t e = 0; e < edges.size(); ++e)
+  {
+    const size_t i = edges[e].first.first;
+    const size_t j = edges[e].first.second;
 
-      // A_ij(j, j) = 1.
-      aRef(0, 3) = neighbors(j, i);
-      aRef(1, 3) = neighbors(j, i);
-      aRef(2, 3) = 1;
+    arma::sp_mat& aRef = mvuSolver.SDP().SparseA()[e];
+    aRef(i, i) = 1;
+    aRef(j, j) = 1;
+    aRef(i, j) = -1;
+    aRef(j, i) = -1;
 
-      // The constraint b_ij is the distance between these two points.
-      mvuSolver.B()[index] = distances(j, i);
-    }
+    // The constraint b_ij is the squared distance between these two points.
+    mvuSolver.SDP().SparseB()[e] = edges[e].second * edges[e].second;
   }
 
   // Now on with the solving.
-  double objective = mvuSolver.Optimize(outputData);
+  double objective = mvuSolver.Optimize(coordinates);
 
   Log::Info << "Final objective is " << objective << "." << std::endl;
-
-  // Revert to original data format.
-  outputData = trans(outputData);
 }
@@ -28,6 +28,11 @@ namespace mvu {
  *
  * - dataset
  * - new dimensionality
+ *
+ * The exact SDP has one variable per pair of points, so it is only tractable
+ * for a few thousand points.  For large datasets, UnfoldLandmarks() solves the
+ * SDP over a subset of landmark points only, and places every other point by
+ * local linear reconstruction from its nearest landmarks.
  */
 class MVU
 {
@@ -38,7 +43,44 @@ class MVU
               const size_t numNeighbors,
               arma::mat& outputCoordinates);
 
+  /**
+   * Unfold the dataset with landmark MVU.  The landmarks are taken at regular
+   * intervals of the dataset, and unfolded with the exact SDP over the graph of
+   * their nearest neighbors (among the landmarks).  Every point is then
+   * placed at the combination of its nearest landmarks that reconstructs it
+   * best in the original space (as in locally linear embedding), with the
+   * weights summing to one.  The neighbor searches are single-tree searches,
+   * which run in parallel over the points, and so does the reconstruction.
+   *
+   * @param newDim Dimensionality of the unfolded dataset.
+   * @param numNeighbors Number of nearest neighbors of each landmark in the
+   *     SDP, and number of landmarks each point is reconstructed from.
+   * @param numLandmarks Number of landmarks.
+   * @param outputCoordinates Matrix to store the unfolded dataset in (one
+   *     column per point, like Unfold()).
+   */
+  void UnfoldLandmarks(const size_t newDim,
+                       const size_t numNeighbors,
+                       const size_t numLandmarks,
+                       arma::mat& outputCoordinates);
+
  private:
+  /**
+   * Solve the MVU SDP for the given points: maximize the variance of the
+   * unfolded points, with the distance of every point to each of its nearest
+   * neighbors held.
+   *
+   * @param points Points to unfold.
+   * @param newDim Dimensionality of the unfolded points.
+   * @param numNeighbors Number of nearest neighbors of each point.
+   * @param coordinates Matrix to store the unfolded points in (one row per
+   *     point).
+   */
+  static void SolveSDP(const arma::mat& points,
+                       const size_t newDim,
+                       const size_t numNeighbors,
+                       arma::mat& coordinates);
+
   const arma::mat& data;
 };
 
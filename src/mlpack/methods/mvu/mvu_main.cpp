@@ -19,7 +19,12 @@ PROGRAM_INFO("Maximum Variance Unfolding (MVU)", "This program implements "
     "Maximum Variance Unfolding, a nonlinear dimensionality reduction "
     "technique.  The method minimizes dimensionality by unfolding a manifold "
     "such that the distances to the nearest neighbors of each point are held "
-    "constant.");
+    "constant."
+    "\n\n"
+    "For large datasets, landmark MVU can be used by specifying the number of "
+    "landmarks with the " + PRINT_PARAM_STRING("landmarks") + " parameter: "
+    "the SDP is only solved for the landmarks, and every other point is "
+    "reconstructed from its nearest landmarks.");
 
 PARAM_MATRIX_IN_REQ("input", "Input dataset.", "i");
 PARAM_INT_IN_REQ("new_dim", "New dimensionality of dataset.", "d");
@@ -27,6 +32,8 @@ PARAM_INT_IN_REQ("new_dim", "New dimensionality of dataset.", "d");
 PARAM_MATRIX_OUT("output", "Matrix to save unfolded dataset to.", "o");
 PARAM_INT_IN("num_neighbors", "Number of nearest neighbors to consider while "
     "unfolding.", "k", 5);
+PARAM_INT_IN("landmarks", "Number of landmarks for landmark MVU (0 solves the "
+    "SDP for all the points).", "l", 0);
 
 using namespace mlpack;
 using namespace mlpack::mvu;
@@ -39,10 +46,9 @@ int main(int argc, char **argv)
 {
   // Read from command line.
   CLI::ParseCommandLine(argc, argv);
-  const string inputFile = CLI::GetParam<string>("input_file");
-  const string outputFile = CLI::GetParam<string>("output_file");
   const int newDim = CLI::GetParam<int>("new_dim");
   const int numNeighbors = CLI::GetParam<int>("num_neighbors");
+  const int landmarks = CLI::GetParam<int>("landmarks");
 
   if (!CLI::HasParam("output"))
   {
@@ -71,11 +77,24 @@ int main(int argc, char **argv)
         << data.n_cols << ")." << std::endl;
   }
 
+  // Verify that the number of landmarks is valid.
+  if (landmarks != 0 && (landmarks <= numNeighbors ||
+      landmarks > (int) data.n_cols))
+  {
+    Log::Fatal << "Invalid number of landmarks (" << landmarks << ").  Must "
+        << "be 0, or greater than the number of neighbors and at most the "
+        << "number of points in the input dataset (" << data.n_cols << ")."
+        << std::endl;
+  }
+
   // Now run MVU.
   MVU mvu(data);
 
   mat output;
-  mvu.Unfold(newDim, numNeighbors, output);
+  if (landmarks > 0)
+    mvu.UnfoldLandmarks(newDim, numNeighbors, landmarks, output);
+  else
+    mvu.Unfold(newDim, numNeighbors, output);
 
   // Save results to file.
   if (CLI::HasParam("output"))
@@ -16,6 +16,7 @@
 #define MLPACK_METHODS_NAIVE_BAYES_NAIVE_BAYES_CLASSIFIER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/parallel_blocks.hpp>
 
 namespace mlpack {
 namespace naive_bayes /** The Naive Bayes Classifier. */ {
@@ -75,9 +76,9 @@ class NaiveBayesClassifier
    * @param data Training data points.
    * @param labels Labels corresponding to training data points.
    * @param numClasses Number of classes in this classifier.
-   * @param incrementalVariance If true, an incremental algorithm is used to
-   *     calculate the variance; this can prevent loss of precision in some
-   *     cases, but will be somewhat slower to calculate.
+   * @param incrementalVariance If true, the moments of the data are merged
+   *     into the (zero) model with the incremental algorithm; the result is
+   *     the same.
    */
   template<typename MatType>
   NaiveBayesClassifier(const MatType& data,
@@ -99,6 +100,12 @@ class NaiveBayesClassifier
    * algorithm is used, the current model is used as a starting point (this is
    * the default).  If the incremental algorithm is not used, then the current
    * model is ignored and the new model will be trained only on the given data.
+   *
+   * The means and variances of each class in the dataset are computed with a
+   * parallel two-pass algorithm, and with the incremental algorithm they are
+   * then merged with the moments of the points seen so far (Chan et al.'s
+   * pairwise update), so training on several batches gives the model of
+   * training on all of them at once.
    * Note that even if the incremental algorithm is not used, the data must have
    * the same dimensionality and number of classes that the model was
    * initialized with.  If you want to change the dimensionality or number of
@@ -225,10 +232,31 @@ class NaiveBayesClassifier
   //! Number of training points seen so far.
   size_t trainingPoints;
 
+  /**
+   * Compute the number of points, the means, and the sums of squared deviations
+   * from the means of each class in the given batch, in parallel.
+   *
+   * @param data Set of points.
+   * @param labels Labels of the points.
+   * @param numClasses Number of classes.
+   * @param counts Vector to store the number of points of each class in.
+   * @param batchMeans Matrix to store the means of each class in.
+   * @param batchSquares Matrix to store the sums of squared deviations of each
+   *     class in.
+   */
+  template<typename MatType>
+  void BatchMoments(const MatType& data,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    arma::vec& counts,
+                    ModelMatType& batchMeans,
+                    ModelMatType& batchSquares) const;
+
   /**
    * Compute the unnormalized posterior log probability of given points (log
    * likelihood). Results are returned as arma::mat, and each column represents
-   * a point, each row represents log likelihood of a class.
+   * a point, each row represents log likelihood of a class.  The points are
+   * processed in parallel blocks, with two matrix products per block.
    *
    * @param data Set of points to compute posterior log probability for.
    * @param logLikelihoods Matrix to store log likelihoods in.
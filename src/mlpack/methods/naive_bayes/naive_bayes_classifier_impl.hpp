@@ -102,75 +102,144 @@ void NaiveBayesClassifier<ModelMatType>::Train(
   }
 
   // Calculate the class probabilities as well as the sample mean and variance
-  // for each of the features with respect to each of the labels.
+  // for each of the features with respect to each of the labels.  The moments
+  // of the batch are computed with a (parallel) two-pass algorithm.
+  arma::vec counts;
+  ModelMatType batchMeans, batchSquares;
+  BatchMoments(data, labels, numClasses, counts, batchMeans, batchSquares);
+
   if (incremental)
   {
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
-    probabilities *= trainingPoints;
-
-    for (size_t j = 0; j < data.n_cols; ++j)
+    // Merge the moments of the batch with the moments of the points seen so
+    // far, as in
+    //
+    //   Chan, T.F., Golub, G.H. and LeVeque, R.J., "Updating formulae and a
+    //   pairwise algorithm for computing sample variances", COMPSTAT 1982.
+    //
+    // which has the precision of the two-pass algorithm over all the points.
+    for (size_t i = 0; i < numClasses; ++i)
     {
-      const size_t label = labels[j];
-      ++probabilities[label];
-
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
+      const double oldCount = std::round(probabilities[i] * trainingPoints);
+      const double batchCount = counts[i];
+      const double count = oldCount + batchCount;
+      counts[i] = count;
+      if (batchCount == 0.0)
+        continue;
+
+      const arma::Col<ElemType> delta = batchMeans.col(i) - means.col(i);
+      arma::Col<ElemType> squares = batchSquares.col(i) +
+          (oldCount * batchCount / count) * arma::square(delta);
+      if (oldCount > 1.0)
+        squares += (oldCount - 1.0) * variances.col(i);
+
+      means.col(i) += (batchCount / count) * delta;
+      if (count > 1.0)
+        variances.col(i) = squares / (count - 1.0);
+      else
+        variances.col(i).zeros();
     }
 
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-    {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
-    }
+    trainingPoints += data.n_cols;
   }
   else
   {
-    // Set all parameters to zero.
-    probabilities.zeros();
-    means.zeros();
-    variances.zeros();
-
-    // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
-    // possible to calculate the means and variances using a faster one-pass
-    // algorithm but there are some precision and stability issues.  If this is
-    // too slow, it's an option to use the faster algorithm by default and then
-    // have this (and the incremental algorithm) be other options.
-
-    // Calculate the means.
-    for (size_t j = 0; j < data.n_cols; ++j)
+    means = batchMeans;
+    variances = batchSquares;
+    for (size_t i = 0; i < numClasses; ++i)
     {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
+      if (counts[i] > 1.0)
+        variances.col(i) /= (counts[i] - 1.0);
     }
 
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
+    trainingPoints = data.n_cols;
+  }
+
+  // Ensure that the variances are invertible.
+  for (size_t i = 0; i < variances.n_elem; ++i)
+    if (variances[i] == 0.0)
+      variances[i] = 1e-50;
+
+  probabilities.zeros();
+  if (trainingPoints > 0)
+  {
+    for (size_t i = 0; i < numClasses; ++i)
+      probabilities[i] = counts[i] / trainingPoints;
+  }
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::BatchMoments(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::vec& counts,
+    ModelMatType& batchMeans,
+    ModelMatType& batchSquares) const
+{
+  if (labels.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NaiveBayesClassifier::Train(): number of labels ("
+        << labels.n_elem << ") does not match the number of points ("
+        << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (labels.n_elem > 0 && arma::max(labels) >= numClasses)
+  {
+    std::ostringstream oss;
+    oss << "NaiveBayesClassifier::Train(): label " << arma::max(labels)
+        << " is not less than the number of classes (" << numClasses << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  counts.zeros(numClasses);
+  batchMeans.zeros(data.n_rows, numClasses);
+  batchSquares.zeros(data.n_rows, numClasses);
 
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
+  // Each thread accumulates the sums of a part of the points, which are then
+  // combined.
+  #pragma omp parallel
+  {
+    arma::vec localCounts(numClasses, arma::fill::zeros);
+    ModelMatType localSums(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
     {
       const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
+      ++localCounts[label];
+      localSums.col(label) += data.col(j);
     }
 
-    // Normalize variances.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] > 1)
-        variances.col(i) /= (probabilities[i] - 1);
+    #pragma omp critical
+    {
+      counts += localCounts;
+      batchMeans += localSums;
+    }
   }
 
-  // Ensure that the variances are invertible.
-  for (size_t i = 0; i < variances.n_elem; ++i)
-    if (variances[i] == 0.0)
-      variances[i] = 1e-50;
+  for (size_t i = 0; i < numClasses; ++i)
+    if (counts[i] != 0.0)
+      batchMeans.col(i) /= counts[i];
 
-  probabilities /= data.n_cols;
-  trainingPoints += data.n_cols;
+  // The sums of the squared deviations from the means of the batch.
+  #pragma omp parallel
+  {
+    ModelMatType localSquares(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      localSquares.col(label) += arma::square(data.col(j) -
+          batchMeans.col(label));
+    }
+
+    #pragma omp critical
+    batchSquares += localSquares;
+  }
 }
 
 template<typename ModelMatType>
@@ -208,24 +277,38 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
-
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
+  // The exponent of each Gaussian is expanded as
+  //
+  //   -0.5 sum_f (x_f - mu_f)^2 / var_f = (mu / var)^T x
+  //       - 0.5 (1 / var)^T (x % x) - 0.5 (mu / var)^T mu,
+  //
+  // so the log likelihoods of all the classes for a block of points are two
+  // matrix products.  The points and the means are shifted by the average of
+  // the means first, so that the expansion does not lose precision when the
+  // data is far from the origin.
+  const arma::Col<ElemType> shift = arma::mean(means, 1);
+  ModelMatType shiftedMeans = means;
+  shiftedMeans.each_col() -= shift;
+  const ModelMatType invVar = 1.0 / variances;
+  const ModelMatType weightedMeans = shiftedMeans % invVar;
+
+  // The terms that do not depend on the point, for each class.
+  arma::Col<ElemType> constants = arma::log(probabilities);
+  constants -= 0.5 * arma::trans(arma::sum(arma::log(variances), 0) +
+      arma::sum(shiftedMeans % weightedMeans, 0));
+  constants -= 0.5 * data.n_rows * std::log(2 * M_PI);
+
+  logLikelihoods.set_size(means.n_cols, data.n_cols);
+  math::ParallelColumnBlocks(data.n_cols,
+      [&](const size_t begin, const size_t end)
   {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    ModelMatType diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = arma::sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        std::log(arma::det(arma::diagmat(variances.col(i)))) + exponents);
-  }
+    ModelMatType block(data.cols(begin, end - 1));
+    block.each_col() -= shift;
+
+    logLikelihoods.cols(begin, end - 1) = weightedMeans.t() * block -
+        0.5 * invVar.t() * arma::square(block);
+    logLikelihoods.cols(begin, end - 1).each_col() += constants;
+  });
 }
 
 template<typename ModelMatType>
@@ -266,7 +349,9 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
   // term.
   ModelMatType logLikelihoods;
   LogLikelihood(point, logLikelihoods);
-  const double logProbX = log(arma::accu(exp(logLikelihoods))); // Log(Prob(X)).
+  const double maxLogLikelihood = logLikelihoods.max();
+  const double logProbX = maxLogLikelihood + std::log(arma::accu(exp(
+      logLikelihoods - maxLogLikelihood))); // Log(Prob(X)).
   logLikelihoods -= logProbX;
 
   arma::uword maxIndex = 0;
@@ -318,23 +403,24 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
   ModelMatType logLikelihoods;
   LogLikelihood(data, logLikelihoods);
 
-  // This will hold log(Prob(X)) for each point.
-  arma::Col<ElemType> logProbX(data.n_cols);
-  for (size_t j = 0; j < data.n_cols; ++j)
+  // Normalize each point by log(Prob(X)), one block at a time.  The largest
+  // log likelihood is subtracted before the exponential, so that it does not
+  // underflow.
+  predictionProbs.set_size(logLikelihoods.n_rows, logLikelihoods.n_cols);
+  math::ParallelColumnBlocks(data.n_cols,
+      [&](const size_t begin, const size_t end)
   {
-    logProbX(j) = log(arma::accu(exp(logLikelihoods.col(j))));
-    logLikelihoods.col(j) -= logProbX(j);
-  }
-
-  predictionProbs = arma::exp(logLikelihoods);
+    for (size_t j = begin; j < end; ++j)
+    {
+      arma::uword maxIndex = 0;
+      const ElemType maxLogLikelihood = logLikelihoods.col(j).max(maxIndex);
+      predictions[j] = maxIndex;
 
-  // Now calculate maximum probabilities for each point.
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    arma::uword maxIndex = 0;
-    logLikelihoods.unsafe_col(i).max(maxIndex);
-    predictions[i] = maxIndex;
-  }
+      predictionProbs.col(j) = arma::exp(logLikelihoods.col(j) -
+          maxLogLikelihood);
+      predictionProbs.col(j) /= arma::accu(predictionProbs.col(j));
+    }
+  });
 }
 
 template<typename ModelMatType>
@@ -17,6 +17,7 @@
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
 
 #include "nca_softmax_error_function.hpp"
+#include "nca_truncated_softmax_error_function.hpp"
 
 namespace mlpack {
 namespace nca /** Neighborhood Components Analysis. */ {
@@ -43,9 +44,19 @@ namespace nca /** Neighborhood Components Analysis. */ {
  *   year = {2004}
  * }
  * @endcode
+ *
+ * The objective takes O(n^2) time to evaluate.  For large datasets, use
+ * TruncatedSoftmaxErrorFunction as the ErrorFunctionType, which only considers
+ * the nearest neighbors of each point in the transformed space; its parameters
+ * can be set through ErrorFunction() before calling LearnDistance().
+ *
+ * @tparam MetricType Type of metric to use.
+ * @tparam OptimizerType Type of optimizer to use.
+ * @tparam ErrorFunctionType Type of the objective function to optimize.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance,
-         typename OptimizerType = optimization::StandardSGD>
+         typename OptimizerType = optimization::StandardSGD,
+         typename ErrorFunctionType = SoftmaxErrorFunction<MetricType>>
 class NCA
 {
  public:
@@ -86,6 +97,11 @@ class NCA
   const OptimizerType& Optimizer() const { return optimizer; }
   OptimizerType& Optimizer() { return optimizer; }
 
+  //! Get the function to optimize.
+  const ErrorFunctionType& ErrorFunction() const { return errorFunction; }
+  //! Modify the function to optimize.
+  ErrorFunctionType& ErrorFunction() { return errorFunction; }
+
  private:
   //! Dataset reference.
   const arma::mat& dataset;
@@ -96,7 +112,7 @@ class NCA
   MetricType metric;
 
   //! The function to optimize.
-  SoftmaxErrorFunction<MetricType> errorFunction;
+  ErrorFunctionType errorFunction;
 
   //! The optimizer to use.
   OptimizerType optimizer;
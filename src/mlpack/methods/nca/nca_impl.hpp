@@ -19,18 +19,24 @@ namespace mlpack {
 namespace nca {
 
 // Just set the internal matrix reference.
-template<typename MetricType, typename OptimizerType>
-NCA<MetricType, OptimizerType>::NCA(const arma::mat& dataset,
-                                    const arma::Row<size_t>& labels,
-                                    MetricType metric) :
+template<typename MetricType,
+         typename OptimizerType,
+         typename ErrorFunctionType>
+NCA<MetricType, OptimizerType, ErrorFunctionType>::NCA(
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    MetricType metric) :
     dataset(dataset),
     labels(labels),
     metric(metric),
     errorFunction(dataset, labels, metric)
 { /* Nothing to do. */ }
 
-template<typename MetricType, typename OptimizerType>
-void NCA<MetricType, OptimizerType>::LearnDistance(arma::mat& outputMatrix)
+template<typename MetricType,
+         typename OptimizerType,
+         typename ErrorFunctionType>
+void NCA<MetricType, OptimizerType, ErrorFunctionType>::LearnDistance(
+    arma::mat& outputMatrix)
 {
   // See if we were passed an initialized matrix.
   if ((outputMatrix.n_rows != dataset.n_rows) ||
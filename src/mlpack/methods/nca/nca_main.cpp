@@ -82,6 +82,14 @@ PROGRAM_INFO("Neighborhood Components Analysis (NCA)",
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
     "literature on L-BFGS."
     "\n\n"
+    "Each evaluation of the objective takes time quadratic in the number of "
+    "points.  For large datasets, the soft neighbors of each point can be "
+    "restricted to its nearest neighbors in the transformed space by setting " +
+    PRINT_PARAM_STRING("num_neighbors") + " to the number of neighbors to use;"
+    " the neighbors are then searched again with a tree every " +
+    PRINT_PARAM_STRING("refresh_interval") + " points passed to the gradient "
+    "(by default, once per pass over the dataset)."
+    "\n\n"
     "By default, the SGD optimizer is used.");
 
 PARAM_MATRIX_IN_REQ("input", "Input dataset to run NCA on.", "i");
@@ -115,6 +123,12 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("num_neighbors", "Number of nearest neighbors of each point to "
+    "use as soft neighbors (0 uses all the points).", "k", 0);
+PARAM_INT_IN("refresh_interval", "Number of points between two searches of "
+    "the nearest neighbors, if num_neighbors is given (0 searches once per "
+    "pass over the dataset).", "R", 0);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -124,6 +138,67 @@ using namespace mlpack::optimization;
 using namespace mlpack::util;
 using namespace std;
 
+//! Setting the number of neighbors of the exact objective does nothing.
+static void SetNeighbors(SoftmaxErrorFunction<LMetric<2>>& /* function */)
+{ }
+
+//! Set the number of neighbors and the refresh interval of the truncated
+//! objective.
+static void SetNeighbors(TruncatedSoftmaxErrorFunction<LMetric<2>>& function)
+{
+  function.K() = (size_t) CLI::GetParam<int>("num_neighbors");
+  function.RefreshInterval() = (size_t) CLI::GetParam<int>("refresh_interval");
+}
+
+//! Run NCA with the given objective and the optimizer given on the command
+//! line, starting from the given distance matrix.
+template<typename ErrorFunctionType>
+static void RunNCA(const arma::mat& data,
+                   const arma::Row<size_t>& labels,
+                   arma::mat& distance)
+{
+  const string optimizerType = CLI::GetParam<string>("optimizer");
+  const double stepSize = CLI::GetParam<double>("step_size");
+  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
+  const double tolerance = CLI::GetParam<double>("tolerance");
+  const bool shuffle = !CLI::HasParam("linear_scan");
+  const int numBasis = CLI::GetParam<int>("num_basis");
+  const double armijoConstant = CLI::GetParam<double>("armijo_constant");
+  const double wolfe = CLI::GetParam<double>("wolfe");
+  const int maxLineSearchTrials = CLI::GetParam<int>("max_line_search_trials");
+  const double minStep = CLI::GetParam<double>("min_step");
+  const double maxStep = CLI::GetParam<double>("max_step");
+  const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
+
+  if (optimizerType == "sgd")
+  {
+    NCA<LMetric<2>, StandardSGD, ErrorFunctionType> nca(data, labels);
+    SetNeighbors(nca.ErrorFunction());
+    nca.Optimizer().StepSize() = stepSize;
+    nca.Optimizer().MaxIterations() = maxIterations;
+    nca.Optimizer().Tolerance() = tolerance;
+    nca.Optimizer().Shuffle() = shuffle;
+    nca.Optimizer().BatchSize() = batchSize;
+
+    nca.LearnDistance(distance);
+  }
+  else if (optimizerType == "lbfgs")
+  {
+    NCA<LMetric<2>, L_BFGS, ErrorFunctionType> nca(data, labels);
+    SetNeighbors(nca.ErrorFunction());
+    nca.Optimizer().NumBasis() = numBasis;
+    nca.Optimizer().MaxIterations() = maxIterations;
+    nca.Optimizer().ArmijoConstant() = armijoConstant;
+    nca.Optimizer().Wolfe() = wolfe;
+    nca.Optimizer().MinGradientNorm() = tolerance;
+    nca.Optimizer().MaxLineSearchTrials() = maxLineSearchTrials;
+    nca.Optimizer().MinStep() = minStep;
+    nca.Optimizer().MaxStep() = maxStep;
+
+    nca.LearnDistance(distance);
+  }
+}
+
 static void mlpackMain()
 {
   if (CLI::GetParam<int>("seed") != 0)
@@ -156,18 +231,17 @@ static void mlpackMain()
     ReportIgnoredParam("batch_size", "SGD optimizer is not being used");
   }
 
-  const double stepSize = CLI::GetParam<double>("step_size");
-  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
-  const double tolerance = CLI::GetParam<double>("tolerance");
+  RequireParamValue<int>("num_neighbors", [](int x) { return x >= 0; }, true,
+      "number of neighbors must be nonnegative");
+  RequireParamValue<int>("refresh_interval", [](int x) { return x >= 0; },
+      true, "refresh interval must be nonnegative");
+  if (CLI::GetParam<int>("num_neighbors") == 0)
+  {
+    ReportIgnoredParam("refresh_interval", "all the points are used as soft "
+        "neighbors");
+  }
+
   const bool normalize = CLI::HasParam("normalize");
-  const bool shuffle = !CLI::HasParam("linear_scan");
-  const int numBasis = CLI::GetParam<int>("num_basis");
-  const double armijoConstant = CLI::GetParam<double>("armijo_constant");
-  const double wolfe = CLI::GetParam<double>("wolfe");
-  const int maxLineSearchTrials = CLI::GetParam<int>("max_line_search_trials");
-  const double minStep = CLI::GetParam<double>("min_step");
-  const double maxStep = CLI::GetParam<double>("max_step");
-  const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
 
   // Load data.
   arma::mat data = std::move(CLI::GetParam<arma::mat>("input"));
@@ -213,31 +287,10 @@ static void mlpackMain()
   }
 
   // Now create the NCA object and run the optimization.
-  if (optimizerType == "sgd")
-  {
-    NCA<LMetric<2> > nca(data, labels);
-    nca.Optimizer().StepSize() = stepSize;
-    nca.Optimizer().MaxIterations() = maxIterations;
-    nca.Optimizer().Tolerance() = tolerance;
-    nca.Optimizer().Shuffle() = shuffle;
-    nca.Optimizer().BatchSize() = batchSize;
-
-    nca.LearnDistance(distance);
-  }
-  else if (optimizerType == "lbfgs")
-  {
-    NCA<LMetric<2>, L_BFGS> nca(data, labels);
-    nca.Optimizer().NumBasis() = numBasis;
-    nca.Optimizer().MaxIterations() = maxIterations;
-    nca.Optimizer().ArmijoConstant() = armijoConstant;
-    nca.Optimizer().Wolfe() = wolfe;
-    nca.Optimizer().MinGradientNorm() = tolerance;
-    nca.Optimizer().MaxLineSearchTrials() = maxLineSearchTrials;
-    nca.Optimizer().MinStep() = minStep;
-    nca.Optimizer().MaxStep() = maxStep;
-
-    nca.LearnDistance(distance);
-  }
+  if (CLI::GetParam<int>("num_neighbors") > 0)
+    RunNCA<TruncatedSoftmaxErrorFunction<LMetric<2>>>(data, labels, distance);
+  else
+    RunNCA<SoftmaxErrorFunction<LMetric<2>>>(data, labels, distance);
 
   // Save the output.
   if (CLI::HasParam("output"))
@@ -70,8 +70,9 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
   double numerator = 0;
   double result = 0;
 
-  // It's quicker to do this now than one point at a time later.
-  stretchedDataset = coordinates * dataset;
+  // It's quicker to do this now than one point at a time later.  This is kept
+  // local, so that different batches can be evaluated at the same time.
+  const arma::mat stretched = coordinates * dataset;
   for (size_t i = begin; i < begin + batchSize; i++)
   {
     for (size_t k = 0; k < dataset.n_cols; ++k)
@@ -81,8 +82,8 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
         continue;
 
       // We want to evaluate exp(-D(A x_i, A x_k)).
-      double eval = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                              stretchedDataset.unsafe_col(k)));
+      double eval = std::exp(-metric.Evaluate(stretched.unsafe_col(i),
+                                              stretched.unsafe_col(k)));
 
       // If they are in the same class, update the numerator.
       if (labels[i] == labels[k])
@@ -170,8 +171,9 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
 
   gradient.zeros(coordinates.n_rows, coordinates.n_rows);
 
-  // Compute the stretched dataset.
-  stretchedDataset = coordinates * dataset;
+  // Compute the stretched dataset.  This is kept local, so that different
+  // batches can be evaluated at the same time.
+  const arma::mat stretched = coordinates * dataset;
   for (size_t i = begin; i < begin + batchSize; i++)
   {
     numerator = 0;
@@ -187,8 +189,8 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
         continue;
 
       // Calculate the numerator of p_ik.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
+      double eval = exp(-metric.Evaluate(stretched.unsafe_col(i),
+                                         stretched.unsafe_col(k)));
 
       // If the points are in the same class, we must add to the second term of
       // the gradient as well as the numerator of p_i.  We will divide by the
@@ -0,0 +1,204 @@
+/**
+ * @file nca_truncated_softmax_error_function.hpp
+ *
+ * The stochastic neighbor assignment probability error function (the "softmax
+ * error"), truncated to the nearest neighbors of each point in the transformed
+ * space.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NCA_NCA_TRUNCATED_SOFTMAX_ERROR_FUNCTION_HPP
+#define MLPACK_METHODS_NCA_NCA_TRUNCATED_SOFTMAX_ERROR_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+namespace mlpack {
+namespace nca {
+
+/**
+ * The "softmax" stochastic neighbor assignment probability function, where the
+ * soft neighbors of each point are restricted to its k nearest neighbors in the
+ * transformed space:
+ *
+ * p_ij = (exp(-|| A x_i - A x_j || ^ 2)) /
+ *     (sum_{k in N(i)} (exp(-|| A x_i - A x_k || ^ 2)))
+ *
+ * for j in N(i), the k nearest neighbors of A x_i among the other transformed
+ * points (and 0 otherwise).  The points far from x_i contribute almost nothing
+ * to the sums of SoftmaxErrorFunction, so this is a close approximation, but
+ * each evaluation only takes O(n k) time and memory instead of O(n^2).
+ *
+ * The nearest neighbors are found with a tree-based kNN search (KNN) on the
+ * transformed dataset, so the metric should be monotonic in the Euclidean
+ * distance (like the squared Euclidean distance and LMetric<2>).  Since the
+ * transformation changes during the optimization, the neighbors are searched
+ * again once RefreshInterval() points have been passed to Gradient() since the
+ * last search (by default, once per pass over the dataset); Evaluate() never
+ * searches again, unless there are no neighbors yet.
+ *
+ * With k = n - 1, this is exactly SoftmaxErrorFunction.
+ */
+template<typename MetricType = metric::SquaredEuclideanDistance>
+class TruncatedSoftmaxErrorFunction
+{
+ public:
+  /**
+   * Create the error function for the given dataset.  The dataset is not
+   * copied until Shuffle() is called.
+   *
+   * @param dataset Matrix containing the dataset.
+   * @param labels Vector of class labels for each point in the dataset.
+   * @param metric Instantiated metric (optional).
+   * @param k Number of neighbors of each point to consider.
+   * @param refreshInterval Number of points passed to Gradient() between two
+   *     searches of the neighbors (0 means once per pass over the dataset).
+   */
+  TruncatedSoftmaxErrorFunction(const arma::mat& dataset,
+                                const arma::Row<size_t>& labels,
+                                MetricType metric = MetricType(),
+                                const size_t k = 20,
+                                const size_t refreshInterval = 0);
+
+  /**
+   * Shuffle the dataset.  The neighbors are kept.
+   */
+  void Shuffle();
+
+  /**
+   * Evaluate the truncated softmax function for the given covariance matrix.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   */
+  double Evaluate(const arma::mat& covariance);
+
+  /**
+   * Evaluate the truncated softmax objective function for the given covariance
+   * matrix on the given batch of points.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param begin Index of the initial point to use for objective function.
+   * @param batchSize Number of points to use for objective function.
+   */
+  double Evaluate(const arma::mat& covariance,
+                  const size_t begin,
+                  const size_t batchSize = 1);
+
+  /**
+   * Evaluate the gradient of the truncated softmax function for the given
+   * covariance matrix.  The neighbors are searched again first, if necessary.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param gradient Matrix to store the calculated gradient in.
+   */
+  void Gradient(const arma::mat& covariance, arma::mat& gradient);
+
+  /**
+   * Evaluate the gradient of the truncated softmax function for the given
+   * covariance matrix on the given batch of points.  The neighbors are searched
+   * again first, if necessary.
+   *
+   * @tparam GradType The type of the gradient out-param.
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param begin Index of the initial point to use for objective function.
+   * @param gradient Matrix to store the calculated gradient in.
+   * @param batchSize Number of points to use for objective function.
+   */
+  template<typename GradType>
+  void Gradient(const arma::mat& covariance,
+                const size_t begin,
+                GradType& gradient,
+                const size_t batchSize = 1);
+
+  /**
+   * Get the initial point.
+   */
+  const arma::mat GetInitialPoint() const;
+
+  /**
+   * Get the number of functions the objective function can be decomposed into.
+   * This is just the number of points in the dataset.
+   */
+  size_t NumFunctions() const { return dataset.n_cols; }
+
+  //! Get the number of neighbors of each point.
+  size_t K() const { return k; }
+  //! Modify the number of neighbors of each point.
+  size_t& K() { return k; }
+
+  //! Get the number of points between two searches of the neighbors.
+  size_t RefreshInterval() const { return refreshInterval; }
+  //! Modify the number of points between two searches of the neighbors.
+  size_t& RefreshInterval() { return refreshInterval; }
+
+  //! Get the neighbors of each point (one column per point).
+  const arma::Mat<size_t>& Neighbors() const { return neighbors; }
+
+ private:
+  //! The dataset.  This is an alias until Shuffle() is called.
+  arma::mat dataset;
+  //! Labels for each point in the dataset.  This is an alias until Shuffle() is
+  //! called.
+  arma::Row<size_t> labels;
+
+  //! The instantiated metric.
+  MetricType metric;
+
+  //! The number of neighbors of each point.
+  size_t k;
+  //! The number of points between two searches of the neighbors.
+  size_t refreshInterval;
+
+  //! The neighbors of each point, one column per point.
+  arma::Mat<size_t> neighbors;
+  //! The number of points passed to Gradient() since the last search.
+  size_t visited;
+
+  //! Get the number of neighbors to search for each point.
+  size_t NumNeighbors() const
+  {
+    return (dataset.n_cols > 1) ? std::min(k, (size_t) dataset.n_cols - 1) : 0;
+  }
+
+  //! Return true if the neighbors do not match the dataset or K().
+  bool NeighborsStale() const
+  {
+    return (neighbors.n_cols != dataset.n_cols) ||
+        (neighbors.n_rows != NumNeighbors());
+  }
+
+  /**
+   * Search the k nearest neighbors of every point in the space transformed by
+   * the given coordinates.
+   *
+   * @param coordinates Coordinates matrix to transform the dataset with.
+   */
+  void Refresh(const arma::mat& coordinates);
+
+  /**
+   * Compute the objective over the given batch of points and, if the gradient
+   * is not NULL, its gradient.  Each point only takes O(k d^2) time, and the
+   * points are processed in parallel.
+   *
+   * @param coordinates Coordinates matrix.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points of the batch.
+   * @param gradient Matrix to store the gradient in, or NULL.
+   */
+  double Accumulate(const arma::mat& coordinates,
+                    const size_t begin,
+                    const size_t batchSize,
+                    arma::mat* gradient);
+};
+
+} // namespace nca
+} // namespace mlpack
+
+// Include implementation.
+#include "nca_truncated_softmax_error_function_impl.hpp"
+
+#endif
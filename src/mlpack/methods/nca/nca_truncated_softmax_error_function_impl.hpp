@@ -0,0 +1,236 @@
+/**
+ * @file nca_truncated_softmax_error_function_impl.hpp
+ *
+ * Implementation of the truncated softmax error function.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NCA_NCA_TRUNCATED_SOFTMAX_ERROR_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_NCA_NCA_TRUNCATED_SOFTMAX_ERROR_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included already.
+#include "nca_truncated_softmax_error_function.hpp"
+
+namespace mlpack {
+namespace nca {
+
+template<typename MetricType>
+TruncatedSoftmaxErrorFunction<MetricType>::TruncatedSoftmaxErrorFunction(
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    MetricType metric,
+    const size_t k,
+    const size_t refreshInterval) :
+    dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
+    labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
+    metric(metric),
+    k(k),
+    refreshInterval(refreshInterval),
+    visited(0)
+{
+  if (k == 0)
+  {
+    throw std::invalid_argument("TruncatedSoftmaxErrorFunction: the number of "
+        "neighbors must be positive!");
+  }
+}
+
+//! Shuffle the dataset, and renumber the neighbors accordingly.
+template<typename MetricType>
+void TruncatedSoftmaxErrorFunction<MetricType>::Shuffle()
+{
+  const arma::uvec ordering = arma::randperm(dataset.n_cols);
+
+  arma::mat newDataset = dataset.cols(ordering);
+  arma::Row<size_t> newLabels = labels.cols(ordering);
+
+  if (neighbors.n_cols == dataset.n_cols)
+  {
+    // Point ordering[i] becomes point i.
+    arma::Col<size_t> position(dataset.n_cols);
+    for (size_t i = 0; i < ordering.n_elem; ++i)
+      position[ordering[i]] = i;
+
+    arma::Mat<size_t> newNeighbors(neighbors.n_rows, neighbors.n_cols);
+    for (size_t i = 0; i < ordering.n_elem; ++i)
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+        newNeighbors(j, i) = position[neighbors(j, ordering[i])];
+
+    neighbors = std::move(newNeighbors);
+  }
+
+  math::ClearAlias(dataset);
+  math::ClearAlias(labels);
+
+  dataset = std::move(newDataset);
+  labels = std::move(newLabels);
+}
+
+template<typename MetricType>
+double TruncatedSoftmaxErrorFunction<MetricType>::Evaluate(
+    const arma::mat& coordinates)
+{
+  return Evaluate(coordinates, 0, dataset.n_cols);
+}
+
+template<typename MetricType>
+double TruncatedSoftmaxErrorFunction<MetricType>::Evaluate(
+    const arma::mat& coordinates,
+    const size_t begin,
+    const size_t batchSize)
+{
+  // The objective does not trigger periodic searches, so that the function
+  // does not change during a line search.
+  if (NeighborsStale())
+    Refresh(coordinates);
+
+  return Accumulate(coordinates, begin, batchSize, NULL);
+}
+
+template<typename MetricType>
+void TruncatedSoftmaxErrorFunction<MetricType>::Gradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient)
+{
+  Gradient(coordinates, 0, gradient, dataset.n_cols);
+}
+
+template<typename MetricType>
+template<typename GradType>
+void TruncatedSoftmaxErrorFunction<MetricType>::Gradient(
+    const arma::mat& coordinates,
+    const size_t begin,
+    GradType& gradient,
+    const size_t batchSize)
+{
+  const size_t interval = (refreshInterval == 0) ? dataset.n_cols :
+      refreshInterval;
+  if (NeighborsStale() || visited >= interval)
+    Refresh(coordinates);
+  visited += batchSize;
+
+  arma::mat denseGradient;
+  Accumulate(coordinates, begin, batchSize, &denseGradient);
+  gradient = denseGradient;
+}
+
+template<typename MetricType>
+const arma::mat TruncatedSoftmaxErrorFunction<MetricType>::GetInitialPoint()
+    const
+{
+  return arma::eye<arma::mat>(dataset.n_rows, dataset.n_rows);
+}
+
+template<typename MetricType>
+void TruncatedSoftmaxErrorFunction<MetricType>::Refresh(
+    const arma::mat& coordinates)
+{
+  visited = 0;
+
+  const size_t numNeighbors = NumNeighbors();
+  if (numNeighbors == 0)
+  {
+    neighbors.set_size(0, dataset.n_cols);
+    return;
+  }
+
+  // The search excludes each point from its own neighbors.
+  neighbor::KNN knn(arma::mat(coordinates * dataset));
+  arma::mat distances;
+  knn.Search(numNeighbors, neighbors, distances);
+}
+
+template<typename MetricType>
+double TruncatedSoftmaxErrorFunction<MetricType>::Accumulate(
+    const arma::mat& coordinates,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat* gradient)
+{
+  const size_t numNeighbors = neighbors.n_rows;
+  if (gradient != NULL)
+    gradient->zeros(coordinates.n_rows, coordinates.n_cols);
+  if (numNeighbors == 0)
+    return 0.0;
+
+  double result = 0.0;
+  #pragma omp parallel
+  {
+    arma::mat threadGradient;
+    if (gradient != NULL)
+      threadGradient.zeros(coordinates.n_rows, coordinates.n_cols);
+    double threadResult = 0.0;
+
+    arma::uvec indices(numNeighbors + 1);
+    arma::vec probabilities(numNeighbors);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
+    {
+      // Only point i and its neighbors are transformed.
+      const size_t i = begin + b;
+      indices[0] = i;
+      for (size_t j = 0; j < numNeighbors; ++j)
+        indices[j + 1] = neighbors(j, i);
+
+      const arma::mat points = dataset.cols(indices);
+      const arma::mat stretched = coordinates * points;
+
+      // Compute p_ij over the neighbors.  Shifting the distances by the
+      // smallest one does not change p_ij but avoids underflow.
+      for (size_t j = 0; j < numNeighbors; ++j)
+      {
+        probabilities[j] = metric.Evaluate(stretched.unsafe_col(0),
+                                           stretched.unsafe_col(j + 1));
+      }
+      probabilities = arma::exp(probabilities.min() - probabilities);
+      probabilities /= arma::accu(probabilities);
+
+      double p = 0.0;
+      for (size_t j = 0; j < numNeighbors; ++j)
+        if (labels[indices[j + 1]] == labels[i])
+          p += probabilities[j];
+
+      // Negate because the optimizer is a minimizer.
+      threadResult -= p;
+
+      if (gradient == NULL)
+        continue;
+
+      // The gradient of p_i is
+      //   2 A (p_i sum_j (p_ij x_ij x_ij^T) -
+      //       sum_{j in class of i} (p_ij x_ij x_ij^T)),
+      // which is the product of the weighted transformed differences A x_ij
+      // with the differences x_ij.
+      arma::vec weights = p * probabilities;
+      for (size_t j = 0; j < numNeighbors; ++j)
+        if (labels[indices[j + 1]] == labels[i])
+          weights[j] -= probabilities[j];
+
+      arma::mat differences = -points.tail_cols(numNeighbors);
+      differences.each_col() += points.col(0);
+      arma::mat stretchedDifferences = -stretched.tail_cols(numNeighbors);
+      stretchedDifferences.each_col() += stretched.col(0);
+      stretchedDifferences.each_row() %= weights.t();
+
+      threadGradient -= 2.0 * stretchedDifferences * differences.t();
+    }
+
+    #pragma omp critical
+    {
+      result += threadResult;
+      if (gradient != NULL)
+        *gradient += threadGradient;
+    }
+  }
+
+  return result;
+}
+
+} // namespace nca
+} // namespace mlpack
+
+#endif
@@ -21,6 +21,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include "ns_autotune.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -77,13 +78,19 @@ PARAM_INT_IN("k", "Number of furthest neighbors to find.", "k", 0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'oct', or 'auto', which chooses the tree type and the leaf "
+    "size by timing the candidates on a sample of the reference set.", "t",
+    "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "vp trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "If true, the model holds the reference set in "
+    "single precision, which halves its memory.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
+PARAM_STRING_IN("autotune_cache", "File of the choices made by '--tree_type "
+    "auto', read and updated so that later runs reuse them.", "", "");
 
 // Search settings.
 PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
@@ -95,6 +102,27 @@ PARAM_DOUBLE_IN("percentage", "If specified, will do approximate furthest "
     "neighbors will be at least (p*100) % of the distance as the true furthest "
     "neighbor.", "p", 1);
 
+// Choose the tree type and the leaf size of the model by autotuning, with the
+// cache file if one is given.
+template<typename MatType>
+void AutotuneTree(KFNModel& model,
+                  const MatType& referenceSet,
+                  const NeighborSearchMode searchMode,
+                  const double epsilon)
+{
+  const string cacheFile = CLI::GetParam<string>("autotune_cache");
+  if (!cacheFile.empty())
+    Autotune::Load(cacheFile);
+
+  Timer::Start("autotuning");
+  SelectTreeType(model, referenceSet, (size_t) CLI::GetParam<int>("k"),
+      searchMode, epsilon);
+  Timer::Stop("autotuning");
+
+  if (!cacheFile.empty())
+    Autotune::Save(cacheFile);
+}
+
 static void mlpackMain()
 {
   if (CLI::GetParam<int>("seed") != 0)
@@ -107,6 +135,7 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "single_precision");
 
   // Notify the user of parameters that will be only be considered for query
   // tree.
@@ -180,7 +209,7 @@ static void mlpackMain()
     // Get all the parameters.
     RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star",
         "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "vp", "rp", "max-rp",
-        "ub", "oct" }, true, "unknown tree type");
+        "ub", "oct", "auto" }, true, "unknown tree type");
     const string treeType = CLI::GetParam<string>("tree_type");
     const bool randomBasis = CLI::HasParam("random_basis");
 
@@ -214,8 +243,14 @@ static void mlpackMain()
     else if (treeType == "oct")
       tree = KFNModel::OCTREE;
 
+    if (treeType == "auto")
+      ReportIgnoredParam("leaf_size", "it is chosen by autotuning");
+    else
+      ReportIgnoredParam("autotune_cache", "the tree type is not 'auto'");
+
     kfn->TreeType() = tree;
     kfn->RandomBasis() = randomBasis;
+    kfn->LeafSize() = size_t(lsInt);
 
     arma::mat referenceSet = std::move(CLI::GetParam<arma::mat>("reference"));
 
@@ -223,8 +258,24 @@ static void mlpackMain()
         << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
         << referenceSet.n_rows << "x" << referenceSet.n_cols << ")." << endl;
 
-    kfn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
-        epsilon);
+    if (CLI::HasParam("single_precision"))
+    {
+      // Release the double precision copy before the tree is built.
+      arma::fmat floatReferenceSet =
+          arma::conv_to<arma::fmat>::from(referenceSet);
+      referenceSet.reset();
+      if (treeType == "auto")
+        AutotuneTree(*kfn, floatReferenceSet, searchMode, epsilon);
+      kfn->BuildModel(std::move(floatReferenceSet), kfn->LeafSize(), searchMode,
+          epsilon);
+    }
+    else
+    {
+      if (treeType == "auto")
+        AutotuneTree(*kfn, referenceSet, searchMode, epsilon);
+      kfn->BuildModel(std::move(referenceSet), kfn->LeafSize(), searchMode,
+          epsilon);
+    }
   }
   else
   {
@@ -243,7 +294,7 @@ static void mlpackMain()
 
     Log::Info << "Using kFN model from '"
         << CLI::GetPrintableParam<KFNModel*>("input_model") << "' (trained on "
-        << kfn->Dataset().n_rows << "x" << kfn->Dataset().n_cols
+        << kfn->Dimensionality() << "x" << kfn->NumPoints()
         << " dataset)." << endl;
   }
 
@@ -264,19 +315,19 @@ static void mlpackMain()
     // Sanity check on k value: must be greater than 0, must be less than or
     // equal to the number of reference points.  Since it is unsigned,
     // we only test the upper bound.
-    if (k > kfn->Dataset().n_cols)
+    if (k > kfn->NumPoints())
     {
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
           << "than or equal to the number of reference points ("
-          << kfn->Dataset().n_cols << ")." << endl;
+          << kfn->NumPoints() << ")." << endl;
     }
 
     // Sanity check on k value: must not be equal to the number of reference
     // points when query data has not been provided.
-    if (!CLI::HasParam("query") && k == kfn->Dataset().n_cols)
+    if (!CLI::HasParam("query") && k == kfn->NumPoints())
     {
       Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
-          << "reference points (" << kfn->Dataset().n_cols << ") "
+          << "reference points (" << kfn->NumPoints() << ") "
           << "if query data has not been provided." << endl;
     }
 
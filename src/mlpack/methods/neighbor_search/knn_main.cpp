@@ -14,6 +14,8 @@
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/flat_tree.hpp>
+#include <mlpack/core/data/transform_stream.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
 
 #include <string>
@@ -23,6 +25,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include "ns_autotune.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -53,7 +56,15 @@ PROGRAM_INFO("k-Nearest-Neighbors Search",
     "neighbors output matrix corresponds to the index of the point in the "
     "reference set which is the j'th nearest neighbor from the point in the "
     "query set with index i.  Row j and column i in the distances output matrix"
-    " corresponds to the distance between those two points.");
+    " corresponds to the distance between those two points."
+    "\n\n"
+    "A query set given as '-' is read from the standard input, and an output "
+    "given as '-' is written to the standard output, as CSV ('-.bin' or "
+    "'-.txt' select another format).  When the query set is read from the "
+    "standard input as text and only one text output is requested (without "
+    "the true neighbors or distances), the queries are searched a batch at a "
+    "time as they arrive, so the program can be piped between other "
+    "programs.");
 
 // Define our input parameters that this program will take.
 PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
@@ -79,7 +90,9 @@ PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'spill', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'spill', 'oct', or 'auto', which chooses the tree type and "
+    "the leaf size by timing the candidates on a sample of the reference set.",
+    "t", "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, vp "
     "trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, spill trees, and octrees).", "l",
@@ -91,7 +104,11 @@ PARAM_DOUBLE_IN("rho", "Balance threshold (only valid for spill trees).", "b",
 
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "If true, the model holds the reference set in "
+    "single precision, which halves its memory.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
+PARAM_STRING_IN("autotune_cache", "File of the choices made by '--tree_type "
+    "auto', read and updated so that later runs reuse them.", "", "");
 
 // Search settings.
 PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
@@ -99,6 +116,78 @@ PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
 
+// Memory-mapped flat trees.
+PARAM_STRING_IN("output_flat_tree", "If specified, the reference tree will be "
+    "saved to this file in a flat layout that can be memory-mapped with "
+    "--input_flat_tree.", "", "");
+PARAM_STRING_IN("input_flat_tree", "Flat tree saved with --output_flat_tree "
+    "to memory-map and search (with single-tree search) instead of a model.",
+    "", "");
+
+// Choose the tree type and the leaf size of the model by autotuning, with the
+// cache file if one is given.
+template<typename MatType>
+void AutotuneTree(KNNModel& model,
+                  const MatType& referenceSet,
+                  const NeighborSearchMode searchMode,
+                  const double epsilon)
+{
+  const string cacheFile = CLI::GetParam<string>("autotune_cache");
+  if (!cacheFile.empty())
+    Autotune::Load(cacheFile);
+
+  Timer::Start("autotuning");
+  SelectTreeType(model, referenceSet, (size_t) CLI::GetParam<int>("k"),
+      searchMode, epsilon);
+  Timer::Stop("autotuning");
+
+  if (!cacheFile.empty())
+    Autotune::Save(cacheFile);
+}
+
+// Search the queries a batch at a time, as they are read from the standard
+// input, writing the requested output as it is computed.
+void SearchQueryStream(KNNModel& model,
+                       const size_t k,
+                       const string& outputFile)
+{
+  const string queryName = CLI::GetPrintableParam<arma::mat>("query");
+  Log::Info << "Searching the queries of '" << queryName << "' a batch at a "
+      << "time." << endl;
+
+  // Check each batch, since the query set is never loaded whole.
+  auto search = [&](const arma::mat& batch,
+                    arma::Mat<size_t>& neighbors,
+                    arma::mat& distances)
+  {
+    if (batch.n_rows != model.Dimensionality())
+    {
+      Log::Fatal << "Query has invalid dimensions (" << batch.n_rows
+          << "); should be " << model.Dimensionality() << "!" << endl;
+    }
+    model.Search(arma::mat(batch), k, neighbors, distances);
+  };
+
+  if (CLI::HasParam("neighbors"))
+  {
+    data::TransformCSVStream<arma::Mat<size_t>>(queryName, outputFile,
+        [&](const arma::mat& batch, arma::Mat<size_t>& neighbors)
+        {
+          arma::mat distances;
+          search(batch, neighbors, distances);
+        });
+  }
+  else
+  {
+    data::TransformCSVStream<arma::mat>(queryName, outputFile,
+        [&](const arma::mat& batch, arma::mat& distances)
+        {
+          arma::Mat<size_t> neighbors;
+          search(batch, neighbors, distances);
+        });
+  }
+}
+
 static void mlpackMain()
 {
   if (CLI::GetParam<int>("seed") != 0)
@@ -106,11 +195,69 @@ static void mlpackMain()
   else
     math::RandomSeed((size_t) std::time(NULL));
 
+  // A flat tree is searched directly; none of the model options apply.
+  if (CLI::HasParam("input_flat_tree"))
+  {
+    RequireOnlyOnePassed({ "input_flat_tree", "reference", "input_model" },
+        true);
+    RequireAtLeastOnePassed({ "k" }, true);
+    RequireAtLeastOnePassed({ "neighbors", "distances" }, false,
+        "nearest neighbor search results will not be saved");
+    for (const string& param : { "tree_type", "leaf_size", "tau", "rho",
+        "random_basis", "single_precision", "algorithm", "epsilon",
+        "true_distances", "true_neighbors", "output_model",
+        "output_flat_tree" })
+      ReportIgnoredParam({{ "input_flat_tree", true }}, param);
+
+    const string filename = CLI::GetParam<string>("input_flat_tree");
+    Timer::Start("load_flat_tree");
+    FlatTree<> flatTree(filename);
+    Timer::Stop("load_flat_tree");
+    Log::Info << "Mapped flat tree from '" << filename << "' ("
+        << flatTree.Dataset().n_rows << "x" << flatTree.Dataset().n_cols
+        << " dataset, " << flatTree.NumNodes() << " nodes)." << endl;
+
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+    if (k == 0 || k > flatTree.Dataset().n_cols ||
+        (!CLI::HasParam("query") && k == flatTree.Dataset().n_cols))
+    {
+      Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
+          << "than the number of reference points ("
+          << flatTree.Dataset().n_cols << "), or equal to it if query data "
+          << "has been provided." << endl;
+    }
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    Timer::Start("computing_neighbors");
+    if (CLI::HasParam("query"))
+    {
+      const arma::mat& queryData = CLI::GetParam<arma::mat>("query");
+      if (queryData.n_rows != flatTree.Dataset().n_rows)
+      {
+        Log::Fatal << "Query has invalid dimensions (" << queryData.n_rows
+            << "); should be " << flatTree.Dataset().n_rows << "!" << endl;
+      }
+      flatTree.Search(queryData, k, neighbors, distances);
+    }
+    else
+    {
+      flatTree.Search(k, neighbors, distances);
+    }
+    Timer::Stop("computing_neighbors");
+    Log::Info << "Search complete." << endl;
+
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    return;
+  }
+
   // A user cannot specify both reference data and a model.
   RequireOnlyOnePassed({ "reference", "input_model" }, true);
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "single_precision");
   ReportIgnoredParam({{ "input_model", true }}, "tau");
   ReportIgnoredParam({{ "input_model", true }}, "rho");
   if (CLI::HasParam("input_model") && CLI::HasParam("leaf_size"))
@@ -193,7 +340,7 @@ static void mlpackMain()
     KNNModel::TreeTypes tree = KNNModel::KD_TREE;
     RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star",
         "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill", "vp", "rp",
-        "max-rp", "ub", "oct" }, true, "unknown tree type");
+        "max-rp", "ub", "oct", "auto" }, true, "unknown tree type");
     if (treeType == "kd")
       tree = KNNModel::KD_TREE;
     else if (treeType == "cover")
@@ -225,6 +372,11 @@ static void mlpackMain()
     else if (treeType == "oct")
       tree = KNNModel::OCTREE;
 
+    if (treeType == "auto")
+      ReportIgnoredParam("leaf_size", "it is chosen by autotuning");
+    else
+      ReportIgnoredParam("autotune_cache", "the tree type is not 'auto'");
+
     knn->TreeType() = tree;
     knn->RandomBasis() = randomBasis;
     knn->LeafSize() = size_t(lsInt);
@@ -238,8 +390,24 @@ static void mlpackMain()
         << referenceSet.n_rows << " x " << referenceSet.n_cols << ")."
         << endl;
 
-    knn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
-        epsilon);
+    if (CLI::HasParam("single_precision"))
+    {
+      // Release the double precision copy before the tree is built.
+      arma::fmat floatReferenceSet =
+          arma::conv_to<arma::fmat>::from(referenceSet);
+      referenceSet.reset();
+      if (treeType == "auto")
+        AutotuneTree(*knn, floatReferenceSet, searchMode, epsilon);
+      knn->BuildModel(std::move(floatReferenceSet), knn->LeafSize(), searchMode,
+          epsilon);
+    }
+    else
+    {
+      if (treeType == "auto")
+        AutotuneTree(*knn, referenceSet, searchMode, epsilon);
+      knn->BuildModel(std::move(referenceSet), knn->LeafSize(), searchMode,
+          epsilon);
+    }
   }
   else
   {
@@ -258,7 +426,7 @@ static void mlpackMain()
 
     Log::Info << "Loaded kNN model from '"
         << CLI::GetPrintableParam<KNNModel*>("input_model") << "' (trained on "
-        << knn->Dataset().n_rows << "x" << knn->Dataset().n_cols
+        << knn->Dimensionality() << "x" << knn->NumPoints()
         << " dataset)." << endl;
   }
 
@@ -267,8 +435,22 @@ static void mlpackMain()
   {
     const size_t k = (size_t) CLI::GetParam<int>("k");
 
+    // Queries from the standard input are searched as they arrive, if only one
+    // output is needed.
+    string streamOutput;
+    if (CLI::HasParam("neighbors") != CLI::HasParam("distances") &&
+        !CLI::HasParam("true_distances") && !CLI::HasParam("true_neighbors"))
+    {
+      streamOutput = CLI::HasParam("neighbors") ?
+          CLI::GetPrintableParam<arma::Mat<size_t>>("neighbors") :
+          CLI::GetPrintableParam<arma::mat>("distances");
+    }
+    const bool streamQueries = CLI::HasParam("query") &&
+        data::CanTransformStream(CLI::GetPrintableParam<arma::mat>("query"),
+        streamOutput);
+
     arma::mat queryData;
-    if (CLI::HasParam("query"))
+    if (CLI::HasParam("query") && !streamQueries)
     {
       queryData = std::move(CLI::GetParam<arma::mat>("query"));
       Log::Info << "Loaded query data from '"
@@ -279,19 +461,19 @@ static void mlpackMain()
     // Sanity check on k value: must be greater than 0, must be less than or
     // equal to the number of reference points.  Since it is unsigned,
     // we only test the upper bound.
-    if (k > knn->Dataset().n_cols)
+    if (k > knn->NumPoints())
     {
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
           << "than or equal to the number of reference points ("
-          << knn->Dataset().n_cols << ")." << endl;
+          << knn->NumPoints() << ")." << endl;
     }
 
     // Sanity check on k value: must not be equal to the number of reference
     // points when query data has not been provided.
-    if (!CLI::HasParam("query") && k == knn->Dataset().n_cols)
+    if (!CLI::HasParam("query") && k == knn->NumPoints())
     {
       Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
-          << "reference points (" << knn->Dataset().n_cols << ") "
+          << "reference points (" << knn->NumPoints() << ") "
           << "if query data has not been provided." << endl;
     }
 
@@ -299,7 +481,9 @@ static void mlpackMain()
     arma::Mat<size_t> neighbors;
     arma::mat distances;
 
-    if (CLI::HasParam("query"))
+    if (streamQueries)
+      SearchQueryStream(*knn, k, streamOutput);
+    else if (CLI::HasParam("query"))
       knn->Search(std::move(queryData), k, neighbors, distances);
     else
       knn->Search(k, neighbors, distances);
@@ -349,5 +533,19 @@ static void mlpackMain()
     }
   }
 
+  // Save the reference tree in the flat layout, if desired.
+  if (CLI::HasParam("output_flat_tree"))
+  {
+    try
+    {
+      knn->SaveFlatTree(CLI::GetParam<string>("output_flat_tree"));
+    }
+    catch (std::invalid_argument& e)
+    {
+      Log::Fatal << "Cannot save " << PRINT_PARAM_STRING("output_flat_tree")
+          << ": " << e.what() << "." << endl;
+    }
+  }
+
   CLI::GetParam<KNNModel*>("output_model") = knn;
 }
@@ -0,0 +1,191 @@
+/**
+ * @file mahalanobis_neighbor_search.hpp
+ *
+ * A specialization of NeighborSearch for the Mahalanobis distance, which
+ * projects the points once and searches with the Euclidean distance.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_MAHALANOBIS_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_MAHALANOBIS_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * NeighborSearch with the Mahalanobis distance.  Each evaluation of the
+ * Mahalanobis distance costs O(d^2), and the distance can't be used with the
+ * bounds of the kd-tree; but with the covariance matrix factorized as Q = L^T L
+ * (see metric::MahalanobisDistance::Transformation()), the distance between
+ * two points is the Euclidean distance between the points multiplied by L.  So
+ * this specialization multiplies the reference points by L once when it is
+ * trained, and each query set when it is searched, and then runs the search
+ * with metric::LMetric<2, TakeRoot> (the squared Euclidean distance if
+ * TakeRoot is false).  The results are the same as with the Mahalanobis
+ * distance, at the cost of the Euclidean distance, and any tree type can be
+ * used:
+ *
+ * @code
+ * // The covariance could be learned by NCA, for instance.
+ * metric::MahalanobisDistance<> distance(covariance);
+ * NeighborSearch<NearestNeighborSort, metric::MahalanobisDistance<>> knn(
+ *     dataset, DUAL_TREE_MODE, 0.0, distance);
+ * knn.Search(querySet, 5, neighbors, distances);
+ * @endcode
+ *
+ * The reference set (ReferenceSet()) and the trees (ReferenceTree(), and the
+ * trees given to Train() and Search()) hold projected points; the overloads
+ * that take points instead of trees project the points themselves.  Apart from
+ * that, this class has the interface of the NeighborSearch class it derives
+ * from.
+ */
+template<typename SortPolicy,
+         bool TakeRoot,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+class NeighborSearch<SortPolicy, metric::MahalanobisDistance<TakeRoot>, MatType,
+    TreeType, DualTreeTraversalType, SingleTreeTraversalType> :
+    public NeighborSearch<SortPolicy, metric::LMetric<2, TakeRoot>, MatType,
+        TreeType, DualTreeTraversalType, SingleTreeTraversalType>
+{
+ public:
+  //! The search on the projected points.
+  typedef NeighborSearch<SortPolicy, metric::LMetric<2, TakeRoot>, MatType,
+      TreeType, DualTreeTraversalType, SingleTreeTraversalType> ProjectedSearch;
+  //! The metric of this search.
+  typedef metric::MahalanobisDistance<TakeRoot> MetricType;
+  //! The type of tree, built on projected points.
+  typedef typename ProjectedSearch::Tree Tree;
+
+  /**
+   * Initialize the NeighborSearch object with the given reference set, which
+   * is projected (and so, copied).
+   *
+   * @param referenceSet Set of reference points.
+   * @param mode Neighbor search mode.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric The Mahalanobis distance to search with.
+   */
+  NeighborSearch(const MatType& referenceSet,
+                 const NeighborSearchMode mode = DUAL_TREE_MODE,
+                 const double epsilon = 0,
+                 const MetricType metric = MetricType());
+
+  /**
+   * Create a NeighborSearch object without any reference data.  If Search() is
+   * called before a reference set is set with Train(), an exception will be
+   * thrown.
+   *
+   * @param mode Neighbor search mode.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric The Mahalanobis distance to search with.
+   */
+  NeighborSearch(const NeighborSearchMode mode = DUAL_TREE_MODE,
+                 const double epsilon = 0,
+                 const MetricType metric = MetricType());
+
+  //! Train on a tree of projected points.
+  using ProjectedSearch::Train;
+
+  /**
+   * Set the reference set to a new reference set, which is projected, and
+   * build a tree if necessary.
+   *
+   * @param referenceSet New set of reference data.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * Set the reference set to a new reference set, which is projected, and
+   * build a tree if necessary.  The given set is only moved from if the
+   * transformation is the identity.
+   *
+   * @param referenceSet New set of reference data.
+   */
+  void Train(MatType&& referenceSet);
+
+  //! Search with a tree of projected points, or for the neighbors of the
+  //! reference points.
+  using ProjectedSearch::Search;
+
+  /**
+   * For each point in the query set, compute the nearest neighbors with the
+   * Mahalanobis distance, as the Search() overload of NeighborSearch does.
+   * Throws std::invalid_argument if the dimensionality of the query points
+   * does not match the covariance matrix.
+   *
+   * @param querySet Set of query points (can be just one point).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * For each point in the query set, compute the nearest neighbors with the
+   * Mahalanobis distance without modifying this object, as the Search()
+   * overload of NeighborSearch that takes a context does.
+   *
+   * @param querySet Set of query points (can be just one point).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param context The state of this search.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              tree::SearchContext& context) const;
+
+  /**
+   * Insert the given points into the reference set, after projecting them.
+   * See the Insert() method of NeighborSearch.
+   *
+   * @param points Points to insert.
+   */
+  void Insert(const MatType& points);
+
+  //! Get the Mahalanobis distance of this search.
+  const MetricType& Metric() const { return metric; }
+
+  //! Get the matrix that the points are multiplied by (empty for the
+  //! identity).
+  const MatType& Transformation() const { return transformation; }
+
+  //! Serialize the NeighborSearch model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! Return the given points multiplied by the transformation.
+  MatType Project(const MatType& points) const;
+
+  //! The Mahalanobis distance.
+  MetricType metric;
+  //! The transformation of the points.
+  MatType transformation;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "mahalanobis_neighbor_search_impl.hpp"
+
+#endif
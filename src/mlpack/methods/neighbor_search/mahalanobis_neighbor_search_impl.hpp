@@ -0,0 +1,196 @@
+/**
+ * @file mahalanobis_neighbor_search_impl.hpp
+ *
+ * Implementation of the specialization of NeighborSearch for the Mahalanobis
+ * distance.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_MAHALANOBIS_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_MAHALANOBIS_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mahalanobis_neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy,
+         bool TakeRoot,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+NeighborSearch<SortPolicy, metric::MahalanobisDistance<TakeRoot>, MatType,
+TreeType, DualTreeTraversalType, SingleTreeTraversalType>::NeighborSearch(
+    const MatType& referenceSet,
+    const NeighborSearchMode mode,
+    const double epsilon,
+    const MetricType metric) :
+    ProjectedSearch(mode, epsilon),
+    metric(metric),
+    transformation(arma::conv_to<MatType>::from(metric.Transformation()))
+{
+  Train(referenceSet);
+}
+
+template<typename SortPolicy,
+         bool TakeRoot,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+NeighborSearch<SortPolicy, metric::MahalanobisDistance<TakeRoot>, MatType,
+TreeType, DualTreeTraversalType, SingleTreeTraversalType>::NeighborSearch(
+    const NeighborSearchMode mode,
+    const double epsilon,
+    const MetricType metric) :
+    ProjectedSearch(mode, epsilon),
+    metric(metric),
+    transformation(arma::conv_to<MatType>::from(metric.Transformation()))
+{ /* Nothing to do. */ }
+
+template<typename SortPolicy,
+         bool TakeRoot,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, metric::MahalanobisDistance<TakeRoot>, MatType,
+TreeType, DualTreeTraversalType, SingleTreeTraversalType>::Train(
+    const MatType& referenceSet)
+{
+  ProjectedSearch::Train(Project(referenceSet));
+}
+
+template<typename SortPolicy,
+         bool TakeRoot,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, metric::MahalanobisDistance<TakeRoot>, MatType,
+TreeType, DualTreeTraversalType, SingleTreeTraversalType>::Train(
+    MatType&& referenceSet)
+{
+  // Without a transformation, the points are used as they are.
+  if (transformation.n_elem == 0)
+    ProjectedSearch::Train(std::move(referenceSet));
+  else
+    ProjectedSearch::Train(Project(referenceSet));
+}
+
+template<typename SortPolicy,
+         bool TakeRoot,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, metric::MahalanobisDistance<TakeRoot>, MatType,
+TreeType, DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  ProjectedSearch::Search(Project(querySet), k, neighbors, distances);
+}
+
+template<typename SortPolicy,
+         bool TakeRoot,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, metric::MahalanobisDistance<TakeRoot>, MatType,
+TreeType, DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    tree::SearchContext& context) const
+{
+  ProjectedSearch::Search(Project(querySet), k, neighbors, distances, context);
+}
+
+template<typename SortPolicy,
+         bool TakeRoot,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, metric::MahalanobisDistance<TakeRoot>, MatType,
+TreeType, DualTreeTraversalType, SingleTreeTraversalType>::Insert(
+    const MatType& points)
+{
+  ProjectedSearch::Insert(Project(points));
+}
+
+template<typename SortPolicy,
+         bool TakeRoot,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename Archive>
+void NeighborSearch<SortPolicy, metric::MahalanobisDistance<TakeRoot>, MatType,
+TreeType, DualTreeTraversalType, SingleTreeTraversalType>::serialize(
+    Archive& ar,
+    const unsigned int version)
+{
+  ProjectedSearch::serialize(ar, version);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(transformation);
+}
+
+template<typename SortPolicy,
+         bool TakeRoot,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+MatType NeighborSearch<SortPolicy, metric::MahalanobisDistance<TakeRoot>,
+MatType, TreeType, DualTreeTraversalType, SingleTreeTraversalType>::Project(
+    const MatType& points) const
+{
+  // Without a covariance matrix, the distance is the Euclidean distance.
+  if (transformation.n_elem == 0)
+    return points;
+
+  if (points.n_rows != transformation.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NeighborSearch::Project(): the points have " << points.n_rows
+        << " dimensions, but the covariance matrix of the Mahalanobis distance "
+        << "has " << transformation.n_cols;
+    throw std::invalid_argument(oss.str());
+  }
+
+  return transformation * points;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
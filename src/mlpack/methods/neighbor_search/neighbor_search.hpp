@@ -20,6 +20,11 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/binary_space_tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/is_dynamic_tree.hpp>
+#include <mlpack/core/tree/search_context.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/mahalanobis_distance.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 #include "neighbor_search_stat.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
@@ -43,6 +48,26 @@ enum NeighborSearchMode
   GREEDY_SINGLE_TREE_MODE
 };
 
+/**
+ * The metric that the trees of a NeighborSearch object are built with, given
+ * its MetricType.  This is MetricType itself, except for the Mahalanobis
+ * distance: NeighborSearch projects the points so that it can search with the
+ * Euclidean distance instead (see mahalanobis_neighbor_search.hpp).
+ */
+template<typename MetricType>
+struct NeighborSearchTreeMetric
+{
+  typedef MetricType Type;
+};
+
+//! The Mahalanobis distance is the (squared, if TakeRoot is false) Euclidean
+//! distance between the projected points.
+template<bool TakeRoot>
+struct NeighborSearchTreeMetric<metric::MahalanobisDistance<TakeRoot>>
+{
+  typedef metric::LMetric<2, TakeRoot> Type;
+};
+
 /**
  * The NeighborSearch class is a template class for performing distance-based
  * neighbor searches.  It takes a query dataset and a reference dataset (or just
@@ -73,11 +98,11 @@ template<typename SortPolicy = NearestNeighborSort,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType = tree::KDTree,
          template<typename RuleType> class DualTreeTraversalType =
-             TreeType<MetricType,
+             TreeType<typename NeighborSearchTreeMetric<MetricType>::Type,
                       NeighborSearchStat<SortPolicy>,
                       MatType>::template DualTreeTraverser,
          template<typename RuleType> class SingleTreeTraversalType =
-             TreeType<MetricType,
+             TreeType<typename NeighborSearchTreeMetric<MetricType>::Type,
                       NeighborSearchStat<SortPolicy>,
                       MatType>::template SingleTreeTraverser>
 class NeighborSearch
@@ -299,6 +324,36 @@ class NeighborSearch
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * For each point in the query set, compute the nearest neighbors, like the
+   * Search() overload above, but without modifying this object: the number of
+   * base cases and scores are stored in the given context instead.  Any number
+   * of threads may call this at the same time on the same object, each with
+   * its own context, as long as the object is not modified meanwhile.
+   *
+   * If the context has a budget (see tree::SearchContext::MaxLeaves() and
+   * tree::SearchContext::Deadline()), the search is a best-first single-tree
+   * search in any mode but the naive one: each query visits the leaves of the
+   * reference tree in order of their distance, and stops when the budget is
+   * spent with the best neighbors found so far (at least one leaf is visited,
+   * but fewer than k neighbors may be found, in which case the remaining ones
+   * are SIZE_MAX with the worst distance).  The context then tells which
+   * queries are exact.  Searches with a budget are not supported by the cover
+   * tree.
+   *
+   * @param querySet Set of query points (can be just one point).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param context The state of this search.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              tree::SearchContext& context) const;
+
   /**
    * Given a pre-built query tree, search for the nearest neighbors of each
    * point in the query tree, storing the output in the given matrices.  The
@@ -334,6 +389,10 @@ class NeighborSearch
    * where n is the number of points in the query dataset and k is the number of
    * neighbors being searched for.
    *
+   * If points have been inserted or deleted, the matrices have one column for
+   * each index given to a point (see Insert()), and the columns of deleted
+   * points are filled with SIZE_MAX and SortPolicy::WorstDistance().
+   *
    * @param k Number of neighbors to search for.
    * @param neighbors Matrix storing lists of neighbors for each query point.
    * @param distances Matrix storing distances of neighbors for each query
@@ -343,6 +402,73 @@ class NeighborSearch
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Search for the nearest neighbors of every point in the reference set, like
+   * the Search() overload above, but without modifying this object, so that
+   * several threads can search at the same time; see the Search() overload
+   * that takes a query set and a context.  In dual-tree mode this searches
+   * with a copy of the reference tree as the query tree.  The context may hold
+   * a budget, as for that overload.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *      point.
+   * @param context The state of this search.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              tree::SearchContext& context) const;
+
+  /**
+   * Insert the given points into the reference set.  Each point is given the
+   * next unused index: the first point inserted into a reference set of n
+   * points has index n, and indices are never reused, even after points are
+   * deleted.  The results of Search() refer to points by these indices.
+   *
+   * If the tree type supports insertion (the R tree and its variants), the
+   * points are inserted into the tree.  Otherwise they are kept in a buffer
+   * that is searched by brute force, and the tree is rebuilt once the buffer
+   * and the deleted points make up more than RebuildFraction() of the
+   * reference set.
+   *
+   * @param points Points to insert.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * Delete the point with the given index from the reference set.  Deleted
+   * points are never returned by Search().  Trees that support deletion remove
+   * the point; other trees keep it until they are rebuilt, and Search() skips
+   * it.
+   *
+   * @param index Index of the point to delete.
+   * @return Whether a point with the given index was deleted; false if there
+   *     is no such point.
+   */
+  bool Delete(const size_t index);
+
+  /**
+   * Rebuild the reference tree on the current reference set: with the
+   * inserted points and without the deleted points.  The indices of the points
+   * do not change.  The tree is built with its default parameters (such as the
+   * leaf size).  Insert() and Delete() call this automatically; this only needs
+   * to be called to rebuild the tree earlier.
+   */
+  void Rebuild();
+
+  //! Return the number of points in the reference set, after insertions and
+  //! deletions.
+  size_t NumReferencePoints() const;
+
+  //! Get the fraction of the reference set that the inserted and deleted
+  //! points can make up before the tree is rebuilt.
+  double RebuildFraction() const { return rebuildFraction; }
+  //! Modify the fraction of the reference set that the inserted and deleted
+  //! points can make up before the tree is rebuilt.
+  double& RebuildFraction() { return rebuildFraction; }
+
   /**
    * Calculate the average relative error (effective error) between the
    * distances calculated and the true distances provided.  The input matrices
@@ -392,7 +518,8 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
-  //! Access the reference dataset.
+  //! Access the reference dataset.  This does not contain the points in the
+  //! insertion buffer, and may still contain deleted points; see Insert().
   const MatType& ReferenceSet() const { return *referenceSet; }
 
   //! Access the reference tree.
@@ -400,9 +527,14 @@ class NeighborSearch
   //! Modify the reference tree.
   Tree& ReferenceTree() { return *referenceTree; }
 
+  //! Access the original index of each point of the reference tree's dataset;
+  //! this is empty if the tree does not rearrange the dataset.
+  const std::vector<size_t>& OldFromNewReferences() const
+  { return oldFromNewReferences; }
+
   //! Serialize the NeighborSearch model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   //! Permutations of reference points during tree building.
@@ -434,6 +566,127 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! Points inserted since the tree was built, which are searched by brute
+  //! force.
+  MatType insertedSet;
+  //! The index of each point in insertedSet.
+  std::vector<size_t> insertedIds;
+  //! The index of each point of the reference set (in its original order);
+  //! this is empty if the indices are the columns of the reference set.
+  std::vector<size_t> referenceIds;
+  //! Whether the point with each index has been deleted; this is empty if no
+  //! point has been deleted.
+  std::vector<bool> deleted;
+  //! The number of deleted points that are still in the reference tree.
+  size_t deletedInSet;
+  //! The index that the next inserted point is given.
+  size_t nextId;
+  //! The fraction of the reference set that the inserted and deleted points can
+  //! make up before the tree is rebuilt.
+  double rebuildFraction;
+
+  /**
+   * Search for the neighbors of the query points with the reference tree only,
+   * ignoring insertions and deletions.
+   */
+  void TreeSearch(const MatType& querySet,
+                  const size_t k,
+                  arma::Mat<size_t>& neighbors,
+                  arma::mat& distances,
+                  tree::SearchContext& context) const;
+
+  /**
+   * Search for the neighbors of the points of the reference tree with the
+   * reference tree only, ignoring insertions and deletions.  Dual-tree search
+   * uses the given query tree, which must be the reference tree or a copy of
+   * it, with reset statistics.
+   */
+  void TreeSearch(const size_t k,
+                  arma::Mat<size_t>& neighbors,
+                  arma::mat& distances,
+                  tree::SearchContext& context,
+                  Tree& queryTree) const;
+
+  /**
+   * Return the mode of a search with the given context: a search with a
+   * budget is a best-first single-tree search in every mode but the naive one.
+   * Throws for trees with self-children (the cover tree), whose nodes share
+   * their points with their children.
+   */
+  NeighborSearchMode BudgetedMode(tree::SearchContext& context) const;
+
+  /**
+   * Search for the neighbors of each query point with the best-first
+   * single-tree traverser, within the budget of the given context, and set
+   * which queries are exact in the context.
+   */
+  void BudgetedSearch(NeighborSearchRules<SortPolicy, MetricType, Tree>& rules,
+                      const size_t numQueries,
+                      tree::SearchContext& context) const;
+
+  //! Search for the neighbors of the query points, taking the inserted and
+  //! deleted points into account.
+  void UpdatedSearch(const MatType& querySet,
+                     const size_t k,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances,
+                     tree::SearchContext& context) const;
+
+  //! Search for the neighbors of every point of the reference set, taking the
+  //! inserted and deleted points into account.
+  void UpdatedSearch(const size_t k,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances,
+                     tree::SearchContext& context) const;
+
+  //! Reset the statistics of every node of the given tree.
+  static void ResetStatistics(Tree& node);
+
+  //! Return whether points have been inserted or deleted, so that the indices
+  //! of the points are not the columns of the reference set.
+  bool HasUpdates() const
+  { return !insertedIds.empty() || !referenceIds.empty() || !deleted.empty(); }
+
+  //! Return whether the point with the given index has been deleted.
+  bool IsDeleted(const size_t index) const
+  { return index < deleted.size() && deleted[index]; }
+
+  //! Return the index of the given column of the reference tree's dataset.
+  size_t ColumnIndex(const size_t column) const;
+
+  //! Collect the points of the reference set that are not deleted, ordered by
+  //! index, together with their indices.
+  void LivePoints(MatType& points, std::vector<size_t>& indices) const;
+
+  //! Forget all insertions and deletions, for a new reference set.
+  void ClearUpdates();
+
+  //! Rebuild the tree if the inserted and deleted points make up too much of
+  //! the reference set.
+  void CheckRebuild();
+
+  //! Insert the given points into the reference tree, if the tree supports
+  //! insertion; return whether it does.
+  template<typename T = Tree>
+  typename std::enable_if<tree::IsDynamicTree<T>::value, bool>::type
+  InsertIntoTree(const MatType& points);
+
+  //! Trees that do not support insertion keep the points in a buffer.
+  template<typename T = Tree>
+  typename std::enable_if<!tree::IsDynamicTree<T>::value, bool>::type
+  InsertIntoTree(const MatType& /* points */) { return false; }
+
+  //! Delete the given column of the dataset from the reference tree, if the
+  //! tree supports deletion; return whether it does.
+  template<typename T = Tree>
+  typename std::enable_if<tree::IsDynamicTree<T>::value, bool>::type
+  DeleteFromTree(const size_t column);
+
+  //! Trees that do not support deletion keep the point until they are rebuilt.
+  template<typename T = Tree>
+  typename std::enable_if<!tree::IsDynamicTree<T>::value, bool>::type
+  DeleteFromTree(const size_t /* column */) { return false; }
+
   //! The NSModel class should have access to internal members.
   template<typename SortPol>
   friend class TrainVisitor;
@@ -442,9 +695,25 @@ class NeighborSearch
 } // namespace neighbor
 } // namespace mlpack
 
+//! Set the serialization version of the NeighborSearch class.
+BOOST_TEMPLATE_CLASS_VERSION(SINGLE_ARG(template<
+    typename SortPolicy,
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType,
+    template<typename> class DualTreeTraversalType,
+    template<typename> class SingleTreeTraversalType>),
+    SINGLE_ARG(mlpack::neighbor::NeighborSearch<SortPolicy, MetricType, MatType,
+    TreeType, DualTreeTraversalType, SingleTreeTraversalType>), 1);
+
 // Include implementation.
 #include "neighbor_search_impl.hpp"
 
+// Include the specialization for the Mahalanobis distance.
+#include "mahalanobis_neighbor_search.hpp"
+
 // Include convenience typedefs.
 #include "typedef.hpp"
 
@@ -14,7 +14,9 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/best_first_single_tree_traverser.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
@@ -70,7 +72,10 @@ SingleTreeTraversalType>::NeighborSearch(const MatType& referenceSetIn,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    deletedInSet(0),
+    nextId(0),
+    rebuildFraction(0.1)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -101,7 +106,10 @@ SingleTreeTraversalType>::NeighborSearch(MatType&& referenceSetIn,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    deletedInSet(0),
+    nextId(0),
+    rebuildFraction(0.1)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -130,7 +138,10 @@ SingleTreeTraversalType>::NeighborSearch(const Tree& referenceTree,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    deletedInSet(0),
+    nextId(0),
+    rebuildFraction(0.1)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -159,7 +170,10 @@ SingleTreeTraversalType>::NeighborSearch(Tree&& referenceTree,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    deletedInSet(0),
+    nextId(0),
+    rebuildFraction(0.1)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -187,7 +201,10 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     metric(metric),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    deletedInSet(0),
+    nextId(0),
+    rebuildFraction(0.1)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -222,7 +239,14 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    insertedSet(other.insertedSet),
+    insertedIds(other.insertedIds),
+    referenceIds(other.referenceIds),
+    deleted(other.deleted),
+    deletedInSet(other.deletedInSet),
+    nextId(other.nextId),
+    rebuildFraction(other.rebuildFraction)
 {
   // Nothing else to do.
 }
@@ -248,7 +272,14 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    treeNeedsReset(other.treeNeedsReset),
+    insertedSet(std::move(other.insertedSet)),
+    insertedIds(std::move(other.insertedIds)),
+    referenceIds(std::move(other.referenceIds)),
+    deleted(std::move(other.deleted)),
+    deletedInSet(other.deletedInSet),
+    nextId(other.nextId),
+    rebuildFraction(other.rebuildFraction)
 {
   // Clear the other model.
   other.referenceSet = new MatType();
@@ -261,6 +292,7 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+  other.ClearUpdates();
 }
 
 // Copy operator.
@@ -306,6 +338,13 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = false;
+  insertedSet = other.insertedSet;
+  insertedIds = other.insertedIds;
+  referenceIds = other.referenceIds;
+  deleted = other.deleted;
+  deletedInSet = other.deletedInSet;
+  nextId = other.nextId;
+  rebuildFraction = other.rebuildFraction;
 }
 
 // Move operator.
@@ -350,6 +389,13 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = other.treeNeedsReset;
+  insertedSet = std::move(other.insertedSet);
+  insertedIds = std::move(other.insertedIds);
+  referenceIds = std::move(other.referenceIds);
+  deleted = std::move(other.deleted);
+  deletedInSet = other.deletedInSet;
+  nextId = other.nextId;
+  rebuildFraction = other.rebuildFraction;
 
   // Reset the other object.
   other.referenceSet = new MatType();
@@ -362,6 +408,7 @@ NeighborSearch<SortPolicy,
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+  other.ClearUpdates();
 }
 
 // Clean memory.
@@ -419,6 +466,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(
   }
 
   setOwner = false; // We don't own the set in either case.
+  ClearUpdates();
 }
 
 template<typename SortPolicy,
@@ -458,6 +506,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType&& referenceSetIn)
     referenceSet = new MatType(std::move(referenceSetIn));
     setOwner = true;
   }
+
+  ClearUpdates();
 }
 
 template<typename SortPolicy,
@@ -489,6 +539,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(
   this->referenceSet = &this->referenceTree->Dataset();
   treeOwner = true;
   setOwner = false;
+  ClearUpdates();
 }
 
 template<typename SortPolicy,
@@ -519,6 +570,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree&& referenceTree)
   this->referenceSet = &this->referenceTree->Dataset();
   treeOwner = true;
   setOwner = false;
+  ClearUpdates();
 }
 
 /**
@@ -534,11 +586,12 @@ template<typename SortPolicy,
          template<typename> class DualTreeTraversalType,
          template<typename> class SingleTreeTraversalType>
 void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
-DualTreeTraversalType, SingleTreeTraversalType>::Search(
+DualTreeTraversalType, SingleTreeTraversalType>::TreeSearch(
     const MatType& querySet,
     const size_t k,
     arma::Mat<size_t>& neighbors,
-    arma::mat& distances)
+    arma::mat& distances,
+    tree::SearchContext& context) const
 {
   if (k > referenceSet->n_cols)
   {
@@ -548,11 +601,21 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     throw std::invalid_argument(ss.str());
   }
 
+  // A search with a budget is a best-first single-tree search, whatever the
+  // search mode (unless it is naive, which is always exact).
+  const NeighborSearchMode mode = BudgetedMode(context);
+
+  MLPACK_PROFILE_SCOPE("neighbor_search/search");
   Timer::Start("computing_neighbors");
 
+  size_t& baseCases = context.BaseCases();
+  size_t& scores = context.Scores();
   baseCases = 0;
   scores = 0;
 
+  // The rules may modify the metric, so they get their own copy.
+  MetricType metric(this->metric);
+
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
 
@@ -566,7 +629,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   // Mapping is only necessary if the tree rearranges points.
   if (tree::TreeTraits<Tree>::RearrangesDataset)
   {
-    if (searchMode == DUAL_TREE_MODE)
+    if (mode == DUAL_TREE_MODE)
     {
       distancePtr = new arma::mat; // Query indices need to be mapped.
       neighborPtr = new arma::Mat<size_t>;
@@ -581,17 +644,24 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
 
-  switch (searchMode)
+  switch (mode)
   {
     case NAIVE_MODE:
     {
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
-      // The naive brute-force traversal.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
+      // The naive brute-force traversal.  Every thread uses its own copy of
+      // the rules, which shares the candidate lists.
+      #pragma omp parallel
+      {
+        RuleType threadRules(rules, tree::SharedResults());
+
+        #pragma omp for schedule(static)
+        for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+          for (size_t j = 0; j < referenceSet->n_cols; ++j)
+            threadRules.BaseCase(i, j);
+      }
 
       baseCases += querySet.n_cols * referenceSet->n_cols;
 
@@ -602,21 +672,33 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     {
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
+      if (context.Budgeted())
+      {
+        BudgetedSearch(rules, querySet.n_cols, context);
+        rules.GetResults(*neighborPtr, *distancePtr);
+        break;
+      }
 
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
+      // The queries are split across the threads; every thread uses its own
+      // copy of the rules, which shares the candidate lists.
+      size_t threadScores = 0, threadBaseCases = 0;
+      #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+      {
+        RuleType threadRules(rules, tree::SharedResults());
+        SingleTreeTraversalType<RuleType> traverser(threadRules);
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+          traverser.Traverse(i, *referenceTree);
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+        MLPACK_PROFILE_COUNT("neighbor_search/prunes", traverser.NumPrunes());
+        threadScores += threadRules.Scores();
+        threadBaseCases += threadRules.BaseCases();
+      }
+
+      scores += threadScores;
+      baseCases += threadBaseCases;
 
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
 
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
@@ -626,25 +708,28 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Build the query tree.
       Timer::Stop("computing_neighbors");
       Timer::Start("tree_building");
-      Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+      Tree* queryTree;
+      {
+        MLPACK_PROFILE_SCOPE("neighbor_search/tree_building");
+        queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+      }
       Timer::Stop("tree_building");
       Timer::Start("computing_neighbors");
 
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
-      traverser.Traverse(*queryTree, *referenceTree);
+      size_t numPrunes;
+      {
+        MLPACK_PROFILE_SCOPE("neighbor_search/traversal");
+        numPrunes = tree::TraverseWithStatistics<DualTreeTraversalType>(rules,
+            *queryTree, *referenceTree, "neighbor search");
+      }
+      MLPACK_PROFILE_COUNT("neighbor_search/prunes", numPrunes);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
 
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
 
       rules.GetResults(*neighborPtr, *distancePtr);
 
@@ -656,23 +741,29 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric);
 
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
+      // The queries are split across the threads; every thread uses its own
+      // copy of the rules, which shares the candidate lists.
+      size_t threadScores = 0, threadBaseCases = 0;
+      #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+      {
+        RuleType threadRules(rules, tree::SharedResults());
+        tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(threadRules);
 
-      // Set the value of minBaseCases.
-      traverser.MinBaseCases() = k;
+        // Set the value of minBaseCases.
+        traverser.MinBaseCases() = k;
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+          traverser.Traverse(i, *referenceTree);
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+        MLPACK_PROFILE_COUNT("neighbor_search/prunes", traverser.NumPrunes());
+        threadScores += threadRules.Scores();
+        threadBaseCases += threadRules.BaseCases();
+      }
+
+      scores += threadScores;
+      baseCases += threadBaseCases;
 
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
 
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
@@ -680,11 +771,13 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 
   Timer::Stop("computing_neighbors");
+  MLPACK_PROFILE_COUNT("neighbor_search/base_cases", baseCases);
+  MLPACK_PROFILE_COUNT("neighbor_search/scores", scores);
 
   // Map points back to original indices, if necessary.
   if (tree::TreeTraits<Tree>::RearrangesDataset)
   {
-    if (searchMode == DUAL_TREE_MODE && !oldFromNewReferences.empty())
+    if (mode == DUAL_TREE_MODE && !oldFromNewReferences.empty())
     {
       // We must map both query and reference indices.
       neighbors.set_size(k, querySet.n_cols);
@@ -707,7 +800,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       delete neighborPtr;
       delete distancePtr;
     }
-    else if (searchMode == DUAL_TREE_MODE)
+    else if (mode == DUAL_TREE_MODE)
     {
       // We must map query indices only.
       neighbors.set_size(k, querySet.n_cols);
@@ -757,6 +850,18 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::mat& distances,
     bool sameSet)
 {
+  // The query tree is searched against the reference tree only, so the tree
+  // must be rebuilt if there are points in the buffer or deleted points in the
+  // tree.
+  if (!insertedIds.empty() || deletedInSet > 0)
+  {
+    if (&queryTree == referenceTree)
+      throw std::invalid_argument("cannot search with the reference tree as "
+          "the query tree after points were inserted or deleted; call "
+          "Rebuild() first");
+    Rebuild();
+  }
+
   if (k > referenceSet->n_cols)
   {
     std::stringstream ss;
@@ -824,6 +929,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     // Finished with temporary matrix.
     delete neighborPtr;
   }
+
+  // Map the reference indices to the indices of the points, if they differ.
+  if (!referenceIds.empty())
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+      neighbors[i] = referenceIds[neighbors[i]];
 }
 
 template<typename SortPolicy,
@@ -835,10 +945,12 @@ template<typename SortPolicy,
          template<typename> class DualTreeTraversalType,
          template<typename> class SingleTreeTraversalType>
 void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
-DualTreeTraversalType, SingleTreeTraversalType>::Search(
+DualTreeTraversalType, SingleTreeTraversalType>::TreeSearch(
     const size_t k,
     arma::Mat<size_t>& neighbors,
-    arma::mat& distances)
+    arma::mat& distances,
+    tree::SearchContext& context,
+    Tree& queryTree) const
 {
   if (k > referenceSet->n_cols)
   {
@@ -856,11 +968,19 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     throw std::invalid_argument(ss.str());
   }
 
+  const NeighborSearchMode mode = BudgetedMode(context);
+
+  MLPACK_PROFILE_SCOPE("neighbor_search/search");
   Timer::Start("computing_neighbors");
 
+  size_t& baseCases = context.BaseCases();
+  size_t& scores = context.Scores();
   baseCases = 0;
   scores = 0;
 
+  // The rules may modify the metric, so they get their own copy.
+  MetricType metric(this->metric);
+
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
 
@@ -881,106 +1001,104 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
       true /* don't return the same point as nearest neighbor */);
 
-  switch (searchMode)
+  switch (mode)
   {
     case NAIVE_MODE:
     {
-      // The naive brute-force solution.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        for (size_t j = 0; j < referenceSet->n_cols; ++j)
-          rules.BaseCase(i, j);
+      // The naive brute-force solution.  Every thread uses its own copy of
+      // the rules, which shares the candidate lists.
+      #pragma omp parallel
+      {
+        RuleType threadRules(rules, tree::SharedResults());
+
+        #pragma omp for schedule(static)
+        for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+          for (size_t j = 0; j < referenceSet->n_cols; ++j)
+            threadRules.BaseCase(i, j);
+      }
 
       baseCases += referenceSet->n_cols * referenceSet->n_cols;
       break;
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      if (context.Budgeted())
+      {
+        BudgetedSearch(rules, referenceSet->n_cols, context);
+        break;
+      }
 
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-      break;
-    }
-    case DUAL_TREE_MODE:
-    {
-      // The dual-tree monochromatic search case may require resetting the
-      // bounds in the tree.
-      if (treeNeedsReset)
+      // The queries are split across the threads; every thread uses its own
+      // copy of the rules, which shares the candidate lists.
+      size_t threadScores = 0, threadBaseCases = 0;
+      #pragma omp parallel reduction(+:threadScores, threadBaseCases)
       {
-        std::stack<Tree*> nodes;
-        nodes.push(referenceTree);
-        while (!nodes.empty())
-        {
-          Tree* node = nodes.top();
-          nodes.pop();
+        RuleType threadRules(rules, tree::SharedResults());
+        SingleTreeTraversalType<RuleType> traverser(threadRules);
 
-          // Reset bounds of this node.
-          node->Stat().Reset();
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+          traverser.Traverse(i, *referenceTree);
 
-          // Then add the children.
-          for (size_t i = 0; i < node->NumChildren(); ++i)
-            nodes.push(&node->Child(i));
-        }
+        MLPACK_PROFILE_COUNT("neighbor_search/prunes", traverser.NumPrunes());
+        threadScores += threadRules.Scores();
+        threadBaseCases += threadRules.BaseCases();
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
+      scores += threadScores;
+      baseCases += threadBaseCases;
 
+      break;
+    }
+    case DUAL_TREE_MODE:
+    {
+      size_t numPrunes;
       if (tree::IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
         // non overlapping (tau = 0).
-        Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        Tree spillQueryTree(*referenceSet);
+        MLPACK_PROFILE_SCOPE("neighbor_search/traversal");
+        numPrunes = tree::TraverseWithStatistics<DualTreeTraversalType>(rules,
+            spillQueryTree, *referenceTree, "neighbor search");
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
-        // Next time we perform this search, we'll need to reset the tree.
-        treeNeedsReset = true;
+        MLPACK_PROFILE_SCOPE("neighbor_search/traversal");
+        numPrunes = tree::TraverseWithStatistics<DualTreeTraversalType>(rules,
+            queryTree, *referenceTree, "neighbor search");
       }
+      MLPACK_PROFILE_COUNT("neighbor_search/prunes", numPrunes);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
-      // Next time we perform this search, we'll need to reset the tree.
-      treeNeedsReset = true;
       break;
     }
     case GREEDY_SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
+      // The queries are split across the threads; every thread uses its own
+      // copy of the rules, which shares the candidate lists.
+      size_t threadScores = 0, threadBaseCases = 0;
+      #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+      {
+        RuleType threadRules(rules, tree::SharedResults());
+        tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(threadRules);
 
-      // Set the value of minBaseCases.
-      traverser.MinBaseCases() = k;
+        // Set the value of minBaseCases.
+        traverser.MinBaseCases() = k;
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+          traverser.Traverse(i, *referenceTree);
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+        MLPACK_PROFILE_COUNT("neighbor_search/prunes", traverser.NumPrunes());
+        threadScores += threadRules.Scores();
+        threadBaseCases += threadRules.BaseCases();
+      }
+
+      scores += threadScores;
+      baseCases += threadBaseCases;
 
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
       break;
     }
   }
@@ -988,6 +1106,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   rules.GetResults(*neighborPtr, *distancePtr);
 
   Timer::Stop("computing_neighbors");
+  MLPACK_PROFILE_COUNT("neighbor_search/base_cases", baseCases);
+  MLPACK_PROFILE_COUNT("neighbor_search/scores", scores);
 
   // Do we need to map the reference indices?
   if (!oldFromNewReferences.empty() &&
@@ -1013,6 +1133,657 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  tree::SearchContext context;
+  Search(querySet, k, neighbors, distances, context);
+
+  baseCases = context.BaseCases();
+  scores = context.Scores();
+  if (searchMode != NAIVE_MODE)
+  {
+    Log::Info << scores << " node combinations were scored." << std::endl;
+    Log::Info << baseCases << " base cases were calculated." << std::endl;
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    tree::SearchContext& context) const
+{
+  if (HasUpdates())
+    UpdatedSearch(querySet, k, neighbors, distances, context);
+  else
+    TreeSearch(querySet, k, neighbors, distances, context);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  tree::SearchContext context;
+  if (HasUpdates())
+  {
+    UpdatedSearch(k, neighbors, distances, context);
+  }
+  else
+  {
+    // The dual-tree search uses the reference tree as the query tree, so the
+    // bounds in the tree must be reset if it was searched before.
+    if (searchMode == DUAL_TREE_MODE && !tree::IsSpillTree<Tree>::value)
+    {
+      if (treeNeedsReset)
+        ResetStatistics(*referenceTree);
+      treeNeedsReset = true;
+    }
+
+    TreeSearch(k, neighbors, distances, context, *referenceTree);
+  }
+
+  baseCases = context.BaseCases();
+  scores = context.Scores();
+  if (searchMode != NAIVE_MODE)
+  {
+    Log::Info << scores << " node combinations were scored." << std::endl;
+    Log::Info << baseCases << " base cases were calculated." << std::endl;
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    tree::SearchContext& context) const
+{
+  if (HasUpdates())
+  {
+    UpdatedSearch(k, neighbors, distances, context);
+  }
+  else if (searchMode == DUAL_TREE_MODE && !tree::IsSpillTree<Tree>::value)
+  {
+    // The bounds of the query tree are modified during the search, so a copy
+    // of the reference tree is used as the query tree.
+    Tree queryTree(*referenceTree);
+    ResetStatistics(queryTree);
+    TreeSearch(k, neighbors, distances, context, queryTree);
+  }
+  else
+  {
+    TreeSearch(k, neighbors, distances, context, *referenceTree);
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+NeighborSearchMode NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::BudgetedMode(
+    tree::SearchContext& context) const
+{
+  context.Exact().clear();
+  if (!context.Budgeted() || searchMode == NAIVE_MODE)
+    return searchMode;
+
+  if (tree::TreeTraits<Tree>::HasSelfChildren)
+  {
+    throw std::invalid_argument("NeighborSearch::Search(): searches with a "
+        "budget are not supported by trees with self-children");
+  }
+
+  return SINGLE_TREE_MODE;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::BudgetedSearch(
+    NeighborSearchRules<SortPolicy, MetricType, Tree>& rules,
+    const size_t numQueries,
+    tree::SearchContext& context) const
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  // The queries are split across the threads, as for the depth-first
+  // single-tree search; each query records whether it finished.
+  std::vector<char>& exact = context.Exact();
+  exact.assign(numQueries, 1);
+  size_t threadScores = 0, threadBaseCases = 0;
+  #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+  {
+    RuleType threadRules(rules, tree::SharedResults());
+    tree::BestFirstSingleTreeTraverser<Tree, RuleType> traverser(threadRules,
+        context.MaxLeaves(), context.Deadline());
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+    {
+      traverser.Traverse(i, *referenceTree);
+      exact[i] = traverser.Exact();
+    }
+
+    MLPACK_PROFILE_COUNT("neighbor_search/prunes", traverser.NumPrunes());
+    threadScores += threadRules.Scores();
+    threadBaseCases += threadRules.BaseCases();
+  }
+
+  context.Scores() += threadScores;
+  context.BaseCases() += threadBaseCases;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ResetStatistics(Tree& node)
+{
+  std::stack<Tree*> nodes;
+  nodes.push(&node);
+  while (!nodes.empty())
+  {
+    Tree* current = nodes.top();
+    nodes.pop();
+
+    // Reset bounds of this node.
+    current->Stat().Reset();
+
+    // Then add the children.
+    for (size_t i = 0; i < current->NumChildren(); ++i)
+      nodes.push(&current->Child(i));
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::UpdatedSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    tree::SearchContext& context) const
+{
+  const size_t numPoints = NumReferencePoints();
+  if (k > numPoints)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << numPoints << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // Search the tree for enough neighbors that at least k remain (together with
+  // the buffer) once the deleted points are skipped.
+  const size_t treeK = std::min(k + deletedInSet,
+      (size_t) referenceSet->n_cols);
+  arma::Mat<size_t> treeNeighbors;
+  arma::mat treeDistances;
+  if (treeK > 0)
+  {
+    TreeSearch(querySet, treeK, treeNeighbors, treeDistances, context);
+  }
+  else
+  {
+    context.BaseCases() = 0;
+    context.Scores() = 0;
+  }
+
+  // The buffer is searched with a copy of the metric, like the tree.
+  MetricType metric(this->metric);
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // Merge the neighbors from the tree with the points of the buffer.
+  typedef std::pair<double, size_t> Candidate;
+  std::vector<Candidate> candidates;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    candidates.clear();
+    for (size_t j = 0; j < treeK; ++j)
+    {
+      if (treeNeighbors(j, i) == size_t() - 1)
+        continue;
+
+      const size_t index = referenceIds.empty() ? treeNeighbors(j, i) :
+          referenceIds[treeNeighbors(j, i)];
+      if (!IsDeleted(index))
+        candidates.push_back(Candidate(treeDistances(j, i), index));
+    }
+
+    for (size_t j = 0; j < insertedSet.n_cols; ++j)
+    {
+      candidates.push_back(Candidate(metric.Evaluate(querySet.col(i),
+          insertedSet.col(j)), insertedIds[j]));
+    }
+    context.BaseCases() += insertedSet.n_cols;
+
+    const size_t found = std::min(k, (size_t) candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + found,
+        candidates.end(), [](const Candidate& a, const Candidate& b)
+        {
+          if (SortPolicy::IsBetter(a.first, b.first))
+            return true;
+          return !SortPolicy::IsBetter(b.first, a.first) && a.second < b.second;
+        });
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      neighbors(j, i) = (j < found) ? candidates[j].second : size_t() - 1;
+      distances(j, i) = (j < found) ? candidates[j].first :
+          SortPolicy::WorstDistance();
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::UpdatedSearch(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    tree::SearchContext& context) const
+{
+  const size_t numPoints = NumReferencePoints();
+  if (k >= numPoints)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than or equal to the "
+        << "number of points in the reference set (" << numPoints << ") and "
+        << "no query set has been provided.";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // Use every point of the reference set as a query point, and search for one
+  // more neighbor, since each point finds itself.
+  MatType querySet;
+  std::vector<size_t> queryIds;
+  LivePoints(querySet, queryIds);
+
+  arma::Mat<size_t> queryNeighbors;
+  arma::mat queryDistances;
+  UpdatedSearch(querySet, k + 1, queryNeighbors, queryDistances, context);
+
+  // The results are indexed by the indices of the points.
+  neighbors.set_size(k, nextId);
+  neighbors.fill(size_t() - 1);
+  distances.set_size(k, nextId);
+  distances.fill(SortPolicy::WorstDistance());
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    const size_t index = queryIds[i];
+    size_t found = 0;
+    for (size_t j = 0; j <= k && found < k; ++j)
+    {
+      if (queryNeighbors(j, i) == index)
+        continue;
+
+      neighbors(found, index) = queryNeighbors(j, i);
+      distances(found, index) = queryDistances(j, i);
+      ++found;
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(const MatType& points)
+{
+  if ((referenceSet->n_cols > 0 || insertedSet.n_cols > 0) &&
+      points.n_rows != referenceSet->n_rows)
+  {
+    std::stringstream ss;
+    ss << "cannot insert points of dimensionality " << points.n_rows << " into "
+        << "a reference set of dimensionality " << referenceSet->n_rows;
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (!HasUpdates())
+    nextId = referenceSet->n_cols;
+
+  if (!InsertIntoTree(points))
+  {
+    // Keep the points in the buffer.
+    if (insertedSet.n_cols == 0)
+      insertedSet = points;
+    else
+      insertedSet = arma::join_rows(insertedSet, points);
+
+    for (size_t i = 0; i < points.n_cols; ++i)
+      insertedIds.push_back(nextId + i);
+  }
+
+  nextId += points.n_cols;
+  CheckRebuild();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Delete(const size_t index)
+{
+  if (!HasUpdates())
+    nextId = referenceSet->n_cols;
+
+  if (index >= nextId || IsDeleted(index))
+    return false;
+
+  // Is the point in the buffer?  The indices are sorted.
+  std::vector<size_t>::iterator it = std::lower_bound(insertedIds.begin(),
+      insertedIds.end(), index);
+  if (it != insertedIds.end() && *it == index)
+  {
+    insertedSet.shed_col(it - insertedIds.begin());
+    insertedIds.erase(it);
+  }
+  else
+  {
+    // Find the column of the point in the original order of the reference set.
+    size_t column = index;
+    if (!referenceIds.empty())
+    {
+      it = std::lower_bound(referenceIds.begin(), referenceIds.end(), index);
+      if (it == referenceIds.end() || *it != index)
+        return false; // The point was deleted before the last rebuild.
+      column = it - referenceIds.begin();
+    }
+
+    if (!DeleteFromTree(column))
+      ++deletedInSet;
+  }
+
+  deleted.resize(nextId, false);
+  deleted[index] = true;
+
+  CheckRebuild();
+  return true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Rebuild()
+{
+  if (!HasUpdates())
+    return;
+
+  MatType points;
+  std::vector<size_t> indices;
+  LivePoints(points, indices);
+
+  // Training forgets the insertions and deletions, but the indices of the
+  // points must be kept.
+  std::vector<bool> oldDeleted(std::move(deleted));
+  const size_t oldNextId = nextId;
+
+  Train(std::move(points));
+
+  // If no point was deleted, the indices are the columns again.
+  if (indices.size() != oldNextId)
+  {
+    referenceIds = std::move(indices);
+    deleted = std::move(oldDeleted);
+  }
+  nextId = oldNextId;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::NumReferencePoints() const
+{
+  if (!HasUpdates())
+    return referenceSet->n_cols;
+
+  return nextId - std::count(deleted.begin(), deleted.end(), true);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ColumnIndex(
+    const size_t column) const
+{
+  // The tree may have rearranged the reference set.
+  const size_t original = (!oldFromNewReferences.empty() &&
+      tree::TreeTraits<Tree>::RearrangesDataset) ?
+      oldFromNewReferences[column] : column;
+  return referenceIds.empty() ? original : referenceIds[original];
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::LivePoints(
+    MatType& points,
+    std::vector<size_t>& indices) const
+{
+  // Order the points of the reference set by index.
+  std::vector<std::pair<size_t, size_t>> order;
+  for (size_t i = 0; i < referenceSet->n_cols; ++i)
+  {
+    const size_t index = ColumnIndex(i);
+    if (!IsDeleted(index))
+      order.push_back(std::make_pair(index, i));
+  }
+  std::sort(order.begin(), order.end());
+
+  // The points in the buffer were inserted last, so they have the largest
+  // indices.
+  points.set_size(referenceSet->n_rows, order.size() + insertedSet.n_cols);
+  indices.resize(points.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    points.col(i) = referenceSet->col(order[i].second);
+    indices[i] = order[i].first;
+  }
+  for (size_t i = 0; i < insertedSet.n_cols; ++i)
+  {
+    points.col(order.size() + i) = insertedSet.col(i);
+    indices[order.size() + i] = insertedIds[i];
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ClearUpdates()
+{
+  insertedSet.reset();
+  insertedIds.clear();
+  referenceIds.clear();
+  deleted.clear();
+  deletedInSet = 0;
+  nextId = 0;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::CheckRebuild()
+{
+  const size_t updates = insertedSet.n_cols + deletedInSet;
+  if (updates > rebuildFraction * referenceSet->n_cols)
+    Rebuild();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+typename std::enable_if<tree::IsDynamicTree<T>::value, bool>::type
+NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertIntoTree(
+    const MatType& points)
+{
+  // A tree on an empty set does not know the dimensionality of the points, so
+  // it is rebuilt instead.
+  if (!referenceTree || referenceSet->n_cols == 0)
+    return false;
+
+  MatType& dataset = referenceTree->Dataset();
+  const size_t firstColumn = dataset.n_cols;
+  if (referenceIds.empty() && nextId != firstColumn)
+  {
+    referenceIds.resize(firstColumn);
+    for (size_t i = 0; i < firstColumn; ++i)
+      referenceIds[i] = i;
+  }
+
+  dataset.insert_cols(firstColumn, points);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    referenceTree->InsertPoint(firstColumn + i);
+    if (!referenceIds.empty())
+      referenceIds.push_back(nextId + i);
+  }
+
+  return true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename T>
+typename std::enable_if<tree::IsDynamicTree<T>::value, bool>::type
+NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DeleteFromTree(
+    const size_t column)
+{
+  return referenceTree && referenceTree->DeletePoint(column);
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -1095,7 +1866,7 @@ template<typename Archive>
 void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
 DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     Archive& ar,
-    const unsigned int /* version */)
+    const unsigned int version)
 {
   // Serialize preferences for search.
   ar & BOOST_SERIALIZATION_NVP(searchMode);
@@ -1156,6 +1927,23 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     }
   }
 
+  // Insertions and deletions were added in version 1.
+  if (version >= 1)
+  {
+    ar & BOOST_SERIALIZATION_NVP(insertedSet);
+    ar & BOOST_SERIALIZATION_NVP(insertedIds);
+    ar & BOOST_SERIALIZATION_NVP(referenceIds);
+    ar & BOOST_SERIALIZATION_NVP(deleted);
+    ar & BOOST_SERIALIZATION_NVP(deletedInSet);
+    ar & BOOST_SERIALIZATION_NVP(nextId);
+    ar & BOOST_SERIALIZATION_NVP(rebuildFraction);
+  }
+  else if (Archive::is_loading::value)
+  {
+    ClearUpdates();
+    rebuildFraction = 0.1;
+  }
+
   // Reset base cases and scores.
   if (Archive::is_loading::value)
   {
@@ -14,6 +14,8 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/leaf_base_case.hpp>
+#include <mlpack/core/tree/shared_results.hpp>
 
 #include <queue>
 
@@ -54,6 +56,25 @@ class NeighborSearchRules
                       const double epsilon = 0,
                       const bool sameSet = false);
 
+  /**
+   * Create a copy of the given rules, with its own copy of the candidate lists
+   * of the query points.
+   *
+   * @param other The object to copy.
+   */
+  NeighborSearchRules(const NeighborSearchRules& other);
+
+  /**
+   * Create a copy of the given rules that shares the candidate lists of the
+   * query points with the given object (which must outlive the copy), but has
+   * its own traversal state and counters.  This allows several traversals of
+   * disjoint sets of query points to run in parallel (see
+   * tree::ParallelDualTreeTraverser).
+   *
+   * @param other The object to copy.
+   */
+  NeighborSearchRules(const NeighborSearchRules& other, tree::SharedResults);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -73,6 +94,19 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Evaluate the base cases between all points of two leaves at once.  The
+   * distances are bounded with one matrix multiplication, and only the pairs
+   * that may still improve the candidates are evaluated exactly.  This is only
+   * done for the Euclidean distance on dense data and large enough leaves;
+   * otherwise false is returned, and the base cases must be evaluated one by
+   * one.
+   *
+   * @param queryNode Query leaf.
+   * @param referenceNode Reference leaf.
+   */
+  bool LeafBaseCase(TreeType& queryNode, TreeType& referenceNode);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -179,8 +213,12 @@ class NeighborSearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
+  //! The candidate lists owned by this object (empty for copies that share
+  //! the lists of another object).
+  std::vector<CandidateList> candidateStorage;
+
   //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -201,6 +239,11 @@ class NeighborSearchRules
   //! The last base case result.
   double lastBaseCase;
 
+  //! For trees with self-children, the last query point that each reference
+  //! point was evaluated with in Score(), and the base case; this is empty
+  //! until it is needed, and is not shared with copies.
+  std::vector<std::pair<size_t, double>> pointBaseCases;
+
   //! The number of base cases that have been performed.
   size_t baseCases;
   //! The number of scores that have been performed.
@@ -29,12 +29,14 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(candidateStorage),
     k(k),
     metric(metric),
     sameSet(sameSet),
     epsilon(epsilon),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
+    lastBaseCase(0.0),
     baseCases(0),
     scores(0)
 {
@@ -59,6 +61,51 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     candidates.push_back(pqueue);
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    const NeighborSearchRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidateStorage(other.candidates),
+    candidates(candidateStorage),
+    k(other.k),
+    metric(other.metric),
+    sameSet(other.sameSet),
+    epsilon(other.epsilon),
+    lastQueryIndex(other.lastQueryIndex),
+    lastReferenceIndex(other.lastReferenceIndex),
+    lastBaseCase(other.lastBaseCase),
+    pointBaseCases(other.pointBaseCases),
+    baseCases(other.baseCases),
+    scores(other.scores),
+    traversalInfo(other.traversalInfo)
+{
+  // The traversal info still points to the other object, which is just as
+  // invalid a tree node as this object.
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    const NeighborSearchRules& other,
+    tree::SharedResults) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    metric(other.metric),
+    sameSet(other.sameSet),
+    epsilon(other.epsilon),
+    lastQueryIndex(other.lastQueryIndex),
+    lastReferenceIndex(other.lastReferenceIndex),
+    lastBaseCase(other.lastBaseCase),
+    baseCases(other.baseCases),
+    scores(other.scores),
+    traversalInfo(other.traversalInfo)
+{
+  // The traversal info still points to the other object, which is just as
+  // invalid a tree node as this object.
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -107,6 +154,52 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline bool NeighborSearchRules<SortPolicy, MetricType, TreeType>::
+LeafBaseCase(TreeType& queryNode, TreeType& referenceNode)
+{
+  typedef tree::LeafDistances<MetricType, typename TreeType::Mat>
+      LeafDistancesType;
+
+  const size_t queryBegin = queryNode.Point(0);
+  const size_t queryCount = queryNode.NumPoints();
+  const size_t referenceBegin = referenceNode.Point(0);
+  const size_t referenceCount = referenceNode.NumPoints();
+  if (!LeafDistancesType::Supported ||
+      queryCount * referenceCount < tree::minimumLeafBaseCases)
+    return false;
+
+  const LeafDistancesType leafDistances(querySet, queryBegin, queryCount,
+      referenceSet, referenceBegin, referenceCount);
+
+  for (size_t i = 0; i < queryCount; ++i)
+  {
+    const size_t queryIndex = queryBegin + i;
+    for (size_t j = 0; j < referenceCount; ++j)
+    {
+      const size_t referenceIndex = referenceBegin + j;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      // Skip the point if even its best possible distance is not better than
+      // the worst candidate.
+      const math::Range range = leafDistances.Range(i, j);
+      const double bestDistance = SortPolicy::IsBetter(range.Lo(),
+          range.Hi()) ? range.Lo() : range.Hi();
+      if (SortPolicy::IsBetter(candidates[queryIndex].top().first,
+          bestDistance))
+        continue;
+
+      const double distance = metric.Evaluate(querySet.col(queryIndex),
+          referenceSet.col(referenceIndex));
+      InsertNeighbor(queryIndex, referenceIndex, distance);
+    }
+  }
+
+  baseCases += queryCount * referenceCount;
+  return true;
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -122,15 +215,24 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     if (tree::TreeTraits<TreeType>::HasSelfChildren)
     {
       // If the parent node is the same, then we have already calculated the
-      // base case.
+      // base case.  It is kept in this object and not in the reference tree,
+      // so that several searches can share the tree.
+      if (pointBaseCases.empty())
+      {
+        pointBaseCases.resize(referenceSet.n_cols,
+            std::make_pair(querySet.n_cols, 0.0));
+      }
+
+      const size_t point = referenceNode.Point(0);
       if ((referenceNode.Parent() != NULL) &&
-          (referenceNode.Point(0) == referenceNode.Parent()->Point(0)))
-        baseCase = referenceNode.Parent()->Stat().LastDistance();
+          (point == referenceNode.Parent()->Point(0)) &&
+          (pointBaseCases[point].first == queryIndex))
+        baseCase = pointBaseCases[point].second;
       else
-        baseCase = BaseCase(queryIndex, referenceNode.Point(0));
+        baseCase = BaseCase(queryIndex, point);
 
       // Save this evaluation.
-      referenceNode.Stat().LastDistance() = baseCase;
+      pointBaseCases[point] = std::make_pair(queryIndex, baseCase);
     }
 
     distance = SortPolicy::CombineBest(baseCase,
@@ -21,6 +21,11 @@ namespace neighbor {
 /**
  * Extra data for each node in the tree.  For neighbor searches, each node only
  * needs to store a bound on neighbor distances.
+ *
+ * The bounds are only written while the node is the query node of a traversal
+ * (and read from its parent and children).  tree::ParallelDualTreeTraverser
+ * gives every thread disjoint query subtrees and never writes above them, so
+ * the bounds need no locking.
  */
 template<typename SortPolicy>
 class NeighborSearchStat
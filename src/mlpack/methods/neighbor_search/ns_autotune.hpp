@@ -0,0 +1,63 @@
+/**
+ * @file ns_autotune.hpp
+ *
+ * Selection of the fastest tree type and leaf size of an NSModel for a
+ * dataset, by timing the tree building and the search on a sample of the
+ * dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_AUTOTUNE_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_AUTOTUNE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/autotune.hpp>
+#include "ns_model.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * Choose the fastest tree type and leaf size for searching the given reference
+ * set, and set them in the model.  Each candidate builds its tree on a sample
+ * of the reference set and finds the k neighbors of every point of the sample
+ * with the given search mode and epsilon; the candidates are the kd,
+ * ball, vantage point, random projection and R trees with leaf sizes 10, 20
+ * and 40, the cover tree, and the octree with the same leaf sizes when the
+ * dimensionality is at most 8.  Spill trees are left out, since they change the
+ * results unless tau is tuned for the data.  The model's random basis setting
+ * is used for all the candidates.
+ *
+ * The decision is cached with Autotune, so reference sets of about the same
+ * shape are not timed again.  With naive search the tree does not matter, and
+ * the model is not changed.
+ *
+ * @param model Model to set the tree type and leaf size of.
+ * @param referenceSet Reference set the model will be built on (arma::mat or
+ *     arma::fmat).
+ * @param k Number of neighbors that will be searched for.
+ * @param searchMode Search mode the model will be built with.
+ * @param epsilon Relative error tolerance the model will be built with.
+ * @param sampleSize Number of points of the sample.
+ * @return The choice, as the knn program's 'tree_type' option takes the tree
+ *     type, followed by ':' and the leaf size (for instance "kd:20"); an
+ *     empty string with naive search.
+ */
+template<typename SortPolicy, typename MatType>
+std::string SelectTreeType(NSModel<SortPolicy>& model,
+                           const MatType& referenceSet,
+                           const size_t k,
+                           const NeighborSearchMode searchMode,
+                           const double epsilon = 0,
+                           const size_t sampleSize = 5000);
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ns_autotune_impl.hpp"
+
+#endif
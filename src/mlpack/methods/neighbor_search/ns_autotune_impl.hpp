@@ -0,0 +1,140 @@
+/**
+ * @file ns_autotune_impl.hpp
+ *
+ * Implementation of the selection of the fastest tree type of an NSModel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_AUTOTUNE_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_AUTOTUNE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ns_autotune.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+namespace details {
+
+//! Get the tree type with the given name of the knn program; return false if
+//! the name is not one of the candidates of SelectTreeType().
+template<typename SortPolicy>
+bool AutotuneTreeType(const std::string& name,
+                      typename NSModel<SortPolicy>::TreeTypes& treeType)
+{
+  typedef NSModel<SortPolicy> ModelType;
+  if (name == "kd")
+    treeType = ModelType::KD_TREE;
+  else if (name == "ball")
+    treeType = ModelType::BALL_TREE;
+  else if (name == "vp")
+    treeType = ModelType::VP_TREE;
+  else if (name == "rp")
+    treeType = ModelType::RP_TREE;
+  else if (name == "r")
+    treeType = ModelType::R_TREE;
+  else if (name == "cover")
+    treeType = ModelType::COVER_TREE;
+  else if (name == "oct")
+    treeType = ModelType::OCTREE;
+  else
+    return false;
+
+  return true;
+}
+
+//! Set the tree type and leaf size of a choice ("kd:20") in the model.
+template<typename SortPolicy>
+void ApplyTreeChoice(const std::string& choice, NSModel<SortPolicy>& model)
+{
+  const size_t separator = choice.find(':');
+  typename NSModel<SortPolicy>::TreeTypes treeType;
+  if (separator == std::string::npos ||
+      !AutotuneTreeType<SortPolicy>(choice.substr(0, separator), treeType))
+  {
+    throw std::invalid_argument("SelectTreeType(): invalid choice '" + choice +
+        "'");
+  }
+
+  model.TreeType() = treeType;
+  model.LeafSize() = std::stoul(choice.substr(separator + 1));
+}
+
+} // namespace details
+
+template<typename SortPolicy, typename MatType>
+std::string SelectTreeType(NSModel<SortPolicy>& model,
+                           const MatType& referenceSet,
+                           const size_t k,
+                           const NeighborSearchMode searchMode,
+                           const double epsilon,
+                           const size_t sampleSize)
+{
+  if (searchMode == NAIVE_MODE || referenceSet.n_cols < 2)
+    return "";
+
+  std::ostringstream method;
+  method << "neighbor_search/tree:mode=" << (int) searchMode;
+  if (epsilon > 0.0)
+    method << ":epsilon=" << epsilon;
+  if (model.RandomBasis())
+    method << ":random_basis";
+  const std::string key = Autotune::Key(method.str(), referenceSet.n_cols,
+      referenceSet.n_rows, k);
+
+  std::string choice;
+  if (Autotune::Lookup(key, choice))
+  {
+    Log::Info << "Using the cached choice '" << choice << "' for the tree."
+        << std::endl;
+    details::ApplyTreeChoice(choice, model);
+    return choice;
+  }
+
+  // Take the sample at regular intervals of the reference set.
+  const size_t points = std::min((size_t) referenceSet.n_cols,
+      std::max(sampleSize, (size_t) 2));
+  MatType sample(referenceSet.n_rows, points);
+  for (size_t i = 0; i < points; ++i)
+    sample.col(i) = referenceSet.col((i * referenceSet.n_cols) / points);
+  const size_t sampleK = std::max((size_t) 1, std::min(k, points - 1));
+
+  std::vector<std::string> candidates;
+  const char* trees[] = { "kd", "ball", "vp", "rp", "r", "oct" };
+  for (size_t t = 0; t < 6; ++t)
+  {
+    if (std::string(trees[t]) == "oct" && referenceSet.n_rows > 8)
+      continue;
+
+    for (const size_t leafSize : { 10, 20, 40 })
+      candidates.push_back(std::string(trees[t]) + ":" +
+          std::to_string(leafSize));
+  }
+  candidates.push_back("cover:20");
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  choice = Autotune::Fastest(candidates, [&](const std::string& candidate)
+  {
+    NSModel<SortPolicy> trial(model.TreeType(), model.RandomBasis());
+    trial.Tau() = model.Tau();
+    trial.Rho() = model.Rho();
+    details::ApplyTreeChoice(candidate, trial);
+    trial.BuildModel(MatType(sample), trial.LeafSize(), searchMode, epsilon);
+    trial.Search(sampleK, neighbors, distances);
+  });
+
+  Log::Info << "Autotuning chose '" << choice << "' for the tree."
+      << std::endl;
+  Autotune::Store(key, choice);
+  details::ApplyTreeChoice(choice, model);
+  return choice;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
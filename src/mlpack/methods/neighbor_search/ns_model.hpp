@@ -20,7 +20,9 @@
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/spill_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/tree/flat_tree.hpp>
 #include <boost/variant.hpp>
+#include <memory>
 #include "neighbor_search.hpp"
 
 namespace mlpack {
@@ -32,14 +34,32 @@ namespace neighbor {
 template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
 using NSType = NeighborSearch<SortPolicy,
                               metric::EuclideanDistance,
-                              arma::mat,
+                              MatType,
                               TreeType,
                               TreeType<metric::EuclideanDistance,
                                   NeighborSearchStat<SortPolicy>,
-                                  arma::mat>::template DualTreeTraverser>;
+                                  MatType>::template DualTreeTraverser>;
+
+/**
+ * Alias template for euclidean neighbor search with spill trees; for
+ * arma::mat this is SpillKNN.
+ */
+template<typename MatType>
+using SpillNSType = NeighborSearch<
+    NearestNeighborSort,
+    metric::EuclideanDistance,
+    MatType,
+    tree::SPTree,
+    tree::SPTree<metric::EuclideanDistance,
+        NeighborSearchStat<NearestNeighborSort>,
+        MatType>::template DefeatistDualTreeTraverser,
+    tree::SPTree<metric::EuclideanDistance,
+        NeighborSearchStat<NearestNeighborSort>,
+        MatType>::template DefeatistSingleTreeTraverser>;
 
 /**
  * MonoSearchVisitor executes a monochromatic neighbor search on the given
@@ -76,12 +96,12 @@ class MonoSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, before doing neighbor search,
  * a query tree with proper leafSize is built from the querySet.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class BiSearchVisitor : public boost::static_visitor<void>
 {
  private:
   //! The query set for the bichromatic search.
-  const arma::mat& querySet;
+  const MatType& querySet;
   //! The number of neighbors to search for.
   const size_t k;
   //! The result matrix for neighbors.
@@ -104,7 +124,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using NSTypeT = NSType<SortPolicy, TreeType>;
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
 
   //! Default Bichromatic neighbor search on the given NSType instance.
   template<template<typename TreeMetricType,
@@ -119,13 +139,13 @@ class BiSearchVisitor : public boost::static_visitor<void>
   void operator()(NSTypeT<tree::BallTree>* ns) const;
 
   //! Bichromatic neighbor search specialized for SPTrees.
-  void operator()(SpillKNN* ns) const;
+  void operator()(SpillNSType<MatType>* ns) const;
 
   //! Bichromatic neighbor search specialized for octrees.
   void operator()(NSTypeT<tree::Octree>* ns) const;
 
   //! Construct the BiSearchVisitor.
-  BiSearchVisitor(const arma::mat& querySet,
+  BiSearchVisitor(const MatType& querySet,
                   const size_t k,
                   arma::Mat<size_t>& neighbors,
                   arma::mat& distances,
@@ -140,12 +160,12 @@ class BiSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, a reference tree with proper
  * leafSize is built from the referenceSet.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class TrainVisitor : public boost::static_visitor<void>
 {
  private:
   //! The reference set to use for training.
-  arma::mat&& referenceSet;
+  MatType&& referenceSet;
   //! The leaf size, used only by BinarySpaceTree.
   size_t leafSize;
   //! Overlapping size (for spill trees).
@@ -162,7 +182,7 @@ class TrainVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using NSTypeT = NSType<SortPolicy, TreeType>;
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
 
   //! Default Train on the given NSType instance.
   template<template<typename TreeMetricType,
@@ -177,14 +197,14 @@ class TrainVisitor : public boost::static_visitor<void>
   void operator()(NSTypeT<tree::BallTree>* ns) const;
 
   //! Train specialized for SPTrees.
-  void operator()(SpillKNN* ns) const;
+  void operator()(SpillNSType<MatType>* ns) const;
 
   //! Train specialized for octrees.
   void operator()(NSTypeT<tree::Octree>* ns) const;
 
   //! Construct the TrainVisitor object with the given reference set, leafSize
   //! for BinarySpaceTrees, and tau and rho for spill trees.
-  TrainVisitor(arma::mat&& referenceSet,
+  TrainVisitor(MatType&& referenceSet,
                const size_t leafSize,
                const double tau,
                const double rho);
@@ -215,12 +235,80 @@ class EpsilonVisitor : public boost::static_visitor<double&>
 /**
  * ReferenceSetVisitor exposes the referenceSet of the given NSType.
  */
-class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
+template<typename MatType = arma::mat>
+class ReferenceSetVisitor : public boost::static_visitor<const MatType&>
 {
  public:
   //! Return the reference set.
   template<typename NSType>
-  const arma::mat& operator()(NSType *ns) const;
+  const MatType& operator()(NSType *ns) const;
+};
+
+/**
+ * FlatTreeVisitor saves the reference tree of the given NSType as a FlatTree.
+ */
+class FlatTreeVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The file to save the flat tree to.
+  const std::string& filename;
+
+ public:
+  //! Save the reference tree as a flat tree.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Construct the FlatTreeVisitor object with the given file name.
+  FlatTreeVisitor(const std::string& filename) : filename(filename) {};
+};
+
+/**
+ * InsertVisitor inserts points into the reference set of the given NSType.
+ */
+template<typename MatType = arma::mat>
+class InsertVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The points to insert.
+  const MatType& points;
+
+ public:
+  //! Insert the points.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Construct the InsertVisitor object with the given points.
+  InsertVisitor(const MatType& points) : points(points) {};
+};
+
+/**
+ * DeletePointVisitor deletes a point from the reference set of the given
+ * NSType.
+ */
+class DeletePointVisitor : public boost::static_visitor<bool>
+{
+ private:
+  //! The index of the point to delete.
+  const size_t index;
+
+ public:
+  //! Delete the point, and return whether it existed.
+  template<typename NSType>
+  bool operator()(NSType* ns) const;
+
+  //! Construct the DeletePointVisitor object with the given index.
+  DeletePointVisitor(const size_t index) : index(index) {};
+};
+
+/**
+ * RebuildVisitor rebuilds the reference tree of the given NSType.
+ */
+class RebuildVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Rebuild the reference tree.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
 };
 
 /**
@@ -234,6 +322,121 @@ class DeleteVisitor : public boost::static_visitor<void>
   void operator()(NSType *ns) const;
 };
 
+/**
+ * A query set set with NSModel::SetQuerySet(), held through this base class
+ * since the type of its query tree depends on the tree type of the model.
+ */
+class CachedQueryBase
+{
+ public:
+  virtual ~CachedQueryBase() { }
+};
+
+/**
+ * A query set prepared for repeated searches: the query set projected and
+ * converted to the precision of the model and, for dual-tree search, the query
+ * tree built on it.
+ *
+ * @tparam MatType Type of the query set.
+ * @tparam TreeType Type of the query tree.
+ */
+template<typename MatType, typename TreeType>
+struct CachedQuery : public CachedQueryBase
+{
+  //! The query set, if no query tree was built.
+  MatType querySet;
+  //! The query tree, for dual-tree search.
+  std::unique_ptr<TreeType> tree;
+  //! Mappings from the points of the query tree to the query points (empty if
+  //! the tree does not rearrange its dataset).
+  std::vector<size_t> oldFromNew;
+};
+
+/**
+ * BuildQueryVisitor prepares the given query set for repeated searches with
+ * the given NSType: in dual-tree mode the query tree is built, like
+ * BiSearchVisitor does for each search.
+ */
+template<typename SortPolicy, typename MatType = arma::mat>
+class BuildQueryVisitor : public boost::static_visitor<CachedQueryBase*>
+{
+ private:
+  //! The query set.
+  MatType&& querySet;
+  //! The number of points in a leaf (for BinarySpaceTrees).
+  const size_t leafSize;
+  //! Balance threshold (for spill trees).
+  const double rho;
+
+  //! Build the query tree with the given leaf size.
+  template<typename NSType>
+  CachedQueryBase* BuildLeaf(NSType* ns) const;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  using NSTypeT = NSType<SortPolicy, TreeType, MatType>;
+
+  //! Prepare the query set for the given NSType instance.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  CachedQueryBase* operator()(NSTypeT<TreeType>* ns) const;
+
+  //! Prepare the query set for the given NSType specialized for KDTrees.
+  CachedQueryBase* operator()(NSTypeT<tree::KDTree>* ns) const;
+
+  //! Prepare the query set for the given NSType specialized for BallTrees.
+  CachedQueryBase* operator()(NSTypeT<tree::BallTree>* ns) const;
+
+  //! Prepare the query set specialized for SPTrees.
+  CachedQueryBase* operator()(SpillNSType<MatType>* ns) const;
+
+  //! Prepare the query set specialized for octrees.
+  CachedQueryBase* operator()(NSTypeT<tree::Octree>* ns) const;
+
+  //! Construct the BuildQueryVisitor.
+  BuildQueryVisitor(MatType&& querySet,
+                    const size_t leafSize,
+                    const double rho);
+};
+
+/**
+ * CachedSearchVisitor executes a bichromatic neighbor search with a query set
+ * prepared by BuildQueryVisitor, reusing its query tree.
+ */
+template<typename MatType = arma::mat>
+class CachedSearchVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The prepared query set.
+  CachedQueryBase& query;
+  //! The number of neighbors to search for.
+  const size_t k;
+  //! The result matrix for neighbors.
+  arma::Mat<size_t>& neighbors;
+  //! The result matrix for distances.
+  arma::mat& distances;
+
+ public:
+  //! Search with the prepared query set.
+  template<typename NSType>
+  void operator()(NSType* ns) const;
+
+  //! Construct the CachedSearchVisitor.
+  CachedSearchVisitor(CachedQueryBase& query,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances) :
+      query(query),
+      k(k),
+      neighbors(neighbors),
+      distances(distances)
+  {};
+};
+
 /**
  * The NSModel class provides an easy way to serialize a model, abstracts away
  * the different types of trees, and also reflects the NeighborSearch API.  This
@@ -285,26 +488,52 @@ class NSModel
   //! This is the random projection matrix; only used if randomBasis is true.
   arma::mat q;
 
+  //! The NeighborSearch types for each tree type, with the given matrix type.
+  template<typename MatType>
+  using NSVariant = boost::variant<
+      NSType<SortPolicy, tree::KDTree, MatType>*,
+      NSType<SortPolicy, tree::StandardCoverTree, MatType>*,
+      NSType<SortPolicy, tree::RTree, MatType>*,
+      NSType<SortPolicy, tree::RStarTree, MatType>*,
+      NSType<SortPolicy, tree::BallTree, MatType>*,
+      NSType<SortPolicy, tree::XTree, MatType>*,
+      NSType<SortPolicy, tree::HilbertRTree, MatType>*,
+      NSType<SortPolicy, tree::RPlusTree, MatType>*,
+      NSType<SortPolicy, tree::RPlusPlusTree, MatType>*,
+      NSType<SortPolicy, tree::VPTree, MatType>*,
+      NSType<SortPolicy, tree::RPTree, MatType>*,
+      NSType<SortPolicy, tree::MaxRPTree, MatType>*,
+      SpillNSType<MatType>*,
+      NSType<SortPolicy, tree::UBTree, MatType>*,
+      NSType<SortPolicy, tree::Octree, MatType>*>;
+
+  //! If true, the reference set is held in single precision, in fSearch.
+  bool singlePrecision;
+
   /**
    * nSearch holds an instance of the NeigborSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
    * We access to the contained value through the visitor classes defined above.
    */
-  boost::variant<NSType<SortPolicy, tree::KDTree>*,
-                 NSType<SortPolicy, tree::StandardCoverTree>*,
-                 NSType<SortPolicy, tree::RTree>*,
-                 NSType<SortPolicy, tree::RStarTree>*,
-                 NSType<SortPolicy, tree::BallTree>*,
-                 NSType<SortPolicy, tree::XTree>*,
-                 NSType<SortPolicy, tree::HilbertRTree>*,
-                 NSType<SortPolicy, tree::RPlusTree>*,
-                 NSType<SortPolicy, tree::RPlusPlusTree>*,
-                 NSType<SortPolicy, tree::VPTree>*,
-                 NSType<SortPolicy, tree::RPTree>*,
-                 NSType<SortPolicy, tree::MaxRPTree>*,
-                 SpillKNN*,
-                 NSType<SortPolicy, tree::UBTree>*,
-                 NSType<SortPolicy, tree::Octree>*> nSearch;
+  NSVariant<arma::mat> nSearch;
+  //! The same as nSearch, for models built on single precision data.
+  NSVariant<arma::fmat> fSearch;
+
+  //! The query set of SearchQuerySet(), if SetQuerySet() was called.  It is
+  //! neither copied nor serialized.
+  std::unique_ptr<CachedQueryBase> query;
+  //! Whether the results of SearchQuerySet() are kept for later searches.
+  bool cacheResults;
+  //! The number of neighbors of the kept results (0 if there are none).
+  size_t cachedK;
+  //! The search mode used for the kept results.
+  NeighborSearchMode cachedMode;
+  //! The epsilon used for the kept results.
+  double cachedEpsilon;
+  //! The kept neighbors.
+  arma::Mat<size_t> cachedNeighbors;
+  //! The kept distances.
+  arma::mat cachedDistances;
 
  public:
   /**
@@ -352,8 +581,20 @@ class NSModel
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
-  //! Expose the dataset.
+  //! Expose the dataset.  An exception is thrown if the model holds the
+  //! dataset in single precision.
   const arma::mat& Dataset() const;
+  //! Expose the dataset of a model built in single precision.  An exception is
+  //! thrown if the model holds the dataset in double precision.
+  const arma::fmat& FloatDataset() const;
+
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const;
+  //! Get the number of points in the reference set.
+  size_t NumPoints() const;
+
+  //! Get whether the reference set is held in single precision.
+  bool SinglePrecision() const { return singlePrecision; }
 
   //! Expose SearchMode.
   NeighborSearchMode SearchMode() const;
@@ -389,19 +630,138 @@ class NSModel
                   const NeighborSearchMode searchMode,
                   const double epsilon = 0);
 
-  //! Perform neighbor search.  The query set will be reordered.
+  //! Build the reference tree on a single precision reference set, which the
+  //! model keeps in single precision.  This halves the memory of the model.
+  void BuildModel(arma::fmat&& referenceSet,
+                  const size_t leafSize,
+                  const NeighborSearchMode searchMode,
+                  const double epsilon = 0);
+
+  //! Perform neighbor search.  The query set will be reordered, and converted
+  //! to single precision if the model is.
   void Search(arma::mat&& querySet,
               const size_t k,
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  //! Perform neighbor search with a single precision query set.  The query
+  //! set will be reordered, and converted to double precision if the model is.
+  void Search(arma::fmat&& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
   //! Perform monochromatic neighbor search.
   void Search(const size_t k,
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Set the query set of SearchQuerySet(), to search it repeatedly: the query
+   * set is projected and converted to the precision of the model once, and in
+   * dual-tree mode the query tree is built once instead of at every search.
+   * This takes possession of the query set.  The query set is kept until
+   * ClearQuerySet() or BuildModel() is called.
+   *
+   * If cacheResults is true, the results of each search are also kept, and a
+   * later search with the same number of neighbors or fewer, the same search
+   * mode and the same epsilon returns them without searching.  Fewer neighbors
+   * are only served from the kept results for exact searches (epsilon = 0, no
+   * spill tree and no greedy search), so searching for the largest k first
+   * serves the others.  Inserting, deleting or rebuilding drops the results.
+   *
+   * @param querySet Set of query points.
+   * @param cacheResults Whether to keep the results of the searches.
+   */
+  void SetQuerySet(arma::mat&& querySet, const bool cacheResults = false);
+
+  //! Set the query set of SearchQuerySet() from a single precision query set;
+  //! see the double precision overload.
+  void SetQuerySet(arma::fmat&& querySet, const bool cacheResults = false);
+
+  /**
+   * Search for the neighbors of the query set given to SetQuerySet().  The
+   * results are the same as those of Search() with that query set.  The search
+   * mode should not be changed after SetQuerySet(): a query tree cannot be
+   * searched outside dual-tree mode (a std::invalid_argument is thrown), and
+   * without one the dual-tree search builds a query tree each time.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *      point.
+   */
+  void SearchQuerySet(const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances);
+
+  //! Release the query set given to SetQuerySet() and the kept results.
+  void ClearQuerySet();
+
+  //! Get whether a query set was given to SetQuerySet().
+  bool HasQuerySet() const { return query.get() != NULL; }
+
+  /**
+   * Insert the given points into the reference set; see
+   * NeighborSearch::Insert().  The first inserted point gets the index after
+   * the last index in use.
+   */
+  void Insert(arma::mat&& points);
+
+  //! Insert the given single precision points into the reference set.
+  void Insert(arma::fmat&& points);
+
+  //! Delete the point with the given index from the reference set; return
+  //! whether the point existed.
+  bool Delete(const size_t index);
+
+  //! Rebuild the reference tree with the inserted points and without the
+  //! deleted points.
+  void Rebuild();
+
+  /**
+   * Save the reference tree to the given file as a FlatTree, which can then be
+   * memory-mapped and searched for nearest neighbors without loading the
+   * model.  This is not possible for models that use naive search or a random
+   * basis.
+   *
+   * @param filename The file to save the flat tree to.
+   */
+  void SaveFlatTree(const std::string& filename) const;
+
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
+
+ private:
+  //! Apply the given visitor to the NeighborSearch object in use.
+  template<typename VisitorType>
+  typename VisitorType::result_type Apply(const VisitorType& visitor) const;
+
+  //! Build the reference tree in the given variant.
+  template<typename MatType>
+  void BuildModel(MatType&& referenceSet,
+                  NSVariant<MatType>& search,
+                  const NeighborSearchMode searchMode,
+                  const double epsilon);
+
+  //! Perform neighbor search with the given variant.
+  template<typename MatType>
+  void Search(MatType&& querySet,
+              NSVariant<MatType>& search,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Prepare the query set of SearchQuerySet() with the given variant.
+  template<typename MatType>
+  void SetQuerySet(MatType&& querySet, NSVariant<MatType>& search);
+
+  //! Project the given points onto the random basis.
+  template<typename MatType>
+  void Project(MatType& points) const;
+
+  //! Clean memory, if necessary.
+  void CleanMemory();
 };
 
 } // namespace neighbor
@@ -409,7 +769,7 @@ class NSModel
 
 //! Set the serialization version of the NSModel class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::NSModel<SortPolicy>, 1);
+    mlpack::neighbor::NSModel<SortPolicy>, 2);
 
 // Include implementation.
 #include "ns_model_impl.hpp"
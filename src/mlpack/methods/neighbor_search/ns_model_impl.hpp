@@ -33,14 +33,15 @@ void MonoSearchVisitor::operator()(NSType *ns) const
 }
 
 //! Save parameters for bichromatic neighbor search.
-template<typename SortPolicy>
-BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
-                                             const size_t k,
-                                             arma::Mat<size_t>& neighbors,
-                                             arma::mat& distances,
-                                             const size_t leafSize,
-                                             const double tau,
-                                             const double rho) :
+template<typename SortPolicy, typename MatType>
+BiSearchVisitor<SortPolicy, MatType>::BiSearchVisitor(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const size_t leafSize,
+    const double tau,
+    const double rho) :
     querySet(querySet),
     k(k),
     neighbors(neighbors),
@@ -51,11 +52,12 @@ BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
 {}
 
 //! Default Bichromatic neighbor search on the given NSType instance.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<TreeType>* ns) const
 {
   if (ns)
     return ns->Search(querySet, k, neighbors, distances);
@@ -63,8 +65,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType specialized for KDTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -72,8 +75,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType specialized for BallTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -81,8 +85,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
 }
 
 //! Bichromatic neighbor search specialized for SPTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    SpillNSType<MatType>* ns) const
 {
   if (ns)
   {
@@ -90,8 +95,8 @@ void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
     {
       // For Dual Tree Search on SpillTrees, the queryTree must be built with
       // non overlapping (tau = 0).
-      typename SpillKNN::Tree queryTree(std::move(querySet), 0 /* tau*/,
-          leafSize, rho);
+      typename SpillNSType<MatType>::Tree queryTree(std::move(querySet),
+          0 /* tau*/, leafSize, rho);
       ns->Search(queryTree, k, neighbors, distances);
     }
     else
@@ -102,8 +107,9 @@ void BiSearchVisitor<SortPolicy>::operator()(SpillKNN* ns) const
 }
 
 //! Bichromatic neighbor search specialized for octrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::Octree>* ns) const
 {
   if (ns)
     return SearchLeaf(ns);
@@ -111,9 +117,9 @@ void BiSearchVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
 }
 
 //! Bichromatic neighbor search on the given NSType considering the leafSize.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename NSType>
-void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
+void BiSearchVisitor<SortPolicy, MatType>::SearchLeaf(NSType* ns) const
 {
   if (ns->SearchMode() == DUAL_TREE_MODE)
   {
@@ -138,12 +144,169 @@ void BiSearchVisitor<SortPolicy>::SearchLeaf(NSType* ns) const
     ns->Search(querySet, k, neighbors, distances);
 }
 
+//! Save parameters for preparing a query set.
+template<typename SortPolicy, typename MatType>
+BuildQueryVisitor<SortPolicy, MatType>::BuildQueryVisitor(
+    MatType&& querySet,
+    const size_t leafSize,
+    const double rho) :
+    querySet(std::move(querySet)),
+    leafSize(leafSize),
+    rho(rho)
+{}
+
+//! Default preparation of the query set for the given NSType instance.
+template<typename SortPolicy, typename MatType>
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+CachedQueryBase* BuildQueryVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<TreeType>* ns) const
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  typedef typename NSTypeT<TreeType>::Tree Tree;
+  CachedQuery<MatType, Tree>* cached = new CachedQuery<MatType, Tree>();
+  if (ns->SearchMode() == DUAL_TREE_MODE)
+    cached->tree.reset(BuildTree<Tree>(std::move(querySet),
+        cached->oldFromNew));
+  else
+    cached->querySet = std::move(querySet);
+
+  return cached;
+}
+
+//! Prepare the query set for the given NSType specialized for KDTrees.
+template<typename SortPolicy, typename MatType>
+CachedQueryBase* BuildQueryVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
+{
+  if (ns)
+    return BuildLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Prepare the query set for the given NSType specialized for BallTrees.
+template<typename SortPolicy, typename MatType>
+CachedQueryBase* BuildQueryVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
+{
+  if (ns)
+    return BuildLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Prepare the query set specialized for SPTrees.
+template<typename SortPolicy, typename MatType>
+CachedQueryBase* BuildQueryVisitor<SortPolicy, MatType>::operator()(
+    SpillNSType<MatType>* ns) const
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  typedef typename SpillNSType<MatType>::Tree Tree;
+  CachedQuery<MatType, Tree>* cached = new CachedQuery<MatType, Tree>();
+  if (ns->SearchMode() == DUAL_TREE_MODE)
+  {
+    // As in BiSearchVisitor, the query tree is built without overlapping.
+    cached->tree.reset(new Tree(std::move(querySet), 0 /* tau */, leafSize,
+        rho));
+  }
+  else
+    cached->querySet = std::move(querySet);
+
+  return cached;
+}
+
+//! Prepare the query set specialized for octrees.
+template<typename SortPolicy, typename MatType>
+CachedQueryBase* BuildQueryVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::Octree>* ns) const
+{
+  if (ns)
+    return BuildLeaf(ns);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Prepare the query set, building the query tree with the leaf size.
+template<typename SortPolicy, typename MatType>
+template<typename NSType>
+CachedQueryBase* BuildQueryVisitor<SortPolicy, MatType>::BuildLeaf(
+    NSType* ns) const
+{
+  typedef typename NSType::Tree Tree;
+  CachedQuery<MatType, Tree>* cached = new CachedQuery<MatType, Tree>();
+  if (ns->SearchMode() == DUAL_TREE_MODE)
+    cached->tree.reset(new Tree(std::move(querySet), cached->oldFromNew,
+        leafSize));
+  else
+    cached->querySet = std::move(querySet);
+
+  return cached;
+}
+
+//! Search with the query set prepared by BuildQueryVisitor.
+template<typename MatType>
+template<typename NSType>
+void CachedSearchVisitor<MatType>::operator()(NSType* ns) const
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+
+  typedef typename NSType::Tree Tree;
+  CachedQuery<MatType, Tree>* cached =
+      dynamic_cast<CachedQuery<MatType, Tree>*>(&query);
+  if (cached == NULL)
+  {
+    throw std::invalid_argument("the query set was prepared for another tree "
+        "type or precision; call SetQuerySet() again");
+  }
+
+  if (!cached->tree)
+  {
+    ns->Search(cached->querySet, k, neighbors, distances);
+    return;
+  }
+
+  // The previous search left its bounds in the statistics of the query tree.
+  std::stack<Tree*> nodes;
+  nodes.push(cached->tree.get());
+  while (!nodes.empty())
+  {
+    Tree* current = nodes.top();
+    nodes.pop();
+    current->Stat().Reset();
+    for (size_t i = 0; i < current->NumChildren(); ++i)
+      nodes.push(&current->Child(i));
+  }
+
+  if (cached->oldFromNew.empty())
+  {
+    ns->Search(*cached->tree, k, neighbors, distances);
+    return;
+  }
+
+  arma::Mat<size_t> neighborsOut;
+  arma::mat distancesOut;
+  ns->Search(*cached->tree, k, neighborsOut, distancesOut);
+
+  // Unmap the query points.
+  distances.set_size(distancesOut.n_rows, distancesOut.n_cols);
+  neighbors.set_size(neighborsOut.n_rows, neighborsOut.n_cols);
+  for (size_t i = 0; i < neighborsOut.n_cols; ++i)
+  {
+    neighbors.col(cached->oldFromNew[i]) = neighborsOut.col(i);
+    distances.col(cached->oldFromNew[i]) = distancesOut.col(i);
+  }
+}
+
 //! Save parameters for Train.
-template<typename SortPolicy>
-TrainVisitor<SortPolicy>::TrainVisitor(arma::mat&& referenceSet,
-                                       const size_t leafSize,
-                                       const double tau,
-                                       const double rho) :
+template<typename SortPolicy, typename MatType>
+TrainVisitor<SortPolicy, MatType>::TrainVisitor(MatType&& referenceSet,
+                                                const size_t leafSize,
+                                                const double tau,
+                                                const double rho) :
     referenceSet(std::move(referenceSet)),
     leafSize(leafSize),
     tau(tau),
@@ -151,11 +314,11 @@ TrainVisitor<SortPolicy>::TrainVisitor(arma::mat&& referenceSet,
 {}
 
 //! Default Train on the given NSType instance.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
+void TrainVisitor<SortPolicy, MatType>::operator()(NSTypeT<TreeType>* ns) const
 {
   if (ns)
     return ns->Train(std::move(referenceSet));
@@ -163,8 +326,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<TreeType>* ns) const
 }
 
 //! Train on the given NSType specialized for KDTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::KDTree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -172,8 +336,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::KDTree>* ns) const
 }
 
 //! Train on the given NSType specialized for BallTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::BallTree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -181,8 +346,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::BallTree>* ns) const
 }
 
 //! Train specialized for SPTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    SpillNSType<MatType>* ns) const
 {
   if (ns)
   {
@@ -190,7 +356,8 @@ void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
       ns->Train(std::move(referenceSet));
     else
     {
-      typename SpillKNN::Tree tree(std::move(referenceSet), tau, leafSize, rho);
+      typename SpillNSType<MatType>::Tree tree(std::move(referenceSet), tau,
+          leafSize, rho);
       ns->Train(std::move(tree));
     }
   }
@@ -199,8 +366,9 @@ void TrainVisitor<SortPolicy>::operator()(SpillKNN* ns) const
 }
 
 //! Train specialized for Octrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    NSTypeT<tree::Octree>* ns) const
 {
   if (ns)
     return TrainLeaf(ns);
@@ -208,9 +376,9 @@ void TrainVisitor<SortPolicy>::operator()(NSTypeT<tree::Octree>* ns) const
 }
 
 //! Train on the given NSType considering the leafSize.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename NSType>
-void TrainVisitor<SortPolicy>::TrainLeaf(NSType* ns) const
+void TrainVisitor<SortPolicy, MatType>::TrainLeaf(NSType* ns) const
 {
   if (ns->SearchMode() == NAIVE_MODE)
     ns->Train(std::move(referenceSet));
@@ -244,14 +412,56 @@ double& EpsilonVisitor::operator()(NSType* ns) const
 }
 
 //! Expose the referenceSet of the given NSType.
+template<typename MatType>
 template<typename NSType>
-const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
+const MatType& ReferenceSetVisitor<MatType>::operator()(NSType* ns) const
 {
   if (ns)
     return ns->ReferenceSet();
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Save the reference tree of the given NSType as a flat tree.
+template<typename NSType>
+void FlatTreeVisitor::operator()(NSType* ns) const
+{
+  if (!ns)
+    throw std::runtime_error("no neighbor search model initialized");
+  if (ns->SearchMode() == NAIVE_MODE)
+    throw std::invalid_argument("cannot save a flat tree for naive search");
+
+  tree::FlatTree<>::Save(ns->ReferenceTree(), filename,
+      ns->OldFromNewReferences());
+}
+
+//! Insert points into the reference set of the given NSType.
+template<typename MatType>
+template<typename NSType>
+void InsertVisitor<MatType>::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->Insert(points);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Delete a point from the reference set of the given NSType.
+template<typename NSType>
+bool DeletePointVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->Delete(index);
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Rebuild the reference tree of the given NSType.
+template<typename NSType>
+void RebuildVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->Rebuild();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Clean memory, if necessary.
 template<typename NSType>
 void DeleteVisitor::operator()(NSType* ns) const
@@ -270,7 +480,12 @@ NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
     leafSize(20),
     tau(0),
     rho(0.7),
-    randomBasis(randomBasis)
+    randomBasis(randomBasis),
+    singlePrecision(false),
+    cacheResults(false),
+    cachedK(0),
+    cachedMode(DUAL_TREE_MODE),
+    cachedEpsilon(0)
 {
   // Nothing to do.
 }
@@ -283,9 +498,15 @@ NSModel<SortPolicy>::NSModel(const NSModel& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(other.q),
-    nSearch(other.nSearch)
+    singlePrecision(other.singlePrecision),
+    nSearch(other.nSearch),
+    fSearch(other.fSearch),
+    cacheResults(false),
+    cachedK(0),
+    cachedMode(DUAL_TREE_MODE),
+    cachedEpsilon(0)
 {
-  // Nothing to do.
+  // The query set of SearchQuerySet() is not copied.
 }
 
 template<typename SortPolicy>
@@ -296,7 +517,16 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
     rho(other.rho),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    nSearch(other.nSearch)
+    singlePrecision(other.singlePrecision),
+    nSearch(other.nSearch),
+    fSearch(other.fSearch),
+    query(std::move(other.query)),
+    cacheResults(other.cacheResults),
+    cachedK(other.cachedK),
+    cachedMode(other.cachedMode),
+    cachedEpsilon(other.cachedEpsilon),
+    cachedNeighbors(std::move(other.cachedNeighbors)),
+    cachedDistances(std::move(other.cachedDistances))
 {
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -304,13 +534,16 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   other.tau = 0;
   other.rho = 0.7;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.nSearch = decltype(other.nSearch)();
+  other.fSearch = decltype(other.fSearch)();
+  other.ClearQuerySet();
 }
 
 template<typename SortPolicy>
 NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
 {
-  boost::apply_visitor(DeleteVisitor(), nSearch);
+  CleanMemory();
 
   treeType = other.treeType;
   leafSize = other.leafSize;
@@ -318,7 +551,9 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
   rho = other.rho;
   randomBasis = other.randomBasis;
   q = other.q;
+  singlePrecision = other.singlePrecision;
   nSearch = other.nSearch;
+  fSearch = other.fSearch;
 
   return *this;
 }
@@ -326,7 +561,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
 template<typename SortPolicy>
 NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
 {
-  boost::apply_visitor(DeleteVisitor(), nSearch);
+  CleanMemory();
 
   treeType = other.treeType;
   leafSize = other.leafSize;
@@ -334,8 +569,17 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   rho = other.rho;
   randomBasis = other.randomBasis;
   q = std::move(other.q);
-  // Copy the pointer and type.
+  singlePrecision = other.singlePrecision;
+  // Copy the pointers and types.
   nSearch = other.nSearch;
+  fSearch = other.fSearch;
+  query = std::move(other.query);
+  cacheResults = other.cacheResults;
+  cachedK = other.cachedK;
+  cachedMode = other.cachedMode;
+  cachedEpsilon = other.cachedEpsilon;
+  cachedNeighbors = std::move(other.cachedNeighbors);
+  cachedDistances = std::move(other.cachedDistances);
 
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
@@ -343,7 +587,10 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
   other.tau = 0;
   other.rho = 0.7;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.nSearch = decltype(other.nSearch)();
+  other.fSearch = decltype(other.fSearch)();
+  other.ClearQuerySet();
 
   return *this;
 }
@@ -352,7 +599,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
 template<typename SortPolicy>
 NSModel<SortPolicy>::~NSModel()
 {
-  boost::apply_visitor(DeleteVisitor(), nSearch);
+  CleanMemory();
 }
 
 //! Serialize the kNN model.
@@ -374,42 +621,84 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const unsigned int version)
 
   // This should never happen, but just in case, be clean with memory.
   if (Archive::is_loading::value)
-    boost::apply_visitor(DeleteVisitor(), nSearch);
+    CleanMemory();
+
+  // Models before version 2 were always in double precision.
+  if (version > 1)
+    ar & BOOST_SERIALIZATION_NVP(singlePrecision);
+  else if (Archive::is_loading::value)
+    singlePrecision = false;
 
-  ar & BOOST_SERIALIZATION_NVP(nSearch);
+  if (singlePrecision)
+    ar & BOOST_SERIALIZATION_NVP(fSearch);
+  else
+    ar & BOOST_SERIALIZATION_NVP(nSearch);
 }
 
 //! Expose the dataset.
 template<typename SortPolicy>
 const arma::mat& NSModel<SortPolicy>::Dataset() const
 {
-  return boost::apply_visitor(ReferenceSetVisitor(), nSearch);
+  if (singlePrecision)
+  {
+    throw std::invalid_argument("NSModel::Dataset(): the model holds the "
+        "dataset in single precision; use FloatDataset()");
+  }
+
+  return boost::apply_visitor(ReferenceSetVisitor<arma::mat>(), nSearch);
+}
+
+//! Expose the single precision dataset.
+template<typename SortPolicy>
+const arma::fmat& NSModel<SortPolicy>::FloatDataset() const
+{
+  if (!singlePrecision)
+  {
+    throw std::invalid_argument("NSModel::FloatDataset(): the model holds the "
+        "dataset in double precision; use Dataset()");
+  }
+
+  return boost::apply_visitor(ReferenceSetVisitor<arma::fmat>(), fSearch);
+}
+
+//! Get the dimensionality of the reference set.
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::Dimensionality() const
+{
+  return singlePrecision ? FloatDataset().n_rows : Dataset().n_rows;
+}
+
+//! Get the number of points in the reference set.
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::NumPoints() const
+{
+  return singlePrecision ? FloatDataset().n_cols : Dataset().n_cols;
 }
 
 //! Access the search mode.
 template<typename SortPolicy>
 NeighborSearchMode NSModel<SortPolicy>::SearchMode() const
 {
-  return boost::apply_visitor(SearchModeVisitor(), nSearch);
+  return Apply(SearchModeVisitor());
 }
 
 //! Modify the search mode.
 template<typename SortPolicy>
 NeighborSearchMode& NSModel<SortPolicy>::SearchMode()
 {
-  return boost::apply_visitor(SearchModeVisitor(), nSearch);
+  return Apply(SearchModeVisitor());
 }
 
 template<typename SortPolicy>
 double NSModel<SortPolicy>::Epsilon() const
 {
-  return boost::apply_visitor(EpsilonVisitor(), nSearch);
+  return Apply(EpsilonVisitor());
 }
 
 template<typename SortPolicy>
 double& NSModel<SortPolicy>::Epsilon()
 {
-  return boost::apply_visitor(EpsilonVisitor(), nSearch);
+  return Apply(EpsilonVisitor());
 }
 
 //! Build the reference tree.
@@ -420,6 +709,39 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
                                      const double epsilon)
 {
   this->leafSize = leafSize;
+
+  // Clean memory, if necessary.
+  CleanMemory();
+
+  singlePrecision = false;
+  BuildModel<arma::mat>(std::move(referenceSet), nSearch, searchMode, epsilon);
+}
+
+//! Build the reference tree on a single precision reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::BuildModel(arma::fmat&& referenceSet,
+                                     const size_t leafSize,
+                                     const NeighborSearchMode searchMode,
+                                     const double epsilon)
+{
+  this->leafSize = leafSize;
+
+  // Clean memory, if necessary.
+  CleanMemory();
+
+  singlePrecision = true;
+  BuildModel<arma::fmat>(std::move(referenceSet), fSearch, searchMode,
+      epsilon);
+}
+
+//! Build the reference tree in the given variant.
+template<typename SortPolicy>
+template<typename MatType>
+void NSModel<SortPolicy>::BuildModel(MatType&& referenceSet,
+                                     NSVariant<MatType>& search,
+                                     const NeighborSearchMode searchMode,
+                                     const double epsilon)
+{
   // Initialize random basis if necessary.
   if (randomBasis)
   {
@@ -452,12 +774,9 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
     }
   }
 
-  // Clean memory, if necessary.
-  boost::apply_visitor(DeleteVisitor(), nSearch);
-
   // Do we need to modify the reference set?
   if (randomBasis)
-    referenceSet = q * referenceSet;
+    Project(referenceSet);
 
   if (searchMode != NAIVE_MODE)
   {
@@ -468,56 +787,69 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   switch (treeType)
   {
     case KD_TREE:
-      nSearch = new NSType<SortPolicy, tree::KDTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::KDTree, MatType>(searchMode,
+          epsilon);
       break;
     case COVER_TREE:
-      nSearch = new NSType<SortPolicy, tree::StandardCoverTree>(searchMode,
-          epsilon);
+      search = new NSType<SortPolicy, tree::StandardCoverTree, MatType>(
+          searchMode, epsilon);
       break;
     case R_TREE:
-      nSearch = new NSType<SortPolicy, tree::RTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::RTree, MatType>(searchMode,
+          epsilon);
       break;
     case R_STAR_TREE:
-      nSearch = new NSType<SortPolicy, tree::RStarTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::RStarTree, MatType>(searchMode,
+          epsilon);
       break;
     case BALL_TREE:
-      nSearch = new NSType<SortPolicy, tree::BallTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::BallTree, MatType>(searchMode,
+          epsilon);
       break;
     case X_TREE:
-      nSearch = new NSType<SortPolicy, tree::XTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::XTree, MatType>(searchMode,
+          epsilon);
       break;
     case HILBERT_R_TREE:
-      nSearch = new NSType<SortPolicy, tree::HilbertRTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::HilbertRTree, MatType>(searchMode,
+          epsilon);
       break;
     case R_PLUS_TREE:
-      nSearch = new NSType<SortPolicy, tree::RPlusTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::RPlusTree, MatType>(searchMode,
+          epsilon);
       break;
     case R_PLUS_PLUS_TREE:
-      nSearch = new NSType<SortPolicy, tree::RPlusPlusTree>(searchMode,
-          epsilon);
+      search = new NSType<SortPolicy, tree::RPlusPlusTree, MatType>(
+          searchMode, epsilon);
       break;
     case VP_TREE:
-      nSearch = new NSType<SortPolicy, tree::VPTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::VPTree, MatType>(searchMode,
+          epsilon);
       break;
     case RP_TREE:
-      nSearch = new NSType<SortPolicy, tree::RPTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::RPTree, MatType>(searchMode,
+          epsilon);
       break;
     case MAX_RP_TREE:
-      nSearch = new NSType<SortPolicy, tree::MaxRPTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::MaxRPTree, MatType>(searchMode,
+          epsilon);
       break;
     case SPILL_TREE:
-      nSearch = new SpillKNN(searchMode, epsilon);
+      search = new SpillNSType<MatType>(searchMode, epsilon);
       break;
     case UB_TREE:
-      nSearch = new NSType<SortPolicy, tree::UBTree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::UBTree, MatType>(searchMode,
+          epsilon);
       break;
     case OCTREE:
-      nSearch = new NSType<SortPolicy, tree::Octree>(searchMode, epsilon);
+      search = new NSType<SortPolicy, tree::Octree, MatType>(searchMode,
+          epsilon);
       break;
   }
 
-  TrainVisitor<SortPolicy> tn(std::move(referenceSet), leafSize, tau, rho);
-  boost::apply_visitor(tn, nSearch);
+  TrainVisitor<SortPolicy, MatType> tn(std::move(referenceSet), leafSize, tau,
+      rho);
+  boost::apply_visitor(tn, search);
 
   if (searchMode != NAIVE_MODE)
   {
@@ -532,10 +864,52 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
                                  const size_t k,
                                  arma::Mat<size_t>& neighbors,
                                  arma::mat& distances)
+{
+  if (singlePrecision)
+  {
+    arma::fmat floatQuerySet = arma::conv_to<arma::fmat>::from(querySet);
+    querySet.reset();
+    Search<arma::fmat>(std::move(floatQuerySet), fSearch, k, neighbors,
+        distances);
+  }
+  else
+  {
+    Search<arma::mat>(std::move(querySet), nSearch, k, neighbors, distances);
+  }
+}
+
+//! Perform neighbor search with a single precision query set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Search(arma::fmat&& querySet,
+                                 const size_t k,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& distances)
+{
+  if (singlePrecision)
+  {
+    Search<arma::fmat>(std::move(querySet), fSearch, k, neighbors, distances);
+  }
+  else
+  {
+    arma::mat doubleQuerySet = arma::conv_to<arma::mat>::from(querySet);
+    querySet.reset();
+    Search<arma::mat>(std::move(doubleQuerySet), nSearch, k, neighbors,
+        distances);
+  }
+}
+
+//! Perform neighbor search with the given variant.
+template<typename SortPolicy>
+template<typename MatType>
+void NSModel<SortPolicy>::Search(MatType&& querySet,
+                                 NSVariant<MatType>& search,
+                                 const size_t k,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& distances)
 {
   // We may need to map the query set randomly.
   if (randomBasis)
-    querySet = q * querySet;
+    Project(querySet);
 
   Log::Info << "Searching for " << k << " neighbors with ";
 
@@ -556,9 +930,9 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
       break;
   }
 
-  BiSearchVisitor<SortPolicy> search(querySet, k, neighbors, distances,
-      leafSize, tau, rho);
-  boost::apply_visitor(search, nSearch);
+  BiSearchVisitor<SortPolicy, MatType> visitor(querySet, k, neighbors,
+      distances, leafSize, tau, rho);
+  boost::apply_visitor(visitor, search);
 }
 
 //! Perform neighbor search.
@@ -591,7 +965,228 @@ void NSModel<SortPolicy>::Search(const size_t k,
         << std::endl;
 
   MonoSearchVisitor search(k, neighbors, distances);
-  boost::apply_visitor(search, nSearch);
+  Apply(search);
+}
+
+//! Prepare the query set of SearchQuerySet().
+template<typename SortPolicy>
+void NSModel<SortPolicy>::SetQuerySet(arma::mat&& querySet,
+                                      const bool cacheResults)
+{
+  if (singlePrecision)
+  {
+    arma::fmat floatQuerySet = arma::conv_to<arma::fmat>::from(querySet);
+    querySet.reset();
+    SetQuerySet<arma::fmat>(std::move(floatQuerySet), fSearch);
+  }
+  else
+  {
+    SetQuerySet<arma::mat>(std::move(querySet), nSearch);
+  }
+
+  this->cacheResults = cacheResults;
+}
+
+//! Prepare the query set of SearchQuerySet() from single precision points.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::SetQuerySet(arma::fmat&& querySet,
+                                      const bool cacheResults)
+{
+  if (singlePrecision)
+  {
+    SetQuerySet<arma::fmat>(std::move(querySet), fSearch);
+  }
+  else
+  {
+    arma::mat doubleQuerySet = arma::conv_to<arma::mat>::from(querySet);
+    querySet.reset();
+    SetQuerySet<arma::mat>(std::move(doubleQuerySet), nSearch);
+  }
+
+  this->cacheResults = cacheResults;
+}
+
+//! Prepare the query set of SearchQuerySet() with the given variant.
+template<typename SortPolicy>
+template<typename MatType>
+void NSModel<SortPolicy>::SetQuerySet(MatType&& querySet,
+                                      NSVariant<MatType>& search)
+{
+  ClearQuerySet();
+
+  // We may need to map the query set randomly.
+  if (randomBasis)
+    Project(querySet);
+
+  const bool buildTree = (SearchMode() == DUAL_TREE_MODE);
+  if (buildTree)
+  {
+    Timer::Start("tree_building");
+    Log::Info << "Building query tree..." << std::endl;
+  }
+
+  BuildQueryVisitor<SortPolicy, MatType> visitor(std::move(querySet), leafSize,
+      rho);
+  query.reset(boost::apply_visitor(visitor, search));
+
+  if (buildTree)
+  {
+    Timer::Stop("tree_building");
+    Log::Info << "Tree built." << std::endl;
+  }
+}
+
+//! Search for the neighbors of the query set given to SetQuerySet().
+template<typename SortPolicy>
+void NSModel<SortPolicy>::SearchQuerySet(const size_t k,
+                                         arma::Mat<size_t>& neighbors,
+                                         arma::mat& distances)
+{
+  if (!query)
+  {
+    throw std::invalid_argument("NSModel::SearchQuerySet(): no query set; "
+        "call SetQuerySet() first");
+  }
+
+  // Fewer neighbors can be taken from the kept results only if these are
+  // exact.
+  const bool exact = (Epsilon() == 0 && treeType != SPILL_TREE &&
+      SearchMode() != GREEDY_SINGLE_TREE_MODE);
+  if (cachedK > 0 && SearchMode() == cachedMode && Epsilon() == cachedEpsilon
+      && k > 0 && (k == cachedK || (k < cachedK && exact)))
+  {
+    Log::Info << "Using the kept results of the search for " << cachedK
+        << " neighbors." << std::endl;
+    neighbors = cachedNeighbors.rows(0, k - 1);
+    distances = cachedDistances.rows(0, k - 1);
+    return;
+  }
+
+  Log::Info << "Searching for " << k << " neighbors with the prepared query "
+      << "set..." << std::endl;
+  if (singlePrecision)
+  {
+    Apply(CachedSearchVisitor<arma::fmat>(*query, k, neighbors, distances));
+  }
+  else
+  {
+    Apply(CachedSearchVisitor<arma::mat>(*query, k, neighbors, distances));
+  }
+
+  if (cacheResults && k > 0)
+  {
+    cachedK = k;
+    cachedMode = SearchMode();
+    cachedEpsilon = Epsilon();
+    cachedNeighbors = neighbors;
+    cachedDistances = distances;
+  }
+}
+
+//! Release the query set of SearchQuerySet().
+template<typename SortPolicy>
+void NSModel<SortPolicy>::ClearQuerySet()
+{
+  query.reset();
+  cachedK = 0;
+  cachedNeighbors.reset();
+  cachedDistances.reset();
+}
+
+//! Insert points into the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Insert(arma::mat&& points)
+{
+  if (singlePrecision)
+  {
+    Insert(arma::conv_to<arma::fmat>::from(points));
+    return;
+  }
+
+  // The points must be mapped like the reference set.
+  if (randomBasis)
+    Project(points);
+
+  boost::apply_visitor(InsertVisitor<arma::mat>(points), nSearch);
+  cachedK = 0;
+}
+
+//! Insert single precision points into the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Insert(arma::fmat&& points)
+{
+  if (!singlePrecision)
+  {
+    Insert(arma::conv_to<arma::mat>::from(points));
+    return;
+  }
+
+  // The points must be mapped like the reference set.
+  if (randomBasis)
+    Project(points);
+
+  boost::apply_visitor(InsertVisitor<arma::fmat>(points), fSearch);
+  cachedK = 0;
+}
+
+//! Delete a point from the reference set.
+template<typename SortPolicy>
+bool NSModel<SortPolicy>::Delete(const size_t index)
+{
+  cachedK = 0;
+  return Apply(DeletePointVisitor(index));
+}
+
+//! Rebuild the reference tree.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Rebuild()
+{
+  Apply(RebuildVisitor());
+  cachedK = 0;
+}
+
+//! Save the reference tree as a flat tree.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::SaveFlatTree(const std::string& filename) const
+{
+  if (randomBasis)
+  {
+    throw std::invalid_argument("cannot save a flat tree for a model that uses"
+        " a random basis");
+  }
+
+  Apply(FlatTreeVisitor(filename));
+}
+
+//! Apply the given visitor to the NeighborSearch object in use.
+template<typename SortPolicy>
+template<typename VisitorType>
+typename VisitorType::result_type NSModel<SortPolicy>::Apply(
+    const VisitorType& visitor) const
+{
+  if (singlePrecision)
+    return boost::apply_visitor(visitor, fSearch);
+  else
+    return boost::apply_visitor(visitor, nSearch);
+}
+
+//! Project the given points onto the random basis.
+template<typename SortPolicy>
+template<typename MatType>
+void NSModel<SortPolicy>::Project(MatType& points) const
+{
+  points = arma::conv_to<MatType>::from(q) * points;
+}
+
+//! Clean memory, if necessary.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::CleanMemory()
+{
+  boost::apply_visitor(DeleteVisitor(), nSearch);
+  boost::apply_visitor(DeleteVisitor(), fSearch);
+  nSearch = decltype(nSearch)();
+  fSearch = decltype(fSearch)();
+  ClearQuerySet();
 }
 
 //! Get the name of the tree type.
@@ -18,6 +18,7 @@
 #include "neighbor_search.hpp"
 
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 
 #include "sort_policies/nearest_neighbor_sort.hpp"
 #include "sort_policies/furthest_neighbor_sort.hpp"
@@ -66,6 +67,22 @@ using DefeatistKNN = NeighborSearch<
  */
 typedef DefeatistKNN<tree::SPTree> SpillKNN;
 
+/**
+ * The ParallelKNN class is the k-nearest-neighbors method with a dual-tree
+ * traversal that runs on all available threads (see
+ * tree::ParallelDualTreeTraverser).  The given tree type (a kd-tree by
+ * default) must not have overlapping nodes.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+using ParallelKNN = NeighborSearch<
+    NearestNeighborSort,
+    metric::EuclideanDistance,
+    arma::mat,
+    TreeType,
+    tree::ParallelDualTreeTraverser>;
+
 /**
  * @deprecated
  * The AllkNN class is the k-nearest-neighbors method.  It returns L2 distances
@@ -0,0 +1,236 @@
+/**
+ * @file nn_descent.hpp
+ *
+ * Defines the NNDescent class, which builds an approximate k-nearest-neighbor
+ * graph of a dataset by local joins of the neighbors of neighbors.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @inproceedings{dong2011efficient,
+ *  title={Efficient k-nearest neighbor graph construction for generic
+ *      similarity measures},
+ *  author={Dong, W. and Moses, C. and Li, K.},
+ *  booktitle={Proceedings of the 20th International Conference on World Wide
+ *      Web},
+ *  pages={577--586},
+ *  year={2011}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NN_DESCENT_NN_DESCENT_HPP
+#define MLPACK_METHODS_NN_DESCENT_NN_DESCENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The NNDescent class builds an approximate k-nearest-neighbor graph of a
+ * dataset: for each point, an approximation of its k nearest neighbors among
+ * the other points.  It starts from random neighbors, and improves them
+ * iteratively on the principle that a neighbor of a neighbor is likely to be a
+ * neighbor: at each iteration, each point compares all pairs of its sampled
+ * neighbors and reverse neighbors (the points that have it as a neighbor),
+ * and each pair that is closer than the current neighbors of its points
+ * updates them.  Only pairs with at least one neighbor that is new since the
+ * last iteration are compared.  The iterations stop when fewer than
+ * Delta() * k * n neighbors are updated in an iteration, or after
+ * MaxIterations() iterations.
+ *
+ * Each iteration costs about n * (SampleRate() * k)^2 distance evaluations, so
+ * building the graph costs far less than the n^2 evaluations of brute force,
+ * and unlike the trees, it does not degrade in high dimensions.  A higher
+ * sample rate, a lower delta and more iterations give a better recall for a
+ * longer build.
+ *
+ * The points are processed in parallel.  The updates found by the local joins
+ * of a block of points are collected first and then applied in parallel, each
+ * thread updating its own share of the points, so that no locks are needed;
+ * the graph then only depends on the random seed and the number of threads.
+ *
+ * The results have the same format as those of the all-points
+ * NeighborSearch::Search(): the neighbors of point i, sorted by distance, are
+ * in column i of the neighbors matrix, with their distances in column i of the
+ * distances matrix, and a point is not its own neighbor.
+ *
+ * @tparam MetricType The metric to use; any metric works.
+ * @tparam MatType Type of the matrix of the dataset.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class NNDescent
+{
+ public:
+  /**
+   * Create the NNDescent object with the given parameters.
+   *
+   * @param sampleRate The fraction of the k neighbors (and of the reverse
+   *     neighbors) of each point that are sampled for the local join of each
+   *     iteration (between 0 and 1).
+   * @param delta The iterations stop when fewer than delta * k * n neighbors
+   *     are updated in an iteration.
+   * @param maxIterations The maximum number of iterations.
+   * @param metric An optional instance of the metric type.
+   */
+  NNDescent(const double sampleRate = 0.5,
+            const double delta = 0.001,
+            const size_t maxIterations = 20,
+            const MetricType metric = MetricType());
+
+  /**
+   * Build the approximate k-nearest-neighbor graph of the given dataset.
+   * Throws std::invalid_argument if k is 0 or not less than the number of
+   * points, or if the sample rate is not in (0, 1].
+   *
+   * @param dataset Dataset to build the graph of, one point per column.
+   * @param k Number of neighbors of each point.
+   * @param neighbors Matrix storing the neighbors of each point (k by n).
+   * @param distances Matrix storing the distances of the neighbors of each
+   *     point (k by n).
+   */
+  void Build(const MatType& dataset,
+             const size_t k,
+             arma::Mat<size_t>& neighbors,
+             arma::mat& distances);
+
+  //! Get the fraction of the neighbors sampled at each iteration.
+  double SampleRate() const { return sampleRate; }
+  //! Modify the fraction of the neighbors sampled at each iteration.
+  double& SampleRate() { return sampleRate; }
+
+  //! Get the fraction of updated neighbors below which the iterations stop.
+  double Delta() const { return delta; }
+  //! Modify the fraction of updated neighbors below which the iterations stop.
+  double& Delta() { return delta; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of iterations of the last build.
+  size_t Iterations() const { return iterations; }
+  //! Get the number of distance evaluations of the last build.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+
+  //! Get the instance of the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the instance of the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! A point that may be a neighbor of another point.
+  struct Update
+  {
+    //! The point whose neighbors may be updated.
+    size_t point;
+    //! The candidate neighbor.
+    size_t neighbor;
+    //! The distance between the points.
+    double distance;
+  };
+
+  //! Mix the bits of the given value (the finalizer of splitmix64), to draw
+  //! deterministic random numbers from any thread.
+  static uint64_t Hash(uint64_t x)
+  {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+
+  /**
+   * Sample at most the given number of points from the given list, keeping
+   * those with the lowest random priority.
+   *
+   * @param points The points to sample from; the sampled points are moved to
+   *     the front.
+   * @param count The number of points.
+   * @param sampleSize The maximum number of points to keep.
+   * @param salt Value that the priorities are drawn from.
+   * @return The number of sampled points.
+   */
+  static size_t Sample(size_t* points,
+                       const size_t count,
+                       const size_t sampleSize,
+                       const uint64_t salt);
+
+  /**
+   * Evaluate the distance between the given points, and keep the updates of
+   * their neighbors that it may give.
+   *
+   * @param dataset The dataset.
+   * @param a The first point.
+   * @param b The second point.
+   * @param distances The distances of the current neighbors of each point.
+   * @param updates The updates found so far.
+   */
+  void Join(const MatType& dataset,
+            const size_t a,
+            const size_t b,
+            const arma::mat& distances,
+            std::vector<Update>& updates);
+
+  /**
+   * Insert the given neighbor into the sorted list of neighbors of a point, if
+   * it is closer than the furthest neighbor and not in the list yet.
+   *
+   * @param neighbors Neighbors of the point.
+   * @param distances Distances of the neighbors.
+   * @param isNew Whether each neighbor is new since the last iteration.
+   * @param k Number of neighbors.
+   * @param neighbor The candidate neighbor.
+   * @param distance The distance of the candidate.
+   * @return Whether the neighbor was inserted.
+   */
+  static bool Insert(size_t* neighbors,
+                     double* distances,
+                     char* isNew,
+                     const size_t k,
+                     const size_t neighbor,
+                     const double distance);
+
+  /**
+   * Apply the given updates to the graph, in parallel.
+   *
+   * @param updates The updates found by each chunk of points.
+   * @param neighbors The neighbors of each point.
+   * @param distances The distances of the neighbors.
+   * @param isNew Whether each neighbor is new since the last iteration.
+   * @return The number of neighbors that changed.
+   */
+  size_t ApplyUpdates(const std::vector<std::vector<Update>>& updates,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances,
+                      std::vector<char>& isNew) const;
+
+  //! The fraction of the neighbors sampled at each iteration.
+  double sampleRate;
+  //! The fraction of updated neighbors below which the iterations stop.
+  double delta;
+  //! The maximum number of iterations.
+  size_t maxIterations;
+
+  //! The number of iterations of the last build.
+  size_t iterations;
+  //! The number of distance evaluations of the last build.
+  size_t distanceEvaluations;
+
+  //! Instantiated metric.
+  MetricType metric;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "nn_descent_impl.hpp"
+
+#endif
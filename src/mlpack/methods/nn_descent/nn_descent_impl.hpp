@@ -0,0 +1,350 @@
+/**
+ * @file nn_descent_impl.hpp
+ *
+ * Implementation of the NNDescent class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NN_DESCENT_NN_DESCENT_IMPL_HPP
+#define MLPACK_METHODS_NN_DESCENT_NN_DESCENT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "nn_descent.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+NNDescent<MetricType, MatType>::NNDescent(const double sampleRate,
+                                          const double delta,
+                                          const size_t maxIterations,
+                                          const MetricType metric) :
+    sampleRate(sampleRate),
+    delta(delta),
+    maxIterations(maxIterations),
+    iterations(0),
+    distanceEvaluations(0),
+    metric(metric)
+{ /* Nothing to do. */ }
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Build(const MatType& dataset,
+                                           const size_t k,
+                                           arma::Mat<size_t>& neighbors,
+                                           arma::mat& distances)
+{
+  const size_t n = dataset.n_cols;
+  if (k == 0 || k >= n)
+  {
+    std::ostringstream oss;
+    oss << "NNDescent::Build(): k must be between 1 and the number of points "
+        << "minus 1 (" << n - 1 << "), but is " << k;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (sampleRate <= 0.0 || sampleRate > 1.0)
+  {
+    throw std::invalid_argument("NNDescent::Build(): the sample rate must be "
+        "in (0, 1]");
+  }
+
+  const uint64_t seed = (uint64_t)
+      math::RandInt(std::numeric_limits<int>::max());
+
+  neighbors.set_size(k, n);
+  distances.set_size(k, n);
+  neighbors.fill(n);
+  distances.fill(DBL_MAX);
+  std::vector<char> isNew(k * n, 1);
+  size_t evaluations = 0;
+
+  // Start from k distinct random neighbors of each point.
+  #pragma omp parallel for schedule(static) reduction(+:evaluations)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    size_t* pointNeighbors = neighbors.colptr(i);
+    const uint64_t pointSeed = Hash(seed + (uint64_t) i);
+    size_t found = 0;
+    for (uint64_t attempt = 0; found < k; ++attempt)
+    {
+      const size_t candidate = Hash(pointSeed + attempt) % n;
+      if (candidate == (size_t) i || std::find(pointNeighbors,
+          pointNeighbors + k, candidate) != pointNeighbors + k)
+        continue;
+
+      const double distance = metric.Evaluate(dataset.unsafe_col(i),
+          dataset.unsafe_col(candidate));
+      ++evaluations;
+      Insert(pointNeighbors, distances.colptr(i), &isNew[i * k], k, candidate,
+          distance);
+      ++found;
+    }
+  }
+
+  // The candidates of each point for the local join: its sampled new (and
+  // then old) neighbors, followed by its sampled new (and old) reverse
+  // neighbors.
+  const size_t sampleSize = std::max((size_t) 1,
+      (size_t) std::ceil(sampleRate * k));
+  arma::Mat<size_t> newCandidates(k + sampleSize, n);
+  arma::Mat<size_t> oldCandidates(k + sampleSize, n);
+  arma::Col<size_t> newCounts(n), oldCounts(n);
+
+  size_t numChunks = 1;
+  #ifdef HAS_OPENMP
+    numChunks = omp_get_max_threads();
+  #endif
+  std::vector<std::vector<Update>> updates(numChunks);
+  const size_t blockSize = 16384;
+
+  iterations = 0;
+  while (iterations < maxIterations)
+  {
+    ++iterations;
+    const uint64_t iterationSeed = Hash(seed ^ Hash(iterations));
+
+    // Sample the new neighbors of each point, which are old after this
+    // iteration; the other new neighbors wait for a later iteration.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      const size_t* pointNeighbors = neighbors.colptr(i);
+      char* pointIsNew = &isNew[i * k];
+      size_t* pointNew = newCandidates.colptr(i);
+      size_t* pointOld = oldCandidates.colptr(i);
+      size_t numNew = 0, numOld = 0;
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (pointIsNew[j])
+          pointNew[numNew++] = pointNeighbors[j];
+        else
+          pointOld[numOld++] = pointNeighbors[j];
+      }
+
+      numNew = Sample(pointNew, numNew, sampleSize,
+          Hash(iterationSeed + (uint64_t) i));
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (pointIsNew[j] && std::find(pointNew, pointNew + numNew,
+            pointNeighbors[j]) != pointNew + numNew)
+          pointIsNew[j] = 0;
+      }
+
+      newCounts[i] = numNew;
+      oldCounts[i] = numOld;
+    }
+
+    // List the reverse neighbors of each point, grouped by point.
+    arma::Col<size_t> newOffsets(n + 1, arma::fill::zeros);
+    arma::Col<size_t> oldOffsets(n + 1, arma::fill::zeros);
+    for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = 0; j < newCounts[i]; ++j)
+        ++newOffsets[newCandidates(j, i) + 1];
+      for (size_t j = 0; j < oldCounts[i]; ++j)
+        ++oldOffsets[oldCandidates(j, i) + 1];
+    }
+    newOffsets = arma::cumsum(newOffsets);
+    oldOffsets = arma::cumsum(oldOffsets);
+
+    std::vector<size_t> reverseNew(newOffsets[n]), reverseOld(oldOffsets[n]);
+    arma::Col<size_t> newPositions(newOffsets), oldPositions(oldOffsets);
+    for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = 0; j < newCounts[i]; ++j)
+        reverseNew[newPositions[newCandidates(j, i)]++] = i;
+      for (size_t j = 0; j < oldCounts[i]; ++j)
+        reverseOld[oldPositions[oldCandidates(j, i)]++] = i;
+    }
+
+    // Add a sample of the reverse neighbors of each point to its candidates.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      size_t* pointNew = newCandidates.colptr(i);
+      size_t* pointReverse = reverseNew.data() + newOffsets[i];
+      const size_t numForward = newCounts[i];
+      const size_t numReverse = Sample(pointReverse,
+          newOffsets[i + 1] - newOffsets[i], sampleSize,
+          Hash(iterationSeed + n + (uint64_t) i));
+      for (size_t j = 0; j < numReverse; ++j)
+      {
+        if (std::find(pointNew, pointNew + numForward, pointReverse[j]) ==
+            pointNew + numForward)
+          pointNew[newCounts[i]++] = pointReverse[j];
+      }
+
+      size_t* pointOld = oldCandidates.colptr(i);
+      pointReverse = reverseOld.data() + oldOffsets[i];
+      const size_t numOldForward = oldCounts[i];
+      const size_t numOldReverse = Sample(pointReverse,
+          oldOffsets[i + 1] - oldOffsets[i], sampleSize,
+          Hash(iterationSeed + 2 * n + (uint64_t) i));
+      for (size_t j = 0; j < numOldReverse; ++j)
+      {
+        if (std::find(pointOld, pointOld + numOldForward, pointReverse[j]) ==
+            pointOld + numOldForward)
+          pointOld[oldCounts[i]++] = pointReverse[j];
+      }
+    }
+
+    // Join the candidates of each point, one block of points at a time: each
+    // chunk of the block collects the updates it finds, while the graph is
+    // not modified, and then the updates are applied.
+    size_t updated = 0;
+    for (size_t blockBegin = 0; blockBegin < n; blockBegin += blockSize)
+    {
+      const size_t blockEnd = std::min(n, blockBegin + blockSize);
+      const size_t chunkSize = (blockEnd - blockBegin + numChunks - 1) /
+          numChunks;
+
+      #pragma omp parallel for schedule(static) reduction(+:evaluations)
+      for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+      {
+        std::vector<Update>& chunkUpdates = updates[c];
+        chunkUpdates.clear();
+        const size_t begin = std::min(blockBegin + c * chunkSize, blockEnd);
+        const size_t end = std::min(begin + chunkSize, blockEnd);
+        for (size_t i = begin; i < end; ++i)
+        {
+          const size_t* pointNew = newCandidates.colptr(i);
+          const size_t* pointOld = oldCandidates.colptr(i);
+          for (size_t a = 0; a < newCounts[i]; ++a)
+          {
+            const size_t p = pointNew[a];
+            for (size_t b = a + 1; b < newCounts[i]; ++b)
+            {
+              Join(dataset, p, pointNew[b], distances, chunkUpdates);
+              ++evaluations;
+            }
+
+            for (size_t b = 0; b < oldCounts[i]; ++b)
+            {
+              if (pointOld[b] == p)
+                continue;
+
+              Join(dataset, p, pointOld[b], distances, chunkUpdates);
+              ++evaluations;
+            }
+          }
+        }
+      }
+
+      updated += ApplyUpdates(updates, neighbors, distances, isNew);
+    }
+
+    Log::Info << "NNDescent::Build(): iteration " << iterations << ", "
+        << updated << " neighbors updated." << std::endl;
+    if (updated <= delta * k * n)
+      break;
+  }
+
+  distanceEvaluations = evaluations;
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Join(const MatType& dataset,
+                                          const size_t a,
+                                          const size_t b,
+                                          const arma::mat& distances,
+                                          std::vector<Update>& updates)
+{
+  const double distance = metric.Evaluate(dataset.unsafe_col(a),
+      dataset.unsafe_col(b));
+
+  // Only the updates that may be applied are kept.
+  const size_t k = distances.n_rows;
+  if (distance < distances(k - 1, a))
+    updates.push_back(Update{ a, b, distance });
+  if (distance < distances(k - 1, b))
+    updates.push_back(Update{ b, a, distance });
+}
+
+template<typename MetricType, typename MatType>
+size_t NNDescent<MetricType, MatType>::Sample(size_t* points,
+                                              const size_t count,
+                                              const size_t sampleSize,
+                                              const uint64_t salt)
+{
+  if (count <= sampleSize)
+    return count;
+
+  std::nth_element(points, points + sampleSize, points + count,
+      [salt](const size_t a, const size_t b)
+      {
+        return Hash(salt ^ a) < Hash(salt ^ b);
+      });
+
+  return sampleSize;
+}
+
+template<typename MetricType, typename MatType>
+bool NNDescent<MetricType, MatType>::Insert(size_t* neighbors,
+                                            double* distances,
+                                            char* isNew,
+                                            const size_t k,
+                                            const size_t neighbor,
+                                            const double distance)
+{
+  if (distance >= distances[k - 1] ||
+      std::find(neighbors, neighbors + k, neighbor) != neighbors + k)
+    return false;
+
+  // Shift the further neighbors to make room.
+  size_t position = k - 1;
+  while (position > 0 && distances[position - 1] > distance)
+  {
+    neighbors[position] = neighbors[position - 1];
+    distances[position] = distances[position - 1];
+    isNew[position] = isNew[position - 1];
+    --position;
+  }
+
+  neighbors[position] = neighbor;
+  distances[position] = distance;
+  isNew[position] = 1;
+  return true;
+}
+
+template<typename MetricType, typename MatType>
+size_t NNDescent<MetricType, MatType>::ApplyUpdates(
+    const std::vector<std::vector<Update>>& updates,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    std::vector<char>& isNew) const
+{
+  // Each chunk updates the points of its residue class, so no point is
+  // updated by two threads.
+  const size_t k = neighbors.n_rows;
+  const size_t numChunks = updates.size();
+  size_t updated = 0;
+  #pragma omp parallel for schedule(static) reduction(+:updated)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    for (size_t u = 0; u < numChunks; ++u)
+    {
+      for (const Update& update : updates[u])
+      {
+        if (update.point % numChunks != (size_t) c)
+          continue;
+
+        if (Insert(neighbors.colptr(update.point),
+            distances.colptr(update.point), &isNew[update.point * k], k,
+            update.neighbor, update.distance))
+          ++updated;
+      }
+    }
+  }
+
+  return updated;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -15,17 +15,24 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 
 namespace mlpack {
 namespace kernel {
 
 /**
- * Implementation of the kmeans sampling scheme.
+ * Implementation of the kmeans sampling scheme.  If sampleSize is not 0, the
+ * clustering is run on a uniform random sample of that many points of the
+ * dataset (without replacement) instead of the whole dataset, so that the
+ * cost of the selection does not grow with the size of the dataset.
  *
  * @tparam ClusteringType Type of clustering.
  * @tparam maxIterations Maximum number of iterations allowed before giving up.
+ * @tparam sampleSize Number of points to cluster (0 for all of them).
  */
-template<typename ClusteringType = kmeans::KMeans<>, size_t maxIterations = 5>
+template<typename ClusteringType = kmeans::KMeans<>,
+         size_t maxIterations = 5,
+         size_t sampleSize = 0>
 class KMeansSelection
 {
  public:
@@ -44,12 +51,41 @@ class KMeansSelection
 
     // Perform the K-Means clustering method.
     ClusteringType kmeans(maxIterations);
-    kmeans.Cluster(data, m, assignments, *centroids);
+    const size_t samples = std::max(sampleSize, m);
+    if (sampleSize == 0 || samples >= data.n_cols)
+    {
+      kmeans.Cluster(data, m, assignments, *centroids);
+    }
+    else
+    {
+      const arma::uvec ordering = arma::randperm(data.n_cols);
+      const arma::mat sample = data.cols(ordering.head(samples));
+      kmeans.Cluster(sample, m, assignments, *centroids);
+    }
 
     return centroids;
   }
 };
 
+/**
+ * A faster k-means selection: the centroids are initialized with k-means||
+ * and refined with mini-batch k-means steps, on a sample of at most
+ * sampleSize points.  The centroids are a little worse than those of full
+ * k-means, but selecting them costs much less than the Nystroem approximation
+ * itself.
+ *
+ * @tparam maxIterations Maximum number of mini-batch steps.
+ * @tparam sampleSize Number of points to cluster (0 for all of them).
+ */
+template<size_t maxIterations = 10, size_t sampleSize = 10000>
+using FastKMeansSelection = KMeansSelection<
+    kmeans::KMeans<metric::EuclideanDistance,
+                   kmeans::KMeansParallelInitialization,
+                   kmeans::MaxVarianceNewCluster,
+                   kmeans::MiniBatchKMeans>,
+    maxIterations,
+    sampleSize>;
+
 } // namespace kernel
 } // namespace mlpack
 
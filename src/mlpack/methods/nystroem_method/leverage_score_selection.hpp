@@ -0,0 +1,127 @@
+/**
+ * @file leverage_score_selection.hpp
+ *
+ * Select the points used by the Nystroem method with probabilities given by
+ * approximate ridge leverage scores of the kernel matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NYSTROEM_METHOD_LEVERAGE_SCORE_SELECTION_HPP
+#define MLPACK_METHODS_NYSTROEM_METHOD_LEVERAGE_SCORE_SELECTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Select m distinct points, each with probability proportional to its rank-m
+ * ridge leverage score in the kernel matrix.  Points with a high leverage score
+ * are poorly represented by the other points, so sampling them gives a better
+ * Nystroem approximation than uniform sampling, in particular for uneven data.
+ *
+ * The exact scores need the whole kernel matrix, so they are approximated in
+ * time linear in the number of points:
+ *
+ *  - A uniform sample of s = oversampling * m points is drawn.
+ *  - The kernel between all points and the sample gives Nystroem features B
+ *    for all points (an n x s kernel block).
+ *  - The score of point i is b_i^T (B^T B + lambda I)^-1 b_i, where lambda is
+ *    the sum of the eigenvalues of B^T B beyond the m largest, divided by m.
+ *
+ * Unlike the other selection policies, this one needs the kernel, so its
+ * Select() function takes it as an extra argument.  For more information, see
+ * the following paper:
+ *
+ * @code
+ * @inproceedings{musco2017recursive,
+ *   title={Recursive Sampling for the Nystr\"om Method},
+ *   author={Musco, C. and Musco, C.},
+ *   booktitle={Advances in Neural Information Processing Systems 30 (NIPS
+ *       2017)},
+ *   pages={3833--3845},
+ *   year={2017}
+ * }
+ * @endcode
+ *
+ * @tparam oversampling Size of the uniform sample, as a multiple of m.
+ */
+template<size_t oversampling = 4>
+class LeverageScoreSelection
+{
+ public:
+  /**
+   * Select the specified number of points in the dataset, with the given
+   * kernel.
+   *
+   * @param data Dataset to sample from.
+   * @param m Number of points to select.
+   * @param kernel Kernel to be used for computation.
+   * @return Indices of selected points from the dataset.
+   */
+  template<typename KernelType>
+  const static arma::Col<size_t> Select(const arma::mat& data,
+                                        const size_t m,
+                                        KernelType& kernel)
+  {
+    const size_t n = data.n_cols;
+    arma::Col<size_t> selectedPoints(std::min(m, n));
+    if (m >= n)
+    {
+      for (size_t i = 0; i < n; ++i)
+        selectedPoints[i] = i;
+      return selectedPoints;
+    }
+
+    // Compute the Nystroem features of all points from a uniform sample.
+    const size_t s = std::min(n, oversampling * m);
+    const arma::uvec ordering = arma::randperm(n);
+    const arma::mat sample = data.cols(ordering.head(s));
+
+    arma::mat sampleKernel, semiKernel;
+    KernelMatrix(sample, kernel, sampleKernel);
+    KernelMatrix(data, sample, kernel, semiKernel);
+
+    arma::vec eigval;
+    arma::mat eigvec;
+    arma::eig_sym(eigval, eigvec, sampleKernel);
+    const arma::uvec kept = arma::find(eigval > 1e-10 * eigval.max());
+    const arma::mat features = semiKernel * eigvec.cols(kept) *
+        arma::diagmat(1.0 / arma::sqrt(eigval.elem(kept)));
+
+    // The ridge is the part of the spectrum that m points cannot capture.
+    arma::vec sigma;
+    arma::mat v;
+    arma::eig_sym(sigma, v, features.t() * features);
+    double lambda = 0.0;
+    for (size_t i = 0; i + m < sigma.n_elem; ++i)
+      lambda += std::max(sigma[i], 0.0);
+    lambda = std::max(lambda / m, 1e-10 * sigma.max());
+
+    arma::mat weighted = arma::square(features * v);
+    weighted.each_row() /= arma::trans(sigma + lambda);
+    const arma::vec scores = arma::sum(weighted, 1);
+
+    // Draw m points without replacement with probabilities proportional to
+    // the scores: the points with the largest keys log(u) / score, with u
+    // uniform in (0, 1], are a weighted sample (Efraimidis and Spirakis, 2006).
+    arma::vec keys(n);
+    for (size_t i = 0; i < n; ++i)
+      keys[i] = std::log(1.0 - math::Random()) / std::max(scores[i], 1e-12);
+
+    const arma::uvec sorted = arma::sort_index(keys, "descend");
+    for (size_t i = 0; i < m; ++i)
+      selectedPoints[i] = sorted[i];
+
+    return selectedPoints;
+  }
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -16,7 +16,9 @@
 #define MLPACK_METHODS_NYSTROEM_METHOD_NYSTROEM_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include "kmeans_selection.hpp"
+#include "leverage_score_selection.hpp"
 
 namespace mlpack {
 namespace kernel {
@@ -69,6 +71,16 @@ class NystroemMethod
                        arma::mat& semiKernel);
 
  private:
+  /**
+   * Compute the kernel between all points and the selected points, in blocks
+   * of points that are processed in parallel.
+   *
+   * @param selectedData The selected points.
+   * @param semiKernel Matrix to store the semi-kernel matrix in.
+   */
+  void SemiKernelMatrix(const arma::mat& selectedData, arma::mat& semiKernel);
+
+
   //! The reference dataset.
   const arma::mat& data;
   //! The locally stored kernel, if it is necessary.
@@ -16,8 +16,35 @@
 // In case it hasn't been included yet.
 #include "nystroem_method.hpp"
 
+#include <mlpack/core/math/parallel_blocks.hpp>
+
 namespace mlpack {
 namespace kernel {
+namespace details {
+
+//! Select the points with a policy whose Select() function takes the kernel.
+template<typename PointSelectionPolicy, typename KernelType>
+auto SelectPoints(const arma::mat& data,
+                  const size_t rank,
+                  KernelType& kernel,
+                  int /* preferred */)
+    -> decltype(PointSelectionPolicy::Select(data, rank, kernel))
+{
+  return PointSelectionPolicy::Select(data, rank, kernel);
+}
+
+//! Select the points with a policy that does not need the kernel.
+template<typename PointSelectionPolicy, typename KernelType>
+auto SelectPoints(const arma::mat& data,
+                  const size_t rank,
+                  KernelType& /* kernel */,
+                  long /* fallback */)
+    -> decltype(PointSelectionPolicy::Select(data, rank))
+{
+  return PointSelectionPolicy::Select(data, rank);
+}
+
+} // namespace details
 
 template<typename KernelType, typename PointSelectionPolicy>
 NystroemMethod<KernelType, PointSelectionPolicy>::NystroemMethod(
@@ -36,17 +63,12 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& semiKernel)
 {
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(selectedData->col(i),
-                                         selectedData->col(j));
+  KernelMatrix(*selectedData, kernel, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected data and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         selectedData->col(j));
+  SemiKernelMatrix(*selectedData, semiKernel);
+
   // Clean the memory.
   delete selectedData;
 }
@@ -57,18 +79,35 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& miniKernel,
     arma::mat& semiKernel)
 {
+  const arma::mat selectedData =
+      data.cols(arma::conv_to<arma::uvec>::from(selectedPoints));
+
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(data.col(selectedPoints(i)),
-                                         data.col(selectedPoints(j)));
+  KernelMatrix(selectedData, kernel, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected points and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         data.col(selectedPoints(j)));
+  SemiKernelMatrix(selectedData, semiKernel);
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+void NystroemMethod<KernelType, PointSelectionPolicy>::SemiKernelMatrix(
+    const arma::mat& selectedData,
+    arma::mat& semiKernel)
+{
+  // There are few selected points, so the threads split the rows (the points
+  // of the dataset) instead of the columns.  Each block is a tile of rows of
+  // the output; the parallel loop inside KernelMatrixRule then runs serially.
+  semiKernel.set_size(data.n_cols, selectedData.n_cols);
+  math::ParallelColumnBlocks(data.n_cols,
+      [&](const size_t begin, const size_t end)
+      {
+        arma::mat block;
+        KernelMatrixRule<KernelType>::Evaluate(
+            details::ColumnAlias(data, begin, end), selectedData, kernel,
+            block);
+        semiKernel.rows(begin, end - 1) = block;
+      });
 }
 
 template<typename KernelType, typename PointSelectionPolicy>
@@ -77,8 +116,8 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::Apply(arma::mat& output)
   arma::mat miniKernel(rank, rank);
   arma::mat semiKernel(data.n_cols, rank);
 
-  GetKernelMatrix(PointSelectionPolicy::Select(data, rank), miniKernel,
-                  semiKernel);
+  GetKernelMatrix(details::SelectPoints<PointSelectionPolicy>(data, rank,
+      kernel, 0), miniKernel, semiKernel);
 
   // Singular value decomposition mini-kernel matrix.
   arma::mat U, V;
@@ -0,0 +1,202 @@
+/**
+ * @file incremental_svd_method.hpp
+ *
+ * Implementation of the incremental SVD policy for use in the Principal
+ * Components Analysis method.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the incremental SVD policy.  Each call to Apply() folds the
+ * given batch of points into the components and singular values of all the
+ * points seen so far (instead of decomposing the batch alone), with the
+ * sequential Karhunen-Loeve update of
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title={Incremental learning for robust visual tracking},
+ *   author={Ross, D.A. and Lim, J. and Lin, R.-S. and Yang, M.-H.},
+ *   journal={International Journal of Computer Vision},
+ *   volume={77},
+ *   number={1--3},
+ *   pages={125--141},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * which also updates the mean.  Only the rank components of the previous
+ * batches are kept, so memory does not grow with the number of points.  A
+ * forgetting factor below 1 downweights the previous batches at each update,
+ * which is useful to track data over a sliding window.
+ *
+ * The transformed data is the projection of the batch (centered with the mean
+ * of all the points) onto the updated components.  The data scaling of
+ * PCAType is not used: the batch itself is decomposed.
+ */
+class IncrementalSVDPolicy
+{
+ public:
+  /**
+   * Use the incremental SVD method to perform the principal components
+   * analysis (PCA).
+   *
+   * @param forgetting Weight of the previous batches at each update, between
+   *        0 (forget the previous batches) and 1 (Default: 1).
+   */
+  IncrementalSVDPolicy(const double forgetting = 1.0) :
+      forgetting(forgetting),
+      points(0.0)
+  {
+    if (forgetting < 0.0 || forgetting > 1.0)
+    {
+      throw std::invalid_argument("IncrementalSVDPolicy: forgetting factor "
+          "must be between 0 and 1!");
+    }
+  }
+
+  /**
+   * Fold the provided batch of points into the principal components analysis.
+   *
+   * @param data Data matrix (the new batch of points).
+   * @param centeredData Centered data matrix (ignored).
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition (number of components to keep).
+   */
+  void Apply(const arma::mat& data,
+             const arma::mat& /* centeredData */,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    if (points > 0.0 && data.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "IncrementalSVDPolicy::Apply(): the batch has " << data.n_rows
+          << " dimensions, but the previous batches had " << mean.n_elem
+          << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    const double batchPoints = data.n_cols;
+    const arma::vec batchMean = arma::mean(data, 1);
+    arma::mat centeredBatch = data;
+    centeredBatch.each_col() -= batchMean;
+
+    if (points == 0.0 || forgetting == 0.0)
+    {
+      // There is nothing to update; decompose the batch.
+      arma::mat v;
+      arma::svd_econ(u, s, v, centeredBatch, "left");
+      mean = batchMean;
+      points = batchPoints;
+    }
+    else
+    {
+      // The previous points count with the forgetting factor.
+      const double previousPoints = forgetting * points;
+      const double totalPoints = previousPoints + batchPoints;
+
+      // The centered batch, and a column for the shift of the mean.
+      arma::mat batch(data.n_rows, data.n_cols + 1);
+      batch.head_cols(data.n_cols) = centeredBatch;
+      batch.col(data.n_cols) = std::sqrt(previousPoints * batchPoints /
+          totalPoints) * (batchMean - mean);
+
+      // Split the batch into its projection onto the components and an
+      // orthonormal basis of the rest.
+      const arma::mat projection = u.t() * batch;
+      arma::mat residual = batch - u * projection;
+      arma::mat basis, r;
+      arma::qr_econ(basis, r, residual);
+
+      // Decompose the small matrix
+      //
+      //   [ f S   U^T B                ]
+      //   [ 0     basis^T (B - U U^T B) ],
+      //
+      // whose left singular vectors rotate [U basis].
+      const size_t k = u.n_cols;
+      arma::mat small(k + basis.n_cols, k + batch.n_cols, arma::fill::zeros);
+      small.submat(0, 0, k - 1, k - 1) = arma::diagmat(forgetting * s);
+      small.submat(0, k, k - 1, small.n_cols - 1) = projection;
+      small.submat(k, k, small.n_rows - 1, small.n_cols - 1) =
+          basis.t() * residual;
+
+      arma::mat smallU, smallV;
+      arma::svd_econ(smallU, s, smallV, small, "left");
+      u = arma::join_rows(u, basis) * smallU;
+
+      mean = (previousPoints * mean + batchPoints * batchMean) / totalPoints;
+      points = totalPoints;
+    }
+
+    // Keep only the requested number of components.
+    if (u.n_cols > rank)
+    {
+      u.shed_cols(rank, u.n_cols - 1);
+      s.shed_rows(rank, s.n_elem - 1);
+    }
+
+    eigvec = u;
+
+    // Now we must square the singular values to get the eigenvalues.
+    // In addition we must divide by the number of points, because the
+    // covariance matrix is X * X' / (N - 1).
+    eigVal = arma::square(s) / std::max(points - 1.0, 1.0);
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * data;
+    transformedData.each_col() -= arma::trans(eigvec) * mean;
+  }
+
+  //! Forget every batch seen so far.
+  void Reset()
+  {
+    points = 0.0;
+    mean.clear();
+    u.clear();
+    s.clear();
+  }
+
+  //! Get the forgetting factor.
+  double Forgetting() const { return forgetting; }
+  //! Modify the forgetting factor.
+  double& Forgetting() { return forgetting; }
+
+  //! Get the (weighted) number of points folded in so far.
+  double Points() const { return points; }
+  //! Get the mean of the points folded in so far.
+  const arma::vec& Mean() const { return mean; }
+
+ private:
+  //! Weight of the previous batches at each update.
+  double forgetting;
+  //! The (weighted) number of points folded in so far.
+  double points;
+  //! The mean of the points folded in so far.
+  arma::vec mean;
+  //! The kept left singular vectors (the components).
+  arma::mat u;
+  //! The kept singular values.
+  arma::vec s;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -77,6 +77,41 @@ class RandomizedSVDPolicy
     transformedData = arma::trans(eigvec) * centeredData;
   }
 
+  /**
+   * Apply Principal Component Analysis to the provided sparse data set using
+   * the randomized SVD.  The data is never centered explicitly, so its
+   * sparsity is kept.
+   *
+   * @param data Sparse data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::sp_mat& data,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    // This matrix will store the right singular values; we do not need them.
+    arma::mat v;
+
+    // Do singular value decomposition using the randomized SVD algorithm.
+    svd::RandomizedSVD rsvd(iteratedPower, maxIterations);
+    rsvd.Apply(data, eigvec, eigVal, v, rank);
+
+    // Now we must square the singular values to get the eigenvalues.
+    // In addition we must divide by the number of points, because the
+    // covariance matrix is X * X' / (N - 1).
+    eigVal %= eigVal / (data.n_cols - 1);
+
+    // Project the samples to the principals, subtracting the projected mean.
+    const arma::vec mean = arma::mat(arma::sum(data, 1)) / data.n_cols;
+    transformedData = arma::trans(eigvec) * data;
+    transformedData.each_col() -= arma::trans(eigvec) * mean;
+  }
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
@@ -69,6 +69,25 @@ class PCAType
              arma::mat& transformedData,
              arma::vec& eigVal);
 
+  /**
+   * Apply Principal Component Analysis to the provided sparse data set,
+   * keeping the given number of components.  The data is never centered
+   * explicitly, so its sparsity is kept; this is only available with
+   * decomposition policies that support sparse data (RandomizedSVDPolicy), and
+   * the data cannot be scaled.
+   *
+   * @param data Sparse data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Number of components to compute.
+   */
+  void Apply(const arma::sp_mat& data,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank);
+
   /**
    * Use PCA for dimensionality reduction on the given dataset. This will save
    * the newDimension largest principal components of the data and remove the
@@ -112,6 +131,11 @@ class PCAType
   //! the data when PCA is performed.
   bool& ScaleData() { return scaleData; }
 
+  //! Get the decomposition policy.
+  const DecompositionPolicy& Decomposition() const { return decomposition; }
+  //! Modify the decomposition policy.
+  DecompositionPolicy& Decomposition() { return decomposition; }
+
  private:
   //! Scaling the data is when we reduce the variance of each dimension to 1.
   void ScaleData(arma::mat& centeredData)
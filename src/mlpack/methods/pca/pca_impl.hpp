@@ -77,6 +77,43 @@ void PCAType<DecompositionPolicy>::Apply(const arma::mat& data,
   Apply(data, transformedData, eigVal, eigvec);
 }
 
+/**
+ * Apply Principal Component Analysis to the provided sparse data set.
+ *
+ * @param data - Sparse data matrix
+ * @param transformedData - Data with PCA applied
+ * @param eigVal - contains eigen values in a column vector
+ * @param eigvec - PCA Loadings/Coeffs/EigenVectors
+ * @param rank - Number of components to compute
+ */
+template<typename DecompositionPolicy>
+void PCAType<DecompositionPolicy>::Apply(const arma::sp_mat& data,
+                                         arma::mat& transformedData,
+                                         arma::vec& eigVal,
+                                         arma::mat& eigvec,
+                                         const size_t rank)
+{
+  if (scaleData)
+    Log::Fatal << "PCA::Apply(): sparse data cannot be scaled!" << endl;
+  if (rank == 0 || rank > data.n_rows)
+    Log::Fatal << "PCA::Apply(): rank (" << rank << ") must be between 1 and "
+        << "the dimensionality of the data (" << data.n_rows << ")!" << endl;
+
+  Timer::Start("pca");
+
+  decomposition.Apply(data, transformedData, eigVal, eigvec, rank);
+
+  // The decomposition may find more components than were asked for.
+  if (eigvec.n_cols > rank)
+  {
+    eigvec.shed_cols(rank, eigvec.n_cols - 1);
+    eigVal.shed_rows(rank, eigVal.n_elem - 1);
+    transformedData.shed_rows(rank, transformedData.n_rows - 1);
+  }
+
+  Timer::Stop("pca");
+}
+
 /**
  * Use PCA for dimensionality reduction on the given dataset.  This will save
  * the newDimension largest principal components of the data and remove the
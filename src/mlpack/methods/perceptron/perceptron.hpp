@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_PERCEPTRON_PERCEPTRON_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/parallel_blocks.hpp>
 
 #include "initialization_methods/zero_init.hpp"
 #include "initialization_methods/random_init.hpp"
@@ -116,6 +117,21 @@ class Perceptron
    */
   void Classify(const MatType& test, arma::Row<size_t>& predictedLabels);
 
+  /**
+   * Classify points of another element type, such as a single-precision
+   * arma::fmat.  The points are scored in their own precision against a copy
+   * of the weights converted once per call; for float points this halves the
+   * memory traffic and doubles the SIMD width of batch scoring.  The model
+   * itself is still trained and stored in double precision.
+   *
+   * @param test Testing data or data to classify.
+   * @param predictedLabels Vector to store the predicted classes after
+   *     classifying test.
+   */
+  template<typename ElemType>
+  void Classify(const arma::Mat<ElemType>& test,
+                arma::Row<size_t>& predictedLabels);
+
   /**
    * Serialize the perceptron.
    */
@@ -154,6 +170,12 @@ class Perceptron
 
   //! The biases for each class.
   arma::vec biases;
+
+  //! Classify the given points one block at a time, in the precision of the
+  //! points.
+  template<typename DataType>
+  void ClassifyBlocks(const DataType& test,
+                      arma::Row<size_t>& predictedLabels) const;
 };
 
 } // namespace perceptron
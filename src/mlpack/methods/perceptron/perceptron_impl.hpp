@@ -106,16 +106,53 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
+  ClassifyBlocks(test, predictedLabels);
+}
+
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+template<typename ElemType>
+void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
+    const arma::Mat<ElemType>& test,
+    arma::Row<size_t>& predictedLabels)
+{
+  ClassifyBlocks(test, predictedLabels);
+}
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; i++)
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+template<typename DataType>
+void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::
+ClassifyBlocks(const DataType& test, arma::Row<size_t>& predictedLabels) const
+{
+  typedef typename DataType::elem_type ElemType;
+
+  // Compute the outputs of one block of points at a time, and pick the class
+  // with the largest output of each point while the block is in cache.
+  const arma::Mat<ElemType> classWeights =
+      arma::conv_to<arma::Mat<ElemType>>::from(weights.t());
+  const arma::Col<ElemType> classBiases =
+      arma::conv_to<arma::Col<ElemType>>::from(biases);
+  predictedLabels.set_size(test.n_cols);
+  math::ParallelColumnBlocks(test.n_cols,
+      [&](const size_t begin, const size_t end)
   {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(0, i) = maxIndex;
-  }
+    arma::Mat<ElemType> outputs = classWeights * test.cols(begin, end - 1);
+    outputs.each_col() += classBiases;
+
+    arma::uword maxIndex = 0;
+    for (size_t i = 0; i < outputs.n_cols; i++)
+    {
+      outputs.unsafe_col(i).max(maxIndex);
+      predictedLabels(0, begin + i) = maxIndex;
+    }
+  });
 }
 
 /**
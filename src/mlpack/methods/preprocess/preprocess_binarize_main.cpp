@@ -13,6 +13,7 @@
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
 #include <mlpack/core/data/binarize.hpp>
+#include <mlpack/core/data/transform_stream.hpp>
 
 PROGRAM_INFO("Binarize Data", "This utility takes a dataset and binarizes the "
     "variables into either 0 or 1 given threshold. User can apply binarization "
@@ -38,7 +39,13 @@ PROGRAM_INFO("Binarize Data", "This utility takes a dataset and binarizes the "
     PRINT_DATASET("X") + ",  we could instead run"
     "\n\n" +
     PRINT_CALL("preprocess_binarize", "input", "X", "threshold", 5.0,
-        "dimension", 0, "output", "Y"));
+        "dimension", 0, "output", "Y") +
+    "\n\n"
+    "An input given as '-' is read from the standard input, and an output "
+    "given as '-' is written to the standard output, as CSV ('-.bin' or "
+    "'-.txt' select another format).  When both are text, the points are "
+    "binarized a batch at a time as they arrive, so the program can be piped "
+    "between other programs.");
 
 // Define parameters for data.
 PARAM_MATRIX_IN_REQ("input", "Input data matrix.", "i");
@@ -75,12 +82,45 @@ static void mlpackMain()
 
   RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
 
+  RequireParamValue<int>("dimension", [](int x) { return x >= 0; }, true,
+      "dimension to binarize must be nonnegative");
+
+  // Binarize the points as they are read from the standard input, if they
+  // don't need to be loaded whole.
+  if (CLI::HasParam("output") && data::CanTransformStream(
+      CLI::GetPrintableParam<arma::mat>("input"),
+      CLI::GetPrintableParam<arma::mat>("output")))
+  {
+    Timer::Start("binarize");
+    data::TransformCSVStream<arma::mat>(
+        CLI::GetPrintableParam<arma::mat>("input"),
+        CLI::GetPrintableParam<arma::mat>("output"),
+        [&](const arma::mat& batch, arma::mat& output)
+        {
+          if (!CLI::HasParam("dimension"))
+          {
+            data::Binarize<double>(batch, output, threshold);
+          }
+          else if (dimension < batch.n_rows)
+          {
+            data::Binarize<double>(batch, output, threshold, dimension);
+          }
+          else
+          {
+            Log::Fatal << "Invalid value of " << PRINT_PARAM_STRING(
+                "dimension") << " specified (" << dimension << "); dimension "
+                << "to binarize must be less than the number of dimensions of "
+                << "the input data (" << batch.n_rows << ")!" << endl;
+          }
+        });
+    Timer::Stop("binarize");
+    return;
+  }
+
   // Load the data.
   arma::mat input = std::move(CLI::GetParam<arma::mat>("input"));
   arma::mat output;
 
-  RequireParamValue<int>("dimension", [](int x) { return x >= 0; }, true,
-      "dimension to binarize must be nonnegative");
   std::ostringstream error;
   error << "dimension to binarize must be less than the number of dimensions "
       << "of the input data (" << input.n_rows << ")";
@@ -0,0 +1,155 @@
+/**
+ * @file preprocess_random_projection_main.cpp
+ *
+ * Project a dense or sparse dataset to fewer dimensions with a sparse random
+ * projection.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/load_svmlight.hpp>
+#include <mlpack/core/data/transform_stream.hpp>
+#include <mlpack/core/math/random_projection.hpp>
+
+PROGRAM_INFO("Random Projection", "This utility projects a dataset to fewer "
+    "dimensions with a sparse random matrix, which preserves the distances "
+    "between the points up to a small distortion with high probability.  Each "
+    "element of the matrix is nonzero with the probability given by " +
+    PRINT_PARAM_STRING("density") + ": 1/3 gives the projection of "
+    "Achlioptas, and the default (0) gives the very sparse random projection, "
+    "with the probability 1 / sqrt(d) for d-dimensional points.  The matrix is "
+    "generated on the fly from the " + PRINT_PARAM_STRING("seed") + " and "
+    "never stored, so this is suitable for points with millions of "
+    "dimensions."
+    "\n\n"
+    "The dataset is given either as a dense matrix with the " +
+    PRINT_PARAM_STRING("input") + " parameter, or as a sparse file in the "
+    "SVMLight format with the " + PRINT_PARAM_STRING("input_svmlight") +
+    " parameter (whose labels are ignored).  The number of dimensions of the "
+    "projected points is given by " + PRINT_PARAM_STRING("dimensionality") +
+    ", and the projected points may be saved with the " +
+    PRINT_PARAM_STRING("output") + " output parameter."
+    "\n\n"
+    "The projection may be saved with the " +
+    PRINT_PARAM_STRING("output_model") + " output parameter, and reused with "
+    "the " + PRINT_PARAM_STRING("input_model") + " parameter to project other "
+    "points of the same dimensionality (such as the query points of a nearest "
+    "neighbor search) in the same way."
+    "\n\n"
+    "For example, to project the sparse dataset '" +
+    PRINT_DATASET("X") + "' to 256 dimensions and save the result to " +
+    PRINT_DATASET("Y") + " and the projection to " +
+    PRINT_MODEL("projection") + ", we could run"
+    "\n\n" +
+    PRINT_CALL("preprocess_random_projection", "input_svmlight", "X.svm",
+        "dimensionality", 256, "output", "Y", "output_model", "projection") +
+    "\n\n"
+    "and then, to project the query points '" + PRINT_DATASET("Q") + "' in "
+    "the same way,"
+    "\n\n" +
+    PRINT_CALL("preprocess_random_projection", "input_svmlight", "Q.svm",
+        "input_model", "projection", "output", "Z") +
+    "\n\n"
+    "A dense input given as '-' is read from the standard input, and an "
+    "output given as '-' is written to the standard output, as CSV ('-.bin' "
+    "or '-.txt' select another format).  When both are text, the points are "
+    "projected a batch at a time as they arrive, so the program can be piped "
+    "between other programs.");
+
+// Define parameters for data.
+PARAM_MATRIX_IN("input", "Input dense data matrix.", "i");
+PARAM_STRING_IN("input_svmlight", "File containing a sparse dataset in the "
+    "SVMLight format (instead of the input matrix).", "I", "");
+PARAM_MATRIX_OUT("output", "Matrix in which to save the projected points.",
+    "o");
+
+// Define the parameters of the projection.
+PARAM_INT_IN("dimensionality", "Number of dimensions of the projected points.",
+    "k", 0);
+PARAM_DOUBLE_IN("density", "Probability that an element of the projection "
+    "matrix is nonzero (0 means 1 / sqrt(d)).", "D", 0.0);
+PARAM_INT_IN("seed", "Random seed of the projection.  If 0, 'std::time(NULL)' "
+    "is used.", "s", 0);
+
+// Model loading/saving.
+PARAM_MODEL_IN(mlpack::math::RandomProjection, "input_model", "Existing "
+    "projection.", "m");
+PARAM_MODEL_OUT(mlpack::math::RandomProjection, "output_model", "Output for "
+    "the projection.", "M");
+
+using namespace mlpack;
+using namespace mlpack::math;
+using namespace mlpack::util;
+using namespace std;
+
+static void mlpackMain()
+{
+  RequireOnlyOnePassed({ "input", "input_svmlight" }, true);
+  RequireAtLeastOnePassed({ "output", "output_model" }, false,
+      "no output will be saved");
+  ReportIgnoredParam({{ "input_model", true }}, "dimensionality");
+  ReportIgnoredParam({{ "input_model", true }}, "density");
+  ReportIgnoredParam({{ "input_model", true }}, "seed");
+
+  RandomProjection* projection;
+  if (CLI::HasParam("input_model"))
+  {
+    projection = CLI::GetParam<RandomProjection*>("input_model");
+  }
+  else
+  {
+    RequireAtLeastOnePassed({ "dimensionality" }, true);
+    RequireParamValue<int>("dimensionality", [](int x) { return x > 0; }, true,
+        "dimensionality must be positive");
+    RequireParamValue<double>("density",
+        [](double x) { return x >= 0.0 && x <= 1.0; }, true,
+        "density must be between 0 and 1");
+
+    const uint64_t seed = (CLI::GetParam<int>("seed") != 0) ?
+        (uint64_t) CLI::GetParam<int>("seed") : (uint64_t) std::time(NULL);
+    projection = new RandomProjection(
+        (size_t) CLI::GetParam<int>("dimensionality"),
+        CLI::GetParam<double>("density"), seed);
+  }
+
+  arma::mat output;
+  Timer::Start("random_projection");
+  if (CLI::HasParam("input") && CLI::HasParam("output") &&
+      data::CanTransformStream(CLI::GetPrintableParam<arma::mat>("input"),
+      CLI::GetPrintableParam<arma::mat>("output")))
+  {
+    // Each point is projected on its own, so the points read from the
+    // standard input can be projected as they arrive.
+    data::TransformCSVStream<arma::mat>(
+        CLI::GetPrintableParam<arma::mat>("input"),
+        CLI::GetPrintableParam<arma::mat>("output"),
+        [&](const arma::mat& batch, arma::mat& projected)
+        {
+          projection->Transform(batch, projected);
+        });
+  }
+  else if (CLI::HasParam("input"))
+  {
+    const arma::mat input = std::move(CLI::GetParam<arma::mat>("input"));
+    projection->Transform(input, output);
+  }
+  else
+  {
+    arma::sp_mat input;
+    arma::rowvec labels;
+    data::LoadSVMLight(CLI::GetParam<string>("input_svmlight"), input, labels,
+        true);
+    projection->Transform(input, output);
+  }
+  Timer::Stop("random_projection");
+
+  if (CLI::HasParam("output"))
+    CLI::GetParam<arma::mat>("output") = std::move(output);
+
+  CLI::GetParam<RandomProjection*>("output_model") = projection;
+}
@@ -13,6 +13,7 @@
 #include "radical.hpp"
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
+#include <mlpack/core/math/random.hpp>
 
 using namespace std;
 using namespace arma;
@@ -45,51 +46,45 @@ void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 
 double Radical::Vasicek(vec& z) const
 {
-  z = sort(z);
+  // Sort in place, to avoid allocating a sorted copy for every candidate.
+  std::sort(z.begin(), z.end());
 
-  // Apparently slower.
-  /*
-  vec logs = log(z.subvec(m, z.n_elem - 1) - z.subvec(0, z.n_elem - 1 - m));
-  //vec val = sum(log(z.subvec(m, nPoints - 1) - z.subvec(0, nPoints - 1 - m)));
-  return (double) sum(logs);
-  */
-
-  // Apparently faster.
   double sum = 0;
+  const double* values = z.memptr();
   uword range = z.n_elem - m;
   for (uword i = 0; i < range; i++)
   {
-    sum += log(z(i + m) - z(i));
+    sum += log(values[i + m] - values[i]);
   }
 
   return sum;
 }
 
 
-double Radical::DoRadical2D(const mat& matX)
+double Radical::BestAngle(const mat& perturbedX) const
 {
-  CopyAndPerturb(perturbed, matX);
-
-  mat::fixed<2, 2> matJacobi;
-
   vec values(angles);
 
-  for (size_t i = 0; i < angles; i++)
+  // The candidate angles are independent, so they are evaluated in parallel;
+  // each thread rotates into its own buffers.
+  #pragma omp parallel
   {
-    const double theta = (i / (double) angles) * M_PI / 2.0;
-    const double cosTheta = cos(theta);
-    const double sinTheta = sin(theta);
+    vec candidateY1(perturbedX.n_rows);
+    vec candidateY2(perturbedX.n_rows);
 
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) angles; i++)
+    {
+      const double theta = (i / (double) angles) * M_PI / 2.0;
+      const double cosTheta = cos(theta);
+      const double sinTheta = sin(theta);
 
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
+      // This is perturbedX times the Jacobi rotation matrix.
+      candidateY1 = cosTheta * perturbedX.col(0) - sinTheta * perturbedX.col(1);
+      candidateY2 = sinTheta * perturbedX.col(0) + cosTheta * perturbedX.col(1);
 
-    values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+      values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+    }
   }
 
   uword indOpt = 0;
@@ -98,6 +93,50 @@ double Radical::DoRadical2D(const mat& matX)
 }
 
 
+double Radical::DoRadical2D(const mat& matX)
+{
+  CopyAndPerturb(perturbed, matX);
+
+  return BestAngle(perturbed);
+}
+
+
+double Radical::Radical2DPair(const mat& matY,
+                              const size_t i,
+                              const size_t j,
+                              std::mt19937& generator) const
+{
+  // This is CopyAndPerturb() on columns i and j, with the given generator.
+  std::normal_distribution<double> noise(0.0, noiseStdDev);
+  const size_t nPoints = matY.n_rows;
+  mat perturbedX(replicates * nPoints, 2);
+  for (size_t d = 0; d < 2; d++)
+  {
+    const double* x = matY.colptr((d == 0) ? i : j);
+    double* y = perturbedX.colptr(d);
+    for (size_t r = 0; r < replicates; r++)
+      for (size_t k = 0; k < nPoints; k++)
+        y[r * nPoints + k] = x[k] + noise(generator);
+  }
+
+  return BestAngle(perturbedX);
+}
+
+
+// Rotate columns i and j of x, as x * J for the Jacobi rotation J by theta.
+static void RotateColumns(mat& x,
+                          const size_t i,
+                          const size_t j,
+                          const double theta)
+{
+  const double cosTheta = cos(theta);
+  const double sinTheta = sin(theta);
+  const vec colI = x.col(i);
+  x.col(i) = cosTheta * colI - sinTheta * x.col(j);
+  x.col(j) = sinTheta * colI + cosTheta * x.col(j);
+}
+
+
 void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
 {
   // matX is nPoints by nDims (although less intuitive than columns being
@@ -114,10 +153,8 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
     m = floor(sqrt((double) matX.n_rows));
 
   const size_t nDims = matX.n_cols;
-  const size_t nPoints = matX.n_rows;
 
   Timer::Start("radical_whiten_data");
-  mat matXWhitened;
   mat matWhitening;
   WhitenFeatureMajorMatrix(matX, matY, matWhitening);
   Timer::Stop("radical_whiten_data");
@@ -128,46 +165,68 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
   // and likely does a better job bouncing out of local optima.
   // GeneratePerturbedX(X, X);
 
-  // Initialize the unmixing matrix to the whitening matrix.
+  // Initialize the unmixing matrix to the whitening matrix; every rotation of
+  // matY is also applied to it, so that matY = matX * matW.
   Timer::Start("radical_do_radical");
   matW = matWhitening;
 
-  mat matYSubspace(nPoints, 2);
+  // Schedule the pairs of dimensions with the circle method: each of the
+  // rounds pairs every dimension with another one (or with the dummy
+  // dimension nDims, if nDims is odd), and every pair occurs in one round.
+  const size_t nSlots = nDims + (nDims % 2);
+  std::vector<std::vector<std::pair<size_t, size_t>>> rounds;
+  std::vector<size_t> slots(nSlots);
+  for (size_t k = 0; k < nSlots; k++)
+    slots[k] = k;
+  for (size_t r = 0; r + 1 < nSlots; r++)
+  {
+    std::vector<std::pair<size_t, size_t>> round;
+    for (size_t k = 0; k < nSlots / 2; k++)
+    {
+      const size_t a = slots[k];
+      const size_t b = slots[nSlots - 1 - k];
+      if (a < nDims && b < nDims)
+        round.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+    }
+    rounds.push_back(round);
 
-  mat matJ = eye(nDims, nDims);
+    // Keep the first slot fixed and rotate the others.
+    std::rotate(slots.begin() + 1, slots.end() - 1, slots.end());
+  }
 
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
 
-    for (size_t i = 0; i < nDims - 1; i++)
+    for (size_t r = 0; r < rounds.size(); r++)
     {
-      for (size_t j = i + 1; j < nDims; j++)
-      {
-        Log::Debug << "RADICAL 2D on dimensions " << i << " and " << j << "."
-            << std::endl;
-
-        matYSubspace.col(0) = matY.col(i);
-        matYSubspace.col(1) = matY.col(j);
-
-        const double thetaOpt = DoRadical2D(matYSubspace);
+      const std::vector<std::pair<size_t, size_t>>& round = rounds[r];
 
-        const double cosThetaOpt = cos(thetaOpt);
-        const double sinThetaOpt = sin(thetaOpt);
-
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
+      // Draw the seeds serially, so that the perturbations do not depend on
+      // the order in which the pairs are processed.
+      std::vector<size_t> seeds(round.size());
+      for (size_t p = 0; p < round.size(); p++)
+      {
+        Log::Debug << "RADICAL 2D on dimensions " << round[p].first << " and "
+            << round[p].second << "." << std::endl;
+        seeds[p] = (size_t) math::RandInt(std::numeric_limits<int>::max());
+      }
 
-        matY *= matJ;
+      // The pairs of a round touch disjoint dimensions.  With a single pair,
+      // the candidate angles are evaluated in parallel instead.
+      std::vector<double> thetas(round.size());
+      #pragma omp parallel for schedule(dynamic) if (round.size() > 1)
+      for (omp_size_t p = 0; p < (omp_size_t) round.size(); p++)
+      {
+        std::mt19937 generator(seeds[p]);
+        thetas[p] = Radical2DPair(matY, round[p].first, round[p].second,
+            generator);
+      }
 
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+      for (size_t p = 0; p < round.size(); p++)
+      {
+        RotateColumns(matY, round[p].first, round[p].second, thetas[p]);
+        RotateColumns(matW, round[p].first, round[p].second, thetas[p]);
       }
     }
   }
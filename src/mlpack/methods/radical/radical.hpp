@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_RADICAL_RADICAL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <random>
 
 namespace mlpack {
 namespace radical {
@@ -63,7 +64,9 @@ class Radical
           const size_t m = 0);
 
   /**
-   * Run RADICAL.
+   * Run RADICAL.  Each sweep visits every pair of dimensions once, in rounds of
+   * disjoint pairs (a round-robin schedule); the pairs of a round are
+   * independent rotations, so they are processed in parallel.
    *
    * @param matX Input data into the algorithm - a matrix where each column is
    *    a point and each row is a dimension.
@@ -88,7 +91,12 @@ class Radical
    */
   void CopyAndPerturb(arma::mat& xNew, const arma::mat& x) const;
 
-  //! Two-dimensional version of RADICAL.
+  /**
+   * Two-dimensional version of RADICAL: perturb the given two-dimensional
+   * data (one point per row) and return the rotation angle that minimizes the
+   * sum of the entropies of the rotated dimensions.  The candidate angles are
+   * evaluated in parallel.
+   */
   double DoRadical2D(const arma::mat& matX);
 
   //! Get the standard deviation of the additive Gaussian noise.
@@ -131,8 +139,23 @@ class Radical
 
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
+
+  /**
+   * Return the angle among the candidate angles that minimizes the sum of the
+   * entropies of the two rotated dimensions of the given (already perturbed)
+   * data.
+   */
+  double BestAngle(const arma::mat& perturbedX) const;
+
+  /**
+   * Run Radical2D on dimensions i and j of the given (feature-major) data,
+   * drawing the perturbation with the given generator, so that several pairs
+   * of dimensions can be processed in parallel.
+   */
+  double Radical2DPair(const arma::mat& matY,
+                       const size_t i,
+                       const size_t j,
+                       std::mt19937& generator) const;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
@@ -8,6 +8,9 @@
 #ifndef MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 #define MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
 namespace mlpack {
 namespace tree {
 
@@ -25,23 +28,41 @@ void Bootstrap(const MatType& dataset,
                LabelsType& bootstrapLabels,
                WeightsType& bootstrapWeights)
 {
-  bootstrapDataset.set_size(dataset.n_rows, dataset.n_cols);
   bootstrapLabels.set_size(labels.n_elem);
   if (UseWeights)
     bootstrapWeights.set_size(weights.n_elem);
 
   // Random sampling with replacement.
-  arma::uvec indices = arma::randi<arma::uvec>(dataset.n_cols,
-      arma::distr_param(0, dataset.n_cols - 1));
+  const arma::uvec indices = math::RandIntegers(dataset.n_cols,
+      dataset.n_cols);
+  bootstrapDataset = dataset.cols(indices);
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
-    bootstrapDataset.col(i) = dataset.col(indices[i]);
     bootstrapLabels[i] = labels[indices[i]];
     if (UseWeights)
       bootstrapWeights[i] = weights[indices[i]];
   }
 }
 
+/**
+ * Draw a bootstrap sample of a dataset with the given number of points, as the
+ * number of times each point is sampled instead of a copy of the sampled
+ * points.  Only the points sampled at least once (about 63% of them) then have
+ * to be used for training, with their counts as weights.
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param counts Set to the number of times each point is sampled.
+ */
+inline void BootstrapCounts(const size_t numPoints, arma::uvec& counts)
+{
+  counts.zeros(numPoints);
+
+  // Random sampling with replacement.
+  const arma::uvec indices = math::RandIntegers(numPoints, numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    ++counts[indices[i]];
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -124,13 +124,17 @@ class RandomForest
    * @param numClasses Number of classes in dataset.
    * @param numTrees Number of trees in the forest.
    * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   * @param countBootstrap If true, train each tree on the points of its
+   *      bootstrap sample weighted by the number of times they are sampled,
+   *      instead of on a copy of the whole sample.
    */
   template<typename MatType>
   void Train(const MatType& data,
              const arma::Row<size_t>& labels,
              const size_t numClasses,
              const size_t numTrees = 50,
-             const size_t minimumLeafSize = 20);
+             const size_t minimumLeafSize = 20,
+             const bool countBootstrap = false);
 
   /**
    * Train the random forest on the given labeled training data with the given
@@ -144,6 +148,9 @@ class RandomForest
    * @param numClasses Number of classes in dataset.
    * @param numTrees Number of trees in the forest.
    * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   * @param countBootstrap If true, train each tree on the points of its
+   *      bootstrap sample weighted by the number of times they are sampled,
+   *      instead of on a copy of the whole sample.
    */
   template<typename MatType>
   void Train(const MatType& data,
@@ -151,7 +158,8 @@ class RandomForest
              const arma::Row<size_t>& labels,
              const size_t numClasses,
              const size_t numTrees = 50,
-             const size_t minimumLeafSize = 20);
+             const size_t minimumLeafSize = 20,
+             const bool countBootstrap = false);
 
   /**
    * Train the random forest on the given weighted labeled training data with
@@ -164,6 +172,9 @@ class RandomForest
    * @param weights Weights (importances) of each point in the dataset.
    * @param numTrees Number of trees in the forest.
    * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   * @param countBootstrap If true, train each tree on the points of its
+   *      bootstrap sample weighted by the number of times they are sampled,
+   *      instead of on a copy of the whole sample.
    */
   template<typename MatType>
   void Train(const MatType& data,
@@ -171,7 +182,8 @@ class RandomForest
              const size_t numClasses,
              const arma::rowvec& weights,
              const size_t numTrees = 50,
-             const size_t minimumLeafSize = 20);
+             const size_t minimumLeafSize = 20,
+             const bool countBootstrap = false);
 
   /**
    * Train the random forest on the given weighted labeled training data with
@@ -186,6 +198,9 @@ class RandomForest
    * @param weights Weights (importances) of each point in the dataset.
    * @param numTrees Number of trees in the forest.
    * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   * @param countBootstrap If true, train each tree on the points of its
+   *      bootstrap sample weighted by the number of times they are sampled,
+   *      instead of on a copy of the whole sample.
    */
   template<typename MatType>
   void Train(const MatType& data,
@@ -194,7 +209,8 @@ class RandomForest
              const size_t numClasses,
              const arma::rowvec& weights,
              const size_t numTrees = 50,
-             const size_t minimumLeafSize = 20);
+             const size_t minimumLeafSize = 20,
+             const bool countBootstrap = false);
 
   /**
    * Predict the class of the given point.  If the random forest has not been
@@ -271,6 +287,7 @@ class RandomForest
    * @param weights Weights for each point in the dataset (may be ignored).
    * @param numTrees Number of trees in the forest.
    * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param countBootstrap Whether to train on the bootstrap sample counts.
    * @tparam UseWeights Whether or not to use the weights parameter.
    * @tparam UseDatasetInfo Whether or not to use the datasetInfo parameter.
    * @tparam MatType The type of data matrix (i.e. arma::mat).
@@ -282,7 +299,46 @@ class RandomForest
              const size_t numClasses,
              const arma::rowvec& weights,
              const size_t numTrees,
-             const size_t minimumLeafSize);
+             const size_t minimumLeafSize,
+             const bool countBootstrap);
+
+  /**
+   * Train the given tree with the type information of each dimension (for
+   * std::true_type) or on numeric data (for std::false_type).  The overloads
+   * make sure that only the training that is used is instantiated, so that
+   * trees can also be trained on a data::MixedDataset.
+   *
+   * @param tree Tree to train.
+   * @param data Dataset to train on.
+   * @param datasetInfo Dimension information for the dataset (may be ignored).
+   * @param labels Labels for the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights for each point in the dataset (may be ignored).
+   * @param useWeights Whether or not to use the weights.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   */
+  template<typename MatType, typename LabelsType, typename WeightsType>
+  static void TrainTree(DecisionTreeType& tree,
+                        MatType&& data,
+                        const data::DatasetInfo& datasetInfo,
+                        LabelsType&& labels,
+                        const size_t numClasses,
+                        WeightsType&& weights,
+                        const bool useWeights,
+                        const size_t minimumLeafSize,
+                        const std::true_type /* useDatasetInfo */);
+
+  //! Train the given tree on numeric data (see the other overload).
+  template<typename MatType, typename LabelsType, typename WeightsType>
+  static void TrainTree(DecisionTreeType& tree,
+                        MatType&& data,
+                        const data::DatasetInfo& datasetInfo,
+                        LabelsType&& labels,
+                        const size_t numClasses,
+                        WeightsType&& weights,
+                        const bool useWeights,
+                        const size_t minimumLeafSize,
+                        const std::false_type /* useDatasetInfo */);
 
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
@@ -37,7 +37,7 @@ RandomForest<
   data::DatasetInfo info; // Ignored.
   arma::rowvec weights; // Fake weights, not used.
   Train<false, false>(dataset, info, labels, numClasses, weights, numTrees,
-      minimumLeafSize);
+      minimumLeafSize, false);
 }
 
 template<
@@ -64,7 +64,7 @@ RandomForest<
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
   Train<false, true>(dataset, datasetInfo, labels, numClasses, weights,
-      numTrees, minimumLeafSize);
+      numTrees, minimumLeafSize, false);
 }
 
 template<
@@ -91,7 +91,7 @@ RandomForest<
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored by Train().
   Train<true, false>(dataset, info, labels, numClasses, weights, numTrees,
-      minimumLeafSize);
+      minimumLeafSize, false);
 }
 
 template<
@@ -118,7 +118,7 @@ RandomForest<
 {
   // Pass off work to the Train() method.
   Train<true, true>(dataset, datasetInfo, labels, numClasses, weights, numTrees,
-      minimumLeafSize);
+      minimumLeafSize, false);
 }
 
 template<
@@ -139,13 +139,14 @@ void RandomForest<
          const arma::Row<size_t>& labels,
          const size_t numClasses,
          const size_t numTrees,
-         const size_t minimumLeafSize)
+         const size_t minimumLeafSize,
+         const bool countBootstrap)
 {
   // Pass off to Train().
   data::DatasetInfo info; // Ignored by Train().
   arma::rowvec weights; // Ignored by Train().
   Train<false, false>(dataset, info, labels, numClasses, weights, numTrees,
-      minimumLeafSize);
+      minimumLeafSize, countBootstrap);
 }
 
 template<
@@ -167,12 +168,13 @@ void RandomForest<
          const arma::Row<size_t>& labels,
          const size_t numClasses,
          const size_t numTrees,
-         const size_t minimumLeafSize)
+         const size_t minimumLeafSize,
+         const bool countBootstrap)
 {
   // Pass off to Train().
   arma::rowvec weights; // Ignored by Train().
   Train<false, true>(dataset, datasetInfo, labels, numClasses, weights,
-      numTrees, minimumLeafSize);
+      numTrees, minimumLeafSize, countBootstrap);
 }
 
 template<
@@ -194,12 +196,13 @@ void RandomForest<
          const size_t numClasses,
          const arma::rowvec& weights,
          const size_t numTrees,
-         const size_t minimumLeafSize)
+         const size_t minimumLeafSize,
+         const bool countBootstrap)
 {
   // Pass off to Train().
   data::DatasetInfo info; // Ignored by Train().
-  Train<false, true>(dataset, info, labels, numClasses, weights, numTrees,
-      minimumLeafSize);
+  Train<true, false>(dataset, info, labels, numClasses, weights, numTrees,
+      minimumLeafSize, countBootstrap);
 }
 
 template<
@@ -222,11 +225,12 @@ void RandomForest<
          const size_t numClasses,
          const arma::rowvec& weights,
          const size_t numTrees,
-         const size_t minimumLeafSize)
+         const size_t minimumLeafSize,
+         const bool countBootstrap)
 {
   // Pass off to Train().
   Train<true, true>(dataset, datasetInfo, labels, numClasses, weights, numTrees,
-      minimumLeafSize);
+      minimumLeafSize, countBootstrap);
 }
 
 template<
@@ -422,14 +426,42 @@ void RandomForest<
          const size_t numClasses,
          const arma::rowvec& weights,
          const size_t numTrees,
-         const size_t minimumLeafSize)
+         const size_t minimumLeafSize,
+         const bool countBootstrap)
 {
   // Train each tree individually.
   trees.resize(numTrees); // This will fill the vector with untrained trees.
 
-  #pragma omp parallel for
+  // If there are fewer trees than threads, train the trees one at a time, so
+  // that each tree is built with all of the threads instead.
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+    threads = omp_get_max_threads();
+  #endif
+
+  #pragma omp parallel for if (numTrees >= threads)
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
+    if (countBootstrap)
+    {
+      // Only copy the points sampled at least once, and weight each by the
+      // number of times it was sampled.  The copies are moved into the tree,
+      // so they are not copied again.
+      arma::uvec counts;
+      BootstrapCounts(dataset.n_cols, counts);
+      const arma::uvec sampled = arma::find(counts);
+      arma::rowvec sampleWeights = arma::conv_to<arma::rowvec>::from(
+          counts.elem(sampled));
+      if (UseWeights)
+        sampleWeights %= weights.elem(sampled).t();
+
+      TrainTree(trees[i], MatType(dataset.cols(sampled)), datasetInfo,
+          arma::Row<size_t>(labels.elem(sampled).t()), numClasses,
+          std::move(sampleWeights), true, minimumLeafSize,
+          std::integral_constant<bool, UseDatasetInfo>());
+      continue;
+    }
+
     MatType bootstrapDataset;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
@@ -437,30 +469,82 @@ void RandomForest<
         bootstrapLabels, bootstrapWeights);
 
     // Now build the decision tree.
-    if (UseWeights)
-    {
-      if (UseDatasetInfo)
-      {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses, weights,
-            minimumLeafSize);
-      }
-      else
-      {
-        trees[i].Train(dataset, labels, numClasses, weights, minimumLeafSize);
-      }
-    }
-    else
-    {
-      if (UseDatasetInfo)
-      {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses,
-            minimumLeafSize);
-      }
-      else
-      {
-        trees[i].Train(dataset, labels, numClasses, minimumLeafSize);
-      }
-    }
+    TrainTree(trees[i], dataset, datasetInfo, labels, numClasses, weights,
+        UseWeights, minimumLeafSize,
+        std::integral_constant<bool, UseDatasetInfo>());
+  }
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType, typename LabelsType, typename WeightsType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::TrainTree(DecisionTreeType& tree,
+             MatType&& data,
+             const data::DatasetInfo& datasetInfo,
+             LabelsType&& labels,
+             const size_t numClasses,
+             WeightsType&& weights,
+             const bool useWeights,
+             const size_t minimumLeafSize,
+             const std::true_type /* useDatasetInfo */)
+{
+  if (useWeights)
+  {
+    tree.Train(std::forward<MatType>(data), datasetInfo,
+        std::forward<LabelsType>(labels), numClasses,
+        std::forward<WeightsType>(weights), minimumLeafSize);
+  }
+  else
+  {
+    tree.Train(std::forward<MatType>(data), datasetInfo,
+        std::forward<LabelsType>(labels), numClasses, minimumLeafSize);
+  }
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType, typename LabelsType, typename WeightsType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::TrainTree(DecisionTreeType& tree,
+             MatType&& data,
+             const data::DatasetInfo& /* datasetInfo */,
+             LabelsType&& labels,
+             const size_t numClasses,
+             WeightsType&& weights,
+             const bool useWeights,
+             const size_t minimumLeafSize,
+             const std::false_type /* useDatasetInfo */)
+{
+  if (useWeights)
+  {
+    tree.Train(std::forward<MatType>(data), std::forward<LabelsType>(labels),
+        numClasses, std::forward<WeightsType>(weights), minimumLeafSize);
+  }
+  else
+  {
+    tree.Train(std::forward<MatType>(data), std::forward<LabelsType>(labels),
+        numClasses, minimumLeafSize);
   }
 }
 
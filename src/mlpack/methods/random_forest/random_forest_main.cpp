@@ -7,6 +7,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
+#include <mlpack/core/data/transform_stream.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
 
 using namespace mlpack;
@@ -20,6 +21,13 @@ PROGRAM_INFO("Random forests",
     "trained and saved for later use, or a random forest may be loaded "
     "and predictions or class probabilities for points may be generated."
     "\n\n"
+    "A test set given as '-' is read from the standard input, and an output "
+    "given as '-' is written to the standard output, as CSV ('-.bin' or "
+    "'-.txt' select another format).  When the test set is read from the "
+    "standard input as text and only one text output is requested (without "
+    "test labels), the points are classified a batch at a time as they "
+    "arrive, so the program can be piped between other programs."
+    "\n\n"
     "This documentation will be rewritten once #880 is merged.");
 
 PARAM_MATRIX_IN("training", "Training dataset.", "t");
@@ -144,7 +152,40 @@ static void mlpackMain()
     rfModel = CLI::GetParam<RandomForestModel*>("input_model");
   }
 
-  if (CLI::HasParam("test"))
+  // Only one output can be written a batch at a time.
+  string streamOutput;
+  if (CLI::HasParam("predictions") != CLI::HasParam("probabilities") &&
+      !CLI::HasParam("test_labels"))
+  {
+    streamOutput = CLI::HasParam("predictions") ?
+        CLI::GetPrintableParam<arma::Row<size_t>>("predictions") :
+        CLI::GetPrintableParam<arma::mat>("probabilities");
+  }
+
+  if (CLI::HasParam("test") && data::CanTransformStream(
+      CLI::GetPrintableParam<arma::mat>("test"), streamOutput))
+  {
+    // Classify the test set as it is read from the standard input.
+    const string testName = CLI::GetPrintableParam<arma::mat>("test");
+    if (CLI::HasParam("predictions"))
+    {
+      data::TransformCSVStream<arma::Row<size_t>>(testName, streamOutput,
+          [&](const arma::mat& batch, arma::Row<size_t>& predictions)
+          {
+            rfModel->rf.Classify(batch, predictions);
+          });
+    }
+    else
+    {
+      data::TransformCSVStream<arma::mat>(testName, streamOutput,
+          [&](const arma::mat& batch, arma::mat& probabilities)
+          {
+            arma::Row<size_t> predictions;
+            rfModel->rf.Classify(batch, predictions, probabilities);
+          });
+    }
+  }
+  else if (CLI::HasParam("test"))
   {
     arma::mat testData = std::move(CLI::GetParam<arma::mat>("test"));
 
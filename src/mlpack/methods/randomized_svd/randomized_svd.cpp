@@ -47,17 +47,20 @@ RandomizedSVD::RandomizedSVD(const size_t iteratedPower,
   /* Nothing to do here */
 }
 
-void RandomizedSVD::Apply(const arma::mat& data,
-                          arma::mat& u,
-                          arma::vec& s,
-                          arma::mat& v,
-                          const size_t rank)
+template<typename MatType>
+void RandomizedSVD::ApplyImpl(const MatType& data,
+                              arma::mat& u,
+                              arma::vec& s,
+                              arma::mat& v,
+                              const size_t rank)
 {
   if (iteratedPower == 0)
     iteratedPower = rank + 2;
 
-  // Center the data into a temporary matrix.
-  arma::vec rowMean = arma::sum(data, 1) / data.n_cols + eps;
+  // The data is never centered explicitly; instead, the mean is subtracted
+  // from each product with the data.  (The sum of sparse data is sparse, so it
+  // is converted.)
+  arma::vec rowMean = arma::mat(arma::sum(data, 1)) / data.n_cols + eps;
 
   arma::mat R, Q, Qdata;
 
@@ -132,5 +135,23 @@ void RandomizedSVD::Apply(const arma::mat& data,
   }
 }
 
+void RandomizedSVD::Apply(const arma::mat& data,
+                          arma::mat& u,
+                          arma::vec& s,
+                          arma::mat& v,
+                          const size_t rank)
+{
+  ApplyImpl(data, u, s, v, rank);
+}
+
+void RandomizedSVD::Apply(const arma::sp_mat& data,
+                          arma::mat& u,
+                          arma::vec& s,
+                          arma::mat& v,
+                          const size_t rank)
+{
+  ApplyImpl(data, u, s, v, rank);
+}
+
 } // namespace svd
 } // namespace mlpack
@@ -120,6 +120,57 @@ class RandomizedSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Apply Principal Component Analysis to the provided sparse data set using
+   * the randomized SVD.  As for dense data, the data is centered implicitly
+   * (the mean is subtracted inside the products with the data), so the
+   * sparsity of the data is kept.
+   *
+   * @param data Sparse data matrix.
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param sigma Diagonal matrix of singular values.
+   * @param rank Rank of the approximation.
+   */
+  void Apply(const arma::sp_mat& data,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank);
+
+  /**
+   * Compute the left singular vectors and the singular values of the centered
+   * data, reading the data in blocks of columns, so that the data never has to
+   * be held in memory at once.  The data is read once to sketch its range and
+   * compute its mean, and then once for each power iteration (at least once);
+   * only matrices with as many rows as the data and IteratedPower() columns are
+   * held in memory.  The right singular vectors are not computed, since they
+   * have as many rows as the data has columns.
+   *
+   * The BlockSourceType class must provide the following:
+   *
+   * @code
+   * // The type of the blocks (for instance arma::mat or arma::sp_mat).
+   * typedef ... MatType;
+   * // The number of rows of the data.
+   * size_t Rows() const;
+   * // The number of blocks of columns.
+   * size_t NumBlocks() const;
+   * // Read the given block of columns.
+   * void Block(const size_t index, MatType& block);
+   * @endcode
+   *
+   * @param source Source of the blocks of columns of the data.
+   * @param u Left singular vectors.
+   * @param s Singular values.
+   * @param rank Rank of the approximation.
+   */
+  template<typename BlockSourceType>
+  void ApplyBlocks(BlockSourceType& source,
+                   arma::mat& u,
+                   arma::vec& s,
+                   const size_t rank);
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
@@ -144,9 +195,20 @@ class RandomizedSVD
 
   //! The value used for numerical stability.
   double eps;
+
+  //! Apply the randomized SVD to the given dense or sparse data.
+  template<typename MatType>
+  void ApplyImpl(const MatType& data,
+                 arma::mat& u,
+                 arma::vec& s,
+                 arma::mat& v,
+                 const size_t rank);
 };
 
 } // namespace svd
 } // namespace mlpack
 
+// Include implementation.
+#include "randomized_svd_impl.hpp"
+
 #endif
@@ -0,0 +1,108 @@
+/**
+ * @file randomized_svd_impl.hpp
+ *
+ * Implementation of the randomized SVD method on data read in blocks of
+ * columns.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_IMPL_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "randomized_svd.hpp"
+
+namespace mlpack {
+namespace svd {
+
+template<typename BlockSourceType>
+void RandomizedSVD::ApplyBlocks(BlockSourceType& source,
+                                arma::mat& u,
+                                arma::vec& s,
+                                const size_t rank)
+{
+  typedef typename BlockSourceType::MatType MatType;
+
+  const size_t dimensions = source.Rows();
+  const size_t sketchSize = std::max(rank,
+      (iteratedPower == 0) ? rank + 2 : iteratedPower);
+
+  // First pass: sketch the range of the data with a random matrix that is
+  // generated one block at a time, and compute the mean.  Since the mean is
+  // only known at the end, the sketch of the centered data is
+  // X * omega - mean * (1^T omega).
+  arma::mat y(dimensions, sketchSize, arma::fill::zeros);
+  arma::vec total(dimensions, arma::fill::zeros);
+  arma::rowvec omegaSum(sketchSize, arma::fill::zeros);
+  size_t points = 0;
+
+  MatType block;
+  for (size_t b = 0; b < source.NumBlocks(); ++b)
+  {
+    source.Block(b, block);
+
+    const arma::mat omega = arma::randn<arma::mat>(block.n_cols, sketchSize);
+    y += block * omega;
+    total += arma::mat(arma::sum(block, 1));
+    omegaSum += arma::sum(omega, 0);
+    points += block.n_cols;
+  }
+
+  if (points == 0)
+  {
+    throw std::invalid_argument("RandomizedSVD::ApplyBlocks(): the blocks hold "
+        "no points!");
+  }
+
+  const arma::vec mean = total / points;
+  y -= mean * omegaSum;
+
+  // Power iterations: each one reads the data once, to compute
+  // (X - mean 1^T) (X - mean 1^T)^T Q block by block.  There is always at
+  // least one, since the last one also gives the projected covariance.
+  arma::mat q, r;
+  const size_t passes = std::max(maxIterations, (size_t) 1);
+  for (size_t i = 0; i < passes; ++i)
+  {
+    arma::qr_econ(q, r, y);
+    const arma::rowvec meanQ = mean.t() * q;
+
+    y.zeros(dimensions, q.n_cols);
+    for (size_t b = 0; b < source.NumBlocks(); ++b)
+    {
+      source.Block(b, block);
+
+      arma::mat z = block.t() * q;
+      z.each_row() -= meanQ;
+      y += block * z - mean * arma::sum(z, 0);
+    }
+  }
+
+  // Rayleigh-Ritz: Q^T Y is the covariance projected onto Q, whose eigenvalues
+  // are the squared singular values.
+  arma::mat projected = q.t() * y;
+  projected = 0.5 * (projected + projected.t());
+
+  arma::vec eigval;
+  arma::mat eigvec;
+  arma::eig_sym(eigval, eigvec, projected);
+
+  // The eigenvalues are in ascending order.
+  const size_t k = std::min(rank, (size_t) eigval.n_elem);
+  s.set_size(k);
+  u.set_size(dimensions, k);
+  for (size_t i = 0; i < k; ++i)
+  {
+    const size_t index = eigval.n_elem - 1 - i;
+    s[i] = std::sqrt(std::max(eigval[index], 0.0));
+    u.col(i) = q * eigvec.col(index);
+  }
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
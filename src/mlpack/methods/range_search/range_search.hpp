@@ -16,7 +16,9 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/search_context.hpp>
 #include "range_search_stat.hpp"
+#include "range_search_results.hpp"
 
 namespace mlpack {
 namespace range /** Range-search routines. */ {
@@ -224,6 +226,63 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, like the Search() overload above, but without modifying this
+   * object: the number of base cases and scores are stored in the given context
+   * instead.  Any number of threads may call this at the same time on the same
+   * object, each with its own context, as long as the object is not modified
+   * meanwhile.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param neighbors Object which will hold the list of neighbors for each
+   *      point which fell into the given range, for each query point.
+   * @param distances Object which will hold the list of distances for each
+   *      point which fell into the given range, for each query point.
+   * @param context The state of this search.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances,
+              tree::SearchContext& context) const;
+
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, and pass each result to the given result policy instead of
+   * storing it in vectors.  CompactRangeResults stores all the results in flat
+   * arrays, CallbackRangeResults passes them to a function as they are found,
+   * and CountRangeResults only counts them; see range_search_results.hpp for
+   * the API of a result policy.  The indices given to the policy are those of
+   * the original query and reference sets.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param results Result policy the results are passed to.
+   */
+  template<typename ResultType>
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              ResultType& results);
+
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set and pass the results to the given result policy, like the
+   * Search() overload above, but without modifying this object; see the
+   * Search() overload that takes vectors and a context.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param results Result policy the results are passed to.
+   * @param context The state of this search.
+   */
+  template<typename ResultType>
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              ResultType& results,
+              tree::SearchContext& context) const;
+
   /**
    * Given a pre-built query tree, search for all reference points in the given
    * range for each point in the query set, returning the results in the
@@ -265,6 +324,20 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Given a pre-built query tree, search for all reference points in the given
+   * range for each point in the query set, and pass the results to the given
+   * result policy.  See the Search() overloads above.
+   *
+   * @param queryTree Tree built on query points.
+   * @param range Range of distances in which to search.
+   * @param results Result policy the results are passed to.
+   */
+  template<typename ResultType>
+  void Search(Tree* queryTree,
+              const math::Range& range,
+              ResultType& results);
+
   /**
    * Search for all points in the given range for each point in the reference
    * set (which was passed to the constructor), returning the results in the
@@ -299,6 +372,49 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, like the Search() overload above, but without modifying this object,
+   * so that several threads can search at the same time; see the Search()
+   * overload that takes a query set and a context.
+   *
+   * @param range Range of distances in which to search.
+   * @param neighbors Object which will hold the list of neighbors for each
+   *      point which fell into the given range, for each query point.
+   * @param distances Object which will hold the list of distances for each
+   *      point which fell into the given range, for each query point.
+   * @param context The state of this search.
+   */
+  void Search(const math::Range& range,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances,
+              tree::SearchContext& context) const;
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, and pass the results to the given result policy.  See the Search()
+   * overloads that take a query set and a result policy.
+   *
+   * @param range Range of distances in which to search.
+   * @param results Result policy the results are passed to.
+   */
+  template<typename ResultType>
+  void Search(const math::Range& range, ResultType& results);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set and pass the results to the given result policy, without modifying
+   * this object.
+   *
+   * @param range Range of distances in which to search.
+   * @param results Result policy the results are passed to.
+   * @param context The state of this search.
+   */
+  template<typename ResultType>
+  void Search(const math::Range& range,
+              ResultType& results,
+              tree::SearchContext& context) const;
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -17,6 +17,7 @@
 
 // The rules for traversal.
 #include "range_search_rules.hpp"
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 namespace mlpack {
 namespace range {
@@ -386,6 +387,56 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     const math::Range& range,
     std::vector<std::vector<size_t>>& neighbors,
     std::vector<std::vector<double>>& distances)
+{
+  VectorRangeResults results(neighbors, distances);
+  Search(querySet, range, results);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    tree::SearchContext& context) const
+{
+  VectorRangeResults results(neighbors, distances);
+  Search(querySet, range, results, context);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    ResultType& results)
+{
+  tree::SearchContext context;
+  Search(querySet, range, results, context);
+
+  baseCases = context.BaseCases();
+  scores = context.Scores();
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    ResultType& results,
+    tree::SearchContext& context) const
 {
   if (querySet.n_rows != referenceSet->n_rows)
   {
@@ -396,77 +447,83 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     throw std::invalid_argument(oss.str());
   }
 
+  results.Reset(querySet.n_cols);
+
   // If there are no points, there is no search to be done.
   if (referenceSet->n_cols == 0)
+  {
+    results.Finish();
     return;
+  }
 
   Timer::Start("range_search/computing_neighbors");
 
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
 
-  // If we have built the trees ourselves, then we will have to map all the
-  // indices back to their original indices when this computation is finished.
-  // To avoid extra copies, we will store the unmapped neighbors and distances
-  // in a separate object.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<double>>* distancePtr = &distances;
-
-  // Mapping is only necessary if the tree rearranges points.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    // Query indices only need to be mapped if we are building the query tree
-    // ourselves.
-    if (!singleMode && !naive)
-    {
-      distancePtr = new std::vector<std::vector<double>>;
-      neighborPtr = new std::vector<std::vector<size_t>>;
-    }
-
-    // Reference indices only need to be mapped if we built the reference tree
-    // ourselves.
-    else if (treeOwner)
-      neighborPtr = new std::vector<std::vector<size_t>>;
-  }
-
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distancePtr->clear();
-  distancePtr->resize(querySet.n_cols);
+  // If we have built the reference tree ourselves and it rearranges the points,
+  // the indices of the results are mapped back to the original indices as they
+  // are found.
+  const std::vector<size_t>* referenceMapping =
+      (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset) ?
+      &oldFromNewReferences : NULL;
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
+  typedef MappedRangeResults<ResultType> MappedResultType;
+  typedef RangeSearchRules<MetricType, Tree, MappedResultType> RuleType;
 
   // Reset counts.
+  size_t& baseCases = context.BaseCases();
+  size_t& scores = context.Scores();
   baseCases = 0;
   scores = 0;
 
+  // The rules may modify the metric, so they get their own copy.
+  MetricType metric(this->metric);
+
   if (naive)
   {
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
+    MappedResultType mappedResults(results, NULL, referenceMapping);
+    RuleType rules(*referenceSet, querySet, range, mappedResults, metric);
 
-    // The naive brute-force solution.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    // The naive brute-force solution.  Every thread uses its own copy of the
+    // rules, which shares the result policy.
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          threadRules.BaseCase(i, j);
+    }
 
     baseCases += (querySet.n_cols * referenceSet->n_cols);
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    MappedResultType mappedResults(results, NULL, referenceMapping);
+    RuleType rules(*referenceSet, querySet, range, mappedResults, metric);
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // The queries are split across the threads; every thread uses its own
+    // copy of the rules, which shares the result policy.
+    size_t threadBaseCases = 0, threadScores = 0;
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+    {
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(
+          threadRules);
 
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadBaseCases += threadRules.BaseCases();
+      threadScores += threadRules.Scores();
+    }
+
+    baseCases += threadBaseCases;
+    scores += threadScores;
   }
   else // Dual-tree recursion.
   {
@@ -477,12 +534,16 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     Timer::Stop("range_search/tree_building");
     Timer::Start("range_search/computing_neighbors");
 
-    // Create the traverser.
-    RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-        *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    // Query indices only need to be mapped if the query tree rearranges them.
+    MappedResultType mappedResults(results,
+        tree::TreeTraits<Tree>::RearrangesDataset ? &oldFromNewQueries : NULL,
+        referenceMapping);
 
-    traverser.Traverse(*queryTree, *referenceTree);
+    // Create the traverser.
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, mappedResults,
+        metric);
+    tree::TraverseWithStatistics<Tree::template DualTreeTraverser>(rules,
+        *queryTree, *referenceTree, "range search");
 
     baseCases += rules.BaseCases();
     scores += rules.Scores();
@@ -491,73 +552,9 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     delete queryTree;
   }
 
-  Timer::Stop("range_search/computing_neighbors");
+  results.Finish();
 
-  // Map points back to original indices, if necessary.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    if (!singleMode && !naive && treeOwner)
-    {
-      // We must map both query and reference indices.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); i++)
-      {
-        // Map distances (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-
-        // Copy each neighbor individually, because we need to map it.
-        neighbors[queryMapping].resize(distances[queryMapping].size());
-        for (size_t j = 0; j < distances[queryMapping].size(); j++)
-          neighbors[queryMapping][j] =
-              oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (!singleMode && !naive)
-    {
-      // We must map query indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); ++i)
-      {
-        // Map distances and neighbors (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-        neighbors[queryMapping] = (*neighborPtr)[i];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (treeOwner)
-    {
-      // We must map reference indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < neighbors.size(); i++)
-      {
-        neighbors[i].resize((*neighborPtr)[i].size());
-        for (size_t j = 0; j < neighbors[i].size(); j++)
-          neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary object.
-      delete neighborPtr;
-    }
-  }
+  Timer::Stop("range_search/computing_neighbors");
 }
 
 template<typename MetricType,
@@ -571,64 +568,108 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     std::vector<std::vector<size_t>>& neighbors,
     std::vector<std::vector<double>>& distances)
 {
-  // If there are no points, there is no search to be done.
-  if (referenceSet->n_cols == 0)
-    return;
-
-  Timer::Start("range_search/computing_neighbors");
-
-  // Get a reference to the query set.
-  const MatType& querySet = queryTree->Dataset();
+  VectorRangeResults results(neighbors, distances);
+  Search(queryTree, range, results);
+}
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    Tree* queryTree,
+    const math::Range& range,
+    ResultType& results)
+{
   // Make sure we are in dual-tree mode.
   if (singleMode || naive)
     throw std::invalid_argument("cannot call RangeSearch::Search() with a "
         "query tree when naive or singleMode are set to true");
 
-  // We won't need to map query indices, but will we need to map distances?
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
+  // Get a reference to the query set.
+  const MatType& querySet = queryTree->Dataset();
 
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
-    neighborPtr = new std::vector<std::vector<size_t>>;
+  results.Reset(querySet.n_cols);
 
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distances.clear();
-  distances.resize(querySet.n_cols);
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+  {
+    results.Finish();
+    return;
+  }
+
+  Timer::Start("range_search/computing_neighbors");
+
+  // We won't need to map query indices, but we may need to map reference
+  // indices.
+  typedef MappedRangeResults<ResultType> MappedResultType;
+  MappedResultType mappedResults(results, NULL,
+      (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset) ?
+      &oldFromNewReferences : NULL);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-      distances, metric);
+  typedef RangeSearchRules<MetricType, Tree, MappedResultType> RuleType;
+  RuleType rules(*referenceSet, queryTree->Dataset(), range, mappedResults,
+      metric);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  // Traverse the trees.
+  tree::TraverseWithStatistics<Tree::template DualTreeTraverser>(rules,
+      *queryTree, *referenceTree, "range search");
 
-  traverser.Traverse(*queryTree, *referenceTree);
+  results.Finish();
 
   Timer::Stop("range_search/computing_neighbors");
 
   baseCases = rules.BaseCases();
   scores = rules.Scores();
+}
 
-  // Do we need to map indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    // We must map reference indices only.
-    neighbors.clear();
-    neighbors.resize(querySet.n_cols);
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
+{
+  VectorRangeResults results(neighbors, distances);
+  Search(range, results);
+}
 
-    for (size_t i = 0; i < neighbors.size(); i++)
-    {
-      neighbors[i].resize((*neighborPtr)[i].size());
-      for (size_t j = 0; j < neighbors[i].size(); j++)
-        neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-    }
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    tree::SearchContext& context) const
+{
+  VectorRangeResults results(neighbors, distances);
+  Search(range, results, context);
+}
 
-    // Finished with temporary object.
-    delete neighborPtr;
-  }
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    ResultType& results)
+{
+  tree::SearchContext context;
+  Search(range, results, context);
+
+  baseCases = context.BaseCases();
+  scores = context.Scores();
 }
 
 template<typename MetricType,
@@ -636,100 +677,93 @@ template<typename MetricType,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
+template<typename ResultType>
 void RangeSearch<MetricType, MatType, TreeType>::Search(
     const math::Range& range,
-    std::vector<std::vector<size_t>>& neighbors,
-    std::vector<std::vector<double>>& distances)
+    ResultType& results,
+    tree::SearchContext& context) const
 {
+  results.Reset(referenceSet->n_cols);
+
   // If there are no points, there is no search to be done.
   if (referenceSet->n_cols == 0)
+  {
+    results.Finish();
     return;
+  }
 
-  Timer::Start("range_search/computing_neighbors");
+  size_t& baseCases = context.BaseCases();
+  size_t& scores = context.Scores();
 
-  // Here, we will use the query set as the reference set.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<double>>* distancePtr = &distances;
+  // The rules may modify the metric, so they get their own copy.
+  MetricType metric(this->metric);
 
-  if (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner)
-  {
-    // We will always need to rearrange in this case.
-    distancePtr = new std::vector<std::vector<double>>;
-    neighborPtr = new std::vector<std::vector<size_t>>;
-  }
+  Timer::Start("range_search/computing_neighbors");
 
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(referenceSet->n_cols);
-  distancePtr->clear();
-  distancePtr->resize(referenceSet->n_cols);
+  // Here, we will use the query set as the reference set, so if the indices
+  // need to be mapped, both the query and reference indices are.
+  const std::vector<size_t>* mapping =
+      (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner) ?
+      &oldFromNewReferences : NULL;
+  typedef MappedRangeResults<ResultType> MappedResultType;
+  MappedResultType mappedResults(results, mapping, mapping);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
+  typedef RangeSearchRules<MetricType, Tree, MappedResultType> RuleType;
+  RuleType rules(*referenceSet, *referenceSet, range, mappedResults, metric,
+      true /* don't return the query in the results */);
 
   if (naive)
   {
-    // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    // The naive brute-force solution.  Every thread uses its own copy of the
+    // rules, which shares the result policy.
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          threadRules.BaseCase(i, j);
+    }
 
     baseCases = (referenceSet->n_cols * referenceSet->n_cols);
     scores = 0;
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    // The queries are split across the threads; every thread uses its own
+    // copy of the rules, which shares the result policy.
+    size_t threadBaseCases = 0, threadScores = 0;
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+    {
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(
+          threadRules);
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
 
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+      threadBaseCases += threadRules.BaseCases();
+      threadScores += threadRules.Scores();
+    }
+
+    baseCases = threadBaseCases;
+    scores = threadScores;
   }
   else // Dual-tree recursion.
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    tree::TraverseWithStatistics<Tree::template DualTreeTraverser>(rules,
+        *referenceTree, *referenceTree, "range search");
 
     baseCases = rules.BaseCases();
     scores = rules.Scores();
   }
 
-  Timer::Stop("range_search/computing_neighbors");
-
-  // Do we need to map the reference indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    neighbors.clear();
-    neighbors.resize(referenceSet->n_cols);
-    distances.clear();
-    distances.resize(referenceSet->n_cols);
-
-    for (size_t i = 0; i < distances.size(); i++)
-    {
-      // Map distances (copy a column).
-      const size_t refMapping = oldFromNewReferences[i];
-      distances[refMapping] = (*distancePtr)[i];
-
-      // Copy each neighbor individually, because we need to map it.
-      neighbors[refMapping].resize(distances[refMapping].size());
-      for (size_t j = 0; j < distances[refMapping].size(); j++)
-      {
-        neighbors[refMapping][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-    }
+  results.Finish();
 
-    // Finished with temporary objects.
-    delete neighborPtr;
-    delete distancePtr;
-  }
+  Timer::Stop("range_search/computing_neighbors");
 }
 
 template<typename MetricType,
@@ -84,6 +84,8 @@ PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "If true, the model holds the reference set in "
+    "single precision, which halves its memory.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
@@ -103,6 +105,7 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "single_precision");
   ReportIgnoredParam({{ "input_model", true }}, "leaf_size");
   ReportIgnoredParam({{ "input_model", true }}, "naive");
 
@@ -191,7 +194,19 @@ static void mlpackMain()
 
     const size_t leafSize = size_t(lsInt);
 
-    rs->BuildModel(std::move(referenceSet), leafSize, naive, singleMode);
+    if (CLI::HasParam("single_precision"))
+    {
+      // Release the double precision copy before the tree is built.
+      arma::fmat floatReferenceSet =
+          arma::conv_to<arma::fmat>::from(referenceSet);
+      referenceSet.reset();
+      rs->BuildModel(std::move(floatReferenceSet), leafSize, naive,
+          singleMode);
+    }
+    else
+    {
+      rs->BuildModel(std::move(referenceSet), leafSize, naive, singleMode);
+    }
   }
   else
   {
@@ -200,7 +215,7 @@ static void mlpackMain()
 
     Log::Info << "Using range search model from '"
         << CLI::GetPrintableParam<RSModel>("input_model") << "' ("
-        << "trained on " << rs->Dataset().n_rows << "x" << rs->Dataset().n_cols
+        << "trained on " << rs->Dimensionality() << "x" << rs->NumPoints()
         << " dataset)." << endl;
 
     // Adjust singleMode and naive if necessary.
@@ -0,0 +1,367 @@
+/**
+ * @file range_search_results.hpp
+ *
+ * Policies that receive the results of RangeSearch: vectors of neighbors for
+ * each query point, compact storage in flat arrays, a callback, or counts.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * A result policy of RangeSearch receives every (query point, reference point,
+ * distance) triple that is found in the range.  It must provide:
+ *
+ * @code
+ * // Whether Add() needs the distances.  If false, the distances of the
+ * // reference nodes entirely in the range are not computed.
+ * static const bool NeedsDistances;
+ *
+ * // Prepare for a search with the given number of query points.
+ * void Reset(const size_t numQueries);
+ *
+ * // Add a result.
+ * void Add(const size_t queryIndex,
+ *          const size_t referenceIndex,
+ *          const double distance);
+ *
+ * // Expect the given number of additional results for the query point.
+ * void Reserve(const size_t queryIndex, const size_t count);
+ *
+ * // Finish the search.
+ * void Finish();
+ * @endcode
+ *
+ * In naive and single-tree mode, several threads call Add() and Reserve() at
+ * the same time, but never for the same query point.
+ *
+ * VectorRangeResults stores the neighbors of each query point in their own
+ * vector, CompactRangeResults stores them all in flat arrays,
+ * CallbackRangeResults passes them to a function, and CountRangeResults only
+ * counts them.
+ */
+class VectorRangeResults
+{
+ public:
+  //! The distances are stored.
+  static const bool NeedsDistances = true;
+
+  /**
+   * Store the results in the given vectors: neighbors[i] and distances[i] will
+   * hold the indices and distances of the reference points in the range of
+   * query point i.
+   *
+   * @param neighbors Vectors to store the neighbors in.
+   * @param distances Vectors to store the distances in.
+   */
+  VectorRangeResults(std::vector<std::vector<size_t>>& neighbors,
+                     std::vector<std::vector<double>>& distances) :
+      neighbors(neighbors),
+      distances(distances)
+  { }
+
+  //! Clear the vectors, and make one for each query point.
+  void Reset(const size_t numQueries)
+  {
+    neighbors.clear();
+    neighbors.resize(numQueries);
+    distances.clear();
+    distances.resize(numQueries);
+  }
+
+  //! Add a result.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    neighbors[queryIndex].push_back(referenceIndex);
+    distances[queryIndex].push_back(distance);
+  }
+
+  //! Reserve room for more results of the given query point.
+  void Reserve(const size_t queryIndex, const size_t count)
+  {
+    neighbors[queryIndex].reserve(neighbors[queryIndex].size() + count);
+    distances[queryIndex].reserve(distances[queryIndex].size() + count);
+  }
+
+  //! Nothing to do.
+  void Finish() { }
+
+ private:
+  //! The neighbors of each query point.
+  std::vector<std::vector<size_t>>& neighbors;
+  //! The distances of each query point.
+  std::vector<std::vector<double>>& distances;
+};
+
+/**
+ * Store the results of all query points in flat arrays, in compressed sparse
+ * row format: the neighbors of query point i are Neighbors()[j] for j from
+ * Offsets()[i] to Offsets()[i + 1] - 1, and their distances are the same
+ * elements of Distances().  This avoids the allocations of a vector per query
+ * point, which dominate when the ranges hold many points.
+ *
+ * During the search, the results are appended to one buffer per thread, and
+ * Finish() moves them to their place.
+ */
+class CompactRangeResults
+{
+ public:
+  //! The distances are stored.
+  static const bool NeedsDistances = true;
+
+  //! Create an empty object.
+  CompactRangeResults() : numQueries(0) { }
+
+  //! Clear the results, and prepare one buffer per thread.
+  void Reset(const size_t numQueries)
+  {
+    size_t threads = 1;
+    #ifdef HAS_OPENMP
+      threads = omp_get_max_threads();
+    #endif
+
+    this->numQueries = numQueries;
+    buffers.clear();
+    buffers.resize(threads);
+    offsets.reset();
+    neighbors.reset();
+    distances.reset();
+  }
+
+  //! Add a result to the buffer of the calling thread.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    size_t thread = 0;
+    #ifdef HAS_OPENMP
+      thread = omp_get_thread_num();
+    #endif
+
+    buffers[thread].push_back(Result(queryIndex, referenceIndex, distance));
+  }
+
+  //! Nothing to do; the buffers grow geometrically.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+  //! Move the results from the buffers to the flat arrays.
+  void Finish()
+  {
+    // Count the results of each query point, then place them in order.
+    offsets.zeros(numQueries + 1);
+    for (size_t t = 0; t < buffers.size(); ++t)
+      for (size_t i = 0; i < buffers[t].size(); ++i)
+        ++offsets[buffers[t][i].query + 1];
+    offsets = arma::cumsum(offsets);
+
+    neighbors.set_size(offsets[numQueries]);
+    distances.set_size(offsets[numQueries]);
+    arma::Col<size_t> positions = offsets.head(numQueries);
+    for (size_t t = 0; t < buffers.size(); ++t)
+    {
+      for (size_t i = 0; i < buffers[t].size(); ++i)
+      {
+        const size_t position = positions[buffers[t][i].query]++;
+        neighbors[position] = buffers[t][i].reference;
+        distances[position] = buffers[t][i].distance;
+      }
+
+      // Release the memory of the buffer.
+      std::vector<Result>().swap(buffers[t]);
+    }
+  }
+
+  //! Get the number of query points.
+  size_t NumQueries() const { return numQueries; }
+  //! Get the number of results of the given query point.
+  size_t NumNeighbors(const size_t queryIndex) const
+  {
+    return offsets[queryIndex + 1] - offsets[queryIndex];
+  }
+
+  //! Get the position of the first result of each query point (and the total
+  //! number of results, last).
+  const arma::Col<size_t>& Offsets() const { return offsets; }
+  //! Get the neighbors of all the query points.
+  const arma::Col<size_t>& Neighbors() const { return neighbors; }
+  //! Get the distances of all the query points.
+  const arma::vec& Distances() const { return distances; }
+
+ private:
+  //! A result, as found during the search.
+  struct Result
+  {
+    Result(const size_t query, const size_t reference, const double distance) :
+        query(query), reference(reference), distance(distance) { }
+
+    size_t query;
+    size_t reference;
+    double distance;
+  };
+
+  //! The number of query points.
+  size_t numQueries;
+  //! The results found by each thread.
+  std::vector<std::vector<Result>> buffers;
+  //! The position of the first result of each query point.
+  arma::Col<size_t> offsets;
+  //! The neighbors of all the query points.
+  arma::Col<size_t> neighbors;
+  //! The distances of all the query points.
+  arma::vec distances;
+};
+
+/**
+ * Pass each result to a callback as soon as it is found, without storing it.
+ * The callback is called as callback(queryIndex, referenceIndex, distance); in
+ * naive and single-tree mode, it is called by several threads at the same time
+ * (for different query points), so it must be thread-safe.
+ *
+ * @tparam CallbackType Type of the callback.
+ */
+template<typename CallbackType>
+class CallbackRangeResults
+{
+ public:
+  //! The callback receives the distances.
+  static const bool NeedsDistances = true;
+
+  /**
+   * Pass the results to the given callback.
+   *
+   * @param callback The callback.
+   */
+  CallbackRangeResults(CallbackType& callback) : callback(callback) { }
+
+  //! Nothing to do.
+  void Reset(const size_t /* numQueries */) { }
+
+  //! Pass a result to the callback.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    callback(queryIndex, referenceIndex, distance);
+  }
+
+  //! Nothing to do.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+  //! Nothing to do.
+  void Finish() { }
+
+ private:
+  //! The callback.
+  CallbackType& callback;
+};
+
+/**
+ * Only count the reference points in the range of each query point.  The
+ * distances of the reference nodes entirely in the range are not computed.
+ */
+class CountRangeResults
+{
+ public:
+  //! The distances are not needed.
+  static const bool NeedsDistances = false;
+
+  //! Create an empty object.
+  CountRangeResults() { }
+
+  //! Set the counts to zero.
+  void Reset(const size_t numQueries) { counts.zeros(numQueries); }
+
+  //! Count a result.
+  void Add(const size_t queryIndex,
+           const size_t /* referenceIndex */,
+           const double /* distance */)
+  {
+    ++counts[queryIndex];
+  }
+
+  //! Nothing to do.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+  //! Nothing to do.
+  void Finish() { }
+
+  //! Get the number of reference points in the range of each query point.
+  const arma::Col<size_t>& Counts() const { return counts; }
+
+ private:
+  //! The number of reference points in the range of each query point.
+  arma::Col<size_t> counts;
+};
+
+/**
+ * Map the indices of the points in the trees to the indices of the points in
+ * the original datasets, and pass the results on to another result policy.
+ * RangeSearch uses this when its trees rearrange the datasets.
+ *
+ * @tparam ResultType Type of the result policy to pass the results to.
+ */
+template<typename ResultType>
+class MappedRangeResults
+{
+ public:
+  //! The distances are needed if the other policy needs them.
+  static const bool NeedsDistances = ResultType::NeedsDistances;
+
+  /**
+   * Pass the mapped results to the given policy.
+   *
+   * @param results Result policy to pass the results to.
+   * @param oldFromNewQueries Original index of each query point, or NULL if
+   *     the indices are not mapped.
+   * @param oldFromNewReferences Original index of each reference point, or
+   *     NULL if the indices are not mapped.
+   */
+  MappedRangeResults(ResultType& results,
+                     const std::vector<size_t>* oldFromNewQueries,
+                     const std::vector<size_t>* oldFromNewReferences) :
+      results(results),
+      oldFromNewQueries(oldFromNewQueries),
+      oldFromNewReferences(oldFromNewReferences)
+  { }
+
+  //! Add a result.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    results.Add(oldFromNewQueries ? (*oldFromNewQueries)[queryIndex] :
+        queryIndex, oldFromNewReferences ?
+        (*oldFromNewReferences)[referenceIndex] : referenceIndex, distance);
+  }
+
+  //! Reserve room for more results of the given query point.
+  void Reserve(const size_t queryIndex, const size_t count)
+  {
+    results.Reserve(oldFromNewQueries ? (*oldFromNewQueries)[queryIndex] :
+        queryIndex, count);
+  }
+
+ private:
+  //! The result policy to pass the results to.
+  ResultType& results;
+  //! The original index of each query point.
+  const std::vector<size_t>* oldFromNewQueries;
+  //! The original index of each reference point.
+  const std::vector<size_t>* oldFromNewReferences;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
@@ -13,18 +13,23 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/leaf_base_case.hpp>
 
 namespace mlpack {
 namespace range {
 
 /**
  * The RangeSearchRules class is a template helper class used by RangeSearch
- * class when performing range searches.
+ * class when performing range searches.  Copies of a RangeSearchRules object
+ * pass their results to the same result policy, so that several threads can
+ * search for disjoint sets of query points.
  *
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ * @tparam ResultType The policy that receives the results (see
+ *     range_search_results.hpp).
  */
-template<typename MetricType, typename TreeType>
+template<typename MetricType, typename TreeType, typename ResultType>
 class RangeSearchRules
 {
  public:
@@ -35,17 +40,15 @@ class RangeSearchRules
    * @param referenceSet Set of reference data.
    * @param querySet Set of query data.
    * @param range Range to search for.
-   * @param neighbors Vector to store resulting neighbors in.
-   * @param distances Vector to store resulting distances in.
+   * @param results Result policy to pass the results to.
    * @param metric Instantiated metric.
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
    */
-  RangeSearchRules(const arma::mat& referenceSet,
-                   const arma::mat& querySet,
+  RangeSearchRules(const typename TreeType::Mat& referenceSet,
+                   const typename TreeType::Mat& querySet,
                    const math::Range& range,
-                   std::vector<std::vector<size_t> >& neighbors,
-                   std::vector<std::vector<double> >& distances,
+                   ResultType& results,
                    MetricType& metric,
                    const bool sameSet = false);
 
@@ -57,6 +60,18 @@ class RangeSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between all points of two leaves at once.  The
+   * distances are bounded with one matrix multiplication, and only the pairs
+   * that may be in the range are evaluated exactly.  This is only done for the
+   * Euclidean distance and large enough leaves; otherwise false is returned,
+   * and the base cases must be computed one by one.
+   *
+   * @param queryNode Query leaf.
+   * @param referenceNode Reference leaf.
+   */
+  bool LeafBaseCase(TreeType& queryNode, TreeType& referenceNode);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -119,19 +134,16 @@ class RangeSearchRules
 
  private:
   //! The reference set.
-  const arma::mat& referenceSet;
+  const typename TreeType::Mat& referenceSet;
 
   //! The query set.
-  const arma::mat& querySet;
+  const typename TreeType::Mat& querySet;
 
   //! The range of distances for which we are searching.
   const math::Range& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
-
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<double> >& distances;
+  //! The policy the results are passed to.
+  ResultType& results;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -144,6 +156,11 @@ class RangeSearchRules
   //! The last reference index.
   size_t lastReferenceIndex;
 
+  //! For trees with self-children, the last query point that each reference
+  //! point was evaluated with in Score(), and the base case; this is empty
+  //! until it is needed, and is not shared with copies.
+  std::vector<std::pair<size_t, double>> pointBaseCases;
+
   //! Add all the points in the given node to the results for the given query
   //! point.  If the base case has already been calculated, we make sure to not
   //! add that to the results twice.
@@ -18,20 +18,18 @@
 namespace mlpack {
 namespace range {
 
-template<typename MetricType, typename TreeType>
-RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
-    const arma::mat& referenceSet,
-    const arma::mat& querySet,
+template<typename MetricType, typename TreeType, typename ResultType>
+RangeSearchRules<MetricType, TreeType, ResultType>::RangeSearchRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
     const math::Range& range,
-    std::vector<std::vector<size_t> >& neighbors,
-    std::vector<std::vector<double> >& distances,
+    ResultType& results,
     MetricType& metric,
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
     range(range),
-    neighbors(neighbors),
-    distances(distances),
+    results(results),
     metric(metric),
     sameSet(sameSet),
     lastQueryIndex(querySet.n_cols),
@@ -44,9 +42,9 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
 
 //! The base case.  Evaluate the distance between the two points and add to the
 //! results if necessary.
-template<typename MetricType, typename TreeType>
+template<typename MetricType, typename TreeType, typename ResultType>
 inline force_inline
-double RangeSearchRules<MetricType, TreeType>::BaseCase(
+double RangeSearchRules<MetricType, TreeType, ResultType>::BaseCase(
     const size_t queryIndex,
     const size_t referenceIndex)
 {
@@ -67,18 +65,59 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   lastReferenceIndex = referenceIndex;
 
   if (range.Contains(distance))
+    results.Add(queryIndex, referenceIndex, distance);
+
+  return distance;
+}
+
+template<typename MetricType, typename TreeType, typename ResultType>
+bool RangeSearchRules<MetricType, TreeType, ResultType>::LeafBaseCase(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  typedef tree::LeafDistances<MetricType, typename TreeType::Mat>
+      LeafDistancesType;
+
+  const size_t queryBegin = queryNode.Point(0);
+  const size_t queryCount = queryNode.NumPoints();
+  const size_t referenceBegin = referenceNode.Point(0);
+  const size_t referenceCount = referenceNode.NumPoints();
+  if (!LeafDistancesType::Supported ||
+      queryCount * referenceCount < tree::minimumLeafBaseCases)
+    return false;
+
+  const LeafDistancesType leafDistances(querySet, queryBegin, queryCount,
+      referenceSet, referenceBegin, referenceCount);
+
+  for (size_t i = 0; i < queryCount; ++i)
   {
-    neighbors[queryIndex].push_back(referenceIndex);
-    distances[queryIndex].push_back(distance);
+    const size_t queryIndex = queryBegin + i;
+    for (size_t j = 0; j < referenceCount; ++j)
+    {
+      const size_t referenceIndex = referenceBegin + j;
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      // Only evaluate the distance if it may be in the range.
+      if (!leafDistances.Range(i, j).Contains(range))
+        continue;
+
+      const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
+          referenceSet.unsafe_col(referenceIndex));
+      if (range.Contains(distance))
+        results.Add(queryIndex, referenceIndex, distance);
+    }
   }
 
-  return distance;
+  baseCases += queryCount * referenceCount;
+  return true;
 }
 
 //! Single-tree scoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
-                                                     TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename ResultType>
+double RangeSearchRules<MetricType, TreeType, ResultType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // We must get the minimum and maximum distances and store them in this
   // object.
@@ -88,21 +127,31 @@ double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
   {
     // In this situation, we calculate the base case.  So we should check to be
     // sure we haven't already done that.
+    // The base cases are kept in this object and not in the reference tree, so
+    // that several searches can share the tree.
+    if (tree::TreeTraits<TreeType>::HasSelfChildren && pointBaseCases.empty())
+    {
+      pointBaseCases.resize(referenceSet.n_cols,
+          std::make_pair(querySet.n_cols, 0.0));
+    }
+
     double baseCase;
+    const size_t point = referenceNode.Point(0);
     if (tree::TreeTraits<TreeType>::HasSelfChildren &&
         (referenceNode.Parent() != NULL) &&
-        (referenceNode.Point(0) == referenceNode.Parent()->Point(0)))
+        (point == referenceNode.Parent()->Point(0)) &&
+        (pointBaseCases[point].first == queryIndex))
     {
       // If the tree has self-children and this is a self-child, the base case
       // was already calculated.
-      baseCase = referenceNode.Parent()->Stat().LastDistance();
+      baseCase = pointBaseCases[point].second;
       lastQueryIndex = queryIndex;
-      lastReferenceIndex = referenceNode.Point(0);
+      lastReferenceIndex = point;
     }
     else
     {
       // We must calculate the base case by hand.
-      baseCase = BaseCase(queryIndex, referenceNode.Point(0));
+      baseCase = BaseCase(queryIndex, point);
     }
 
     // This may be possibly loose for non-ball bound trees.
@@ -110,7 +159,8 @@ double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
     distances.Hi() = baseCase + referenceNode.FurthestDescendantDistance();
 
     // Update last distance calculation.
-    referenceNode.Stat().LastDistance() = baseCase;
+    if (tree::TreeTraits<TreeType>::HasSelfChildren)
+      pointBaseCases[point] = std::make_pair(queryIndex, baseCase);
   }
   else
   {
@@ -136,8 +186,8 @@ double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
 }
 
 //! Single-tree rescoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Rescore(
+template<typename MetricType, typename TreeType, typename ResultType>
+double RangeSearchRules<MetricType, TreeType, ResultType>::Rescore(
     const size_t /* queryIndex */,
     TreeType& /* referenceNode */,
     const double oldScore) const
@@ -147,9 +197,10 @@ double RangeSearchRules<MetricType, TreeType>::Rescore(
 }
 
 //! Dual-tree scoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
-                                                     TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename ResultType>
+double RangeSearchRules<MetricType, TreeType, ResultType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
 {
   math::Range distances;
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
@@ -209,8 +260,8 @@ double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
 }
 
 //! Dual-tree rescoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Rescore(
+template<typename MetricType, typename TreeType, typename ResultType>
+double RangeSearchRules<MetricType, TreeType, ResultType>::Rescore(
     TreeType& /* queryNode */,
     TreeType& /* referenceNode */,
     const double oldScore) const
@@ -221,9 +272,10 @@ double RangeSearchRules<MetricType, TreeType>::Rescore(
 
 //! Add all the points in the given node to the results for the given query
 //! point.
-template<typename MetricType, typename TreeType>
-void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
-                                                       TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename ResultType>
+void RangeSearchRules<MetricType, TreeType, ResultType>::AddResult(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // Some types of trees calculate the base case evaluation before Score() is
   // called, so if the base case has already been calculated, then we must avoid
@@ -236,14 +288,9 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     baseCaseMod = 1;
   }
 
-  // Resize distances and neighbors vectors appropriately.  We have to use
-  // reserve() and not resize(), because we don't know if we will encounter the
+  // This is an upper bound, because we don't know if we will encounter the
   // case where the datasets and points are the same (and we skip in that case).
-  const size_t oldSize = neighbors[queryIndex].size();
-  neighbors[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
-  distances[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
+  results.Reserve(queryIndex, referenceNode.NumDescendants() - baseCaseMod);
 
   for (size_t i = baseCaseMod; i < referenceNode.NumDescendants(); ++i)
   {
@@ -251,11 +298,12 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
         (queryIndex == referenceNode.Descendant(i)))
       continue;
 
-    const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
-        referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i)));
+    // The distance is only computed if the results need it.
+    const double distance = ResultType::NeedsDistances ?
+        metric.Evaluate(querySet.unsafe_col(queryIndex),
+        referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i))) : 0.0;
 
-    neighbors[queryIndex].push_back(referenceNode.Descendant(i));
-    distances[queryIndex].push_back(distance);
+    results.Add(queryIndex, referenceNode.Descendant(i), distance);
   }
 }
 
@@ -20,6 +20,8 @@
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
 #include <boost/variant.hpp>
+#include <memory>
+#include <stack>
 #include "range_search.hpp"
 
 namespace mlpack {
@@ -30,8 +32,9 @@ namespace range {
  */
 template<template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-using RSType = RangeSearch<metric::EuclideanDistance, arma::mat, TreeType>;
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
+using RSType = RangeSearch<metric::EuclideanDistance, MatType, TreeType>;
 
 /**
  * MonoSearchVisitor executes a monochromatic range search on the given
@@ -68,11 +71,12 @@ class MonoSearchVisitor : public  boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, before doing range search,
  * a query tree with proper leafSize is built from the querySet.
  */
+template<typename MatType = arma::mat>
 class BiSearchVisitor : public boost::static_visitor<void>
 {
  private:
   //! The query set for the bichromatic search.
-  const arma::mat& querySet;
+  const MatType& querySet;
   //! Range to search neighbours for.
   const math::Range& range;
   //! The result vector for neighbors.
@@ -91,7 +95,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using RSTypeT = RSType<TreeType>;
+  using RSTypeT = RSType<TreeType, MatType>;
 
   //! Default Bichromatic range search on the given RSType instance.
   template<template<typename TreeMetricType,
@@ -109,7 +113,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   void operator()(RSTypeT<tree::Octree>* rs) const;
 
   //! Construct the BiSearchVisitor.
-  BiSearchVisitor(const arma::mat& querySet,
+  BiSearchVisitor(const MatType& querySet,
                   const math::Range& range,
                   std::vector<std::vector<size_t>>& neighbors,
                   std::vector<std::vector<double>>& distances,
@@ -122,11 +126,12 @@ class BiSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, a reference tree with proper
  * leafSize is built from the referenceSet.
  */
+template<typename MatType = arma::mat>
 class TrainVisitor : public boost::static_visitor<void>
 {
  private:
   //! The reference set to use for training.
-  arma::mat&& referenceSet;
+  MatType&& referenceSet;
   //! The leaf size, used only by BinarySpaceTree.
   size_t leafSize;
   //! Train on the given RsType considering the leafSize.
@@ -138,7 +143,7 @@ class TrainVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using RSTypeT = RSType<TreeType>;
+  using RSTypeT = RSType<TreeType, MatType>;
 
   //! Default Train on the given RSType instance.
   template<template<typename TreeMetricType,
@@ -156,19 +161,20 @@ class TrainVisitor : public boost::static_visitor<void>
   void operator()(RSTypeT<tree::Octree>* rs) const;
 
   //! Construct the TrainVisitor object with the given reference set, leafSize
-  TrainVisitor(arma::mat&& referenceSet,
+  TrainVisitor(MatType&& referenceSet,
                const size_t leafSize);
 };
 
 /**
  * ReferenceSetVisitor exposes the referenceSet of the given RSType.
  */
-class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
+template<typename MatType = arma::mat>
+class ReferenceSetVisitor : public boost::static_visitor<const MatType&>
 {
  public:
   //! Return the reference set.
   template<typename RSType>
-  const arma::mat& operator()(RSType* rs) const;
+  const MatType& operator()(RSType* rs) const;
 };
 
 /**
@@ -209,6 +215,114 @@ class NaiveVisitor : public boost::static_visitor<bool&>
   bool& operator()(RSType* rs) const;
 };
 
+/**
+ * A query set set with RSModel::SetQuerySet(), held through this base class
+ * since the type of its query tree depends on the tree type of the model.
+ */
+class CachedQueryBase
+{
+ public:
+  virtual ~CachedQueryBase() { }
+};
+
+/**
+ * A query set prepared for repeated searches: the query set projected and
+ * converted to the precision of the model and, for dual-tree search, the query
+ * tree built on it.
+ *
+ * @tparam MatType Type of the query set.
+ * @tparam TreeType Type of the query tree.
+ */
+template<typename MatType, typename TreeType>
+struct CachedQuery : public CachedQueryBase
+{
+  //! The query set, if no query tree was built.
+  MatType querySet;
+  //! The query tree, for dual-tree search.
+  std::unique_ptr<TreeType> tree;
+  //! Mappings from the points of the query tree to the query points (empty if
+  //! the tree does not rearrange its dataset).
+  std::vector<size_t> oldFromNew;
+};
+
+/**
+ * BuildQueryVisitor prepares the given query set for repeated searches with
+ * the given RSType: for dual-tree search the query tree is built, like
+ * BiSearchVisitor does for each search.
+ */
+template<typename MatType = arma::mat>
+class BuildQueryVisitor : public boost::static_visitor<CachedQueryBase*>
+{
+ private:
+  //! The query set.
+  MatType&& querySet;
+  //! The number of points in a leaf (for BinarySpaceTrees).
+  const size_t leafSize;
+
+  //! Build the query tree with the given leaf size.
+  template<typename RSType>
+  CachedQueryBase* BuildLeaf(RSType* rs) const;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  using RSTypeT = RSType<TreeType, MatType>;
+
+  //! Prepare the query set for the given RSType instance.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  CachedQueryBase* operator()(RSTypeT<TreeType>* rs) const;
+
+  //! Prepare the query set for the given RSType specialized for KDTrees.
+  CachedQueryBase* operator()(RSTypeT<tree::KDTree>* rs) const;
+
+  //! Prepare the query set for the given RSType specialized for BallTrees.
+  CachedQueryBase* operator()(RSTypeT<tree::BallTree>* rs) const;
+
+  //! Prepare the query set specialized for octrees.
+  CachedQueryBase* operator()(RSTypeT<tree::Octree>* rs) const;
+
+  //! Construct the BuildQueryVisitor.
+  BuildQueryVisitor(MatType&& querySet, const size_t leafSize);
+};
+
+/**
+ * CachedSearchVisitor executes a bichromatic range search with a query set
+ * prepared by BuildQueryVisitor, reusing its query tree.
+ */
+template<typename MatType = arma::mat>
+class CachedSearchVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The prepared query set.
+  CachedQueryBase& query;
+  //! Range to search neighbours for.
+  const math::Range& range;
+  //! The result vector for neighbors.
+  std::vector<std::vector<size_t>>& neighbors;
+  //! The result vector for distances.
+  std::vector<std::vector<double>>& distances;
+
+ public:
+  //! Search with the prepared query set.
+  template<typename RSType>
+  void operator()(RSType* rs) const;
+
+  //! Construct the CachedSearchVisitor.
+  CachedSearchVisitor(CachedQueryBase& query,
+                      const math::Range& range,
+                      std::vector<std::vector<size_t>>& neighbors,
+                      std::vector<std::vector<double>>& distances) :
+      query(query),
+      range(range),
+      neighbors(neighbors),
+      distances(distances)
+  {};
+};
+
 class RSModel
 {
  public:
@@ -239,25 +353,48 @@ class RSModel
   //! Random projection matrix.
   arma::mat q;
 
+  //! The RangeSearch types for each tree type, with the given matrix type.
+  template<typename MatType>
+  using RSVariant = boost::variant<RSType<tree::KDTree, MatType>*,
+                                   RSType<tree::StandardCoverTree, MatType>*,
+                                   RSType<tree::RTree, MatType>*,
+                                   RSType<tree::RStarTree, MatType>*,
+                                   RSType<tree::BallTree, MatType>*,
+                                   RSType<tree::XTree, MatType>*,
+                                   RSType<tree::HilbertRTree, MatType>*,
+                                   RSType<tree::RPlusTree, MatType>*,
+                                   RSType<tree::RPlusPlusTree, MatType>*,
+                                   RSType<tree::VPTree, MatType>*,
+                                   RSType<tree::RPTree, MatType>*,
+                                   RSType<tree::MaxRPTree, MatType>*,
+                                   RSType<tree::UBTree, MatType>*,
+                                   RSType<tree::Octree, MatType>*>;
+
+  //! If true, the reference set is held in single precision, in fSearch.
+  bool singlePrecision;
+
   /**
    * rSearch holds an instance of the RangeSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
    * We access to the contained value through the visitor classes defined above.
    */
-  boost::variant<RSType<tree::KDTree>*,
-                 RSType<tree::StandardCoverTree>*,
-                 RSType<tree::RTree>*,
-                 RSType<tree::RStarTree>*,
-                 RSType<tree::BallTree>*,
-                 RSType<tree::XTree>*,
-                 RSType<tree::HilbertRTree>*,
-                 RSType<tree::RPlusTree>*,
-                 RSType<tree::RPlusPlusTree>*,
-                 RSType<tree::VPTree>*,
-                 RSType<tree::RPTree>*,
-                 RSType<tree::MaxRPTree>*,
-                 RSType<tree::UBTree>*,
-                 RSType<tree::Octree>*> rSearch;
+  RSVariant<arma::mat> rSearch;
+  //! The same as rSearch, for models built on single precision data.
+  RSVariant<arma::fmat> fSearch;
+
+  //! The query set of SearchQuerySet(), if SetQuerySet() was called.  It is
+  //! neither copied nor serialized.
+  std::unique_ptr<CachedQueryBase> query;
+  //! Whether the results of SearchQuerySet() are kept for later searches.
+  bool cacheResults;
+  //! Whether results are kept.
+  bool hasCachedResults;
+  //! The range of the kept results.
+  math::Range cachedRange;
+  //! The kept neighbors.
+  std::vector<std::vector<size_t>> cachedNeighbors;
+  //! The kept distances.
+  std::vector<std::vector<double>> cachedDistances;
 
  public:
   /**
@@ -307,8 +444,20 @@ class RSModel
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
-  //! Expose the dataset.
+  //! Expose the dataset.  An exception is thrown if the model holds the
+  //! dataset in single precision.
   const arma::mat& Dataset() const;
+  //! Expose the dataset of a model built in single precision.  An exception is
+  //! thrown if the model holds the dataset in double precision.
+  const arma::fmat& FloatDataset() const;
+
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const;
+  //! Get the number of points in the reference set.
+  size_t NumPoints() const;
+
+  //! Get whether the reference set is held in single precision.
+  bool SinglePrecision() const { return singlePrecision; }
 
   //! Get whether the model is in single-tree search mode.
   bool SingleMode() const;
@@ -350,10 +499,26 @@ class RSModel
                   const bool naive,
                   const bool singleMode);
 
+  /**
+   * Build the reference tree on the given single precision dataset, which the
+   * model keeps in single precision; this halves the memory of the model.
+   * This takes possession of the reference set to avoid a copy.
+   *
+   * @param referenceSet Set of reference points.
+   * @param leafSize Leaf size of tree (ignored for the cover tree).
+   * @param naive Whether naive search should be used.
+   * @param singleMode Whether single-tree search should be used.
+   */
+  void BuildModel(arma::fmat&& referenceSet,
+                  const size_t leafSize,
+                  const bool naive,
+                  const bool singleMode);
+
   /**
    * Perform range search.  This takes possession of the query set, so the query
-   * set will not be usable after the search.  For more information on the
-   * output format, see RangeSearch<>::Search().
+   * set will not be usable after the search.  The query set is converted to
+   * the precision of the model.  For more information on the output format,
+   * see RangeSearch<>::Search().
    *
    * @param querySet Set of query points.
    * @param range Range to search for.
@@ -365,6 +530,13 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  //! Perform range search with a single precision query set; see the double
+  //! precision overload.
+  void Search(arma::fmat&& querySet,
+              const math::Range& range,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances);
+
   /**
    * Perform monochromatic range search, with the reference set as the query
    * set.  For more information on the output format, see
@@ -378,6 +550,49 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Set the query set of SearchQuerySet(), to search it repeatedly: the query
+   * set is projected and converted to the precision of the model once, and for
+   * dual-tree search the query tree is built once instead of at every search.
+   * This takes possession of the query set.  The query set is kept until
+   * ClearQuerySet() or BuildModel() is called.
+   *
+   * If cacheResults is true, the results of the last search are also kept,
+   * and a later search for a range inside the range of the kept results is
+   * answered from them, without searching.  So, to sweep over many ranges,
+   * search for the widest range first.
+   *
+   * @param querySet Set of query points.
+   * @param cacheResults Whether to keep the results of the searches.
+   */
+  void SetQuerySet(arma::mat&& querySet, const bool cacheResults = false);
+
+  //! Set the query set of SearchQuerySet() from a single precision query set;
+  //! see the double precision overload.
+  void SetQuerySet(arma::fmat&& querySet, const bool cacheResults = false);
+
+  /**
+   * Perform range search for the query set given to SetQuerySet().  The
+   * results are the same as those of Search() with that query set, up to the
+   * order of the neighbors of each point, which is not specified.  The search
+   * mode should not be changed after SetQuerySet(): a query tree cannot be
+   * searched in naive or single-tree mode (a std::invalid_argument is thrown),
+   * and without one the dual-tree search builds a query tree each time.
+   *
+   * @param range Range to search for.
+   * @param neighbors Output: neighbors falling within the desired range.
+   * @param distances Output: distances of neighbors.
+   */
+  void SearchQuerySet(const math::Range& range,
+                      std::vector<std::vector<size_t>>& neighbors,
+                      std::vector<std::vector<double>>& distances);
+
+  //! Release the query set given to SetQuerySet() and the kept results.
+  void ClearQuerySet();
+
+  //! Get whether a query set was given to SetQuerySet().
+  bool HasQuerySet() const { return query.get() != NULL; }
+
  private:
   /**
    * Return a string representing the name of the tree.  This is used for
@@ -385,6 +600,29 @@ class RSModel
    */
   std::string TreeName() const;
 
+  //! Apply the given visitor to the RangeSearch object in use.
+  template<typename VisitorType>
+  typename VisitorType::result_type Apply(const VisitorType& visitor) const;
+
+  //! Build the reference tree in the given variant.
+  template<typename MatType>
+  void BuildModel(MatType&& referenceSet,
+                  RSVariant<MatType>& search,
+                  const bool naive,
+                  const bool singleMode);
+
+  //! Perform range search with the given variant.
+  template<typename MatType>
+  void Search(MatType&& querySet,
+              RSVariant<MatType>& search,
+              const math::Range& range,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances);
+
+  //! Prepare the query set of SearchQuerySet() with the given variant.
+  template<typename MatType>
+  void SetQuerySet(MatType&& querySet, RSVariant<MatType>& search);
+
   /**
    * Clean up memory.
    */
@@ -394,6 +632,9 @@ class RSModel
 } // namespace range
 } // namespace mlpack
 
+//! Set the serialization version of the RSModel class.
+BOOST_CLASS_VERSION(mlpack::range::RSModel, 1);
+
 // Include implementation (of serialize() and inline functions).
 #include "rs_model_impl.hpp"
 
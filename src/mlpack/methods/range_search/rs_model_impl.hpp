@@ -28,7 +28,10 @@ namespace range {
 inline RSModel::RSModel(TreeTypes treeType, bool randomBasis) :
     treeType(treeType),
     leafSize(0),
-    randomBasis(randomBasis)
+    randomBasis(randomBasis),
+    singlePrecision(false),
+    cacheResults(false),
+    hasCachedResults(false)
 {
   // Nothing to do.
 }
@@ -39,9 +42,13 @@ inline RSModel::RSModel(const RSModel& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(other.q),
-    rSearch(other.rSearch)
+    singlePrecision(other.singlePrecision),
+    rSearch(other.rSearch),
+    fSearch(other.fSearch),
+    cacheResults(false),
+    hasCachedResults(false)
 {
-  // Nothing to do.
+  // The query set of SearchQuerySet() is not copied.
 }
 
 // Move constructor.
@@ -50,25 +57,38 @@ inline RSModel::RSModel(RSModel&& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    rSearch(std::move(other.rSearch))
+    singlePrecision(other.singlePrecision),
+    rSearch(std::move(other.rSearch)),
+    fSearch(std::move(other.fSearch)),
+    query(std::move(other.query)),
+    cacheResults(other.cacheResults),
+    hasCachedResults(other.hasCachedResults),
+    cachedRange(other.cachedRange),
+    cachedNeighbors(std::move(other.cachedNeighbors)),
+    cachedDistances(std::move(other.cachedDistances))
 {
   // Reset other model.
   other.treeType = TreeTypes::KD_TREE;
   other.leafSize = 0;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.rSearch = decltype(other.rSearch)();
+  other.fSearch = decltype(other.fSearch)();
+  other.ClearQuerySet();
 }
 
 // Copy operator.
 inline RSModel& RSModel::operator=(const RSModel& other)
 {
-  boost::apply_visitor(DeleteVisitor(), rSearch);
+  CleanMemory();
 
   treeType = other.treeType;
   leafSize = other.leafSize;
   randomBasis = other.randomBasis;
   q = other.q;
+  singlePrecision = other.singlePrecision;
   rSearch = other.rSearch;
+  fSearch = other.fSearch;
 
   return *this;
 }
@@ -76,19 +96,30 @@ inline RSModel& RSModel::operator=(const RSModel& other)
 // Move operator.
 inline RSModel& RSModel::operator=(RSModel&& other)
 {
-  boost::apply_visitor(DeleteVisitor(), rSearch);
+  CleanMemory();
 
   treeType = other.treeType;
   leafSize = other.leafSize;
   randomBasis = other.randomBasis;
   q = std::move(other.q);
+  singlePrecision = other.singlePrecision;
   rSearch = std::move(other.rSearch);
+  fSearch = std::move(other.fSearch);
+  query = std::move(other.query);
+  cacheResults = other.cacheResults;
+  hasCachedResults = other.hasCachedResults;
+  cachedRange = other.cachedRange;
+  cachedNeighbors = std::move(other.cachedNeighbors);
+  cachedDistances = std::move(other.cachedDistances);
 
   // Reset other model.
   other.treeType = TreeTypes::KD_TREE;
   other.leafSize = 0;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.rSearch = decltype(other.rSearch)();
+  other.fSearch = decltype(other.fSearch)();
+  other.ClearQuerySet();
 
   return *this;
 }
@@ -96,13 +127,43 @@ inline RSModel& RSModel::operator=(RSModel&& other)
 // Clean memory, if necessary.
 inline RSModel::~RSModel()
 {
-  boost::apply_visitor(DeleteVisitor(), rSearch);
+  CleanMemory();
 }
 
 inline void RSModel::BuildModel(arma::mat&& referenceSet,
                                 const size_t leafSize,
                                 const bool naive,
                                 const bool singleMode)
+{
+  this->leafSize = leafSize;
+
+  // Clean memory, if necessary.
+  CleanMemory();
+
+  singlePrecision = false;
+  BuildModel<arma::mat>(std::move(referenceSet), rSearch, naive, singleMode);
+}
+
+inline void RSModel::BuildModel(arma::fmat&& referenceSet,
+                                const size_t leafSize,
+                                const bool naive,
+                                const bool singleMode)
+{
+  this->leafSize = leafSize;
+
+  // Clean memory, if necessary.
+  CleanMemory();
+
+  singlePrecision = true;
+  BuildModel<arma::fmat>(std::move(referenceSet), fSearch, naive, singleMode);
+}
+
+// Build the reference tree in the given variant.
+template<typename MatType>
+void RSModel::BuildModel(MatType&& referenceSet,
+                         RSVariant<MatType>& search,
+                         const bool naive,
+                         const bool singleMode)
 {
   // Initialize random basis if necessary.
   if (randomBasis)
@@ -111,14 +172,9 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
     math::RandomBasis(q, referenceSet.n_rows);
   }
 
-  this->leafSize = leafSize;
-
-  // Clean memory, if necessary.
-  boost::apply_visitor(DeleteVisitor(), rSearch);
-
   // Do we need to modify the reference set?
   if (randomBasis)
-    referenceSet = q * referenceSet;
+    referenceSet = arma::conv_to<MatType>::from(q) * referenceSet;
 
   if (!naive)
   {
@@ -129,64 +185,64 @@ inline void RSModel::BuildModel(arma::mat&& referenceSet,
   switch (treeType)
   {
     case KD_TREE:
-      rSearch = new RSType<tree::KDTree> (naive, singleMode);
+      search = new RSType<tree::KDTree, MatType>(naive, singleMode);
       break;
 
     case COVER_TREE:
-      rSearch = new RSType<tree::StandardCoverTree>(naive, singleMode);
+      search = new RSType<tree::StandardCoverTree, MatType>(naive, singleMode);
       break;
 
     case R_TREE:
-      rSearch = new RSType<tree::RTree>(naive, singleMode);
+      search = new RSType<tree::RTree, MatType>(naive, singleMode);
       break;
 
     case R_STAR_TREE:
-      rSearch = new RSType<tree::RStarTree>(naive, singleMode);
+      search = new RSType<tree::RStarTree, MatType>(naive, singleMode);
       break;
 
     case BALL_TREE:
-      rSearch = new RSType<tree::BallTree>(naive, singleMode);
+      search = new RSType<tree::BallTree, MatType>(naive, singleMode);
       break;
 
     case X_TREE:
-      rSearch = new RSType<tree::XTree>(naive, singleMode);
+      search = new RSType<tree::XTree, MatType>(naive, singleMode);
       break;
 
     case HILBERT_R_TREE:
-      rSearch = new RSType<tree::HilbertRTree>(naive, singleMode);
+      search = new RSType<tree::HilbertRTree, MatType>(naive, singleMode);
       break;
 
     case R_PLUS_TREE:
-      rSearch = new RSType<tree::RPlusTree>(naive, singleMode);
+      search = new RSType<tree::RPlusTree, MatType>(naive, singleMode);
       break;
 
     case R_PLUS_PLUS_TREE:
-      rSearch = new RSType<tree::RPlusPlusTree>(naive, singleMode);
+      search = new RSType<tree::RPlusPlusTree, MatType>(naive, singleMode);
       break;
 
     case VP_TREE:
-      rSearch = new RSType<tree::VPTree>(naive, singleMode);
+      search = new RSType<tree::VPTree, MatType>(naive, singleMode);
       break;
 
     case RP_TREE:
-      rSearch = new RSType<tree::RPTree>(naive, singleMode);
+      search = new RSType<tree::RPTree, MatType>(naive, singleMode);
       break;
 
     case MAX_RP_TREE:
-      rSearch = new RSType<tree::MaxRPTree>(naive, singleMode);
+      search = new RSType<tree::MaxRPTree, MatType>(naive, singleMode);
       break;
 
     case UB_TREE:
-      rSearch = new RSType<tree::UBTree>(naive, singleMode);
+      search = new RSType<tree::UBTree, MatType>(naive, singleMode);
       break;
 
     case OCTREE:
-      rSearch = new RSType<tree::Octree>(naive, singleMode);
+      search = new RSType<tree::Octree, MatType>(naive, singleMode);
       break;
   }
 
-  TrainVisitor tn(std::move(referenceSet), leafSize);
-  boost::apply_visitor(tn, rSearch);
+  TrainVisitor<MatType> tn(std::move(referenceSet), leafSize);
+  boost::apply_visitor(tn, search);
 
   if (!naive)
   {
@@ -200,10 +256,52 @@ inline void RSModel::Search(arma::mat&& querySet,
                             const math::Range& range,
                             std::vector<std::vector<size_t>>& neighbors,
                             std::vector<std::vector<double>>& distances)
+{
+  if (singlePrecision)
+  {
+    arma::fmat floatQuerySet = arma::conv_to<arma::fmat>::from(querySet);
+    querySet.reset();
+    Search<arma::fmat>(std::move(floatQuerySet), fSearch, range, neighbors,
+        distances);
+  }
+  else
+  {
+    Search<arma::mat>(std::move(querySet), rSearch, range, neighbors,
+        distances);
+  }
+}
+
+// Perform range search with a single precision query set.
+inline void RSModel::Search(arma::fmat&& querySet,
+                            const math::Range& range,
+                            std::vector<std::vector<size_t>>& neighbors,
+                            std::vector<std::vector<double>>& distances)
+{
+  if (singlePrecision)
+  {
+    Search<arma::fmat>(std::move(querySet), fSearch, range, neighbors,
+        distances);
+  }
+  else
+  {
+    arma::mat doubleQuerySet = arma::conv_to<arma::mat>::from(querySet);
+    querySet.reset();
+    Search<arma::mat>(std::move(doubleQuerySet), rSearch, range, neighbors,
+        distances);
+  }
+}
+
+// Perform range search with the given variant.
+template<typename MatType>
+void RSModel::Search(MatType&& querySet,
+                     RSVariant<MatType>& search,
+                     const math::Range& range,
+                     std::vector<std::vector<size_t>>& neighbors,
+                     std::vector<std::vector<double>>& distances)
 {
   // We may need to map the query set randomly.
   if (randomBasis)
-    querySet = q * querySet;
+    querySet = arma::conv_to<MatType>::from(q) * querySet;
 
   Log::Info << "Search for points in the range [" << range.Lo() << ", "
       << range.Hi() << "] with ";
@@ -215,9 +313,9 @@ inline void RSModel::Search(arma::mat&& querySet,
     Log::Info << "brute-force (naive) search..." << std::endl;
 
 
-  BiSearchVisitor search(querySet, range, neighbors, distances,
+  BiSearchVisitor<MatType> visitor(querySet, range, neighbors, distances,
       leafSize);
-  boost::apply_visitor(search, rSearch);
+  boost::apply_visitor(visitor, search);
 }
 
 // Perform range search (monochromatic case).
@@ -235,7 +333,136 @@ inline void RSModel::Search(const math::Range& range,
     Log::Info << "brute-force (naive) search..." << std::endl;
 
   MonoSearchVisitor search(range, neighbors, distances);
-  boost::apply_visitor(search, rSearch);
+  Apply(search);
+}
+
+// Prepare the query set of SearchQuerySet().
+inline void RSModel::SetQuerySet(arma::mat&& querySet,
+                                 const bool cacheResults)
+{
+  if (singlePrecision)
+  {
+    arma::fmat floatQuerySet = arma::conv_to<arma::fmat>::from(querySet);
+    querySet.reset();
+    SetQuerySet<arma::fmat>(std::move(floatQuerySet), fSearch);
+  }
+  else
+  {
+    SetQuerySet<arma::mat>(std::move(querySet), rSearch);
+  }
+
+  this->cacheResults = cacheResults;
+}
+
+// Prepare the query set of SearchQuerySet() from single precision points.
+inline void RSModel::SetQuerySet(arma::fmat&& querySet,
+                                 const bool cacheResults)
+{
+  if (singlePrecision)
+  {
+    SetQuerySet<arma::fmat>(std::move(querySet), fSearch);
+  }
+  else
+  {
+    arma::mat doubleQuerySet = arma::conv_to<arma::mat>::from(querySet);
+    querySet.reset();
+    SetQuerySet<arma::mat>(std::move(doubleQuerySet), rSearch);
+  }
+
+  this->cacheResults = cacheResults;
+}
+
+// Prepare the query set of SearchQuerySet() with the given variant.
+template<typename MatType>
+void RSModel::SetQuerySet(MatType&& querySet, RSVariant<MatType>& search)
+{
+  ClearQuerySet();
+
+  // We may need to map the query set randomly.
+  if (randomBasis)
+    querySet = arma::conv_to<MatType>::from(q) * querySet;
+
+  const bool buildTree = (!Naive() && !SingleMode());
+  if (buildTree)
+  {
+    Timer::Start("tree_building");
+    Log::Info << "Building query tree..." << std::endl;
+  }
+
+  BuildQueryVisitor<MatType> visitor(std::move(querySet), leafSize);
+  query.reset(boost::apply_visitor(visitor, search));
+
+  if (buildTree)
+  {
+    Timer::Stop("tree_building");
+    Log::Info << "Tree built." << std::endl;
+  }
+}
+
+// Perform range search for the query set given to SetQuerySet().
+inline void RSModel::SearchQuerySet(
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
+{
+  if (!query)
+  {
+    throw std::invalid_argument("RSModel::SearchQuerySet(): no query set; "
+        "call SetQuerySet() first");
+  }
+
+  if (hasCachedResults && cachedRange.Contains(range))
+  {
+    // Keep the neighbors of the wider search that fall in the range.
+    Log::Info << "Using the kept results of the search in the range ["
+        << cachedRange.Lo() << ", " << cachedRange.Hi() << "]." << std::endl;
+    neighbors.clear();
+    distances.clear();
+    neighbors.resize(cachedNeighbors.size());
+    distances.resize(cachedDistances.size());
+    for (size_t i = 0; i < cachedNeighbors.size(); ++i)
+    {
+      for (size_t j = 0; j < cachedNeighbors[i].size(); ++j)
+      {
+        if (range.Contains(cachedDistances[i][j]))
+        {
+          neighbors[i].push_back(cachedNeighbors[i][j]);
+          distances[i].push_back(cachedDistances[i][j]);
+        }
+      }
+    }
+    return;
+  }
+
+  Log::Info << "Search for points in the range [" << range.Lo() << ", "
+      << range.Hi() << "] with the prepared query set..." << std::endl;
+  if (singlePrecision)
+  {
+    Apply(CachedSearchVisitor<arma::fmat>(*query, range, neighbors,
+        distances));
+  }
+  else
+  {
+    Apply(CachedSearchVisitor<arma::mat>(*query, range, neighbors,
+        distances));
+  }
+
+  if (cacheResults)
+  {
+    hasCachedResults = true;
+    cachedRange = range;
+    cachedNeighbors = neighbors;
+    cachedDistances = distances;
+  }
+}
+
+// Release the query set of SearchQuerySet().
+inline void RSModel::ClearQuerySet()
+{
+  query.reset();
+  hasCachedResults = false;
+  cachedNeighbors.clear();
+  cachedDistances.clear();
 }
 
 // Get the name of the tree type.
@@ -276,10 +503,25 @@ inline std::string RSModel::TreeName() const
   }
 }
 
+// Apply the given visitor to the RangeSearch object in use.
+template<typename VisitorType>
+typename VisitorType::result_type RSModel::Apply(
+    const VisitorType& visitor) const
+{
+  if (singlePrecision)
+    return boost::apply_visitor(visitor, fSearch);
+  else
+    return boost::apply_visitor(visitor, rSearch);
+}
+
 // Clean memory.
 inline void RSModel::CleanMemory()
 {
   boost::apply_visitor(DeleteVisitor(), rSearch);
+  boost::apply_visitor(DeleteVisitor(), fSearch);
+  rSearch = decltype(rSearch)();
+  fSearch = decltype(fSearch)();
+  ClearQuerySet();
 }
 
 //! Monochromatic range search on the given RSType instance.
@@ -292,11 +534,13 @@ void MonoSearchVisitor::operator()(RSType* rs) const
 }
 
 //! Save parameters for bichromatic range search.
-BiSearchVisitor::BiSearchVisitor(const arma::mat& querySet,
-                                 const math::Range& range,
-                                 std::vector<std::vector<size_t>>& neighbors,
-                                 std::vector<std::vector<double>>& distances,
-                                 const size_t leafSize):
+template<typename MatType>
+BiSearchVisitor<MatType>::BiSearchVisitor(
+    const MatType& querySet,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    const size_t leafSize):
     querySet(querySet),
     range(range),
     neighbors(neighbors),
@@ -305,10 +549,11 @@ BiSearchVisitor::BiSearchVisitor(const arma::mat& querySet,
 {}
 
 //! Default Bichromatic range search on the given RSType instance.
+template<typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void BiSearchVisitor::operator()(RSTypeT<TreeType>* rs) const
+void BiSearchVisitor<MatType>::operator()(RSTypeT<TreeType>* rs) const
 {
   if (rs)
     return rs->Search(querySet, range, neighbors, distances);
@@ -316,7 +561,8 @@ void BiSearchVisitor::operator()(RSTypeT<TreeType>* rs) const
 }
 
 //! Bichromatic range search on the given RSType specialized for KDTrees.
-void BiSearchVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::KDTree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -324,7 +570,8 @@ void BiSearchVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
 }
 
 //! Bichromatic range search on the given RSType specialized for BallTrees.
-void BiSearchVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::BallTree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -332,7 +579,8 @@ void BiSearchVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
 }
 
 //! Bichromatic range search specialized for Ocrees.
-void BiSearchVisitor::operator()(RSTypeT<tree::Octree>* rs) const
+template<typename MatType>
+void BiSearchVisitor<MatType>::operator()(RSTypeT<tree::Octree>* rs) const
 {
   if (rs)
     return SearchLeaf(rs);
@@ -340,8 +588,9 @@ void BiSearchVisitor::operator()(RSTypeT<tree::Octree>* rs) const
 }
 
 //! Bichromatic range search on the given RSType considering the leafSize.
+template<typename MatType>
 template<typename RSType>
-void BiSearchVisitor::SearchLeaf(RSType* rs) const
+void BiSearchVisitor<MatType>::SearchLeaf(RSType* rs) const
 {
   if (!rs->Naive() && !rs->SingleMode())
   {
@@ -371,18 +620,152 @@ void BiSearchVisitor::SearchLeaf(RSType* rs) const
     rs->Search(querySet, range, neighbors, distances);
 }
 
+//! Save parameters for preparing a query set.
+template<typename MatType>
+BuildQueryVisitor<MatType>::BuildQueryVisitor(MatType&& querySet,
+                                              const size_t leafSize) :
+    querySet(std::move(querySet)),
+    leafSize(leafSize)
+{}
+
+//! Default preparation of the query set for the given RSType instance.
+template<typename MatType>
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+CachedQueryBase* BuildQueryVisitor<MatType>::operator()(
+    RSTypeT<TreeType>* rs) const
+{
+  if (!rs)
+    throw std::runtime_error("no range search model initialized");
+
+  typedef typename RSTypeT<TreeType>::Tree Tree;
+  CachedQuery<MatType, Tree>* cached = new CachedQuery<MatType, Tree>();
+  if (!rs->Naive() && !rs->SingleMode())
+    cached->tree.reset(BuildTree<Tree>(std::move(querySet),
+        cached->oldFromNew));
+  else
+    cached->querySet = std::move(querySet);
+
+  return cached;
+}
+
+//! Prepare the query set for the given RSType specialized for KDTrees.
+template<typename MatType>
+CachedQueryBase* BuildQueryVisitor<MatType>::operator()(
+    RSTypeT<tree::KDTree>* rs) const
+{
+  if (rs)
+    return BuildLeaf(rs);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Prepare the query set for the given RSType specialized for BallTrees.
+template<typename MatType>
+CachedQueryBase* BuildQueryVisitor<MatType>::operator()(
+    RSTypeT<tree::BallTree>* rs) const
+{
+  if (rs)
+    return BuildLeaf(rs);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Prepare the query set specialized for octrees.
+template<typename MatType>
+CachedQueryBase* BuildQueryVisitor<MatType>::operator()(
+    RSTypeT<tree::Octree>* rs) const
+{
+  if (rs)
+    return BuildLeaf(rs);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Prepare the query set, building the query tree with the leaf size.
+template<typename MatType>
+template<typename RSType>
+CachedQueryBase* BuildQueryVisitor<MatType>::BuildLeaf(RSType* rs) const
+{
+  typedef typename RSType::Tree Tree;
+  CachedQuery<MatType, Tree>* cached = new CachedQuery<MatType, Tree>();
+  if (!rs->Naive() && !rs->SingleMode())
+    cached->tree.reset(new Tree(std::move(querySet), cached->oldFromNew,
+        leafSize));
+  else
+    cached->querySet = std::move(querySet);
+
+  return cached;
+}
+
+//! Search with the query set prepared by BuildQueryVisitor.
+template<typename MatType>
+template<typename RSType>
+void CachedSearchVisitor<MatType>::operator()(RSType* rs) const
+{
+  if (!rs)
+    throw std::runtime_error("no range search model initialized");
+
+  typedef typename RSType::Tree Tree;
+  CachedQuery<MatType, Tree>* cached =
+      dynamic_cast<CachedQuery<MatType, Tree>*>(&query);
+  if (cached == NULL)
+  {
+    throw std::invalid_argument("the query set was prepared for another tree "
+        "type or precision; call SetQuerySet() again");
+  }
+
+  if (!cached->tree)
+  {
+    rs->Search(cached->querySet, range, neighbors, distances);
+    return;
+  }
+
+  // The previous search left its distances in the statistics of the query
+  // tree.
+  std::stack<Tree*> nodes;
+  nodes.push(cached->tree.get());
+  while (!nodes.empty())
+  {
+    Tree* current = nodes.top();
+    nodes.pop();
+    current->Stat().LastDistance() = 0.0;
+    for (size_t i = 0; i < current->NumChildren(); ++i)
+      nodes.push(&current->Child(i));
+  }
+
+  if (cached->oldFromNew.empty())
+  {
+    rs->Search(cached->tree.get(), range, neighbors, distances);
+    return;
+  }
+
+  std::vector<std::vector<size_t>> neighborsOut;
+  std::vector<std::vector<double>> distancesOut;
+  rs->Search(cached->tree.get(), range, neighborsOut, distancesOut);
+
+  // Remap the query points.
+  neighbors.resize(neighborsOut.size());
+  distances.resize(distancesOut.size());
+  for (size_t i = 0; i < neighborsOut.size(); ++i)
+  {
+    neighbors[cached->oldFromNew[i]] = std::move(neighborsOut[i]);
+    distances[cached->oldFromNew[i]] = std::move(distancesOut[i]);
+  }
+}
+
 //! Save parameters for Train.
-TrainVisitor::TrainVisitor(arma::mat&& referenceSet,
-                           const size_t leafSize) :
+template<typename MatType>
+TrainVisitor<MatType>::TrainVisitor(MatType&& referenceSet,
+                                    const size_t leafSize) :
     referenceSet(std::move(referenceSet)),
     leafSize(leafSize)
 {}
 
 //! Default Train on the given RSType instance.
+template<typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void TrainVisitor::operator()(RSTypeT<TreeType>* rs) const
+void TrainVisitor<MatType>::operator()(RSTypeT<TreeType>* rs) const
 {
   if (rs)
     return rs->Train(std::move(referenceSet));
@@ -390,7 +773,8 @@ void TrainVisitor::operator()(RSTypeT<TreeType>* rs) const
 }
 
 //! Train on the given RSType specialized for KDTrees.
-void TrainVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::KDTree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -398,7 +782,8 @@ void TrainVisitor::operator()(RSTypeT<tree::KDTree>* rs) const
 }
 
 //! Train on the given RSType specialized for BallTrees.
-void TrainVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::BallTree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -406,7 +791,8 @@ void TrainVisitor::operator()(RSTypeT<tree::BallTree>* rs) const
 }
 
 //! Train specialized for Octrees.
-void TrainVisitor::operator()(RSTypeT<tree::Octree>* rs) const
+template<typename MatType>
+void TrainVisitor<MatType>::operator()(RSTypeT<tree::Octree>* rs) const
 {
   if (rs)
     return TrainLeaf(rs);
@@ -414,8 +800,9 @@ void TrainVisitor::operator()(RSTypeT<tree::Octree>* rs) const
 }
 
 //! Train on the given RSType considering the leafSize.
+template<typename MatType>
 template<typename RSType>
-void TrainVisitor::TrainLeaf(RSType* rs) const
+void TrainVisitor<MatType>::TrainLeaf(RSType* rs) const
 {
   if (rs->Naive())
     rs->Train(std::move(referenceSet));
@@ -434,8 +821,9 @@ void TrainVisitor::TrainLeaf(RSType* rs) const
 }
 
 //! Expose the referenceSet of the given RSType.
+template<typename MatType>
 template<typename RSType>
-const arma::mat& ReferenceSetVisitor::operator()(RSType* rs) const
+const MatType& ReferenceSetVisitor<MatType>::operator()(RSType* rs) const
 {
   if (rs)
     return rs->ReferenceSet();
@@ -470,7 +858,7 @@ bool& NaiveVisitor::operator()(RSType* rs) const
 
 // Serialize the model.
 template<typename Archive>
-void RSModel::serialize(Archive& ar, const unsigned int /* version */)
+void RSModel::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
@@ -478,35 +866,71 @@ void RSModel::serialize(Archive& ar, const unsigned int /* version */)
 
   // This should never happen, but just in case...
   if (Archive::is_loading::value)
-    boost::apply_visitor(DeleteVisitor(), rSearch);
+    CleanMemory();
+
+  // Models before version 1 were always in double precision.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(singlePrecision);
+  else if (Archive::is_loading::value)
+    singlePrecision = false;
 
   // We'll only need to serialize one of the model objects, based on the type.
-  ar & BOOST_SERIALIZATION_NVP(rSearch);
+  if (singlePrecision)
+    ar & BOOST_SERIALIZATION_NVP(fSearch);
+  else
+    ar & BOOST_SERIALIZATION_NVP(rSearch);
 }
 
 inline const arma::mat& RSModel::Dataset() const
 {
-  return boost::apply_visitor(ReferenceSetVisitor(), rSearch);
+  if (singlePrecision)
+  {
+    throw std::invalid_argument("RSModel::Dataset(): the model holds the "
+        "dataset in single precision; use FloatDataset()");
+  }
+
+  return boost::apply_visitor(ReferenceSetVisitor<arma::mat>(), rSearch);
+}
+
+inline const arma::fmat& RSModel::FloatDataset() const
+{
+  if (!singlePrecision)
+  {
+    throw std::invalid_argument("RSModel::FloatDataset(): the model holds the "
+        "dataset in double precision; use Dataset()");
+  }
+
+  return boost::apply_visitor(ReferenceSetVisitor<arma::fmat>(), fSearch);
+}
+
+inline size_t RSModel::Dimensionality() const
+{
+  return singlePrecision ? FloatDataset().n_rows : Dataset().n_rows;
+}
+
+inline size_t RSModel::NumPoints() const
+{
+  return singlePrecision ? FloatDataset().n_cols : Dataset().n_cols;
 }
 
 inline bool RSModel::SingleMode() const
 {
-  return boost::apply_visitor(SingleModeVisitor(), rSearch);
+  return Apply(SingleModeVisitor());
 }
 
 inline bool& RSModel::SingleMode()
 {
-  return boost::apply_visitor(SingleModeVisitor(), rSearch);
+  return Apply(SingleModeVisitor());
 }
 
 inline bool RSModel::Naive() const
 {
-  return boost::apply_visitor(NaiveVisitor(), rSearch);
+  return Apply(NaiveVisitor());
 }
 
 inline bool& RSModel::Naive()
 {
-  return boost::apply_visitor(NaiveVisitor(), rSearch);
+  return Apply(NaiveVisitor());
 }
 
 } // namespace range
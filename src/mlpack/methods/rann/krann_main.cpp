@@ -80,6 +80,8 @@ PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "If true, the model holds the reference set in "
+    "single precision, which halves its memory.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search options.
@@ -109,6 +111,7 @@ static void mlpackMain()
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "leaf_size");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "single_precision");
   ReportIgnoredParam({{ "input_model", true }}, "naive");
 
   // The user should give something to do...
@@ -181,7 +184,20 @@ static void mlpackMain()
         << referenceSet.n_rows << " x " << referenceSet.n_cols << ")."
         << endl;
 
-    rann->BuildModel(std::move(referenceSet), size_t(lsInt), naive, singleMode);
+    if (CLI::HasParam("single_precision"))
+    {
+      // Release the double precision copy before the tree is built.
+      arma::fmat floatReferenceSet =
+          arma::conv_to<arma::fmat>::from(referenceSet);
+      referenceSet.reset();
+      rann->BuildModel(std::move(floatReferenceSet), size_t(lsInt), naive,
+          singleMode);
+    }
+    else
+    {
+      rann->BuildModel(std::move(referenceSet), size_t(lsInt), naive,
+          singleMode);
+    }
   }
   else
   {
@@ -190,7 +206,7 @@ static void mlpackMain()
 
     Log::Info << "Using rank-approximate kNN model from '"
         << CLI::GetPrintableParam<RANNModel>("input_model") << "' (trained on "
-        << rann->Dataset().n_rows << "x" << rann->Dataset().n_cols
+        << rann->Dimensionality() << "x" << rann->NumPoints()
         << " dataset)." << endl;
 
     // Adjust singleMode and naive if necessary.
@@ -226,11 +242,11 @@ static void mlpackMain()
     // Sanity check on k value: must be greater than 0, must be less than the
     // number of reference points.  Since it is unsigned, we only test the upper
     // bound.
-    if (k > rann->Dataset().n_cols)
+    if (k > rann->NumPoints())
     {
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less ";
       Log::Fatal << "than or equal to the number of reference points (";
-      Log::Fatal << rann->Dataset().n_cols << ")." << endl;
+      Log::Fatal << rann->NumPoints() << ")." << endl;
     }
 
     arma::Mat<size_t> neighbors;
@@ -30,10 +30,11 @@ namespace neighbor {
 template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
 using RAType = RASearch<SortPolicy,
                         metric::EuclideanDistance,
-                        arma::mat,
+                        MatType,
                         TreeType>;
 
 /**
@@ -71,12 +72,12 @@ class MonoSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, before doing neighbor search
  * a query tree with proper leafSize is built from the querySet.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class BiSearchVisitor : public boost::static_visitor<void>
 {
  private:
   //! The query set for the bichromatic search.
-  const arma::mat& querySet;
+  const MatType& querySet;
   //! The number of neighbors to search for.
   const size_t k;
   //! The results matrix for neighbors.
@@ -95,7 +96,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using RATypeT = RAType<SortPolicy, TreeType>;
+  using RATypeT = RAType<SortPolicy, TreeType, MatType>;
 
   //! Default Bichromatic neighbor search on the given RAType instance.
   template<template<typename TreeMetricType,
@@ -110,7 +111,7 @@ class BiSearchVisitor : public boost::static_visitor<void>
   void operator()(RATypeT<tree::Octree>* ra) const;
 
   //! Construct the BiSearchVisitor.
-  BiSearchVisitor(const arma::mat& querySet,
+  BiSearchVisitor(const MatType& querySet,
                   const size_t k,
                   arma::Mat<size_t>& neighbors,
                   arma::mat& distances,
@@ -123,12 +124,12 @@ class BiSearchVisitor : public boost::static_visitor<void>
  * accept leafSize as a parameter. In these cases, a reference tree with proper
  * leafSize is built from the referenceSet.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class TrainVisitor : public boost::static_visitor<void>
 {
  private:
   //! The reference set to use for training.
-  arma::mat&& referenceSet;
+  MatType&& referenceSet;
   //! The leaf size, used only by BinarySpaceTree.
   size_t leafSize;
 
@@ -141,7 +142,7 @@ class TrainVisitor : public boost::static_visitor<void>
   template<template<typename TreeMetricType,
                     typename TreeStatType,
                     typename TreeMatType> class TreeType>
-  using RATypeT = RAType<SortPolicy, TreeType>;
+  using RATypeT = RAType<SortPolicy, TreeType, MatType>;
 
   //! Default Train on the given RAType instance.
   template<template<typename TreeMetricType,
@@ -157,7 +158,7 @@ class TrainVisitor : public boost::static_visitor<void>
 
   //! Construct the TrainVisitor object with the given reference set, leafSize
   //! for BinarySpaceTrees.
-  TrainVisitor(arma::mat&& referenceSet,
+  TrainVisitor(MatType&& referenceSet,
                const size_t leafSize);
 };
 
@@ -228,12 +229,13 @@ class SingleModeVisitor : public boost::static_visitor<bool&>
 /**
  * Exposes the referenceSet of the given RAType.
  */
-class ReferenceSetVisitor : public boost::static_visitor<const arma::mat&>
+template<typename MatType = arma::mat>
+class ReferenceSetVisitor : public boost::static_visitor<const MatType&>
 {
  public:
   //! Return the reference set.
   template<typename RAType>
-  const arma::mat& operator()(RAType* ra) const;
+  const MatType& operator()(RAType* ra) const;
 };
 
 /**
@@ -300,17 +302,27 @@ class RAModel
   //! The basis to project into.
   arma::mat q;
 
+  //! The RASearch types for each tree type, with the given matrix type.
+  template<typename MatType>
+  using RAVariant = boost::variant<
+      RAType<SortPolicy, tree::KDTree, MatType>*,
+      RAType<SortPolicy, tree::StandardCoverTree, MatType>*,
+      RAType<SortPolicy, tree::RTree, MatType>*,
+      RAType<SortPolicy, tree::RStarTree, MatType>*,
+      RAType<SortPolicy, tree::XTree, MatType>*,
+      RAType<SortPolicy, tree::HilbertRTree, MatType>*,
+      RAType<SortPolicy, tree::RPlusTree, MatType>*,
+      RAType<SortPolicy, tree::RPlusPlusTree, MatType>*,
+      RAType<SortPolicy, tree::UBTree, MatType>*,
+      RAType<SortPolicy, tree::Octree, MatType>*>;
+
+  //! If true, the reference set is held in single precision, in faSearch.
+  bool singlePrecision;
+
   //! The rank-approximate model.
-  boost::variant<RAType<SortPolicy, tree::KDTree>*,
-                 RAType<SortPolicy, tree::StandardCoverTree>*,
-                 RAType<SortPolicy, tree::RTree>*,
-                 RAType<SortPolicy, tree::RStarTree>*,
-                 RAType<SortPolicy, tree::XTree>*,
-                 RAType<SortPolicy, tree::HilbertRTree>*,
-                 RAType<SortPolicy, tree::RPlusTree>*,
-                 RAType<SortPolicy, tree::RPlusPlusTree>*,
-                 RAType<SortPolicy, tree::UBTree>*,
-                 RAType<SortPolicy, tree::Octree>*> raSearch;
+  RAVariant<arma::mat> raSearch;
+  //! The same as raSearch, for models built on single precision data.
+  RAVariant<arma::fmat> faSearch;
 
  public:
   /**
@@ -354,8 +366,20 @@ class RAModel
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
-  //! Expose the dataset.
+  //! Expose the dataset.  An exception is thrown if the model holds the
+  //! dataset in single precision.
   const arma::mat& Dataset() const;
+  //! Expose the dataset of a model built in single precision.  An exception is
+  //! thrown if the model holds the dataset in double precision.
+  const arma::fmat& FloatDataset() const;
+
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const;
+  //! Get the number of points in the reference set.
+  size_t NumPoints() const;
+
+  //! Get whether the reference set is held in single precision.
+  bool SinglePrecision() const { return singlePrecision; }
 
   //! Get whether or not single-tree search is being used.
   bool SingleMode() const;
@@ -414,13 +438,28 @@ class RAModel
                   const bool naive,
                   const bool singleMode);
 
+  //! Build the reference tree on a single precision reference set, which the
+  //! model keeps in single precision.  This halves the memory of the model.
+  void BuildModel(arma::fmat&& referenceSet,
+                  const size_t leafSize,
+                  const bool naive,
+                  const bool singleMode);
+
   //! Perform rank-approximate neighbor search, taking ownership of the query
-  //! set.
+  //! set.  The query set is converted to single precision if the model is.
   void Search(arma::mat&& querySet,
               const size_t k,
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  //! Perform rank-approximate neighbor search with a single precision query
+  //! set, taking ownership of it.  The query set is converted to double
+  //! precision if the model is.
+  void Search(arma::fmat&& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
   /**
    * Perform rank-approximate neighbor search, using the reference set as the
    * query set.
@@ -431,11 +470,38 @@ class RAModel
 
   //! Get the name of the tree type.
   std::string TreeName() const;
+
+ private:
+  //! Apply the given visitor to the RASearch object in use.
+  template<typename VisitorType>
+  typename VisitorType::result_type Apply(const VisitorType& visitor) const;
+
+  //! Build the reference tree in the given variant.
+  template<typename MatType>
+  void BuildModel(MatType&& referenceSet,
+                  RAVariant<MatType>& search,
+                  const bool naive,
+                  const bool singleMode);
+
+  //! Perform rank-approximate neighbor search with the given variant.
+  template<typename MatType>
+  void Search(MatType&& querySet,
+              RAVariant<MatType>& search,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Clean memory, if necessary.
+  void CleanMemory();
 };
 
 } // namespace neighbor
 } // namespace mlpack
 
+//! Set the serialization version of the RAModel class.
+BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
+    mlpack::neighbor::RAModel<SortPolicy>, 1);
+
 #include "ra_model_impl.hpp"
 
 #endif
@@ -30,12 +30,13 @@ void MonoSearchVisitor::operator()(RAType* ra) const
 }
 
 //! Save the parameters for the rank-approximate search.
-template<typename SortPolicy>
-BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
-                                 const size_t k,
-                                 arma::Mat<size_t>& neighbors,
-                                 arma::mat& distances,
-                                 const size_t leafSize) :
+template<typename SortPolicy, typename MatType>
+BiSearchVisitor<SortPolicy, MatType>::BiSearchVisitor(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const size_t leafSize) :
     querySet(querySet),
     k(k),
     neighbors(neighbors),
@@ -44,11 +45,12 @@ BiSearchVisitor<SortPolicy>::BiSearchVisitor(const arma::mat& querySet,
 {};
 
 //! Default Bichromatic search on the given RAType instance.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void BiSearchVisitor<SortPolicy>::operator()(RATypeT<TreeType>* ra) const
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    RATypeT<TreeType>* ra) const
 {
   if (ra)
     return ra->Search(querySet, k, neighbors, distances);
@@ -56,8 +58,9 @@ void BiSearchVisitor<SortPolicy>::operator()(RATypeT<TreeType>* ra) const
 }
 
 //! Bichromatic search on the given RAType specialized for KDTrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(RATypeT<tree::KDTree>* ra) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    RATypeT<tree::KDTree>* ra) const
 {
   if (ra)
     return SearchLeaf(ra);
@@ -65,8 +68,9 @@ void BiSearchVisitor<SortPolicy>::operator()(RATypeT<tree::KDTree>* ra) const
 }
 
 //! Bichromatic search on the given RAType specialized for Octrees.
-template<typename SortPolicy>
-void BiSearchVisitor<SortPolicy>::operator()(RATypeT<tree::Octree>* ra) const
+template<typename SortPolicy, typename MatType>
+void BiSearchVisitor<SortPolicy, MatType>::operator()(
+    RATypeT<tree::Octree>* ra) const
 {
   if (ra)
     return SearchLeaf(ra);
@@ -74,9 +78,9 @@ void BiSearchVisitor<SortPolicy>::operator()(RATypeT<tree::Octree>* ra) const
 }
 
 //! Bichromatic search on the given RAType considering the leafSize.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename RAType>
-void BiSearchVisitor<SortPolicy>::SearchLeaf(RAType* ra) const
+void BiSearchVisitor<SortPolicy, MatType>::SearchLeaf(RAType* ra) const
 {
   if (!ra->Naive() && !ra->SingleMode())
   {
@@ -110,19 +114,20 @@ void BiSearchVisitor<SortPolicy>::SearchLeaf(RAType* ra) const
 }
 
 //! Save parameters for the Train.
-template<typename SortPolicy>
-TrainVisitor<SortPolicy>::TrainVisitor(arma::mat&& referenceSet,
-                                       const size_t leafSize) :
+template<typename SortPolicy, typename MatType>
+TrainVisitor<SortPolicy, MatType>::TrainVisitor(MatType&& referenceSet,
+                                                const size_t leafSize) :
     referenceSet(std::move(referenceSet)),
     leafSize(leafSize)
 {};
 
 //! Default Train on the given RAType instance.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType>
-void TrainVisitor<SortPolicy>::operator()(RATypeT<TreeType>* ra) const
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    RATypeT<TreeType>* ra) const
 {
   if (ra)
     return ra->Train(std::move(referenceSet));
@@ -130,8 +135,9 @@ void TrainVisitor<SortPolicy>::operator()(RATypeT<TreeType>* ra) const
 }
 
 //! Train on the given RAType specialized for KDTrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(RATypeT<tree::KDTree>* ra) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    RATypeT<tree::KDTree>* ra) const
 {
   if (ra)
     return TrainLeaf(ra);
@@ -139,8 +145,9 @@ void TrainVisitor<SortPolicy>::operator()(RATypeT<tree::KDTree>* ra) const
 }
 
 //! Train on the given RAType specialized for Octrees.
-template<typename SortPolicy>
-void TrainVisitor<SortPolicy>::operator()(RATypeT<tree::Octree>* ra) const
+template<typename SortPolicy, typename MatType>
+void TrainVisitor<SortPolicy, MatType>::operator()(
+    RATypeT<tree::Octree>* ra) const
 {
   if (ra)
     return TrainLeaf(ra);
@@ -148,9 +155,9 @@ void TrainVisitor<SortPolicy>::operator()(RATypeT<tree::Octree>* ra) const
 }
 
 //! Train on the given RAType considering the leafSize.
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType>
 template<typename RAType>
-void TrainVisitor<SortPolicy>::TrainLeaf(RAType* ra) const
+void TrainVisitor<SortPolicy, MatType>::TrainLeaf(RAType* ra) const
 {
   // Build tree, if necessary
   if (ra->Naive())
@@ -226,8 +233,9 @@ bool& SingleModeVisitor::operator()(RAType* ra) const
 }
 
 //! Exposes the referenceSet of the given RAType.
+template<typename MatType>
 template<typename RAType>
-const arma::mat& ReferenceSetVisitor::operator()(RAType* ra) const
+const MatType& ReferenceSetVisitor<MatType>::operator()(RAType* ra) const
 {
   if (ra)
     return ra->ReferenceSet();
@@ -255,7 +263,8 @@ template<typename SortPolicy>
 RAModel<SortPolicy>::RAModel(const TreeTypes treeType, const bool randomBasis) :
     treeType(treeType),
     leafSize(20),
-    randomBasis(randomBasis)
+    randomBasis(randomBasis),
+    singlePrecision(false)
 {
   // Nothing to do.
 }
@@ -267,7 +276,9 @@ RAModel<SortPolicy>::RAModel(const RAModel& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(other.q),
-    raSearch(other.raSearch)
+    singlePrecision(other.singlePrecision),
+    raSearch(other.raSearch),
+    faSearch(other.faSearch)
 {
   // Nothing to do.
 }
@@ -279,13 +290,17 @@ RAModel<SortPolicy>::RAModel(RAModel&& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    raSearch(std::move(other.raSearch))
+    singlePrecision(other.singlePrecision),
+    raSearch(std::move(other.raSearch)),
+    faSearch(std::move(other.faSearch))
 {
   // Clear other model.
   other.treeType = TreeTypes::KD_TREE;
   other.leafSize = 20;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.raSearch = decltype(other.raSearch)();
+  other.faSearch = decltype(other.faSearch)();
 }
 
 // Copy operator.
@@ -293,13 +308,15 @@ template<typename SortPolicy>
 RAModel<SortPolicy>& RAModel<SortPolicy>::operator=(const RAModel& other)
 {
   // Clear current model.
-  boost::apply_visitor(DeleteVisitor(), raSearch);
+  CleanMemory();
 
   treeType = other.treeType;
   leafSize = other.leafSize;
   randomBasis = other.randomBasis;
   q = other.q;
+  singlePrecision = other.singlePrecision;
   raSearch = other.raSearch;
+  faSearch = other.faSearch;
 
   return *this;
 }
@@ -307,19 +324,23 @@ RAModel<SortPolicy>& RAModel<SortPolicy>::operator=(const RAModel& other)
 template<typename SortPolicy>
 RAModel<SortPolicy>& RAModel<SortPolicy>::operator=(RAModel&& other)
 {
-  boost::apply_visitor(DeleteVisitor(), raSearch);
+  CleanMemory();
 
   treeType = other.treeType;
   leafSize = other.leafSize;
   randomBasis = other.randomBasis;
   q = std::move(other.q);
+  singlePrecision = other.singlePrecision;
   raSearch = std::move(other.raSearch);
+  faSearch = std::move(other.faSearch);
 
   // Reset other model.
   other.treeType = TreeTypes::KD_TREE;
   other.leafSize = 20;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.raSearch = decltype(other.raSearch)();
+  other.faSearch = decltype(other.faSearch)();
 
   return *this;
 }
@@ -328,13 +349,13 @@ RAModel<SortPolicy>& RAModel<SortPolicy>::operator=(RAModel&& other)
 template<typename SortPolicy>
 RAModel<SortPolicy>::~RAModel()
 {
-  boost::apply_visitor(DeleteVisitor(), raSearch);
+  CleanMemory();
 }
 
 template<typename SortPolicy>
 template<typename Archive>
 void RAModel<SortPolicy>::serialize(Archive& ar,
-                                    const unsigned int /* version */)
+                                    const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(treeType);
   ar & BOOST_SERIALIZATION_NVP(randomBasis);
@@ -343,101 +364,140 @@ void RAModel<SortPolicy>::serialize(Archive& ar,
   // This should never happen, but just in case, be clean with memory.
   if (Archive::is_loading::value)
   {
-    boost::apply_visitor(DeleteVisitor(), raSearch);
+    CleanMemory();
   }
 
+  // Models before version 1 were always in double precision.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(singlePrecision);
+  else if (Archive::is_loading::value)
+    singlePrecision = false;
+
   // We only need to serialize one of the kRANN objects.
-  ar & BOOST_SERIALIZATION_NVP(raSearch);
+  if (singlePrecision)
+    ar & BOOST_SERIALIZATION_NVP(faSearch);
+  else
+    ar & BOOST_SERIALIZATION_NVP(raSearch);
 }
 
 template<typename SortPolicy>
 const arma::mat& RAModel<SortPolicy>::Dataset() const
 {
-  return boost::apply_visitor(ReferenceSetVisitor(), raSearch);
+  if (singlePrecision)
+  {
+    throw std::invalid_argument("RAModel::Dataset(): the model holds the "
+        "dataset in single precision; use FloatDataset()");
+  }
+
+  return boost::apply_visitor(ReferenceSetVisitor<arma::mat>(), raSearch);
+}
+
+template<typename SortPolicy>
+const arma::fmat& RAModel<SortPolicy>::FloatDataset() const
+{
+  if (!singlePrecision)
+  {
+    throw std::invalid_argument("RAModel::FloatDataset(): the model holds the "
+        "dataset in double precision; use Dataset()");
+  }
+
+  return boost::apply_visitor(ReferenceSetVisitor<arma::fmat>(), faSearch);
+}
+
+template<typename SortPolicy>
+size_t RAModel<SortPolicy>::Dimensionality() const
+{
+  return singlePrecision ? FloatDataset().n_rows : Dataset().n_rows;
+}
+
+template<typename SortPolicy>
+size_t RAModel<SortPolicy>::NumPoints() const
+{
+  return singlePrecision ? FloatDataset().n_cols : Dataset().n_cols;
 }
 
 template<typename SortPolicy>
 bool RAModel<SortPolicy>::Naive() const
 {
-  return boost::apply_visitor(NaiveVisitor(), raSearch);
+  return Apply(NaiveVisitor());
 }
 
 template<typename SortPolicy>
 bool& RAModel<SortPolicy>::Naive()
 {
-  return boost::apply_visitor(NaiveVisitor(), raSearch);
+  return Apply(NaiveVisitor());
 }
 
 template<typename SortPolicy>
 bool RAModel<SortPolicy>::SingleMode() const
 {
-  return boost::apply_visitor(SingleModeVisitor(), raSearch);
+  return Apply(SingleModeVisitor());
 }
 
 template<typename SortPolicy>
 bool& RAModel<SortPolicy>::SingleMode()
 {
-  return boost::apply_visitor(SingleModeVisitor(), raSearch);
+  return Apply(SingleModeVisitor());
 }
 
 template<typename SortPolicy>
 double RAModel<SortPolicy>::Tau() const
 {
-  return boost::apply_visitor(TauVisitor(), raSearch);
+  return Apply(TauVisitor());
 }
 
 template<typename SortPolicy>
 double& RAModel<SortPolicy>::Tau()
 {
-  return boost::apply_visitor(TauVisitor(), raSearch);
+  return Apply(TauVisitor());
 }
 
 template<typename SortPolicy>
 double RAModel<SortPolicy>::Alpha() const
 {
-  return boost::apply_visitor(AlphaVisitor(), raSearch);
+  return Apply(AlphaVisitor());
 }
 
 template<typename SortPolicy>
 double& RAModel<SortPolicy>::Alpha()
 {
-  return boost::apply_visitor(AlphaVisitor(), raSearch);
+  return Apply(AlphaVisitor());
 }
 
 template<typename SortPolicy>
 bool RAModel<SortPolicy>::SampleAtLeaves() const
 {
-  return boost::apply_visitor(SampleAtLeavesVisitor(), raSearch);
+  return Apply(SampleAtLeavesVisitor());
 }
 
 template<typename SortPolicy>
 bool& RAModel<SortPolicy>::SampleAtLeaves()
 {
-  return boost::apply_visitor(SampleAtLeavesVisitor(), raSearch);
+  return Apply(SampleAtLeavesVisitor());
 }
 
 template<typename SortPolicy>
 bool RAModel<SortPolicy>::FirstLeafExact() const
 {
-  return boost::apply_visitor(FirstLeafExactVisitor(), raSearch);
+  return Apply(FirstLeafExactVisitor());
 }
 
 template<typename SortPolicy>
 bool& RAModel<SortPolicy>::FirstLeafExact()
 {
-  return boost::apply_visitor(FirstLeafExactVisitor(), raSearch);
+  return Apply(FirstLeafExactVisitor());
 }
 
 template<typename SortPolicy>
 size_t RAModel<SortPolicy>::SingleSampleLimit() const
 {
-  return boost::apply_visitor(SingleSampleLimitVisitor(), raSearch);
+  return Apply(SingleSampleLimitVisitor());
 }
 
 template<typename SortPolicy>
 size_t& RAModel<SortPolicy>::SingleSampleLimit()
 {
-  return boost::apply_visitor(SingleSampleLimitVisitor(), raSearch);
+  return Apply(SingleSampleLimitVisitor());
 }
 
 template<typename SortPolicy>
@@ -481,6 +541,36 @@ void RAModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
                                      const size_t leafSize,
                                      const bool naive,
                                      const bool singleMode)
+{
+  // Clean memory, if necessary.
+  CleanMemory();
+
+  this->leafSize = leafSize;
+  singlePrecision = false;
+  BuildModel<arma::mat>(std::move(referenceSet), raSearch, naive, singleMode);
+}
+
+template<typename SortPolicy>
+void RAModel<SortPolicy>::BuildModel(arma::fmat&& referenceSet,
+                                     const size_t leafSize,
+                                     const bool naive,
+                                     const bool singleMode)
+{
+  // Clean memory, if necessary.
+  CleanMemory();
+
+  this->leafSize = leafSize;
+  singlePrecision = true;
+  BuildModel<arma::fmat>(std::move(referenceSet), faSearch, naive,
+      singleMode);
+}
+
+template<typename SortPolicy>
+template<typename MatType>
+void RAModel<SortPolicy>::BuildModel(MatType&& referenceSet,
+                                     RAVariant<MatType>& search,
+                                     const bool naive,
+                                     const bool singleMode)
 {
   // Initialize random basis, if necessary.
   if (randomBasis)
@@ -489,13 +579,8 @@ void RAModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
     math::RandomBasis(q, referenceSet.n_rows);
   }
 
-  // Clean memory, if necessary.
-  boost::apply_visitor(DeleteVisitor(), raSearch);
-
-  this->leafSize = leafSize;
-
   if (randomBasis)
-    referenceSet = q * referenceSet;
+    referenceSet = arma::conv_to<MatType>::from(q) * referenceSet;
 
   if (!naive)
   {
@@ -506,41 +591,47 @@ void RAModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
   switch (treeType)
   {
     case KD_TREE:
-      raSearch = new RAType<SortPolicy, tree::KDTree>(naive, singleMode);
+      search = new RAType<SortPolicy, tree::KDTree, MatType>(naive,
+          singleMode);
       break;
     case COVER_TREE:
-      raSearch = new RAType<SortPolicy, tree::StandardCoverTree>(naive,
+      search = new RAType<SortPolicy, tree::StandardCoverTree, MatType>(naive,
           singleMode);
       break;
     case R_TREE:
-      raSearch = new RAType<SortPolicy, tree::RTree>(naive, singleMode);
+      search = new RAType<SortPolicy, tree::RTree, MatType>(naive, singleMode);
       break;
     case R_STAR_TREE:
-      raSearch = new RAType<SortPolicy, tree::RStarTree>(naive, singleMode);
+      search = new RAType<SortPolicy, tree::RStarTree, MatType>(naive,
+          singleMode);
       break;
     case X_TREE:
-      raSearch = new RAType<SortPolicy, tree::XTree>(naive, singleMode);
+      search = new RAType<SortPolicy, tree::XTree, MatType>(naive, singleMode);
       break;
     case HILBERT_R_TREE:
-      raSearch = new RAType<SortPolicy, tree::HilbertRTree>(naive, singleMode);
+      search = new RAType<SortPolicy, tree::HilbertRTree, MatType>(naive,
+          singleMode);
       break;
     case R_PLUS_TREE:
-      raSearch = new RAType<SortPolicy, tree::RPlusTree>(naive, singleMode);
+      search = new RAType<SortPolicy, tree::RPlusTree, MatType>(naive,
+          singleMode);
       break;
     case R_PLUS_PLUS_TREE:
-      raSearch = new RAType<SortPolicy, tree::RPlusPlusTree>(naive,
+      search = new RAType<SortPolicy, tree::RPlusPlusTree, MatType>(naive,
           singleMode);
       break;
     case UB_TREE:
-      raSearch = new RAType<SortPolicy, tree::UBTree>(naive, singleMode);
+      search = new RAType<SortPolicy, tree::UBTree, MatType>(naive,
+          singleMode);
       break;
     case OCTREE:
-      raSearch = new RAType<SortPolicy, tree::Octree>(naive, singleMode);
+      search = new RAType<SortPolicy, tree::Octree, MatType>(naive,
+          singleMode);
       break;
   }
 
-  TrainVisitor<SortPolicy> tn(std::move(referenceSet), leafSize);
-  boost::apply_visitor(tn, raSearch);
+  TrainVisitor<SortPolicy, MatType> tn(std::move(referenceSet), leafSize);
+  boost::apply_visitor(tn, search);
 
   if (!naive)
   {
@@ -554,10 +645,51 @@ void RAModel<SortPolicy>::Search(arma::mat&& querySet,
                                  const size_t k,
                                  arma::Mat<size_t>& neighbors,
                                  arma::mat& distances)
+{
+  if (singlePrecision)
+  {
+    arma::fmat floatQuerySet = arma::conv_to<arma::fmat>::from(querySet);
+    querySet.reset();
+    Search<arma::fmat>(std::move(floatQuerySet), faSearch, k, neighbors,
+        distances);
+  }
+  else
+  {
+    Search<arma::mat>(std::move(querySet), raSearch, k, neighbors, distances);
+  }
+}
+
+template<typename SortPolicy>
+void RAModel<SortPolicy>::Search(arma::fmat&& querySet,
+                                 const size_t k,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& distances)
+{
+  if (singlePrecision)
+  {
+    Search<arma::fmat>(std::move(querySet), faSearch, k, neighbors,
+        distances);
+  }
+  else
+  {
+    arma::mat doubleQuerySet = arma::conv_to<arma::mat>::from(querySet);
+    querySet.reset();
+    Search<arma::mat>(std::move(doubleQuerySet), raSearch, k, neighbors,
+        distances);
+  }
+}
+
+template<typename SortPolicy>
+template<typename MatType>
+void RAModel<SortPolicy>::Search(MatType&& querySet,
+                                 RAVariant<MatType>& search,
+                                 const size_t k,
+                                 arma::Mat<size_t>& neighbors,
+                                 arma::mat& distances)
 {
   // Apply the random basis if necessary.
   if (randomBasis)
-    querySet = q * querySet;
+    querySet = arma::conv_to<MatType>::from(q) * querySet;
 
   Log::Info << "Searching for " << k << " approximate nearest neighbors with ";
   if (!Naive() && !SingleMode())
@@ -568,9 +700,9 @@ void RAModel<SortPolicy>::Search(arma::mat&& querySet,
     Log::Info << "brute-force (naive) rank-approximate search...";
   Log::Info << std::endl;
 
-  BiSearchVisitor<SortPolicy> search(querySet, k, neighbors, distances,
-      leafSize);
-  boost::apply_visitor(search, raSearch);
+  BiSearchVisitor<SortPolicy, MatType> visitor(querySet, k, neighbors,
+      distances, leafSize);
+  boost::apply_visitor(visitor, search);
 }
 
 template<typename SortPolicy>
@@ -588,7 +720,29 @@ void RAModel<SortPolicy>::Search(const size_t k,
   Log::Info << std::endl;
 
   MonoSearchVisitor search(k, neighbors, distances);
-  boost::apply_visitor(search, raSearch);
+  Apply(search);
+}
+
+//! Apply the given visitor to the RASearch object in use.
+template<typename SortPolicy>
+template<typename VisitorType>
+typename VisitorType::result_type RAModel<SortPolicy>::Apply(
+    const VisitorType& visitor) const
+{
+  if (singlePrecision)
+    return boost::apply_visitor(visitor, faSearch);
+  else
+    return boost::apply_visitor(visitor, raSearch);
+}
+
+//! Clean memory, if necessary.
+template<typename SortPolicy>
+void RAModel<SortPolicy>::CleanMemory()
+{
+  boost::apply_visitor(DeleteVisitor(), raSearch);
+  boost::apply_visitor(DeleteVisitor(), faSearch);
+  raSearch = decltype(raSearch)();
+  faSearch = decltype(faSearch)();
 }
 
 template<typename SortPolicy>
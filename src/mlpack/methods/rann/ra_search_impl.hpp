@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "ra_search_rules.hpp"
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -376,9 +377,9 @@ Search(const MatType& querySet,
 
     // Run the base case on each combination of query point and sampled
     // reference point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        rules.BaseCase(i, (size_t) distinctSamples[j]);
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+      rules.BaseCases(i, distinctSamples);
 
     rules.GetResults(*neighborPtr, *distancePtr);
   }
@@ -393,12 +394,19 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+      // Traverse for each point in parallel; each thread has its own
+      // traverser, and the rules only hold separate state for each point.
+      #pragma omp parallel
+      {
+        typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        {
+          rules.StartQuery(i);
+          traverser.Traverse(i, *referenceTree);
+        }
+      }
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
@@ -422,12 +430,11 @@ Search(const MatType& querySet,
 
     RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
         naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
     Log::Info << "Query statistic pre-search: "
         << queryTree->Stat().NumSamplesMade() << std::endl;
 
-    traverser.Traverse(*queryTree, *referenceTree);
+    tree::TraverseWithStatistics<Tree::template DualTreeTraverser>(rules,
+        *queryTree, *referenceTree, "rank-approximate search");
 
     Log::Info << "Dual-tree traversal complete." << std::endl;
     Log::Info << "Average number of distance calculations per query point: "
@@ -536,9 +543,9 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
       naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  // Traverse the trees.
+  tree::TraverseWithStatistics<Tree::template DualTreeTraverser>(rules,
+      *queryTree, *referenceTree, "rank-approximate search");
 
   rules.GetResults(*neighborPtr, distances);
 
@@ -603,25 +610,31 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
         distinctSamples);
 
     // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    const arma::uvec allPoints = arma::regspace<arma::uvec>(0,
+        referenceSet->n_cols - 1);
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+      rules.BaseCases(i, allPoints);
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    // Traverse for each point in parallel, with a traverser for each thread.
+    #pragma omp parallel
+    {
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+      {
+        rules.StartQuery(i);
+        traverser.Traverse(i, *referenceTree);
+      }
+    }
   }
   else
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    tree::TraverseWithStatistics<Tree::template DualTreeTraverser>(rules,
+        *referenceTree, *referenceTree, "rank-approximate search");
   }
 
   rules.GetResults(*neighborPtr, *distancePtr);
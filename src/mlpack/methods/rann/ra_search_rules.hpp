@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_RANN_RA_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/leaf_base_case.hpp>
 
 #include <queue>
 
@@ -54,8 +55,8 @@ class RASearchRules
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
    */
-  RASearchRules(const arma::mat& referenceSet,
-                const arma::mat& querySet,
+  RASearchRules(const typename TreeType::Mat& referenceSet,
+                const typename TreeType::Mat& querySet,
                 const size_t k,
                 MetricType& metric,
                 const double tau = 5,
@@ -84,6 +85,27 @@ class RASearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between the query point and each of the given
+   * reference points.  For the Euclidean distance on dense matrices, the
+   * distances are computed in blocks; otherwise, this calls BaseCase() for
+   * each reference point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndices Indices of reference points.
+   */
+  void BaseCases(const size_t queryIndex, const arma::uvec& referenceIndices);
+
+  /**
+   * Prepare the random number generator of the calling thread for the
+   * single-tree traversal of the given query point.  The samples made for a
+   * query point then do not depend on the number of threads.  Several threads
+   * may traverse different query points at the same time.
+   *
+   * @param queryIndex Index of query point.
+   */
+  void StartQuery(const size_t queryIndex);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -227,7 +249,13 @@ class RASearchRules
                  const double oldScore);
 
 
-  size_t NumDistComputations() { return numDistComputations; }
+  size_t NumDistComputations()
+  {
+    if (numDistComputations.n_elem == 0)
+      return 0;
+    else
+      return arma::sum(numDistComputations);
+  }
   size_t NumEffectiveSamples()
   {
     if (numSamplesMade.n_elem == 0)
@@ -243,10 +271,10 @@ class RASearchRules
 
  private:
   //! The reference set.
-  const arma::mat& referenceSet;
+  const typename TreeType::Mat& referenceSet;
 
   //! The query set.
-  const arma::mat& querySet;
+  const typename TreeType::Mat& querySet;
 
   //! Candidate represents a possible candidate neighbor (distance, index).
   typedef std::pair<double, size_t> Candidate;
@@ -290,14 +318,56 @@ class RASearchRules
   //! The sampling ratio.
   double samplingRatio;
 
-  //! The number of distance calculations performed during search.
-  size_t numDistComputations;
+  //! The number of distance calculations performed for every query.
+  arma::Col<size_t> numDistComputations;
 
   //! If the query and reference set are identical, this is true.
   bool sameSet;
 
   TraversalInfoType traversalInfo;
 
+  //! The seed of the random samples; query i uses the seed seed + i.
+  size_t seed;
+
+  //! The random number generator of each thread.
+  std::vector<std::mt19937> generators;
+
+  /**
+   * Sample distinct points uniformly from [0, numPoints) with the generator of
+   * the calling thread, like math::ObtainDistinctSamples(); all the points are
+   * returned if numSamples is not smaller than numPoints.
+   *
+   * @param numPoints Number of points to sample from.
+   * @param numSamples Number of samples to draw (with replacement).
+   * @param distinctSamples The distinct samples, in increasing order.
+   */
+  void ObtainDistinctSamples(const size_t numPoints,
+                             const size_t numSamples,
+                             arma::uvec& distinctSamples);
+
+  /**
+   * Sample the given number of descendants of the reference node, and compute
+   * their base cases with the query point.  The counting of the samples is
+   * done by BaseCase().
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Node to sample from.
+   * @param numSamples Number of samples to draw.
+   */
+  void SampleNode(const size_t queryIndex,
+                  TreeType& referenceNode,
+                  const size_t numSamples);
+
+  //! Compute the base cases in blocks, for the dense Euclidean distance.
+  void BaseCases(const size_t queryIndex,
+                 const arma::uvec& referenceIndices,
+                 const std::true_type /* blocked */);
+
+  //! Compute the base cases one by one.
+  void BaseCases(const size_t queryIndex,
+                 const arma::uvec& referenceIndices,
+                 const std::false_type /* blocked */);
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
@@ -20,8 +20,8 @@ namespace neighbor {
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
 RASearchRules<SortPolicy, MetricType, TreeType>::
-RASearchRules(const arma::mat& referenceSet,
-              const arma::mat& querySet,
+RASearchRules(const typename TreeType::Mat& referenceSet,
+              const typename TreeType::Mat& querySet,
               const size_t k,
               MetricType& metric,
               const double tau,
@@ -64,7 +64,7 @@ RASearchRules(const arma::mat& referenceSet,
 
   // Initialize some statistics to be collected during the search.
   numSamplesMade = arma::zeros<arma::Col<size_t> >(querySet.n_cols);
-  numDistComputations = 0;
+  numDistComputations = arma::zeros<arma::Col<size_t> >(querySet.n_cols);
   samplingRatio = (double) numSamplesReqd / (double) n;
 
   Log::Info << "Minimum samples required per query: " << numSamplesReqd <<
@@ -84,19 +84,90 @@ RASearchRules(const arma::mat& referenceSet,
   for (size_t i = 0; i < querySet.n_cols; i++)
     candidates.push_back(pqueue);
 
+  // Each thread draws its samples with its own generator.  The generator of
+  // the first thread is also used by the dual-tree traversal, which does not
+  // call StartQuery().
+  size_t threads = 1;
+  #ifdef HAS_OPENMP
+    threads = omp_get_max_threads();
+  #endif
+  seed = (size_t) math::RandInt(std::numeric_limits<int>::max());
+  generators.resize(threads, std::mt19937((uint32_t) seed));
+
   if (naive) // No tree traversal; just do naive sampling here.
   {
-    // Sample enough points.
-    arma::uvec distinctSamples;
-    for (size_t i = 0; i < querySet.n_cols; ++i)
+    // Sample enough points for each query point.
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
     {
-      math::ObtainDistinctSamples(0, n, numSamplesReqd, distinctSamples);
-      for (size_t j = 0; j < distinctSamples.n_elem; j++)
-        BaseCase(i, (size_t) distinctSamples[j]);
+      StartQuery(i);
+
+      arma::uvec distinctSamples;
+      ObtainDistinctSamples(n, numSamplesReqd, distinctSamples);
+      BaseCases(i, distinctSamples);
     }
   }
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::StartQuery(
+    const size_t queryIndex)
+{
+  size_t thread = 0;
+  #ifdef HAS_OPENMP
+    thread = omp_get_thread_num();
+  #endif
+
+  generators[thread].seed((uint32_t) (seed + queryIndex));
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::ObtainDistinctSamples(
+    const size_t numPoints,
+    const size_t numSamples,
+    arma::uvec& distinctSamples)
+{
+  if (numSamples == 0)
+  {
+    distinctSamples.reset();
+  }
+  else if (numPoints > numSamples)
+  {
+    size_t thread = 0;
+    #ifdef HAS_OPENMP
+      thread = omp_get_thread_num();
+    #endif
+
+    // Sort the samples and remove the duplicates, instead of marking the
+    // sampled points of the whole range.
+    std::uniform_int_distribution<size_t> distribution(0, numPoints - 1);
+    arma::uvec samples(numSamples);
+    for (size_t i = 0; i < numSamples; ++i)
+      samples[i] = distribution(generators[thread]);
+
+    distinctSamples = arma::unique(samples);
+  }
+  else
+  {
+    distinctSamples = arma::regspace<arma::uvec>(0, numPoints - 1);
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::SampleNode(
+    const size_t queryIndex,
+    TreeType& referenceNode,
+    const size_t numSamples)
+{
+  arma::uvec distinctSamples;
+  ObtainDistinctSamples(referenceNode.NumDescendants(), numSamples,
+      distinctSamples);
+  for (size_t i = 0; i < distinctSamples.n_elem; ++i)
+    distinctSamples[i] = referenceNode.Descendant(distinctSamples[i]);
+
+  BaseCases(queryIndex, distinctSamples);
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void RASearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -135,17 +206,74 @@ double RASearchRules<SortPolicy, MetricType, TreeType>::BaseCase(
 
   numSamplesMade[queryIndex]++;
 
-  numDistComputations++;
+  numDistComputations[queryIndex]++;
 
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::BaseCases(
+    const size_t queryIndex,
+    const arma::uvec& referenceIndices)
+{
+  BaseCases(queryIndex, referenceIndices, std::integral_constant<bool,
+      tree::LeafDistances<MetricType, typename TreeType::Mat>::Supported>());
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::BaseCases(
+    const size_t queryIndex,
+    const arma::uvec& referenceIndices,
+    const std::true_type /* blocked */)
+{
+  typedef typename TreeType::ElemType ElemType;
+
+  // Bound the memory used for the block of reference points.
+  const size_t blockSize = 1024;
+  const arma::Col<ElemType> queryPoint = querySet.unsafe_col(queryIndex);
+  for (size_t begin = 0; begin < referenceIndices.n_elem; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, referenceIndices.n_elem);
+    const arma::uvec block = referenceIndices.subvec(begin, end - 1);
+
+    arma::Row<ElemType> blockDistances = arma::sum(arma::square(
+        referenceSet.cols(block).each_col() - queryPoint), 0);
+    if (MetricType::TakeRoot)
+      blockDistances = arma::sqrt(blockDistances);
+
+    for (size_t i = 0; i < block.n_elem; ++i)
+    {
+      // A query point is not its own neighbor.
+      if (sameSet && (queryIndex == block[i]))
+        continue;
+
+      InsertNeighbor(queryIndex, block[i], blockDistances[i]);
+    }
+
+    const size_t computations = (sameSet && arma::any(block == queryIndex)) ?
+        block.n_elem - 1 : block.n_elem;
+    numSamplesMade[queryIndex] += computations;
+    numDistComputations[queryIndex] += computations;
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void RASearchRules<SortPolicy, MetricType, TreeType>::BaseCases(
+    const size_t queryIndex,
+    const arma::uvec& referenceIndices,
+    const std::false_type /* blocked */)
+{
+  for (size_t i = 0; i < referenceIndices.n_elem; ++i)
+    BaseCase(queryIndex, referenceIndices[i]);
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
     TreeType& referenceNode)
 {
-  const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
+  const arma::Col<typename TreeType::ElemType> queryPoint =
+      querySet.unsafe_col(queryIndex);
   const double distance = SortPolicy::BestPointToNodeDistance(queryPoint,
       &referenceNode);
   const double bestDistance = candidates[queryIndex].top().first;
@@ -159,7 +287,8 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
     TreeType& referenceNode,
     const double baseCaseResult)
 {
-  const arma::vec queryPoint = querySet.unsafe_col(queryIndex);
+  const arma::Col<typename TreeType::ElemType> queryPoint =
+      querySet.unsafe_col(queryIndex);
   const double distance = SortPolicy::BestPointToNodeDistance(queryPoint,
       &referenceNode, baseCaseResult);
   const double bestDistance = candidates[queryIndex].top().first;
@@ -203,13 +332,9 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
         {
           // Then samplesReqd <= singleSampleLimit.
           // Hence, approximate the node by sampling enough number of points.
-          arma::uvec distinctSamples;
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
-          for (size_t i = 0; i < distinctSamples.n_elem; i++)
-            // The counting of the samples are done in the 'BaseCase' function
-            // so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+          // The counting of the samples is done in BaseCase(), so no
+          // book-keeping is required here.
+          SampleNode(queryIndex, referenceNode, samplesReqd);
 
           // Node approximated, so we can prune it.
           return DBL_MAX;
@@ -219,14 +344,9 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           if (sampleAtLeaves) // If allowed to sample at leaves.
           {
             // Approximate node by sampling enough number of points.
-            arma::uvec distinctSamples;
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
-            for (size_t i = 0; i < distinctSamples.n_elem; i++)
-              // The counting of the samples are done in the 'BaseCase' function
-              // so no book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[i]));
+            // The counting of the samples is done in BaseCase(), so no
+            // book-keeping is required here.
+            SampleNode(queryIndex, referenceNode, samplesReqd);
 
             // (Leaf) node approximated, so we can prune it.
             return DBL_MAX;
@@ -307,13 +427,9 @@ Rescore(const size_t queryIndex,
       {
         // Then, samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough number of points.
-        arma::uvec distinctSamples;
-        math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-            samplesReqd, distinctSamples);
-        for (size_t i = 0; i < distinctSamples.n_elem; i++)
-          // The counting of the samples are done in the 'BaseCase' function so
-          // no book-keeping is required here.
-          BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+        // The counting of the samples is done in BaseCase(), so no
+        // book-keeping is required here.
+        SampleNode(queryIndex, referenceNode, samplesReqd);
 
         // Node approximated, so we can prune it.
         return DBL_MAX;
@@ -323,13 +439,9 @@ Rescore(const size_t queryIndex,
         if (sampleAtLeaves)
         {
           // Approximate node by sampling enough points.
-          arma::uvec distinctSamples;
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
-          for (size_t i = 0; i < distinctSamples.n_elem; i++)
-            // The counting of the samples are done in the 'BaseCase' function
-            // so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+          // The counting of the samples is done in BaseCase(), so no
+          // book-keeping is required here.
+          SampleNode(queryIndex, referenceNode, samplesReqd);
 
           // (Leaf) node approximated, so we can prune it.
           return DBL_MAX;
@@ -507,18 +619,10 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
         {
           // Then samplesReqd <= singleSampleLimit.  Hence, approximate node by
           // sampling enough number of points for every query in the query node.
-          arma::uvec distinctSamples;
+          // The counting of the samples is done in BaseCase(), so no
+          // book-keeping is required here.
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-          {
-            const size_t queryIndex = queryNode.Descendant(i);
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
-            for (size_t j = 0; j < distinctSamples.n_elem; j++)
-              // The counting of the samples are done in the 'BaseCase' function
-              // so no book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[j]));
-          }
+            SampleNode(queryNode.Descendant(i), referenceNode, samplesReqd);
 
           // Update the number of samples made for the queryNode and also update
           // the number of sample made for the child nodes.
@@ -537,18 +641,10 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           {
             // Approximate node by sampling enough number of points for every
             // query in the query node.
-            arma::uvec distinctSamples;
+            // The counting of the samples is done in BaseCase(), so no
+            // book-keeping is required here.
             for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-            {
-              const size_t queryIndex = queryNode.Descendant(i);
-              math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                  samplesReqd, distinctSamples);
-              for (size_t j = 0; j < distinctSamples.n_elem; j++)
-                // The counting of the samples are done in the 'BaseCase'
-                // function so no book-keeping is required here.
-                BaseCase(queryIndex,
-                    referenceNode.Descendant(distinctSamples[j]));
-            }
+              SampleNode(queryNode.Descendant(i), referenceNode, samplesReqd);
 
             // Update the number of samples made for the queryNode and also
             // update the number of sample made for the child nodes.
@@ -712,17 +808,10 @@ Rescore(TreeType& queryNode,
       {
         // then samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough points for every query in the query node.
-        arma::uvec distinctSamples;
+        // The counting of the samples is done in BaseCase(), so no
+        // book-keeping is required here.
         for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-        {
-          const size_t queryIndex = queryNode.Descendant(i);
-          math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-              samplesReqd, distinctSamples);
-          for (size_t j = 0; j < distinctSamples.n_elem; j++)
-            // The counting of the samples are done in the 'BaseCase'
-            // function so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[j]));
-        }
+          SampleNode(queryNode.Descendant(i), referenceNode, samplesReqd);
 
         // Update the number of samples made for the query node and also update
         // the number of samples made for the child nodes.
@@ -741,18 +830,10 @@ Rescore(TreeType& queryNode,
         {
           // Approximate node by sampling enough points for every query in the
           // query node.
-          arma::uvec distinctSamples;
+          // The counting of the samples is done in BaseCase(), so no
+          // book-keeping is required here.
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-          {
-            const size_t queryIndex = queryNode.Descendant(i);
-            math::ObtainDistinctSamples(0, referenceNode.NumDescendants(),
-                samplesReqd, distinctSamples);
-            for (size_t j = 0; j < distinctSamples.n_elem; j++)
-              // The counting of the samples are done in BaseCase() so no
-              // book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[j]));
-          }
+            SampleNode(queryNode.Descendant(i), referenceNode, samplesReqd);
 
           // Update the number of samples made for the query node and also
           // update the number of samples made for the child nodes.
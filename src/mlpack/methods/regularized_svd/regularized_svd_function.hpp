@@ -96,6 +96,21 @@ class RegularizedSVDFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluates the gradient of the cost function over the given training
+   * examples, as a sparse matrix: only the columns of the users and items of
+   * the examples are nonzero.
+   *
+   * @param parameters Parameters(user/item matrices) of the decomposition.
+   * @param start The first index of the training examples to use.
+   * @param gradient Calculated gradient for the parameters.
+   * @param batchSize Size of batch to calculate gradient for.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t start,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
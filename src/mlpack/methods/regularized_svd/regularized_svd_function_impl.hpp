@@ -122,25 +122,56 @@ void RegularizedSVDFunction<MatType>::Gradient(const arma::mat& parameters,
   // The full gradient is calculated by summing the contributions over all the
   // training examples.
 
-  gradient.zeros(rank, numUsers + numItems);
+  const size_t numColumns = numUsers + numItems;
+  gradient.zeros(rank, numColumns);
 
-  for (size_t i = 0; i < data.n_cols; i++)
+  // Compute the prediction errors in parallel.
+  arma::vec errors(data.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
-    // Indices for accessing the the correct parameter columns.
     const size_t user = data(0, i);
     const size_t item = data(1, i) + numUsers;
+    errors[i] = data(2, i) - arma::dot(parameters.col(user),
+                                       parameters.col(item));
+  }
 
-    // Prediction error for the example.
-    const double rating = data(2, i);
-    double ratingError = rating - arma::dot(parameters.col(user),
-                                            parameters.col(item));
+  // Group the examples by the parameter columns they contribute to (each
+  // example contributes to one user column and one item column), so that each
+  // column of the gradient is summed by one thread, with no atomic operations.
+  // The examples are summed in the same order as in a serial loop.
+  arma::Col<size_t> starts(numColumns + 1, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    ++starts[(size_t) data(0, i) + 1];
+    ++starts[(size_t) data(1, i) + numUsers + 1];
+  }
+  for (size_t c = 1; c < starts.n_elem; ++c)
+    starts[c] += starts[c - 1];
 
-    // Gradient is non-zero only for the parameter columns corresponding to the
-    // example.
-    gradient.col(user) += 2 * (lambda * parameters.col(user) -
-                               ratingError * parameters.col(item));
-    gradient.col(item) += 2 * (lambda * parameters.col(item) -
-                               ratingError * parameters.col(user));
+  arma::Col<size_t> position = starts.head(numColumns);
+  arma::Col<size_t> examples(2 * data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    examples[position[(size_t) data(0, i)]++] = i;
+    examples[position[(size_t) data(1, i) + numUsers]++] = i;
+  }
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t c = 0; c < (omp_size_t) numColumns; ++c)
+  {
+    for (size_t k = starts[c]; k < starts[c + 1]; ++k)
+    {
+      const size_t i = examples[k];
+      const size_t user = data(0, i);
+      const size_t item = data(1, i) + numUsers;
+      const size_t other = ((size_t) c == user) ? item : user;
+
+      // Gradient is non-zero only for the parameter columns corresponding to
+      // the example.
+      gradient.col(c) += 2 * (lambda * parameters.col(c) -
+                              errors[i] * parameters.col(other));
+    }
   }
 }
 
@@ -173,6 +204,42 @@ void RegularizedSVDFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void RegularizedSVDFunction<MatType>::Gradient(const arma::mat& parameters,
+                                               const size_t start,
+                                               arma::sp_mat& gradient,
+                                               const size_t batchSize) const
+{
+  // Only the user and item columns of the examples are nonzero, so the
+  // gradient is assembled from their locations; duplicates are summed.
+  arma::umat locations(2, 2 * rank * batchSize);
+  arma::vec values(2 * rank * batchSize);
+  for (size_t i = start, k = 0; i < start + batchSize; ++i)
+  {
+    const size_t user = data(0, i);
+    const size_t item = data(1, i) + numUsers;
+
+    // Prediction error for the example.
+    const double rating = data(2, i);
+    double ratingError = rating - arma::dot(parameters.col(user),
+                                            parameters.col(item));
+
+    for (size_t d = 0; d < rank; ++d, k += 2)
+    {
+      locations(0, k) = d;
+      locations(1, k) = user;
+      values[k] = 2 * (lambda * parameters(d, user) -
+                       ratingError * parameters(d, item));
+      locations(0, k + 1) = d;
+      locations(1, k + 1) = item;
+      values[k + 1] = 2 * (lambda * parameters(d, item) -
+                           ratingError * parameters(d, user));
+    }
+  }
+
+  gradient = arma::sp_mat(true, locations, values, rank, numUsers + numItems);
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -252,6 +319,20 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       (function.NumFunctions() - 1), function.NumFunctions());
 
   const arma::mat data = function.Dataset();
+  const size_t numUsers = function.NumUsers();
+
+  // The users and the items are split into one stratum per thread.
+  size_t strata = 1;
+  #ifdef HAS_OPENMP
+    strata = omp_get_max_threads();
+  #endif
+  auto blockOf = [&](const size_t j)
+  {
+    return ((size_t) data(0, j) % strata) * strata +
+        ((size_t) data(1, j) % strata);
+  };
+  arma::Col<size_t> blockStarts(strata * strata + 1);
+  arma::Col<size_t> blockExamples(visitationOrder.n_elem);
 
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
@@ -294,45 +375,54 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       std::shuffle(visitationOrder.begin(), visitationOrder.end(),
           mlpack::math::randGen);
 
-    #pragma omp parallel
+    // The examples of this iteration (threadShareSize per thread) are split
+    // into strata x strata blocks by user and item, as in DSGD.  In each of
+    // the strata sub-epochs, the blocks that are run in parallel share no
+    // user and no item, so no atomic operations are needed.
+    const size_t numExamples = std::min((size_t) visitationOrder.n_elem,
+        strata * threadShareSize);
+    blockStarts.zeros();
+    for (size_t j = 0; j < numExamples; ++j)
+      ++blockStarts[blockOf(visitationOrder[j]) + 1];
+    for (size_t b = 1; b < blockStarts.n_elem; ++b)
+      blockStarts[b] += blockStarts[b - 1];
+
+    arma::Col<size_t> position = blockStarts.head(strata * strata);
+    for (size_t j = 0; j < numExamples; ++j)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        const size_t numUsers = function.NumUsers();
-
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        double ratingError = rating - arma::dot(iterate.col(user),
-            iterate.col(item));
-
-        double lambda = function.Lambda();
-
-        arma::mat userUpdate = stepSize * (lambda * iterate.col(user) -
-            ratingError * iterate.col(item));
-        arma::mat itemUpdate = stepSize * (lambda * iterate.col(item) -
-            ratingError * iterate.col(user));
+      const size_t example = visitationOrder[j];
+      blockExamples[position[blockOf(example)]++] = example;
+    }
 
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < iterate.n_rows; ++i)
+    const double lambda = function.Lambda();
+    for (size_t s = 0; s < strata; ++s)
+    {
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t r = 0; r < (omp_size_t) strata; ++r)
+      {
+        const size_t block = r * strata + (r + s) % strata;
+        for (size_t k = blockStarts[block]; k < blockStarts[block + 1]; ++k)
         {
-          #pragma omp atomic
-          iterate(i, user) -= userUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemUpdate(i);
+          // Indices for accessing the the correct parameter columns.
+          const size_t user = data(0, blockExamples[k]);
+          const size_t item = data(1, blockExamples[k]) + numUsers;
+
+          // Prediction error for the example.
+          const double rating = data(2, blockExamples[k]);
+          double* u = iterate.colptr(user);
+          double* v = iterate.colptr(item);
+          double ratingError = rating;
+          for (size_t d = 0; d < iterate.n_rows; ++d)
+            ratingError -= u[d] * v[d];
+
+          // Gradient is non-zero only for the parameter columns corresponding
+          // to the example.
+          for (size_t d = 0; d < iterate.n_rows; ++d)
+          {
+            const double ud = u[d];
+            u[d] -= stepSize * (lambda * ud - ratingError * v[d]);
+            v[d] -= stepSize * (lambda * v[d] - ratingError * ud);
+          }
         }
       }
     }
@@ -113,7 +113,86 @@ class AsyncLearning
   //! Modify the environment.
   const EnvironmentType& Environment() const { return environment; }
 
+  /**
+   * Get the file that Train() saves checkpoints to; no checkpoints are saved
+   * if it is empty (the default).  A checkpoint holds the parameters of the
+   * learning and the target network, the number of steps done and the state of
+   * the behavior policy.  It is saved by the thread that runs the evaluation
+   * worker, at the end of the first evaluation episode that ends at least
+   * CheckpointPeriod() seconds after the last checkpoint, and at the end of
+   * Train(); the other workers keep training meanwhile.  The state is written
+   * in the fast binary format to a temporary file first and then renamed, so
+   * the file always holds a complete checkpoint.
+   *
+   * The parameters of the learning network are copied while the workers
+   * update them, so like the parameters every worker reads, the copy may mix
+   * two updates.  The optimizer state of the workers is not saved; every
+   * worker starts with a copy of Updater() after a resume, as at the start of
+   * Train().
+   */
+  const std::string& CheckpointFile() const { return checkpointFile; }
+  //! Modify the file that Train() saves checkpoints to.
+  std::string& CheckpointFile() { return checkpointFile; }
+
+  //! Get the minimum number of seconds between two checkpoints.
+  double CheckpointPeriod() const { return checkpointPeriod; }
+  //! Modify the minimum number of seconds between two checkpoints.
+  double& CheckpointPeriod() { return checkpointPeriod; }
+
+  /**
+   * Restore the learning and the target network, the number of steps and the
+   * behavior policy from CheckpointFile(), if it exists, so that the next
+   * call to Train() continues where the checkpoint was saved.  Throws
+   * std::runtime_error if the file was saved for a network with another
+   * number of parameters, and the exceptions of data::LoadFastBinary() if it
+   * is invalid.
+   *
+   * @return false if there is no checkpoint file.
+   */
+  bool Resume();
+
+  //! Get the number of steps done by the workers (the total over all calls to
+  //! Train(), including those before a resume).
+  size_t TotalSteps() const { return totalSteps; }
+
  private:
+  //! The state saved in a checkpoint.
+  struct CheckpointState
+  {
+    //! Create the state with a copy of the given policy.
+    CheckpointState(const PolicyType& policy) : totalSteps(0), policy(policy)
+    { }
+
+    //! The parameters of the learning network.
+    arma::mat parameters;
+    //! The parameters of the target network.
+    arma::mat targetParameters;
+    //! The number of steps done.
+    size_t totalSteps;
+    //! The behavior policy.
+    PolicyType policy;
+
+    //! Serialize the state.
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */)
+    {
+      ar & BOOST_SERIALIZATION_NVP(parameters);
+      ar & BOOST_SERIALIZATION_NVP(targetParameters);
+      ar & BOOST_SERIALIZATION_NVP(totalSteps);
+      ar & BOOST_SERIALIZATION_NVP(policy);
+    }
+  };
+
+  /**
+   * Save a checkpoint of the given state; a failure is reported as a warning,
+   * since it must not stop the training.
+   *
+   * @param filename The file to save the checkpoint to.
+   * @param state The state to save.
+   */
+  static void SaveCheckpoint(const std::string& filename,
+                             CheckpointState& state);
+
   //! Locally-stored hyper-parameters.
   TrainingConfig config;
 
@@ -128,6 +207,19 @@ class AsyncLearning
 
   //! Locally-stored task.
   EnvironmentType environment;
+
+  //! Locally-stored parameters of the target network (empty until Train() or
+  //! Resume() sets them).
+  arma::mat targetNetworkParameters;
+
+  //! Locally-stored number of steps done.
+  size_t totalSteps;
+
+  //! Locally-stored file to save checkpoints to.
+  std::string checkpointFile;
+
+  //! Locally-stored minimum number of seconds between two checkpoints.
+  double checkpointPeriod;
 };
 
 /**
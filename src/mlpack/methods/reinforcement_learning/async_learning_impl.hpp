@@ -14,7 +14,11 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "queue"
+#include <mlpack/core/data/fast_binary.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 
 namespace mlpack {
 namespace rl {
@@ -42,9 +46,98 @@ AsyncLearning<
     learningNetwork(std::move(network)),
     policy(std::move(policy)),
     updater(std::move(updater)),
-    environment(std::move(environment))
+    environment(std::move(environment)),
+    totalSteps(0),
+    checkpointPeriod(60.0)
 { /* Nothing to do here. */ };
 
+template <
+  typename WorkerType,
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+bool AsyncLearning<
+  WorkerType,
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType
+>::Resume()
+{
+  if (checkpointFile.empty() || !std::ifstream(checkpointFile.c_str()).good())
+    return false;
+
+  CheckpointState state(policy);
+  data::LoadFastBinary(checkpointFile, "checkpoint", state);
+
+  if (learningNetwork.Parameters().is_empty())
+    learningNetwork.ResetParameters();
+
+  if (state.parameters.n_elem != learningNetwork.Parameters().n_elem ||
+      state.targetParameters.n_elem != state.parameters.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "AsyncLearning::Resume(): the checkpoint '" << checkpointFile
+        << "' holds " << state.parameters.n_elem << " parameters, but the "
+        << "network has " << learningNetwork.Parameters().n_elem << "!";
+    throw std::runtime_error(oss.str());
+  }
+
+  // Copy into the existing parameters, so that the layers keep sharing them.
+  learningNetwork.Parameters() = state.parameters;
+  targetNetworkParameters = std::move(state.targetParameters);
+  totalSteps = state.totalSteps;
+  policy = state.policy;
+
+  Log::Info << "AsyncLearning: resumed from '" << checkpointFile << "' after "
+      << totalSteps << " steps." << std::endl;
+  return true;
+}
+
+template <
+  typename WorkerType,
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType
+>
+void AsyncLearning<
+  WorkerType,
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType
+>::SaveCheckpoint(const std::string& filename, CheckpointState& state)
+{
+  const std::string temporary = filename + ".tmp";
+  try
+  {
+    {
+      std::ofstream stream(temporary.c_str(), std::ios::binary);
+      if (!stream.is_open())
+        throw std::runtime_error("cannot open '" + temporary + "'");
+      data::SaveFastBinary(stream, "checkpoint", state);
+      stream.close();
+      if (stream.fail())
+        throw std::runtime_error("cannot write '" + temporary + "'");
+    }
+
+    // Replace the last checkpoint (rename() can't replace files on Windows).
+#ifdef _WIN32
+    std::remove(filename.c_str());
+#endif
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0)
+      throw std::runtime_error("cannot rename '" + temporary + "'");
+  }
+  catch (std::exception& e)
+  {
+    Log::Warn << "AsyncLearning: checkpoint not saved: " << e.what() << "."
+        << std::endl;
+  }
+}
+
 template <
   typename WorkerType,
   typename EnvironmentType,
@@ -68,10 +161,20 @@ void AsyncLearning<
   NetworkType learningNetwork = std::move(this->learningNetwork);
   if (learningNetwork.Parameters().is_empty())
     learningNetwork.ResetParameters();
-  NetworkType targetNetwork = learningNetwork;
-  size_t totalSteps = 0;
+  TargetParameters targetParameters(targetNetworkParameters.n_elem ==
+      learningNetwork.Parameters().n_elem ? targetNetworkParameters :
+      learningNetwork.Parameters());
+  std::atomic<size_t> totalSteps(this->totalSteps);
   PolicyType policy = this->policy;
-  bool stop = false;
+  std::atomic<bool> stop(false);
+
+  // Checkpoints are saved by the thread that runs the evaluation worker; the
+  // busy flag of the worker orders the accesses of the threads that run it.
+  const std::string checkpointFile = this->checkpointFile;
+  const double checkpointPeriod = this->checkpointPeriod;
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  double lastCheckpoint = 0.0;
 
   // Set up worker pool, worker 0 will be deterministic for evaluation.
   std::vector<WorkerType> workers;
@@ -80,10 +183,12 @@ void AsyncLearning<
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
+
+  // Each worker is stepped by one thread at a time; a thread takes a worker by
+  // setting its flag.
+  std::vector<std::atomic<bool>> busy(workers.size());
+  for (size_t i = 0; i < busy.size(); ++i)
+    busy[i].store(false);
 
   /**
    * Compute the number of threads for the for-loop. In general, we should use
@@ -95,8 +200,14 @@ void AsyncLearning<
   numThreads++;
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
-      targetNetwork, totalSteps, policy)
+  /**
+   * The workers apply their updates to the parameters of the shared learning
+   * network without locks (Hogwild), publish the target network through a
+   * double buffer, and count the steps with an atomic counter, so the threads
+   * never wait for each other.
+   */
+  #pragma omp parallel for shared(stop, workers, busy, learningNetwork, \
+      targetParameters, totalSteps, policy, lastCheckpoint)
   for (omp_size_t i = 0; i < numThreads; ++i)
   {
     #pragma omp critical
@@ -106,39 +217,62 @@ void AsyncLearning<
             " started." << std::endl;
       #endif
     }
-    size_t task = std::numeric_limits<size_t>::max();
-    while (!stop)
+
+    // Start the search for a free worker at a different place in each thread.
+    size_t task = (size_t) i % workers.size();
+    while (!stop.load())
     {
-      // Assign task to current thread from queue.
-      #pragma omp critical
+      // Take the next free worker.  This may fail when threads are more than
+      // workers.
+      bool expected = false;
+      if (!busy[task].compare_exchange_strong(expected, true))
       {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
-        {
-          task = tasks.front();
-          tasks.pop();
-        }
-      };
-
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
+        task = (task + 1) % workers.size();
         continue;
+      }
 
       // Get corresponding worker.
       WorkerType& worker = workers[task];
       double episodeReturn;
-      if (worker.Step(learningNetwork, targetNetwork, totalSteps,
+      if (worker.Step(learningNetwork, targetParameters, totalSteps,
           policy, episodeReturn) && !task)
       {
-        stop = measure(episodeReturn);
+        stop.store(measure(episodeReturn));
+
+        const double elapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        if (!checkpointFile.empty() && !stop.load() &&
+            elapsed - lastCheckpoint >= checkpointPeriod)
+        {
+          CheckpointState state(policy);
+          state.parameters = learningNetwork.Parameters();
+          size_t version = std::numeric_limits<size_t>::max();
+          targetParameters.Fetch(state.targetParameters, version);
+          state.totalSteps = totalSteps.load();
+          SaveCheckpoint(checkpointFile, state);
+          lastCheckpoint = elapsed;
+        }
       }
+
+      busy[task].store(false);
+      task = (task + 1) % workers.size();
     }
   }
 
-  // Write back the learning network.
+  // Write back the learning network and the state of the training.
+  size_t version = std::numeric_limits<size_t>::max();
+  targetParameters.Fetch(targetNetworkParameters, version);
+  this->totalSteps = totalSteps.load();
   this->learningNetwork = std::move(learningNetwork);
+
+  if (!checkpointFile.empty())
+  {
+    CheckpointState state(policy);
+    state.parameters = this->learningNetwork.Parameters();
+    state.targetParameters = targetNetworkParameters;
+    state.totalSteps = this->totalSteps;
+    SaveCheckpoint(checkpointFile, state);
+  }
 };
 
 } // namespace rl
@@ -66,6 +66,14 @@ class AggregatedPolicy
       policy.Anneal();
   }
 
+  //! Serialize the policy, with the state of the child policies.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(policies);
+    ar & BOOST_SERIALIZATION_NVP(sampler);
+  }
+
  private:
   //! Locally-stored child policies.
   std::vector<PolicyType> policies;
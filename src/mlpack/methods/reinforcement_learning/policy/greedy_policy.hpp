@@ -84,6 +84,15 @@ class GreedyPolicy
    */
   const double& Epsilon() const { return epsilon; }
 
+  //! Serialize the policy, with the current probability to explore.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(epsilon);
+    ar & BOOST_SERIALIZATION_NVP(minEpsilon);
+    ar & BOOST_SERIALIZATION_NVP(delta);
+  }
+
  private:
   //! Locally-stored probability to explore.
   double epsilon;
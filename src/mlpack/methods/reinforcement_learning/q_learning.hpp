@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "replay/random_replay.hpp"
+#include "replay/prioritized_replay.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -95,6 +96,22 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Execute an episode in each of the given number of copies of the
+   * environment, stepped in lockstep: at each step, the states of the copies
+   * whose episode has not ended are encoded into one matrix and their action
+   * values are computed with one forward pass of the network, and their
+   * transitions are stored in the replay memory with one call.  The learning
+   * network is then trained once on a minibatch from the replay memory, so
+   * there is one update per step of all the copies (instead of one per
+   * transition, like Episode()).  The environment functions take the state
+   * explicitly, so all the copies share the environment object.
+   *
+   * @param copies Number of copies of the environment.
+   * @return Return of the episode of each copy.
+   */
+  arma::colvec Episodes(const size_t copies);
+
   /**
    * @return Total steps from beginning.
    */
@@ -113,6 +130,18 @@ class QLearning
    */
   arma::Col<size_t> BestAction(const arma::mat& actionValues);
 
+  /**
+   * Train the learning network on a minibatch sampled from the replay memory.
+   */
+  void TrainAgent();
+
+  /**
+   * Account for the given number of new transitions: synchronize the target
+   * network every TargetNetworkSyncInterval() transitions, and anneal the
+   * policy after the exploration steps.
+   */
+  void AdvanceSteps(const size_t steps);
+
   //! Locally-stored hyper-parameters.
   TrainingConfig config;
 
@@ -113,6 +113,26 @@ double QLearning<
   if (deterministic || totalSteps < config.ExplorationSteps())
     return reward;
 
+  TrainAgent();
+
+  return reward;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::TrainAgent()
+{
   // Start experience replay.
 
   // Sample from previous experience.
@@ -144,18 +164,49 @@ double QLearning<
   // Compute the update target.
   arma::mat target;
   learningNetwork.Forward(sampledStates, target);
+  const arma::mat actionValues = target;
   for (size_t i = 0; i < sampledNextStates.n_cols; ++i)
   {
     target(sampledActions[i], i) = sampledRewards[i] + config.Discount() *
         (isTerminal[i] ? 0.0 : nextActionValues(bestActions[i], i));
   }
 
+  // Let the replay method update its memory (and possibly reweight the
+  // targets) from the errors of the sampled transitions.
+  replayMethod.Update(target, sampledActions, actionValues);
+
   // Learn form experience.
   arma::mat gradients;
   learningNetwork.Backward(target, gradients);
   updater.Update(learningNetwork.Parameters(), config.StepSize(), gradients);
+}
 
-  return reward;
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::AdvanceSteps(const size_t steps)
+{
+  for (size_t i = 0; i < steps; ++i)
+  {
+    totalSteps++;
+
+    // Update target network
+    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
+      targetNetwork = learningNetwork;
+
+    if (totalSteps > config.ExplorationSteps())
+      policy.Anneal();
+  }
 }
 
 template <
@@ -194,17 +245,98 @@ double QLearning<
     if (deterministic)
       continue;
 
-    totalSteps++;
+    AdvanceSteps(1);
+  }
 
-    // Update target network
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-      targetNetwork = learningNetwork;
+  return totalReturn;
+}
 
-    if (totalSteps > config.ExplorationSteps())
-      policy.Anneal();
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+arma::colvec QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Episodes(const size_t copies)
+{
+  arma::colvec totalReturns(copies, arma::fill::zeros);
+
+  // Get the initial state of each copy from environment, and track the copies
+  // whose episode has not ended.
+  std::vector<StateType> states(copies);
+  std::vector<size_t> active;
+  for (size_t i = 0; i < copies; ++i)
+  {
+    states[i] = environment.InitialSample();
+    if (!environment.IsTerminal(states[i]))
+      active.push_back(i);
   }
 
-  return totalReturn;
+  // Track the steps in these episodes.
+  size_t steps = 0;
+
+  while (!active.empty())
+  {
+    if (config.StepLimit() && steps >= config.StepLimit())
+      break;
+
+    // Get the action values of all the active copies at once.
+    const size_t dimension = states[active[0]].Encode().n_elem;
+    arma::mat encodedStates(dimension, active.size());
+    for (size_t j = 0; j < active.size(); ++j)
+      encodedStates.col(j) = states[active[j]].Encode();
+
+    arma::mat actionValues;
+    learningNetwork.Predict(encodedStates, actionValues);
+
+    // Select the actions and advance every copy to its next state.
+    arma::icolvec actions(active.size());
+    arma::colvec rewards(active.size());
+    arma::mat encodedNextStates(dimension, active.size());
+    arma::icolvec isTerminal(active.size());
+    std::vector<size_t> stillActive;
+    for (size_t j = 0; j < active.size(); ++j)
+    {
+      const ActionType action = policy.Sample(actionValues.unsafe_col(j),
+          deterministic);
+
+      StateType nextState;
+      rewards[j] = environment.Sample(states[active[j]], action, nextState);
+      actions[j] = action;
+      encodedNextStates.col(j) = nextState.Encode();
+      isTerminal[j] = environment.IsTerminal(nextState);
+
+      totalReturns[active[j]] += rewards[j];
+      states[active[j]] = nextState;
+      if (!isTerminal[j])
+        stillActive.push_back(active[j]);
+    }
+
+    // Store the transitions for replay.
+    replayMethod.Store(encodedStates, actions, rewards, encodedNextStates,
+        isTerminal);
+
+    const size_t transitions = active.size();
+    active = std::move(stillActive);
+    steps++;
+
+    if (deterministic)
+      continue;
+
+    if (totalSteps >= config.ExplorationSteps())
+      TrainAgent();
+
+    AdvanceSteps(transitions);
+  }
+
+  return totalReturns;
 }
 
 } // namespace rl
@@ -0,0 +1,330 @@
+/**
+ * @file prioritized_replay.hpp
+ *
+ * This file is an implementation of prioritized experience replay.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include "sum_tree.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of prioritized experience replay.
+ *
+ * Like RandomReplay, the transitions are stored in a First-In-First-Out
+ * buffer, but they are sampled with probability proportional to p_i^alpha,
+ * where the priority p_i of a transition is the magnitude of its last
+ * temporal difference error (new transitions get the largest priority seen so
+ * far, so they are replayed at least once).  The priorities are kept in a
+ * SumTree, so sampling a minibatch and updating its priorities take
+ * O(batchSize log capacity) time.  The bias of the non-uniform sampling is
+ * corrected with the importance sampling weights
+ * w_i = (N P(i))^-beta / max_j w_j of the sampled transitions.
+ *
+ * When used with QLearning, Update() is called at every step with the targets
+ * of the sampled transitions: it updates their priorities, and scales the
+ * error of each target by its importance sampling weight, which weights the
+ * gradient of each transition exactly for the mean squared error loss.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{schaul2015prioritized,
+ *  title   = {Prioritized experience replay},
+ *  author  = {Schaul, Tom and Quan, John and Antonoglou, Ioannis and
+ *             Silver, David},
+ *  journal = {arXiv preprint arXiv:1511.05952},
+ *  year    = {2015}
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType Desired task.
+ */
+template <typename EnvironmentType>
+class PrioritizedReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of prioritized experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param alpha How much prioritization is used (0 is uniform sampling).
+   * @param beta The exponent of the importance sampling weights (1 fully
+   *        corrects the bias of the sampling).
+   * @param epsilon Added to the priorities, so that every transition can be
+   *        sampled again.
+   * @param dimension The dimension of an encoded state.
+   */
+  PrioritizedReplay(const size_t batchSize,
+                    const size_t capacity,
+                    const double alpha = 0.6,
+                    const double beta = 0.4,
+                    const double epsilon = 1e-6,
+                    const size_t dimension = StateType::dimension) :
+      batchSize(batchSize),
+      capacity(capacity),
+      alpha(alpha),
+      beta(beta),
+      epsilon(epsilon),
+      position(0),
+      states(dimension, capacity),
+      actions(capacity),
+      rewards(capacity),
+      nextStates(dimension, capacity),
+      isTerminal(capacity),
+      full(false),
+      priorities(capacity),
+      maxPriority(1.0)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the given experience, with the largest priority so far.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   */
+  void Store(const StateType& state,
+             ActionType action,
+             double reward,
+             const StateType& nextState,
+             bool isEnd)
+  {
+    states.col(position) = state.Encode();
+    actions(position) = action;
+    rewards(position) = reward;
+    nextStates.col(position) = nextState.Encode();
+    isTerminal(position) = isEnd;
+    priorities.Set(position, std::pow(maxPriority, alpha));
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+  }
+
+  /**
+   * Store the given experiences, in order, with one copy per contiguous range
+   * of the memory.
+   *
+   * @param encodedStates Given encoded states (one column per experience).
+   * @param actions Given actions.
+   * @param rewards Given rewards.
+   * @param encodedNextStates Given encoded next states.
+   * @param isEnd Whether each next state is terminal state.
+   */
+  void Store(const arma::mat& encodedStates,
+             const arma::icolvec& actions,
+             const arma::colvec& rewards,
+             const arma::mat& encodedNextStates,
+             const arma::icolvec& isEnd)
+  {
+    size_t stored = 0;
+    while (stored < encodedStates.n_cols)
+    {
+      const size_t span = std::min((size_t) encodedStates.n_cols - stored,
+          capacity - position);
+      const size_t last = stored + span - 1;
+      states.cols(position, position + span - 1) =
+          encodedStates.cols(stored, last);
+      this->actions.subvec(position, position + span - 1) =
+          actions.subvec(stored, last);
+      this->rewards.subvec(position, position + span - 1) =
+          rewards.subvec(stored, last);
+      nextStates.cols(position, position + span - 1) =
+          encodedNextStates.cols(stored, last);
+      isTerminal.subvec(position, position + span - 1) =
+          isEnd.subvec(stored, last);
+      priorities.Set(arma::regspace<arma::uvec>(position, position + span - 1),
+          arma::vec(span).fill(std::pow(maxPriority, alpha)));
+
+      stored += span;
+      position += span;
+      if (position == capacity)
+      {
+        full = true;
+        position = 0;
+      }
+    }
+  }
+
+  /**
+   * Sample some experiences in proportion to their priorities.  The interval
+   * [0, total priority) is split into batchSize equal segments and one
+   * transition is sampled from each, which reduces the variance of the
+   * minibatch.  The indices and the importance sampling weights of the sampled
+   * transitions are kept until the next call.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal)
+  {
+    const size_t upperBound = Size();
+    const double total = priorities.Sum();
+    const double segment = total / batchSize;
+
+    sampledIndices.set_size(batchSize);
+    weights.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      const double mass = math::Random(i * segment, (i + 1) * segment);
+      sampledIndices[i] = std::min(priorities.FindPrefixSum(mass),
+          upperBound - 1);
+      weights[i] = std::pow(upperBound * priorities.Get(sampledIndices[i]) /
+          total, -beta);
+    }
+    weights /= weights.max();
+
+    // Gather the minibatch with one copy per buffer.
+    sampledStates = states.cols(sampledIndices);
+    sampledActions = actions.elem(sampledIndices);
+    sampledRewards = rewards.elem(sampledIndices);
+    sampledNextStates = nextStates.cols(sampledIndices);
+    isTerminal = this->isTerminal.elem(sampledIndices);
+  }
+
+  /**
+   * Set the priorities of the given transitions from their temporal
+   * difference errors.
+   *
+   * @param indices Indices of the transitions in the memory.
+   * @param tdErrors Temporal difference errors of the transitions.
+   */
+  void UpdatePriorities(const arma::uvec& indices, const arma::colvec& tdErrors)
+  {
+    const arma::colvec newPriorities = arma::abs(tdErrors) + epsilon;
+    maxPriority = std::max(maxPriority, newPriorities.max());
+    priorities.Set(indices, arma::pow(newPriorities, alpha));
+  }
+
+  /**
+   * Update the priorities of the last sampled transitions, and scale the
+   * error of their targets by their importance sampling weights.
+   *
+   * @param target The targets of the sampled transitions; the target of
+   *        sampled transition i is target(sampledActions[i], i).
+   * @param sampledActions The actions of the sampled transitions.
+   * @param actionValues The action values of the sampled states predicted by
+   *        the network being trained.
+   */
+  void Update(arma::mat& target,
+              const arma::icolvec& sampledActions,
+              const arma::mat& actionValues)
+  {
+    arma::colvec tdErrors(sampledIndices.n_elem);
+    for (size_t i = 0; i < sampledIndices.n_elem; ++i)
+    {
+      const double value = actionValues(sampledActions[i], i);
+      tdErrors[i] = target(sampledActions[i], i) - value;
+      target(sampledActions[i], i) = value + weights[i] * tdErrors[i];
+    }
+
+    UpdatePriorities(sampledIndices, tdErrors);
+  }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size
+   */
+  size_t Size() const
+  {
+    return full ? capacity : position;
+  }
+
+  //! Get the indices of the last sampled transitions.
+  const arma::uvec& SampledIndices() const { return sampledIndices; }
+  //! Get the importance sampling weights of the last sampled transitions.
+  const arma::colvec& Weights() const { return weights; }
+
+  //! Get the exponent of the priorities.
+  double Alpha() const { return alpha; }
+  //! Get the exponent of the importance sampling weights.
+  double Beta() const { return beta; }
+  //! Modify the exponent of the importance sampling weights (it is usually
+  //! annealed to 1 during training).
+  double& Beta() { return beta; }
+
+ private:
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! The exponent of the priorities.
+  double alpha;
+
+  //! The exponent of the importance sampling weights.
+  double beta;
+
+  //! The constant added to the priorities.
+  double epsilon;
+
+  //! Indicate the position to store new transition.
+  size_t position;
+
+  //! Locally-stored encoded previous states.
+  arma::mat states;
+
+  //! Locally-stored previous actions.
+  arma::icolvec actions;
+
+  //! Locally-stored previous rewards.
+  arma::colvec rewards;
+
+  //! Locally-stored encoded previous next states.
+  arma::mat nextStates;
+
+  //! Locally-stored termination information of previous experience.
+  arma::icolvec isTerminal;
+
+  //! Locally-stored indicator that whether the memory is full or not
+  bool full;
+
+  //! The priorities of the transitions, raised to the power alpha.
+  SumTree priorities;
+
+  //! The largest priority so far (before the exponent).
+  double maxPriority;
+
+  //! The indices of the last sampled transitions.
+  arma::uvec sampledIndices;
+
+  //! The importance sampling weights of the last sampled transitions.
+  arma::colvec weights;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -98,6 +98,49 @@ class RandomReplay
     }
   }
 
+  /**
+   * Store the given experiences, in order, with one copy per contiguous range
+   * of the memory.
+   *
+   * @param encodedStates Given encoded states (one column per experience).
+   * @param actions Given actions.
+   * @param rewards Given rewards.
+   * @param encodedNextStates Given encoded next states.
+   * @param isEnd Whether each next state is terminal state.
+   */
+  void Store(const arma::mat& encodedStates,
+             const arma::icolvec& actions,
+             const arma::colvec& rewards,
+             const arma::mat& encodedNextStates,
+             const arma::icolvec& isEnd)
+  {
+    size_t stored = 0;
+    while (stored < encodedStates.n_cols)
+    {
+      const size_t span = std::min((size_t) encodedStates.n_cols - stored,
+          capacity - position);
+      const size_t last = stored + span - 1;
+      states.cols(position, position + span - 1) =
+          encodedStates.cols(stored, last);
+      this->actions.subvec(position, position + span - 1) =
+          actions.subvec(stored, last);
+      this->rewards.subvec(position, position + span - 1) =
+          rewards.subvec(stored, last);
+      nextStates.cols(position, position + span - 1) =
+          encodedNextStates.cols(stored, last);
+      isTerminal.subvec(position, position + span - 1) =
+          isEnd.subvec(stored, last);
+
+      stored += span;
+      position += span;
+      if (position == capacity)
+      {
+        full = true;
+        position = 0;
+      }
+    }
+  }
+
   /**
    * Sample some experiences.
    *
@@ -125,6 +168,21 @@ class RandomReplay
     isTerminal = this->isTerminal.elem(sampledIndices);
   }
 
+  /**
+   * Update the replay memory with the targets of the last sampled
+   * transitions.  Uniform replay keeps no state about the samples, so this
+   * does nothing.
+   *
+   * @param target The targets of the sampled transitions.
+   * @param sampledActions The actions of the sampled transitions.
+   * @param actionValues The action values of the sampled states predicted by
+   *        the network being trained.
+   */
+  void Update(arma::mat& /* target */,
+              const arma::icolvec& /* sampledActions */,
+              const arma::mat& /* actionValues */)
+  { /* Nothing to do here. */ }
+
   /**
    * Get the number of transitions in the memory.
    *
@@ -0,0 +1,122 @@
+/**
+ * @file sum_tree.hpp
+ *
+ * This file is an implementation of a sum tree, for sampling in proportion to
+ * a set of changing nonnegative values.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+#define MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A complete binary tree whose leaves hold nonnegative values and whose inner
+ * nodes hold the sum of their children, stored in an array (the children of
+ * node i are 2i and 2i + 1, and the leaves start at the first power of two
+ * that is at least the capacity).  Setting a value and finding the leaf at a
+ * given prefix sum both take O(log n) time, so elements can be sampled in
+ * proportion to their values while the values change.
+ */
+class SumTree
+{
+ public:
+  /**
+   * Create a sum tree with the given number of leaves, all set to 0.
+   *
+   * @param capacity Number of values.
+   */
+  SumTree(const size_t capacity = 0) :
+      capacity(capacity),
+      leaves(1)
+  {
+    while (leaves < capacity)
+      leaves *= 2;
+    nodes.zeros(2 * leaves);
+  }
+
+  /**
+   * Set the value of the given leaf, and update the sums above it.
+   *
+   * @param index Index of the leaf.
+   * @param value New nonnegative value.
+   */
+  void Set(const size_t index, const double value)
+  {
+    size_t node = leaves + index;
+    nodes[node] = value;
+    for (node /= 2; node > 0; node /= 2)
+      nodes[node] = nodes[2 * node] + nodes[2 * node + 1];
+  }
+
+  /**
+   * Set the values of the given leaves.
+   *
+   * @param indices Indices of the leaves.
+   * @param values New nonnegative values, one per index.
+   */
+  void Set(const arma::uvec& indices, const arma::vec& values)
+  {
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      Set(indices[i], values[i]);
+  }
+
+  //! Get the value of the given leaf.
+  double Get(const size_t index) const { return nodes[leaves + index]; }
+
+  //! Get the sum of all the values.
+  double Sum() const { return nodes[1]; }
+
+  //! Get the number of values.
+  size_t Capacity() const { return capacity; }
+
+  /**
+   * Find the first leaf whose inclusive prefix sum exceeds the given mass, so
+   * that for a mass uniform in [0, Sum()) each leaf is found with probability
+   * proportional to its value.  Masses outside of that range are clamped to
+   * the first or last nonzero leaf.
+   *
+   * @param mass Prefix sum to search for.
+   * @return Index of the leaf.
+   */
+  size_t FindPrefixSum(double mass) const
+  {
+    size_t node = 1;
+    while (node < leaves)
+    {
+      // Go left unless the mass is beyond the left subtree (or that subtree is
+      // empty, which may happen through rounding).
+      if (mass < nodes[2 * node] || nodes[2 * node + 1] == 0.0)
+      {
+        node = 2 * node;
+      }
+      else
+      {
+        mass -= nodes[2 * node];
+        node = 2 * node + 1;
+      }
+    }
+
+    return std::min(node - leaves, capacity - 1);
+  }
+
+ private:
+  //! The number of values.
+  size_t capacity;
+  //! The number of leaves (a power of two).
+  size_t leaves;
+  //! The nodes of the tree; node 0 is unused, the root is node 1.
+  arma::vec nodes;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RL_WORKER_ONE_STEP_Q_LEARNING_WORKER_HPP
 
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
+#include "target_parameters.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -70,13 +71,16 @@ class OneStepQLearningWorker
         learningNetwork.Parameters().n_cols);
     // Build local network.
     network = learningNetwork;
+    // Build local copy of the target network.
+    targetNetwork = learningNetwork;
+    targetVersion = 0;
   }
 
   /**
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param targetParameters The shared parameters of the target network.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -84,8 +88,8 @@ class OneStepQLearningWorker
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
-            size_t& totalSteps,
+            TargetParameters& targetParameters,
+            std::atomic<size_t>& totalSteps,
             PolicyType& policy,
             double& totalReward)
   {
@@ -108,15 +112,14 @@ class OneStepQLearningWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        network.Parameters() = learningNetwork.Parameters();
         return true;
       }
       state = nextState;
       return false;
     }
 
-    #pragma omp atomic
-    totalSteps++;
+    const size_t totalStep = ++totalSteps;
 
     pending[pendingIndex] = std::make_tuple(state, action, reward, nextState);
     pendingIndex++;
@@ -126,17 +129,17 @@ class OneStepQLearningWorker
       // Initialize the gradient storage.
       arma::mat totalGradients(learningNetwork.Parameters().n_rows,
           learningNetwork.Parameters().n_cols, arma::fill::zeros);
+
+      // Get the latest parameters of the target network.
+      targetParameters.Fetch(targetNetwork.Parameters(), targetVersion);
+
       for (size_t i = 0; i < pending.size(); ++i)
       {
         TransitionType &transition = pending[i];
 
         // Compute the target state-action value.
         arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              std::get<3>(transition).Encode(), actionValue);
-        };
+        targetNetwork.Predict(std::get<3>(transition).Encode(), actionValue);
         double targetActionValue = actionValue.max();
         if (terminal && i == pending.size() - 1)
           targetActionValue = 0;
@@ -166,17 +169,14 @@ class OneStepQLearningWorker
           config.StepSize(), totalGradients);
 
       // Sync the local network with the global network.
-      network = learningNetwork;
+      network.Parameters() = learningNetwork.Parameters();
 
       pendingIndex = 0;
     }
 
     // Update global target network.
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
+    if (totalStep % config.TargetNetworkSyncInterval() == 0)
+      targetParameters.Publish(learningNetwork.Parameters());
 
     policy.Anneal();
 
@@ -229,6 +229,12 @@ class OneStepQLearningWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local copy of the target network.
+  NetworkType targetNetwork;
+
+  //! Version of the parameters of the local target network.
+  size_t targetVersion;
+
   //! Current state of the agent.
   StateType state;
 };
@@ -0,0 +1,124 @@
+/**
+ * @file target_parameters.hpp
+ *
+ * This file is an implementation of a double buffer for the target network
+ * parameters shared by asynchronous learning workers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_WORKER_TARGET_PARAMETERS_HPP
+#define MLPACK_METHODS_RL_WORKER_TARGET_PARAMETERS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+#include <thread>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * The parameters of the target network shared by asynchronous learning
+ * workers, published and read without locks.  Every worker predicts with its
+ * own copy of the target network, and Fetch() copies the latest published
+ * parameters into it when they have changed; a new version is written by
+ * Publish() into the buffer that is not being read, and then made current by
+ * incrementing the version counter.
+ *
+ * A reader that copies a buffer while it is overwritten (which needs two
+ * publications during one copy) detects it and copies the new version again,
+ * so the parameters it gets are always one consistent published version.  At
+ * most one publication is in progress at a time: a concurrent call to
+ * Publish() waits until the publication in progress is done and then
+ * publishes its own parameters as the next version, so no parameters are
+ * dropped.  Publications take one copy of the parameters and are rare (once
+ * per target network update), so the wait is short.
+ */
+class TargetParameters
+{
+ public:
+  /**
+   * Create the buffer with the initial parameters of the target network, as
+   * version 0.
+   *
+   * @param parameters The initial parameters.
+   */
+  TargetParameters(const arma::mat& parameters) :
+      started(0),
+      version(0),
+      writing(false)
+  {
+    buffers[0] = parameters;
+    buffers[1] = parameters;
+  }
+
+  /**
+   * Publish the given parameters as the new version.  If another publication
+   * is in progress, wait until it is done first.
+   *
+   * @param parameters The new parameters of the target network.
+   */
+  void Publish(const arma::mat& parameters)
+  {
+    while (writing.exchange(true, std::memory_order_acquire))
+      std::this_thread::yield();
+
+    const size_t next = version.load(std::memory_order_relaxed) + 1;
+    started.store(next, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    buffers[next % 2] = parameters;
+    version.store(next, std::memory_order_release);
+
+    writing.store(false, std::memory_order_release);
+  }
+
+  /**
+   * Copy the latest published parameters, if they are newer than the given
+   * version.  This only takes an atomic load when they are not.
+   *
+   * @param parameters The parameters to overwrite.
+   * @param localVersion The version of the given parameters; it is updated.
+   * @return Whether the parameters were copied.
+   */
+  bool Fetch(arma::mat& parameters, size_t& localVersion) const
+  {
+    size_t current = version.load(std::memory_order_acquire);
+    if (current == localVersion)
+      return false;
+
+    while (true)
+    {
+      parameters = buffers[current % 2];
+
+      // The buffer is only overwritten once the publication of version
+      // current + 2 has started.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (started.load(std::memory_order_relaxed) < current + 2)
+        break;
+      current = version.load(std::memory_order_acquire);
+    }
+
+    localVersion = current;
+    return true;
+  }
+
+  //! Get the latest published version.
+  size_t Version() const { return version.load(std::memory_order_acquire); }
+
+ private:
+  //! The two buffers; version v is stored in buffers[v % 2].
+  arma::mat buffers[2];
+  //! The version whose publication started last.
+  std::atomic<size_t> started;
+  //! The latest published version.
+  std::atomic<size_t> version;
+  //! Whether a publication is in progress.
+  std::atomic<bool> writing;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,8 @@
 #define MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/parallel_blocks.hpp>
+#include <mlpack/core/cv/warm_start_traits.hpp>
 #include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
 
 #include "softmax_regression_function.hpp"
@@ -98,6 +100,29 @@ class SoftmaxRegression
                     const bool fitIntercept = false,
                     OptimizerType optimizer = OptimizerType());
 
+  /**
+   * Construct the SoftmaxRegression class with the provided sparse data and
+   * labels, and train the model.  The gradients are computed with
+   * sparse-dense products, so the training time is proportional to the number
+   * of nonzero elements of the data.  The model is the same as when training on
+   * the equivalent dense data.
+   *
+   * @tparam OptimizerType Desired optimizer type.
+   * @param data Input sparse training features, one column per sample.
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @param lambda L2-regularization constant.
+   * @param fitIntercept add intercept term or not.
+   * @param optimizer Desired optimizer.
+   */
+  template<typename OptimizerType = mlpack::optimization::L_BFGS>
+  SoftmaxRegression(const arma::sp_mat& data,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    const double lambda = 0.0001,
+                    const bool fitIntercept = false,
+                    OptimizerType optimizer = OptimizerType());
+
   /**
    * Predict the class labels for the provided feature points. The function
    * calculates the probabilities for every class, given a data point. It then
@@ -123,6 +148,15 @@ class SoftmaxRegression
    */
   void Classify(const arma::mat& dataset, arma::Row<size_t>& labels) const;
 
+  /**
+   * Classify the given sparse points, returning the predicted labels for each
+   * point.
+   *
+   * @param dataset Set of sparse points to classify.
+   * @param labels Predicted labels for each point.
+   */
+  void Classify(const arma::sp_mat& dataset, arma::Row<size_t>& labels) const;
+
   /**
    * Classify the given point. The predicted class label is returned.
    * The function calculates the probabilites for every class, given the point.
@@ -158,6 +192,37 @@ class SoftmaxRegression
   void Classify(const arma::mat& dataset,
                 arma::mat& probabilities) const;
 
+  /**
+   * Classify the given sparse points, returning class probabilities for each
+   * point.
+   *
+   * @param dataset Matrix of sparse data points to be classified.
+   * @param probabilities Class probabilities for each point.
+   */
+  void Classify(const arma::sp_mat& dataset,
+                arma::mat& probabilities) const;
+
+  /**
+   * Classify the given single-precision points, returning the predicted labels
+   * for each point.  The points are scored in single precision against a copy
+   * of the parameters converted once per call, which halves the memory traffic
+   * and doubles the SIMD width of batch scoring.  The model itself is still
+   * trained and stored in double precision.
+   *
+   * @param dataset Set of single-precision points to classify.
+   * @param labels Predicted labels for each point.
+   */
+  void Classify(const arma::fmat& dataset, arma::Row<size_t>& labels) const;
+
+  /**
+   * Classify the given single-precision points, returning single-precision
+   * class probabilities for each point.
+   *
+   * @param dataset Set of single-precision points to classify.
+   * @param probabilities Class probabilities for each point.
+   */
+  void Classify(const arma::fmat& dataset, arma::fmat& probabilities) const;
+
   /**
    * Computes accuracy of the learned model given the feature data and the
    * labels associated with each data point. Predictions are made using the
@@ -169,6 +234,16 @@ class SoftmaxRegression
   double ComputeAccuracy(const arma::mat& testData,
                          const arma::Row<size_t>& labels) const;
 
+  /**
+   * Computes accuracy of the learned model given sparse feature data and the
+   * labels associated with each data point.
+   *
+   * @param testData Matrix of sparse data points to make predictions for.
+   * @param labels Vector of labels associated with the data.
+   */
+  double ComputeAccuracy(const arma::sp_mat& testData,
+                         const arma::Row<size_t>& labels) const;
+
   /**
    * Train the softmax regression with the given training data.
    *
@@ -185,6 +260,41 @@ class SoftmaxRegression
                const size_t numClasses,
                OptimizerType optimizer = OptimizerType());
 
+  /**
+   * Train the softmax regression with the given sparse training data.  The
+   * gradients are computed with sparse-dense products.
+   *
+   * @tparam OptimizerType Desired optimizer type.
+   * @param data Input sparse data with each column as one example.
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @param optimizer Desired optimizer.
+   * @return Objective value of the final point.
+   */
+  template<typename OptimizerType = mlpack::optimization::L_BFGS>
+  double Train(const arma::sp_mat& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               OptimizerType optimizer = OptimizerType());
+
+  /**
+   * Update the model with batches of data and labels read one at a time from
+   * the given loader (such as data::CSVBatchReader), so that the training set
+   * never has to be in memory at once.  The loader is called as
+   * loader(data, labels) and returns false when there are no more batches.
+   * Each batch is optimized with a copy of the given optimizer, starting from
+   * the current parameters, so an optimizer that takes a bounded number of
+   * steps (such as SGD with one pass over each batch) should be used.
+   *
+   * @tparam LoaderType Type of the loader, a callable object.
+   * @tparam OptimizerType Desired optimizer type.
+   * @param loader Loader to read batches from.
+   * @param optimizer Desired optimizer.
+   * @return The number of batches read.
+   */
+  template<typename LoaderType, typename OptimizerType>
+  size_t Update(LoaderType& loader, const OptimizerType& optimizer);
+
   //! Sets the number of classes.
   size_t& NumClasses() { return numClasses; }
   //! Gets the number of classes.
@@ -221,6 +331,46 @@ class SoftmaxRegression
   }
 
  private:
+  //! Train the model on dense or sparse data.
+  template<typename MatType, typename OptimizerType>
+  double TrainModel(const MatType& data,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    OptimizerType& optimizer);
+
+  //! Make sure that the dataset has the dimensionality of the model.
+  template<typename MatType>
+  void CheckDimensionality(const MatType& dataset) const;
+
+  //! Compute the class scores (the given weights, a copy of the parameters in
+  //! the element type of the dataset, times the points) of the columns
+  //! [begin, end) of the dataset.
+  template<typename MatType, typename WeightsType, typename ScoresType>
+  void ClassScores(const WeightsType& weights,
+                   const MatType& dataset,
+                   const size_t begin,
+                   const size_t end,
+                   ScoresType& scores) const;
+
+  //! Compute the class probabilities of dense or sparse data, in the
+  //! precision of the data.
+  template<typename MatType, typename ProbabilitiesType>
+  void ClassProbabilities(const MatType& dataset,
+                          ProbabilitiesType& probabilities) const;
+
+  //! Compute the most probable class of each point of dense or sparse data.
+  template<typename MatType>
+  void ClassLabels(const MatType& dataset, arma::Row<size_t>& labels) const;
+
+  //! Pick the most probable class of each point.
+  void MostProbableClasses(const arma::mat& probabilities,
+                           arma::Row<size_t>& labels) const;
+
+  //! Compute the accuracy of the model on dense or sparse data.
+  template<typename MatType>
+  double Accuracy(const MatType& testData,
+                  const arma::Row<size_t>& labels) const;
+
   //! Parameters after optimization.
   arma::mat parameters;
   //! Number of classes.
@@ -232,6 +382,32 @@ class SoftmaxRegression
 };
 
 } // namespace regression
+
+namespace cv {
+
+//! SoftmaxRegression starts training from its current parameters, so
+//! cross-validation can continue from a model trained with another lambda.
+template<>
+struct WarmStartTraits<regression::SoftmaxRegression>
+{
+  static const bool SupportsWarmStart = true;
+
+  static void SetHyperParameters(regression::SoftmaxRegression& model,
+                                 const double lambda = 0.0001,
+                                 const bool fitIntercept = false)
+  {
+    // The parameters have another shape with or without the intercept.
+    if (fitIntercept != model.FitIntercept())
+    {
+      model = regression::SoftmaxRegression(model.FeatureSize(),
+          model.NumClasses(), fitIntercept);
+    }
+
+    model.Lambda() = lambda;
+  }
+};
+
+} // namespace cv
 } // namespace mlpack
 
 // Include implementation.
@@ -18,7 +18,16 @@
 namespace mlpack {
 namespace regression {
 
-class SoftmaxRegressionFunction
+/**
+ * The objective function of softmax regression.  The data may be dense or
+ * sparse; with sparse data (arma::sp_mat), the gradients only cost time
+ * proportional to the number of nonzero elements of the data (times the number
+ * of classes).
+ *
+ * @tparam MatType Type of the data matrix (arma::mat or arma::sp_mat).
+ */
+template<typename MatType = arma::mat>
+class SoftmaxRegressionFunctionType
 {
  public:
   /**
@@ -32,11 +41,11 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
-                            const arma::Row<size_t>& labels,
-                            const size_t numClasses,
-                            const double lambda = 0.0001,
-                            const bool fitIntercept = false);
+  SoftmaxRegressionFunctionType(const MatType& data,
+                                const arma::Row<size_t>& labels,
+                                const size_t numClasses,
+                                const double lambda = 0.0001,
+                                const bool fitIntercept = false);
 
   //! Initializes the parameters of the model to suitable values.
   const arma::mat InitializeWeights();
@@ -186,7 +195,7 @@ class SoftmaxRegressionFunction
 
  private:
   //! Training data matrix.  This is an alias until the data is shuffled.
-  arma::mat data;
+  MatType data;
   //! Label matrix for the provided data.
   arma::sp_mat groundTruth;
   //! Initial parameter point.
@@ -199,7 +208,13 @@ class SoftmaxRegressionFunction
   bool fitIntercept;
 };
 
+//! The softmax regression objective function on dense data.
+typedef SoftmaxRegressionFunctionType<arma::mat> SoftmaxRegressionFunction;
+
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
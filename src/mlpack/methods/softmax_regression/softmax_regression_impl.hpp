@@ -33,6 +33,21 @@ SoftmaxRegression::SoftmaxRegression(
   Train(data, labels, numClasses, optimizer);
 }
 
+template<typename OptimizerType>
+SoftmaxRegression::SoftmaxRegression(
+    const arma::sp_mat& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const double lambda,
+    const bool fitIntercept,
+    OptimizerType optimizer) :
+    numClasses(numClasses),
+    lambda(lambda),
+    fitIntercept(fitIntercept)
+{
+  Train(data, labels, numClasses, optimizer);
+}
+
 template<typename VecType>
 size_t SoftmaxRegression::Classify(const VecType& point) const
 {
@@ -47,8 +62,26 @@ double SoftmaxRegression::Train(const arma::mat& data,
                                 const size_t numClasses,
                                 OptimizerType optimizer)
 {
-  SoftmaxRegressionFunction regressor(data, labels, numClasses,
-                                      lambda, fitIntercept);
+  return TrainModel(data, labels, numClasses, optimizer);
+}
+
+template<typename OptimizerType>
+double SoftmaxRegression::Train(const arma::sp_mat& data,
+                                const arma::Row<size_t>& labels,
+                                const size_t numClasses,
+                                OptimizerType optimizer)
+{
+  return TrainModel(data, labels, numClasses, optimizer);
+}
+
+template<typename MatType, typename OptimizerType>
+double SoftmaxRegression::TrainModel(const MatType& data,
+                                     const arma::Row<size_t>& labels,
+                                     const size_t numClasses,
+                                     OptimizerType& optimizer)
+{
+  SoftmaxRegressionFunctionType<MatType> regressor(data, labels, numClasses,
+      lambda, fitIntercept);
   if (parameters.is_empty())
     parameters = regressor.GetInitialPoint();
 
@@ -63,6 +96,160 @@ double SoftmaxRegression::Train(const arma::mat& data,
   return out;
 }
 
+template<typename MatType>
+void SoftmaxRegression::CheckDimensionality(const MatType& dataset) const
+{
+  if (dataset.n_rows != FeatureSize())
+  {
+    std::ostringstream oss;
+    oss << "SoftmaxRegression::Classify(): dataset has " << dataset.n_rows
+        << " dimensions, but model has " << FeatureSize() << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename MatType, typename WeightsType, typename ScoresType>
+void SoftmaxRegression::ClassScores(const WeightsType& weights,
+                                    const MatType& dataset,
+                                    const size_t begin,
+                                    const size_t end,
+                                    ScoresType& scores) const
+{
+  if (fitIntercept)
+  {
+    // In order to add the intercept term, we should compute following matrix:
+    //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
+    //     scores = parameters * [1; data].
+    //
+    // Since the cost of join maybe high due to the copy of original data,
+    // split the computation to two components.
+    scores = weights.cols(1, weights.n_cols - 1) *
+        dataset.cols(begin, end - 1);
+    scores.each_col() += weights.col(0);
+  }
+  else
+  {
+    scores = weights * dataset.cols(begin, end - 1);
+  }
+}
+
+template<typename MatType, typename ProbabilitiesType>
+void SoftmaxRegression::ClassProbabilities(
+    const MatType& dataset,
+    ProbabilitiesType& probabilities) const
+{
+  typedef typename MatType::elem_type ElemType;
+
+  CheckDimensionality(dataset);
+
+  // Calculate the probabilities for each test input, one block of points at a
+  // time.  The largest score of each point is subtracted before the
+  // exponentiation, which does not change the probabilities but avoids
+  // overflow.
+  const arma::Mat<ElemType> weights =
+      arma::conv_to<arma::Mat<ElemType>>::from(parameters);
+  probabilities.set_size(numClasses, dataset.n_cols);
+  math::ParallelColumnBlocks(dataset.n_cols,
+      [&](const size_t begin, const size_t end)
+  {
+    arma::Mat<ElemType> scores;
+    ClassScores(weights, dataset, begin, end, scores);
+    for (size_t i = 0; i < scores.n_cols; ++i)
+    {
+      const ElemType* score = scores.colptr(i);
+      ElemType* probability = probabilities.colptr(begin + i);
+      const ElemType maxScore = scores.col(i).max();
+      ElemType sum = 0;
+      for (size_t j = 0; j < numClasses; ++j)
+      {
+        probability[j] = std::exp(score[j] - maxScore);
+        sum += probability[j];
+      }
+      for (size_t j = 0; j < numClasses; ++j)
+        probability[j] /= sum;
+    }
+  });
+}
+
+template<typename MatType>
+void SoftmaxRegression::ClassLabels(const MatType& dataset,
+                                    arma::Row<size_t>& labels) const
+{
+  typedef typename MatType::elem_type ElemType;
+
+  CheckDimensionality(dataset);
+
+  // The most probable class has the largest score, so the probabilities do not
+  // need to be computed.
+  const arma::Mat<ElemType> weights =
+      arma::conv_to<arma::Mat<ElemType>>::from(parameters);
+  labels.set_size(dataset.n_cols);
+  math::ParallelColumnBlocks(dataset.n_cols,
+      [&](const size_t begin, const size_t end)
+  {
+    arma::Mat<ElemType> scores;
+    ClassScores(weights, dataset, begin, end, scores);
+    for (size_t i = 0; i < scores.n_cols; ++i)
+    {
+      const ElemType* score = scores.colptr(i);
+      size_t best = 0;
+      for (size_t j = 1; j < numClasses; ++j)
+        if (score[j] > score[best])
+          best = j;
+      labels[begin + i] = best;
+    }
+  });
+}
+
+template<typename MatType>
+double SoftmaxRegression::Accuracy(const MatType& testData,
+                                   const arma::Row<size_t>& labels) const
+{
+  arma::Row<size_t> predictions;
+
+  // Get predictions for the provided data.
+  Classify(testData, predictions);
+
+  // Increment count for every correctly predicted label.
+  size_t count = 0;
+  for (size_t i = 0; i < predictions.n_elem; i++)
+    if (predictions(i) == labels(i))
+      count++;
+
+  // Return percentage accuracy.
+  return (count * 100.0) / predictions.n_elem;
+}
+
+template<typename LoaderType, typename OptimizerType>
+size_t SoftmaxRegression::Update(LoaderType& loader,
+                                 const OptimizerType& optimizer)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  size_t batches = 0;
+  while (loader(data, labels))
+  {
+    if (data.n_cols == 0)
+      continue;
+
+    if (!parameters.is_empty() && data.n_rows != FeatureSize())
+    {
+      std::ostringstream oss;
+      oss << "SoftmaxRegression::Update(): batch has dimensionality "
+          << data.n_rows << ", but the model has dimensionality "
+          << FeatureSize() << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    Train(data, labels, numClasses, optimizer);
+    ++batches;
+  }
+
+  Log::Info << "SoftmaxRegression::Update(): updated the model with "
+      << batches << " batches." << std::endl;
+  return batches;
+}
+
 } // namespace regression
 } // namespace mlpack
 
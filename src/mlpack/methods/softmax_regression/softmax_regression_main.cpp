@@ -13,6 +13,7 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 
 #include <mlpack/methods/softmax_regression/softmax_regression.hpp>
+#include <mlpack/core/data/load_svmlight.hpp>
 #include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
 
 #include <memory>
@@ -71,13 +72,24 @@ PROGRAM_INFO("Softmax Regression", "This program performs softmax regression, "
     " " + PRINT_DATASET("predictions") + ", the following command can be used:"
     "\n\n" +
     PRINT_CALL("softmax_regression", "input_model", "sr_model", "test",
-        "test_points", "predictions", "predictions"));
+        "test_points", "predictions", "predictions") +
+    "\n\n"
+    "Sparse data can be given instead as files in the SVMLight format with the "
+    + PRINT_PARAM_STRING("training_svmlight") + " parameter (then the labels "
+    "are read from the file, and must be class indices) and the " +
+    PRINT_PARAM_STRING("test_svmlight") + " parameter.  The model is trained "
+    "on the sparse matrix directly, which is much faster than on the "
+    "equivalent dense matrix when most of the features are zero, and the saved "
+    "model is the same as for dense data.");
 
 // Required options.
 PARAM_MATRIX_IN("training", "A matrix containing the training set (the matrix "
     "of predictors, X).", "t");
 PARAM_UROW_IN("labels", "A matrix containing labels (0 or 1) for the points "
     "in the training set (y). The labels must order as a row.", "l");
+PARAM_STRING_IN("training_svmlight", "File containing a sparse training set "
+    "and its labels in the SVMLight format (instead of the training set).",
+    "S", "");
 
 // Model loading/saving.
 PARAM_MODEL_IN(SoftmaxRegression, "input_model", "File containing existing "
@@ -87,6 +99,9 @@ PARAM_MODEL_OUT(SoftmaxRegression, "output_model", "File to save trained "
 
 // Testing.
 PARAM_MATRIX_IN("test", "Matrix containing test dataset.", "T");
+PARAM_STRING_IN("test_svmlight", "File containing a sparse test dataset in "
+    "the SVMLight format (instead of the test dataset); its labels are "
+    "ignored.", "E", "");
 PARAM_UROW_OUT("predictions", "Matrix to save predictions for test dataset "
     "into.", "p");
 PARAM_UROW_IN("test_labels", "Matrix containing test labels.", "L");
@@ -111,6 +126,12 @@ size_t CalculateNumberOfClasses(const size_t numClasses,
 template<typename Model>
 void TestClassifyAcc(const size_t numClasses, const Model& model);
 
+// Test the accuracy of the model on the given test set.
+template<typename Model, typename MatType>
+void TestClassifyAcc(const size_t numClasses,
+                     const Model& model,
+                     const MatType& testData);
+
 // Build the softmax model given the parameters.
 template<typename Model>
 Model* TrainSoftmax(const size_t maxIterations);
@@ -120,17 +141,24 @@ static void mlpackMain()
   const int maxIterations = CLI::GetParam<int>("max_iterations");
 
   // One of inputFile and modelFile must be specified.
-  RequireOnlyOnePassed({ "input_model", "training" }, true);
+  RequireOnlyOnePassed({ "input_model", "training", "training_svmlight" },
+      true);
+  if (CLI::HasParam("test_svmlight"))
+    RequireOnlyOnePassed({ "test", "test_svmlight" }, true);
   if (CLI::HasParam("training"))
   {
     RequireAtLeastOnePassed({ "labels" }, true, "if training data is specified,"
         " labels must also be specified");
   }
   ReportIgnoredParam({{ "training", false }}, "labels");
-  ReportIgnoredParam({{ "training", false }}, "max_iterations");
-  ReportIgnoredParam({{ "training", false }}, "number_of_classes");
-  ReportIgnoredParam({{ "training", false }}, "lambda");
-  ReportIgnoredParam({{ "training", false }}, "no_intercept");
+  ReportIgnoredParam({{ "training", false }, { "training_svmlight", false }},
+      "max_iterations");
+  ReportIgnoredParam({{ "training", false }, { "training_svmlight", false }},
+      "number_of_classes");
+  ReportIgnoredParam({{ "training", false }, { "training_svmlight", false }},
+      "lambda");
+  ReportIgnoredParam({{ "training", false }, { "training_svmlight", false }},
+      "no_intercept");
 
   RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
       "maximum number of iterations must be greater than or equal to 0");
@@ -172,7 +200,7 @@ void TestClassifyAcc(size_t numClasses, const Model& model)
   using namespace mlpack;
 
   // If there is no test set, there is nothing to test on.
-  if (!CLI::HasParam("test"))
+  if (!CLI::HasParam("test") && !CLI::HasParam("test_svmlight"))
   {
     ReportIgnoredParam({{ "test", false }}, "test_labels");
     ReportIgnoredParam({{ "test", false }}, "predictions");
@@ -180,9 +208,30 @@ void TestClassifyAcc(size_t numClasses, const Model& model)
     return;
   }
 
-  // Get the test dataset, and get predictions.
-  arma::mat testData = std::move(CLI::GetParam<arma::mat>("test"));
+  // Get the test dataset.
+  if (CLI::HasParam("test_svmlight"))
+  {
+    arma::sp_mat testData;
+    arma::rowvec fileLabels;
+    data::LoadSVMLight(CLI::GetParam<string>("test_svmlight"), testData,
+        fileLabels, true, model.FeatureSize());
+    TestClassifyAcc(numClasses, model, testData);
+  }
+  else
+  {
+    const arma::mat testData = std::move(CLI::GetParam<arma::mat>("test"));
+    TestClassifyAcc(numClasses, model, testData);
+  }
+}
+
+template<typename Model, typename MatType>
+void TestClassifyAcc(const size_t numClasses,
+                     const Model& model,
+                     const MatType& testData)
+{
+  using namespace mlpack;
 
+  // Get predictions.
   arma::Row<size_t> predictLabels;
   model.Classify(testData, predictLabels);
 
@@ -240,6 +289,33 @@ Model* TrainSoftmax(const size_t maxIterations)
   {
     sm = CLI::GetParam<Model*>("input_model");
   }
+  else if (CLI::HasParam("training_svmlight"))
+  {
+    arma::sp_mat trainData;
+    arma::rowvec fileLabels;
+    data::LoadSVMLight(CLI::GetParam<string>("training_svmlight"), trainData,
+        fileLabels, true);
+
+    if (fileLabels.n_elem > 0 && (fileLabels.min() < 0 ||
+        arma::any(fileLabels != arma::floor(fileLabels))))
+    {
+      Log::Fatal << "The labels in "
+          << PRINT_PARAM_STRING("training_svmlight") << " must be class "
+          << "indices (nonnegative integers)!" << endl;
+    }
+    const arma::Row<size_t> trainLabels =
+        arma::conv_to<arma::Row<size_t>>::from(fileLabels);
+
+    const size_t numClasses = CalculateNumberOfClasses(
+        (size_t) CLI::GetParam<int>("number_of_classes"), trainLabels);
+
+    const bool intercept = CLI::HasParam("no_intercept") ? false : true;
+
+    const size_t numBasis = 5;
+    optimization::L_BFGS optimizer(numBasis, maxIterations);
+    sm = new Model(trainData, trainLabels, numClasses,
+        CLI::GetParam<double>("lambda"), intercept, std::move(optimizer));
+  }
   else
   {
     arma::mat trainData = std::move(CLI::GetParam<arma::mat>("training"));
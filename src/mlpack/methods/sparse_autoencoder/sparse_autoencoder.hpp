@@ -57,7 +57,9 @@ namespace nn {
  * @endcode
  *
  * This implementation allows the use of arbitrary mlpack optimizers via the
- * OptimizerType template parameter.
+ * OptimizerType template parameter.  SparseAutoencoderFunction is
+ * decomposable, so minibatch optimizers (such as SGD or Adam) can be used on
+ * datasets that are too large for full-batch L-BFGS.
  *
  */
 class SparseAutoencoder
@@ -15,6 +15,9 @@ using namespace mlpack;
 using namespace mlpack::nn;
 using namespace std;
 
+//! The number of points processed at once.
+static const size_t blockSize = 1024;
+
 SparseAutoencoderFunction::SparseAutoencoderFunction(const arma::mat& data,
                                                      const size_t visibleSize,
                                                      const size_t hiddenSize,
@@ -74,6 +77,58 @@ const arma::mat SparseAutoencoderFunction::InitializeWeights()
 /** Evaluates the objective function given the parameters.
   */
 double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
+{
+  return Accumulate(parameters, 0, data.n_cols, NULL);
+}
+
+/** Calculates and stores the gradient values given a set of parameters.
+  */
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         arma::mat& gradient) const
+{
+  Accumulate(parameters, 0, data.n_cols, &gradient);
+}
+
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return Accumulate(parameters, 0, data.n_cols, &gradient);
+}
+
+double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t begin,
+                                           const size_t batchSize) const
+{
+  return Accumulate(parameters, begin, batchSize, NULL);
+}
+
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         const size_t begin,
+                                         arma::mat& gradient,
+                                         const size_t batchSize) const
+{
+  Accumulate(parameters, begin, batchSize, &gradient);
+}
+
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  return Accumulate(parameters, begin, batchSize, &gradient);
+}
+
+void SparseAutoencoderFunction::Shuffle()
+{
+  visitationOrder = arma::randperm(data.n_cols);
+}
+
+double SparseAutoencoderFunction::Accumulate(const arma::mat& parameters,
+                                             const size_t begin,
+                                             const size_t batchSize,
+                                             arma::mat* gradient) const
 {
   // The objective function is the average squared reconstruction error of the
   // network. w1 and b1 are the weights and biases associated with the hidden
@@ -82,45 +137,58 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // 'm' is the number of training examples.
   // The cost also takes into account the regularization and KL divergence terms
   // to control the parameter weights and sparsity of the model respectively.
+  // For a batch, the errors of its points are still divided by 'm', and the
+  // other terms are scaled by batchSize / m.
 
   // Compute the limits for the parameters w1, w2, b1 and b2.
   const size_t l1 = hiddenSize;
   const size_t l2 = visibleSize;
   const size_t l3 = 2 * hiddenSize;
 
-  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
-  // used in their place to avoid copying data. The following representations
-  // are used:
-  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
-  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
-  // b1 <- parameters.submat(0, l2, l1-1, l2)
-  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
-
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
-
-  // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  double wL2SquaredNorm;
-
-  // Calculate squared L2-norms of w1 and w2.
-  wL2SquaredNorm = arma::accu(parameters.submat(0, 0, l3 - 1, l2 - 1) %
-      parameters.submat(0, 0, l3 - 1, l2 - 1));
-
-  double sumOfSquaresError, weightDecay, klDivergence, cost;
+  const size_t end = begin + batchSize;
+  const size_t blocks = (batchSize + blockSize - 1) / blockSize;
+
+  // The first pass computes the average activations of the hidden layer, which
+  // the KL divergence term (and its gradient) needs, and the reconstruction
+  // error.  If the batch is a single block, its activations are kept for the
+  // second pass.
+  arma::vec rhoCap(hiddenSize, arma::fill::zeros);
+  double sumOfSquaresError = 0.0;
+  arma::mat batchHiddenLayer, batchOutputLayer;
+  #pragma omp parallel if (blocks > 1)
+  {
+    arma::vec localActivations(hiddenSize, arma::fill::zeros);
+    double localError = 0.0;
+    arma::mat hiddenLayer, outputLayer;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+    {
+      const size_t blockBegin = begin + b * blockSize;
+      const arma::mat points = Points(blockBegin,
+          std::min(blockBegin + blockSize, end));
+      Forward(parameters, points, hiddenLayer, outputLayer);
+
+      localActivations += arma::sum(hiddenLayer, 1);
+      localError += arma::accu(arma::square(outputLayer - points));
+    }
+
+    #pragma omp critical
+    {
+      rhoCap += localActivations;
+      sumOfSquaresError += localError;
+      if (blocks == 1)
+      {
+        batchHiddenLayer = std::move(hiddenLayer);
+        batchOutputLayer = std::move(outputLayer);
+      }
+    }
+  }
+  rhoCap /= batchSize;
+
+  // Calculate the squared L2-norm of w1 and w2.
+  const double wL2SquaredNorm = arma::accu(arma::square(
+      parameters.submat(0, 0, l3 - 1, l2 - 1)));
 
   // Calculate the reconstruction error, the regularization cost and the KL
   // divergence cost terms. 'sumOfSquaresError' is the average squared l2-norm
@@ -128,28 +196,79 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
   // activations not being low. It is given by the following formula:
   // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
-  sumOfSquaresError = 0.5 * arma::accu(diff % diff) / data.n_cols;
-  weightDecay = 0.5 * lambda * wL2SquaredNorm;
-  klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) + (1 - rho) *
-      arma::log((1 - rho) / (1 - rhoCap)));
+  const double scale = (double) batchSize / data.n_cols;
+  const double weightDecay = 0.5 * lambda * wL2SquaredNorm;
+  const double klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) +
+      (1 - rho) * arma::log((1 - rho) / (1 - rhoCap)));
 
   // The cost is the sum of the terms calculated above.
-  cost = sumOfSquaresError + weightDecay + klDivergence;
+  const double cost = 0.5 * sumOfSquaresError / data.n_cols +
+      scale * (weightDecay + klDivergence);
+
+  if (gradient == NULL)
+    return cost;
+
+  // The second pass backpropagates the errors.  Since our cost function also
+  // includes the KL divergence term, its gradient with respect to the hidden
+  // activations is added to the delta values of the hidden layer.
+  const arma::vec klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
+      (1 - rhoCap));
+
+  gradient->zeros(2 * hiddenSize + 1, visibleSize + 1);
+  if (blocks == 1)
+  {
+    Backward(parameters, Points(begin, end), batchHiddenLayer,
+        batchOutputLayer, klDivGrad, *gradient);
+  }
+  else
+  {
+    #pragma omp parallel
+    {
+      arma::mat localGradient(gradient->n_rows, gradient->n_cols,
+          arma::fill::zeros);
+      arma::mat hiddenLayer, outputLayer;
+
+      #pragma omp for schedule(static)
+      for (omp_size_t b = 0; b < (omp_size_t) blocks; ++b)
+      {
+        const size_t blockBegin = begin + b * blockSize;
+        const arma::mat points = Points(blockBegin,
+            std::min(blockBegin + blockSize, end));
+        Forward(parameters, points, hiddenLayer, outputLayer);
+        Backward(parameters, points, hiddenLayer, outputLayer, klDivGrad,
+            localGradient);
+      }
+
+      #pragma omp critical
+      *gradient += localGradient;
+    }
+  }
+
+  // Normalize, and add the gradient of the regularization term.
+  *gradient /= data.n_cols;
+  gradient->submat(0, 0, l3 - 1, l2 - 1) += scale * lambda *
+      parameters.submat(0, 0, l3 - 1, l2 - 1);
 
   return cost;
 }
 
-/** Calculates and stores the gradient values given a set of parameters.
-  */
-void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
-                                         arma::mat& gradient) const
+arma::mat SparseAutoencoderFunction::Points(const size_t begin,
+                                            const size_t end) const
 {
-  // Performs a feedforward pass of the neural network, and computes the
-  // activations of the output layer as in the Evaluate() method. It uses the
-  // Backpropagation algorithm to calculate the delta values at each layer,
-  // except for the input layer. The delta values are then used with input layer
-  // and hidden layer activations to get the parameter gradients.
+  if (visitationOrder.is_empty())
+  {
+    return arma::mat(const_cast<double*>(data.colptr(begin)), data.n_rows,
+        end - begin, false, true);
+  }
+
+  return data.cols(visitationOrder.subvec(begin, end - 1));
+}
 
+void SparseAutoencoderFunction::Forward(const arma::mat& parameters,
+                                        const arma::mat& points,
+                                        arma::mat& hiddenLayer,
+                                        arma::mat& outputLayer) const
+{
   // Compute the limits for the parameters w1, w2, b1 and b2.
   const size_t l1 = hiddenSize;
   const size_t l2 = visibleSize;
@@ -163,48 +282,42 @@ void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
 
-  arma::mat hiddenLayer, outputLayer;
-
   // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
+  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * points +
+      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, points.n_cols),
       hiddenLayer);
 
   Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
+      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, points.n_cols),
       outputLayer);
+}
 
-  arma::mat rhoCap, diff;
-
-  // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  arma::mat klDivGrad, delOut, delHid;
+void SparseAutoencoderFunction::Backward(const arma::mat& parameters,
+                                         const arma::mat& points,
+                                         const arma::mat& hiddenLayer,
+                                         const arma::mat& outputLayer,
+                                         const arma::vec& klDivGrad,
+                                         arma::mat& gradient) const
+{
+  // Compute the limits for the parameters w1, w2, b1 and b2.
+  const size_t l1 = hiddenSize;
+  const size_t l2 = visibleSize;
+  const size_t l3 = 2 * hiddenSize;
 
   // The delta vector for the output layer is given by diff * f'(z), where z is
   // the preactivation and f is the activation function. The derivative of the
   // sigmoid function turns out to be f(z) * (1 - f(z)). For every other layer
   // in the neural network which comes before the output layer, the delta values
-  // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
-  // includes the KL divergence term, we adjust for that in the formula below.
-  klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) / (1 - rhoCap));
-  delOut = diff % outputLayer % (1 - outputLayer);
-  delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
-      arma::repmat(klDivGrad, 1, data.n_cols)) % hiddenLayer %
+  // are given del_n = w_n' * del_(n+1) * f'(z_n).
+  const arma::mat delOut = (outputLayer - points) % outputLayer %
+      (1 - outputLayer);
+  const arma::mat delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
+      arma::repmat(klDivGrad, 1, points.n_cols)) % hiddenLayer %
       (1 - hiddenLayer);
 
-  gradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
-
-  // Compute the gradient values using the activations and the delta values. The
-  // formula also accounts for the regularization terms in the objective.
-  // function.
-  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * data.t() / data.n_cols +
-      lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
-  gradient.submat(l1, 0, l3 - 1, l2 - 1) =
-      (delOut * hiddenLayer.t() / data.n_cols +
-      lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
-  gradient.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / data.n_cols;
-  gradient.submat(l3, 0, l3, l2 - 1) = (arma::sum(delOut, 1) / data.n_cols).t();
+  // Compute the gradient values using the activations and the delta values.
+  gradient.submat(0, 0, l1 - 1, l2 - 1) += delHid * points.t();
+  gradient.submat(l1, 0, l3 - 1, l2 - 1) += hiddenLayer * delOut.t();
+  gradient.submat(0, l2, l1 - 1, l2) += arma::sum(delHid, 1);
+  gradient.submat(l3, 0, l3, l2 - 1) += arma::sum(delOut, 1).t();
 }
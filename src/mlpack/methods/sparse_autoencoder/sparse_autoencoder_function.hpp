@@ -22,6 +22,15 @@ namespace nn {
  * This is a class for the sparse autoencoder objective function. It can be used
  * to create learning models like self-taught learning, stacked autoencoders,
  * conditional random fields (CRFs), and so forth.
+ *
+ * The function is decomposable, so it can be optimized in minibatches (with
+ * SGD, Adam, and so forth) as well as over the full dataset (with L_BFGS).  The
+ * objective of a batch is its share of the reconstruction error, plus the
+ * fraction batchSize / NumFunctions() of the regularization and sparsity terms;
+ * the sparsity term of a batch uses the average activations of the batch, so
+ * the objectives of the batches add up to the full objective only when the
+ * batch is the whole dataset.  The points of a batch are processed in blocks,
+ * in parallel, so the activations of the whole batch are never stored.
  */
 class SparseAutoencoderFunction
 {
@@ -70,6 +79,64 @@ class SparseAutoencoderFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluate the objective function and its gradient over the full dataset,
+   * with one forward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective function on the given batch of points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the gradient of the objective function on the given batch of
+   * points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the objective function and its gradient on the given batch of
+   * points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
+  //! Return the number of points (separable functions).
+  size_t NumFunctions() const { return data.n_cols; }
+
+  /**
+   * Shuffle the order of the points.  The data is not copied; the batches
+   * gather their points in the new order.
+   */
+  void Shuffle();
+
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
    * function of a real number 'x' is [1 / (1 + exp(-x))].
@@ -145,8 +212,44 @@ class SparseAutoencoderFunction
   }
 
  private:
+  /**
+   * Compute the objective function, and optionally its gradient, on the given
+   * batch of points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param gradient Matrix where gradient values will be stored, or NULL to
+   *     only compute the objective.
+   */
+  double Accumulate(const arma::mat& parameters,
+                    const size_t begin,
+                    const size_t batchSize,
+                    arma::mat* gradient) const;
+
+  //! Get the points [begin, end) of the current order (an alias of the data
+  //! if it is not shuffled).
+  arma::mat Points(const size_t begin, const size_t end) const;
+
+  //! Compute the activations of the hidden and output layers.
+  void Forward(const arma::mat& parameters,
+               const arma::mat& points,
+               arma::mat& hiddenLayer,
+               arma::mat& outputLayer) const;
+
+  //! Add the (unnormalized) gradient of the given points, without the
+  //! regularization, to the given matrix.
+  void Backward(const arma::mat& parameters,
+                const arma::mat& points,
+                const arma::mat& hiddenLayer,
+                const arma::mat& outputLayer,
+                const arma::vec& klDivGrad,
+                arma::mat& gradient) const;
+
   //! The matrix of data points.
   const arma::mat& data;
+  //! The order of the points (empty if they are not shuffled).
+  arma::uvec visitationOrder;
   //! Initial parameter vector.
   arma::mat initialPoint;
   //! Size of the visible layer.
@@ -39,22 +39,27 @@ void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
   // lambda2 > 0.
   arma::mat matGram = trans(dictionary) * dictionary;
 
+  Log::Debug << "Optimizing the codes of " << data.n_cols << " points."
+      << std::endl;
+
+  // The code of each point is an independent LARS problem.  Each thread has
+  // its own LARS object, and all of them share the Gram matrix.
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel
   {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-
     bool useCholesky = true;
     regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
 
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    arma::vec code = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictionary, responses, code, false);
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      // Create an alias of the code (using the same memory), and then LARS
+      // will place the result directly into that; then we will not need to
+      // have an extra copy.
+      arma::vec code = codes.unsafe_col(i);
+      arma::rowvec responses = data.unsafe_col(i).t();
+      lars.Train(dictionary, responses, code, false);
+    }
   }
 }
 
@@ -891,4 +891,54 @@ BOOST_AUTO_TEST_CASE(DecisionStumpSerializationTest)
   }
 }
 
+/**
+ * Make sure that training and classification give the same results with one
+ * thread and with several threads, for both types of weak learner.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainingTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+  #endif
+
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  const size_t numClasses = 3;
+  DecisionStump<> ds(inputData, labels.row(0), numClasses, 6);
+  Perceptron<> p(inputData, labels.row(0), numClasses, 100);
+
+  arma::Row<size_t> dsPredictions[2], pPredictions[2];
+  double dsZtProduct[2], pZtProduct[2];
+  for (size_t run = 0; run < 2; ++run)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(run == 0 ? 1 : 4);
+    #endif
+
+    AdaBoost<DecisionStump<>> dsa(inputData, labels.row(0), numClasses, ds, 50,
+        1e-10);
+    dsa.Classify(inputData, dsPredictions[run]);
+    dsZtProduct[run] = dsa.ZtProduct();
+
+    AdaBoost<> pa(inputData, labels.row(0), numClasses, p, 50, 1e-10);
+    pa.Classify(inputData, pPredictions[run]);
+    pZtProduct[run] = pa.ZtProduct();
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  CheckMatrices(dsPredictions[0], dsPredictions[1]);
+  CheckMatrices(pPredictions[0], pPredictions[1]);
+  BOOST_REQUIRE_CLOSE(dsZtProduct[0], dsZtProduct[1], 1e-5);
+  BOOST_REQUIRE_CLOSE(pZtProduct[0], pZtProduct[1], 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -19,9 +19,11 @@
 #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
 #include <mlpack/methods/ann/rnn.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -854,6 +856,66 @@ BOOST_AUTO_TEST_CASE(FastLSTMRrhoTest)
   CheckMatrices(modelB.Parameters(), modelA.Parameters());
 }
 
+/**
+ * Make sure that the fused sequence functions of the FastLSTM layer compute the
+ * same outputs, errors and gradients as the step-wise functions.
+ */
+BOOST_AUTO_TEST_CASE(FastLSTMSequenceTest)
+{
+  const size_t steps = 6;
+  const size_t batchSize = 4;
+
+  FastLSTM<> stepwise(5, 3, steps), fused(5, 3, steps);
+  stepwise.Parameters().randu();
+  stepwise.Parameters() -= 0.5;
+  fused.Parameters() = stepwise.Parameters();
+  stepwise.Reset();
+  fused.Reset();
+
+  arma::mat input = arma::randu(5, steps * batchSize);
+  arma::mat error = arma::randu(3, steps * batchSize);
+
+  // Step through time.
+  arma::mat output(3, steps * batchSize), delta(5, steps * batchSize);
+  arma::mat gradient = arma::zeros(stepwise.Parameters().n_elem, 1);
+  for (size_t t = 0; t < steps; ++t)
+  {
+    arma::mat stepOutput;
+    stepwise.Forward(std::move(arma::mat(input.cols(t * batchSize,
+        (t + 1) * batchSize - 1))), std::move(stepOutput));
+    output.cols(t * batchSize, (t + 1) * batchSize - 1) = stepOutput;
+  }
+
+  for (size_t t = steps; t > 0; --t)
+  {
+    const size_t first = (t - 1) * batchSize;
+    const size_t last = t * batchSize - 1;
+
+    arma::mat gy = error.cols(first, last);
+    arma::mat g, stepGradient(stepwise.Parameters().n_elem, 1);
+    stepwise.Backward(std::move(arma::mat()), std::move(gy), std::move(g));
+    stepwise.Gradient(std::move(arma::mat(input.cols(first, last))),
+        std::move(gy), std::move(stepGradient));
+
+    delta.cols(first, last) = g;
+    gradient += stepGradient;
+  }
+
+  // Process the whole sequence at once.
+  arma::mat fusedOutput, fusedDelta, fusedGradient;
+  fused.ForwardSequence(input, batchSize, fusedOutput);
+  fused.BackwardSequence(error, fusedDelta);
+  fused.GradientSequence(input, fusedGradient);
+
+  CheckMatrices(output, fusedOutput);
+  CheckMatrices(delta, fusedDelta);
+  CheckMatrices(gradient, fusedGradient);
+
+  // The buffers are reused for a second sequence.
+  fused.ForwardSequence(input, batchSize, fusedOutput);
+  CheckMatrices(output, fusedOutput);
+}
+
 /**
  * FastLSTM layer numerical gradient test.
  */
@@ -1122,6 +1184,39 @@ BOOST_AUTO_TEST_CASE(SimpleLookupLayerTest)
   BOOST_REQUIRE_CLOSE(arma::accu(gradient), arma::accu(error), 1e-3);
 }
 
+/**
+ * Make sure that the Lookup gradient sums the errors of repeated words, and
+ * that the sparse gradient only writes the used columns.
+ */
+BOOST_AUTO_TEST_CASE(LookupSparseGradientTest)
+{
+  Lookup<> module(10, 3);
+  module.Parameters().randu();
+
+  arma::mat input("2; 5; 2"), error, gradient;
+  error.randu(3, 3);
+  module.Gradient(std::move(input), std::move(error), std::move(gradient));
+
+  CheckMatrices(gradient.col(1), error.col(0) + error.col(2));
+  CheckMatrices(gradient.col(4), error.col(1));
+  BOOST_REQUIRE_SMALL(arma::accu(arma::abs(gradient)) -
+      arma::accu(arma::abs(error)), 1e-8);
+
+  // Columns that are not used keep their value.
+  arma::mat sparseGradient(3, 10);
+  sparseGradient.fill(7.0);
+  module.SparseGradient(std::move(input), std::move(error),
+      std::move(sparseGradient));
+
+  BOOST_REQUIRE_EQUAL(module.TouchedColumns().n_elem, 2);
+  BOOST_REQUIRE_EQUAL(module.TouchedColumns()[0], 1);
+  BOOST_REQUIRE_EQUAL(module.TouchedColumns()[1], 4);
+  CheckMatrices(sparseGradient.col(1), gradient.col(1));
+  CheckMatrices(sparseGradient.col(4), gradient.col(4));
+  BOOST_REQUIRE_CLOSE(sparseGradient(0, 0), 7.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(sparseGradient(2, 9), 7.0, 1e-5);
+}
+
 /**
  * Simple LogSoftMax module test.
  */
@@ -1371,6 +1466,70 @@ BOOST_AUTO_TEST_CASE(BatchNormTest)
   CheckMatrices(output, result, 1e-1);
 }
 
+/**
+ * Make sure that the passes of the BatchNorm layer agree with the textbook
+ * formulas, and that the running statistics merged batch by batch are those
+ * of the whole data.
+ */
+BOOST_AUTO_TEST_CASE(BatchNormReferenceTest)
+{
+  arma::mat input = arma::randn(7, 50) * 3.0 + 2.0;
+  arma::mat input2 = arma::randn(7, 30) - 1.0;
+  const double eps = 1e-5;
+
+  BatchNorm<> model(7, eps);
+  model.Reset();
+  model.Parameters().randn();
+
+  arma::mat output;
+  model.Forward(std::move(input), std::move(output));
+
+  const arma::vec gamma = model.Parameters().rows(0, 6);
+  const arma::vec beta = model.Parameters().rows(7, 13);
+  const arma::vec mean = arma::mean(input, 1);
+  const arma::vec stdInv = 1.0 / arma::sqrt(arma::var(input, 1, 1) + eps);
+  arma::mat xhat = input.each_col() - mean;
+  xhat.each_col() %= stdInv;
+  arma::mat expected = xhat.each_col() % gamma;
+  expected.each_col() += beta;
+  CheckMatrices(output, expected, 1e-6);
+
+  // Reference backward pass and gradient.
+  arma::mat gy = arma::randn(7, 50);
+  arma::mat g, gradient;
+  model.Backward(std::move(output), std::move(gy), std::move(g));
+  model.Gradient(std::move(input), std::move(gy), std::move(gradient));
+
+  const arma::mat dxhat = gy.each_col() % gamma;
+  arma::mat expectedG = 50 * dxhat;
+  expectedG.each_col() -= arma::sum(dxhat, 1);
+  expectedG -= xhat.each_col() % arma::sum(dxhat % xhat, 1);
+  expectedG.each_col() %= stdInv / 50.0;
+  CheckMatrices(g, expectedG, 1e-6);
+  CheckMatrices(gradient.rows(0, 6), arma::sum(gy % xhat, 1), 1e-6);
+  CheckMatrices(gradient.rows(7, 13), arma::sum(gy, 1), 1e-6);
+
+  // The statistics of the two batches are those of all the points.
+  model.Forward(std::move(input2), std::move(output));
+  const arma::mat all = arma::join_rows(input, input2);
+  CheckMatrices(model.TrainingMean(), arma::mean(all, 1), 1e-6);
+  CheckMatrices(model.TrainingVariance(), arma::var(all, 1, 1), 1e-6);
+  BOOST_REQUIRE_EQUAL(model.Stats().count(), 80);
+  CheckMatrices(model.Stats().var(), arma::var(all, 0, 1), 1e-6);
+
+  // The deterministic passes use the training statistics.
+  model.Deterministic() = true;
+  model.Forward(std::move(input), std::move(output));
+  const arma::vec scale = gamma / arma::sqrt(arma::var(all, 1, 1) + eps);
+  expected = input.each_col() - arma::mean(all, 1);
+  expected.each_col() %= scale;
+  expected.each_col() += beta;
+  CheckMatrices(output, expected, 1e-6);
+
+  model.Backward(std::move(output), std::move(gy), std::move(g));
+  CheckMatrices(g, gy.each_col() % scale, 1e-6);
+}
+
 /**
  * BatchNorm layer numerically gradient test.
  */
@@ -1415,4 +1574,640 @@ BOOST_AUTO_TEST_CASE(GradientBatchNormLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * Make sure that the im2col convolution rule computes the same forward pass,
+ * backward pass and gradient as the naive convolution rule.
+ */
+BOOST_AUTO_TEST_CASE(ImToColConvolutionLayerTest)
+{
+  for (size_t pad = 0; pad < 2; pad++)
+  {
+    Convolution<> naive(2, 3, 3, 3, 1, 1, pad, pad, 7, 6);
+    Convolution<ImToColConvolution<ValidConvolution>,
+        ImToColConvolution<FullConvolution>,
+        ImToColConvolution<ValidConvolution> > imToCol(2, 3, 3, 3, 1, 1, pad,
+        pad, 7, 6);
+
+    naive.Parameters().randu();
+    imToCol.Parameters() = naive.Parameters();
+    naive.Reset();
+    imToCol.Reset();
+
+    arma::mat input = arma::randu(7 * 6 * 2, 4);
+    arma::mat naiveOutput, imToColOutput;
+    naive.Forward(std::move(input), std::move(naiveOutput));
+    imToCol.Forward(std::move(input), std::move(imToColOutput));
+    CheckMatrices(naiveOutput, imToColOutput, 1e-6);
+
+    arma::mat error = arma::randu(naiveOutput.n_rows, naiveOutput.n_cols);
+    arma::mat naiveDelta, imToColDelta;
+    naive.Backward(std::move(input), std::move(error), std::move(naiveDelta));
+    imToCol.Backward(std::move(input), std::move(error),
+        std::move(imToColDelta));
+    CheckMatrices(naiveDelta, imToColDelta, 1e-6);
+
+    arma::mat naiveGradient(naive.Parameters().n_elem, 1);
+    arma::mat imToColGradient(imToCol.Parameters().n_elem, 1);
+    naive.Gradient(std::move(input), std::move(error),
+        std::move(naiveGradient));
+    imToCol.Gradient(std::move(input), std::move(error),
+        std::move(imToColGradient));
+    CheckMatrices(naiveGradient, imToColGradient, 1e-6);
+  }
+}
+
+/**
+ * Make sure that a network can hold a convolution layer with the im2col rule,
+ * which computes the same predictions as the naive rule, and that such a
+ * network can be serialized.
+ */
+BOOST_AUTO_TEST_CASE(ImToColConvolutionNetworkTest)
+{
+  arma::mat input = arma::randu(8 * 8, 16);
+
+  FFN<NegativeLogLikelihood<> > naiveModel;
+  naiveModel.Add<Convolution<> >(1, 2, 3, 3, 1, 1, 1, 1, 8, 8);
+  naiveModel.Add<Linear<> >(128, 2);
+  naiveModel.Add<LogSoftMax<> >();
+  naiveModel.ResetParameters();
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<ImToColConvolutionLayer<> >(1, 2, 3, 3, 1, 1, 1, 1, 8, 8);
+  model.Add<Linear<> >(128, 2);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+  model.Parameters() = naiveModel.Parameters();
+
+  arma::mat naivePredictions, predictions;
+  naiveModel.Predict(input, naivePredictions);
+  model.Predict(input, predictions);
+  CheckMatrices(naivePredictions, predictions, 1e-6);
+
+  FFN<NegativeLogLikelihood<> > xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  xmlModel.Predict(input, xmlPredictions);
+  textModel.Predict(input, textPredictions);
+  binaryModel.Predict(input, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that single-precision layers compute the same results as the
+ * corresponding double-precision layers.
+ */
+BOOST_AUTO_TEST_CASE(FloatLayerTest)
+{
+  Linear<> linear(10, 5);
+  Linear<arma::fmat, arma::fmat> linearFloat(10, 5);
+  linear.Parameters().randu();
+  linearFloat.Parameters() = arma::conv_to<arma::fmat>::from(
+      linear.Parameters());
+  linear.Reset();
+  linearFloat.Reset();
+
+  BatchNorm<> batchNorm(5);
+  BatchNorm<arma::fmat, arma::fmat> batchNormFloat(5);
+  batchNorm.Reset();
+  batchNormFloat.Reset();
+
+  LogSoftMax<> logSoftMax;
+  LogSoftMax<arma::fmat, arma::fmat> logSoftMaxFloat;
+
+  arma::mat input = arma::randu(10, 8);
+  arma::fmat inputFloat = arma::conv_to<arma::fmat>::from(input);
+
+  arma::mat linearOutput, normOutput, output;
+  linear.Forward(std::move(input), std::move(linearOutput));
+  batchNorm.Forward(std::move(linearOutput), std::move(normOutput));
+  logSoftMax.Forward(std::move(normOutput), std::move(output));
+
+  arma::fmat linearOutputFloat, normOutputFloat, outputFloat;
+  linearFloat.Forward(std::move(inputFloat), std::move(linearOutputFloat));
+  batchNormFloat.Forward(std::move(linearOutputFloat),
+      std::move(normOutputFloat));
+  logSoftMaxFloat.Forward(std::move(normOutputFloat), std::move(outputFloat));
+
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(outputFloat), 1e-2);
+
+  // Backward pass and gradient of the linear layer.
+  arma::mat error = arma::randu(5, 8);
+  arma::fmat errorFloat = arma::conv_to<arma::fmat>::from(error);
+
+  arma::mat delta, gradient(linear.Parameters().n_elem, 1);
+  linear.Backward(std::move(input), std::move(error), std::move(delta));
+  linear.Gradient(std::move(input), std::move(error), std::move(gradient));
+
+  arma::fmat deltaFloat, gradientFloat(linearFloat.Parameters().n_elem, 1);
+  linearFloat.Backward(std::move(inputFloat), std::move(errorFloat),
+      std::move(deltaFloat));
+  linearFloat.Gradient(std::move(inputFloat), std::move(errorFloat),
+      std::move(gradientFloat));
+
+  CheckMatrices(delta, arma::conv_to<arma::mat>::from(deltaFloat), 1e-2);
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(gradientFloat),
+      1e-2);
+
+  // The single-precision weights have to survive serialization.
+  Linear<arma::fmat, arma::fmat> xmlLinear(10, 5), textLinear(10, 5),
+      binaryLinear(10, 5);
+  SerializeObjectAll(linearFloat, xmlLinear, textLinear, binaryLinear);
+  CheckMatrices(arma::conv_to<arma::mat>::from(linearFloat.Parameters()),
+      arma::conv_to<arma::mat>::from(xmlLinear.Parameters()),
+      arma::conv_to<arma::mat>::from(textLinear.Parameters()),
+      arma::conv_to<arma::mat>::from(binaryLinear.Parameters()));
+}
+
+/**
+ * Pool every map of the input with the given window with Armadillo; the
+ * reference for the pooling layer tests.
+ */
+template<typename PoolingFunction>
+arma::mat ReferencePooling(const arma::mat& input,
+                           const size_t width,
+                           const size_t height,
+                           const size_t kW,
+                           const size_t kH,
+                           const size_t dW,
+                           const size_t dH,
+                           PoolingFunction pool)
+{
+  const size_t outWidth = (width - kW) / dW + 1;
+  const size_t outHeight = (height - kH) / dH + 1;
+  const size_t maps = input.n_elem / (width * height);
+  arma::cube inputCube(const_cast<double*>(input.memptr()), width, height,
+      maps, false, true);
+  arma::cube output(outWidth, outHeight, maps);
+  for (size_t s = 0; s < maps; ++s)
+    for (size_t j = 0; j < outHeight; ++j)
+      for (size_t i = 0; i < outWidth; ++i)
+        output(i, j, s) = pool(inputCube.slice(s).submat(i * dW, j * dH,
+            i * dW + kW - 1, j * dH + kH - 1));
+
+  return arma::mat(output.memptr(), output.n_elem / input.n_cols,
+      input.n_cols);
+}
+
+/**
+ * Make sure that the max and mean pooling layers compute the same pooled maps
+ * as a reference on a batch of multi-channel inputs, both for the 2x2 stride 2
+ * windows and for other windows, and that their backward passes are right.
+ */
+BOOST_AUTO_TEST_CASE(PoolingLayerBatchTest)
+{
+  // 3 channels of 6x8 maps for 4 points.
+  arma::mat input = arma::randu(6 * 8 * 3, 4);
+  const size_t windows[2][4] = { { 2, 2, 2, 2 }, { 3, 2, 1, 2 } };
+  for (size_t w = 0; w < 2; ++w)
+  {
+    const size_t kW = windows[w][0], kH = windows[w][1];
+    const size_t dW = windows[w][2], dH = windows[w][3];
+
+    MaxPooling<> maxPooling(kW, kH, dW, dH);
+    MeanPooling<> meanPooling(kW, kH, dW, dH);
+    maxPooling.InputWidth() = meanPooling.InputWidth() = 6;
+    maxPooling.InputHeight() = meanPooling.InputHeight() = 8;
+
+    arma::mat maxOutput, meanOutput;
+    maxPooling.Forward(std::move(input), std::move(maxOutput));
+    meanPooling.Forward(std::move(input), std::move(meanOutput));
+
+    CheckMatrices(maxOutput, ReferencePooling(input, 6, 8, kW, kH, dW, dH,
+        [](const arma::mat& x) { return x.max(); }));
+    CheckMatrices(meanOutput, ReferencePooling(input, 6, 8, kW, kH, dW, dH,
+        [](const arma::mat& x) { return arma::mean(arma::vectorise(x)); }));
+
+    // The error of every window goes to its maximum.
+    arma::mat error = arma::randu(maxOutput.n_rows, maxOutput.n_cols);
+    arma::mat maxDelta, meanDelta;
+    maxPooling.Backward(std::move(input), std::move(error),
+        std::move(maxDelta));
+    BOOST_REQUIRE_EQUAL(maxDelta.n_rows, input.n_rows);
+    BOOST_REQUIRE_EQUAL(maxDelta.n_cols, input.n_cols);
+    BOOST_REQUIRE_CLOSE(arma::accu(maxDelta), arma::accu(error), 1e-5);
+    BOOST_REQUIRE_CLOSE(arma::accu(maxDelta % input),
+        arma::accu(error % maxOutput), 1e-5);
+
+    // Mean pooling is linear, so its backward pass is its adjoint.
+    meanPooling.Backward(std::move(input), std::move(error),
+        std::move(meanDelta));
+    arma::mat other = arma::randu(input.n_rows, input.n_cols);
+    arma::mat otherOutput;
+    meanPooling.Forward(std::move(other), std::move(otherOutput));
+    BOOST_REQUIRE_CLOSE(arma::accu(meanDelta % other),
+        arma::accu(error % otherOutput), 1e-5);
+  }
+}
+
+/**
+ * Make sure that single-precision convolution and pooling layers compute the
+ * same results as the corresponding double-precision layers.
+ */
+BOOST_AUTO_TEST_CASE(FloatConvolutionLayerTest)
+{
+  Convolution<> conv(2, 3, 3, 3, 1, 1, 1, 1, 8, 8);
+  Convolution<NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<FullConvolution>,
+      NaiveConvolution<ValidConvolution>,
+      arma::fmat, arma::fmat> convFloat(2, 3, 3, 3, 1, 1, 1, 1, 8, 8);
+  conv.Parameters().randu();
+  convFloat.Parameters() = arma::conv_to<arma::fmat>::from(conv.Parameters());
+  conv.Reset();
+  convFloat.Reset();
+
+  MaxPooling<> pooling(2, 2, 2, 2);
+  MaxPooling<arma::fmat, arma::fmat> poolingFloat(2, 2, 2, 2);
+  pooling.InputWidth() = poolingFloat.InputWidth() = 8;
+  pooling.InputHeight() = poolingFloat.InputHeight() = 8;
+
+  arma::mat input = arma::randu(8 * 8 * 2, 4);
+  arma::fmat inputFloat = arma::conv_to<arma::fmat>::from(input);
+
+  arma::mat convOutput, output;
+  conv.Forward(std::move(input), std::move(convOutput));
+  pooling.Forward(std::move(convOutput), std::move(output));
+
+  arma::fmat convOutputFloat, outputFloat;
+  convFloat.Forward(std::move(inputFloat), std::move(convOutputFloat));
+  poolingFloat.Forward(std::move(convOutputFloat), std::move(outputFloat));
+
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(outputFloat), 1e-2);
+
+  arma::mat error = arma::randu(output.n_rows, output.n_cols);
+  arma::fmat errorFloat = arma::conv_to<arma::fmat>::from(error);
+
+  arma::mat poolingDelta, delta;
+  pooling.Backward(std::move(convOutput), std::move(error),
+      std::move(poolingDelta));
+  conv.Backward(std::move(input), std::move(poolingDelta), std::move(delta));
+
+  arma::fmat poolingDeltaFloat, deltaFloat;
+  poolingFloat.Backward(std::move(convOutputFloat), std::move(errorFloat),
+      std::move(poolingDeltaFloat));
+  convFloat.Backward(std::move(inputFloat), std::move(poolingDeltaFloat),
+      std::move(deltaFloat));
+
+  CheckMatrices(delta, arma::conv_to<arma::mat>::from(deltaFloat), 1e-2);
+}
+
+/**
+ * Make sure that the 8-bit quantized linear and convolution layers compute
+ * (nearly) the same results as the corresponding floating point layers, and
+ * that they can be serialized.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedLayerTest)
+{
+  Linear<> linear(10, 5);
+  linear.Parameters().randn();
+  linear.Reset();
+
+  const arma::mat weight = arma::reshape(linear.Parameters().rows(0, 49), 5,
+      10);
+  const arma::vec bias = linear.Parameters().rows(50, 54);
+
+  arma::mat input = arma::randu(10, 8);
+  QuantizedLinear<> quantizedLinear(weight, bias,
+      Quantization::Scale(arma::abs(input).max()));
+
+  arma::mat output, quantizedOutput;
+  linear.Forward(std::move(input), std::move(output));
+  quantizedLinear.Forward(std::move(input), std::move(quantizedOutput));
+  BOOST_REQUIRE_LT(arma::abs(output - quantizedOutput).max(), 0.1);
+
+  // The error is propagated through the dequantized weights.
+  arma::mat error = arma::randu(5, 8);
+  arma::mat delta, quantizedDelta;
+  linear.Backward(std::move(input), std::move(error), std::move(delta));
+  quantizedLinear.Backward(std::move(input), std::move(error),
+      std::move(quantizedDelta));
+  BOOST_REQUIRE_LT(arma::abs(delta - quantizedDelta).max(), 0.1);
+
+  Convolution<> conv(2, 3, 3, 3, 1, 1, 1, 1, 8, 8);
+  conv.Parameters().randu();
+  conv.Reset();
+
+  const arma::cube filter(conv.Parameters().memptr(), 3, 3, 3 * 2);
+  const arma::vec convBias = conv.Parameters().rows(filter.n_elem,
+      filter.n_elem + 2);
+
+  arma::mat convInput = arma::randu(8 * 8 * 2, 4);
+  QuantizedConvolution<> quantizedConv(2, 3, filter, convBias,
+      Quantization::Scale(arma::abs(convInput).max()), 1, 1, 1, 1, 8, 8);
+
+  arma::mat convOutput, quantizedConvOutput;
+  conv.Forward(std::move(convInput), std::move(convOutput));
+  quantizedConv.Forward(std::move(convInput), std::move(quantizedConvOutput));
+  BOOST_REQUIRE_EQUAL(quantizedConv.OutputWidth(), conv.OutputWidth());
+  BOOST_REQUIRE_EQUAL(quantizedConv.OutputHeight(), conv.OutputHeight());
+  BOOST_REQUIRE_LT(arma::abs(convOutput - quantizedConvOutput).max(), 0.1);
+
+  QuantizedConvolution<> xmlConv, textConv, binaryConv;
+  SerializeObjectAll(quantizedConv, xmlConv, textConv, binaryConv);
+
+  arma::mat xmlOutput, textOutput, binaryOutput;
+  xmlConv.Forward(std::move(convInput), std::move(xmlOutput));
+  textConv.Forward(std::move(convInput), std::move(textOutput));
+  binaryConv.Forward(std::move(convInput), std::move(binaryOutput));
+  CheckMatrices(quantizedConvOutput, xmlOutput);
+  CheckMatrices(quantizedConvOutput, textOutput);
+  CheckMatrices(quantizedConvOutput, binaryOutput);
+}
+
+/**
+ * Jacobian LayerNorm module test, with one and with several vectors per point.
+ */
+BOOST_AUTO_TEST_CASE(JacobianLayerNormLayerTest)
+{
+  for (size_t vectors = 1; vectors < 4; vectors++)
+  {
+    arma::mat input;
+    input.set_size(6 * vectors, 1);
+
+    LayerNorm<> module(6);
+    module.Reset();
+    module.Parameters().randu();
+
+    double error = JacobianTest(module, input, -2, 2);
+    BOOST_REQUIRE_LE(error, 1e-5);
+  }
+}
+
+/**
+ * LayerNorm layer numerically gradient test.
+ */
+BOOST_AUTO_TEST_CASE(GradientLayerNormLayerTest)
+{
+  // Add function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randn(10, 16);
+      target.ones(1, 16);
+
+      model = new FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>(
+          input, target);
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(10, 10);
+      model->Add<LayerNorm<> >(5);
+      model->Add<Linear<> >(10, 2);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 16, false);
+      model->Gradient(model->Parameters(), 0, gradient, 16);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
+/**
+ * Make sure that the PositionalEncoding layer adds the sinusoidal signal to
+ * sequences of any length up to the maximum, and passes the error on.
+ */
+BOOST_AUTO_TEST_CASE(SimplePositionalEncodingLayerTest)
+{
+  PositionalEncoding<> module(4, 10);
+  arma::mat input = arma::zeros(4 * 3, 2);
+  arma::mat output, delta;
+  module.Forward(std::move(input), std::move(output));
+
+  BOOST_REQUIRE_EQUAL(output.n_rows, 12);
+  for (size_t t = 0; t < 3; ++t)
+  {
+    BOOST_REQUIRE_CLOSE(output(4 * t, 1), std::sin(t), 1e-8);
+    BOOST_REQUIRE_CLOSE(output(4 * t + 1, 1), std::cos(t), 1e-8);
+    BOOST_REQUIRE_SMALL(output(4 * t + 2, 1) - std::sin(t / 100.0), 1e-12);
+    BOOST_REQUIRE_CLOSE(output(4 * t + 3, 1), std::cos(t / 100.0), 1e-8);
+  }
+
+  module.Backward(std::move(input), std::move(output), std::move(delta));
+  CheckMatrices(delta, output);
+
+  PositionalEncoding<> xmlModule, textModule, binaryModule;
+  SerializeObjectAll(module, xmlModule, textModule, binaryModule);
+  CheckMatrices(xmlModule.Encoding(), module.Encoding());
+  CheckMatrices(textModule.Encoding(), module.Encoding());
+  CheckMatrices(binaryModule.Encoding(), module.Encoding());
+}
+
+/**
+ * Compute the multi-head attention of the given sequences the textbook way,
+ * with the whole matrix of scores, for comparison.
+ */
+arma::mat NaiveMultiheadAttention(const arma::mat& parameters,
+                                  const arma::mat& input,
+                                  const size_t embedSize,
+                                  const size_t numHeads,
+                                  const bool causal)
+{
+  const size_t e = embedSize;
+  const size_t d = e / numHeads;
+  const size_t length = input.n_rows / e;
+  const arma::mat inWeight(parameters.memptr(), 3 * e, e);
+  const arma::mat outWeight(parameters.memptr() + 3 * e * e, e, e);
+  const arma::vec inBias(parameters.memptr() + 4 * e * e, 3 * e);
+  const arma::vec outBias(parameters.memptr() + 4 * e * e + 3 * e, e);
+
+  arma::mat output(input.n_rows, input.n_cols);
+  for (size_t s = 0; s < input.n_cols; ++s)
+  {
+    const arma::mat x = arma::reshape(input.col(s), e, length);
+    arma::mat qkv = inWeight * x;
+    qkv.each_col() += inBias;
+
+    arma::mat heads(e, length);
+    for (size_t h = 0; h < numHeads; ++h)
+    {
+      const arma::mat q = qkv.rows(h * d, h * d + d - 1);
+      const arma::mat k = qkv.rows(e + h * d, e + h * d + d - 1);
+      const arma::mat v = qkv.rows(2 * e + h * d, 2 * e + h * d + d - 1);
+      arma::mat scores = k.t() * q / std::sqrt((double) d);
+      for (size_t j = 0; j < length; ++j)
+      {
+        if (causal && j + 1 < length)
+          scores.col(j).rows(j + 1, length - 1).fill(-arma::datum::inf);
+        scores.col(j) = arma::exp(scores.col(j) - scores.col(j).max());
+        scores.col(j) /= arma::accu(scores.col(j));
+      }
+      heads.rows(h * d, h * d + d - 1) = v * scores;
+    }
+
+    arma::mat y = outWeight * heads;
+    y.each_col() += outBias;
+    output.col(s) = arma::vectorise(y);
+  }
+
+  return output;
+}
+
+/**
+ * Make sure that the blockwise softmax of the MultiheadAttention layer gives
+ * the attention of the whole matrix of scores, for any block size, with and
+ * without causal masking, and that causal masking hides the following
+ * elements.
+ */
+BOOST_AUTO_TEST_CASE(MultiheadAttentionBlockwiseTest)
+{
+  const size_t embedSize = 6;
+  const size_t length = 7;
+  arma::mat input = arma::randn(embedSize * length, 3);
+
+  for (size_t causal = 0; causal < 2; ++causal)
+  {
+    MultiheadAttention<> reference(embedSize, 3, causal);
+    reference.Parameters().randn();
+    reference.Parameters() *= 0.5;
+    reference.Reset();
+
+    const arma::mat expected = NaiveMultiheadAttention(
+        reference.Parameters(), input, embedSize, 3, causal);
+
+    for (size_t blockSize = 1; blockSize <= length + 1; ++blockSize)
+    {
+      MultiheadAttention<> module(embedSize, 3, causal, blockSize);
+      module.Parameters() = reference.Parameters();
+      module.Reset();
+
+      arma::mat output;
+      module.Forward(std::move(input), std::move(output));
+      CheckMatrices(output, expected, 1e-6);
+    }
+
+    // Changing the last element of a sequence only changes the output of the
+    // earlier elements without causal masking.
+    arma::mat changed = input;
+    changed.rows(embedSize * (length - 1), embedSize * length - 1).randn();
+    arma::mat output, changedOutput;
+    reference.Forward(std::move(input), std::move(output));
+    reference.Forward(std::move(changed), std::move(changedOutput));
+    const double difference = arma::abs(output.rows(0,
+        embedSize * (length - 1) - 1) - changedOutput.rows(0,
+        embedSize * (length - 1) - 1)).max();
+    if (causal)
+      BOOST_REQUIRE_SMALL(difference, 1e-12);
+    else
+      BOOST_REQUIRE_GT(difference, 1e-6);
+  }
+}
+
+/**
+ * Jacobian MultiheadAttention module test, with blocks smaller than the
+ * sequences.
+ */
+BOOST_AUTO_TEST_CASE(JacobianMultiheadAttentionLayerTest)
+{
+  for (size_t causal = 0; causal < 2; ++causal)
+  {
+    arma::mat input;
+    input.set_size(4 * 5, 1);
+
+    MultiheadAttention<> module(4, 2, causal, 2);
+    module.Parameters().randn();
+    module.Reset();
+
+    double error = JacobianTest(module, input, -1, 1);
+    BOOST_REQUIRE_LE(error, 1e-5);
+  }
+}
+
+/**
+ * MultiheadAttention layer numerically gradient test, as the first layer of
+ * the network (whose Backward() is not called) and after another one.
+ */
+BOOST_AUTO_TEST_CASE(GradientMultiheadAttentionLayerTest)
+{
+  // Add function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction(const bool first)
+    {
+      input = arma::randn(4 * 5, 8);
+      target.ones(1, 8);
+
+      model = new FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>(
+          input, target);
+      if (!first)
+      {
+        model->Add<IdentityLayer<> >();
+        model->Add<PositionalEncoding<> >(4, 5);
+      }
+      model->Add<MultiheadAttention<> >(4, 2, true, 2);
+      model->Add<LayerNorm<> >(4);
+      model->Add<Linear<> >(20, 2);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 8, false);
+      model->Gradient(model->Parameters(), 0, gradient, 8);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<NegativeLogLikelihood<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  };
+
+  GradientFunction first(true), second(false);
+  BOOST_REQUIRE_LE(CheckGradient(first), 1e-4);
+  BOOST_REQUIRE_LE(CheckGradient(second), 1e-4);
+}
+
+/**
+ * Make sure that a serialized MultiheadAttention layer keeps its settings.
+ */
+BOOST_AUTO_TEST_CASE(MultiheadAttentionSerializationTest)
+{
+  MultiheadAttention<> module(6, 2, true, 3);
+  module.Parameters().randn();
+  module.Reset();
+
+  arma::mat input = arma::randn(6 * 4, 2);
+  arma::mat output;
+  module.Forward(std::move(input), std::move(output));
+
+  MultiheadAttention<> xmlModule, textModule, binaryModule;
+  SerializeObjectAll(module, xmlModule, textModule, binaryModule);
+
+  for (MultiheadAttention<>* loaded : { &xmlModule, &textModule,
+      &binaryModule })
+  {
+    BOOST_REQUIRE_EQUAL(loaded->NumHeads(), 2);
+    BOOST_REQUIRE_EQUAL(loaded->Causal(), true);
+    BOOST_REQUIRE_EQUAL(loaded->BlockSize(), 3);
+    BOOST_REQUIRE_EQUAL(loaded->Parameters().n_elem,
+        module.Parameters().n_elem);
+
+    loaded->Parameters() = module.Parameters();
+    loaded->Reset();
+    arma::mat loadedOutput;
+    loaded->Forward(std::move(input), std::move(loadedOutput));
+    CheckMatrices(loadedOutput, output);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
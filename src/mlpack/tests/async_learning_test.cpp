@@ -217,4 +217,73 @@ BOOST_AUTO_TEST_CASE(NStepQLearningTest)
   Log::Debug << "Total test episodes: " << testEpisodes << std::endl;
 }
 
+// Test that a checkpoint saved by Train() is restored by Resume().
+BOOST_AUTO_TEST_CASE(AsyncLearningCheckpointTest)
+{
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(1);
+  #endif
+
+  const std::string filename = "async_learning_checkpoint.bin";
+  std::remove(filename.c_str());
+
+  // Set up the network.
+  FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+      GaussianInitialization(0, 0.001));
+  model.Add<Linear<>>(4, 10);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(10, 2);
+
+  TrainingConfig config;
+  config.StepSize() = 0.0001;
+  config.Discount() = 0.99;
+  config.NumWorkers() = 2;
+  config.UpdateInterval() = 6;
+  config.StepLimit() = 50;
+  config.TargetNetworkSyncInterval() = 20;
+
+  using Policy = GreedyPolicy<CartPole>;
+  OneStepQLearning<CartPole, decltype(model), VanillaUpdate, Policy> agent(
+      config, model, Policy(0.7, 500, 0.1));
+  agent.CheckpointFile() = filename;
+  agent.CheckpointPeriod() = 0.0;
+
+  // Nothing to resume from yet.
+  BOOST_REQUIRE(!agent.Resume());
+
+  size_t testEpisodes = 0;
+  auto measure = [&testEpisodes](double /* reward */)
+  {
+    return ++testEpisodes >= 5;
+  };
+  agent.Train(measure);
+  BOOST_REQUIRE_GT(agent.TotalSteps(), 0);
+
+  // Resume with a new agent.
+  OneStepQLearning<CartPole, decltype(model), VanillaUpdate, Policy> resumed(
+      config, model, Policy(0.7, 500, 0.1));
+  resumed.CheckpointFile() = filename;
+  BOOST_REQUIRE(resumed.Resume());
+
+  BOOST_REQUIRE_EQUAL(resumed.TotalSteps(), agent.TotalSteps());
+  CheckMatrices(resumed.Network().Parameters(), agent.Network().Parameters());
+  BOOST_REQUIRE_LT(resumed.Policy().Epsilon(), 0.7);
+
+  // Training continues from the restored steps.
+  testEpisodes = 0;
+  resumed.Train(measure);
+  BOOST_REQUIRE_GT(resumed.TotalSteps(), agent.TotalSteps());
+
+  // A checkpoint of another network is refused.
+  FFN<MeanSquaredError<>, GaussianInitialization> otherModel(
+      MeanSquaredError<>(), GaussianInitialization(0, 0.001));
+  otherModel.Add<Linear<>>(4, 2);
+  OneStepQLearning<CartPole, decltype(otherModel), VanillaUpdate, Policy>
+      other(config, otherModel, Policy(0.7, 500, 0.1));
+  other.CheckpointFile() = filename;
+  BOOST_REQUIRE_THROW(other.Resume(), std::runtime_error);
+
+  std::remove(filename.c_str());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
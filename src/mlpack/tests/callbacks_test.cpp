@@ -0,0 +1,296 @@
+/**
+ * @file callbacks_test.cpp
+ *
+ * Tests for the optimizer callbacks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/callbacks/callbacks.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/adam/adam.hpp>
+#include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
+#include <mlpack/core/optimizers/sarah/sarah.hpp>
+#include <mlpack/core/optimizers/sa/sa.hpp>
+#include <mlpack/core/optimizers/cmaes/cmaes.hpp>
+#include <mlpack/core/optimizers/grid_search/grid_search.hpp>
+#include <mlpack/core/optimizers/problems/sgd_test_function.hpp>
+#include <mlpack/core/optimizers/problems/rosenbrock_function.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression_function.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "test_function_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::optimization::test;
+using namespace mlpack::regression;
+
+BOOST_AUTO_TEST_SUITE(CallbacksTest);
+
+/**
+ * A callback that records the information of each iteration, and terminates
+ * after the given number of iterations.
+ */
+class RecordingCallback
+{
+ public:
+  RecordingCallback(const size_t maxIterations) : maxIterations(maxIterations)
+  { }
+
+  bool Iteration(const arma::mat& /* coordinates */, const IterationInfo& info)
+  {
+    infos.push_back(info);
+    return infos.size() >= maxIterations;
+  }
+
+  size_t maxIterations;
+  std::vector<IterationInfo> infos;
+};
+
+/**
+ * Make sure that SGD calls the callback once per pass with increasing
+ * iterations and times, and stops when asked to.
+ */
+BOOST_AUTO_TEST_CASE(SGDCallbackTest)
+{
+  SGDTestFunction f;
+  StandardSGD s(0.0003, 1, 3000, -1.0, false);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  RecordingCallback callback(5);
+  s.Optimize(f, coordinates, callback);
+
+  BOOST_REQUIRE_EQUAL(callback.infos.size(), 5);
+  for (size_t i = 0; i < callback.infos.size(); ++i)
+  {
+    // SGDTestFunction has three functions.
+    BOOST_REQUIRE_EQUAL(callback.infos[i].iteration, 3 * (i + 1));
+    BOOST_REQUIRE_EQUAL(callback.infos[i].stepSize, 0.0003);
+    BOOST_REQUIRE_GE(callback.infos[i].gradientNorm, 0.0);
+    if (i > 0)
+    {
+      BOOST_REQUIRE_GE(callback.infos[i].elapsed,
+          callback.infos[i - 1].elapsed);
+    }
+  }
+}
+
+/**
+ * Make sure that the trace written by CSVTrace has a header and one line per
+ * pass of SGD.
+ */
+BOOST_AUTO_TEST_CASE(CSVTraceTest)
+{
+  SGDTestFunction f;
+  StandardSGD s(0.0003, 1, 300, -1.0, false);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  {
+    CSVTrace trace("callbacks_test_trace.csv");
+    s.Optimize(f, coordinates, trace);
+  }
+
+  std::ifstream stream("callbacks_test_trace.csv");
+  std::string line;
+  std::getline(stream, line);
+  BOOST_REQUIRE_EQUAL(line,
+      "iteration,objective,gradient_norm,step_size,elapsed");
+
+  size_t lines = 0;
+  while (std::getline(stream, line))
+  {
+    ++lines;
+    BOOST_REQUIRE_EQUAL(std::count(line.begin(), line.end(), ','), 4);
+    BOOST_REQUIRE_EQUAL(line.substr(0, line.find(',')),
+        std::to_string(3 * lines));
+  }
+
+  // 300 iterations over three functions give 99 completed passes before the
+  // last one.
+  BOOST_REQUIRE_EQUAL(lines, 99);
+  stream.close();
+  remove("callbacks_test_trace.csv");
+}
+
+/**
+ * A budget of zero seconds should stop L-BFGS before its first step.
+ */
+BOOST_AUTO_TEST_CASE(TimeBudgetLBFGSTest)
+{
+  RosenbrockFunction f;
+  L_BFGS lbfgs;
+
+  arma::mat coordinates = f.GetInitialPoint();
+  TimeBudget budget(0.0);
+  lbfgs.Optimize(f, coordinates, budget);
+
+  BOOST_REQUIRE(budget.Exceeded());
+  BOOST_REQUIRE_SMALL(arma::abs(coordinates - f.GetInitialPoint()).max(),
+      1e-15);
+
+  // With a generous budget, the optimization should finish as usual.
+  coordinates = f.GetInitialPoint();
+  TimeBudget largeBudget(1e6);
+  const double objective = lbfgs.Optimize(f, coordinates, largeBudget);
+
+  BOOST_REQUIRE(!largeBudget.Exceeded());
+  BOOST_REQUIRE_SMALL(objective, 1e-5);
+}
+
+/**
+ * Stop SARAH with the objective on a validation set, and make sure the best
+ * coordinates are kept.
+ */
+BOOST_AUTO_TEST_CASE(ValidationEarlyStopSARAHTest)
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  CreateLogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  LogisticRegressionFunction<> train(shuffledData, shuffledResponses, 0.5);
+  LogisticRegressionFunction<> validation(testData, testResponses, 0.5);
+
+  SARAH s(0.01, 32, 100, 0, -1.0);
+  arma::mat coordinates = train.GetInitialPoint();
+  ValidationEarlyStop<LogisticRegressionFunction<>> earlyStop(validation, 2);
+  s.Optimize(train, coordinates, earlyStop);
+
+  // The validation objective improved, and the best coordinates are at least
+  // as good as the last ones.
+  BOOST_REQUIRE_LT(earlyStop.BestObjective(),
+      validation.Evaluate(train.GetInitialPoint()));
+  BOOST_REQUIRE_CLOSE(validation.Evaluate(earlyStop.BestCoordinates()),
+      earlyStop.BestObjective(), 1e-10);
+  BOOST_REQUIRE_LE(earlyStop.BestObjective(),
+      validation.Evaluate(coordinates));
+}
+
+/**
+ * A function to minimize with GridSearch.
+ */
+class SquareFunction
+{
+ public:
+  double Evaluate(const arma::mat& coordinates)
+  {
+    return coordinates(0) * coordinates(0);
+  }
+};
+
+/**
+ * The objective of the grid 0, 1, ..., 9 only increases after the first point,
+ * so ObjectivePatience should stop GridSearch after patience more points.
+ */
+BOOST_AUTO_TEST_CASE(ObjectivePatienceGridSearchTest)
+{
+  data::DatasetMapper<data::IncrementPolicy, double> datasetInfo(1);
+  for (size_t i = 0; i < 10; ++i)
+    datasetInfo.MapString<size_t>(double(i), 0);
+
+  SquareFunction f;
+  GridSearch gridSearch;
+  arma::mat bestParameters;
+  ObjectivePatience patience(3);
+  RecordingCallback recorder(100);
+  CallbackList<ObjectivePatience, RecordingCallback> callbacks(patience,
+      recorder);
+  const double objective = gridSearch.Optimize(f, bestParameters, datasetInfo,
+      callbacks);
+
+  BOOST_REQUIRE_EQUAL(recorder.infos.size(), 4);
+  BOOST_REQUIRE_SMALL(objective, 1e-15);
+  BOOST_REQUIRE_SMALL(bestParameters(0), 1e-15);
+  BOOST_REQUIRE_SMALL(patience.BestObjective(), 1e-15);
+  for (size_t i = 0; i < recorder.infos.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(recorder.infos[i].iteration, i);
+    BOOST_REQUIRE_CLOSE(recorder.infos[i].objective, double(i * i), 1e-10);
+    BOOST_REQUIRE(std::isnan(recorder.infos[i].gradientNorm));
+  }
+}
+
+/**
+ * Make sure that CMAES and SA report their iterations, and stop when asked.
+ */
+BOOST_AUTO_TEST_CASE(CMAESAndSACallbackTest)
+{
+  SGDTestFunction f;
+  CMAES<> cmaes(0, -1, 1, 3, 1000, -1.0);
+  arma::mat coordinates = f.GetInitialPoint();
+  RecordingCallback cmaesRecorder(10);
+  cmaes.Optimize(f, coordinates, cmaesRecorder);
+
+  BOOST_REQUIRE_EQUAL(cmaesRecorder.infos.size(), 10);
+  for (size_t i = 1; i < cmaesRecorder.infos.size(); ++i)
+  {
+    // CMAES reports the best objective so far.
+    BOOST_REQUIRE_LE(cmaesRecorder.infos[i].objective,
+        cmaesRecorder.infos[i - 1].objective);
+    BOOST_REQUIRE_GT(cmaesRecorder.infos[i].stepSize, 0.0);
+  }
+
+  RosenbrockFunction g;
+  ExponentialSchedule schedule;
+  SA<> sa(schedule, 1000000, 1000., 1000, 100, -1.0);
+  coordinates = g.GetInitialPoint();
+  RecordingCallback saRecorder(5);
+  sa.Optimize(g, coordinates, saRecorder);
+
+  // There is one report per sweep over the two coordinates of the function.
+  BOOST_REQUIRE_EQUAL(saRecorder.infos.size(), 5);
+  for (size_t i = 0; i < saRecorder.infos.size(); ++i)
+    BOOST_REQUIRE_EQUAL(saRecorder.infos[i].iteration % 2, 1);
+}
+
+/**
+ * Make sure that an Adam optimization resumed from its last checkpoint ends
+ * where the uninterrupted optimization ends.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointResumeAdamTest)
+{
+  SGDTestFunction f;
+  Adam adam(0.01, 1, 0.9, 0.999, 1e-8, 150, -1.0, false);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  {
+    Checkpoint<Adam> checkpoint("callbacks_test_checkpoint.bin", adam, 0.0);
+    adam.Optimize(f, coordinates, checkpoint);
+
+    // There is one checkpoint per completed pass over the three functions.
+    BOOST_REQUIRE_EQUAL(checkpoint.Checkpoints(), 49);
+  }
+
+  // Resume with a different optimizer, which should take the saved state.
+  Adam resumed(0.5, 10, 0.5, 0.5, 1e-3, 1000, 1e-5, true);
+  Checkpoint<Adam> checkpoint("callbacks_test_checkpoint.bin", resumed, 0.0);
+  arma::mat resumedCoordinates;
+  BOOST_REQUIRE(checkpoint.Resume(resumedCoordinates));
+
+  BOOST_REQUIRE_EQUAL(checkpoint.ResumedIterations(), 147);
+  BOOST_REQUIRE_EQUAL(resumed.MaxIterations(), 3);
+  BOOST_REQUIRE_EQUAL(resumed.StepSize(), 0.01);
+  BOOST_REQUIRE_EQUAL(resumed.BatchSize(), 1);
+  BOOST_REQUIRE_EQUAL(resumed.Shuffle(), false);
+  BOOST_REQUIRE_EQUAL(resumed.ResetPolicy(), false);
+  BOOST_REQUIRE_EQUAL(resumedCoordinates.n_elem, coordinates.n_elem);
+
+  resumed.Optimize(f, resumedCoordinates);
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(resumedCoordinates[i], coordinates[i], 1e-8);
+
+  // Coordinates of the wrong size are rejected.
+  arma::mat wrongCoordinates(2, 2);
+  BOOST_REQUIRE_THROW(checkpoint.Resume(wrongCoordinates), std::runtime_error);
+
+  remove("callbacks_test_checkpoint.bin");
+  BOOST_REQUIRE(!checkpoint.Resume(resumedCoordinates));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
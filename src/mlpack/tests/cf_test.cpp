@@ -98,6 +98,49 @@ BOOST_AUTO_TEST_CASE(CFGetRecommendationsQueriedUserTest)
   BOOST_REQUIRE_EQUAL(recommendations.n_cols, numUsers);
 }
 
+/**
+ * Make sure that the recommendations found with FastMKS are the same as the
+ * recommendations found by scoring every item, and that they do not contain
+ * items the user already rated.
+ */
+BOOST_AUTO_TEST_CASE(CFFastMKSRecommendationsTest)
+{
+  const size_t numRecs = 10;
+
+  // Load GroupLens data.
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  // Make data into sparse matrix.
+  arma::sp_mat cleanedData;
+  CF::CleanData(dataset, cleanedData);
+
+  CF c(cleanedData);
+
+  arma::Mat<size_t> recommendations, mksRecommendations;
+  c.GetRecommendations(numRecs, recommendations);
+  c.GetRecommendations(numRecs, mksRecommendations, true);
+
+  BOOST_REQUIRE_EQUAL(mksRecommendations.n_rows, numRecs);
+  BOOST_REQUIRE_EQUAL(mksRecommendations.n_cols, recommendations.n_cols);
+
+  // The order of items with (almost) the same estimated rating may differ, so
+  // only require nearly all of the recommendations to be the same.
+  size_t same = 0;
+  for (size_t i = 0; i < recommendations.n_cols; ++i)
+  {
+    for (size_t j = 0; j < numRecs; ++j)
+    {
+      BOOST_REQUIRE_LT(mksRecommendations(j, i), cleanedData.n_rows);
+      BOOST_REQUIRE_EQUAL(cleanedData(mksRecommendations(j, i), i), 0.0);
+      if (arma::any(recommendations.col(i) == mksRecommendations(j, i)))
+        ++same;
+    }
+  }
+
+  BOOST_REQUIRE_GE(same, (size_t) (0.95 * recommendations.n_elem));
+}
+
 /**
  * Make sure recommendations that are generated are reasonably accurate.
  */
@@ -327,6 +370,74 @@ BOOST_AUTO_TEST_CASE(CFBatchPredictTest)
   }
 }
 
+/**
+ * Make sure that folding in new users and items fits their ratings at least as
+ * well as the factors of the existing users and items with the same ratings.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInTest)
+{
+  // Load GroupLens data.
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  // Make data into sparse matrix.
+  arma::sp_mat cleanedData;
+  CF::CleanData(dataset, cleanedData);
+
+  CF c(cleanedData);
+  const size_t numItems = c.CleanedData().n_rows;
+  const size_t numUsers = c.CleanedData().n_cols;
+
+  // Add a copy of user 0, and then a copy of item 0.
+  const arma::sp_mat userRatings = cleanedData.col(0);
+  const arma::vec oldUser = c.H().col(0);
+  const arma::rowvec oldItem = c.W().row(0);
+
+  c.AddUsers(userRatings);
+  BOOST_REQUIRE_EQUAL(c.H().n_cols, numUsers + 1);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, numUsers + 1);
+
+  const arma::sp_mat itemRatings = c.CleanedData().row(0);
+  c.AddItems(itemRatings);
+  BOOST_REQUIRE_EQUAL(c.W().n_rows, numItems + 1);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_rows, numItems + 1);
+
+  // The fold-in is the least squares fit, so it cannot be worse than the
+  // factors found by the factorization.
+  double oldUserError = 0.0, newUserError = 0.0;
+  for (arma::sp_mat::const_iterator it = userRatings.begin();
+      it != userRatings.end(); ++it)
+  {
+    const arma::rowvec item = c.W().row(it.row());
+    oldUserError += std::pow(*it - arma::dot(item, oldUser), 2.0);
+    newUserError += std::pow(*it - arma::dot(item, c.H().col(numUsers)), 2.0);
+  }
+  BOOST_REQUIRE_LE(newUserError, oldUserError * (1 + 1e-5) + 1e-10);
+
+  double oldItemError = 0.0, newItemError = 0.0;
+  for (arma::sp_mat::const_iterator it = itemRatings.begin();
+      it != itemRatings.end(); ++it)
+  {
+    const arma::vec user = c.H().col(it.col());
+    oldItemError += std::pow(*it - arma::dot(oldItem, user), 2.0);
+    newItemError += std::pow(*it - arma::dot(c.W().row(numItems), user), 2.0);
+  }
+  BOOST_REQUIRE_LE(newItemError, oldItemError * (1 + 1e-5) + 1e-10);
+
+  // The new user can be queried right away.
+  arma::Mat<size_t> recommendations;
+  arma::Col<size_t> users(1);
+  users[0] = numUsers;
+  c.GetRecommendations(5, recommendations, users);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, 1);
+
+  // Ratings of the wrong size are rejected.
+  BOOST_REQUIRE_THROW(c.AddUsers(arma::sp_mat(numItems, 1)),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(c.AddItems(arma::sp_mat(1, numUsers)),
+      std::invalid_argument);
+}
+
 /**
  * Make sure we can train an already-trained model and it works okay.
  */
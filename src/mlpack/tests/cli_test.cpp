@@ -27,6 +27,7 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -1125,4 +1126,108 @@ BOOST_AUTO_TEST_CASE(CppNameTest)
   BOOST_REQUIRE_EQUAL(CLI::Parameters().at("double").cppType, "double");
 }
 
+/**
+ * Make sure that --threads sets the number of threads of mlpack.
+ */
+BOOST_AUTO_TEST_CASE(ThreadsOptionTest)
+{
+  AddRequiredCLIOptions();
+
+  PARAM_INT_IN("threads", "Number of threads.", "j", 0);
+
+  const char* argv[3];
+  argv[0] = "./test";
+  argv[1] = "--threads";
+  argv[2] = "1";
+
+  int argc = 3;
+
+  ParseCommandLine(argc, const_cast<char**>(argv));
+  BOOST_REQUIRE_EQUAL(Threads::Get(), 1);
+
+  // A negative number of threads is an error.
+  CLI::ClearSettings();
+  AddRequiredCLIOptions();
+  PARAM_INT_IN("threads", "Number of threads.", "j", 0);
+  argv[2] = "-1";
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(ParseCommandLine(argc, const_cast<char**>(argv)),
+      runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  // Restore the default.
+  Threads::Set(0);
+}
+
+/**
+ * The program run by ServeTest: it returns the bandwidth of the given kernel,
+ * and removes the kernel file, so that a later request can only succeed if the
+ * kernel was kept.
+ */
+static void ServeTestMain()
+{
+  CLI::GetParam<double>("bandwidth") =
+      CLI::GetParam<GaussianKernel*>("kernel")->Bandwidth();
+  remove("kernel.bin");
+}
+
+/**
+ * Make sure that a server answers each request, and loads each model once.
+ */
+BOOST_AUTO_TEST_CASE(ServeTest)
+{
+  AddRequiredCLIOptions();
+
+  GaussianKernel gk(0.5);
+  data::Save("kernel.bin", "model", gk);
+
+  CLIOption<bool> serve(false, "serve", "Run as a server.", "", "bool");
+  PARAM_MODEL_IN_REQ(GaussianKernel, "kernel", "Test kernel", "k");
+  PARAM_DOUBLE_OUT("bandwidth", "Bandwidth of the kernel.");
+
+  // The required kernel does not have to be given to the server.
+  const char* argv[2];
+  argv[0] = "./test";
+  argv[1] = "--serve";
+
+  int argc = 2;
+
+  ParseCommandLine(argc, const_cast<char**>(argv));
+
+  std::istringstream input("--kernel_file kernel.bin\n"
+                           "\n"
+                           "-k 'kernel.bin'\n"
+                           "--kernel_file other.bin\n"
+                           "--help\n"
+                           "quit\n"
+                           "--kernel_file kernel.bin\n");
+  std::ostringstream output;
+  Serve(&ServeTestMain, input, output);
+
+  // Read the responses.
+  std::istringstream responses(output.str());
+  std::vector<std::string> status, contents;
+  std::string s;
+  size_t size;
+  while (responses >> s >> size)
+  {
+    responses.get(); // The newline.
+    std::string content(size, ' ');
+    responses.read(&content[0], size);
+    status.push_back(s);
+    contents.push_back(content);
+  }
+
+  BOOST_REQUIRE_EQUAL(status.size(), 4);
+  BOOST_REQUIRE_EQUAL(status[0], "OK");
+  BOOST_REQUIRE_EQUAL(contents[0], "bandwidth: 0.5\n");
+  BOOST_REQUIRE_EQUAL(status[1], "OK");
+  BOOST_REQUIRE_EQUAL(contents[1], "bandwidth: 0.5\n");
+  BOOST_REQUIRE_EQUAL(status[2], "ERROR");
+  BOOST_REQUIRE_EQUAL(status[3], "ERROR");
+
+  remove("kernel.bin");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -144,4 +144,28 @@ BOOST_AUTO_TEST_CASE(ApproxCMAESLogisticRegressionTest)
   BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
 }
 
+/**
+ * Run CMA-ES with the random selection policy on logistic regression while
+ * evaluating the candidates in parallel, and make sure the results are
+ * acceptable.
+ */
+BOOST_AUTO_TEST_CASE(ParallelApproxCMAESLogisticRegressionTest)
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  CreateLogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  ApproxCMAES<> cmaes(0, -1, 1, 32, 200, 1e-3, RandomSelection(), true);
+  LogisticRegression<> lr(shuffledData, shuffledResponses, cmaes, 0.5);
+
+  // Ensure that the error is close to zero.
+  const double acc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 0.3); // 0.3% error tolerance.
+
+  const double testAcc = lr.ComputeAccuracy(testData, testResponses);
+  BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -16,6 +16,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -149,6 +150,52 @@ BOOST_AUTO_TEST_CASE(ValidConvolution2DTest)
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution using the im2col transformation.
+  Convolution2DMethodTest<ImToColConvolution<ValidConvolution> >(input, filter,
+      output);
+}
+
+/**
+ * Make sure that the strided convolution (valid) methods agree on the output
+ * size and the result: a convolution with strides dW and dH is the unit stride
+ * convolution restricted to every dW-th row and dH-th column.
+ */
+BOOST_AUTO_TEST_CASE(StridedValidConvolution2DTest)
+{
+  const arma::mat input = arma::randu(8, 7);
+  const arma::mat filter = arma::randu(3, 3);
+
+  arma::mat unitOutput;
+  NaiveConvolution<ValidConvolution>::Convolution(input, filter, unitOutput);
+
+  const size_t strides[][2] = { { 2, 2 }, { 2, 1 }, { 1, 3 }, { 3, 2 } };
+  for (const size_t* stride : strides)
+  {
+    const size_t dW = stride[0];
+    const size_t dH = stride[1];
+
+    // The output size of the Convolution layer.
+    arma::mat output((input.n_rows - filter.n_rows) / dW + 1,
+        (input.n_cols - filter.n_cols) / dH + 1);
+    for (size_t j = 0; j < output.n_cols; ++j)
+      for (size_t i = 0; i < output.n_rows; ++i)
+        output(i, j) = unitOutput(i * dW, j * dH);
+
+    arma::mat naiveOutput, imToColOutput;
+    NaiveConvolution<ValidConvolution>::Convolution(input, filter,
+        naiveOutput, dW, dH);
+    ImToColConvolution<ValidConvolution>::Convolution(input, filter,
+        imToColOutput, dW, dH);
+
+    BOOST_REQUIRE_EQUAL(naiveOutput.n_rows, output.n_rows);
+    BOOST_REQUIRE_EQUAL(naiveOutput.n_cols, output.n_cols);
+    BOOST_REQUIRE_EQUAL(imToColOutput.n_rows, output.n_rows);
+    BOOST_REQUIRE_EQUAL(imToColOutput.n_cols, output.n_cols);
+
+    CheckMatrices(naiveOutput, output, 1e-3);
+    CheckMatrices(imToColOutput, output, 1e-3);
+  }
 }
 
 /**
@@ -186,6 +233,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution2DTest)
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution using the im2col transformation.
+  Convolution2DMethodTest<ImToColConvolution<FullConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -231,6 +282,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution3DTest)
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution using the im2col transformation.
+  Convolution3DMethodTest<ImToColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -280,6 +335,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution3DTest)
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution using the im2col transformation.
+  Convolution3DMethodTest<ImToColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -322,6 +381,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolutionBatchTest)
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution using the im2col transformation.
+  ConvolutionMethodBatchTest<ImToColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
 }
 
 /**
@@ -368,6 +431,10 @@ BOOST_AUTO_TEST_CASE(FullConvolutionBatchTest)
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<FullConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution using the im2col transformation.
+  ConvolutionMethodBatchTest<ImToColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
 }
 
 BOOST_AUTO_TEST_SUITE_END();
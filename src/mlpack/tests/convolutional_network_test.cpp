@@ -118,4 +118,32 @@ BOOST_AUTO_TEST_CASE(VanillaNetworkTest)
   BOOST_REQUIRE_LE(classificationError, 0.25);
 }
 
+/**
+ * Make sure that a convolutional network gives the same predictions when the
+ * points are passed through the network in batches.
+ */
+BOOST_AUTO_TEST_CASE(BatchedPredictTest)
+{
+  arma::mat X = arma::randu<arma::mat>(28 * 28, 21);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+
+  model.Add<Convolution<> >(1, 8, 5, 5, 1, 1, 0, 0, 28, 28);
+  model.Add<ReLULayer<> >();
+  model.Add<MaxPooling<> >(8, 8, 2, 2);
+  model.Add<Convolution<> >(8, 12, 2, 2);
+  model.Add<ReLULayer<> >();
+  model.Add<MeanPooling<> >(2, 2, 2, 2);
+  model.Add<Linear<> >(192, 10);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(10, 2);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat predictions, batchPredictions;
+  model.Predict(X, predictions);
+  model.Predict(X, batchPredictions, 8);
+
+  CheckMatrices(predictions, batchPredictions);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -222,4 +222,70 @@ BOOST_AUTO_TEST_CASE(CosineTreeModifiedGramSchmidt)
   }
 }
 
+/**
+ * Checks that CosineTree::GramSchmidt() with the basis as a matrix gives the
+ * same vectors as CosineTree::ModifiedGramSchmidt() with the basis in a queue.
+ */
+BOOST_AUTO_TEST_CASE(CosineTreeMatrixGramSchmidt)
+{
+  const size_t numRows = 60;
+  const size_t numCols = 30;
+
+  arma::mat data = arma::randu(numRows, numCols);
+
+  CosineNodeQueue basisQueue;
+  CosineTree dummyTree(data, 1, 0.1);
+  std::vector<CosineTree*> nodes;
+  arma::mat basis(numRows, 0);
+
+  for (size_t i = 0; i < numCols; i++)
+  {
+    arma::vec centroid = data.col(i);
+    arma::vec queueVector, matrixVector;
+    dummyTree.ModifiedGramSchmidt(basisQueue, centroid, queueVector);
+    dummyTree.GramSchmidt(basis, centroid, matrixVector);
+    CheckMatrices(queueVector, matrixVector, 1e-5);
+
+    // With an additional vector too.
+    if (i > 0)
+    {
+      arma::vec additional = basis.col(0);
+      dummyTree.ModifiedGramSchmidt(basisQueue, centroid, queueVector,
+          &additional);
+      dummyTree.GramSchmidt(basis, centroid, matrixVector, &additional);
+      CheckMatrices(queueVector, matrixVector, 1e-5);
+    }
+
+    dummyTree.GramSchmidt(basis, centroid, matrixVector);
+    CosineTree* basisNode = new CosineTree(data);
+    basisNode->BasisVector(matrixVector);
+    basisNode->L2Error(arma::randu());
+    basisQueue.push(basisNode);
+    nodes.push_back(basisNode);
+    basis.insert_cols(basis.n_cols, matrixVector);
+  }
+
+  for (size_t i = 0; i < nodes.size(); i++)
+    delete nodes[i];
+}
+
+/**
+ * Make sure that the basis of a tree built to a small error captures a
+ * low-rank dataset.
+ */
+BOOST_AUTO_TEST_CASE(CosineTreeLowRankBasis)
+{
+  // A rank-5 dataset.
+  arma::mat data = arma::randu(40, 5) * arma::randu(5, 300);
+
+  CosineTree ctree(data, 0.001, 0.1);
+  arma::mat basis;
+  ctree.GetFinalBasis(basis);
+
+  // The dataset is close to its projection onto the span of the basis.
+  const double error = arma::accu(arma::square(data - basis *
+      arma::solve(basis, data)));
+  BOOST_REQUIRE_LT(error, 0.01 * arma::accu(arma::square(data)));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -13,8 +13,10 @@
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/cv/metrics/accuracy.hpp>
+#include <mlpack/core/cv/metrics/confusion_matrix.hpp>
 #include <mlpack/core/cv/metrics/f1.hpp>
 #include <mlpack/core/cv/metrics/mse.hpp>
+#include <mlpack/core/cv/metrics/multi_metric.hpp>
 #include <mlpack/core/cv/metrics/precision.hpp>
 #include <mlpack/core/cv/metrics/recall.hpp>
 #include <mlpack/core/cv/simple_cv.hpp>
@@ -122,6 +124,74 @@ BOOST_AUTO_TEST_CASE(MulticlassClassificationMetricsTest)
       macroaveragedF1, 1e-5);
 }
 
+/**
+ * A classifier that returns fixed predictions and counts how many times it has
+ * been asked to classify.
+ */
+class CountingClassifier
+{
+ public:
+  CountingClassifier(const arma::Row<size_t>& predictions) :
+      predictions(predictions), calls(0) { }
+
+  void Classify(const arma::mat& /* data */, arma::Row<size_t>& labels)
+  {
+    ++calls;
+    labels = predictions;
+  }
+
+  arma::Row<size_t> predictions;
+  size_t calls;
+};
+
+/**
+ * Make sure that the metrics calculated from a confusion matrix are the same as
+ * the metrics calculated from the model, and that MultiMetric classifies only
+ * once.
+ */
+BOOST_AUTO_TEST_CASE(ConfusionMatrixTest)
+{
+  arma::mat data = arma::linspace<arma::rowvec>(1.0, 12.0, 12);
+  arma::Row<size_t> labels("0 1  0 1  2 2 1 2  3 3 3 3");
+  arma::Row<size_t> predictedLabels("0 0  1 1  2 2 2 2  3 3 3 3");
+
+  ConfusionMatrix confusion(labels, predictedLabels);
+  BOOST_REQUIRE_EQUAL(confusion.Classes(), 4);
+  BOOST_REQUIRE_EQUAL(confusion.Points(), 12);
+  BOOST_REQUIRE_EQUAL(confusion.Correct(), 9);
+  BOOST_REQUIRE_EQUAL(confusion.Counts()(1, 2), 1);
+  BOOST_REQUIRE_EQUAL(confusion.TruePositives(1), 1);
+  BOOST_REQUIRE_EQUAL(confusion.Predictions(2), 4);
+  BOOST_REQUIRE_EQUAL(confusion.Instances(1), 3);
+  BOOST_REQUIRE_EQUAL(confusion.Instances(7), 0);
+
+  CountingClassifier model(predictedLabels);
+  BOOST_REQUIRE_CLOSE(Accuracy::Evaluate(confusion),
+      Accuracy::Evaluate(model, data, labels), 1e-10);
+  BOOST_REQUIRE_CLOSE(Precision<Macro>::Evaluate(confusion),
+      (0.5 + 0.5 + 0.75 + 1.0) / 4, 1e-5);
+  BOOST_REQUIRE_CLOSE(Recall<Macro>::Evaluate(confusion),
+      (0.5 + 1.0 / 3 + 1.0 + 1.0) / 4, 1e-5);
+  BOOST_REQUIRE_CLOSE(F1<Macro>::Evaluate(confusion),
+      F1<Macro>::Evaluate(model, data, labels), 1e-10);
+  BOOST_REQUIRE_CLOSE(Precision<Binary, 2>::Evaluate(confusion), 0.75, 1e-5);
+  BOOST_REQUIRE_CLOSE(Recall<Binary, 2>::Evaluate(confusion), 1.0, 1e-5);
+
+  model.calls = 0;
+  arma::vec values = MultiMetric<Accuracy, Precision<Macro>, Recall<Macro>,
+      F1<Macro>, F1<Micro>>::Evaluate(model, data, labels);
+  BOOST_REQUIRE_EQUAL(model.calls, 1);
+  BOOST_REQUIRE_EQUAL(values.n_elem, 5);
+  BOOST_REQUIRE_CLOSE(values[0], 0.75, 1e-5);
+  BOOST_REQUIRE_CLOSE(values[1], Precision<Macro>::Evaluate(confusion), 1e-10);
+  BOOST_REQUIRE_CLOSE(values[2], Recall<Macro>::Evaluate(confusion), 1e-10);
+  BOOST_REQUIRE_CLOSE(values[3], F1<Macro>::Evaluate(confusion), 1e-10);
+  BOOST_REQUIRE_CLOSE(values[4], 0.75, 1e-5);
+
+  BOOST_REQUIRE(UsesConfusionMatrix<F1<Binary>>::value);
+  BOOST_REQUIRE(!UsesConfusionMatrix<MSE>::value);
+}
+
 /**
  * Test the mean squared error.
  */
@@ -415,6 +485,43 @@ BOOST_AUTO_TEST_CASE(KFoldCVMSETest)
   cv.Model();
 }
 
+/**
+ * Make sure that k-fold cross-validation with several metrics gives the same
+ * values as with each metric on its own.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVEvaluateMetricsTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  data::DatasetInfo datasetInfo;
+  MockCategoricalData(data, labels, datasetInfo);
+  const size_t numClasses = 3;
+
+  KFoldCV<NaiveBayesClassifier<>, Accuracy> cv(5, data, labels, numClasses);
+  arma::vec values = cv.EvaluateMetrics<Accuracy, Precision<Macro>,
+      Recall<Macro>, F1<Macro>>();
+  BOOST_REQUIRE_EQUAL(values.n_elem, 4);
+
+  KFoldCV<NaiveBayesClassifier<>, Precision<Macro>> precisionCV(5, data,
+      labels, numClasses);
+  KFoldCV<NaiveBayesClassifier<>, Recall<Macro>> recallCV(5, data, labels,
+      numClasses);
+  KFoldCV<NaiveBayesClassifier<>, F1<Macro>> f1CV(5, data, labels,
+      numClasses);
+  BOOST_REQUIRE_CLOSE(values[0], cv.Evaluate(), 1e-8);
+  BOOST_REQUIRE_CLOSE(values[1], precisionCV.Evaluate(), 1e-8);
+  BOOST_REQUIRE_CLOSE(values[2], recallCV.Evaluate(), 1e-8);
+  BOOST_REQUIRE_CLOSE(values[3], f1CV.Evaluate(), 1e-8);
+
+  // Regression metrics are evaluated on their own.
+  arma::mat regressionData("0 1 2 3 4");
+  arma::rowvec responses("-1 0 1 3 5");
+  SimpleCV<LinearRegression, MSE> simpleCV(0.6, regressionData, responses);
+  arma::vec mse = simpleCV.EvaluateMetrics<MSE>();
+  BOOST_REQUIRE_EQUAL(mse.n_elem, 1);
+  BOOST_REQUIRE_CLOSE(mse[0], (0 * 0 + 1 * 1 + 2 * 2) / 3.0, 1e-5);
+}
+
 /**
  * Test k-fold cross-validation with the Accuracy metric.
  */
@@ -440,6 +547,138 @@ BOOST_AUTO_TEST_CASE(KFoldCVAccuracyTest)
   cv.Model();
 }
 
+/**
+ * Test k-fold cross-validation gives the same result when the folds are trained
+ * in parallel.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVParallelTest)
+{
+  arma::mat data("0 1 2 3 100 101 102 103 104 5");
+  arma::Row<size_t> labels("0 0 0 0 1 1 1 1 1 1");
+  size_t numClasses = 2;
+
+  KFoldCV<NaiveBayesClassifier<>, Accuracy> cv(10, data, labels, numClasses);
+  cv.Parallel() = true;
+
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), 0.9, 1e-5);
+  cv.Model();
+}
+
+/**
+ * Test k-fold cross-validation runs only the first Folds() folds.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVFoldsTest)
+{
+  arma::mat data("0 1 2 3 100 101 102 103 104 5");
+  arma::Row<size_t> labels("0 0 0 0 1 1 1 1 1 1");
+
+  KFoldCV<NaiveBayesClassifier<>, Accuracy> cv(10, data, labels, 2);
+  BOOST_REQUIRE_EQUAL(cv.K(), 10);
+  BOOST_REQUIRE_EQUAL(cv.Folds(), 10);
+
+  // Only the last point is misclassified, and the first fold validates on it
+  // (the following ones validate on the first points).
+  cv.Folds() = 5;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), 0.8, 1e-5);
+  cv.Folds() = 10;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), 0.9, 1e-5);
+
+  cv.Folds() = 0;
+  BOOST_REQUIRE_THROW(cv.Evaluate(), std::invalid_argument);
+  cv.Folds() = 11;
+  BOOST_REQUIRE_THROW(cv.Evaluate(), std::invalid_argument);
+}
+
+/**
+ * Test k-fold cross-validation with models warm-started from the previous
+ * fold.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVWarmStartTest)
+{
+  // A linear regression model is retrained from scratch, so warm starting
+  // shouldn't change anything.
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+  arma::rowvec responses = arma::rowvec("1 2 3") * data +
+      0.1 * arma::randn<arma::rowvec>(100);
+
+  KFoldCV<LinearRegression, MSE> cv(5, data, responses);
+  KFoldCV<LinearRegression, MSE> warmCV(5, data, responses);
+  warmCV.WarmStart() = true;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), warmCV.Evaluate(), 1e-5);
+
+  // Logistic regression starts from the previous model, and should keep its
+  // lambda and find the same optimum as when it starts from scratch.
+  arma::mat lrData = arma::join_cols(arma::randn<arma::rowvec>(100),
+      arma::randn<arma::rowvec>(100));
+  arma::Row<size_t> lrLabels(100);
+  for (size_t i = 0; i < 100; ++i)
+    lrLabels[i] = (lrData(0, i) + lrData(1, i) > 0.0) ? 1 : 0;
+
+  const double lambda = 0.5;
+  KFoldCV<LogisticRegression<>, Accuracy> lrCV(4, lrData, lrLabels);
+  KFoldCV<LogisticRegression<>, Accuracy> warmLRCV(4, lrData, lrLabels);
+  warmLRCV.WarmStart() = true;
+  BOOST_REQUIRE_SMALL(lrCV.Evaluate(lambda) - warmLRCV.Evaluate(lambda),
+      0.05);
+
+  BOOST_REQUIRE_CLOSE(warmLRCV.Model().Lambda(), lambda, 1e-5);
+  for (size_t i = 0; i < lrCV.Model().Parameters().n_elem; ++i)
+  {
+    BOOST_REQUIRE_SMALL(lrCV.Model().Parameters()[i] -
+        warmLRCV.Model().Parameters()[i], 1e-3);
+  }
+}
+
+/**
+ * Test k-fold and simple cross-validation continuing from the models of the
+ * previous hyper-parameters along a regularization path.
+ */
+BOOST_AUTO_TEST_CASE(CVContinuationTest)
+{
+  arma::mat data = arma::join_cols(arma::randn<arma::rowvec>(200),
+      arma::randn<arma::rowvec>(200));
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = (data(0, i) - 0.5 * data(1, i) > 0.0) ? 1 : 0;
+
+  KFoldCV<LogisticRegression<>, Accuracy> cv(4, data, labels);
+  KFoldCV<LogisticRegression<>, Accuracy> continuedCV(4, data, labels);
+  continuedCV.Continuation() = true;
+  SimpleCV<LogisticRegression<>, Accuracy> simpleCV(0.25, data, labels);
+  SimpleCV<LogisticRegression<>, Accuracy> continuedSimpleCV(0.25, data,
+      labels);
+  continuedSimpleCV.Continuation() = true;
+
+  // Each model has the current lambda and reaches the same optimum as the
+  // model trained from scratch.
+  for (const double lambda : { 1.0, 0.5, 0.25, 0.1 })
+  {
+    BOOST_REQUIRE_SMALL(cv.Evaluate(lambda) - continuedCV.Evaluate(lambda),
+        0.02);
+    BOOST_REQUIRE_CLOSE(continuedCV.Model().Lambda(), lambda, 1e-5);
+    for (size_t i = 0; i < cv.Model().Parameters().n_elem; ++i)
+    {
+      BOOST_REQUIRE_SMALL(cv.Model().Parameters()[i] -
+          continuedCV.Model().Parameters()[i], 1e-3);
+    }
+
+    BOOST_REQUIRE_SMALL(simpleCV.Evaluate(lambda) -
+        continuedSimpleCV.Evaluate(lambda), 0.02);
+    BOOST_REQUIRE_CLOSE(continuedSimpleCV.Model().Lambda(), lambda, 1e-5);
+  }
+
+  // A copy continues from the same models.
+  KFoldCV<LogisticRegression<>, Accuracy> copiedCV(continuedCV);
+  BOOST_REQUIRE_SMALL(copiedCV.Evaluate(0.05) - cv.Evaluate(0.05), 0.02);
+
+  // Models without WarmStartTraits are trained from scratch.
+  KFoldCV<NaiveBayesClassifier<>, Accuracy> nbCV(4, data, labels, 2);
+  KFoldCV<NaiveBayesClassifier<>, Accuracy> continuedNBCV(4, data, labels, 2);
+  continuedNBCV.Continuation() = true;
+  BOOST_REQUIRE_CLOSE(nbCV.Evaluate(), continuedNBCV.Evaluate(), 1e-5);
+  BOOST_REQUIRE_CLOSE(nbCV.Evaluate(), continuedNBCV.Evaluate(), 1e-5);
+}
+
 /**
  * Test k-fold cross-validation with weighted linear regression.
  */
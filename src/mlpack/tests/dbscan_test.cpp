@@ -17,6 +17,7 @@
 
 using namespace mlpack;
 using namespace mlpack::dbscan;
+using namespace mlpack::range;
 using namespace mlpack::distribution;
 
 BOOST_AUTO_TEST_SUITE(DBSCANTest);
@@ -271,4 +272,33 @@ BOOST_AUTO_TEST_CASE(GaussiansSingleModeTest)
   }
 }
 
+/**
+ * Make sure that searching the points in blocks, in parallel, gives the same
+ * clustering as searching all of them at once.
+ */
+BOOST_AUTO_TEST_CASE(BlockSearchTest)
+{
+  arma::mat points(3, 1000, arma::fill::randu);
+
+  DBSCAN<> d(0.1, 3);
+  arma::Row<size_t> assignments;
+  const size_t clusters = d.Cluster(points, assignments);
+
+  const size_t blockSizes[] = { 1, 37, 256, 999, 1000 };
+  for (const size_t blockSize : blockSizes)
+  {
+    DBSCAN<> blockD(0.1, 3, true, RangeSearch<>(), RandomPointSelection(),
+        blockSize);
+    BOOST_REQUIRE_EQUAL(blockD.BlockSize(), blockSize);
+
+    arma::Row<size_t> blockAssignments;
+    const size_t blockClusters = blockD.Cluster(points, blockAssignments);
+
+    BOOST_REQUIRE_EQUAL(blockClusters, clusters);
+    BOOST_REQUIRE_EQUAL(blockAssignments.n_elem, assignments.n_elem);
+    for (size_t i = 0; i < assignments.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(blockAssignments[i], assignments[i]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -391,4 +391,48 @@ BOOST_AUTO_TEST_CASE(IntTest)
   BOOST_CHECK_EQUAL(predictedLabels(0, 7), 2);
 }
 
+/**
+ * Make sure that stumps trained from a presorted stump are the same as the
+ * stumps that sort the data, for different weights.
+ */
+BOOST_AUTO_TEST_CASE(PresortTest)
+{
+  arma::mat trainingData = arma::randu<arma::mat>(5, 300);
+  // Make some values identical, to check that the sort stays stable.
+  trainingData.row(2) = arma::floor(trainingData.row(2) * 10);
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (trainingData(2, i) + 3 * trainingData(4, i) > 6.0) ? 1 :
+        ((trainingData(0, i) > 0.7) ? 2 : 0);
+
+  DecisionStump<> ds(trainingData, labels, 3, 5);
+  DecisionStump<> presorted(ds);
+  presorted.Presort(trainingData);
+  BOOST_REQUIRE(presorted.Presorted(trainingData));
+  BOOST_REQUIRE(!ds.Presorted(trainingData));
+
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::rowvec weights = arma::randu<arma::rowvec>(300);
+    weights /= arma::accu(weights);
+
+    DecisionStump<> sorting(ds, trainingData, labels, 3, weights);
+    DecisionStump<> reusing(presorted, trainingData, labels, 3, weights);
+
+    // The order is not copied into the new stump.
+    BOOST_REQUIRE(!reusing.Presorted(trainingData));
+
+    BOOST_REQUIRE_EQUAL(sorting.SplitDimension(), reusing.SplitDimension());
+    BOOST_REQUIRE_EQUAL(sorting.Split().n_elem, reusing.Split().n_elem);
+    for (size_t i = 0; i < sorting.Split().n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(sorting.Split()[i], reusing.Split()[i]);
+      BOOST_REQUIRE_EQUAL(sorting.BinLabels()[i], reusing.BinLabels()[i]);
+    }
+  }
+
+  presorted.ClearPresort();
+  BOOST_REQUIRE(!presorted.Presorted(trainingData));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
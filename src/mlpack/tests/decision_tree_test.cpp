@@ -13,6 +13,8 @@
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/information_gain.hpp>
 #include <mlpack/methods/decision_tree/gini_gain.hpp>
+#include <mlpack/methods/decision_tree/histogram_numeric_split.hpp>
+#include <mlpack/methods/decision_tree/flat_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
 
@@ -367,6 +369,145 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Check that the HistogramNumericSplit will split on an obviously splittable
+ * dimension, and won't split if not enough points are given.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitSimpleSplitTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem, arma::fill::ones);
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(gain, weightedGain);
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_GT(classProbabilities[0], 0.4);
+  BOOST_REQUIRE_LT(classProbabilities[0], 0.5);
+
+  arma::vec noClassProbabilities;
+  const double noGain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 8, 1e-7, noClassProbabilities,
+      aux);
+  BOOST_REQUIRE_EQUAL(noGain, bestGain);
+  BOOST_REQUIRE_EQUAL(noClassProbabilities.n_elem, 0);
+}
+
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when there are fewer distinct values than bins.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitMatchesBestBinaryTest)
+{
+  for (size_t trial = 0; trial < 10; ++trial)
+  {
+    arma::vec values(1000);
+    arma::Row<size_t> labels(1000);
+    arma::rowvec weights(1000, arma::fill::randu);
+    for (size_t i = 0; i < values.n_elem; ++i)
+    {
+      values[i] = math::RandInt(100);
+      labels[i] = (values[i] + math::RandInt(30) < 60) ? 0 :
+          math::RandInt(1, 3);
+    }
+
+    arma::vec bestProbabilities, histogramProbabilities;
+    BestBinaryNumericSplit<InformationGain>::template
+        AuxiliarySplitInfo<double> bestAux;
+    HistogramNumericSplit<InformationGain>::template
+        AuxiliarySplitInfo<double> histogramAux;
+
+    const double bestGain = InformationGain::Evaluate<false>(labels, 3,
+        weights);
+    const double expectedGain =
+        BestBinaryNumericSplit<InformationGain>::SplitIfBetter<false>(bestGain,
+        values, labels, 3, weights, 5, 1e-7, bestProbabilities, bestAux);
+    const double gain =
+        HistogramNumericSplit<InformationGain>::SplitIfBetter<false>(bestGain,
+        values, labels, 3, weights, 5, 1e-7, histogramProbabilities,
+        histogramAux);
+
+    BOOST_REQUIRE_CLOSE(gain, expectedGain, 1e-5);
+    BOOST_REQUIRE_EQUAL(histogramProbabilities.n_elem, 1);
+    BOOST_REQUIRE_CLOSE(histogramProbabilities[0], bestProbabilities[0], 1e-5);
+
+    const double weightedBestGain = InformationGain::Evaluate<true>(labels, 3,
+        weights);
+    const double expectedWeightedGain =
+        BestBinaryNumericSplit<InformationGain>::SplitIfBetter<true>(
+        weightedBestGain, values, labels, 3, weights, 5, 1e-7,
+        bestProbabilities, bestAux);
+    const double weightedGain =
+        HistogramNumericSplit<InformationGain>::SplitIfBetter<true>(
+        weightedBestGain, values, labels, 3, weights, 5, 1e-7,
+        histogramProbabilities, histogramAux);
+
+    BOOST_REQUIRE_CLOSE(weightedGain, expectedWeightedGain, 1e-5);
+    BOOST_REQUIRE_CLOSE(histogramProbabilities[0], bestProbabilities[0], 1e-5);
+  }
+}
+
+/**
+ * Check that BestBinaryNumericSplit finds the same split with presorted
+ * indices as without them.
+ */
+BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitSortedMatchesTest)
+{
+  for (size_t trial = 0; trial < 10; ++trial)
+  {
+    arma::rowvec values(1000);
+    arma::Row<size_t> labels(1000);
+    arma::rowvec weights(1000, arma::fill::randu);
+    for (size_t i = 0; i < values.n_elem; ++i)
+    {
+      values[i] = math::RandInt(200);
+      labels[i] = (values[i] + math::RandInt(50) < 120) ? 0 :
+          math::RandInt(1, 3);
+    }
+    const arma::uvec sortedIndices = arma::stable_sort_index(values);
+
+    arma::vec probabilities, sortedProbabilities;
+    BestBinaryNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+    const double bestGain = GiniGain::Evaluate<false>(labels, 3, weights);
+    const double expectedGain =
+        BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+        values, labels, 3, weights, 5, 1e-7, probabilities, aux);
+    const double gain =
+        BestBinaryNumericSplit<GiniGain>::SplitIfBetterSorted<false>(bestGain,
+        values, sortedIndices, labels, 3, weights, 5, 1e-7,
+        sortedProbabilities, aux);
+
+    BOOST_REQUIRE_CLOSE(gain, expectedGain, 1e-5);
+    BOOST_REQUIRE_EQUAL(sortedProbabilities.n_elem, 1);
+    BOOST_REQUIRE_EQUAL(sortedProbabilities[0], probabilities[0]);
+
+    const double weightedBestGain = GiniGain::Evaluate<true>(labels, 3,
+        weights);
+    const double expectedWeightedGain =
+        BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(weightedBestGain,
+        values, labels, 3, weights, 5, 1e-7, probabilities, aux);
+    const double weightedGain =
+        BestBinaryNumericSplit<GiniGain>::SplitIfBetterSorted<true>(
+        weightedBestGain, values, sortedIndices, labels, 3, weights, 5, 1e-7,
+        sortedProbabilities, aux);
+
+    BOOST_REQUIRE_CLOSE(weightedGain, expectedWeightedGain, 1e-5);
+    BOOST_REQUIRE_EQUAL(sortedProbabilities[0], probabilities[0]);
+  }
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -664,6 +805,193 @@ BOOST_AUTO_TEST_CASE(SimpleGeneralizationTest)
   BOOST_REQUIRE_GT(wdcorrect, 0.75);
 }
 
+/**
+ * Test that a decision tree with histogram-based numeric splits generalizes
+ * reasonably.
+ */
+BOOST_AUTO_TEST_CASE(HistogramSplitGeneralizationTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::rowvec weights(labels.n_cols, arma::fill::ones);
+
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+  DecisionTree<GiniGain, HistogramNumericSplit> wd(inputData, labels, 3,
+      weights, 10);
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Row<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+  const double correct = double(arma::accu(predictions == trueTestLabels)) /
+      predictions.n_elem;
+  BOOST_REQUIRE_GT(correct, 0.75);
+
+  wd.Classify(testData, predictions);
+  const double wdcorrect = double(arma::accu(predictions == trueTestLabels)) /
+      predictions.n_elem;
+  BOOST_REQUIRE_GT(wdcorrect, 0.75);
+}
+
+/**
+ * Test that a decision tree trained with presorted indices makes the same
+ * predictions as one trained without them, and that split types without
+ * presorting support are rejected.
+ */
+BOOST_AUTO_TEST_CASE(PresortedTrainingTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::rowvec weights(labels.n_cols, arma::fill::ones);
+
+  DecisionTree<> d, pd, wd, pwd;
+  d.Train(inputData, labels, 3, 5);
+  pd.Train(inputData, labels, 3, 5, 1e-7, true);
+  wd.Train(inputData, labels, 3, weights, 5);
+  pwd.Train(inputData, labels, 3, weights, 5, 1e-7, true);
+
+  arma::Row<size_t> predictions, presortedPredictions;
+  d.Classify(testData, predictions);
+  pd.Classify(testData, presortedPredictions);
+  CheckMatrices(predictions, presortedPredictions);
+
+  wd.Classify(testData, predictions);
+  pwd.Classify(testData, presortedPredictions);
+  CheckMatrices(predictions, presortedPredictions);
+
+  DecisionTree<GiniGain, HistogramNumericSplit> hd;
+  BOOST_REQUIRE_THROW(hd.Train(inputData, labels, 3, 5, 1e-7, true),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that a decision tree built with several threads is the same as one
+ * built with a single thread, for numeric, categorical and presorted training.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainingTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+  #endif
+
+  arma::mat numericData;
+  if (!data::Load("vc2.csv", numericData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> numericLabels;
+  if (!data::Load("vc2_labels.txt", numericLabels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat categoricalData;
+  arma::Row<size_t> categoricalLabels;
+  data::DatasetInfo info;
+  MockCategoricalData(categoricalData, categoricalLabels, info);
+
+  arma::Row<size_t> predictions[2][3];
+  arma::mat probabilities[2][3];
+  for (size_t run = 0; run < 2; ++run)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(run == 0 ? 1 : 4);
+    #endif
+
+    DecisionTree<> numericTree(numericData, numericLabels, 3, 2);
+    DecisionTree<> categoricalTree(categoricalData, info, categoricalLabels, 5,
+        2);
+    DecisionTree<> presortedTree;
+    presortedTree.Train(numericData, numericLabels, 3, 2, 1e-7, true);
+
+    numericTree.Classify(numericData, predictions[run][0],
+        probabilities[run][0]);
+    categoricalTree.Classify(categoricalData, predictions[run][1],
+        probabilities[run][1]);
+    presortedTree.Classify(numericData, predictions[run][2],
+        probabilities[run][2]);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    CheckMatrices(predictions[0][i], predictions[1][i]);
+    CheckMatrices(probabilities[0][i], probabilities[1][i]);
+  }
+}
+
+/**
+ * Make sure that a FlatForest compiled from a single decision tree gives the
+ * same predictions and probabilities as the tree, on numeric and categorical
+ * data.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestDecisionTreeTest)
+{
+  arma::mat numericData;
+  if (!data::Load("vc2.csv", numericData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> numericLabels;
+  if (!data::Load("vc2_labels.txt", numericLabels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat categoricalData;
+  arma::Row<size_t> categoricalLabels;
+  data::DatasetInfo info;
+  MockCategoricalData(categoricalData, categoricalLabels, info);
+
+  DecisionTree<> numericTree(numericData, numericLabels, 3, 5);
+  DecisionTree<> categoricalTree(categoricalData, info, categoricalLabels, 5,
+      5);
+
+  FlatForest flatNumeric, flatCategorical;
+  BOOST_REQUIRE_THROW(flatNumeric.Classify(numericData, numericLabels),
+      std::invalid_argument);
+  flatNumeric.Add(numericTree);
+  flatCategorical.Add(categoricalTree);
+  BOOST_REQUIRE_EQUAL(flatNumeric.NumTrees(), 1);
+  BOOST_REQUIRE_EQUAL(flatNumeric.NumClasses(), 3);
+  BOOST_REQUIRE_THROW(flatNumeric.Add(categoricalTree), std::invalid_argument);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  numericTree.Classify(numericData, predictions, probabilities);
+  flatNumeric.Classify(numericData, flatPredictions, flatProbabilities);
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+  BOOST_REQUIRE_EQUAL(flatNumeric.Classify(numericData.col(0)),
+      numericTree.Classify(numericData.col(0)));
+
+  categoricalTree.Classify(categoricalData, predictions, probabilities);
+  flatCategorical.Classify(categoricalData, flatPredictions,
+      flatProbabilities);
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+}
+
 /**
  * Test that we can build a decision tree on a simple categorical dataset.
  */
@@ -1126,4 +1454,48 @@ BOOST_AUTO_TEST_CASE(RegularisedDecisionTree)
   BOOST_REQUIRE_GT(count, 0);
 }
 
+/**
+ * Test that a decision tree trained on a MixedDataset, whose categorical
+ * dimensions are stored as 8-bit codes, is the same as the one trained on the
+ * matrix.
+ */
+BOOST_AUTO_TEST_CASE(MixedDatasetBuildTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+  arma::Row<size_t> testLabels = l.subvec(2000, 3999);
+  arma::rowvec weights(2000, arma::fill::randu);
+
+  data::MixedDataset<double, uint8_t> mixed(trainingData, di);
+  BOOST_REQUIRE_EQUAL(mixed.Codes().n_rows, 2);
+
+  DecisionTree<> tree(trainingData, di, trainingLabels, 5, 10);
+  DecisionTree<> mixedTree(mixed, di, trainingLabels, 5, 10);
+  DecisionTree<> weightedTree(trainingData, di, trainingLabels, 5, weights,
+      10);
+  DecisionTree<> mixedWeightedTree(mixed, di, trainingLabels, 5, weights, 10);
+
+  arma::Row<size_t> predictions, mixedPredictions;
+  tree.Classify(testData, predictions);
+  mixedTree.Classify(testData, mixedPredictions);
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), mixedTree.NumChildren());
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != mixedPredictions), 0);
+
+  weightedTree.Classify(testData, predictions);
+  mixedWeightedTree.Classify(testData, mixedPredictions);
+  BOOST_REQUIRE_EQUAL(arma::accu(predictions != mixedPredictions), 0);
+
+  // Numeric dimensions in single precision still give a good tree.
+  data::MixedDataset<float, uint8_t> floatMixed(trainingData, di);
+  DecisionTree<> floatTree(floatMixed, di, trainingLabels, 5, 10);
+  floatTree.Classify(testData, predictions);
+  BOOST_REQUIRE_GT(arma::accu(predictions == testLabels), 1400);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
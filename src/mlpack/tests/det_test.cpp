@@ -778,4 +778,123 @@ BOOST_AUTO_TEST_CASE(MoveOperatorTest)
   BOOST_REQUIRE_CLOSE(testDTree2.Right()->SplitValue(), 0.5, 1e-5);
 }
 
+/**
+ * Make sure that growing a tree with presorted points gives the same tree as
+ * sorting at every node.
+ */
+BOOST_AUTO_TEST_CASE(PresortedGrowTest)
+{
+  arma::mat data = arma::randn<arma::mat>(3, 2000);
+  arma::mat presortedData(data);
+
+  arma::Col<size_t> oldFromNew = arma::regspace<arma::Col<size_t>>(0, 1999);
+  arma::Col<size_t> presortedOldFromNew(oldFromNew);
+
+  DTree<arma::mat> tree(data);
+  DTree<arma::mat> presortedTree(data);
+  const double alpha = tree.Grow(data, oldFromNew, false, 10, 5);
+  const double presortedAlpha = presortedTree.Grow(presortedData,
+      presortedOldFromNew, false, 10, 5, true);
+
+  BOOST_REQUIRE_GT(tree.SubtreeLeaves(), 1);
+  BOOST_REQUIRE_EQUAL(tree.SubtreeLeaves(), presortedTree.SubtreeLeaves());
+  BOOST_REQUIRE_CLOSE(alpha, presortedAlpha, 1e-5);
+  CheckMatrices(oldFromNew, presortedOldFromNew);
+  CheckMatrices(data, presortedData);
+
+  arma::vec densities, presortedDensities;
+  tree.ComputeValue(data, densities);
+  presortedTree.ComputeValue(data, presortedDensities);
+  CheckMatrices(densities, presortedDensities);
+}
+
+/**
+ * Make sure that the grown tree does not depend on the number of threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelGrowTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+  #endif
+
+  const arma::mat data = arma::randu<arma::mat>(4, 5000);
+  arma::vec densities[2];
+  arma::Col<size_t> oldFromNew[2];
+  size_t leaves[2];
+  for (size_t run = 0; run < 2; ++run)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(run == 0 ? 1 : 4);
+    #endif
+
+    arma::mat growData(data);
+    oldFromNew[run] = arma::regspace<arma::Col<size_t>>(0, data.n_cols - 1);
+    DTree<arma::mat> tree(growData);
+    tree.Grow(growData, oldFromNew[run], false, 10, 5, run == 1);
+    leaves[run] = tree.SubtreeLeaves();
+    tree.ComputeValue(data, densities[run]);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  BOOST_REQUIRE_EQUAL(leaves[0], leaves[1]);
+  CheckMatrices(oldFromNew[0], oldFromNew[1]);
+  CheckMatrices(densities[0], densities[1]);
+}
+
+/**
+ * Make sure that the batched density estimates are the same as the estimates
+ * of each point, including for points outside of the range of the tree.
+ */
+BOOST_AUTO_TEST_CASE(BatchComputeValueTest)
+{
+  arma::mat data = arma::randn<arma::mat>(3, 1000);
+  arma::Col<size_t> oldFromNew = arma::regspace<arma::Col<size_t>>(0, 999);
+  DTree<arma::mat> tree(data);
+  const double alpha = tree.Grow(data, oldFromNew, false, 10, 5);
+  tree.PruneAndUpdate(alpha, data.n_cols);
+
+  const arma::mat queries = 2.0 * arma::randn<arma::mat>(3, 2000);
+  arma::vec densities;
+  tree.ComputeValue(queries, densities);
+
+  BOOST_REQUIRE_EQUAL(densities.n_elem, queries.n_cols);
+  size_t outside = 0;
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    const arma::vec query = queries.col(i);
+    const double density = tree.ComputeValue(query);
+    if (density == 0.0)
+    {
+      BOOST_REQUIRE_EQUAL(densities[i], 0.0);
+      ++outside;
+    }
+    else
+    {
+      BOOST_REQUIRE_CLOSE(densities[i], density, 1e-5);
+    }
+  }
+
+  // Some of the points must be outside of the range of the tree.
+  BOOST_REQUIRE_GT(outside, 0);
+  BOOST_REQUIRE_LT(outside, queries.n_cols);
+
+  // The same must hold for sparse trees.
+  arma::sp_mat sparseData = arma::sprandu<arma::sp_mat>(3, 1000, 0.3);
+  oldFromNew = arma::regspace<arma::Col<size_t>>(0, 999);
+  DTree<arma::sp_mat> sparseTree(sparseData);
+  sparseTree.Grow(sparseData, oldFromNew, false, 10, 5);
+
+  arma::vec sparseDensities;
+  sparseTree.ComputeValue(sparseData, sparseDensities);
+  for (size_t i = 0; i < sparseData.n_cols; ++i)
+  {
+    const arma::sp_vec query = sparseData.col(i);
+    BOOST_REQUIRE_CLOSE(sparseDensities[i], sparseTree.ComputeValue(query),
+        1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
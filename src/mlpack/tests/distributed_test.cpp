@@ -0,0 +1,214 @@
+/**
+ * @file distributed_test.cpp
+ *
+ * Tests for the ring allreduce and DistributedFunction, with the ranks run as
+ * threads of a LocalGroup.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/distributed/distributed_function.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/adam/adam.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::regression;
+
+BOOST_AUTO_TEST_SUITE(DistributedTest);
+
+/**
+ * Run the given function for every rank of a group of the given size, each in
+ * its own thread.
+ */
+template<typename RankFunction>
+void RunRanks(const size_t ranks, RankFunction rankFunction)
+{
+  LocalGroup group(ranks);
+  std::vector<std::thread> threads;
+  for (size_t r = 0; r < ranks; ++r)
+  {
+    threads.emplace_back([&group, &rankFunction, r]()
+    {
+      LocalCommunicator communicator(group, r);
+      rankFunction(communicator);
+    });
+  }
+
+  for (size_t r = 0; r < ranks; ++r)
+    threads[r].join();
+}
+
+/**
+ * Make the shards of a logistic regression dataset, with a different number of
+ * points for each rank.
+ */
+void MakeShards(const size_t ranks,
+                std::vector<arma::mat>& data,
+                std::vector<arma::Row<size_t>>& responses)
+{
+  data.resize(ranks);
+  responses.resize(ranks);
+  for (size_t r = 0; r < ranks; ++r)
+  {
+    data[r] = arma::randu<arma::mat>(4, 300 + 7 * r);
+    responses[r].set_size(data[r].n_cols);
+    for (size_t i = 0; i < data[r].n_cols; ++i)
+      responses[r][i] = (arma::accu(data[r].col(i)) > 2.0) ? 1 : 0;
+  }
+}
+
+/**
+ * Make sure that the ring allreduce sums the arrays of all the ranks, whether
+ * or not the number of ranks divides the size and the bucket size.
+ */
+BOOST_AUTO_TEST_CASE(RingAllreduceTest)
+{
+  for (size_t ranks = 1; ranks <= 5; ++ranks)
+  {
+    for (const size_t n : { 1, 3, 17, 100 })
+    {
+      for (const size_t bucketSize : { 0, 4, 33 })
+      {
+        std::vector<arma::vec> values(ranks);
+        arma::vec sum(n, arma::fill::zeros);
+        for (size_t r = 0; r < ranks; ++r)
+        {
+          values[r] = arma::randu<arma::vec>(n);
+          sum += values[r];
+        }
+
+        RunRanks(ranks, [&](LocalCommunicator& communicator)
+        {
+          RingAllreduce(communicator, values[communicator.Rank()].memptr(), n,
+              bucketSize);
+        });
+
+        for (size_t r = 0; r < ranks; ++r)
+        {
+          for (size_t i = 0; i < n; ++i)
+            BOOST_REQUIRE_CLOSE(values[r][i], sum[i], 1e-10);
+
+          // Every element is summed by one rank, so all of them agree.
+          BOOST_REQUIRE_EQUAL(arma::accu(values[r] != values[0]), 0);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the objective and gradient of DistributedFunction are the
+ * averages of those of the shards.
+ */
+BOOST_AUTO_TEST_CASE(DistributedFunctionGradientTest)
+{
+  const size_t ranks = 3;
+  std::vector<arma::mat> data;
+  std::vector<arma::Row<size_t>> responses;
+  MakeShards(ranks, data, responses);
+  const arma::mat parameters = arma::randn<arma::mat>(1, 5);
+
+  // Compute the expected averages (of the first 40 points of each shard).
+  arma::mat expectedGradient(1, 5, arma::fill::zeros);
+  double expectedObjective = 0.0;
+  for (size_t r = 0; r < ranks; ++r)
+  {
+    LogisticRegressionFunction<> lrf(data[r], responses[r], 0.1);
+    arma::mat gradient;
+    expectedObjective += lrf.EvaluateWithGradient(parameters, 10, gradient,
+        40) / ranks;
+    expectedGradient += gradient / ranks;
+  }
+
+  std::vector<size_t> numFunctions(ranks);
+  std::vector<double> objectives(ranks);
+  std::vector<arma::mat> gradients(2 * ranks);
+  RunRanks(ranks, [&](LocalCommunicator& communicator)
+  {
+    const size_t r = communicator.Rank();
+    LogisticRegressionFunction<> lrf(data[r], responses[r], 0.1);
+    DistributedFunction<LogisticRegressionFunction<>, LocalCommunicator>
+        f(lrf, communicator, 2);
+
+    numFunctions[r] = f.NumFunctions();
+    f.Gradient(parameters, 10, gradients[r], 40);
+    objectives[r] = f.EvaluateWithGradient(parameters, 10,
+        gradients[ranks + r], 40);
+  });
+
+  for (size_t r = 0; r < ranks; ++r)
+  {
+    BOOST_REQUIRE_EQUAL(numFunctions[r], 300);
+    BOOST_REQUIRE_CLOSE(objectives[r], expectedObjective, 1e-8);
+    for (size_t g = 0; g < 2; ++g)
+    {
+      for (size_t j = 0; j < expectedGradient.n_elem; ++j)
+      {
+        BOOST_REQUIRE_CLOSE(gradients[g * ranks + r][j], expectedGradient[j],
+            1e-8);
+      }
+    }
+  }
+}
+
+/**
+ * Train a logistic regression model on shards with SGD and Adam, and make sure
+ * that all the ranks end with the same parameters, and that they classify the
+ * data well.
+ */
+BOOST_AUTO_TEST_CASE(DistributedSGDTest)
+{
+  const size_t ranks = 4;
+  std::vector<arma::mat> data;
+  std::vector<arma::Row<size_t>> responses;
+  MakeShards(ranks, data, responses);
+
+  for (size_t optimizer = 0; optimizer < 2; ++optimizer)
+  {
+    std::vector<arma::mat> parameters(ranks);
+    RunRanks(ranks, [&](LocalCommunicator& communicator)
+    {
+      const size_t r = communicator.Rank();
+      LogisticRegressionFunction<> lrf(data[r], responses[r], 0.0);
+      DistributedFunction<LogisticRegressionFunction<>, LocalCommunicator>
+          f(lrf, communicator, 4);
+
+      // Start from a different point on each rank; Broadcast() makes them
+      // agree.
+      parameters[r] = arma::mat(1, 5);
+      parameters[r].fill((double) r);
+      f.Broadcast(parameters[r]);
+
+      if (optimizer == 0)
+      {
+        StandardSGD sgd(0.5, 10, 30000, 1e-10, false);
+        sgd.Optimize(f, parameters[r]);
+      }
+      else
+      {
+        Adam adam(0.05, 10, 0.9, 0.999, 1e-8, 30000, 1e-10, false);
+        adam.Optimize(f, parameters[r]);
+      }
+    });
+
+    for (size_t r = 1; r < ranks; ++r)
+      BOOST_REQUIRE_EQUAL(arma::accu(parameters[r] != parameters[0]), 0);
+
+    LogisticRegression<> lr(4, 0.0);
+    lr.Parameters() = parameters[0];
+    for (size_t r = 0; r < ranks; ++r)
+      BOOST_REQUIRE_GT(lr.ComputeAccuracy(data[r], responses[r]), 90.0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
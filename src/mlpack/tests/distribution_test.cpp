@@ -393,6 +393,40 @@ BOOST_AUTO_TEST_CASE(GaussianMultipointMultivariateProbabilityTest)
   BOOST_REQUIRE_CLOSE(phis(5), -14.900192463287908, 1e-5);
 }
 
+/**
+ * Make sure the single-precision batched log-probabilities match the
+ * double-precision ones.
+ */
+BOOST_AUTO_TEST_CASE(GaussianDistributionFloatLogProbabilityTest)
+{
+  arma::vec mean("5 6 3 3 2");
+  arma::mat cov("6 1 1 1 2;"
+                "1 7 1 0 0;"
+                "1 1 4 1 1;"
+                "1 0 1 7 0;"
+                "2 0 1 0 6");
+  GaussianDistribution g(mean, cov);
+
+  arma::mat points(5, 3000, arma::fill::randn);
+  points *= 3.0;
+
+  arma::vec phis;
+  g.LogProbability(points, phis);
+
+  arma::fvec floatPhis, floatProbabilities;
+  g.LogProbability(arma::conv_to<arma::fmat>::from(points), floatPhis);
+  g.Probability(arma::conv_to<arma::fmat>::from(points), floatProbabilities);
+
+  BOOST_REQUIRE_EQUAL(floatPhis.n_elem, points.n_cols);
+  BOOST_REQUIRE_EQUAL(floatProbabilities.n_elem, points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(floatPhis[i], phis[i], 1e-3);
+    BOOST_REQUIRE_CLOSE(floatProbabilities[i], std::exp(phis[i]), 1e-2);
+    BOOST_REQUIRE_CLOSE(phis[i], g.LogProbability(points.col(i)), 1e-5);
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
@@ -167,4 +167,38 @@ BOOST_AUTO_TEST_CASE(SparseTest)
   BOOST_REQUIRE_EQUAL(distances.n_rows, 3);
 }
 
+/**
+ * With a candidate set holding the whole reference set, the search of more
+ * query points than fit in one block must be exact, with double and float
+ * storage.
+ */
+template<typename MatType>
+void CheckExhaustiveBlockedSearch(const double tolerance)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(5, 100);
+  arma::mat querySet = arma::randu<arma::mat>(5, 2500);
+
+  DrusillaSelect<MatType> ds(arma::conv_to<MatType>::from(referenceSet), 100,
+      1);
+  arma::mat distances, distancesTrue;
+  arma::Mat<size_t> neighbors, neighborsTrue;
+  ds.Search(arma::conv_to<MatType>::from(querySet), 3, neighbors, distances);
+
+  AllkFN kfn(referenceSet);
+  kfn.Search(querySet, 3, neighborsTrue, distancesTrue);
+
+  CheckMatrices(neighbors, neighborsTrue);
+  CheckMatrices(distances, distancesTrue, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(DrusillaSelectBlockedSearchTest)
+{
+  CheckExhaustiveBlockedSearch<arma::mat>(1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(DrusillaSelectFloatSearchTest)
+{
+  CheckExhaustiveBlockedSearch<arma::fmat>(1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,229 @@
+/**
+ * @file elastic_net_test.cpp
+ *
+ * Tests for the ElasticNet coordinate descent solver.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/elastic_net/elastic_net.hpp>
+#include <mlpack/methods/lars/lars.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::regression;
+using namespace mlpack::optimization;
+
+BOOST_AUTO_TEST_SUITE(ElasticNetTest);
+
+/**
+ * Make sure the coefficients satisfy the KKT conditions of the elastic net on
+ * the given (centered) data.
+ */
+void ElasticNetVerifyKKT(const arma::mat& X,
+                         const arma::rowvec& y,
+                         const arma::vec& beta,
+                         const double lambda1,
+                         const double lambda2,
+                         const double tol)
+{
+  const arma::vec errCorr = X * (y.t() - X.t() * beta) - lambda2 * beta;
+  for (size_t j = 0; j < beta.n_elem; ++j)
+  {
+    if (beta[j] == 0.0)
+      BOOST_REQUIRE_SMALL(std::max(std::abs(errCorr[j]) - lambda1, 0.0), tol);
+    else if (beta[j] > 0.0)
+      BOOST_REQUIRE_SMALL(errCorr[j] - lambda1, tol);
+    else
+      BOOST_REQUIRE_SMALL(errCorr[j] + lambda1, tol);
+  }
+}
+
+/**
+ * Compare the solutions of ElasticNet and LARS on random problems.
+ */
+void CompareWithLARS(const double lambda2Ratio)
+{
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    const arma::mat X = arma::randn(10, 100);
+    const arma::rowvec y = arma::randn<arma::vec>(10).t() * X +
+        0.1 * arma::randn<arma::rowvec>(100);
+
+    const arma::vec sortedAbsCorr = arma::sort(arma::abs(X * y.t()));
+    const double lambda1 = sortedAbsCorr[5];
+    const double lambda2 = lambda2Ratio * lambda1;
+
+    LARS lars(true, lambda1, lambda2);
+    arma::vec larsBeta;
+    lars.Train(X, y, larsBeta);
+
+    ElasticNet<CyclicDescent> elasticNet(lambda1, lambda2, false, 1e-14);
+    elasticNet.Train(X, y);
+
+    BOOST_REQUIRE_EQUAL(elasticNet.Beta().n_elem, larsBeta.n_elem);
+    for (size_t j = 0; j < larsBeta.n_elem; ++j)
+      BOOST_REQUIRE_SMALL(elasticNet.Beta()[j] - larsBeta[j], 1e-5);
+    BOOST_REQUIRE_EQUAL(elasticNet.Intercept(), 0.0);
+
+    ElasticNetVerifyKKT(X, y, elasticNet.Beta(), lambda1, lambda2, 1e-4);
+  }
+}
+
+/**
+ * The lasso solution should be the same as the one of LARS.
+ */
+BOOST_AUTO_TEST_CASE(ElasticNetLassoLARSTest)
+{
+  CompareWithLARS(0.0);
+}
+
+/**
+ * The elastic net solution should be the same as the one of LARS.
+ */
+BOOST_AUTO_TEST_CASE(ElasticNetLARSTest)
+{
+  CompareWithLARS(0.5);
+}
+
+/**
+ * With an intercept, the coefficients should be the ones of the centered
+ * problem, and the default (random) descent policy should converge too.
+ */
+BOOST_AUTO_TEST_CASE(ElasticNetInterceptTest)
+{
+  arma::mat X = arma::randn(8, 200);
+  X.each_col() += arma::linspace<arma::vec>(-2.0, 5.0, 8);
+  const arma::rowvec y = arma::randn<arma::vec>(8).t() * X + 3.0;
+
+  arma::mat centeredX = X;
+  centeredX.each_col() -= arma::mean(X, 1);
+  const arma::rowvec centeredY = y - arma::mean(y);
+
+  const double lambda1 = 0.1 * ElasticNet<>::MaxLambda1(X, y, true);
+  ElasticNet<> elasticNet(X, y, lambda1, 0.1, true, 1e-14);
+
+  ElasticNetVerifyKKT(centeredX, centeredY, elasticNet.Beta(), lambda1, 0.1,
+      1e-3);
+  BOOST_REQUIRE_CLOSE(elasticNet.Intercept(), arma::mean(y) -
+      arma::dot(arma::mean(X, 1), elasticNet.Beta()), 1e-5);
+
+  // The predictions should be the ones of the centered model.
+  arma::rowvec predictions;
+  elasticNet.Predict(X, predictions);
+  const arma::rowvec centeredPredictions = elasticNet.Beta().t() * centeredX +
+      arma::mean(y);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(predictions[i], centeredPredictions[i], 1e-5);
+}
+
+/**
+ * Training on sparse data should give the same model as training on the same
+ * data in a dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(ElasticNetSparseTest)
+{
+  arma::sp_mat sparseX;
+  sparseX.sprandu(50, 300, 0.1);
+  const arma::mat X(sparseX);
+  const arma::rowvec y = arma::randn<arma::vec>(50).t() * X +
+      0.1 * arma::randn<arma::rowvec>(300);
+
+  const double lambda1 = 0.2 * ElasticNet<>::MaxLambda1(X, y, true);
+  BOOST_REQUIRE_CLOSE(ElasticNet<>::MaxLambda1(sparseX, y, true),
+      lambda1 / 0.2, 1e-5);
+
+  ElasticNet<CyclicDescent> dense(X, y, lambda1, 0.01, true, 1e-14);
+  ElasticNet<CyclicDescent> sparse(sparseX, y, lambda1, 0.01, true, 1e-14);
+
+  for (size_t j = 0; j < dense.Beta().n_elem; ++j)
+    BOOST_REQUIRE_SMALL(sparse.Beta()[j] - dense.Beta()[j], 1e-6);
+  BOOST_REQUIRE_SMALL(sparse.Intercept() - dense.Intercept(), 1e-6);
+
+  arma::rowvec densePredictions, sparsePredictions;
+  dense.Predict(X, densePredictions);
+  sparse.Predict(sparseX, sparsePredictions);
+  for (size_t i = 0; i < densePredictions.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(sparsePredictions[i] - densePredictions[i], 1e-5);
+}
+
+/**
+ * Each solution of the path should be the solution of its value of lambda1,
+ * and the screening rule should discard features.
+ */
+BOOST_AUTO_TEST_CASE(ElasticNetPathTest)
+{
+  const arma::mat X = arma::randn(200, 50);
+  arma::vec trueBeta(200, arma::fill::zeros);
+  trueBeta.head(5) = arma::randn<arma::vec>(5);
+  const arma::rowvec y = trueBeta.t() * X + 0.1 * arma::randn<arma::rowvec>(50);
+
+  const double maxLambda1 = ElasticNet<>::MaxLambda1(X, y, true);
+  arma::vec lambda1Path(10);
+  for (size_t i = 0; i < lambda1Path.n_elem; ++i)
+    lambda1Path[i] = maxLambda1 * std::pow(0.7, (double) i);
+
+  ElasticNet<CyclicDescent> path(0.0, 0.0, true, 1e-14);
+  arma::mat betaPath;
+  arma::rowvec interceptPath;
+  path.Path(X, y, lambda1Path, betaPath, interceptPath);
+
+  BOOST_REQUIRE_EQUAL(betaPath.n_rows, (size_t) 200);
+  BOOST_REQUIRE_EQUAL(betaPath.n_cols, (size_t) 10);
+  BOOST_REQUIRE_EQUAL(interceptPath.n_elem, (size_t) 10);
+
+  // At the largest value of lambda1, all the coefficients are zero.
+  BOOST_REQUIRE_SMALL(arma::norm(betaPath.col(0)), 1e-10);
+  BOOST_REQUIRE_SMALL(interceptPath[0] - arma::mean(y), 1e-10);
+
+  // The model holds the last solution.
+  BOOST_REQUIRE_EQUAL(path.Lambda1(), lambda1Path[9]);
+
+  // Close to the largest value of lambda1, the noise features are screened.
+  ElasticNet<CyclicDescent> screened(X, y, 0.8 * maxLambda1, 0.0, true);
+  BOOST_REQUIRE_GT(screened.NumScreened(), (size_t) 0);
+
+  arma::mat centeredX = X;
+  centeredX.each_col() -= arma::mean(X, 1);
+  const arma::rowvec centeredY = y - arma::mean(y);
+  for (size_t i = 1; i < lambda1Path.n_elem; ++i)
+  {
+    ElasticNet<CyclicDescent> single(X, y, lambda1Path[i], 0.0, true, 1e-14);
+    for (size_t j = 0; j < betaPath.n_rows; ++j)
+      BOOST_REQUIRE_SMALL(betaPath(j, i) - single.Beta()[j], 1e-4);
+    BOOST_REQUIRE_SMALL(interceptPath[i] - single.Intercept(), 1e-4);
+
+    ElasticNetVerifyKKT(centeredX, centeredY, betaPath.col(i), lambda1Path[i],
+        0.0, 1e-3);
+  }
+}
+
+/**
+ * A warm start should converge to the same solution.
+ */
+BOOST_AUTO_TEST_CASE(ElasticNetWarmStartTest)
+{
+  const arma::mat X = arma::randn(20, 100);
+  const arma::rowvec y = arma::randn<arma::vec>(20).t() * X;
+  const double maxLambda1 = ElasticNet<>::MaxLambda1(X, y, false);
+
+  ElasticNet<CyclicDescent> cold(X, y, 0.1 * maxLambda1, 0.0, false, 1e-14);
+
+  ElasticNet<CyclicDescent> warm(X, y, 0.3 * maxLambda1, 0.0, false, 1e-14);
+  warm.Lambda1() = 0.1 * maxLambda1;
+  warm.Train(X, y, true);
+
+  for (size_t j = 0; j < cold.Beta().n_elem; ++j)
+    BOOST_REQUIRE_SMALL(warm.Beta()[j] - cold.Beta()[j], 1e-5);
+
+  // Warm starting with the wrong dimensionality is an error.
+  const arma::mat smallX = X.rows(0, 9);
+  BOOST_REQUIRE_THROW(warm.Train(smallX, y, true), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -278,4 +278,52 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Make sure the parallel Boruvka rounds give the same tree as the naive
+ * computation, with the kd-tree and in naive mode.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDTBTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+  #endif
+
+  arma::mat inputData(3, 2000, arma::fill::randu);
+
+  // The serial naive computation.
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(1);
+  #endif
+  DualTreeBoruvka<> serialNaive(inputData, true);
+  arma::mat serialResults;
+  serialNaive.ComputeMST(serialResults);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(4);
+  #endif
+  DualTreeBoruvka<> parallelNaive(inputData, true);
+  DualTreeBoruvka<> parallelTree(inputData);
+  arma::mat naiveResults, treeResults;
+  parallelNaive.ComputeMST(naiveResults);
+  parallelTree.ComputeMST(treeResults);
+
+  BOOST_REQUIRE_EQUAL(naiveResults.n_cols, serialResults.n_cols);
+  BOOST_REQUIRE_EQUAL(treeResults.n_cols, serialResults.n_cols);
+  for (size_t i = 0; i < serialResults.n_cols; i++)
+  {
+    BOOST_REQUIRE_EQUAL(naiveResults(0, i), serialResults(0, i));
+    BOOST_REQUIRE_EQUAL(naiveResults(1, i), serialResults(1, i));
+    BOOST_REQUIRE_CLOSE(naiveResults(2, i), serialResults(2, i), 1e-5);
+
+    BOOST_REQUIRE_EQUAL(treeResults(0, i), serialResults(0, i));
+    BOOST_REQUIRE_EQUAL(treeResults(1, i), serialResults(1, i));
+    BOOST_REQUIRE_CLOSE(treeResults(2, i), serialResults(2, i), 1e-5);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1082,4 +1082,127 @@ BOOST_AUTO_TEST_CASE(CopyAssignmentTest)
   }
 }
 
+/**
+ * Make sure the batched naive search gives the same results as a direct
+ * computation of the kernels, for the kernels evaluated with matrix products
+ * and for the others, with and without a query set.
+ */
+template<typename KernelType>
+void CheckNaiveSearch(KernelType& kernel)
+{
+  // Use more points than the size of the blocks.
+  arma::mat referenceData = arma::randn<arma::mat>(4, 1500);
+  arma::mat queryData = arma::randn<arma::mat>(4, 150);
+
+  FastMKS<KernelType> naive(referenceData, kernel, false, true);
+  arma::Mat<size_t> indices, selfIndices;
+  arma::mat kernels, selfKernels;
+  naive.Search(queryData, 5, indices, kernels);
+  naive.Search(5, selfIndices, selfKernels);
+
+  BOOST_REQUIRE_EQUAL(indices.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(indices.n_cols, 150);
+  BOOST_REQUIRE_EQUAL(selfIndices.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(selfIndices.n_cols, 1500);
+
+  for (size_t q = 0; q < 1500; q += 7)
+  {
+    arma::vec trueKernels(1500);
+    for (size_t r = 0; r < 1500; ++r)
+      trueKernels[r] = kernel.Evaluate(referenceData.col(q),
+          referenceData.col(r));
+    trueKernels[q] = -DBL_MAX;
+    const arma::uvec order = arma::sort_index(trueKernels, "descend");
+
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(selfIndices(j, q), (size_t) order[j]);
+      BOOST_REQUIRE_CLOSE(selfKernels(j, q), trueKernels[order[j]], 1e-5);
+    }
+  }
+
+  for (size_t q = 0; q < 150; ++q)
+  {
+    arma::vec trueKernels(1500);
+    for (size_t r = 0; r < 1500; ++r)
+      trueKernels[r] = kernel.Evaluate(queryData.col(q), referenceData.col(r));
+    const arma::uvec order = arma::sort_index(trueKernels, "descend");
+
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(indices(j, q), (size_t) order[j]);
+      BOOST_REQUIRE_CLOSE(kernels(j, q), trueKernels[order[j]], 1e-5);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BatchedNaiveSearchTest)
+{
+  LinearKernel lk;
+  CheckNaiveSearch(lk);
+
+  PolynomialKernel pk(3, 1.5);
+  CheckNaiveSearch(pk);
+
+  GaussianKernel gk(2.0);
+  CheckNaiveSearch(gk);
+}
+
+/**
+ * Make sure the parallel single-tree search over many blocks of query points
+ * gives the same results as naive search, with and without a query set.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeVsNaiveTest)
+{
+  arma::mat referenceData = arma::randn<arma::mat>(5, 1200);
+  arma::mat queryData = arma::randn<arma::mat>(5, 700);
+  PolynomialKernel pk(2, 1.0);
+
+  FastMKS<PolynomialKernel> naive(referenceData, pk, false, true);
+  FastMKS<PolynomialKernel> single(referenceData, pk, true);
+
+  arma::Mat<size_t> naiveIndices, singleIndices;
+  arma::mat naiveKernels, singleKernels;
+
+  naive.Search(queryData, 5, naiveIndices, naiveKernels);
+  single.Search(queryData, 5, singleIndices, singleKernels);
+  CheckMatrices(singleIndices, naiveIndices);
+  CheckMatrices(singleKernels, naiveKernels, 1e-5);
+
+  naive.Search(5, naiveIndices, naiveKernels);
+  single.Search(5, singleIndices, singleKernels);
+  CheckMatrices(singleIndices, naiveIndices);
+  CheckMatrices(singleKernels, naiveKernels, 1e-5);
+}
+
+/**
+ * Make sure the cached self-kernels are recomputed when the reference set
+ * changes.
+ */
+BOOST_AUTO_TEST_CASE(CachedSelfKernelsRetrainTest)
+{
+  arma::mat referenceData = arma::randn<arma::mat>(3, 500);
+  arma::mat newReferenceData = 10 * arma::randn<arma::mat>(3, 500);
+  arma::mat queryData = arma::randn<arma::mat>(3, 100);
+  LinearKernel lk;
+
+  FastMKS<LinearKernel> single(referenceData, lk, true);
+  arma::Mat<size_t> singleIndices;
+  arma::mat singleKernels;
+  single.Search(queryData, 3, singleIndices, singleKernels);
+
+  // Train on a reference set with the same number of points but different
+  // norms.
+  single.Train(newReferenceData);
+  single.Search(queryData, 3, singleIndices, singleKernels);
+
+  FastMKS<LinearKernel> naive(newReferenceData, lk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(queryData, 3, naiveIndices, naiveKernels);
+
+  CheckMatrices(singleIndices, naiveIndices);
+  CheckMatrices(singleKernels, naiveKernels, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,10 +12,13 @@
  */
 #include <mlpack/core.hpp>
 
+#include <mlpack/core/optimizers/adam/adam.hpp>
 #include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
+#include <mlpack/core/optimizers/sgd/sgd.hpp>
 #include <mlpack/core/optimizers/sgd/update_policies/vanilla_update.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -619,4 +622,871 @@ BOOST_AUTO_TEST_CASE(CustomLayerTest)
   arma::mat prediction = arma::zeros<arma::mat>(1, predictionTemp.n_cols);
 }
 
+/**
+ * Make sure that batched prediction gives the same results as predicting one
+ * point at a time, also when the batch size does not divide the number of
+ * points.
+ */
+BOOST_AUTO_TEST_CASE(BatchedPredictTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 103);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat predictions, batchPredictions, fullPredictions;
+  model.Predict(data, predictions);
+  model.Predict(data, batchPredictions, 16);
+  model.Predict(data, fullPredictions, data.n_cols);
+
+  CheckMatrices(predictions, batchPredictions);
+  CheckMatrices(predictions, fullPredictions);
+}
+
+/**
+ * Make sure that the planned forward pass gives the same results as the
+ * regular forward pass and that the arena has the expected size.
+ */
+BOOST_AUTO_TEST_CASE(PlannedForwardTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 103);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat predictions, plannedPredictions;
+  model.Predict(data, predictions);
+
+  // The arena holds the input block and the output of every layer.
+  const size_t memory = model.Plan(10, 16);
+  BOOST_REQUIRE(model.Planned());
+  BOOST_REQUIRE_EQUAL(memory, (10 + 8 + 8 + 3 + 3) * 16 * sizeof(double));
+  BOOST_REQUIRE_EQUAL(model.PlannedMemory(), memory);
+
+  // Predict twice to make sure the buffers can be reused.
+  model.Predict(data, plannedPredictions);
+  CheckMatrices(predictions, plannedPredictions);
+  model.Predict(data, plannedPredictions);
+  CheckMatrices(predictions, plannedPredictions);
+
+  // Copies of the model are planned too.
+  FFN<NegativeLogLikelihood<> > copiedModel(model);
+  BOOST_REQUIRE(copiedModel.Planned());
+  copiedModel.Predict(data, plannedPredictions);
+  CheckMatrices(predictions, plannedPredictions);
+
+  // An input of a different shape drops the plan.
+  model.Forward(data.cols(0, 4), plannedPredictions);
+  BOOST_REQUIRE(!model.Planned());
+  BOOST_REQUIRE_EQUAL(model.PlannedMemory(), 0);
+  CheckMatrices(predictions.cols(0, 4), plannedPredictions);
+}
+
+/**
+ * Create a dataset of 64 points with the given number of dimensions in two
+ * classes: the first half of the points has label 1, and the second half,
+ * whose values are larger by 0.5, has label 2.
+ */
+void TwoClassData(const size_t dimensions, arma::mat& data, arma::mat& labels)
+{
+  data = arma::randu<arma::mat>(dimensions, 64);
+  data.cols(32, 63) += 0.5;
+  labels = arma::ones<arma::mat>(1, 64);
+  labels.cols(32, 63).fill(2);
+}
+
+/**
+ * Add a dense classifier to the given network: a Linear layer between each
+ * two consecutive sizes, with a SigmoidLayer between the Linear layers, and a
+ * LogSoftMax layer at the end.
+ */
+void AddDenseLayers(FFN<NegativeLogLikelihood<> >& model,
+                    const std::vector<size_t>& sizes)
+{
+  for (size_t i = 0; i + 1 < sizes.size(); ++i)
+  {
+    if (i > 0)
+      model.Add<SigmoidLayer<> >();
+    model.Add<Linear<> >(sizes[i], sizes[i + 1]);
+  }
+  model.Add<LogSoftMax<> >();
+}
+
+/**
+ * Add a classifier of 8x8 images whose forward pass in training mode has
+ * state: a Convolution layer with two maps, a BatchNorm layer (the second
+ * layer), a MaxPooling layer (the fourth layer) and a Dropout layer, and a
+ * dense classifier of the pooled maps.
+ */
+void AddStatefulLayers(FFN<NegativeLogLikelihood<> >& model)
+{
+  model.Add<Convolution<> >(1, 2, 3, 3, 1, 1, 1, 1, 8, 8);
+  model.Add<BatchNorm<> >(128);
+  model.Add<ReLULayer<> >();
+  model.Add<MaxPooling<> >(2, 2, 2, 2);
+  model.Add<Dropout<> >(0.3);
+  AddDenseLayers(model, { 32, 8, 2 });
+}
+
+/**
+ * Make sure that the layers added by AddStatefulLayers() have the same running
+ * statistics in both networks, and that no forward pass is left waiting for
+ * its backward pass.
+ */
+void CheckStatefulLayers(FFN<NegativeLogLikelihood<> >& model,
+                         FFN<NegativeLogLikelihood<> >& reference)
+{
+  const BatchNorm<>& batchNorm = *boost::get<BatchNorm<>*>(model.Model()[1]);
+  const BatchNorm<>& referenceBatchNorm =
+      *boost::get<BatchNorm<>*>(reference.Model()[1]);
+  BOOST_REQUIRE_EQUAL(batchNorm.Stats().count(),
+      referenceBatchNorm.Stats().count());
+  CheckMatrices(batchNorm.Stats().mean(), referenceBatchNorm.Stats().mean());
+  CheckMatrices(batchNorm.Stats().var(), referenceBatchNorm.Stats().var());
+
+  BOOST_REQUIRE_EQUAL(boost::get<MaxPooling<>*>(model.Model()[3])->
+      PendingPasses(), 0);
+  BOOST_REQUIRE_EQUAL(boost::get<MaxPooling<>*>(reference.Model()[3])->
+      PendingPasses(), 0);
+}
+
+/**
+ * Make sure that the gradient computed by worker replicas on parts of the
+ * batch is the same as the gradient computed on the whole batch.
+ */
+BOOST_AUTO_TEST_CASE(ParallelGradientTest)
+{
+  arma::mat data, labels;
+  TwoClassData(10, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model(data, labels);
+  AddDenseLayers(model, { 10, 8, 2 });
+  model.ResetParameters();
+
+  arma::mat gradient, parallelGradient;
+  model.Gradient(model.Parameters(), 0, gradient, 64);
+
+  model.NumThreads() = 4;
+  model.Gradient(model.Parameters(), 0, parallelGradient, 64);
+  CheckMatrices(gradient, parallelGradient);
+
+  // Batches smaller than the number of threads and batches that don't start
+  // at the first point.
+  model.NumThreads() = 1;
+  model.Gradient(model.Parameters(), 5, gradient, 3);
+  model.NumThreads() = 4;
+  model.Gradient(model.Parameters(), 5, parallelGradient, 3);
+  CheckMatrices(gradient, parallelGradient);
+
+  // The replicas have to see updated parameters.
+  model.Parameters() *= 0.5;
+  model.NumThreads() = 1;
+  model.Gradient(model.Parameters(), 10, gradient, 32);
+  model.NumThreads() = 4;
+  model.Gradient(model.Parameters(), 10, parallelGradient, 32);
+  CheckMatrices(gradient, parallelGradient);
+}
+
+/**
+ * Make sure that the BatchNorm layers of the worker replicas normalize their
+ * own part of the batch, and that their running statistics are merged into the
+ * network after every batch.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBatchNormGradientTest)
+{
+#ifdef HAS_OPENMP
+  arma::mat data, labels;
+  TwoClassData(10, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model(data, labels), partModel(data, labels);
+  for (FFN<NegativeLogLikelihood<> >* network : { &model, &partModel })
+  {
+    network->Add<Linear<> >(10, 8);
+    network->Add<BatchNorm<> >(8);
+    network->Add<SigmoidLayer<> >();
+    network->Add<Linear<> >(8, 2);
+    network->Add<LogSoftMax<> >();
+    network->ResetParameters();
+  }
+  partModel.Parameters() = model.Parameters();
+
+  // Size the layers with a first pass.
+  arma::mat gradient, partGradient, parallelGradient;
+  model.Gradient(model.Parameters(), 0, gradient, 64);
+  partModel.Gradient(partModel.Parameters(), 0, gradient, 64);
+
+  model.NumThreads() = 4;
+  for (size_t step = 0; step < 2; ++step)
+  {
+    model.Gradient(model.Parameters(), 0, parallelGradient, 64);
+
+    // Each quarter of the batch is normalized on its own.
+    gradient.zeros();
+    for (size_t t = 0; t < 4; ++t)
+    {
+      partModel.Gradient(partModel.Parameters(), 16 * t, partGradient, 16);
+      gradient += partGradient;
+    }
+    CheckMatrices(gradient, parallelGradient);
+
+    const BatchNorm<>& batchNorm = *boost::get<BatchNorm<>*>(model.Model()[1]);
+    const BatchNorm<>& partBatchNorm =
+        *boost::get<BatchNorm<>*>(partModel.Model()[1]);
+    BOOST_REQUIRE_EQUAL(batchNorm.Stats().count(), 64 * (step + 2));
+    BOOST_REQUIRE_EQUAL(partBatchNorm.Stats().count(), 64 * (step + 2));
+    CheckMatrices(batchNorm.Stats().mean(), partBatchNorm.Stats().mean());
+    CheckMatrices(batchNorm.Stats().var(), partBatchNorm.Stats().var());
+  }
+#endif
+}
+
+/**
+ * Make sure that the pipeline computes the same gradient as a single pass over
+ * the batch, for several numbers of stages and microbatches.
+ */
+BOOST_AUTO_TEST_CASE(PipelineGradientTest)
+{
+  arma::mat data, labels;
+  TwoClassData(10, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model(data, labels);
+  AddDenseLayers(model, { 10, 8, 6, 2 });
+  model.ResetParameters();
+
+  arma::mat gradient, pipelineGradient;
+  model.Gradient(model.Parameters(), 0, gradient, 64);
+
+  const size_t settings[4][2] = { { 2, 4 }, { 3, 4 }, { 6, 3 }, { 4, 64 } };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    model.PipelineStages() = settings[i][0];
+    model.Microbatches() = settings[i][1];
+    model.Gradient(model.Parameters(), 0, pipelineGradient, 64);
+    CheckMatrices(gradient, pipelineGradient);
+  }
+
+  // Batches smaller than the number of microbatches that don't start at the
+  // first point.
+  model.PipelineStages() = 1;
+  model.Gradient(model.Parameters(), 5, gradient, 3);
+  model.PipelineStages() = 3;
+  model.Microbatches() = 4;
+  model.Gradient(model.Parameters(), 5, pipelineGradient, 3);
+  CheckMatrices(gradient, pipelineGradient);
+}
+
+/**
+ * Make sure that the recomputed forward passes of the pipeline replay the
+ * state of the layers: with two stages, the first of which holds the layers
+ * with state, the gradient is the sum of the gradients of the microbatches
+ * over several batches, and the running statistics of BatchNorm are the same.
+ */
+BOOST_AUTO_TEST_CASE(PipelineStatefulGradientTest)
+{
+  arma::mat data, labels;
+  TwoClassData(64, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model(data, labels),
+      pipelineModel(data, labels);
+  AddStatefulLayers(model);
+  AddStatefulLayers(pipelineModel);
+  model.ResetParameters();
+  pipelineModel.ResetParameters();
+  pipelineModel.Parameters() = model.Parameters();
+
+  // Size the layers with a first pass.
+  arma::mat gradient, microbatchGradient, pipelineGradient;
+  math::RandomSeed(1);
+  model.Gradient(model.Parameters(), 0, gradient, 8);
+  math::RandomSeed(1);
+  pipelineModel.Gradient(pipelineModel.Parameters(), 0, gradient, 8);
+
+  // The first stage runs on the calling thread, so it draws the same masks
+  // as the microbatches one after the other.
+  pipelineModel.PipelineStages() = 2;
+  pipelineModel.Microbatches() = 4;
+  for (size_t step = 2; step < 5; ++step)
+  {
+    const size_t begin = 16 * (step - 2);
+    math::RandomSeed(step);
+    gradient.zeros();
+    for (size_t m = 0; m < 4; ++m)
+    {
+      model.Gradient(model.Parameters(), begin + 8 * m, microbatchGradient,
+          8);
+      gradient += microbatchGradient;
+    }
+
+    math::RandomSeed(step);
+    pipelineModel.Gradient(pipelineModel.Parameters(), begin,
+        pipelineGradient, 32);
+    CheckMatrices(gradient, pipelineGradient);
+    CheckStatefulLayers(pipelineModel, model);
+  }
+}
+
+/**
+ * Make sure that the gradient with activation checkpointing is the same as
+ * without, whatever the number of segments.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointGradientTest)
+{
+  arma::mat data, labels;
+  TwoClassData(10, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model(data, labels);
+  AddDenseLayers(model, { 10, 8, 6, 2 });
+  model.ResetParameters();
+
+  arma::mat gradient, checkpointGradient;
+  model.Gradient(model.Parameters(), 0, gradient, 64);
+
+  // The second time, the segments are balanced with the measured sizes.
+  for (const size_t segments : { 0, 2, 3, 6, 3, 0 })
+  {
+    model.CheckpointSegments() = segments;
+    model.Gradient(model.Parameters(), 0, checkpointGradient, 64);
+    CheckMatrices(gradient, checkpointGradient);
+  }
+
+  // Another batch, after which the prediction still works.
+  model.CheckpointSegments() = 1;
+  model.Gradient(model.Parameters(), 5, gradient, 3);
+  model.CheckpointSegments() = 3;
+  model.Gradient(model.Parameters(), 5, checkpointGradient, 3);
+  CheckMatrices(gradient, checkpointGradient);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_cols, 64);
+}
+
+/**
+ * Make sure that the recomputed segments replay the forward pass of layers
+ * with state: the gradient is the same as without checkpointing over several
+ * batches, Dropout applies the same masks, the running statistics of
+ * BatchNorm are updated once, and MaxPooling keeps no offsets.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointStatefulGradientTest)
+{
+  arma::mat data, labels;
+  TwoClassData(64, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model(data, labels),
+      checkpointModel(data, labels);
+  AddStatefulLayers(model);
+  AddStatefulLayers(checkpointModel);
+  model.ResetParameters();
+  checkpointModel.ResetParameters();
+  checkpointModel.Parameters() = model.Parameters();
+
+  // Size the layers with a first pass.
+  arma::mat gradient, checkpointGradient;
+  math::RandomSeed(1);
+  model.Gradient(model.Parameters(), 0, gradient, 32);
+  math::RandomSeed(1);
+  checkpointModel.Gradient(checkpointModel.Parameters(), 0, gradient, 32);
+
+  size_t step = 2;
+  for (const size_t segments : { 2, 3, 0, 9 })
+  {
+    checkpointModel.CheckpointSegments() = segments;
+    for (const size_t begin : { 0, 16, 32 })
+    {
+      math::RandomSeed(step);
+      model.Gradient(model.Parameters(), begin, gradient, 32);
+      math::RandomSeed(step++);
+      checkpointModel.Gradient(checkpointModel.Parameters(), begin,
+          checkpointGradient, 32);
+      CheckMatrices(gradient, checkpointGradient);
+      CheckStatefulLayers(checkpointModel, model);
+    }
+  }
+}
+
+/**
+ * Make sure that the sparse gradient of a network with a Lookup layer is the
+ * same as the dense one, and that SGD with sparse gradients only changes the
+ * embeddings of the words that were used.
+ */
+BOOST_AUTO_TEST_CASE(SparseGradientTest)
+{
+  // Each point is one of the first five words of a vocabulary of 100 words.
+  arma::mat data(1, 64);
+  arma::mat labels(1, 64);
+  for (size_t i = 0; i < 64; ++i)
+  {
+    data(0, i) = 1 + (i % 5);
+    labels(0, i) = 1 + (i % 3);
+  }
+
+  FFN<NegativeLogLikelihood<> > model(data, labels);
+  model.Add<Lookup<> >(100, 4);
+  model.Add<Linear<> >(4, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat gradient;
+  arma::sp_mat sparseGradient;
+  model.Gradient(model.Parameters(), 0, gradient, 64);
+  model.Gradient(model.Parameters(), 0, sparseGradient, 64);
+  CheckMatrices(gradient, arma::mat(sparseGradient));
+
+  // Only the five used embeddings and the Linear layer are stored.
+  BOOST_REQUIRE_LE(sparseGradient.n_nonzero, 5 * 4 + 4 * 3 + 3);
+
+  // A batch with other words must not see the gradient of the last one.
+  model.Gradient(model.Parameters(), 3, gradient, 2);
+  model.Gradient(model.Parameters(), 3, sparseGradient, 2);
+  CheckMatrices(gradient, arma::mat(sparseGradient));
+
+  const arma::mat usedEmbeddings = model.Parameters().rows(0, 5 * 4 - 1);
+  const arma::mat unusedEmbeddings = model.Parameters().rows(5 * 4, 399);
+  model.SparseGradients() = true;
+  StandardSGD optimizer(0.01, 8, 640);
+  model.Train(data, labels, optimizer);
+
+  CheckMatrices(unusedEmbeddings, model.Parameters().rows(5 * 4, 399));
+  BOOST_REQUIRE_GT(arma::norm(model.Parameters().rows(0, 5 * 4 - 1) -
+      usedEmbeddings), 0.0);
+}
+
+/**
+ * Make sure that the static network computes the same predictions and
+ * gradients as the equivalent FFN, and that it can be trained and serialized.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNTest)
+{
+  arma::mat data, labels;
+  TwoClassData(10, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model;
+  AddDenseLayers(model, { 10, 8, 2 });
+  model.ResetParameters();
+
+  typedef StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<> > StaticNetworkType;
+  StaticNetworkType staticModel(Linear<>(10, 8), SigmoidLayer<>(),
+      Linear<>(8, 2), LogSoftMax<>());
+  staticModel.Import(model);
+  CheckMatrices(model.Parameters(), staticModel.Parameters());
+
+  arma::mat predictions, staticPredictions;
+  model.Predict(data, predictions, 16);
+  staticModel.Predict(data, staticPredictions, 16);
+  CheckMatrices(predictions, staticPredictions);
+
+  arma::mat output, gradient, staticOutput, staticGradient;
+  model.Forward(data, output);
+  const double error = model.Backward(labels, gradient);
+  staticModel.Forward(data, staticOutput);
+  const double staticError = staticModel.Backward(labels, staticGradient);
+  CheckMatrices(output, staticOutput);
+  CheckMatrices(gradient, staticGradient);
+  BOOST_REQUIRE_CLOSE(error, staticError, 1e-5);
+
+  // Copies of the network use their own parameters.
+  StaticNetworkType copiedModel(staticModel);
+  copiedModel.Parameters().zeros();
+  staticModel.Predict(data, staticPredictions, 16);
+  CheckMatrices(predictions, staticPredictions);
+
+  // Training reduces the objective.
+  RMSProp opt(0.01, 16, 0.88, 1e-8, 20 * data.n_cols, -1);
+  staticModel.Train(data, labels, opt);
+  BOOST_REQUIRE_LT(staticModel.Evaluate(staticModel.Parameters()),
+      staticError);
+
+  // Serialize the trained network.
+  StaticNetworkType xmlModel(Linear<>(10, 8), SigmoidLayer<>(),
+      Linear<>(8, 2), LogSoftMax<>());
+  StaticNetworkType textModel(xmlModel), binaryModel(xmlModel);
+  SerializeObjectAll(staticModel, xmlModel, textModel, binaryModel);
+
+  arma::mat xmlPredictions, textPredictions, binaryPredictions;
+  staticModel.Predict(data, staticPredictions);
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+  CheckMatrices(staticPredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that a static network can be exported to an FFN, and that the
+ * archives of a static network and of the equivalent FFN can be loaded by
+ * either class.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNArchiveTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 64);
+
+  typedef StaticFFN<NegativeLogLikelihood<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, LogSoftMax<> > StaticNetworkType;
+  StaticNetworkType staticModel(Linear<>(10, 8), SigmoidLayer<>(),
+      Linear<>(8, 2), LogSoftMax<>());
+  staticModel.ResetParameters();
+
+  arma::mat staticPredictions;
+  staticModel.Predict(data, staticPredictions);
+
+  FFN<NegativeLogLikelihood<> > exportedModel;
+  staticModel.Export(exportedModel);
+  CheckMatrices(staticModel.Parameters(), exportedModel.Parameters());
+
+  arma::mat predictions;
+  exportedModel.Predict(data, predictions);
+  CheckMatrices(staticPredictions, predictions);
+
+  // The static network saves an FFN archive.
+  FFN<NegativeLogLikelihood<> > model;
+  data::Save("static_ffn.xml", "model", staticModel);
+  data::Load("static_ffn.xml", "model", model);
+  CheckMatrices(staticModel.Parameters(), model.Parameters());
+  model.Predict(data, predictions);
+  CheckMatrices(staticPredictions, predictions);
+
+  // And it loads one.
+  model.Parameters() *= 0.5;
+  model.Predict(data, predictions);
+  data::Save("static_ffn.bin", "model", model);
+
+  StaticNetworkType loadedModel(Linear<>(10, 8), SigmoidLayer<>(),
+      Linear<>(8, 2), LogSoftMax<>());
+  data::Load("static_ffn.bin", "model", loadedModel);
+  CheckMatrices(model.Parameters(), loadedModel.Parameters());
+  loadedModel.Predict(data, staticPredictions);
+  CheckMatrices(predictions, staticPredictions);
+
+  remove("static_ffn.xml");
+  remove("static_ffn.bin");
+}
+
+/**
+ * Make sure that a single-precision static network computes the same outputs
+ * and gradients as the double-precision one, and that it can be trained and
+ * serialized in single precision.
+ */
+BOOST_AUTO_TEST_CASE(FloatStaticFFNTest)
+{
+  typedef StaticFFN<MeanSquaredError<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<> > NetworkType;
+  typedef StaticFFN<MeanSquaredError<arma::fmat, arma::fmat>,
+      RandomInitialization, Linear<arma::fmat, arma::fmat>,
+      SigmoidLayer<LogisticFunction, arma::fmat, arma::fmat>,
+      Linear<arma::fmat, arma::fmat> > FloatNetworkType;
+  BOOST_REQUIRE((std::is_same<FloatNetworkType::MatType, arma::fmat>::value));
+
+  arma::fmat data = arma::randu<arma::fmat>(10, 64);
+  arma::fmat responses = arma::sum(data.rows(0, 2)) / 3;
+
+  NetworkType model(Linear<>(10, 8), SigmoidLayer<>(), Linear<>(8, 1));
+  FloatNetworkType floatModel(Linear<arma::fmat, arma::fmat>(10, 8),
+      SigmoidLayer<LogisticFunction, arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(8, 1));
+  model.ResetParameters();
+  floatModel.ResetParameters();
+  floatModel.Parameters() = arma::conv_to<arma::fmat>::from(
+      model.Parameters());
+
+  arma::mat output, gradient;
+  model.Forward(arma::conv_to<arma::mat>::from(data), output);
+  const double error = model.Backward(
+      arma::conv_to<arma::mat>::from(responses), gradient);
+
+  arma::fmat floatOutput, floatGradient;
+  floatModel.Forward(data, floatOutput);
+  const double floatError = floatModel.Backward(responses, floatGradient);
+
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(floatOutput), 1e-2);
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(floatGradient), 1e-2);
+  BOOST_REQUIRE_CLOSE(error, floatError, 1e-2);
+
+  // Training in single precision reduces the objective.
+  const double initialObjective = floatModel.Evaluate(floatModel.Parameters());
+  StandardSGD opt(0.1, 8, 50 * data.n_cols, -1);
+  floatModel.Train(data, responses, opt);
+  BOOST_REQUIRE_LT(floatModel.Evaluate(floatModel.Parameters()),
+      initialObjective);
+
+  // So does Adam, which keeps its moments in double precision.
+  FloatNetworkType adamModel(floatModel);
+  Adam adam(0.01, 8, 0.9, 0.999, 1e-8, 10 * data.n_cols, -1);
+  const double trainedObjective = adamModel.Evaluate(adamModel.Parameters());
+  adamModel.Train(data, responses, adam);
+  BOOST_REQUIRE_LT(adamModel.Evaluate(adamModel.Parameters()),
+      trainedObjective);
+
+  // Serialize the trained network; the parameters stay in single precision.
+  FloatNetworkType xmlModel(Linear<arma::fmat, arma::fmat>(10, 8),
+      SigmoidLayer<LogisticFunction, arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(8, 1));
+  FloatNetworkType textModel(xmlModel), binaryModel(xmlModel);
+  SerializeObjectAll(floatModel, xmlModel, textModel, binaryModel);
+
+  arma::fmat predictions, xmlPredictions, textPredictions, binaryPredictions;
+  floatModel.Predict(data, predictions);
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+  CheckMatrices(arma::conv_to<arma::mat>::from(predictions),
+      arma::conv_to<arma::mat>::from(xmlPredictions),
+      arma::conv_to<arma::mat>::from(textPredictions),
+      arma::conv_to<arma::mat>::from(binaryPredictions));
+}
+
+/**
+ * Make sure the fused network predicts the same as the original network, and
+ * that the foldable layers are gone.
+ */
+BOOST_AUTO_TEST_CASE(FuseTest)
+{
+  arma::mat data, labels;
+  TwoClassData(10, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<BatchNorm<> >(8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >(0.2, false);
+  model.Add<LinearNoBias<> >(8, 6);
+  model.Add<Dropout<> >(0.3);
+  model.Add<MultiplyConstant<> >(0.5);
+  model.Add<BatchNorm<> >(6);
+  model.Add<SigmoidLayer<> >();
+  model.Add<BatchNorm<> >(6);
+  model.Add<DropConnect<> >(6, 2);
+  model.Add<LogSoftMax<> >();
+
+  // Train a little, so that the BatchNorm layers collect statistics.
+  RMSProp opt(0.01, 16, 0.88, 1e-8, 2 * data.n_cols, -1);
+  model.Train(data, labels, opt);
+
+  FFN<NegativeLogLikelihood<> > fusedModel;
+  model.Fuse(fusedModel);
+
+  // Linear, SigmoidLayer, Linear, SigmoidLayer, BatchNorm, Linear, LogSoftMax.
+  BOOST_REQUIRE_EQUAL(fusedModel.Model().size(), 7);
+  BOOST_REQUIRE_LT(fusedModel.Parameters().n_elem,
+      model.Parameters().n_elem);
+
+  arma::mat predictions, fusedPredictions;
+  model.Predict(data, predictions);
+  fusedModel.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions);
+}
+
+/**
+ * Make sure that the layers of a convolutional network that can't be folded
+ * (Convolution, the BatchNorm layer after it, MaxPooling and a rescaling
+ * Dropout layer after it) are copied with their state, so that the fused
+ * network predicts the same as the original network.
+ */
+BOOST_AUTO_TEST_CASE(FuseStatefulTest)
+{
+  arma::mat data, labels;
+  TwoClassData(8 * 8, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Convolution<> >(1, 2, 3, 3, 1, 1, 1, 1, 8, 8);
+  model.Add<BatchNorm<> >(128);
+  model.Add<ReLULayer<> >();
+  model.Add<MaxPooling<> >(2, 2, 2, 2);
+  model.Add<Dropout<> >(0.3);
+  model.Add<Linear<> >(32, 8);
+  model.Add<BatchNorm<> >(8);
+  model.Add<Dropout<> >(0.2);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 2);
+  model.Add<LogSoftMax<> >();
+
+  RMSProp opt(0.01, 16, 0.88, 1e-8, 2 * data.n_cols, -1);
+  model.Train(data, labels, opt);
+
+  FFN<NegativeLogLikelihood<> > fusedModel;
+  model.Fuse(fusedModel);
+
+  // Only the BatchNorm and Dropout layers after the first Linear layer are
+  // folded.
+  BOOST_REQUIRE_EQUAL(fusedModel.Model().size(), 9);
+  BOOST_REQUIRE(boost::get<BatchNorm<>*>(&fusedModel.Model()[1]));
+  BOOST_REQUIRE(boost::get<MaxPooling<>*>(&fusedModel.Model()[3]));
+
+  arma::mat predictions, fusedPredictions;
+  model.Predict(data, predictions);
+  fusedModel.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions);
+}
+
+/**
+ * Make sure that the 8-bit quantized version of a trained convolutional network
+ * predicts (nearly) the same as the network itself.
+ */
+BOOST_AUTO_TEST_CASE(QuantizeTest)
+{
+  arma::mat data, labels;
+  TwoClassData(8 * 8, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Convolution<> >(1, 2, 3, 3, 1, 1, 1, 1, 8, 8);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(2 * 8 * 8, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<LinearNoBias<> >(8, 2);
+  model.Add<LogSoftMax<> >();
+
+  RMSProp opt(0.01, 16, 0.88, 1e-8, 2 * data.n_cols, -1);
+  model.Train(data, labels, opt);
+
+  FFN<NegativeLogLikelihood<> > quantizedModel;
+  model.Quantize(data, quantizedModel);
+
+  BOOST_REQUIRE_EQUAL(quantizedModel.Model().size(), 6);
+  BOOST_REQUIRE_EQUAL(quantizedModel.Parameters().n_elem, 0);
+
+  arma::mat predictions, quantizedPredictions;
+  model.Predict(data, predictions);
+  quantizedModel.Predict(data, quantizedPredictions);
+  BOOST_REQUIRE_LT(arma::abs(arma::exp(predictions) -
+      arma::exp(quantizedPredictions)).max(), 0.05);
+}
+
+/**
+ * Make sure that the layers with state between the quantized layers
+ * (BatchNorm, MaxPooling and Dropout) are copied with their state, so that the
+ * quantized network still predicts (nearly) the same as the network itself.
+ */
+BOOST_AUTO_TEST_CASE(QuantizeStatefulTest)
+{
+  arma::mat data, labels;
+  TwoClassData(8 * 8, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model;
+  AddStatefulLayers(model);
+
+  RMSProp opt(0.01, 16, 0.88, 1e-8, 2 * data.n_cols, -1);
+  model.Train(data, labels, opt);
+
+  FFN<NegativeLogLikelihood<> > quantizedModel;
+  model.Quantize(data, quantizedModel);
+
+  // Only the BatchNorm layer keeps its parameters.
+  BOOST_REQUIRE_EQUAL(quantizedModel.Model().size(), 9);
+  BOOST_REQUIRE_EQUAL(quantizedModel.Parameters().n_elem, 2 * 128);
+  BatchNorm<>& batchNorm = *boost::get<BatchNorm<>*>(model.Model()[1]);
+  BatchNorm<>& quantizedBatchNorm =
+      *boost::get<BatchNorm<>*>(quantizedModel.Model()[1]);
+  CheckMatrices(batchNorm.TrainingMean(), quantizedBatchNorm.TrainingMean());
+  CheckMatrices(batchNorm.TrainingVariance(),
+      quantizedBatchNorm.TrainingVariance());
+
+  arma::mat predictions, quantizedPredictions;
+  model.Predict(data, predictions);
+  quantizedModel.Predict(data, quantizedPredictions);
+  BOOST_REQUIRE_LT(arma::abs(arma::exp(predictions) -
+      arma::exp(quantizedPredictions)).max(), 0.05);
+}
+
+/**
+ * Make sure that the emulated mixed precision gradient is close to the full
+ * precision one, that the loss scale follows overflows, and that SGD skips the
+ * steps whose gradient overflowed.
+ */
+BOOST_AUTO_TEST_CASE(EmulatedPrecisionGradientTest)
+{
+  arma::mat data, labels;
+  TwoClassData(10, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model(data, labels);
+  AddDenseLayers(model, { 10, 8, 2 });
+  model.ResetParameters();
+
+  arma::mat gradient, mixedGradient;
+  model.Gradient(model.Parameters(), 0, gradient, 64);
+  const arma::mat parameters = model.Parameters();
+
+  const PrecisionType precisions[2] = { BFLOAT16_PRECISION, HALF_PRECISION };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    model.EmulatedPrecision() = precisions[i];
+    model.Gradient(model.Parameters(), 0, mixedGradient, 64);
+    BOOST_REQUIRE_LE(arma::norm(mixedGradient - gradient), 0.05 *
+        arma::norm(gradient));
+
+    // The master weights are not rounded.
+    BOOST_REQUIRE_EQUAL(arma::accu(model.Parameters() != parameters), 0);
+  }
+
+  // A scale that makes the half precision errors overflow is halved.
+  model.LossScale() = 1e30;
+  model.Gradient(model.Parameters(), 0, mixedGradient, 64);
+  BOOST_REQUIRE(!mixedGradient.is_finite());
+  BOOST_REQUIRE_CLOSE(model.LossScale(), 5e29, 1e-5);
+
+  // And a scale that works is doubled after the window.
+  model.LossScale() = 256.0;
+  model.LossScaleWindow() = 2;
+  model.Gradient(model.Parameters(), 0, mixedGradient, 64);
+  BOOST_REQUIRE_CLOSE(model.LossScale(), 256.0, 1e-5);
+  model.Gradient(model.Parameters(), 0, mixedGradient, 64);
+  BOOST_REQUIRE_CLOSE(model.LossScale(), 512.0, 1e-5);
+
+  // Start with a scale that overflows; the first steps are skipped until the
+  // scale is low enough, and then the network learns.
+  model.LossScale() = 1e10;
+  model.LossScaleWindow() = 2000;
+  const double objective = model.Evaluate(model.Parameters());
+  SGD<SkipNonFiniteUpdate<VanillaUpdate> > sgd(0.1, 8, 64 * 50, -1);
+  model.Train(data, labels, sgd);
+  BOOST_REQUIRE_GT(sgd.UpdatePolicy().Skipped(), 0);
+  BOOST_REQUIRE_LT(sgd.UpdatePolicy().Skipped(), 64 * 50 / 8);
+  BOOST_REQUIRE(model.Parameters().is_finite());
+  BOOST_REQUIRE_LT(model.Evaluate(model.Parameters()), objective);
+}
+
+/**
+ * Make sure that the pass that sizes the layers before the first emulated
+ * mixed precision gradient is replayed by the rounded pass: Dropout applies
+ * the same masks as in full precision, BatchNorm adds every batch to its
+ * running statistics once, and MaxPooling keeps no offsets.
+ */
+BOOST_AUTO_TEST_CASE(EmulatedPrecisionStatefulGradientTest)
+{
+  arma::mat data, labels;
+  TwoClassData(64, data, labels);
+
+  FFN<NegativeLogLikelihood<> > model(data, labels),
+      emulatedModel(data, labels);
+  AddStatefulLayers(model);
+  AddStatefulLayers(emulatedModel);
+  model.ResetParameters();
+  emulatedModel.ResetParameters();
+  emulatedModel.Parameters() = model.Parameters();
+  emulatedModel.EmulatedPrecision() = BFLOAT16_PRECISION;
+
+  arma::mat gradient, emulatedGradient;
+  for (size_t step = 0; step < 3; ++step)
+  {
+    math::RandomSeed(step + 1);
+    model.Gradient(model.Parameters(), 16 * step, gradient, 32);
+    math::RandomSeed(step + 1);
+    emulatedModel.Gradient(emulatedModel.Parameters(), 16 * step,
+        emulatedGradient, 32);
+    BOOST_REQUIRE_LE(arma::norm(emulatedGradient - gradient), 0.05 *
+        arma::norm(gradient));
+
+    const BatchNorm<>& batchNorm =
+        *boost::get<BatchNorm<>*>(emulatedModel.Model()[1]);
+    BOOST_REQUIRE_EQUAL(batchNorm.Stats().count(), 32 * (step + 1));
+    BOOST_REQUIRE_EQUAL(boost::get<MaxPooling<>*>(emulatedModel.Model()[3])->
+        PendingPasses(), 0);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,197 @@
+/**
+ * @file flat_tree_test.cpp
+ *
+ * Tests for the FlatTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/flat_tree.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/ns_model.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::metric;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(FlatTreeTest);
+
+/**
+ * Make sure the given results are the same as the baseline results.
+ */
+void CheckResults(const arma::Mat<size_t>& neighbors,
+                  const arma::mat& distances,
+                  const arma::Mat<size_t>& baselineNeighbors,
+                  const arma::mat& baselineDistances)
+{
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, baselineNeighbors.n_rows);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, baselineNeighbors.n_cols);
+  BOOST_REQUIRE_EQUAL(distances.n_rows, baselineDistances.n_rows);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, baselineDistances.n_cols);
+
+  for (size_t i = 0; i < distances.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], baselineNeighbors[i]);
+    if (std::abs(baselineDistances[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(distances[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(distances[i], baselineDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that a flattened kd-tree finds the same neighbors as naive search.
+ */
+BOOST_AUTO_TEST_CASE(KDTreeSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  std::vector<size_t> oldFromNew;
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(referenceData,
+      oldFromNew, 10);
+  FlatTree<>::Save(tree, "flat_tree_test.bin", oldFromNew);
+
+  FlatTree<> flatTree("flat_tree_test.bin");
+  BOOST_REQUIRE_EQUAL(flatTree.Dataset().n_rows, 3);
+  BOOST_REQUIRE_EQUAL(flatTree.Dataset().n_cols, 1000);
+  BOOST_REQUIRE_EQUAL(flatTree.GetNode(0).count, 1000);
+
+  // Every stored point must map back to the original dataset.
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    for (size_t d = 0; d < 3; ++d)
+    {
+      BOOST_REQUIRE_EQUAL(flatTree.Dataset()(d, i),
+          referenceData(d, flatTree.OldFromNew(i)));
+    }
+  }
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, baselineNeighbors;
+  arma::mat distances, baselineDistances;
+
+  // Bichromatic search.
+  knn.Search(queryData, 5, baselineNeighbors, baselineDistances);
+  flatTree.Search(queryData, 5, neighbors, distances);
+  CheckResults(neighbors, distances, baselineNeighbors, baselineDistances);
+
+  // Monochromatic search.
+  knn.Search(5, baselineNeighbors, baselineDistances);
+  flatTree.Search(5, neighbors, distances);
+  CheckResults(neighbors, distances, baselineNeighbors, baselineDistances);
+
+  remove("flat_tree_test.bin");
+}
+
+/**
+ * A cover tree holds points in internal nodes too and does not rearrange the
+ * dataset; make sure it is flattened correctly.
+ */
+BOOST_AUTO_TEST_CASE(CoverTreeSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 500);
+  arma::mat queryData = arma::randu<arma::mat>(4, 100);
+
+  StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      tree(referenceData);
+  FlatTree<>::Save(tree, "flat_tree_test.bin");
+
+  FlatTree<> flatTree("flat_tree_test.bin");
+  BOOST_REQUIRE_EQUAL(flatTree.GetNode(0).count, 500);
+
+  KNN knn(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, baselineNeighbors;
+  arma::mat distances, baselineDistances;
+
+  knn.Search(queryData, 3, baselineNeighbors, baselineDistances);
+  flatTree.Search(queryData, 3, neighbors, distances);
+  CheckResults(neighbors, distances, baselineNeighbors, baselineDistances);
+
+  knn.Search(3, baselineNeighbors, baselineDistances);
+  flatTree.Search(3, neighbors, distances);
+  CheckResults(neighbors, distances, baselineNeighbors, baselineDistances);
+
+  remove("flat_tree_test.bin");
+}
+
+/**
+ * Make sure that the flat tree saved from a kNN model gives the same results as
+ * the model.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelFlatTreeTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat referenceData = arma::randu<arma::mat>(5, 300);
+  arma::mat queryData = arma::randu<arma::mat>(5, 50);
+
+  KNNModel::TreeTypes treeTypes[] = { KNNModel::TreeTypes::KD_TREE,
+      KNNModel::TreeTypes::COVER_TREE, KNNModel::TreeTypes::BALL_TREE,
+      KNNModel::TreeTypes::R_TREE, KNNModel::TreeTypes::OCTREE };
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    KNNModel model(treeTypes[i], false);
+    arma::mat referenceCopy(referenceData);
+    model.BuildModel(std::move(referenceCopy), 20, DUAL_TREE_MODE);
+    model.SaveFlatTree("flat_tree_test.bin");
+
+    arma::Mat<size_t> neighbors, baselineNeighbors;
+    arma::mat distances, baselineDistances;
+    arma::mat queryCopy(queryData);
+    model.Search(std::move(queryCopy), 4, baselineNeighbors,
+        baselineDistances);
+
+    FlatTree<> flatTree("flat_tree_test.bin");
+    flatTree.Search(queryData, 4, neighbors, distances);
+    CheckResults(neighbors, distances, baselineNeighbors, baselineDistances);
+  }
+
+  // A model with naive search has no tree to save.
+  KNNModel naiveModel(KNNModel::TreeTypes::KD_TREE, false);
+  arma::mat referenceCopy(referenceData);
+  naiveModel.BuildModel(std::move(referenceCopy), 20, NAIVE_MODE);
+  BOOST_REQUIRE_THROW(naiveModel.SaveFlatTree("flat_tree_test.bin"),
+      std::invalid_argument);
+
+  remove("flat_tree_test.bin");
+}
+
+/**
+ * Make sure that invalid files are rejected.
+ */
+BOOST_AUTO_TEST_CASE(InvalidFileTest)
+{
+  Log::Fatal.ignoreInput = true;
+
+  BOOST_REQUIRE_THROW(FlatTree<> t("flat_tree_missing.bin"),
+      std::runtime_error);
+
+  // A file that is not a flat tree.
+  std::ofstream f("flat_tree_test.bin");
+  f << "this is not a flat tree, but it is long enough to hold a header.";
+  f.close();
+  BOOST_REQUIRE_THROW(FlatTree<> t("flat_tree_test.bin"), std::runtime_error);
+
+  // A flat tree with the wrong element type.
+  arma::mat data = arma::randu<arma::mat>(2, 50);
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(data);
+  FlatTree<>::Save(tree, "flat_tree_test.bin");
+  BOOST_REQUIRE_THROW((FlatTree<EuclideanDistance, float>(
+      "flat_tree_test.bin")), std::runtime_error);
+
+  Log::Fatal.ignoreInput = false;
+  remove("flat_tree_test.bin");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -18,9 +18,11 @@
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
 #include <mlpack/methods/gmm/diagonal_constraint.hpp>
 #include <mlpack/methods/gmm/eigenvalue_ratio_constraint.hpp>
+#include <mlpack/methods/gmm/tree_em_fit.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
 
 using namespace mlpack;
 using namespace mlpack::gmm;
@@ -78,6 +80,43 @@ BOOST_AUTO_TEST_CASE(GMMProbabilityComponentTest)
   BOOST_REQUIRE_CLOSE(gmm.Probability("1.4 0", 1), 0.0067568972024, 1e-5);
 }
 
+/**
+ * Test the batch GMM::LogProbability() and GMM::Probability() against the
+ * probability of each observation, and far from the components.
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchLogProbabilityTest)
+{
+  // Create a GMM (same as the last test).
+  GMM gmm(2, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("3 3", "2 1; 1 2");
+  gmm.Weights() = "0.3 0.7";
+
+  const arma::mat observations("0 1 2 3 -1 1.4; 0 1 2 3 5.3 0");
+  arma::vec logProbabilities, probabilities;
+  gmm.LogProbability(observations, logProbabilities);
+  gmm.Probability(observations, probabilities);
+
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, 6);
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, 6);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    const double probability = gmm.Probability(observations.col(i));
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], std::log(probability), 1e-5);
+    BOOST_REQUIRE_CLOSE(probabilities[i], probability, 1e-5);
+  }
+
+  // Far from both components, the probability underflows, but the
+  // log-probability is still that of the closest component.
+  arma::vec far("200 200");
+  gmm.LogProbability(far, logProbabilities);
+  arma::vec componentLogProbabilities;
+  gmm.Component(1).LogProbability(far, componentLogProbabilities);
+  BOOST_REQUIRE_EQUAL(gmm.Probability(far), 0.0);
+  BOOST_REQUIRE_CLOSE(logProbabilities[0], std::log(0.7) +
+      componentLogProbabilities[0], 1e-5);
+}
+
 /**
  * Test training a model on only one Gaussian (randomly generated) in two
  * dimensions.  We will vary the dataset size from small to large.  The EM
@@ -856,4 +895,329 @@ BOOST_AUTO_TEST_CASE(DiagonalGMMTrainTest)
   }
 }
 
+/**
+ * A covariance constraint that is the same as the DiagonalConstraint, but that
+ * EMFit does not recognize, so that the general EM iterations are used.
+ */
+class GeneralDiagonalConstraint
+{
+ public:
+  static void ApplyConstraint(arma::mat& covariance)
+  {
+    DiagonalConstraint::ApplyConstraint(covariance);
+  }
+
+  template<typename Archive>
+  static void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+};
+
+/**
+ * Make sure that the diagonal EM iterations, which never factor a covariance
+ * matrix, give the same model as the general iterations with a diagonal
+ * constraint, when the points are given probabilities.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalEMFitTest)
+{
+  distribution::GaussianDistribution d1("0.0 1.0 0.0", "1.0 0.0 0.0;"
+                                                       "0.0 0.8 0.0;"
+                                                       "0.0 0.0 1.0");
+  distribution::GaussianDistribution d2("4.0 -1.0 5.0", "3.0 0.0 0.0;"
+                                                        "0.0 1.2 0.0;"
+                                                        "0.0 0.0 1.3");
+
+  // Use more than one block of points.
+  arma::mat points(3, 3000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    points.col(i) = (i % 3 == 0) ? d1.Random() : d2.Random();
+
+  arma::vec probabilities;
+  probabilities.randu(points.n_cols);
+
+  // Start both fits from the same model.
+  std::vector<distribution::GaussianDistribution> dists(2);
+  dists[0] = distribution::GaussianDistribution("1.0 0.0 1.0",
+      "2.0 0.0 0.0; 0.0 2.0 0.0; 0.0 0.0 2.0");
+  dists[1] = distribution::GaussianDistribution("3.0 0.0 4.0",
+      "2.0 0.0 0.0; 0.0 2.0 0.0; 0.0 0.0 2.0");
+  arma::vec weights("0.5 0.5");
+
+  std::vector<distribution::GaussianDistribution> generalDists(dists);
+  arma::vec generalWeights(weights);
+
+  EMFit<kmeans::KMeans<>, DiagonalConstraint> fitter(20, 0.0);
+  fitter.Estimate(points, probabilities, dists, weights, true);
+
+  EMFit<kmeans::KMeans<>, GeneralDiagonalConstraint> generalFitter(20, 0.0);
+  generalFitter.Estimate(points, probabilities, generalDists, generalWeights,
+      true);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(weights[i], generalWeights[i], 1e-5);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(dists[i].Mean()[j], generalDists[i].Mean()[j],
+          1e-5);
+      for (size_t k = 0; k < 3; ++k)
+      {
+        if (j == k)
+          BOOST_REQUIRE_CLOSE(dists[i].Covariance()(j, k),
+              generalDists[i].Covariance()(j, k), 1e-5);
+        else
+          BOOST_REQUIRE_SMALL(dists[i].Covariance()(j, k), 1e-50);
+      }
+    }
+  }
+
+  // The means should be close to the true means.
+  const size_t first = (dists[0].Mean()[0] < dists[1].Mean()[0]) ? 0 : 1;
+  for (size_t j = 0; j < 3; ++j)
+  {
+    BOOST_REQUIRE_SMALL(dists[first].Mean()[j] - d1.Mean()[j], 0.3);
+    BOOST_REQUIRE_SMALL(dists[1 - first].Mean()[j] - d2.Mean()[j], 0.3);
+  }
+}
+
+/**
+ * Make sure that a GMM updated with stepwise EM from a loader finds the
+ * mixture, and that a checkpointed fit resumes exactly.
+ */
+BOOST_AUTO_TEST_CASE(OnlineEMFitUpdateTest)
+{
+  distribution::GaussianDistribution d1("0.0 1.0", "1.0 0.3; 0.3 0.8");
+  distribution::GaussianDistribution d2("6.0 -4.0", "1.5 0.0; 0.0 0.6");
+
+  // The loader gives 30 chunks of 500 points, 30% of which are from d1.
+  size_t chunksLeft = 30;
+  auto loader = [&](arma::mat& chunk)
+  {
+    if (chunksLeft == 0)
+      return false;
+
+    chunk.set_size(2, 500);
+    for (size_t i = 0; i < chunk.n_cols; ++i)
+      chunk.col(i) = (math::Random() < 0.3) ? d1.Random() : d2.Random();
+    --chunksLeft;
+    return true;
+  };
+
+  GMM gmm(2, 2);
+  OnlineEMFit<> fitter;
+  BOOST_REQUIRE_EQUAL(gmm.Update(loader, fitter), 30);
+  BOOST_REQUIRE_EQUAL(fitter.Steps(), 29);
+
+  const size_t first = (gmm.Component(0).Mean()[0] <
+      gmm.Component(1).Mean()[0]) ? 0 : 1;
+  BOOST_REQUIRE_SMALL(gmm.Weights()[first] - 0.3, 0.05);
+  for (size_t j = 0; j < 2; ++j)
+  {
+    BOOST_REQUIRE_SMALL(gmm.Component(first).Mean()[j] - d1.Mean()[j], 0.2);
+    BOOST_REQUIRE_SMALL(gmm.Component(1 - first).Mean()[j] - d2.Mean()[j],
+        0.2);
+    for (size_t k = 0; k < 2; ++k)
+    {
+      BOOST_REQUIRE_SMALL(gmm.Component(first).Covariance()(j, k) -
+          d1.Covariance()(j, k), 0.3);
+      BOOST_REQUIRE_SMALL(gmm.Component(1 - first).Covariance()(j, k) -
+          d2.Covariance()(j, k), 0.3);
+    }
+  }
+
+  // Checkpoint the fit, then give the same chunks to both fits.
+  GMM resumedGMM;
+  OnlineEMFit<> resumedFitter(0.8);
+  SerializeObject<GMM, boost::archive::binary_iarchive,
+      boost::archive::binary_oarchive>(gmm, resumedGMM);
+  SerializeObject<OnlineEMFit<>, boost::archive::binary_iarchive,
+      boost::archive::binary_oarchive>(fitter, resumedFitter);
+  BOOST_REQUIRE_EQUAL(resumedFitter.Steps(), fitter.Steps());
+  BOOST_REQUIRE_CLOSE(resumedFitter.StepDecay(), fitter.StepDecay(), 1e-10);
+
+  for (size_t c = 0; c < 5; ++c)
+  {
+    arma::mat chunk;
+    chunksLeft = 1;
+    loader(chunk);
+
+    size_t chunks = 1;
+    auto chunkLoader = [&](arma::mat& out)
+    {
+      if (chunks == 0)
+        return false;
+      out = chunk;
+      --chunks;
+      return true;
+    };
+    gmm.Update(chunkLoader, fitter, true);
+    chunks = 1;
+    resumedGMM.Update(chunkLoader, resumedFitter, true);
+  }
+
+  BOOST_REQUIRE_EQUAL(resumedFitter.Steps(), 34);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(resumedGMM.Weights()[i], gmm.Weights()[i], 1e-8);
+    for (size_t j = 0; j < 2; ++j)
+      BOOST_REQUIRE_CLOSE(resumedGMM.Component(i).Mean()[j],
+          gmm.Component(i).Mean()[j], 1e-8);
+  }
+}
+
+/**
+ * Make sure OnlineEMFit can be used as the fitting type of GMM::Train(), with
+ * and without probabilities.
+ */
+BOOST_AUTO_TEST_CASE(OnlineEMFitTrainTest)
+{
+  distribution::GaussianDistribution d1("0.0 1.0 0.0", "1.0 0.0 0.0;"
+                                                       "0.0 0.8 0.0;"
+                                                       "0.0 0.0 1.0");
+  distribution::GaussianDistribution d2("5.0 -3.0 5.0", "3.0 0.0 0.0;"
+                                                        "0.0 1.2 0.0;"
+                                                        "0.0 0.0 1.3");
+
+  arma::mat points(3, 10000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    points.col(i) = (i % 2 == 0) ? d1.Random() : d2.Random();
+
+  arma::vec probabilities(points.n_cols);
+  probabilities.fill(0.5);
+
+  GMM gmm(2, 3), weightedGMM(2, 3);
+  gmm.Train(points, 1, false, OnlineEMFit<>(0.6, 1000, 2));
+  weightedGMM.Train(points, probabilities, 1, false,
+      OnlineEMFit<>(0.6, 1000, 2));
+
+  const GMM* models[2] = { &gmm, &weightedGMM };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    const GMM& g = *models[m];
+    const size_t first = (g.Component(0).Mean()[0] <
+        g.Component(1).Mean()[0]) ? 0 : 1;
+    BOOST_REQUIRE_SMALL(g.Weights()[first] - 0.5, 0.05);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_SMALL(g.Component(first).Mean()[j] - d1.Mean()[j], 0.2);
+      BOOST_REQUIRE_SMALL(g.Component(1 - first).Mean()[j] - d2.Mean()[j],
+          0.2);
+    }
+  }
+}
+
+/**
+ * With a responsibility tolerance of 0, nothing is pruned, and TreeEMFit gives
+ * the same model as EMFit, with or without probabilities.
+ */
+BOOST_AUTO_TEST_CASE(TreeEMFitExactTest)
+{
+  distribution::GaussianDistribution d1("0.0 1.0", "1.0 0.3; 0.3 0.8");
+  distribution::GaussianDistribution d2("3.0 -1.0", "1.5 0.0; 0.0 0.6");
+
+  arma::mat points(2, 2000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    points.col(i) = (i % 3 == 0) ? d1.Random() : d2.Random();
+  arma::vec probabilities;
+  probabilities.randu(points.n_cols);
+
+  for (size_t weighted = 0; weighted < 2; ++weighted)
+  {
+    // Start both fits from the same model; a negative tolerance runs every
+    // iteration.
+    std::vector<distribution::GaussianDistribution> dists(2);
+    dists[0] = distribution::GaussianDistribution("1.0 0.0",
+        "2.0 0.0; 0.0 2.0");
+    dists[1] = distribution::GaussianDistribution("2.0 0.0",
+        "2.0 0.0; 0.0 2.0");
+    arma::vec weights("0.5 0.5");
+    std::vector<distribution::GaussianDistribution> treeDists(dists);
+    arma::vec treeWeights(weights);
+
+    EMFit<> fitter(10, -1.0);
+    TreeEMFit<> treeFitter(10, -1.0, 0.0);
+    if (weighted)
+    {
+      fitter.Estimate(points, probabilities, dists, weights, true);
+      treeFitter.Estimate(points, probabilities, treeDists, treeWeights, true);
+    }
+    else
+    {
+      fitter.Estimate(points, dists, weights, true);
+      treeFitter.Estimate(points, treeDists, treeWeights, true);
+    }
+
+    // Every point of the 10 E-steps was handled one by one.
+    BOOST_REQUIRE_EQUAL(treeFitter.BaseCases(), 10 * points.n_cols);
+    for (size_t i = 0; i < 2; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(weights[i], treeWeights[i], 1e-5);
+      for (size_t j = 0; j < 2; ++j)
+      {
+        BOOST_REQUIRE_CLOSE(dists[i].Mean()[j], treeDists[i].Mean()[j], 1e-5);
+        for (size_t k = 0; k < 2; ++k)
+          BOOST_REQUIRE_CLOSE(dists[i].Covariance()(j, k),
+              treeDists[i].Covariance()(j, k), 1e-5);
+      }
+    }
+  }
+}
+
+/**
+ * On well separated components, most points are pruned, and the model is
+ * still found.
+ */
+BOOST_AUTO_TEST_CASE(TreeEMFitPruningTest)
+{
+  distribution::GaussianDistribution d1("0.0 1.0", "1.0 0.3; 0.3 0.8");
+  distribution::GaussianDistribution d2("8.0 -6.0", "1.5 0.0; 0.0 0.6");
+  distribution::GaussianDistribution d3("-8.0 6.0", "0.7 -0.2; -0.2 1.0");
+
+  arma::mat points(2, 30000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    points.col(i) = (i % 3 == 0) ? d1.Random() : (i % 3 == 1) ? d2.Random() :
+        d3.Random();
+  }
+
+  GMM gmm(3, 2);
+  TreeEMFit<> fitter(20, 1e-5);
+  const double likelihood = gmm.Train(points, 1, false, fitter);
+
+  GMM exactGmm(3, 2);
+  const double exactLikelihood = exactGmm.Train(points, 1, false,
+      EMFit<>(20, 1e-5));
+  BOOST_REQUIRE_CLOSE(likelihood, exactLikelihood, 0.1);
+
+  // Check that each true component was found.
+  const distribution::GaussianDistribution* truth[3] = { &d1, &d2, &d3 };
+  for (size_t t = 0; t < 3; ++t)
+  {
+    size_t closest = 0;
+    for (size_t i = 1; i < 3; ++i)
+    {
+      if (arma::norm(gmm.Component(i).Mean() - truth[t]->Mean()) <
+          arma::norm(gmm.Component(closest).Mean() - truth[t]->Mean()))
+        closest = i;
+    }
+
+    BOOST_REQUIRE_SMALL(gmm.Weights()[closest] - 1.0 / 3.0, 0.02);
+    for (size_t j = 0; j < 2; ++j)
+    {
+      BOOST_REQUIRE_SMALL(gmm.Component(closest).Mean()[j] -
+          truth[t]->Mean()[j], 0.1);
+      for (size_t k = 0; k < 2; ++k)
+        BOOST_REQUIRE_SMALL(gmm.Component(closest).Covariance()(j, k) -
+            truth[t]->Covariance()(j, k), 0.15);
+    }
+  }
+
+  // Continuing from the trained model, few points are handled one by one.
+  std::vector<distribution::GaussianDistribution> dists;
+  for (size_t i = 0; i < 3; ++i)
+    dists.push_back(gmm.Component(i));
+  arma::vec weights = gmm.Weights();
+  TreeEMFit<> continuedFitter(5, -1.0);
+  continuedFitter.Estimate(points, dists, weights, true);
+  BOOST_REQUIRE_LT(continuedFitter.BaseCases(), 5 * points.n_cols / 4);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,220 @@
+/**
+ * @file gradient_boosting_test.cpp
+ *
+ * Tests for the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+#include <mlpack/methods/decision_tree/random_dimension_select.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(GradientBoostingTest);
+
+/**
+ * Make sure that a binary problem with two well-separated Gaussians is learned,
+ * and that the probabilities make sense.
+ */
+BOOST_AUTO_TEST_CASE(BinaryLearningTest)
+{
+  arma::mat dataset(3, 1000);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    labels[i] = i % 2;
+    dataset.col(i) = arma::randn<arma::vec>(3) + 4.0 * labels[i];
+  }
+
+  GradientBoosting<> gb(50, 0.1, 3, 5);
+  gb.Train(dataset, labels, 2);
+
+  // One tree per round for two classes.
+  BOOST_REQUIRE_EQUAL(gb.NumTrees(), 50);
+  BOOST_REQUIRE_EQUAL(gb.NumClasses(), 2);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  gb.Classify(dataset, predictions, probabilities);
+
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, 1000);
+  for (size_t i = 0; i < 1000; ++i)
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+
+  const size_t correct = arma::accu(predictions == labels);
+  BOOST_REQUIRE_GE(correct, 950);
+
+  BOOST_REQUIRE_EQUAL(gb.Classify(dataset.col(1)), predictions[1]);
+}
+
+/**
+ * Make sure that the vc2 dataset (three classes) is learned well, with and
+ * without row and feature subsampling.
+ */
+BOOST_AUTO_TEST_CASE(MulticlassLearningTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  GradientBoosting<> gb(50, 0.1, 4, 5);
+  gb.Train(dataset, labels, 3);
+  BOOST_REQUIRE_EQUAL(gb.NumTrees(), 150);
+
+  arma::Row<size_t> predictions;
+  gb.Classify(testDataset, predictions);
+  BOOST_REQUIRE_GE(arma::accu(predictions == testLabels),
+      size_t(0.7 * testDataset.n_cols));
+
+  GradientBoosting<RandomDimensionSelect> sgb(50, 0.1, 4, 5, 1.0, 0.0, 0.5,
+      0.5);
+  sgb.Train(dataset, labels, 3);
+  sgb.Classify(testDataset, predictions);
+  BOOST_REQUIRE_GE(arma::accu(predictions == testLabels),
+      size_t(0.7 * testDataset.n_cols));
+}
+
+/**
+ * Make sure that early stopping stops before the maximum number of rounds when
+ * the model overfits, and that the kept model does well on the validation set.
+ */
+BOOST_AUTO_TEST_CASE(EarlyStoppingTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  // Deep trees with a large learning rate overfit quickly.
+  GradientBoosting<> gb(500, 0.5, 0, 1, 0.0);
+  gb.Train(dataset, labels, 3, testDataset, testLabels, 5);
+
+  BOOST_REQUIRE_LT(gb.NumTrees(), 1500);
+  BOOST_REQUIRE_EQUAL(gb.NumTrees() % 3, 0);
+
+  arma::Row<size_t> predictions;
+  gb.Classify(testDataset, predictions);
+  BOOST_REQUIRE_GE(arma::accu(predictions == testLabels),
+      size_t(0.7 * testDataset.n_cols));
+}
+
+/**
+ * Make sure that the trained model does not depend on the number of threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainingTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+  #endif
+
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  arma::mat probabilities[2];
+  for (size_t run = 0; run < 2; ++run)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(run == 0 ? 1 : 4);
+    #endif
+
+    math::RandomSeed(42);
+    GradientBoosting<> gb(20, 0.1, 4, 5, 1.0, 0.0, 0.8, 0.8);
+    gb.Train(dataset, labels, 3);
+
+    arma::Row<size_t> predictions;
+    gb.Classify(dataset, predictions, probabilities[run]);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  CheckMatrices(probabilities[0], probabilities[1]);
+}
+
+/**
+ * Make sure that invalid parameters and untrained models throw.
+ */
+BOOST_AUTO_TEST_CASE(InvalidParametersTest)
+{
+  arma::mat dataset(2, 10, arma::fill::randu);
+  arma::Row<size_t> labels(10, arma::fill::zeros);
+  arma::Row<size_t> predictions;
+
+  GradientBoosting<> gb;
+  BOOST_REQUIRE_THROW(gb.Classify(dataset, predictions),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(gb.Train(dataset, labels, 1), std::invalid_argument);
+  BOOST_REQUIRE_THROW(gb.Train(dataset, labels.head(5).eval(), 2),
+      std::invalid_argument);
+
+  labels[0] = 2;
+  BOOST_REQUIRE_THROW(gb.Train(dataset, labels, 2), std::invalid_argument);
+  labels[0] = 1;
+
+  gb.MaxBins() = 1000;
+  BOOST_REQUIRE_THROW(gb.Train(dataset, labels, 2), std::invalid_argument);
+  gb.MaxBins() = 256;
+  gb.SubsampleRatio() = 0.0;
+  BOOST_REQUIRE_THROW(gb.Train(dataset, labels, 2), std::invalid_argument);
+}
+
+/**
+ * Make sure that serialization works.
+ */
+BOOST_AUTO_TEST_CASE(SerializationTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  GradientBoosting<> gb(10);
+  gb.Train(dataset, labels, 3);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  gb.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  GradientBoosting<> xmlModel, textModel, binaryModel(3);
+  binaryModel.Train(dataset, labels, 3);
+  SerializeObjectAll(gb, xmlModel, textModel, binaryModel);
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
+  xmlModel.Classify(dataset, xmlPredictions, xmlProbabilities);
+  textModel.Classify(dataset, textPredictions, textProbabilities);
+  binaryModel.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(beforePredictions, xmlPredictions);
+  CheckMatrices(beforePredictions, textPredictions);
+  CheckMatrices(beforePredictions, binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities);
+  CheckMatrices(beforeProbabilities, textProbabilities);
+  CheckMatrices(beforeProbabilities, binaryProbabilities);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hmm/hmm.hpp>
+#include <mlpack/methods/hmm/streaming_decoder.hpp>
 #include <mlpack/methods/gmm/gmm.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -536,6 +537,147 @@ BOOST_AUTO_TEST_CASE(DiscreteHMMLogLikelihoodTest)
       -24.51556128368, 1e-5);
 }
 
+/**
+ * The batch versions of LogLikelihood() and Predict() must give the same
+ * results as processing each sequence separately.
+ */
+BOOST_AUTO_TEST_CASE(DiscreteHMMBatchTest)
+{
+  arma::vec initial("0.5 0.2 0.3");
+  arma::mat transition("0.5 0.0 0.1;"
+                       "0.2 0.6 0.2;"
+                       "0.3 0.4 0.7");
+  std::vector<DiscreteDistribution> emission(3);
+  emission[0].Probabilities() = "0.75 0.25 0.00 0.00";
+  emission[1].Probabilities() = "0.00 0.25 0.25 0.50";
+  emission[2].Probabilities() = "0.10 0.40 0.40 0.10";
+
+  HMM<DiscreteDistribution> hmm(initial, transition, emission);
+
+  std::vector<arma::mat> sequences(50);
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    hmm.Generate(5 + i % 7, sequences[i], states, i % 3);
+  }
+
+  arma::vec logLikelihoods;
+  hmm.LogLikelihood(sequences, logLikelihoods);
+
+  std::vector<arma::Row<size_t> > stateSeqs;
+  arma::vec viterbiLogLikelihoods;
+  hmm.Predict(sequences, stateSeqs, viterbiLogLikelihoods);
+
+  BOOST_REQUIRE_EQUAL(logLikelihoods.n_elem, sequences.size());
+  BOOST_REQUIRE_EQUAL(stateSeqs.size(), sequences.size());
+  BOOST_REQUIRE_EQUAL(viterbiLogLikelihoods.n_elem, sequences.size());
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logLikelihoods[i], hmm.LogLikelihood(sequences[i]),
+        1e-5);
+
+    arma::Row<size_t> stateSeq;
+    BOOST_REQUIRE_CLOSE(viterbiLogLikelihoods[i],
+        hmm.Predict(sequences[i], stateSeq), 1e-5);
+    BOOST_REQUIRE_EQUAL(stateSeqs[i].n_elem, stateSeq.n_elem);
+    for (size_t t = 0; t < stateSeq.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(stateSeqs[i][t], stateSeq[t]);
+  }
+}
+
+/**
+ * The streaming decoder must filter like the Forward algorithm, and with a lag
+ * longer than the sequence it must decode the Viterbi path.
+ */
+BOOST_AUTO_TEST_CASE(DiscreteHMMStreamingDecoderTest)
+{
+  arma::vec initial("0.5 0.2 0.3");
+  arma::mat transition("0.5 0.0 0.1;"
+                       "0.2 0.6 0.2;"
+                       "0.3 0.4 0.7");
+  std::vector<DiscreteDistribution> emission(3);
+  emission[0].Probabilities() = "0.75 0.25 0.00 0.00";
+  emission[1].Probabilities() = "0.00 0.25 0.25 0.50";
+  emission[2].Probabilities() = "0.10 0.40 0.40 0.10";
+
+  HMM<DiscreteDistribution> hmm(initial, transition, emission);
+
+  arma::mat observations;
+  arma::Row<size_t> states;
+  hmm.Generate(100, observations, states);
+
+  arma::Row<size_t> viterbi;
+  hmm.Predict(observations, viterbi);
+
+  StreamingDecoder<DiscreteDistribution> decoder(hmm, 200);
+  for (size_t t = 0; t < observations.n_cols; ++t)
+  {
+    BOOST_REQUIRE(!decoder.Push(observations.col(t)));
+
+    // The filtered posterior is the smoothed posterior of the last step.
+    arma::mat stateProb;
+    hmm.Estimate(observations.cols(0, t), stateProb);
+    CheckMatrices(decoder.StatePosterior(), stateProb.col(t), 1e-5);
+  }
+
+  BOOST_REQUIRE_EQUAL(decoder.Steps(), (size_t) 100);
+  BOOST_REQUIRE_CLOSE(decoder.LogLikelihood(), hmm.LogLikelihood(observations),
+      1e-5);
+
+  arma::Row<size_t> decoded;
+  decoder.Flush(decoded);
+  BOOST_REQUIRE_EQUAL(decoded.n_elem, viterbi.n_elem);
+  for (size_t t = 0; t < viterbi.n_elem; ++t)
+    BOOST_REQUIRE_EQUAL(decoded[t], viterbi[t]);
+  BOOST_REQUIRE_EQUAL(decoder.Steps(), (size_t) 0);
+}
+
+/**
+ * With a short lag, the streaming decoder must decode one state per
+ * observation, and all the states once flushed.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMStreamingDecoderLagTest)
+{
+  // Two well-separated states, so that the lag is enough to decode them.
+  GaussianDistribution g1("5.0 5.0", "1.0 0.0; 0.0 1.0");
+  GaussianDistribution g2("-5.0 -5.0", "1.0 0.0; 0.0 1.0");
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(g1);
+  emission.push_back(g2);
+  HMM<GaussianDistribution> hmm(arma::vec("1 0"),
+      arma::mat("0.75 0.25; 0.25 0.75"), emission);
+
+  arma::mat observations;
+  arma::Row<size_t> states;
+  hmm.Generate(300, observations, states);
+
+  arma::Row<size_t> viterbi;
+  hmm.Predict(observations, viterbi);
+
+  const size_t lag = 5;
+  StreamingDecoder<GaussianDistribution> decoder(hmm, lag);
+  arma::Row<size_t> decoded;
+  for (size_t t = 0; t < observations.n_cols; ++t)
+  {
+    const bool decodedState = decoder.Push(observations.col(t));
+    BOOST_REQUIRE_EQUAL(decodedState, t >= lag);
+    if (decodedState)
+    {
+      decoded.resize(decoded.n_elem + 1);
+      decoded[decoded.n_elem - 1] = decoder.DecodedState();
+    }
+  }
+
+  arma::Row<size_t> remaining;
+  decoder.Flush(remaining);
+  BOOST_REQUIRE_EQUAL(remaining.n_elem, (size_t) lag);
+  decoded = arma::join_rows(decoded, remaining);
+
+  BOOST_REQUIRE_EQUAL(decoded.n_elem, viterbi.n_elem);
+  for (size_t t = 0; t < viterbi.n_elem; ++t)
+    BOOST_REQUIRE_EQUAL(decoded[t], viterbi[t]);
+}
+
 /**
  * A simple test to make sure HMMs with Gaussian output distributions work.
  */
@@ -599,6 +741,67 @@ BOOST_AUTO_TEST_CASE(GaussianHMMSimpleTest)
   }
 }
 
+/**
+ * Make sure that Gaussian HMMs still work when the emission probabilities of
+ * every state underflow, because the emission probabilities are computed in
+ * log space.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMUnderflowTest)
+{
+  // The covariances are much too small for the observations, so an observation
+  // has a probability far below the smallest double under either state.
+  GaussianDistribution g1("5.0 5.0", "0.001 0.0; 0.0 0.001");
+  GaussianDistribution g2("-5.0 -5.0", "0.001 0.0; 0.0 0.001");
+  GaussianDistribution n1("5.0 5.0", "1.0 0.0; 0.0 1.0");
+  GaussianDistribution n2("-5.0 -5.0", "1.0 0.0; 0.0 1.0");
+
+  arma::vec initial("1 0");
+  arma::mat transition("0.75 0.25; 0.25 0.75");
+
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(g1);
+  emission.push_back(g2);
+
+  HMM<GaussianDistribution> hmm(initial, transition, emission);
+
+  arma::mat observations(2, 500);
+  arma::Row<size_t> classes(500);
+  classes[0] = 0;
+  observations.col(0) = n1.Random();
+  for (size_t i = 1; i < 500; i++)
+  {
+    if (math::Random() > 0.75)
+      classes[i] = (classes[i - 1] + 1) % 2;
+    else
+      classes[i] = classes[i - 1];
+
+    observations.col(i) = (classes[i] == 0) ? n1.Random() : n2.Random();
+  }
+
+  const double loglik = hmm.LogLikelihood(observations);
+  BOOST_REQUIRE(std::isfinite(loglik));
+  BOOST_REQUIRE_LT(loglik, -1e5);
+
+  arma::Row<size_t> predictedClasses;
+  arma::mat stateProb;
+  hmm.Predict(observations, predictedClasses);
+  BOOST_REQUIRE_CLOSE(hmm.Estimate(observations, stateProb), loglik, 1e-5);
+  for (size_t i = 0; i < 500; i++)
+  {
+    BOOST_REQUIRE_EQUAL(predictedClasses[i], classes[i]);
+    BOOST_REQUIRE_CLOSE(stateProb(classes[i], i), 1.0, 1e-5);
+  }
+
+  // With a single state, the log-likelihood is the sum of the emission
+  // log-probabilities.
+  HMM<GaussianDistribution> single(arma::vec("1"), arma::mat("1"),
+      std::vector<GaussianDistribution>(1, g1));
+  arma::vec logProbabilities;
+  g1.LogProbability(observations, logProbabilities);
+  BOOST_REQUIRE_CLOSE(single.LogLikelihood(observations),
+      arma::accu(logProbabilities), 1e-5);
+}
+
 /**
  * Ensure that Gaussian HMMs can be trained properly, for the labeled training
  * case and also for the unlabeled training case.
@@ -0,0 +1,209 @@
+/**
+ * @file hnsw_test.cpp
+ *
+ * Tests for the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(HNSWTest);
+
+/**
+ * Make sure that the approximate neighbors found for a separate query set are
+ * nearly all the true neighbors, with the right distances.
+ */
+BOOST_AUTO_TEST_CASE(HNSWRecallTest)
+{
+  math::RandomSeed(1);
+  arma::mat referenceData = arma::randu<arma::mat>(5, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 200);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 8, 100, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 10, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 200);
+  BOOST_REQUIRE_EQUAL(distances.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, 200);
+
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.95);
+
+  // The distances must be sorted and correct.
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors(j, i), referenceData.n_cols);
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          queryData.col(i), referenceData.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+    }
+  }
+}
+
+/**
+ * Make sure that the monochromatic search does not return each point as its
+ * own neighbor, and finds nearly all the true neighbors.
+ */
+BOOST_AUTO_TEST_CASE(HNSWMonochromaticTest)
+{
+  math::RandomSeed(2);
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(5, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(5, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 1000);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.95);
+}
+
+/**
+ * Make sure a wider search never does worse on the same graph.
+ */
+BOOST_AUTO_TEST_CASE(HNSWEfTest)
+{
+  math::RandomSeed(3);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(10, 100);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData, 4, 20);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 10, neighbors, distances, 10);
+  const double narrowRecall = KNN::Recall(neighbors, trueNeighbors);
+  hnsw.Search(queryData, 10, neighbors, distances, 200);
+  const double wideRecall = KNN::Recall(neighbors, trueNeighbors);
+
+  BOOST_REQUIRE_GE(wideRecall, narrowRecall);
+  BOOST_REQUIRE_GE(wideRecall, 0.9);
+}
+
+/**
+ * Check the structure of the graph: the number of links of each point, and
+ * the levels of the linked points.
+ */
+BOOST_AUTO_TEST_CASE(HNSWGraphTest)
+{
+  math::RandomSeed(4);
+  arma::mat referenceData = arma::randu<arma::mat>(4, 3000);
+  HNSWSearch<> hnsw(referenceData, 6, 50);
+
+  BOOST_REQUIRE_EQUAL(hnsw.Level(hnsw.EntryPoint()), hnsw.MaxLevel());
+  BOOST_REQUIRE_GT(hnsw.MaxLevel(), (size_t) 0);
+
+  for (size_t i = 0; i < referenceData.n_cols; ++i)
+  {
+    BOOST_REQUIRE_LE(hnsw.Level(i), hnsw.MaxLevel());
+    for (size_t l = 0; l <= hnsw.Level(i); ++l)
+    {
+      // Only a point alone on its highest level may have no links.
+      const arma::Col<size_t> links = hnsw.Neighbors(i, l);
+      if (l == 0)
+        BOOST_REQUIRE_GT(links.n_elem, (arma::uword) 0);
+      BOOST_REQUIRE_LE(links.n_elem, (arma::uword) ((l == 0) ? 12 : 6));
+      for (size_t j = 0; j < links.n_elem; ++j)
+      {
+        BOOST_REQUIRE_NE(links[j], i);
+        BOOST_REQUIRE_GE(hnsw.Level(links[j]), l);
+      }
+    }
+  }
+
+  BOOST_REQUIRE_THROW(hnsw.Neighbors(hnsw.EntryPoint(), hnsw.MaxLevel() + 1),
+      std::invalid_argument);
+}
+
+/**
+ * Invalid searches must throw.
+ */
+BOOST_AUTO_TEST_CASE(HNSWInvalidSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 50);
+  HNSWSearch<> hnsw(referenceData);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::mat queryData = arma::randu<arma::mat>(3, 10);
+  BOOST_REQUIRE_THROW(hnsw.Search(queryData, 51, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnsw.Search(50, neighbors, distances),
+      std::invalid_argument);
+
+  arma::mat wrongQueryData = arma::randu<arma::mat>(4, 10);
+  BOOST_REQUIRE_THROW(hnsw.Search(wrongQueryData, 5, neighbors, distances),
+      std::invalid_argument);
+
+  BOOST_REQUIRE_THROW(HNSWSearch<>(referenceData, 1), std::invalid_argument);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * The graph must not depend on the number of threads it is built with.
+ */
+BOOST_AUTO_TEST_CASE(HNSWParallelTrainTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 3000);
+
+  size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  math::RandomSeed(1000);
+  HNSWSearch<> sequentialHnsw(referenceData, 8, 40);
+
+  omp_set_num_threads(std::max(prevNumThreads, (size_t) 4));
+  math::RandomSeed(1000);
+  HNSWSearch<> parallelHnsw(referenceData, 8, 40);
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(sequentialHnsw.EntryPoint(), parallelHnsw.EntryPoint());
+  for (size_t i = 0; i < referenceData.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(sequentialHnsw.Level(i), parallelHnsw.Level(i));
+    for (size_t l = 0; l <= sequentialHnsw.Level(i); ++l)
+    {
+      CheckMatrices(sequentialHnsw.Neighbors(i, l),
+          parallelHnsw.Neighbors(i, l));
+    }
+  }
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -16,6 +16,7 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_categorical_split.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree_model.hpp>
+#include <mlpack/methods/hoeffding_trees/hoeffding_forest.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -1462,4 +1463,371 @@ BOOST_AUTO_TEST_CASE(HoeffdingTreeModelSerializationTest)
   }
 }
 
+/**
+ * Count the leaves of a tree that keep split statistics.
+ */
+template<typename TreeType>
+size_t CountActiveLeaves(const TreeType& tree)
+{
+  if (tree.NumChildren() == 0)
+    return tree.Active() ? 1 : 0;
+
+  size_t count = 0;
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    count += CountActiveLeaves(tree.Child(i));
+  return count;
+}
+
+/**
+ * Make sure that a streaming tree with a limit on the number of active leaves
+ * respects the limit and still learns the dataset of NumericHoeffdingTreeTest.
+ */
+BOOST_AUTO_TEST_CASE(ActiveLeafLimitTest)
+{
+  // Generate data.
+  arma::mat dataset(3, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(3); // All features are numeric.
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    labels[i + 2] = 1;
+  }
+
+  // Only one leaf may keep statistics at a time, so the pure leaves should be
+  // deactivated and the mixed leaf should keep splitting.
+  typedef HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit> TreeType;
+  TreeType tree(info, 3);
+  tree.MaxActiveLeaves(1);
+  tree.Train(dataset, labels, false);
+  tree.Train(dataset, labels, false);
+
+  BOOST_REQUIRE_EQUAL(tree.MaxActiveLeaves(), 1);
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+  BOOST_REQUIRE_LE(CountActiveLeaves(tree), 1);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+  const size_t correct = arma::accu(predictions == labels);
+
+  // 66% accuracy shouldn't be too much to ask...
+  BOOST_REQUIRE_GT(correct, 6000);
+}
+
+/**
+ * Make sure that an inactive leaf is reactivated once it becomes more promising
+ * than the active leaf.
+ */
+BOOST_AUTO_TEST_CASE(ActiveLeafReactivationTest)
+{
+  // Points below zero have label 0, and points above it have label 1 or 2 at
+  // random, so the root should split at zero into a pure and a mixed leaf.
+  data::DatasetInfo info(1);
+  typedef HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit> TreeType;
+  TreeType tree(info, 3);
+  tree.MaxActiveLeaves(1);
+  arma::vec point(1);
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    if (i % 2 == 0)
+    {
+      point[0] = -mlpack::math::Random();
+      tree.Train(point, 0);
+    }
+    else
+    {
+      point[0] = mlpack::math::Random();
+      tree.Train(point, 1 + (i / 2) % 2);
+    }
+  }
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), 2);
+
+  // The pure leaf should be deactivated.
+  tree.EnforceActiveLeafLimit();
+  point[0] = -0.5;
+  const size_t pure = tree.CalculateDirection(point);
+  BOOST_REQUIRE_EQUAL(tree.Child(pure).Active(), false);
+  BOOST_REQUIRE_EQUAL(CountActiveLeaves(tree), 1);
+
+  // Now give the inactive leaf many points it misclassifies half of the time.
+  for (size_t i = 0; i < 8000; ++i)
+  {
+    point[0] = -mlpack::math::Random();
+    tree.Train(point, i % 2);
+  }
+  BOOST_REQUIRE_EQUAL(tree.Child(pure).NumChildren(), 0);
+
+  tree.EnforceActiveLeafLimit();
+  BOOST_REQUIRE_EQUAL(tree.Child(pure).Active(), true);
+  BOOST_REQUIRE_EQUAL(CountActiveLeaves(tree), 1);
+}
+
+/**
+ * Make sure that a tree with inactive leaves can be serialized, and that
+ * training can continue after loading it.
+ */
+BOOST_AUTO_TEST_CASE(ActiveLeafLimitSerializationTest)
+{
+  // Generate data.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4);
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    dataset.col(i) = arma::randu<arma::vec>(4);
+    labels[i] = (dataset(0, i) > 0.5) + 2 * (dataset(1, i) > 0.5);
+  }
+
+  HoeffdingTreeModel m(HoeffdingTreeModel::GINI_HOEFFDING);
+  m.BuildModel(dataset, info, labels, 4, false, 0.95, 0, 100, 100, 10, 100, 2);
+
+  HoeffdingTreeModel xmlM, textM, binaryM;
+  SerializeObjectAll(m, xmlM, textM, binaryM);
+
+  arma::Row<size_t> predictions, predictionsXml, predictionsText,
+      predictionsBinary;
+  m.Classify(dataset, predictions);
+  xmlM.Classify(dataset, predictionsXml);
+  textM.Classify(dataset, predictionsText);
+  binaryM.Classify(dataset, predictionsBinary);
+
+  CheckMatrices(predictions, predictionsXml);
+  CheckMatrices(predictions, predictionsText);
+  CheckMatrices(predictions, predictionsBinary);
+
+  // Training must be able to continue on the loaded models.
+  m.Train(dataset, labels, false);
+  binaryM.Train(dataset, labels, false);
+  m.Classify(dataset, predictions);
+  binaryM.Classify(dataset, predictionsBinary);
+  CheckMatrices(predictions, predictionsBinary);
+}
+
+/**
+ * Make sure that streaming training on a matrix, which takes the points in
+ * mini-batches and updates the statistics in parallel, gives the same tree as
+ * training on each point in turn, for any number of threads.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchStreamingTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+  #endif
+
+  // Generate data with numeric dimensions and a categorical dimension.
+  arma::mat dataset(5, 20000);
+  arma::Row<size_t> labels(20000);
+  data::DatasetInfo info(5);
+  info.MapString<double>("0", 4);
+  info.MapString<double>("1", 4);
+  info.MapString<double>("2", 4);
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    dataset.col(i) = arma::randu<arma::vec>(5);
+    dataset(4, i) = mlpack::math::RandInt(3);
+    labels[i] = (dataset(0, i) > 0.3) + (dataset(1, i) > 0.6) +
+        (dataset(4, i) == 2 ? 1 : 0);
+  }
+
+  typedef HoeffdingTree<GiniImpurity, HoeffdingDoubleNumericSplit> TreeType;
+  TreeType pointTree(info, 4, 0.95, 0, 100, 100);
+  for (size_t i = 0; i < 20000; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+
+  arma::Row<size_t> pointPredictions;
+  arma::rowvec pointProbabilities;
+  pointTree.Classify(dataset, pointPredictions, pointProbabilities);
+  BOOST_REQUIRE_GT(pointTree.NumChildren(), 0);
+
+  for (size_t threads = 1; threads <= 4; threads *= 2)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(threads);
+    #endif
+
+    // Train in two calls, so that the second one starts in the middle of a
+    // check interval of some leaves.
+    TreeType batchTree(info, 4, 0.95, 0, 100, 100);
+    const arma::mat first = dataset.cols(0, 12344);
+    const arma::mat second = dataset.cols(12345, 19999);
+    batchTree.Train(first, labels.cols(0, 12344), false);
+    batchTree.Train(second, labels.cols(12345, 19999), false);
+
+    BOOST_REQUIRE_EQUAL(batchTree.NumDescendants(),
+        pointTree.NumDescendants());
+
+    arma::Row<size_t> batchPredictions;
+    arma::rowvec batchProbabilities;
+    batchTree.Classify(dataset, batchPredictions, batchProbabilities);
+    CheckMatrices(pointPredictions, batchPredictions);
+    CheckMatrices(pointProbabilities, batchProbabilities);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+}
+
+// Generate points in the unit square whose label is whether the first
+// dimension is above 0.5, or the opposite if flipped.
+static void GenerateThresholdData(const size_t n,
+                                  const bool flipped,
+                                  arma::mat& data,
+                                  arma::Row<size_t>& labels)
+{
+  data.randu(2, n);
+  labels.set_size(n);
+  for (size_t i = 0; i < n; ++i)
+    labels[i] = ((data(0, i) > 0.5) != flipped) ? 1 : 0;
+}
+
+/**
+ * Make sure that an online bagging ensemble trained on a stream classifies
+ * well, and that its votes are consistent.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestAccuracyTest)
+{
+  data::DatasetInfo info(2);
+  HoeffdingForest<> forest(info, 2, 5);
+
+  for (size_t batch = 0; batch < 100; ++batch)
+  {
+    arma::mat data;
+    arma::Row<size_t> labels;
+    GenerateThresholdData(100, false, data, labels);
+    forest.Train(data, labels);
+  }
+  BOOST_REQUIRE_EQUAL(forest.SeenSamples(), 10000);
+  BOOST_REQUIRE_EQUAL(forest.NumTrees(), 5);
+
+  arma::mat test;
+  arma::Row<size_t> testLabels;
+  GenerateThresholdData(1000, false, test, testLabels);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  forest.Classify(test, predictions, probabilities);
+  BOOST_REQUIRE_GT(arma::accu(predictions == testLabels), 950);
+
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, 1000);
+  for (size_t i = 0; i < test.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+    BOOST_REQUIRE_EQUAL(predictions[i], probabilities.col(i).index_max());
+  }
+
+  // The trees of the ensemble were trained on different samples.
+  arma::Row<size_t> treePredictions;
+  forest.Tree(0).Classify(test, treePredictions);
+  BOOST_REQUIRE_GT(arma::accu(treePredictions == testLabels), 900);
+}
+
+/**
+ * After a change of the concept, the trees are replaced, and the ensemble
+ * learns the new concept.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestDriftTest)
+{
+  data::DatasetInfo info(2);
+  HoeffdingForest<> forest(info, 2, 5);
+  HoeffdingForest<> staticForest(info, 2, 5, 1.0, false);
+
+  for (size_t batch = 0; batch < 250; ++batch)
+  {
+    arma::mat data;
+    arma::Row<size_t> labels;
+    GenerateThresholdData(100, batch >= 200, data, labels);
+    forest.Train(data, labels);
+    staticForest.Train(data, labels);
+  }
+
+  BOOST_REQUIRE_GT(forest.Replacements(), 0);
+  BOOST_REQUIRE_EQUAL(staticForest.Replacements(), 0);
+
+  arma::mat test;
+  arma::Row<size_t> testLabels;
+  GenerateThresholdData(1000, true, test, testLabels);
+
+  arma::Row<size_t> predictions, staticPredictions;
+  forest.Classify(test, predictions);
+  staticForest.Classify(test, staticPredictions);
+  const size_t correct = arma::accu(predictions == testLabels);
+  BOOST_REQUIRE_GT(correct, 900);
+  BOOST_REQUIRE_GT(correct, arma::accu(staticPredictions == testLabels) + 300);
+}
+
+/**
+ * Training doesn't depend on the number of threads, and a serialized or copied
+ * ensemble classifies in the same way.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestDeterminismTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+  #endif
+
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateThresholdData(3000, false, data, labels);
+  arma::mat test;
+  arma::Row<size_t> testLabels;
+  GenerateThresholdData(500, false, test, testLabels);
+
+  data::DatasetInfo info(2);
+  arma::mat firstProbabilities;
+  for (size_t threads = 1; threads <= 4; threads *= 2)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(threads);
+    #endif
+
+    math::RandomSeed(7);
+    HoeffdingForest<> forest(info, 2, 4);
+    for (size_t begin = 0; begin < data.n_cols; begin += 500)
+    {
+      forest.Train(arma::mat(data.cols(begin, begin + 499)),
+          labels.cols(begin, begin + 499));
+    }
+
+    arma::Row<size_t> predictions;
+    arma::mat probabilities;
+    forest.Classify(test, predictions, probabilities);
+    if (threads == 1)
+      firstProbabilities = probabilities;
+    else
+      CheckMatrices(firstProbabilities, probabilities);
+
+    HoeffdingForest<> xmlForest, textForest, binaryForest;
+    SerializeObjectAll(forest, xmlForest, textForest, binaryForest);
+    HoeffdingForest<> copy(forest);
+
+    arma::mat xmlProbabilities, textProbabilities, binaryProbabilities,
+        copyProbabilities;
+    xmlForest.Classify(test, predictions, xmlProbabilities);
+    textForest.Classify(test, predictions, textProbabilities);
+    binaryForest.Classify(test, predictions, binaryProbabilities);
+    copy.Classify(test, predictions, copyProbabilities);
+    CheckMatrices(probabilities, xmlProbabilities, textProbabilities,
+        binaryProbabilities);
+    CheckMatrices(probabilities, copyProbabilities);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,11 +11,14 @@
 
 #include <mlpack/core/cv/metrics/mse.hpp>
 #include <mlpack/core/cv/metrics/accuracy.hpp>
+#include <mlpack/core/cv/k_fold_cv.hpp>
 #include <mlpack/core/cv/simple_cv.hpp>
 #include <mlpack/core/hpt/cv_function.hpp>
 #include <mlpack/core/hpt/fixed.hpp>
 #include <mlpack/core/hpt/hpt.hpp>
 #include <mlpack/core/optimizers/grid_search/grid_search.hpp>
+#include <mlpack/core/optimizers/hyperband/hyperband.hpp>
+#include <mlpack/core/optimizers/random_search/random_search.hpp>
 #include <mlpack/core/optimizers/gradient_descent/gradient_descent.cpp>
 #include <mlpack/methods/lars/lars.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
@@ -267,6 +270,94 @@ BOOST_AUTO_TEST_CASE(HPTTest)
   BOOST_REQUIRE_CLOSE(expectedObjective, objective, 1e-5);
 }
 
+/**
+ * Test GridSearch in parallel finds the same parameters as the serial search.
+ */
+BOOST_AUTO_TEST_CASE(ParallelGridSearchTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, GridSearch>
+      hpt(validationSize, xs, ys);
+  hpt.Optimizer().Parallel() = true;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  BOOST_REQUIRE_CLOSE(expectedObjective, hpt.BestObjective(), 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda1, actualLambda1, 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda2, actualLambda2, 1e-5);
+
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  double objective = MSE::Evaluate(hpt.BestModel(), validationXs, validationYs);
+  BOOST_REQUIRE_CLOSE(expectedObjective, objective, 1e-5);
+}
+
+/**
+ * Test KFoldCV trains the folds in parallel to the same result, and that
+ * HyperParameterTuner gives the same results with parallel folds, a parallel
+ * grid and cached objectives, also when everything comes from the cache.
+ */
+BOOST_AUTO_TEST_CASE(ParallelKFoldCVCacheTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  KFoldCV<LARS, MSE> cv(4, xs, ys);
+  KFoldCV<LARS, MSE> parallelCV(4, xs, ys);
+  parallelCV.Parallel() = true;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(transposeData, useCholesky, 0.01, 0.05),
+      parallelCV.Evaluate(transposeData, useCholesky, 0.01, 0.05), 1e-5);
+
+  double expectedLambda1, expectedLambda2;
+  HyperParameterTuner<LARS, MSE, KFoldCV, GridSearch> hpt(4, xs, ys);
+  std::tie(expectedLambda1, expectedLambda2) = hpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  HyperParameterTuner<LARS, MSE, KFoldCV, GridSearch> parallelHpt(4, xs, ys);
+  parallelHpt.CV().Parallel() = true;
+  parallelHpt.Optimizer().Parallel() = true;
+  parallelHpt.UseCache() = true;
+  for (size_t run = 0; run < 2; ++run)
+  {
+    double actualLambda1, actualLambda2;
+    std::tie(actualLambda1, actualLambda2) = parallelHpt.Optimize(
+        Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+    BOOST_REQUIRE_CLOSE(hpt.BestObjective(), parallelHpt.BestObjective(),
+        1e-5);
+    BOOST_REQUIRE_CLOSE(expectedLambda1, actualLambda1, 1e-5);
+    BOOST_REQUIRE_CLOSE(expectedLambda2, actualLambda2, 1e-5);
+
+    // The best model must have been trained, even if its objective came from
+    // the cache.
+    BOOST_REQUIRE_CLOSE(MSE::Evaluate(hpt.BestModel(), xs, ys),
+        MSE::Evaluate(parallelHpt.BestModel(), xs, ys), 1e-5);
+  }
+}
+
 /**
  * Test HyperParamterTuner maximizes Accuracy rather than minimizes it.
  */
@@ -343,4 +434,205 @@ BOOST_AUTO_TEST_CASE(HPTGradientDescentTest)
   BOOST_REQUIRE_CLOSE(zOptimized, zMin, 1e-4);
 }
 
+/**
+ * A function of two variables with its minimum at (2, 5), which records the
+ * budget of each evaluation.
+ */
+class BudgetFunction
+{
+ public:
+  double Evaluate(const arma::mat& coordinates)
+  {
+    return Evaluate(coordinates, 1.0);
+  }
+
+  double Evaluate(const arma::mat& coordinates, const double budget)
+  {
+    const double objective = std::pow(coordinates(0) - 2.0, 2) +
+        std::pow(coordinates(1) - 5.0, 2);
+    #pragma omp critical(BudgetFunction)
+    {
+      budgets.push_back(budget);
+      objectives.push_back(objective);
+    }
+
+    return objective;
+  }
+
+  std::vector<double> budgets;
+  std::vector<double> objectives;
+};
+
+//! Fill the given datasetInfo with the values 0, ..., 8 for both dimensions.
+void InitBudgetGrid(DatasetMapper<IncrementPolicy, double>& datasetInfo)
+{
+  for (size_t i = 0; i < 9; ++i)
+  {
+    datasetInfo.MapString<size_t>((double) i, 0);
+    datasetInfo.MapString<size_t>((double) i, 1);
+  }
+}
+
+//! Count the evaluations with the given budget.
+size_t CountBudget(const BudgetFunction& f, const double budget)
+{
+  size_t count = 0;
+  for (const double b : f.budgets)
+    count += (std::abs(b - budget) < 1e-8) ? 1 : 0;
+  return count;
+}
+
+/**
+ * Test RandomSearch evaluates the given number of points of the grid, and
+ * returns the best of them.
+ */
+BOOST_AUTO_TEST_CASE(RandomSearchTest)
+{
+  mlpack::math::RandomSeed(42);
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 2);
+  InitBudgetGrid(datasetInfo);
+
+  for (const bool parallel : { false, true })
+  {
+    BudgetFunction f;
+    RandomSearch optimizer(300, parallel);
+    arma::mat bestParameters;
+    const double objective = optimizer.Optimize(f, bestParameters,
+        datasetInfo);
+
+    BOOST_REQUIRE_EQUAL(f.objectives.size(), 300);
+    BOOST_REQUIRE_CLOSE(*std::min_element(f.objectives.begin(),
+        f.objectives.end()) + 1.0, objective + 1.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(f.Evaluate(bestParameters) + 1.0, objective + 1.0,
+        1e-5);
+
+    // 300 random points of 81 should hit the minimum.
+    BOOST_REQUIRE_SMALL(objective, 1e-10);
+  }
+
+  // Numeric dimensions can't be sampled.
+  DatasetMapper<IncrementPolicy, double> numericInfo(policy, 1);
+  numericInfo.Type(0) = Datatype::numeric;
+  BudgetFunction f;
+  arma::mat bestParameters;
+  BOOST_REQUIRE_THROW(RandomSearch().Optimize(f, bestParameters, numericInfo),
+      std::invalid_argument);
+}
+
+/**
+ * Test SuccessiveHalving evaluates the points with growing budgets, keeps the
+ * best third of them each time, and returns the best point.
+ */
+BOOST_AUTO_TEST_CASE(SuccessiveHalvingTest)
+{
+  mlpack::math::RandomSeed(42);
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 2);
+  InitBudgetGrid(datasetInfo);
+
+  for (const bool parallel : { false, true })
+  {
+    BudgetFunction f;
+    SuccessiveHalving optimizer(27, 3.0, 1.0 / 9.0, parallel);
+    arma::mat bestParameters;
+    const double objective = optimizer.Optimize(f, bestParameters,
+        datasetInfo);
+
+    BOOST_REQUIRE_EQUAL(f.objectives.size(), 39);
+    BOOST_REQUIRE_EQUAL(CountBudget(f, 1.0 / 9.0), 27);
+    BOOST_REQUIRE_EQUAL(CountBudget(f, 1.0 / 3.0), 9);
+    BOOST_REQUIRE_EQUAL(CountBudget(f, 1.0), 3);
+
+    // The objectives don't depend on the budget, so the best point of the
+    // first round survives.
+    BOOST_REQUIRE_CLOSE(*std::min_element(f.objectives.begin(),
+        f.objectives.begin() + 27) + 1.0, objective + 1.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(f.Evaluate(bestParameters) + 1.0, objective + 1.0,
+        1e-5);
+  }
+}
+
+/**
+ * Test Hyperband runs the expected brackets of successive halving.
+ */
+BOOST_AUTO_TEST_CASE(HyperbandTest)
+{
+  mlpack::math::RandomSeed(42);
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 2);
+  InitBudgetGrid(datasetInfo);
+
+  BudgetFunction f;
+  Hyperband optimizer(3.0, 1.0 / 9.0, true);
+  arma::mat bestParameters;
+  const double objective = optimizer.Optimize(f, bestParameters, datasetInfo);
+
+  // The brackets start with 9 points at 1/9, 5 points at 1/3, and 3 points at
+  // the full budget.
+  BOOST_REQUIRE_EQUAL(CountBudget(f, 1.0 / 9.0), 9);
+  BOOST_REQUIRE_EQUAL(CountBudget(f, 1.0 / 3.0), 3 + 5);
+  BOOST_REQUIRE_EQUAL(CountBudget(f, 1.0), 1 + 1 + 3);
+
+  double bestFull = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < f.objectives.size(); ++i)
+    if (std::abs(f.budgets[i] - 1.0) < 1e-8)
+      bestFull = std::min(bestFull, f.objectives[i]);
+  BOOST_REQUIRE_CLOSE(bestFull + 1.0, objective + 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(f.Evaluate(bestParameters) + 1.0, objective + 1.0,
+      1e-5);
+}
+
+/**
+ * Test HyperParameterTuner with RandomSearch finds the best parameters of the
+ * grid when it draws many more points than the grid has, and with
+ * SuccessiveHalving and KFoldCV returns a point whose full cross-validation
+ * gives the reported objective and the best model.
+ */
+BOOST_AUTO_TEST_CASE(HPTRandomSearchAndSuccessiveHalvingTest)
+{
+  mlpack::math::RandomSeed(42);
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, RandomSearch>
+      hpt(validationSize, xs, ys);
+  hpt.Optimizer().Trials() = 300;
+  hpt.Optimizer().Parallel() = true;
+  hpt.UseCache() = true;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  BOOST_REQUIRE_CLOSE(expectedObjective, hpt.BestObjective(), 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda1, actualLambda1, 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda2, actualLambda2, 1e-5);
+
+  HyperParameterTuner<LARS, MSE, KFoldCV, SuccessiveHalving> shHpt(4, xs, ys);
+  shHpt.Optimizer().Parallel() = true;
+  std::tie(actualLambda1, actualLambda2) = shHpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  // All of the folds are run again after the search.
+  BOOST_REQUIRE_EQUAL(shHpt.CV().Folds(), 4);
+  KFoldCV<LARS, MSE> cv(4, xs, ys);
+  const double objective = cv.Evaluate(transposeData, useCholesky,
+      actualLambda1, actualLambda2);
+  BOOST_REQUIRE_CLOSE(objective, shHpt.BestObjective(), 1e-5);
+  BOOST_REQUIRE_CLOSE(MSE::Evaluate(cv.Model(), xs, ys),
+      MSE::Evaluate(shHpt.BestModel(), xs, ys), 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
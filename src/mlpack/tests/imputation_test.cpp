@@ -314,4 +314,68 @@ BOOST_AUTO_TEST_CASE(DatasetMapperPointerMapping)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(2, 0), &c);
 }
 
+/**
+ * Impute the given dimensions of the given matrix one at a time and all at
+ * once with the given strategy, and make sure the results are the same.
+ */
+template<typename StrategyType>
+void CheckMultipleDimensionImputation(StrategyType strategy,
+                                      const arma::mat& input,
+                                      const std::vector<size_t>& dimensions,
+                                      const bool columnMajor)
+{
+  arma::mat separate(input);
+  for (size_t d : dimensions)
+    strategy.Impute(separate, 0.0, d, columnMajor);
+
+  arma::mat together(input);
+  strategy.Impute(together, std::vector<double>(dimensions.size(), 0.0),
+      dimensions, columnMajor);
+
+  CheckMatrices(separate, together);
+}
+
+/**
+ * Make sure that imputing several dimensions at once gives the same result as
+ * imputing them one at a time, for every strategy.
+ */
+BOOST_AUTO_TEST_CASE(MultipleDimensionImputationTest)
+{
+  // Make some elements missing (0), and some elements of the imputed
+  // dimensions NaN.
+  const std::vector<size_t> dimensions = { 0, 2, 3, 7 };
+  arma::mat input = arma::randu<arma::mat>(8, 301) + 1.0;
+  for (size_t i = 1; i < input.n_cols; i += 3)
+    input(i % input.n_rows, i) = 0.0;
+  for (size_t i = 2; i < input.n_cols; i += 7)
+    input(dimensions[i % dimensions.size()], i) = std::nan("");
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const bool columnMajor = (i == 0);
+    const arma::mat data = columnMajor ? input : arma::mat(input.t());
+    CheckMultipleDimensionImputation(MeanImputation<double>(), data,
+        dimensions, columnMajor);
+    CheckMultipleDimensionImputation(MedianImputation<double>(), data,
+        dimensions, columnMajor);
+    CheckMultipleDimensionImputation(CustomImputation<double>(-1.0), data,
+        dimensions, columnMajor);
+    CheckMultipleDimensionImputation(ListwiseDeletion<double>(), data,
+        dimensions, columnMajor);
+  }
+
+  // The Imputer imputes all the given dimensions.
+  DatasetInfo info(input.n_rows);
+  for (size_t d = 0; d < input.n_rows; ++d)
+    info.MapString<double>("missing", d);
+  arma::mat imputed(input);
+  Imputer<double, DatasetInfo, CustomImputation<double>> imputer(info,
+      CustomImputation<double>(-1.0));
+  imputer.Impute(imputed, "missing", dimensions);
+  for (size_t d : dimensions)
+    for (size_t i = 0; i < input.n_cols; ++i)
+      if (input(d, i) == info.UnmapValue("missing", d) ||
+          std::isnan(input(d, i)))
+        BOOST_REQUIRE_EQUAL(imputed(d, i), -1.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,193 @@
+/**
+ * @file ivf_pq_test.cpp
+ *
+ * Tests for the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ivf_pq/ivf_pq_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(IVFPQTest);
+
+/**
+ * When every list is scanned and every candidate is re-ranked, the search is
+ * exact.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQExactRerankTest)
+{
+  math::RandomSeed(1);
+  arma::mat referenceData = arma::randu<arma::mat>(8, 500);
+  arma::mat queryData = arma::randu<arma::mat>(8, 50);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 5, trueNeighbors, trueDistances);
+
+  IVFPQSearch ivfpq(referenceData, 10, 4, 16, true);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(queryData, 5, neighbors, distances, 10, 500);
+
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+/**
+ * The approximate distances of the compressed points must find most of the
+ * true neighbors, and re-ranking a few candidates must find more.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQRecallTest)
+{
+  math::RandomSeed(2);
+  arma::mat referenceData = arma::randu<arma::mat>(8, 3000);
+  arma::mat queryData = arma::randu<arma::mat>(8, 100);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  IVFPQSearch ivfpq(referenceData, 16, 4, 256, true);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(queryData, 10, neighbors, distances, 8);
+  const double recall = KNN::Recall(neighbors, trueNeighbors);
+
+  ivfpq.Search(queryData, 10, neighbors, distances, 8, 50);
+  const double rerankRecall = KNN::Recall(neighbors, trueNeighbors);
+
+  BOOST_REQUIRE_GE(recall, 0.6);
+  BOOST_REQUIRE_GE(rerankRecall, recall);
+  BOOST_REQUIRE_GE(rerankRecall, 0.9);
+
+  // Each column must be sorted.
+  for (size_t i = 0; i < distances.n_cols; ++i)
+    for (size_t j = 1; j < distances.n_rows; ++j)
+      BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+}
+
+/**
+ * Points added after training must get the following indices, and the lists
+ * must hold every point once.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQAddTest)
+{
+  math::RandomSeed(3);
+  arma::mat referenceData = arma::randu<arma::mat>(6, 1000);
+
+  IVFPQSearch ivfpq(arma::mat(referenceData.cols(0, 599)), 8, 3, 32, true);
+  ivfpq.Add(referenceData.cols(600, 999));
+
+  BOOST_REQUIRE_EQUAL(ivfpq.NumPoints(), 1000);
+  BOOST_REQUIRE_EQUAL(ivfpq.ListOffsets().n_elem, 9);
+  BOOST_REQUIRE_EQUAL(ivfpq.ListOffsets()[8], 1000);
+  BOOST_REQUIRE_EQUAL(ivfpq.Codes().n_rows, 3);
+  BOOST_REQUIRE_EQUAL(ivfpq.Codes().n_cols, 1000);
+  CheckMatrices(ivfpq.ReferenceSet(), referenceData);
+
+  const arma::Col<size_t> sortedIndices = arma::sort(ivfpq.ListIndices());
+  for (size_t i = 0; i < sortedIndices.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(sortedIndices[i], i);
+
+  // The added points can be found.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(referenceData.cols(900, 999), 1, neighbors, distances, 8, 20);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors(0, i), 900 + i);
+    BOOST_REQUIRE_SMALL(distances(0, i), 1e-10);
+  }
+}
+
+/**
+ * The reconstruction of the points from their codes must be closer to them
+ * than the centroids of their lists.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQReconstructTest)
+{
+  math::RandomSeed(4);
+  arma::mat referenceData = arma::randu<arma::mat>(4, 1000);
+  IVFPQSearch ivfpq(referenceData, 4, 2, 64);
+
+  double reconstructionError = 0.0;
+  double coarseError = 0.0;
+  arma::vec reconstruction;
+  for (size_t i = 0; i < referenceData.n_cols; ++i)
+  {
+    ivfpq.Reconstruct(i, reconstruction);
+    reconstructionError += arma::norm(reconstruction - referenceData.col(i));
+
+    arma::rowvec listDistances = arma::sum(arma::square(
+        ivfpq.CoarseCentroids().each_col() - referenceData.col(i)), 0);
+    coarseError += std::sqrt(listDistances.min());
+  }
+
+  BOOST_REQUIRE_LT(reconstructionError, 0.5 * coarseError);
+  BOOST_REQUIRE_THROW(ivfpq.Reconstruct(1000, reconstruction),
+      std::invalid_argument);
+}
+
+/**
+ * Training on a sample must give the full index.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQTrainingSamplesTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 2000);
+  IVFPQSearch ivfpq(referenceData, 8, 2, 16, false, 300);
+
+  BOOST_REQUIRE_EQUAL(ivfpq.NumPoints(), 2000);
+  BOOST_REQUIRE_EQUAL(ivfpq.CoarseCentroids().n_cols, 8);
+  BOOST_REQUIRE_EQUAL(ivfpq.Codebooks().n_rows, 2);
+  BOOST_REQUIRE_EQUAL(ivfpq.Codebooks().n_cols, 16);
+  BOOST_REQUIRE_EQUAL(ivfpq.Codebooks().n_slices, 2);
+  BOOST_REQUIRE_EQUAL(ivfpq.ReferenceSet().n_elem, 0);
+}
+
+/**
+ * Invalid parameters must throw.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQInvalidParametersTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(6, 300);
+
+  // The dimensionality is not a multiple of the number of subspaces.
+  BOOST_REQUIRE_THROW(IVFPQSearch(referenceData, 4, 4, 16),
+      std::invalid_argument);
+  // Too many centroids.
+  BOOST_REQUIRE_THROW(IVFPQSearch(referenceData, 4, 3, 257),
+      std::invalid_argument);
+  // Not enough training points.
+  BOOST_REQUIRE_THROW(IVFPQSearch(referenceData, 4, 3, 64, false, 50),
+      std::invalid_argument);
+
+  IVFPQSearch ivfpq(referenceData, 4, 3, 16);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  // Re-ranking without the reference set.
+  BOOST_REQUIRE_THROW(ivfpq.Search(referenceData, 5, neighbors, distances, 2,
+      10), std::invalid_argument);
+  // Too many neighbors.
+  BOOST_REQUIRE_THROW(ivfpq.Search(referenceData, 301, neighbors, distances),
+      std::invalid_argument);
+  // Wrong dimensionality.
+  BOOST_REQUIRE_THROW(ivfpq.Add(arma::randu<arma::mat>(5, 10)),
+      std::invalid_argument);
+
+  IVFPQSearch untrained;
+  BOOST_REQUIRE_THROW(untrained.Add(referenceData), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,404 @@
+/**
+ * @file kde_test.cpp
+ *
+ * Tests for the KDE class and the KDEModel class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/kde/kde_model.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::kernel;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(KDETest);
+
+/**
+ * Compute the unnormalized densities exactly: the mean of the kernel values.
+ */
+template<typename KernelType>
+arma::vec ExactDensities(const arma::mat& referenceSet,
+                         const arma::mat& querySet,
+                         const KernelType& kernel)
+{
+  arma::vec densities(querySet.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+    {
+      densities[i] += kernel.Evaluate(metric::EuclideanDistance::Evaluate(
+          querySet.col(i), referenceSet.col(j)));
+    }
+  }
+
+  return densities / referenceSet.n_cols;
+}
+
+/**
+ * Make sure each estimate is within the error tolerance of the exact density.
+ * The tolerance is on the unnormalized densities, so the normalizer is given.
+ */
+void CheckDensities(const arma::vec& estimations,
+                    const arma::vec& exact,
+                    const double normalizer,
+                    const double relError,
+                    const double absError)
+{
+  BOOST_REQUIRE_EQUAL(estimations.n_elem, exact.n_elem);
+  for (size_t i = 0; i < exact.n_elem; ++i)
+  {
+    BOOST_REQUIRE_LE(std::abs(estimations[i] * normalizer - exact[i]),
+        relError * exact[i] + absError + 1e-12);
+  }
+}
+
+/**
+ * Naive mode must compute the exact densities, normalized.
+ */
+BOOST_AUTO_TEST_CASE(KDENaiveTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+  GaussianKernel kernel(0.3);
+
+  KDE<> kde(0.05, 0.0, kernel, NAIVE_MODE);
+  kde.Train(referenceData);
+  arma::vec estimations;
+  kde.Evaluate(queryData, estimations);
+
+  CheckDensities(estimations, ExactDensities(referenceData, queryData, kernel),
+      kernel.Normalizer(3), 1e-8, 0.0);
+}
+
+/**
+ * Dual-tree and single-tree mode must be within the relative error.
+ */
+BOOST_AUTO_TEST_CASE(KDETreeModesTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 3000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 300);
+  GaussianKernel kernel(0.2);
+  const arma::vec exact = ExactDensities(referenceData, queryData, kernel);
+
+  KDE<> kde(0.05, 0.0, kernel, DUAL_TREE_MODE);
+  kde.Train(referenceData);
+  arma::vec estimations;
+  kde.Evaluate(queryData, estimations);
+  CheckDensities(estimations, exact, kernel.Normalizer(3), 0.05, 0.0);
+
+  // The approximations must save base cases.
+  BOOST_REQUIRE_LT(kde.BaseCases(),
+      referenceData.n_cols * queryData.n_cols);
+
+  kde.Mode() = SINGLE_TREE_MODE;
+  kde.Evaluate(queryData, estimations);
+  CheckDensities(estimations, exact, kernel.Normalizer(3), 0.05, 0.0);
+}
+
+/**
+ * With no error tolerance, the tree modes must be exact.
+ */
+BOOST_AUTO_TEST_CASE(KDEExactTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(2, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(2, 200);
+  EpanechnikovKernel kernel(0.1);
+  const arma::vec exact = ExactDensities(referenceData, queryData, kernel);
+
+  KDE<EpanechnikovKernel> kde(0.0, 0.0, kernel);
+  kde.Train(referenceData);
+  arma::vec estimations;
+  kde.Evaluate(queryData, estimations);
+  CheckDensities(estimations, exact, kernel.Normalizer(2), 1e-8, 0.0);
+
+  kde.Mode() = SINGLE_TREE_MODE;
+  kde.Evaluate(queryData, estimations);
+  CheckDensities(estimations, exact, kernel.Normalizer(2), 1e-8, 0.0);
+}
+
+/**
+ * The absolute error tolerance must be respected.
+ */
+BOOST_AUTO_TEST_CASE(KDEAbsoluteErrorTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+  LaplacianKernel kernel(0.3);
+  const arma::vec exact = ExactDensities(referenceData, queryData, kernel);
+
+  KDE<LaplacianKernel> kde(0.0, 0.01, kernel);
+  kde.Train(referenceData);
+  arma::vec estimations;
+  kde.Evaluate(queryData, estimations);
+  CheckDensities(estimations, exact, 1.0, 0.0, 0.01);
+}
+
+/**
+ * Test every kernel, with their normalizers.
+ */
+template<typename KernelType>
+void CheckKernel(const KernelType& kernel, const double normalizer)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(2, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(2, 200);
+  const arma::vec exact = ExactDensities(referenceData, queryData, kernel);
+
+  KDE<KernelType> kde(0.02, 0.0, kernel);
+  kde.Train(referenceData);
+  arma::vec estimations;
+  kde.Evaluate(queryData, estimations);
+  CheckDensities(estimations, exact, normalizer, 0.02, 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(KDEKernelsTest)
+{
+  GaussianKernel gaussian(0.2);
+  CheckKernel(gaussian, gaussian.Normalizer(2));
+  EpanechnikovKernel epanechnikov(0.3);
+  CheckKernel(epanechnikov, epanechnikov.Normalizer(2));
+  CheckKernel(LaplacianKernel(0.2), 1.0);
+  SphericalKernel spherical(0.25);
+  CheckKernel(spherical, spherical.Normalizer(2));
+  CheckKernel(TriangularKernel(0.4), 1.0);
+}
+
+/**
+ * Test the other tree types.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckTree()
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+  GaussianKernel kernel(0.25);
+  const arma::vec exact = ExactDensities(referenceData, queryData, kernel);
+
+  KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, TreeType> kde(0.05,
+      0.0, kernel);
+  kde.Train(referenceData);
+  arma::vec estimations;
+  kde.Evaluate(queryData, estimations);
+  CheckDensities(estimations, exact, kernel.Normalizer(3), 0.05, 0.0);
+
+  kde.Mode() = SINGLE_TREE_MODE;
+  kde.Evaluate(queryData, estimations);
+  CheckDensities(estimations, exact, kernel.Normalizer(3), 0.05, 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(KDETreeTypesTest)
+{
+  CheckTree<BallTree>();
+  CheckTree<Octree>();
+  CheckTree<RTree>();
+}
+
+/**
+ * The monochromatic estimates must be given in the original order of the
+ * reference points.
+ */
+BOOST_AUTO_TEST_CASE(KDEMonochromaticTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1500);
+  GaussianKernel kernel(0.2);
+  const arma::vec exact = ExactDensities(referenceData, referenceData, kernel);
+
+  KDE<> kde(0.05, 0.0, kernel);
+  kde.Train(referenceData);
+  arma::vec estimations;
+  kde.Evaluate(estimations);
+  CheckDensities(estimations, exact, kernel.Normalizer(3), 0.05, 0.0);
+
+  kde.Mode() = NAIVE_MODE;
+  kde.Evaluate(estimations);
+  CheckDensities(estimations, exact, kernel.Normalizer(3), 1e-8, 0.0);
+}
+
+/**
+ * A query tree can be given, and the estimates are mapped to the original
+ * order of the query points.
+ */
+BOOST_AUTO_TEST_CASE(KDEQueryTreeTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 300);
+  GaussianKernel kernel(0.2);
+  const arma::vec exact = ExactDensities(referenceData, queryData, kernel);
+
+  KDE<> kde(0.05, 0.0, kernel);
+  kde.Train(referenceData);
+
+  std::vector<size_t> oldFromNewQueries;
+  KDE<>::Tree queryTree(queryData, oldFromNewQueries);
+  arma::vec estimations;
+  kde.Evaluate(&queryTree, oldFromNewQueries, estimations);
+  CheckDensities(estimations, exact, kernel.Normalizer(3), 0.05, 0.0);
+
+  // A query tree can only be used in dual-tree mode.
+  kde.Mode() = SINGLE_TREE_MODE;
+  BOOST_REQUIRE_THROW(kde.Evaluate(&queryTree, oldFromNewQueries, estimations),
+      std::invalid_argument);
+}
+
+/**
+ * Monte Carlo estimation must give estimates that are mostly within the
+ * relative error, and save base cases when the kernel is wide.
+ */
+BOOST_AUTO_TEST_CASE(KDEMonteCarloTest)
+{
+  math::RandomSeed(5);
+  arma::mat referenceData = arma::randu<arma::mat>(2, 20000);
+  arma::mat queryData = arma::randu<arma::mat>(2, 200);
+  GaussianKernel kernel(0.8);
+  const arma::vec exact = ExactDensities(referenceData, queryData, kernel);
+
+  KDE<> kde(0.05, 0.0, kernel, DUAL_TREE_MODE, true, 0.95, 50, 3.0, 0.4);
+  kde.Train(referenceData);
+  arma::vec estimations;
+  kde.Evaluate(queryData, estimations);
+  estimations *= kernel.Normalizer(2);
+
+  size_t within = 0;
+  for (size_t i = 0; i < exact.n_elem; ++i)
+    if (std::abs(estimations[i] - exact[i]) <= 0.05 * exact[i])
+      ++within;
+
+  BOOST_REQUIRE_GE(within, 0.9 * exact.n_elem);
+  BOOST_REQUIRE_LT(kde.BaseCases(),
+      referenceData.n_cols * queryData.n_cols / 4);
+}
+
+/**
+ * Copies of a KDE object must give the same estimates.
+ */
+BOOST_AUTO_TEST_CASE(KDECopyTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+
+  KDE<> kde(0.05, 0.0, GaussianKernel(0.3));
+  kde.Train(referenceData);
+
+  KDE<> copy(kde);
+  KDE<> assigned;
+  assigned = kde;
+  KDE<> moved(std::move(copy));
+
+  arma::vec estimations, assignedEstimations, movedEstimations;
+  kde.Evaluate(queryData, estimations);
+  assigned.Evaluate(queryData, assignedEstimations);
+  moved.Evaluate(queryData, movedEstimations);
+
+  CheckMatrices(estimations, assignedEstimations);
+  CheckMatrices(estimations, movedEstimations);
+  BOOST_REQUIRE(!copy.IsTrained());
+}
+
+/**
+ * Invalid parameters must throw.
+ */
+BOOST_AUTO_TEST_CASE(KDEInvalidParametersTest)
+{
+  BOOST_REQUIRE_THROW(KDE<>(-0.1), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(1.5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(0.05, -1.0), std::invalid_argument);
+  // Monte Carlo estimation needs a relative error tolerance.
+  BOOST_REQUIRE_THROW(KDE<>(0.0, 0.1, GaussianKernel(), DUAL_TREE_MODE, true),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(0.05, 0.0, GaussianKernel(), DUAL_TREE_MODE, true,
+      1.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(0.05, 0.0, GaussianKernel(), DUAL_TREE_MODE, true,
+      0.95, 1), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(0.05, 0.0, GaussianKernel(), DUAL_TREE_MODE, true,
+      0.95, 100, 0.5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(0.05, 0.0, GaussianKernel(), DUAL_TREE_MODE, true,
+      0.95, 100, 3.0, 1.5), std::invalid_argument);
+
+  KDE<> kde;
+  arma::vec estimations;
+  arma::mat referenceData = arma::randu<arma::mat>(3, 100);
+  // Not trained.
+  BOOST_REQUIRE_THROW(kde.Evaluate(referenceData, estimations),
+      std::invalid_argument);
+  // Wrong dimensionality.
+  kde.Train(referenceData);
+  BOOST_REQUIRE_THROW(kde.Evaluate(arma::randu<arma::mat>(2, 10), estimations),
+      std::invalid_argument);
+}
+
+/**
+ * Every combination of kernel and tree of the model must work, and a
+ * serialized model must give the same estimates.
+ */
+BOOST_AUTO_TEST_CASE(KDEModelTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 800);
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+
+  for (size_t k = 0; k <= KDEModel::TRIANGULAR_KERNEL; ++k)
+  {
+    for (size_t t = 0; t <= KDEModel::R_TREE; ++t)
+    {
+      KDEModel model(0.3, 0.05, 0.0, (KDEModel::KernelTypes) k,
+          (KDEModel::TreeTypes) t);
+      model.BuildModel(arma::mat(referenceData));
+
+      // Naive mode gives the exact densities.
+      arma::vec estimations, naiveEstimations;
+      model.Evaluate(arma::mat(queryData), estimations);
+      model.Mode() = NAIVE_MODE;
+      model.Evaluate(arma::mat(queryData), naiveEstimations);
+      for (size_t i = 0; i < estimations.n_elem; ++i)
+      {
+        BOOST_REQUIRE_LE(std::abs(estimations[i] - naiveEstimations[i]),
+            0.05 * naiveEstimations[i] + 1e-12);
+      }
+
+      KDEModel xmlModel, textModel, binaryModel;
+      SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+      arma::vec xmlEstimations, textEstimations, binaryEstimations;
+      xmlModel.Evaluate(arma::mat(queryData), xmlEstimations);
+      textModel.Evaluate(arma::mat(queryData), textEstimations);
+      binaryModel.Evaluate(arma::mat(queryData), binaryEstimations);
+
+      CheckMatrices(naiveEstimations, xmlEstimations);
+      CheckMatrices(naiveEstimations, textEstimations);
+      CheckMatrices(naiveEstimations, binaryEstimations);
+    }
+  }
+}
+
+/**
+ * The bandwidth of a built model can be changed.
+ */
+BOOST_AUTO_TEST_CASE(KDEModelBandwidthTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(2, 500);
+  arma::mat queryData = arma::randu<arma::mat>(2, 50);
+
+  KDEModel model(0.5, 0.0, 0.0, KDEModel::LAPLACIAN_KERNEL);
+  model.BuildModel(arma::mat(referenceData));
+  model.Bandwidth() = 0.1;
+  arma::vec estimations;
+  model.Evaluate(arma::mat(queryData), estimations);
+
+  CheckDensities(estimations, ExactDensities(referenceData, queryData,
+      LaplacianKernel(0.1)), 1.0, 1e-8, 0.0);
+
+  KDEModel empty;
+  BOOST_REQUIRE_THROW(empty.Evaluate(estimations), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_features_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_pca.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -150,4 +151,103 @@ BOOST_AUTO_TEST_CASE(CircleTransformationTestNystroem)
   BOOST_REQUIRE_EQUAL(ranges[1].Contains(ranges[2]), false);
 }
 
+/**
+ * If KernelPCA is working right, then it should turn a circle dataset into a
+ * linearly separable dataset in one dimension (which is easy to check).
+ */
+BOOST_AUTO_TEST_CASE(CircleTransformationTestRandomFeatures)
+{
+  // The dataset, which will have three concentric rings in three dimensions.
+  arma::mat dataset;
+
+  // Now, there are 750 points centered at the origin with unit variance.
+  dataset.randn(3, 750);
+  dataset *= 0.05;
+
+  // Take the second 250 points and spread them away from the origin.
+  for (size_t i = 250; i < 500; ++i)
+  {
+    // Push the point away from the origin by 2.
+    const double pointNorm = norm(dataset.col(i), 2);
+
+    dataset(0, i) += 2.0 * (dataset(0, i) / pointNorm);
+    dataset(1, i) += 2.0 * (dataset(1, i) / pointNorm);
+    dataset(2, i) += 2.0 * (dataset(2, i) / pointNorm);
+  }
+
+  // Take the third 500 points and spread them away from the origin.
+  for (size_t i = 500; i < 750; ++i)
+  {
+    // Push the point away from the origin by 5.
+    const double pointNorm = norm(dataset.col(i), 2);
+
+    dataset(0, i) += 5.0 * (dataset(0, i) / pointNorm);
+    dataset(1, i) += 5.0 * (dataset(1, i) / pointNorm);
+    dataset(2, i) += 5.0 * (dataset(2, i) / pointNorm);
+  }
+
+  // Now we have a dataset; we will use the GaussianKernel to perform KernelPCA
+  // using random Fourier features to take it down to one dimension.
+  KernelPCA<GaussianKernel, RandomFeaturesKernelRule<GaussianKernel> > p;
+  p.Apply(dataset, 1);
+
+  // Get the ranges of each "class".  These are all initialized as empty ranges
+  // containing no points.
+  Range ranges[3];
+  ranges[0] = Range();
+  ranges[1] = Range();
+  ranges[2] = Range();
+
+  // Expand the ranges to hold all of the points in the class.
+  for (size_t i = 0; i < 250; ++i)
+    ranges[0] |= dataset(0, i);
+  for (size_t i = 250; i < 500; ++i)
+    ranges[1] |= dataset(0, i);
+  for (size_t i = 500; i < 750; ++i)
+    ranges[2] |= dataset(0, i);
+
+  // None of these ranges should overlap -- the classes should be linearly
+  // separable.
+  BOOST_REQUIRE_EQUAL(ranges[0].Contains(ranges[1]), false);
+  BOOST_REQUIRE_EQUAL(ranges[0].Contains(ranges[2]), false);
+  BOOST_REQUIRE_EQUAL(ranges[1].Contains(ranges[2]), false);
+}
+
+/**
+ * The eigenvalues found with random Fourier features should be close to the
+ * eigenvalues of the exact centered kernel matrix, and the feature map should
+ * project the points as in the transformed data.
+ */
+BOOST_AUTO_TEST_CASE(RandomFeaturesEigenvaluesTest)
+{
+  arma::mat dataset(2, 300, arma::fill::randu);
+  GaussianKernel kernel(0.5);
+
+  arma::mat transformed, eigvec;
+  arma::vec eigval;
+  NaiveKernelRule<GaussianKernel>::ApplyKernelMatrix(dataset, transformed,
+      eigval, eigvec, 0, kernel);
+
+  arma::mat approxTransformed, approxEigvec;
+  arma::vec approxEigval, featureMean;
+  RandomFourierFeatures<GaussianKernel> features;
+  RandomFeaturesKernelRule<GaussianKernel, 2048>::ApplyKernelMatrix(dataset,
+      approxTransformed, approxEigval, approxEigvec, 3, kernel, features,
+      featureMean);
+
+  BOOST_REQUIRE_EQUAL(approxEigval.n_elem, 2048);
+  BOOST_REQUIRE_EQUAL(approxEigvec.n_rows, 2048);
+  BOOST_REQUIRE_EQUAL(approxTransformed.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(approxTransformed.n_cols, dataset.n_cols);
+
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(approxEigval[i], eigval[i], 10.0);
+
+  arma::mat mapped;
+  features.Map(dataset, mapped);
+  mapped.each_col() -= featureMean;
+  const arma::mat projected = approxEigvec.head_cols(3).t() * mapped;
+  CheckMatrices(projected, approxTransformed);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
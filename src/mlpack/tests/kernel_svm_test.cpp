@@ -0,0 +1,302 @@
+/**
+ * @file kernel_svm_test.cpp
+ *
+ * Tests for the kernel support vector machine and its SMO solver.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kernel_svm/kernel_svm.hpp>
+#include <mlpack/methods/kernel_svm/kernel_svm_model.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::svm;
+using namespace mlpack::kernel;
+
+BOOST_AUTO_TEST_SUITE(KernelSVMTest);
+
+/**
+ * Generate two concentric rings of points, of radius 1 (class 0) and 3
+ * (class 1), which no linear classifier separates.
+ */
+void GenerateRings(const size_t pointsPerClass,
+                   arma::mat& data,
+                   arma::Row<size_t>& labels)
+{
+  data.set_size(2, 2 * pointsPerClass);
+  labels.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const double angle = 2.0 * M_PI * math::Random();
+    const double radius = ((i % 2 == 0) ? 1.0 : 3.0) +
+        0.2 * math::RandNormal();
+    data(0, i) = radius * std::cos(angle);
+    data(1, i) = radius * std::sin(angle);
+    labels[i] = i % 2;
+  }
+}
+
+/**
+ * Generate Gaussian clouds of points around the given centers (one column per
+ * class).
+ */
+void GenerateClouds(const arma::mat& centers,
+                    const size_t pointsPerClass,
+                    arma::mat& data,
+                    arma::Row<size_t>& labels)
+{
+  data.set_size(centers.n_rows, centers.n_cols * pointsPerClass);
+  labels.set_size(data.n_cols);
+  for (size_t c = 0; c < centers.n_cols; ++c)
+  {
+    for (size_t i = 0; i < pointsPerClass; ++i)
+    {
+      const size_t j = c * pointsPerClass + i;
+      data.col(j) = centers.col(c) + arma::randn<arma::vec>(centers.n_rows);
+      labels[j] = c;
+    }
+  }
+}
+
+/**
+ * Make sure that nonlinearly separable classes are separated with the
+ * Gaussian kernel.
+ */
+BOOST_AUTO_TEST_CASE(KernelSVMRingsTest)
+{
+  math::RandomSeed(1);
+  arma::mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  GenerateRings(200, data, labels);
+  GenerateRings(200, testData, testLabels);
+
+  KernelSVM<GaussianKernel> svm(data, labels, 2, 10.0, 1e-3, true, 100.0, 0,
+      GaussianKernel(1.0));
+
+  BOOST_REQUIRE_EQUAL(svm.NumClasses(), (size_t) 2);
+  BOOST_REQUIRE_EQUAL(svm.Biases().n_elem, (size_t) 1);
+  BOOST_REQUIRE_EQUAL(svm.Coefficients().n_cols, (size_t) 1);
+  BOOST_REQUIRE_EQUAL(svm.Coefficients().n_rows, svm.SupportVectors().n_cols);
+  BOOST_REQUIRE_GT(svm.SupportVectors().n_cols, (size_t) 0);
+  BOOST_REQUIRE_LT(svm.SupportVectors().n_cols, data.n_cols / 2);
+  BOOST_REQUIRE_GT(svm.ComputeAccuracy(testData, testLabels), 97.0);
+
+  // The linear kernel can't separate the rings.
+  KernelSVM<LinearKernel> linearSVM(data, labels, 2);
+  BOOST_REQUIRE_LT(linearSVM.ComputeAccuracy(testData, testLabels), 75.0);
+}
+
+/**
+ * Make sure that the solution of the solver satisfies the optimality
+ * conditions of the dual problem, with and without shrinking.
+ */
+BOOST_AUTO_TEST_CASE(SMOOptimalityTest)
+{
+  math::RandomSeed(2);
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateClouds(arma::mat("-1.0 1.0; 0.0 0.0; 0.0 1.0"), 150, data, labels);
+  const arma::vec y = 2.0 * arma::conv_to<arma::vec>::from(labels) - 1.0;
+
+  const double c = 2.0;
+  for (size_t s = 0; s < 2; ++s)
+  {
+    GaussianKernel kernel(2.0);
+    SMO<GaussianKernel> smo(c, 1e-4, (s == 0));
+    arma::vec alpha;
+    double bias;
+    smo.Optimize(data, y, kernel, alpha, bias);
+
+    BOOST_REQUIRE_SMALL(arma::dot(alpha, y), 1e-8);
+
+    arma::mat k;
+    KernelMatrixRule<GaussianKernel>::Evaluate(data, data, kernel, k);
+    const arma::vec f = k * (alpha % y) + bias;
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      BOOST_REQUIRE_GE(alpha[i], 0.0);
+      BOOST_REQUIRE_LE(alpha[i], c);
+
+      const double margin = y[i] * f[i];
+      if (alpha[i] == 0.0)
+        BOOST_REQUIRE_GE(margin, 1.0 - 1e-3);
+      else if (alpha[i] == c)
+        BOOST_REQUIRE_LE(margin, 1.0 + 1e-3);
+      else
+        BOOST_REQUIRE_SMALL(margin - 1.0, 1e-3);
+    }
+  }
+}
+
+/**
+ * Make sure that the size of the kernel cache only changes the number of
+ * kernel evaluations.
+ */
+BOOST_AUTO_TEST_CASE(SMOCacheSizeTest)
+{
+  math::RandomSeed(3);
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateRings(150, data, labels);
+  const arma::vec y = 2.0 * arma::conv_to<arma::vec>::from(labels) - 1.0;
+
+  // The small cache only holds two columns; without shrinking, the large
+  // cache computes each column at most once.
+  GaussianKernel kernel(1.0);
+  SMO<GaussianKernel> largeSMO(5.0, 1e-3, false, 100.0);
+  SMO<GaussianKernel> smallSMO(5.0, 1e-3, false, 1e-6);
+  arma::vec largeAlpha, smallAlpha;
+  double largeBias, smallBias;
+  largeSMO.Optimize(data, y, kernel, largeAlpha, largeBias);
+  smallSMO.Optimize(data, y, kernel, smallAlpha, smallBias);
+
+  // The solutions give the same decision values.
+  arma::mat k;
+  KernelMatrixRule<GaussianKernel>::Evaluate(data, data, kernel, k);
+  const arma::vec largeF = k * (largeAlpha % y) + largeBias;
+  const arma::vec smallF = k * (smallAlpha % y) + smallBias;
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_SMALL(largeF[i] - smallF[i], 1e-2);
+
+  BOOST_REQUIRE_GT(largeSMO.CacheHits(), smallSMO.CacheHits());
+  BOOST_REQUIRE_LT(largeSMO.CacheMisses(), smallSMO.CacheMisses());
+  BOOST_REQUIRE_LE(largeSMO.CacheMisses(), data.n_cols);
+}
+
+/**
+ * Make sure that several classes are classified with one-vs-one classifiers,
+ * and that a class without points is never predicted.
+ */
+BOOST_AUTO_TEST_CASE(KernelSVMMulticlassTest)
+{
+  math::RandomSeed(4);
+  arma::mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  const arma::mat centers("-5.0 0.0 5.0 0.0; 0.0 5.0 0.0 -5.0");
+  GenerateClouds(centers, 100, data, labels);
+  GenerateClouds(centers, 100, testData, testLabels);
+
+  KernelSVM<GaussianKernel> svm(data, labels, 5);
+
+  BOOST_REQUIRE_EQUAL(svm.NumClasses(), (size_t) 5);
+  BOOST_REQUIRE_EQUAL(svm.Biases().n_elem, (size_t) 10);
+  BOOST_REQUIRE_EQUAL(svm.Coefficients().n_cols, (size_t) 10);
+  BOOST_REQUIRE_EQUAL(svm.Iterations().n_elem, (size_t) 10);
+
+  arma::Row<size_t> predictions;
+  arma::mat scores;
+  svm.Classify(testData, predictions, scores);
+  BOOST_REQUIRE_EQUAL(scores.n_rows, (size_t) 10);
+  BOOST_REQUIRE_EQUAL(scores.n_cols, testData.n_cols);
+  BOOST_REQUIRE_LT(arma::max(predictions), (size_t) 4);
+  BOOST_REQUIRE_GT(svm.ComputeAccuracy(testData, testLabels), 95.0);
+
+  // The classifiers of the pairs with class 4 always vote for the other class.
+  BOOST_REQUIRE_LT(arma::max(scores.row(3)), 0.0);
+}
+
+/**
+ * Make sure that invalid labels and parameters are refused.
+ */
+BOOST_AUTO_TEST_CASE(KernelSVMInvalidParametersTest)
+{
+  arma::mat data(2, 10, arma::fill::randu);
+  arma::Row<size_t> labels("0 1 0 1 0 1 0 1 0 2");
+
+  KernelSVM<> svm;
+  BOOST_REQUIRE_THROW(svm.Train(data, labels, 2), std::invalid_argument);
+  BOOST_REQUIRE_THROW(svm.Train(data, labels.head(5), 3),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(svm.Train(data, labels, 1), std::invalid_argument);
+
+  svm.CacheSize() = 0.0;
+  BOOST_REQUIRE_THROW(svm.Train(data, labels, 3), std::invalid_argument);
+  svm.CacheSize() = 100.0;
+  svm.C() = -1.0;
+  BOOST_REQUIRE_THROW(svm.Train(data, labels, 3), std::invalid_argument);
+
+  svm.C() = 1.0;
+  svm.Train(data, labels, 3);
+  arma::Row<size_t> predictions;
+  BOOST_REQUIRE_THROW(svm.Classify(arma::mat(3, 5, arma::fill::randu),
+      predictions), std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized model gives the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(KernelSVMSerializationTest)
+{
+  math::RandomSeed(5);
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateClouds(arma::mat("-3.0 0.0 3.0; 0.0 3.0 0.0"), 50, data, labels);
+
+  KernelSVM<PolynomialKernel> svm(data, labels, 3, 2.0, 1e-3, false, 10.0, 0,
+      PolynomialKernel(2.0, 1.0));
+  KernelSVM<PolynomialKernel> xmlSVM, textSVM, binarySVM;
+  SerializeObjectAll(svm, xmlSVM, textSVM, binarySVM);
+
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions;
+  svm.Classify(data, predictions);
+  xmlSVM.Classify(data, xmlPredictions);
+  textSVM.Classify(data, textPredictions);
+  binarySVM.Classify(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  BOOST_REQUIRE_CLOSE(xmlSVM.C(), 2.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(binarySVM.Shrinking(), false);
+  BOOST_REQUIRE_EQUAL(textSVM.NumClasses(), (size_t) 3);
+  BOOST_REQUIRE_CLOSE(textSVM.Kernel().Degree(), 2.0, 1e-5);
+}
+
+/**
+ * Make sure that the model of the binding holds the kernel SVM of the chosen
+ * kernel, and survives serialization.
+ */
+BOOST_AUTO_TEST_CASE(KernelSVMModelTest)
+{
+  math::RandomSeed(6);
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateRings(100, data, labels);
+
+  KernelSVMModel model;
+  model.Train(data, labels, 2, LaplacianKernel(1.0), 10.0, 1e-3, true, 10.0,
+      0);
+  BOOST_REQUIRE_EQUAL(model.KernelType(), KernelSVMModel::LAPLACIAN_KERNEL);
+  BOOST_REQUIRE_EQUAL(model.Dimensionality(), (size_t) 2);
+
+  KernelSVM<LaplacianKernel> svm(data, labels, 2, 10.0, 1e-3, true, 10.0, 0,
+      LaplacianKernel(1.0));
+
+  KernelSVMModel xmlModel, textModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions, svmPredictions;
+  arma::mat scores, svmScores;
+  model.Classify(data, predictions, scores);
+  xmlModel.Classify(data, xmlPredictions, scores);
+  textModel.Classify(data, textPredictions, scores);
+  binaryModel.Classify(data, binaryPredictions, scores);
+  svm.Classify(data, svmPredictions, svmScores);
+
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(predictions, svmPredictions);
+  CheckMatrices(scores, svmScores);
+  BOOST_REQUIRE_EQUAL(textModel.KernelType(),
+      KernelSVMModel::LAPLACIAN_KERNEL);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
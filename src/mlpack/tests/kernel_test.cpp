@@ -15,9 +15,11 @@
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/core/kernels/hyperbolic_tangent_kernel.hpp>
 #include <mlpack/core/kernels/laplacian_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/core/kernels/polynomial_kernel.hpp>
 #include <mlpack/core/kernels/spherical_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
@@ -208,6 +210,41 @@ BOOST_AUTO_TEST_CASE(MDFullCovarianceTest)
   BOOST_REQUIRE_CLOSE(md.Evaluate(b, a), 15.7, 1e-5);
 }
 
+/**
+ * Make sure that the Mahalanobis distance is the Euclidean distance between the
+ * transformed points, for positive definite and singular covariance matrices.
+ */
+BOOST_AUTO_TEST_CASE(MDTransformationTest)
+{
+  arma::mat x = arma::randu<arma::mat>(4, 4);
+  arma::mat singular = arma::randu<arma::mat>(4, 2);
+  const arma::mat covariances[] = { x * x.t() + arma::eye<arma::mat>(4, 4),
+      singular * singular.t() };
+
+  for (const arma::mat& cov : covariances)
+  {
+    MahalanobisDistance<true> md(cov);
+    const arma::mat l = md.Transformation();
+    BOOST_REQUIRE_EQUAL(l.n_cols, 4);
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+      arma::vec a = arma::randu<arma::vec>(4);
+      arma::vec b = arma::randu<arma::vec>(4);
+      BOOST_REQUIRE_CLOSE(md.Evaluate(a, b), arma::norm(l * a - l * b),
+          1e-5);
+    }
+  }
+
+  // Without a covariance matrix, the transformation is empty.
+  MahalanobisDistance<true> empty;
+  BOOST_REQUIRE_EQUAL(empty.Transformation().n_elem, 0);
+
+  // Matrices with negative eigenvalues are refused.
+  MahalanobisDistance<true> negative(-arma::eye<arma::mat>(3, 3));
+  BOOST_REQUIRE_THROW(negative.Transformation(), std::invalid_argument);
+}
+
 /**
  * Simple test case for the cosine distance.
  */
@@ -608,4 +645,146 @@ BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
   BOOST_REQUIRE_CLOSE(p.Evaluate(b, a), 11.0, 1e-5);
 }
 
+/**
+ * Check the kernel matrices computed by KernelMatrix() and PackedKernelMatrix()
+ * against kernel evaluations.  There are more points than the size of a tile.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(KernelType& kernel)
+{
+  arma::mat data(3, 1030, arma::fill::randu);
+  arma::mat queries(3, 40, arma::fill::randu);
+
+  arma::mat symmetric;
+  KernelMatrix(data, kernel, symmetric);
+  arma::fmat single;
+  KernelMatrix(data, kernel, single);
+  arma::vec packed;
+  PackedKernelMatrix(data, kernel, packed);
+
+  BOOST_REQUIRE_EQUAL(symmetric.n_rows, data.n_cols);
+  BOOST_REQUIRE_EQUAL(symmetric.n_cols, data.n_cols);
+  BOOST_REQUIRE_EQUAL(single.n_rows, data.n_cols);
+  BOOST_REQUIRE_EQUAL(single.n_cols, data.n_cols);
+  BOOST_REQUIRE_EQUAL(packed.n_elem, data.n_cols * (data.n_cols + 1) / 2);
+
+  for (size_t j = 0; j < data.n_cols; ++j)
+  {
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const double value = kernel.Evaluate(data.col(i), data.col(j));
+      BOOST_REQUIRE_SMALL(symmetric(i, j) - value, 1e-8);
+      BOOST_REQUIRE_SMALL(single(i, j) - value, 1e-5);
+      if (i <= j)
+        BOOST_REQUIRE_SMALL(packed[j * (j + 1) / 2 + i] - value, 1e-8);
+    }
+  }
+
+  arma::mat cross;
+  KernelMatrix(queries, data, kernel, cross);
+  BOOST_REQUIRE_EQUAL(cross.n_rows, queries.n_cols);
+  BOOST_REQUIRE_EQUAL(cross.n_cols, data.n_cols);
+  for (size_t j = 0; j < data.n_cols; ++j)
+  {
+    for (size_t i = 0; i < queries.n_cols; ++i)
+    {
+      BOOST_REQUIRE_SMALL(cross(i, j) -
+          kernel.Evaluate(queries.col(i), data.col(j)), 1e-8);
+    }
+  }
+}
+
+/**
+ * A kernel that hides the batch Evaluate() function of another kernel, so that
+ * its kernel matrices are computed one pair of points at a time.
+ */
+template<typename KernelType>
+class PairwiseKernel
+{
+ public:
+  PairwiseKernel(const KernelType& kernel) : kernel(kernel) { }
+
+  template<typename VecTypeA, typename VecTypeB>
+  double Evaluate(const VecTypeA& a, const VecTypeB& b)
+  {
+    return kernel.Evaluate(a, b);
+  }
+
+ private:
+  KernelType kernel;
+};
+
+/**
+ * Test the kernel matrices of the kernels with a batch Evaluate() function.
+ */
+BOOST_AUTO_TEST_CASE(KernelMatrixSpecializedTest)
+{
+  LinearKernel linear;
+  CheckKernelMatrix(linear);
+
+  PolynomialKernel polynomial(3, 0.5);
+  CheckKernelMatrix(polynomial);
+
+  GaussianKernel gaussian(0.7);
+  CheckKernelMatrix(gaussian);
+
+  EpanechnikovKernel epanechnikov(0.9);
+  CheckKernelMatrix(epanechnikov);
+
+  LaplacianKernel laplacian(0.6);
+  CheckKernelMatrix(laplacian);
+
+  SphericalKernel spherical(0.8);
+  CheckKernelMatrix(spherical);
+
+  TriangularKernel triangular(1.2);
+  CheckKernelMatrix(triangular);
+
+  HyperbolicTangentKernel hyperbolicTangent(0.5, -0.3);
+  CheckKernelMatrix(hyperbolicTangent);
+
+  CosineDistance cosine;
+  CheckKernelMatrix(cosine);
+}
+
+/**
+ * Test the kernel matrix of a kernel without a batch Evaluate() function.
+ */
+BOOST_AUTO_TEST_CASE(KernelMatrixGenericTest)
+{
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<PairwiseKernel<EpanechnikovKernel>>::
+      HasBatchEvaluate, false);
+
+  PairwiseKernel<EpanechnikovKernel> epanechnikov(EpanechnikovKernel(0.9));
+  CheckKernelMatrix(epanechnikov);
+}
+
+/**
+ * The cosine distance involving a zero vector must be 0 in the batch
+ * evaluation too.
+ */
+BOOST_AUTO_TEST_CASE(CosineDistanceBatchZeroTest)
+{
+  arma::mat a(4, 3, arma::fill::randu);
+  arma::mat b(4, 5, arma::fill::randu);
+  a.col(1).zeros();
+  b.col(2).zeros();
+
+  arma::mat out;
+  CosineDistance::Evaluate(a, b, out);
+
+  BOOST_REQUIRE_EQUAL(out.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(out.n_cols, 5);
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      BOOST_REQUIRE_SMALL(out(i, j) -
+          CosineDistance::Evaluate(a.col(i), b.col(j)), 1e-10);
+    }
+  }
+  BOOST_REQUIRE_EQUAL(out(1, 0), 0.0);
+  BOOST_REQUIRE_EQUAL(out(0, 2), 0.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
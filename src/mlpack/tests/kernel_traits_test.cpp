@@ -61,4 +61,33 @@ BOOST_AUTO_TEST_CASE(IsNormalizedTest)
       false);
 }
 
+/**
+ * Check the kernels that declare a batch Evaluate() function.
+ */
+BOOST_AUTO_TEST_CASE(HasBatchEvaluateTest)
+{
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<int>::HasBatchEvaluate, false);
+  BOOST_REQUIRE_EQUAL(
+      (bool) KernelTraits<PSpectrumStringKernel>::HasBatchEvaluate, false);
+
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<CosineDistance>::HasBatchEvaluate,
+      true);
+  BOOST_REQUIRE_EQUAL(
+      (bool) KernelTraits<EpanechnikovKernel>::HasBatchEvaluate, true);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<GaussianKernel>::HasBatchEvaluate,
+      true);
+  BOOST_REQUIRE_EQUAL(
+      (bool) KernelTraits<HyperbolicTangentKernel>::HasBatchEvaluate, true);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<LaplacianKernel>::HasBatchEvaluate,
+      true);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<LinearKernel>::HasBatchEvaluate,
+      true);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<PolynomialKernel>::HasBatchEvaluate,
+      true);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<SphericalKernel>::HasBatchEvaluate,
+      true);
+  BOOST_REQUIRE_EQUAL((bool) KernelTraits<TriangularKernel>::HasBatchEvaluate,
+      true);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
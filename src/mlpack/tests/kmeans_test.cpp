@@ -11,13 +11,18 @@
 
 #include <mlpack/methods/kmeans/kmeans.hpp>
 #include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
+#include <mlpack/methods/kmeans/centroid_distance.hpp>
 #include <mlpack/methods/kmeans/refined_start.hpp>
 #include <mlpack/methods/kmeans/elkan_kmeans.hpp>
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/yinyang_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
+#include <mlpack/methods/kmeans/kmeans_autotune.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
@@ -534,6 +539,104 @@ BOOST_AUTO_TEST_CASE(SparseKMeansTest)
   BOOST_REQUIRE_EQUAL(assignments[11], clusterTwo);
 }
 
+/**
+ * The sparse-dense distances should match the distances computed by the
+ * metric on dense data.
+ */
+BOOST_AUTO_TEST_CASE(SparseCentroidDistanceTest)
+{
+  arma::sp_mat data;
+  data.sprandu(40, 100, 0.1);
+  const arma::mat denseData(data);
+  arma::mat centroids(40, 6, arma::fill::randu);
+
+  metric::EuclideanDistance metric;
+  CentroidDistance<metric::EuclideanDistance, arma::sp_mat> distances(data,
+      metric);
+  distances.Centroids(centroids);
+
+  metric::SquaredEuclideanDistance squaredMetric;
+  CentroidDistance<metric::SquaredEuclideanDistance, arma::sp_mat>
+      squaredDistances(data, squaredMetric);
+  squaredDistances.Centroids(centroids);
+
+  arma::mat sums(40, 6, arma::fill::zeros);
+  arma::mat denseSums(40, 6, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t c = 0; c < centroids.n_cols; ++c)
+    {
+      BOOST_REQUIRE_CLOSE(distances.Evaluate(i, c),
+          metric.Evaluate(denseData.col(i), centroids.col(c)), 1e-5);
+      BOOST_REQUIRE_CLOSE(squaredDistances.Evaluate(i, c),
+          squaredMetric.Evaluate(denseData.col(i), centroids.col(c)), 1e-5);
+    }
+
+    distances.AddPoint(sums, i, i % 6);
+    denseSums.col(i % 6) += denseData.col(i);
+  }
+
+  for (size_t i = 0; i < sums.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sums[i] + 1.0, denseSums[i] + 1.0, 1e-5);
+}
+
+/**
+ * Cluster sparse data with the given Lloyd step type, and make sure that the
+ * results are the same as for the dense data with the naive step.
+ */
+template<template<class, class> class LloydStepType>
+void CheckSparseLloydStep()
+{
+  for (size_t t = 0; t < 3; ++t)
+  {
+    arma::sp_mat data;
+    data.sprandu(100, 1000, 0.05);
+    const arma::mat denseData(data);
+
+    // Start from points of the dataset, so that no cluster is empty.
+    const size_t k = 5 * (t + 1);
+    arma::mat centroids(100, k);
+    for (size_t c = 0; c < k; ++c)
+      centroids.col(c) = denseData.col(c * 7);
+
+    KMeans<> km;
+    arma::Row<size_t> assignments;
+    arma::mat denseCentroids(centroids);
+    km.Cluster(denseData, k, assignments, denseCentroids, false, true);
+
+    KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        LloydStepType, arma::sp_mat> sparseKMeans;
+    arma::Row<size_t> sparseAssignments;
+    arma::mat sparseCentroids(centroids);
+    sparseKMeans.Cluster(data, k, sparseAssignments, sparseCentroids, false,
+        true);
+
+    for (size_t i = 0; i < data.n_cols; ++i)
+      BOOST_REQUIRE_EQUAL(assignments[i], sparseAssignments[i]);
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(denseCentroids[i] + 1.0, sparseCentroids[i] + 1.0,
+          1e-5);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SparseNaiveKMeansTest)
+{
+  CheckSparseLloydStep<NaiveKMeans>();
+}
+
+BOOST_AUTO_TEST_CASE(SparseElkanKMeansTest)
+{
+  CheckSparseLloydStep<ElkanKMeans>();
+}
+
+BOOST_AUTO_TEST_CASE(SparseHamerlyKMeansTest)
+{
+  CheckSparseLloydStep<HamerlyKMeans>();
+}
+
 #endif // ARMA_HAS_SPMAT
 
 BOOST_AUTO_TEST_CASE(ElkanTest)
@@ -605,6 +708,68 @@ BOOST_AUTO_TEST_CASE(HamerlyTest)
   }
 }
 
+/**
+ * Make sure Yinyang k-means gives the same result as the naive algorithm, with
+ * both the automatic number of groups and a single group.
+ */
+BOOST_AUTO_TEST_CASE(YinyangTest)
+{
+  const size_t trials = 5;
+
+  for (size_t t = 0; t < trials; ++t)
+  {
+    arma::mat dataset(10, 1000);
+    dataset.randu();
+
+    const size_t k = 10 * (t + 1);
+    arma::mat centroids(10, k);
+    centroids.randu();
+
+    arma::mat naiveCentroids(centroids);
+    KMeans<> km;
+    arma::Row<size_t> assignments;
+    km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+    KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        YinyangKMeans> yinyang;
+    arma::Row<size_t> yinyangAssignments;
+    arma::mat yinyangCentroids(centroids);
+    yinyang.Cluster(dataset, k, yinyangAssignments, yinyangCentroids, false,
+        true);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      BOOST_REQUIRE_EQUAL(assignments[i], yinyangAssignments[i]);
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(naiveCentroids[i], yinyangCentroids[i], 1e-5);
+
+    // Now run Lloyd steps by hand with a single group of centroids, next to
+    // the naive steps.
+    EuclideanDistance metric;
+    NaiveKMeans<EuclideanDistance, arma::mat> naiveStep(dataset, metric);
+    YinyangKMeans<EuclideanDistance, arma::mat> yinyangStep(dataset, metric,
+        1);
+    arma::mat naiveStepCentroids(centroids), yinyangStepCentroids(centroids);
+    arma::mat newNaiveCentroids, newYinyangCentroids;
+    arma::Col<size_t> naiveCounts, yinyangCounts;
+    for (size_t i = 0; i < 10; ++i)
+    {
+      naiveStep.Iterate(naiveStepCentroids, newNaiveCentroids, naiveCounts);
+      yinyangStep.Iterate(yinyangStepCentroids, newYinyangCentroids,
+          yinyangCounts);
+
+      for (size_t j = 0; j < k; ++j)
+        BOOST_REQUIRE_EQUAL(naiveCounts[j], yinyangCounts[j]);
+      for (size_t j = 0; j < centroids.n_elem; ++j)
+        BOOST_REQUIRE_CLOSE(newNaiveCentroids[j] + 1.0,
+            newYinyangCentroids[j] + 1.0, 1e-5);
+
+      naiveStepCentroids = newNaiveCentroids;
+      yinyangStepCentroids = newYinyangCentroids;
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(PellegMooreTest)
 {
   const size_t trials = 5;
@@ -703,6 +868,140 @@ BOOST_AUTO_TEST_CASE(DTNNCoverTreeTest)
   }
 }
 
+/**
+ * Run the given k-means type with several threads and make sure it gives the
+ * same clustering as the naive algorithm.
+ */
+template<typename KMeansType>
+void CheckParallelKMeans(const arma::mat& dataset,
+                         const arma::mat& centroids,
+                         const arma::Row<size_t>& naiveAssignments,
+                         const arma::mat& naiveCentroids)
+{
+  KMeansType km;
+  arma::Row<size_t> assignments;
+  arma::mat parallelCentroids(centroids);
+  km.Cluster(dataset, centroids.n_cols, assignments, parallelCentroids, false,
+      true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], naiveAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(parallelCentroids[i], naiveCentroids[i], 1e-5);
+}
+
+/**
+ * Make sure the parallel iterations of Elkan's, Hamerly's, Yinyang and the
+ * dual-tree algorithms give the same result as the naive algorithm.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBoundedKMeansTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+  #endif
+
+  arma::mat dataset(5, 3000);
+  dataset.randu();
+  arma::mat centroids(5, 20);
+  centroids.randu();
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, centroids.n_cols, assignments, naiveCentroids, false,
+      true);
+
+  CheckParallelKMeans<KMeans<EuclideanDistance, RandomPartition,
+      MaxVarianceNewCluster, ElkanKMeans>>(dataset, centroids, assignments,
+      naiveCentroids);
+  CheckParallelKMeans<KMeans<EuclideanDistance, RandomPartition,
+      MaxVarianceNewCluster, HamerlyKMeans>>(dataset, centroids, assignments,
+      naiveCentroids);
+  CheckParallelKMeans<KMeans<EuclideanDistance, RandomPartition,
+      MaxVarianceNewCluster, YinyangKMeans>>(dataset, centroids, assignments,
+      naiveCentroids);
+  CheckParallelKMeans<KMeans<EuclideanDistance, RandomPartition,
+      MaxVarianceNewCluster, DefaultDualTreeKMeans>>(dataset, centroids,
+      assignments, naiveCentroids);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+}
+
+/**
+ * Make sure that mini-batch k-means finds the clusters of the simple dataset.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans(100);
+
+  // Start from one point of each class.
+  const arma::mat data = trans(kMeansData);
+  arma::mat centroids(2, 3);
+  centroids.col(0) = data.col(1);
+  centroids.col(1) = data.col(14);
+  centroids.col(2) = data.col(21);
+
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, 3, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < 13; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], 0);
+  for (size_t i = 13; i < 20; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], 1);
+  for (size_t i = 20; i < 30; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], 2);
+}
+
+/**
+ * Make sure that streaming k-means on chunks of well-separated clusters gives
+ * the mean of each cluster: with the per-center learning rates, each centroid
+ * is the mean of all points assigned to it.
+ */
+BOOST_AUTO_TEST_CASE(ClusterStreamTest)
+{
+  arma::mat data(3, 600);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    data.col(i) = arma::randu<arma::vec>(3);
+    data(i % 3, i) += 20.0;
+  }
+
+  arma::mat centroids(3, 3, arma::fill::zeros);
+  centroids.diag().fill(20.0);
+
+  // Read the data in chunks of 70 points.
+  size_t begin = 0;
+  auto reader = [&](arma::mat& chunk)
+  {
+    if (begin >= data.n_cols)
+      return false;
+
+    const size_t end = std::min(begin + 70, size_t(data.n_cols));
+    chunk = data.cols(begin, end - 1);
+    begin = end;
+    return true;
+  };
+
+  KMeans<> kmeans;
+  kmeans.ClusterStream(reader, 3, centroids, true, 16);
+
+  for (size_t c = 0; c < 3; ++c)
+  {
+    arma::vec mean(3, arma::fill::zeros);
+    for (size_t i = c; i < data.n_cols; i += 3)
+      mean += data.col(i);
+    mean /= (data.n_cols / 3);
+
+    for (size_t d = 0; d < 3; ++d)
+      BOOST_REQUIRE_CLOSE(centroids(d, c), mean[d], 1e-5);
+  }
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -737,4 +1036,104 @@ BOOST_AUTO_TEST_CASE(SampleInitializationTest)
   }
 }
 
+/**
+ * Make sure the k-means|| initialization gives one centroid near each of the
+ * well-separated clusters, and that KMeans clusters correctly with it.
+ */
+BOOST_AUTO_TEST_CASE(KMeansParallelInitializationTest)
+{
+  arma::mat data(3, 3000);
+  data.randn();
+
+  arma::mat centroids(" 0 20 -20;"
+                      " 0 10  10;"
+                      " 0  0  20");
+  for (size_t i = 1000; i < 2000; ++i)
+    data.col(i) += centroids.col(1);
+  for (size_t i = 2000; i < 3000; ++i)
+    data.col(i) += centroids.col(2);
+
+  KMeansParallelInitialization kp(5, 2.0);
+  arma::mat initialCentroids;
+  kp.Cluster(data, 3, initialCentroids);
+
+  BOOST_REQUIRE_EQUAL(initialCentroids.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(initialCentroids.n_cols, 3);
+
+  // Each true centroid must have exactly one initial centroid near it.
+  for (size_t c = 0; c < 3; ++c)
+  {
+    size_t found = 0;
+    for (size_t i = 0; i < 3; ++i)
+      if (metric::EuclideanDistance::Evaluate(centroids.col(c),
+          initialCentroids.col(i)) < 3.0)
+        ++found;
+
+    BOOST_REQUIRE_EQUAL(found, 1);
+  }
+
+  // Now cluster with the initialization and check the assignments.
+  KMeans<EuclideanDistance, KMeansParallelInitialization> kmeans;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, 3, assignments);
+
+  for (size_t i = 1; i < 1000; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[0]);
+  for (size_t i = 1001; i < 2000; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[1000]);
+  for (size_t i = 2001; i < 3000; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[2000]);
+
+  BOOST_REQUIRE_NE(assignments[0], assignments[1000]);
+  BOOST_REQUIRE_NE(assignments[0], assignments[2000]);
+  BOOST_REQUIRE_NE(assignments[1000], assignments[2000]);
+}
+
+/**
+ * Make sure that autotuning chooses one of the exact step types, caches the
+ * choice for datasets of about the same shape, and that the cache survives a
+ * round trip through a file.
+ */
+BOOST_AUTO_TEST_CASE(KMeansAutotuneTest)
+{
+  Autotune::Clear();
+
+  arma::mat centroids(4, 5, arma::fill::randu);
+  centroids *= 20.0;
+  arma::mat data(4, 2000, arma::fill::randn);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data.col(i) += centroids.col(i % 5);
+
+  const std::string choice = SelectLloydStepType(data, 5, 500, 2);
+  const std::vector<std::string> candidates = { "naive", "elkan", "hamerly",
+      "pelleg-moore", "dualtree", "yinyang" };
+  BOOST_REQUIRE(std::find(candidates.begin(), candidates.end(), choice) !=
+      candidates.end());
+
+  // A dataset of about the same shape must get the cached choice without
+  // being timed; make the cached choice one that is unlikely to win.
+  const std::string key = Autotune::Key("kmeans/lloyd_step", data.n_cols,
+      data.n_rows, 5);
+  Autotune::Store(key, "pelleg-moore");
+  arma::mat similar(4, 1900, arma::fill::randn);
+  BOOST_REQUIRE_EQUAL(SelectLloydStepType(similar, 5), "pelleg-moore");
+
+  // Save and load the cache.
+  const std::string file = "kmeans_autotune_test.txt";
+  Autotune::Save(file);
+  Autotune::Clear();
+  std::string cached;
+  BOOST_REQUIRE(!Autotune::Lookup(key, cached));
+  Autotune::Load(file);
+  BOOST_REQUIRE(Autotune::Lookup(key, cached));
+  BOOST_REQUIRE_EQUAL(cached, "pelleg-moore");
+
+  remove(file.c_str());
+  Autotune::Clear();
+
+  // With as many clusters as points there is nothing to time.
+  BOOST_REQUIRE_EQUAL(SelectLloydStepType(arma::mat(data.cols(0, 4)), 5),
+      "naive");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,6 +12,7 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/ns_autotune.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
 #include <boost/test/unit_test.hpp>
@@ -1225,6 +1226,131 @@ BOOST_AUTO_TEST_CASE(KNNModelMonochromaticTest)
   }
 }
 
+/**
+ * Make sure that an NSModel built on a single precision reference set returns
+ * the same neighbors as a double precision search, and that it survives
+ * serialization.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelSinglePrecisionTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+
+  // Get a baseline.
+  KNN knn(referenceData);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  knn.Search(queryData, 3, baselineNeighbors, baselineDistances);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::KD_TREE,
+      KNNModel::COVER_TREE, KNNModel::R_TREE, KNNModel::BALL_TREE,
+      KNNModel::VP_TREE, KNNModel::OCTREE };
+
+  for (const KNNModel::TreeTypes treeType : treeTypes)
+  {
+    KNNModel model(treeType);
+    arma::fmat referenceCopy = arma::conv_to<arma::fmat>::from(referenceData);
+    model.BuildModel(std::move(referenceCopy), 20, DUAL_TREE_MODE);
+
+    BOOST_REQUIRE(model.SinglePrecision());
+    BOOST_REQUIRE_EQUAL(model.Dimensionality(), referenceData.n_rows);
+    BOOST_REQUIRE_EQUAL(model.NumPoints(), referenceData.n_cols);
+    BOOST_REQUIRE_THROW(model.Dataset(), std::invalid_argument);
+
+    // Round-trip the model through a file.
+    data::Save("knn_float_model.xml", "knn_model", model);
+    KNNModel loadedModel;
+    data::Load("knn_float_model.xml", "knn_model", loadedModel);
+    remove("knn_float_model.xml");
+    BOOST_REQUIRE(loadedModel.SinglePrecision());
+
+    arma::mat queryCopy(queryData);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    loadedModel.Search(std::move(queryCopy), 3, neighbors, distances);
+
+    BOOST_REQUIRE_EQUAL(neighbors.n_rows, baselineNeighbors.n_rows);
+    BOOST_REQUIRE_EQUAL(neighbors.n_cols, baselineNeighbors.n_cols);
+    for (size_t k = 0; k < distances.n_elem; ++k)
+    {
+      // Single precision may swap neighbors with (nearly) equal distances, so
+      // only the distances are compared.
+      BOOST_REQUIRE_CLOSE(distances[k], baselineDistances[k], 1e-3);
+    }
+  }
+}
+
+/**
+ * Make sure that searching a query set given to SetQuerySet() several times
+ * gives the same results as Search(), with and without kept results.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelQuerySetTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::KD_TREE,
+      KNNModel::COVER_TREE, KNNModel::R_TREE, KNNModel::BALL_TREE,
+      KNNModel::OCTREE };
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE };
+
+  for (const KNNModel::TreeTypes treeType : treeTypes)
+  {
+    for (const NeighborSearchMode mode : modes)
+    {
+      for (size_t cache = 0; cache < 2; ++cache)
+      {
+        KNNModel model(treeType);
+        arma::mat referenceCopy(referenceData);
+        model.BuildModel(std::move(referenceCopy), 5, mode);
+
+        arma::mat queryCopy(queryData);
+        model.SetQuerySet(std::move(queryCopy), cache == 1);
+        BOOST_REQUIRE(model.HasQuerySet());
+
+        // Search for the largest k first, so the others can use the kept
+        // results.
+        const size_t ks[] = { 5, 3, 1 };
+        for (const size_t k : ks)
+        {
+          arma::Mat<size_t> baselineNeighbors;
+          arma::mat baselineDistances;
+          arma::mat baselineQuery(queryData);
+          model.Search(std::move(baselineQuery), k, baselineNeighbors,
+              baselineDistances);
+
+          // Search twice, so that the query tree is reused.
+          for (size_t trial = 0; trial < 2; ++trial)
+          {
+            arma::Mat<size_t> neighbors;
+            arma::mat distances;
+            model.SearchQuerySet(k, neighbors, distances);
+
+            BOOST_REQUIRE_EQUAL(neighbors.n_rows, k);
+            BOOST_REQUIRE_EQUAL(neighbors.n_cols, queryData.n_cols);
+            for (size_t i = 0; i < distances.n_elem; ++i)
+            {
+              BOOST_REQUIRE_EQUAL(neighbors[i], baselineNeighbors[i]);
+              BOOST_REQUIRE_CLOSE(distances[i], baselineDistances[i], 1e-5);
+            }
+          }
+        }
+
+        model.ClearQuerySet();
+        BOOST_REQUIRE(!model.HasQuerySet());
+        arma::Mat<size_t> neighbors;
+        arma::mat distances;
+        BOOST_REQUIRE_THROW(model.SearchQuerySet(1, neighbors, distances),
+            std::invalid_argument);
+      }
+    }
+  }
+}
+
 /**
  * If we search twice with the same reference tree, the bounds need to be reset
  * before the second search.  This test ensures that that happens, by making
@@ -1466,4 +1592,711 @@ BOOST_AUTO_TEST_CASE(GreedyTreeSearch)
       0);
 }
 
+/**
+ * Make sure that the parallel dual-tree traversal with the given tree type
+ * finds the same neighbors as the naive method, both for a separate query set
+ * and for the monochromatic search.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ParallelDualTreeTest()
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 700);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  ParallelKNN<TreeType> parallel(referenceData);
+
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+
+  naive.Search(queryData, 4, naiveNeighbors, naiveDistances);
+  parallel.Search(queryData, 4, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+
+  naive.Search(4, naiveNeighbors, naiveDistances);
+  parallel.Search(4, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Test the parallel dual-tree traversal with kd-trees, ball trees and cover
+ * trees.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeSearchTest)
+{
+  ParallelDualTreeTest<KDTree>();
+  ParallelDualTreeTest<BallTree>();
+  ParallelDualTreeTest<StandardCoverTree>();
+}
+
+/**
+ * Use the parallel traverser directly, with many small query subtrees, and make
+ * sure the rules collect the correct results and counters.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeTraverserTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance, TreeType>
+      RuleType;
+
+  TreeType tree(dataset, 5);
+  EuclideanDistance metric;
+  RuleType rules(tree.Dataset(), tree.Dataset(), 3, metric, 0, true);
+
+  ParallelDualTreeTraverser<RuleType> traverser(rules, 64);
+  traverser.Traverse(tree, tree);
+
+  // The base cases of all copies of the rules are counted.
+  BOOST_REQUIRE_GT(rules.BaseCases(), 0);
+  BOOST_REQUIRE_LE(rules.BaseCases(), 500 * 500);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  rules.GetResults(neighbors, distances);
+
+  KNN naive(tree.Dataset(), NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(3, naiveNeighbors, naiveDistances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that a copy of the rules owns its candidate lists and outlives the
+ * original, while a SharedResults copy updates the lists of the original.
+ */
+BOOST_AUTO_TEST_CASE(NeighborSearchRulesCopyTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 100);
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance, TreeType>
+      RuleType;
+
+  EuclideanDistance metric;
+  RuleType* rules = new RuleType(dataset, dataset, 1, metric, 0, true);
+  {
+    RuleType sharedRules(*rules, SharedResults());
+    for (size_t j = 1; j < dataset.n_cols; ++j)
+      sharedRules.BaseCase(0, j);
+  }
+
+  RuleType copy(*rules);
+  delete rules;
+
+  // The copy holds the neighbor that the shared copy found.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  copy.GetResults(neighbors, distances);
+
+  size_t nearest = 1;
+  for (size_t j = 2; j < dataset.n_cols; ++j)
+  {
+    if (arma::norm(dataset.col(0) - dataset.col(j)) <
+        arma::norm(dataset.col(0) - dataset.col(nearest)))
+      nearest = j;
+  }
+  BOOST_REQUIRE_EQUAL(neighbors(0, 0), nearest);
+  BOOST_REQUIRE_CLOSE(distances(0, 0),
+      arma::norm(dataset.col(0) - dataset.col(nearest)), 1e-5);
+
+  // The other query points have no candidates yet.
+  BOOST_REQUIRE_EQUAL(neighbors(0, 1), (size_t) -1);
+}
+
+/**
+ * Make sure that the naive and single-tree searches find the same neighbors as
+ * the dual-tree search when the queries are split across several threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeSearchTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+  #endif
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 800);
+  arma::mat queryData = arma::randu<arma::mat>(3, 500);
+
+  KNN dualTree(referenceData);
+  KNN naive(referenceData, NAIVE_MODE);
+  KNN singleTree(referenceData, SINGLE_TREE_MODE);
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> coverTree(referenceData, SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> dualNeighbors, naiveNeighbors, singleNeighbors,
+      coverNeighbors;
+  arma::mat dualDistances, naiveDistances, singleDistances, coverDistances;
+
+  // Search with a separate query set, and then the monochromatic search.
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    if (trial == 0)
+    {
+      dualTree.Search(queryData, 3, dualNeighbors, dualDistances);
+      naive.Search(queryData, 3, naiveNeighbors, naiveDistances);
+      singleTree.Search(queryData, 3, singleNeighbors, singleDistances);
+      coverTree.Search(queryData, 3, coverNeighbors, coverDistances);
+    }
+    else
+    {
+      dualTree.Search(3, dualNeighbors, dualDistances);
+      naive.Search(3, naiveNeighbors, naiveDistances);
+      singleTree.Search(3, singleNeighbors, singleDistances);
+      coverTree.Search(3, coverNeighbors, coverDistances);
+    }
+
+    for (size_t i = 0; i < dualNeighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(naiveNeighbors[i], dualNeighbors[i]);
+      BOOST_REQUIRE_EQUAL(singleNeighbors[i], dualNeighbors[i]);
+      BOOST_REQUIRE_EQUAL(coverNeighbors[i], dualNeighbors[i]);
+      BOOST_REQUIRE_CLOSE(naiveDistances[i], dualDistances[i], 1e-5);
+      BOOST_REQUIRE_CLOSE(singleDistances[i], dualDistances[i], 1e-5);
+      BOOST_REQUIRE_CLOSE(coverDistances[i], dualDistances[i], 1e-5);
+    }
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+}
+
+/**
+ * Make sure that searching a compacted tree gives the same results as the
+ * naive search.
+ */
+BOOST_AUTO_TEST_CASE(CompactTreeSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+  for (size_t layout = 0; layout < 2; ++layout)
+  {
+    const NodeLayout nodeLayout = (layout == 0) ? BREADTH_FIRST_LAYOUT :
+        VAN_EMDE_BOAS_LAYOUT;
+
+    std::vector<size_t> oldFromNew;
+    KNN::Tree dualTreeTree(referenceData, oldFromNew);
+    dualTreeTree.Compact(nodeLayout);
+    KNN::Tree singleTreeTree(referenceData);
+    singleTreeTree.Compact(nodeLayout);
+
+    KNN dualTree(std::move(dualTreeTree));
+    KNN singleTree(std::move(singleTreeTree), SINGLE_TREE_MODE);
+
+    arma::Mat<size_t> dualNeighbors, singleNeighbors;
+    arma::mat dualDistances, singleDistances;
+    dualTree.Search(queryData, 5, dualNeighbors, dualDistances);
+    singleTree.Search(queryData, 5, singleNeighbors, singleDistances);
+
+    for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(oldFromNew[dualNeighbors[i]], naiveNeighbors[i]);
+      BOOST_REQUIRE_EQUAL(oldFromNew[singleNeighbors[i]], naiveNeighbors[i]);
+      BOOST_REQUIRE_CLOSE(dualDistances[i], naiveDistances[i], 1e-5);
+      BOOST_REQUIRE_CLOSE(singleDistances[i], naiveDistances[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that the dual-tree search with large leaves, where all base cases
+ * between two leaves are evaluated at once, gives the same results as the
+ * naive search, also for duplicated points.
+ */
+BOOST_AUTO_TEST_CASE(LeafBaseCaseSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(30, 500);
+  arma::mat queryData = arma::join_rows(arma::randu<arma::mat>(30, 100),
+      referenceData.cols(0, 99));
+  referenceData.cols(400, 499) = referenceData.cols(0, 99);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(queryData, 4, naiveNeighbors, naiveDistances);
+
+  std::vector<size_t> oldFromNewReferences;
+  KNN::Tree tree(referenceData, oldFromNewReferences, 40);
+  KNN dualTree(std::move(tree));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  dualTree.Search(queryData, 4, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    // Duplicated points may be returned in either order.
+    BOOST_REQUIRE_SMALL(arma::norm(referenceData.col(
+        oldFromNewReferences[neighbors[i]]) -
+        referenceData.col(naiveNeighbors[i])), 1e-10);
+    if (naiveDistances[i] < 1e-10)
+      BOOST_REQUIRE_SMALL(distances[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Search a shared const model from several threads at once, and make sure the
+ * results are the same as those of a search from one thread.
+ */
+template<typename NSType>
+void CheckConcurrentSearch(const NSType& model,
+                           const arma::mat& queryData)
+{
+  arma::Mat<size_t> neighbors, monoNeighbors;
+  arma::mat distances, monoDistances;
+  tree::SearchContext context;
+  model.Search(queryData, 3, neighbors, distances, context);
+  model.Search(3, monoNeighbors, monoDistances, context);
+
+  // Each query point is searched for by one thread, and one more thread runs
+  // the monochromatic search at the same time.
+  const size_t n = queryData.n_cols;
+  std::vector<arma::Mat<size_t>> threadNeighbors(n + 1);
+  std::vector<arma::mat> threadDistances(n + 1);
+  size_t threadBaseCases = 0;
+
+  #pragma omp parallel for schedule(dynamic, 1) reduction(+:threadBaseCases)
+  for (omp_size_t i = 0; i < (omp_size_t) (n + 1); ++i)
+  {
+    tree::SearchContext threadContext;
+    if ((size_t) i < n)
+    {
+      model.Search(queryData.col(i), 3, threadNeighbors[i],
+          threadDistances[i], threadContext);
+    }
+    else
+    {
+      model.Search(3, threadNeighbors[i], threadDistances[i], threadContext);
+    }
+    threadBaseCases += threadContext.BaseCases();
+  }
+  BOOST_REQUIRE_GT(threadBaseCases, 0);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(threadNeighbors[i](j, 0), neighbors(j, i));
+      BOOST_REQUIRE_CLOSE(threadDistances[i](j, 0), distances(j, i), 1e-5);
+    }
+  }
+
+  for (size_t i = 0; i < monoNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(threadNeighbors[n][i], monoNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(threadDistances[n][i], monoDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that const models can be searched from several threads at once.
+ */
+BOOST_AUTO_TEST_CASE(ConcurrentSearchTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+  #endif
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 600);
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+
+  const KNN dualTree(referenceData);
+  const KNN singleTree(referenceData, SINGLE_TREE_MODE);
+  const KNN naive(referenceData, NAIVE_MODE);
+  const NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> coverTree(referenceData, SINGLE_TREE_MODE);
+  const NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> dualCoverTree(referenceData);
+
+  CheckConcurrentSearch(dualTree, queryData);
+  CheckConcurrentSearch(singleTree, queryData);
+  CheckConcurrentSearch(naive, queryData);
+  CheckConcurrentSearch(coverTree, queryData);
+  CheckConcurrentSearch(dualCoverTree, queryData);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+}
+
+/**
+ * Make sure that the results of a search after insertions and deletions are
+ * the same as those of a naive search on the remaining points.  The columns
+ * of points are the points with each index.
+ */
+template<typename NSType>
+void CheckUpdatedSearch(NSType& knn,
+                        const arma::mat& points,
+                        const std::vector<bool>& live,
+                        const arma::mat& queryData)
+{
+  // Collect the remaining points.
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < live.size(); ++i)
+    if (live[i])
+      indices.push_back(i);
+  arma::mat livePoints(points.n_rows, indices.size());
+  for (size_t i = 0; i < indices.size(); ++i)
+    livePoints.col(i) = points.col(indices[i]);
+
+  BOOST_REQUIRE_EQUAL(knn.NumReferencePoints(), indices.size());
+
+  KNN naive(livePoints, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+  knn.Search(queryData, 5, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, queryData.n_cols);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], indices[naiveNeighbors[i]]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+
+  // The monochromatic results are indexed by the indices of the points.
+  naive.Search(5, naiveNeighbors, naiveDistances);
+  knn.Search(5, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, live.size());
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    if (!live[i])
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(0, i), size_t() - 1);
+      BOOST_REQUIRE_EQUAL(distances(0, i), DBL_MAX);
+    }
+  }
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, indices[i]),
+          indices[naiveNeighbors(j, i)]);
+      BOOST_REQUIRE_CLOSE(distances(j, indices[i]), naiveDistances(j, i),
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Insert and delete points, and make sure the results stay correct.
+ */
+template<typename NSType>
+void UpdatedSearchTest()
+{
+  arma::mat points = arma::randu<arma::mat>(4, 600);
+  arma::mat queryData = arma::randu<arma::mat>(4, 100);
+  std::vector<bool> live(300, true);
+
+  NSType knn(arma::mat(points.cols(0, 299)));
+
+  // Insert a few points at a time, and delete some of them and some of the
+  // original points.
+  for (size_t i = 300; i < 600; i += 30)
+  {
+    knn.Insert(points.cols(i, i + 29));
+    live.resize(i + 30, true);
+
+    for (size_t j = 0; j < 10; ++j)
+    {
+      const size_t index = math::RandInt(i + 30);
+      BOOST_REQUIRE_EQUAL(knn.Delete(index), live[index]);
+      live[index] = false;
+    }
+
+    CheckUpdatedSearch(knn, points, live, queryData);
+  }
+
+  // Indices that were never given out cannot be deleted.
+  BOOST_REQUIRE_EQUAL(knn.Delete(600), false);
+
+  // The indices do not change when the tree is rebuilt.
+  knn.Rebuild();
+  CheckUpdatedSearch(knn, points, live, queryData);
+
+  // Make sure that the results are right without rebuilding, too.
+  NSType buffered(arma::mat(points.cols(0, 299)));
+  buffered.RebuildFraction() = 10.0;
+  buffered.Insert(points.cols(300, 599));
+  live.assign(600, true);
+  for (size_t i = 0; i < 600; i += 7)
+  {
+    BOOST_REQUIRE_EQUAL(buffered.Delete(i), true);
+    live[i] = false;
+  }
+  CheckUpdatedSearch(buffered, points, live, queryData);
+}
+
+/**
+ * Make sure insertions and deletions work with trees that are rebuilt.
+ */
+BOOST_AUTO_TEST_CASE(KDTreeUpdatedSearchTest)
+{
+  UpdatedSearchTest<KNN>();
+}
+
+/**
+ * Make sure insertions and deletions work with trees that support them.
+ */
+BOOST_AUTO_TEST_CASE(RTreeUpdatedSearchTest)
+{
+  UpdatedSearchTest<NeighborSearch<NearestNeighborSort, EuclideanDistance,
+      arma::mat, RTree>>();
+}
+
+/**
+ * Make sure insertions and deletions work with naive search.
+ */
+BOOST_AUTO_TEST_CASE(NaiveUpdatedSearchTest)
+{
+  arma::mat points = arma::randu<arma::mat>(3, 200);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+  std::vector<bool> live(200, true);
+
+  KNN knn(arma::mat(points.cols(0, 99)), NAIVE_MODE);
+  knn.Insert(points.cols(100, 199));
+  for (size_t i = 0; i < 50; ++i)
+  {
+    const size_t index = math::RandInt(200);
+    BOOST_REQUIRE_EQUAL(knn.Delete(index), live[index]);
+    live[index] = false;
+  }
+
+  CheckUpdatedSearch(knn, points, live, queryData);
+}
+
+/**
+ * Make sure that autotuning sets a tree type and leaf size in the model that
+ * give the same results as naive search.
+ */
+BOOST_AUTO_TEST_CASE(SelectTreeTypeTest)
+{
+  Autotune::Clear();
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  NSModel<NearestNeighborSort> model;
+  const std::string choice = SelectTreeType(model, dataset, 3, DUAL_TREE_MODE,
+      0.0, 200);
+  BOOST_REQUIRE_NE(choice.find(':'), std::string::npos);
+  BOOST_REQUIRE_GT(model.LeafSize(), 0);
+
+  model.BuildModel(arma::mat(dataset), model.LeafSize(), DUAL_TREE_MODE);
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  model.Search(3, neighbors, distances);
+
+  KNN naive(dataset, NAIVE_MODE);
+  naive.Search(3, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // The choice is cached, and naive search is left alone.
+  std::string cached;
+  BOOST_REQUIRE(Autotune::Lookup(Autotune::Key("neighbor_search/tree:mode=" +
+      std::to_string((int) DUAL_TREE_MODE), dataset.n_cols, dataset.n_rows, 3),
+      cached));
+  BOOST_REQUIRE_EQUAL(cached, choice);
+  BOOST_REQUIRE_EQUAL(SelectTreeType(model, dataset, 3, NAIVE_MODE), "");
+
+  Autotune::Clear();
+}
+
+/**
+ * Make sure that a search with a budget of at least the number of leaves
+ * visits the tree best first and finds the exact neighbors.
+ */
+BOOST_AUTO_TEST_CASE(BudgetedSearchExactTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  KNN knn(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  tree::SearchContext context;
+  context.MaxLeaves() = dataset.n_cols;
+  knn.Search(queryData, 5, neighbors, distances, context);
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+  BOOST_REQUIRE_EQUAL(context.Exact().size(), queryData.n_cols);
+  BOOST_REQUIRE(context.AllExact());
+  BOOST_REQUIRE_GT(context.BaseCases(), 0);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+
+  // The same holds for the monochromatic search, with a far deadline.
+  tree::SearchContext monoContext;
+  monoContext.Timeout(std::chrono::hours(1));
+  knn.Search(5, neighbors, distances, monoContext);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  BOOST_REQUIRE_EQUAL(monoContext.Exact().size(), dataset.n_cols);
+  BOOST_REQUIRE(monoContext.AllExact());
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+
+  // A search without a budget does not report exactness.
+  tree::SearchContext exactContext;
+  knn.Search(queryData, 5, neighbors, distances, exactContext);
+  BOOST_REQUIRE(exactContext.Exact().empty());
+}
+
+/**
+ * Make sure that a search that visits only one leaf per query returns
+ * neighbors no closer than the true ones, and reports which queries are exact.
+ */
+BOOST_AUTO_TEST_CASE(BudgetedSearchOneLeafTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  KNN knn(dataset, SINGLE_TREE_MODE);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  tree::SearchContext context;
+  context.MaxLeaves() = 1;
+  knn.Search(queryData, 5, neighbors, distances, context);
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+
+  BOOST_REQUIRE_EQUAL(context.Exact().size(), queryData.n_cols);
+  BOOST_REQUIRE(!context.AllExact());
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_GE(distances(j, i), naiveDistances(j, i) - 1e-10);
+      if (context.Exact()[i])
+        BOOST_REQUIRE_CLOSE(distances(j, i), naiveDistances(j, i), 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that a search whose deadline has passed still returns the
+ * candidates of the first leaf of each query.
+ */
+BOOST_AUTO_TEST_CASE(BudgetedSearchDeadlineTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  tree::SearchContext context;
+  context.Deadline() = tree::SearchContext::Clock::now();
+  knn.Search(queryData, 1, neighbors, distances, context);
+
+  BOOST_REQUIRE_EQUAL(context.Exact().size(), queryData.n_cols);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    BOOST_REQUIRE_LT(neighbors(0, i), dataset.n_cols);
+    BOOST_REQUIRE_CLOSE(distances(0, i), EuclideanDistance::Evaluate(
+        queryData.col(i), dataset.col(neighbors(0, i))), 1e-5);
+  }
+}
+
+/**
+ * Make sure that searches with a budget are refused for the cover tree, whose
+ * nodes are their own children.
+ */
+BOOST_AUTO_TEST_CASE(BudgetedSearchCoverTreeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> knn(dataset);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  tree::SearchContext context;
+  context.MaxLeaves() = 10;
+  BOOST_REQUIRE_THROW(knn.Search(dataset, 3, neighbors, distances, context),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that kNN with the Mahalanobis distance, which searches the
+ * projected points with the Euclidean distance, gives the same results as a
+ * brute-force search with the Mahalanobis distance.
+ */
+BOOST_AUTO_TEST_CASE(MahalanobisKNNTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 300);
+  arma::mat queryData = arma::randu<arma::mat>(4, 50);
+  arma::mat x = arma::randu<arma::mat>(4, 4);
+  MahalanobisDistance<> distance(x * x.t() + 0.1 * arma::eye<arma::mat>(4, 4));
+
+  NeighborSearch<NearestNeighborSort, MahalanobisDistance<>> knn(dataset,
+      DUAL_TREE_MODE, 0.0, distance);
+  NeighborSearch<NearestNeighborSort, MahalanobisDistance<>, arma::mat,
+      BallTree> ballKnn(dataset, SINGLE_TREE_MODE, 0.0, distance);
+  arma::Mat<size_t> neighbors, ballNeighbors;
+  arma::mat distances, ballDistances;
+  knn.Search(queryData, 3, neighbors, distances);
+  ballKnn.Search(queryData, 3, ballNeighbors, ballDistances);
+
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    arma::vec bruteDistances(dataset.n_cols);
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+      bruteDistances[j] = distance.Evaluate(queryData.col(i), dataset.col(j));
+    const arma::uvec order = arma::sort_index(bruteDistances);
+
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, i), order[j]);
+      BOOST_REQUIRE_CLOSE(distances(j, i), bruteDistances[order[j]], 1e-5);
+      BOOST_REQUIRE_EQUAL(ballNeighbors(j, i), order[j]);
+      BOOST_REQUIRE_CLOSE(ballDistances(j, i), bruteDistances[order[j]],
+          1e-5);
+    }
+  }
+
+  // Query points of the wrong dimensionality are refused.
+  arma::mat wrongQueries = arma::randu<arma::mat>(3, 10);
+  BOOST_REQUIRE_THROW(knn.Search(wrongQueries, 3, neighbors, distances),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
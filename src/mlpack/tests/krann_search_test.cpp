@@ -19,6 +19,7 @@
 
 #include <mlpack/methods/rann/ra_search.hpp>
 #include <mlpack/methods/rann/ra_model.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 using namespace std;
 using namespace mlpack;
@@ -715,4 +716,60 @@ BOOST_AUTO_TEST_CASE(RAModelTest)
   }
 }
 
+/**
+ * Naive search on a single dataset computes every distance, in blocks, so it
+ * must give the exact nearest neighbors.
+ */
+BOOST_AUTO_TEST_CASE(SingleDatasetNaiveExactTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1500);
+
+  RASearch<> naive(dataset, true);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  naive.Search(3, neighbors, distances);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(3, trueNeighbors, trueDistances);
+
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+/**
+ * The samples of each query point only depend on the random seed, so that
+ * two single-tree searches (possibly with different threads for each query
+ * point) with the same seed give the same results.
+ */
+BOOST_AUTO_TEST_CASE(SingleTreeRepeatableTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 5000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 1000);
+
+  RASearch<> rann(referenceData, false, true, 5.0, 0.95, false, false, 5);
+
+  arma::Mat<size_t> neighbors1, neighbors2;
+  arma::mat distances1, distances2;
+  math::RandomSeed(42);
+  rann.Search(queryData, 3, neighbors1, distances1);
+  math::RandomSeed(42);
+  rann.Search(queryData, 3, neighbors2, distances2);
+
+  CheckMatrices(neighbors1, neighbors2);
+  CheckMatrices(distances1, distances2);
+
+  // The results must be real neighbors with their distances.
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors1(j, i), referenceData.n_cols);
+      BOOST_REQUIRE_CLOSE(distances1(j, i), arma::norm(queryData.col(i) -
+          referenceData.col(neighbors1(j, i))), 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -109,6 +109,140 @@ BOOST_AUTO_TEST_CASE(TestWhitenUsingEig)
   }
 }
 
+/**
+ * Make sure that centering in place and centering into the input matrix give
+ * the same result as centering into another matrix, also for floats.
+ */
+BOOST_AUTO_TEST_CASE(TestCenterInPlace)
+{
+  mat x(7, 2500, fill::randu);
+  x.row(3) += 100.0;
+
+  mat centered;
+  Center(x, centered);
+
+  mat y(x);
+  vec mean;
+  CenterInPlace(y, mean, 128);
+  vec realMean = arma::mean(x, 1);
+  for (size_t i = 0; i < mean.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(mean[i], realMean[i], 1e-8);
+  CheckMatrices(y, centered);
+
+  Center(x, x);
+  CheckMatrices(x, centered);
+
+  fmat f = conv_to<fmat>::from(y + repmat(realMean, 1, y.n_cols));
+  fmat fCentered;
+  Center(f, fCentered);
+  for (size_t i = 0; i < f.n_elem; ++i)
+    BOOST_REQUIRE_SMALL((double) fCentered[i] - centered[i], 1e-3);
+}
+
+/**
+ * Check the one-pass mean and covariance against mean() and ccov(), for block
+ * sizes that do and do not divide the number of points.
+ */
+BOOST_AUTO_TEST_CASE(TestMeanAndCovariance)
+{
+  mat x(6, 1003, fill::randn);
+  x.row(0) *= 5.0;
+  x.row(2) += 1e4;
+
+  const vec realMean = arma::mean(x, 1);
+  const mat realCov = ccov(x);
+  for (const size_t blockSize : { 1, 17, 1003, 5000 })
+  {
+    vec mean;
+    mat covariance;
+    MeanAndCovariance(x, mean, covariance, blockSize);
+
+    for (size_t i = 0; i < mean.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(mean[i], realMean[i], 1e-8);
+    for (size_t i = 0; i < covariance.n_elem; ++i)
+    {
+      if (std::abs(realCov[i]) < 1e-5)
+        BOOST_REQUIRE_SMALL(covariance[i], 1e-5);
+      else
+        BOOST_REQUIRE_CLOSE(covariance[i], realCov[i], 1e-6);
+    }
+  }
+
+  // Floats with a large offset: the merge of centered blocks keeps the
+  // precision that the naive sum of squares would lose.
+  fmat f = conv_to<fmat>::from(x);
+  fvec fMean;
+  fmat fCovariance;
+  MeanAndCovariance(f, fMean, fCovariance, 64);
+  for (size_t i = 0; i < fCovariance.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(fCovariance[i] - realCov[i], 1e-2);
+}
+
+/**
+ * Merging the moments of chunks of a dataset gives the moments of the whole
+ * dataset.
+ */
+BOOST_AUTO_TEST_CASE(TestMergeMoments)
+{
+  mat x(4, 900, fill::randu);
+
+  size_t points = 0;
+  vec mean;
+  mat scatter;
+  for (size_t begin = 0; begin < x.n_cols; begin += 250)
+  {
+    const mat chunk = x.cols(begin, std::min(begin + 250, (size_t) x.n_cols) -
+        1);
+    vec chunkMean;
+    mat chunkCovariance;
+    MeanAndCovariance(chunk, chunkMean, chunkCovariance);
+    MergeMoments(points, mean, scatter, (size_t) chunk.n_cols, chunkMean,
+        mat(chunkCovariance * (chunk.n_cols - 1.0)));
+  }
+
+  BOOST_REQUIRE_EQUAL(points, x.n_cols);
+  const vec realMean = arma::mean(x, 1);
+  const mat realCov = ccov(x);
+  for (size_t i = 0; i < mean.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(mean[i], realMean[i], 1e-8);
+  for (size_t i = 0; i < scatter.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(scatter[i] / (x.n_cols - 1), realCov[i], 1e-6);
+}
+
+/**
+ * Whitening in place gives the same result as whitening into another matrix,
+ * and the covariance of the result is the identity.
+ */
+BOOST_AUTO_TEST_CASE(TestWhitenInPlace)
+{
+  mat x(5, 2000, fill::randn);
+  x.row(1) += 0.5 * x.row(0);
+  x.row(4) *= 3.0;
+
+  mat whitened, whiteningMatrix;
+  WhitenUsingSVD(x, whitened, whiteningMatrix);
+  mat y(x), inPlaceWhiteningMatrix;
+  WhitenUsingSVDInPlace(y, inPlaceWhiteningMatrix, 300);
+  CheckMatrices(y, whitened, 1e-6);
+
+  WhitenUsingEig(x, whitened, whiteningMatrix);
+  y = x;
+  WhitenUsingEigInPlace(y, inPlaceWhiteningMatrix, 300);
+  CheckMatrices(y, whitened, 1e-6);
+
+  const mat newcov = ccov(y);
+  for (size_t row = 0; row < 5; ++row)
+  {
+    for (size_t col = 0; col < 5; ++col)
+    {
+      if (row == col)
+        BOOST_REQUIRE_CLOSE(newcov(row, col), 1.0, 1e-6);
+      else
+        BOOST_REQUIRE_SMALL(newcov(row, col), 1e-8);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(TestOrthogonalize)
 {
   // Generate a random matrix; then, orthogonalize it and test if it's
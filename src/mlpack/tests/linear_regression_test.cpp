@@ -199,4 +199,143 @@ BOOST_AUTO_TEST_CASE(LinearRegressionTrainTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrTrain.Parameters()[i], 1e-5);
 }
 
+/**
+ * Make sure that the blocked predictions are the same as the predictions
+ * computed with one matrix product, when there are several blocks.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionBlockedPredictTest)
+{
+  arma::mat points = arma::randu<arma::mat>(7, 2500);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    LinearRegression lr(arma::randu<arma::mat>(7, 20),
+        arma::randu<arma::rowvec>(20), 0.0, intercept == 1);
+    lr.Parameters() = arma::randn<arma::vec>(7 + intercept);
+
+    arma::rowvec predictions;
+    lr.Predict(points, predictions);
+
+    arma::rowvec expected = (intercept == 1) ?
+        arma::rowvec(lr.Parameters().tail(7).t() * points +
+        lr.Parameters()[0]) : arma::rowvec(lr.Parameters().t() * points);
+    CheckMatrices(predictions, expected);
+  }
+}
+
+/**
+ * Make sure that training from normal equations accumulated in chunks, some of
+ * them merged from other normal equations, gives the same model as training on
+ * the full dataset.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionNormalEquationsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 10000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(10000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(10000);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    for (size_t weighted = 0; weighted < 2; ++weighted)
+    {
+      const double lambdas[] = { 0.0, 0.3 };
+      for (const double lambda : lambdas)
+      {
+        LinearRegression lr = (weighted == 1) ?
+            LinearRegression(dataset, responses, weights, lambda,
+            intercept == 1) :
+            LinearRegression(dataset, responses, lambda, intercept == 1);
+
+        // The last chunk is accumulated separately and merged.
+        NormalEquations equations(5, intercept == 1), other(5, intercept == 1);
+        const size_t bounds[] = { 0, 3000, 9000, 10000 };
+        for (size_t c = 0; c < 3; ++c)
+        {
+          NormalEquations& e = (c == 2) ? other : equations;
+          const size_t begin = bounds[c], end = bounds[c + 1] - 1;
+          if (weighted == 1)
+          {
+            e.Add(dataset.cols(begin, end), responses.subvec(begin, end),
+                weights.subvec(begin, end));
+          }
+          else
+          {
+            e.Add(dataset.cols(begin, end), responses.subvec(begin, end));
+          }
+        }
+        equations.Merge(other);
+        BOOST_REQUIRE_EQUAL(equations.NumPoints(), 10000);
+
+        LinearRegression streamed(equations, lambda);
+        BOOST_REQUIRE_EQUAL(streamed.Intercept(), intercept == 1);
+        BOOST_REQUIRE_EQUAL(streamed.Parameters().n_elem,
+            lr.Parameters().n_elem);
+        for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+        {
+          BOOST_REQUIRE_CLOSE(streamed.Parameters()[i], lr.Parameters()[i],
+              1e-4);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that a model can be updated with new data by adding it to the
+ * normal equations it was trained from.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionNormalEquationsUpdateTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 2000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(2000);
+
+  NormalEquations equations(4);
+  equations.Add(dataset.cols(0, 999), responses.subvec(0, 999));
+  LinearRegression lr;
+  lr.Lambda() = 0.1;
+  lr.Train(equations);
+
+  LinearRegression firstHalf(dataset.cols(0, 999), responses.subvec(0, 999),
+      0.1);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], firstHalf.Parameters()[i], 1e-4);
+
+  // Now the new data arrives.
+  equations.Add(dataset.cols(1000, 1999), responses.subvec(1000, 1999));
+  lr.Train(equations);
+
+  LinearRegression full(dataset, responses, 0.1);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], full.Parameters()[i], 1e-4);
+
+  // Points of the wrong dimensionality are rejected.
+  BOOST_REQUIRE_THROW(equations.Add(arma::randu<arma::mat>(3, 10),
+      arma::randu<arma::rowvec>(10)), std::invalid_argument);
+}
+
+/**
+ * Make sure that the predictions of single-precision points match the
+ * predictions of the double-precision points to single precision.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionFloatPredictTest)
+{
+  arma::mat points = arma::randu<arma::mat>(7, 2500);
+  const arma::fmat floatPoints = arma::conv_to<arma::fmat>::from(points);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    LinearRegression lr(arma::randu<arma::mat>(7, 20),
+        arma::randu<arma::rowvec>(20), 0.0, intercept == 1);
+    lr.Parameters() = arma::randn<arma::vec>(7 + intercept);
+
+    arma::rowvec predictions;
+    lr.Predict(points, predictions);
+
+    arma::frowvec floatPredictions;
+    lr.Predict(floatPoints, floatPredictions);
+    CheckMatrices(arma::conv_to<arma::rowvec>::from(floatPredictions),
+        predictions, 1e-2);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
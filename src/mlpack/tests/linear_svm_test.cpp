@@ -0,0 +1,216 @@
+/**
+ * @file linear_svm_test.cpp
+ *
+ * Tests for the linear support vector machine.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/linear_svm/linear_svm.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::svm;
+
+BOOST_AUTO_TEST_SUITE(LinearSVMTest);
+
+/**
+ * Generate Gaussian clouds of points around the given centers (one column per
+ * class).
+ */
+void GenerateClouds(const arma::mat& centers,
+                    const size_t pointsPerClass,
+                    arma::mat& data,
+                    arma::Row<size_t>& labels)
+{
+  data.set_size(centers.n_rows, centers.n_cols * pointsPerClass);
+  labels.set_size(data.n_cols);
+  for (size_t c = 0; c < centers.n_cols; ++c)
+  {
+    for (size_t i = 0; i < pointsPerClass; ++i)
+    {
+      const size_t j = c * pointsPerClass + i;
+      data.col(j) = centers.col(c) + arma::randn<arma::vec>(centers.n_rows);
+      labels[j] = c;
+    }
+  }
+}
+
+/**
+ * Compute the primal objective of a binary linear SVM (the intercept is
+ * regularized).
+ */
+double PrimalObjective(const arma::mat& data,
+                       const arma::Row<size_t>& labels,
+                       const arma::vec& w,
+                       const double intercept,
+                       const double c,
+                       const bool squaredHinge)
+{
+  double objective = 0.5 * (arma::dot(w, w) + intercept * intercept);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const double y = (labels[i] == 1) ? 1.0 : -1.0;
+    const double loss = std::max(0.0,
+        1.0 - y * (arma::dot(w, data.col(i)) + intercept));
+    objective += c * (squaredHinge ? loss * loss : loss);
+  }
+
+  return objective;
+}
+
+/**
+ * Make sure that a well-separated binary problem is classified perfectly.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMSeparableTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateClouds(arma::mat("-5.0 5.0; -5.0 5.0; 0.0 0.0"), 200, data, labels);
+
+  LinearSVM svm(data, labels, 2);
+
+  BOOST_REQUIRE_EQUAL(svm.NumClasses(), (size_t) 2);
+  BOOST_REQUIRE_EQUAL(svm.Weights().n_rows, (size_t) 3);
+  BOOST_REQUIRE_EQUAL(svm.Weights().n_cols, (size_t) 1);
+  BOOST_REQUIRE_CLOSE(svm.ComputeAccuracy(data, labels), 100.0, 1e-5);
+
+  // The classes are separated by the first two dimensions.
+  BOOST_REQUIRE_GT(svm.Weights()(0, 0), 0.0);
+  BOOST_REQUIRE_GT(svm.Weights()(1, 0), 0.0);
+  BOOST_REQUIRE_LT(std::abs(svm.Weights()(2, 0)), svm.Weights()(0, 0));
+}
+
+/**
+ * The solution must be (close to) the minimizer of the primal objective, for
+ * both losses.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMOptimalityTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateClouds(arma::mat("-1.0 1.0; 0.0 0.5; 0.5 0.0"), 150, data, labels);
+
+  for (size_t loss = 0; loss < 2; ++loss)
+  {
+    const bool squaredHinge = (loss == 1);
+    LinearSVM svm(data, labels, 2, 0.5, true, squaredHinge, 1e-6, 0);
+
+    const arma::vec w = svm.Weights().col(0);
+    const double b = svm.Intercepts()[0];
+    const double objective = PrimalObjective(data, labels, w, b, 0.5,
+        squaredHinge);
+
+    // Perturbing the solution must not improve the objective.
+    for (size_t trial = 0; trial < 20; ++trial)
+    {
+      const arma::vec dw = 0.05 * arma::randn<arma::vec>(w.n_elem);
+      const double db = 0.05 * arma::randn();
+      BOOST_REQUIRE_LE(objective, PrimalObjective(data, labels, w + dw, b + db,
+          0.5, squaredHinge) * (1.0 + 1e-6));
+    }
+  }
+}
+
+/**
+ * Training on sparse data must give the same model as on dense data.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMSparseTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(30, 400, 0.1);
+  const arma::mat data(sparseData);
+  arma::Row<size_t> labels(400);
+  const arma::vec direction = arma::randn<arma::vec>(30);
+  for (size_t i = 0; i < 400; ++i)
+    labels[i] = (arma::dot(direction, data.col(i)) > 0.0) ? 1 : 0;
+
+  math::RandomSeed(42);
+  LinearSVM denseSVM(data, labels, 2, 1.0, true, false, 1e-6, 0);
+  math::RandomSeed(42);
+  LinearSVM sparseSVM(sparseData, labels, 2, 1.0, true, false, 1e-6, 0);
+
+  CheckMatrices(sparseSVM.Weights(), denseSVM.Weights(), 0.1);
+  BOOST_REQUIRE_SMALL(sparseSVM.Intercepts()[0] - denseSVM.Intercepts()[0],
+      1e-3);
+
+  arma::Row<size_t> densePredictions, sparsePredictions;
+  denseSVM.Classify(data, densePredictions);
+  sparseSVM.Classify(sparseData, sparsePredictions);
+  BOOST_REQUIRE_EQUAL((size_t) arma::accu(densePredictions !=
+      sparsePredictions), (size_t) 0);
+}
+
+/**
+ * One-vs-rest classification of several well-separated classes.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMMulticlassTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateClouds(arma::mat("-8.0 0.0 8.0 0.0; 0.0 8.0 0.0 -8.0"), 100, data,
+      labels);
+
+  LinearSVM svm(data, labels, 4);
+  BOOST_REQUIRE_EQUAL(svm.Weights().n_cols, (size_t) 4);
+  BOOST_REQUIRE_EQUAL(svm.Intercepts().n_elem, (size_t) 4);
+  BOOST_REQUIRE_EQUAL(svm.Iterations().n_elem, (size_t) 4);
+  BOOST_REQUIRE_GT(svm.ComputeAccuracy(data, labels), 98.0);
+
+  arma::Row<size_t> predictions;
+  arma::mat scores;
+  svm.Classify(data, predictions, scores);
+  BOOST_REQUIRE_EQUAL(scores.n_rows, (size_t) 4);
+  BOOST_REQUIRE_EQUAL(scores.n_cols, data.n_cols);
+}
+
+/**
+ * Invalid labels must be rejected.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMInvalidLabelsTest)
+{
+  const arma::mat data = arma::randu<arma::mat>(3, 10);
+  arma::Row<size_t> labels = arma::zeros<arma::Row<size_t>>(10);
+  labels[4] = 2;
+
+  LinearSVM svm;
+  BOOST_REQUIRE_THROW(svm.Train(data, labels, 2), std::invalid_argument);
+  BOOST_REQUIRE_THROW(svm.Train(data, labels.head(5), 3),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(svm.Train(data, labels, 1), std::invalid_argument);
+}
+
+/**
+ * A serialized model must classify like the original one.
+ */
+BOOST_AUTO_TEST_CASE(LinearSVMSerializationTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateClouds(arma::mat("-3.0 0.0 3.0; 0.0 3.0 0.0"), 50, data, labels);
+
+  LinearSVM svm(data, labels, 3, 2.0, true, true);
+  LinearSVM xmlSVM, textSVM, binarySVM;
+  SerializeObjectAll(svm, xmlSVM, textSVM, binarySVM);
+
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions;
+  svm.Classify(data, predictions);
+  xmlSVM.Classify(data, xmlPredictions);
+  textSVM.Classify(data, textPredictions);
+  binarySVM.Classify(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  BOOST_REQUIRE_CLOSE(xmlSVM.C(), 2.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(binarySVM.SquaredHinge(), true);
+  BOOST_REQUIRE_EQUAL(textSVM.NumClasses(), (size_t) 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -12,12 +12,30 @@
 #include <sstream>
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/binary_batch_reader.hpp>
+#include <mlpack/core/data/columnar_dataset.hpp>
+#include <mlpack/core/data/csv_batch_reader.hpp>
 #include <mlpack/core/data/load_arff.hpp>
+#include <mlpack/core/data/load_csv.hpp>
+#include <mlpack/core/data/load_svmlight.hpp>
+#include <mlpack/core/data/mapped_matrix.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
+#include <mlpack/core/data/matrix_batch_reader.hpp>
+#include <mlpack/core/data/mixed_dataset.hpp>
+#include <mlpack/core/data/prefetch_loader.hpp>
+#include <mlpack/core/data/transform_stream.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
+#ifdef HAS_ZLIB
+  #include <zlib.h>
+#endif
+
+#ifdef HAS_ZSTD
+  #include <zstd.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::data;
 using namespace std;
@@ -822,6 +840,56 @@ BOOST_AUTO_TEST_CASE(NormalizeLabelTest)
     BOOST_REQUIRE_EQUAL(randLabels[i], revertedLabels[i]);
 }
 
+/**
+ * Test label normalization of a large label vector (which runs in parallel)
+ * numbers the labels in the order of their first appearance, and that
+ * MapLabels() reuses and extends a mapping.
+ */
+BOOST_AUTO_TEST_CASE(LargeNormalizeLabelTest)
+{
+  arma::Row<size_t> labelsIn = arma::randi<arma::Row<size_t>>(100000,
+      arma::distr_param(0, 20000)) * 3;
+
+  arma::Row<size_t> newLabels;
+  arma::Col<size_t> mapping;
+  data::NormalizeLabels(labelsIn, newLabels, mapping);
+
+  // Check against a serial scan.
+  std::map<size_t, size_t> expected;
+  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  {
+    if (expected.count(labelsIn[i]) == 0)
+    {
+      const size_t label = expected.size();
+      expected[labelsIn[i]] = label;
+    }
+    BOOST_REQUIRE_EQUAL(newLabels[i], expected[labelsIn[i]]);
+  }
+  BOOST_REQUIRE_EQUAL(mapping.n_elem, expected.size());
+
+  arma::Row<size_t> revertedLabels;
+  data::RevertLabels(newLabels, mapping, revertedLabels);
+  BOOST_REQUIRE_EQUAL(arma::accu(revertedLabels != labelsIn), 0);
+
+  // The known labels keep their numbers, and the new ones (1 is not a
+  // multiple of 3) get the next ones.
+  arma::Row<size_t> testLabelsIn = { labelsIn[5], 1, labelsIn[0], 1, 4 };
+  arma::Row<size_t> testLabels;
+  const size_t classes = mapping.n_elem;
+  data::MapLabels(testLabelsIn, testLabels, mapping);
+  BOOST_REQUIRE_EQUAL(mapping.n_elem, classes + 2);
+  BOOST_REQUIRE_EQUAL(testLabels[0], newLabels[5]);
+  BOOST_REQUIRE_EQUAL(testLabels[1], classes);
+  BOOST_REQUIRE_EQUAL(testLabels[2], 0);
+  BOOST_REQUIRE_EQUAL(testLabels[3], classes);
+  BOOST_REQUIRE_EQUAL(testLabels[4], classes + 1);
+
+  // Labels without a value can't be reverted.
+  testLabels[0] = mapping.n_elem;
+  BOOST_REQUIRE_THROW(data::RevertLabels(testLabels, mapping, revertedLabels),
+      std::invalid_argument);
+}
+
 // Test structures.
 class TestInner
 {
@@ -927,6 +995,48 @@ BOOST_AUTO_TEST_CASE(LoadTextTest)
   BOOST_REQUIRE_EQUAL(y.inb.s, x.inb.s);
 }
 
+/**
+ * Make sure we can load and save in the fast binary format, which is also
+ * recognized with the .bin extension, and that truncated files fail to load.
+ */
+BOOST_AUTO_TEST_CASE(LoadFastBinaryTest)
+{
+  Test x(10, 12);
+  BOOST_REQUIRE_EQUAL(data::Save("test.fbin", "x", x, false), true);
+
+  Test y(11, 14);
+  BOOST_REQUIRE_EQUAL(data::Load("test.fbin", "x", y, false), true);
+
+  BOOST_REQUIRE_EQUAL(y.x, x.x);
+  BOOST_REQUIRE_EQUAL(y.y, x.y);
+  BOOST_REQUIRE_EQUAL(y.ina.c, x.ina.c);
+  BOOST_REQUIRE_EQUAL(y.ina.s, x.ina.s);
+  BOOST_REQUIRE_EQUAL(y.inb.c, x.inb.c);
+  BOOST_REQUIRE_EQUAL(y.inb.s, x.inb.s);
+
+  arma::mat matrix(100, 1000, arma::fill::randu);
+  BOOST_REQUIRE_EQUAL(data::Save("test.bin", "matrix", matrix, false,
+      format::fast_binary), true);
+  arma::mat loadedMatrix;
+  BOOST_REQUIRE_EQUAL(data::Load("test.bin", "matrix", loadedMatrix, false),
+      true);
+  CheckMatrices(matrix, loadedMatrix);
+
+  // Truncate the file.
+  std::ifstream in("test.bin", std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(in)),
+      std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream out("test.bin", std::ios::binary);
+  out.write(contents.data(), contents.size() / 2);
+  out.close();
+  BOOST_REQUIRE_EQUAL(data::Load("test.bin", "matrix", loadedMatrix, false),
+      false);
+
+  remove("test.fbin");
+  remove("test.bin");
+}
+
 /**
  * Test DatasetInfo by making a map for a dimension.
  */
@@ -1994,4 +2104,731 @@ BOOST_AUTO_TEST_CASE(DatasetMapperNonUniqueTest)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(nan, 0, 2), "cheese");
 }
 
+/**
+ * Make sure that parsing a CSV in many small chunks gives the same matrix and
+ * mappings as a serial parse would, including a dimension that only turns out
+ * to be categorical late in the file.
+ */
+BOOST_AUTO_TEST_CASE(ParallelCSVLoadTest)
+{
+  const char* words[] = { "red", "green", "blue", "cyan", "black" };
+
+  fstream f;
+  f.open("test_parallel.csv", fstream::out);
+  std::vector<std::string> column1, column2;
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    column1.push_back(words[(i * 3) % 5]);
+    column2.push_back((i == 1500) ? "x" : std::to_string(i % 10));
+    f << i << ", " << column1.back() << ", " << column2.back() << endl;
+  }
+  f.close();
+
+  // Strings are mapped in the order they first appear.
+  std::map<std::string, size_t> map1, map2;
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    map1.insert(std::make_pair(column1[i], map1.size()));
+    map2.insert(std::make_pair(column2[i], map2.size()));
+  }
+
+  arma::mat matrix;
+  DatasetInfo info;
+  LoadCSV loader("test_parallel.csv");
+  loader.ParallelLoad(matrix, info, 100);
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 2000);
+  BOOST_REQUIRE(info.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 5);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 11);
+
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(matrix(0, i), double(i));
+    BOOST_REQUIRE_EQUAL(matrix(1, i), double(map1[column1[i]]));
+    BOOST_REQUIRE_EQUAL(matrix(2, i), double(map2[column2[i]]));
+  }
+
+  // data::Load() should give the same result.
+  arma::mat loadedMatrix;
+  DatasetInfo loadedInfo;
+  data::Load("test_parallel.csv", loadedMatrix, loadedInfo, true);
+  CheckMatrices(matrix, loadedMatrix);
+  BOOST_REQUIRE_EQUAL(loadedInfo.UnmapString(size_t(4), 1), words[2]);
+
+  // A bad line late in the file is still reported.
+  f.open("test_parallel.csv", fstream::out | fstream::app);
+  f << "1, 2" << endl;
+  f.close();
+  LoadCSV badLoader("test_parallel.csv");
+  BOOST_REQUIRE_THROW(badLoader.ParallelLoad(matrix, info, 100),
+      std::runtime_error);
+
+  remove("test_parallel.csv");
+}
+
+/**
+ * Make sure a matrix saved with SaveMappable() can be mapped without copying,
+ * and can still be loaded normally.
+ */
+BOOST_AUTO_TEST_CASE(MappedMatrixTest)
+{
+  arma::mat matrix = arma::randu<arma::mat>(7, 53);
+  BOOST_REQUIRE(data::SaveMappable("test_mapped.bin", matrix));
+
+  {
+    data::MappedMatrix<double> mapped("test_mapped.bin");
+    const arma::mat& alias = mapped.Matrix();
+#ifndef _WIN32
+    BOOST_REQUIRE(mapped.Mapped());
+    BOOST_REQUIRE_EQUAL(size_t(alias.memptr()) % data::mappableAlignment, 0);
+#endif
+    CheckMatrices(matrix, alias);
+  }
+
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test_mapped.bin", loaded, false, false));
+  CheckMatrices(matrix, loaded);
+
+  // The element type must match.
+  BOOST_REQUIRE_THROW(data::MappedMatrix<float>("test_mapped.bin"),
+      std::runtime_error);
+
+  // A file in another format cannot be mapped.
+  fstream f;
+  f.open("test_mapped.csv", fstream::out);
+  f << "1, 2, 3" << endl;
+  f.close();
+  BOOST_REQUIRE_THROW(data::MappedMatrix<double>("test_mapped.csv"),
+      std::runtime_error);
+
+  remove("test_mapped.bin");
+  remove("test_mapped.csv");
+}
+
+/**
+ * Make sure the batch readers give the same points as data::Load(), a batch at
+ * a time.
+ */
+BOOST_AUTO_TEST_CASE(BatchReaderTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 103);
+  dataset.row(3) = arma::floor(4 * dataset.row(3));
+  data::Save("test_batches.csv", dataset);
+  data::Save("test_batches.bin", dataset);
+  data::SaveMappable("test_batches_mappable.bin", dataset);
+
+  data::CSVBatchReader<> csvReader("test_batches.csv", 25);
+  data::BinaryBatchReader<> binaryReader("test_batches.bin", 25);
+  data::BinaryBatchReader<> mappableReader("test_batches_mappable.bin", 25,
+      false);
+  BOOST_REQUIRE_EQUAL(binaryReader.Dimensionality(), 4);
+  BOOST_REQUIRE_EQUAL(binaryReader.Points(), 103);
+  BOOST_REQUIRE_EQUAL(mappableReader.Points(), 103);
+
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    arma::mat csvBatch, binaryBatch, mappableBatch;
+    arma::Row<size_t> labels;
+    size_t begin = 0;
+    while (csvReader(csvBatch))
+    {
+      BOOST_REQUIRE(binaryReader(binaryBatch, labels));
+      BOOST_REQUIRE(mappableReader(mappableBatch));
+
+      const size_t end = std::min(begin + 25, size_t(103)) - 1;
+      BOOST_REQUIRE_EQUAL(csvBatch.n_cols, end - begin + 1);
+      CheckMatrices(csvBatch, dataset.cols(begin, end));
+      CheckMatrices(mappableBatch, dataset.cols(begin, end));
+      CheckMatrices(binaryBatch, dataset.submat(0, begin, 2, end));
+      for (size_t i = begin; i <= end; ++i)
+        BOOST_REQUIRE_EQUAL(labels[i - begin], size_t(dataset(3, i)));
+
+      begin = end + 1;
+    }
+
+    BOOST_REQUIRE_EQUAL(begin, 103);
+    BOOST_REQUIRE(!binaryReader(binaryBatch));
+    BOOST_REQUIRE(!mappableReader(mappableBatch));
+
+    csvReader.Reset();
+    binaryReader.Reset();
+    mappableReader.Reset();
+  }
+
+  // The element type of a binary file must match.
+  BOOST_REQUIRE_THROW(data::BinaryBatchReader<float>("test_batches.bin"),
+      std::runtime_error);
+
+  // Non-numeric lines are reported.
+  fstream f;
+  f.open("test_batches.csv", fstream::out | fstream::app);
+  f << "1, 2, x, 4" << endl;
+  f.close();
+  arma::mat batch;
+  data::CSVBatchReader<> badReader("test_batches.csv", 1000);
+  BOOST_REQUIRE_THROW(badReader(batch), std::runtime_error);
+
+  remove("test_batches.csv");
+  remove("test_batches.bin");
+  remove("test_batches_mappable.bin");
+}
+
+/**
+ * Make sure that a PrefetchLoader over a MatrixBatchReader gives every point
+ * once per pass, with its label, in a new order every pass, and that errors of
+ * the wrapped loader reach the caller.
+ */
+BOOST_AUTO_TEST_CASE(PrefetchLoaderTest)
+{
+  // The first dimension of each point is its index.
+  arma::mat dataset = arma::randu<arma::mat>(3, 103);
+  dataset.row(0) = arma::linspace<arma::rowvec>(0, 102, 103);
+  arma::mat responses = 2 * dataset.row(0);
+
+  data::MatrixBatchReader<> reader(dataset, responses, 10);
+  data::PrefetchLoader<data::MatrixBatchReader<>> loader(reader, 3,
+      [](arma::mat& predictors, arma::mat& /* labels */)
+      {
+        predictors.row(1).fill(-1.0);
+      });
+
+  std::vector<arma::uvec> orders;
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    arma::mat predictors, labels;
+    arma::uvec order;
+    while (loader(predictors, labels))
+    {
+      BOOST_REQUIRE_LE(predictors.n_cols, 10);
+      BOOST_REQUIRE_EQUAL(labels.n_cols, predictors.n_cols);
+      for (size_t i = 0; i < predictors.n_cols; ++i)
+      {
+        const size_t index = (size_t) predictors(0, i);
+        BOOST_REQUIRE_CLOSE(predictors(1, i), -1.0, 1e-10);
+        BOOST_REQUIRE_CLOSE(predictors(2, i), dataset(2, index), 1e-10);
+        BOOST_REQUIRE_CLOSE(labels(0, i), 2.0 * index, 1e-10);
+        order.resize(order.n_elem + 1);
+        order[order.n_elem - 1] = index;
+      }
+    }
+
+    BOOST_REQUIRE(!loader(predictors, labels));
+    BOOST_REQUIRE_EQUAL(order.n_elem, 103);
+    const arma::uvec sorted = arma::sort(order);
+    for (size_t i = 0; i < 103; ++i)
+      BOOST_REQUIRE_EQUAL(sorted[i], i);
+
+    orders.push_back(order);
+    loader.Reset();
+  }
+
+  BOOST_REQUIRE_GT(arma::accu(orders[0] != orders[1]), 0);
+
+  // Without shuffling, the batches come in order.
+  data::MatrixBatchReader<> orderedReader(dataset, 25, false);
+  data::PrefetchLoader<data::MatrixBatchReader<>> orderedLoader(
+      orderedReader);
+  arma::mat batch;
+  size_t begin = 0;
+  while (orderedLoader(batch))
+  {
+    const size_t end = std::min(begin + 25, (size_t) 103) - 1;
+    CheckMatrices(batch, dataset.cols(begin, end));
+    begin = end + 1;
+  }
+  BOOST_REQUIRE_EQUAL(begin, 103);
+
+  // The wrapped reader has no labels, so the exception comes from the
+  // background thread.
+  data::PrefetchLoader<data::MatrixBatchReader<>> badLoader(orderedReader);
+  orderedReader.Reset();
+  arma::mat labels;
+  BOOST_REQUIRE_THROW(badLoader(batch, labels), std::invalid_argument);
+}
+
+/**
+ * Make sure the mappings of a saved DatasetInfo can be reused by later loads.
+ */
+BOOST_AUTO_TEST_CASE(ReuseMappingsTest)
+{
+  fstream f;
+  f.open("test_reuse.csv", fstream::out);
+  f << "1, red" << endl;
+  f << "2, blue" << endl;
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test_reuse.csv", matrix, info));
+  BOOST_REQUIRE(data::Save("test_reuse.xml", "info", info));
+
+  DatasetInfo savedInfo;
+  BOOST_REQUIRE(data::Load("test_reuse.xml", "info", savedInfo));
+
+  // The second file has a new string; the others keep their values.
+  f.open("test_reuse.csv", fstream::out);
+  f << "3, blue" << endl;
+  f << "4, green" << endl;
+  f << "5, red" << endl;
+  f.close();
+
+  BOOST_REQUIRE(data::Load("test_reuse.csv", matrix, savedInfo, false, true,
+      true));
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 3);
+  BOOST_REQUIRE(savedInfo.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(savedInfo.NumMappings(1), 3);
+  BOOST_REQUIRE_EQUAL(matrix(1, 0), 1.0);
+  BOOST_REQUIRE_EQUAL(matrix(1, 1), 2.0);
+  BOOST_REQUIRE_EQUAL(matrix(1, 2), 0.0);
+
+  // The same works without transposing.
+  arma::mat nonTransposed;
+  BOOST_REQUIRE(data::Load("test_reuse.csv", nonTransposed, info, false,
+      false, false));
+  DatasetInfo columnInfo = info;
+  BOOST_REQUIRE(data::Load("test_reuse.csv", nonTransposed, columnInfo, false,
+      false, true));
+  BOOST_REQUIRE_EQUAL(columnInfo.Dimensionality(), 3);
+
+  // A file with another dimensionality cannot reuse the mappings.
+  f.open("test_reuse.csv", fstream::out);
+  f << "1, red, 2" << endl;
+  f.close();
+  BOOST_REQUIRE(!data::Load("test_reuse.csv", matrix, savedInfo, false, true,
+      true));
+
+  remove("test_reuse.csv");
+  remove("test_reuse.xml");
+}
+
+/**
+ * Make sure the MissingPolicy gives the same result when the file is parsed
+ * in parallel chunks.
+ */
+BOOST_AUTO_TEST_CASE(ParallelMissingPolicyLoadTest)
+{
+  fstream f;
+  f.open("test_parallel_missing.csv", fstream::out);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    f << i << ", " << ((i % 7 == 0) ? "-1" : std::to_string(i)) << ", "
+        << ((i % 11 == 0) ? "unknown" : "2") << endl;
+  }
+  f.close();
+
+  arma::mat matrix;
+  MissingPolicy policy({"-1"});
+  DatasetMapper<MissingPolicy> info(policy);
+  LoadCSV loader("test_parallel_missing.csv");
+  loader.ParallelLoad(matrix, info, 100);
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 500);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 1);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 1);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(matrix(0, i), double(i));
+    if (i % 7 == 0)
+      BOOST_REQUIRE(std::isnan(matrix(1, i)));
+    else
+      BOOST_REQUIRE_EQUAL(matrix(1, i), double(i));
+
+    if (i % 11 == 0)
+      BOOST_REQUIRE(std::isnan(matrix(2, i)));
+    else
+      BOOST_REQUIRE_EQUAL(matrix(2, i), 2.0);
+  }
+
+  remove("test_parallel_missing.csv");
+}
+
+/**
+ * Make sure a dataset and its DatasetInfo survive the columnar format, and
+ * that selected dimensions can be loaded on their own.
+ */
+BOOST_AUTO_TEST_CASE(ColumnarDatasetTest)
+{
+  fstream f;
+  f.open("test_columnar.csv", fstream::out);
+  f << "1, red, 0.5" << endl;
+  f << "2, blue, 1.5" << endl;
+  f << "3, red, 2.5" << endl;
+  f << "4, green, 3.5" << endl;
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test_columnar.csv", matrix, info));
+  BOOST_REQUIRE(data::SaveColumnar("test_columnar.bin", matrix, info));
+
+  arma::mat loaded;
+  DatasetInfo loadedInfo;
+  BOOST_REQUIRE(data::LoadColumnar("test_columnar.bin", loaded, loadedInfo));
+  CheckMatrices(matrix, loaded);
+  BOOST_REQUIRE_EQUAL(loadedInfo.Dimensionality(), 3);
+  BOOST_REQUIRE(loadedInfo.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(loadedInfo.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(loadedInfo.NumMappings(1), 3);
+  BOOST_REQUIRE_EQUAL(loadedInfo.UnmapString(size_t(2), 1), "green");
+
+  // Load only the last two dimensions, in reverse order.
+  arma::mat selected;
+  DatasetInfo selectedInfo;
+  std::vector<size_t> dimensions = { 2, 1 };
+  BOOST_REQUIRE(data::LoadColumnar("test_columnar.bin", selected,
+      selectedInfo, dimensions));
+  BOOST_REQUIRE_EQUAL(selected.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(selected.n_cols, 4);
+  CheckMatrices(selected.row(0), matrix.row(2));
+  CheckMatrices(selected.row(1), matrix.row(1));
+  BOOST_REQUIRE(selectedInfo.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(selectedInfo.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(selectedInfo.UnmapString(size_t(1), 1), "blue");
+
+  dimensions.push_back(3);
+  BOOST_REQUIRE(!data::LoadColumnar("test_columnar.bin", selected,
+      selectedInfo, dimensions));
+
+  // The file can be mapped, with one column per dimension.
+  {
+    data::MappedColumnarDataset<double> mapped("test_columnar.bin");
+    CheckMatrices(mapped.Columns(), trans(matrix));
+    BOOST_REQUIRE_EQUAL(mapped.Info().NumMappings(1), 3);
+  }
+
+  // It is also an ordinary Armadillo binary matrix.
+  arma::mat plain;
+  BOOST_REQUIRE(data::Load("test_columnar.bin", plain));
+  CheckMatrices(matrix, plain);
+
+  remove("test_columnar.csv");
+  remove("test_columnar.bin");
+}
+
+/**
+ * Make sure svmlight files are loaded correctly into sparse matrices, however
+ * they are split into chunks.
+ */
+BOOST_AUTO_TEST_CASE(LoadSVMLightTest)
+{
+  fstream f;
+  f.open("test_sparse.svm", fstream::out);
+  f << "# A comment." << endl;
+  f << "1 1:0.5 3:2" << endl;
+  f << "-1 qid:3 2:1.5 4:0 # Zeros are not stored." << endl;
+  f << endl;
+  f << "+1 5:-1 2:3" << endl;
+  f << "0" << endl;
+  f.close();
+
+  for (size_t chunkSize = 1; chunkSize <= 128; chunkSize *= 2)
+  {
+    arma::sp_mat matrix;
+    arma::rowvec labels;
+    BOOST_REQUIRE(data::LoadSVMLight("test_sparse.svm", matrix, labels, false,
+        0, chunkSize));
+
+    BOOST_REQUIRE_EQUAL(matrix.n_rows, 5);
+    BOOST_REQUIRE_EQUAL(matrix.n_cols, 4);
+    BOOST_REQUIRE_EQUAL(matrix.n_nonzero, 5);
+    BOOST_REQUIRE_EQUAL(labels.n_elem, 4);
+    BOOST_REQUIRE_EQUAL(labels[0], 1.0);
+    BOOST_REQUIRE_EQUAL(labels[1], -1.0);
+    BOOST_REQUIRE_EQUAL(labels[2], 1.0);
+    BOOST_REQUIRE_EQUAL(labels[3], 0.0);
+
+    BOOST_REQUIRE_EQUAL(matrix(0, 0), 0.5);
+    BOOST_REQUIRE_EQUAL(matrix(2, 0), 2.0);
+    BOOST_REQUIRE_EQUAL(matrix(1, 1), 1.5);
+    BOOST_REQUIRE_EQUAL(matrix(3, 1), 0.0);
+    BOOST_REQUIRE_EQUAL(matrix(1, 2), 3.0);
+    BOOST_REQUIRE_EQUAL(matrix(4, 2), -1.0);
+    BOOST_REQUIRE_EQUAL(arma::accu(arma::abs(matrix.col(3))), 0.0);
+  }
+
+  // The dimensionality can be set, but not below the largest index.
+  arma::sp_mat matrix;
+  arma::rowvec labels;
+  BOOST_REQUIRE(data::LoadSVMLight("test_sparse.svm", matrix, labels, false,
+      10));
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 10);
+  BOOST_REQUIRE(!data::LoadSVMLight("test_sparse.svm", matrix, labels, false,
+      4));
+
+  // The sparse matrix can be saved and reloaded in the binary and coordinate
+  // formats.
+  BOOST_REQUIRE(data::Load("test_sparse.svm", matrix));
+  BOOST_REQUIRE(data::Save("test_sparse.bin", matrix));
+  BOOST_REQUIRE(data::Save("test_sparse.txt", matrix));
+  arma::sp_mat binaryMatrix, coordMatrix;
+  BOOST_REQUIRE(data::Load("test_sparse.bin", binaryMatrix));
+  BOOST_REQUIRE(data::Load("test_sparse.txt", coordMatrix));
+  CheckMatrices(arma::mat(matrix), arma::mat(binaryMatrix));
+  CheckMatrices(arma::mat(matrix), arma::mat(coordMatrix));
+
+  // Indices are one-based.
+  f.open("test_sparse.svm", fstream::out);
+  f << "1 0:1 2:2" << endl;
+  f.close();
+  BOOST_REQUIRE(!data::LoadSVMLight("test_sparse.svm", matrix, labels));
+
+  remove("test_sparse.svm");
+  remove("test_sparse.bin");
+  remove("test_sparse.txt");
+}
+
+#if defined(HAS_ZLIB) || defined(HAS_ZSTD)
+/**
+ * Check that the given compressed CSV and binary files, which hold the same
+ * data as the given matrix, load correctly, with and without mappings.
+ */
+void CheckCompressedLoad(const std::string& csvFile,
+                         const std::string& binFile,
+                         const arma::mat& expected)
+{
+  arma::mat csvMatrix, binMatrix;
+  BOOST_REQUIRE(data::Load(csvFile, csvMatrix));
+  BOOST_REQUIRE(data::Load(binFile, binMatrix));
+  CheckMatrices(csvMatrix, expected);
+  CheckMatrices(binMatrix, expected);
+
+  arma::mat mappedMatrix;
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load(csvFile, mappedMatrix, info));
+  CheckMatrices(mappedMatrix, expected);
+  BOOST_REQUIRE_EQUAL(info.Dimensionality(), expected.n_rows);
+}
+#endif
+
+#ifdef HAS_ZLIB
+/**
+ * Make sure gzip-compressed files can be loaded, even when they have several
+ * members, and that truncated files fail to load.
+ */
+BOOST_AUTO_TEST_CASE(LoadGzipTest)
+{
+  arma::mat expected = arma::floor(100 * arma::randu<arma::mat>(4, 500));
+  std::ostringstream csv;
+  arma::mat(expected.t()).save(csv, arma::csv_ascii);
+  std::ostringstream bin;
+  arma::mat(expected.t()).save(bin, arma::arma_binary);
+
+  // Write the CSV as two gzip members.
+  const std::string csvString = csv.str();
+  const size_t half = csvString.find('\n', csvString.size() / 2) + 1;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    gzFile f = gzopen("test_file.csv.gz", (i == 0) ? "wb" : "ab");
+    const std::string part = (i == 0) ? csvString.substr(0, half) :
+        csvString.substr(half);
+    gzwrite(f, part.data(), part.size());
+    gzclose(f);
+  }
+
+  gzFile f = gzopen("test_file.bin.gz", "wb");
+  gzwrite(f, bin.str().data(), bin.str().size());
+  gzclose(f);
+
+  CheckCompressedLoad("test_file.csv.gz", "test_file.bin.gz", expected);
+
+  // Truncate the compressed binary file.
+  std::ifstream in("test_file.bin.gz", std::ios::binary);
+  std::string compressed((std::istreambuf_iterator<char>(in)),
+      std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream out("test_file.bin.gz", std::ios::binary);
+  out.write(compressed.data(), compressed.size() / 2);
+  out.close();
+
+  arma::mat matrix;
+  BOOST_REQUIRE(!data::Load("test_file.bin.gz", matrix));
+
+  remove("test_file.csv.gz");
+  remove("test_file.bin.gz");
+}
+#endif
+
+#ifdef HAS_ZSTD
+/**
+ * Make sure zstd-compressed files can be loaded.
+ */
+BOOST_AUTO_TEST_CASE(LoadZstdTest)
+{
+  arma::mat expected = arma::floor(100 * arma::randu<arma::mat>(4, 500));
+  std::ostringstream csv;
+  arma::mat(expected.t()).save(csv, arma::csv_ascii);
+  std::ostringstream bin;
+  arma::mat(expected.t()).save(bin, arma::arma_binary);
+
+  const std::string files[2] = { "test_file.csv.zst", "test_file.bin.zst" };
+  const std::string contents[2] = { csv.str(), bin.str() };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    std::string compressed(ZSTD_compressBound(contents[i].size()), '\0');
+    const size_t size = ZSTD_compress(&compressed[0], compressed.size(),
+        contents[i].data(), contents[i].size(), 3);
+    BOOST_REQUIRE(!ZSTD_isError(size));
+
+    std::ofstream out(files[i].c_str(), std::ios::binary);
+    out.write(compressed.data(), size);
+  }
+
+  CheckCompressedLoad(files[0], files[1], expected);
+
+  remove(files[0].c_str());
+  remove(files[1].c_str());
+}
+#endif
+
+/**
+ * Make sure that "-" loads from the standard input and saves to the standard
+ * output, as CSV or in the format of its extension.
+ */
+BOOST_AUTO_TEST_CASE(StandardStreamLoadSaveTest)
+{
+  arma::mat expected = arma::floor(100 * arma::randu<arma::mat>(4, 50));
+  std::streambuf* cinBuffer = std::cin.rdbuf();
+  std::streambuf* coutBuffer = std::cout.rdbuf();
+
+  const char* formats[] = { "-", "-.csv", "-.txt", "-.bin" };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    // Save to the standard output, and load that back from the standard input.
+    std::stringstream stream;
+    std::cout.rdbuf(stream.rdbuf());
+    const bool saved = data::Save(formats[i], expected);
+    std::cout.rdbuf(coutBuffer);
+    BOOST_REQUIRE(saved);
+
+    arma::mat matrix;
+    std::cin.rdbuf(stream.rdbuf());
+    const bool loaded = data::Load(formats[i], matrix);
+    std::cin.rdbuf(cinBuffer);
+    BOOST_REQUIRE(loaded);
+
+    CheckMatrices(matrix, expected);
+  }
+
+  // The same data from a file and from the standard input is the same.
+  arma::mat(expected.t()).save("test_file.csv", arma::csv_ascii);
+  std::ifstream file("test_file.csv");
+  std::cin.rdbuf(file.rdbuf());
+  arma::mat matrix;
+  const bool loaded = data::Load("-", matrix);
+  std::cin.rdbuf(cinBuffer);
+  BOOST_REQUIRE(loaded);
+  CheckMatrices(matrix, expected);
+
+  file.close();
+  remove("test_file.csv");
+}
+
+/**
+ * Make sure that TransformCSVStream() reads the standard input a batch at a
+ * time and writes every result to the standard output, one line per point.
+ */
+BOOST_AUTO_TEST_CASE(TransformCSVStreamTest)
+{
+  arma::mat dataset = arma::floor(100 * arma::randu<arma::mat>(3, 103));
+  std::stringstream input;
+  arma::mat(dataset.t()).save(input, arma::csv_ascii);
+
+  std::streambuf* cinBuffer = std::cin.rdbuf();
+  std::streambuf* coutBuffer = std::cout.rdbuf();
+  std::stringstream output;
+  std::cin.rdbuf(input.rdbuf());
+  std::cout.rdbuf(output.rdbuf());
+
+  // Sum the dimensions of each point, and record the batch sizes.
+  std::vector<size_t> batchSizes;
+  const size_t points = data::TransformCSVStream<arma::Row<size_t>>("-", "-",
+      [&](const arma::mat& batch, arma::Row<size_t>& sums)
+      {
+        batchSizes.push_back(batch.n_cols);
+        sums = arma::conv_to<arma::Row<size_t>>::from(arma::sum(batch));
+      }, 25);
+
+  std::cin.rdbuf(cinBuffer);
+  std::cout.rdbuf(coutBuffer);
+
+  BOOST_REQUIRE_EQUAL(points, 103);
+  BOOST_REQUIRE_EQUAL(batchSizes.size(), 5);
+  for (size_t i = 0; i < 4; ++i)
+    BOOST_REQUIRE_EQUAL(batchSizes[i], 25);
+  BOOST_REQUIRE_EQUAL(batchSizes[4], 3);
+
+  // Each line holds the sum of one point.
+  arma::Col<size_t> sums;
+  BOOST_REQUIRE(sums.load(output, arma::raw_ascii));
+  BOOST_REQUIRE_EQUAL(sums.n_elem, 103);
+  for (size_t i = 0; i < 103; ++i)
+    BOOST_REQUIRE_EQUAL(sums[i], size_t(arma::accu(dataset.col(i))));
+
+  // The standard input can't be read twice.
+  std::cin.rdbuf(input.rdbuf());
+  data::CSVBatchReader<> reader("-");
+  BOOST_REQUIRE_THROW(reader.Reset(), std::runtime_error);
+  std::cin.rdbuf(cinBuffer);
+
+  BOOST_REQUIRE(data::CanTransformStream("-", "-"));
+  BOOST_REQUIRE(data::CanTransformStream("-.txt", "output.csv"));
+  BOOST_REQUIRE(!data::CanTransformStream("-.bin", "-"));
+  BOOST_REQUIRE(!data::CanTransformStream("-", "-.bin"));
+  BOOST_REQUIRE(!data::CanTransformStream("input.csv", "-"));
+}
+
+/**
+ * Test that a MixedDataset stores each type of dimension separately and
+ * rebuilds the dataset.
+ */
+BOOST_AUTO_TEST_CASE(MixedDatasetTest)
+{
+  data::DatasetInfo info(3);
+  info.Type(1) = data::Datatype::categorical;
+  for (size_t i = 0; i < 300; ++i)
+    info.MapString<double>(std::to_string(i), 1);
+
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  dataset.row(1) = arma::floor(299.0 * dataset.row(1));
+
+  data::MixedDataset<float, uint16_t> mixed(dataset, info);
+  BOOST_REQUIRE_EQUAL(mixed.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(mixed.n_cols, 1000);
+  BOOST_REQUIRE_EQUAL(mixed.Numeric().n_rows, 2);
+  BOOST_REQUIRE_EQUAL(mixed.Codes().n_rows, 1);
+  BOOST_REQUIRE(mixed.Categorical(1));
+  BOOST_REQUIRE_EQUAL(mixed.Row(2), 1);
+  BOOST_REQUIRE_EQUAL(mixed(1, 10), dataset(1, 10));
+  BOOST_REQUIRE_CLOSE(mixed(2, 10), dataset(2, 10), 1e-4);
+
+  arma::mat rebuilt;
+  mixed.ToMatrix(rebuilt);
+  BOOST_REQUIRE_EQUAL(arma::accu(rebuilt.row(1) != dataset.row(1)), 0);
+  BOOST_REQUIRE_SMALL(arma::abs(rebuilt - dataset).max(), 1e-6);
+
+  // Selected points, and swapped points.
+  const arma::uvec indices = { 5, 2, 5 };
+  data::MixedDataset<float, uint16_t> subset = mixed.cols(indices);
+  BOOST_REQUIRE_EQUAL(subset.n_cols, 3);
+  subset.swap_cols(0, 1);
+  BOOST_REQUIRE_EQUAL(subset(1, 0), dataset(1, 2));
+  BOOST_REQUIRE_EQUAL(subset(1, 2), dataset(1, 5));
+
+  // A dimension with 300 categories doesn't fit in 8-bit codes, and values
+  // that aren't mapped can't be stored.
+  typedef data::MixedDataset<double, uint8_t> SmallMixedDataset;
+  BOOST_REQUIRE_THROW(SmallMixedDataset(dataset, info), std::invalid_argument);
+  dataset(1, 3) = 300;
+  BOOST_REQUIRE_THROW(data::MixedDataset<>(dataset, info),
+      std::invalid_argument);
+  const arma::mat twoDimensions = dataset.rows(0, 1);
+  BOOST_REQUIRE_THROW(data::MixedDataset<>(twoDimensions, info),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -13,6 +13,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/function/parallel_function.hpp>
+#include <mlpack/core/data/csv_batch_reader.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -505,6 +507,47 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionLBFGSSimpleTest)
   BOOST_REQUIRE_SMALL(sigmoids[2], 0.1);
 }
 
+/**
+ * Make sure that the objective and gradient of ParallelFunction are those of
+ * the wrapped function, and that L-BFGS finds the same parameters with it.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionParallelFunctionTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 1003);
+  arma::Row<size_t> responses(1003);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    responses[i] = (arma::accu(data.col(i)) > 2.5) ? 1 : 0;
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+  ParallelFunction<LogisticRegressionFunction<>> plrf(lrf);
+
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::mat parameters = arma::randn<arma::mat>(1, 6);
+
+    arma::mat gradient, parallelGradient, parallelGradient2;
+    const double objective = lrf.EvaluateWithGradient(parameters, gradient);
+    plrf.Gradient(parameters, parallelGradient);
+
+    BOOST_REQUIRE_CLOSE(plrf.Evaluate(parameters), objective, 1e-5);
+    BOOST_REQUIRE_CLOSE(plrf.EvaluateWithGradient(parameters,
+        parallelGradient2), objective, 1e-5);
+    for (size_t j = 0; j < gradient.n_elem; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(parallelGradient[j], gradient[j], 1e-5);
+      BOOST_REQUIRE_CLOSE(parallelGradient2[j], gradient[j], 1e-5);
+    }
+  }
+
+  L_BFGS lbfgs;
+  arma::mat parameters = lrf.GetInitialPoint();
+  arma::mat parallelParameters = parameters;
+  lbfgs.Optimize(lrf, parameters);
+  lbfgs.Optimize(plrf, parallelParameters);
+  for (size_t j = 0; j < parameters.n_elem; ++j)
+    BOOST_REQUIRE_CLOSE(parallelParameters[j], parameters[j], 0.01);
+}
+
 // Test training of logistic regression on a simple dataset using SGD.
 BOOST_AUTO_TEST_CASE(LogisticRegressionSGDSimpleTest)
 {
@@ -813,6 +856,47 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionSparseSGDTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrSparse.Parameters()[i], 1e-5);
 }
 
+/**
+ * Make sure that the sparse batch gradient is the same as the dense batch
+ * gradient, with and without regularization.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionSparseGradientTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(50, 200, 0.05);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, 2);
+
+  arma::mat parameters = arma::randn<arma::mat>(1, 51);
+  parameters.tail_cols(20).zeros();
+
+  for (size_t l = 0; l < 2; ++l)
+  {
+    LogisticRegressionFunction<arma::sp_mat> lrf(dataset, labels,
+        (l == 0) ? 0.0 : 0.5);
+
+    arma::mat gradient;
+    arma::sp_mat sparseGradient;
+    lrf.Gradient(parameters, 30, gradient, 40);
+    lrf.Gradient(parameters, 30, sparseGradient, 40);
+
+    BOOST_REQUIRE_EQUAL(sparseGradient.n_rows, gradient.n_rows);
+    BOOST_REQUIRE_EQUAL(sparseGradient.n_cols, gradient.n_cols);
+    CheckMatrices(gradient, arma::mat(sparseGradient));
+
+    // Without regularization, only the features of the batch are touched.
+    if (l == 0)
+    {
+      const arma::sp_mat batch(dataset.cols(30, 69));
+      const arma::vec touched = arma::vec(arma::sum(arma::abs(batch), 1));
+      for (size_t i = 0; i < touched.n_elem; ++i)
+        if (touched[i] == 0.0)
+          BOOST_REQUIRE_EQUAL((double) sparseGradient(0, i + 1), 0.0);
+    }
+  }
+}
+
 /**
  * Test multi-point classification (Classify()).
  */
@@ -963,4 +1047,102 @@ BOOST_AUTO_TEST_CASE(ClassifyProbabilitiesTest)
   }
 }
 
+/**
+ * Make sure that logistic regression can be trained on batches streamed from
+ * a file.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionUpdateTest)
+{
+  // Generate a two-Gaussian dataset, in random order.
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(4, 1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const bool second = (math::RandInt(2) == 1);
+    data.submat(0, i, 2, i) = second ? g2.Random() : g1.Random();
+    data(3, i) = second ? 1.0 : 0.0;
+  }
+  data::Save("test_stream.csv", data);
+
+  LogisticRegression<> lr(3, 0.5);
+  StandardSGD sgd(0.01, 1, 250, 1e-10);
+  data::CSVBatchReader<> reader("test_stream.csv", 250);
+  for (size_t pass = 0; pass < 3; ++pass)
+  {
+    BOOST_REQUIRE_EQUAL(lr.Update(reader, sgd), 4);
+    reader.Reset();
+  }
+
+  const arma::Row<size_t> responses =
+      arma::conv_to<arma::Row<size_t>>::from(data.row(3));
+  const double acc = lr.ComputeAccuracy(data.rows(0, 2), responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 0.5);
+
+  // The dimensionality must match the model.
+  LogisticRegression<> wrong(5, 0.5);
+  BOOST_REQUIRE_THROW(wrong.Update(reader, sgd), std::invalid_argument);
+
+  remove("test_stream.csv");
+}
+
+/**
+ * Make sure that the blocked classification gives the same labels and
+ * probabilities as the expressions over all the points, when there are several
+ * blocks.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionBlockedClassifyTest)
+{
+  arma::mat dataset = arma::randn<arma::mat>(6, 2500);
+
+  LogisticRegression<> lr(6, 0.0);
+  lr.Parameters() = arma::randn<arma::rowvec>(7);
+
+  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-lr.Parameters()(0) -
+      lr.Parameters().tail_cols(6) * dataset));
+
+  arma::Row<size_t> labels;
+  lr.Classify(dataset, labels, 0.3);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(labels[i], (size_t) (sigmoids[i] >= 0.3));
+
+  arma::mat probabilities;
+  lr.Classify(dataset, probabilities);
+  CheckMatrices(probabilities.row(1), sigmoids);
+  CheckMatrices(probabilities.row(0), 1.0 - sigmoids);
+}
+
+/**
+ * Make sure that single-precision points get the same labels and (to single
+ * precision) the same probabilities as the double-precision points.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFloatClassifyTest)
+{
+  arma::mat dataset = arma::randn<arma::mat>(6, 2500);
+  const arma::fmat floatDataset = arma::conv_to<arma::fmat>::from(dataset);
+
+  LogisticRegression<> lr(6, 0.0);
+  lr.Parameters() = arma::randn<arma::rowvec>(7);
+
+  arma::mat probabilities;
+  lr.Classify(dataset, probabilities);
+
+  arma::Row<size_t> labels;
+  lr.Classify(floatDataset, labels, 0.3);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    // Skip the points that are too close to the boundary for single precision.
+    if (std::abs(probabilities(1, i) - 0.3) > 1e-4)
+      BOOST_REQUIRE_EQUAL(labels[i], (size_t) (probabilities(1, i) >= 0.3));
+  }
+
+  arma::fmat floatProbabilities;
+  lr.Classify(floatDataset, floatProbabilities);
+  CheckMatrices(arma::conv_to<arma::mat>::from(floatProbabilities),
+      probabilities, 1e-2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
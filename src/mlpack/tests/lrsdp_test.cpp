@@ -314,4 +314,114 @@ BOOST_AUTO_TEST_CASE(Keller4LovaszThetaSDP)
   }
 }*/
 
+/**
+ * Compute the augmented Lagrangian objective and gradient of an LRSDP by
+ * forming R R^T and S explicitly.
+ */
+double NaiveAugLagrangian(const SDP<arma::sp_mat>& sdp,
+                          const arma::mat& coordinates,
+                          const arma::vec& lambda,
+                          const double sigma,
+                          arma::mat& gradient)
+{
+  const arma::mat rrt = coordinates * trans(coordinates);
+  double objective = arma::accu(arma::mat(sdp.C()) % rrt);
+  arma::mat s(sdp.C());
+  for (size_t i = 0; i < sdp.NumConstraints(); ++i)
+  {
+    const arma::mat a = (i < sdp.NumSparseConstraints()) ?
+        arma::mat(sdp.SparseA()[i]) :
+        sdp.DenseA()[i - sdp.NumSparseConstraints()];
+    const double b = (i < sdp.NumSparseConstraints()) ? sdp.SparseB()[i] :
+        sdp.DenseB()[i - sdp.NumSparseConstraints()];
+    const double constraint = arma::accu(a % rrt) - b;
+    objective += -lambda[i] * constraint + (sigma / 2.) * constraint *
+        constraint;
+    s -= (lambda[i] - sigma * constraint) * a;
+  }
+
+  gradient = 2 * s * coordinates;
+  return objective;
+}
+
+/**
+ * Make sure the constraint kernels give the same augmented Lagrangian objective
+ * and gradient as the explicit computation, with only sparse constraints (where
+ * R R^T is never formed) and with sparse and dense constraints.
+ */
+BOOST_AUTO_TEST_CASE(LRSDPConstraintKernelsTest)
+{
+  const size_t n = 30;
+  const size_t rank = 4;
+  const size_t numSparse = 200;
+
+  for (size_t numDense = 0; numDense <= 3; numDense += 3)
+  {
+    arma::mat coordinates(n, rank, arma::fill::randn);
+    LRSDPFunction<SDP<arma::sp_mat>> function(numSparse, numDense,
+        coordinates);
+    SDP<arma::sp_mat>& sdp = function.SDP();
+
+    sdp.C() = arma::sprandu<arma::sp_mat>(n, n, 0.1);
+    sdp.C() += trans(sdp.C());
+    for (size_t i = 0; i < numSparse; ++i)
+    {
+      // Rank-one constraints of the form (e_j - e_k)(e_j - e_k)^T, as in MVU.
+      const size_t j = math::RandInt(n);
+      const size_t k = (j + 1 + math::RandInt(n - 1)) % n;
+      sdp.SparseA()[i].zeros(n, n);
+      sdp.SparseA()[i](j, j) = 1.0;
+      sdp.SparseA()[i](k, k) = 1.0;
+      sdp.SparseA()[i](j, k) = -1.0;
+      sdp.SparseA()[i](k, j) = -1.0;
+    }
+    sdp.SparseB().randu(numSparse);
+    for (size_t i = 0; i < numDense; ++i)
+    {
+      sdp.DenseA()[i].randn(n, n);
+      sdp.DenseA()[i] += trans(sdp.DenseA()[i]);
+    }
+    sdp.DenseB().randu(numDense);
+
+    const arma::vec lambda(numSparse + numDense, arma::fill::randn);
+    const double sigma = 3.0;
+    AugLagrangianFunction<LRSDPFunction<SDP<arma::sp_mat>>> augLag(function,
+        lambda, sigma);
+
+    arma::mat expectedGradient;
+    const double expectedObjective = NaiveAugLagrangian(sdp, coordinates,
+        lambda, sigma, expectedGradient);
+
+    arma::mat gradient;
+    const double objective = augLag.Evaluate(coordinates);
+    augLag.Gradient(coordinates, gradient);
+
+    BOOST_REQUIRE_CLOSE(objective, expectedObjective, 1e-7);
+    BOOST_REQUIRE_EQUAL(gradient.n_rows, n);
+    BOOST_REQUIRE_EQUAL(gradient.n_cols, rank);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+    {
+      if (std::abs(expectedGradient[i]) < 1e-8)
+        BOOST_REQUIRE_SMALL(gradient[i], 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(gradient[i], expectedGradient[i], 1e-7);
+    }
+
+    for (size_t i = 0; i < numSparse + numDense; ++i)
+    {
+      const arma::mat a = (i < numSparse) ? arma::mat(sdp.SparseA()[i]) :
+          sdp.DenseA()[i - numSparse];
+      const double b = (i < numSparse) ? sdp.SparseB()[i] :
+          sdp.DenseB()[i - numSparse];
+      const double expected = arma::accu(a % (coordinates *
+          trans(coordinates))) - b;
+      const double actual = function.EvaluateConstraint(i, coordinates);
+      if (std::abs(expected) < 1e-8)
+        BOOST_REQUIRE_SMALL(actual, 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(actual, expected, 1e-7);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -802,6 +802,34 @@ BOOST_AUTO_TEST_CASE(ParallelBichromatic)
   BOOST_REQUIRE_EQUAL(recall, 1);
 }
 
+/**
+ * Test: This test verifies that building the hash tables in parallel gives the
+ * same tables as building them with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrain)
+{
+  arma::mat rdata = arma::randu<arma::mat>(4, 5000);
+
+  size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  math::RandomSeed(1000);
+  LSHSearch<> sequentialLsh(rdata, 3, 8, 0.0, 991, 100);
+
+  omp_set_num_threads(std::max(prevNumThreads, (size_t) 4));
+  math::RandomSeed(1000);
+  LSHSearch<> parallelLsh(rdata, 3, 8, 0.0, 991, 100);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(sequentialLsh.BucketOffsets(), parallelLsh.BucketOffsets());
+  BOOST_REQUIRE_EQUAL(sequentialLsh.BucketContents().n_elem,
+      parallelLsh.BucketContents().n_elem);
+  for (size_t i = 0; i < sequentialLsh.BucketContents().n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(sequentialLsh.BucketContents()[i],
+        parallelLsh.BucketContents()[i]);
+  }
+}
+
 /**
  * Test: This test verifies that parallel query processing returns correct
  * results for the monochromatic search.
@@ -912,4 +940,60 @@ BOOST_AUTO_TEST_CASE(MoveOperatorTest)
   CheckMatrices(distances, distances2);
 }
 
+/**
+ * Make sure that the second hash table holds each point once in each table
+ * when the buckets are unlimited, and at most bucketSize points per bucket
+ * otherwise.
+ */
+BOOST_AUTO_TEST_CASE(BucketStorageTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 300);
+
+  LSHSearch<> lsh(dataset, 3, 6, 0.0, 99901, 0);
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  const arma::Col<uint32_t>& contents = lsh.BucketContents();
+  BOOST_REQUIRE_GT(offsets.n_elem, (arma::uword) 1);
+  BOOST_REQUIRE_EQUAL(offsets[0], (size_t) 0);
+  BOOST_REQUIRE_EQUAL(offsets[offsets.n_elem - 1], (size_t) contents.n_elem);
+  BOOST_REQUIRE_EQUAL((size_t) contents.n_elem, (size_t) 6 * 300);
+
+  arma::Col<size_t> counts(300, arma::fill::zeros);
+  for (size_t i = 0; i < contents.n_elem; ++i)
+    counts[contents[i]]++;
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], (size_t) 6);
+
+  // The per-bucket view matches the contiguous storage.
+  const std::vector<arma::Col<size_t>> table = lsh.SecondHashTable();
+  BOOST_REQUIRE_EQUAL(table.size(), (size_t) offsets.n_elem - 1);
+  for (size_t i = 0; i < table.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL((size_t) table[i].n_elem, offsets[i + 1] - offsets[i]);
+    for (size_t j = 0; j < table[i].n_elem; ++j)
+      BOOST_REQUIRE_EQUAL(table[i][j], (size_t) contents[offsets[i] + j]);
+  }
+
+  // Now limit the buckets.
+  LSHSearch<> smallLsh(dataset, 1, 2, 0.0, 3, 20);
+  const arma::Col<size_t>& smallOffsets = smallLsh.BucketOffsets();
+  BOOST_REQUIRE_GT(smallOffsets.n_elem, (arma::uword) 1);
+  for (size_t i = 0; i + 1 < smallOffsets.n_elem; ++i)
+  {
+    BOOST_REQUIRE_GT(smallOffsets[i + 1], smallOffsets[i]);
+    BOOST_REQUIRE_LE(smallOffsets[i + 1] - smallOffsets[i], (size_t) 20);
+  }
+
+  // The search returns distinct candidates, so every neighbor of a point is
+  // distinct.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lsh.Search(5, neighbors, distances, 0, 3);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    const arma::Col<size_t> found = neighbors.col(i);
+    BOOST_REQUIRE_EQUAL(arma::Col<size_t>(arma::unique(found)).n_elem,
+        found.n_elem);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
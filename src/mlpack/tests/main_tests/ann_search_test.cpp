@@ -0,0 +1,138 @@
+/**
+ * @file ann_search_test.cpp
+ *
+ * Test mlpackMain() of ann_search_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "ANNSearch";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/methods/hnsw/ann_search_main.cpp>
+#include "test_helper.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct ANNSearchTestFixture
+{
+ public:
+  ANNSearchTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~ANNSearchTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(ANNSearchMainTest, ANNSearchTestFixture);
+
+/**
+ * Make sure the outputs have k rows and one column per query point.
+ */
+BOOST_AUTO_TEST_CASE(ANNSearchOutputDimensionTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat queryData = arma::randu<arma::mat>(3, 40);
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("query", std::move(queryData));
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+      40);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_cols, 40);
+}
+
+/**
+ * Make sure a saved model gives the same results as the model it was saved
+ * from.
+ */
+BOOST_AUTO_TEST_CASE(ANNSearchModelReuseTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("k", (int) 4);
+
+  mlpackMain();
+
+  arma::Mat<size_t> neighbors =
+      std::move(CLI::GetParam<arma::Mat<size_t>>("neighbors"));
+  arma::mat distances = std::move(CLI::GetParam<arma::mat>("distances"));
+
+  // Reset passed parameters.
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  SetInputParam("input_model",
+      std::move(CLI::GetParam<neighbor::HNSWSearch<>*>("output_model")));
+
+  mlpackMain();
+
+  CheckMatrices(neighbors, CLI::GetParam<arma::Mat<size_t>>("neighbors"));
+  CheckMatrices(distances, CLI::GetParam<arma::mat>("distances"));
+}
+
+/**
+ * Make sure only one of the reference set or a model can be passed.
+ */
+BOOST_AUTO_TEST_CASE(ANNSearchReferenceAndModelTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 100);
+
+  SetInputParam("reference", referenceData);
+
+  mlpackMain();
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("input_model",
+      std::move(CLI::GetParam<neighbor::HNSWSearch<>*>("output_model")));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure invalid values of k and the connectivity are rejected.
+ */
+BOOST_AUTO_TEST_CASE(ANNSearchInvalidParametersTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 100);
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("k", (int) 100);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("k", (int) 5);
+  SetInputParam("connectivity", (int) 1);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -67,4 +67,43 @@ BOOST_AUTO_TEST_CASE(HMMLoglikOutputNegativeTest)
   BOOST_REQUIRE(loglik <= 0);
 }
 
+/**
+ * With sequence lengths, the log-likelihood of each concatenated sequence must
+ * be computed separately.
+ */
+BOOST_AUTO_TEST_CASE(HMMLoglikLengthsTest)
+{
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(&trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(&trainSeq);
+
+  // Split the observations into two sequences.
+  const size_t split = inp.n_cols / 3;
+  const double loglik1 = h->DiscreteHMM()->LogLikelihood(
+      inp.cols(0, split - 1));
+  const double loglik2 = h->DiscreteHMM()->LogLikelihood(
+      inp.cols(split, inp.n_cols - 1));
+
+  arma::Row<size_t> lengths(2);
+  lengths[0] = split;
+  lengths[1] = inp.n_cols - split;
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", inp);
+  SetInputParam("lengths", lengths);
+
+  mlpackMain();
+
+  const arma::vec logliks = CLI::GetParam<arma::vec>("log_likelihoods");
+  BOOST_REQUIRE_EQUAL(logliks.n_elem, 2);
+  BOOST_REQUIRE_CLOSE(logliks[0], loglik1, 1e-5);
+  BOOST_REQUIRE_CLOSE(logliks[1], loglik2, 1e-5);
+  BOOST_REQUIRE_CLOSE(CLI::GetParam<double>("log_likelihood"),
+      loglik1 + loglik2, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
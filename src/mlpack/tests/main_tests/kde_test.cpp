@@ -0,0 +1,181 @@
+/**
+ * @file kde_test.cpp
+ *
+ * Test mlpackMain() of kde_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "KDE";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/methods/kde/kde_main.cpp>
+#include "test_helper.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct KDETestFixture
+{
+ public:
+  KDETestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~KDETestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(KDEMainTest, KDETestFixture);
+
+/**
+ * Make sure there is one estimate per query point, or per reference point if
+ * there is no query set.
+ */
+BOOST_AUTO_TEST_CASE(KDEOutputDimensionTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat queryData = arma::randu<arma::mat>(3, 40);
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("query", std::move(queryData));
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::vec>("predictions").n_elem, 40);
+
+  bindings::tests::CleanMemory();
+  CLI::GetSingleton().Parameters()["query"].wasPassed = false;
+  SetInputParam("reference", std::move(referenceData));
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::vec>("predictions").n_elem, 300);
+}
+
+/**
+ * Make sure a saved model gives the same estimates as the model it was saved
+ * from, in naive mode.
+ */
+BOOST_AUTO_TEST_CASE(KDEModelReuseTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("query", queryData);
+  SetInputParam("kernel", std::string("epanechnikov"));
+  SetInputParam("tree", std::string("ball-tree"));
+  SetInputParam("algorithm", std::string("naive"));
+  SetInputParam("bandwidth", 0.5);
+
+  mlpackMain();
+
+  arma::vec predictions = std::move(CLI::GetParam<arma::vec>("predictions"));
+
+  // Reset passed parameters.
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["kernel"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["tree"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["algorithm"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["bandwidth"].wasPassed = false;
+
+  SetInputParam("input_model",
+      std::move(CLI::GetParam<kde::KDEModel*>("output_model")));
+  SetInputParam("query", std::move(queryData));
+
+  mlpackMain();
+
+  CheckMatrices(predictions, CLI::GetParam<arma::vec>("predictions"));
+}
+
+/**
+ * Make sure the estimates of the dual-tree algorithm are close to the exact
+ * ones.
+ */
+BOOST_AUTO_TEST_CASE(KDEDualTreeTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(2, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(2, 100);
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("query", queryData);
+  SetInputParam("algorithm", std::string("naive"));
+  SetInputParam("bandwidth", 0.2);
+
+  mlpackMain();
+
+  arma::vec exact = std::move(CLI::GetParam<arma::vec>("predictions"));
+
+  bindings::tests::CleanMemory();
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("query", std::move(queryData));
+  SetInputParam("algorithm", std::string("dual-tree"));
+  SetInputParam("rel_error", 0.01);
+
+  mlpackMain();
+
+  const arma::vec& predictions = CLI::GetParam<arma::vec>("predictions");
+  for (size_t i = 0; i < exact.n_elem; ++i)
+    BOOST_REQUIRE_LE(std::abs(predictions[i] - exact[i]), 0.01 * exact[i]);
+}
+
+/**
+ * Make sure only one of the reference set or a model can be passed.
+ */
+BOOST_AUTO_TEST_CASE(KDEReferenceAndModelTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 100);
+
+  SetInputParam("reference", referenceData);
+
+  mlpackMain();
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("input_model",
+      std::move(CLI::GetParam<kde::KDEModel*>("output_model")));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure invalid parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(KDEInvalidParametersTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 100);
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("kernel", std::string("cosine"));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+
+  SetInputParam("kernel", std::string("gaussian"));
+  SetInputParam("bandwidth", -1.0);
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+
+  SetInputParam("bandwidth", 1.0);
+  SetInputParam("rel_error", 0.0);
+  SetInputParam("monte_carlo", true);
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+BOOST_AUTO_TEST_SUITE_END();
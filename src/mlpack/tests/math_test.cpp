@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core/math/clamp.hpp>
+#include <mlpack/core/math/image_patches.hpp>
 #include <mlpack/core/math/random.hpp>
 #include <mlpack/core/math/range.hpp>
 #include <boost/test/unit_test.hpp>
@@ -738,6 +739,28 @@ BOOST_AUTO_TEST_CASE(InplaceShuffleTest)
     BOOST_REQUIRE_EQUAL(counts[i], 1);
 }
 
+/**
+ * Make sure shuffling dense data in place gives the same result as shuffling
+ * it into other matrices.
+ */
+BOOST_AUTO_TEST_CASE(InplaceShuffleMatchesCopyTest)
+{
+  arma::mat data(5, 1000, arma::fill::randu);
+  arma::Row<size_t> labels = arma::linspace<arma::Row<size_t>>(0, 999, 1000);
+
+  arma::mat outputData;
+  arma::Row<size_t> outputLabels;
+  RandomSeed(5);
+  ShuffleData(data, labels, outputData, outputLabels);
+
+  RandomSeed(5);
+  ShuffleData(data, labels, data, labels);
+
+  CheckMatrices(data, outputData);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(labels[i], outputLabels[i]);
+}
+
 /**
  * Make sure shuffling sparse data works when the input and output matrices are
  * the same.
@@ -819,4 +842,67 @@ BOOST_AUTO_TEST_CASE(InplaceCubeShuffleTest)
     BOOST_REQUIRE_EQUAL(counts[i], data.n_slices);
 }
 
+/**
+ * Test ImagePatches extracts the expected overlapping patches of multi-channel
+ * images, also as floats, and reassembles the images from them.
+ */
+BOOST_AUTO_TEST_CASE(ImagePatchesTest)
+{
+  const size_t height = 10, width = 12, channels = 3;
+  arma::mat images(height * width * channels, 4, arma::fill::randu);
+
+  ImagePatches patches(height, width, channels, 4, 5, 2, 3);
+  BOOST_REQUIRE_EQUAL(patches.GridHeight(), 4);
+  BOOST_REQUIRE_EQUAL(patches.GridWidth(), 3);
+
+  arma::mat x;
+  patches.Extract(images, x);
+  BOOST_REQUIRE_EQUAL(x.n_rows, 4 * 5 * channels);
+  BOOST_REQUIRE_EQUAL(x.n_cols, 4 * patches.PatchesPerImage());
+  for (size_t i = 0; i < images.n_cols; ++i)
+  {
+    const arma::cube image(images.colptr(i), height, width, channels);
+    for (size_t col = 0; col < 3; ++col)
+    {
+      for (size_t row = 0; row < 4; ++row)
+      {
+        const arma::cube expected = image.subcube(row * 2, col * 3, 0,
+            row * 2 + 3, col * 3 + 4, channels - 1);
+        const arma::vec patch = x.col(i * 12 + col * 4 + row);
+        BOOST_REQUIRE_EQUAL(arma::accu(arma::vectorise(expected) != patch), 0);
+      }
+    }
+  }
+
+  arma::fmat floatX;
+  patches.Extract(images, floatX);
+  BOOST_REQUIRE_SMALL(arma::abs(arma::conv_to<arma::mat>::from(floatX) -
+      x).max(), 1e-6);
+
+  // The overlapping patches give back the pixels that they cover; the last
+  // column of each channel is in no patch.
+  arma::mat reassembled;
+  patches.Reassemble(x, reassembled, -1.0);
+  for (size_t i = 0; i < images.n_cols; ++i)
+  {
+    const arma::cube image(images.colptr(i), height, width, channels);
+    const arma::cube result(reassembled.colptr(i), height, width, channels);
+    BOOST_REQUIRE_SMALL(arma::abs(image.subcube(0, 0, 0, 9, 10, 2) -
+        result.subcube(0, 0, 0, 9, 10, 2)).max(), 1e-10);
+    BOOST_REQUIRE_CLOSE(arma::accu(result.subcube(0, 11, 0, 9, 11, 2)),
+        -10.0 * channels, 1e-5);
+  }
+
+  // Tiles reassemble to the same images.
+  ImagePatches tiles(height, width, channels, 5, 4);
+  tiles.Extract(images, x);
+  BOOST_REQUIRE_EQUAL(x.n_cols, 4 * 6);
+  tiles.Reassemble(x, reassembled);
+  BOOST_REQUIRE_SMALL(arma::abs(reassembled - images).max(), 1e-10);
+
+  BOOST_REQUIRE_THROW(ImagePatches(4, 4, 1, 5, 2), std::invalid_argument);
+  BOOST_REQUIRE_THROW(tiles.Extract(arma::mat(10, 2), x),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/matrix_completion/matrix_completion.hpp>
+#include <mlpack/methods/matrix_completion/soft_impute.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -64,4 +65,93 @@ BOOST_AUTO_TEST_CASE(UniformMatrixCompletionSDP)
   }
 }
 
+/**
+ * Sample the given fraction of the entries of a matrix.
+ */
+void SampleEntries(const arma::mat& x,
+                   const double fraction,
+                   arma::umat& indices,
+                   arma::vec& values)
+{
+  const arma::uvec order = arma::randperm(x.n_elem);
+  const size_t p = (size_t) (fraction * x.n_elem);
+  indices.set_size(2, p);
+  values.set_size(p);
+  for (size_t i = 0; i < p; ++i)
+  {
+    indices(0, i) = order[i] % x.n_rows;
+    indices(1, i) = order[i] / x.n_rows;
+    values[i] = x[order[i]];
+  }
+}
+
+/**
+ * Soft-Impute without thresholding (Hard-Impute) with the right rank must
+ * recover a random low-rank matrix from a fraction of its entries.
+ */
+BOOST_AUTO_TEST_CASE(SoftImputeLowRankRecovery)
+{
+  const arma::mat x = arma::randn<arma::mat>(200, 3) *
+      arma::randn<arma::mat>(3, 150);
+  arma::umat indices;
+  arma::vec values;
+  SampleEntries(x, 0.3, indices, values);
+
+  SoftImpute si(x.n_rows, x.n_cols, indices, values, 3, 0.0, 1000, 1e-10);
+  arma::mat u, v;
+  arma::vec s;
+  si.Recover(u, s, v);
+
+  BOOST_REQUIRE_EQUAL(u.n_rows, (size_t) 200);
+  BOOST_REQUIRE_EQUAL(v.n_rows, (size_t) 150);
+  BOOST_REQUIRE_LE(s.n_elem, (size_t) 3);
+  BOOST_REQUIRE_LT(si.Iterations(), (size_t) 1000);
+
+  const arma::mat recovered = u * arma::diagmat(s) * v.t();
+  const double err = arma::norm(x - recovered, "fro") / arma::norm(x, "fro");
+  BOOST_REQUIRE_SMALL(err, 1e-4);
+
+  // The factors are orthonormal.
+  CheckMatrices(u.t() * u, arma::eye<arma::mat>(s.n_elem, s.n_elem), 1e-5);
+  CheckMatrices(v.t() * v, arma::eye<arma::mat>(s.n_elem, s.n_elem), 1e-5);
+}
+
+/**
+ * Soft-thresholding with a large threshold must shrink the estimate towards
+ * zero, and a threshold above the largest singular value must give zero.
+ */
+BOOST_AUTO_TEST_CASE(SoftImputeThreshold)
+{
+  const arma::mat x = arma::randn<arma::mat>(60, 2) *
+      arma::randn<arma::mat>(2, 50);
+  arma::umat indices;
+  arma::vec values;
+  SampleEntries(x, 0.5, indices, values);
+
+  arma::mat hard, soft;
+  SoftImpute(60, 50, indices, values, 5, 0.0, 200).Recover(hard);
+  SoftImpute(60, 50, indices, values, 5, 5.0, 200).Recover(soft);
+  BOOST_REQUIRE_LT(arma::norm(soft, "fro"), arma::norm(hard, "fro"));
+
+  arma::mat u, v;
+  arma::vec s;
+  SoftImpute(60, 50, indices, values, 5, 10.0 * arma::norm(x, "fro"))
+      .Recover(u, s, v);
+  BOOST_REQUIRE_EQUAL(s.n_elem, (size_t) 0);
+}
+
+/**
+ * Entries given more than once must be rejected.
+ */
+BOOST_AUTO_TEST_CASE(SoftImputeDuplicateEntries)
+{
+  const arma::umat indices("0 1 0; 2 1 2");
+  const arma::vec values("1.0 2.0 3.0");
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(SoftImpute(3, 3, indices, values, 1),
+      std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
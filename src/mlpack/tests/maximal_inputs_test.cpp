@@ -83,4 +83,24 @@ BOOST_AUTO_TEST_CASE(ColumnToBlocksChangeBlockSize)
   TestResults(output, matlabResults);
 }
 
+/**
+ * Test ColumnsToBlocks with fewer columns than blocks leaves the remaining
+ * blocks as buffer.
+ */
+BOOST_AUTO_TEST_CASE(ColumnToBlocksFewerColumns)
+{
+  arma::mat output;
+  mlpack::math::ColumnsToBlocks ctb(2, 2);
+  const arma::mat input = CreateMaximalInput();
+  ctb.Transform(input, output);
+
+  BOOST_REQUIRE_EQUAL(output.n_rows, 7);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 7);
+  BOOST_REQUIRE_EQUAL(arma::accu(output.submat(1, 1, 2, 2) !=
+      arma::reshape(input.col(0), 2, 2)), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(output.submat(1, 4, 2, 5) !=
+      arma::reshape(input.col(1), 2, 2)), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(output.submat(4, 1, 5, 5) != -1.0), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -165,4 +165,59 @@ BOOST_AUTO_TEST_CASE(GaussianClustering)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * Make sure the result does not depend on the number of threads, and that
+ * other seed bins still find the three clusters of the simple dataset.
+ */
+BOOST_AUTO_TEST_CASE(ParallelMeanShiftTest)
+{
+  const arma::mat data = trans(meanShiftData);
+
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+  #endif
+
+  MeanShift<> meanShift;
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster(data, assignments, centroids, true, false);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(4);
+  #endif
+
+  arma::Row<size_t> parallelAssignments;
+  arma::mat parallelCentroids;
+  meanShift.Cluster(data, parallelAssignments, parallelCentroids, true, false);
+
+  BOOST_REQUIRE_EQUAL(parallelCentroids.n_cols, centroids.n_cols);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(parallelCentroids[i], centroids[i], 1e-5);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(parallelAssignments[i], assignments[i]);
+
+  // Now use bins of half the radius to generate the seeds.
+  MeanShift<> binnedMeanShift(meanShift.Radius(), 1000,
+      kernel::GaussianKernel(), 0.5 * meanShift.Radius());
+  BOOST_REQUIRE_CLOSE(binnedMeanShift.BinSize(), 0.5 * meanShift.Radius(),
+      1e-5);
+
+  arma::Row<size_t> binnedAssignments;
+  arma::mat binnedCentroids;
+  binnedMeanShift.Cluster(data, binnedAssignments, binnedCentroids);
+
+  BOOST_REQUIRE_EQUAL(binnedCentroids.n_cols, 3);
+  for (size_t i = 1; i < 13; ++i)
+    BOOST_REQUIRE_EQUAL(binnedAssignments[i], binnedAssignments[0]);
+  for (size_t i = 14; i < 20; ++i)
+    BOOST_REQUIRE_EQUAL(binnedAssignments[i], binnedAssignments[13]);
+  for (size_t i = 21; i < 30; ++i)
+    BOOST_REQUIRE_EQUAL(binnedAssignments[i], binnedAssignments[20]);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+}
+
 BOOST_AUTO_TEST_SUITE_END();
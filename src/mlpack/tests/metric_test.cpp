@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/fixed_lmetric.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -87,4 +88,122 @@ BOOST_AUTO_TEST_CASE(LINFMetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+/**
+ * Check the batch Evaluate() of a metric against the evaluations of each pair
+ * of points, on matrices and on subviews.
+ */
+template<typename MetricType>
+void CheckBatchEvaluate()
+{
+  arma::mat a(6, 30, arma::fill::randn);
+  arma::mat b(6, 45, arma::fill::randn);
+
+  arma::mat out;
+  MetricType::Evaluate(a, b, out);
+  BOOST_REQUIRE_EQUAL(out.n_rows, a.n_cols);
+  BOOST_REQUIRE_EQUAL(out.n_cols, b.n_cols);
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      BOOST_REQUIRE_SMALL(out(i, j) - MetricType::Evaluate(a.col(i),
+          b.col(j)), 1e-8);
+    }
+  }
+
+  arma::mat subviewOut;
+  MetricType::Evaluate(a.cols(5, 14), b.cols(20, 44), subviewOut);
+  BOOST_REQUIRE_EQUAL(subviewOut.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(subviewOut.n_cols, 25);
+  CheckMatrices(subviewOut, out.submat(5, 20, 14, 44));
+
+  // The distance between a point and itself must be (nearly) zero.
+  MetricType::Evaluate(a, a, out);
+  for (size_t i = 0; i < a.n_cols; ++i)
+    BOOST_REQUIRE_SMALL(out(i, i), 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(LMetricBatchEvaluateTest)
+{
+  CheckBatchEvaluate<ManhattanDistance>();
+  CheckBatchEvaluate<SquaredEuclideanDistance>();
+  CheckBatchEvaluate<EuclideanDistance>();
+  CheckBatchEvaluate<LMetric<3, false>>();
+  CheckBatchEvaluate<LMetric<3, true>>();
+  CheckBatchEvaluate<ChebyshevDistance>();
+}
+
+/**
+ * Make sure that the compiled distance kernels, which LMetric uses for long
+ * vectors, give the same distances as Armadillo, for sizes around the block
+ * size of the kernels and for every kind of contiguous vector.
+ */
+template<typename eT>
+void CheckDistanceKernels()
+{
+  const double tolerance = std::is_same<eT, float>::value ? 1e-3 : 1e-8;
+  const size_t sizes[] = { 1, 15, 16, 17, 31, 32, 33, 100, 1000 };
+  for (const size_t n : sizes)
+  {
+    const arma::Mat<eT> data(n, 2, arma::fill::randn);
+    const arma::Col<eT> a = data.col(0);
+    const arma::Row<eT> b = data.col(1).t();
+
+    const eT squared = arma::accu(arma::square(data.col(0) - data.col(1)));
+    const eT manhattan = arma::accu(arma::abs(data.col(0) - data.col(1)));
+
+    BOOST_REQUIRE_CLOSE(SquaredEuclideanKernel(a.memptr(), b.memptr(), n),
+        squared, tolerance);
+    BOOST_REQUIRE_CLOSE(ManhattanKernel(a.memptr(), b.memptr(), n), manhattan,
+        tolerance);
+
+    BOOST_REQUIRE_CLOSE(SquaredEuclideanDistance::Evaluate(data.col(0),
+        data.col(1)), squared, tolerance);
+    BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(a, data.col(1)),
+        std::sqrt(squared), tolerance);
+    BOOST_REQUIRE_SMALL(ManhattanDistance::Evaluate(data.col(0), a), eT(1e-5));
+    BOOST_REQUIRE_CLOSE(ManhattanDistance::Evaluate(a, data.col(1)), manhattan,
+        tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DistanceKernelsTest)
+{
+  CheckDistanceKernels<double>();
+  CheckDistanceKernels<float>();
+}
+
+/**
+ * Make sure that FixedLMetric gives the same distances as LMetric.
+ */
+template<size_t Dim, int Power, bool TakeRoot>
+void CheckFixedLMetric()
+{
+  const arma::mat data(Dim, 10, arma::fill::randn);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      const double expected = LMetric<Power, TakeRoot>::Evaluate(data.col(i),
+          data.col(j));
+      const double d = FixedLMetric<Dim, Power, TakeRoot>::Evaluate(
+          data.col(i), data.col(j));
+      if (i == j)
+        BOOST_REQUIRE_SMALL(d, 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(d, expected, 1e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(FixedLMetricTest)
+{
+  CheckFixedLMetric<2, 1, false>();
+  CheckFixedLMetric<2, 2, true>();
+  CheckFixedLMetric<3, 2, false>();
+  CheckFixedLMetric<3, 3, true>();
+  CheckFixedLMetric<3, INT_MAX, false>();
+  CheckFixedLMetric<5, 2, true>();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -314,4 +314,81 @@ BOOST_AUTO_TEST_CASE(SeparateTrainIndividualIncrementalTest)
   }
 }
 
+/**
+ * Incremental training on several batches should give the same model as
+ * training on all the points at once.
+ */
+BOOST_AUTO_TEST_CASE(BatchIncrementalTest)
+{
+  arma::mat data = arma::randn(5, 3000);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(3000,
+      arma::distr_param(0, 2));
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data.col(i) = 100.0 + (labels[i] + 1.0) * data.col(i) + labels[i];
+
+  NaiveBayesClassifier<> nbc(data, labels, 3, false);
+
+  NaiveBayesClassifier<> nbcBatches(data.n_rows, 3);
+  nbcBatches.Train(data.cols(0, 999), labels.subvec(0, 999), 3, true);
+  nbcBatches.Train(data.cols(1000, 1009), labels.subvec(1000, 1009), 3, true);
+  nbcBatches.Train(data.cols(1010, 2999), labels.subvec(1010, 2999), 3, true);
+
+  CheckMatrices(nbc.Means(), nbcBatches.Means(), 1e-7);
+  CheckMatrices(nbc.Variances(), nbcBatches.Variances(), 1e-7);
+  CheckMatrices(nbc.Probabilities(), nbcBatches.Probabilities(), 1e-7);
+
+  // Non-incremental training only uses the given data.
+  nbcBatches.Train(data.cols(0, 999), labels.subvec(0, 999), 3, false);
+  NaiveBayesClassifier<> nbcFirst(data.cols(0, 999), labels.subvec(0, 999), 3);
+  CheckMatrices(nbcFirst.Means(), nbcBatches.Means());
+  CheckMatrices(nbcFirst.Variances(), nbcBatches.Variances());
+  CheckMatrices(nbcFirst.Probabilities(), nbcBatches.Probabilities());
+}
+
+/**
+ * The class probabilities should be the normalized Gaussian likelihoods, also
+ * for data far from the origin.
+ */
+BOOST_AUTO_TEST_CASE(ClassifyProbabilitiesTest)
+{
+  arma::mat data = arma::randn(4, 2000);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(2000,
+      arma::distr_param(0, 1));
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data.col(i) += 1e5 + 0.5 * labels[i];
+
+  NaiveBayesClassifier<> nbc(data, labels, 2);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  nbc.Classify(data, predictions, probabilities);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, (size_t) 2);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, (size_t) 2000);
+
+  arma::Row<size_t> labelPredictions;
+  nbc.Classify(data, labelPredictions);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::vec logLikelihoods(2);
+    for (size_t c = 0; c < 2; ++c)
+    {
+      logLikelihoods[c] = std::log(nbc.Probabilities()[c]) - 0.5 * arma::accu(
+          arma::log(2 * M_PI * nbc.Variances().col(c)) +
+          arma::square(data.col(i) - nbc.Means().col(c)) /
+          nbc.Variances().col(c));
+    }
+    arma::uword maxIndex = 0;
+    arma::vec expected = arma::exp(logLikelihoods -
+        logLikelihoods.max(maxIndex));
+    expected /= arma::accu(expected);
+
+    for (size_t c = 0; c < 2; ++c)
+      BOOST_REQUIRE_SMALL(probabilities(c, i) - expected[c], 1e-6);
+    BOOST_REQUIRE_EQUAL(predictions[i], (size_t) maxIndex);
+    BOOST_REQUIRE_EQUAL(labelPredictions[i], predictions[i]);
+    BOOST_REQUIRE_EQUAL(nbc.Classify(data.col(i)), predictions[i]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
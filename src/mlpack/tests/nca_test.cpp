@@ -322,4 +322,93 @@ BOOST_AUTO_TEST_CASE(NCALBFGSSimpleDataset)
   BOOST_REQUIRE_LT(arma::norm(finalGradient, 2), 1e-6);
 }
 
+/**
+ * With as many neighbors as points, the truncated softmax error function must
+ * be the softmax error function.
+ */
+BOOST_AUTO_TEST_CASE(TruncatedSoftmaxAllNeighbors)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 30);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(30,
+      arma::distr_param(0, 2));
+  const arma::mat coordinates = arma::eye<arma::mat>(3, 3) +
+      0.3 * arma::randu<arma::mat>(3, 3);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  TruncatedSoftmaxErrorFunction<SquaredEuclideanDistance> tsef(data, labels,
+      SquaredEuclideanDistance(), 29);
+
+  BOOST_REQUIRE_CLOSE(tsef.Evaluate(coordinates), sef.Evaluate(coordinates),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(tsef.Evaluate(coordinates, 4, 7),
+      sef.Evaluate(coordinates, 4, 7), 1e-5);
+
+  arma::mat gradient, truncatedGradient;
+  sef.Gradient(coordinates, gradient);
+  tsef.Gradient(coordinates, truncatedGradient);
+  CheckMatrices(truncatedGradient, gradient, 1e-5);
+
+  sef.Gradient(coordinates, 10, gradient, 5);
+  tsef.Gradient(coordinates, 10, truncatedGradient, 5);
+  CheckMatrices(truncatedGradient, gradient, 1e-5);
+}
+
+/**
+ * The neighbors of the truncated softmax error function must be the nearest
+ * neighbors in the transformed space, and they must follow the points when the
+ * dataset is shuffled.
+ */
+BOOST_AUTO_TEST_CASE(TruncatedSoftmaxNeighbors)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 200);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(200,
+      arma::distr_param(0, 1));
+  const arma::mat coordinates = arma::diagmat(arma::vec("1.0 2.0 0.5 3.0"));
+
+  TruncatedSoftmaxErrorFunction<SquaredEuclideanDistance> tsef(data, labels,
+      SquaredEuclideanDistance(), 5);
+  const double objective = tsef.Evaluate(coordinates);
+
+  neighbor::KNN knn(arma::mat(coordinates * data), neighbor::NAIVE_MODE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(tsef.Neighbors().n_rows, (size_t) 5);
+  BOOST_REQUIRE_EQUAL(tsef.Neighbors().n_cols, (size_t) 200);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(tsef.Neighbors()[i], neighbors[i]);
+
+  // Shuffling does not search the neighbors again, so the objective over the
+  // whole dataset must stay the same.
+  tsef.Shuffle();
+  BOOST_REQUIRE_CLOSE(tsef.Evaluate(coordinates), objective, 1e-5);
+}
+
+/**
+ * NCA with the truncated softmax error function should improve the objective
+ * on the simple dataset.
+ */
+BOOST_AUTO_TEST_CASE(NCATruncatedLBFGSSimpleDataset)
+{
+  // Useful but simple dataset with six points and two classes.
+  arma::mat data           = "-0.1 -0.1 -0.1  0.1  0.1  0.1;"
+                             " 1.0  0.0 -1.0  1.0  0.0 -1.0 ";
+  arma::Row<size_t> labels = " 0    0    0    1    1    1   ";
+
+  NCA<SquaredEuclideanDistance, L_BFGS,
+      TruncatedSoftmaxErrorFunction<SquaredEuclideanDistance>> nca(data,
+      labels);
+  nca.ErrorFunction().K() = 3;
+  nca.Optimizer().NumBasis() = 5;
+
+  arma::mat outputMatrix;
+  nca.LearnDistance(outputMatrix);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  const double initObj = sef.Evaluate(arma::eye<arma::mat>(2, 2));
+  const double finalObj = sef.Evaluate(outputMatrix);
+
+  BOOST_REQUIRE_LT(finalObj, initObj);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
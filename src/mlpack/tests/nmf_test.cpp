@@ -16,6 +16,9 @@
 #include <mlpack/methods/amf/update_rules/nmf_mult_div.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
+#include <mlpack/methods/amf/update_rules/implicit_als.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
+#include <mlpack/methods/amf/termination_policies/time_budget_termination.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -295,4 +298,185 @@ BOOST_AUTO_TEST_CASE(NonNegNMFALSTest)
       && arma::all(arma::vectorise(h) >= 0));
 }
 
+/**
+ * A budget of zero seconds should stop the factorization after its first
+ * iteration, and a large budget should let the wrapped policy terminate it.
+ */
+BOOST_AUTO_TEST_CASE(NMFTimeBudgetTest)
+{
+  mat w = randu<mat>(20, 12);
+  mat h = randu<mat>(12, 20);
+  mat v = w * h;
+  const size_t r = 12;
+
+  AMF<TimeBudgetTermination<>> nmf(TimeBudgetTermination<>(0.0));
+  nmf.Apply(v, r, w, h);
+
+  BOOST_REQUIRE(nmf.TerminationPolicy().Exceeded());
+  BOOST_REQUIRE_EQUAL(nmf.TerminationPolicy().Iteration(), 1);
+
+  AMF<TimeBudgetTermination<>> longNMF(TimeBudgetTermination<>(1e6));
+  longNMF.Apply(v, r, w, h);
+
+  BOOST_REQUIRE(!longNMF.TerminationPolicy().Exceeded());
+  BOOST_REQUIRE_GT(longNMF.TerminationPolicy().Iteration(), 1);
+}
+
+/**
+ * Compute the objective of implicit ALS: the confidence-weighted squared error
+ * of the preferences, plus the regularization.
+ */
+double ImplicitALSObjective(const mat& v,
+                            const mat& w,
+                            const mat& h,
+                            const double lambda,
+                            const double alpha)
+{
+  const mat preferences = conv_to<mat>::from(v != 0);
+  const mat confidences = 1.0 + alpha * v;
+  return accu(confidences % square(preferences - w * h)) +
+      lambda * (accu(square(w)) + accu(square(h)));
+}
+
+/**
+ * Make sure that each iteration of implicit ALS does not increase its
+ * objective, and that the factorization ranks the observed interactions above
+ * the others.
+ */
+BOOST_AUTO_TEST_CASE(ImplicitALSObjectiveTest)
+{
+  sp_mat v;
+  v.sprandu(40, 30, 0.2);
+  v *= 5.0;
+  const mat dv(v);
+  const size_t r = 4;
+
+  mat iw, ih;
+  RandomAcolInitialization<>::Initialize(v, r, iw, ih);
+
+  double lastObjective = std::numeric_limits<double>::max();
+  mat w, h;
+  for (size_t iterations = 1; iterations <= 10; ++iterations)
+  {
+    GivenInitialization g(iw, ih);
+    AMF<MaxIterationTermination, GivenInitialization, ImplicitALSUpdate> als(
+        MaxIterationTermination(iterations), g, ImplicitALSUpdate(0.1, 2.0));
+    als.Apply(v, r, w, h);
+
+    const double objective = ImplicitALSObjective(dv, w, h, 0.1, 2.0);
+    BOOST_REQUIRE_LE(objective, lastObjective * (1 + 1e-8));
+    lastObjective = objective;
+  }
+
+  // The observed interactions should be predicted higher on average.
+  const mat predictions = w * h;
+  const double observed = accu(predictions % conv_to<mat>::from(dv != 0)) /
+      accu(dv != 0);
+  const double unobserved = accu(predictions % conv_to<mat>::from(dv == 0)) /
+      accu(dv == 0);
+  BOOST_REQUIRE_GT(observed, unobserved);
+}
+
+/**
+ * Make sure that implicit ALS gives the same result with dense and sparse
+ * input, and with any number of threads.
+ */
+BOOST_AUTO_TEST_CASE(ImplicitALSParallelTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+  #endif
+
+  sp_mat v;
+  v.sprandu(300, 200, 0.05);
+  const mat dv(v);
+  const size_t r = 8;
+
+  mat iw, ih;
+  RandomAcolInitialization<>::Initialize(v, r, iw, ih);
+
+  mat w[3], h[3];
+  for (size_t run = 0; run < 3; ++run)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(run == 1 ? 4 : 1);
+    #endif
+
+    GivenInitialization g(iw, ih);
+    AMF<MaxIterationTermination, GivenInitialization, ImplicitALSUpdate> als(
+        MaxIterationTermination(5), g);
+    if (run < 2)
+      als.Apply(v, r, w[run], h[run]);
+    else
+      als.Apply(dv, r, w[run], h[run]);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  CheckMatrices(w[0], w[1]);
+  CheckMatrices(h[0], h[1]);
+  CheckMatrices(w[0], w[2]);
+  CheckMatrices(h[0], h[2]);
+}
+
+/**
+ * Make sure that the multiplicative update rules give the same result with
+ * dense and sparse input (where W H is only computed at the nonzero entries),
+ * and with any number of threads.
+ */
+BOOST_AUTO_TEST_CASE(SparseNMFMultiplicativeTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+  #endif
+
+  sp_mat v;
+  v.sprandu(100, 80, 0.1);
+  // Ensure there is at least one nonzero element in every row and column.
+  for (size_t i = 0; i < 80; ++i)
+    v(i, i) += 0.1;
+  const mat dv(v);
+  const size_t r = 6;
+
+  mat iw, ih;
+  RandomInitialization::Initialize(v, r, iw, ih);
+
+  mat w[3], h[3], dw[3], dh[3];
+  for (size_t run = 0; run < 3; ++run)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(run == 1 ? 4 : 1);
+    #endif
+
+    GivenInitialization g(iw, ih);
+    AMF<MaxIterationTermination, GivenInitialization,
+        NMFMultiplicativeDivergenceUpdate> div(MaxIterationTermination(20), g);
+    AMF<MaxIterationTermination, GivenInitialization,
+        NMFMultiplicativeDistanceUpdate> dist(MaxIterationTermination(20), g);
+    if (run < 2)
+    {
+      div.Apply(v, r, w[run], h[run]);
+      dist.Apply(v, r, dw[run], dh[run]);
+    }
+    else
+    {
+      div.Apply(dv, r, w[run], h[run]);
+      dist.Apply(dv, r, dw[run], dh[run]);
+    }
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  CheckMatrices(w[0], w[1]);
+  CheckMatrices(h[0], h[1]);
+  CheckMatrices(w[0], w[2], 1e-4);
+  CheckMatrices(h[0], h[2], 1e-4);
+  CheckMatrices(dw[0], dw[2], 1e-4);
+  CheckMatrices(dh[0], dh[2], 1e-4);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,147 @@
+/**
+ * @file nn_descent_test.cpp
+ *
+ * Tests for the NNDescent class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/nn_descent/nn_descent.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(NNDescentTest);
+
+/**
+ * Check that the graph has the format of NeighborSearch results: no point is
+ * its own neighbor, and the neighbors are distinct, sorted and have the right
+ * distances.
+ */
+void CheckGraph(const arma::mat& dataset,
+                const arma::Mat<size_t>& neighbors,
+                const arma::mat& distances,
+                const size_t k)
+{
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, k);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, dataset.n_cols);
+  BOOST_REQUIRE_EQUAL(distances.n_rows, k);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, dataset.n_cols);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors(j, i), dataset.n_cols);
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          dataset.col(i), dataset.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+      {
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+        for (size_t l = 0; l < j; ++l)
+          BOOST_REQUIRE_NE(neighbors(l, i), neighbors(j, i));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the graph holds nearly all the true neighbors.
+ */
+BOOST_AUTO_TEST_CASE(NNDescentRecallTest)
+{
+  math::RandomSeed(1);
+  arma::mat dataset = arma::randu<arma::mat>(10, 3000);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(10, trueNeighbors, trueDistances);
+
+  NNDescent<> nnDescent(1.0);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  nnDescent.Build(dataset, 10, neighbors, distances);
+
+  CheckGraph(dataset, neighbors, distances, 10);
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.9);
+  BOOST_REQUIRE_GT(nnDescent.Iterations(), 0);
+  BOOST_REQUIRE_GT(nnDescent.DistanceEvaluations(), 0);
+}
+
+/**
+ * Make sure that without any iteration the graph is the random initial graph,
+ * which has a much lower recall.
+ */
+BOOST_AUTO_TEST_CASE(NNDescentNoIterationTest)
+{
+  math::RandomSeed(2);
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(5, trueNeighbors, trueDistances);
+
+  NNDescent<> nnDescent(0.5, 0.001, 0);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  nnDescent.Build(dataset, 5, neighbors, distances);
+
+  CheckGraph(dataset, neighbors, distances, 5);
+  BOOST_REQUIRE_EQUAL(nnDescent.Iterations(), 0);
+  BOOST_REQUIRE_EQUAL(nnDescent.DistanceEvaluations(), 5 * dataset.n_cols);
+  BOOST_REQUIRE_LT(KNN::Recall(neighbors, trueNeighbors), 0.1);
+}
+
+/**
+ * Make sure that the graph only depends on the random seed.
+ */
+BOOST_AUTO_TEST_CASE(NNDescentSeedTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 800);
+
+  NNDescent<> nnDescent(0.8);
+  arma::Mat<size_t> neighbors1, neighbors2;
+  arma::mat distances1, distances2;
+  math::RandomSeed(3);
+  nnDescent.Build(dataset, 6, neighbors1, distances1);
+  math::RandomSeed(3);
+  nnDescent.Build(dataset, 6, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+/**
+ * Make sure that invalid parameters are refused.
+ */
+BOOST_AUTO_TEST_CASE(NNDescentInvalidParametersTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 10);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  NNDescent<> nnDescent;
+  BOOST_REQUIRE_THROW(nnDescent.Build(dataset, 0, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(nnDescent.Build(dataset, 10, neighbors, distances),
+      std::invalid_argument);
+
+  nnDescent.SampleRate() = 0.0;
+  BOOST_REQUIRE_THROW(nnDescent.Build(dataset, 3, neighbors, distances),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -18,6 +18,7 @@
 #include <mlpack/methods/nystroem_method/ordered_selection.hpp>
 #include <mlpack/methods/nystroem_method/random_selection.hpp>
 #include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
+#include <mlpack/methods/nystroem_method/leverage_score_selection.hpp>
 #include <mlpack/methods/nystroem_method/nystroem_method.hpp>
 
 using namespace mlpack;
@@ -202,4 +203,156 @@ BOOST_AUTO_TEST_CASE(GermanTest)
   }
 }
 
+/**
+ * Make sure that the k-means selection on a sample of the points, with
+ * k-means|| and mini-batch steps, still gives a good approximation of the
+ * kernel matrix of the german dataset.
+ */
+BOOST_AUTO_TEST_CASE(FastKMeansSelectionTest)
+{
+  arma::mat dataset;
+  data::Load("german.csv", dataset, true);
+
+  GaussianKernel gk(16.461);
+  arma::mat kernel;
+  KernelMatrix(dataset, gk, kernel);
+
+  // Cluster only half of the points.
+  const size_t rank = dataset.n_cols / 10;
+  double avgError = 0.0;
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    NystroemMethod<GaussianKernel, FastKMeansSelection<10, 500> > nm(dataset,
+        gk, rank);
+    arma::mat g;
+    nm.Apply(g);
+
+    const double error = arma::norm(kernel - g * g.t(), "fro");
+    if (error != error)
+    {
+      // Sometimes K' is singular.  Unlucky.
+      --trial;
+      continue;
+    }
+
+    avgError += error;
+  }
+
+  // This is the tolerance of KMeansSelection<> for 0.08n points.
+  BOOST_REQUIRE_SMALL(avgError / 5, 12.0);
+}
+
+/**
+ * Make sure that LeverageScoreSelection returns distinct points, and all of
+ * them when more are requested than there are.
+ */
+BOOST_AUTO_TEST_CASE(LeverageScoreSelectionDistinctTest)
+{
+  arma::mat data(4, 200, arma::fill::randu);
+  GaussianKernel gk(0.5);
+
+  const arma::Col<size_t> selected =
+      LeverageScoreSelection<>::Select(data, 30, gk);
+  BOOST_REQUIRE_EQUAL(selected.n_elem, 30);
+  BOOST_REQUIRE_EQUAL(arma::Col<size_t>(arma::unique(selected)).n_elem, 30);
+  BOOST_REQUIRE_LT(selected.max(), 200);
+
+  const arma::Col<size_t> all = LeverageScoreSelection<>::Select(data, 250, gk);
+  BOOST_REQUIRE_EQUAL(all.n_elem, 200);
+  for (size_t i = 0; i < all.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(all[i], i);
+}
+
+/**
+ * Points far from all the others have the largest leverage scores, so with a
+ * narrow kernel LeverageScoreSelection should select all of them.
+ */
+BOOST_AUTO_TEST_CASE(LeverageScoreSelectionOutlierTest)
+{
+  // One dense cluster and five isolated points.
+  arma::mat data(2, 505);
+  data.cols(0, 499).randu();
+  data.cols(0, 499) *= 0.1;
+  for (size_t i = 0; i < 5; ++i)
+    data.col(500 + i).fill(10.0 * (i + 1));
+
+  GaussianKernel gk(0.5);
+  size_t found = 0;
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    const arma::Col<size_t> selected =
+        LeverageScoreSelection<10>::Select(data, 10, gk);
+    for (size_t i = 0; i < selected.n_elem; ++i)
+      if (selected[i] >= 500)
+        ++found;
+  }
+
+  // The isolated points can be missed by the uniform sample that the scores
+  // are computed from, but most of them should be found.
+  BOOST_REQUIRE_GE(found, 15);
+}
+
+/**
+ * Can the Nystroem method with leverage score sampling accurately represent a
+ * rank-10 linear kernel matrix?
+ */
+BOOST_AUTO_TEST_CASE(LeverageScoreSelectionRank10Test)
+{
+  arma::mat data(10, 300, arma::fill::randn);
+  arma::mat basis(50, 10, arma::fill::randn);
+  const arma::mat dataMod = basis * data +
+      1e-5 * arma::randu<arma::mat>(50, 300);
+  const arma::mat kernel = dataMod.t() * dataMod;
+
+  size_t successes = 0;
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    LinearKernel lk;
+    NystroemMethod<LinearKernel, LeverageScoreSelection<> > nm(dataMod, lk,
+        10);
+    arma::mat g;
+    nm.Apply(g);
+
+    const double error = arma::norm(kernel - g * g.t(), "fro") /
+        arma::norm(kernel, "fro");
+    if (error == error && error <= 1e-3)
+      ++successes;
+  }
+
+  BOOST_REQUIRE_GE(successes, 3);
+}
+
+/**
+ * Make sure that the semi-kernel matrix computed in parallel blocks matches
+ * the kernel matrix, for more points than fit in one block.
+ */
+BOOST_AUTO_TEST_CASE(SemiKernelMatrixTest)
+{
+  arma::mat data(3, 2500, arma::fill::randu);
+  arma::Col<size_t> selected(20);
+  for (size_t i = 0; i < selected.n_elem; ++i)
+    selected[i] = 100 * i + 7;
+
+  EpanechnikovKernel ek(1.0);
+  NystroemMethod<EpanechnikovKernel, RandomSelection> nm(data, ek, 20);
+  arma::mat miniKernel, semiKernel;
+  nm.GetKernelMatrix(selected, miniKernel, semiKernel);
+
+  BOOST_REQUIRE_EQUAL(miniKernel.n_rows, 20);
+  BOOST_REQUIRE_EQUAL(miniKernel.n_cols, 20);
+  BOOST_REQUIRE_EQUAL(semiKernel.n_rows, 2500);
+  BOOST_REQUIRE_EQUAL(semiKernel.n_cols, 20);
+  for (size_t j = 0; j < selected.n_elem; ++j)
+  {
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const double k = ek.Evaluate(data.col(i), data.col(selected[j]));
+      if (std::abs(k) < 1e-10)
+        BOOST_REQUIRE_SMALL(semiKernel(i, j), 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(semiKernel(i, j), k, 1e-8);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -346,4 +346,145 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   delete textTree;
 }
 
+/**
+ * Make sure that two trees built on the same data with different numbers of
+ * threads hold the same original points in every node, and have the same
+ * bounds.  The order of the points inside a node may differ.
+ */
+template<typename TreeType>
+void CheckSameBuild(const TreeType& node1,
+                    const TreeType& node2,
+                    const std::vector<size_t>& oldFromNew1,
+                    const std::vector<size_t>& oldFromNew2)
+{
+  BOOST_REQUIRE_EQUAL(node1.NumChildren(), node2.NumChildren());
+  BOOST_REQUIRE_EQUAL(node1.NumDescendants(), node2.NumDescendants());
+
+  std::vector<size_t> points1(node1.NumDescendants());
+  std::vector<size_t> points2(node2.NumDescendants());
+  for (size_t i = 0; i < node1.NumDescendants(); ++i)
+  {
+    points1[i] = oldFromNew1[node1.Descendant(i)];
+    points2[i] = oldFromNew2[node2.Descendant(i)];
+  }
+  std::sort(points1.begin(), points1.end());
+  std::sort(points2.begin(), points2.end());
+  for (size_t i = 0; i < points1.size(); ++i)
+    BOOST_REQUIRE_EQUAL(points1[i], points2[i]);
+
+  for (size_t d = 0; d < node1.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_CLOSE(node1.Bound()[d].Lo(), node2.Bound()[d].Lo(), 1e-5);
+    BOOST_REQUIRE_CLOSE(node1.Bound()[d].Hi(), node2.Bound()[d].Hi(), 1e-5);
+  }
+
+  BOOST_REQUIRE_CLOSE(node1.FurthestDescendantDistance(),
+      node2.FurthestDescendantDistance(), 1e-5);
+
+  for (size_t i = 0; i < node1.NumChildren(); ++i)
+  {
+    CheckSameBuild(node1.Child(i), node2.Child(i), oldFromNew1,
+        oldFromNew2);
+  }
+}
+
+/**
+ * Make sure that building an octree with several threads gives the same tree
+ * as building it with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBuildTest)
+{
+  arma::mat dataset(3, 30000, arma::fill::randu);
+
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+  #endif
+
+  std::vector<size_t> oldFromNew1;
+  Octree<> serialTree(dataset, oldFromNew1);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(4);
+  #endif
+
+  std::vector<size_t> oldFromNew2;
+  Octree<> parallelTree(dataset, oldFromNew2);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  CheckSameBuild(serialTree, parallelTree, oldFromNew1, oldFromNew2);
+}
+
+/**
+ * Make sure every point of a node is inside its bound, and that every leaf
+ * holds at most maxLeafSize points, unless they are all the same point.
+ */
+template<typename TreeType>
+void CheckMortonNode(const TreeType& node, const size_t maxLeafSize)
+{
+  for (size_t i = 0; i < node.NumDescendants(); ++i)
+  {
+    BOOST_REQUIRE(node.Bound().Contains(
+        node.Dataset().col(node.Descendant(i))));
+  }
+
+  if (node.NumChildren() == 0 && node.NumPoints() > maxLeafSize)
+  {
+    for (size_t i = 1; i < node.NumPoints(); ++i)
+    {
+      BOOST_REQUIRE_SMALL(arma::norm(node.Dataset().col(node.Point(i)) -
+          node.Dataset().col(node.Point(0))), 1e-10);
+    }
+  }
+
+  BOOST_REQUIRE_LE(node.NumChildren(), std::pow(2, node.Dataset().n_rows));
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    CheckMortonNode(node.Child(i), maxLeafSize);
+}
+
+/**
+ * Build octrees from Morton codes in one, two and three dimensions, with some
+ * duplicated points, and make sure the nodes and the mappings are correct.
+ */
+BOOST_AUTO_TEST_CASE(MortonBuildTest)
+{
+  for (size_t d = 1; d <= 3; ++d)
+  {
+    arma::mat dataset(d, 2000, arma::fill::randu);
+    dataset.cols(1000, 1099).each_col() = dataset.col(0);
+    arma::mat datacopy(dataset);
+
+    std::vector<size_t> oldFromNew;
+    Octree<> t(std::move(dataset), oldFromNew, 5);
+
+    for (size_t i = 0; i < oldFromNew.size(); ++i)
+    {
+      BOOST_REQUIRE_SMALL(arma::norm(datacopy.col(oldFromNew[i]) -
+          t.Dataset().col(i)), 1e-10);
+    }
+
+    BOOST_REQUIRE_EQUAL(t.NumDescendants(), 2000);
+    CheckMortonNode(t, 5);
+    CheckOverlap(t);
+    CheckFurthestDistances(t);
+  }
+}
+
+/**
+ * Make sure a tree on many copies of the same point is a leaf.
+ */
+BOOST_AUTO_TEST_CASE(MortonSamePointTest)
+{
+  arma::mat dataset(3, 100);
+  dataset.each_col() = arma::vec("0.3 0.1 0.7");
+
+  Octree<> t(dataset, 10);
+
+  BOOST_REQUIRE_EQUAL(t.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(t.NumPoints(), 100);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
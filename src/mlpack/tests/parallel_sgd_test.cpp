@@ -103,6 +103,71 @@ BOOST_AUTO_TEST_CASE(GeneralizedRosenbrockTest)
   }
 }
 
+/**
+ * Functions without sparse gradients should be optimized with dense
+ * minibatches, and updates that may race.
+ */
+BOOST_AUTO_TEST_CASE(DenseHogwildTest)
+{
+  DenseGradientTestFunction f;
+
+  ConstantStep decayPolicy(0.2);
+
+  size_t threadsAvailable = omp_get_max_threads();
+  for (size_t i = threadsAvailable; i > 0; --i)
+  {
+    omp_set_num_threads(i);
+
+    // Each thread takes a contiguous share of the functions in minibatches of
+    // size 1.
+    size_t threadShareSize = std::ceil((float) f.NumFunctions() / i);
+
+    ParallelSGD<ConstantStep> s(10000, threadShareSize, 1e-10, true,
+        decayPolicy, 1);
+
+    arma::mat coordinates = f.GetInitialPoint();
+    double result = s.Optimize(f, coordinates);
+
+    BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+    BOOST_REQUIRE_CLOSE(coordinates[0], 2, 0.02);
+    BOOST_REQUIRE_CLOSE(coordinates[1], 1, 0.02);
+    BOOST_REQUIRE_CLOSE(coordinates[2], 1.5, 0.02);
+    BOOST_REQUIRE_CLOSE(coordinates[3], 4, 0.02);
+  }
+}
+
+/**
+ * With one replica of the parameters per group of threads, the averaged
+ * parameters should still converge.
+ */
+BOOST_AUTO_TEST_CASE(ReplicatedParallelSGDTest)
+{
+  SparseTestFunction f;
+
+  ConstantStep decayPolicy(0.4);
+
+  size_t threadsAvailable = omp_get_max_threads();
+  for (size_t i = threadsAvailable; i > 0; --i)
+  {
+    omp_set_num_threads(i);
+
+    size_t threadShareSize = std::ceil((float) f.NumFunctions() / i);
+
+    // Use two replicas (or one, if there is only one thread).
+    ParallelSGD<ConstantStep> s(10000, threadShareSize, 1e-10, true,
+        decayPolicy, 1, 2);
+
+    arma::mat coordinates = f.GetInitialPoint();
+    double result = s.Optimize(f, coordinates);
+
+    BOOST_REQUIRE_CLOSE(result, 123.75, 0.01);
+    BOOST_REQUIRE_CLOSE(coordinates[0], 2, 0.02);
+    BOOST_REQUIRE_CLOSE(coordinates[1], 1, 0.02);
+    BOOST_REQUIRE_CLOSE(coordinates[2], 1.5, 0.02);
+    BOOST_REQUIRE_CLOSE(coordinates[3], 4, 0.02);
+  }
+}
+
 #endif
 
 /**
@@ -13,6 +13,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
@@ -207,6 +208,134 @@ BOOST_AUTO_TEST_CASE(ArmaComparisonRandomizedPCATest)
   ArmaComparisonPCA<RandomizedSVDPolicy>();
 }
 
+/**
+ * Compare the output of randomized-SVD PCA on sparse data with Armadillo's PCA
+ * of the same data.
+ */
+BOOST_AUTO_TEST_CASE(SparseRandomizedPCATest)
+{
+  arma::sp_mat data;
+  data.sprandu(5, 1000, 0.3);
+
+  arma::mat coeff, coeff1, score, score1;
+  arma::vec eigVal, eigVal1;
+
+  PCAType<RandomizedSVDPolicy> pcaType;
+  pcaType.Apply(data, score1, eigVal1, coeff1, 5);
+
+  princomp(coeff, score, eigVal, trans(arma::mat(data)));
+
+  BOOST_REQUIRE_EQUAL(eigVal1.n_elem, 5);
+  BOOST_REQUIRE_EQUAL(score1.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(score1.n_cols, 1000);
+  for (size_t i = 0; i < eigVal.n_elem; i++)
+    BOOST_REQUIRE_CLOSE(eigVal[i], eigVal1[i], 0.0001);
+
+  // The scores should be the same, up to the sign of each component.
+  for (size_t i = 0; i < 5; i++)
+  {
+    const double sign = arma::dot(score1.row(i), score.col(i)) < 0 ? -1 : 1;
+    CheckMatrices(sign * score1.row(i), score.col(i).t(), 1e-3);
+  }
+}
+
+/**
+ * Folding batches into incremental PCA should give the same result as PCA of
+ * all the points.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCATest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 1000);
+  data.row(1) += 2.0 * data.row(0);
+
+  arma::mat coeff, score;
+  arma::vec eigVal;
+  princomp(coeff, score, eigVal, trans(data));
+
+  PCAType<IncrementalSVDPolicy> pcaType;
+  arma::mat score1, coeff1;
+  arma::vec eigVal1;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    pcaType.Apply(data.cols(200 * i, 200 * i + 199).eval(), score1, eigVal1,
+        coeff1);
+  }
+
+  BOOST_REQUIRE_CLOSE(pcaType.Decomposition().Points(), 1000.0, 1e-10);
+  BOOST_REQUIRE_EQUAL(eigVal1.n_elem, 4);
+  for (size_t i = 0; i < eigVal.n_elem; i++)
+    BOOST_REQUIRE_CLOSE(eigVal[i], eigVal1[i], 1e-5);
+
+  // The scores of the last batch should be the same, up to the sign of each
+  // component.
+  for (size_t i = 0; i < 4; i++)
+  {
+    const arma::rowvec expected = score.col(i).tail(200).t();
+    const double sign = arma::dot(score1.row(i), expected) < 0 ? -1 : 1;
+    CheckMatrices(sign * score1.row(i), expected, 1e-5);
+  }
+}
+
+/**
+ * Incremental PCA that keeps fewer components should still find the main
+ * components, and a forgetting factor of 0 should only use the last batch.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCARankForgettingTest)
+{
+  // Two strong directions and small noise in 10 dimensions.
+  arma::mat data = 0.01 * arma::randn<arma::mat>(10, 600);
+  data.row(0) += 10.0 * arma::randn<arma::rowvec>(600);
+  data.row(1) += 5.0 * arma::randn<arma::rowvec>(600);
+
+  arma::mat coeff, score;
+  arma::vec eigVal;
+  princomp(coeff, score, eigVal, trans(data));
+
+  PCAType<IncrementalSVDPolicy> pcaType;
+  arma::mat batch;
+  double varRetained = 0.0;
+  for (size_t i = 0; i < 6; ++i)
+  {
+    batch = data.cols(100 * i, 100 * i + 99);
+    varRetained = pcaType.Apply(batch, (size_t) 3);
+  }
+
+  BOOST_REQUIRE_EQUAL(batch.n_rows, 3);
+  BOOST_REQUIRE_GT(varRetained, 0.99);
+
+  pcaType.Decomposition().Reset();
+  BOOST_REQUIRE_EQUAL(pcaType.Decomposition().Points(), 0.0);
+
+  // Only three components are kept between the batches.
+  IncrementalSVDPolicy decomposition;
+  arma::mat coeff1, score1;
+  arma::vec eigVal1;
+  for (size_t i = 0; i < 6; ++i)
+  {
+    batch = data.cols(100 * i, 100 * i + 99);
+    decomposition.Apply(batch, batch, score1, eigVal1, coeff1, 3);
+  }
+
+  BOOST_REQUIRE_EQUAL(eigVal1.n_elem, 3);
+  BOOST_REQUIRE_EQUAL(coeff1.n_cols, 3);
+  for (size_t i = 0; i < 2; i++)
+    BOOST_REQUIRE_CLOSE(eigVal[i], eigVal1[i], 0.01);
+
+  // With no memory, only the last batch is decomposed.
+  const arma::mat lastBatch = data.tail_cols(100);
+  princomp(coeff, score, eigVal, trans(lastBatch));
+
+  PCAType<IncrementalSVDPolicy> forgetful(false, IncrementalSVDPolicy(0.0));
+  for (size_t i = 0; i < 6; ++i)
+  {
+    forgetful.Apply(data.cols(100 * i, 100 * i + 99).eval(), score1, eigVal1,
+        coeff1);
+  }
+
+  for (size_t i = 0; i < eigVal.n_elem; i++)
+    BOOST_REQUIRE_CLOSE(eigVal[i], eigVal1[i], 1e-5);
+}
+
 /**
  * Test that dimensionality reduction with exact-svd PCA works the same way
  * MATLAB does (which should be correct!).
@@ -255,4 +255,63 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * Make sure that the blocked classification gives the same labels as the
+ * outputs of all the points computed at once, when there are several blocks.
+ */
+BOOST_AUTO_TEST_CASE(PerceptronBlockedClassifyTest)
+{
+  mat testData = randu<mat>(5, 2500);
+
+  Perceptron<> p(4, 5);
+  p.Weights() = randn<mat>(5, 4);
+  p.Biases() = randn<vec>(4);
+
+  Row<size_t> predictedLabels;
+  p.Classify(testData, predictedLabels);
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, testData.n_cols);
+
+  mat outputs = p.Weights().t() * testData;
+  outputs.each_col() += p.Biases();
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    uword maxIndex;
+    outputs.col(i).max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictedLabels[i], maxIndex);
+  }
+}
+
+/**
+ * Make sure that single-precision points get the same labels as the
+ * double-precision points.
+ */
+BOOST_AUTO_TEST_CASE(PerceptronFloatClassifyTest)
+{
+  mat testData = randu<mat>(5, 2500);
+  const fmat floatTestData = conv_to<fmat>::from(testData);
+
+  Perceptron<> p(4, 5);
+  p.Weights() = randn<mat>(5, 4);
+  p.Biases() = randn<vec>(4);
+
+  Row<size_t> predictedLabels;
+  p.Classify(floatTestData, predictedLabels);
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, testData.n_cols);
+
+  mat outputs = p.Weights().t() * testData;
+  outputs.each_col() += p.Biases();
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    // Skip the points whose two largest outputs are too close for single
+    // precision.
+    vec sorted = sort(outputs.col(i), "descend");
+    if (sorted[0] - sorted[1] < 1e-4)
+      continue;
+
+    uword maxIndex;
+    outputs.col(i).max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictedLabels[i], maxIndex);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,178 @@
+/**
+ * @file profiler_test.cpp
+ *
+ * Tests for the Profiler.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+#include <sstream>
+#include <thread>
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(ProfilerTest);
+
+/**
+ * Make sure the calls, the times of nested scopes and the counters are
+ * accumulated.
+ */
+BOOST_AUTO_TEST_CASE(NestedScopeTest)
+{
+  Profiler::Reset();
+  Profiler::Enable();
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    MLPACK_PROFILE_SCOPE("profiler_test/outer");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    {
+      MLPACK_PROFILE_SCOPE("profiler_test/inner");
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      MLPACK_PROFILE_COUNT("profiler_test/count", 5);
+    }
+  }
+
+  Profiler::Disable();
+
+  std::map<std::string, ProfileSummary> summary = Profiler::Summary();
+  const ProfileSummary& outer = summary["profiler_test/outer"];
+  const ProfileSummary& inner = summary["profiler_test/inner"];
+
+  BOOST_REQUIRE_EQUAL(outer.calls, 3);
+  BOOST_REQUIRE_EQUAL(inner.calls, 3);
+  BOOST_REQUIRE_EQUAL(summary["profiler_test/count"].count, 15);
+
+  // Each scope slept for at least 6ms in total.
+  BOOST_REQUIRE_GE(inner.totalTime, 6000000);
+  BOOST_REQUIRE_GE(outer.totalTime, inner.totalTime + 6000000);
+  BOOST_REQUIRE_EQUAL(inner.selfTime, inner.totalTime);
+  BOOST_REQUIRE_EQUAL(outer.selfTime + inner.totalTime, outer.totalTime);
+}
+
+/**
+ * Make sure nothing is recorded while profiling is disabled.
+ */
+BOOST_AUTO_TEST_CASE(DisabledTest)
+{
+  Profiler::Reset();
+  Profiler::Disable();
+
+  {
+    MLPACK_PROFILE_SCOPE("profiler_test/disabled");
+    MLPACK_PROFILE_COUNT("profiler_test/disabled_count", 1);
+  }
+
+  std::map<std::string, ProfileSummary> summary = Profiler::Summary();
+  BOOST_REQUIRE(summary.find("profiler_test/disabled") == summary.end());
+  BOOST_REQUIRE(summary.find("profiler_test/disabled_count") ==
+      summary.end());
+}
+
+/**
+ * Make sure the counters of several threads are summed.
+ */
+BOOST_AUTO_TEST_CASE(ThreadCountTest)
+{
+  Profiler::Reset();
+  Profiler::Enable();
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) 1000; ++i)
+  {
+    MLPACK_PROFILE_SCOPE("profiler_test/thread_scope");
+    MLPACK_PROFILE_COUNT("profiler_test/thread_count", 2);
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t)
+  {
+    threads.push_back(std::thread([]()
+    {
+      MLPACK_PROFILE_COUNT("profiler_test/thread_count", 1);
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+
+  Profiler::Disable();
+
+  std::map<std::string, ProfileSummary> summary = Profiler::Summary();
+  BOOST_REQUIRE_EQUAL(summary["profiler_test/thread_scope"].calls, 1000);
+  BOOST_REQUIRE_EQUAL(summary["profiler_test/thread_count"].count, 2004);
+}
+
+/**
+ * Make sure the trace holds the recorded scopes, drops the events that do not
+ * fit, and holds the counters.
+ */
+BOOST_AUTO_TEST_CASE(ChromeTraceTest)
+{
+  Profiler::Reset();
+  Profiler::EnableTracing(5);
+
+  for (size_t i = 0; i < 8; ++i)
+  {
+    MLPACK_PROFILE_SCOPE("profiler_test/\"traced\"");
+    MLPACK_PROFILE_COUNT("profiler_test/trace_count", 1);
+  }
+
+  Profiler::DisableTracing();
+  Profiler::Disable();
+
+  std::ostringstream trace;
+  Profiler::WriteChromeTrace(trace);
+  const std::string s = trace.str();
+
+  BOOST_REQUIRE_EQUAL(s.find("{\"traceEvents\":["), 0);
+  size_t events = 0;
+  for (size_t pos = s.find("\"ph\":\"X\""); pos != std::string::npos;
+       pos = s.find("\"ph\":\"X\"", pos + 1))
+    ++events;
+  BOOST_REQUIRE_EQUAL(events, 5);
+  BOOST_REQUIRE_NE(s.find("profiler_test/\\\"traced\\\""), std::string::npos);
+  BOOST_REQUIRE_NE(s.find("\"dropped_events\":3"), std::string::npos);
+  BOOST_REQUIRE_NE(s.find("\"args\":{\"value\":8}"), std::string::npos);
+
+  // The summary has a header and one line for each of the two entries.
+  std::ostringstream table;
+  Profiler::WriteSummary(table);
+  const std::string t = table.str();
+  BOOST_REQUIRE_EQUAL(std::count(t.begin(), t.end(), '\n'), 3);
+}
+
+/**
+ * Make sure the counters of a neighbor search match its statistics.
+ */
+BOOST_AUTO_TEST_CASE(NeighborSearchCountersTest)
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  KNN knn(dataset);
+
+  Profiler::Reset();
+  Profiler::Enable();
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(5, neighbors, distances);
+
+  Profiler::Disable();
+
+  std::map<std::string, ProfileSummary> summary = Profiler::Summary();
+  BOOST_REQUIRE_EQUAL(summary["neighbor_search/search"].calls, 1);
+  BOOST_REQUIRE_EQUAL(summary["neighbor_search/traversal"].calls, 1);
+  BOOST_REQUIRE_EQUAL(summary["neighbor_search/base_cases"].count,
+      knn.BaseCases());
+  BOOST_REQUIRE_EQUAL(summary["neighbor_search/scores"].count, knn.Scores());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
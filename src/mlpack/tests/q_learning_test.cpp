@@ -170,4 +170,124 @@ BOOST_AUTO_TEST_CASE(CartPoleWithDoubleDQN)
   BOOST_REQUIRE(converged);
 }
 
+//! Test DQN in Cart Pole task, with several copies of the environment.
+BOOST_AUTO_TEST_CASE(CartPoleWithVectorizedDQN)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of iterations using random weights.
+  size_t episodes = 0;
+  bool converged = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 128);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(128, 128);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(128, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+    RandomReplay<CartPole> replayMethod(10, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+    config.StepLimit() = 200;
+
+    // Set up the DQN agent.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy)>
+        agent(std::move(config), std::move(model), std::move(policy),
+            std::move(replayMethod));
+
+    arma::running_stat<double> averageReturn;
+
+    // Each call runs four episodes, with a quarter of the updates of four
+    // calls to Episode().
+    for (episodes = 0; episodes <= 1000; ++episodes)
+    {
+      const arma::colvec episodeReturns = agent.Episodes(4);
+      BOOST_REQUIRE_EQUAL(episodeReturns.n_elem, (size_t) 4);
+      for (size_t i = 0; i < episodeReturns.n_elem; ++i)
+        averageReturn(episodeReturns[i]);
+
+      Log::Debug << "Average return: " << averageReturn.mean()
+          << " Episode returns: " << episodeReturns.t();
+      if (averageReturn.mean() > 35)
+        break;
+    }
+
+    if (episodes < 1000)
+    {
+      converged = true;
+      break;
+    }
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
+//! Test DQN with prioritized experience replay in Cart Pole task.
+BOOST_AUTO_TEST_CASE(CartPoleWithDQNPrioritizedReplay)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of iterations using random weights.
+  size_t episodes = 0;
+  bool converged = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 128);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(128, 128);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(128, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+    PrioritizedReplay<CartPole> replayMethod(10, 10000, 0.6);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+    config.StepLimit() = 200;
+
+    // Set up the DQN agent.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy),
+        decltype(replayMethod)> agent(std::move(config), std::move(model),
+        std::move(policy), std::move(replayMethod));
+
+    arma::running_stat<double> averageReturn;
+
+    for (episodes = 0; episodes <= 1000; ++episodes)
+    {
+      double episodeReturn = agent.Episode();
+      averageReturn(episodeReturn);
+
+      Log::Debug << "Average return: " << averageReturn.mean()
+          << " Episode return: " << episodeReturn << std::endl;
+      if (averageReturn.mean() > 35)
+        break;
+    }
+
+    if (episodes < 1000)
+    {
+      converged = true;
+      break;
+    }
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
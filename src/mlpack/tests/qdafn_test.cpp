@@ -208,4 +208,45 @@ BOOST_AUTO_TEST_CASE(SparseTest)
   BOOST_REQUIRE_EQUAL(distances.n_cols, 1000);
 }
 
+/**
+ * Search more query points than fit in one block, with double and float
+ * storage; every result must be a reference point with its true distance.
+ */
+template<typename MatType>
+void CheckBlockedSearch()
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(5, 500);
+  arma::mat querySet = arma::randu<arma::mat>(5, 2500);
+
+  QDAFN<MatType> qdafn(arma::conv_to<MatType>::from(referenceSet), 10, 20);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  qdafn.Search(arma::conv_to<MatType>::from(querySet), 3, neighbors,
+      distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 2500);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors(j, i), 500);
+      BOOST_REQUIRE_CLOSE(distances(j, i), arma::norm(querySet.col(i) -
+          referenceSet.col(neighbors(j, i))), 1e-3);
+      if (j > 0)
+        BOOST_REQUIRE_GE(distances(j - 1, i), distances(j, i));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BlockedSearchTest)
+{
+  CheckBlockedSearch<arma::mat>();
+}
+
+BOOST_AUTO_TEST_CASE(FloatSearchTest)
+{
+  CheckBlockedSearch<arma::fmat>();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
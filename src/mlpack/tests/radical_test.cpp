@@ -58,4 +58,33 @@ BOOST_AUTO_TEST_CASE(Radical_Test_Radical3D)
   BOOST_REQUIRE_CLOSE(valBest, valEst, 2.0);
 }
 
+/**
+ * The unmixing matrix must map the data to the estimated components, also
+ * with an odd number of dimensions (where every round of the sweep leaves one
+ * dimension out).
+ */
+BOOST_AUTO_TEST_CASE(Radical_Test_UnmixingMatrix)
+{
+  // Mix five independent uniform sources.
+  const mat matS = randu<mat>(5, 500);
+  const mat matA = randn<mat>(5, 5);
+  const mat matX = matA * matS;
+
+  Radical rad(0.175, 5, 50, 2);
+
+  mat matY;
+  mat matW;
+  rad.DoRadical(matX, matY, matW);
+
+  BOOST_REQUIRE_EQUAL(matW.n_rows, (uword) 5);
+  BOOST_REQUIRE_EQUAL(matW.n_cols, (uword) 5);
+  BOOST_REQUIRE_EQUAL(matY.n_rows, (uword) 5);
+  BOOST_REQUIRE_EQUAL(matY.n_cols, (uword) 500);
+
+  // The rows of the whitened and rotated data are uncorrelated, with unit
+  // variance.
+  CheckMatrices(matW * matX, matY, 1e-5);
+  CheckMatrices(cov(trans(matY)), eye<mat>(5, 5), 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
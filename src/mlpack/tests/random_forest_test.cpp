@@ -12,6 +12,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
+#include <mlpack/methods/decision_tree/histogram_numeric_split.hpp>
+#include <mlpack/methods/decision_tree/flat_forest.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -153,6 +155,82 @@ BOOST_AUTO_TEST_CASE(UnweightedNumericLearningTest)
   BOOST_REQUIRE_GE(rfCorrect, size_t(0.7 * testDataset.n_cols));
 }
 
+/**
+ * Make sure bootstrap counts sample as many points as there are in the dataset,
+ * and leave out about a third of them.
+ */
+BOOST_AUTO_TEST_CASE(BootstrapCountsTest)
+{
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::uvec counts;
+    BootstrapCounts(10000, counts);
+
+    BOOST_REQUIRE_EQUAL(counts.n_elem, 10000);
+    BOOST_REQUIRE_EQUAL(arma::accu(counts), 10000);
+
+    // We expect a fraction of 1 - 1 / e (about 0.632) to be sampled.
+    const arma::uvec sampled = arma::find(counts);
+    BOOST_REQUIRE_GT(sampled.n_elem, 6000);
+    BOOST_REQUIRE_LT(sampled.n_elem, 6650);
+  }
+}
+
+/**
+ * Test numeric learning with bootstrap counts, unweighted and weighted.
+ */
+BOOST_AUTO_TEST_CASE(CountBootstrapNumericLearningTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::rowvec weights(labels.n_elem, arma::fill::ones);
+
+  RandomForest<GiniGain, RandomDimensionSelect> rf, wrf;
+  rf.Train(dataset, labels, 3, 10 /* 10 trees */, 5, true);
+  wrf.Train(dataset, labels, 3, weights, 10 /* 10 trees */, 5, true);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  arma::Row<size_t> rfPredictions;
+  rf.Classify(testDataset, rfPredictions);
+  const size_t rfCorrect = arma::accu(rfPredictions == testLabels);
+  BOOST_REQUIRE_GE(rfCorrect, size_t(0.7 * testDataset.n_cols));
+
+  wrf.Classify(testDataset, rfPredictions);
+  const size_t wrfCorrect = arma::accu(rfPredictions == testLabels);
+  BOOST_REQUIRE_GE(wrfCorrect, size_t(0.7 * testDataset.n_cols));
+}
+
+/**
+ * Test unweighted numeric learning with histogram-based numeric splits.
+ */
+BOOST_AUTO_TEST_CASE(HistogramSplitNumericLearningTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<GiniGain, RandomDimensionSelect, HistogramNumericSplit> rf(
+      dataset, labels, 3, 10 /* 10 trees */, 5);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  arma::Row<size_t> rfPredictions;
+  rf.Classify(testDataset, rfPredictions);
+
+  const size_t rfCorrect = arma::accu(rfPredictions == testLabels);
+  BOOST_REQUIRE_GE(rfCorrect, size_t(0.7 * testDataset.n_cols));
+}
+
 /**
  * Test weighted numeric learning, making sure that we get better performance
  * than a single decision tree.
@@ -299,6 +377,34 @@ BOOST_AUTO_TEST_CASE(WeightedCategoricalLearningTest)
   BOOST_REQUIRE_GE(rfCorrect, size_t(0.7 * testData.n_cols));
 }
 
+/**
+ * Make sure that a FlatForest compiled from a random forest gives the same
+ * predictions and probabilities as the forest.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<GiniGain, RandomDimensionSelect> rf(dataset, labels, 3,
+      20 /* 20 trees */, 3);
+  FlatForest flat(rf);
+  BOOST_REQUIRE_EQUAL(flat.NumTrees(), 20);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(testDataset, predictions, probabilities);
+  flat.Classify(testDataset, flatPredictions, flatProbabilities);
+
+  CheckMatrices(predictions, flatPredictions);
+  CheckMatrices(probabilities, flatProbabilities);
+}
+
 /**
  * Test that learning with a leaf size of 1 successfully memorizes the training
  * set.
@@ -395,4 +501,34 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
       binaryProbabilities);
 }
 
+/**
+ * Test that a random forest can be trained on a MixedDataset.
+ */
+BOOST_AUTO_TEST_CASE(MixedDatasetLearningTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+  arma::Row<size_t> testLabels = l.subvec(2000, 3999);
+
+  data::MixedDataset<float, uint8_t> mixed(trainingData, di);
+  RandomForest<> rf(mixed, di, trainingLabels, 5, 15 /* 15 trees */, 5);
+  RandomForest<> countRF;
+  countRF.Train(mixed, di, trainingLabels, 5, 15, 5, true);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testData, predictions);
+  BOOST_REQUIRE_GE(arma::accu(predictions == testLabels),
+      size_t(0.7 * testData.n_cols));
+
+  countRF.Classify(testData, predictions);
+  BOOST_REQUIRE_GE(arma::accu(predictions == testLabels),
+      size_t(0.7 * testData.n_cols));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
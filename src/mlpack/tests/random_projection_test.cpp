@@ -0,0 +1,189 @@
+/**
+ * @file random_projection_test.cpp
+ *
+ * Tests for the sparse random projections of math::RandomProjection.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/math/random_projection.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::math;
+
+BOOST_AUTO_TEST_SUITE(RandomProjectionTest);
+
+/**
+ * Make sure that the projection of dense points is the product with the
+ * projection matrix.
+ */
+BOOST_AUTO_TEST_CASE(DenseTransformMatchesProjectionTest)
+{
+  // More than one block of dimensions.
+  arma::mat data(5000, 20, arma::fill::randn);
+  RandomProjection projection(32, 0.1, 7);
+
+  arma::mat projected;
+  projection.Transform(data, projected);
+
+  arma::sp_mat matrix;
+  projection.Projection(data.n_rows, matrix);
+  const arma::mat expected = matrix * data;
+
+  BOOST_REQUIRE_EQUAL(projected.n_rows, 32);
+  BOOST_REQUIRE_EQUAL(projected.n_cols, 20);
+  for (size_t i = 0; i < projected.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(projected[i] - expected[i], 1e-8);
+}
+
+/**
+ * Make sure that the projection of sparse points is the product with the
+ * projection matrix, and the same as the projection of the dense points.
+ */
+BOOST_AUTO_TEST_CASE(SparseTransformMatchesProjectionTest)
+{
+  arma::sp_mat data;
+  data.sprandu(20000, 30, 0.01);
+  RandomProjection projection(16, 0.0, 11);
+
+  arma::mat projected;
+  projection.Transform(data, projected);
+
+  arma::sp_mat matrix;
+  projection.Projection(data.n_rows, matrix);
+  const arma::mat expected(matrix * data);
+
+  arma::mat denseProjected;
+  projection.Transform(arma::mat(data), denseProjected);
+
+  BOOST_REQUIRE_EQUAL(projected.n_rows, 16);
+  BOOST_REQUIRE_EQUAL(projected.n_cols, 30);
+  for (size_t i = 0; i < projected.n_elem; ++i)
+  {
+    BOOST_REQUIRE_SMALL(projected[i] - expected[i], 1e-8);
+    BOOST_REQUIRE_SMALL(projected[i] - denseProjected[i], 1e-8);
+  }
+}
+
+/**
+ * The projection only depends on the seed.
+ */
+BOOST_AUTO_TEST_CASE(SeedDeterminismTest)
+{
+  arma::mat data(300, 10, arma::fill::randu);
+
+  arma::mat a, b, c;
+  RandomProjection(8, 0.0, 3).Transform(data, a);
+  RandomProjection(8, 0.0, 3).Transform(data, b);
+  RandomProjection(8, 0.0, 4).Transform(data, c);
+
+  BOOST_REQUIRE_EQUAL(arma::accu(a != b), 0);
+  BOOST_REQUIRE_GT(arma::accu(a != c), 0);
+}
+
+/**
+ * With density 1, every element of the projection matrix is +1 / sqrt(k) or
+ * -1 / sqrt(k), and the signs are balanced.
+ */
+BOOST_AUTO_TEST_CASE(FullDensityTest)
+{
+  RandomProjection projection(50, 1.0, 5);
+  arma::sp_mat matrix;
+  projection.Projection(200, matrix);
+
+  BOOST_REQUIRE_EQUAL(matrix.n_nonzero, 50 * 200);
+  const arma::mat dense(matrix);
+  size_t positive = 0;
+  for (size_t i = 0; i < dense.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(std::abs(dense[i]), 1.0 / std::sqrt(50.0), 1e-8);
+    if (dense[i] > 0)
+      ++positive;
+  }
+
+  BOOST_REQUIRE_GT(positive, 4500);
+  BOOST_REQUIRE_LT(positive, 5500);
+}
+
+/**
+ * The number of nonzero elements of the projection matrix follows the density.
+ */
+BOOST_AUTO_TEST_CASE(DensityTest)
+{
+  RandomProjection projection(100, 0.0, 9);
+  arma::sp_mat matrix;
+  projection.Projection(10000, matrix);
+
+  // The density is 1 / sqrt(10000) = 0.01, so 10000 elements are expected
+  // (with a standard deviation of about 100).
+  BOOST_REQUIRE_GT(matrix.n_nonzero, 9400);
+  BOOST_REQUIRE_LT(matrix.n_nonzero, 10600);
+}
+
+/**
+ * Distances are approximately preserved.
+ */
+BOOST_AUTO_TEST_CASE(DistancePreservationTest)
+{
+  arma::sp_mat data;
+  data.sprandn(100000, 20, 0.001);
+  RandomProjection projection(1024, 0.0, 13);
+
+  arma::mat projected;
+  projection.Transform(data, projected);
+
+  const arma::mat dense(data);
+  for (size_t i = 1; i < data.n_cols; ++i)
+  {
+    const double distance = arma::norm(dense.col(i) - dense.col(0));
+    const double projectedDistance =
+        arma::norm(projected.col(i) - projected.col(0));
+    BOOST_REQUIRE_CLOSE(projectedDistance, distance, 20.0);
+  }
+}
+
+/**
+ * Invalid parameters throw.
+ */
+BOOST_AUTO_TEST_CASE(InvalidParametersTest)
+{
+  arma::mat data(10, 5, arma::fill::randu);
+  arma::mat projected;
+
+  BOOST_REQUIRE_THROW(RandomProjection(0).Transform(data, projected),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(RandomProjection(4, 1.5).Transform(data, projected),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(RandomProjection(4, -0.5).Transform(data, projected),
+      std::invalid_argument);
+}
+
+/**
+ * A serialized projection projects the points in the same way.
+ */
+BOOST_AUTO_TEST_CASE(SerializationTest)
+{
+  arma::mat data(100, 10, arma::fill::randu);
+  RandomProjection projection(8, 0.2, 17);
+  RandomProjection xmlProjection, textProjection, binaryProjection;
+
+  SerializeObjectAll(projection, xmlProjection, textProjection,
+      binaryProjection);
+
+  arma::mat projected, xmlProjected, textProjected, binaryProjected;
+  projection.Transform(data, projected);
+  xmlProjection.Transform(data, xmlProjected);
+  textProjection.Transform(data, textProjected);
+  binaryProjection.Transform(data, binaryProjected);
+
+  CheckMatrices(projected, xmlProjected, textProjected, binaryProjected);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -97,4 +97,67 @@ BOOST_AUTO_TEST_CASE(WeightedRandomTest)
   }
 }
 
+// Test the Philox generator against the known-answer vectors of Random123.
+BOOST_AUTO_TEST_CASE(PhiloxKnownAnswerTest)
+{
+  uint32_t block[4];
+  Philox(0, 0).Block(0, block);
+  BOOST_REQUIRE_EQUAL(block[0], 0x6627e8d5u);
+  BOOST_REQUIRE_EQUAL(block[1], 0xe169c58du);
+  BOOST_REQUIRE_EQUAL(block[2], 0xbc57ac4cu);
+  BOOST_REQUIRE_EQUAL(block[3], 0x9b00dbd8u);
+
+  Philox(0x299f31d0a4093822ull, 0x0370734413198a2eull).Block(
+      0x85a308d3243f6a88ull, block);
+  BOOST_REQUIRE_EQUAL(block[0], 0xd16cfe09u);
+  BOOST_REQUIRE_EQUAL(block[1], 0x94fdccebu);
+  BOOST_REQUIRE_EQUAL(block[2], 0x5001e420u);
+  BOOST_REQUIRE_EQUAL(block[3], 0x24126ea1u);
+}
+
+// Make sure the fill functions give the right distributions, and that the
+// streams are reproducible and differ from each other.
+BOOST_AUTO_TEST_CASE(PhiloxFillTest)
+{
+  Philox generator(42);
+  arma::vec uniform(100001);
+  generator.FillUniform(uniform.memptr(), uniform.n_elem);
+  BOOST_REQUIRE_GE(uniform.min(), 0.0);
+  BOOST_REQUIRE_LT(uniform.max(), 1.0);
+  BOOST_REQUIRE_SMALL(arma::mean(uniform) - 0.5, 0.01);
+
+  arma::fvec uniformFloat(1001);
+  generator.FillUniform(uniformFloat.memptr(), uniformFloat.n_elem);
+  BOOST_REQUIRE_LT(uniformFloat.max(), 1.0f);
+
+  arma::vec normal(100001);
+  generator.FillNormal(normal.memptr(), normal.n_elem, 1.0, 2.0);
+  BOOST_REQUIRE_SMALL(arma::mean(normal) - 1.0, 0.05);
+  BOOST_REQUIRE_SMALL(arma::stddev(normal) - 2.0, 0.05);
+
+  // Another stream of the same seed is a different sequence.
+  Philox other(42, 1);
+  arma::vec otherUniform(100001);
+  other.FillUniform(otherUniform.memptr(), otherUniform.n_elem);
+  BOOST_REQUIRE_GT(arma::norm(uniform - otherUniform), 1.0);
+
+  // The same stream of the same seed is the same sequence, however it is
+  // drawn.
+  Philox first(7, 3), second(7, 3);
+  arma::mat firstUniform(10, 10), secondUniform(10, 10);
+  first.FillUniform(firstUniform.memptr(), firstUniform.n_elem);
+  for (size_t i = 0; i < secondUniform.n_elem; i += 2)
+    second.FillUniform(secondUniform.memptr() + i, 2);
+  CheckMatrices(firstUniform, secondUniform);
+
+  RandUniform(firstUniform);
+  BOOST_REQUIRE_LT(firstUniform.max(), 1.0);
+
+  const arma::uvec ordering = RandPermutation(100);
+  BOOST_REQUIRE_EQUAL(ordering.n_elem, 100);
+  BOOST_REQUIRE_EQUAL(arma::accu(arma::sort(ordering) !=
+      arma::linspace<arma::uvec>(0, 99, 100)), 0);
+  BOOST_REQUIRE_LT(RandIntegers(1000, 3).max(), 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
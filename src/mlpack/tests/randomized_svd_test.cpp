@@ -64,4 +64,113 @@ BOOST_AUTO_TEST_CASE(RandomizedSVDReconstructionError)
   BOOST_REQUIRE_SMALL(error, 1e-5);
 }
 
+/**
+ * The randomized SVD of sparse data should be the same as the randomized SVD of
+ * the same data in a dense matrix.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDSparseTest)
+{
+  arma::sp_mat data;
+  data.sprandu(20, 300, 0.2);
+  const arma::mat denseData(data);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  math::RandomSeed(10);
+  svd::RandomizedSVD rSVD(0, 5);
+  rSVD.Apply(denseData, U1, s1, V1, 5);
+
+  math::RandomSeed(10);
+  svd::RandomizedSVD sparseSVD(0, 5);
+  sparseSVD.Apply(data, U2, s2, V2, 5);
+
+  BOOST_REQUIRE_EQUAL(s1.n_elem, s2.n_elem);
+  for (size_t i = 0; i < s1.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(s1[i], s2[i], 1e-5);
+
+  CheckMatrices(U1 * arma::diagmat(s1) * V1.t(),
+      U2 * arma::diagmat(s2) * V2.t(), 1e-5);
+}
+
+/**
+ * A source of blocks of columns of a matrix held in memory.
+ */
+template<typename BlockMatType>
+class TestBlockSource
+{
+ public:
+  typedef BlockMatType MatType;
+
+  TestBlockSource(const BlockMatType& data, const size_t blockSize) :
+      data(data), blockSize(blockSize), reads(0) { }
+
+  size_t Rows() const { return data.n_rows; }
+
+  size_t NumBlocks() const
+  {
+    return (data.n_cols + blockSize - 1) / blockSize;
+  }
+
+  void Block(const size_t index, BlockMatType& block)
+  {
+    const size_t end = std::min((index + 1) * blockSize,
+        (size_t) data.n_cols);
+    block = data.cols(index * blockSize, end - 1);
+    ++reads;
+  }
+
+  //! The number of blocks that were read.
+  size_t Reads() const { return reads; }
+
+ private:
+  const BlockMatType& data;
+  size_t blockSize;
+  size_t reads;
+};
+
+/**
+ * The singular values computed from blocks of columns, on dense and sparse
+ * data, should be the singular values of the centered data, and the data
+ * should be read once for the sketch and once for each power iteration.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDBlocksTest)
+{
+  arma::sp_mat data;
+  data.sprandu(15, 1000, 0.1);
+  const arma::mat denseData(data);
+
+  arma::mat centeredData;
+  math::Center(denseData, centeredData);
+
+  arma::mat U, V;
+  arma::vec s;
+  arma::svd_econ(U, s, V, centeredData);
+
+  // The sketch spans every dimension, so the results are exact.
+  TestBlockSource<arma::mat> denseSource(denseData, 128);
+  TestBlockSource<arma::sp_mat> sparseSource(data, 128);
+
+  arma::mat U1, U2;
+  arma::vec s1, s2;
+  svd::RandomizedSVD rSVD(0, 2);
+  rSVD.ApplyBlocks(denseSource, U1, s1, 15);
+  rSVD.ApplyBlocks(sparseSource, U2, s2, 15);
+
+  BOOST_REQUIRE_EQUAL(denseSource.Reads(), 3 * denseSource.NumBlocks());
+  BOOST_REQUIRE_EQUAL(sparseSource.Reads(), 3 * sparseSource.NumBlocks());
+
+  BOOST_REQUIRE_EQUAL(s1.n_elem, 15);
+  BOOST_REQUIRE_EQUAL(s2.n_elem, 15);
+  for (size_t i = 0; i < 15; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(s1[i], s[i], 1e-4);
+    BOOST_REQUIRE_CLOSE(s2[i], s[i], 1e-4);
+  }
+
+  // The singular vectors should be the same, up to their sign.
+  CheckMatrices(arma::abs(U1.t() * U), arma::eye<arma::mat>(15, 15), 1e-4);
+  CheckMatrices(arma::abs(U2.t() * U), arma::eye<arma::mat>(15, 15), 1e-4);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
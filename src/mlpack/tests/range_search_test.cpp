@@ -1334,6 +1334,139 @@ BOOST_AUTO_TEST_CASE(RSModelTest)
   }
 }
 
+/**
+ * Make sure that an RSModel built on a single precision reference set finds
+ * the same points as a double precision search.
+ */
+BOOST_AUTO_TEST_CASE(RSModelSinglePrecisionTest)
+{
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+
+  RangeSearch<> rs(referenceData);
+  vector<vector<size_t>> baselineNeighbors;
+  vector<vector<double>> baselineDistances;
+  rs.Search(queryData, math::Range(0.25, 0.75), baselineNeighbors,
+      baselineDistances);
+
+  vector<vector<pair<double, size_t>>> baselineSorted;
+  SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+
+  const RSModel::TreeTypes treeTypes[] = { RSModel::KD_TREE,
+      RSModel::COVER_TREE, RSModel::R_TREE, RSModel::BALL_TREE,
+      RSModel::OCTREE };
+
+  for (const RSModel::TreeTypes treeType : treeTypes)
+  {
+    RSModel model(treeType);
+    arma::fmat referenceCopy = arma::conv_to<arma::fmat>::from(referenceData);
+    model.BuildModel(std::move(referenceCopy), 5, false, false);
+
+    BOOST_REQUIRE(model.SinglePrecision());
+    BOOST_REQUIRE_EQUAL(model.NumPoints(), referenceData.n_cols);
+
+    arma::mat queryCopy(queryData);
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    model.Search(std::move(queryCopy), math::Range(0.25, 0.75), neighbors,
+        distances);
+
+    BOOST_REQUIRE_EQUAL(neighbors.size(), baselineNeighbors.size());
+
+    vector<vector<pair<double, size_t>>> sorted;
+    SortResults(neighbors, distances, sorted);
+
+    // Points very close to the edges of the range may be classified
+    // differently in single precision, so only the points that are clearly
+    // inside the range must be found.
+    for (size_t k = 0; k < sorted.size(); ++k)
+    {
+      for (size_t m = 0; m < baselineSorted[k].size(); ++m)
+      {
+        const double distance = baselineSorted[k][m].first;
+        if (distance < 0.2501 || distance > 0.7499)
+          continue;
+
+        size_t l = 0;
+        while (l < sorted[k].size() &&
+            sorted[k][l].second != baselineSorted[k][m].second)
+          ++l;
+        BOOST_REQUIRE_LT(l, sorted[k].size());
+        BOOST_REQUIRE_CLOSE(sorted[k][l].first, distance, 1e-3);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that searching a query set given to SetQuerySet() for several
+ * ranges gives the same results as Search(), with and without kept results.
+ */
+BOOST_AUTO_TEST_CASE(RSModelQuerySetTest)
+{
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+
+  const RSModel::TreeTypes treeTypes[] = { RSModel::KD_TREE,
+      RSModel::COVER_TREE, RSModel::R_TREE, RSModel::BALL_TREE,
+      RSModel::OCTREE };
+
+  for (const RSModel::TreeTypes treeType : treeTypes)
+  {
+    for (size_t singleMode = 0; singleMode < 2; ++singleMode)
+    {
+      for (size_t cache = 0; cache < 2; ++cache)
+      {
+        RSModel model(treeType);
+        arma::mat referenceCopy(referenceData);
+        model.BuildModel(std::move(referenceCopy), 5, false, singleMode == 1);
+
+        arma::mat queryCopy(queryData);
+        model.SetQuerySet(std::move(queryCopy), cache == 1);
+        BOOST_REQUIRE(model.HasQuerySet());
+
+        // The widest range comes first, so that the others can use the kept
+        // results; the last range is searched again.
+        const math::Range ranges[] = { math::Range(0.0, 1.0),
+            math::Range(0.25, 0.75), math::Range(0.5, 0.6),
+            math::Range(0.8, 1.2), math::Range(0.8, 1.2) };
+        for (const math::Range& range : ranges)
+        {
+          vector<vector<size_t>> baselineNeighbors;
+          vector<vector<double>> baselineDistances;
+          arma::mat baselineQuery(queryData);
+          model.Search(std::move(baselineQuery), range, baselineNeighbors,
+              baselineDistances);
+          vector<vector<pair<double, size_t>>> baselineSorted;
+          SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+
+          vector<vector<size_t>> neighbors;
+          vector<vector<double>> distances;
+          model.SearchQuerySet(range, neighbors, distances);
+          vector<vector<pair<double, size_t>>> sorted;
+          SortResults(neighbors, distances, sorted);
+
+          BOOST_REQUIRE_EQUAL(sorted.size(), baselineSorted.size());
+          for (size_t k = 0; k < sorted.size(); ++k)
+          {
+            BOOST_REQUIRE_EQUAL(sorted[k].size(), baselineSorted[k].size());
+            for (size_t l = 0; l < sorted[k].size(); ++l)
+            {
+              BOOST_REQUIRE_EQUAL(sorted[k][l].second,
+                  baselineSorted[k][l].second);
+              BOOST_REQUIRE_CLOSE(sorted[k][l].first,
+                  baselineSorted[k][l].first, 1e-5);
+            }
+          }
+        }
+
+        model.ClearQuerySet();
+        BOOST_REQUIRE(!model.HasQuerySet());
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(RSModelMonochromaticTest)
 {
   // Ensure that we can build an RSModel and get correct results.
@@ -1696,4 +1829,242 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+/**
+ * Make sure that the naive and single-tree searches find the same results as
+ * the dual-tree search when the queries are split across several threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeSearchTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+  #endif
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 600);
+  arma::mat queryData = arma::randu<arma::mat>(3, 400);
+
+  RangeSearch<> dualTree(referenceData);
+  RangeSearch<> naive(referenceData, true);
+  RangeSearch<> singleTree(referenceData, false, true);
+
+  vector<vector<size_t>> dualNeighbors, naiveNeighbors, singleNeighbors;
+  vector<vector<double>> dualDistances, naiveDistances, singleDistances;
+  vector<vector<pair<double, size_t>>> dualSorted, naiveSorted, singleSorted;
+
+  // Search with a separate query set, and then the monochromatic search.
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    if (trial == 0)
+    {
+      dualTree.Search(queryData, Range(0.1, 0.3), dualNeighbors,
+          dualDistances);
+      naive.Search(queryData, Range(0.1, 0.3), naiveNeighbors, naiveDistances);
+      singleTree.Search(queryData, Range(0.1, 0.3), singleNeighbors,
+          singleDistances);
+    }
+    else
+    {
+      dualTree.Search(Range(0.1, 0.3), dualNeighbors, dualDistances);
+      naive.Search(Range(0.1, 0.3), naiveNeighbors, naiveDistances);
+      singleTree.Search(Range(0.1, 0.3), singleNeighbors, singleDistances);
+    }
+
+    SortResults(dualNeighbors, dualDistances, dualSorted);
+    SortResults(naiveNeighbors, naiveDistances, naiveSorted);
+    SortResults(singleNeighbors, singleDistances, singleSorted);
+
+    BOOST_REQUIRE_EQUAL(naiveSorted.size(), dualSorted.size());
+    BOOST_REQUIRE_EQUAL(singleSorted.size(), dualSorted.size());
+    for (size_t i = 0; i < dualSorted.size(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(naiveSorted[i].size(), dualSorted[i].size());
+      BOOST_REQUIRE_EQUAL(singleSorted[i].size(), dualSorted[i].size());
+      for (size_t j = 0; j < dualSorted[i].size(); ++j)
+      {
+        BOOST_REQUIRE_EQUAL(naiveSorted[i][j].second, dualSorted[i][j].second);
+        BOOST_REQUIRE_EQUAL(singleSorted[i][j].second,
+            dualSorted[i][j].second);
+      }
+    }
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+}
+
+/**
+ * Make sure that the dual-tree search with large leaves, where all base cases
+ * between two leaves are computed at once, finds the same results as the naive
+ * search, also for duplicated points at distance zero.
+ */
+BOOST_AUTO_TEST_CASE(LeafBaseCaseSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(20, 400);
+  referenceData.cols(300, 399) = referenceData.cols(0, 99);
+  arma::mat queryData = referenceData.cols(50, 249);
+
+  RangeSearch<> naive(referenceData, true);
+  RangeSearch<>::Tree tree(referenceData, 40);
+  RangeSearch<> dualTree(&tree);
+
+  vector<vector<size_t>> dualNeighbors, naiveNeighbors;
+  vector<vector<double>> dualDistances, naiveDistances;
+  vector<vector<pair<double, size_t>>> dualSorted, naiveSorted;
+
+  naive.Search(queryData, Range(0.0, 1.2), naiveNeighbors, naiveDistances);
+  dualTree.Search(queryData, Range(0.0, 1.2), dualNeighbors, dualDistances);
+
+  // The reference indices of the dual-tree search refer to the rearranged
+  // dataset of the tree, so only the distances are compared.
+  SortResults(dualNeighbors, dualDistances, dualSorted);
+  SortResults(naiveNeighbors, naiveDistances, naiveSorted);
+
+  BOOST_REQUIRE_EQUAL(naiveSorted.size(), dualSorted.size());
+  for (size_t i = 0; i < dualSorted.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(naiveSorted[i].size(), dualSorted[i].size());
+    for (size_t j = 0; j < dualSorted[i].size(); ++j)
+    {
+      if (naiveSorted[i][j].first < 1e-10)
+        BOOST_REQUIRE_SMALL(dualSorted[i][j].first, 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(naiveSorted[i][j].first, dualSorted[i][j].first,
+            1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure the compact results hold the same results as the vectors.
+ */
+void CheckCompactResults(const CompactRangeResults& compact,
+                         const vector<vector<size_t>>& neighbors,
+                         const vector<vector<double>>& distances)
+{
+  BOOST_REQUIRE_EQUAL(compact.NumQueries(), neighbors.size());
+  BOOST_REQUIRE_EQUAL(compact.Offsets().n_elem, neighbors.size() + 1);
+  BOOST_REQUIRE_EQUAL(compact.Neighbors().n_elem, compact.Offsets().back());
+  BOOST_REQUIRE_EQUAL(compact.Distances().n_elem, compact.Offsets().back());
+
+  vector<vector<size_t>> compactNeighbors(compact.NumQueries());
+  vector<vector<double>> compactDistances(compact.NumQueries());
+  for (size_t i = 0; i < compact.NumQueries(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(compact.NumNeighbors(i), neighbors[i].size());
+    for (size_t j = compact.Offsets()[i]; j < compact.Offsets()[i + 1]; ++j)
+    {
+      compactNeighbors[i].push_back(compact.Neighbors()[j]);
+      compactDistances[i].push_back(compact.Distances()[j]);
+    }
+  }
+
+  vector<vector<pair<double, size_t>>> sorted, compactSorted;
+  SortResults(neighbors, distances, sorted);
+  SortResults(compactNeighbors, compactDistances, compactSorted);
+  for (size_t i = 0; i < sorted.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(compactSorted[i].size(), sorted[i].size());
+    for (size_t j = 0; j < sorted[i].size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(compactSorted[i][j].second, sorted[i][j].second);
+      BOOST_REQUIRE_CLOSE(compactSorted[i][j].first, sorted[i][j].first,
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure the compact results are the same as the vector results, in every
+ * search mode, with and without a query set.
+ */
+BOOST_AUTO_TEST_CASE(CompactResultsTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 300);
+  const Range range(0.1, 0.3);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceData, mode == 0, mode == 1);
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    CompactRangeResults compact;
+
+    rs.Search(queryData, range, neighbors, distances);
+    rs.Search(queryData, range, compact);
+    CheckCompactResults(compact, neighbors, distances);
+
+    rs.Search(range, neighbors, distances);
+    rs.Search(range, compact);
+    CheckCompactResults(compact, neighbors, distances);
+  }
+}
+
+/**
+ * A callback that counts the results of each query point and keeps the
+ * largest distance.
+ */
+struct CountingCallback
+{
+  CountingCallback(const size_t numQueries) :
+      counts(numQueries, arma::fill::zeros),
+      maxDistances(numQueries, arma::fill::zeros)
+  { }
+
+  void operator()(const size_t queryIndex,
+                  const size_t /* referenceIndex */,
+                  const double distance)
+  {
+    ++counts[queryIndex];
+    maxDistances[queryIndex] = std::max(maxDistances[queryIndex], distance);
+  }
+
+  arma::Col<size_t> counts;
+  arma::vec maxDistances;
+};
+
+/**
+ * Make sure the callback and the counts see every result, in every search
+ * mode, also when whole nodes are in the range.
+ */
+BOOST_AUTO_TEST_CASE(CallbackAndCountResultsTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 300);
+  const Range range(0.0, 0.8);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceData, mode == 0, mode == 1);
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    rs.Search(queryData, range, neighbors, distances);
+
+    CountingCallback callback(queryData.n_cols);
+    CallbackRangeResults<CountingCallback> callbackResults(callback);
+    rs.Search(queryData, range, callbackResults);
+
+    CountRangeResults counts;
+    rs.Search(queryData, range, counts);
+    BOOST_REQUIRE_EQUAL(counts.Counts().n_elem, queryData.n_cols);
+
+    for (size_t i = 0; i < queryData.n_cols; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(callback.counts[i], neighbors[i].size());
+      BOOST_REQUIRE_EQUAL(counts.Counts()[i], neighbors[i].size());
+      BOOST_REQUIRE_LE(callback.maxDistances[i], 0.8);
+    }
+
+    // Now without a query set.
+    rs.Search(range, neighbors, distances);
+    rs.Search(range, counts);
+    BOOST_REQUIRE_EQUAL(counts.Counts().n_elem, referenceData.n_cols);
+    for (size_t i = 0; i < referenceData.n_cols; ++i)
+      BOOST_REQUIRE_EQUAL(counts.Counts()[i], neighbors[i].size());
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1384,4 +1384,143 @@ BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Check the structure of a bulk-loaded tree: the bounds must be exact, the
+ * fills legal, and all the leaves on the same level.
+ */
+template<typename TreeType>
+void CheckBulkLoadedTree(const TreeType& tree, const size_t numPoints)
+{
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), numPoints);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckFills(tree);
+  CheckNumDescendants(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+}
+
+/**
+ * Bulk load a tree with the given packing policy, check it, insert more points
+ * into it, check it again, and then compare its nearest neighbors with a naive
+ * search.
+ */
+template<template<typename, typename, typename> class TreeType,
+         typename PackingType>
+void CheckBulkLoad()
+{
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  Tree tree(dataset, PackingType(), 20, 6, 5, 2);
+
+  // The dataset is not modified, and the tree is as short as possible.
+  CheckMatrices(tree.Dataset(), dataset);
+  CheckBulkLoadedTree(tree, 1000);
+  BOOST_REQUIRE_EQUAL(GetMaxLevel(tree), 4);
+
+  // The tree must stay valid when points are inserted.
+  tree.Dataset().reshape(5, 1100);
+  dataset.reshape(5, 1100);
+  dataset.cols(1000, 1099).randu();
+  tree.Dataset().cols(1000, 1099) = dataset.cols(1000, 1099);
+  for (size_t i = 1000; i < 1100; ++i)
+    tree.InsertPoint(i);
+
+  CheckBulkLoadedTree(tree, 1100);
+
+  arma::Mat<size_t> neighbors1, neighbors2;
+  arma::mat distances1, distances2;
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      knn1(std::move(tree), SINGLE_TREE_MODE);
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  CheckMatrices(neighbors1, neighbors2);
+  CheckMatrices(distances1, distances2);
+}
+
+/**
+ * Bulk load the R tree with both packing policies.
+ */
+BOOST_AUTO_TEST_CASE(RTreeBulkLoadTest)
+{
+  CheckBulkLoad<RTree, STRPacking>();
+  CheckBulkLoad<RTree, HilbertPacking>();
+}
+
+/**
+ * Bulk load the R* tree with both packing policies.
+ */
+BOOST_AUTO_TEST_CASE(RStarTreeBulkLoadTest)
+{
+  CheckBulkLoad<RStarTree, STRPacking>();
+  CheckBulkLoad<RStarTree, HilbertPacking>();
+}
+
+/**
+ * Bulk load the X tree with both packing policies.
+ */
+BOOST_AUTO_TEST_CASE(XTreeBulkLoadTest)
+{
+  CheckBulkLoad<XTree, STRPacking>();
+  CheckBulkLoad<XTree, HilbertPacking>();
+}
+
+/**
+ * Bulk load the Hilbert R tree with both packing policies.
+ */
+BOOST_AUTO_TEST_CASE(HilbertRTreeBulkLoadTest)
+{
+  CheckBulkLoad<HilbertRTree, STRPacking>();
+  CheckBulkLoad<HilbertRTree, HilbertPacking>();
+}
+
+/**
+ * The Hilbert values of a bulk-loaded Hilbert R tree must be ordered and in
+ * sync, before and after more points are inserted.
+ */
+BOOST_AUTO_TEST_CASE(HilbertRTreeBulkLoadOrderingTest)
+{
+  typedef HilbertRTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> TreeType;
+
+  arma::mat dataset = arma::randu<arma::mat>(8, 1000);
+  TreeType tree(dataset, HilbertPacking(), 20, 6, 5, 2);
+
+  CheckHilbertOrdering(tree);
+  CheckDiscreteHilbertValueSync(tree);
+  CheckHilbertValue(tree);
+
+  tree.Dataset().reshape(8, 1200);
+  tree.Dataset().cols(1000, 1199).randu();
+  for (size_t i = 1000; i < 1200; ++i)
+    tree.InsertPoint(i);
+
+  CheckBulkLoadedTree(tree, 1200);
+  CheckHilbertOrdering(tree);
+  CheckDiscreteHilbertValueSync(tree);
+  CheckHilbertValue(tree);
+}
+
+/**
+ * A dataset that fits in one leaf gives a single node.
+ */
+BOOST_AUTO_TEST_CASE(RectangleTreeBulkLoadSmallTest)
+{
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 15);
+  TreeType tree(dataset, STRPacking(), 20, 6, 5, 2);
+
+  BOOST_REQUIRE(tree.IsLeaf());
+  BOOST_REQUIRE_EQUAL(tree.Count(), 15);
+  CheckBulkLoadedTree(tree, 15);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -879,6 +879,266 @@ BOOST_AUTO_TEST_CASE(GRUBatchSizeTest)
   BatchSizeTest<GRU<>>();
 }
 
+/**
+ * Make sure that truncated BPTT carries the state of the recurrent layer over
+ * the window boundaries, by comparing against a network that processes the
+ * whole sequence at once.
+ */
+template<typename RecurrentLayerType>
+void TruncatedBPTTTest()
+{
+  const size_t steps = 12;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, steps, 3);
+  arma::cube labels = arma::randu<arma::cube>(1, input.n_cols, steps);
+
+  // The first network backpropagates through the whole sequence, the second
+  // one uses windows of 5, 5 and 2 time steps.
+  RNN<MeanSquaredError<> > model(input, labels, steps);
+  model.Add<Linear<> >(1, 5);
+  model.Add<SigmoidLayer<> >();
+  model.Add<RecurrentLayerType>(5, 5);
+  model.Add<Linear<> >(5, 1);
+
+  RNN<MeanSquaredError<> > truncatedModel(input, labels, 5);
+  truncatedModel.Add<Linear<> >(1, 5);
+  truncatedModel.Add<SigmoidLayer<> >();
+  truncatedModel.Add<RecurrentLayerType>(5, 5);
+  truncatedModel.Add<Linear<> >(5, 1);
+  truncatedModel.TruncatedBPTT() = true;
+
+  model.ResetParameters();
+  truncatedModel.ResetParameters();
+  truncatedModel.Parameters() = model.Parameters();
+
+  const double objective = model.Evaluate(model.Parameters(), 0,
+      input.n_cols);
+  const double truncatedObjective = truncatedModel.Evaluate(
+      truncatedModel.Parameters(), 0, input.n_cols);
+  BOOST_REQUIRE_CLOSE(objective, truncatedObjective, 1e-5);
+
+  arma::cube prediction, truncatedPrediction;
+  model.Predict(input, prediction);
+  truncatedModel.Predict(input, truncatedPrediction);
+
+  BOOST_REQUIRE_EQUAL(truncatedPrediction.n_slices, steps);
+  CheckMatrices(prediction, truncatedPrediction, 1e-5);
+
+  // If a single window covers the whole sequence, truncated BPTT is BPTT.
+  truncatedModel.Rho() = steps;
+
+  arma::mat gradient, truncatedGradient;
+  model.Gradient(model.Parameters(), 0, gradient, input.n_cols);
+  truncatedModel.Gradient(truncatedModel.Parameters(), 0, truncatedGradient,
+      input.n_cols);
+
+  CheckMatrices(gradient, truncatedGradient, 1e-5);
+}
+
+/**
+ * Ensure LSTMs carry their state with truncated BPTT.
+ */
+BOOST_AUTO_TEST_CASE(LSTMTruncatedBPTTTest)
+{
+  TruncatedBPTTTest<LSTM<> >();
+}
+
+/**
+ * Ensure fast LSTMs carry their state with truncated BPTT.
+ */
+BOOST_AUTO_TEST_CASE(FastLSTMTruncatedBPTTTest)
+{
+  TruncatedBPTTTest<FastLSTM<> >();
+}
+
+/**
+ * Make sure that processing all time steps of the sequence at once in
+ * RNN::Gradient() gives the gradient of the step-wise pass, for a full batch,
+ * a partial batch and the single output mode, and that training through the
+ * fused pass gives the parameters of step-wise training.
+ */
+template<typename RecurrentLayerType>
+void SequenceGradientTest()
+{
+  const size_t rho = 7;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, rho, 3);
+  arma::cube labels = arma::randu<arma::cube>(2, input.n_cols, rho);
+
+  for (size_t single = 0; single < 2; ++single)
+  {
+    RNN<MeanSquaredError<> > model(input, labels, rho, single == 1);
+    model.Add<IdentityLayer<> >();
+    model.Add<Linear<> >(1, 6);
+    model.Add<TanHLayer<> >();
+    model.Add<RecurrentLayerType>(6, 5);
+    model.Add<Linear<> >(5, 2);
+    model.Add<SigmoidLayer<> >();
+
+    RNN<MeanSquaredError<> > stepModel(input, labels, rho, single == 1);
+    stepModel.Add<IdentityLayer<> >();
+    stepModel.Add<Linear<> >(1, 6);
+    stepModel.Add<TanHLayer<> >();
+    stepModel.Add<RecurrentLayerType>(6, 5);
+    stepModel.Add<Linear<> >(5, 2);
+    stepModel.Add<SigmoidLayer<> >();
+    stepModel.FusedSequences() = false;
+
+    model.ResetParameters();
+    stepModel.ResetParameters();
+    stepModel.Parameters() = model.Parameters();
+
+    const size_t batchSizes[] = { input.n_cols, 4 };
+    for (const size_t batchSize : batchSizes)
+    {
+      const size_t begin = input.n_cols - batchSize;
+      arma::mat gradient, stepGradient;
+      model.Gradient(model.Parameters(), begin, gradient, batchSize);
+      stepModel.Gradient(stepModel.Parameters(), begin, stepGradient,
+          batchSize);
+
+      BOOST_REQUIRE_GT(arma::norm(gradient), 0.0);
+      CheckMatrices(gradient, stepGradient, 1e-5);
+    }
+
+    // Both models must still predict the same after the fused pass.
+    arma::cube prediction, stepPrediction;
+    model.Predict(input, prediction);
+    stepModel.Predict(input, stepPrediction);
+    CheckMatrices(prediction, stepPrediction, 1e-5);
+
+    const double objective = model.Evaluate(model.Parameters(), 0,
+        input.n_cols);
+
+    StandardSGD opt(0.1, 2, 10 * input.n_cols, -100, false);
+    model.Train(input, labels, opt);
+    stepModel.Train(input, labels, opt);
+
+    CheckMatrices(model.Parameters(), stepModel.Parameters(), 1e-3);
+    BOOST_REQUIRE_LT(model.Evaluate(model.Parameters(), 0, input.n_cols),
+        objective);
+  }
+}
+
+/**
+ * Ensure the fused LSTM sequence pass gives the step-wise gradient.
+ */
+BOOST_AUTO_TEST_CASE(LSTMSequenceGradientTest)
+{
+  SequenceGradientTest<LSTM<> >();
+}
+
+/**
+ * Ensure the fused FastLSTM sequence pass gives the step-wise gradient.
+ */
+BOOST_AUTO_TEST_CASE(FastLSTMSequenceGradientTest)
+{
+  SequenceGradientTest<FastLSTM<> >();
+}
+
+/**
+ * Step the given model through the input sequences one time step at a time
+ * with RNN::Step() and make sure the outputs are those of Predict().  On every
+ * other step the sequences are split into two batches, to check that the
+ * states of the sequences can be regrouped between the steps.
+ */
+template<typename ModelType>
+void CheckStep(ModelType& model, const arma::cube& input)
+{
+  arma::cube prediction;
+  model.Predict(input, prediction);
+
+  const size_t half = input.n_cols / 2;
+  arma::mat state, output;
+  for (size_t t = 0; t < input.n_slices; ++t)
+  {
+    if (t % 2 == 0)
+    {
+      model.Step(input.slice(t), state, output);
+    }
+    else
+    {
+      arma::mat firstState = state.cols(0, half - 1);
+      arma::mat secondState = state.cols(half, input.n_cols - 1);
+      arma::mat firstOutput, secondOutput;
+      model.Step(input.slice(t).cols(0, half - 1), firstState, firstOutput);
+      model.Step(input.slice(t).cols(half, input.n_cols - 1), secondState,
+          secondOutput);
+
+      state = arma::join_rows(firstState, secondState);
+      output = arma::join_rows(firstOutput, secondOutput);
+    }
+
+    BOOST_REQUIRE_EQUAL(state.n_cols, input.n_cols);
+    CheckMatrices(output, prediction.slice(t), 1e-5);
+  }
+}
+
+/**
+ * Make sure that stepping the sequences of an RNN with LSTM, FastLSTM, GRU or
+ * Recurrent layers one time step at a time gives the predictions of the whole
+ * sequences.
+ */
+template<typename RecurrentLayerType>
+void StepTest()
+{
+  const size_t steps = 8;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, steps, 4);
+
+  RNN<MeanSquaredError<> > model(steps);
+  model.Add<Linear<> >(1, 5);
+  model.Add<SigmoidLayer<> >();
+  model.Add<RecurrentLayerType>(5, 5, steps);
+  model.Add<Linear<> >(5, 1);
+
+  CheckStep(model, input);
+}
+
+BOOST_AUTO_TEST_CASE(LSTMStepTest)
+{
+  StepTest<LSTM<> >();
+}
+
+BOOST_AUTO_TEST_CASE(FastLSTMStepTest)
+{
+  StepTest<FastLSTM<> >();
+}
+
+BOOST_AUTO_TEST_CASE(GRUStepTest)
+{
+  StepTest<GRU<> >();
+}
+
+BOOST_AUTO_TEST_CASE(RecurrentStepTest)
+{
+  const size_t steps = 8;
+
+  arma::cube input;
+  arma::mat labelsTemp;
+  GenerateNoisySines(input, labelsTemp, steps, 4);
+
+  Add<> add(4);
+  Linear<> lookup(1, 4);
+  SigmoidLayer<> sigmoidLayer;
+  Linear<> linear(4, 4);
+  Recurrent<>* recurrent = new Recurrent<>(add, lookup, linear,
+      sigmoidLayer, steps);
+
+  RNN<MeanSquaredError<> > model(steps);
+  model.Add<IdentityLayer<> >();
+  model.Add(recurrent);
+  model.Add<Linear<> >(4, 1);
+
+  CheckStep(model, input);
+}
+
 /**
  * Make sure the RNN can be properly serialized.
  */
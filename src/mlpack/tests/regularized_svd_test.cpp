@@ -13,6 +13,7 @@
 #include <mlpack/methods/regularized_svd/regularized_svd.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/parallel_sgd.hpp>
 #include <mlpack/core/optimizers/parallel_sgd/decay_policies/constant_step.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/decay_policies/exponential_backoff.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -197,6 +198,61 @@ BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionGradient)
   }
 }
 
+/**
+ * The sparse batch gradient should match the dense batch gradient, and the full
+ * gradient should not depend on the number of threads.
+ */
+BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionSparseGradient)
+{
+  const size_t numUsers = 30;
+  const size_t numItems = 40;
+  const size_t numRatings = 200;
+  const size_t rank = 5;
+
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+  data.row(2) = floor(data.row(2) * 5 + 0.5);
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, 0.1);
+
+  // Batches that contain repeated users and items.
+  for (size_t start = 0; start < numRatings; start += 50)
+  {
+    arma::mat denseGradient;
+    arma::sp_mat sparseGradient;
+    rSVDFunc.Gradient(parameters, start, denseGradient, 50);
+    rSVDFunc.Gradient(parameters, start, sparseGradient, 50);
+    CheckMatrices(denseGradient, arma::mat(sparseGradient));
+  }
+
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+  #endif
+
+  arma::mat gradients[2];
+  for (size_t run = 0; run < 2; ++run)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(run == 0 ? 1 : 4);
+    #endif
+    rSVDFunc.Gradient(parameters, gradients[run]);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  // The full gradient is the sum of the gradients of all the examples.
+  arma::mat batchGradient;
+  rSVDFunc.Gradient(parameters, 0, batchGradient, numRatings);
+  CheckMatrices(gradients[0], gradients[1]);
+  CheckMatrices(gradients[0], batchGradient);
+}
+
 BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimize)
 {
   // Define useful constants.
@@ -318,4 +374,52 @@ BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimizeHOGWILD)
 
 #endif
 
+/**
+ * Test Regularized SVD with the stratified parallel SGD used with the
+ * exponential backoff decay policy.
+ */
+BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimizeStratified)
+{
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t rank = 10;
+  const double lambda = 0.01;
+
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
+
+  // Each thread gets enough examples that every example is visited.
+  ExponentialBackoff decayPolicy(100, 0.01, 0.9);
+  ParallelSGD<ExponentialBackoff> optimizer(5000, rSVDFunc.NumFunctions(),
+      1e-7, true, decayPolicy);
+
+  arma::mat optParameters = arma::randu(rank, numUsers + numItems);
+  optimizer.Optimize(rSVDFunc, optParameters);
+
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    predictedData(0, i) = arma::dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+  BOOST_REQUIRE_SMALL(relativeError, 1e-2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,148 @@
+/**
+ * @file reorder_points_test.cpp
+ *
+ * Test the ReorderPoints() and RestoreOrder() utilities.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/reorder_points.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/unmap.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+BOOST_AUTO_TEST_SUITE(ReorderPointsTest);
+
+/**
+ * Return the total distance between consecutive points of the dataset.
+ */
+double PathLength(const arma::mat& dataset)
+{
+  double length = 0.0;
+  for (size_t i = 1; i < dataset.n_cols; ++i)
+    length += arma::norm(dataset.col(i) - dataset.col(i - 1));
+  return length;
+}
+
+/**
+ * Make sure that the points are permuted, and that the mappings match the
+ * permutation, for both curves.
+ */
+BOOST_AUTO_TEST_CASE(ReorderPointsMappingTest)
+{
+  const arma::mat original = arma::randn<arma::mat>(4, 500);
+  const SpaceFillingCurve curves[] = { HILBERT_CURVE, MORTON_CURVE };
+  for (const SpaceFillingCurve curve : curves)
+  {
+    arma::mat dataset(original);
+    std::vector<size_t> oldFromNew, newFromOld;
+    ReorderPoints(dataset, oldFromNew, newFromOld, curve);
+
+    BOOST_REQUIRE_EQUAL(dataset.n_rows, original.n_rows);
+    BOOST_REQUIRE_EQUAL(dataset.n_cols, original.n_cols);
+    BOOST_REQUIRE_EQUAL(oldFromNew.size(), original.n_cols);
+    BOOST_REQUIRE_EQUAL(newFromOld.size(), original.n_cols);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(newFromOld[oldFromNew[i]], i);
+      for (size_t j = 0; j < dataset.n_rows; ++j)
+        BOOST_REQUIRE_EQUAL(dataset(j, i), original(j, oldFromNew[i]));
+    }
+
+    // Restoring the order gives back the original dataset.
+    RestoreOrder(dataset, oldFromNew);
+    for (size_t i = 0; i < dataset.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(dataset[i], original[i]);
+  }
+}
+
+/**
+ * Make sure that consecutive points are much closer to each other after the
+ * dataset is sorted along either curve.
+ */
+BOOST_AUTO_TEST_CASE(ReorderPointsLocalityTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(2, 2000);
+  const double length = PathLength(dataset);
+
+  arma::mat hilbert(dataset), morton(dataset);
+  std::vector<size_t> oldFromNew;
+  ReorderPoints(hilbert, oldFromNew, HILBERT_CURVE);
+  ReorderPoints(morton, oldFromNew, MORTON_CURVE);
+
+  BOOST_REQUIRE_LT(PathLength(hilbert), 0.25 * length);
+  BOOST_REQUIRE_LT(PathLength(morton), 0.25 * length);
+}
+
+/**
+ * Make sure that RestoreOrder() refuses values with the wrong number of points.
+ */
+BOOST_AUTO_TEST_CASE(RestoreOrderWrongSizeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 50);
+  std::vector<size_t> oldFromNew;
+  ReorderPoints(dataset, oldFromNew);
+
+  arma::Row<size_t> labels(49);
+  BOOST_REQUIRE_THROW(RestoreOrder(labels, oldFromNew), std::invalid_argument);
+}
+
+/**
+ * Make sure that k-means and naive kNN give the same results on a reordered
+ * dataset, once the results are mapped back.
+ */
+BOOST_AUTO_TEST_CASE(ReorderedDatasetResultsTest)
+{
+  arma::mat dataset(2, 600);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    dataset.col(i) = arma::randn<arma::vec>(2);
+    dataset(0, i) += 10.0 * (i % 3);
+  }
+
+  arma::mat reordered(dataset);
+  std::vector<size_t> oldFromNew;
+  ReorderPoints(reordered, oldFromNew);
+
+  // k-means, from the same initial centroids.
+  arma::mat initialCentroids("0 10 20; 0 0 0");
+  arma::mat centroids(initialCentroids), reorderedCentroids(initialCentroids);
+  arma::Row<size_t> assignments, reorderedAssignments;
+  kmeans::KMeans<> k;
+  k.Cluster(dataset, 3, assignments, centroids, false, true);
+  k.Cluster(reordered, 3, reorderedAssignments, reorderedCentroids, false,
+      true);
+  RestoreOrder(reorderedAssignments, oldFromNew);
+
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(reorderedAssignments[i], assignments[i]);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(reorderedCentroids[i], centroids[i], 1e-5);
+
+  // Naive kNN of the original points, with the reordered reference set.
+  neighbor::KNN naive(dataset, neighbor::NAIVE_MODE);
+  neighbor::KNN reorderedNaive(reordered, neighbor::NAIVE_MODE);
+  arma::Mat<size_t> neighbors, reorderedNeighbors, mappedNeighbors;
+  arma::mat distances, reorderedDistances, mappedDistances;
+  naive.Search(dataset, 3, neighbors, distances);
+  reorderedNaive.Search(dataset, 3, reorderedNeighbors, reorderedDistances);
+  neighbor::Unmap(reorderedNeighbors, reorderedDistances, oldFromNew,
+      mappedNeighbors, mappedDistances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(mappedNeighbors[i], neighbors[i]);
+    BOOST_REQUIRE_CLOSE(mappedDistances[i], distances[i], 1e-5);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -15,7 +15,12 @@
 #include <mlpack/methods/reinforcement_learning/environment/mountain_car.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/cart_pole.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/prioritized_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
+#include <mlpack/methods/reinforcement_learning/worker/target_parameters.hpp>
+
+#include <atomic>
+#include <thread>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -107,6 +112,240 @@ BOOST_AUTO_TEST_CASE(RandomReplayTest)
   }
 }
 
+/**
+ * Check that storing several experiences at once wraps around the memory like
+ * storing them one by one.
+ */
+BOOST_AUTO_TEST_CASE(RandomReplayBulkStoreTest)
+{
+  RandomReplay<MountainCar> replay(4, 3);
+
+  // Five experiences, whose states and rewards are their indices.
+  arma::mat states(2, 5);
+  for (size_t i = 0; i < 5; ++i)
+    states.col(i).fill(i);
+  arma::icolvec actions(5);
+  actions.fill(MountainCar::Action::forward);
+  const arma::colvec rewards("0 1 2 3 4");
+  const arma::icolvec isEnd("0 0 0 0 1");
+
+  replay.Store(states.cols(0, 1), actions.subvec(0, 1), rewards.subvec(0, 1),
+      states.cols(0, 1), isEnd.subvec(0, 1));
+  BOOST_REQUIRE_EQUAL(replay.Size(), (size_t) 2);
+
+  // The first two experiences are overwritten.
+  replay.Store(states.cols(2, 4), actions.subvec(2, 4), rewards.subvec(2, 4),
+      states.cols(2, 4), isEnd.subvec(2, 4));
+  BOOST_REQUIRE_EQUAL(replay.Size(), (size_t) 3);
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  for (size_t trial = 0; trial < 10; ++trial)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+    for (size_t i = 0; i < sampledReward.n_elem; ++i)
+    {
+      BOOST_REQUIRE_GE(sampledReward[i], 2.0);
+      BOOST_REQUIRE_CLOSE(sampledState(0, i), sampledReward[i], 1e-5);
+      BOOST_REQUIRE_CLOSE(sampledNextState(1, i), sampledReward[i], 1e-5);
+      BOOST_REQUIRE_EQUAL(sampledTerminal[i],
+          (sampledReward[i] == 4.0) ? 1 : 0);
+    }
+  }
+}
+
+/**
+ * Check that a sum tree keeps the sums of its values, and finds the leaves at
+ * the given prefix sums.
+ */
+BOOST_AUTO_TEST_CASE(SumTreeTest)
+{
+  // A capacity that is not a power of two leaves some leaves unused.
+  SumTree tree(5);
+  const arma::vec values("1 0 2 3 4");
+  for (size_t i = 0; i < values.n_elem; ++i)
+    tree.Set(i, values[i]);
+
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 10.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(0.0), (size_t) 0);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(0.5), (size_t) 0);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(1.0), (size_t) 2);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(2.9), (size_t) 2);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(3.0), (size_t) 3);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(9.9), (size_t) 4);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(20.0), (size_t) 4);
+
+  // Batch updates.
+  tree.Set(arma::uvec("0 4"), arma::vec("5 0"));
+  BOOST_REQUIRE_CLOSE(tree.Get(0), 5.0, 1e-5);
+  BOOST_REQUIRE_SMALL(tree.Get(4), 1e-10);
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 10.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(9.9), (size_t) 3);
+}
+
+/**
+ * Check that prioritized replay samples transitions in proportion to their
+ * priorities, and weights the targets by importance sampling.
+ */
+BOOST_AUTO_TEST_CASE(PrioritizedReplayTest)
+{
+  PrioritizedReplay<MountainCar> replay(100, 4, 1.0, 1.0, 0.0);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    // Record the index of the transition in its reward.
+    env.Sample(state, action, nextState);
+    replay.Store(state, action, i, nextState, false);
+  }
+  BOOST_REQUIRE_EQUAL(replay.Size(), (size_t) 4);
+
+  // Transition 2 has no priority, and transition 3 three times the priority
+  // of transitions 0 and 1.
+  replay.UpdatePriorities(arma::uvec("0 1 2 3"), arma::colvec("1 -1 0 3"));
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+
+  arma::vec counts(4, arma::fill::zeros);
+  for (size_t trial = 0; trial < 10; ++trial)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+    for (size_t i = 0; i < sampledReward.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(replay.SampledIndices()[i], (size_t)
+          sampledReward[i]);
+      counts[(size_t) sampledReward[i]]++;
+    }
+  }
+
+  // Sampling is stratified, so the counts are close to the expected ones.
+  BOOST_REQUIRE_SMALL(counts[2], 1e-10);
+  BOOST_REQUIRE_CLOSE(counts[0], 200.0, 5.0);
+  BOOST_REQUIRE_CLOSE(counts[1], 200.0, 5.0);
+  BOOST_REQUIRE_CLOSE(counts[3], 600.0, 5.0);
+
+  // The weights are inversely proportional to the priorities with beta = 1.
+  for (size_t i = 0; i < sampledReward.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(replay.Weights()[i], (sampledReward[i] == 3.0) ?
+        1.0 / 3.0 : 1.0, 1e-5);
+  }
+
+  // Update() scales the errors of the targets by the weights, and takes them
+  // as the new priorities.
+  arma::mat actionValues(3, sampledReward.n_elem, arma::fill::zeros);
+  arma::mat target(3, sampledReward.n_elem, arma::fill::zeros);
+  for (size_t i = 0; i < sampledReward.n_elem; ++i)
+    target(sampledAction[i], i) = 6.0;
+  const arma::colvec weights = replay.Weights();
+  replay.Update(target, sampledAction, actionValues);
+  for (size_t i = 0; i < sampledReward.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(target(sampledAction[i], i), 6.0 * weights[i], 1e-5);
+
+  // Every sampled transition now has priority 6.
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+  for (size_t i = 0; i < replay.Weights().n_elem; ++i)
+    BOOST_REQUIRE_GT(replay.Weights()[i], 0.0);
+}
+
+/**
+ * Check that the shared target parameters are only copied when a new version
+ * has been published.
+ */
+BOOST_AUTO_TEST_CASE(TargetParametersTest)
+{
+  const arma::mat initial(5, 1, arma::fill::randu);
+  TargetParameters target(initial);
+  BOOST_REQUIRE_EQUAL(target.Version(), (size_t) 0);
+
+  arma::mat local = initial;
+  size_t localVersion = 0;
+  BOOST_REQUIRE(!target.Fetch(local, localVersion));
+
+  // Publish two versions; only the last one is fetched.
+  const arma::mat first(5, 1, arma::fill::randu);
+  const arma::mat second(5, 1, arma::fill::randu);
+  target.Publish(first);
+  target.Publish(second);
+  BOOST_REQUIRE_EQUAL(target.Version(), (size_t) 2);
+
+  BOOST_REQUIRE(target.Fetch(local, localVersion));
+  BOOST_REQUIRE_EQUAL(localVersion, (size_t) 2);
+  CheckMatrices(local, second);
+  BOOST_REQUIRE(!target.Fetch(local, localVersion));
+
+  // A stale copy gets the latest version.
+  arma::mat stale = initial;
+  size_t staleVersion = 0;
+  BOOST_REQUIRE(target.Fetch(stale, staleVersion));
+  CheckMatrices(stale, second);
+}
+
+/**
+ * Check that concurrent publications are all published, and that concurrent
+ * readers only get consistent versions.
+ */
+BOOST_AUTO_TEST_CASE(TargetParametersConcurrentPublishTest)
+{
+  const size_t writers = 4;
+  const size_t publications = 200;
+  TargetParameters target(arma::zeros(1000, 1));
+
+  // Every published matrix is filled with a single value, so a reader can
+  // detect a copy that mixes two versions.  Boost.Test isn't thread-safe, so
+  // the threads only count the errors.
+  std::atomic<bool> done(false);
+  std::atomic<size_t> inconsistent(0);
+  std::thread reader([&]()
+  {
+    arma::mat local;
+    size_t localVersion = 0;
+    while (!done.load())
+    {
+      if (target.Fetch(local, localVersion) &&
+          arma::any(arma::vectorise(local) != local[0]))
+        ++inconsistent;
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < writers; ++i)
+  {
+    threads.push_back(std::thread([&target, i, publications]()
+    {
+      for (size_t j = 0; j < publications; ++j)
+        target.Publish(arma::mat(1000, 1).fill(i * publications + j + 1));
+    }));
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+  done.store(true);
+  reader.join();
+
+  BOOST_REQUIRE_EQUAL(inconsistent.load(), (size_t) 0);
+  BOOST_REQUIRE_EQUAL(target.Version(), writers * publications);
+
+  // The last version is the last publication of one of the writers.
+  arma::mat local;
+  size_t localVersion = 0;
+  BOOST_REQUIRE(target.Fetch(local, localVersion));
+  BOOST_REQUIRE_EQUAL(localVersion, writers * publications);
+  BOOST_REQUIRE(arma::all(arma::vectorise(local) == local[0]));
+  BOOST_REQUIRE_EQUAL(((size_t) local[0]) % publications, (size_t) 0);
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -110,4 +110,69 @@ BOOST_AUTO_TEST_CASE(RastrigrinFunctionTest)
   BOOST_REQUIRE_GE(successes, 1);
 }
 
+/**
+ * Replica exchange between several chains should find the global minimum of
+ * the Rastrigin function, and return the best point found.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTemperingRastriginTest)
+{
+  size_t successes = 0;
+
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    RastriginFunction f(2);
+    ExponentialSchedule schedule;
+    SA<> sa(schedule, 2000000, 100, 50, 1000, 1e-12, 2, 2.0, 0.5, 0.1, 4, 10,
+        2.0);
+    arma::mat coordinates = f.GetInitialPoint();
+
+    const double result = sa.Optimize(f, coordinates);
+
+    // The returned objective is the one of the returned point.
+    BOOST_REQUIRE_CLOSE(result + 1.0, f.Evaluate(coordinates) + 1.0, 1e-5);
+    if ((std::abs(result) < 1e-3) &&
+        (std::abs(coordinates[0]) < 1e-3) &&
+        (std::abs(coordinates[1]) < 1e-3))
+    {
+      ++successes;
+      break; // No need to continue.
+    }
+  }
+
+  BOOST_REQUIRE_GE(successes, 1);
+}
+
+/**
+ * Independent chains (without exchanges) should minimize the Rosenbrock
+ * function too, and the results should not depend on the number of threads.
+ */
+BOOST_AUTO_TEST_CASE(IndependentChainsRosenbrockTest)
+{
+  RosenbrockFunction f;
+  ExponentialSchedule schedule;
+  SA<> sa(schedule, 1000000, 1000., 1000, 100, 1e-11, 3, 1.5, 0.3, 0.3, 3, 0);
+  BOOST_REQUIRE_EQUAL(sa.Chains(), 3);
+  BOOST_REQUIRE_EQUAL(sa.SwapSweeps(), 0);
+
+  math::RandomSeed(12);
+  arma::mat coordinates = f.GetInitialPoint();
+  const double result = sa.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_SMALL(result, 1e-5);
+  BOOST_REQUIRE_CLOSE(coordinates[0], 1.0, 1e-2);
+  BOOST_REQUIRE_CLOSE(coordinates[1], 1.0, 1e-2);
+
+  // A second run from the same seed gives the same point.
+  ExponentialSchedule schedule2;
+  SA<> sa2(schedule2, 1000000, 1000., 1000, 100, 1e-11, 3, 1.5, 0.3, 0.3, 3,
+      0);
+  math::RandomSeed(12);
+  arma::mat coordinates2 = f.GetInitialPoint();
+  const double result2 = sa2.Optimize(f, coordinates2);
+
+  BOOST_REQUIRE_CLOSE(result + 1.0, result2 + 1.0, 1e-10);
+  BOOST_REQUIRE_CLOSE(coordinates[0], coordinates2[0], 1e-10);
+  BOOST_REQUIRE_CLOSE(coordinates[1], coordinates2[1], 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
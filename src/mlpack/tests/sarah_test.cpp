@@ -75,4 +75,27 @@ BOOST_AUTO_TEST_CASE(SAHRAPlusLogisticRegressionTest)
   }
 }
 
+/**
+ * Run SARAH with parallel full gradients and asynchronous inner iterations on
+ * logistic regression and make sure the results are acceptable.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSARAHLogisticRegressionTest)
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  SARAH optimizer(0.01, 40, 250, 0, 1e-5, true, SARAHUpdate(), true);
+  LogisticRegression<> lr(shuffledData, shuffledResponses, optimizer, 0.5);
+
+  // Ensure that the error is close to zero.
+  const double acc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 1.5); // 1.5% error tolerance.
+
+  const double testAcc = lr.ComputeAccuracy(testData, testResponses);
+  BOOST_REQUIRE_CLOSE(testAcc, 100.0, 1.5); // 1.5% error tolerance.
+}
+
 BOOST_AUTO_TEST_SUITE_END();
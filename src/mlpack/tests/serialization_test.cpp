@@ -32,7 +32,10 @@
 #include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
 #include <mlpack/methods/rann/ra_search.hpp>
 #include <mlpack/methods/lsh/lsh_search.hpp>
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/ivf_pq/ivf_pq_search.hpp>
 #include <mlpack/methods/decision_stump/decision_stump.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/lars/lars.hpp>
 
 using namespace mlpack;
@@ -1232,16 +1235,98 @@ BOOST_AUTO_TEST_CASE(LSHTest)
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), textLsh.BucketSize());
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), binaryLsh.BucketSize());
 
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      xmlLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      textLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      binaryLsh.SecondHashTable().size());
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      textLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+  CheckMatrices(arma::conv_to<arma::Mat<size_t>>::from(lsh.BucketContents()),
+      arma::conv_to<arma::Mat<size_t>>::from(xmlLsh.BucketContents()),
+      arma::conv_to<arma::Mat<size_t>>::from(textLsh.BucketContents()),
+      arma::conv_to<arma::Mat<size_t>>::from(binaryLsh.BucketContents()));
+}
+
+/**
+ * Test that an HNSW model can be serialized and deserialized, and that it gives
+ * the same results afterwards.
+ */
+BOOST_AUTO_TEST_CASE(HNSWTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 300);
+  arma::mat queryData = arma::randu<arma::mat>(5, 20);
+
+  HNSWSearch<> hnsw(referenceData, 6, 40, 30);
+
+  HNSWSearch<> xmlHnsw;
+  arma::mat textData = arma::randu<arma::mat>(3, 50);
+  HNSWSearch<> textHnsw(textData, 4, 10);
+  HNSWSearch<> binaryHnsw(referenceData, 12, 20);
+
+  // Now serialize.
+  SerializeObjectAll(hnsw, xmlHnsw, textHnsw, binaryHnsw);
+
+  BOOST_REQUIRE_EQUAL(hnsw.M(), xmlHnsw.M());
+  BOOST_REQUIRE_EQUAL(hnsw.M(), textHnsw.M());
+  BOOST_REQUIRE_EQUAL(hnsw.M(), binaryHnsw.M());
+  BOOST_REQUIRE_EQUAL(hnsw.Ef(), xmlHnsw.Ef());
+  BOOST_REQUIRE_EQUAL(hnsw.Ef(), textHnsw.Ef());
+  BOOST_REQUIRE_EQUAL(hnsw.Ef(), binaryHnsw.Ef());
+  BOOST_REQUIRE_EQUAL(hnsw.EntryPoint(), xmlHnsw.EntryPoint());
+  BOOST_REQUIRE_EQUAL(hnsw.EntryPoint(), textHnsw.EntryPoint());
+  BOOST_REQUIRE_EQUAL(hnsw.EntryPoint(), binaryHnsw.EntryPoint());
+
+  CheckMatrices(hnsw.ReferenceSet(), xmlHnsw.ReferenceSet(),
+      textHnsw.ReferenceSet(), binaryHnsw.ReferenceSet());
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  hnsw.Search(queryData, 5, neighbors, distances);
+  xmlHnsw.Search(queryData, 5, xmlNeighbors, xmlDistances);
+  textHnsw.Search(queryData, 5, textNeighbors, textDistances);
+  binaryHnsw.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+/**
+ * Test that an IVF-PQ index can be serialized and deserialized, and that it
+ * gives the same results afterwards.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(6, 400);
+  arma::mat queryData = arma::randu<arma::mat>(6, 20);
+
+  IVFPQSearch ivfpq(referenceData, 4, 3, 16, true);
+
+  IVFPQSearch xmlIvfpq;
+  arma::mat textData = arma::randu<arma::mat>(4, 100);
+  IVFPQSearch textIvfpq(textData, 2, 2, 8);
+  IVFPQSearch binaryIvfpq(referenceData, 8, 2, 4);
 
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      textLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  // Now serialize.
+  SerializeObjectAll(ivfpq, xmlIvfpq, textIvfpq, binaryIvfpq);
+
+  BOOST_REQUIRE_EQUAL(ivfpq.NumPoints(), xmlIvfpq.NumPoints());
+  BOOST_REQUIRE_EQUAL(ivfpq.NumPoints(), textIvfpq.NumPoints());
+  BOOST_REQUIRE_EQUAL(ivfpq.NumPoints(), binaryIvfpq.NumPoints());
+
+  CheckMatrices(ivfpq.CoarseCentroids(), xmlIvfpq.CoarseCentroids(),
+      textIvfpq.CoarseCentroids(), binaryIvfpq.CoarseCentroids());
+  CheckMatrices(ivfpq.Codebooks(), xmlIvfpq.Codebooks(),
+      textIvfpq.Codebooks(), binaryIvfpq.Codebooks());
+  CheckMatrices(ivfpq.ListIndices(), xmlIvfpq.ListIndices(),
+      textIvfpq.ListIndices(), binaryIvfpq.ListIndices());
+  CheckMatrices(ivfpq.ReferenceSet(), xmlIvfpq.ReferenceSet(),
+      textIvfpq.ReferenceSet(), binaryIvfpq.ReferenceSet());
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  ivfpq.Search(queryData, 5, neighbors, distances, 2, 10);
+  xmlIvfpq.Search(queryData, 5, xmlNeighbors, xmlDistances, 2, 10);
+  textIvfpq.Search(queryData, 5, textNeighbors, textDistances, 2, 10);
+  binaryIvfpq.Search(queryData, 5, binaryNeighbors, binaryDistances, 2, 10);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
 }
 
 // Make sure serialization works for the decision stump.
@@ -1690,4 +1775,89 @@ BOOST_AUTO_TEST_CASE(HoeffdingTreeTest)
   }
 }
 
+//! Enable compact storage of models for the lifetime of the object.
+struct CompactStorageGuard
+{
+  CompactStorageGuard() { mlpack::data::CompactStorage::Set(true); }
+  ~CompactStorageGuard() { mlpack::data::CompactStorage::Set(false); }
+};
+
+//! Get the size of the binary archive of an object.
+template<typename T>
+size_t BinaryArchiveSize(T& t)
+{
+  std::ostringstream stream;
+  {
+    boost::archive::binary_oarchive o(stream);
+    o << BOOST_SERIALIZATION_NVP(t);
+  }
+  return stream.str().size();
+}
+
+/**
+ * Make sure that models saved compactly are smaller, and are loaded again with
+ * parameters close to the original ones.
+ */
+BOOST_AUTO_TEST_CASE(CompactStorageTest)
+{
+  vec mean(10, arma::fill::randu);
+  mat cov(10, 10, arma::fill::randu);
+  cov = cov * cov.t() + 0.1 * arma::eye<mat>(10, 10);
+  GaussianDistribution g(mean, cov);
+
+  arma::mat referenceData = arma::randu<arma::mat>(10, 1000);
+  LSHSearch<> lsh(referenceData, 5, 10);
+
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (dataset(0, i) + dataset(1, i) > 1.0) ? 1 : 0;
+  DecisionTree<> tree(dataset, labels, 2, 10);
+
+  const size_t gaussianSize = BinaryArchiveSize(g);
+  const size_t lshSize = BinaryArchiveSize(lsh);
+  const size_t treeSize = BinaryArchiveSize(tree);
+
+  CompactStorageGuard guard;
+  BOOST_REQUIRE_LT(BinaryArchiveSize(g), gaussianSize / 2);
+  BOOST_REQUIRE_LT(BinaryArchiveSize(lsh), 0.6 * lshSize);
+  BOOST_REQUIRE_LT(BinaryArchiveSize(tree), treeSize);
+
+  GaussianDistribution xmlG, textG, binaryG;
+  SerializeObjectAll(g, xmlG, textG, binaryG);
+  arma::mat randomObs = arma::randu<arma::mat>(10, 100);
+  for (size_t i = 0; i < randomObs.n_cols; ++i)
+  {
+    const double logProb = g.LogProbability(randomObs.unsafe_col(i));
+    BOOST_REQUIRE_CLOSE(xmlG.LogProbability(randomObs.unsafe_col(i)), logProb,
+        1e-2);
+    BOOST_REQUIRE_CLOSE(textG.LogProbability(randomObs.unsafe_col(i)), logProb,
+        1e-2);
+    BOOST_REQUIRE_CLOSE(binaryG.LogProbability(randomObs.unsafe_col(i)),
+        logProb, 1e-2);
+  }
+
+  LSHSearch<> xmlLsh, textLsh, binaryLsh;
+  SerializeObjectAll(lsh, xmlLsh, textLsh, binaryLsh);
+  for (LSHSearch<>* loaded : { &xmlLsh, &textLsh, &binaryLsh })
+  {
+    BOOST_REQUIRE_SMALL(arma::abs(loaded->ReferenceSet() -
+        lsh.ReferenceSet()).max(), 1e-6);
+    BOOST_REQUIRE(arma::all(loaded->BucketOffsets() == lsh.BucketOffsets()));
+    BOOST_REQUIRE(arma::all(loaded->BucketContents() ==
+        lsh.BucketContents()));
+  }
+
+  DecisionTree<> xmlTree, textTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, textTree, binaryTree);
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions;
+  tree.Classify(dataset, predictions);
+  xmlTree.Classify(dataset, xmlPredictions);
+  textTree.Classify(dataset, textPredictions);
+  binaryTree.Classify(dataset, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -13,6 +13,10 @@
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
 #include <mlpack/core/optimizers/problems/generalized_rosenbrock_function.hpp>
 #include <mlpack/core/optimizers/problems/sgd_test_function.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/sparse_test_function.hpp>
+#include <mlpack/core/optimizers/adam/adam_update.hpp>
+#include <mlpack/core/optimizers/ada_grad/ada_grad_update.hpp>
+#include <mlpack/core/optimizers/rmsprop/rmsprop_update.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -58,4 +62,56 @@ BOOST_AUTO_TEST_CASE(GeneralizedRosenbrockTest)
   }
 }
 
+/**
+ * Optimize the given function with the given sparse update policy and make sure
+ * that each coordinate ends up at the vertex of its parabola.
+ */
+template<typename UpdatePolicyType>
+void CheckSparseSGD(const double stepSize,
+                    const UpdatePolicyType& updatePolicy = UpdatePolicyType())
+{
+  SparseTestFunction f;
+  SGD<UpdatePolicyType> s(stepSize, 1, 200000, 1e-12, true, updatePolicy);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates);
+
+  BOOST_REQUIRE_CLOSE(coordinates[0], 2.0, 1.0);
+  BOOST_REQUIRE_CLOSE(coordinates[1], 1.0, 1.0);
+  BOOST_REQUIRE_CLOSE(coordinates[2], 1.5, 1.0);
+  BOOST_REQUIRE_CLOSE(coordinates[3], 4.0, 1.0);
+}
+
+/**
+ * Make sure that SGD works with sparse gradients and all of the update policies
+ * that support them.
+ */
+BOOST_AUTO_TEST_CASE(SparseGradientSGDTest)
+{
+  CheckSparseSGD<VanillaUpdate>(0.1);
+  CheckSparseSGD<MomentumUpdate>(0.05, MomentumUpdate(0.5));
+  CheckSparseSGD<AdaGradUpdate>(0.5);
+  CheckSparseSGD<RMSPropUpdate>(0.001);
+  CheckSparseSGD<AdamUpdate>(0.001);
+}
+
+/**
+ * The sparse RMSProp update catches up the decay of the mean squared gradient
+ * exactly, so it should give the same result as the dense update.
+ */
+BOOST_AUTO_TEST_CASE(SparseRMSPropMatchesDenseTest)
+{
+  SparseTestFunction sparseFunction;
+  DenseGradientTestFunction denseFunction;
+  SGD<RMSPropUpdate> s(0.01, 1, 1000, 0.0, false);
+
+  arma::mat sparseCoordinates = sparseFunction.GetInitialPoint();
+  arma::mat denseCoordinates = denseFunction.GetInitialPoint();
+  s.Optimize(sparseFunction, sparseCoordinates);
+  s.Optimize(denseFunction, denseCoordinates);
+
+  for (size_t i = 0; i < sparseCoordinates.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sparseCoordinates[i], denseCoordinates[i], 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
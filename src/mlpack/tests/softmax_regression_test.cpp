@@ -669,4 +669,163 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionComputeProbabilitiesAndLabelsTest)
   }
 }
 
+/**
+ * Make sure that the objective and gradients on sparse data are the same as on
+ * the equivalent dense data.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionSparseTest)
+{
+  const size_t points = 300;
+  const size_t numClasses = 4;
+
+  arma::sp_mat data;
+  data.sprandu(30, points, 0.1);
+  const arma::mat denseData(data);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels[i] = math::RandInt(0, numClasses);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegressionFunction srf(denseData, labels, numClasses, 0.1,
+        intercept == 1);
+    SoftmaxRegressionFunctionType<arma::sp_mat> sparseSrf(data, labels,
+        numClasses, 0.1, intercept == 1);
+
+    const arma::mat parameters = srf.GetInitialPoint();
+    BOOST_REQUIRE_CLOSE(srf.Evaluate(parameters),
+        sparseSrf.Evaluate(parameters), 1e-5);
+
+    arma::mat gradient, sparseGradient;
+    srf.Gradient(parameters, gradient);
+    sparseSrf.Gradient(parameters, sparseGradient);
+    CheckMatrices(gradient, sparseGradient);
+
+    srf.Gradient(parameters, 50, gradient, 100);
+    sparseSrf.Gradient(parameters, 50, sparseGradient, 100);
+    CheckMatrices(gradient, sparseGradient);
+  }
+}
+
+/**
+ * Train softmax regression on sparse data and make sure that the model is the
+ * same as the one trained on the equivalent dense data.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionSparseTrainTest)
+{
+  const size_t points = 500;
+  const size_t numClasses = 3;
+
+  arma::sp_mat data;
+  data.sprandu(20, points, 0.2);
+  const arma::mat denseData(data);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels[i] = math::RandInt(0, numClasses);
+
+  SoftmaxRegression sr(20, numClasses, true);
+  SoftmaxRegression sparseSr(20, numClasses, true);
+  sparseSr.Parameters() = sr.Parameters();
+
+  sr.Train(denseData, labels, numClasses, L_BFGS(5, 20));
+  sparseSr.Train(data, labels, numClasses, L_BFGS(5, 20));
+
+  BOOST_REQUIRE_EQUAL(sr.Parameters().n_elem, sparseSr.Parameters().n_elem);
+  for (size_t i = 0; i < sr.Parameters().n_elem; ++i)
+  {
+    if (std::abs(sr.Parameters()[i]) < 1e-6)
+      BOOST_REQUIRE_SMALL(sparseSr.Parameters()[i], 1e-6);
+    else
+      BOOST_REQUIRE_CLOSE(sr.Parameters()[i], sparseSr.Parameters()[i], 1e-3);
+  }
+
+  // Classification of sparse and dense points must give the same results.
+  arma::Row<size_t> predictions, sparsePredictions;
+  sr.Classify(denseData, predictions);
+  sr.Classify(data, sparsePredictions);
+  CheckMatrices(predictions, sparsePredictions);
+  BOOST_REQUIRE_CLOSE(sr.ComputeAccuracy(denseData, labels),
+      sr.ComputeAccuracy(data, labels), 1e-5);
+}
+
+/**
+ * Make sure that the blocked classification gives the same probabilities and
+ * labels as the expressions over all the points, when there are several
+ * blocks.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionBlockedClassifyTest)
+{
+  const size_t numClasses = 5;
+  arma::mat data = arma::randn<arma::mat>(8, 2500);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegression sr(8, numClasses, intercept == 1);
+    sr.Parameters() = arma::randn<arma::mat>(numClasses, 8 + intercept);
+
+    arma::mat scores = (intercept == 1) ?
+        arma::mat(sr.Parameters().tail_cols(8) * data) :
+        arma::mat(sr.Parameters() * data);
+    if (intercept == 1)
+      scores.each_col() += sr.Parameters().col(0);
+    arma::mat expected = arma::exp(scores);
+    expected.each_row() /= arma::sum(expected, 0);
+
+    arma::mat probabilities;
+    arma::Row<size_t> labels, labelsWithProbabilities;
+    sr.Classify(data, probabilities);
+    sr.Classify(data, labels);
+    sr.Classify(data, labelsWithProbabilities, probabilities);
+    CheckMatrices(probabilities, expected);
+
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      arma::uword best;
+      expected.col(i).max(best);
+      BOOST_REQUIRE_EQUAL(labels[i], best);
+      BOOST_REQUIRE_EQUAL(labelsWithProbabilities[i], best);
+    }
+  }
+}
+
+/**
+ * Make sure that single-precision points get the same labels and (to single
+ * precision) the same probabilities as the double-precision points.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFloatClassifyTest)
+{
+  const size_t numClasses = 5;
+  arma::mat data = arma::randn<arma::mat>(8, 2500);
+  const arma::fmat floatData = arma::conv_to<arma::fmat>::from(data);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegression sr(8, numClasses, intercept == 1);
+    sr.Parameters() = arma::randn<arma::mat>(numClasses, 8 + intercept);
+
+    arma::mat probabilities;
+    sr.Classify(data, probabilities);
+
+    arma::fmat floatProbabilities;
+    arma::Row<size_t> labels;
+    sr.Classify(floatData, floatProbabilities);
+    sr.Classify(floatData, labels);
+    CheckMatrices(arma::conv_to<arma::mat>::from(floatProbabilities),
+        probabilities, 1e-2);
+
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      // Skip the points whose two most probable classes are too close for
+      // single precision.
+      arma::vec sorted = arma::sort(probabilities.col(i), "descend");
+      if (sorted[0] - sorted[1] < 1e-4)
+        continue;
+
+      arma::uword best;
+      probabilities.col(i).max(best);
+      BOOST_REQUIRE_EQUAL(labels[i], best);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
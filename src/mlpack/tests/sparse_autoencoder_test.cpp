@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/sparse_autoencoder/sparse_autoencoder.hpp>
+#include <mlpack/core/optimizers/adam/adam.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -268,4 +269,119 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionGradient)
   }
 }
 
+/**
+ * The objective and the gradient of a batch that holds all the points should
+ * be the full objective and gradient, also when the batch is processed in
+ * several blocks; and the objective should not depend on the order of the
+ * points.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionFullBatchTest)
+{
+  const size_t points = 2500;
+  const size_t vSize = 20;
+  const size_t hSize = 10;
+
+  arma::mat data;
+  data.randu(vSize, points);
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.1, 2, 0.05);
+
+  arma::mat parameters;
+  parameters.randu(2 * hSize + 1, vSize + 1);
+  parameters -= 0.5;
+
+  // The reference objective and gradient, computed without blocks.
+  arma::mat hiddenLayer, outputLayer;
+  saf.Sigmoid(parameters.submat(0, 0, hSize - 1, vSize - 1) * data +
+      arma::repmat(parameters.submat(0, vSize, hSize - 1, vSize), 1, points),
+      hiddenLayer);
+  saf.Sigmoid(parameters.submat(hSize, 0, 2 * hSize - 1, vSize - 1).t() *
+      hiddenLayer + arma::repmat(parameters.submat(2 * hSize, 0, 2 * hSize,
+      vSize - 1).t(), 1, points), outputLayer);
+  const arma::vec rhoCap = arma::mean(hiddenLayer, 1);
+  const double expected = 0.5 * arma::accu(arma::square(outputLayer - data)) /
+      points + 0.05 * arma::accu(arma::square(parameters.submat(0, 0,
+      2 * hSize - 1, vSize - 1))) + 2 * arma::accu(0.05 *
+      arma::log(0.05 / rhoCap) + 0.95 * arma::log(0.95 / (1 - rhoCap)));
+
+  BOOST_REQUIRE_CLOSE(saf.Evaluate(parameters), expected, 1e-8);
+  BOOST_REQUIRE_CLOSE(saf.Evaluate(parameters, 0, points), expected, 1e-8);
+
+  arma::mat gradient, batchGradient, combinedGradient;
+  saf.Gradient(parameters, gradient);
+  saf.Gradient(parameters, 0, batchGradient, points);
+  const double objective = saf.EvaluateWithGradient(parameters, 0,
+      combinedGradient, points);
+  BOOST_REQUIRE_CLOSE(objective, expected, 1e-8);
+  CheckMatrices(gradient, batchGradient, 1e-5);
+  CheckMatrices(gradient, combinedGradient, 1e-5);
+
+  // The empty cells of the parameters have a zero gradient.
+  BOOST_REQUIRE_EQUAL(arma::accu(arma::abs(gradient.submat(hSize, vSize,
+      2 * hSize, vSize))), 0.0);
+
+  saf.Shuffle();
+  BOOST_REQUIRE_CLOSE(saf.Evaluate(parameters), expected, 1e-8);
+  saf.Gradient(parameters, batchGradient);
+  CheckMatrices(gradient, batchGradient, 1e-5);
+}
+
+/**
+ * Check the gradient of a batch numerically.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionBatchGradientTest)
+{
+  const size_t vSize = 8;
+  const size_t hSize = 5;
+
+  arma::mat data;
+  data.randu(vSize, 500);
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.5, 3, 0.1);
+
+  arma::mat parameters;
+  parameters.randu(2 * hSize + 1, vSize + 1);
+  parameters -= 0.5;
+
+  const size_t begin = 100;
+  const size_t batchSize = 50;
+  arma::mat gradient;
+  saf.Gradient(parameters, begin, gradient, batchSize);
+
+  const double epsilon = 1e-5;
+  for (size_t i = 0; i <= 2 * hSize; ++i)
+  {
+    for (size_t j = 0; j <= vSize; ++j)
+    {
+      parameters(i, j) += epsilon;
+      const double costPlus = saf.Evaluate(parameters, begin, batchSize);
+      parameters(i, j) -= 2 * epsilon;
+      const double costMinus = saf.Evaluate(parameters, begin, batchSize);
+      parameters(i, j) += epsilon;
+
+      const double numGradient = (costPlus - costMinus) / (2 * epsilon);
+      BOOST_REQUIRE_SMALL(gradient(i, j) - numGradient, 1e-6);
+    }
+  }
+}
+
+/**
+ * Minibatch training with Adam should decrease the objective.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionAdamTest)
+{
+  const size_t vSize = 10;
+  const size_t hSize = 4;
+
+  arma::mat data;
+  data.randu(vSize, 2000);
+  SparseAutoencoderFunction saf(data, vSize, hSize);
+
+  arma::mat parameters = saf.GetInitialPoint();
+  const double initialObjective = saf.Evaluate(parameters);
+
+  optimization::Adam adam(0.01, 32, 0.9, 0.999, 1e-8, 20 * data.n_cols, 1e-8);
+  adam.Optimize(saf, parameters);
+
+  BOOST_REQUIRE_LT(saf.Evaluate(parameters), 0.5 * initialObjective);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
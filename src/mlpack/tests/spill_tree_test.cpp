@@ -13,12 +13,15 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/tree/spill_tree.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <boost/test/unit_test.hpp>
 #include <stack>
+#include "test_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::tree;
 using namespace mlpack::metric;
+using namespace mlpack::neighbor;
 
 BOOST_AUTO_TEST_SUITE(SpillTreeTest);
 
@@ -308,4 +311,143 @@ BOOST_AUTO_TEST_CASE(SpillTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Store the number of descendants and points of each node, in depth-first
+ * order.
+ */
+template<typename TreeType>
+void GetNodeCounts(const TreeType& node, std::vector<size_t>& counts)
+{
+  counts.push_back(node.NumDescendants());
+  counts.push_back(node.NumPoints());
+  if (node.Left())
+    GetNodeCounts(*node.Left(), counts);
+  if (node.Right())
+    GetNodeCounts(*node.Right(), counts);
+}
+
+/**
+ * The tree built with all threads must be the same as the tree built with one
+ * thread, including the points of each leaf.
+ */
+BOOST_AUTO_TEST_CASE(SpillTreeParallelConstructionTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 30000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+  #endif
+
+  TreeType serialTree(dataset, 0.05);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(std::max(prevNumThreads, 4));
+  #endif
+
+  TreeType parallelTree(dataset, 0.05);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  std::vector<size_t> serialCounts, parallelCounts;
+  GetNodeCounts(serialTree, serialCounts);
+  GetNodeCounts(parallelTree, parallelCounts);
+  BOOST_REQUIRE_EQUAL(serialCounts.size(), parallelCounts.size());
+  for (size_t i = 0; i < serialCounts.size(); ++i)
+    BOOST_REQUIRE_EQUAL(serialCounts[i], parallelCounts[i]);
+
+  // Check the leaves and the parents.
+  std::stack<const TreeType*> serialNodes, parallelNodes;
+  serialNodes.push(&serialTree);
+  parallelNodes.push(&parallelTree);
+  while (!serialNodes.empty())
+  {
+    const TreeType* serialNode = serialNodes.top();
+    const TreeType* parallelNode = parallelNodes.top();
+    serialNodes.pop();
+    parallelNodes.pop();
+
+    BOOST_REQUIRE_CLOSE(serialNode->ParentDistance(),
+        parallelNode->ParentDistance(), 1e-5);
+    for (size_t i = 0; i < serialNode->NumPoints(); ++i)
+      BOOST_REQUIRE_EQUAL(serialNode->Point(i), parallelNode->Point(i));
+
+    for (size_t i = 0; i < parallelNode->NumChildren(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(parallelNode->Child(i).Parent(), parallelNode);
+      serialNodes.push(&serialNode->Child(i));
+      parallelNodes.push(&parallelNode->Child(i));
+    }
+  }
+}
+
+/**
+ * With a leaf budget, the single-tree traverser must visit at most that many
+ * leaves per query, and the neighbors it finds must have the right distances.
+ * Without a budget, the search must be exact.
+ */
+BOOST_AUTO_TEST_CASE(SpillTreeHybridTraverserTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(4, 100);
+
+  typedef SPTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance, TreeType>
+      RuleType;
+
+  // Without an overlapping buffer, no point is found twice.
+  TreeType tree(dataset, 0, 10);
+  EuclideanDistance metric;
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  naive.Search(querySet, 3, trueNeighbors, trueDistances);
+
+  // Without a budget, the search is exact.
+  RuleType exactRules(tree.Dataset(), querySet, 3, metric);
+  TreeType::SingleTreeTraverser<RuleType> exactTraverser(exactRules);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    exactTraverser.Traverse(i, tree);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  exactRules.GetResults(neighbors, distances);
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+
+  // With a budget of two leaves, both traversers stay within it.
+  RuleType rules(tree.Dataset(), querySet, 3, metric);
+  TreeType::SingleTreeTraverser<RuleType> traverser(rules, 2);
+  RuleType defeatistRules(tree.Dataset(), querySet, 3, metric);
+  TreeType::DefeatistSingleTreeTraverser<RuleType> defeatistTraverser(
+      defeatistRules, 2);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    traverser.Traverse(i, tree);
+    BOOST_REQUIRE_GE(traverser.NumVisitedLeaves(), 1);
+    BOOST_REQUIRE_LE(traverser.NumVisitedLeaves(), 2);
+
+    defeatistTraverser.Traverse(i, tree);
+    BOOST_REQUIRE_GE(defeatistTraverser.NumVisitedLeaves(), 1);
+    BOOST_REQUIRE_LE(defeatistTraverser.NumVisitedLeaves(), 2);
+  }
+
+  rules.GetResults(neighbors, distances);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors(j, i), dataset.n_cols);
+      BOOST_REQUIRE_CLOSE(distances(j, i), arma::norm(querySet.col(i) -
+          dataset.col(neighbors(j, i))), 1e-5);
+      BOOST_REQUIRE_GE(distances(j, i), trueDistances(j, i) - 1e-10);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -170,4 +170,40 @@ BOOST_AUTO_TEST_CASE(SplitLabeledDataLargerTest)
   CheckDuplication(std::get<2>(value), std::get<3>(value));
 }
 
+/**
+ * Make sure SplitInPlace() returns aliases of the shuffled input, which are the
+ * same as the result of Split() with the same random seed.
+ */
+BOOST_AUTO_TEST_CASE(SplitInPlaceTest)
+{
+  mat input(10, 497);
+  input.randu();
+  const mat original(input);
+
+  // Set the labels to the column ID.
+  Row<size_t> labels = arma::linspace<Row<size_t>>(0, input.n_cols - 1,
+      input.n_cols);
+
+  math::RandomSeed(17);
+  const auto copied = Split(original, labels, 0.3);
+  math::RandomSeed(17);
+  const auto value = SplitInPlace(input, labels, 0.3);
+
+  BOOST_REQUIRE_EQUAL(std::get<0>(value).n_cols, 497 - size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(std::get<1>(value).n_cols, size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(std::get<0>(value).memptr(), input.memptr());
+  BOOST_REQUIRE_EQUAL(std::get<1>(value).memptr(),
+      input.colptr(std::get<0>(value).n_cols));
+  BOOST_REQUIRE_EQUAL(std::get<2>(value).memptr(), labels.memptr());
+
+  CompareData(original, std::get<0>(value), std::get<2>(value));
+  CompareData(original, std::get<1>(value), std::get<3>(value));
+  CheckDuplication(std::get<2>(value), std::get<3>(value));
+
+  CheckMatrices(std::get<0>(value), std::get<0>(copied));
+  CheckMatrices(std::get<1>(value), std::get<1>(copied));
+  for (size_t i = 0; i < std::get<2>(value).n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(std::get<2>(value)[i], std::get<2>(copied)[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
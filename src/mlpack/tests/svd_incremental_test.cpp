@@ -14,9 +14,11 @@
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/termination_policies/incomplete_incremental_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/complete_incremental_termination.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_tolerance_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/validation_rmse_termination.hpp>
 
@@ -146,4 +148,90 @@ BOOST_AUTO_TEST_CASE(SVDIncompleteIncrementalRegularizationTest)
   BOOST_REQUIRE_LT(regularizedRMSE, regularRMSE + 0.105);
 }
 
+/**
+ * Compute the RMSE of the factorization on the nonzero entries of the data.
+ */
+double NonzeroRMSE(const sp_mat& data, const mat& w, const mat& h)
+{
+  double sum = 0.0;
+  for (sp_mat::const_iterator it = data.begin(); it != data.end(); ++it)
+  {
+    const double error = *it - dot(w.row(it.row()), h.col(it.col()));
+    sum += error * error;
+  }
+
+  return std::sqrt(sum / data.n_nonzero);
+}
+
+/**
+ * Make sure that parallel incremental learning reduces the error on the
+ * nonzero entries.
+ */
+BOOST_AUTO_TEST_CASE(SVDParallelIncrementalLearningTest)
+{
+  // Observe some entries of a low-rank matrix.
+  const mat lowRank = randu<mat>(100, 2) * randu<mat>(2, 80);
+  sp_mat data;
+  data.sprandu(100, 80, 0.2);
+  for (sp_mat::iterator it = data.begin(); it != data.end(); ++it)
+    *it = lowRank(it.row(), it.col());
+
+  SpecificRandomInitialization sri(data.n_rows, 2, data.n_cols);
+  mat w, h;
+  sri.Initialize(data, 2, w, h);
+  const double initialRMSE = NonzeroRMSE(data, w, h);
+
+  AMF<MaxIterationTermination,
+      SpecificRandomInitialization,
+      SVDParallelIncrementalLearning> amf(MaxIterationTermination(200), sri,
+      SVDParallelIncrementalLearning(0.01, 0, 0, 4));
+  amf.Apply(data, 2, w, h);
+
+  BOOST_REQUIRE_LT(NonzeroRMSE(data, w, h), 0.5 * initialRMSE);
+}
+
+/**
+ * Make sure that parallel incremental learning gives the same result with any
+ * number of threads, and with dense and sparse input.
+ */
+BOOST_AUTO_TEST_CASE(SVDParallelIncrementalThreadsTest)
+{
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+  #endif
+
+  sp_mat data;
+  data.sprandu(200, 150, 0.1);
+  const mat denseData(data);
+
+  SpecificRandomInitialization sri(data.n_rows, 4, data.n_cols);
+
+  mat w[3], h[3];
+  for (size_t run = 0; run < 3; ++run)
+  {
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(run == 1 ? 4 : 1);
+    #endif
+
+    math::RandomSeed(17);
+    AMF<MaxIterationTermination,
+        SpecificRandomInitialization,
+        SVDParallelIncrementalLearning> amf(MaxIterationTermination(10), sri,
+        SVDParallelIncrementalLearning(0.01, 0.001, 0.001, 8));
+    if (run < 2)
+      amf.Apply(data, 4, w[run], h[run]);
+    else
+      amf.Apply(denseData, 4, w[run], h[run]);
+  }
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  CheckMatrices(w[0], w[1]);
+  CheckMatrices(h[0], h[1]);
+  CheckMatrices(w[0], w[2]);
+  CheckMatrices(h[0], h[2]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
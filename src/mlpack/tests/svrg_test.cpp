@@ -74,4 +74,28 @@ BOOST_AUTO_TEST_CASE(SVRGBBLogisticRegressionTest)
   }
 }
 
+/**
+ * Run SVRG with parallel full gradients and asynchronous inner iterations on
+ * logistic regression and make sure the results are acceptable.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSVRGLogisticRegressionTest)
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  SVRG optimizer(0.001, 40, 250, 0, 1e-3, true, SVRGUpdate(), NoDecay(),
+      true, true);
+  LogisticRegression<> lr(shuffledData, shuffledResponses, optimizer, 0.5);
+
+  // Ensure that the error is close to zero.
+  const double acc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 1.5); // 1.5% error tolerance.
+
+  const double testAcc = lr.ComputeAccuracy(testData, testResponses);
+  BOOST_REQUIRE_CLOSE(testAcc, 100.0, 1.5); // 1.5% error tolerance.
+}
+
 BOOST_AUTO_TEST_SUITE_END();
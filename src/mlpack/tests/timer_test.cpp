@@ -147,4 +147,53 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+/**
+ * The memory used while a timer runs should be recorded: the peak resident set
+ * size where the platform gives it, and the Armadillo allocations if they are
+ * tracked.
+ */
+BOOST_AUTO_TEST_CASE(TimerMemoryUsageTest)
+{
+  Timer::EnableTiming();
+  Timer::Start("memory_timer");
+  arma::mat a(100, 100, arma::fill::randu);
+  arma::mat b = a * a;
+  Timer::Stop("memory_timer");
+
+  const MemoryUsage usage = Timer::GetMemoryUsage("memory_timer");
+  #if defined(__unix__) || defined(__APPLE__)
+  BOOST_REQUIRE_GT(usage.peakRSS, 0);
+  BOOST_REQUIRE_GE(usage.peakRSS, MemoryTracker::CurrentRSS() / 2);
+  #endif
+
+  if (MemoryTracker::TracksAllocations())
+  {
+    BOOST_REQUIRE_GE(usage.allocations, 2);
+    BOOST_REQUIRE_GE(usage.bytesAllocated, 2 * a.n_elem * sizeof(double));
+    BOOST_REQUIRE_GE(MemoryTracker::BytesInUse(),
+        2 * a.n_elem * sizeof(double));
+    BOOST_REQUIRE_GE(MemoryTracker::PeakBytesInUse(),
+        MemoryTracker::BytesInUse());
+  }
+  else
+  {
+    BOOST_REQUIRE_EQUAL(usage.allocations, 0);
+    BOOST_REQUIRE_EQUAL(usage.bytesAllocated, 0);
+  }
+
+  // The allocations are summed over the runs of the timer.
+  Timer::Start("memory_timer");
+  arma::mat c(a);
+  Timer::Stop("memory_timer");
+  if (MemoryTracker::TracksAllocations())
+  {
+    BOOST_REQUIRE_GE(Timer::GetMemoryUsage("memory_timer").allocations,
+        usage.allocations + 1);
+  }
+
+  Timer::ResetAll();
+  BOOST_REQUIRE_EQUAL(Timer::GetMemoryUsage("memory_timer").peakRSS, 0);
+  Timer::DisableTiming();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,145 @@
+/**
+ * @file traversal_statistics_test.cpp
+ *
+ * Tests for the traversal statistics of the dual-tree algorithms.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::neighbor;
+using namespace mlpack::range;
+using namespace mlpack::metric;
+
+typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+    KNN::Tree> KNNRules;
+
+BOOST_AUTO_TEST_SUITE(TraversalStatisticsTest);
+
+/**
+ * Make sure wrapping the rules does not change the results, and that the
+ * statistics agree with the counters of the rules.
+ */
+BOOST_AUTO_TEST_CASE(StatisticsRulesTest)
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  KNN::Tree tree(dataset, 10);
+  EuclideanDistance metric;
+
+  KNNRules rules(tree.Dataset(), tree.Dataset(), 5, metric, 0, true);
+  KNN::Tree::DualTreeTraverser<KNNRules> traverser(rules);
+  traverser.Traverse(tree, tree);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  rules.GetResults(neighbors, distances);
+
+  KNNRules wrappedRules(tree.Dataset(), tree.Dataset(), 5, metric, 0, true);
+  TraversalStatistics statistics;
+  size_t numPrunes;
+  {
+    StatisticsRules<KNNRules> statisticsRules(wrappedRules, statistics);
+    KNN::Tree::DualTreeTraverser<StatisticsRules<KNNRules>>
+        statisticsTraverser(statisticsRules);
+    statisticsTraverser.Traverse(tree, tree);
+    numPrunes = statisticsTraverser.NumPrunes();
+  }
+
+  arma::Mat<size_t> wrappedNeighbors;
+  arma::mat wrappedDistances;
+  wrappedRules.GetResults(wrappedNeighbors, wrappedDistances);
+
+  CheckMatrices(neighbors, wrappedNeighbors);
+  CheckMatrices(distances, wrappedDistances);
+
+  // The base cases that the rules skip (the same point, or a repeated base
+  // case) are counted by the statistics too, and so are the pruned point
+  // scores in the leaves, which the traverser does not count as prunes.
+  BOOST_REQUIRE_EQUAL(statistics.Scores(), wrappedRules.Scores());
+  BOOST_REQUIRE_GE(statistics.BaseCases(), wrappedRules.BaseCases());
+  BOOST_REQUIRE_GE(statistics.Prunes(), numPrunes);
+  BOOST_REQUIRE_GT(statistics.Depths(), 1);
+
+  size_t scores = 0, prunes = 0;
+  for (size_t d = 0; d < statistics.Depths(); ++d)
+  {
+    BOOST_REQUIRE_LE(statistics.Prunes(d), statistics.Scores(d));
+    scores += statistics.Scores(d);
+    prunes += statistics.Prunes(d);
+  }
+  BOOST_REQUIRE_EQUAL(scores, statistics.Scores());
+  BOOST_REQUIRE_EQUAL(prunes, statistics.Prunes());
+}
+
+/**
+ * Make sure the statistics of the copies of the rules made by the parallel
+ * traverser are merged.
+ */
+BOOST_AUTO_TEST_CASE(ParallelStatisticsTest)
+{
+  arma::mat dataset(3, 2000, arma::fill::randu);
+  KNN::Tree tree(dataset, 10);
+  EuclideanDistance metric;
+
+  KNNRules rules(tree.Dataset(), tree.Dataset(), 3, metric, 0, true);
+  TraversalStatistics statistics;
+  {
+    StatisticsRules<KNNRules> statisticsRules(rules, statistics);
+    ParallelDualTreeTraverser<StatisticsRules<KNNRules>>
+        traverser(statisticsRules);
+    traverser.Traverse(tree, tree);
+  }
+
+  BOOST_REQUIRE_EQUAL(statistics.Scores(), rules.Scores());
+  BOOST_REQUIRE_GE(statistics.BaseCases(), rules.BaseCases());
+  BOOST_REQUIRE_GT(statistics.Prunes(), 0);
+}
+
+/**
+ * Make sure collecting statistics does not change the results of the
+ * searches.
+ */
+BOOST_AUTO_TEST_CASE(EnabledSearchTest)
+{
+  arma::mat dataset(4, 800, arma::fill::randu);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> neighbors, statisticsNeighbors;
+  arma::mat distances, statisticsDistances;
+  knn.Search(4, neighbors, distances);
+
+  RangeSearch<> rs(dataset);
+  std::vector<std::vector<size_t>> rangeNeighbors, statisticsRangeNeighbors;
+  std::vector<std::vector<double>> rangeDistances, statisticsRangeDistances;
+  rs.Search(math::Range(0.0, 0.2), rangeNeighbors, rangeDistances);
+
+  TraversalStatistics::Enable();
+  knn.Search(4, statisticsNeighbors, statisticsDistances);
+  rs.Search(math::Range(0.0, 0.2), statisticsRangeNeighbors,
+      statisticsRangeDistances);
+  TraversalStatistics::Disable();
+
+  CheckMatrices(neighbors, statisticsNeighbors);
+  CheckMatrices(distances, statisticsDistances);
+
+  BOOST_REQUIRE_EQUAL(rangeNeighbors.size(), statisticsRangeNeighbors.size());
+  for (size_t i = 0; i < rangeNeighbors.size(); ++i)
+  {
+    BOOST_REQUIRE(rangeNeighbors[i] == statisticsRangeNeighbors[i]);
+    BOOST_REQUIRE(rangeDistances[i] == statisticsRangeDistances[i]);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -14,6 +14,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/traversal_scratch.hpp>
 
 #include <queue>
 #include <stack>
@@ -1041,6 +1042,184 @@ BOOST_AUTO_TEST_CASE(HRectBoundDiameter)
   BOOST_REQUIRE_SMALL(d.Diameter(), 1e-5);
 }
 
+/**
+ * Compare the bound-to-bound distances of random bounds with the distances
+ * computed dimension by dimension, for dimensionalities on both sides of the
+ * threshold of the vectorized kernels.
+ */
+template<typename MetricType, typename ElemType>
+void CheckBoundDistances()
+{
+  // The sums are accumulated in a different order than below.
+  const double tolerance = std::is_same<ElemType, float>::value ? 1e-2 : 1e-5;
+
+  const size_t dims[] = { 3, 7, 8, 9, 16, 17, 33, 64, 100 };
+  for (size_t i = 0; i < 9; ++i)
+  {
+    const size_t dim = dims[i];
+    for (size_t trial = 0; trial < 10; ++trial)
+    {
+      HRectBound<MetricType, ElemType> b(dim), c(dim);
+      arma::Mat<ElemType> corners = arma::randu<arma::Mat<ElemType>>(dim, 4);
+      for (size_t d = 0; d < dim; ++d)
+      {
+        b[d] = RangeType<ElemType>(std::min(corners(d, 0), corners(d, 1)),
+            std::max(corners(d, 0), corners(d, 1)));
+        c[d] = RangeType<ElemType>(std::min(corners(d, 2), corners(d, 3)),
+            std::max(corners(d, 2), corners(d, 3)));
+      }
+
+      arma::vec minDist(dim), maxDist(dim);
+      for (size_t d = 0; d < dim; ++d)
+      {
+        minDist(d) = std::max(0.0, std::max(double(c[d].Lo() - b[d].Hi()),
+            double(b[d].Lo() - c[d].Hi())));
+        maxDist(d) = std::max(double(c[d].Hi() - b[d].Lo()),
+            double(b[d].Hi() - c[d].Lo()));
+      }
+
+      double minExpected = arma::accu(arma::pow(minDist, MetricType::Power));
+      double maxExpected = arma::accu(arma::pow(maxDist, MetricType::Power));
+      if (MetricType::TakeRoot)
+      {
+        minExpected = std::pow(minExpected, 1.0 / MetricType::Power);
+        maxExpected = std::pow(maxExpected, 1.0 / MetricType::Power);
+      }
+
+      const RangeType<ElemType> range = b.RangeDistance(c);
+      if (minExpected < 1e-5)
+      {
+        BOOST_REQUIRE_SMALL((double) b.MinDistance(c), 1e-5);
+        BOOST_REQUIRE_SMALL((double) range.Lo(), 1e-5);
+      }
+      else
+      {
+        BOOST_REQUIRE_CLOSE((double) b.MinDistance(c), minExpected,
+            tolerance);
+        BOOST_REQUIRE_CLOSE((double) range.Lo(), minExpected,
+            tolerance);
+      }
+      BOOST_REQUIRE_CLOSE((double) b.MaxDistance(c), maxExpected, tolerance);
+      BOOST_REQUIRE_CLOSE((double) range.Hi(), maxExpected, tolerance);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(HRectBoundHighDimensionalDistances)
+{
+  CheckBoundDistances<ManhattanDistance, double>();
+  CheckBoundDistances<EuclideanDistance, double>();
+  CheckBoundDistances<SquaredEuclideanDistance, double>();
+  CheckBoundDistances<LMetric<3, true>, double>();
+  CheckBoundDistances<EuclideanDistance, float>();
+  CheckBoundDistances<SquaredEuclideanDistance, float>();
+  CheckBoundDistances<LMetric<4, false>, float>();
+}
+
+/**
+ * Make sure that the fixed-dimensionality HRectBound gives the same distances
+ * as the general HRectBound.
+ */
+template<size_t Dim, int Power, bool TakeRoot>
+void CheckFixedBoundDistances()
+{
+  typedef HRectBound<LMetric<Power, TakeRoot>> BoundType;
+  typedef HRectBound<FixedLMetric<Dim, Power, TakeRoot>> FixedBoundType;
+
+  for (size_t trial = 0; trial < 20; ++trial)
+  {
+    const arma::mat points(Dim, 6, arma::fill::randn);
+    BoundType b(Dim), c(Dim);
+    FixedBoundType fb(Dim), fc(Dim);
+    b |= points.cols(0, 2);
+    c |= points.cols(3, 4);
+    fb |= points.cols(0, 2);
+    fc |= points.cols(3, 4);
+
+    BOOST_REQUIRE_EQUAL(fb.Dim(), Dim);
+    BOOST_REQUIRE_CLOSE(fb.MinWidth(), b.MinWidth(), 1e-8);
+    BOOST_REQUIRE_CLOSE(fb.MaxDistance(fc), b.MaxDistance(c), 1e-8);
+    BOOST_REQUIRE_CLOSE(fb.RangeDistance(fc).Hi(), b.RangeDistance(c).Hi(),
+        1e-8);
+    BOOST_REQUIRE_CLOSE(fb.MaxDistance(points.col(5)),
+        b.MaxDistance(points.col(5)), 1e-8);
+    BOOST_REQUIRE_CLOSE(fb.RangeDistance(points.col(5)).Hi(),
+        b.RangeDistance(points.col(5)).Hi(), 1e-8);
+    BOOST_REQUIRE_CLOSE(fb.Diameter(), b.Diameter(), 1e-8);
+
+    // The minimum distances may be zero.
+    const double tolerance = 1e-8;
+    if (b.MinDistance(c) == 0.0)
+      BOOST_REQUIRE_SMALL(fb.MinDistance(fc), tolerance);
+    else
+      BOOST_REQUIRE_CLOSE(fb.MinDistance(fc), b.MinDistance(c), tolerance);
+
+    if (b.RangeDistance(c).Lo() == 0.0)
+      BOOST_REQUIRE_SMALL(fb.RangeDistance(fc).Lo(), tolerance);
+    else
+      BOOST_REQUIRE_CLOSE(fb.RangeDistance(fc).Lo(), b.RangeDistance(c).Lo(),
+          tolerance);
+
+    if (b.MinDistance(points.col(5)) == 0.0)
+      BOOST_REQUIRE_SMALL(fb.MinDistance(points.col(5)), tolerance);
+    else
+      BOOST_REQUIRE_CLOSE(fb.MinDistance(points.col(5)),
+          b.MinDistance(points.col(5)), tolerance);
+
+    BOOST_REQUIRE_EQUAL(fb.Contains(points.col(0)), true);
+    BOOST_REQUIRE_EQUAL(fb.Contains(points.col(5)),
+        b.Contains(points.col(5)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(FixedHRectBoundDistances)
+{
+  CheckFixedBoundDistances<2, 1, false>();
+  CheckFixedBoundDistances<2, 2, true>();
+  CheckFixedBoundDistances<3, 2, false>();
+  CheckFixedBoundDistances<3, 2, true>();
+  CheckFixedBoundDistances<3, 3, true>();
+}
+
+/**
+ * A kd-tree with a fixed-dimensionality metric should have the same structure
+ * and bounds as a kd-tree with the equivalent LMetric, also after it is
+ * compacted.
+ */
+BOOST_AUTO_TEST_CASE(FixedDimensionKDTree)
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  typedef KDTree<FixedEuclideanDistance<3>, EmptyStatistic, arma::mat>
+      FixedTreeType;
+
+  TreeType tree(dataset, 10);
+  FixedTreeType fixedTree(dataset, 10);
+  fixedTree.Compact(BREADTH_FIRST_LAYOUT);
+
+  std::stack<std::pair<const TreeType*, const FixedTreeType*>> stack;
+  stack.push(std::make_pair(&tree, &fixedTree));
+  while (!stack.empty())
+  {
+    const TreeType* node = stack.top().first;
+    const FixedTreeType* fixedNode = stack.top().second;
+    stack.pop();
+
+    BOOST_REQUIRE_EQUAL(node->Begin(), fixedNode->Begin());
+    BOOST_REQUIRE_EQUAL(node->Count(), fixedNode->Count());
+    BOOST_REQUIRE_EQUAL(node->NumChildren(), fixedNode->NumChildren());
+    for (size_t d = 0; d < 3; ++d)
+    {
+      BOOST_REQUIRE_EQUAL(node->Bound()[d].Lo(), fixedNode->Bound()[d].Lo());
+      BOOST_REQUIRE_EQUAL(node->Bound()[d].Hi(), fixedNode->Bound()[d].Hi());
+    }
+
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push(std::make_pair(&node->Child(i), &fixedNode->Child(i)));
+  }
+}
+
 /**
  * It seems as though Bill has stumbled across a bug where
  * BinarySpaceTree<>::count() returns something different than
@@ -1926,6 +2105,59 @@ BOOST_AUTO_TEST_CASE(CoverTreeConstructionTest)
   // implementation.
 }
 
+/**
+ * The Euclidean distance, evaluated one pair of points at a time; the cover
+ * tree does not compute it in blocks.
+ */
+class PairwiseEuclideanDistance
+{
+ public:
+  template<typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
+                                               const VecTypeB& b)
+  {
+    return EuclideanDistance::Evaluate(a, b);
+  }
+
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+};
+
+/**
+ * Check that two cover trees have the same structure.
+ */
+template<typename TreeTypeA, typename TreeTypeB>
+void CheckSameCoverTree(const TreeTypeA& a, const TreeTypeB& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Point(), b.Point());
+  BOOST_REQUIRE_EQUAL(a.Scale(), b.Scale());
+  BOOST_REQUIRE_EQUAL(a.NumDescendants(), b.NumDescendants());
+  BOOST_REQUIRE_CLOSE(a.FurthestDescendantDistance(),
+      b.FurthestDescendantDistance(), 1e-5);
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameCoverTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * The blocked Euclidean distances must build the same cover tree as the
+ * distances computed one pair at a time, with enough points at the top of the
+ * tree to split the blocks among threads.
+ */
+BOOST_AUTO_TEST_CASE(CoverTreeBlockedDistancesTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 3000);
+
+  StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      blockedTree(dataset);
+  StandardCoverTree<PairwiseEuclideanDistance, EmptyStatistic, arma::mat>
+      pairwiseTree(dataset);
+
+  CheckSameCoverTree(blockedTree, pairwiseTree);
+  CheckCovering<StandardCoverTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>, LMetric<2, true>>(blockedTree);
+}
+
 /**
  * Create a cover tree on sparse data and make sure it's accurate.
  */
@@ -2252,4 +2484,188 @@ BOOST_AUTO_TEST_CASE(CoverTreeDescendantTest)
   CheckDescendants(&tree);
 }
 
+/**
+ * Make sure that two trees built on the same data with different numbers of
+ * threads hold the same original points in every node, and have the same
+ * bounds.  The order of the points inside a node may differ.
+ */
+template<typename TreeType>
+void CheckSameBuild(const TreeType& node1,
+                    const TreeType& node2,
+                    const std::vector<size_t>& oldFromNew1,
+                    const std::vector<size_t>& oldFromNew2)
+{
+  BOOST_REQUIRE_EQUAL(node1.NumChildren(), node2.NumChildren());
+  BOOST_REQUIRE_EQUAL(node1.NumDescendants(), node2.NumDescendants());
+
+  std::vector<size_t> points1(node1.NumDescendants());
+  std::vector<size_t> points2(node2.NumDescendants());
+  for (size_t i = 0; i < node1.NumDescendants(); ++i)
+  {
+    points1[i] = oldFromNew1[node1.Descendant(i)];
+    points2[i] = oldFromNew2[node2.Descendant(i)];
+  }
+  std::sort(points1.begin(), points1.end());
+  std::sort(points2.begin(), points2.end());
+  for (size_t i = 0; i < points1.size(); ++i)
+    BOOST_REQUIRE_EQUAL(points1[i], points2[i]);
+
+  for (size_t d = 0; d < node1.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_CLOSE(node1.Bound()[d].Lo(), node2.Bound()[d].Lo(), 1e-5);
+    BOOST_REQUIRE_CLOSE(node1.Bound()[d].Hi(), node2.Bound()[d].Hi(), 1e-5);
+  }
+
+  BOOST_REQUIRE_CLOSE(node1.FurthestDescendantDistance(),
+      node2.FurthestDescendantDistance(), 1e-5);
+
+  for (size_t i = 0; i < node1.NumChildren(); ++i)
+  {
+    CheckSameBuild(node1.Child(i), node2.Child(i), oldFromNew1,
+        oldFromNew2);
+  }
+}
+
+/**
+ * Make sure that building a kd-tree with several threads gives the same tree
+ * as building it with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelKdTreeBuildTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  // The dataset is large enough for the top partitions to be parallel.
+  arma::mat dataset = arma::randu<arma::mat>(3, 30000);
+
+  #ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+  #endif
+
+  std::vector<size_t> oldFromNew1;
+  TreeType serialTree(dataset, oldFromNew1);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(4);
+  #endif
+
+  std::vector<size_t> oldFromNew2;
+  TreeType parallelTree(dataset, oldFromNew2);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(prevNumThreads);
+  #endif
+
+  // Every point must map back to the original dataset.
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+    {
+      BOOST_REQUIRE_EQUAL(parallelTree.Dataset()(d, i),
+          dataset(d, oldFromNew2[i]));
+    }
+  }
+
+  CheckSameBuild(serialTree, parallelTree, oldFromNew1, oldFromNew2);
+}
+
+/**
+ * Check that the parent pointers of the given tree are consistent.
+ */
+template<typename TreeType>
+void CheckParents(TreeType& node)
+{
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(node.Child(i).Parent(), &node);
+    CheckParents(node.Child(i));
+  }
+}
+
+/**
+ * Make sure that compacting a kd-tree in either layout keeps the tree intact,
+ * and that the breadth-first layout stores siblings next to each other.
+ */
+BOOST_AUTO_TEST_CASE(CompactKdTreeTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew);
+
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    TreeType compactTree(tree);
+    if (trial == 0)
+    {
+      compactTree.Compact(BREADTH_FIRST_LAYOUT);
+    }
+    else if (trial == 1)
+    {
+      compactTree.Compact(VAN_EMDE_BOAS_LAYOUT);
+    }
+    else
+    {
+      // Compacting an already compacted tree must also work.
+      compactTree.Compact(VAN_EMDE_BOAS_LAYOUT);
+      compactTree.Compact(BREADTH_FIRST_LAYOUT);
+    }
+
+    CheckSameBuild(tree, compactTree, oldFromNew, oldFromNew);
+    CheckParents(compactTree);
+
+    if (trial != 1)
+    {
+      BOOST_REQUIRE_EQUAL(compactTree.Left() + 1, compactTree.Right());
+      BOOST_REQUIRE_EQUAL(compactTree.Right() + 1, compactTree.Left()->Left());
+    }
+
+    // A compacted tree can be moved and copied like any other.
+    TreeType movedTree(std::move(compactTree));
+    CheckSameBuild(tree, movedTree, oldFromNew, oldFromNew);
+    CheckParents(movedTree);
+
+    TreeType copiedTree(movedTree);
+    CheckSameBuild(tree, copiedTree, oldFromNew, oldFromNew);
+    CheckParents(copiedTree);
+  }
+}
+
+/**
+ * Make sure that the vectors of a TraversalScratch stay valid while deeper
+ * levels take more, and that their memory is reused.
+ */
+BOOST_AUTO_TEST_CASE(TraversalScratchTest)
+{
+  TraversalScratch<size_t> scratch;
+  const size_t* memory;
+  {
+    ScratchVector<size_t> outer(scratch, 3);
+    BOOST_REQUIRE_EQUAL(outer.Vector().size(), 3);
+    outer.Vector()[0] = 5;
+    memory = outer.Vector().data();
+
+    // Many nested levels, to make the scratch memory grow.
+    std::vector<ScratchVector<size_t>*> inner;
+    for (size_t i = 0; i < 100; ++i)
+    {
+      inner.push_back(new ScratchVector<size_t>(scratch, i));
+      BOOST_REQUIRE_EQUAL(inner.back()->Vector().size(), i);
+    }
+    for (size_t i = 100; i > 0; --i)
+      delete inner[i - 1];
+
+    BOOST_REQUIRE_EQUAL(outer.Vector().size(), 3);
+    BOOST_REQUIRE_EQUAL(outer.Vector()[0], 5);
+    BOOST_REQUIRE_EQUAL(outer.Vector().data(), memory);
+  }
+
+  // The next vector is the same one, cleared.
+  ScratchVector<size_t> again(scratch, 2);
+  BOOST_REQUIRE_EQUAL(again.Vector().size(), 2);
+  BOOST_REQUIRE_EQUAL(again.Vector()[0], 0);
+  BOOST_REQUIRE_EQUAL(again.Vector().data(), memory);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
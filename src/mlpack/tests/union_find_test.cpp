@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,54 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+/**
+ * Make sure ConcurrentUnionFind finds the same components as UnionFind when
+ * many unions are made from several threads at once, and that each successful
+ * Union() merges two components.
+ */
+BOOST_AUTO_TEST_CASE(TestConcurrentUnion)
+{
+  static const size_t testSize = 10000;
+  static const size_t numUnions = 8000;
+
+  arma::Mat<size_t> pairs(2, numUnions);
+  for (size_t i = 0; i < numUnions; ++i)
+  {
+    pairs(0, i) = math::RandInt(testSize);
+    pairs(1, i) = math::RandInt(testSize);
+  }
+
+  UnionFind serial(testSize);
+  for (size_t i = 0; i < numUnions; ++i)
+    serial.Union(pairs(0, i), pairs(1, i));
+
+  ConcurrentUnionFind concurrent(testSize);
+  size_t merges = 0;
+  #pragma omp parallel for reduction(+:merges)
+  for (omp_size_t i = 0; i < (omp_size_t) numUnions; ++i)
+  {
+    if (concurrent.Union(pairs(0, i), pairs(1, i)))
+      ++merges;
+  }
+
+  // Count the components, and make sure each is labeled by its smallest
+  // element.
+  size_t components = 0;
+  for (size_t i = 0; i < testSize; ++i)
+  {
+    if (concurrent.Find(i) == i)
+      ++components;
+    BOOST_REQUIRE_LE(concurrent.Find(i), i);
+  }
+  BOOST_REQUIRE_EQUAL(components + merges, testSize);
+
+  for (size_t i = 0; i < numUnions; ++i)
+  {
+    const size_t a = pairs(0, i);
+    const size_t b = (i + 1 < numUnions) ? pairs(1, i + 1) : pairs(1, 0);
+    BOOST_REQUIRE_EQUAL(serial.Find(a) == serial.Find(b),
+        concurrent.Find(a) == concurrent.Find(b));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();